@@ -0,0 +1,43 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+// The entry of doris_be_benchmark. Besides the standard flags of Google Benchmark, the
+// results can be saved as JSON to be compared between commits, e.g.
+//   doris_be_benchmark --benchmark_out=result.json --benchmark_out_format=json
+
+#include <benchmark/benchmark.h>
+
+#include "common/config.h"
+#include "util/cpu_info.h"
+#include "util/logging.h"
+#include "util/mem_info.h"
+
+int main(int argc, char** argv) {
+    // the benchmarks use the default config, be.conf is not required
+    doris::config::init(nullptr, false);
+    doris::init_glog("be-benchmark");
+    doris::CpuInfo::init();
+    doris::MemInfo::init();
+
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
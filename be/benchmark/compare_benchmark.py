@@ -0,0 +1,74 @@
+#!/usr/bin/env python
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+"""Compare two JSON results of doris_be_benchmark, e.g. of two commits.
+
+Usage: compare_benchmark.py base.json new.json [--threshold=5]
+
+The benchmarks whose cpu time changes more than the threshold (in percent) are
+marked, the exit code is 1 if any benchmark regresses.
+"""
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        benchmarks = json.load(f)["benchmarks"]
+    # the aggregates of repetitions are ignored except the mean
+    return dict((b["name"], b) for b in benchmarks
+                if b.get("run_type", "iteration") == "iteration" or
+                b.get("aggregate_name") == "mean")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compare doris_be_benchmark results")
+    parser.add_argument("base")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=5.0,
+                        help="the change of cpu time in percent to be reported")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+    regressed = False
+    print("%-70s %14s %14s %9s" % ("Benchmark", "Base(ns)", "New(ns)", "Change"))
+    for name in sorted(set(base) & set(new)):
+        base_time = base[name]["cpu_time"]
+        new_time = new[name]["cpu_time"]
+        change = (new_time - base_time) * 100.0 / base_time if base_time else 0.0
+        mark = ""
+        if change > args.threshold:
+            mark = " REGRESSION"
+            regressed = True
+        elif change < -args.threshold:
+            mark = " IMPROVEMENT"
+        print("%-70s %14.1f %14.1f %+8.1f%%%s" % (name, base_time, new_time, change, mark))
+    for name in sorted(set(base) - set(new)):
+        print("%-70s only in base" % name)
+    for name in sorted(set(new) - set(base)):
+        print("%-70s only in new" % name)
+    return 1 if regressed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,220 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/rowset/segment_v2/binary_dict_page.h"
+#include "olap/rowset/segment_v2/binary_plain_page.h"
+#include "olap/rowset/segment_v2/bitshuffle_page.h"
+#include "olap/rowset/segment_v2/frame_of_reference_page.h"
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/rle_page.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/cpu_info.h"
+#include "vec/columns/column_dictionary.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// The rows of one batch of SegmentIterator.
+static constexpr size_t NUM_ROWS = 4096;
+static constexpr size_t PAGE_SIZE = 1024 * 1024;
+
+// NUM_ROWS increasing integers whose deltas are in [0, max_delta).
+static std::vector<int32_t> create_ints(int32_t max_delta) {
+    std::mt19937 rng(max_delta);
+    std::vector<int32_t> values(NUM_ROWS);
+    int32_t value = 0;
+    for (auto& v : values) {
+        value += rng() % max_delta;
+        v = value;
+    }
+    return values;
+}
+
+template <typename PageBuilderType>
+static OwnedSlice build_page(const void* values, size_t count) {
+    PageBuilderOptions options;
+    options.data_page_size = PAGE_SIZE;
+    options.dict_page_size = PAGE_SIZE;
+    PageBuilderType builder(options);
+    CHECK(builder.add(reinterpret_cast<const uint8_t*>(values), &count).ok());
+    return builder.finish();
+}
+
+static void BM_BitShufflePageDecoder_Int(benchmark::State& state) {
+    auto values = create_ints(state.range(0));
+    OwnedSlice page = build_page<BitshufflePageBuilder<OLAP_FIELD_TYPE_INT>>(values.data(),
+                                                                              values.size());
+    BitShufflePageDecoder<OLAP_FIELD_TYPE_INT> decoder(page.slice(), PageDecoderOptions());
+    CHECK(decoder.init().ok());
+    for (auto _ : state) {
+        decoder.seek_to_position_in_page(0);
+        vectorized::MutableColumnPtr column = vectorized::ColumnInt32::create();
+        size_t n = NUM_ROWS;
+        CHECK(decoder.next_batch(&n, column).ok());
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_BitShufflePageDecoder_Int)->Arg(2)->Arg(1024)->Arg(1 << 20);
+
+// Disable the AVX-512 decoding when `avx512` is 0, to compare with the scalar decoding.
+static std::unique_ptr<CpuInfo::TempDisable> disable_avx512(int64_t avx512) {
+    if (avx512 != 0) {
+        return nullptr;
+    }
+    return std::make_unique<CpuInfo::TempDisable>(CpuInfo::AVX512BW);
+}
+
+static void BM_FrameOfReferencePageDecoder_Int(benchmark::State& state) {
+    auto disable = disable_avx512(state.range(1));
+    auto values = create_ints(state.range(0));
+    OwnedSlice page = build_page<FrameOfReferencePageBuilder<OLAP_FIELD_TYPE_INT>>(
+            values.data(), values.size());
+    FrameOfReferencePageDecoder<OLAP_FIELD_TYPE_INT> decoder(page.slice(), PageDecoderOptions());
+    CHECK(decoder.init().ok());
+
+    // the decoder does not support vectorized columns yet
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    CHECK(ColumnVectorBatch::create(NUM_ROWS, false, get_scalar_type_info(OLAP_FIELD_TYPE_INT),
+                                    nullptr, &cvb)
+                  .ok());
+    ColumnBlock block(cvb.get(), &pool);
+    for (auto _ : state) {
+        decoder.seek_to_position_in_page(0);
+        ColumnBlockView column_block_view(&block);
+        size_t n = NUM_ROWS;
+        CHECK(decoder.next_batch(&n, &column_block_view).ok());
+        benchmark::DoNotOptimize(block.data());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_FrameOfReferencePageDecoder_Int)->ArgsProduct({{2, 1024, 1 << 20}, {0, 1}});
+
+// NUM_ROWS bools in the runs of the same value of random lengths in [1, max_run].
+static void BM_RlePageDecoder_Bool(benchmark::State& state) {
+    auto disable = disable_avx512(state.range(1));
+    std::mt19937 rng(state.range(0));
+    std::vector<uint8_t> values;
+    while (values.size() < NUM_ROWS) {
+        uint8_t value = rng() % 2;
+        values.insert(values.end(), 1 + rng() % state.range(0), value);
+    }
+    values.resize(NUM_ROWS);
+    OwnedSlice page = build_page<RlePageBuilder<OLAP_FIELD_TYPE_BOOL>>(values.data(),
+                                                                        values.size());
+    RlePageDecoder<OLAP_FIELD_TYPE_BOOL> decoder(page.slice(), PageDecoderOptions());
+    CHECK(decoder.init().ok());
+    for (auto _ : state) {
+        decoder.seek_to_position_in_page(0);
+        vectorized::MutableColumnPtr column = vectorized::ColumnUInt8::create();
+        size_t n = NUM_ROWS;
+        CHECK(decoder.next_batch(&n, column).ok());
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_RlePageDecoder_Bool)->ArgsProduct({{1, 16, 1024}, {0, 1}});
+
+// A dictionary page with `cardinality` words and the data page of NUM_ROWS codes.
+class DictPages {
+public:
+    explicit DictPages(size_t cardinality) {
+        std::mt19937 rng(cardinality);
+        std::vector<std::string> words;
+        for (size_t i = 0; i < cardinality; ++i) {
+            words.emplace_back("dict_word_" + std::to_string(i));
+        }
+        std::vector<Slice> values;
+        for (size_t i = 0; i < NUM_ROWS; ++i) {
+            values.emplace_back(words[rng() % cardinality]);
+        }
+
+        PageBuilderOptions options;
+        options.data_page_size = PAGE_SIZE;
+        options.dict_page_size = PAGE_SIZE;
+        BinaryDictPageBuilder builder(options);
+        size_t count = values.size();
+        CHECK(builder.add(reinterpret_cast<const uint8_t*>(values.data()), &count).ok());
+        _data_page = builder.finish();
+        CHECK(builder.get_dictionary_page(&_dict_page).ok());
+
+        _dict_decoder.reset(new BinaryPlainPageDecoder(_dict_page.slice(), PageDecoderOptions()));
+        CHECK(_dict_decoder->init().ok());
+        _dict_word_info.resize(_dict_decoder->count());
+        _dict_decoder->get_dict_word_info(_dict_word_info.data());
+
+        _decoder.reset(new BinaryDictPageDecoder(_data_page.slice(), PageDecoderOptions()));
+        _decoder->set_dict_decoder(_dict_decoder.get(), _dict_word_info.data());
+        CHECK(_decoder->init().ok());
+    }
+
+    BinaryDictPageDecoder* decoder() { return _decoder.get(); }
+
+private:
+    OwnedSlice _data_page;
+    OwnedSlice _dict_page;
+    std::unique_ptr<BinaryPlainPageDecoder> _dict_decoder;
+    std::vector<StringRef> _dict_word_info;
+    std::unique_ptr<BinaryDictPageDecoder> _decoder;
+};
+
+static void BM_BinaryDictPageDecoder_String(benchmark::State& state) {
+    DictPages pages(state.range(0));
+    for (auto _ : state) {
+        pages.decoder()->seek_to_position_in_page(0);
+        vectorized::MutableColumnPtr column = vectorized::ColumnString::create();
+        size_t n = NUM_ROWS;
+        CHECK(pages.decoder()->next_batch(&n, column).ok());
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_BinaryDictPageDecoder_String)->Arg(16)->Arg(1024);
+
+// Decode into the dictionary codes, which is the way of predicate columns.
+static void BM_BinaryDictPageDecoder_DictCode(benchmark::State& state) {
+    DictPages pages(state.range(0));
+    for (auto _ : state) {
+        pages.decoder()->seek_to_position_in_page(0);
+        vectorized::MutableColumnPtr column = vectorized::ColumnDictI32::create();
+        column->reserve(NUM_ROWS);
+        size_t n = NUM_ROWS;
+        CHECK(pages.decoder()->next_batch(&n, column).ok());
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_BinaryDictPageDecoder_DictCode)->Arg(16)->Arg(1024);
+
+} // namespace segment_v2
+} // namespace doris
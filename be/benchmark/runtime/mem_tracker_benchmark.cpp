@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+// Compare the cost of tracking the allocations of an allocation heavy loop:
+//   0: not tracked
+//   1: every allocation consumes the task tracker and all of its ancestors, i.e. the shared
+//      atomics of the query and process trackers are touched on each allocation
+//   2: every allocation is buffered in the thread local ThreadMemTrackerMgr, as the TCMalloc
+//      hook does, and the trackers are only consumed (and the limits checked) on flush, once
+//      per mem_tracker_consume_min_size_bytes
+// Run with multiple threads to see the contention on the process tracker, e.g.
+//   doris_be_benchmark --benchmark_filter=BM_MemTracker
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "runtime/mem_tracker.h"
+#include "runtime/thread_context.h"
+
+namespace doris {
+
+static constexpr size_t NUM_ALLOCATIONS = 4096;
+
+static std::shared_ptr<MemTracker> query_tracker() {
+    static auto tracker = MemTracker::create_tracker(-1, "BenchmarkQuery",
+                                                     MemTracker::get_process_tracker());
+    return tracker;
+}
+
+static void BM_MemTracker_Allocate(benchmark::State& state) {
+    int mode = state.range(0);
+    auto task_tracker = MemTracker::create_tracker(-1, "BenchmarkTask", query_tracker());
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(task_tracker);
+
+    std::mt19937 rand(state.thread_index());
+    std::uniform_int_distribution<size_t> sizes(16, 4096);
+    std::vector<size_t> alloc_sizes(NUM_ALLOCATIONS);
+    for (auto& size : alloc_sizes) {
+        size = sizes(rand);
+    }
+
+    std::vector<std::unique_ptr<char[]>> buffers(NUM_ALLOCATIONS);
+    for (auto _ : state) {
+        for (size_t i = 0; i < NUM_ALLOCATIONS; ++i) {
+            buffers[i].reset(new char[alloc_sizes[i]]);
+            benchmark::DoNotOptimize(buffers[i].get());
+            if (mode == 1) {
+                task_tracker->consume(alloc_sizes[i]);
+            } else if (mode == 2) {
+                tls_ctx()->consume_mem(alloc_sizes[i]);
+            }
+        }
+        for (size_t i = 0; i < NUM_ALLOCATIONS; ++i) {
+            buffers[i].reset();
+            if (mode == 1) {
+                task_tracker->release(alloc_sizes[i]);
+            } else if (mode == 2) {
+                tls_ctx()->release_mem(alloc_sizes[i]);
+            }
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ALLOCATIONS);
+}
+BENCHMARK(BM_MemTracker_Allocate)->DenseRange(0, 2)->ThreadRange(1, 32)->UseRealTime();
+
+} // namespace doris
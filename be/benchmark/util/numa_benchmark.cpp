@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+// Compare reading the memory allocated on the local NUMA node with reading it from the other
+// node, i.e. a scan thread reading the page cache filled by a thread on the other socket. The
+// memory is allocated by the first touch, by a thread bound to the allocating node. Requires a
+// machine with at least two NUMA nodes, e.g.
+//   doris_be_benchmark --benchmark_filter=BM_Numa
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "util/cpu_info.h"
+
+namespace doris {
+
+static constexpr size_t BUFFER_BYTES = 256L << 20;
+
+// args: the node allocating the memory, the node reading it
+static void BM_NumaRead(benchmark::State& state) {
+    int alloc_node = state.range(0);
+    int read_node = state.range(1);
+    if (CpuInfo::get_max_num_numa_nodes() <= std::max(alloc_node, read_node)) {
+        state.SkipWithError("not enough NUMA nodes");
+        return;
+    }
+    if (!CpuInfo::bind_current_thread_to_numa_node(alloc_node).ok()) {
+        state.SkipWithError("failed to bind to the allocating node");
+        return;
+    }
+    size_t num_values = BUFFER_BYTES / sizeof(int64_t);
+    std::unique_ptr<int64_t[]> buffer(new int64_t[num_values]);
+    memset(buffer.get(), 1, BUFFER_BYTES);
+    if (!CpuInfo::bind_current_thread_to_numa_node(read_node).ok()) {
+        state.SkipWithError("failed to bind to the reading node");
+        return;
+    }
+
+    for (auto _ : state) {
+        int64_t sum = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            sum += buffer[i];
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * BUFFER_BYTES);
+}
+
+BENCHMARK(BM_NumaRead)->Args({0, 0})->Args({0, 1})->Unit(benchmark::kMillisecond);
+
+} // namespace doris
@@ -0,0 +1,179 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "util/ddsketch.h"
+#include "util/tdigest.h"
+
+namespace doris {
+
+// Compare TDigest and DDSketch as the states of percentile_approx, by the speed to add the
+// values, to merge the states of NUM_PARTS parts (as in the two-phase aggregation) and to
+// serialize them, and by the max relative error of the quantiles and the serialized size.
+// The values are lognormal, and both sketches are of the default compression 10000.
+static constexpr size_t NUM_VALUES = 1 << 20;
+static constexpr size_t NUM_PARTS = 64;
+static constexpr double COMPRESSION = 10000;
+static constexpr double QUANTILES[] = {0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999};
+
+static const std::vector<double>& values() {
+    static std::vector<double> values = [] {
+        std::mt19937_64 rng(NUM_VALUES);
+        std::lognormal_distribution<double> distribution(0, 2);
+        std::vector<double> values(NUM_VALUES);
+        for (auto& value : values) {
+            value = distribution(rng);
+        }
+        return values;
+    }();
+    return values;
+}
+
+static double max_relative_error(const std::vector<double>& estimates) {
+    std::vector<double> sorted = values();
+    std::sort(sorted.begin(), sorted.end());
+    double max_error = 0;
+    for (size_t i = 0; i < estimates.size(); ++i) {
+        double expected = sorted[static_cast<size_t>(QUANTILES[i] * (sorted.size() - 1))];
+        max_error = std::max(max_error, std::abs(estimates[i] - expected) / expected);
+    }
+    return max_error;
+}
+
+template <typename Sketch>
+static void set_counters(benchmark::State& state, Sketch& sketch) {
+    std::vector<double> estimates;
+    for (double q : QUANTILES) {
+        estimates.push_back(sketch.quantile(q));
+    }
+    state.counters["max_relative_error"] = benchmark::Counter(max_relative_error(estimates));
+    state.counters["serialized_size"] = benchmark::Counter(sketch.serialized_size());
+}
+
+static std::unique_ptr<TDigest> create_tdigest(size_t begin, size_t end) {
+    auto tdigest = std::make_unique<TDigest>(COMPRESSION);
+    for (size_t i = begin; i < end; ++i) {
+        tdigest->add(values()[i]);
+    }
+    tdigest->compress();
+    return tdigest;
+}
+
+static std::unique_ptr<DDSketch> create_ddsketch(size_t begin, size_t end) {
+    auto ddsketch =
+            std::make_unique<DDSketch>(DDSketch::relative_accuracy_of_compression(COMPRESSION));
+    for (size_t i = begin; i < end; ++i) {
+        ddsketch->add(values()[i]);
+    }
+    return ddsketch;
+}
+
+static void BM_TDigest_Add(benchmark::State& state) {
+    for (auto _ : state) {
+        auto tdigest = create_tdigest(0, NUM_VALUES);
+        benchmark::DoNotOptimize(tdigest.get());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VALUES);
+    set_counters(state, *create_tdigest(0, NUM_VALUES));
+}
+BENCHMARK(BM_TDigest_Add)->Unit(benchmark::kMillisecond);
+
+static void BM_DDSketch_Add(benchmark::State& state) {
+    for (auto _ : state) {
+        auto ddsketch = create_ddsketch(0, NUM_VALUES);
+        benchmark::DoNotOptimize(ddsketch.get());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_VALUES);
+    set_counters(state, *create_ddsketch(0, NUM_VALUES));
+}
+BENCHMARK(BM_DDSketch_Add)->Unit(benchmark::kMillisecond);
+
+static void BM_TDigest_Merge(benchmark::State& state) {
+    std::vector<std::unique_ptr<TDigest>> parts;
+    for (size_t i = 0; i < NUM_PARTS; ++i) {
+        parts.push_back(
+                create_tdigest(i * NUM_VALUES / NUM_PARTS, (i + 1) * NUM_VALUES / NUM_PARTS));
+    }
+    std::unique_ptr<TDigest> merged;
+    for (auto _ : state) {
+        merged = std::make_unique<TDigest>(COMPRESSION);
+        for (auto& part : parts) {
+            merged->merge(part.get());
+        }
+        merged->compress();
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_PARTS);
+    set_counters(state, *merged);
+}
+BENCHMARK(BM_TDigest_Merge)->Unit(benchmark::kMicrosecond);
+
+static void BM_DDSketch_Merge(benchmark::State& state) {
+    std::vector<std::unique_ptr<DDSketch>> parts;
+    for (size_t i = 0; i < NUM_PARTS; ++i) {
+        parts.push_back(
+                create_ddsketch(i * NUM_VALUES / NUM_PARTS, (i + 1) * NUM_VALUES / NUM_PARTS));
+    }
+    std::unique_ptr<DDSketch> merged;
+    for (auto _ : state) {
+        merged = create_ddsketch(0, 0);
+        for (auto& part : parts) {
+            merged->merge(*part);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_PARTS);
+    set_counters(state, *merged);
+}
+BENCHMARK(BM_DDSketch_Merge)->Unit(benchmark::kMicrosecond);
+
+static void BM_TDigest_Serialize(benchmark::State& state) {
+    auto tdigest = create_tdigest(0, NUM_VALUES);
+    std::string buf;
+    for (auto _ : state) {
+        buf.resize(tdigest->serialized_size());
+        tdigest->serialize((uint8_t*)buf.data());
+        TDigest copy(COMPRESSION);
+        copy.unserialize((const uint8_t*)buf.data());
+        benchmark::DoNotOptimize(copy.quantile(0.5));
+    }
+    state.SetBytesProcessed(state.iterations() * buf.size());
+}
+BENCHMARK(BM_TDigest_Serialize)->Unit(benchmark::kMicrosecond);
+
+static void BM_DDSketch_Serialize(benchmark::State& state) {
+    auto ddsketch = create_ddsketch(0, NUM_VALUES);
+    std::string buf;
+    for (auto _ : state) {
+        buf.resize(ddsketch->serialized_size());
+        ddsketch->serialize((uint8_t*)buf.data());
+        DDSketch copy;
+        copy.deserialize((const uint8_t*)buf.data(), buf.size());
+        benchmark::DoNotOptimize(copy.quantile(0.5));
+    }
+    state.SetBytesProcessed(state.iterations() * buf.size());
+}
+BENCHMARK(BM_DDSketch_Serialize)->Unit(benchmark::kMicrosecond);
+
+} // namespace doris
@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/arena.h"
+#include "vec/exec/vaggregation_node.h"
+
+namespace doris::vectorized {
+
+// The rows of one block of the aggregation.
+static constexpr size_t NUM_ROWS = 4096;
+
+static ColumnPtr create_int_column(size_t cardinality) {
+    std::mt19937_64 rng(cardinality);
+    std::uniform_int_distribution<Int64> dist(0, cardinality - 1);
+    auto column = ColumnInt64::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        column->insert_value(dist(rng));
+    }
+    return column;
+}
+
+static ColumnPtr create_string_column(size_t cardinality) {
+    std::mt19937_64 rng(cardinality);
+    std::uniform_int_distribution<Int64> dist(0, cardinality - 1);
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        std::string str = "group_key_" + std::to_string(dist(rng));
+        column->insert_data(str.data(), str.size());
+    }
+    return column;
+}
+
+// Emplace the keys of one block into the hash table of the aggregation method, the same
+// way as AggregationNode::_emplace_into_hash_table, with a fake aggregate state.
+template <typename Method>
+static void emplace_block(benchmark::State& state, const Columns& columns) {
+    ColumnRawPtrs key_columns;
+    for (const auto& column : columns) {
+        key_columns.push_back(column.get());
+    }
+    Sizes key_sizes;
+    for (auto _ : state) {
+        Method method;
+        Arena arena;
+        typename Method::State hash_state(key_columns, key_sizes, nullptr);
+        for (size_t i = 0; i < NUM_ROWS; ++i) {
+            auto emplace_result = hash_state.emplace_key(method.data, i, arena);
+            if (emplace_result.is_inserted()) {
+                emplace_result.set_mapped(arena.alloc(8));
+            }
+            benchmark::DoNotOptimize(emplace_result.get_mapped());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+
+static void BM_AggregationMethodOneNumber(benchmark::State& state) {
+    emplace_block<AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64Key, false>>(
+            state, {create_int_column(state.range(0))});
+}
+BENCHMARK(BM_AggregationMethodOneNumber)->RangeMultiplier(16)->Range(16, 4096);
+
+static void BM_AggregationMethodSerialized(benchmark::State& state) {
+    emplace_block<AggregationMethodSerialized<AggregatedDataWithStringKey>>(
+            state, {create_int_column(state.range(0)), create_string_column(state.range(0))});
+}
+BENCHMARK(BM_AggregationMethodSerialized)->RangeMultiplier(16)->Range(16, 4096);
+
+static void BM_AggregationMethodStringNoCache(benchmark::State& state) {
+    emplace_block<AggregationMethodStringNoCache<AggregatedDataWithShortStringKey>>(
+            state, {create_string_column(state.range(0))});
+}
+BENCHMARK(BM_AggregationMethodStringNoCache)->RangeMultiplier(16)->Range(16, 4096);
+
+static void BM_AggregationMethodStringKeySerialized(benchmark::State& state) {
+    emplace_block<AggregationMethodSerialized<AggregatedDataWithStringKey>>(
+            state, {create_string_column(state.range(0))});
+}
+BENCHMARK(BM_AggregationMethodStringKeySerialized)->RangeMultiplier(16)->Range(16, 4096);
+
+} // namespace doris::vectorized
@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+
+#include "gen_cpp/data.pb.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+static constexpr size_t NUM_ROWS = 4096;
+
+static MutableColumnPtr create_string_column(size_t length) {
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        std::string str = std::to_string(i);
+        str.resize(std::max(length, str.size()), 'x');
+        column->insert_data(str.data(), str.size());
+    }
+    return column;
+}
+
+static Block create_block() {
+    auto int_column = ColumnInt64::create();
+    auto double_column = ColumnFloat64::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        int_column->insert_value(i);
+        double_column->insert_value(i * 0.5);
+    }
+    return Block({{std::move(int_column), std::make_shared<DataTypeInt64>(), "k1"},
+                  {std::move(double_column), std::make_shared<DataTypeFloat64>(), "k2"},
+                  {create_string_column(32), std::make_shared<DataTypeString>(), "k3"}});
+}
+
+static void BM_Block_Serialize(benchmark::State& state) {
+    Block block = create_block();
+    bool allow_compress = state.range(0);
+    std::string buf;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    for (auto _ : state) {
+        PBlock pblock;
+        auto st = block.serialize(&pblock, &uncompressed_bytes, &compressed_bytes, &buf,
+                                  allow_compress);
+        benchmark::DoNotOptimize(st);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+    state.SetBytesProcessed(state.iterations() * uncompressed_bytes);
+}
+BENCHMARK(BM_Block_Serialize)->Arg(0)->Arg(1);
+
+static void BM_Block_Deserialize(benchmark::State& state) {
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    std::string buf;
+    auto st = create_block().serialize(&pblock, &uncompressed_bytes, &compressed_bytes, &buf,
+                                       state.range(0));
+    CHECK(st.ok()) << st.get_error_msg();
+    for (auto _ : state) {
+        Block block(pblock);
+        benchmark::DoNotOptimize(block.rows());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_Block_Deserialize)->Arg(0)->Arg(1);
+
+// range(0) is the length of the strings, range(1) is the selectivity in percent.
+static void BM_ColumnString_Filter(benchmark::State& state) {
+    auto column = create_string_column(state.range(0));
+    std::mt19937 rng(0);
+    IColumn::Filter filter(NUM_ROWS);
+    for (auto& selected : filter) {
+        selected = rng() % 100 < state.range(1);
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(column->filter(filter, -1));
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_ColumnString_Filter)->ArgsProduct({{8, 64}, {1, 50, 99}});
+
+static void BM_ColumnString_InsertRangeFrom(benchmark::State& state) {
+    auto src = create_string_column(state.range(0));
+    for (auto _ : state) {
+        auto column = ColumnString::create();
+        for (size_t i = 0; i < NUM_ROWS; i += 64) {
+            column->insert_range_from(*src, i, 64);
+        }
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_ColumnString_InsertRangeFrom)->Arg(8)->Arg(64);
+
+static void BM_ColumnString_InsertIndicesFrom(benchmark::State& state) {
+    auto src = create_string_column(state.range(0));
+    std::mt19937 rng(0);
+    std::vector<int> indices(NUM_ROWS);
+    for (auto& index : indices) {
+        index = rng() % NUM_ROWS;
+    }
+    for (auto _ : state) {
+        auto column = ColumnString::create();
+        column->insert_indices_from(*src, indices.data(), indices.data() + indices.size());
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_ColumnString_InsertIndicesFrom)->Arg(8)->Arg(64);
+
+static void BM_ColumnString_InsertData(benchmark::State& state) {
+    std::string str(state.range(0), 'x');
+    for (auto _ : state) {
+        auto column = ColumnString::create();
+        for (size_t i = 0; i < NUM_ROWS; ++i) {
+            column->insert_data(str.data(), str.size());
+        }
+        benchmark::DoNotOptimize(column->size());
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+BENCHMARK(BM_ColumnString_InsertData)->Arg(8)->Arg(64);
+
+} // namespace doris::vectorized
@@ -0,0 +1,130 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "vec/common/hash_table/fixed_hash_map.h"
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/hash_table/string_hash_map.h"
+#include "vec/common/string_ref.h"
+
+namespace doris::vectorized {
+
+static constexpr size_t NUM_ROWS = 1 << 20;
+
+// NUM_ROWS keys which have `cardinality` distinct values.
+template <typename T>
+static std::vector<T> create_keys(size_t cardinality) {
+    std::mt19937_64 rng(cardinality);
+    std::uniform_int_distribution<uint64_t> dist(0, cardinality - 1);
+    std::vector<T> keys(NUM_ROWS);
+    for (auto& key : keys) {
+        key = static_cast<T>(dist(rng));
+    }
+    return keys;
+}
+
+static std::vector<std::string> create_string_keys(size_t cardinality, size_t length) {
+    std::vector<std::string> keys;
+    keys.reserve(NUM_ROWS);
+    for (auto key : create_keys<uint64_t>(cardinality)) {
+        std::string str = std::to_string(key);
+        str.resize(std::max(length, str.size()), 'x');
+        keys.emplace_back(std::move(str));
+    }
+    return keys;
+}
+
+template <typename Map, typename T>
+static void emplace_keys(benchmark::State& state, const std::vector<T>& keys) {
+    for (auto _ : state) {
+        Map map;
+        typename Map::LookupResult it;
+        bool inserted;
+        for (const auto& key : keys) {
+            map.emplace(key, it, inserted);
+            if (inserted) {
+                *lookup_result_get_mapped(it) = 0;
+            }
+            ++*lookup_result_get_mapped(it);
+        }
+        benchmark::DoNotOptimize(map.size());
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+static void BM_HashMap_UInt64_Emplace(benchmark::State& state) {
+    auto keys = create_keys<UInt64>(state.range(0));
+    emplace_keys<HashMap<UInt64, UInt64, HashCRC32<UInt64>>>(state, keys);
+}
+BENCHMARK(BM_HashMap_UInt64_Emplace)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+
+static void BM_HashMap_UInt64_Find(benchmark::State& state) {
+    auto keys = create_keys<UInt64>(state.range(0));
+    HashMap<UInt64, UInt64, HashCRC32<UInt64>> map;
+    for (auto key : keys) {
+        map[key] = key;
+    }
+    for (auto _ : state) {
+        UInt64 sum = 0;
+        for (auto key : keys) {
+            sum += *lookup_result_get_mapped(map.find(key));
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+BENCHMARK(BM_HashMap_UInt64_Find)->RangeMultiplier(32)->Range(1 << 5, 1 << 20);
+
+static void BM_FixedHashMap_UInt16_Emplace(benchmark::State& state) {
+    auto keys = create_keys<UInt16>(state.range(0));
+    emplace_keys<FixedHashMap<UInt16, UInt64>>(state, keys);
+}
+BENCHMARK(BM_FixedHashMap_UInt16_Emplace)->RangeMultiplier(8)->Range(1 << 4, 1 << 16);
+
+static void BM_FixedImplicitZeroHashMap_UInt16_Emplace(benchmark::State& state) {
+    auto keys = create_keys<UInt16>(state.range(0));
+    emplace_keys<FixedImplicitZeroHashMap<UInt16, UInt64>>(state, keys);
+}
+BENCHMARK(BM_FixedImplicitZeroHashMap_UInt16_Emplace)->RangeMultiplier(8)->Range(1 << 4, 1 << 16);
+
+// The keys are not persisted, the strings outlive the maps.
+template <typename Map>
+static void emplace_string_keys(benchmark::State& state) {
+    auto strings = create_string_keys(state.range(0), state.range(1));
+    std::vector<StringRef> keys(strings.begin(), strings.end());
+    emplace_keys<Map>(state, keys);
+}
+
+static void BM_HashMapWithSavedHash_String_Emplace(benchmark::State& state) {
+    emplace_string_keys<HashMapWithSavedHash<StringRef, UInt64>>(state);
+}
+BENCHMARK(BM_HashMapWithSavedHash_String_Emplace)
+        ->ArgsProduct({{1 << 10, 1 << 18}, {4, 12, 20, 40}});
+
+static void BM_StringHashMap_Emplace(benchmark::State& state) {
+    emplace_string_keys<StringHashMap<UInt64>>(state);
+}
+BENCHMARK(BM_StringHashMap_Emplace)->ArgsProduct({{1 << 10, 1 << 18}, {4, 12, 20, 40}});
+
+} // namespace doris::vectorized
@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/inline_string_ref.h"
+#include "vec/common/string_ref.h"
+
+namespace doris::vectorized {
+
+static constexpr size_t NUM_ROWS = 4096;
+
+// Random strings of `length` bytes sharing a common prefix of `common_prefix` bytes.
+static MutableColumnPtr create_string_column(size_t length, size_t common_prefix) {
+    std::mt19937 rng(0);
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        std::string str(length, 'x');
+        for (size_t j = std::min(common_prefix, length); j < length; ++j) {
+            str[j] = 'a' + rng() % 26;
+        }
+        column->insert_data(str.data(), str.size());
+    }
+    return column;
+}
+
+// Sort a string column by get_permutation(), comparing the inline refs or the strings.
+static void sort_strings(benchmark::State& state, bool inline_refs) {
+    auto column = create_string_column(state.range(0), state.range(1));
+    bool enabled = config::enable_vec_inline_string_sort;
+    config::enable_vec_inline_string_sort = inline_refs;
+    IColumn::Permutation perm;
+    for (auto _ : state) {
+        column->get_permutation(false, 0, 1, perm);
+        benchmark::DoNotOptimize(perm.data());
+    }
+    config::enable_vec_inline_string_sort = enabled;
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+
+static void BM_SortStrings_ColumnString(benchmark::State& state) {
+    sort_strings(state, false);
+}
+BENCHMARK(BM_SortStrings_ColumnString)->Args({8, 0})->Args({32, 0})->Args({32, 16});
+
+static void BM_SortStrings_InlineRefs(benchmark::State& state) {
+    sort_strings(state, true);
+}
+BENCHMARK(BM_SortStrings_InlineRefs)->Args({8, 0})->Args({32, 0})->Args({32, 16});
+
+// The key comparisons of a hash join probe: each probe key is compared with the build key of the
+// bucket it hashes to, a quarter of them match.
+template <typename Ref>
+static void probe_keys(benchmark::State& state) {
+    auto build_column = create_string_column(state.range(0), 0);
+    auto probe_column = create_string_column(state.range(0), 0);
+    std::mt19937 rng(1);
+    std::vector<Ref> build_keys;
+    std::vector<Ref> probe_keys;
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        build_keys.emplace_back(build_column->get_data_at(rng() % NUM_ROWS));
+        probe_keys.emplace_back(rng() % 4 == 0 ? build_keys.back()
+                                               : Ref(probe_column->get_data_at(i)));
+    }
+    for (auto _ : state) {
+        size_t matched = 0;
+        for (size_t i = 0; i < NUM_ROWS; ++i) {
+            matched += probe_keys[i] == build_keys[i];
+        }
+        benchmark::DoNotOptimize(matched);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+}
+
+static void BM_ProbeKeys_StringRef(benchmark::State& state) {
+    probe_keys<StringRef>(state);
+}
+BENCHMARK(BM_ProbeKeys_StringRef)->Arg(8)->Arg(32);
+
+static void BM_ProbeKeys_InlineRefs(benchmark::State& state) {
+    probe_keys<InlineStringRef>(state);
+}
+BENCHMARK(BM_ProbeKeys_InlineRefs)->Arg(8)->Arg(32);
+
+} // namespace doris::vectorized
@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "testutil/function_utils.h"
+#include "udf/udf.h"
+#include "udf/udf_internal.h"
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_string.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/functions/simple_function_factory.h"
+
+namespace doris::vectorized {
+
+static constexpr size_t NUM_ROWS = 4096;
+
+// Evaluate `func_name(str, pattern)` with a constant pattern on random urls.
+static void match_pattern(benchmark::State& state, const std::string& func_name,
+                          const std::string& pattern) {
+    std::mt19937 rng(0);
+    auto str_column = ColumnString::create();
+    for (size_t i = 0; i < NUM_ROWS; ++i) {
+        std::string str = "http://www.example" + std::to_string(rng() % 1000) + ".com/path/" +
+                          std::to_string(rng()) + "/index.html";
+        str_column->insert_data(str.data(), str.size());
+    }
+    auto pattern_column = ColumnString::create();
+    pattern_column->insert_data(pattern.data(), pattern.size());
+
+    Block block;
+    auto string_type = std::make_shared<DataTypeString>();
+    block.insert({std::move(str_column), string_type, "str"});
+    block.insert({ColumnConst::create(std::move(pattern_column), NUM_ROWS), string_type,
+                  "pattern"});
+
+    auto return_type = std::make_shared<DataTypeUInt8>();
+    auto func = SimpleFunctionFactory::instance().get_function(
+            func_name, block.get_columns_with_type_and_name(), return_type);
+    CHECK(func != nullptr) << func_name;
+
+    doris_udf::FunctionContext::TypeDesc string_type_desc;
+    string_type_desc.type = doris_udf::FunctionContext::TYPE_STRING;
+    doris_udf::FunctionContext::TypeDesc return_type_desc;
+    return_type_desc.type = doris_udf::FunctionContext::TYPE_BOOLEAN;
+    FunctionUtils fn_utils(return_type_desc, {string_type_desc, string_type_desc}, 0);
+    auto* fn_ctx = fn_utils.get_fn_ctx();
+    ColumnPtrWrapper constant_pattern(block.get_by_position(1).column);
+    fn_ctx->impl()->set_constant_cols({nullptr, &constant_pattern});
+    CHECK(func->prepare(fn_ctx, FunctionContext::FRAGMENT_LOCAL).ok());
+    CHECK(func->prepare(fn_ctx, FunctionContext::THREAD_LOCAL).ok());
+
+    ColumnNumbers arguments = {0, 1};
+    block.insert({nullptr, return_type, "result"});
+    for (auto _ : state) {
+        CHECK(func->execute(fn_ctx, block, arguments, 2, NUM_ROWS).ok());
+        benchmark::DoNotOptimize(block.get_by_position(2).column);
+    }
+    state.SetItemsProcessed(state.iterations() * NUM_ROWS);
+
+    func->close(fn_ctx, FunctionContext::THREAD_LOCAL);
+    func->close(fn_ctx, FunctionContext::FRAGMENT_LOCAL);
+}
+
+static void BM_Like_Substring(benchmark::State& state) {
+    match_pattern(state, "like", "%example42%");
+}
+BENCHMARK(BM_Like_Substring);
+
+static void BM_Like_StartsWith(benchmark::State& state) {
+    match_pattern(state, "like", "http://www.example4%");
+}
+BENCHMARK(BM_Like_StartsWith);
+
+static void BM_Like_EndsWith(benchmark::State& state) {
+    match_pattern(state, "like", "%/index.html");
+}
+BENCHMARK(BM_Like_EndsWith);
+
+static void BM_Like_Regexp(benchmark::State& state) {
+    match_pattern(state, "like", "http://www.example_2%.com/path/%");
+}
+BENCHMARK(BM_Like_Regexp);
+
+static void BM_Regexp(benchmark::State& state) {
+    match_pattern(state, "regexp", "example[0-9]+2\\.com/path/[0-9]+/");
+}
+BENCHMARK(BM_Regexp);
+
+} // namespace doris::vectorized
@@ -0,0 +1,123 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "olap/schema.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/olap/block_zorder_compare.h"
+
+namespace doris::vectorized {
+
+// Compare the page-level zone map pruning of the rows sorted in lexical order and in Z-order.
+// The rows have NUM_COLUMNS uniformly random columns, and the predicate of each column is a
+// range covering `state.range(0)` per mille of the values.
+static constexpr size_t NUM_ROWS = 1 << 20;
+static constexpr size_t NUM_COLUMNS = 3;
+static constexpr int32_t MAX_VALUE = 1 << 20;
+// the number of INT values in a data page of 64KB
+static constexpr size_t ROWS_PER_PAGE = 16384;
+
+static Block create_block() {
+    std::mt19937 rng(NUM_ROWS);
+    Block block;
+    for (size_t i = 0; i < NUM_COLUMNS; ++i) {
+        auto column = ColumnInt32::create();
+        for (size_t row = 0; row < NUM_ROWS; ++row) {
+            column->insert_value(rng() % MAX_VALUE);
+        }
+        block.insert({std::move(column), std::make_shared<DataTypeInt32>(),
+                      "c" + std::to_string(i)});
+    }
+    return block;
+}
+
+static Schema create_schema() {
+    std::vector<TabletColumn> columns;
+    for (size_t i = 0; i < NUM_COLUMNS; ++i) {
+        columns.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, false);
+    }
+    return Schema(columns, NUM_COLUMNS);
+}
+
+// Set the ratio of the pages skipped by the range predicate of each column as counters.
+static void count_pages_skipped(benchmark::State& state, const Block& block,
+                                const std::vector<uint32_t>& order) {
+    int32_t range = MAX_VALUE / 1000 * state.range(0);
+    // the predicates are in the middle of the value range
+    int32_t lower = (MAX_VALUE - range) / 2;
+    int32_t upper = lower + range;
+    size_t num_pages = (NUM_ROWS + ROWS_PER_PAGE - 1) / ROWS_PER_PAGE;
+    for (size_t i = 0; i < NUM_COLUMNS; ++i) {
+        const auto& column = assert_cast<const ColumnInt32&>(*block.get_by_position(i).column);
+        size_t num_skipped = 0;
+        for (size_t page = 0; page < num_pages; ++page) {
+            auto begin = order.begin() + page * ROWS_PER_PAGE;
+            auto end = order.begin() + std::min(NUM_ROWS, (page + 1) * ROWS_PER_PAGE);
+            auto min_max = std::minmax_element(begin, end, [&column](uint32_t lhs, uint32_t rhs) {
+                return column.get_element(lhs) < column.get_element(rhs);
+            });
+            if (column.get_element(*min_max.second) < lower ||
+                column.get_element(*min_max.first) >= upper) {
+                ++num_skipped;
+            }
+        }
+        state.counters["c" + std::to_string(i) + "_pages_skipped"] =
+                benchmark::Counter(double(num_skipped) / num_pages);
+    }
+}
+
+static void BM_ZoneMap_LexicalOrder(benchmark::State& state) {
+    Block block = create_block();
+    std::vector<uint32_t> order(NUM_ROWS);
+    for (auto _ : state) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&block](uint32_t lhs, uint32_t rhs) {
+            return block.compare_at(lhs, rhs, NUM_COLUMNS, block, -1) < 0;
+        });
+        benchmark::DoNotOptimize(order.data());
+    }
+    count_pages_skipped(state, block, order);
+}
+BENCHMARK(BM_ZoneMap_LexicalOrder)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+static void BM_ZoneMap_ZOrder(benchmark::State& state) {
+    Block block = create_block();
+    Schema schema = create_schema();
+    BlockZOrderComparator comparator(schema, NUM_COLUMNS);
+    std::vector<uint32_t> order(NUM_ROWS);
+    for (auto _ : state) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+                  [&block, &comparator](uint32_t lhs, uint32_t rhs) {
+                      return comparator.compare_at(lhs, rhs, block, block) < 0;
+                  });
+        benchmark::DoNotOptimize(order.data());
+    }
+    count_pages_skipped(state, block, order);
+}
+BENCHMARK(BM_ZoneMap_ZOrder)->Arg(1)->Arg(10)->Arg(100)->Unit(benchmark::kMillisecond);
+
+} // namespace doris::vectorized
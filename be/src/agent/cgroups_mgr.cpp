@@ -354,7 +354,10 @@ Status CgroupsMgr::assign_thread_to_cgroups(int64_t thread_id, const string& use
         return Status::InternalError("Cgroups not inited");
     }
     string tasks_path = _root_cgroups_path + "/" + user_name + "/" + level + "/tasks";
-    if (!is_file_exist(_root_cgroups_path + "/" + user_name)) {
+    if (level.empty()) {
+        // the cgroup of the user itself, e.g. the cgroup of a workload group
+        tasks_path = _root_cgroups_path + "/" + user_name + "/tasks";
+    } else if (!is_file_exist(_root_cgroups_path + "/" + user_name)) {
         tasks_path = this->_root_cgroups_path + "/" + _default_user_name + "/" + _default_level +
                      "/tasks";
     } else if (!is_file_exist(_root_cgroups_path + "/" + user_name + "/" + level)) {
@@ -74,7 +74,8 @@ public:
     //
     // Input parameters:
     //   thread_id: the unique id for the thread
-    //   user_name&level: the user name and level used to find the cgroup
+    //   user_name&level: the user name and level used to find the cgroup, an empty level means
+    //                    the cgroup of the user itself
     Status assign_thread_to_cgroups(int64_t thread_id, const std::string& user_name,
                                     const std::string& level);
 
@@ -99,6 +100,8 @@ public:
 
     int64_t get_cgroups_version() { return _cur_version; }
 
+    bool is_cgroups_init_success() const { return _is_cgroups_init_success; }
+
     // set the disk throttle for the user by getting resource value from the map and echo it to the cgroups.
     // currently, both the user and groups under the user are set to the same value
     // because throttle does not support hierachy.
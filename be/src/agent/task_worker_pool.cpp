@@ -20,6 +20,7 @@
 #include <pthread.h>
 #include <sys/stat.h>
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <chrono>
 #include <csignal>
@@ -55,6 +56,7 @@
 #include "util/scoped_cleanup.h"
 #include "util/stopwatch.hpp"
 #include "util/threadpool.h"
+#include "util/time.h"
 #include "util/trace.h"
 
 namespace doris {
@@ -212,6 +214,14 @@ void TaskWorkerPool::start() {
             .set_max_threads(_worker_count)
             .build(&_thread_pool);
 
+    if (_task_worker_type == TaskWorkerType::CREATE_TABLE ||
+        _task_worker_type == TaskWorkerType::DROP_TABLE) {
+        ThreadPoolBuilder(_name + "_BATCH")
+                .set_min_threads(1)
+                .set_max_threads(std::max(1, config::tablet_task_batch_parallelism))
+                .build(&_batch_thread_pool);
+    }
+
     for (int i = 0; i < _worker_count; i++) {
         auto st = _thread_pool->submit_func(cb);
         CHECK(st.ok()) << st.to_string();
@@ -226,6 +236,9 @@ void TaskWorkerPool::stop() {
         _worker_thread_condition_variable.notify_all();
     }
     _thread_pool->shutdown();
+    if (_batch_thread_pool != nullptr) {
+        _batch_thread_pool->shutdown();
+    }
 }
 
 void TaskWorkerPool::submit_task(const TAgentTaskRequest& task) {
@@ -329,131 +342,158 @@ uint32_t TaskWorkerPool::_get_next_task_index(int32_t thread_count,
     return index;
 }
 
-void TaskWorkerPool::_create_tablet_worker_thread_callback() {
-    while (_is_work) {
-        TAgentTaskRequest agent_task_req;
-        TCreateTabletReq create_tablet_req;
-        {
-            std::unique_lock<std::mutex> worker_thread_lock(_worker_thread_lock);
-            while (_is_work && _tasks.empty()) {
-                _worker_thread_condition_variable.wait(worker_thread_lock);
-            }
-            if (!_is_work) {
-                return;
-            }
+bool TaskWorkerPool::_pop_task_batch(std::vector<TAgentTaskRequest>* batch) {
+    std::unique_lock<std::mutex> worker_thread_lock(_worker_thread_lock);
+    while (_is_work && _tasks.empty()) {
+        _worker_thread_condition_variable.wait(worker_thread_lock);
+    }
+    if (!_is_work) {
+        return false;
+    }
+    size_t batch_size = std::max(1, config::tablet_task_batch_size);
+    while (!_tasks.empty() && batch->size() < batch_size) {
+        batch->push_back(std::move(_tasks.front()));
+        _tasks.pop_front();
+    }
+    return true;
+}
 
-            agent_task_req = _tasks.front();
-            create_tablet_req = agent_task_req.create_tablet_req;
-            _tasks.pop_front();
+void TaskWorkerPool::_run_task_batch(
+        const std::vector<TAgentTaskRequest>& batch,
+        const std::function<void(const TAgentTaskRequest&)>& run_task) {
+    if (batch.size() == 1 || _batch_thread_pool == nullptr) {
+        for (const auto& task : batch) {
+            run_task(task);
         }
-
-        scoped_refptr<Trace> trace(new Trace);
-        MonotonicStopWatch watch;
-        watch.start();
-        SCOPED_CLEANUP({
-            if (watch.elapsed_time() / 1e9 > config::agent_task_trace_threshold_sec) {
-                LOG(WARNING) << "Trace:" << std::endl << trace->DumpToString(Trace::INCLUDE_ALL);
-            }
+        return;
+    }
+    CountDownLatch latch(batch.size());
+    for (const auto& task : batch) {
+        Status st = _batch_thread_pool->submit_func([&run_task, &task, &latch]() {
+            run_task(task);
+            latch.count_down();
         });
-        ADOPT_TRACE(trace.get());
-        TRACE("start to create tablet $0", create_tablet_req.tablet_id);
-
-        TStatusCode::type status_code = TStatusCode::OK;
-        std::vector<string> error_msgs;
-        TStatus task_status;
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to submit the tablet task to the batch thread pool: "
+                         << st.to_string() << ", run it in the worker thread";
+            run_task(task);
+            latch.count_down();
+        }
+    }
+    latch.wait();
+}
 
-        std::vector<TTabletInfo> finish_tablet_infos;
-        Status create_status = _env->storage_engine()->create_tablet(create_tablet_req);
-        if (!create_status.ok()) {
-            LOG(WARNING) << "create table failed. status: " << create_status
-                         << ", signature: " << agent_task_req.signature;
-            status_code = TStatusCode::RUNTIME_ERROR;
-        } else {
-            ++_s_report_version;
-            // get path hash of the created tablet
-            TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
-                    create_tablet_req.tablet_id);
-            DCHECK(tablet != nullptr);
-            TTabletInfo tablet_info;
-            tablet_info.tablet_id = tablet->table_id();
-            tablet_info.schema_hash = tablet->schema_hash();
-            tablet_info.version = create_tablet_req.version;
-            // Useless but it is a required field in TTabletInfo
-            tablet_info.version_hash = 0;
-            tablet_info.row_count = 0;
-            tablet_info.data_size = 0;
-            tablet_info.__set_path_hash(tablet->data_dir()->path_hash());
-            finish_tablet_infos.push_back(tablet_info);
+void TaskWorkerPool::_create_tablet_worker_thread_callback() {
+    while (_is_work) {
+        std::vector<TAgentTaskRequest> batch;
+        if (!_pop_task_batch(&batch)) {
+            return;
         }
+        _run_task_batch(batch, [this](const TAgentTaskRequest& task) { _create_tablet(task); });
+    }
+}
 
-        task_status.__set_status_code(status_code);
-        task_status.__set_error_msgs(error_msgs);
+void TaskWorkerPool::_create_tablet(const TAgentTaskRequest& agent_task_req) {
+    const TCreateTabletReq& create_tablet_req = agent_task_req.create_tablet_req;
+    scoped_refptr<Trace> trace(new Trace);
+    MonotonicStopWatch watch;
+    watch.start();
+    SCOPED_CLEANUP({
+        if (watch.elapsed_time() / 1e9 > config::agent_task_trace_threshold_sec) {
+            LOG(WARNING) << "Trace:" << std::endl << trace->DumpToString(Trace::INCLUDE_ALL);
+        }
+    });
+    ADOPT_TRACE(trace.get());
+    TRACE("start to create tablet $0", create_tablet_req.tablet_id);
 
-        TFinishTaskRequest finish_task_request;
-        finish_task_request.__set_finish_tablet_infos(finish_tablet_infos);
-        finish_task_request.__set_backend(_backend);
-        finish_task_request.__set_report_version(_s_report_version);
-        finish_task_request.__set_task_type(agent_task_req.task_type);
-        finish_task_request.__set_signature(agent_task_req.signature);
-        finish_task_request.__set_task_status(task_status);
+    TStatusCode::type status_code = TStatusCode::OK;
+    std::vector<string> error_msgs;
+    TStatus task_status;
 
-        _finish_task(finish_task_request);
-        _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
+    std::vector<TTabletInfo> finish_tablet_infos;
+    Status create_status = _env->storage_engine()->create_tablet(create_tablet_req);
+    if (!create_status.ok()) {
+        LOG(WARNING) << "create table failed. status: " << create_status
+                     << ", signature: " << agent_task_req.signature;
+        status_code = TStatusCode::RUNTIME_ERROR;
+    } else {
+        ++_s_report_version;
+        // get path hash of the created tablet
+        TabletSharedPtr tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+                create_tablet_req.tablet_id);
+        DCHECK(tablet != nullptr);
+        TTabletInfo tablet_info;
+        tablet_info.tablet_id = tablet->table_id();
+        tablet_info.schema_hash = tablet->schema_hash();
+        tablet_info.version = create_tablet_req.version;
+        // Useless but it is a required field in TTabletInfo
+        tablet_info.version_hash = 0;
+        tablet_info.row_count = 0;
+        tablet_info.data_size = 0;
+        tablet_info.__set_path_hash(tablet->data_dir()->path_hash());
+        finish_tablet_infos.push_back(tablet_info);
     }
+
+    task_status.__set_status_code(status_code);
+    task_status.__set_error_msgs(error_msgs);
+
+    TFinishTaskRequest finish_task_request;
+    finish_task_request.__set_finish_tablet_infos(finish_tablet_infos);
+    finish_task_request.__set_backend(_backend);
+    finish_task_request.__set_report_version(_s_report_version);
+    finish_task_request.__set_task_type(agent_task_req.task_type);
+    finish_task_request.__set_signature(agent_task_req.signature);
+    finish_task_request.__set_task_status(task_status);
+
+    _finish_task(finish_task_request);
+    _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
 }
 
 void TaskWorkerPool::_drop_tablet_worker_thread_callback() {
     while (_is_work) {
-        TAgentTaskRequest agent_task_req;
-        TDropTabletReq drop_tablet_req;
-        {
-            std::unique_lock<std::mutex> worker_thread_lock(_worker_thread_lock);
-            while (_is_work && _tasks.empty()) {
-                _worker_thread_condition_variable.wait(worker_thread_lock);
-            }
-            if (!_is_work) {
-                return;
-            }
-
-            agent_task_req = _tasks.front();
-            drop_tablet_req = agent_task_req.drop_tablet_req;
-            _tasks.pop_front();
+        std::vector<TAgentTaskRequest> batch;
+        if (!_pop_task_batch(&batch)) {
+            return;
         }
+        _run_task_batch(batch, [this](const TAgentTaskRequest& task) { _drop_tablet(task); });
+    }
+}
 
-        TStatusCode::type status_code = TStatusCode::OK;
-        std::vector<string> error_msgs;
-        TStatus task_status;
-        string err;
-        TabletSharedPtr dropped_tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
-                drop_tablet_req.tablet_id, false, &err);
-        if (dropped_tablet != nullptr) {
-            Status drop_status = StorageEngine::instance()->tablet_manager()->drop_tablet(
-                    drop_tablet_req.tablet_id);
-            if (!drop_status.ok()) {
-                LOG(WARNING) << "drop table failed! signature: " << agent_task_req.signature;
-                error_msgs.push_back("drop table failed!");
-                status_code = TStatusCode::RUNTIME_ERROR;
-            }
-            // if tablet is dropped by fe, then the related txn should also be removed
-            StorageEngine::instance()->txn_manager()->force_rollback_tablet_related_txns(
-                    dropped_tablet->data_dir()->get_meta(), drop_tablet_req.tablet_id,
-                    drop_tablet_req.schema_hash, dropped_tablet->tablet_uid());
-        } else {
-            status_code = TStatusCode::NOT_FOUND;
-            error_msgs.push_back(err);
+void TaskWorkerPool::_drop_tablet(const TAgentTaskRequest& agent_task_req) {
+    const TDropTabletReq& drop_tablet_req = agent_task_req.drop_tablet_req;
+    TStatusCode::type status_code = TStatusCode::OK;
+    std::vector<string> error_msgs;
+    TStatus task_status;
+    string err;
+    TabletSharedPtr dropped_tablet = StorageEngine::instance()->tablet_manager()->get_tablet(
+            drop_tablet_req.tablet_id, false, &err);
+    if (dropped_tablet != nullptr) {
+        Status drop_status = StorageEngine::instance()->tablet_manager()->drop_tablet(
+                drop_tablet_req.tablet_id);
+        if (!drop_status.ok()) {
+            LOG(WARNING) << "drop table failed! signature: " << agent_task_req.signature;
+            error_msgs.push_back("drop table failed!");
+            status_code = TStatusCode::RUNTIME_ERROR;
         }
-        task_status.__set_status_code(status_code);
-        task_status.__set_error_msgs(error_msgs);
+        // if tablet is dropped by fe, then the related txn should also be removed
+        StorageEngine::instance()->txn_manager()->force_rollback_tablet_related_txns(
+                dropped_tablet->data_dir()->get_meta(), drop_tablet_req.tablet_id,
+                drop_tablet_req.schema_hash, dropped_tablet->tablet_uid());
+    } else {
+        status_code = TStatusCode::NOT_FOUND;
+        error_msgs.push_back(err);
+    }
+    task_status.__set_status_code(status_code);
+    task_status.__set_error_msgs(error_msgs);
 
-        TFinishTaskRequest finish_task_request;
-        finish_task_request.__set_backend(_backend);
-        finish_task_request.__set_task_type(agent_task_req.task_type);
-        finish_task_request.__set_signature(agent_task_req.signature);
-        finish_task_request.__set_task_status(task_status);
+    TFinishTaskRequest finish_task_request;
+    finish_task_request.__set_backend(_backend);
+    finish_task_request.__set_task_type(agent_task_req.task_type);
+    finish_task_request.__set_signature(agent_task_req.signature);
+    finish_task_request.__set_task_status(task_status);
 
-        _finish_task(finish_task_request);
-        _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
-    }
+    _finish_task(finish_task_request);
+    _remove_task_info(agent_task_req.task_type, agent_task_req.signature);
 }
 
 void TaskWorkerPool::_alter_tablet_worker_thread_callback() {
@@ -1169,6 +1209,9 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
     TReportRequest request;
     request.__set_backend(_backend);
     request.__isset.tablets = true;
+    // the first report is a full one, FE deletes the tablets missing in a full report
+    bool need_full_report = true;
+    int64_t last_full_report_time = 0;
     while (_is_work) {
         _is_doing_work = false;
 
@@ -1192,9 +1235,17 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
         _random_sleep(5);
         request.tablets.clear();
         uint64_t report_version = _s_report_version;
+        TabletManager* tablet_manager = StorageEngine::instance()->tablet_manager();
+        bool full_report = need_full_report || !config::enable_incremental_tablet_report ||
+                           UnixSeconds() - last_full_report_time >=
+                                   config::full_tablet_report_interval_seconds;
         Status build_all_report_tablets_info_status =
-                StorageEngine::instance()->tablet_manager()->build_all_report_tablets_info(
-                        &request.tablets);
+                full_report ? tablet_manager->build_all_report_tablets_info(&request.tablets)
+                            : tablet_manager->build_incremental_report_tablets_info(
+                                      &request.tablets);
+        // the dirty tablets are consumed by the build, so a report not sent or not accepted
+        // is followed by a full one
+        need_full_report = true;
         if (report_version < _s_report_version) {
             // TODO llj This can only reduce the possibility for report error, but can't avoid it.
             // If FE create a tablet in FE meta and send CREATE task to this BE, the tablet may not be included in this
@@ -1215,7 +1266,14 @@ void TaskWorkerPool::_report_tablet_worker_thread_callback() {
                          DorisMetrics::instance()->tablet_base_max_compaction_score->value());
         request.__set_tablet_max_compaction_score(max_compaction_score);
         request.__set_report_version(report_version);
-        _handle_report(request, ReportType::TABLET);
+        request.__set_is_incremental(!full_report);
+        request.__set_tablets_checksum(tablet_manager->report_tablets_checksum());
+        if (_handle_report(request, ReportType::TABLET)) {
+            need_full_report = false;
+            if (full_report) {
+                last_full_report_time = UnixSeconds();
+            }
+        }
     }
     StorageEngine::instance()->deregister_report_listener(this);
 }
@@ -1554,7 +1612,7 @@ Status TaskWorkerPool::_move_dir(const TTabletId tablet_id, const std::string& s
     return Status::OK();
 }
 
-void TaskWorkerPool::_handle_report(TReportRequest& request, ReportType type) {
+bool TaskWorkerPool::_handle_report(TReportRequest& request, ReportType type) {
     TMasterResult result;
     Status status = _master_client->report(request, &result);
     bool is_report_success = false;
@@ -1601,6 +1659,7 @@ void TaskWorkerPool::_handle_report(TReportRequest& request, ReportType type) {
     default:
         break;
     }
+    return is_report_success;
 }
 
 void TaskWorkerPool::_random_sleep(int second) {
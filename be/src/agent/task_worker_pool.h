@@ -20,6 +20,7 @@
 
 #include <atomic>
 #include <deque>
+#include <functional>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -171,6 +172,15 @@ private:
     uint32_t _get_next_task_index(int32_t thread_count, std::deque<TAgentTaskRequest>& tasks,
                                   TPriority::type priority);
 
+    // Wait for the queued tasks and take at most tablet_task_batch_size of them, return false
+    // if the pool is stopped.
+    bool _pop_task_batch(std::vector<TAgentTaskRequest>* batch);
+    // Run the tasks of the batch by the batch threads in parallel, and wait for them.
+    void _run_task_batch(const std::vector<TAgentTaskRequest>& batch,
+                         const std::function<void(const TAgentTaskRequest&)>& run_task);
+    void _create_tablet(const TAgentTaskRequest& agent_task_req);
+    void _drop_tablet(const TAgentTaskRequest& agent_task_req);
+
     void _create_tablet_worker_thread_callback();
     void _drop_tablet_worker_thread_callback();
     void _push_worker_thread_callback();
@@ -194,7 +204,8 @@ private:
 
     void _alter_tablet(const TAgentTaskRequest& alter_tablet_request, int64_t signature,
                        const TTaskType::type task_type, TFinishTaskRequest* finish_task_request);
-    void _handle_report(TReportRequest& request, ReportType type);
+    // return true if FE accepts the report
+    bool _handle_report(TReportRequest& request, ReportType type);
 
     Status _get_tablet_info(const TTabletId tablet_id, const TSchemaHash schema_hash,
                             int64_t signature, TTabletInfo* tablet_info);
@@ -229,6 +240,8 @@ private:
     bool _is_work;
     ThreadModel _thread_model;
     std::unique_ptr<ThreadPool> _thread_pool;
+    // runs the batches of the create and drop tablet tasks
+    std::unique_ptr<ThreadPool> _batch_thread_pool;
     // Only meaningful when _thread_model is MULTI_THREADS
     std::deque<TAgentTaskRequest> _tasks;
     // Only meaningful when _thread_model is SINGLE_THREAD
@@ -76,12 +76,23 @@ CONF_Int32(heartbeat_service_thread_count, "1");
 CONF_Int32(create_tablet_worker_count, "3");
 // the count of thread to drop table
 CONF_Int32(drop_tablet_worker_count, "3");
+// A create or drop tablet worker takes at most tablet_task_batch_size queued tasks at a time,
+// and runs them by the tablet_task_batch_parallelism threads shared by the workers, so the
+// tablet metas written by them to a data dir are committed by the meta group commit together.
+CONF_mInt32(tablet_task_batch_size, "64");
+CONF_Int32(tablet_task_batch_parallelism, "16");
 // the count of thread to batch load
 CONF_Int32(push_worker_count_normal_priority, "3");
 // the count of thread to high priority batch load
 CONF_Int32(push_worker_count_high_priority, "3");
 // the count of thread to publish version
 CONF_Int32(publish_version_worker_count, "8");
+// the count of thread to add the visible rowsets to the tablets of the publish version tasks,
+// shared by all the publish version workers
+CONF_Int32(publish_version_tablet_thread_num, "32");
+// the max number of the tablets of a publish version task which are published in parallel,
+// 1 means the tablets are published one by one by the publish version worker
+CONF_mInt32(publish_version_tablet_parallelism, "8");
 // the count of thread to clear transaction task
 CONF_Int32(clear_transaction_task_worker_count, "1");
 // the count of thread to delete
@@ -98,6 +109,9 @@ CONF_Int32(check_consistency_worker_count, "1");
 CONF_Int32(upload_worker_count, "1");
 // the count of thread to download
 CONF_Int32(download_worker_count, "1");
+// the number of the files transferred in parallel by an upload or download task of backup
+// and restore
+CONF_mInt32(snapshot_transfer_parallelism, "4");
 // the count of thread to make snapshot
 CONF_Int32(make_snapshot_worker_count, "5");
 // the count of thread to release snapshot
@@ -108,12 +122,28 @@ CONF_mInt32(report_task_interval_seconds, "10");
 CONF_mInt32(report_disk_state_interval_seconds, "60");
 // the interval time(seconds) for agent report olap table to FE
 CONF_mInt32(report_tablet_interval_seconds, "60");
+// Whether to report only the tablets changed since the last report, the full report is still
+// sent every full_tablet_report_interval_seconds. Enable it only after all the FEs are upgraded
+// to support the incremental report.
+CONF_mBool(enable_incremental_tablet_report, "false");
+// the interval time(seconds) for agent report all the olap tables to FE, if the incremental
+// report is enabled
+CONF_mInt32(full_tablet_report_interval_seconds, "600");
 // the max download speed(KB/s)
 CONF_mInt32(max_download_speed_kbps, "50000");
 // download low speed limit(KB/s)
 CONF_mInt32(download_low_speed_limit_kbps, "50");
 // download low speed time(seconds)
 CONF_mInt32(download_low_speed_time, "300");
+// the number of the files of a tablet downloaded in parallel by a clone
+CONF_mInt32(clone_download_parallelism, "4");
+// the total download speed(MB/s) of the clones to a data dir, 0 means no limit. It should be
+// larger than download_low_speed_limit_kbps * clone_download_parallelism, or the downloads
+// may be aborted for being too slow.
+CONF_mInt32(clone_disk_download_speed_limit_mbps, "0");
+// verify the crc32c of the files downloaded by a clone, computed while downloading, with the
+// crc32c computed by the source backend, which costs the source an extra read of the files
+CONF_mBool(clone_verify_checksum, "false");
 // sleep time for one second
 CONF_Int32(sleep_one_second, "1");
 
@@ -139,6 +169,12 @@ CONF_Int32(be_service_threads, "64");
 // cgroups allocated for doris
 CONF_String(doris_cgroups, "");
 
+// the workload groups isolating the queries on this backend, in the format of
+// "name:cpu_share=1024,memory_limit=40%,max_concurrency=10;name:...", a query runs in the group
+// named by its query option workload_group. memory_limit is a memory spec, the percentage is of
+// the process memory limit. The cgroups of the groups are created under doris_cgroups.
+CONF_String(workload_groups, "");
+
 // Controls the number of threads to run work per core.  It's common to pick 2x
 // or 3x the number of cores.  This keeps the cores busy without causing excessive
 // thrashing.
@@ -165,6 +201,9 @@ CONF_mInt32(thrift_connect_timeout_seconds, "3");
 CONF_mInt64(thrift_client_retry_interval_ms, "1000");
 // max row count number for single scan range, used in segmentv1
 CONF_mInt32(doris_scan_range_row_count, "524288");
+// the max number of the short keys of a segment sampled to split the scan of a merge-on-read
+// unique key tablet by the keys, which bounds the cost of splitting on every query
+CONF_mInt32(doris_scan_range_split_keys_per_segment, "64");
 // max bytes number for single scan range, used in segmentv2
 CONF_mInt32(doris_scan_range_max_mb, "0");
 // size of scanner queue between scanner thread and compute thread
@@ -173,6 +212,39 @@ CONF_mInt32(doris_scanner_queue_size, "1024");
 CONF_mInt32(doris_scanner_row_num, "16384");
 // single read execute fragment row bytes
 CONF_mInt32(doris_scanner_row_bytes, "10485760");
+// the max time in milliseconds of a vectorized olap scan task before yielding its thread,
+// 0 means no time limit
+CONF_mInt32(doris_scanner_time_slice_ms, "10");
+// whether to share the scan threads among the queries by weighted fair queueing, the weight
+// of a query is the cpu_share of its workload group, or 1024 times the cpu_limit of its
+// resource limit if it's not in a workload group
+CONF_Bool(enable_fair_scan_scheduler, "true");
+// whether to run the scan threads of a store path on the NUMA node closest to its disk, only
+// works with doris_enable_scanner_thread_pool_per_disk
+CONF_Bool(enable_numa_aware_scanner, "false");
+// The preferred bytes of a vectorized block, the scanners, the olap scan node and the exchange
+// sender size their blocks by the observed row width to get close to it. 0 means the blocks are
+// sized by the batch size of the query. It can be overridden by the query option.
+CONF_mInt64(preferred_block_size_bytes, "0");
+// The max rows of a block sized by preferred_block_size_bytes.
+CONF_mInt32(adaptive_block_max_rows, "65536");
+// The min ratio of the rows kept by a filter to defer the copy of the rows, with a lower
+// ratio the rows are copied at once since skipping the rows not selected costs more.
+CONF_mDouble(block_selection_min_density, "0.5");
+// The max ratio of the rows to evaluate the right side of AND/OR and the branches of CASE only on
+// the undecided rows, with a higher ratio they are evaluated on the whole block since filtering
+// the input and scattering the result back cost more than they save.
+CONF_mDouble(selective_eval_max_density, "0.3");
+// Whether the subexpressions repeated in the exprs of an operator, e.g. the grouping exprs and
+// the inputs of the aggregate functions, are executed once for a block.
+CONF_Bool(enable_common_subexpr_elimination, "true");
+// Whether an OR of LIKE and REGEXP predicates with constant patterns on the same string matches
+// all the patterns in one pass of the string, by hyperscan if Doris is built WITH_HYPERSCAN and
+// by RE2::Set otherwise.
+CONF_Bool(enable_multi_pattern_match, "true");
+// The max bytes of a json column whose rows parsed by simdjson are kept by a thread, so the json
+// functions on the same column share the parse. The larger columns are parsed row by row.
+CONF_mInt64(json_parse_cache_max_bytes, "16777216");
 // number of max scan keys
 CONF_mInt32(doris_max_scan_key_num, "1024");
 // the max number of push down values of a single column.
@@ -189,6 +261,12 @@ CONF_mInt64(column_dictionary_key_ratio_threshold, "0");
 CONF_mInt64(column_dictionary_key_size_threshold, "0");
 // memory_limitation_per_thread_for_schema_change_bytes unit bytes
 CONF_mInt64(memory_limitation_per_thread_for_schema_change_bytes, "2147483648");
+// Convert the historical rowsets of a schema change by the vectorized engine, the blocks are
+// converted by the vectorized cast functions and sorted by sort_block. The schema changes
+// which aren't supported by the vectorized engine, such as the materialized view functions,
+// the type conversions other than between the integers and the sorting of the tablets of the
+// aggregate and unique keys, are still converted row by row.
+CONF_mBool(enable_vectorized_alter_table, "false");
 CONF_mInt64(memory_limitation_per_thread_for_storage_migration_bytes, "100000000");
 
 // the clean interval of file descriptor cache and segment cache
@@ -220,6 +298,18 @@ CONF_mInt32(trash_file_expire_time_sec, "259200");
 CONF_mBool(row_nums_check, "true");
 //file descriptors cache, by default, cache 32768 descriptors
 CONF_Int32(file_descriptor_cache_capacity, "32768");
+// The eviction policy of file descriptor cache, "LRU" or "CLOCK".
+// The lookups of CLOCK cache don't contend on a mutex, which is better for high QPS.
+CONF_String(file_descriptor_cache_policy, "LRU");
+// Whether to read a batch of ranges of a local file by io_uring, falls back to pread
+// if io_uring is not supported by the kernel.
+CONF_mBool(enable_io_uring_read, "false");
+// The submission queue depth of the io_uring of each thread
+CONF_Int32(io_uring_queue_depth, "64");
+// Whether to read the segment files by direct IO, bypassing the OS page cache, so that the
+// storage page cache is the only cache of the segment pages and could be sized as the
+// memory for caching.
+CONF_Bool(enable_segment_direct_io_read, "false");
 // minimum file descriptor number
 // modify them upon necessity
 CONF_Int32(min_file_descriptor_number, "60000");
@@ -230,8 +320,32 @@ CONF_String(storage_page_cache_limit, "20%");
 // Percentage for index page cache
 // all storage page cache will be divided into data_page_cache and index_page_cache
 CONF_Int32(index_page_cache_percentage, "10");
+// Percentage of the data page cache used by the decoded page cache, which keeps the decoded
+// values of the bitshuffle and dictionary encoded data pages, so the pages hit in it are not
+// decoded again. 0 means the decoded page cache is disabled.
+CONF_Int32(decoded_page_cache_percentage, "0");
+// Only the data pages of at most this size after decoding are kept in the decoded page cache.
+CONF_mInt32(decoded_page_cache_max_page_bytes, "65536");
 // whether to disable page cache feature in storage
 CONF_Bool(disable_storage_page_cache, "false");
+// The eviction policy of data page cache, "LRU", "SLRU" or "CLOCK". With SLRU, the pages read only once,
+// e.g. by a big scan, can not flush the pages which are read frequently out of the cache.
+CONF_String(data_page_cache_policy, "LRU");
+// Percentage of the data page cache capacity for the protected segment of SLRU
+CONF_Int32(data_page_cache_slru_protected_percentage, "80");
+// The scan without any key range on a tablet which has at least this number of rows reads
+// the pages through the page cache but does not insert the missed pages into it.
+// 0 means never bypass the page cache.
+CONF_mInt64(storage_page_cache_bypass_scan_rows, "0");
+
+// The number of data pages read ahead for each column of a query scan, so that the scanner
+// doesn't wait for the IO at every page boundary. 0 means no read-ahead.
+CONF_mInt32(column_page_prefetch_depth, "0");
+// The max number of data pages read ahead but not consumed yet by all the scanners
+// of a scan node.
+CONF_mInt32(column_page_prefetch_max_pages_per_scan, "256");
+// The number of threads to read ahead the data pages, shared by all queries
+CONF_Int32(column_page_prefetch_thread_num, "16");
 
 CONF_Bool(enable_storage_vectorization, "false");
 
@@ -242,6 +356,22 @@ CONF_Bool(enable_low_cardinality_optimize, "false");
 CONF_mBool(disable_auto_compaction, "false");
 // whether enable vectorized compaction
 CONF_Bool(enable_vectorized_compaction, "false");
+// whether enable vertical compaction, which merges the key columns first and then merges the
+// value columns group by group to bound the memory of compacting wide tables.
+// only works with vectorized compaction, and tables of AGG_KEYS are compacted horizontally.
+CONF_mBool(enable_vertical_compaction, "false");
+// the number of value columns in one column group of vertical compaction
+CONF_mInt32(vertical_compaction_num_columns_per_group, "5");
+// whether enable building the output rowset of compaction by linking the segment files of the
+// input rowsets, when their keys are ordered and not overlapping and there is no delete predicate
+CONF_mBool(enable_trivial_move_compaction, "true");
+// the max number of the key ranges of a tablet merged in parallel by one compaction, the input
+// rowsets are split into ranges of `compaction_key_range_bytes` by the short key index.
+// only works with vectorized compaction, 1 means disabled.
+CONF_mInt32(compaction_key_range_parallelism, "1");
+CONF_mInt64(compaction_key_range_bytes, "10737418240");
+// the count of thread to merge the key ranges of the compactions, shared by all the compactions
+CONF_Int32(compaction_key_range_thread_num, "8");
 // check the configuration of auto compaction in seconds when auto compaction disabled
 CONF_mInt32(check_auto_compaction_interval_seconds, "5");
 
@@ -257,7 +387,7 @@ CONF_mInt32(base_compaction_write_mbytes_per_sec, "5");
 // lower write amplification, trading off read amplification and space amplification.
 CONF_mString(cumulative_compaction_policy, "size_based");
 CONF_Validator(cumulative_compaction_policy, [](const std::string config) -> bool {
-    return config == "size_based" || config == "num_based";
+    return config == "size_based" || config == "num_based" || config == "time_series";
 });
 
 // In size_based policy, output rowset of cumulative compaction total disk size exceed this config size,
@@ -277,6 +407,13 @@ CONF_mInt64(cumulative_size_based_promotion_min_size_mbytes, "64");
 // this size, size_based policy may not do to cumulative compaction. The unit is m byte.
 CONF_mInt64(cumulative_size_based_compaction_lower_size_mbytes, "64");
 
+// time series policy: the goal size of the output rowset of cumulative compaction, and the count
+// and the age thresholds of the cumulative rowsets to compact before they reach the goal size.
+// the policy is used by the tablets whose table property "compaction_policy" is "time_series".
+CONF_mInt64(time_series_compaction_goal_size_mbytes, "1024");
+CONF_mInt64(time_series_compaction_file_count_threshold, "200");
+CONF_mInt64(time_series_compaction_time_threshold_seconds, "3600");
+
 // cumulative compaction policy: min and max delta file's number
 CONF_mInt64(min_cumulative_compaction_num_singleton_deltas, "5");
 CONF_mInt64(max_cumulative_compaction_num_singleton_deltas, "1000");
@@ -329,6 +466,19 @@ CONF_mInt64(tablet_scan_frequency_time_node_interval_second, "300");
 // coefficient for tablet scan frequency and compaction score when finding a tablet for compaction
 CONF_mInt32(compaction_tablet_scan_frequency_factor, "0");
 CONF_mInt32(compaction_tablet_compaction_score_factor, "1");
+// Policy to pick the tablet to compact on each data dir.
+// Valid configs: score, cost_based
+// score policy, pick the tablet with the highest weighted sum of compaction score and scan frequency,
+// see the two factors above.
+// cost_based policy, pick the tablet with the highest read amplification saving per byte rewritten,
+// weighted by the scan frequency, and limit the compaction tasks on the disks with high io util.
+CONF_mString(compaction_tablet_pick_policy, "score");
+CONF_Validator(compaction_tablet_pick_policy, [](const std::string config) -> bool {
+    return config == "score" || config == "cost_based";
+});
+// In cost_based policy, only one compaction task can be running on a disk whose io util percent
+// reaches this config, which is reserved for cumulative compaction.
+CONF_mInt32(compaction_cost_based_max_disk_io_util_percent, "80");
 
 // This config can be set to limit thread number in tablet migration thread pool.
 CONF_Int32(min_tablet_migration_threads, "1");
@@ -353,6 +503,15 @@ CONF_Int64(load_data_reserve_hours, "4");
 // log error log will be removed after this time
 CONF_mInt64(load_error_log_reserve_hours, "48");
 CONF_Int32(number_tablet_writer_threads, "16");
+// The brpc handlers which may block, e.g. preparing the plan fragments or folding the constant
+// exprs, run in a pool of this many threads, so that they don't hold the brpc threads, which
+// are left for the light handlers like the heartbeats and the cancels. The requests fail if
+// more than brpc_heavy_work_pool_max_queue_size tasks are waiting.
+CONF_Int32(brpc_heavy_work_pool_threads, "64");
+CONF_Int32(brpc_heavy_work_pool_max_queue_size, "10240");
+// The max number of the prepared statements of the point queries whose return columns are
+// cached, the least recently used ones are evicted.
+CONF_Int32(point_query_prepared_statement_cache_size, "1024");
 
 // The maximum amount of data that can be processed by a stream load
 CONF_mInt64(streaming_load_max_mb, "10240");
@@ -360,6 +519,28 @@ CONF_mInt64(streaming_load_max_mb, "10240");
 // Therefore, it is necessary to limit the maximum number of
 // such data when using stream load to prevent excessive memory consumption.
 CONF_mInt64(streaming_load_json_max_mb, "100");
+// The max bytes of the body of a stream load buffered in its pipe, i.e. received but not
+// parsed yet. A deeper pipe lets the receive of the body overlap more with the parsing.
+CONF_mInt64(stream_load_pipe_buffer_bytes, "1048576");
+// The number of the threads to parse the body of a csv stream load by the vectorized engine.
+// The body is split into chunks of whole lines, which are parsed in parallel and loaded in the
+// order of the body. The json bodies, such as the kafka messages of a routine load, are split
+// into chunks of whole messages. 1 means the body is parsed by the scanner thread only.
+CONF_mInt32(stream_load_parse_parallelism, "1");
+// The bytes of a chunk of the body of a stream load parsed in parallel.
+CONF_mInt64(stream_load_parse_chunk_bytes, "8388608");
+// The dir of the write ahead logs of the group committed stream loads. The body of a stream load
+// with the header 'group_commit: true' is acknowledged once it's synced to a wal here, and is
+// loaded with the other loads of the same table and params in one transaction later.
+CONF_String(group_commit_wal_path, "${DORIS_HOME}/wal");
+// A group commit batch is committed after it has been open for this time,
+CONF_mInt32(group_commit_interval_ms, "10000");
+// or once the bytes of its loads reach this size. A group committed load can't be larger than it.
+CONF_mInt64(group_commit_data_bytes, "67108864");
+// The number of the threads to commit the group commit batches.
+CONF_Int32(group_commit_flush_threads, "4");
+// A group commit batch failed to load is loaded again in a new transaction after this time.
+CONF_mInt32(group_commit_retry_interval_ms, "10000");
 // the alive time of a TabletsChannel.
 // If the channel does not receive any data till this time,
 // the channel will be removed.
@@ -369,6 +550,21 @@ CONF_mInt32(streaming_load_rpc_max_alive_time_sec, "1200");
 CONF_Int32(tablet_writer_open_rpc_timeout_sec, "60");
 // You can ignore brpc error '[E1011]The server is overcrowded' when writing data.
 CONF_mBool(tablet_writer_ignore_eovercrowded, "false");
+// Whether the vectorized tablet writer sends the blocks through a brpc stream, which keeps
+// several packets in flight instead of waiting for the result of each add_block rpc.
+// The sender falls back to the add_block rpcs if the stream can't be created.
+CONF_mBool(enable_tablet_writer_stream, "false");
+// The max bytes of the packets in flight of a tablet writer stream, including the ones received
+// but not yet written by the receiver.
+CONF_mInt64(tablet_writer_stream_max_buf_bytes, "67108864");
+// If true, the load sinks only send the rows of a tablet to its first replica, which builds the
+// rowset and asks the other replicas to download the segment files of the rowset after it's
+// committed, so the other replicas don't sort, encode and flush the rows again.
+CONF_mBool(enable_single_replica_load, "false");
+// the timeout of a rpc to ask a slave replica to pull the rowset in the single replica load
+CONF_mInt32(slave_replica_pull_rowset_rpc_timeout_sec, "300");
+// the number of threads of the slave replicas to pull the rowsets in the single replica load
+CONF_Int32(number_slave_replica_download_threads, "64");
 // Whether to enable stream load record function, the default is false.
 // False: disable stream load record
 CONF_mBool(enable_stream_load_record, "false");
@@ -388,6 +584,17 @@ CONF_mInt32(olap_table_sink_send_interval_ms, "1");
 CONF_Int32(fragment_pool_thread_num_min, "64");
 CONF_Int32(fragment_pool_thread_num_max, "512");
 CONF_Int32(fragment_pool_queue_size, "2048");
+// whether the fragment and compaction thread pools queue their tasks to per-worker queues, and
+// the idle workers steal from the others, instead of sharing a single queue
+CONF_Bool(enable_work_stealing_thread_pool, "false");
+
+// The admission control of the select queries. The fragments of a query wait in the queue when
+// query_queue_max_running_queries queries are running, or the memory limits of the running
+// queries plus the query's exceed query_queue_reservable_mem_percent of the process memory
+// limit. 0 means no limit. The waiting fragments are cancelled after query_queue_timeout_ms.
+CONF_mInt32(query_queue_max_running_queries, "0");
+CONF_mInt32(query_queue_reservable_mem_percent, "0");
+CONF_mInt64(query_queue_timeout_ms, "60000");
 
 // Control the number of disks on the machine.  If 0, this comes from the system settings.
 CONF_Int32(num_disks, "0");
@@ -419,6 +626,11 @@ CONF_Bool(use_mmap_allocate_chunk, "false");
 // acquire more free memory which can not be used by other modules
 CONF_Int64(chunk_reserved_bytes_limit, "2147483648");
 
+// The max bytes of the freed mmapped chunks kept by the vectorized Allocator (of PODArray, Arena
+// and the hash tables) to be reused by the following allocations of the same sizes, instead of
+// mmap and munmap them again. 0 disables the cache.
+CONF_mInt64(vec_allocator_chunk_cache_bytes, "1073741824");
+
 // The probing algorithm of partitioned hash table.
 // Enable quadratic probing hash table
 CONF_Bool(enable_quadratic_probing, "false");
@@ -426,11 +638,27 @@ CONF_Bool(enable_quadratic_probing, "false");
 // for pprof
 CONF_String(pprof_profile_dir, "${DORIS_HOME}/log");
 
+// the always-on sampling profiler, which samples the cpu stacks of the threads at a low rate
+// and keeps the samples of the recent window in memory, see /api/sampling_profile
+CONF_Bool(enable_sampling_profiler, "true");
+// the samples per second of cpu time consumed by the process
+CONF_Int32(sampling_profiler_hz, "10");
+// the seconds of the rolling window of samples kept in memory
+CONF_Int32(sampling_profiler_window_sec, "900");
+
+// Capture the params of the fragments of the select queries into query_capture_dir, so the
+// queries can be replayed by /api/query_replay to compare the profiles between builds.
+CONF_mBool(enable_query_capture, "false");
+CONF_String(query_capture_dir, "${DORIS_HOME}/query_capture");
+
 // to forward compatibility, will be removed later
 CONF_mBool(enable_token_check, "true");
 
 // to open/close system metrics
 CONF_Bool(enable_system_metrics, "true");
+// the milliseconds during which the rendering of the metrics is reused by the later scrapes,
+// rendering 10k+ metrics costs a lot. 0 means rendering for each scrape.
+CONF_mInt32(metrics_render_cache_ms, "5000");
 
 CONF_mBool(enable_prefetch, "true");
 
@@ -442,7 +670,7 @@ CONF_Int32(num_cores, "0");
 // Otherwise, we will ignore the broken disk,
 CONF_Bool(ignore_broken_disk, "false");
 
-// linux transparent huge page
+// linux transparent huge page, it's also used by the large chunks of vectorized Allocator
 CONF_Bool(madvise_huge_pages, "false");
 
 // whether use mmap to allocate memory
@@ -464,6 +692,15 @@ CONF_Int32(memory_max_alignment, "16");
 
 // write buffer size before flush
 CONF_mInt64(write_buffer_size, "209715200");
+// Whether to sort the vectorized memtable of DUP_KEYS tables at once when flushing, instead of
+// inserting the rows into a skiplist one by one.
+CONF_mBool(enable_memtable_batch_sort, "true");
+// Whether to aggregate the vectorized memtable of AGG_KEYS and UNIQUE_KEYS tables by a hash table
+// of the keys, instead of searching the rows of the same key in a skiplist.
+CONF_mBool(enable_memtable_hash_aggregation, "true");
+// Whether to append the vectorized rows to the memtable without the skiplist or the hash table
+// while they're in the order of the keys, as the loads sorted by the keys upstream.
+CONF_mBool(enable_memtable_ordered_append, "true");
 
 // following 2 configs limit the memory consumption of load process on a Backend.
 // eg: memory limit to 80% of mem limit config but up to 100GB(default)
@@ -472,15 +709,30 @@ CONF_mInt64(write_buffer_size, "209715200");
 // user should set these configs properly if necessary.
 CONF_Int64(load_process_max_memory_limit_bytes, "107374182400"); // 100GB
 CONF_Int32(load_process_max_memory_limit_percent, "80");         // 80%
+// The largest memtables of all the loads are flushed in the background once the load memory
+// exceeds this percent of the load memory limit above.
+CONF_mInt32(load_memtable_flush_soft_limit_percent, "70");
+// The max time an add batch request waits for the memtables to be flushed when the load
+// memory exceeds its limit.
+CONF_mInt32(load_memtable_mem_wait_max_ms, "5000");
 
 // result buffer cancelled time (unit: second)
 CONF_mInt32(result_buffer_cancelled_interval_time, "300");
 
+// the max number of the rows of a row group of the parquet files written by the vectorized
+// outfile, the rows of a row group are buffered in memory before being written
+CONF_mInt64(parquet_writer_row_group_rows, "262144");
+
 // the increased frequency of priority for remaining tasks in BlockingPriorityQueue
 CONF_mInt32(priority_queue_remaining_tasks_increased_frequency, "512");
 
 // sync tablet_meta when modifying meta
 CONF_mBool(sync_tablet_meta, "false");
+// Commit the concurrent meta writes of a data dir together by one rocksdb write batch, so the
+// group pays for one wal write and sync. Each write returns after its group is committed.
+CONF_mBool(enable_meta_group_commit, "true");
+// the max number of the meta writes committed by one write batch
+CONF_mInt32(meta_group_commit_max_writes, "128");
 
 // default thrift rpc timeout ms
 CONF_mInt32(thrift_rpc_timeout_ms, "10000");
@@ -512,6 +764,10 @@ CONF_String(es_scroll_keepalive, "5m");
 // HTTP connection timeout for es
 CONF_mInt32(es_http_timeout_ms, "5000");
 
+// The number of the sliced scrolls of each es shard, each slice is scanned by its own scanner,
+// so an index of few shards is read by more concurrent scrolls. 1 means the shards are not sliced.
+CONF_mInt32(es_scroll_slices_per_shard, "1");
+
 // the max client cache number per each host
 // There are variety of client cache in BE, but currently we use the
 // same cache size configuration.
@@ -537,6 +793,16 @@ CONF_mInt64(storage_flood_stage_left_capacity_bytes, "1073741824"); // 1GB
 CONF_Int32(flush_thread_num_per_store, "2");
 // number of thread for flushing memtable per store, for high priority load task
 CONF_Int32(high_priority_flush_thread_num_per_store, "1");
+// Whether to split a large flush of memtable, and the output of compaction and schema change,
+// into several segments whose columns are encoded and compressed in parallel.
+CONF_mBool(enable_parallel_segment_write, "false");
+// number of threads to write segments in parallel, shared by all rowset writers
+CONF_Int32(parallel_segment_write_thread_num, "8");
+// max rows of a segment written in parallel, it's also limited by the segment size
+CONF_mInt64(parallel_segment_write_rows_per_segment, "1048576");
+// max number of segments being written in parallel by a compaction or schema change,
+// which bounds the memory of the blocks buffered for them
+CONF_mInt32(parallel_segment_write_max_pending_segments, "4");
 
 // config for tablet meta checkpoint
 CONF_mInt32(tablet_meta_checkpoint_min_new_rowsets_num, "10");
@@ -574,6 +840,9 @@ CONF_Int32(txn_shard_size, "1024");
 // Whether to continue to start be when load tablet from header failed.
 CONF_Bool(ignore_load_tablet_failure, "false");
 
+// The number of threads to decode the tablet and rowset metas of one data dir at BE startup.
+CONF_Int32(load_data_dir_thread_num_per_disk, "8");
+
 // Whether to continue to start be when load tablet from header failed.
 CONF_mBool(ignore_rowset_stale_unconsistent_delete, "false");
 
@@ -589,6 +858,12 @@ CONF_Int32(query_cache_elasticity_size_mb, "128");
 // Maximum number of cache partitions corresponding to a SQL
 CONF_Int32(query_cache_max_partition_count, "1024");
 
+// The directory to spill the cache partitions pruned from the memory to, and the max size of
+// the spilled partitions. Empty means the pruned partitions are dropped. The "result_cache"
+// sub-directory of it is cleared at startup.
+CONF_String(query_cache_spill_path, "");
+CONF_Int32(query_cache_spill_max_size_mb, "1024");
+
 // Maximum number of version of a tablet. If the version num of a tablet exceed limit,
 // the load process will reject new incoming load job of this tablet.
 // This is to avoid too many version num.
@@ -601,6 +876,25 @@ CONF_String(thrift_server_type_of_fe, "THREAD_POOL");
 // disable zone map index when page row is too few
 CONF_mInt32(zone_map_row_num_threshold, "20");
 
+// Whether to choose the encoding of the columns with default encoding by the first data page of
+// a segment. All encodings registered for the type are tried on the first page, and the one with
+// the smallest size weighted by its decoding cost is used for the whole column of the segment.
+CONF_mBool(enable_adaptive_column_encoding, "false");
+
+// Whether to compress the string columns by ZSTD with a dictionary, which is trained from the
+// first data pages of the column in a segment and stored in the segment footer.
+CONF_mBool(enable_zstd_dict_compression, "false");
+// the bytes of the first data pages used to train the ZSTD dictionary
+CONF_mInt32(zstd_dict_train_sample_bytes, "1048576");
+// Whether to write a HyperLogLog of the values of each column in a segment, which are merged
+// by the scan to estimate the number of distinct values of the columns.
+CONF_mBool(enable_segment_ndv_sketch, "true");
+// Whether the olap scan merges the ndv sketches of the segments it reads, and records the
+// estimated number of distinct values of the columns in the profile.
+CONF_mBool(enable_scan_ndv_estimate, "false");
+// the max bytes of a ZSTD dictionary
+CONF_mInt32(zstd_dict_max_bytes, "16384");
+
 // aws sdk log level
 //    Off = 0,
 //    Fatal = 1,
@@ -613,6 +907,20 @@ CONF_Int32(aws_log_level, "3");
 
 // the buffer size when read data from remote storage like s3
 CONF_mInt32(remote_storage_read_buffer_mb, "16");
+// The number of the buffers prefetched after a sequential read of the external files,
+// 0 to disable the prefetch.
+CONF_mInt32(remote_read_prefetch_buffers, "2");
+// A read of the external files within this number of bytes after the last one is sequential,
+// the bytes skipped are read together with it instead of issuing a new request.
+CONF_mInt64(remote_read_coalesce_gap_bytes, "1048576");
+// A remote read slower than this percentile of the recent remote reads is issued again,
+// the first finished one is used. 0 to disable the hedged reads. Only the readers supporting
+// concurrent reads (S3) are hedged.
+CONF_mInt32(remote_read_hedge_percentile, "95");
+// The min delay before a remote read is issued again.
+CONF_mInt64(remote_read_hedge_min_delay_ms, "50");
+// The number of the threads to prefetch and hedge the reads of the external files.
+CONF_Int32(remote_read_thread_pool_thread_num, "16");
 
 // Whether Hook TCmalloc new/delete, currently consume/release tls mem tracker in Hook.
 CONF_Bool(track_new_delete, "true");
@@ -634,7 +942,9 @@ CONF_mInt16(mem_tracker_level, "0");
 // smaller than this value will continue to accumulate. specified as number of bytes.
 // Decreasing this value will increase the frequency of consume/release.
 // Increasing this value will cause MemTracker statistics to be inaccurate.
-CONF_mInt32(mem_tracker_consume_min_size_bytes, "2097152");
+// The shared atomics of the tracker and its ancestors (e.g. the process tracker) are only
+// touched, and the limits are only checked, once per this value on each thread.
+CONF_mInt32(mem_tracker_consume_min_size_bytes, "4194304");
 
 // When MemTracker is a negative value, it is considered that a memory leak has occurred,
 // but the actual MemTracker records inaccurately will also cause a negative value,
@@ -655,6 +965,50 @@ CONF_mDouble(tablet_version_graph_orphan_vertex_ratio, "0.1");
 // else we will call sync method
 CONF_mBool(runtime_filter_use_async_rpc, "true");
 
+// Whether the runtime filters which arrive after the olap scan has started are pushed down to
+// the segments not read yet, to prune their pages and filter their rows in the storage.
+CONF_mBool(enable_late_runtime_filter_pushdown, "true");
+
+// Whether the olap scan starts without waiting for the runtime filters not ready yet, when they
+// are pushed down after arriving (enable_late_runtime_filter_pushdown). Their bloom filters are
+// also applied to the segments being read from the next block on.
+CONF_mBool(late_runtime_filter_skip_wait, "true");
+
+// A bitmap runtime filter filters the rows of a segment by the bitmap index of its column when
+// it has at most this number of values, one dictionary seek per value, otherwise it filters the
+// rows after reading the column.
+CONF_mInt32(bitmap_filter_max_bitmap_index_seeks, "1024");
+
+// The range predicates (<, <=, >, >=) of a column are evaluated by its bitmap index only if at
+// most this number of bitmaps are unioned, the bitmaps of the values in the range or of the ones
+// out of it. Otherwise they are evaluated after reading the column, which is cheaper when the
+// range covers too many distinct values.
+CONF_mInt32(bitmap_index_max_range_union_bitmaps, "16384");
+
+// The number of the first batches of a segment on which the cost and the selectivity of each
+// short circuit predicate are measured to order the predicates, 0 to keep the planner's order.
+CONF_mInt32(predicate_reorder_sample_batches, "3");
+// The min percent of the rows a runtime bloom filter has to filter out on the sampled batches of a
+// segment to be kept, the ones filtering less are no longer evaluated on the rest of the segment
+// and are sampled again on the next segment. 0 to always evaluate them.
+CONF_mInt32(runtime_filter_min_filtered_percent, "5");
+
+// Whether the string columns only used by short circuit predicates are read only for the rows
+// passing the other predicates, when the other columns are lazily materialized.
+CONF_mBool(enable_second_stage_lazy_materialization, "true");
+
+// Whether percentile_approx and the quantile states use DDSketch instead of TDigest, which is
+// smaller and faster to merge. The serialized states are tagged by their sketches, but the
+// backends of the older versions can't read the states of DDSketch, so only enable it after
+// all the backends are upgraded.
+CONF_mBool(enable_quantile_ddsketch, "false");
+
+// Whether multi_distinct_count of the integers keeps the distinct values in roaring bitmaps
+// instead of hash sets, which are much smaller for the dense values (e.g. the ids) and are
+// merged and exchanged by their containers. The states of bitmaps and hash sets are different,
+// so it must be the same on all the backends.
+CONF_mBool(enable_multi_distinct_count_bitmap, "false");
+
 // max send batch parallelism for OlapTableSink
 // The value set by the user for send_batch_parallelism is not allowed to exceed max_send_batch_parallelism_per_job,
 // if exceed, the value of send_batch_parallelism would be max_send_batch_parallelism_per_job
@@ -667,6 +1021,13 @@ CONF_Int32(send_batch_thread_pool_thread_num, "64");
 // number of send batch thread pool queue size
 CONF_Int32(send_batch_thread_pool_queue_size, "102400");
 
+// The number of the threads to write the rows of a batch received by a TabletsChannel into
+// the memtables of its tablets.
+CONF_Int32(tablet_writer_write_thread_num, "32");
+// The max number of the tablets of a TabletsChannel written in parallel for a batch,
+// 1 means the tablets are written one by one by the brpc thread.
+CONF_Int32(tablet_writer_write_parallelism, "4");
+
 // Limit the number of segment of a newly created rowset.
 // The newly created rowset may to be compacted after loading,
 // so if there are too many segment in a rowset, the compaction process
@@ -674,16 +1035,71 @@ CONF_Int32(send_batch_thread_pool_queue_size, "102400");
 // When doing compaction, each segment may take at least 1MB buffer.
 CONF_mInt32(max_segment_num_per_rowset, "200");
 
+// Move the tablets between the SSD and HDD data dirs by their scan heat every
+// tablet_auto_tiering_interval_sec. The scan heat of a tablet is the bytes scanned from it,
+// halved in each round. The hottest tablets within tablet_auto_tiering_ssd_usage_percent of the
+// capacity of the SSD data dirs are kept on SSD, the others are moved to HDD. At most
+// tablet_auto_tiering_max_migrations_per_round tablets of tablet_auto_tiering_max_bytes_per_round
+// in total are migrated in a round. The FE migrates the tablets back to the storage medium of
+// their partitions unless its `disable_storage_medium_check` is true.
+CONF_mBool(enable_tablet_auto_tiering, "false");
+CONF_mInt32(tablet_auto_tiering_interval_sec, "600");
+CONF_mInt32(tablet_auto_tiering_ssd_usage_percent, "80");
+CONF_mInt32(tablet_auto_tiering_max_migrations_per_round, "4");
+CONF_mInt64(tablet_auto_tiering_max_bytes_per_round, "10737418240");
+
+// Evaluate the delete predicates on the older rowsets in the background every
+// delete_predicate_bitmap_interval_sec, and keep the deleted rows in the delete bitmap of the
+// tablet, so the reads don't evaluate the predicates again. At most
+// delete_predicate_bitmap_max_rowsets_per_round rowsets are evaluated in a round.
+CONF_mBool(enable_delete_predicate_bitmap, "true");
+CONF_mInt32(delete_predicate_bitmap_interval_sec, "60");
+CONF_mInt32(delete_predicate_bitmap_max_rowsets_per_round, "100");
+
 // The connection timeout when connecting to external table such as odbc table.
 CONF_mInt32(external_table_connect_timeout_sec, "5");
 
+// The max bytes of the buffers the columns of a vectorized odbc scan are bound to, the rows
+// fetched by one call to the driver are limited by it and the batch size.
+CONF_mInt64(odbc_scan_fetch_buffer_bytes, "16777216");
+
 // The capacity of lur cache in segment loader.
 // Althought it is called "segment cache", but it caches segments in rowset granularity.
 // So the value of this config should corresponding to the number of rowsets on this BE.
 CONF_mInt32(segment_cache_capacity, "1000000");
+// The memory limit of the segment cache, as bytes or a percentage of mem_limit. If it's
+// positive, the cache is limited by the bytes of the metadata of the cached segments
+// instead of segment_cache_capacity.
+CONF_String(segment_cache_memory_limit, "5%");
+// The eviction policy of segment cache, "LRU" or "CLOCK".
+CONF_String(segment_cache_policy, "LRU");
+
+// The columns of the segments of the in memory tablets are decoded and cached by
+// decoded_column_cache_load_threads background threads after being read for the first time,
+// and the later scans read the decoded values from the cache instead of the pages.
+// decoded_column_cache_limit is the memory limit of the cache, the same format as
+// storage_page_cache_limit.
+CONF_Bool(enable_decoded_column_cache, "true");
+CONF_String(decoded_column_cache_limit, "10%");
+CONF_Int32(decoded_column_cache_load_threads, "2");
 
 // s3 config
 CONF_mInt32(max_remote_storage_count, "10");
+// The files of at least s3_multipart_threshold_mb are uploaded to s3 by multipart upload. The
+// parts of s3_transfer_part_size_mb (at least 5MB) of a file are uploaded, or downloaded by
+// ranged reads, by s3_transfer_part_parallelism threads.
+CONF_mInt64(s3_multipart_threshold_mb, "64");
+CONF_mInt64(s3_transfer_part_size_mb, "16");
+CONF_mInt32(s3_transfer_part_parallelism, "4");
+
+// The capacity of the local disk cache of the remote segment files in each data dir,
+// the cache is in the "remote_cache" directory of the data dir. 0 means no cache.
+// It's better to be enabled only on the data dirs on SSD.
+CONF_Int64(remote_file_cache_capacity_per_disk, "0");
+// The size of the blocks of the remote files cached on the local disk
+CONF_Int64(remote_file_cache_block_size, "1048576");
+// The number of threads of each data dir to write the missed blocks to the cache
+CONF_Int32(remote_file_cache_fill_thread_num, "2");
 
 // Set to true to disable the minidump feature.
 CONF_Bool(disable_minidump, "false");
@@ -724,6 +1140,13 @@ CONF_mInt32(min_load_rpc_timeout_ms, "20000");
 // use which protocol to access function service, candicate is baidu_std/h2:grpc
 CONF_String(function_service_protocol, "h2:grpc");
 
+// A vectorized rpc function splits a block into sub-batches of at most this number of rows and
+// keeps the calls of several sub-batches in flight to overlap their latencies, 0 to call the
+// function service once per block.
+CONF_mInt32(function_service_batch_rows, "1024");
+// The max number of the calls of the sub-batches of a block in flight at the same time.
+CONF_mInt32(function_service_max_inflight_calls, "4");
+
 // use which load balancer to select server to connect
 CONF_String(rpc_load_balancer, "rr");
 
@@ -738,6 +1161,119 @@ CONF_Validator(string_type_length_soft_limit_bytes,
 // is greater than object_pool_buffer_size, release the object in the unused_object_pool.
 CONF_Int32(object_pool_buffer_size, "100");
 
+// When spilling is enabled for a query, the vectorized operators which support spilling
+// begin to spill data to the tmp dirs once the memory consumption of the query exceeds
+// this percentage of the query mem limit.
+CONF_mInt32(vec_spill_mem_limit_percent, "80");
+CONF_Validator(vec_spill_mem_limit_percent,
+               [](const int config) -> bool { return config > 0 && config <= 100; });
+// The minimal memory of a vectorized operator to be worth spilling.
+CONF_mInt64(vec_spill_min_mem_bytes, "16777216");
+
+// The number of partitions the data spilled by a vectorized operator is split into.
+CONF_Int32(vec_spill_partition_count, "16");
+// The times a spilled partition which still can't fit in memory is split again by another hash
+// of the keys, the operator fails with MemoryLimitExceeded beyond it.
+CONF_mInt32(vec_spill_max_repartition_depth, "3");
+
+// The codec compressing the blocks spilled by the vectorized operators, LZ4 is faster while
+// ZSTD spills fewer bytes.
+CONF_mString(vec_spill_compression, "LZ4");
+CONF_Validator(vec_spill_compression, [](const std::string config) -> bool {
+    return config == "LZ4" || config == "ZSTD";
+});
+// The number of the threads of TmpFileMgr doing the spill io of the vectorized operators, which
+// write and read ahead the spilled blocks asynchronously. 0 to do the io in the operators.
+CONF_Int32(vec_spill_io_thread_num, "8");
+// The max number of the blocks being written per spill stream, an operator spilling a block
+// waits once its stream has this many writes in flight.
+CONF_mInt32(vec_spill_max_inflight_writes, "4");
+// The number of the blocks a spill stream reads ahead of the operator reading it back.
+CONF_mInt32(vec_spill_read_ahead_blocks, "2");
+
+// The interval of the query memory arbitrator of the fragment mgr, 0 disables it. Once the
+// process memory exceeds query_spill_process_mem_percent of mem_limit, the biggest queries which
+// enable spilling are asked to spill, until the memory they hold covers the excess. Once it
+// exceeds query_cancel_process_mem_percent of mem_limit and all the spillable queries are already
+// spilling, the biggest query is cancelled, preferring the ones which can't spill.
+CONF_mInt32(query_mem_arbitrate_interval_ms, "500");
+CONF_mInt32(query_spill_process_mem_percent, "85");
+CONF_Validator(query_spill_process_mem_percent,
+               [](const int config) -> bool { return config > 0 && config <= 100; });
+CONF_mInt32(query_cancel_process_mem_percent, "95");
+CONF_Validator(query_cancel_process_mem_percent,
+               [](const int config) -> bool { return config > 0 && config <= 100; });
+
+// Whether a Top-N sort on a column of the olap scan below it pushes its boundary down to the
+// scan, so that the rows which can't be in the result are skipped in the storage.
+CONF_mBool(enable_topn_runtime_predicate, "true");
+
+// Whether the scan of an aggregate key table grouped by a prefix of its keys partially
+// aggregates the rows of each group in the order of the keys, for the aggregation above it.
+CONF_mBool(enable_scan_pre_aggregation, "true");
+
+// Whether an aggregation of which the input is sorted by the group by keys aggregates each
+// group once all its rows are read, instead of building a hash table of all the groups.
+CONF_mBool(enable_sorted_aggregation, "true");
+
+// Whether the vectorized TOP-N (ORDER BY ... LIMIT) uses VTopNNode, which only keeps the first
+// `offset + limit` rows, instead of the TOP-N mode of VSortNode.
+CONF_mBool(enable_vec_topn_node, "true");
+
+// Whether the vectorized data stream senders of a query merge their blocks to the same host into
+// one transmit_blocks rpc, at most one rpc of them is in flight for a host. All the backends must
+// support transmit_blocks before it's enabled.
+CONF_mBool(enable_vec_exchange_multiplex, "false");
+
+// Whether the hash and bucket shuffle partitioned channels to the receivers in this backend move
+// their buffered columns to the receivers instead of sending them by rpc, so the instances on
+// the same host are re-partitioned in memory.
+CONF_mBool(enable_vec_partitioned_local_exchange, "true");
+
+// The number of worker threads of the pipeline engine, 0 means the number of cpu cores.
+CONF_Int32(pipeline_executor_size, "0");
+
+// The hash table of vectorized aggregation is converted to a two level hash table once
+// it has more rows or bytes than these thresholds, 0 means no limit of that kind.
+CONF_mInt64(vec_agg_two_level_hash_table_threshold_rows, "100000");
+CONF_mInt64(vec_agg_two_level_hash_table_threshold_bytes, "52428800");
+
+// The vectorized hash join and aggregation hash the keys of a block by batch and prefetch the
+// bucket of the key this number of rows ahead of the key being looked up, 0 to not prefetch.
+CONF_mInt32(vec_hash_table_prefetch_distance, "16");
+CONF_Validator(vec_hash_table_prefetch_distance,
+               [](const int config) -> bool { return config >= 0; });
+
+// The vectorized analytic node evaluates the ROWS window frames of at least this number of rows
+// by merging the partial states of a segment tree over the partition instead of adding all the
+// rows of each frame, a negative value to disable it.
+CONF_mInt32(vec_analytic_segment_tree_min_frame_rows, "64");
+
+// Whether sorting a block on several columns encodes the sort columns of each row into a byte
+// string compared by memcmp, if all of them are numbers, decimals or strings.
+CONF_mBool(enable_vec_normalized_sort_keys, "true");
+// Whether sorting a block without limit by the normalized sort keys uses a radix sort, when no
+// string in the keys is longer than the prefix.
+CONF_mBool(enable_vec_radix_sort, "true");
+// The bytes of a string encoded into the sort key, the rows whose strings are equal on the prefix
+// but longer than it are compared by the columns.
+CONF_mInt32(vec_normalized_sort_key_string_prefix, "16");
+CONF_Validator(vec_normalized_sort_key_string_prefix,
+               [](const int config) -> bool { return config > 0 && config < 255; });
+
+// Whether the vectorized cross join sorts the build side on a column compared by <, <=, > or >=
+// with the left rows in its conjuncts, and joins each left row only with the build rows found
+// in range by binary search.
+CONF_mBool(enable_vec_cross_join_range_search, "true");
+
+// Whether sorting a string column compares the 16 bytes inline refs of the strings (the size, the
+// prefix and the short strings inlined) instead of the strings.
+CONF_mBool(enable_vec_inline_string_sort, "true");
+
+// Whether a column whose rows all have the same non-null value in a segment, by the zone map of
+// the segment, is read without its pages, and its predicates are evaluated once per segment.
+CONF_mBool(enable_segment_constant_column, "true");
+
 } // namespace config
 
 } // namespace doris
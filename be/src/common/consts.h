@@ -24,5 +24,9 @@ namespace BeConsts {
 const std::string CSV = "csv";
 const std::string CSV_WITH_NAMES = "csv_with_names";
 const std::string CSV_WITH_NAMES_AND_TYPES = "csv_with_names_and_types";
+
+// the slot of the row locators (GlobalRowLocation) of the olap scan, the other columns of the
+// rows are fetched later by the locators
+const std::string ROWID_COL = "__DORIS_ROWID_COL__";
 } // namespace BeConsts
 } // namespace doris
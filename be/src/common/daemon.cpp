@@ -60,6 +60,7 @@
 #include "util/logging.h"
 #include "util/mem_info.h"
 #include "util/network_util.h"
+#include "util/sampling_profiler.h"
 #include "util/system_metrics.h"
 #include "util/thrift_util.h"
 #include "util/time.h"
@@ -297,10 +298,19 @@ void Daemon::start() {
                 [this]() { this->calculate_metrics_thread(); }, &_calculate_metrics_thread);
         CHECK(st.ok()) << st.to_string();
     }
+
+    if (config::enable_sampling_profiler) {
+        st = SamplingProfiler::instance()->start(config::sampling_profiler_hz,
+                                                 config::sampling_profiler_window_sec);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to start the sampling profiler: " << st.to_string();
+        }
+    }
 }
 
 void Daemon::stop() {
     _stop_background_threads_latch.count_down();
+    SamplingProfiler::instance()->stop();
 
     if (_tcmalloc_gc_thread) {
         _tcmalloc_gc_thread->join();
@@ -273,6 +273,9 @@ private:
 
 struct RandomAccessFileOptions {
     RandomAccessFileOptions() {}
+    // Read by direct IO through aligned buffers, to bypass the OS page cache.
+    // The file is read by buffered IO if the file system doesn't support direct IO.
+    bool use_direct_io = false;
 };
 
 // Creation-time options for WritableFile
@@ -291,6 +294,13 @@ struct RandomRWFileOptions {
     Env::OpenMode mode = Env::CREATE_OR_OPEN_WITH_TRUNCATE;
 };
 
+// One range of a file to read by RandomAccessFile::read_batch_at,
+// exactly "result.size" bytes are read at "offset" into "result.data".
+struct ReadRequest {
+    uint64_t offset = 0;
+    Slice result;
+};
+
 class RandomAccessFile {
 public:
     RandomAccessFile() {}
@@ -321,6 +331,20 @@ public:
     // Safe for concurrent use by multiple threads.
     virtual Status readv_at(uint64_t offset, const Slice* result, size_t res_cnt) const = 0;
 
+    // Reads the "req_cnt" ranges of "requests", which may be at any offsets. The ranges are
+    // read at once if the implementation supports it, so the device serves them in parallel.
+    //
+    // If an error was encountered, returns a non-OK status, and the content of all the
+    // results is undefined.
+    //
+    // Safe for concurrent use by multiple threads.
+    virtual Status read_batch_at(const ReadRequest* requests, size_t req_cnt) const {
+        for (size_t i = 0; i < req_cnt; ++i) {
+            RETURN_IF_ERROR(read_at(requests[i].offset, &requests[i].result));
+        }
+        return Status::OK();
+    }
+
     // read all data from this file
     virtual Status read_all(std::string* content) const = 0;
 
@@ -25,16 +25,22 @@
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <cstdlib>
+#include <cstring>
 #include <filesystem>
 #include <fstream>
 #include <memory>
+#include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
+#include "env/io_uring.h"
 #include "gutil/gscoped_ptr.h"
 #include "gutil/macros.h"
 #include "gutil/port.h"
 #include "gutil/strings/substitute.h"
+#include "util/alignment.h"
 #include "util/errno.h"
 #include "util/file_cache.h"
 #include "util/slice.h"
@@ -170,6 +176,82 @@ static Status do_readv_at(int fd, const std::string& filename, uint64_t offset,
     return Status::OK();
 }
 
+// The alignment of the offsets, lengths and buffers of direct IO, it's the logical
+// block size of almost all devices, or a multiple of it.
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+// Read by direct IO into an aligned buffer covering the aligned range, and copy the data
+// to the results, because the offset and the results are not aligned in general.
+static Status do_direct_readv_at(int fd, const std::string& filename, uint64_t offset,
+                                 const Slice* res, size_t res_cnt) {
+    size_t bytes_req = 0;
+    for (size_t i = 0; i < res_cnt; i++) {
+        bytes_req += res[i].size;
+    }
+    uint64_t begin = ALIGN_DOWN(offset, DIRECT_IO_ALIGNMENT);
+    uint64_t end = ALIGN_UP(offset + bytes_req, DIRECT_IO_ALIGNMENT);
+    size_t len = end - begin;
+    void* buf = nullptr;
+    if (posix_memalign(&buf, DIRECT_IO_ALIGNMENT, len) != 0) {
+        return Status::MemoryAllocFailed(
+                strings::Substitute("failed to allocate $0 bytes for direct IO", len));
+    }
+    std::unique_ptr<uint8_t, decltype(&free)> aligned_buf(static_cast<uint8_t*>(buf), &free);
+
+    size_t bytes_read = 0;
+    while (bytes_read < len) {
+        ssize_t r;
+        RETRY_ON_EINTR(r, pread(fd, aligned_buf.get() + bytes_read, len - bytes_read,
+                                begin + bytes_read));
+        if (PREDICT_FALSE(r < 0)) {
+            return io_error(filename, errno);
+        }
+        bytes_read += r;
+        // a short read which is not aligned only happens at the end of file
+        if (r == 0 || r % DIRECT_IO_ALIGNMENT != 0) {
+            break;
+        }
+    }
+    if (PREDICT_FALSE(begin + bytes_read < offset + bytes_req)) {
+        return Status::EndOfFile(strings::Substitute("EOF trying to read $0 bytes at offset $1",
+                                                     bytes_req, offset));
+    }
+
+    const uint8_t* src = aligned_buf.get() + (offset - begin);
+    for (size_t i = 0; i < res_cnt; i++) {
+        memcpy(res[i].data, src, res[i].size);
+        src += res[i].size;
+    }
+    return Status::OK();
+}
+
+// Read the ranges at once by io_uring, the short reads are completed by do_readv_at().
+static Status do_read_batch_at_io_uring(IoUring* ring, int fd, const std::string& filename,
+                                        const ReadRequest* reqs, size_t req_cnt) {
+    std::vector<struct iovec> iovs(req_cnt);
+    std::vector<uint64_t> offsets(req_cnt);
+    std::vector<ssize_t> results(req_cnt);
+    for (size_t i = 0; i < req_cnt; i++) {
+        iovs[i] = {reqs[i].result.data, reqs[i].result.size};
+        offsets[i] = reqs[i].offset;
+    }
+    RETURN_IF_ERROR(ring->preadv(fd, iovs.data(), offsets.data(), req_cnt, results.data()));
+
+    for (size_t i = 0; i < req_cnt; i++) {
+        ssize_t r = results[i];
+        if (PREDICT_TRUE(r == reqs[i].result.size)) {
+            continue;
+        }
+        if (r < 0 && r != -EINTR && r != -EAGAIN) {
+            return io_error(filename, -r);
+        }
+        size_t bytes_read = std::max<ssize_t>(r, 0);
+        Slice rem(reqs[i].result.data + bytes_read, reqs[i].result.size - bytes_read);
+        RETURN_IF_ERROR(do_readv_at(fd, filename, reqs[i].offset + bytes_read, &rem, 1));
+    }
+    return Status::OK();
+}
+
 static Status do_writev_at(int fd, const string& filename, uint64_t offset, const Slice* data,
                            size_t data_cnt, size_t* bytes_written) {
     // Convert the results into the iovec vector to request
@@ -225,7 +307,8 @@ static Status do_writev_at(int fd, const string& filename, uint64_t offset, cons
 
 class PosixRandomAccessFile : public RandomAccessFile {
 public:
-    PosixRandomAccessFile(std::string filename, int fd) : _filename(std::move(filename)), _fd(fd) {}
+    PosixRandomAccessFile(std::string filename, int fd, bool direct_io = false)
+            : _filename(std::move(filename)), _fd(fd), _direct_io(direct_io) {}
     ~PosixRandomAccessFile() override {
         int res;
         RETRY_ON_EINTR(res, close(_fd));
@@ -240,9 +323,34 @@ public:
     }
 
     Status readv_at(uint64_t offset, const Slice* result, size_t res_cnt) const override {
+        if (_direct_io) {
+            return do_direct_readv_at(_fd, _filename, offset, result, res_cnt);
+        }
         return do_readv_at(_fd, _filename, offset, result, res_cnt);
     }
 
+    Status read_batch_at(const ReadRequest* requests, size_t req_cnt) const override {
+        if (_direct_io) {
+            // the buffers are not aligned for the direct IO by io_uring
+            for (size_t i = 0; i < req_cnt; i++) {
+                const ReadRequest& req = requests[i];
+                RETURN_IF_ERROR(do_direct_readv_at(_fd, _filename, req.offset, &req.result, 1));
+            }
+            return Status::OK();
+        }
+        if (req_cnt > 1 && config::enable_io_uring_read) {
+            IoUring* ring = IoUring::thread_local_ring();
+            if (ring != nullptr) {
+                return do_read_batch_at_io_uring(ring, _fd, _filename, requests, req_cnt);
+            }
+        }
+        for (size_t i = 0; i < req_cnt; i++) {
+            const ReadRequest& req = requests[i];
+            RETURN_IF_ERROR(do_readv_at(_fd, _filename, req.offset, &req.result, 1));
+        }
+        return Status::OK();
+    }
+
     Status read_all(std::string* content) const override {
         std::fstream fs(_filename.c_str(), std::fstream::in);
         if (!fs.is_open()) {
@@ -282,6 +390,8 @@ public:
 private:
     std::string _filename;
     int _fd;
+    // opened with O_DIRECT
+    bool _direct_io;
 };
 
 class PosixWritableFile : public WritableFile {
@@ -495,6 +605,17 @@ Status PosixEnv::new_random_access_file(const RandomAccessFileOptions& opts,
                                         const std::string& fname,
                                         std::unique_ptr<RandomAccessFile>* result) {
     int fd;
+    if (opts.use_direct_io) {
+        RETRY_ON_EINTR(fd, open(fname.c_str(), O_RDONLY | O_DIRECT));
+        if (fd >= 0) {
+            result->reset(new PosixRandomAccessFile(fname, fd, true));
+            return Status::OK();
+        }
+        if (errno != EINVAL) {
+            return io_error(fname, errno);
+        }
+        // the file system doesn't support direct IO, e.g. tmpfs
+    }
     RETRY_ON_EINTR(fd, open(fname.c_str(), O_RDONLY));
     if (fd < 0) {
         return io_error(fname, errno);
@@ -0,0 +1,216 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "env/io_uring.h"
+
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "gutil/strings/substitute.h"
+#include "util/errno.h"
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>) && defined(__NR_io_uring_setup)
+#include <linux/io_uring.h>
+#define DORIS_HAVE_IO_URING 1
+#endif
+
+namespace doris {
+
+#ifdef DORIS_HAVE_IO_URING
+
+static int io_uring_setup(uint32_t entries, struct io_uring_params* p) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, p));
+}
+
+static int io_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return static_cast<int>(
+            syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+Status IoUring::create(uint32_t entries, std::unique_ptr<IoUring>* ring) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    int fd = io_uring_setup(entries, &p);
+    if (fd < 0) {
+        return Status::NotSupported(
+                strings::Substitute("io_uring_setup failed: $0", errno_to_string(errno)));
+    }
+    std::unique_ptr<IoUring> r(new IoUring());
+    r->_ring_fd = fd;
+    r->_sq_entries = p.sq_entries;
+
+    r->_sq_ring_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+    r->_cq_ring_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    bool single_mmap = (p.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap) {
+        r->_sq_ring_size = std::max(r->_sq_ring_size, r->_cq_ring_size);
+    }
+    r->_sq_ring = mmap(nullptr, r->_sq_ring_size, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (r->_sq_ring == MAP_FAILED) {
+        r->_sq_ring = nullptr;
+        return Status::NotSupported(
+                strings::Substitute("mmap io_uring failed: $0", errno_to_string(errno)));
+    }
+    if (single_mmap) {
+        r->_cq_ring = r->_sq_ring;
+    } else {
+        r->_cq_ring = mmap(nullptr, r->_cq_ring_size, PROT_READ | PROT_WRITE,
+                           MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (r->_cq_ring == MAP_FAILED) {
+            r->_cq_ring = nullptr;
+            return Status::NotSupported(
+                    strings::Substitute("mmap io_uring failed: $0", errno_to_string(errno)));
+        }
+    }
+    r->_sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    r->_sqes = mmap(nullptr, r->_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd,
+                    IORING_OFF_SQES);
+    if (r->_sqes == MAP_FAILED) {
+        r->_sqes = nullptr;
+        return Status::NotSupported(
+                strings::Substitute("mmap io_uring failed: $0", errno_to_string(errno)));
+    }
+
+    auto* sq = static_cast<uint8_t*>(r->_sq_ring);
+    r->_sq_tail = reinterpret_cast<unsigned*>(sq + p.sq_off.tail);
+    r->_sq_mask = reinterpret_cast<unsigned*>(sq + p.sq_off.ring_mask);
+    r->_sq_array = reinterpret_cast<unsigned*>(sq + p.sq_off.array);
+    auto* cq = static_cast<uint8_t*>(r->_cq_ring);
+    r->_cq_head = reinterpret_cast<unsigned*>(cq + p.cq_off.head);
+    r->_cq_tail = reinterpret_cast<unsigned*>(cq + p.cq_off.tail);
+    r->_cq_mask = reinterpret_cast<unsigned*>(cq + p.cq_off.ring_mask);
+    r->_cqes = cq + p.cq_off.cqes;
+
+    *ring = std::move(r);
+    return Status::OK();
+}
+
+IoUring::~IoUring() {
+    if (_sqes != nullptr) {
+        munmap(_sqes, _sqes_size);
+    }
+    if (_cq_ring != nullptr && _cq_ring != _sq_ring) {
+        munmap(_cq_ring, _cq_ring_size);
+    }
+    if (_sq_ring != nullptr) {
+        munmap(_sq_ring, _sq_ring_size);
+    }
+    if (_ring_fd >= 0) {
+        close(_ring_fd);
+    }
+}
+
+Status IoUring::_submit_and_wait(uint32_t to_submit, uint32_t min_complete) {
+    while (true) {
+        int ret = io_uring_enter(_ring_fd, to_submit, min_complete, IORING_ENTER_GETEVENTS);
+        if (ret >= 0) {
+            return Status::OK();
+        }
+        if (errno != EINTR && errno != EAGAIN) {
+            return Status::IOError(
+                    strings::Substitute("io_uring_enter failed: $0", errno_to_string(errno)));
+        }
+    }
+}
+
+Status IoUring::preadv(int fd, const struct iovec* iovs, const uint64_t* offsets, size_t cnt,
+                       ssize_t* results) {
+    auto* sqes = static_cast<struct io_uring_sqe*>(_sqes);
+    auto* cqes = static_cast<struct io_uring_cqe*>(_cqes);
+    const unsigned sq_mask = *_sq_mask;
+    const unsigned cq_mask = *_cq_mask;
+    for (size_t start = 0; start < cnt; start += _sq_entries) {
+        // the completion queue has twice the entries, it never overflows with at most
+        // _sq_entries reads in flight
+        uint32_t n = static_cast<uint32_t>(std::min<size_t>(cnt - start, _sq_entries));
+        unsigned tail = *_sq_tail;
+        for (uint32_t i = 0; i < n; ++i) {
+            unsigned idx = tail & sq_mask;
+            struct io_uring_sqe* sqe = &sqes[idx];
+            memset(sqe, 0, sizeof(*sqe));
+            sqe->opcode = IORING_OP_READV;
+            sqe->fd = fd;
+            sqe->addr = reinterpret_cast<uint64_t>(&iovs[start + i]);
+            sqe->len = 1;
+            sqe->off = offsets[start + i];
+            sqe->user_data = start + i;
+            _sq_array[idx] = idx;
+            tail++;
+        }
+        __atomic_store_n(_sq_tail, tail, __ATOMIC_RELEASE);
+
+        RETURN_IF_ERROR(_submit_and_wait(n, n));
+        uint32_t reaped = 0;
+        while (reaped < n) {
+            unsigned head = *_cq_head;
+            unsigned cq_tail = __atomic_load_n(_cq_tail, __ATOMIC_ACQUIRE);
+            if (head == cq_tail) {
+                RETURN_IF_ERROR(_submit_and_wait(0, 1));
+                continue;
+            }
+            for (; head != cq_tail; ++head, ++reaped) {
+                const struct io_uring_cqe& cqe = cqes[head & cq_mask];
+                results[cqe.user_data] = cqe.res;
+            }
+            __atomic_store_n(_cq_head, head, __ATOMIC_RELEASE);
+        }
+    }
+    return Status::OK();
+}
+
+#else
+
+Status IoUring::create(uint32_t entries, std::unique_ptr<IoUring>* ring) {
+    return Status::NotSupported("io_uring is not supported by this build");
+}
+
+IoUring::~IoUring() {}
+
+Status IoUring::_submit_and_wait(uint32_t to_submit, uint32_t min_complete) {
+    return Status::NotSupported("io_uring is not supported by this build");
+}
+
+Status IoUring::preadv(int fd, const struct iovec* iovs, const uint64_t* offsets, size_t cnt,
+                       ssize_t* results) {
+    return Status::NotSupported("io_uring is not supported by this build");
+}
+
+#endif
+
+IoUring* IoUring::thread_local_ring() {
+    static std::atomic<bool> unsupported {false};
+    static thread_local std::unique_ptr<IoUring> ring;
+    if (ring == nullptr && !unsupported.load(std::memory_order_relaxed)) {
+        Status st = create(std::max(1, config::io_uring_queue_depth), &ring);
+        if (!st.ok()) {
+            LOG(WARNING) << "io_uring is not available, read files by pread: " << st.to_string();
+            unsupported.store(true, std::memory_order_relaxed);
+        }
+    }
+    return ring.get();
+}
+
+} // namespace doris
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <sys/types.h>
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "common/status.h"
+#include "gutil/macros.h"
+
+namespace doris {
+
+// A minimal io_uring instance to read many ranges of a file with one system call,
+// driven by the raw io_uring system calls, so it doesn't depend on liburing.
+//
+// Not thread-safe, use thread_local_ring() to get the ring of the calling thread.
+class IoUring {
+public:
+    // Create a ring with at least `entries` submission queue entries.
+    // Return NotSupported if io_uring is not available in the kernel or the build.
+    static Status create(uint32_t entries, std::unique_ptr<IoUring>* ring);
+
+    // The ring of the calling thread, created at the first call with
+    // config::io_uring_queue_depth entries. nullptr if io_uring is not supported,
+    // which is only tried once in a process.
+    static IoUring* thread_local_ring();
+
+    ~IoUring();
+
+    // Read the `cnt` ranges of `fd`, `iovs[i]` at `offsets[i]`, and wait for all the reads.
+    // results[i] is set to the bytes read by the read i, or -errno if it failed. The read
+    // may be short, and it's up to the caller to read the remaining bytes.
+    // Return a non-OK status only if the ring itself fails.
+    Status preadv(int fd, const struct iovec* iovs, const uint64_t* offsets, size_t cnt,
+                  ssize_t* results);
+
+private:
+    IoUring() = default;
+
+    Status _submit_and_wait(uint32_t to_submit, uint32_t min_complete);
+
+    int _ring_fd = -1;
+    uint32_t _sq_entries = 0;
+
+    void* _sq_ring = nullptr;
+    size_t _sq_ring_size = 0;
+    void* _cq_ring = nullptr;
+    size_t _cq_ring_size = 0;
+    void* _sqes = nullptr;
+    size_t _sqes_size = 0;
+
+    unsigned* _sq_tail = nullptr;
+    unsigned* _sq_mask = nullptr;
+    unsigned* _sq_array = nullptr;
+    unsigned* _cq_head = nullptr;
+    unsigned* _cq_tail = nullptr;
+    unsigned* _cq_mask = nullptr;
+    void* _cqes = nullptr;
+
+    DISALLOW_COPY_AND_ASSIGN(IoUring);
+};
+
+} // namespace doris
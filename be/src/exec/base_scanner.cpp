@@ -23,11 +23,19 @@
 #include "common/utils.h"
 #include "exec/exec_node.h"
 #include "exprs/expr_context.h"
+#include "exprs/slot_ref.h"
 #include "runtime/descriptors.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/raw_value.h"
 #include "runtime/runtime_state.h"
 #include "runtime/tuple.h"
+#include "vec/columns/column_complex.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
+#include "vec/runtime/vdatetime_value.h"
 
 namespace doris {
 
@@ -260,6 +268,318 @@ Status BaseScanner::_fill_dest_tuple(Tuple* dest_tuple, MemPool* mem_pool) {
     return Status::OK();
 }
 
+Status BaseScanner::fill_dest_columns(std::vector<vectorized::MutableColumnPtr>& columns) {
+    using namespace vectorized;
+
+    // filter src tuple by preceding filter first
+    if (!ExecNode::eval_conjuncts(&_pre_filter_ctxs[0], _pre_filter_ctxs.size(), _src_tuple_row)) {
+        _counter->num_rows_unselected++;
+        _success = false;
+        return Status::OK();
+    }
+    // convert and fill dest tuple
+    int ctx_idx = 0;
+    for (auto slot_desc : _dest_tuple_desc->slots()) {
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+
+        int dest_index = ctx_idx++;
+        auto* column_ptr = columns[dest_index].get();
+
+        ExprContext* ctx = _dest_expr_ctx[dest_index];
+        void* value = ctx->get_value(_src_tuple_row);
+        if (value == nullptr) {
+            // Only when the expr return value is null, we will check the error message.
+            std::string expr_error = ctx->get_error_msg();
+            if (!expr_error.empty()) {
+                RETURN_IF_ERROR(_state->append_error_msg_to_file(
+                        [&]() -> std::string {
+                            return _src_tuple_row->to_string(*(_row_desc.get()));
+                        },
+                        [&]() -> std::string { return expr_error; }, &_scanner_eof));
+                _counter->num_rows_filtered++;
+                // The ctx is reused, so must clear the error state and message.
+                ctx->clear_error_msg();
+                _success = false;
+                return Status::OK();
+            }
+            // If _strict_mode is false, _src_slot_descs_order_by_dest size could be zero
+            if (_strict_mode && (_src_slot_descs_order_by_dest[dest_index] != nullptr) &&
+                !_src_tuple->is_null(
+                        _src_slot_descs_order_by_dest[dest_index]->null_indicator_offset())) {
+                RETURN_IF_ERROR(_state->append_error_msg_to_file(
+                        [&]() -> std::string {
+                            return _src_tuple_row->to_string(*(_row_desc.get()));
+                        },
+                        [&]() -> std::string {
+                            // Type of the slot is must be Varchar in _src_tuple.
+                            StringValue* raw_value = _src_tuple->get_string_slot(
+                                    _src_slot_descs_order_by_dest[dest_index]->tuple_offset());
+                            std::string raw_string;
+                            if (raw_value != nullptr) { //is not null then get raw value
+                                raw_string = raw_value->to_string();
+                            }
+                            fmt::memory_buffer error_msg;
+                            fmt::format_to(error_msg,
+                                           "column({}) value is incorrect while strict mode is {}, "
+                                           "src value is {}",
+                                           slot_desc->col_name(), _strict_mode, raw_string);
+                            return error_msg.data();
+                        },
+                        &_scanner_eof));
+                _counter->num_rows_filtered++;
+                _success = false;
+                return Status::OK();
+            }
+            if (!slot_desc->is_nullable()) {
+                RETURN_IF_ERROR(_state->append_error_msg_to_file(
+                        [&]() -> std::string {
+                            return _src_tuple_row->to_string(*(_row_desc.get()));
+                        },
+                        [&]() -> std::string {
+                            fmt::memory_buffer error_msg;
+                            fmt::format_to(
+                                    error_msg,
+                                    "column({}) values is null while columns is not nullable",
+                                    slot_desc->col_name());
+                            return error_msg.data();
+                        },
+                        &_scanner_eof));
+                _counter->num_rows_filtered++;
+                _success = false;
+                return Status::OK();
+            }
+            auto* nullable_column = reinterpret_cast<vectorized::ColumnNullable*>(column_ptr);
+            nullable_column->insert_data(nullptr, 0);
+            continue;
+        }
+        if (slot_desc->is_nullable()) {
+            auto* nullable_column = reinterpret_cast<vectorized::ColumnNullable*>(column_ptr);
+            nullable_column->get_null_map_data().push_back(0);
+            column_ptr = &nullable_column->get_nested_column();
+        }
+        char* value_ptr = (char*)value;
+        switch (slot_desc->type().type) {
+        case TYPE_BOOLEAN: {
+            assert_cast<ColumnVector<UInt8>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_TINYINT: {
+            assert_cast<ColumnVector<Int8>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_SMALLINT: {
+            assert_cast<ColumnVector<Int16>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_INT: {
+            assert_cast<ColumnVector<Int32>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_BIGINT: {
+            assert_cast<ColumnVector<Int64>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_LARGEINT: {
+            assert_cast<ColumnVector<Int128>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_FLOAT: {
+            assert_cast<ColumnVector<Float32>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_DOUBLE: {
+            assert_cast<ColumnVector<Float64>*>(column_ptr)->insert_data(value_ptr, 0);
+            break;
+        }
+        case TYPE_CHAR: {
+            Slice* slice = reinterpret_cast<Slice*>(value_ptr);
+            assert_cast<ColumnString*>(column_ptr)
+                    ->insert_data(slice->data, strnlen(slice->data, slice->size));
+            break;
+        }
+        case TYPE_VARCHAR:
+        case TYPE_STRING: {
+            Slice* slice = reinterpret_cast<Slice*>(value_ptr);
+            assert_cast<ColumnString*>(column_ptr)->insert_data(slice->data, slice->size);
+            break;
+        }
+        case TYPE_OBJECT: {
+            Slice* slice = reinterpret_cast<Slice*>(value_ptr);
+            // insert_default()
+            auto* target_column = assert_cast<ColumnBitmap*>(column_ptr);
+
+            target_column->insert_default();
+            BitmapValue* pvalue = nullptr;
+            int pos = target_column->size() - 1;
+            pvalue = &target_column->get_element(pos);
+
+            if (slice->size != 0) {
+                BitmapValue value;
+                value.deserialize(slice->data);
+                *pvalue = std::move(value);
+            } else {
+                *pvalue = std::move(*reinterpret_cast<BitmapValue*>(slice->data));
+            }
+            break;
+        }
+        case TYPE_HLL: {
+            Slice* slice = reinterpret_cast<Slice*>(value_ptr);
+            auto* target_column = assert_cast<ColumnHLL*>(column_ptr);
+
+            target_column->insert_default();
+            HyperLogLog* pvalue = nullptr;
+            int pos = target_column->size() - 1;
+            pvalue = &target_column->get_element(pos);
+            if (slice->size != 0) {
+                HyperLogLog value;
+                value.deserialize(*slice);
+                *pvalue = std::move(value);
+            } else {
+                *pvalue = std::move(*reinterpret_cast<HyperLogLog*>(slice->data));
+            }
+            break;
+        }
+        case TYPE_DECIMALV2: {
+            assert_cast<ColumnDecimal<Decimal128>*>(column_ptr)
+                    ->insert_data(reinterpret_cast<char*>(value_ptr), 0);
+            break;
+        }
+        case TYPE_DATETIME: {
+            DateTimeValue value = *reinterpret_cast<DateTimeValue*>(value_ptr);
+            VecDateTimeValue date;
+            date.convert_dt_to_vec_dt(&value);
+            assert_cast<ColumnVector<Int64>*>(column_ptr)
+                    ->insert_data(reinterpret_cast<char*>(&date), 0);
+            break;
+        }
+        case TYPE_DATE: {
+            DateTimeValue value = *reinterpret_cast<DateTimeValue*>(value_ptr);
+            VecDateTimeValue date;
+            date.convert_dt_to_vec_dt(&value);
+            assert_cast<ColumnVector<Int64>*>(column_ptr)
+                    ->insert_data(reinterpret_cast<char*>(&date), 0);
+            break;
+        }
+        default: {
+            break;
+        }
+        }
+    }
+    _success = true;
+    return Status::OK();
+}
+
+void BaseScanner::get_pre_filter_predicates(std::vector<PreFilterPredicate>* predicates) {
+    std::map<SlotId, size_t> slot_idxs;
+    for (size_t i = 0; i < _src_slot_descs.size(); ++i) {
+        slot_idxs.emplace(_src_slot_descs[i]->id(), i);
+    }
+    for (auto ctx : _pre_filter_ctxs) {
+        Expr* root = ctx->root();
+        if (root->node_type() != TExprNodeType::BINARY_PRED || root->get_num_children() != 2) {
+            continue;
+        }
+        TExprOpcode::type op = root->op();
+        Expr* column = root->get_child(0);
+        Expr* value = root->get_child(1);
+        if (column->is_constant()) {
+            std::swap(column, value);
+            switch (op) {
+            case TExprOpcode::LT:
+                op = TExprOpcode::GT;
+                break;
+            case TExprOpcode::LE:
+                op = TExprOpcode::GE;
+                break;
+            case TExprOpcode::GT:
+                op = TExprOpcode::LT;
+                break;
+            case TExprOpcode::GE:
+                op = TExprOpcode::LE;
+                break;
+            default:
+                break;
+            }
+        }
+        if (!value->is_constant()) {
+            continue;
+        }
+        bool is_cast = column->node_type() == TExprNodeType::CAST_EXPR &&
+                       column->get_num_children() == 1;
+        Expr* slot = is_cast ? column->get_child(0) : column;
+        if (slot->node_type() != TExprNodeType::SLOT_REF || !slot->type().is_string_type()) {
+            continue;
+        }
+        auto it = slot_idxs.find(static_cast<SlotRef*>(slot)->slot_id());
+        if (it == slot_idxs.end()) {
+            continue;
+        }
+
+        PreFilterPredicate predicate;
+        predicate.slot_idx = it->second;
+        predicate.op = op;
+        if (!is_cast) {
+            if (!value->type().is_string_type()) {
+                continue;
+            }
+            StringVal string_val = value->get_string_val(ctx, nullptr);
+            if (string_val.is_null) {
+                continue;
+            }
+            predicate.is_string = true;
+            predicate.string_value.assign(reinterpret_cast<const char*>(string_val.ptr),
+                                          string_val.len);
+            predicates->push_back(std::move(predicate));
+            continue;
+        }
+
+        // the integer values cast from the strings
+        if (column->type().type != value->type().type) {
+            continue;
+        }
+        predicate.is_string = false;
+        switch (value->type().type) {
+        case TYPE_TINYINT: {
+            TinyIntVal val = value->get_tiny_int_val(ctx, nullptr);
+            if (val.is_null) {
+                continue;
+            }
+            predicate.int_value = val.val;
+            break;
+        }
+        case TYPE_SMALLINT: {
+            SmallIntVal val = value->get_small_int_val(ctx, nullptr);
+            if (val.is_null) {
+                continue;
+            }
+            predicate.int_value = val.val;
+            break;
+        }
+        case TYPE_INT: {
+            IntVal val = value->get_int_val(ctx, nullptr);
+            if (val.is_null) {
+                continue;
+            }
+            predicate.int_value = val.val;
+            break;
+        }
+        case TYPE_BIGINT: {
+            BigIntVal val = value->get_big_int_val(ctx, nullptr);
+            if (val.is_null) {
+                continue;
+            }
+            predicate.int_value = val.val;
+            break;
+        }
+        default:
+            continue;
+        }
+        predicates->push_back(std::move(predicate));
+    }
+}
+
 void BaseScanner::fill_slots_of_columns_from_path(
         int start, const std::vector<std::string>& columns_from_path) {
     // values of columns from path can not be null
@@ -48,6 +48,18 @@ struct ScannerCounter {
     int64_t num_rows_unselected; // rows filtered by predicates
 };
 
+// A predicate `slot op value` of the preceding filters on a src slot, which is used by the
+// scanners of the columnar files to skip the data by the statistics of the columns. The value is
+// an integer if the src slot is cast to an integer type, else a string.
+struct PreFilterPredicate {
+    // the index of the src slot in _src_slot_descs
+    size_t slot_idx;
+    TExprOpcode::type op;
+    bool is_string;
+    int64_t int_value = 0;
+    std::string string_value;
+};
+
 class BaseScanner {
 public:
     BaseScanner(RuntimeState* state, RuntimeProfile* profile, const TBrokerScanRangeParams& params,
@@ -69,12 +81,19 @@ public:
     // Close this scanner
     virtual void close() = 0;
     Status fill_dest_tuple(Tuple* dest_tuple, MemPool* mem_pool, bool* fill_tuple);
+    // Filter the src tuple by the preceding filters, and append the values of the dest slots
+    // converted from the src tuple to `columns`. `_success` is false if the row is filtered.
+    Status fill_dest_columns(std::vector<vectorized::MutableColumnPtr>& columns);
 
     void fill_slots_of_columns_from_path(int start,
                                          const std::vector<std::string>& columns_from_path);
 
     void free_expr_local_allocations();
 
+    // Extract the predicates of the form `slot op literal` (or `cast(slot as integer) op
+    // literal`) on the src slots from the preceding filters.
+    void get_pre_filter_predicates(std::vector<PreFilterPredicate>* predicates);
+
 protected:
     RuntimeState* _state;
     const TBrokerScanRangeParams& _params;
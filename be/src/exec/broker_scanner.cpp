@@ -37,6 +37,7 @@
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_pipe.h"
 #include "runtime/tuple.h"
+#include "util/simd/bits.h"
 #include "util/utf8_check.h"
 #include "common/consts.h"
 
@@ -338,39 +339,21 @@ void BrokerScanner::split_line(const Slice& line) {
         delete[] ptr;
     } else {
         const char* value = line.data;
-        size_t start = 0;  // point to the start pos of next col value.
-        size_t curpos = 0; // point to the start pos of separator matching sequence.
-        size_t p1 = 0;     // point to the current pos of separator matching sequence.
-
-        // Separator: AAAA
-        //
-        //   curpos
-        //     ▼
-        //     AAAA
-        //   1000AAAA2000AAAA
-        //   ▲   ▲
-        // Start │
-        //       p1
-
-        while (curpos < line.size) {
-            if (*(value + curpos + p1) != _value_separator[p1]) {
-                // Not match, move forward:
-                curpos += (p1 == 0 ? 1 : p1);
-                p1 = 0;
-            } else {
-                p1++;
-                if (p1 == _value_separator_length) {
-                    // Match a separator
-                    _split_values.emplace_back(value + start, curpos - start);
-                    start = curpos + _value_separator_length;
-                    curpos = start;
-                    p1 = 0;
-                }
+        size_t start = 0; // point to the start pos of next col value.
+        // The positions of the first byte of the separator are found by simd, and the rest of
+        // the separator is matched at each of them.
+        const char* separator = _value_separator.data();
+        const size_t separator_length = _value_separator_length;
+        const size_t size =
+                line.size >= separator_length ? line.size - separator_length + 1 : 0;
+        simd::for_each_char_position(value, size, separator[0], [&](size_t pos) {
+            if (pos >= start &&
+                memcmp(value + pos + 1, separator + 1, separator_length - 1) == 0) {
+                _split_values.emplace_back(value + start, pos - start);
+                start = pos + separator_length;
             }
-        }
-
-        CHECK(curpos == line.size) << curpos << " vs " << line.size;
-        _split_values.emplace_back(value + start, curpos - start);
+        });
+        _split_values.emplace_back(value + start, line.size - start);
     }
 }
 
@@ -18,28 +18,83 @@
 #include "exec/buffered_reader.h"
 
 #include <algorithm>
+#include <chrono>
 #include <sstream>
 
 #include "common/config.h"
 #include "common/logging.h"
+#include "runtime/exec_env.h"
+#include "util/stopwatch.hpp"
+#include "util/threadpool.h"
 
 namespace doris {
 
+namespace {
+
+// the latencies of the recent remote reads of all the buffered readers, to decide when to
+// issue the hedged reads
+class RemoteReadLatencies {
+public:
+    static RemoteReadLatencies* instance() {
+        static RemoteReadLatencies latencies;
+        return &latencies;
+    }
+
+    void add(int64_t latency_us) {
+        std::lock_guard<std::mutex> l(_lock);
+        _samples[_next] = latency_us;
+        _next = (_next + 1) % kMaxSamples;
+        _num_samples = std::min(_num_samples + 1, kMaxSamples);
+    }
+
+    // -1 if there are not enough samples
+    int64_t percentile(int p) {
+        std::vector<int64_t> samples;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            if (_num_samples < kMinSamples) {
+                return -1;
+            }
+            samples.assign(_samples.begin(), _samples.begin() + _num_samples);
+        }
+        size_t nth = std::min(samples.size() - 1, samples.size() * p / 100);
+        std::nth_element(samples.begin(), samples.begin() + nth, samples.end());
+        return samples[nth];
+    }
+
+private:
+    static constexpr size_t kMaxSamples = 1024;
+    static constexpr size_t kMinSamples = 32;
+
+    std::mutex _lock;
+    std::vector<int64_t> _samples = std::vector<int64_t>(kMaxSamples);
+    size_t _next = 0;
+    size_t _num_samples = 0;
+};
+
+} // namespace
+
 // buffered reader
-BufferedReader::BufferedReader(RuntimeProfile* profile, FileReader* reader, int64_t buffer_size)
+BufferedReader::BufferedReader(RuntimeProfile* profile, FileReader* reader, int64_t buffer_size,
+                               ThreadPool* read_pool)
         : _profile(profile),
           _reader(reader),
           _buffer_size(buffer_size),
           _buffer_offset(0),
           _buffer_limit(0),
-          _cur_offset(0) {
+          _cur_offset(0),
+          _read_pool(read_pool) {
     if (_buffer_size == -1L) {
         _buffer_size = config::remote_storage_read_buffer_mb * 1024 * 1024;
     }
-    _buffer = new char[_buffer_size];
+    if (_read_pool == nullptr) {
+        _read_pool = ExecEnv::GetInstance()->remote_read_thread_pool();
+    }
+    _buffer.reset(new char[_buffer_size]);
     // set the _cur_offset of this reader as same as the inner reader's,
     // to make sure the buffer reader will start to read at right position.
     _reader->tell(&_cur_offset);
+    _last_fill_end = _cur_offset;
 }
 
 BufferedReader::~BufferedReader() {
@@ -59,6 +114,8 @@ Status BufferedReader::open() {
     _remote_read_timer = ADD_CHILD_TIMER(_profile, "FileRemoteReadTime", "FileReadTime");
     _read_counter = ADD_COUNTER(_profile, "FileReadCalls", TUnit::UNIT);
     _remote_read_counter = ADD_COUNTER(_profile, "FileRemoteReadCalls", TUnit::UNIT);
+    _prefetch_hit_counter = ADD_COUNTER(_profile, "FilePrefetchHits", TUnit::UNIT);
+    _hedged_read_counter = ADD_COUNTER(_profile, "FileRemoteHedgedReads", TUnit::UNIT);
 
     RETURN_IF_ERROR(_reader->open());
     return Status::OK();
@@ -112,6 +169,7 @@ Status BufferedReader::_read_once(int64_t position, int64_t nbytes, int64_t* byt
         // if requested length is larger than the capacity of buffer, do not
         // need to copy the character into local buffer.
         if (nbytes > _buffer_size) {
+            std::lock_guard<std::mutex> l(_reader_lock);
             auto st = _reader->readat(position, nbytes, bytes_read, out);
             if (st.ok()) {
                 _cur_offset = position + *bytes_read;
@@ -120,29 +178,197 @@ Status BufferedReader::_read_once(int64_t position, int64_t nbytes, int64_t* byt
         }
         _buffer_offset = position;
         RETURN_IF_ERROR(_fill());
-        if (position >= _buffer_limit) {
+        if (position >= _buffer_limit || position < _buffer_offset) {
             *bytes_read = 0;
             return Status::OK();
         }
     }
     int64_t len = std::min(_buffer_limit - position, nbytes);
     int64_t off = position - _buffer_offset;
-    memcpy(out, _buffer + off, len);
+    memcpy(out, _buffer.get() + off, len);
     *bytes_read = len;
     _cur_offset = position + *bytes_read;
     return Status::OK();
 }
 
 Status BufferedReader::_fill() {
-    if (_buffer_offset >= 0) {
+    if (_buffer_offset < 0) {
+        return Status::OK();
+    }
+    // coalesce the bytes skipped after the last buffer into this one
+    int64_t gap = _buffer_offset - _last_fill_end;
+    bool sequential = gap >= 0 && gap <= std::min<int64_t>(config::remote_read_coalesce_gap_bytes,
+                                                           _buffer_size / 2);
+    if (sequential) {
+        _buffer_offset = _last_fill_end;
+    }
+    bool hedge = _read_pool != nullptr && _reader->support_concurrent_reads() &&
+                 config::remote_read_hedge_percentile > 0;
+
+    SCOPED_TIMER(_remote_read_timer);
+    auto read = _take_prefetch(_buffer_offset);
+    if (read != nullptr) {
+        RETURN_IF_ERROR(_wait_read(read));
+        // a short read may not cover the position, read it again
+        if (read->offset + read->bytes_read <= _buffer_offset) {
+            read = nullptr;
+        } else {
+            _prefetch_hit_count++;
+        }
+    }
+    if (read == nullptr && hedge) {
+        _remote_read_count++;
+        read = _submit_read(_buffer_offset, _buffer_size);
+        RETURN_IF_ERROR(_wait_read(read));
+    }
+    if (read != nullptr) {
+        std::lock_guard<std::mutex> l(read->lock);
+        _buffer = std::move(read->data);
+        _buffer_offset = read->offset;
+        _buffer_limit = read->offset + read->bytes_read;
+    } else {
+        _remote_read_count++;
         int64_t bytes_read = 0;
-        SCOPED_TIMER(_remote_read_timer);
-        RETURN_IF_ERROR(_reader->readat(_buffer_offset, _buffer_size, &bytes_read, _buffer));
+        std::lock_guard<std::mutex> l(_reader_lock);
+        RETURN_IF_ERROR(
+                _reader->readat(_buffer_offset, _buffer_size, &bytes_read, _buffer.get()));
         _buffer_limit = _buffer_offset + bytes_read;
     }
+    _last_fill_end = _buffer_limit;
+    if (sequential) {
+        _prefetch();
+    }
     return Status::OK();
 }
 
+std::shared_ptr<BufferedReader::RangeRead> BufferedReader::_take_prefetch(int64_t offset) {
+    while (!_prefetches.empty()) {
+        auto read = _prefetches.front();
+        _prefetches.pop_front();
+        if (read->offset > offset) {
+            // not a sequential read, the prefetched buffers are useless
+            _prefetches.clear();
+            return nullptr;
+        }
+        if (offset < read->offset + read->nbytes) {
+            return read;
+        }
+    }
+    return nullptr;
+}
+
+void BufferedReader::_prefetch() {
+    if (_read_pool == nullptr || config::remote_read_prefetch_buffers <= 0) {
+        return;
+    }
+    // the prefetched buffers follow the current one
+    if (!_prefetches.empty() && _prefetches.front()->offset != _last_fill_end) {
+        _prefetches.clear();
+    }
+    int64_t offset = _prefetches.empty() ? _last_fill_end
+                                         : _prefetches.back()->offset + _prefetches.back()->nbytes;
+    if (!_file_size_known) {
+        // not cached by all the readers, so it can't run with the background reads
+        std::lock_guard<std::mutex> l(_reader_lock);
+        _file_size = _reader->size();
+        _file_size_known = true;
+    }
+    while (_prefetches.size() < static_cast<size_t>(config::remote_read_prefetch_buffers)) {
+        if (_file_size > 0 && offset >= _file_size) {
+            break;
+        }
+        _remote_read_count++;
+        _prefetches.push_back(_submit_read(offset, _buffer_size));
+        offset += _buffer_size;
+    }
+}
+
+std::shared_ptr<BufferedReader::RangeRead> BufferedReader::_submit_read(int64_t offset,
+                                                                       int64_t nbytes) {
+    auto read = std::make_shared<RangeRead>();
+    read->offset = offset;
+    read->nbytes = nbytes;
+    read->start_time = std::chrono::steady_clock::now();
+    _start_attempt(read);
+    return read;
+}
+
+void BufferedReader::_start_attempt(const std::shared_ptr<RangeRead>& read) {
+    auto finish = [this, read](Status st, int64_t bytes_read, std::unique_ptr<char[]> data) {
+        {
+            std::lock_guard<std::mutex> l(read->lock);
+            read->running--;
+            // the first succeeded attempt wins, a failure only if all the attempts failed
+            if (!read->done && (st.ok() || read->running == 0)) {
+                read->done = true;
+                read->status = st;
+                read->bytes_read = bytes_read;
+                read->data = std::move(data);
+                read->cv.notify_all();
+            }
+        }
+        std::lock_guard<std::mutex> l(_background_lock);
+        if (--_background_reads == 0) {
+            _background_cv.notify_all();
+        }
+    };
+    {
+        std::lock_guard<std::mutex> l(read->lock);
+        read->running++;
+    }
+    {
+        std::lock_guard<std::mutex> l(_background_lock);
+        _background_reads++;
+    }
+    auto st = _read_pool->submit_func([this, read, finish]() {
+        std::unique_ptr<char[]> data(new char[read->nbytes]);
+        int64_t bytes_read = 0;
+        MonotonicStopWatch watch;
+        watch.start();
+        Status read_st;
+        if (_reader->support_concurrent_reads()) {
+            read_st = _reader->readat(read->offset, read->nbytes, &bytes_read, data.get());
+        } else {
+            std::lock_guard<std::mutex> l(_reader_lock);
+            read_st = _reader->readat(read->offset, read->nbytes, &bytes_read, data.get());
+        }
+        if (read_st.ok()) {
+            RemoteReadLatencies::instance()->add(watch.elapsed_time() / 1000);
+        }
+        finish(read_st, bytes_read, std::move(data));
+    });
+    if (!st.ok()) {
+        finish(st, 0, nullptr);
+    }
+}
+
+Status BufferedReader::_wait_read(const std::shared_ptr<RangeRead>& read) {
+    std::unique_lock<std::mutex> l(read->lock);
+    if (!read->done && !read->hedged && _reader->support_concurrent_reads() &&
+        config::remote_read_hedge_percentile > 0) {
+        int64_t delay_us = RemoteReadLatencies::instance()->percentile(
+                std::min(config::remote_read_hedge_percentile, 100));
+        if (delay_us >= 0) {
+            delay_us = std::max(delay_us, config::remote_read_hedge_min_delay_ms * 1000);
+            auto deadline = read->start_time + std::chrono::microseconds(delay_us);
+            if (!read->cv.wait_until(l, deadline, [&read]() { return read->done; })) {
+                read->hedged = true;
+                l.unlock();
+                _hedged_read_count++;
+                _start_attempt(read);
+                l.lock();
+            }
+        }
+    }
+    read->cv.wait(l, [&read]() { return read->done; });
+    return read->status;
+}
+
+void BufferedReader::_wait_background_reads() {
+    std::unique_lock<std::mutex> l(_background_lock);
+    _background_cv.wait(l, [this]() { return _background_reads == 0; });
+}
+
 int64_t BufferedReader::size() {
     return _reader->size();
 }
@@ -158,8 +384,10 @@ Status BufferedReader::tell(int64_t* position) {
 }
 
 void BufferedReader::close() {
+    _wait_background_reads();
+    _prefetches.clear();
     _reader->close();
-    SAFE_DELETE_ARRAY(_buffer);
+    _buffer.reset();
 
     if (_read_counter != nullptr) {
         COUNTER_UPDATE(_read_counter, _read_count);
@@ -167,6 +395,12 @@ void BufferedReader::close() {
     if (_remote_read_counter != nullptr) {
         COUNTER_UPDATE(_remote_read_counter, _remote_read_count);
     }
+    if (_prefetch_hit_counter != nullptr) {
+        COUNTER_UPDATE(_prefetch_hit_counter, _prefetch_hit_count);
+    }
+    if (_hedged_read_counter != nullptr) {
+        COUNTER_UPDATE(_hedged_read_counter, _hedged_read_count);
+    }
 }
 
 bool BufferedReader::closed() {
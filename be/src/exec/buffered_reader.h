@@ -19,7 +19,12 @@
 
 #include <stdint.h>
 
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 #include "common/status.h"
 #include "exec/file_reader.h"
@@ -28,16 +33,28 @@
 
 namespace doris {
 
+class ThreadPool;
+
 // Buffered Reader
 // Add a cache layer between the caller and the file reader to reduce the
 // times of calls to the read function to speed up.
+//
+// The buffers after a sequential read are prefetched in the background, at most
+// remote_read_prefetch_buffers of them. The reads of the buffers within
+// remote_read_coalesce_gap_bytes after the last one are sequential, the bytes skipped are read
+// together with the buffer. If the inner reader supports concurrent reads, the buffers are
+// prefetched in parallel, and a read slower than the remote_read_hedge_percentile percentile of
+// the recent reads is issued again, the first finished one is used.
 class BufferedReader : public FileReader {
 public:
     // If the reader need the file size, set it when construct FileReader.
     // There is no other way to set the file size.
     // buffered_reader will acquire reader
     // -1 means using config buffered_reader_buffer_size_bytes
-    BufferedReader(RuntimeProfile* profile, FileReader* reader, int64_t = -1L);
+    // the background reads are run by `read_pool`, or the remote read thread pool of ExecEnv
+    // if it's nullptr. There are no background reads if neither of them exists.
+    BufferedReader(RuntimeProfile* profile, FileReader* reader, int64_t = -1L,
+                   ThreadPool* read_pool = nullptr);
     virtual ~BufferedReader();
 
     virtual Status open() override;
@@ -54,13 +71,43 @@ public:
     virtual bool closed() override;
 
 private:
+    // a read of a buffer from the inner reader in the background, shared with the tasks, as a
+    // hedged read may finish after the reader gives up waiting for it
+    struct RangeRead {
+        int64_t offset = 0;
+        int64_t nbytes = 0;
+        std::mutex lock;
+        std::condition_variable cv;
+        // the number of running attempts
+        int running = 0;
+        bool hedged = false;
+        bool done = false;
+        std::chrono::steady_clock::time_point start_time;
+        Status status;
+        int64_t bytes_read = 0;
+        // the data of the first succeeded attempt
+        std::unique_ptr<char[]> data;
+    };
+
     Status _fill();
     Status _read_once(int64_t position, int64_t nbytes, int64_t* bytes_read, void* out);
 
+    // start a read of [offset, offset + nbytes) in the background
+    std::shared_ptr<RangeRead> _submit_read(int64_t offset, int64_t nbytes);
+    void _start_attempt(const std::shared_ptr<RangeRead>& read);
+    // wait for the read, and issue a hedged read if it's slow
+    Status _wait_read(const std::shared_ptr<RangeRead>& read);
+    // the prefetched read including `offset`, the prefetched reads before it are dropped
+    std::shared_ptr<RangeRead> _take_prefetch(int64_t offset);
+    // prefetch the buffers after the current one
+    void _prefetch();
+    // wait for all the background reads, which use the inner reader
+    void _wait_background_reads();
+
 private:
     RuntimeProfile* _profile;
     std::unique_ptr<FileReader> _reader;
-    char* _buffer;
+    std::unique_ptr<char[]> _buffer;
     int64_t _buffer_size;
     int64_t _buffer_offset;
     int64_t _buffer_limit;
@@ -68,6 +115,22 @@ private:
 
     int64_t _read_count = 0;
     int64_t _remote_read_count = 0;
+    int64_t _prefetch_hit_count = 0;
+    int64_t _hedged_read_count = 0;
+
+    ThreadPool* _read_pool = nullptr;
+    // the inner reader is used by one thread at a time, unless it supports concurrent reads
+    std::mutex _reader_lock;
+    std::deque<std::shared_ptr<RangeRead>> _prefetches;
+    // the end of the last buffer filled, to tell the sequential reads
+    int64_t _last_fill_end = 0;
+    // the size of the inner file, -1 if unknown
+    int64_t _file_size = -1;
+    bool _file_size_known = false;
+    // the number of the running background attempts
+    std::mutex _background_lock;
+    std::condition_variable _background_cv;
+    int _background_reads = 0;
 
     // total time cost in this reader
     RuntimeProfile::Counter* _read_timer = nullptr;
@@ -77,6 +140,10 @@ private:
     RuntimeProfile::Counter* _read_counter = nullptr;
     // counter of calling "remote read()"
     RuntimeProfile::Counter* _remote_read_counter = nullptr;
+    // counter of the buffers filled by the prefetched reads
+    RuntimeProfile::Counter* _prefetch_hit_counter = nullptr;
+    // counter of the hedged reads issued when a remote read is slow
+    RuntimeProfile::Counter* _hedged_read_counter = nullptr;
 };
 
 } // namespace doris
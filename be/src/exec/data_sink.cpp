@@ -40,6 +40,8 @@
 
 #include "vec/sink/result_sink.h"
 #include "vec/sink/vdata_stream_sender.h"
+#include "vec/sink/vmemory_scratch_sink.h"
+#include "vec/sink/vresult_file_sink.h"
 #include "vec/sink/vmysql_table_writer.h"
 #include "vec/sink/vtablet_sink.h"
 #include "vec/sink/vmysql_table_sink.h"
@@ -99,6 +101,9 @@ Status DataSink::create_data_sink(ObjectPool* pool, const TDataSink& thrift_sink
         if (params.__isset.destinations && params.destinations.size() > 0) {
             tmp_sink = new ResultFileSink(row_desc, output_exprs, thrift_sink.result_file_sink,
                                           params.destinations, pool, params.sender_id, desc_tbl);
+        } else if (is_vec) {
+            tmp_sink = new vectorized::VResultFileSink(row_desc, output_exprs,
+                                                       thrift_sink.result_file_sink);
         } else {
             tmp_sink = new ResultFileSink(row_desc, output_exprs, thrift_sink.result_file_sink);
         }
@@ -110,7 +115,13 @@ Status DataSink::create_data_sink(ObjectPool* pool, const TDataSink& thrift_sink
             return Status::InternalError("Missing data buffer sink.");
         }
 
-        tmp_sink = new MemoryScratchSink(row_desc, output_exprs, thrift_sink.memory_scratch_sink);
+        if (is_vec) {
+            tmp_sink = new vectorized::VMemoryScratchSink(row_desc, output_exprs,
+                                                          thrift_sink.memory_scratch_sink);
+        } else {
+            tmp_sink =
+                    new MemoryScratchSink(row_desc, output_exprs, thrift_sink.memory_scratch_sink);
+        }
         sink->reset(tmp_sink);
         break;
     }
@@ -130,7 +130,7 @@ Status ESScanReader::get_next(bool* scan_eos, std::unique_ptr<ScrollParser>& scr
     }
 
     if (_is_first) {
-        response = _cached_response;
+        response = std::move(_cached_response);
         _is_first = false;
     } else {
         if (_exactly_once) {
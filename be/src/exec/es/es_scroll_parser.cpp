@@ -290,9 +290,9 @@ Status ScrollParser::parse(const std::string& scroll_result, bool exactly_once)
     if (!inner_hits_node.IsArray()) {
         return Status::OK();
     }
-    _inner_hits_node.CopyFrom(inner_hits_node, _document_node.GetAllocator());
+    _inner_hits_node = &inner_hits_node;
     // how many documents contains in this batch
-    _size = _inner_hits_node.Size();
+    _size = _inner_hits_node->Size();
     return Status::OK();
 }
 
@@ -313,7 +313,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
         return Status::OK();
     }
 
-    const rapidjson::Value& obj = _inner_hits_node[_line_index++];
+    const rapidjson::Value& obj = (*_inner_hits_node)[_line_index++];
     bool pure_doc_value = false;
     if (obj.HasMember("fields")) {
         pure_doc_value = true;
@@ -378,7 +378,7 @@ Status ScrollParser::fill_tuple(const TupleDescriptor* tuple_desc, Tuple* tuple,
         }
 
         tuple->set_not_null(slot_desc->null_indicator_offset());
-        const rapidjson::Value& col = line[col_name];
+        const rapidjson::Value& col = itr->value;
 
         void* slot = tuple->get_slot(slot_desc->tuple_offset());
         PrimitiveType type = slot_desc->type().type;
@@ -588,7 +588,7 @@ Status ScrollParser::fill_columns(const TupleDescriptor* tuple_desc,
         return Status::OK();
     }
 
-    const rapidjson::Value& obj = _inner_hits_node[_line_index++];
+    const rapidjson::Value& obj = (*_inner_hits_node)[_line_index++];
     bool pure_doc_value = false;
     if (obj.HasMember("fields")) {
         pure_doc_value = true;
@@ -630,7 +630,7 @@ Status ScrollParser::fill_columns(const TupleDescriptor* tuple_desc,
             return Status::RuntimeError(details);
         }
 
-        const rapidjson::Value& col = line[col_name];
+        const rapidjson::Value& col = itr->value;
 
         PrimitiveType type = slot_desc->type().type;
 
@@ -62,7 +62,8 @@ private:
     rapidjson::SizeType _line_index;
 
     rapidjson::Document _document_node;
-    rapidjson::Value _inner_hits_node;
+    // the hits array in _document_node, nullptr if there is no hit
+    const rapidjson::Value* _inner_hits_node = nullptr;
 
     // todo(milimin): ScrollParser should be divided into two classes: SourceParser and DocValueParser,
     // including remove some variables in the current implementation, e.g. pure_doc_value.
@@ -17,9 +17,11 @@
 
 #include "exec/es_http_scan_node.h"
 
+#include <algorithm>
 #include <chrono>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exec/es/es_predicate.h"
 #include "exec/es/es_query_builder.h"
@@ -172,19 +174,28 @@ Status EsHttpScanNode::open(RuntimeState* state) {
 }
 
 Status EsHttpScanNode::start_scanners() {
+    // the limit is pushed down by one search request of each range, which can't be sliced
+    _slices_per_shard = can_push_down_limit() ? 1 : std::max(1, config::es_scroll_slices_per_shard);
+    int num_scanners = _scan_ranges.size() * _slices_per_shard;
     {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
-        _num_running_scanners = _scan_ranges.size();
+        _num_running_scanners = num_scanners;
     }
 
-    _scanners_status.resize(_scan_ranges.size());
-    for (int i = 0; i < _scan_ranges.size(); i++) {
-        _scanner_threads.emplace_back(&EsHttpScanNode::scanner_worker, this, i, _scan_ranges.size(),
+    _scanners_status.resize(num_scanners);
+    for (int i = 0; i < num_scanners; i++) {
+        _scanner_threads.emplace_back(&EsHttpScanNode::scanner_worker, this, i, num_scanners,
                                       std::ref(_scanners_status[i]));
     }
     return Status::OK();
 }
 
+bool EsHttpScanNode::can_push_down_limit() const {
+    // if predicate in _conjunct_ctxs can not be processed by Elasticsearch, we can not push down
+    // limit operator to Elasticsearch
+    return limit() != -1 && limit() <= _runtime_state->batch_size() && _conjunct_ctxs.empty();
+}
+
 Status EsHttpScanNode::collect_scanners_status() {
     // NOTE. if open() was called, but set_range() was NOT called for some reason.
     // then close() was called.
@@ -434,7 +445,8 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
     }
 
     EsScanCounter counter;
-    const TEsScanRange& es_scan_range = _scan_ranges[start_idx].scan_range.es_scan_range;
+    const TEsScanRange& es_scan_range =
+            _scan_ranges[start_idx / _slices_per_shard].scan_range.es_scan_range;
 
     // Collect the information from scan range to properties
     std::map<std::string, std::string> properties(_properties);
@@ -446,10 +458,13 @@ void EsHttpScanNode::scanner_worker(int start_idx, int length, std::promise<Stat
     properties[ESScanReader::KEY_BATCH_SIZE] = std::to_string(_runtime_state->batch_size());
     properties[ESScanReader::KEY_HOST_PORT] = get_host_port(es_scan_range.es_hosts);
     // push down limit to Elasticsearch
-    // if predicate in _conjunct_ctxs can not be processed by Elasticsearch, we can not push down limit operator to Elasticsearch
-    if (limit() != -1 && limit() <= _runtime_state->batch_size() && _conjunct_ctxs.empty()) {
+    if (can_push_down_limit()) {
         properties[ESScanReader::KEY_TERMINATE_AFTER] = std::to_string(limit());
     }
+    if (_slices_per_shard > 1) {
+        properties[ESScanReader::KEY_SLICE_ID] = std::to_string(start_idx % _slices_per_shard);
+        properties[ESScanReader::KEY_SLICE_MAX] = std::to_string(_slices_per_shard);
+    }
 
     bool doc_value_mode = false;
     properties[ESScanReader::KEY_QUERY] = ESScrollQueryBuilder::build(
@@ -66,7 +66,8 @@ protected:
         return false;
     }
 
-    // One scanner worker, This scanner will handle 'length' ranges start from start_idx
+    // One scanner worker, This scanner will handle the slice `start_idx % _slices_per_shard` of
+    // the range `start_idx / _slices_per_shard`, `length` is the number of the scanners
     virtual void scanner_worker(int start_idx, int length, std::promise<Status>& p_status);
 
     TupleId _tuple_id;
@@ -104,11 +105,16 @@ private:
 
     Status build_conjuncts_list();
 
+    // whether the limit is pushed down to Elasticsearch by terminate_after
+    bool can_push_down_limit() const;
+
     std::vector<std::thread> _scanner_threads;
     std::vector<std::promise<Status>> _scanners_status;
     std::map<std::string, std::string> _properties;
     std::map<std::string, std::string> _fields_context;
     std::vector<TScanRangeParams> _scan_ranges;
+    // the sliced scrolls of each range, each of them is read by one scanner
+    int _slices_per_shard = 1;
     std::vector<std::string> _column_names;
 
     std::mutex _batch_queue_lock;
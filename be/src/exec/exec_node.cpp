@@ -25,6 +25,7 @@
 
 #include <sstream>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "common/status.h"
 #include "exec/analytic_eval_node.h"
@@ -64,6 +65,7 @@
 #include "util/runtime_profile.h"
 #include "vec/core/block.h"
 #include "vec/exec/join/vhash_join_node.h"
+#include "vec/exec/join/vmerge_join_node.h"
 #include "vec/exec/vaggregation_node.h"
 #include "vec/exec/vanalytic_eval_node.h"
 #include "vec/exec/vassert_num_rows_node.h"
@@ -80,6 +82,7 @@
 #include "vec/exec/vschema_scan_node.h"
 #include "vec/exec/vselect_node.h"
 #include "vec/exec/vsort_node.h"
+#include "vec/exec/vtopn_node.h"
 #include "vec/exec/vtable_function_node.h"
 #include "vec/exec/vunion_node.h"
 #include "vec/exec/vbroker_scan_node.h"
@@ -209,6 +212,10 @@ Status ExecNode::prepare(RuntimeState* state) {
             std::bind<int64_t>(&RuntimeProfile::units_per_second, _rows_returned_counter,
                                runtime_profile()->total_time_counter()),
             "");
+    if (state->enable_hardware_counters()) {
+        _hardware_counters.reset(
+                new HardwareCounters(_runtime_profile.get(), state->hardware_counters()));
+    }
     _mem_tracker = MemTracker::create_tracker(-1, "ExecNode:" + _runtime_profile->name(),
                                               state->instance_mem_tracker(),
                                               MemTrackerLevel::VERBOSE, _runtime_profile.get());
@@ -377,6 +384,7 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
         case TPlanNodeType::OLAP_SCAN_NODE:
         case TPlanNodeType::ASSERT_NUM_ROWS_NODE:
         case TPlanNodeType::HASH_JOIN_NODE:
+        case TPlanNodeType::MERGE_JOIN_NODE:
         case TPlanNodeType::AGGREGATION_NODE:
         case TPlanNodeType::UNION_NODE:
         case TPlanNodeType::CROSS_JOIN_NODE:
@@ -481,7 +489,11 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
         return Status::OK();
 
     case TPlanNodeType::MERGE_JOIN_NODE:
-        *node = pool->add(new MergeJoinNode(pool, tnode, descs));
+        if (state->enable_vectorized_exec()) {
+            *node = pool->add(new vectorized::VMergeJoinNode(pool, tnode, descs));
+        } else {
+            *node = pool->add(new MergeJoinNode(pool, tnode, descs));
+        }
         return Status::OK();
 
     case TPlanNodeType::EMPTY_SET_NODE:
@@ -510,7 +522,11 @@ Status ExecNode::create_node(RuntimeState* state, ObjectPool* pool, const TPlanN
 
     case TPlanNodeType::SORT_NODE:
         if (state->enable_vectorized_exec()) {
-            *node = pool->add(new vectorized::VSortNode(pool, tnode, descs));
+            if (tnode.sort_node.use_top_n && tnode.limit >= 0 && config::enable_vec_topn_node) {
+                *node = pool->add(new vectorized::VTopNNode(pool, tnode, descs));
+            } else {
+                *node = pool->add(new vectorized::VSortNode(pool, tnode, descs));
+            }
         } else {
             if (tnode.sort_node.use_top_n) {
                 *node = pool->add(new TopNNode(pool, tnode, descs));
@@ -755,12 +771,15 @@ void ExecNode::release_block_memory(vectorized::Block& block, uint16_t child_idx
 }
 
 void ExecNode::reached_limit(vectorized::Block* block, bool* eos) {
+    if (_limit != -1) {
+        block->materialize_selection();
+    }
     if (_limit != -1 and _num_rows_returned + block->rows() >= _limit) {
         block->set_num_rows(_limit - _num_rows_returned);
         *eos = true;
     }
 
-    _num_rows_returned += block->rows();
+    _num_rows_returned += block->selected_rows();
     COUNTER_SET(_rows_returned_counter, _num_rows_returned);
 }
 
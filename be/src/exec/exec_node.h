@@ -190,9 +190,21 @@ public:
     int64_t rows_returned() const { return _num_rows_returned; }
     int64_t limit() const { return _limit; }
     bool reached_limit() const { return _limit != -1 && _num_rows_returned >= _limit; }
+
+    // Set by a parent which skips the rows not selected by Block::selection(), then the blocks
+    // returned by get_next() may carry a deferred selection instead of copying the rows.
+    void set_accept_block_selection(bool accept) { _accept_block_selection = accept; }
+
+    // The slots the blocks returned by get_next() are ordered by, in the order of priority.
+    // Empty if the rows are in no order. Valid after prepare().
+    virtual std::vector<SlotId> ordered_by_slots() const { return {}; }
+    // Whether each slot of ordered_by_slots() is in ascending order, and has the NULLs first.
+    virtual std::vector<bool> ordered_by_asc_order() const { return {}; }
+    virtual std::vector<bool> ordered_by_nulls_first() const { return {}; }
     const std::vector<TupleId>& get_tuple_ids() const { return _tuple_ids; }
 
     RuntimeProfile* runtime_profile() const { return _runtime_profile.get(); }
+    HardwareCounters* hardware_counters() const { return _hardware_counters.get(); }
     RuntimeProfile::Counter* memory_used_counter() const { return _memory_used_counter; }
 
     std::shared_ptr<MemTracker> mem_tracker() const { return _mem_tracker; }
@@ -302,6 +314,8 @@ protected:
 
     int64_t _limit; // -1: no limit
     int64_t _num_rows_returned;
+    // see set_accept_block_selection()
+    bool _accept_block_selection = false;
 
     std::unique_ptr<RuntimeProfile> _runtime_profile;
 
@@ -314,6 +328,9 @@ protected:
     RuntimeProfile::Counter* _rows_returned_rate;
     // Account for peak memory used by this node
     RuntimeProfile::Counter* _memory_used_counter;
+    // the hardware events of this node excluding its children, only with the query option
+    // enable_hardware_counters
+    std::unique_ptr<HardwareCounters> _hardware_counters;
 
     // Execution options that are determined at runtime.  This is added to the
     // runtime profile at close().  Examples for options logged here would be
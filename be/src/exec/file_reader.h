@@ -48,6 +48,8 @@ public:
     virtual Status tell(int64_t* position) = 0;
     virtual void close() = 0;
     virtual bool closed() = 0;
+    // whether readat() can be called by multiple threads at the same time
+    virtual bool support_concurrent_reads() const { return false; }
 };
 
 } // namespace doris
@@ -68,13 +68,12 @@ public:
     // Close this scanner
     void close() override;
 
-private:
+protected:
     Status open_file_reader();
     Status open_line_reader();
-    Status open_json_reader();
+    virtual Status open_json_reader();
     Status open_next_reader();
 
-private:
     const std::vector<TBrokerRangeDesc>& _ranges;
     const std::vector<TNetworkAddress>& _broker_addresses;
 
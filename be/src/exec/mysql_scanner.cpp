@@ -181,6 +181,23 @@ Status MysqlScanner::get_next_row(char*** buf, unsigned long** lengths, bool* eo
     return Status::OK();
 }
 
+Status MysqlScanner::get_next_rows(size_t max_rows, std::vector<char**>* rows,
+                                   std::vector<unsigned long>* lengths, bool* eos) {
+    *eos = false;
+    for (size_t i = 0; i < max_rows; ++i) {
+        char** row = nullptr;
+        unsigned long* row_lengths = nullptr;
+        RETURN_IF_ERROR(get_next_row(&row, &row_lengths, eos));
+        if (*eos) {
+            break;
+        }
+        rows->push_back(row);
+        // the lengths are overwritten by the next fetch
+        lengths->insert(lengths->end(), row_lengths, row_lengths + _field_num);
+    }
+    return Status::OK();
+}
+
 Status MysqlScanner::_error_status(const std::string& prefix) {
     std::stringstream msg;
     msg << prefix << " Err: " << mysql_error(_my_conn);
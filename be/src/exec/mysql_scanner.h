@@ -58,6 +58,11 @@ public:
     Status query(const std::string& table, const std::vector<std::string>& fields,
                  const std::vector<std::string>& filters, const uint64_t limit);
     Status get_next_row(char*** buf, unsigned long** lengths, bool* eos);
+    // Fetch at most max_rows rows, which are appended to `rows`, and the lengths of their fields
+    // are appended to `lengths` one row after another. The rows are stored by the result, so they
+    // are valid until the next query.
+    Status get_next_rows(size_t max_rows, std::vector<char**>* rows,
+                         std::vector<unsigned long>* lengths, bool* eos);
 
     int field_num() const { return _field_num; }
 
@@ -19,6 +19,7 @@
 
 #include <sqlext.h>
 
+#include <algorithm>
 #include <codecvt>
 
 #include "common/config.h"
@@ -56,6 +57,7 @@ ODBCConnector::ODBCConnector(const ODBCConnectorParam& param)
         : _connect_string(param.connect_string),
           _sql_str(param.query_string),
           _tuple_desc(param.tuple_desc),
+          _fetch_rows(std::max(1, param.max_fetch_rows)),
           _output_expr_ctxs(param.output_expr_ctxs),
           _is_open(false),
           _field_num(0),
@@ -146,6 +148,7 @@ Status ODBCConnector::query() {
     }
 
     // allocate memory for the binding
+    size_t row_bytes = 0;
     for (int i = 0; i < _field_num; i++) {
         DataBinding* column_data = new DataBinding;
         column_data->target_type = SQL_C_CHAR;
@@ -154,16 +157,36 @@ Status ODBCConnector::query() {
                                       type == TYPE_VARCHAR || type == TYPE_STRING)
                                              ? BIG_COLUMN_SIZE_BUFFER
                                              : SMALL_COLUMN_SIZE_BUFFER;
-        column_data->target_value_ptr = malloc(sizeof(char) * column_data->buffer_length);
+        row_bytes += column_data->buffer_length;
         _columns_data.emplace_back(column_data);
     }
+    _fetch_rows = _rows_per_fetch(_fetch_rows, row_bytes);
+    for (auto& column_data : _columns_data) {
+        column_data->target_value_ptr = malloc(sizeof(char) * column_data->buffer_length *
+                                               _fetch_rows);
+        column_data->strlen_or_ind =
+                static_cast<SQLLEN*>(malloc(sizeof(SQLLEN) * _fetch_rows));
+    }
+    if (_fetch_rows > 1) {
+        // bind the columns by the arrays of the values, each fetch returns a rowset of at most
+        // _fetch_rows rows
+        ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
+                     SQLSetStmtAttr(_stmt, SQL_ATTR_ROW_BIND_TYPE, SQL_BIND_BY_COLUMN, 0),
+                     "set row bind type");
+        ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
+                     SQLSetStmtAttr(_stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER)_fetch_rows, 0),
+                     "set row array size");
+        ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
+                     SQLSetStmtAttr(_stmt, SQL_ATTR_ROWS_FETCHED_PTR, &_num_fetched_rows, 0),
+                     "set rows fetched ptr");
+    }
 
     // setup the binding
     for (int i = 0; i < _field_num; i++) {
         ODBC_DISPOSE(_stmt, SQL_HANDLE_STMT,
                      SQLBindCol(_stmt, (SQLUSMALLINT)i + 1, _columns_data[i]->target_type,
                                 _columns_data[i]->target_value_ptr, _columns_data[i]->buffer_length,
-                                &(_columns_data[i]->strlen_or_ind)),
+                                _columns_data[i]->strlen_or_ind),
                      "bind col");
     }
 
@@ -186,6 +209,34 @@ Status ODBCConnector::get_next_row(bool* eos) {
     return Status::OK();
 }
 
+Status ODBCConnector::get_next_batch(size_t* num_rows, bool* eos) {
+    if (!_is_open) {
+        return Status::InternalError("GetNextBatch before open.");
+    }
+
+    *num_rows = 0;
+    auto ret = SQLFetchScroll(_stmt, SQL_FETCH_NEXT, 0);
+    if (ret == SQL_SUCCESS || ret == SQL_SUCCESS_WITH_INFO) {
+        // the rows fetched ptr is only set for the rowset of more than one row
+        *num_rows = _fetch_rows > 1 ? _num_fetched_rows : 1;
+        return Status::OK();
+    } else if (ret != SQL_NO_DATA_FOUND) {
+        return error_status("result fetch", handle_diagnostic_record(_stmt, SQL_HANDLE_STMT, ret));
+    }
+
+    *eos = true;
+    return Status::OK();
+}
+
+size_t ODBCConnector::_rows_per_fetch(size_t max_fetch_rows, size_t row_bytes) {
+    // the buffers of the rows fetched at once are limited by odbc_scan_fetch_buffer_bytes
+    if (max_fetch_rows <= 1 || row_bytes == 0) {
+        return max_fetch_rows;
+    }
+    return std::clamp<size_t>(config::odbc_scan_fetch_buffer_bytes / row_bytes, 1,
+                              max_fetch_rows);
+}
+
 void ODBCConnector::_init_profile(doris::RuntimeProfile* profile) {
     _convert_tuple_timer = ADD_TIMER(profile, "TupleConvertTime");
     _result_send_timer = ADD_TIMER(profile, "ResultSendTime");
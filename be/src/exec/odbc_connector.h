@@ -40,22 +40,37 @@ struct ODBCConnectorParam {
     // only use in query
     std::string query_string;
     const TupleDescriptor* tuple_desc;
+    // the max number of the rows fetched by one get_next_batch, 1 means the rows are fetched
+    // one by one by get_next_row
+    int max_fetch_rows = 1;
 
     // only use in write
     std::vector<ExprContext*> output_expr_ctxs;
 };
 
 // Because the DataBinding have the mem alloc, so
-// this class should not be copyable
+// this class should not be copyable.
+// The column is bound to an array of the values of the rows fetched at once.
 struct DataBinding {
     SQLSMALLINT target_type;
+    // the buffer length of one value
     SQLINTEGER buffer_length;
-    SQLLEN strlen_or_ind;
-    SQLPOINTER target_value_ptr;
+    // the lengths or the indicators (e.g. SQL_NULL_DATA) of the fetched rows
+    SQLLEN* strlen_or_ind = nullptr;
+    // the values of the fetched rows, each of them takes buffer_length bytes
+    SQLPOINTER target_value_ptr = nullptr;
 
     DataBinding() = default;
 
-    ~DataBinding() { free(target_value_ptr); }
+    ~DataBinding() {
+        free(target_value_ptr);
+        free(strlen_or_ind);
+    }
+
+    char* value(size_t row) const {
+        return static_cast<char*>(target_value_ptr) + row * buffer_length;
+    }
+    SQLLEN length(size_t row) const { return strlen_or_ind[row]; }
     DataBinding(const DataBinding&) = delete;
     DataBinding& operator=(const DataBinding&) = delete;
 };
@@ -70,6 +85,8 @@ public:
     // query for ODBC table
     Status query();
     Status get_next_row(bool* eos);
+    // fetch the next rows at once, at most `max_fetch_rows` of the param
+    Status get_next_batch(size_t* num_rows, bool* eos);
 
     // write for ODBC table
     Status init_to_write(RuntimeProfile* profile);
@@ -91,6 +108,10 @@ private:
     static std::string handle_diagnostic_record(SQLHANDLE hHandle, SQLSMALLINT hType,
                                                 RETCODE RetCode);
 
+    // the rows fetched at once, at most max_fetch_rows rows of row_bytes bytes within
+    // odbc_scan_fetch_buffer_bytes
+    static size_t _rows_per_fetch(size_t max_fetch_rows, size_t row_bytes);
+
     std::string _connect_string;
     // only use in query
     std::string _sql_str;
@@ -109,9 +130,12 @@ private:
     RuntimeProfile::Counter* _sent_rows_counter = nullptr;
 
     bool _is_open;
-    bool _is_in_transaction;
+    bool _is_in_transaction = false;
 
     SQLSMALLINT _field_num;
+    // the number of the rows fetched at once, and the rows of the last fetch
+    size_t _fetch_rows = 1;
+    SQLULEN _num_fetched_rows = 0;
 
     SQLHENV _env;
     SQLHDBC _dbc;
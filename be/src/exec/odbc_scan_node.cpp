@@ -68,6 +68,7 @@ Status OdbcScanNode::prepare(RuntimeState* state) {
     _odbc_param.connect_string = std::move(_connect_string);
     _odbc_param.query_string = std::move(_query_string);
     _odbc_param.tuple_desc = _tuple_desc;
+    _odbc_param.max_fetch_rows = _fetch_batch ? state->batch_size() : 1;
 
     _odbc_scanner.reset(new (std::nothrow) ODBCConnector(_odbc_param));
 
@@ -195,7 +196,7 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
             }
 
             const auto& column_data = _odbc_scanner->get_column_data(j);
-            if (column_data.strlen_or_ind == SQL_NULL_DATA) {
+            if (column_data.length(0) == SQL_NULL_DATA) {
                 if (slot_desc->is_nullable()) {
                     _tuple->set_null(slot_desc->null_indicator_offset());
                 } else {
@@ -204,14 +205,14 @@ Status OdbcScanNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
                        << ", column=" << slot_desc->col_name();
                     return Status::InternalError(ss.str());
                 }
-            } else if (column_data.strlen_or_ind > column_data.buffer_length) {
+            } else if (column_data.length(0) > column_data.buffer_length) {
                 std::stringstream ss;
                 ss << "nonnull column contains nullptr. table=" << _table_name
                    << ", column=" << slot_desc->col_name();
                 return Status::InternalError(ss.str());
             } else {
-                RETURN_IF_ERROR(write_text_slot(static_cast<char*>(column_data.target_value_ptr),
-                                                column_data.strlen_or_ind, slot_desc, state));
+                RETURN_IF_ERROR(write_text_slot(column_data.value(0), column_data.length(0),
+                                                slot_desc, state));
             }
             j++;
         }
@@ -65,6 +65,9 @@ protected:
     // Write debug string of this into out.
     virtual void debug_string(int indentation_level, std::stringstream* out) const;
 
+    // whether the rows are fetched in batches by ODBCConnector::get_next_batch
+    bool _fetch_batch = false;
+
 private:
     // Writes a slot in _tuple from an MySQL value containing text data.
     // The Odbc value is converted into the appropriate target type.
@@ -79,6 +79,10 @@ Status OlapScanNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
     _max_scanner_queue_size_bytes = query_options.mem_limit / 20; //TODO: session variable percent
 
+    if (_olap_scan_node.__isset.push_down_agg_type_opt) {
+        _push_down_agg_type_opt = _olap_scan_node.push_down_agg_type_opt;
+    }
+
     /// TODO: could one filter used in the different scan_node ?
     int filter_size = _runtime_filter_descs.size();
     _runtime_filter_ctxs.resize(filter_size);
@@ -124,6 +128,10 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
     _block_seek_counter = ADD_COUNTER(_segment_profile, "BlockSeekCount", TUnit::UNIT);
 
     _rows_vec_cond_counter = ADD_COUNTER(_segment_profile, "RowsVectorPredFiltered", TUnit::UNIT);
+    _runtime_filters_dropped_counter =
+            ADD_COUNTER(_segment_profile, "RuntimeFiltersDropped", TUnit::UNIT);
+    _runtime_filters_in_flight_counter =
+            ADD_COUNTER(_segment_profile, "RuntimeFiltersAppliedInFlight", TUnit::UNIT);
     _vec_cond_timer = ADD_TIMER(_segment_profile, "VectorPredEvalTime");
     _short_cond_timer = ADD_TIMER(_segment_profile, "ShortPredEvalTime");
     _first_read_timer = ADD_TIMER(_segment_profile, "FirstReadTime");
@@ -147,10 +155,16 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
 
     _total_pages_num_counter = ADD_COUNTER(_segment_profile, "TotalPagesNum", TUnit::UNIT);
     _cached_pages_num_counter = ADD_COUNTER(_segment_profile, "CachedPagesNum", TUnit::UNIT);
+    _prefetched_pages_num_counter =
+            ADD_COUNTER(_segment_profile, "PrefetchedPagesNum", TUnit::UNIT);
+    _page_prefetch_wait_timer = ADD_TIMER(_segment_profile, "PagePrefetchWaitTime");
 
     _bitmap_index_filter_counter =
             ADD_COUNTER(_segment_profile, "RowsBitmapIndexFiltered", TUnit::UNIT);
     _bitmap_index_filter_timer = ADD_TIMER(_segment_profile, "BitmapIndexFilterTimer");
+    _inverted_index_filter_counter =
+            ADD_COUNTER(_segment_profile, "RowsInvertedIndexFiltered", TUnit::UNIT);
+    _inverted_index_filter_timer = ADD_TIMER(_segment_profile, "InvertedIndexFilterTimer");
 
     _num_scanners = ADD_COUNTER(_runtime_profile, "NumScanners", TUnit::UNIT);
 
@@ -161,6 +175,9 @@ void OlapScanNode::_init_counter(RuntimeState* state) {
     _scanner_wait_batch_timer = ADD_TIMER(_runtime_profile, "ScannerBatchWaitTime");
     // time of scan thread to wait for worker thread of the thread pool
     _scanner_wait_worker_timer = ADD_TIMER(_runtime_profile, "ScannerWorkerWaitTime");
+    // the same time summed up by all the scan nodes of the fragment instance
+    _instance_scanner_wait_worker_timer =
+            ADD_TIMER(state->runtime_profile(), "ScannerWorkerWaitTime");
 
     // time of node to wait for batch/block queue
     _olap_wait_batch_queue_timer = ADD_TIMER(_runtime_profile, "BatchQueueWaitTime");
@@ -187,6 +204,10 @@ Status OlapScanNode::prepare(RuntimeState* state) {
 
     _scanner_mem_tracker = MemTracker::create_tracker(state->instance_mem_tracker()->limit(),
                                                       "Scanners", mem_tracker());
+    if (config::column_page_prefetch_depth > 0) {
+        _page_prefetch_budget = std::make_unique<segment_v2::PagePrefetchBudget>(
+                config::column_page_prefetch_max_pages_per_scan);
+    }
 
     if (_tuple_desc == nullptr) {
         // TODO: make sure we print all available diagnostic output to our error log
@@ -229,8 +250,11 @@ Status OlapScanNode::open(RuntimeState* state) {
 
     _resource_info = ResourceTls::get_resource_tls();
 
-    // acquire runtime filter
+    // acquire runtime filter, the filters not ready are not waited for when they are pushed down
+    // to the storage after arriving
     _runtime_filter_ctxs.resize(_runtime_filter_descs.size());
+    const bool wait_runtime_filters = !config::enable_late_runtime_filter_pushdown ||
+                                      !config::late_runtime_filter_skip_wait;
 
     for (size_t i = 0; i < _runtime_filter_descs.size(); ++i) {
         auto& filter_desc = _runtime_filter_descs[i];
@@ -241,7 +265,7 @@ Status OlapScanNode::open(RuntimeState* state) {
             continue;
         }
         bool ready = runtime_filter->is_ready();
-        if (!ready) {
+        if (!ready && wait_runtime_filters) {
             ready = runtime_filter->await();
         }
         if (ready) {
@@ -261,6 +285,16 @@ Status OlapScanNode::open(RuntimeState* state) {
         }
     }
 
+    // the filters not ready now are pushed down to the storage when they are ready
+    _late_runtime_filters.resize(_runtime_filter_descs.size());
+    if (config::enable_late_runtime_filter_pushdown) {
+        for (size_t i = 0; i < _runtime_filter_descs.size(); ++i) {
+            if (!_runtime_filter_ctxs[i].apply_mark) {
+                _late_runtime_filters[i] = std::make_shared<LateRuntimeFilter>();
+            }
+        }
+    }
+
     return Status::OK();
 }
 
@@ -455,6 +489,38 @@ Status OlapScanNode::set_scan_ranges(const std::vector<TScanRangeParams>& scan_r
     return Status::OK();
 }
 
+bool OlapScanNode::set_topn_predicate(SlotId slot_id,
+                                      std::shared_ptr<TopNRuntimePredicate> predicate) {
+    if (_tuple_desc == nullptr) {
+        return false;
+    }
+    for (auto slot : _tuple_desc->slots()) {
+        if (slot->id() != slot_id) {
+            continue;
+        }
+        // the types of which the boundary converts to a storage predicate exactly
+        switch (slot->type().type) {
+        case TYPE_BOOLEAN:
+        case TYPE_TINYINT:
+        case TYPE_SMALLINT:
+        case TYPE_INT:
+        case TYPE_BIGINT:
+        case TYPE_LARGEINT:
+        case TYPE_DATE:
+        case TYPE_DATETIME:
+        case TYPE_DECIMALV2:
+        case TYPE_VARCHAR:
+        case TYPE_STRING:
+            _topn_column = slot->col_name();
+            _topn_predicate = std::move(predicate);
+            return true;
+        default:
+            return false;
+        }
+    }
+    return false;
+}
+
 Status OlapScanNode::start_scan(RuntimeState* state) {
     RETURN_IF_CANCELLED(state);
 
@@ -498,6 +564,13 @@ bool OlapScanNode::is_key_column(const std::string& key_name) {
     if (_olap_scan_node.keyType == TKeysType::DUP_KEYS) {
         return true;
     }
+    // the value columns of merge-on-write unique key table are not replaced at read time,
+    // so all columns are treated as key columns too
+    if (_olap_scan_node.keyType == TKeysType::UNIQUE_KEYS &&
+        _olap_scan_node.__isset.enable_unique_key_merge_on_write &&
+        _olap_scan_node.enable_unique_key_merge_on_write) {
+        return true;
+    }
 
     auto res = std::find(_olap_scan_node.key_column_name.begin(),
                          _olap_scan_node.key_column_name.end(), key_name);
@@ -611,8 +684,15 @@ Status OlapScanNode::normalize_conjuncts() {
 
         case TYPE_CHAR:
         case TYPE_VARCHAR:
-        case TYPE_HLL:
         case TYPE_STRING: {
+            ColumnValueRange<StringValue> range(slots[slot_idx]->col_name(),
+                                                slots[slot_idx]->type().type);
+            normalize_predicate(range, slots[slot_idx]);
+            normalize_like_predicate(slots[slot_idx]);
+            break;
+        }
+
+        case TYPE_HLL: {
             ColumnValueRange<StringValue> range(slots[slot_idx]->col_name(),
                                                 slots[slot_idx]->type().type);
             normalize_predicate(range, slots[slot_idx]);
@@ -859,6 +939,7 @@ Status OlapScanNode::normalize_predicate(ColumnValueRange<T>& range, SlotDescrip
 
     // 3. Normalize BloomFilterPredicate, push down by hash join node
     RETURN_IF_ERROR(normalize_bloom_filter_predicate(slot));
+    RETURN_IF_ERROR(normalize_bitmap_filter_predicate(slot));
 
     // 4. Check whether range is empty, set _eos
     if (range.is_empty_value_range()) _eos = true;
@@ -1356,6 +1437,192 @@ Status OlapScanNode::normalize_bloom_filter_predicate(SlotDescriptor* slot) {
     return Status::OK();
 }
 
+Status OlapScanNode::normalize_bitmap_filter_predicate(SlotDescriptor* slot) {
+    // only the bitmap filters of the key columns are pushed down, as the bloom filters
+    if (!is_key_column(slot->col_name())) {
+        return Status::OK();
+    }
+    for (int conj_idx = _direct_conjunct_size; conj_idx < _conjunct_ctxs.size(); ++conj_idx) {
+        Expr* pred = _conjunct_ctxs[conj_idx]->root();
+        if (TExprNodeType::BITMAP_PRED != pred->node_type()) continue;
+        DCHECK(pred->get_num_children() == 1);
+
+        Expr* child = pred->get_child(0);
+        if (Expr::type_without_cast(child) != TExprNodeType::SLOT_REF) {
+            continue;
+        }
+        if (child->type().type != slot->type().type && !ignore_cast(slot, child)) {
+            continue;
+        }
+        std::vector<SlotId> slot_ids;
+        if (1 != child->get_slot_ids(&slot_ids) || slot_ids[0] != slot->id()) {
+            continue;
+        }
+        _pushed_conjuncts_index.insert(conj_idx);
+        _bitmap_filters_push_down.emplace_back(
+                slot->col_name(),
+                static_cast<BitmapFilterPredicate*>(pred)->get_bitmap_filter_func());
+    }
+    return Status::OK();
+}
+
+SlotDescriptor* OlapScanNode::late_runtime_filter_slot(Expr* pred, int child_idx) {
+    Expr* child = pred->get_child(child_idx);
+    if (Expr::type_without_cast(child) != TExprNodeType::SLOT_REF) {
+        return nullptr;
+    }
+    std::vector<SlotId> slot_ids;
+    if (child->get_slot_ids(&slot_ids) != 1) {
+        return nullptr;
+    }
+    for (auto slot : _tuple_desc->slots()) {
+        if (slot->id() == slot_ids[0]) {
+            if (child->type().type != slot->type().type && !ignore_cast(slot, child)) {
+                return nullptr;
+            }
+            return slot;
+        }
+    }
+    return nullptr;
+}
+
+template <class T>
+Status OlapScanNode::normalize_late_runtime_filter(ExprContext* ctx, SlotDescriptor* slot,
+                                                   ColumnValueRange<T>* range) {
+    Expr* pred = ctx->root();
+    if (TExprOpcode::FILTER_IN == pred->op()) {
+        InPredicate* in_pred = static_cast<InPredicate*>(pred);
+        if (!should_push_down_in_predicate(slot, in_pred)) {
+            return Status::OK();
+        }
+        auto temp_range = ColumnValueRange<T>::create_empty_column_value_range(range->type());
+        HybridSetBase::IteratorBase* iter = in_pred->hybrid_set()->begin();
+        for (; iter->has_next(); iter->next()) {
+            if (iter->get_value() == nullptr) {
+                continue;
+            }
+            auto value = const_cast<void*>(iter->get_value());
+            RETURN_IF_ERROR(change_fixed_value_range(temp_range, slot->type().type, value,
+                                                     ColumnValueRange<T>::add_fixed_value_range));
+        }
+        range->intersection(temp_range);
+        return Status::OK();
+    }
+
+    // the min/max filter is `col >= min` and `col <= max`
+    if (TExprNodeType::BINARY_PRED != pred->node_type() ||
+        FILTER_IN == to_olap_filter_type(pred->op(), false) ||
+        FILTER_NOT_IN == to_olap_filter_type(pred->op(), false)) {
+        return Status::OK();
+    }
+    for (int child_idx = 0; child_idx < 2; ++child_idx) {
+        Expr* expr = pred->get_child(1 - child_idx);
+        if (late_runtime_filter_slot(pred, child_idx) != slot || !expr->is_constant()) {
+            continue;
+        }
+        void* value = ctx->get_value(expr, nullptr);
+        if (value == nullptr) {
+            continue;
+        }
+        SQLFilterOp op = to_olap_filter_type(pred->op(), child_idx);
+        RETURN_IF_ERROR(change_fixed_value_range(
+                *range, slot->type().type, value,
+                [op](ColumnValueRange<T>& column_range, T* column_value) {
+                    column_range.add_range(op, *column_value);
+                }));
+    }
+    return Status::OK();
+}
+
+void OlapScanNode::publish_late_runtime_filter(size_t filter_idx,
+                                               const std::vector<ExprContext*>& ctxs) {
+    auto& late_filter = _late_runtime_filters[filter_idx];
+    if (late_filter == nullptr || late_filter->is_published()) {
+        return;
+    }
+
+    std::vector<TCondition> conditions;
+    std::vector<LateRuntimeFilter::BloomFilter> bloom_filters;
+    for (auto ctx : ctxs) {
+        Expr* pred = ctx->root();
+        if (pred->get_num_children() == 0) {
+            continue;
+        }
+        // the late bitmap filters are only evaluated by the scanner
+        if (TExprNodeType::BITMAP_PRED == pred->node_type()) {
+            continue;
+        }
+        if (TExprNodeType::BLOOM_PRED == pred->node_type()) {
+            SlotDescriptor* slot = late_runtime_filter_slot(pred, 0);
+            if (slot != nullptr && is_key_column(slot->col_name())) {
+                bloom_filters.emplace_back(
+                        slot->col_name(),
+                        static_cast<BloomFilterPredicate*>(pred)->get_bloom_filter_func());
+            }
+            continue;
+        }
+        SlotDescriptor* slot = late_runtime_filter_slot(pred, 0);
+        if (slot == nullptr && pred->get_num_children() == 2) {
+            slot = late_runtime_filter_slot(pred, 1);
+        }
+        // only the rows of the key columns can be filtered before being merged
+        if (slot == nullptr || !is_key_column(slot->col_name())) {
+            continue;
+        }
+        auto iter = _column_value_ranges.find(slot->col_name());
+        if (iter == _column_value_ranges.end()) {
+            continue;
+        }
+        std::visit(
+                [&](auto&& origin_range) {
+                    using RangeType = std::decay_t<decltype(origin_range)>;
+                    RangeType range(origin_range.column_name(), origin_range.type());
+                    Status st = normalize_late_runtime_filter(ctx, slot, &range);
+                    if (st.ok()) {
+                        range.to_olap_filter(conditions);
+                    } else {
+                        LOG(WARNING) << "failed to push down the late runtime filter on column "
+                                     << slot->col_name() << ": " << st;
+                    }
+                },
+                iter->second);
+    }
+    VLOG_CRITICAL << "push down late runtime filter "
+                  << _runtime_filter_descs[filter_idx].filter_id
+                  << ", conditions: " << conditions.size()
+                  << ", bloom filters: " << bloom_filters.size();
+    late_filter->publish(std::move(conditions), std::move(bloom_filters));
+}
+
+void OlapScanNode::normalize_like_predicate(SlotDescriptor* slot) {
+    for (int conj_idx = 0; conj_idx < _conjunct_ctxs.size(); ++conj_idx) {
+        Expr* root_expr = _conjunct_ctxs[conj_idx]->root();
+        if (TExprNodeType::FUNCTION_CALL != root_expr->node_type() ||
+            root_expr->fn().name.function_name != "like" || root_expr->get_num_children() != 2) {
+            continue;
+        }
+        Expr* slot_expr = root_expr->get_child(0);
+        Expr* pattern_expr = root_expr->get_child(1);
+        if (Expr::type_without_cast(slot_expr) != TExprNodeType::SLOT_REF ||
+            pattern_expr->node_type() != TExprNodeType::STRING_LITERAL) {
+            continue;
+        }
+
+        std::vector<SlotId> slot_ids;
+        if (1 != slot_expr->get_slot_ids(&slot_ids) || slot_ids[0] != slot->id()) {
+            continue;
+        }
+        void* value = _conjunct_ctxs[conj_idx]->get_value(pattern_expr, nullptr);
+        if (value == nullptr) {
+            continue;
+        }
+        // The conjunct is not pushed down, the pattern is only used by the
+        // ngram bloom filter index to skip pages.
+        _like_predicates_push_down.emplace_back(slot->col_name(),
+                                                reinterpret_cast<StringValue*>(value)->to_string());
+    }
+}
+
 void OlapScanNode::transfer_thread(RuntimeState* state) {
     // scanner open pushdown to scanThread
     SCOPED_ATTACH_TASK_THREAD(state, mem_tracker());
@@ -1569,7 +1836,10 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
             DCHECK(runtime_filter != nullptr);
             bool ready = runtime_filter->is_ready();
             if (ready) {
+                size_t begin = contexts.size();
                 runtime_filter->get_prepared_context(&contexts, row_desc(), _expr_mem_tracker);
+                publish_late_runtime_filter(
+                        i, std::vector<ExprContext*>(contexts.begin() + begin, contexts.end()));
                 _runtime_filter_ctxs[i].apply_mark = true;
             }
         }
@@ -1676,6 +1946,7 @@ void OlapScanNode::scanner_thread(OlapScanner* scanner) {
 
     _scan_cpu_timer->update(cpu_watch.elapsed_time());
     _scanner_wait_worker_timer->update(wait_time);
+    _instance_scanner_wait_worker_timer->update(wait_time);
 
     // The transfer thead will wait for `_running_thread==0`, to make sure all scanner threads won't access class members.
     // Do not access class members after this code.
@@ -24,8 +24,12 @@
 #include "exec/olap_common.h"
 #include "exec/olap_scanner.h"
 #include "exec/scan_node.h"
+#include "exprs/bitmapfilter_predicate.h"
 #include "exprs/bloomfilter_predicate.h"
 #include "exprs/in_predicate.h"
+#include "olap/late_runtime_filter.h"
+#include "olap/rowset/segment_v2/page_prefetcher.h"
+#include "olap/topn_predicate.h"
 #include "runtime/descriptors.h"
 #include "runtime/row_batch_interface.hpp"
 #include "runtime/vectorized_row_batch.h"
@@ -58,6 +62,9 @@ public:
     Status close(RuntimeState* state) override;
     Status set_scan_ranges(const std::vector<TScanRangeParams>& scan_ranges) override;
     void set_no_agg_finalize() { _need_agg_finalize = false; }
+    // Filter the rows in the storage by the boundary of the Top-N sort above on the slot
+    // `slot_id`. Return false if the slot can't be filtered by it. Must be called before open().
+    bool set_topn_predicate(SlotId slot_id, std::shared_ptr<TopNRuntimePredicate> predicate);
 
 protected:
     struct HeapType {
@@ -123,6 +130,24 @@ protected:
 
     Status normalize_bloom_filter_predicate(SlotDescriptor* slot);
 
+    Status normalize_bitmap_filter_predicate(SlotDescriptor* slot);
+
+    // collect `col LIKE 'pattern'` for ngram bloom filter index
+    void normalize_like_predicate(SlotDescriptor* slot);
+
+    // Push the runtime filter `filter_idx` which became ready after the scan started down to
+    // the segments not read yet, `ctxs` are the exprs of the filter.
+    void publish_late_runtime_filter(size_t filter_idx, const std::vector<ExprContext*>& ctxs);
+
+    // add the conditions of the min/max or IN runtime filter expr `ctx` on `slot` to `range`
+    template <class T>
+    Status normalize_late_runtime_filter(ExprContext* ctx, SlotDescriptor* slot,
+                                         ColumnValueRange<T>* range);
+
+    // the slot of the scan tuple which is the child `child_idx` of the runtime filter expr
+    // `pred`, nullptr if it isn't a slot of the scan tuple
+    SlotDescriptor* late_runtime_filter_slot(Expr* pred, int child_idx);
+
     template <typename T>
     static bool normalize_is_null_predicate(Expr* expr, SlotDescriptor* slot,
                                             const std::string& is_null_str,
@@ -188,6 +213,12 @@ protected:
     // 2. std::pair.second :: shared_ptr of BloomFilterFuncBase
     std::vector<std::pair<std::string, std::shared_ptr<IBloomFilterFuncBase>>>
             _bloom_filters_push_down;
+    // (column name, bitmap filter) of the bitmap runtime filters pushed down to storage engine
+    std::vector<std::pair<std::string, std::shared_ptr<BitmapFilterFunc>>>
+            _bitmap_filters_push_down;
+    // (column name, pattern) of LIKE predicates, only used by storage engine to filter
+    // pages with ngram bloom filter index, the conjuncts are still evaluated by scanner.
+    std::vector<std::pair<std::string, std::string>> _like_predicates_push_down;
 
     // Pool for storing allocated scanner objects.  We don't want to use the
     // runtime pool to ensure that the scanner objects are deleted before this
@@ -252,8 +283,18 @@ protected:
     int64_t _buffered_bytes;
     // Count the memory consumption of Rowset Reader and Tablet Reader in OlapScanner.
     std::shared_ptr<MemTracker> _scanner_mem_tracker;
+
+    // bounds the data pages read ahead by all the scanners of this node
+    std::unique_ptr<segment_v2::PagePrefetchBudget> _page_prefetch_budget;
     EvalConjunctsFn _eval_conjuncts_fn;
 
+    // the aggregate without grouping answered from the segment metadata, vec only
+    TPushAggOp::type _push_down_agg_type_opt = TPushAggOp::NONE;
+
+    // the boundary of the Top-N sort above on the column `_topn_column`
+    std::string _topn_column;
+    std::shared_ptr<TopNRuntimePredicate> _topn_predicate;
+
     bool _need_agg_finalize = true;
 
     // the max num of scan keys of this scan request.
@@ -276,6 +317,9 @@ protected:
     std::vector<TRuntimeFilterDesc> _runtime_filter_descs;
     std::vector<RuntimeFilterContext> _runtime_filter_ctxs;
     std::map<int, RuntimeFilterContext*> _conjunctid_to_runtime_filter_ctxs;
+    // the storage filters of the runtime filters not ready when the scan node was opened, indexed
+    // like `_runtime_filter_descs`, nullptr for the ones applied when opened
+    std::vector<std::shared_ptr<LateRuntimeFilter>> _late_runtime_filters;
 
     std::unique_ptr<RuntimeProfile> _scanner_profile;
     std::unique_ptr<RuntimeProfile> _segment_profile;
@@ -288,6 +332,9 @@ protected:
     RuntimeProfile::Counter* _raw_rows_counter = nullptr;
 
     RuntimeProfile::Counter* _rows_vec_cond_counter = nullptr;
+    // the times a runtime bloom filter is dropped on a segment since it filters too few rows
+    RuntimeProfile::Counter* _runtime_filters_dropped_counter = nullptr;
+    RuntimeProfile::Counter* _runtime_filters_in_flight_counter = nullptr;
     RuntimeProfile::Counter* _vec_cond_timer = nullptr;
     RuntimeProfile::Counter* _short_cond_timer = nullptr;
     RuntimeProfile::Counter* _first_read_timer = nullptr;
@@ -315,11 +362,17 @@ protected:
     // page read from cache
     // used by segment v2
     RuntimeProfile::Counter* _cached_pages_num_counter = nullptr;
+    // page read ahead by the page prefetcher, and the time waiting for them
+    RuntimeProfile::Counter* _prefetched_pages_num_counter = nullptr;
+    RuntimeProfile::Counter* _page_prefetch_wait_timer = nullptr;
 
     // row count filtered by bitmap inverted index
     RuntimeProfile::Counter* _bitmap_index_filter_counter = nullptr;
     // time fro bitmap inverted index read and filter
     RuntimeProfile::Counter* _bitmap_index_filter_timer = nullptr;
+    // row count filtered by inverted index of MATCH predicates
+    RuntimeProfile::Counter* _inverted_index_filter_counter = nullptr;
+    RuntimeProfile::Counter* _inverted_index_filter_timer = nullptr;
     // number of created olap scanners
     RuntimeProfile::Counter* _num_scanners = nullptr;
 
@@ -330,6 +383,7 @@ protected:
 
     RuntimeProfile::Counter* _scanner_wait_batch_timer = nullptr;
     RuntimeProfile::Counter* _scanner_wait_worker_timer = nullptr;
+    RuntimeProfile::Counter* _instance_scanner_wait_worker_timer = nullptr;
 
     RuntimeProfile::Counter* _olap_wait_batch_queue_timer = nullptr;
 
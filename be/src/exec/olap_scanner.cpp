@@ -19,6 +19,8 @@
 
 #include <string>
 
+#include "common/config.h"
+#include "common/consts.h"
 #include "common/utils.h"
 #include "exprs/expr_context.h"
 #include "gen_cpp/PaloInternalService_types.h"
@@ -58,7 +60,8 @@ Status OlapScanner::prepare(
         const TPaloScanRange& scan_range, const std::vector<OlapScanRange*>& key_ranges,
         const std::vector<TCondition>& filters,
         const std::vector<std::pair<string, std::shared_ptr<IBloomFilterFuncBase>>>&
-                bloom_filters) {
+                bloom_filters,
+        const std::vector<RowsetReaderSharedPtr>* rs_readers) {
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     set_tablet_reader();
     // set limit to reduce end of rowset and segment mem use
@@ -82,7 +85,10 @@ Status OlapScanner::prepare(
             LOG(WARNING) << ss.str();
             return Status::InternalError(ss.str());
         }
-        {
+        if (rs_readers != nullptr) {
+            // the rowsets were captured by the scan node for all the scanners of the tablet
+            _tablet_reader_params.rs_readers = *rs_readers;
+        } else {
             std::shared_lock rdlock(_tablet->get_header_lock());
             const RowsetSharedPtr rowset = _tablet->rowset_with_max_version();
             if (rowset == nullptr) {
@@ -157,6 +163,8 @@ Status OlapScanner::_init_tablet_reader_params(
     std::copy(bloom_filters.cbegin(), bloom_filters.cend(),
               std::inserter(_tablet_reader_params.bloom_filters,
                             _tablet_reader_params.bloom_filters.begin()));
+    _tablet_reader_params.bitmap_filters = _parent->_bitmap_filters_push_down;
+    _tablet_reader_params.like_predicates = _parent->_like_predicates_push_down;
 
     // Range
     for (auto key_range : key_ranges) {
@@ -169,7 +177,11 @@ Status OlapScanner::_init_tablet_reader_params(
         _tablet_reader_params.end_key_include = key_range->end_include;
 
         _tablet_reader_params.start_key.push_back(key_range->begin_scan_range);
-        _tablet_reader_params.end_key.push_back(key_range->end_scan_range);
+        // the range split by the keys without an end has no upper bound, it's the only range
+        // of its scanner
+        if (key_range->end_scan_range.size() > 0) {
+            _tablet_reader_params.end_key.push_back(key_range->end_scan_range);
+        }
     }
 
     // TODO(zc)
@@ -227,13 +239,50 @@ Status OlapScanner::_init_tablet_reader_params(
 
     if (!config::disable_storage_page_cache) {
         _tablet_reader_params.use_page_cache = true;
+        // a full scan of a big tablet reads each page only once, don't let it flush
+        // the page cache
+        int64_t bypass_scan_rows = config::storage_page_cache_bypass_scan_rows;
+        _tablet_reader_params.bypass_page_cache_admission =
+                bypass_scan_rows > 0 && _tablet_reader_params.start_key.empty() &&
+                static_cast<int64_t>(_tablet->num_rows()) >= bypass_scan_rows;
+    }
+    _tablet_reader_params.page_prefetch_budget = _parent->_page_prefetch_budget.get();
+    _tablet_reader_params.push_down_agg_type_opt = _parent->_push_down_agg_type_opt;
+    _tablet_reader_params.topn_column = _parent->_topn_column;
+    _tablet_reader_params.topn_predicate = _parent->_topn_predicate;
+    for (const auto& late_filter : _parent->_late_runtime_filters) {
+        if (late_filter != nullptr) {
+            _tablet_reader_params.late_runtime_filters.push_back(late_filter);
+        }
+    }
+
+    if (_row_locator_pos >= 0) {
+        // the locations of the rows are lost once the rows are merged
+        if (!config::enable_storage_vectorization ||
+            !(_tablet_reader_params.direct_mode || _tablet->keys_type() == DUP_KEYS ||
+              _tablet->enable_unique_key_merge_on_write())) {
+            return Status::NotSupported(
+                    "only the rows of duplicate key or merge-on-write unique key tablets can "
+                    "be located");
+        }
+        _tablet_reader_params.record_rowids = true;
     }
 
     return Status::OK();
 }
 
 Status OlapScanner::_init_return_columns() {
-    for (auto slot : _tuple_desc->slots()) {
+    const auto& slots = _tuple_desc->slots();
+    for (int i = 0; i < slots.size(); ++i) {
+        auto slot = slots[i];
+        if (slot->col_name() == BeConsts::ROWID_COL) {
+            // the block reader fills the columns of the return columns in order
+            if (i != slots.size() - 1) {
+                return Status::InternalError("the row locator must be the last slot");
+            }
+            _row_locator_pos = i;
+            continue;
+        }
         if (!slot->is_materialized()) {
             continue;
         }
@@ -250,8 +299,8 @@ Status OlapScanner::_init_return_columns() {
         _query_slots.push_back(slot);
     }
 
-    // expand the sequence column
-    if (_tablet->tablet_schema().has_sequence_col()) {
+    // expand the sequence column, the rows are not merged if the row locators are read
+    if (_tablet->tablet_schema().has_sequence_col() && _row_locator_pos < 0) {
         bool has_replace_col = false;
         for (auto col : _return_columns) {
             if (_tablet->tablet_schema().column(col).aggregation() ==
@@ -549,6 +598,9 @@ void OlapScanner::update_counter() {
     COUNTER_UPDATE(_parent->_lazy_read_timer, stats.lazy_read_ns);
     COUNTER_UPDATE(_parent->_output_col_timer, stats.output_col_ns);
     COUNTER_UPDATE(_parent->_rows_vec_cond_counter, stats.rows_vec_cond_filtered);
+    COUNTER_UPDATE(_parent->_runtime_filters_dropped_counter, stats.runtime_filters_dropped);
+    COUNTER_UPDATE(_parent->_runtime_filters_in_flight_counter,
+                   stats.runtime_filters_applied_in_flight);
 
     COUNTER_UPDATE(_parent->_stats_filtered_counter, stats.rows_stats_filtered);
     COUNTER_UPDATE(_parent->_bf_filtered_counter, stats.rows_bf_filtered);
@@ -567,9 +619,13 @@ void OlapScanner::update_counter() {
 
     COUNTER_UPDATE(_parent->_total_pages_num_counter, stats.total_pages_num);
     COUNTER_UPDATE(_parent->_cached_pages_num_counter, stats.cached_pages_num);
+    COUNTER_UPDATE(_parent->_prefetched_pages_num_counter, stats.prefetched_pages_num);
+    COUNTER_UPDATE(_parent->_page_prefetch_wait_timer, stats.page_prefetch_wait_ns);
 
     COUNTER_UPDATE(_parent->_bitmap_index_filter_counter, stats.rows_bitmap_index_filtered);
     COUNTER_UPDATE(_parent->_bitmap_index_filter_timer, stats.bitmap_index_filter_timer);
+    COUNTER_UPDATE(_parent->_inverted_index_filter_counter, stats.rows_inverted_index_filtered);
+    COUNTER_UPDATE(_parent->_inverted_index_filter_timer, stats.inverted_index_filter_timer);
     COUNTER_UPDATE(_parent->_block_seek_counter, stats.block_seek_num);
 
     COUNTER_UPDATE(_parent->_filtered_segment_counter, stats.filtered_segment_number);
@@ -52,10 +52,13 @@ public:
 
     virtual ~OlapScanner() = default;
 
+    // If `rs_readers` is given, the scanner reads them instead of all the rowsets of the
+    // tablet, used to read a tablet by several scanners in parallel.
     Status prepare(const TPaloScanRange& scan_range, const std::vector<OlapScanRange*>& key_ranges,
                    const std::vector<TCondition>& filters,
                    const std::vector<std::pair<std::string, std::shared_ptr<IBloomFilterFuncBase>>>&
-                           bloom_filters);
+                           bloom_filters,
+                   const std::vector<RowsetReaderSharedPtr>* rs_readers = nullptr);
 
     Status open();
 
@@ -137,6 +140,10 @@ protected:
 
     std::vector<SlotDescriptor*> _query_slots;
 
+    // the position of the slot of the row locators in the tuple, -1 if not existed. It's not a
+    // column of the tablet, it's filled by the scanner after the other columns are read.
+    int _row_locator_pos = -1;
+
     // time costed and row returned statistics
     ExecNode::EvalConjunctsFn _eval_conjuncts_fn = nullptr;
 
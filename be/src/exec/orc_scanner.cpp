@@ -441,6 +441,7 @@ Status ORCScanner::open_next_reader() {
         _current_group = 0;
         _rows_of_group = 0;
         _current_line_of_group = 0;
+        init_row_reader_options();
         _row_reader = _reader->createRowReader(_row_reader_options);
 
         //include_colus is in loader columns order, and batch is in the orc order
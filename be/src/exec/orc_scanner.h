@@ -43,11 +43,14 @@ public:
     // Close this scanner
     void close() override;
 
-private:
+protected:
     // Read next buffer from reader
     Status open_next_reader();
 
-private:
+    // Set the options of the row reader of the file being opened by `_reader`, before the row
+    // reader is created.
+    virtual void init_row_reader_options() {}
+
     const std::vector<TBrokerRangeDesc>& _ranges;
     const std::vector<TNetworkAddress>& _broker_addresses;
 
@@ -45,8 +45,8 @@ ParquetScanner::ParquetScanner(RuntimeState* state, RuntimeProfile* profile,
           _ranges(ranges),
           _broker_addresses(broker_addresses),
           // _splittable(params.splittable),
-          _cur_file_reader(nullptr),
           _next_range(0),
+          _cur_file_reader(nullptr),
           _cur_file_eof(false) {}
 
 ParquetScanner::~ParquetScanner() {
@@ -110,44 +110,8 @@ Status ParquetScanner::open_next_reader() {
         }
         const TBrokerRangeDesc& range = _ranges[_next_range++];
         std::unique_ptr<FileReader> file_reader;
-        switch (range.file_type) {
-        case TFileType::FILE_LOCAL: {
-            file_reader.reset(new LocalFileReader(range.path, range.start_offset));
-            break;
-        }
-        case TFileType::FILE_HDFS: {
-            FileReader* reader;
-            RETURN_IF_ERROR(HdfsReaderWriter::create_reader(range.hdfs_params, range.path,
-                                                            range.start_offset, &reader));
-            file_reader.reset(reader);
-            break;
-        }
-        case TFileType::FILE_BROKER: {
-            int64_t file_size = 0;
-            // for compatibility
-            if (range.__isset.file_size) {
-                file_size = range.file_size;
-            }
-            file_reader.reset(new BufferedReader(
-                    _profile,
-                    new BrokerReader(_state->exec_env(), _broker_addresses, _params.properties,
-                                     range.path, range.start_offset, file_size)));
-            break;
-        }
-        case TFileType::FILE_S3: {
-            file_reader.reset(new BufferedReader(
-                    _profile, new S3Reader(_params.properties, range.path, range.start_offset)));
-            break;
-        }
-        default: {
-            std::stringstream ss;
-            ss << "Unknown file type, type=" << range.file_type;
-            return Status::InternalError(ss.str());
-        }
-        }
-        RETURN_IF_ERROR(file_reader->open());
-        if (file_reader->size() == 0) {
-            file_reader->close();
+        RETURN_IF_ERROR(open_file_reader(range, &file_reader));
+        if (file_reader == nullptr) {
             continue;
         }
         if (range.__isset.num_of_columns_from_file) {
@@ -173,6 +137,51 @@ Status ParquetScanner::open_next_reader() {
     }
 }
 
+Status ParquetScanner::open_file_reader(const TBrokerRangeDesc& range,
+                                        std::unique_ptr<FileReader>* file_reader) {
+    switch (range.file_type) {
+    case TFileType::FILE_LOCAL: {
+        file_reader->reset(new LocalFileReader(range.path, range.start_offset));
+        break;
+    }
+    case TFileType::FILE_HDFS: {
+        FileReader* reader;
+        RETURN_IF_ERROR(HdfsReaderWriter::create_reader(range.hdfs_params, range.path,
+                                                        range.start_offset, &reader));
+        file_reader->reset(reader);
+        break;
+    }
+    case TFileType::FILE_BROKER: {
+        int64_t file_size = 0;
+        // for compatibility
+        if (range.__isset.file_size) {
+            file_size = range.file_size;
+        }
+        file_reader->reset(new BufferedReader(
+                _profile,
+                new BrokerReader(_state->exec_env(), _broker_addresses, _params.properties,
+                                 range.path, range.start_offset, file_size)));
+        break;
+    }
+    case TFileType::FILE_S3: {
+        file_reader->reset(new BufferedReader(
+                _profile, new S3Reader(_params.properties, range.path, range.start_offset)));
+        break;
+    }
+    default: {
+        std::stringstream ss;
+        ss << "Unknown file type, type=" << range.file_type;
+        return Status::InternalError(ss.str());
+    }
+    }
+    RETURN_IF_ERROR((*file_reader)->open());
+    if ((*file_reader)->size() == 0) {
+        (*file_reader)->close();
+        file_reader->reset();
+    }
+    return Status::OK();
+}
+
 void ParquetScanner::close() {
     BaseScanner::close();
     if (_cur_file_reader != nullptr) {
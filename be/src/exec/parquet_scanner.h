@@ -33,6 +33,7 @@
 
 namespace doris {
 
+class FileReader;
 class Tuple;
 class SlotDescriptor;
 struct Slice;
@@ -65,18 +66,22 @@ public:
     // Close this scanner
     virtual void close();
 
-private:
-    // Read next buffer from reader
-    Status open_next_reader();
+protected:
+    // Open the file of `range`, `file_reader` is null if the file is empty.
+    Status open_file_reader(const TBrokerRangeDesc& range,
+                            std::unique_ptr<FileReader>* file_reader);
 
-private:
     //const TBrokerScanRangeParams& _params;
     const std::vector<TBrokerRangeDesc>& _ranges;
     const std::vector<TNetworkAddress>& _broker_addresses;
+    int _next_range;
+
+private:
+    // Read next buffer from reader
+    Status open_next_reader();
 
     // Reader
     ParquetReaderWrap* _cur_file_reader;
-    int _next_range;
     bool _cur_file_eof; // is read over?
 
     // used to hold current StreamLoadPipe
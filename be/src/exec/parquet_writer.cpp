@@ -106,6 +106,11 @@ ParquetWriterWrapper::ParquetWriterWrapper(FileWriter* file_writer,
 
 void ParquetWriterWrapper::parse_properties(
         const std::map<std::string, std::string>& propertie_map) {
+    _properties = build_properties(propertie_map);
+}
+
+std::shared_ptr<parquet::WriterProperties> ParquetWriterWrapper::build_properties(
+        const std::map<std::string, std::string>& propertie_map) {
     parquet::WriterProperties::Builder builder;
     for (auto it = propertie_map.begin(); it != propertie_map.end(); it++) {
         std::string property_name = it->first;
@@ -143,7 +148,7 @@ void ParquetWriterWrapper::parse_properties(
             }
         }
     }
-    _properties = builder.build();
+    return builder.build();
 }
 
 Status ParquetWriterWrapper::parse_schema(const std::vector<std::vector<std::string>>& schema) {
@@ -86,6 +86,10 @@ public:
 
     void parse_properties(const std::map<std::string, std::string>& propertie_map);
 
+    // the writer properties of the file properties of the export
+    static std::shared_ptr<parquet::WriterProperties> build_properties(
+            const std::map<std::string, std::string>& propertie_map);
+
     Status parse_schema(const std::vector<std::vector<std::string>>& schema);
 
     parquet::RowGroupWriter* get_rg_writer();
@@ -94,6 +94,10 @@ inline bool PlainTextLineReader::update_eof() {
 uint8_t* PlainTextLineReader::update_field_pos_and_find_line_delimiter(const uint8_t* start,
                                                                        size_t len) {
     // TODO: meanwhile find and save field pos
+    if (_line_delimiter_length == 1) {
+        // memchr is vectorized, while memmem may fall back to the two-way algorithm
+        return (uint8_t*)memchr(start, _line_delimiter[0], len);
+    }
     return (uint8_t*)memmem(start, len, _line_delimiter.c_str(), _line_delimiter_length);
 }
 
@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exec/rowid_fetcher.h"
+
+#include <map>
+
+#include "gen_cpp/internal_service.pb.h"
+#include "gutil/strings/substitute.h"
+#include "olap/olap_common.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "service/brpc.h"
+#include "util/brpc_client_cache.h"
+#include "vec/common/assert_cast.h"
+#include "vec/columns/column_nullable.h"
+
+namespace doris {
+
+namespace {
+
+// the rpc to fetch the rows located in a backend
+struct FetchRpc {
+    std::shared_ptr<PBackendService_Stub> stub;
+    // the rows of the locators fetched by this rpc
+    std::vector<size_t> rows;
+    PMultiGetRequest request;
+    PMultiGetResponse response;
+    brpc::Controller cntl;
+};
+
+} // namespace
+
+Status RowIdFetcher::fetch(RuntimeState* state, const vectorized::ColumnPtr& locators,
+                           vectorized::Block* block) {
+    const vectorized::IColumn* locator_column = locators.get();
+    if (locator_column->is_nullable()) {
+        locator_column =
+                &assert_cast<const vectorized::ColumnNullable*>(locator_column)->get_nested_column();
+    }
+
+    // one rpc for the rows of each backend
+    std::map<int64_t, std::unique_ptr<FetchRpc>> rpcs;
+    for (size_t i = 0; i < locator_column->size(); ++i) {
+        StringRef data = locator_column->get_data_at(i);
+        if (data.size != sizeof(GlobalRowLocation)) {
+            return Status::InternalError("invalid row locator");
+        }
+        GlobalRowLocation location;
+        memcpy(&location, data.data, sizeof(location));
+        auto& rpc = rpcs[location.backend_id];
+        if (rpc == nullptr) {
+            rpc = std::make_unique<FetchRpc>();
+        }
+        rpc->rows.push_back(i);
+        auto row_loc = rpc->request.add_row_locs();
+        row_loc->set_tablet_id(location.tablet_id);
+        row_loc->set_rowset_id(location.row_location.rowset_id.to_string());
+        row_loc->set_segment_id(location.row_location.segment_id);
+        row_loc->set_ordinal_id(location.row_location.row_id);
+    }
+
+    for (auto& [backend_id, rpc] : rpcs) {
+        const NodeInfo* node = _nodes_info.find_node(backend_id);
+        if (node == nullptr) {
+            return Status::InternalError(strings::Substitute("unknown backend $0", backend_id));
+        }
+        rpc->stub = state->exec_env()->brpc_internal_client_cache()->get_client(node->host,
+                                                                                node->brpc_port);
+        if (rpc->stub == nullptr) {
+            return Status::InternalError(strings::Substitute(
+                    "failed to get the brpc stub of $0:$1", node->host, node->brpc_port));
+        }
+        for (auto slot : _fetch_tuple->slots()) {
+            slot->to_protobuf(rpc->request.add_slots());
+        }
+        rpc->request.mutable_query_id()->set_hi(state->query_id().hi);
+        rpc->request.mutable_query_id()->set_lo(state->query_id().lo);
+        rpc->cntl.set_timeout_ms(state->query_options().query_timeout * 1000);
+    }
+
+    // send all the rpcs, and wait for all of them before the rpcs are released
+    for (auto& [backend_id, rpc] : rpcs) {
+        rpc->stub->multiget_data(&rpc->cntl, &rpc->request, &rpc->response, brpc::DoNothing());
+    }
+    for (auto& [backend_id, rpc] : rpcs) {
+        brpc::Join(rpc->cntl.call_id());
+    }
+
+    // the row i of the locators is the row `positions[i].second` of `fetched[positions[i].first]`
+    std::vector<vectorized::Block> fetched;
+    std::vector<std::pair<size_t, size_t>> positions(locator_column->size());
+    for (auto& [backend_id, rpc] : rpcs) {
+        if (rpc->cntl.Failed()) {
+            state->exec_env()->brpc_internal_client_cache()->erase(rpc->cntl.remote_side());
+            return Status::InternalError(strings::Substitute(
+                    "failed to fetch the rows from backend $0: $1", backend_id,
+                    rpc->cntl.ErrorText()));
+        }
+        RETURN_IF_ERROR(Status(rpc->response.status()));
+        vectorized::Block rows(rpc->response.block());
+        if (rows.rows() != rpc->rows.size() || rows.columns() != _fetch_tuple->slots().size()) {
+            return Status::InternalError(strings::Substitute(
+                    "fetched $0 rows of $1 columns from backend $2, expect $3 rows of $4 columns",
+                    rows.rows(), rows.columns(), backend_id, rpc->rows.size(),
+                    _fetch_tuple->slots().size()));
+        }
+        for (size_t j = 0; j < rpc->rows.size(); ++j) {
+            positions[rpc->rows[j]] = {fetched.size(), j};
+        }
+        fetched.push_back(std::move(rows));
+    }
+
+    // restore the order of the locators
+    for (size_t i = 0; i < _fetch_tuple->slots().size(); ++i) {
+        auto slot = _fetch_tuple->slots()[i];
+        auto column = slot->get_empty_mutable_column();
+        column->reserve(positions.size());
+        for (const auto& [block_idx, row] : positions) {
+            column->insert_from(*fetched[block_idx].get_by_position(i).column, row);
+        }
+        block->insert({std::move(column), slot->get_data_type_ptr(), slot->col_name()});
+    }
+    return Status::OK();
+}
+
+} // namespace doris
@@ -0,0 +1,51 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+
+#include "common/status.h"
+#include "exec/tablet_info.h"
+#include "gen_cpp/DataSinks_types.h"
+#include "vec/core/block.h"
+
+namespace doris {
+
+class RuntimeState;
+class TupleDescriptor;
+
+// Fetch the columns of the rows by their row locators (GlobalRowLocation) from the backends
+// holding the rows, by the multiget_data rpc. It's the second phase of a two-phase Top-N
+// query, the first phase only reads the sort columns and the row locators, so the other
+// columns are only read for the rows in the result.
+class RowIdFetcher {
+public:
+    RowIdFetcher(const TupleDescriptor* fetch_tuple, const TPaloNodesInfo& nodes_info)
+            : _fetch_tuple(fetch_tuple), _nodes_info(nodes_info) {}
+
+    // Fetch the columns of the slots of the fetch tuple of the rows located by `locators`, and
+    // append them to `block` in the order of the slots.
+    Status fetch(RuntimeState* state, const vectorized::ColumnPtr& locators,
+                 vectorized::Block* block);
+
+private:
+    const TupleDescriptor* _fetch_tuple;
+    DorisNodesInfo _nodes_info;
+};
+
+} // namespace doris
@@ -73,6 +73,7 @@ Status S3Reader::open() {
 Status S3Reader::read(uint8_t* buf, int64_t buf_len, int64_t* bytes_read, bool* eof) {
     DCHECK_NE(buf_len, 0);
     RETURN_IF_ERROR(readat(_cur_offset, buf_len, bytes_read, buf));
+    _cur_offset += *bytes_read;
     if (*bytes_read == 0) {
         *eof = true;
     } else {
@@ -106,7 +107,6 @@ Status S3Reader::readat(int64_t position, int64_t nbytes, int64_t* bytes_read, v
     }
     *bytes_read = response.GetResult().GetContentLength();
     *bytes_read = nbytes < *bytes_read ? nbytes : *bytes_read;
-    _cur_offset = position + *bytes_read;
     response.GetResult().GetBody().read((char*)out, *bytes_read);
     return Status::OK();
 }
@@ -56,6 +56,8 @@ public:
     virtual Status tell(int64_t* position) override;
     virtual void close() override;
     virtual bool closed() override;
+    // every readat() is an independent ranged GET
+    bool support_concurrent_reads() const override { return true; }
 
 private:
     const std::map<std::string, std::string>& _properties;
@@ -566,6 +566,64 @@ uint32_t VOlapTablePartitionParam::find_tablet(BlockRow* block_row,
     return _compute_tablet_index(block_row, partition.num_buckets);
 }
 
+void VOlapTablePartitionParam::find_partitions(
+        vectorized::Block* block, std::vector<const VOlapTablePartition*>* partitions) const {
+    const int num_rows = block->rows();
+    partitions->assign(num_rows, nullptr);
+    const VOlapTablePartition* last_partition = nullptr;
+    for (int i = 0; i < num_rows; ++i) {
+        BlockRow block_row {block, i};
+        if (!_is_in_partition && last_partition != nullptr &&
+            _range_contains(last_partition, &block_row)) {
+            (*partitions)[i] = last_partition;
+            continue;
+        }
+        if (find_partition(&block_row, &(*partitions)[i])) {
+            last_partition = (*partitions)[i];
+        }
+    }
+}
+
+void VOlapTablePartitionParam::find_tablets(
+        vectorized::Block* block, const std::vector<const VOlapTablePartition*>& partitions,
+        std::vector<uint32_t>* tablet_indexes) const {
+    const int num_rows = block->rows();
+    tablet_indexes->assign(num_rows, 0);
+    if (_distributed_slot_locs.empty()) {
+        for (int i = 0; i < num_rows; ++i) {
+            if (partitions[i] != nullptr) {
+                BlockRow block_row {block, i};
+                (*tablet_indexes)[i] =
+                        _compute_tablet_index(&block_row, partitions[i]->num_buckets);
+            }
+        }
+        return;
+    }
+
+    // the same hashes as _compute_tablet_index, but computed column by column
+    std::vector<uint32_t> hash_vals(num_rows, 0);
+    static const int INT_VALUE = 0;
+    static const TypeDescriptor INT_TYPE(TYPE_INT);
+    for (auto slot_loc : _distributed_slot_locs) {
+        const auto& type = _slots[slot_loc]->type();
+        const vectorized::IColumn& column = *block->get_by_position(slot_loc).column;
+        for (int i = 0; i < num_rows; ++i) {
+            auto val = column.get_data_at(i);
+            if (val.data != nullptr) {
+                hash_vals[i] = RawValue::zlib_crc32(val.data, val.size, type, hash_vals[i]);
+            } else {
+                // NULL is treat as 0 when hash
+                hash_vals[i] = RawValue::zlib_crc32(&INT_VALUE, INT_TYPE, hash_vals[i]);
+            }
+        }
+    }
+    for (int i = 0; i < num_rows; ++i) {
+        if (partitions[i] != nullptr) {
+            (*tablet_indexes)[i] = hash_vals[i] % partitions[i]->num_buckets;
+        }
+    }
+}
+
 Status VOlapTablePartitionParam::_create_partition_keys(const std::vector<TExprNode>& t_exprs,
                                                         BlockRow* part_key) {
     for (int i = 0; i < t_exprs.size(); i++) {
@@ -267,6 +267,18 @@ public:
 
     uint32_t find_tablet(BlockRow* block_row, const VOlapTablePartition& partition) const;
 
+    // Find the partitions of all the rows of the block, (*partitions)[i] is nullptr if there is
+    // no partition for the row i. The consecutive rows are usually in the same partition, so the
+    // partition of the previous row is checked before searching all the partitions.
+    void find_partitions(vectorized::Block* block,
+                         std::vector<const VOlapTablePartition*>* partitions) const;
+
+    // Find the tablet indexes of all the rows of the block in their partitions, the distributed
+    // columns are hashed column by column. The rows without partitions get the index 0.
+    void find_tablets(vectorized::Block* block,
+                      const std::vector<const VOlapTablePartition*>& partitions,
+                      std::vector<uint32_t>* tablet_indexes) const;
+
     const std::vector<VOlapTablePartition*>& get_partitions() const { return _partitions; }
 
 private:
@@ -283,6 +295,13 @@ private:
         return part->start_key.second == -1 || !comparator(key, &part->start_key);
     }
 
+    // check if the key is in the range [start_key, end_key) of the range partition
+    bool _range_contains(const VOlapTablePartition* part, BlockRow* key) const {
+        VOlapTablePartKeyComparator comparator(_partition_slot_locs);
+        return (part->start_key.second == -1 || !comparator(key, &part->start_key)) &&
+               comparator(key, &part->end_key);
+    }
+
 private:
     // this partition only valid in this schema
     std::shared_ptr<OlapTableSchemaParam> _schema;
@@ -135,6 +135,23 @@ void NodeChannel::open() {
         ptablet->set_partition_id(tablet.partition_id);
         ptablet->set_tablet_id(tablet.tablet_id);
     }
+    for (auto& [tablet_id, node_ids] : _slave_tablet_nodes) {
+        auto slave_tablet_nodes = request.add_slave_tablet_nodes();
+        slave_tablet_nodes->set_tablet_id(tablet_id);
+        for (auto node_id : node_ids) {
+            const NodeInfo* node = _parent->_nodes_info->find_node(node_id);
+            if (node == nullptr) {
+                // the replica is not committed, FE judges whether the load succeeds by the quorum
+                LOG(WARNING) << "unknown node id of the slave replica, node_id=" << node_id
+                             << ", tablet_id=" << tablet_id;
+                continue;
+            }
+            auto slave_node = slave_tablet_nodes->add_slave_nodes();
+            slave_node->set_id(node_id);
+            slave_node->set_host(node->host);
+            slave_node->set_async_internal_port(node->brpc_port);
+        }
+    }
     request.set_num_senders(_parent->_num_senders);
     request.set_need_gen_rollup(false); // Useless but it is a required field in pb
     request.set_load_mem_limit(_parent->_load_mem_limit);
@@ -239,12 +256,7 @@ Status NodeChannel::open_wait() {
                 if (!st.ok()) {
                     _cancel_with_msg(st.get_error_msg());
                 } else if (is_last_rpc) {
-                    for (auto& tablet : result.tablet_vec()) {
-                        TTabletCommitInfo commit_info;
-                        commit_info.tabletId = tablet.tablet_id();
-                        commit_info.backendId = _node_id;
-                        _tablet_commit_infos.emplace_back(std::move(commit_info));
-                    }
+                    _add_tablet_commit_infos(result);
                     _add_batches_finished = true;
                 }
             } else {
@@ -560,6 +572,11 @@ Status IndexChannel::init(RuntimeState* state, const std::vector<TTabletWithPart
         }
         std::vector<std::shared_ptr<NodeChannel>> channels;
         for (auto& node_id : location->node_ids) {
+            if (_parent->_single_replica_load && !channels.empty()) {
+                // the slave replica pulls the rowset from the first replica after it's committed
+                channels[0]->add_slave_tablet_node(tablet.tablet_id, node_id);
+                continue;
+            }
             std::shared_ptr<NodeChannel> channel;
             auto it = _node_channels.find(node_id);
             if (it == _node_channels.end()) {
@@ -587,6 +604,36 @@ Status IndexChannel::init(RuntimeState* state, const std::vector<TTabletWithPart
     return Status::OK();
 }
 
+void IndexChannel::add_rows(const vectorized::Block* block, const std::vector<int>& rows,
+                            const std::vector<int64_t>& tablet_ids) {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_index_channel_tracker);
+    // the rows of each node channel, in the order of the rows in the block
+    std::unordered_map<NodeChannel*, std::pair<std::vector<int>, std::vector<int64_t>>>
+            channel_rows;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto it = _channels_by_tablet.find(tablet_ids[i]);
+        DCHECK(it != _channels_by_tablet.end()) << "unknown tablet, tablet_id=" << tablet_ids[i];
+        for (const auto& channel : it->second) {
+            auto& [channel_row_ids, channel_tablet_ids] = channel_rows[channel.get()];
+            channel_row_ids.push_back(rows[i]);
+            channel_tablet_ids.push_back(tablet_ids[i]);
+        }
+    }
+    for (auto& [channel, row_and_tablet_ids] : channel_rows) {
+        // if this node channel is already failed, this add_rows will be skipped
+        auto st = channel->add_rows(block, row_and_tablet_ids.first, row_and_tablet_ids.second);
+        if (!st.ok()) {
+            std::unordered_set<int64_t> failed_tablets(row_and_tablet_ids.second.begin(),
+                                                       row_and_tablet_ids.second.end());
+            for (auto tablet_id : failed_tablets) {
+                mark_as_failed(channel->node_id(), channel->host(), st.get_error_msg(),
+                               tablet_id);
+            }
+            // continue add rows to other nodes, the error will be checked for every batch outside
+        }
+    }
+}
+
 void IndexChannel::mark_as_failed(int64_t node_id, const std::string& host, const std::string& err,
                                   int64_t tablet_id) {
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_index_channel_tracker);
@@ -681,6 +728,7 @@ Status OlapTableSink::init(const TDataSink& t_sink) {
     } else {
         _load_channel_timeout_s = config::streaming_load_rpc_max_alive_time_sec;
     }
+    _single_replica_load = config::enable_single_replica_load;
     if (table_sink.__isset.send_batch_parallelism && table_sink.send_batch_parallelism > 1) {
         _send_batch_parallelism = table_sink.send_batch_parallelism;
     }
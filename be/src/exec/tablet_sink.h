@@ -172,6 +172,11 @@ public:
 
     // called before open, used to add tablet located in this backend
     void add_tablet(const TTabletWithPartition& tablet) { _all_tablets.emplace_back(tablet); }
+    // called before open in the single replica load, the slave replica on `node_id` pulls the
+    // rowset of the tablet from this backend
+    void add_slave_tablet_node(int64_t tablet_id, int64_t node_id) {
+        _slave_tablet_nodes[tablet_id].push_back(node_id);
+    }
 
     virtual Status init(RuntimeState* state);
 
@@ -184,6 +189,12 @@ public:
         LOG(FATAL) << "add block row to NodeChannel not supported";
         return Status::OK();
     }
+    // add the rows of the block, tablet_ids[i] is the tablet of the row rows[i]
+    virtual Status add_rows(const vectorized::Block* block, const std::vector<int>& rows,
+                            const std::vector<int64_t>& tablet_ids) {
+        LOG(FATAL) << "add block rows to NodeChannel not supported";
+        return Status::OK();
+    }
 
     // two ways to stop channel:
     // 1. mark_close()->close_wait() PS. close_wait() will block waiting for the last AddBatch rpc response.
@@ -238,6 +249,26 @@ protected:
     void _cancel_with_msg(const std::string& msg);
     virtual void _close_check();
 
+    // add the commit infos of the tablets written by the last rpc, and the ones of the slave
+    // replicas pulled the rowsets from this backend
+    template <typename Result>
+    void _add_tablet_commit_infos(const Result& result) {
+        for (auto& tablet : result.tablet_vec()) {
+            TTabletCommitInfo commit_info;
+            commit_info.tabletId = tablet.tablet_id();
+            commit_info.backendId = _node_id;
+            _tablet_commit_infos.emplace_back(std::move(commit_info));
+        }
+        for (auto& slave_nodes : result.success_slave_tablet_node_ids()) {
+            for (auto node_id : slave_nodes.slave_node_ids()) {
+                TTabletCommitInfo commit_info;
+                commit_info.tabletId = slave_nodes.tablet_id();
+                commit_info.backendId = node_id;
+                _tablet_commit_infos.emplace_back(std::move(commit_info));
+            }
+        }
+    }
+
 protected:
     bool _is_vectorized = false;
     OlapTableSink* _parent = nullptr;
@@ -285,6 +316,8 @@ protected:
     RefCountClosure<PTabletWriterOpenResult>* _open_closure = nullptr;
 
     std::vector<TTabletWithPartition> _all_tablets;
+    // tablet_id -> the node ids of the slave replicas, only in the single replica load
+    std::unordered_map<int64_t, std::vector<int64_t>> _slave_tablet_nodes;
     std::vector<TTabletCommitInfo> _tablet_commit_infos;
 
     AddBatchCounter _add_batch_counter;
@@ -334,6 +367,11 @@ public:
     template <typename Row>
     void add_row(const Row& tuple, int64_t tablet_id);
 
+    // Add the rows of the block, tablet_ids[i] is the tablet of the row rows[i]. The rows are
+    // grouped by their node channels first, so each node channel adds its rows at once.
+    void add_rows(const vectorized::Block* block, const std::vector<int>& rows,
+                  const std::vector<int64_t>& tablet_ids);
+
     void for_each_node_channel(
             const std::function<void(const std::shared_ptr<NodeChannel>&)>& func) {
         SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_index_channel_tracker);
@@ -469,6 +507,8 @@ protected:
     int _sender_id = -1;
     int _num_senders = -1;
     bool _is_high_priority = false;
+    // only send the rows to the first replica of each tablet
+    bool _single_replica_load = false;
 
     // TODO(zc): think about cache this data
     std::shared_ptr<OlapTableSchemaParam> _schema;
@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/bitmapfilter_predicate.h"
+
+#include "exprs/expr_context.h"
+
+namespace doris {
+
+Status BitmapFilterFunc::assign(const char* data, int len) {
+    if (len == 0) {
+        _bitmap = BitmapValue();
+        return Status::OK();
+    }
+    if (!_bitmap.deserialize(data)) {
+        return Status::InvalidArgument("invalid bitmap filter");
+    }
+    return Status::OK();
+}
+
+Status BitmapFilterFunc::get_data(char** data, int* len) {
+    _serialized.resize(_bitmap.getSizeInBytes());
+    _bitmap.write(_serialized.data());
+    *data = _serialized.data();
+    *len = _serialized.size();
+    return Status::OK();
+}
+
+BitmapFilterPredicate::BitmapFilterPredicate(const TExprNode& node)
+        : Predicate(node), _is_prepare(false) {}
+
+BitmapFilterPredicate::BitmapFilterPredicate(const BitmapFilterPredicate& other)
+        : Predicate(other), _is_prepare(other._is_prepare), _filter(other._filter) {}
+
+Status BitmapFilterPredicate::prepare(RuntimeState* state, BitmapFilterFunc* bitmap_filter_func) {
+    if (_is_prepare) {
+        return Status::OK();
+    }
+    _filter.reset(bitmap_filter_func);
+    if (_filter == nullptr) {
+        return Status::InternalError("Unknown column type.");
+    }
+    _is_prepare = true;
+    return Status::OK();
+}
+
+std::string BitmapFilterPredicate::debug_string() const {
+    return "BitmapFilterPredicate()";
+}
+
+BooleanVal BitmapFilterPredicate::get_boolean_val(ExprContext* ctx, TupleRow* row) {
+    const void* lhs_slot = ctx->get_value(_children[0], row);
+    if (lhs_slot == nullptr) {
+        return BooleanVal::null();
+    }
+    return BooleanVal(_filter->find(lhs_slot));
+}
+
+Status BitmapFilterPredicate::open(RuntimeState* state, ExprContext* context,
+                                   FunctionContext::FunctionStateScope scope) {
+    return Expr::open(state, context, scope);
+}
+
+} // namespace doris
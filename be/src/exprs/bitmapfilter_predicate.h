@@ -0,0 +1,113 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "common/status.h"
+#include "exprs/predicate.h"
+#include "runtime/primitive_type.h"
+#include "util/bitmap_value.h"
+
+namespace doris {
+
+// The bitmap of the build keys of a join on an integer key, used as a runtime filter.
+// Unlike a bloom filter it has no false positive, and it stays small for dense keys. The
+// values are stored as uint64, the negative values are stored as their two's complement.
+class BitmapFilterFunc {
+public:
+    explicit BitmapFilterFunc(PrimitiveType type) : _type(type) {}
+
+    static bool is_supported_type(PrimitiveType type) {
+        return type == TYPE_TINYINT || type == TYPE_SMALLINT || type == TYPE_INT ||
+               type == TYPE_BIGINT;
+    }
+
+    // `data` points to a value of the column type
+    void insert(const void* data) { _bitmap.add(_to_key(data)); }
+
+    bool find(const void* data) const { return _bitmap.contains(_to_key(data)); }
+
+    // results[i] is set to whether the value data[sel[i]] is in the bitmap
+    template <class T>
+    void find_batch(const T* data, const uint16_t* sel, uint16_t n, uint8_t* results) const {
+        for (uint16_t i = 0; i < n; ++i) {
+            results[i] = _bitmap.contains(static_cast<uint64_t>(data[sel[i]]));
+        }
+    }
+
+    void merge(const BitmapFilterFunc* other) { _bitmap |= other->_bitmap; }
+
+    Status assign(const char* data, int len);
+
+    // the serialized bitmap, valid until the next call
+    Status get_data(char** data, int* len);
+
+    const BitmapValue& bitmap() const { return _bitmap; }
+
+    PrimitiveType type() const { return _type; }
+
+private:
+    uint64_t _to_key(const void* data) const {
+        switch (_type) {
+        case TYPE_TINYINT:
+            return static_cast<uint64_t>(*reinterpret_cast<const int8_t*>(data));
+        case TYPE_SMALLINT:
+            return static_cast<uint64_t>(*reinterpret_cast<const int16_t*>(data));
+        case TYPE_INT:
+            return static_cast<uint64_t>(*reinterpret_cast<const int32_t*>(data));
+        default:
+            return static_cast<uint64_t>(*reinterpret_cast<const int64_t*>(data));
+        }
+    }
+
+    PrimitiveType _type;
+    BitmapValue _bitmap;
+    std::string _serialized;
+};
+
+// BitmapFilterPredicate only used in runtime filter
+class BitmapFilterPredicate : public Predicate {
+public:
+    BitmapFilterPredicate(const TExprNode& node);
+    BitmapFilterPredicate(const BitmapFilterPredicate& other);
+    ~BitmapFilterPredicate() override = default;
+    Expr* clone(ObjectPool* pool) const override {
+        return pool->add(new BitmapFilterPredicate(*this));
+    }
+    using Predicate::prepare;
+    Status prepare(RuntimeState* state, BitmapFilterFunc* bitmap_filter_func);
+
+    std::shared_ptr<BitmapFilterFunc> get_bitmap_filter_func() { return _filter; }
+
+    BooleanVal get_boolean_val(ExprContext* context, TupleRow* row) override;
+
+    Status open(RuntimeState* state, ExprContext* context,
+                FunctionContext::FunctionStateScope scope) override;
+
+protected:
+    friend class Expr;
+    std::string debug_string() const override;
+
+private:
+    bool _is_prepare;
+    std::shared_ptr<BitmapFilterFunc> _filter;
+};
+
+} // namespace doris
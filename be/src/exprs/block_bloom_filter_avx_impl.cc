@@ -61,6 +61,21 @@ bool BlockBloomFilter::bucket_find_avx2(const uint32_t bucket_idx,
     return result;
 }
 
+void BlockBloomFilter::find_batch_avx2(const uint32_t* hashes, size_t n,
+                                       uint8_t* results) const noexcept {
+    const __m256i* const directory = reinterpret_cast<const __m256i*>(_directory);
+    for (size_t i = 0; i < n; ++i) {
+        if (i + kPrefetchDistance < n) {
+            __builtin_prefetch(
+                    &directory[rehash32to32(hashes[i + kPrefetchDistance]) & _directory_mask]);
+        }
+        const uint32_t bucket_idx = rehash32to32(hashes[i]) & _directory_mask;
+        results[i] = _mm256_testc_si256(directory[bucket_idx], make_mark(hashes[i]));
+    }
+    // zero the upper halves once for the whole batch instead of once per probe
+    _mm256_zeroupper();
+}
+
 void BlockBloomFilter::insert_avx2(const uint32_t hash) noexcept {
     _always_false = false;
     const uint32_t bucket_idx = rehash32to32(hash) & _directory_mask;
@@ -172,6 +172,25 @@ bool BlockBloomFilter::find(const uint32_t hash) const noexcept {
 #endif
 }
 
+void BlockBloomFilter::find_batch(const uint32_t* hashes, size_t n,
+                                  uint8_t* results) const noexcept {
+    if (_always_false) {
+        memset(results, 0, n);
+        return;
+    }
+#ifdef __AVX2__
+    find_batch_avx2(hashes, n, results);
+#else
+    for (size_t i = 0; i < n; ++i) {
+        if (i + kPrefetchDistance < n) {
+            __builtin_prefetch(
+                    &_directory[rehash32to32(hashes[i + kPrefetchDistance]) & _directory_mask]);
+        }
+        results[i] = bucket_find(rehash32to32(hashes[i]) & _directory_mask, hashes[i]);
+    }
+#endif
+}
+
 void BlockBloomFilter::or_equal_array_internal(size_t n, const uint8_t* __restrict__ in,
                                                uint8_t* __restrict__ out) {
 #ifdef __AVX2__
@@ -66,6 +66,12 @@ public:
         return _bloom_filter->find(data);
     }
 
+    void test_batch(const uint32_t* hashes, size_t n, uint8_t* results) const {
+        _bloom_filter->find_batch(hashes, n, results);
+    }
+
+    uint32_t hash(const Slice& key) const { return _bloom_filter->hash(key); }
+
     void add_bytes(const char* data, size_t len) { _bloom_filter->insert(Slice(data, len)); }
 
 private:
@@ -85,6 +91,12 @@ public:
     virtual bool find(const void* data) const = 0;
     virtual bool find_olap_engine(const void* data) const = 0;
     virtual bool find_uint32_t(uint32_t data) const = 0;
+    // Probe the values data + sel[i] * stride like find_olap_engine by batch, results[i] is set
+    // to whether the value of sel[i] may be in the filter.
+    virtual void find_olap_engine_batch(const char* data, size_t stride, const uint16_t* sel,
+                                        uint16_t n, uint8_t* results) const = 0;
+    virtual void find_uint32_t_batch(const uint32_t* hashes, size_t n,
+                                     uint8_t* results) const = 0;
 
     virtual Status merge(IBloomFilterFuncBase* bloomfilter_func) = 0;
     virtual Status assign(const char* data, int len) = 0;
@@ -327,8 +339,34 @@ public:
         return dummy.find(*this->_bloom_filter, data);
     }
 
+    void find_olap_engine_batch(const char* data, size_t stride, const uint16_t* sel, uint16_t n,
+                                uint8_t* results) const override {
+        if constexpr (std::is_same_v<FindOp, CommonFindOp<ValueType, BloomFilterAdaptor>>) {
+            // the storage values are hashed as they are, hash all of them and then probe them
+            // by batch, so the bucket loads are prefetched
+            DCHECK_EQ(stride, sizeof(ValueType));
+            uint32_t hashes[n];
+            for (uint16_t i = 0; i < n; ++i) {
+                hashes[i] = this->_bloom_filter->hash(
+                        Slice(data + sel[i] * stride, sizeof(ValueType)));
+            }
+            this->_bloom_filter->test_batch(hashes, n, results);
+        } else {
+            for (uint16_t i = 0; i < n; ++i) {
+                results[i] = dummy.find_olap_engine(*this->_bloom_filter, data + sel[i] * stride);
+            }
+        }
+    }
+
+    void find_uint32_t_batch(const uint32_t* hashes, size_t n, uint8_t* results) const override {
+        this->_bloom_filter->test_batch(hashes, n, results);
+    }
+
 private:
-    typename BloomFilterTypeTraits<type, BloomFilterAdaptor>::FindOp dummy;
+    using ValueType = typename PrimitiveTypeTraits<type>::CppType;
+    using FindOp = typename BloomFilterTypeTraits<type, BloomFilterAdaptor>::FindOp;
+
+    FindOp dummy;
 };
 
 // BloomFilterPredicate only used in runtime filter
@@ -21,6 +21,7 @@
 #include <parallel_hashmap/phmap.h>
 
 #include <cstring>
+#include <type_traits>
 
 #include "common/object_pool.h"
 #include "common/status.h"
@@ -28,6 +29,7 @@
 #include "runtime/decimalv2_value.h"
 #include "runtime/primitive_type.h"
 #include "runtime/string_value.h"
+#include "vec/columns/column.h"
 
 namespace doris {
 
@@ -45,6 +47,20 @@ public:
     virtual bool find(void* data) = 0;
     // use in vectorize execute engine
     virtual bool find(void* data, size_t) = 0;
+
+    // Probe all the rows of (the not nullable) `column`, results[i] is set to whether the row i
+    // is in the set. The rows whose null_map entries are set are skipped, their results are
+    // undefined. null_map may be nullptr.
+    virtual void find_batch(const vectorized::IColumn& column, const uint8_t* null_map,
+                            uint8_t* results) {
+        for (size_t i = 0; i < column.size(); ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                auto ref_data = column.get_data_at(i);
+                results[i] = find((void*)ref_data.data, ref_data.size);
+            }
+        }
+    }
+
     class IteratorBase {
     public:
         IteratorBase() {}
@@ -71,16 +87,18 @@ public:
             // for largeint, it will core dump with no memcpy
             T value;
             memcpy(&value, data, sizeof(T));
-            _set.insert(value);
+            _insert_value(value);
         } else {
-            _set.insert(*reinterpret_cast<const T*>(data));
+            _insert_value(*reinterpret_cast<const T*>(data));
         }
     }
     void insert(void* data, size_t) override { insert(data); }
 
     void insert(HybridSetBase* set) override {
         HybridSet<T>* hybrid_set = reinterpret_cast<HybridSet<T>*>(set);
-        _set.insert(hybrid_set->_set.begin(), hybrid_set->_set.end());
+        for (const auto& value : hybrid_set->_set) {
+            _insert_value(value);
+        }
     }
 
     int size() override { return _set.size(); }
@@ -92,6 +110,45 @@ public:
 
     bool find(void* data, size_t) override { return find(data); }
 
+    void find_batch(const vectorized::IColumn& column, const uint8_t* null_map,
+                    uint8_t* results) override {
+        // the columns whose values are not laid out as T, e.g. the dates, are probed row by row
+        if (!column.is_fixed_and_contiguous() || column.size_of_value_if_fixed() != sizeof(T)) {
+            HybridSetBase::find_batch(column, null_map, results);
+            return;
+        }
+        const T* data = reinterpret_cast<const T*>(column.get_raw_data().data);
+        size_t rows = column.size();
+        if constexpr (std::is_arithmetic_v<T>) {
+            // comparing with all the values of a small set is cheaper than hashing, and the
+            // fixed trip count loop is vectorized. The null rows are probed too, it's harmless.
+            if (_set.size() <= SMALL_SET_SIZE) {
+                if (_set.empty()) {
+                    memset(results, 0, rows);
+                    return;
+                }
+                // pad by a value in the set, which doesn't change the results
+                T values[SMALL_SET_SIZE];
+                for (size_t j = 0; j < SMALL_SET_SIZE; ++j) {
+                    values[j] = j < _set.size() ? _small_values[j] : _small_values[0];
+                }
+                for (size_t i = 0; i < rows; ++i) {
+                    bool found = false;
+                    for (size_t j = 0; j < SMALL_SET_SIZE; ++j) {
+                        found |= data[i] == values[j];
+                    }
+                    results[i] = found;
+                }
+                return;
+            }
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                results[i] = _set.find(data[i]) != _set.end();
+            }
+        }
+    }
+
     template <class _iT>
     class Iterator : public IteratorBase {
     public:
@@ -113,7 +170,18 @@ public:
     }
 
 private:
+    static constexpr size_t SMALL_SET_SIZE = 16;
+
+    void _insert_value(const T& value) {
+        if (_set.insert(value).second && _set.size() <= SMALL_SET_SIZE) {
+            _small_values[_set.size() - 1] = value;
+        }
+    }
+
     phmap::flat_hash_set<T> _set;
+    // the values of the set in the insertion order, only valid if the set has no more than
+    // SMALL_SET_SIZE values
+    T _small_values[SMALL_SET_SIZE];
     ObjectPool _pool;
 };
 
@@ -156,6 +224,18 @@ public:
         return !(it == _set.end());
     }
 
+    void find_batch(const vectorized::IColumn& column, const uint8_t* null_map,
+                    uint8_t* results) override {
+        // probe by string_view, without copying the values to std::string
+        for (size_t i = 0; i < column.size(); ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                auto ref_data = column.get_data_at(i);
+                std::string_view str_value(ref_data.data, ref_data.size);
+                results[i] = _set.find(str_value) != _set.end();
+            }
+        }
+    }
+
     class Iterator : public IteratorBase {
     public:
         Iterator(phmap::flat_hash_set<std::string>::iterator begin,
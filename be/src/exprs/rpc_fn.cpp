@@ -19,6 +19,9 @@
 
 #include <fmt/format.h>
 
+#include <numeric>
+
+#include "common/config.h"
 #include "runtime/fragment_mgr.h"
 #include "runtime/user_function_cache.h"
 #include "service/brpc.h"
@@ -39,10 +42,10 @@ namespace doris {
 
 RPCFn::RPCFn(RuntimeState* state, const TFunction& fn, int fn_ctx_id, bool is_agg)
         : _state(state), _fn(fn), _fn_ctx_id(fn_ctx_id), _is_agg(is_agg) {
+    _server_addr = _fn.hdfs_location;
     _client = ExecEnv::GetInstance()->brpc_function_client_cache()->get_client(_server_addr);
     if (!_is_agg) {
         _function_name = _fn.scalar_fn.symbol;
-        _server_addr = _fn.hdfs_location;
         _signature = fmt::format("{}: [{}/{}]", _fn.name.function_name, _fn.hdfs_location,
                                  _fn.scalar_fn.symbol);
     }
@@ -746,29 +749,105 @@ void convert_to_block(vectorized::Block& block, const PValues& result, size_t po
         block.replace_by_position(pos, std::move(column));
     }
 }
-Status RPCFn::vec_call(FunctionContext* context, vectorized::Block& block,
-                       const vectorized::ColumnNumbers& arguments, size_t result,
-                       size_t input_rows_count) {
+namespace {
+
+// a call of the rows of a block to the function service
+struct FnCall {
+    size_t rows = 0;
     PFunctionCallRequest request;
     PFunctionCallResponse response;
-    request.set_function_name(_function_name);
-    convert_block_to_proto(block, arguments, input_rows_count, &request);
     brpc::Controller cntl;
-    _client->fn_call(&cntl, &request, &response, nullptr);
-    if (cntl.Failed()) {
+};
+
+Status check_fn_call(const std::string& signature, const FnCall& call) {
+    if (call.cntl.Failed()) {
         return Status::InternalError(
-                fmt::format("call to rpc function {} failed: {}", _signature, cntl.ErrorText())
+                fmt::format("call to rpc function {} failed: {}", signature, call.cntl.ErrorText())
                         .c_str());
     }
-    if (!response.has_status() || response.result_size() == 0) {
+    if (!call.response.has_status() || call.response.result_size() == 0) {
         return Status::InternalError(fmt::format(
-                "call rpc function {} failed: status or result is not set.", _signature));
+                "call rpc function {} failed: status or result is not set.", signature));
+    }
+    if (call.response.status().status_code() != 0) {
+        return Status::InternalError(fmt::format("call to rpc function {} failed: {}", signature,
+                                                 call.response.status().DebugString()));
     }
-    if (response.status().status_code() != 0) {
-        return Status::InternalError(fmt::format("call to rpc function {} failed: {}", _signature,
-                                                 response.status().DebugString()));
+    return Status::OK();
+}
+
+} // namespace
+
+Status RPCFn::vec_call(FunctionContext* context, vectorized::Block& block,
+                       const vectorized::ColumnNumbers& arguments, size_t result,
+                       size_t input_rows_count) {
+    size_t row_count = std::min(block.rows(), input_rows_count);
+    size_t batch_rows = std::max(config::function_service_batch_rows, 0);
+    if (batch_rows == 0 || row_count <= batch_rows) {
+        FnCall call;
+        call.request.set_function_name(_function_name);
+        convert_block_to_proto(block, arguments, input_rows_count, &call.request);
+        _client->fn_call(&call.cntl, &call.request, &call.response, nullptr);
+        RETURN_IF_ERROR(check_fn_call(_signature, call));
+        convert_to_block(block, call.response.result(0), result);
+        return Status::OK();
+    }
+
+    // Split the rows into sub-batches, and keep the calls of several sub-batches in flight, so
+    // that the latencies of the calls are overlapped. The results are appended in order.
+    size_t num_calls = (row_count + batch_rows - 1) / batch_rows;
+    size_t max_inflight = std::max(config::function_service_max_inflight_calls, 1);
+    vectorized::ColumnNumbers sub_arguments(arguments.size());
+    std::iota(sub_arguments.begin(), sub_arguments.end(), 0);
+    std::vector<std::unique_ptr<FnCall>> calls(num_calls);
+    size_t sent = 0;
+    auto send = [&]() {
+        size_t offset = sent * batch_rows;
+        auto& call = calls[sent++];
+        call = std::make_unique<FnCall>();
+        call->rows = std::min(batch_rows, row_count - offset);
+        vectorized::Block sub_block;
+        for (size_t col_idx : arguments) {
+            const auto& column = block.get_by_position(col_idx);
+            sub_block.insert({column.column->cut(offset, call->rows), column.type, column.name});
+        }
+        call->request.set_function_name(_function_name);
+        convert_block_to_proto(sub_block, sub_arguments, call->rows, &call->request);
+        _client->fn_call(&call->cntl, &call->request, &call->response, brpc::DoNothing());
+    };
+    while (sent < std::min(num_calls, max_inflight)) {
+        send();
+    }
+
+    const auto& result_type = block.get_by_position(result).type;
+    auto result_column = result_type->create_column();
+    result_column->reserve(row_count);
+    Status status;
+    // all the calls sent are waited for, even if one of them fails
+    for (size_t i = 0; i < sent; ++i) {
+        brpc::Join(calls[i]->cntl.call_id());
+        if (status.ok()) {
+            status = check_fn_call(_signature, *calls[i]);
+        }
+        if (status.ok()) {
+            vectorized::Block result_block({{nullptr, result_type, ""}});
+            convert_to_block(result_block, calls[i]->response.result(0), 0);
+            const auto& column = result_block.get_by_position(0).column;
+            if (column->size() == calls[i]->rows) {
+                result_column->insert_range_from(*column, 0, column->size());
+            } else {
+                status = Status::InternalError(
+                        fmt::format("call rpc function {} failed: {} rows returned, expect {}",
+                                    _signature, column->size(), calls[i]->rows));
+            }
+        }
+        if (status.ok() && sent < num_calls) {
+            send();
+        }
+        calls[i].reset();
     }
-    convert_to_block(block, response.result(0), result);
+    RETURN_IF_ERROR(status);
+    block.replace_by_position(result, std::move(result_column));
     return Status::OK();
 }
 } // namespace doris
@@ -23,6 +23,7 @@
 #include "common/status.h"
 #include "exec/hash_join_node.h"
 #include "exprs/binary_predicate.h"
+#include "exprs/bitmapfilter_predicate.h"
 #include "exprs/bloomfilter_predicate.h"
 #include "exprs/create_predicate_function.h"
 #include "exprs/expr.h"
@@ -177,6 +178,8 @@ RuntimeFilterType get_type(int filter_type) {
     }
     case PFilterType::MINMAX_FILTER:
         return RuntimeFilterType::MINMAX_FILTER;
+    case PFilterType::BITMAP_FILTER:
+        return RuntimeFilterType::BITMAP_FILTER;
     default:
         return RuntimeFilterType::UNKNOWN_FILTER;
     }
@@ -193,6 +196,8 @@ PFilterType get_type(RuntimeFilterType type) {
         return PFilterType::MINMAX_FILTER;
     case RuntimeFilterType::IN_OR_BLOOM_FILTER:
         return PFilterType::IN_OR_BLOOM_FILTER;
+    case RuntimeFilterType::BITMAP_FILTER:
+        return PFilterType::BITMAP_FILTER;
     default:
         return PFilterType::UNKNOW_FILTER;
     }
@@ -358,6 +363,14 @@ public:
             _bloomfilter_func.reset(create_bloom_filter(_column_return_type));
             return _bloomfilter_func->init_with_fixed_length(params->bloom_filter_size);
         }
+        case RuntimeFilterType::BITMAP_FILTER: {
+            if (!BitmapFilterFunc::is_supported_type(_column_return_type)) {
+                return Status::InvalidArgument("bitmap filter does not support the type " +
+                                               type_to_string(_column_return_type));
+            }
+            _bitmap_filter_func.reset(new BitmapFilterFunc(_column_return_type));
+            break;
+        }
         default:
             return Status::InvalidArgument("Unknown Filter type");
         }
@@ -405,6 +418,10 @@ public:
             }
             break;
         }
+        case RuntimeFilterType::BITMAP_FILTER: {
+            _bitmap_filter_func->insert(data);
+            break;
+        }
         default:
             DCHECK(false);
             break;
@@ -511,6 +528,18 @@ public:
             container->push_back(ctx);
             break;
         }
+        case RuntimeFilterType::BITMAP_FILTER: {
+            TTypeDesc type_desc = create_type_desc(_column_return_type);
+            TExprNode node;
+            node.__set_type(type_desc);
+            node.__set_node_type(TExprNodeType::BITMAP_PRED);
+            node.__set_opcode(TExprOpcode::RT_FILTER);
+            auto bitmap_pred = _pool->add(new BitmapFilterPredicate(node));
+            RETURN_IF_ERROR(bitmap_pred->prepare(state, _bitmap_filter_func.release()));
+            bitmap_pred->add_child(Expr::copy(_pool, prob_expr->root()));
+            container->push_back(_pool->add(new ExprContext(bitmap_pred)));
+            break;
+        }
         default:
             DCHECK(false);
             break;
@@ -575,6 +604,10 @@ public:
             _bloomfilter_func->merge(wrapper->_bloomfilter_func.get());
             break;
         }
+        case RuntimeFilterType::BITMAP_FILTER: {
+            _bitmap_filter_func->merge(wrapper->_bitmap_filter_func.get());
+            break;
+        }
         case RuntimeFilterType::IN_OR_BLOOM_FILTER: {
             auto real_filter_type = _is_bloomfilter ? RuntimeFilterType::BLOOM_FILTER
                                                     : RuntimeFilterType::IN_FILTER;
@@ -759,6 +792,14 @@ public:
         return _bloomfilter_func->assign(data, bloom_filter->filter_length());
     }
 
+    // used by shuffle runtime filter
+    // assign this filter by protobuf
+    Status assign(const PBitmapFilter* bitmap_filter, const char* data) {
+        // only used to merge or be merged, the type is not used
+        _bitmap_filter_func.reset(new BitmapFilterFunc(PrimitiveType::TYPE_BIGINT));
+        return _bitmap_filter_func->assign(data, bitmap_filter->filter_length());
+    }
+
     // used by shuffle runtime filter
     // assign this filter by protobuf
     Status assign(const PMinMaxFilter* minmax_filter) {
@@ -856,6 +897,10 @@ public:
         return _bloomfilter_func->get_data(data, filter_length);
     }
 
+    Status get_bitmap_filter_desc(char** data, int* filter_length) {
+        return _bitmap_filter_func->get_data(data, filter_length);
+    }
+
     Status get_minmax_filter_desc(void** min_data, void** max_data) {
         *min_data = _minmax_func->get_min();
         *max_data = _minmax_func->get_max();
@@ -907,6 +952,7 @@ private:
     std::unique_ptr<MinMaxFuncBase> _minmax_func;
     std::unique_ptr<HybridSetBase> _hybrid_set;
     std::unique_ptr<IBloomFilterFuncBase> _bloomfilter_func;
+    std::unique_ptr<BitmapFilterFunc> _bitmap_filter_func;
     bool _is_bloomfilter = false;
     bool _is_ignored_in_filter = false;
     std::string* _ignored_in_filter_msg = nullptr;
@@ -1024,6 +1070,8 @@ Status IRuntimeFilter::init_with_desc(const TRuntimeFilterDesc* desc, const TQue
         _runtime_filter_type = RuntimeFilterType::IN_FILTER;
     } else if (desc->type == TRuntimeFilterType::IN_OR_BLOOM) {
         _runtime_filter_type = RuntimeFilterType::IN_OR_BLOOM_FILTER;
+    } else if (desc->type == TRuntimeFilterType::BITMAP) {
+        _runtime_filter_type = RuntimeFilterType::BITMAP_FILTER;
     } else {
         return Status::InvalidArgument("unknown filter type");
     }
@@ -1108,6 +1156,10 @@ Status IRuntimeFilter::_create_wrapper(const T* param, ObjectPool* pool,
         DCHECK(param->request->has_minmax_filter());
         return (*wrapper)->assign(&param->request->minmax_filter());
     }
+    case PFilterType::BITMAP_FILTER: {
+        DCHECK(param->request->has_bitmap_filter());
+        return (*wrapper)->assign(&param->request->bitmap_filter(), param->data);
+    }
     default:
         return Status::InvalidArgument("unknown filter type");
     }
@@ -1196,6 +1248,9 @@ Status IRuntimeFilter::serialize_impl(T* request, void** data, int* len) {
     } else if (real_runtime_filter_type == RuntimeFilterType::MINMAX_FILTER) {
         auto minmax_filter = request->mutable_minmax_filter();
         to_protobuf(minmax_filter);
+    } else if (real_runtime_filter_type == RuntimeFilterType::BITMAP_FILTER) {
+        RETURN_IF_ERROR(_wrapper->get_bitmap_filter_desc((char**)data, len));
+        request->mutable_bitmap_filter()->set_filter_length(*len);
     } else {
         return Status::InvalidArgument("not implemented !");
     }
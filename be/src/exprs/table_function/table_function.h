@@ -74,6 +74,28 @@ public:
         return Status::OK();
     }
 
+    // only used for vectorized.
+    // Append the values of the current row from the cursor to `column`, at most `max_step` of
+    // them, and forward the cursor past them. `*step` is the number of the values appended, the
+    // result of an empty row is a single null. It's the batch version of get_value and forward,
+    // the functions override it to append the values without the per value virtual calls.
+    virtual Status get_values(vectorized::IColumn* column, int64_t max_step, int64_t* step) {
+        bool eos = _eos;
+        for (*step = 0; *step < max_step && !eos; ++*step) {
+            void* value = nullptr;
+            int64_t length = -1;
+            RETURN_IF_ERROR(get_value(&value));
+            RETURN_IF_ERROR(get_value_length(&length));
+            if (value == nullptr) {
+                column->insert_default();
+            } else {
+                column->insert_data(reinterpret_cast<char*>(value), length);
+            }
+            RETURN_IF_ERROR(forward(&eos));
+        }
+        return Status::OK();
+    }
+
     virtual Status close() { return Status::OK(); }
 
     virtual Status forward(bool* eos) {
@@ -240,6 +240,9 @@ void GeoFunctions::st_contains_prepare(doris_udf::FunctionContext* ctx,
                         std::shared_ptr<GeoShape>(GeoShape::from_encoded(str->ptr, str->len));
                 if (contains_ctx->shapes[i] == nullptr) {
                     contains_ctx->is_null = true;
+                } else if (i == 0 && contains_ctx->shapes[i]->type() == GEO_SHAPE_POLYGON) {
+                    // the constant polygon is tested against the points of all the rows
+                    static_cast<GeoPolygon*>(contains_ctx->shapes[i].get())->build_covering();
                 }
             }
         }
@@ -19,10 +19,13 @@
 
 #include <s2/s2cap.h>
 #include <s2/s2cell.h>
+#include <s2/s2cell_id.h>
+#include <s2/s2cell_union.h>
 #include <s2/s2earth.h>
 #include <s2/s2latlng.h>
 #include <s2/s2polygon.h>
 #include <s2/s2polyline.h>
+#include <s2/s2region_coverer.h>
 #include <s2/util/coding/coder.h>
 #include <s2/util/units/length-units.h>
 #include <stdio.h>
@@ -303,6 +306,8 @@ void GeoPolygon::encode(std::string* buf) {
 bool GeoPolygon::decode(const void* data, size_t size) {
     Decoder decoder(data, size);
     _polygon.reset(new S2Polygon());
+    _covering.reset();
+    _interior_covering.reset();
     return _polygon->Decode(&decoder);
 }
 
@@ -343,10 +348,35 @@ std::string GeoPolygon::as_wkt() const {
     return ss.str();
 }
 
+// The number of the cells of each covering, the more cells the less points on the boundary cells
+// need the exact test, but the more cells to search for each point.
+static constexpr int kPolygonCoveringMaxCells = 128;
+
+void GeoPolygon::build_covering() {
+    S2RegionCoverer::Options options;
+    options.set_max_cells(kPolygonCoveringMaxCells);
+    S2RegionCoverer coverer(options);
+    std::vector<S2CellId> cell_ids;
+    coverer.GetCovering(*_polygon, &cell_ids);
+    _covering.reset(new S2CellUnion(std::move(cell_ids)));
+    cell_ids.clear();
+    coverer.GetInteriorCovering(*_polygon, &cell_ids);
+    _interior_covering.reset(new S2CellUnion(std::move(cell_ids)));
+}
+
 bool GeoPolygon::contains(const GeoShape* rhs) const {
     switch (rhs->type()) {
     case GEO_SHAPE_POINT: {
         const GeoPoint* point = (const GeoPoint*)rhs;
+        if (_covering != nullptr) {
+            S2CellId cell_id(*point->point());
+            if (!_covering->Contains(cell_id)) {
+                return false;
+            }
+            if (_interior_covering->Contains(cell_id)) {
+                return true;
+            }
+        }
         return _polygon->Contains(*point->point());
     }
     case GEO_SHAPE_LINE_STRING: {
@@ -27,6 +27,7 @@
 class S2Polyline;
 class S2Polygon;
 class S2Cap;
+class S2CellUnion;
 
 template <typename T>
 class Vector3;
@@ -123,12 +124,21 @@ public:
     bool contains(const GeoShape* rhs) const override;
     std::string as_wkt() const override;
 
+    // Build the cell coverings of the polygon, after which contains() tests the points against
+    // the cells first, and only the points in the cells crossing the boundary are tested
+    // exactly. It pays off when the polygon is tested against many points.
+    void build_covering();
+
 protected:
     void encode(std::string* buf) override;
     bool decode(const void* data, size_t size) override;
 
 private:
     std::unique_ptr<S2Polygon> _polygon;
+    // the cells covering the polygon, a point out of them is not in the polygon
+    std::unique_ptr<S2CellUnion> _covering;
+    // the cells inside the polygon, a point in them is in the polygon
+    std::unique_ptr<S2CellUnion> _interior_covering;
 };
 
 class GeoCircle : public GeoShape {
@@ -15,6 +15,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <cmath>
 #include <limits>
 using std::numeric_limits;
 #include <string>
@@ -1270,8 +1271,107 @@ int FloatToBuffer(float value, int width, char* buffer) {
     return snprintf_result;
 }
 
+// Write the output of "%.<precision>g" of value, by laying out the shortest round-trip digits
+// of value (by the Dragonbox algorithm of fmt). If the shortest digits are not longer than the
+// precision, rounding value to the precision gets the same digits, because the gap between
+// two decimals of the precision is much wider than the gap between two floating point values.
+// Return nullptr if the shortest digits are longer than the precision, which means the output
+// of "%.<precision>g" doesn't round-trip, or value is not a normal number (the gap between two
+// subnormal values is too wide).
+template <typename T>
+static char* ShortestToGeneralFormat(T value, int precision, char* buffer) {
+    if (!std::isnormal(value)) {
+        return nullptr;
+    }
+    char shortest[64];
+    char* end = fmt::format_to(shortest, "{}", value);
+    *end = '\0';
+    const char* p = shortest;
+    const bool negative = *p == '-';
+    p += negative;
+
+    // value is 0.<digits> * 10^exponent
+    char digits[32];
+    int num_digits = 0;
+    int exponent = 0;
+    bool before_point = true;
+    for (; p < end && *p != 'e'; ++p) {
+        if (*p == '.') {
+            before_point = false;
+        } else if (*p >= '0' && *p <= '9') {
+            if (num_digits == 0 && *p == '0') {
+                // skip the leading zeros
+                exponent -= !before_point;
+            } else {
+                if (num_digits == sizeof(digits)) {
+                    return nullptr;
+                }
+                digits[num_digits++] = *p;
+                exponent += before_point;
+            }
+        } else {
+            return nullptr;
+        }
+    }
+    if (p < end) {
+        exponent += strtol(p + 1, nullptr, 10);
+    }
+    while (num_digits > 0 && digits[num_digits - 1] == '0') {
+        --num_digits;
+    }
+    if (num_digits == 0 || num_digits > precision) {
+        return nullptr;
+    }
+
+    // the exponent of the scientific notation, d.ddd * 10^sci_exponent
+    const int sci_exponent = exponent - 1;
+    char* out = buffer;
+    if (negative) {
+        *out++ = '-';
+    }
+    if (sci_exponent < -4 || sci_exponent >= precision) {
+        *out++ = digits[0];
+        if (num_digits > 1) {
+            *out++ = '.';
+            memcpy(out, digits + 1, num_digits - 1);
+            out += num_digits - 1;
+        }
+        *out++ = 'e';
+        *out++ = sci_exponent < 0 ? '-' : '+';
+        const int abs_exponent = sci_exponent < 0 ? -sci_exponent : sci_exponent;
+        if (abs_exponent < 10) {
+            *out++ = '0';
+        }
+        out = fmt::format_to(out, "{}", abs_exponent);
+    } else if (exponent <= 0) {
+        *out++ = '0';
+        *out++ = '.';
+        memset(out, '0', -exponent);
+        out += -exponent;
+        memcpy(out, digits, num_digits);
+        out += num_digits;
+    } else if (num_digits <= exponent) {
+        memcpy(out, digits, num_digits);
+        out += num_digits;
+        memset(out, '0', exponent - num_digits);
+        out += exponent - num_digits;
+    } else {
+        memcpy(out, digits, exponent);
+        out += exponent;
+        *out++ = '.';
+        memcpy(out, digits + exponent, num_digits - exponent);
+        out += num_digits - exponent;
+    }
+    return out;
+}
+
 int FastDoubleToBuffer(double value, char* buffer) {
-    auto end = fmt::format_to(buffer, "{:.15g}", value);
+    char* end = ShortestToGeneralFormat(value, 15, buffer);
+    if (end != nullptr) {
+        *end = '\0';
+        return end - buffer;
+    }
+    end = fmt::format_to(buffer, "{:.15g}", value);
     *end = '\0';
     if (strtod(buffer, nullptr) != value) {
         end = fmt::format_to(buffer, "{:.17g}", value);
@@ -1280,7 +1380,12 @@ int FastDoubleToBuffer(double value, char* buffer) {
 }
 
 int FastFloatToBuffer(float value, char* buffer) {
-    auto end = fmt::format_to(buffer, "{:.6g}", value);
+    char* end = ShortestToGeneralFormat(value, 6, buffer);
+    if (end != nullptr) {
+        *end = '\0';
+        return end - buffer;
+    }
+    end = fmt::format_to(buffer, "{:.6g}", value);
     *end = '\0';
 #ifdef _MSC_VER // has no strtof()
     if (strtod(buffer, nullptr) != value) {
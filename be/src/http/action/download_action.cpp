@@ -17,9 +17,11 @@
 
 #include "http/action/download_action.h"
 
+#include <fcntl.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <memory>
 #include <sstream>
 #include <string>
 
@@ -33,6 +35,8 @@
 #include "http/utils.h"
 #include "runtime/exec_env.h"
 #include "util/file_utils.h"
+#include "util/crc32c.h"
+#include "util/error_util.h"
 #include "util/filesystem_util.h"
 #include "util/path_util.h"
 
@@ -42,6 +46,33 @@ const std::string FILE_PARAMETER = "file";
 const std::string DB_PARAMETER = "db";
 const std::string LABEL_PARAMETER = "label";
 const std::string TOKEN_PARAMETER = "token";
+const std::string CHECKSUM_PARAMETER = "checksum";
+
+// Reply the crc32c of the file instead of the file, for the clones to verify the downloaded
+// files with the crc32c they compute while downloading.
+static void do_file_checksum_response(const std::string& file_path, HttpRequest* req) {
+    int fd = open(file_path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG(WARNING) << "Failed to open file: " << file_path;
+        HttpChannel::send_error(req, HttpStatus::NOT_FOUND);
+        return;
+    }
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    constexpr size_t kBufferSize = 1024 * 1024;
+    std::unique_ptr<char[]> buf(new char[kBufferSize]);
+    uint32_t crc = 0;
+    ssize_t n = 0;
+    while ((n = read(fd, buf.get(), kBufferSize)) > 0) {
+        crc = crc32c::Extend(crc, buf.get(), n);
+    }
+    close(fd);
+    if (n < 0) {
+        LOG(WARNING) << "Failed to read file: " << file_path << ", " << get_str_err_msg();
+        HttpChannel::send_error(req, HttpStatus::INTERNAL_SERVER_ERROR);
+        return;
+    }
+    HttpChannel::send_reply(req, std::to_string(crc));
+}
 
 DownloadAction::DownloadAction(ExecEnv* exec_env, const std::vector<std::string>& allow_dirs)
         : _exec_env(exec_env), _download_type(NORMAL) {
@@ -79,6 +110,8 @@ void DownloadAction::handle_normal(HttpRequest* req, const std::string& file_par
 
     if (FileUtils::is_dir(file_param)) {
         do_dir_response(file_param, req);
+    } else if (req->param(CHECKSUM_PARAMETER) == "crc32c") {
+        do_file_checksum_response(file_param, req);
     } else {
         do_file_response(file_param, req);
     }
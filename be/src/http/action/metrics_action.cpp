@@ -24,12 +24,14 @@
 
 #include <string>
 
+#include "common/config.h"
 #include "http/http_channel.h"
 #include "http/http_headers.h"
 #include "http/http_request.h"
 #include "http/http_response.h"
 #include "runtime/exec_env.h"
 #include "util/metrics.h"
+#include "util/time.h"
 
 namespace doris {
 
@@ -37,12 +39,22 @@ void MetricsAction::handle(HttpRequest* req) {
     const std::string& type = req->param("type");
     const std::string& with_tablet = req->param("with_tablet");
     std::string str;
-    if (type == "core") {
-        str = _metric_registry->to_core_string();
-    } else if (type == "json") {
-        str = _metric_registry->to_json(with_tablet == "true");
-    } else {
-        str = _metric_registry->to_prometheus(with_tablet == "true");
+    {
+        std::lock_guard<std::mutex> l(_cache_lock);
+        RenderedMetrics& rendered = _cache[type + "/" + with_tablet];
+        int64_t now_ms = MonotonicMillis();
+        if (rendered.render_time_ms == 0 ||
+            now_ms - rendered.render_time_ms >= config::metrics_render_cache_ms) {
+            if (type == "core") {
+                rendered.text = _metric_registry->to_core_string();
+            } else if (type == "json") {
+                rendered.text = _metric_registry->to_json(with_tablet == "true");
+            } else {
+                rendered.text = _metric_registry->to_prometheus(with_tablet == "true");
+            }
+            rendered.render_time_ms = now_ms;
+        }
+        str = rendered.text;
     }
 
     req->add_output_header(HttpHeaders::CONTENT_TYPE, "text/plain; version=0.0.4");
@@ -17,6 +17,10 @@
 
 #pragma once
 
+#include <map>
+#include <mutex>
+#include <string>
+
 #include "http/http_handler.h"
 
 namespace doris {
@@ -34,7 +38,16 @@ public:
     void handle(HttpRequest* req) override;
 
 private:
+    struct RenderedMetrics {
+        int64_t render_time_ms = 0;
+        std::string text;
+    };
+
     MetricRegistry* _metric_registry;
+    // the concurrent scrapes wait for one rendering instead of rendering by themselves
+    std::mutex _cache_lock;
+    // the latest rendering of each output format, see config::metrics_render_cache_ms
+    std::map<std::string, RenderedMetrics> _cache;
 };
 
 } // namespace doris
@@ -40,6 +40,7 @@
 #include "util/bfd_parser.h"
 #include "util/file_utils.h"
 #include "util/pprof_utils.h"
+#include "util/sampling_profiler.h"
 
 namespace doris {
 
@@ -150,9 +151,12 @@ void ProfileAction::handle(HttpRequest* req) {
         std::ostringstream tmp_prof_file_name;
         tmp_prof_file_name << config::pprof_profile_dir << "/doris_profile." << getpid() << "."
                            << rand();
+        // the cpu profiler of gperftools also samples by SIGPROF
+        SamplingProfiler::instance()->suspend();
         ProfilerStart(tmp_prof_file_name.str().c_str());
         sleep(seconds);
         ProfilerStop();
+        SamplingProfiler::instance()->resume();
 
         if (type_str != "text") {
             // return raw content via http response directly
@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "http/action/query_replay_action.h"
+
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "common/config.h"
+#include "gutil/strings/substitute.h"
+#include "http/http_channel.h"
+#include "http/http_headers.h"
+#include "http/http_request.h"
+#include "http/http_status.h"
+#include "runtime/exec_env.h"
+#include "runtime/fragment_mgr.h"
+#include "runtime/query_replayer.h"
+
+namespace doris {
+
+static const std::string QUERY_ID_KEY = "query_id";
+static const std::string BASELINE_KEY = "baseline";
+
+void QueryReplayAction::handle(HttpRequest* req) {
+    const std::string& query_id = req->param(QUERY_ID_KEY);
+    if (query_id.empty()) {
+        HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST, "query_id is required");
+        return;
+    }
+    std::string baseline;
+    const std::string& baseline_path = req->param(BASELINE_KEY);
+    if (!baseline_path.empty()) {
+        std::ifstream file(baseline_path);
+        std::stringstream buf;
+        buf << file.rdbuf();
+        if (file.fail()) {
+            HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST,
+                                    strings::Substitute("failed to read $0", baseline_path));
+            return;
+        }
+        baseline = buf.str();
+    }
+
+    std::string profile;
+    Status st = _exec_env->fragment_mgr()->query_replayer()->replay(query_id, &profile);
+    if (!st.ok()) {
+        HttpChannel::send_reply(req, HttpStatus::INTERNAL_SERVER_ERROR, st.to_string());
+        return;
+    }
+
+    std::string path = strings::Substitute("$0/$1/replay_$2.profile", config::query_capture_dir,
+                                           query_id, time(nullptr));
+    std::ofstream file(path, std::ios::trunc);
+    file << profile;
+    file.close();
+    std::string result = file.fail() ? strings::Substitute("# failed to save to $0\n", path)
+                                     : strings::Substitute("# saved to $0\n", path);
+    result.append(profile);
+    if (!baseline_path.empty()) {
+        result.append(strings::Substitute("# the changes from $0\n", baseline_path));
+        QueryReplayer::diff_profiles(baseline, profile, &result);
+    }
+    req->add_output_header(HttpHeaders::CONTENT_TYPE, "text/plain; charset=utf-8");
+    HttpChannel::send_reply(req, HttpStatus::OK, result);
+}
+
+} // namespace doris
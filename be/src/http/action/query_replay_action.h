@@ -0,0 +1,44 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "http/http_handler.h"
+
+namespace doris {
+
+class ExecEnv;
+class HttpRequest;
+
+// Replay a query captured by enable_query_capture on this backend, see QueryReplayer.
+//   POST /api/query_replay?query_id=<query id>&baseline=<profile file>
+// The counters of the operators are returned, and saved in the capture dir of the query. If
+// baseline is the profile file saved by an earlier replay, e.g. by another build, the counters
+// which differ from the baseline are returned too.
+class QueryReplayAction : public HttpHandler {
+public:
+    explicit QueryReplayAction(ExecEnv* exec_env) : _exec_env(exec_env) {}
+    ~QueryReplayAction() override = default;
+
+    void handle(HttpRequest* req) override;
+
+private:
+    ExecEnv* _exec_env;
+};
+
+} // namespace doris
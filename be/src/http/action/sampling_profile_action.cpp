@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "http/action/sampling_profile_action.h"
+
+#include <ctime>
+#include <string>
+
+#include "gutil/strings/numbers.h"
+#include "gutil/strings/substitute.h"
+#include "http/http_channel.h"
+#include "http/http_headers.h"
+#include "http/http_request.h"
+#include "http/http_status.h"
+#include "util/sampling_profiler.h"
+
+namespace doris {
+
+static const std::string START_KEY = "start";
+static const std::string END_KEY = "end";
+static const std::string TASK_ID_KEY = "task_id";
+static const int64_t kDefaultRangeSecs = 60;
+
+void SamplingProfileAction::handle(HttpRequest* req) {
+    SamplingProfiler* profiler = SamplingProfiler::instance();
+    if (!profiler->is_running()) {
+        HttpChannel::send_reply(req, HttpStatus::SERVICE_UNAVAILABLE,
+                                "the sampling profiler is not running, see "
+                                "enable_sampling_profiler in be.conf");
+        return;
+    }
+
+    int64_t end_sec = time(nullptr);
+    const std::string& end_str = req->param(END_KEY);
+    if (!end_str.empty() && !safe_strto64(end_str, &end_sec)) {
+        HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST,
+                                strings::Substitute("invalid end: $0", end_str));
+        return;
+    }
+    int64_t start_sec = end_sec - kDefaultRangeSecs;
+    const std::string& start_str = req->param(START_KEY);
+    if (!start_str.empty() && !safe_strto64(start_str, &start_sec)) {
+        HttpChannel::send_reply(req, HttpStatus::BAD_REQUEST,
+                                strings::Substitute("invalid start: $0", start_str));
+        return;
+    }
+
+    std::string result;
+    profiler->get_folded_stacks(start_sec, end_sec, req->param(TASK_ID_KEY), &result);
+    req->add_output_header(HttpHeaders::CONTENT_TYPE, "text/plain; charset=utf-8");
+    HttpChannel::send_reply(req, HttpStatus::OK, result);
+}
+
+} // namespace doris
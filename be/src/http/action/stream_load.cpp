@@ -20,6 +20,7 @@
 #include <deque>
 #include <future>
 #include <sstream>
+#include <vector>
 
 // use string iequal
 #include <event2/buffer.h>
@@ -43,6 +44,7 @@
 #include "runtime/client_cache.h"
 #include "runtime/exec_env.h"
 #include "runtime/fragment_mgr.h"
+#include "runtime/group_commit_mgr.h"
 #include "runtime/load_path_mgr.h"
 #include "runtime/plan_fragment_executor.h"
 #include "runtime/stream_load/load_stream_mgr.h"
@@ -156,6 +158,9 @@ void StreamLoadAction::handle(HttpRequest* req) {
         if (ctx->body_sink.get() != nullptr) {
             ctx->body_sink->cancel(ctx->status.get_error_msg());
         }
+        if (ctx->group_commit) {
+            _exec_env->group_commit_mgr()->abort(ctx);
+        }
     }
 
     auto str = ctx->to_json();
@@ -181,6 +186,12 @@ Status StreamLoadAction::_handle(StreamLoadContext* ctx) {
                      << ", receive_bytes=" << ctx->receive_bytes << ", id=" << ctx->id;
         return Status::InternalError("receive body don't equal with body bytes");
     }
+    if (ctx->group_commit) {
+        // the load is acknowledged once its body is synced to the wal
+        RETURN_IF_ERROR(ctx->body_sink->finish());
+        ctx->body_sink.reset();
+        return _exec_env->group_commit_mgr()->commit_wal(ctx);
+    }
     if (!ctx->use_streaming) {
         // if we use non-streaming, we need to close file first,
         // then execute_plan_fragment here
@@ -225,6 +236,7 @@ int StreamLoadAction::on_header(HttpRequest* req) {
     }
 
     ctx->two_phase_commit = req->header(HTTP_TWO_PHASE_COMMIT) == "true" ? true : false;
+    ctx->group_commit = boost::iequals(req->header(HTTP_GROUP_COMMIT), "true");
 
     LOG(INFO) << "new income streaming load request." << ctx->brief() << ", db=" << ctx->db
               << ", tbl=" << ctx->table;
@@ -239,6 +251,9 @@ int StreamLoadAction::on_header(HttpRequest* req) {
         if (ctx->body_sink.get() != nullptr) {
             ctx->body_sink->cancel(st.get_error_msg());
         }
+        if (ctx->group_commit) {
+            _exec_env->group_commit_mgr()->abort(ctx);
+        }
         auto str = ctx->to_json();
         // add new line at end
         str = str + '\n';
@@ -328,6 +343,10 @@ Status StreamLoadAction::_on_header(HttpRequest* http_req, StreamLoadContext* ct
         }
     }
 
+    if (ctx->group_commit) {
+        return _process_group_commit_put(http_req, ctx);
+    }
+
     // begin transaction
     int64_t begin_txn_start_time = MonotonicNanos();
     RETURN_IF_ERROR(_exec_env->stream_load_executor()->begin_txn(ctx));
@@ -347,23 +366,36 @@ void StreamLoadAction::on_chunk_data(HttpRequest* req) {
     auto evbuf = evhttp_request_get_input_buffer(ev_req);
 
     int64_t start_read_data_time = MonotonicNanos();
-    while (evbuffer_get_length(evbuf) > 0) {
-        auto bb = ByteBuffer::allocate(4096);
-        auto remove_bytes = evbuffer_remove(evbuf, bb->ptr, bb->capacity);
-        bb->pos = remove_bytes;
-        bb->flip();
-        auto st = ctx->body_sink->append(bb);
-        if (!st.ok()) {
-            LOG(WARNING) << "append body content failed. errmsg=" << st.get_error_msg() << ", "
-                         << ctx->brief();
-            ctx->status = st;
-            return;
-        }
-        ctx->receive_bytes += remove_bytes;
+    auto st = _append_body(evbuf, ctx->body_sink.get(), &ctx->receive_bytes);
+    if (!st.ok()) {
+        LOG(WARNING) << "append body content failed. errmsg=" << st.get_error_msg() << ", "
+                     << ctx->brief();
+        ctx->status = st;
+        return;
     }
     ctx->read_data_cost_nanos += (MonotonicNanos() - start_read_data_time);
 }
 
+Status StreamLoadAction::_append_body(evbuffer* evbuf, MessageBodySink* body_sink,
+                                      size_t* receive_bytes) {
+    if (evbuffer_get_length(evbuf) == 0) {
+        return Status::OK();
+    }
+    // Move the received chains out of the input buffer without copying them, and hand their
+    // segments to the sink, which keep the chains alive until the last segment is consumed.
+    std::shared_ptr<evbuffer> chains(evbuffer_new(), evbuffer_free);
+    evbuffer_add_buffer(chains.get(), evbuf);
+    int num_segments = evbuffer_peek(chains.get(), -1, nullptr, nullptr, 0);
+    std::vector<evbuffer_iovec> segments(num_segments);
+    evbuffer_peek(chains.get(), -1, nullptr, segments.data(), num_segments);
+    for (const auto& segment : segments) {
+        RETURN_IF_ERROR(body_sink->append(ByteBuffer::wrap(static_cast<char*>(segment.iov_base),
+                                                           segment.iov_len, chains)));
+        *receive_bytes += segment.iov_len;
+    }
+    return Status::OK();
+}
+
 void StreamLoadAction::free_handler_ctx(void* param) {
     StreamLoadContext* ctx = (StreamLoadContext*)param;
     if (ctx == nullptr) {
@@ -373,39 +405,22 @@ void StreamLoadAction::free_handler_ctx(void* param) {
     if (ctx->body_sink != nullptr) {
         ctx->body_sink->cancel("sender is gone");
     }
+    if (ctx->group_commit) {
+        _exec_env->group_commit_mgr()->abort(ctx);
+    }
     if (ctx->unref()) {
         delete ctx;
     }
 }
 
-Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext* ctx) {
-    // Now we use stream
-    ctx->use_streaming = is_format_support_streaming(ctx->format);
-
-    // put request
-    TStreamLoadPutRequest request;
+Status StreamLoadAction::_build_put_request(HttpRequest* http_req, StreamLoadContext* ctx,
+                                            TStreamLoadPutRequest* put_request) {
+    TStreamLoadPutRequest& request = *put_request;
     set_request_auth(&request, ctx->auth);
     request.db = ctx->db;
     request.tbl = ctx->table;
-    request.txnId = ctx->txn_id;
     request.formatType = ctx->format;
     request.__set_header_type(ctx->header_type);
-    request.__set_loadId(ctx->id.to_thrift());
-    if (ctx->use_streaming) {
-        auto pipe = std::make_shared<StreamLoadPipe>(1024 * 1024 /* max_buffered_bytes */,
-                                                     64 * 1024 /* min_chunk_size */,
-                                                     ctx->body_bytes /* total_length */);
-        RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(ctx->id, pipe));
-        request.fileType = TFileType::FILE_STREAM;
-        ctx->body_sink = pipe;
-    } else {
-        RETURN_IF_ERROR(_data_saved_path(http_req, &request.path));
-        auto file_sink = std::make_shared<MessageBodyFileSink>(request.path);
-        RETURN_IF_ERROR(file_sink->open());
-        request.__isset.path = true;
-        request.fileType = TFileType::FILE_LOCAL;
-        ctx->body_sink = file_sink;
-    }
     if (!http_req->header(HTTP_COLUMNS).empty()) {
         request.__set_columns(http_req->header(HTTP_COLUMNS));
     }
@@ -556,6 +571,33 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
         ctx->max_filter_ratio = strtod(http_req->header(HTTP_MAX_FILTER_RATIO).c_str(), nullptr);
         request.__set_max_filter_ratio(ctx->max_filter_ratio);
     }
+    return Status::OK();
+}
+
+Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext* ctx) {
+    // Now we use stream
+    ctx->use_streaming = is_format_support_streaming(ctx->format);
+
+    // put request
+    TStreamLoadPutRequest request;
+    RETURN_IF_ERROR(_build_put_request(http_req, ctx, &request));
+    request.txnId = ctx->txn_id;
+    request.__set_loadId(ctx->id.to_thrift());
+    if (ctx->use_streaming) {
+        auto pipe = std::make_shared<StreamLoadPipe>(
+                config::stream_load_pipe_buffer_bytes /* max_buffered_bytes */,
+                64 * 1024 /* min_chunk_size */, ctx->body_bytes /* total_length */);
+        RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(ctx->id, pipe));
+        request.fileType = TFileType::FILE_STREAM;
+        ctx->body_sink = pipe;
+    } else {
+        RETURN_IF_ERROR(_data_saved_path(http_req, &request.path));
+        auto file_sink = std::make_shared<MessageBodyFileSink>(request.path);
+        RETURN_IF_ERROR(file_sink->open());
+        request.__isset.path = true;
+        request.fileType = TFileType::FILE_LOCAL;
+        ctx->body_sink = file_sink;
+    }
 
 #ifndef BE_TEST
     // plan this load
@@ -586,6 +628,34 @@ Status StreamLoadAction::_process_put(HttpRequest* http_req, StreamLoadContext*
     return _exec_env->stream_load_executor()->execute_plan_fragment(ctx);
 }
 
+Status StreamLoadAction::_process_group_commit_put(HttpRequest* http_req,
+                                                    StreamLoadContext* ctx) {
+    // the bodies of the loads in a batch are concatenated, so they must be plain csv lines
+    if (ctx->format != TFileFormatType::FORMAT_CSV_PLAIN || !ctx->header_type.empty() ||
+        !http_req->header(HTTP_LINE_DELIMITER).empty()) {
+        return Status::InvalidArgument(
+                "group commit only supports plain csv with the default line delimiter");
+    }
+    if (ctx->two_phase_commit) {
+        return Status::InvalidArgument("group commit can't be used with two phase commit");
+    }
+    if (!http_req->header(HTTP_LABEL_KEY).empty()) {
+        return Status::InvalidArgument(
+                "group commit can't be used with a label, the load is labeled by its batch");
+    }
+    if (http_req->header(HttpHeaders::CONTENT_LENGTH).empty() ||
+        ctx->body_bytes > config::group_commit_data_bytes) {
+        std::stringstream ss;
+        ss << "group commit requires a content length not larger than "
+           << config::group_commit_data_bytes;
+        return Status::InvalidArgument(ss.str());
+    }
+
+    TStreamLoadPutRequest request;
+    RETURN_IF_ERROR(_build_put_request(http_req, ctx, &request));
+    return _exec_env->group_commit_mgr()->join(ctx, request);
+}
+
 Status StreamLoadAction::_data_saved_path(HttpRequest* req, std::string* file_path) {
     std::string prefix;
     RETURN_IF_ERROR(_exec_env->load_path_mgr()->allocate_dir(req->param(HTTP_DB_KEY), "", &prefix));
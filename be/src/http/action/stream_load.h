@@ -24,11 +24,14 @@
 #include "runtime/client_cache.h"
 #include "runtime/message_body_sink.h"
 
+struct evbuffer;
+
 namespace doris {
 
 class ExecEnv;
 class Status;
 class StreamLoadContext;
+class TStreamLoadPutRequest;
 
 class StreamLoadAction : public HttpHandler {
 public:
@@ -50,6 +53,14 @@ private:
     Status _data_saved_path(HttpRequest* req, std::string* file_path);
     Status _execute_plan_fragment(StreamLoadContext* ctx);
     Status _process_put(HttpRequest* http_req, StreamLoadContext* ctx);
+    // build the put request from the headers, without the txn and the file of the body
+    Status _build_put_request(HttpRequest* http_req, StreamLoadContext* ctx,
+                              TStreamLoadPutRequest* put_request);
+    // join the load to an open group commit batch of its table instead of its own txn
+    Status _process_group_commit_put(HttpRequest* http_req, StreamLoadContext* ctx);
+    // hand the received body in `evbuf` to the sink without copying it
+    static Status _append_body(evbuffer* evbuf, MessageBodySink* body_sink,
+                               size_t* receive_bytes);
     void _sava_stream_load_record(StreamLoadContext* ctx, const std::string& str);
 
 private:
@@ -19,6 +19,7 @@
 
 #include <event2/buffer.h>
 #include <event2/http.h>
+#include <fcntl.h>
 
 #include <mutex>
 #include <sstream>
@@ -67,6 +68,9 @@ void HttpChannel::send_reply(HttpRequest* request, HttpStatus status, const std:
 }
 
 void HttpChannel::send_file(HttpRequest* request, int fd, size_t off, size_t size) {
+    // the file is sent to the socket by sendfile() without being copied into the user space,
+    // let the kernel read ahead aggressively for the sequential read
+    posix_fadvise(fd, off, size, POSIX_FADV_SEQUENTIAL);
     auto evb = evbuffer_new();
     evbuffer_add_file(evb, fd, off, size);
     evhttp_send_reply(request->get_evhttp_request(), HttpStatus::OK,
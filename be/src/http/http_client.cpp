@@ -18,6 +18,8 @@
 #include "http/http_client.h"
 
 #include "common/config.h"
+#include "util/crc32c.h"
+#include "util/rate_limiter.h"
 
 namespace doris {
 
@@ -168,7 +170,8 @@ Status HttpClient::execute(const std::function<bool(const void* data, size_t len
     return Status::OK();
 }
 
-Status HttpClient::download(const std::string& local_path) {
+Status HttpClient::download(const std::string& local_path, RateLimiter* limiter,
+                            uint32_t* crc32c) {
     // set method to GET
     set_method(GET);
 
@@ -185,7 +188,15 @@ Status HttpClient::download(const std::string& local_path) {
         return Status::InternalError("open file failed");
     }
     Status status;
-    auto callback = [&status, &fp, &local_path](const void* data, size_t length) {
+    uint32_t crc = 0;
+    auto callback = [&status, &fp, &local_path, limiter, crc32c, &crc](const void* data,
+                                                                      size_t length) {
+        if (limiter != nullptr) {
+            limiter->acquire(length);
+        }
+        if (crc32c != nullptr) {
+            crc = crc32c::Extend(crc, static_cast<const char*>(data), length);
+        }
         auto res = fwrite(data, length, 1, fp.get());
         if (res != 1) {
             LOG(WARNING) << "fail to write data to file, file=" << local_path
@@ -196,6 +207,9 @@ Status HttpClient::download(const std::string& local_path) {
         return true;
     };
     RETURN_IF_ERROR(execute(callback));
+    if (crc32c != nullptr) {
+        *crc32c = crc;
+    }
     return status;
 }
 
@@ -29,6 +29,8 @@
 #include "http/utils.h"
 namespace doris {
 
+class RateLimiter;
+
 // Helper class to access HTTP resource
 class HttpClient {
 public:
@@ -123,7 +125,14 @@ public:
 
     // helper function to download a file, you can call this function to download
     // a file to local_path
-    Status download(const std::string& local_path);
+    Status download(const std::string& local_path) {
+        return download(local_path, nullptr, nullptr);
+    }
+
+    // download a file to local_path, the writes to the file are limited by `limiter` if it's not
+    // null, and the crc32c of the file is computed from the received data to `crc32c` if it's not
+    // null, without reading the file again.
+    Status download(const std::string& local_path, RateLimiter* limiter, uint32_t* crc32c);
 
     Status execute_post_request(const std::string& payload, std::string* response);
 
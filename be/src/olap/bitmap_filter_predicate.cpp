@@ -0,0 +1,38 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/bitmap_filter_predicate.h"
+
+namespace doris {
+
+ColumnPredicate* BitmapFilterColumnPredicateFactory::create_column_predicate(
+        uint32_t column_id, const std::shared_ptr<BitmapFilterFunc>& filter, FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_TINYINT:
+        return new BitmapFilterColumnPredicate<TYPE_TINYINT>(column_id, filter);
+    case OLAP_FIELD_TYPE_SMALLINT:
+        return new BitmapFilterColumnPredicate<TYPE_SMALLINT>(column_id, filter);
+    case OLAP_FIELD_TYPE_INT:
+        return new BitmapFilterColumnPredicate<TYPE_INT>(column_id, filter);
+    case OLAP_FIELD_TYPE_BIGINT:
+        return new BitmapFilterColumnPredicate<TYPE_BIGINT>(column_id, filter);
+    default:
+        return nullptr;
+    }
+}
+
+} //namespace doris
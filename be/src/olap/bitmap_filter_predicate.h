@@ -0,0 +1,170 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <stdint.h>
+
+#include <roaring/roaring.hh>
+
+#include "common/config.h"
+#include "exprs/bitmapfilter_predicate.h"
+#include "olap/column_predicate.h"
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "runtime/vectorized_row_batch.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/predicate_column.h"
+
+namespace doris {
+
+// only use in runtime filter and segment v2, for the integer key columns
+template <PrimitiveType T>
+class BitmapFilterColumnPredicate : public ColumnPredicate {
+public:
+    using FT = typename PredicatePrimitiveTypeTraits<T>::PredicateFieldType;
+
+    BitmapFilterColumnPredicate(uint32_t column_id,
+                                const std::shared_ptr<BitmapFilterFunc>& filter)
+            : ColumnPredicate(column_id), _filter(filter), _bitmap(&filter->bitmap()) {}
+    ~BitmapFilterColumnPredicate() override = default;
+
+    PredicateType type() const override { return PredicateType::BITMAP_FILTER; }
+
+    void evaluate(VectorizedRowBatch* batch) const override;
+
+    void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
+
+    void evaluate_or(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                     bool* flags) const override {};
+    void evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                      bool* flags) const override {};
+
+    // a large filter is cheaper to evaluate on the rows than by a dictionary seek per value
+    bool can_do_bitmap_index_filter() const override {
+        return static_cast<int64_t>(_bitmap->cardinality()) <=
+               config::bitmap_filter_max_bitmap_index_seeks;
+    }
+
+    Status evaluate(const Schema& schema, const vector<BitmapIndexIterator*>& iterators,
+                    uint32_t num_rows, roaring::Roaring* roaring) const override;
+
+    void evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const override;
+
+private:
+    bool _find(FT value) const { return _bitmap->contains(static_cast<uint64_t>(value)); }
+
+    std::shared_ptr<BitmapFilterFunc> _filter;
+    const BitmapValue* _bitmap; // owned by _filter
+};
+
+// bitmap filter column predicate do not support in segment v1
+template <PrimitiveType T>
+void BitmapFilterColumnPredicate<T>::evaluate(VectorizedRowBatch* batch) const {
+    uint16_t n = batch->size();
+    uint16_t* sel = batch->selected();
+    if (!batch->selected_in_use()) {
+        for (uint16_t i = 0; i != n; ++i) {
+            sel[i] = i;
+        }
+    }
+}
+
+template <PrimitiveType T>
+void BitmapFilterColumnPredicate<T>::evaluate(ColumnBlock* block, uint16_t* sel,
+                                              uint16_t* size) const {
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        new_size += (!block->is_nullable() || !block->cell(idx).is_null()) &&
+                    _find(*reinterpret_cast<const FT*>(block->cell(idx).cell_ptr()));
+    }
+    *size = new_size;
+}
+
+template <PrimitiveType T>
+Status BitmapFilterColumnPredicate<T>::evaluate(const Schema& schema,
+                                                const vector<BitmapIndexIterator*>& iterators,
+                                                uint32_t num_rows,
+                                                roaring::Roaring* result) const {
+    BitmapIndexIterator* iterator = iterators[_column_id];
+    if (iterator == nullptr) {
+        return Status::OK();
+    }
+    if (iterator->has_null_bitmap()) {
+        roaring::Roaring null_bitmap;
+        RETURN_IF_ERROR(iterator->read_null_bitmap(&null_bitmap));
+        *result -= null_bitmap;
+    }
+    roaring::Roaring indices;
+    BitmapValueIterator end = _bitmap->end();
+    for (BitmapValueIterator it = _bitmap->begin(); it != end; ++it) {
+        FT value = static_cast<FT>(*it);
+        bool exact_match;
+        Status s = iterator->seek_dictionary(&value, &exact_match);
+        if (s.is_not_found()) {
+            continue;
+        }
+        RETURN_IF_ERROR(s);
+        if (exact_match) {
+            roaring::Roaring index;
+            RETURN_IF_ERROR(iterator->read_bitmap(iterator->current_ordinal(), &index));
+            indices |= index;
+        }
+    }
+    *result &= indices;
+    return Status::OK();
+}
+
+template <PrimitiveType T>
+void BitmapFilterColumnPredicate<T>::evaluate(vectorized::IColumn& column, uint16_t* sel,
+                                              uint16_t* size) const {
+    if (*size == 0) {
+        return;
+    }
+
+    const uint8_t* null_map = nullptr;
+    const vectorized::IColumn* nested_col = &column;
+    if (column.is_nullable()) {
+        auto* nullable_col = vectorized::check_and_get_column<vectorized::ColumnNullable>(column);
+        null_map = nullable_col->get_null_map_column().get_data().data();
+        nested_col = &nullable_col->get_nested_column();
+    }
+
+    // look up all the selected rows by batch, the null rows are looked up too and skipped later
+    uint8_t results[*size];
+    auto* pred_col =
+            vectorized::check_and_get_column<vectorized::PredicateColumnType<FT>>(*nested_col);
+    _filter->find_batch(pred_col->get_data().data(), sel, *size, results);
+
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; i++) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        new_size += (null_map == nullptr || !null_map[idx]) && results[i];
+    }
+    *size = new_size;
+}
+
+class BitmapFilterColumnPredicateFactory {
+public:
+    // return nullptr if the type of the column is not an integer type
+    static ColumnPredicate* create_column_predicate(
+            uint32_t column_id, const std::shared_ptr<BitmapFilterFunc>& filter, FieldType type);
+};
+
+} //namespace doris
@@ -51,6 +51,9 @@ public:
 
     PredicateType type() const override { return PredicateType::BF; }
 
+    // a bloom filter can't be applied on the bitmap index
+    bool can_do_bitmap_index_filter() const override { return false; }
+
     void evaluate(VectorizedRowBatch* batch) const override;
 
     void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
@@ -110,52 +113,42 @@ void BloomFilterColumnPredicate<T>::evaluate(ColumnBlock* block, uint16_t* sel,
 template <PrimitiveType T>
 void BloomFilterColumnPredicate<T>::evaluate(vectorized::IColumn& column, uint16_t* sel,
                                              uint16_t* size) const {
-    uint16_t new_size = 0;
     using FT = typename PredicatePrimitiveTypeTraits<T>::PredicateFieldType;
+    if (*size == 0) {
+        return;
+    }
 
+    const uint8_t* null_map = nullptr;
+    vectorized::IColumn* nested_col = &column;
     if (column.is_nullable()) {
         auto* nullable_col = vectorized::check_and_get_column<vectorized::ColumnNullable>(column);
-        auto& null_map_data = nullable_col->get_null_map_column().get_data();
-        // deal ColumnDict
-        if (nullable_col->get_nested_column().is_column_dictionary()) {
-            auto* dict_col = vectorized::check_and_get_column<vectorized::ColumnDictI32>(
-                    nullable_col->get_nested_column());
-            const_cast<vectorized::ColumnDictI32*>(dict_col)->generate_hash_values();
-            for (uint16_t i = 0; i < *size; i++) {
-                uint16_t idx = sel[i];
-                sel[new_size] = idx;
-                new_size += (!null_map_data[idx]) &&
-                            _specific_filter->find_uint32_t(dict_col->get_hash_value(idx));
-            }
-        } else {
-            auto* pred_col = vectorized::check_and_get_column<vectorized::PredicateColumnType<FT>>(
-                    nullable_col->get_nested_column());
-            auto& pred_col_data = pred_col->get_data();
-            for (uint16_t i = 0; i < *size; i++) {
-                uint16_t idx = sel[i];
-                sel[new_size] = idx;
-                const auto* cell_value = reinterpret_cast<const void*>(&(pred_col_data[idx]));
-                new_size += (!null_map_data[idx]) && _specific_filter->find_olap_engine(cell_value);
-            }
-        }
-    } else if (column.is_column_dictionary()) {
-        auto* dict_col = vectorized::check_and_get_column<vectorized::ColumnDictI32>(column);
+        null_map = nullable_col->get_null_map_column().get_data().data();
+        nested_col = const_cast<vectorized::IColumn*>(&nullable_col->get_nested_column());
+    }
+
+    // probe all the selected rows by batch, the null rows are probed too and skipped later
+    uint8_t results[*size];
+    if (nested_col->is_column_dictionary()) {
+        auto* dict_col = vectorized::check_and_get_column<vectorized::ColumnDictI32>(*nested_col);
         const_cast<vectorized::ColumnDictI32*>(dict_col)->generate_hash_values();
+        uint32_t hashes[*size];
         for (uint16_t i = 0; i < *size; i++) {
-            uint16_t idx = sel[i];
-            sel[new_size] = idx;
-            new_size += _specific_filter->find_uint32_t(dict_col->get_hash_value(idx));
+            hashes[i] = dict_col->get_hash_value(sel[i]);
         }
+        _specific_filter->find_uint32_t_batch(hashes, *size, results);
     } else {
         auto* pred_col =
-                vectorized::check_and_get_column<vectorized::PredicateColumnType<FT>>(column);
-        auto& pred_col_data = pred_col->get_data();
-        for (uint16_t i = 0; i < *size; i++) {
-            uint16_t idx = sel[i];
-            sel[new_size] = idx;
-            const auto* cell_value = reinterpret_cast<const void*>(&(pred_col_data[idx]));
-            new_size += _specific_filter->find_olap_engine(cell_value);
-        }
+                vectorized::check_and_get_column<vectorized::PredicateColumnType<FT>>(*nested_col);
+        _specific_filter->find_olap_engine_batch(
+                reinterpret_cast<const char*>(pred_col->get_data().data()), sizeof(FT), sel,
+                *size, results);
+    }
+
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; i++) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        new_size += (null_map == nullptr || !null_map[idx]) && results[i];
     }
     *size = new_size;
 }
@@ -0,0 +1,356 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/clock_cache.h"
+
+#include <mutex>
+
+#include "runtime/thread_context.h"
+#include "util/doris_metrics.h"
+
+namespace doris {
+
+// defined in lru_cache.cpp
+extern MetricPrototype METRIC_capacity;
+extern MetricPrototype METRIC_usage;
+extern MetricPrototype METRIC_usage_ratio;
+extern MetricPrototype METRIC_lookup_count;
+extern MetricPrototype METRIC_hit_count;
+extern MetricPrototype METRIC_hit_ratio;
+
+// The refs and visited of the entries are changed by lookup() and release() concurrently,
+// so they are always accessed atomically.
+static inline uint32_t ref_entry(LRUHandle* e) {
+    return __atomic_add_fetch(&e->refs, 1, __ATOMIC_RELAXED);
+}
+
+static inline bool unref_entry(LRUHandle* e) {
+    return __atomic_sub_fetch(&e->refs, 1, __ATOMIC_ACQ_REL) == 0;
+}
+
+static inline bool is_entry_in_use(LRUHandle* e) {
+    // the cache holds one reference
+    return __atomic_load_n(&e->refs, __ATOMIC_RELAXED) > 1;
+}
+
+ClockCache::ClockCache(LRUCacheType type) : _type(type) {
+    _clock_list.next = &_clock_list;
+    _clock_list.prev = &_clock_list;
+    _hand = &_clock_list;
+}
+
+ClockCache::~ClockCache() {
+    prune();
+}
+
+void ClockCache::_clock_append(LRUHandle* e) {
+    // insert just before the hand, so the new entry is checked at last
+    e->next = _hand;
+    e->prev = _hand->prev;
+    e->prev->next = e;
+    e->next->prev = e;
+}
+
+void ClockCache::_clock_remove(LRUHandle* e) {
+    if (_hand == e) {
+        _hand = e->next;
+    }
+    e->next->prev = e->prev;
+    e->prev->next = e->next;
+    e->prev = e->next = nullptr;
+}
+
+void ClockCache::_remove_from_cache(LRUHandle* e) {
+    DCHECK(e->in_cache);
+    _clock_remove(e);
+    e->in_cache = false;
+    _usage -= e->total_size;
+    --_num_entries;
+}
+
+Cache::Handle* ClockCache::lookup(const CacheKey& key, uint32_t hash) {
+    _lookup_count.fetch_add(1, std::memory_order_relaxed);
+    std::shared_lock<std::shared_mutex> l(_mutex);
+    LRUHandle* e = _table.lookup(key, hash);
+    if (e != nullptr) {
+        ref_entry(e);
+        if (!__atomic_load_n(&e->visited, __ATOMIC_RELAXED)) {
+            // avoid writing the shared cache line on every hit
+            __atomic_store_n(&e->visited, true, __ATOMIC_RELAXED);
+        }
+        _hit_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCache::release(Cache::Handle* handle) {
+    if (handle == nullptr) {
+        return;
+    }
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(handle);
+    // the reference of the cache is only dropped under the exclusive lock, so the last
+    // reference here means the entry has left the cache
+    if (unref_entry(e)) {
+        e->free();
+    }
+}
+
+void ClockCache::_evict(size_t total_size, LRUHandle** to_remove_head) {
+    for (CachePriority priority : {CachePriority::NORMAL, CachePriority::DURABLE}) {
+        // Two rounds are enough to clear all visited marks and come back to the first
+        // one, stop if still can't find an entry to evict.
+        size_t steps = 2 * _num_entries;
+        while (_usage + total_size > _capacity && _num_entries > 0 && steps-- > 0) {
+            if (_hand == &_clock_list) {
+                _hand = _hand->next;
+            }
+            LRUHandle* e = _hand;
+            _hand = e->next;
+            if (e->priority != priority || is_entry_in_use(e)) {
+                continue;
+            }
+            if (__atomic_load_n(&e->visited, __ATOMIC_RELAXED)) {
+                // second chance
+                __atomic_store_n(&e->visited, false, __ATOMIC_RELAXED);
+                continue;
+            }
+            _table.remove(e);
+            _remove_from_cache(e);
+            // refs must be 1 here, no lookup can run under the exclusive lock
+            unref_entry(e);
+            e->next = *to_remove_head;
+            *to_remove_head = e;
+        }
+    }
+}
+
+Cache::Handle* ClockCache::insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                                  void (*deleter)(const CacheKey& key, void* value),
+                                  CachePriority priority) {
+    size_t handle_size = sizeof(LRUHandle) - 1 + key.size();
+    LRUHandle* e = reinterpret_cast<LRUHandle*>(malloc(handle_size));
+    e->value = value;
+    e->deleter = deleter;
+    e->charge = charge;
+    e->key_length = key.size();
+    e->total_size = (_type == LRUCacheType::SIZE ? handle_size + charge : 1);
+    e->hash = hash;
+    e->refs = 2; // one for the returned handle, one for ClockCache.
+    e->next = e->prev = nullptr;
+    e->in_cache = true;
+    e->in_protected = false;
+    e->visited = false;
+    e->priority = priority;
+    memcpy(e->key_data, key.data(), key.size());
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::unique_lock<std::shared_mutex> l(_mutex);
+
+        _evict(e->total_size, &to_remove_head);
+
+        // the cache might get larger than its capacity if not enough space was freed
+        LRUHandle* old = _table.insert(e);
+        _clock_append(e);
+        _usage += e->total_size;
+        ++_num_entries;
+        if (old != nullptr) {
+            _remove_from_cache(old);
+            if (unref_entry(old)) {
+                old->next = to_remove_head;
+                to_remove_head = old;
+            }
+        }
+    }
+
+    // free the entries out of mutex
+    while (to_remove_head != nullptr) {
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+
+    return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCache::erase(const CacheKey& key, uint32_t hash) {
+    LRUHandle* e = nullptr;
+    bool last_ref = false;
+    {
+        std::unique_lock<std::shared_mutex> l(_mutex);
+        e = _table.remove(key, hash);
+        if (e != nullptr) {
+            _remove_from_cache(e);
+            last_ref = unref_entry(e);
+        }
+    }
+    // free handle out of mutex, when last_ref is true, e must not be nullptr
+    if (last_ref) {
+        e->free();
+    }
+}
+
+int64_t ClockCache::prune() {
+    return prune_if([](const void*) { return true; });
+}
+
+int64_t ClockCache::prune_if(CacheValuePredicate pred) {
+    LRUHandle* to_remove_head = nullptr;
+    {
+        std::unique_lock<std::shared_mutex> l(_mutex);
+        LRUHandle* p = _clock_list.next;
+        while (p != &_clock_list) {
+            LRUHandle* next = p->next;
+            if (!is_entry_in_use(p) && pred(p->value)) {
+                _table.remove(p);
+                _remove_from_cache(p);
+                unref_entry(p);
+                p->next = to_remove_head;
+                to_remove_head = p;
+            }
+            p = next;
+        }
+    }
+    int64_t pruned_count = 0;
+    while (to_remove_head != nullptr) {
+        ++pruned_count;
+        LRUHandle* next = to_remove_head->next;
+        to_remove_head->free();
+        to_remove_head = next;
+    }
+    return pruned_count;
+}
+
+inline uint32_t ShardedClockCache::_hash_slice(const CacheKey& s) {
+    return s.hash(s.data(), s.size(), 0);
+}
+
+uint32_t ShardedClockCache::_shard(uint32_t hash) {
+    return hash >> (32 - kNumShardBits);
+}
+
+ShardedClockCache::ShardedClockCache(const std::string& name, size_t total_capacity,
+                                     LRUCacheType type)
+        : _name(name),
+          _last_id(1),
+          _mem_tracker(MemTracker::create_tracker(-1, name, nullptr, MemTrackerLevel::OVERVIEW)) {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_END_CLEAR(_mem_tracker);
+    const size_t per_shard = (total_capacity + (kNumShards - 1)) / kNumShards;
+    for (int s = 0; s < kNumShards; s++) {
+        _shards[s] = new ClockCache(type);
+        _shards[s]->set_capacity(per_shard);
+    }
+
+    _entity = DorisMetrics::instance()->metric_registry()->register_entity(
+            std::string("lru_cache:") + name, {{"name", name}});
+    _entity->register_hook(name, std::bind(&ShardedClockCache::update_cache_metrics, this));
+    INT_GAUGE_METRIC_REGISTER(_entity, capacity);
+    INT_GAUGE_METRIC_REGISTER(_entity, usage);
+    INT_DOUBLE_METRIC_REGISTER(_entity, usage_ratio);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, lookup_count);
+    INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, hit_count);
+    INT_DOUBLE_METRIC_REGISTER(_entity, hit_ratio);
+}
+
+ShardedClockCache::~ShardedClockCache() {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    for (int s = 0; s < kNumShards; s++) {
+        delete _shards[s];
+    }
+    _entity->deregister_hook(_name);
+    DorisMetrics::instance()->metric_registry()->deregister_entity(_entity);
+}
+
+Cache::Handle* ShardedClockCache::insert(const CacheKey& key, void* value, size_t charge,
+                                         void (*deleter)(const CacheKey& key, void* value),
+                                         CachePriority priority) {
+    // transfer the memory ownership of the value to ShardedClockCache::_mem_tracker.
+    tls_ctx()->_thread_mem_tracker_mgr->mem_tracker()->transfer_to(_mem_tracker.get(), charge);
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    const uint32_t hash = _hash_slice(key);
+    return _shards[_shard(hash)]->insert(key, hash, value, charge, deleter, priority);
+}
+
+Cache::Handle* ShardedClockCache::lookup(const CacheKey& key) {
+    const uint32_t hash = _hash_slice(key);
+    return _shards[_shard(hash)]->lookup(key, hash);
+}
+
+void ShardedClockCache::release(Handle* handle) {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    LRUHandle* h = reinterpret_cast<LRUHandle*>(handle);
+    _shards[_shard(h->hash)]->release(handle);
+}
+
+void ShardedClockCache::erase(const CacheKey& key) {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    const uint32_t hash = _hash_slice(key);
+    _shards[_shard(hash)]->erase(key, hash);
+}
+
+void* ShardedClockCache::value(Handle* handle) {
+    return reinterpret_cast<LRUHandle*>(handle)->value;
+}
+
+Slice ShardedClockCache::value_slice(Handle* handle) {
+    auto lru_handle = reinterpret_cast<LRUHandle*>(handle);
+    return Slice((char*)lru_handle->value, lru_handle->charge);
+}
+
+uint64_t ShardedClockCache::new_id() {
+    return _last_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+int64_t ShardedClockCache::prune() {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    int64_t num_prune = 0;
+    for (int s = 0; s < kNumShards; s++) {
+        num_prune += _shards[s]->prune();
+    }
+    return num_prune;
+}
+
+int64_t ShardedClockCache::prune_if(CacheValuePredicate pred) {
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    int64_t num_prune = 0;
+    for (int s = 0; s < kNumShards; s++) {
+        num_prune += _shards[s]->prune_if(pred);
+    }
+    return num_prune;
+}
+
+void ShardedClockCache::update_cache_metrics() const {
+    size_t total_capacity = 0;
+    size_t total_usage = 0;
+    size_t total_lookup_count = 0;
+    size_t total_hit_count = 0;
+    for (int i = 0; i < kNumShards; i++) {
+        total_capacity += _shards[i]->get_capacity();
+        total_usage += _shards[i]->get_usage();
+        total_lookup_count += _shards[i]->get_lookup_count();
+        total_hit_count += _shards[i]->get_hit_count();
+    }
+
+    capacity->set_value(total_capacity);
+    usage->set_value(total_usage);
+    lookup_count->set_value(total_lookup_count);
+    hit_count->set_value(total_hit_count);
+    usage_ratio->set_value(total_capacity == 0 ? 0 : ((double)total_usage / total_capacity));
+    hit_ratio->set_value(total_lookup_count == 0 ? 0
+                                                 : ((double)total_hit_count / total_lookup_count));
+}
+
+} // namespace doris
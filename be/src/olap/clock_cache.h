@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <shared_mutex>
+#include <string>
+
+#include "olap/lru_cache.h"
+
+namespace doris {
+
+// A single shard of ShardedClockCache.
+//
+// Unlike LRUCache, a hit doesn't reorder any list, it only increases the refcount of the
+// entry and marks it visited, so lookups run concurrently under a shared lock and
+// release() doesn't take any lock. Insert, erase and prune take the exclusive lock, the
+// eviction sweeps the entries with a clock hand and gives each visited entry a second
+// chance. DURABLE entries are only evicted when no NORMAL entry can be evicted.
+//
+// The usage only counts the entries in the cache, an evicted or erased entry which is
+// still pinned by some handle is not counted any more.
+class ClockCache {
+public:
+    explicit ClockCache(LRUCacheType type);
+    ~ClockCache();
+
+    void set_capacity(size_t capacity) { _capacity = capacity; }
+
+    // Like Cache methods, but with an extra "hash" parameter.
+    Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
+                          void (*deleter)(const CacheKey& key, void* value),
+                          CachePriority priority = CachePriority::NORMAL);
+    Cache::Handle* lookup(const CacheKey& key, uint32_t hash);
+    void release(Cache::Handle* handle);
+    void erase(const CacheKey& key, uint32_t hash);
+    int64_t prune();
+    int64_t prune_if(CacheValuePredicate pred);
+
+    uint64_t get_lookup_count() const { return _lookup_count.load(std::memory_order_relaxed); }
+    uint64_t get_hit_count() const { return _hit_count.load(std::memory_order_relaxed); }
+    size_t get_usage() const { return _usage; }
+    size_t get_capacity() const { return _capacity; }
+
+private:
+    void _clock_append(LRUHandle* e);
+    void _clock_remove(LRUHandle* e);
+    // Must hold the exclusive lock, and e must be in the cache.
+    void _remove_from_cache(LRUHandle* e);
+    // Evict the unused entries until there is space for `total_size`.
+    void _evict(size_t total_size, LRUHandle** to_remove_head);
+
+private:
+    LRUCacheType _type;
+    size_t _capacity = 0;
+
+    // protects _table, _clock_list, _hand and _usage
+    std::shared_mutex _mutex;
+    size_t _usage = 0;
+    size_t _num_entries = 0;
+
+    // Dummy head of the circular list of all entries in the cache.
+    LRUHandle _clock_list;
+    // The next entry to check for eviction, may be &_clock_list.
+    LRUHandle* _hand = nullptr;
+
+    HandleTable _table;
+
+    std::atomic<uint64_t> _lookup_count {0};
+    std::atomic<uint64_t> _hit_count {0};
+};
+
+// A Cache for read mostly workloads, the hits of different threads don't serialize on
+// a mutex. See ClockCache.
+class ShardedClockCache : public Cache {
+public:
+    explicit ShardedClockCache(const std::string& name, size_t total_capacity,
+                               LRUCacheType type);
+    ~ShardedClockCache() override;
+    Handle* insert(const CacheKey& key, void* value, size_t charge,
+                   void (*deleter)(const CacheKey& key, void* value),
+                   CachePriority priority = CachePriority::NORMAL) override;
+    Handle* lookup(const CacheKey& key) override;
+    void release(Handle* handle) override;
+    void erase(const CacheKey& key) override;
+    void* value(Handle* handle) override;
+    Slice value_slice(Handle* handle) override;
+    uint64_t new_id() override;
+    int64_t prune() override;
+    int64_t prune_if(CacheValuePredicate pred) override;
+
+private:
+    void update_cache_metrics() const;
+
+    static uint32_t _hash_slice(const CacheKey& s);
+    static uint32_t _shard(uint32_t hash);
+
+private:
+    std::string _name;
+    ClockCache* _shards[kNumShards];
+    std::atomic<uint64_t> _last_id;
+
+    std::shared_ptr<MemTracker> _mem_tracker;
+    std::shared_ptr<MetricEntity> _entity = nullptr;
+    IntGauge* capacity = nullptr;
+    IntGauge* usage = nullptr;
+    DoubleGauge* usage_ratio = nullptr;
+    IntAtomicCounter* lookup_count = nullptr;
+    IntAtomicCounter* hit_count = nullptr;
+    DoubleGauge* hit_ratio = nullptr;
+};
+
+} // namespace doris
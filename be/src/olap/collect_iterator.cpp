@@ -32,9 +32,12 @@ CollectIterator::~CollectIterator() = default;
 void CollectIterator::init(TabletReader* reader) {
     _reader = reader;
     // when aggregate is enabled or key_type is DUP_KEYS, we don't merge
-    // multiple data to aggregate for better performance
+    // multiple data to aggregate for better performance.
+    // merge-on-write unique key tablet has no duplicated keys after the delete bitmap
+    // is applied, so it's read like DUP_KEYS.
     if (_reader->_reader_type == READER_QUERY &&
-        (_reader->_aggregation || _reader->_tablet->keys_type() == KeysType::DUP_KEYS)) {
+        (_reader->_aggregation || _reader->_tablet->keys_type() == KeysType::DUP_KEYS ||
+         _reader->_tablet->enable_unique_key_merge_on_write())) {
         _merge = false;
     }
 }
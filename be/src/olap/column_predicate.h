@@ -45,6 +45,8 @@ enum class PredicateType {
     IS_NULL = 9,
     IS_NOT_NULL = 10,
     BF = 11, // BloomFilter
+    MATCH = 12, // inverted index
+    BITMAP_FILTER = 13, // runtime bitmap filter
 };
 
 class ColumnPredicate {
@@ -66,11 +68,23 @@ public:
     virtual void evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
                               bool* flags) const = 0;
 
+    // whether evaluate() on the bitmap index applies the whole predicate, the predicate is no
+    // longer evaluated on the rows after being evaluated on the bitmap index
+    virtual bool can_do_bitmap_index_filter() const { return true; }
+
     //evaluate predicate on Bitmap
     virtual Status evaluate(const Schema& schema,
                             const std::vector<BitmapIndexIterator*>& iterators, uint32_t num_rows,
                             roaring::Roaring* roaring) const = 0;
 
+    // Narrow [*from, *to) to the ordinals of the dictionary values of the bitmap index matching
+    // a range predicate (<, <=, >, >=), so the range predicates of a column can be evaluated
+    // together by the bitmaps of one dictionary range.
+    virtual Status seek_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from,
+                                           rowid_t* to) const {
+        return Status::NotSupported("not a range predicate");
+    }
+
     // evaluate predicate on IColumn
     // a short circuit eval way
     virtual void evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const {};
@@ -17,10 +17,15 @@
 
 #include "olap/compaction.h"
 
+#include <limits>
+
 #include "gutil/strings/substitute.h"
 #include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "util/countdown_latch.h"
 #include "util/time.h"
 #include "util/trace.h"
+#include "vec/olap/vertical_merge_iterator.h"
 
 using std::vector;
 
@@ -79,7 +84,8 @@ Status Compaction::do_compaction_impl(int64_t permits) {
     LOG(INFO) << "start " << compaction_name() << ". tablet=" << _tablet->full_name()
               << ", output_version=" << _output_version << ", permits: " << permits;
 
-    RETURN_NOT_OK(construct_output_rowset_writer());
+    bool vertical_compaction = should_vertical_compaction(segments_num);
+    RETURN_NOT_OK(construct_output_rowset_writer(vertical_compaction));
     RETURN_NOT_OK(construct_input_rowset_readers());
     TRACE("prepare finished");
 
@@ -87,7 +93,17 @@ Status Compaction::do_compaction_impl(int64_t permits) {
     // The test results show that merger is low-memory-footprint, there is no need to tracker its mem pool
     Merger::Statistics stats;
     Status res;
-    if (config::enable_vectorized_compaction) {
+    bool trivial_move = can_trivial_move();
+    int num_ranges = trivial_move || vertical_compaction ? 1 : get_parallel_merge_ranges();
+    if (trivial_move) {
+        res = do_trivial_move(&stats);
+    } else if (num_ranges > 1) {
+        res = do_parallel_merge(num_ranges, &stats);
+    } else if (vertical_compaction) {
+        res = Merger::vertical_merge_rowsets(_tablet, compaction_type(), _input_rs_readers,
+                                             _output_rs_writer.get(), get_avg_segment_rows(),
+                                             &stats);
+    } else if (config::enable_vectorized_compaction) {
         res = Merger::vmerge_rowsets(_tablet, compaction_type(), _input_rs_readers,
                                      _output_rs_writer.get(), &stats);
     } else {
@@ -95,6 +111,13 @@ Status Compaction::do_compaction_impl(int64_t permits) {
                                     _output_rs_writer.get(), &stats);
     }
     string merge_type = config::enable_vectorized_compaction ? "v" : "";
+    if (trivial_move) {
+        merge_type = "trivial move ";
+    } else if (num_ranges > 1) {
+        merge_type = "parallel ";
+    } else if (vertical_compaction) {
+        merge_type = "vertical ";
+    }
     if (!res.ok()) {
         LOG(WARNING) << "fail to do " << merge_type << compaction_name() << ". res=" << res
                      << ", tablet=" << _tablet->full_name()
@@ -121,7 +144,7 @@ Status Compaction::do_compaction_impl(int64_t permits) {
     TRACE("check correctness finished");
 
     // 4. modify rowsets in memory
-    modify_rowsets();
+    RETURN_NOT_OK(modify_rowsets());
     TRACE("modify rowsets finished");
 
     // 5. update last success compaction time
@@ -155,7 +178,160 @@ Status Compaction::do_compaction_impl(int64_t permits) {
     return Status::OK();
 }
 
-Status Compaction::construct_output_rowset_writer() {
+bool Compaction::should_vertical_compaction(int64_t segments_num) const {
+    // the rows of AGG_KEYS are aggregated by all value columns, which can't be done group
+    // by group, the key columns are merged in lexical order only, and the row source of each
+    // row takes 15 bits
+    return config::enable_vectorized_compaction && config::enable_vertical_compaction &&
+           _tablet->keys_type() != KeysType::AGG_KEYS &&
+           _tablet->tablet_schema().sort_type() != SortType::ZORDER &&
+           segments_num <= vectorized::RowSource::MAX_SOURCE_NUM + 1;
+}
+
+bool Compaction::can_trivial_move() const {
+    // the delete bitmap of merge-on-write tablets is bound to the input rowsets, and the key
+    // bounds of the segments in Z-order are not the min and max keys
+    if (!config::enable_trivial_move_compaction ||
+        _tablet->enable_unique_key_merge_on_write() ||
+        _tablet->tablet_schema().sort_type() == SortType::ZORDER ||
+        _output_rs_writer->type() != RowsetTypePB::BETA_ROWSET) {
+        return false;
+    }
+    const std::string* prev_max_key = nullptr;
+    for (auto& rowset : _input_rowsets) {
+        const auto& rowset_meta = rowset->rowset_meta();
+        if (rowset_meta->rowset_type() != RowsetTypePB::BETA_ROWSET ||
+            rowset_meta->has_delete_predicate() || rowset->rowset_path_desc().is_remote()) {
+            return false;
+        }
+        if (rowset_meta->num_segments() == 0) {
+            continue;
+        }
+        if (!rowset_meta->has_segments_key_bounds()) {
+            return false;
+        }
+        // the keys must be strictly increasing across segments, otherwise the same keys
+        // need to be merged in unique and aggregate tablets
+        for (const auto& key_bounds : rowset_meta->segments_key_bounds()) {
+            if (prev_max_key != nullptr && key_bounds.min_key() <= *prev_max_key) {
+                return false;
+            }
+            prev_max_key = &key_bounds.max_key();
+        }
+    }
+    return true;
+}
+
+Status Compaction::do_trivial_move(Merger::Statistics* stats) {
+    for (auto& rowset : _input_rowsets) {
+        RETURN_NOT_OK(_output_rs_writer->add_rowset(rowset));
+    }
+    stats->output_rows = _input_row_num;
+    return Status::OK();
+}
+
+int Compaction::get_parallel_merge_ranges() const {
+    // the rows of merge-on-write tablets are mapped to the input rows by the row ids, and the
+    // rows in Z-order are not ordered by the short keys
+    if (config::compaction_key_range_parallelism <= 1 || !config::enable_vectorized_compaction ||
+        _tablet->enable_unique_key_merge_on_write() ||
+        _tablet->tablet_schema().sort_type() == SortType::ZORDER ||
+        _tablet->tablet_schema().num_short_key_columns() == 0 ||
+        _output_rs_writer->type() != RowsetTypePB::BETA_ROWSET) {
+        return 1;
+    }
+    for (auto& rowset : _input_rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != RowsetTypePB::BETA_ROWSET) {
+            return 1;
+        }
+    }
+    int64_t range_bytes = std::max<int64_t>(config::compaction_key_range_bytes, 1);
+    return std::min<int64_t>(config::compaction_key_range_parallelism,
+                             std::max<int64_t>(_input_rowsets_size / range_bytes, 1));
+}
+
+Status Compaction::do_parallel_merge(int num_ranges, Merger::Statistics* stats) {
+    std::vector<Merger::KeyRange> key_ranges;
+    RETURN_NOT_OK(Merger::split_key_ranges(_tablet->tablet_schema(), _input_rowsets, num_ranges,
+                                           &key_ranges));
+    size_t n = key_ranges.size();
+    std::vector<std::vector<RowsetReaderSharedPtr>> rs_readers(n);
+    std::vector<std::unique_ptr<RowsetWriter>> rs_writers(n);
+    for (size_t i = 0; i < n; ++i) {
+        for (auto& rowset : _input_rowsets) {
+            RowsetReaderSharedPtr rs_reader;
+            RETURN_NOT_OK(rowset->create_reader(&rs_reader));
+            rs_readers[i].push_back(std::move(rs_reader));
+        }
+        RETURN_NOT_OK(construct_rowset_writer(false, &rs_writers[i]));
+    }
+
+    std::vector<Merger::Statistics> range_stats(n);
+    std::vector<Status> statuses(n);
+    auto merge_range = [&](size_t i) {
+        statuses[i] = Merger::vmerge_rowsets(_tablet, compaction_type(), rs_readers[i],
+                                             rs_writers[i].get(), &range_stats[i], &key_ranges[i]);
+    };
+    ThreadPool* merge_pool = StorageEngine::instance()->compaction_key_range_thread_pool();
+    CountDownLatch latch(n);
+    for (size_t i = 0; i < n; ++i) {
+        if (merge_pool == nullptr || !merge_pool->submit_func([&, i]() {
+                                          merge_range(i);
+                                          latch.count_down();
+                                      }).ok()) {
+            // merge it by this thread if the pool is shutting down
+            merge_range(i);
+            latch.count_down();
+        }
+    }
+    latch.wait();
+
+    std::vector<RowsetSharedPtr> range_rowsets;
+    Status st;
+    for (size_t i = 0; i < n && st.ok(); ++i) {
+        st = statuses[i];
+        if (st.ok()) {
+            RowsetSharedPtr rowset = rs_writers[i]->build();
+            if (rowset == nullptr) {
+                st = Status::OLAPInternalError(OLAP_ERR_MALLOC_ERROR);
+                break;
+            }
+            range_rowsets.push_back(std::move(rowset));
+        }
+    }
+    // the ranges are ordered, so the output rowset is built by linking their segments in order
+    for (size_t i = 0; i < range_rowsets.size() && st.ok(); ++i) {
+        st = _output_rs_writer->add_rowset(range_rowsets[i]);
+    }
+    for (auto& rowset : range_rowsets) {
+        StorageEngine::instance()->add_unused_rowset(rowset);
+    }
+    RETURN_NOT_OK(st);
+
+    for (auto& range_stat : range_stats) {
+        stats->output_rows += range_stat.output_rows;
+        stats->merged_rows += range_stat.merged_rows;
+        stats->filtered_rows += range_stat.filtered_rows;
+    }
+    return Status::OK();
+}
+
+uint32_t Compaction::get_avg_segment_rows() const {
+    if (_input_row_num <= 0) {
+        return std::numeric_limits<uint32_t>::max();
+    }
+    int64_t avg_row_size = std::max<int64_t>(_input_rowsets_size / _input_row_num, 1);
+    return std::max<int64_t>(std::min<int64_t>(MAX_SEGMENT_SIZE / avg_row_size,
+                                               std::numeric_limits<uint32_t>::max()),
+                             1);
+}
+
+Status Compaction::construct_output_rowset_writer(bool is_vertical) {
+    return construct_rowset_writer(is_vertical, &_output_rs_writer);
+}
+
+Status Compaction::construct_rowset_writer(bool is_vertical,
+                                           std::unique_ptr<RowsetWriter>* writer) {
     RowsetWriterContext context;
     context.rowset_id = StorageEngine::instance()->next_rowset_id();
     context.tablet_uid = _tablet->tablet_uid();
@@ -172,8 +348,9 @@ Status Compaction::construct_output_rowset_writer() {
     context.rowset_state = VISIBLE;
     context.version = _output_version;
     context.segments_overlap = NONOVERLAPPING;
+    context.is_vertical = is_vertical;
     // The test results show that one rs writer is low-memory-footprint, there is no need to tracker its mem pool
-    RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, &_output_rs_writer));
+    RETURN_NOT_OK(RowsetFactory::create_rowset_writer(context, writer));
     return Status::OK();
 }
 
@@ -186,13 +363,38 @@ Status Compaction::construct_input_rowset_readers() {
     return Status::OK();
 }
 
-void Compaction::modify_rowsets() {
+Status Compaction::modify_rowsets() {
     std::vector<RowsetSharedPtr> output_rowsets;
     output_rowsets.push_back(_output_rowset);
 
+    std::unique_lock<std::mutex> rowset_update_lock(_tablet->get_rowset_update_lock(),
+                                                    std::defer_lock);
+    DeleteBitmap delete_bitmap;
+    if (_tablet->enable_unique_key_merge_on_write()) {
+        // The rows deleted by the versions <= output version are dropped by compaction,
+        // but the rows of the output rowset may be replaced by the newer rowsets, which
+        // are marked against the input rowsets only, so mark them again.
+        rowset_update_lock.lock();
+        std::vector<std::pair<Version, RowsetSharedPtr>> version_rowsets;
+        {
+            std::shared_lock rdlock(_tablet->get_header_lock());
+            _tablet->acquire_version_and_rowsets(&version_rowsets);
+        }
+        for (auto& [version, rowset] : version_rowsets) {
+            if (version.first > _output_version.second) {
+                RETURN_NOT_OK(_tablet->calc_delete_bitmap(rowset, output_rowsets, &delete_bitmap,
+                                                          version.second));
+            }
+        }
+    }
+
     std::lock_guard<std::shared_mutex> wrlock(_tablet->get_header_lock());
     _tablet->modify_rowsets(output_rowsets, _input_rowsets);
+    if (_tablet->enable_unique_key_merge_on_write()) {
+        _tablet->tablet_meta()->delete_bitmap()->merge(delete_bitmap);
+    }
     _tablet->save_meta();
+    return Status::OK();
 }
 
 void Compaction::gc_output_rowset() {
@@ -61,10 +61,22 @@ protected:
     Status do_compaction(int64_t permits);
     Status do_compaction_impl(int64_t permits);
 
-    void modify_rowsets();
+    Status modify_rowsets();
     void gc_output_rowset();
 
-    Status construct_output_rowset_writer();
+    Status construct_output_rowset_writer(bool is_vertical = false);
+    Status construct_rowset_writer(bool is_vertical, std::unique_ptr<RowsetWriter>* writer);
+    bool should_vertical_compaction(int64_t segments_num) const;
+    // whether the segments of the input rowsets are ordered by keys and not overlapping, so the
+    // output rowset can be built by linking the segment files without merge
+    bool can_trivial_move() const;
+    Status do_trivial_move(Merger::Statistics* stats);
+    // the number of the key ranges merged in parallel, 1 if the rowsets can't be split
+    int get_parallel_merge_ranges() const;
+    // merge each key range into a rowset in parallel, and link them as the output rowset
+    Status do_parallel_merge(int num_ranges, Merger::Statistics* stats);
+    // estimated from the average row size of the input rowsets
+    uint32_t get_avg_segment_rows() const;
     Status construct_input_rowset_readers();
 
     Status check_version_continuity(const std::vector<RowsetSharedPtr>& rowsets);
@@ -17,10 +17,13 @@
 
 #include "olap/comparison_predicate.h"
 
+#include <algorithm>
+
 #include "common/logging.h"
 #include "olap/schema.h"
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
+#include "util/simd/bits.h"
 #include "vec/columns/column_dictionary.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/column_vector.h"
@@ -143,6 +146,58 @@ COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(LessEqualPredicate, <=)
 COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterPredicate, >)
 COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterEqualPredicate, >=)
 
+// Filter the selection vector by `compare` over the fixed-width data, 32 rows at a time: the
+// results are written to a byte mask by a branchless loop (which is vectorized when the selected
+// rows are contiguous), then compacted into the selection vector by simd shuffles.
+// A null row never matches `compare`, but matches the opposite predicate.
+template <bool is_nullable, class T, class Compare>
+uint16_t evaluate_and_compact(const T* data, const uint8_t* null_map, uint16_t* sel,
+                              uint16_t size, bool opposite, Compare compare) {
+    constexpr uint16_t batch_size = 32;
+    uint8_t flags[batch_size];
+    uint16_t new_size = 0;
+    uint16_t i = 0;
+    // sel is ascending, so it's contiguous iff the distance of the ends matches the size
+    if (size > 0 && sel[size - 1] - sel[0] == size - 1) {
+        const T* base_data = data + sel[0];
+        const uint8_t* base_null_map = is_nullable ? null_map + sel[0] : nullptr;
+        for (; i + batch_size <= size; i += batch_size) {
+            for (uint16_t j = 0; j < batch_size; ++j) {
+                bool ret = compare(base_data[i + j]);
+                if constexpr (is_nullable) {
+                    ret = ret && !base_null_map[i + j];
+                }
+                flags[j] = ret != opposite;
+            }
+            new_size += simd::compact_selection_by_bits32_mask(
+                    simd::bytes32_mask_to_bits32_mask(flags), sel + i, sel + new_size);
+        }
+    } else {
+        for (; i + batch_size <= size; i += batch_size) {
+            for (uint16_t j = 0; j < batch_size; ++j) {
+                uint16_t idx = sel[i + j];
+                bool ret = compare(data[idx]);
+                if constexpr (is_nullable) {
+                    ret = ret && !null_map[idx];
+                }
+                flags[j] = ret != opposite;
+            }
+            new_size += simd::compact_selection_by_bits32_mask(
+                    simd::bytes32_mask_to_bits32_mask(flags), sel + i, sel + new_size);
+        }
+    }
+    for (; i < size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        bool ret = compare(data[idx]);
+        if constexpr (is_nullable) {
+            ret = ret && !null_map[idx];
+        }
+        new_size += ret != opposite;
+    }
+    return new_size;
+}
+
 // todo(zeno) define interface in IColumn to simplify code
 #define COMPARISON_PRED_COLUMN_EVALUATE(CLASS, OP, IS_RANGE)                                       \
     template <class T>                                                                             \
@@ -176,13 +231,10 @@ COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterEqualPredicate, >=)
                         vectorized::check_and_get_column<vectorized::PredicateColumnType<T>>(      \
                                 nested_col);                                                       \
                 auto& data_array = nested_col_ptr->get_data();                                     \
-                for (uint16_t i = 0; i < *size; i++) {                                             \
-                    uint16_t idx = sel[i];                                                         \
-                    sel[new_size] = idx;                                                           \
-                    const auto& cell_value = reinterpret_cast<const T&>(data_array[idx]);          \
-                    bool ret = !null_bitmap[idx] && (cell_value OP _value);                        \
-                    new_size += _opposite ? !ret : ret;                                            \
-                }                                                                                  \
+                new_size = evaluate_and_compact<true>(                                             \
+                        reinterpret_cast<const T*>(data_array.data()), null_bitmap.data(), sel,    \
+                        *size, _opposite,                                                          \
+                        [this](const T& cell_value) { return cell_value OP _value; });             \
             }                                                                                      \
         } else if (column.is_column_dictionary()) {                                                \
             if constexpr (std::is_same_v<T, StringValue>) {                                        \
@@ -203,13 +255,9 @@ COMPARISON_PRED_COLUMN_BLOCK_EVALUATE(GreaterEqualPredicate, >=)
         } else {                                                                                   \
             auto& pred_column_ref = reinterpret_cast<vectorized::PredicateColumnType<T>&>(column); \
             auto& data_array = pred_column_ref.get_data();                                         \
-            for (uint16_t i = 0; i < *size; i++) {                                                 \
-                uint16_t idx = sel[i];                                                             \
-                sel[new_size] = idx;                                                               \
-                const auto& cell_value = reinterpret_cast<const T&>(data_array[idx]);              \
-                auto ret = cell_value OP _value;                                                   \
-                new_size += _opposite ? !ret : ret;                                                \
-            }                                                                                      \
+            new_size = evaluate_and_compact<false>(                                                \
+                    reinterpret_cast<const T*>(data_array.data()), nullptr, sel, *size, _opposite, \
+                    [this](const T& cell_value) { return cell_value OP _value; });                 \
         }                                                                                          \
         *size = new_size;                                                                          \
     }
@@ -510,6 +558,40 @@ COMPARISON_PRED_BITMAP_EVALUATE(LessEqualPredicate, <=)
 COMPARISON_PRED_BITMAP_EVALUATE(GreaterPredicate, >)
 COMPARISON_PRED_BITMAP_EVALUATE(GreaterEqualPredicate, >=)
 
+Status seek_bitmap_index_range(PredicateType type, const void* value,
+                               BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to) {
+    if (type != PredicateType::LT && type != PredicateType::LE && type != PredicateType::GT &&
+        type != PredicateType::GE) {
+        return Status::NotSupported("not a range predicate");
+    }
+    // the null bitmap is stored after the bitmaps of the values
+    rowid_t ordinal_limit = iterator->bitmap_nums() - (iterator->has_null_bitmap() ? 1 : 0);
+    bool exact_match = false;
+    Status s = iterator->seek_dictionary(value, &exact_match);
+    // the ordinal of the first value >= `value`
+    rowid_t ordinal = ordinal_limit;
+    if (s.ok()) {
+        ordinal = iterator->current_ordinal();
+    } else if (!s.is_not_found()) {
+        return s;
+    }
+    switch (type) {
+    case PredicateType::LT:
+        *to = std::min(*to, ordinal);
+        break;
+    case PredicateType::LE:
+        *to = std::min(*to, exact_match ? ordinal + 1 : ordinal);
+        break;
+    case PredicateType::GT:
+        *from = std::max(*from, exact_match ? ordinal + 1 : ordinal);
+        break;
+    default:
+        *from = std::max(*from, ordinal);
+        break;
+    }
+    return Status::OK();
+}
+
 #define COMPARISON_PRED_CONSTRUCTOR_DECLARATION(CLASS)                                         \
     template CLASS<int8_t>::CLASS(uint32_t column_id, const int8_t& value, bool opposite);     \
     template CLASS<int16_t>::CLASS(uint32_t column_id, const int16_t& value, bool opposite);   \
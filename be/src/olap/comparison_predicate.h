@@ -25,6 +25,11 @@ namespace doris {
 
 class VectorizedRowBatch;
 
+// Narrow [*from, *to) to the dictionary ordinals of the values matching the range predicate of
+// `type` on `value`, NotSupported if `type` isn't a range.
+Status seek_bitmap_index_range(PredicateType type, const void* value,
+                               BitmapIndexIterator* iterator, rowid_t* from, rowid_t* to);
+
 #define COMPARISON_PRED_CLASS_DEFINE(CLASS, PT)                                                    \
     template <class T>                                                                             \
     class CLASS : public ColumnPredicate {                                                         \
@@ -40,6 +45,10 @@ class VectorizedRowBatch;
         virtual Status evaluate(const Schema& schema,                                              \
                                 const std::vector<BitmapIndexIterator*>& iterators,                \
                                 uint32_t num_rows, roaring::Roaring* roaring) const override;      \
+        Status seek_bitmap_index_range(BitmapIndexIterator* iterator, rowid_t* from,               \
+                                       rowid_t* to) const override {                               \
+            return doris::seek_bitmap_index_range(type(), &_value, iterator, from, to);            \
+        }                                                                                          \
         void evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const override;  \
         void evaluate_and(vectorized::IColumn& column, uint16_t* sel, uint16_t size,               \
                           bool* flags) const override;                                             \
@@ -18,6 +18,7 @@
 #include "olap/cumulative_compaction_policy.h"
 
 #include <boost/algorithm/string.hpp>
+#include <limits>
 #include <string>
 
 #include "util/time.h"
@@ -460,6 +461,160 @@ void NumBasedCumulativeCompactionPolicy::calculate_cumulative_point(
     }
 }
 
+TimeSeriesCumulativeCompactionPolicy::TimeSeriesCumulativeCompactionPolicy(
+        int64_t goal_size, int64_t file_count_threshold, int64_t time_threshold_sec)
+        : CumulativeCompactionPolicy(),
+          _goal_size(goal_size),
+          _file_count_threshold(file_count_threshold),
+          _time_threshold_sec(time_threshold_sec) {}
+
+void TimeSeriesCumulativeCompactionPolicy::calculate_cumulative_point(
+        Tablet* tablet, const std::vector<RowsetMetaSharedPtr>& all_metas,
+        int64_t current_cumulative_point, int64_t* ret_cumulative_point) {
+    *ret_cumulative_point = Tablet::K_INVALID_CUMULATIVE_POINT;
+    if (current_cumulative_point != Tablet::K_INVALID_CUMULATIVE_POINT) {
+        // only calculate the point once.
+        // after that, cumulative point will be updated along with compaction process.
+        return;
+    }
+    // empty return
+    if (all_metas.empty()) {
+        return;
+    }
+
+    std::vector<RowsetMetaSharedPtr> existing_rss(all_metas);
+    std::sort(existing_rss.begin(), existing_rss.end(),
+              [](const RowsetMetaSharedPtr& a, const RowsetMetaSharedPtr& b) {
+                  return a->version().first < b->version().first;
+              });
+
+    if (tablet->tablet_state() == TABLET_RUNNING) {
+        int64_t prev_version = -1;
+        for (const RowsetMetaSharedPtr& rs : existing_rss) {
+            if (rs->version().first > prev_version + 1) {
+                // There is a hole, do not continue
+                break;
+            }
+            bool is_delete = tablet->version_for_delete_predicate(rs->version());
+            // break the loop at the first rowset which needs to be compacted
+            if (!is_delete && rs->version().first != 0 &&
+                (rs->is_segments_overlapping() ||
+                 static_cast<int64_t>(rs->total_disk_size()) < _goal_size)) {
+                *ret_cumulative_point = rs->version().first;
+                break;
+            }
+            prev_version = rs->version().second;
+            *ret_cumulative_point = prev_version + 1;
+        }
+    } else if (tablet->tablet_state() == TABLET_NOTREADY) {
+        // tablet under alter process
+        // we choose version next to the base version as cumulative point
+        for (const RowsetMetaSharedPtr& rs : existing_rss) {
+            if (rs->version().first > 0) {
+                *ret_cumulative_point = rs->version().first;
+                break;
+            }
+        }
+    }
+}
+
+int TimeSeriesCumulativeCompactionPolicy::pick_input_rowsets(
+        Tablet* tablet, const std::vector<RowsetSharedPtr>& candidate_rowsets,
+        const int64_t max_compaction_score, const int64_t min_compaction_score,
+        std::vector<RowsetSharedPtr>* input_rowsets, Version* last_delete_version,
+        size_t* compaction_score) {
+    *compaction_score = 0;
+    int transient_size = 0;
+    int64_t total_size = 0;
+    for (size_t i = 0; i < candidate_rowsets.size(); ++i) {
+        RowsetSharedPtr rowset = candidate_rowsets[i];
+        // check whether this rowset is delete version
+        if (tablet->version_for_delete_predicate(rowset->version())) {
+            *last_delete_version = rowset->version();
+            if (!input_rowsets->empty()) {
+                // we meet a delete version, and there were other versions before.
+                // we should compact those version before handling them over to base compaction
+                break;
+            } else {
+                // we meet a delete version, and no other versions before, skip it and continue
+                input_rowsets->clear();
+                transient_size = 0;
+                total_size = 0;
+                *compaction_score = 0;
+                continue;
+            }
+        }
+        int64_t rowset_size = rowset->rowset_meta()->total_disk_size();
+        if (input_rowsets->empty() && !rowset->rowset_meta()->is_segments_overlapping() &&
+            rowset_size >= _goal_size) {
+            // a rowset reaching the goal size is not rewritten, hand it over to base compaction
+            tablet->set_cumulative_layer_point(rowset->end_version() + 1);
+            transient_size += 1;
+            continue;
+        }
+        if (*compaction_score >= max_compaction_score || total_size >= _goal_size) {
+            // got enough segments or data
+            break;
+        }
+        *compaction_score += rowset->rowset_meta()->get_compaction_score();
+        total_size += rowset_size;
+        input_rowsets->push_back(rowset);
+        transient_size += 1;
+    }
+
+    if (input_rowsets->empty() || last_delete_version->first != -1) {
+        return transient_size;
+    }
+
+    // compact the rowsets when they reach the goal size, or there are too many of them, or they
+    // have waited for long enough
+    int64_t now = UnixSeconds();
+    bool reach_threshold = total_size >= _goal_size ||
+                           *compaction_score >= max_compaction_score ||
+                           static_cast<int64_t>(input_rowsets->size()) >= _file_count_threshold ||
+                           (input_rowsets->size() > 1 &&
+                            input_rowsets->front()->creation_time() + _time_threshold_sec <= now);
+    if (!reach_threshold) {
+        input_rowsets->clear();
+    }
+    return transient_size;
+}
+
+void TimeSeriesCumulativeCompactionPolicy::update_cumulative_point(
+        Tablet* tablet, const std::vector<RowsetSharedPtr>& input_rowsets,
+        RowsetSharedPtr output_rowset, Version& last_delete_version) {
+    // the output rowset smaller than the goal size is compacted with the following rowsets again
+    if (last_delete_version.first != -1 ||
+        output_rowset->rowset_meta()->total_disk_size() >= _goal_size) {
+        tablet->set_cumulative_layer_point(output_rowset->end_version() + 1);
+    }
+}
+
+void TimeSeriesCumulativeCompactionPolicy::calc_cumulative_compaction_score(
+        TabletState state, const std::vector<RowsetMetaSharedPtr>& all_rowsets,
+        const int64_t current_cumulative_point, uint32_t* score) {
+    uint32_t cumulative_score = 0;
+    int64_t total_size = 0;
+    int64_t rowset_num = 0;
+    int64_t min_creation_time = std::numeric_limits<int64_t>::max();
+    bool has_delete = false;
+    for (auto& rs_meta : all_rowsets) {
+        if (rs_meta->start_version() < current_cumulative_point) {
+            // all_rs_metas() is not sorted, so we use _continue_ other than _break_ here.
+            continue;
+        }
+        cumulative_score += rs_meta->get_compaction_score();
+        total_size += rs_meta->total_disk_size();
+        rowset_num += 1;
+        min_creation_time = std::min(min_creation_time, rs_meta->creation_time());
+        has_delete |= rs_meta->has_delete_predicate();
+    }
+    if (has_delete || total_size >= _goal_size || rowset_num >= _file_count_threshold ||
+        (rowset_num > 1 && min_creation_time + _time_threshold_sec <= UnixSeconds())) {
+        *score = cumulative_score;
+    }
+}
+
 void CumulativeCompactionPolicy::pick_candidate_rowsets(
         int64_t skip_window_sec,
         const std::unordered_map<Version, RowsetSharedPtr, HashOfVersion>& rs_version_map,
@@ -488,6 +643,9 @@ CumulativeCompactionPolicyFactory::create_cumulative_compaction_policy(std::stri
     } else if (policy_type == SIZE_BASED_POLICY) {
         return std::unique_ptr<CumulativeCompactionPolicy>(
                 new SizeBasedCumulativeCompactionPolicy());
+    } else if (policy_type == TIME_SERIES_POLICY) {
+        return std::unique_ptr<CumulativeCompactionPolicy>(
+                new TimeSeriesCumulativeCompactionPolicy());
     }
 
     return std::shared_ptr<CumulativeCompactionPolicy>(new NumBasedCumulativeCompactionPolicy());
@@ -499,6 +657,8 @@ void CumulativeCompactionPolicyFactory::_parse_cumulative_compaction_policy(
         *policy_type = NUM_BASED_POLICY;
     } else if (type == CUMULATIVE_SIZE_BASED_POLICY) {
         *policy_type = SIZE_BASED_POLICY;
+    } else if (type == CUMULATIVE_TIME_SERIES_POLICY) {
+        *policy_type = TIME_SERIES_POLICY;
     } else {
         LOG(WARNING) << "parse cumulative compaction policy error " << type << ", default use "
                      << CUMULATIVE_NUM_BASED_POLICY;
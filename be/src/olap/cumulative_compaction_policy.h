@@ -30,16 +30,19 @@ namespace doris {
 class Tablet;
 
 /// This CompactionPolicy enum is used to represent the type of compaction policy.
-/// Now it has two values, NUM_BASED_POLICY and SIZE_BASED_POLICY.
+/// Now it has three values, NUM_BASED_POLICY, SIZE_BASED_POLICY and TIME_SERIES_POLICY.
 /// NUM_BASED_POLICY means current compaction policy implemented by num based policy.
 /// SIZE_BASED_POLICY means current compaction policy implemented by size_based policy.
+/// TIME_SERIES_POLICY means current compaction policy implemented by time series policy.
 enum CompactionPolicy {
     NUM_BASED_POLICY = 0,
     SIZE_BASED_POLICY = 1,
+    TIME_SERIES_POLICY = 2,
 };
 
 const static std::string CUMULATIVE_NUM_BASED_POLICY = "NUM_BASED";
 const static std::string CUMULATIVE_SIZE_BASED_POLICY = "SIZE_BASED";
+const static std::string CUMULATIVE_TIME_SERIES_POLICY = "TIME_SERIES";
 /// This class CumulativeCompactionPolicy is the base class of cumulative compaction policy.
 /// It defines the policy to do cumulative compaction. It has different derived classes, which implements
 /// concrete cumulative compaction algorithm. The policy is configured by conf::cumulative_compaction_policy.
@@ -245,11 +248,68 @@ private:
     std::vector<int64_t> _levels;
 };
 
+/// Time series cumulative compaction policy implemention. It's for the append-only tablets which receive
+/// many small and non-overlapping loads, such as logs and metrics. The cumulative rowsets are batched until
+/// they reach the goal size, or their count or the age of the oldest one reaches the thresholds, and the output
+/// rowset is compacted only once if it reaches the goal size, so each row is rewritten once or twice by
+/// cumulative compaction. The non-overlapping outputs of ordered keys are linked by base compaction.
+class TimeSeriesCumulativeCompactionPolicy final : public CumulativeCompactionPolicy {
+public:
+    TimeSeriesCumulativeCompactionPolicy(
+            int64_t goal_size = config::time_series_compaction_goal_size_mbytes * 1024 * 1024,
+            int64_t file_count_threshold = config::time_series_compaction_file_count_threshold,
+            int64_t time_threshold_sec = config::time_series_compaction_time_threshold_seconds);
+
+    ~TimeSeriesCumulativeCompactionPolicy() {}
+
+    /// Time series cumulative compaction policy implements calculate cumulative point function.
+    /// When the first time the tablet does compact, this calculation is executed. Its main policy is to find first rowset
+    /// which is overlapping or smaller than the goal size.
+    void calculate_cumulative_point(Tablet* tablet,
+                                    const std::vector<RowsetMetaSharedPtr>& all_rowsets,
+                                    int64_t current_cumulative_point,
+                                    int64_t* cumulative_point) override;
+
+    /// Time series cumulative compaction policy implements pick input rowsets function.
+    /// Its main policy is picking the continuous rowsets until their total size reaches the goal size, and
+    /// only compacting them if one of the size, the count and the time thresholds is reached. The leading
+    /// non-overlapping rowsets which already reach the goal size are skipped by moving the cumulative point.
+    int pick_input_rowsets(Tablet* tablet, const std::vector<RowsetSharedPtr>& candidate_rowsets,
+                           const int64_t max_compaction_score, const int64_t min_compaction_score,
+                           std::vector<RowsetSharedPtr>* input_rowsets,
+                           Version* last_delete_version, size_t* compaction_score) override;
+
+    /// Time series cumulative compaction policy implements update cumulative point function.
+    /// The cumulative point moves after the output rowset if it reaches the goal size, otherwise the output
+    /// rowset is compacted with the following rowsets once more.
+    void update_cumulative_point(Tablet* tablet, const std::vector<RowsetSharedPtr>& input_rowsets,
+                                 RowsetSharedPtr _output_rowset,
+                                 Version& last_delete_version) override;
+
+    /// Time series cumulative compaction policy implements calc cumulative compaction score function.
+    /// The score is the accumulative compaction score after the cumulative point if one of the thresholds
+    /// is reached, otherwise 0, so the tablets waiting for more loads are not picked.
+    void calc_cumulative_compaction_score(TabletState state,
+                                          const std::vector<RowsetMetaSharedPtr>& all_rowsets,
+                                          int64_t current_cumulative_point,
+                                          uint32_t* score) override;
+
+    std::string name() override { return CUMULATIVE_TIME_SERIES_POLICY; }
+
+private:
+    /// the goal size of the output rowset, unit is byte.
+    int64_t _goal_size;
+    /// compact the rowsets if their count reaches it, even if they are smaller than the goal size.
+    int64_t _file_count_threshold;
+    /// compact the rowsets if the oldest one is created before it, unit is second.
+    int64_t _time_threshold_sec;
+};
+
 /// The factory of CumulativeCompactionPolicy, it can product different policy according to the `policy` parameter.
 class CumulativeCompactionPolicyFactory {
 public:
     /// Static factory function. It can product different policy according to the `policy` parameter and use tablet ptr
-    /// to construct the policy. Now it can product size based and num based policies.
+    /// to construct the policy. Now it can product size based, num based and time series policies.
     static std::shared_ptr<CumulativeCompactionPolicy> create_cumulative_compaction_policy(
             std::string policy);
 
@@ -23,6 +23,7 @@
 #include <sys/file.h>
 #include <sys/statfs.h>
 #include <utime.h>
+#include <algorithm>
 #include <atomic>
 
 #include <boost/algorithm/string/classification.hpp>
@@ -43,10 +44,16 @@
 #include "olap/tablet_meta_manager.h"
 #include "olap/utils.h" // for check_dir_existed
 #include "service/backend_options.h"
+#include "util/disk_info.h"
+#include "util/doris_metrics.h"
 #include "util/errno.h"
 #include "util/file_utils.h"
 #include "util/storage_backend.h"
 #include "util/storage_backend_mgr.h"
+#include "util/stopwatch.hpp"
+#include "util/system_metrics.h"
+#include "util/threadpool.h"
+#include "util/time.h"
 
 #include "util/string_util.h"
 
@@ -60,6 +67,10 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_data_used_capacity, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_state, MetricUnit::BYTES);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_score, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_compaction_num, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_io_util_percent, MetricUnit::PERCENT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_rowset_meta_ms, MetricUnit::MILLISECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_tablet_ms, MetricUnit::MILLISECONDS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(disks_load_rowset_ms, MetricUnit::MILLISECONDS);
 
 static const char* const kTestFilePath = "/.testfile";
 
@@ -88,6 +99,10 @@ DataDir::DataDir(const std::string& path, int64_t capacity_bytes,
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_state);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_score);
     INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_compaction_num);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_io_util_percent);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_rowset_meta_ms);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_tablet_ms);
+    INT_GAUGE_METRIC_REGISTER(_data_dir_metric_entity, disks_load_rowset_ms);
 }
 
 DataDir::~DataDir() {
@@ -107,6 +122,8 @@ Status DataDir::init() {
     RETURN_NOT_OK_STATUS_WITH_WARN(_init_cluster_id(), "_init_cluster_id failed");
     RETURN_NOT_OK_STATUS_WITH_WARN(_init_capacity(), "_init_capacity failed");
     RETURN_NOT_OK_STATUS_WITH_WARN(_init_meta(), "_init_meta failed");
+    _init_disk_device();
+    RETURN_NOT_OK_STATUS_WITH_WARN(_init_remote_file_cache(), "_init_remote_file_cache failed");
 
     _is_used = true;
     return Status::OK();
@@ -118,6 +135,16 @@ void DataDir::stop_bg_worker() {
     _check_path_cv.notify_one();
 }
 
+Status DataDir::_init_remote_file_cache() {
+    if (config::remote_file_cache_capacity_per_disk <= 0) {
+        return Status::OK();
+    }
+    _remote_file_cache = std::make_unique<fs::RemoteFileCache>(
+            _path_desc.filepath + REMOTE_FILE_CACHE_PREFIX,
+            config::remote_file_cache_capacity_per_disk, config::remote_file_cache_block_size);
+    return _remote_file_cache->init();
+}
+
 Status DataDir::_init_cluster_id() {
     FilePathDescStream path_desc_s;
     path_desc_s << _path_desc << CLUSTER_ID_PREFIX;
@@ -374,39 +401,75 @@ Status DataDir::load() {
     // necessarily check incompatible old format. when there are old metas, it may load to data missing
     _check_incompatible_old_format_tablet();
 
+    std::unique_ptr<ThreadPool> load_pool;
+    int load_threads = std::max(1, config::load_data_dir_thread_num_per_disk);
+    RETURN_IF_ERROR(ThreadPoolBuilder("DataDirLoad")
+                            .set_min_threads(load_threads)
+                            .set_max_threads(load_threads)
+                            .build(&load_pool));
+
     std::vector<RowsetMetaSharedPtr> dir_rowset_metas;
+    MonotonicStopWatch watch;
+    watch.start();
     LOG(INFO) << "begin loading rowset from meta";
-    auto load_rowset_func = [&dir_rowset_metas](TabletUid tablet_uid, RowsetId rowset_id,
+    std::vector<std::pair<RowsetId, std::string>> rowset_meta_strs;
+    auto load_rowset_func = [&rowset_meta_strs](TabletUid tablet_uid, RowsetId rowset_id,
                                                 const std::string& meta_str) -> bool {
-        RowsetMetaSharedPtr rowset_meta(new AlphaRowsetMeta());
-        bool parsed = rowset_meta->init(meta_str);
-        if (!parsed) {
-            LOG(WARNING) << "parse rowset meta string failed for rowset_id:" << rowset_id;
-            // return false will break meta iterator, return true to skip this error
-            return true;
-        }
-        dir_rowset_metas.push_back(rowset_meta);
+        rowset_meta_strs.emplace_back(rowset_id, meta_str);
         return true;
     };
     Status load_rowset_status = RowsetMetaManager::traverse_rowset_metas(_meta, load_rowset_func);
+    // decode the rowset metas in parallel, each task decodes a slice of them
+    dir_rowset_metas.resize(rowset_meta_strs.size());
+    _parallel_load(load_pool.get(), rowset_meta_strs.size(),
+                   [&rowset_meta_strs, &dir_rowset_metas](size_t i) {
+                       RowsetMetaSharedPtr rowset_meta(new AlphaRowsetMeta());
+                       if (!rowset_meta->init(rowset_meta_strs[i].second)) {
+                           LOG(WARNING) << "parse rowset meta string failed for rowset_id:"
+                                        << rowset_meta_strs[i].first;
+                           // skip this error
+                           return;
+                       }
+                       dir_rowset_metas[i] = std::move(rowset_meta);
+                   });
+    rowset_meta_strs.clear();
+    dir_rowset_metas.erase(std::remove(dir_rowset_metas.begin(), dir_rowset_metas.end(), nullptr),
+                           dir_rowset_metas.end());
+    disks_load_rowset_meta_ms->set_value(watch.elapsed_time() / 1000 / 1000);
 
     if (!load_rowset_status) {
         LOG(WARNING) << "errors when load rowset meta from meta env, skip this data dir:"
                      << _path_desc.filepath;
     } else {
-        LOG(INFO) << "load rowset from meta finished, data dir: " << _path_desc.filepath;
+        LOG(INFO) << "load rowset from meta finished, data dir: " << _path_desc.filepath
+                  << ", cost " << disks_load_rowset_meta_ms->value() << "ms";
     }
 
     // load tablet
     // create tablet from tablet meta and add it to tablet mgr
+    watch.reset();
     LOG(INFO) << "begin loading tablet from meta";
+    struct TabletMetaStr {
+        int64_t tablet_id;
+        int32_t schema_hash;
+        std::string value;
+    };
+    std::vector<TabletMetaStr> tablet_meta_strs;
+    auto load_tablet_func = [&tablet_meta_strs](int64_t tablet_id, int32_t schema_hash,
+                                                const std::string& value) -> bool {
+        tablet_meta_strs.push_back({tablet_id, schema_hash, value});
+        return true;
+    };
+    Status load_tablet_status = TabletMetaManager::traverse_headers(_meta, load_tablet_func);
+    std::mutex tablet_ids_lock;
     std::set<int64_t> tablet_ids;
     std::set<int64_t> failed_tablet_ids;
-    auto load_tablet_func = [this, &tablet_ids, &failed_tablet_ids](
-                                    int64_t tablet_id, int32_t schema_hash,
-                                    const std::string& value) -> bool {
-        Status status = _tablet_manager->load_tablet_from_meta(this, tablet_id, schema_hash, value,
-                                                               false, false, false, false);
+    _parallel_load(load_pool.get(), tablet_meta_strs.size(), [&](size_t i) {
+        const TabletMetaStr& meta_str = tablet_meta_strs[i];
+        Status status = _tablet_manager->load_tablet_from_meta(
+                this, meta_str.tablet_id, meta_str.schema_hash, meta_str.value, false, false,
+                false, false);
+        std::lock_guard<std::mutex> l(tablet_ids_lock);
         if (!status.ok() &&
             status != Status::OLAPInternalError(OLAP_ERR_TABLE_ALREADY_DELETED_ERROR) &&
             status != Status::OLAPInternalError(OLAP_ERR_ENGINE_INSERT_OLD_TABLET)) {
@@ -425,14 +488,14 @@ Status DataDir::load() {
             // may be older than previously loaded one, which should not be acknowledged as a
             // failure.
             LOG(WARNING) << "load tablet from header failed. status:" << status
-                         << ", tablet=" << tablet_id << "." << schema_hash;
-            failed_tablet_ids.insert(tablet_id);
+                         << ", tablet=" << meta_str.tablet_id << "." << meta_str.schema_hash;
+            failed_tablet_ids.insert(meta_str.tablet_id);
         } else {
-            tablet_ids.insert(tablet_id);
+            tablet_ids.insert(meta_str.tablet_id);
         }
-        return true;
-    };
-    Status load_tablet_status = TabletMetaManager::traverse_headers(_meta, load_tablet_func);
+    });
+    tablet_meta_strs.clear();
+    disks_load_tablet_ms->set_value(watch.elapsed_time() / 1000 / 1000);
     if (failed_tablet_ids.size() != 0) {
         LOG(WARNING) << "load tablets from header failed"
                      << ", loaded tablet: " << tablet_ids.size()
@@ -452,84 +515,123 @@ Status DataDir::load() {
         LOG(INFO) << "load tablet from meta finished"
                   << ", loaded tablet: " << tablet_ids.size()
                   << ", error tablet: " << failed_tablet_ids.size()
-                  << ", path: " << _path_desc.filepath;
+                  << ", path: " << _path_desc.filepath
+                  << ", cost " << disks_load_tablet_ms->value() << "ms";
     }
 
     // traverse rowset
     // 1. add committed rowset to txn map
     // 2. add visible rowset to tablet
     // ignore any errors when load tablet or rowset, because fe will repair them after report
-    int64_t invalid_rowset_counter = 0;
-    for (auto rowset_meta : dir_rowset_metas) {
-        TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
-                                                             rowset_meta->tablet_schema_hash());
-        // tablet maybe dropped, but not drop related rowset meta
-        if (tablet == nullptr) {
-            VLOG_NOTICE << "could not find tablet id: " << rowset_meta->tablet_id()
-                        << ", schema hash: " << rowset_meta->tablet_schema_hash()
-                        << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
-            ++invalid_rowset_counter;
-            continue;
-        }
-        RowsetSharedPtr rowset;
-        Status create_status = RowsetFactory::create_rowset(
-                &tablet->tablet_schema(), tablet->tablet_path_desc(), rowset_meta, &rowset);
-        if (!create_status) {
-            LOG(WARNING) << "could not create rowset from rowsetmeta: "
-                         << " rowset_id: " << rowset_meta->rowset_id()
-                         << " rowset_type: " << rowset_meta->rowset_type()
-                         << " rowset_state: " << rowset_meta->rowset_state();
-            continue;
-        }
-        if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
-            rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            Status commit_txn_status = _txn_manager->commit_txn(
-                    _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
-                    rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
-                    rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
-            if (!commit_txn_status &&
-                commit_txn_status !=
-                        Status::OLAPInternalError(OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST)) {
-                LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
-                             << " to tablet: " << rowset_meta->tablet_id()
-                             << " for txn: " << rowset_meta->txn_id();
-            } else {
-                LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
-                          << " to tablet: " << rowset_meta->tablet_id()
-                          << " schema hash: " << rowset_meta->tablet_schema_hash()
-                          << " for txn: " << rowset_meta->txn_id();
-            }
-        } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
-                   rowset_meta->tablet_uid() == tablet->tablet_uid()) {
-            Status publish_status = tablet->add_rowset(rowset, false);
-            if (!publish_status &&
-                publish_status != Status::OLAPInternalError(OLAP_ERR_PUSH_VERSION_ALREADY_EXIST)) {
-                LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
-                             << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
-                             << " txn id:" << rowset_meta->txn_id()
-                             << " start_version: " << rowset_meta->version().first
-                             << " end_version: " << rowset_meta->version().second;
+    watch.reset();
+    // the rowsets of a tablet are added by the same task, so they don't contend for the
+    // header lock of the tablet
+    std::vector<std::vector<RowsetMetaSharedPtr>> rowset_metas_by_task(load_threads);
+    for (auto& rowset_meta : dir_rowset_metas) {
+        rowset_metas_by_task[rowset_meta->tablet_id() % load_threads].push_back(rowset_meta);
+    }
+    std::atomic<int64_t> invalid_rowset_counter {0};
+    _parallel_load(load_pool.get(), rowset_metas_by_task.size(), [&](size_t i) {
+        for (auto& rowset_meta : rowset_metas_by_task[i]) {
+            if (!_load_rowset(rowset_meta)) {
+                ++invalid_rowset_counter;
             }
-        } else {
-            LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
-                         << " with tablet id: " << rowset_meta->tablet_id()
-                         << " tablet uid: " << rowset_meta->tablet_uid()
-                         << " schema hash: " << rowset_meta->tablet_schema_hash()
-                         << " txn: " << rowset_meta->txn_id()
-                         << " current valid tablet uid: " << tablet->tablet_uid();
-            ++invalid_rowset_counter;
         }
-    }
+    });
+    load_pool->shutdown();
+    disks_load_rowset_ms->set_value(watch.elapsed_time() / 1000 / 1000);
     // At startup, we only count these invalid rowset, but do not actually delete it.
     // The actual delete operation is in StorageEngine::_clean_unused_rowset_metas,
     // which is cleaned up uniformly by the background cleanup thread.
     LOG(INFO) << "finish to load tablets from " << _path_desc.filepath
               << ", total rowset meta: " << dir_rowset_metas.size()
-              << ", invalid rowset num: " << invalid_rowset_counter;
+              << ", invalid rowset num: " << invalid_rowset_counter
+              << ", cost " << disks_load_rowset_ms->value() << "ms";
 
     return Status::OK();
 }
 
+void DataDir::_parallel_load(ThreadPool* pool, size_t num_items,
+                             const std::function<void(size_t)>& load_func) {
+    // a task loads a slice of the items, so the tasks are not too small to submit
+    const size_t num_tasks = std::min<size_t>(
+            num_items, std::max(1, config::load_data_dir_thread_num_per_disk) * 4);
+    for (size_t task = 0; task < num_tasks; ++task) {
+        size_t begin = num_items * task / num_tasks;
+        size_t end = num_items * (task + 1) / num_tasks;
+        auto func = [&load_func, begin, end] {
+            for (size_t i = begin; i < end; ++i) {
+                load_func(i);
+            }
+        };
+        if (!pool->submit_func(func).ok()) {
+            func();
+        }
+    }
+    pool->wait();
+}
+
+bool DataDir::_load_rowset(const RowsetMetaSharedPtr& rowset_meta) {
+    TabletSharedPtr tablet = _tablet_manager->get_tablet(rowset_meta->tablet_id(),
+                                                         rowset_meta->tablet_schema_hash());
+    // tablet maybe dropped, but not drop related rowset meta
+    if (tablet == nullptr) {
+        VLOG_NOTICE << "could not find tablet id: " << rowset_meta->tablet_id()
+                    << ", schema hash: " << rowset_meta->tablet_schema_hash()
+                    << ", for rowset: " << rowset_meta->rowset_id() << ", skip this rowset";
+        return false;
+    }
+    RowsetSharedPtr rowset;
+    Status create_status = RowsetFactory::create_rowset(
+            &tablet->tablet_schema(), tablet->tablet_path_desc(), rowset_meta, &rowset);
+    if (!create_status) {
+        LOG(WARNING) << "could not create rowset from rowsetmeta: "
+                     << " rowset_id: " << rowset_meta->rowset_id()
+                     << " rowset_type: " << rowset_meta->rowset_type()
+                     << " rowset_state: " << rowset_meta->rowset_state();
+        return true;
+    }
+    if (rowset_meta->rowset_state() == RowsetStatePB::COMMITTED &&
+        rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        Status commit_txn_status = _txn_manager->commit_txn(
+                _meta, rowset_meta->partition_id(), rowset_meta->txn_id(),
+                rowset_meta->tablet_id(), rowset_meta->tablet_schema_hash(),
+                rowset_meta->tablet_uid(), rowset_meta->load_id(), rowset, true);
+        if (!commit_txn_status &&
+            commit_txn_status !=
+                    Status::OLAPInternalError(OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST)) {
+            LOG(WARNING) << "failed to add committed rowset: " << rowset_meta->rowset_id()
+                         << " to tablet: " << rowset_meta->tablet_id()
+                         << " for txn: " << rowset_meta->txn_id();
+        } else {
+            LOG(INFO) << "successfully to add committed rowset: " << rowset_meta->rowset_id()
+                      << " to tablet: " << rowset_meta->tablet_id()
+                      << " schema hash: " << rowset_meta->tablet_schema_hash()
+                      << " for txn: " << rowset_meta->txn_id();
+        }
+    } else if (rowset_meta->rowset_state() == RowsetStatePB::VISIBLE &&
+               rowset_meta->tablet_uid() == tablet->tablet_uid()) {
+        Status publish_status = tablet->add_rowset(rowset, false);
+        if (!publish_status &&
+            publish_status != Status::OLAPInternalError(OLAP_ERR_PUSH_VERSION_ALREADY_EXIST)) {
+            LOG(WARNING) << "add visible rowset to tablet failed rowset_id:"
+                         << rowset->rowset_id() << " tablet id: " << rowset_meta->tablet_id()
+                         << " txn id:" << rowset_meta->txn_id()
+                         << " start_version: " << rowset_meta->version().first
+                         << " end_version: " << rowset_meta->version().second;
+        }
+    } else {
+        LOG(WARNING) << "find invalid rowset: " << rowset_meta->rowset_id()
+                     << " with tablet id: " << rowset_meta->tablet_id()
+                     << " tablet uid: " << rowset_meta->tablet_uid()
+                     << " schema hash: " << rowset_meta->tablet_schema_hash()
+                     << " txn: " << rowset_meta->txn_id()
+                     << " current valid tablet uid: " << tablet->tablet_uid();
+        return false;
+    }
+    return true;
+}
+
 void DataDir::add_pending_ids(const std::string& id) {
     std::lock_guard<std::shared_mutex> wr_lock(_pending_path_mutex);
     _pending_path_ids.insert(id);
@@ -762,6 +864,46 @@ void DataDir::disks_compaction_num_increment(int64_t delta) {
     disks_compaction_num->increment(delta);
 }
 
+void DataDir::_init_disk_device() {
+    if (is_remote()) {
+        return;
+    }
+    std::set<std::string> devices;
+    Status st = DiskInfo::get_disk_devices({_path_desc.filepath}, &devices);
+    if (!st.ok() || devices.size() != 1) {
+        LOG(WARNING) << "failed to get disk device of path: " << _path_desc.filepath
+                     << ", io util of the disk will not be monitored, status=" << st;
+        return;
+    }
+    _disk_device = *devices.begin();
+}
+
+void DataDir::update_io_util() {
+    auto system_metrics = DorisMetrics::instance()->system_metrics();
+    if (_disk_device.empty() || system_metrics == nullptr) {
+        return;
+    }
+    int64_t io_time_ms = system_metrics->get_disk_io_time_ms(_disk_device);
+    if (io_time_ms < 0) {
+        return;
+    }
+    int64_t now_ms = UnixMillis();
+    // the disk metrics are refreshed every 15 seconds by the daemon, a shorter interval makes
+    // the io util jitter between 0 and the actual value
+    static constexpr int64_t kMinSampleIntervalMs = 15 * 1000;
+    if (_last_io_sample_ms >= 0 && now_ms - _last_io_sample_ms < kMinSampleIntervalMs) {
+        return;
+    }
+    if (_last_io_sample_ms >= 0 && io_time_ms >= _last_io_time_ms) {
+        int64_t util = (io_time_ms - _last_io_time_ms) * 100 / (now_ms - _last_io_sample_ms);
+        util = std::min<int64_t>(util, 100);
+        _io_util_percent.store(util, std::memory_order_relaxed);
+        disks_io_util_percent->set_value(util);
+    }
+    _last_io_time_ms = io_time_ms;
+    _last_io_sample_ms = now_ms;
+}
+
 // this is moved from src/olap/utils.h, the old move_to_trash() can only support local files,
 // and it is more suitable in DataDir because one trash path is in one DataDir
 Status DataDir::move_to_trash(const FilePathDesc& segment_path_desc) {
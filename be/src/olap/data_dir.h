@@ -17,24 +17,32 @@
 
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <shared_mutex>
 #include <string>
 
+#include "common/config.h"
 #include "common/status.h"
 #include "env/env.h"
 #include "gen_cpp/Types_types.h"
 #include "gen_cpp/olap_file.pb.h"
+#include "olap/fs/remote_file_cache.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/rowset_id_generator.h"
+#include "olap/rowset/rowset_meta.h"
 #include "util/metrics.h"
+#include "util/rate_limiter.h"
 
 namespace doris {
 
 class Tablet;
+class ThreadPool;
 class TabletManager;
 class TabletMeta;
 class TxnManager;
@@ -59,6 +67,9 @@ public:
     int32_t cluster_id() const { return _cluster_id; }
     bool cluster_id_incomplete() const { return _cluster_id_incomplete; }
 
+    // the local cache of the remote segment files, nullptr if not enabled
+    fs::RemoteFileCache* remote_file_cache() const { return _remote_file_cache.get(); }
+
     DataDirInfo get_dir_info() {
         DataDirInfo info;
         info.path_desc = _path_desc;
@@ -131,6 +142,16 @@ public:
 
     void disks_compaction_num_increment(int64_t delta);
 
+    // Sample the io time of the disk device of this data dir, and update the io util percent
+    // over the time elapsed since the last sample.
+    void update_io_util();
+
+    // io util percent of the disk device of this data dir, 0 if the disk is not monitored.
+    int32_t io_util_percent() const { return _io_util_percent.load(std::memory_order_relaxed); }
+
+    // limit the writes of the files downloaded by the clones to this data dir
+    RateLimiter* clone_download_limiter() { return &_clone_download_limiter; }
+
     // Move segment_path_desc to trash, trash is in storage_root/trash, segment_path_desc can be file or dir
     // Modify segment_path_desc when this operation is being done.
     // filepath is replaced by：
@@ -159,6 +180,15 @@ private:
 
     bool _check_pending_ids(const std::string& id);
 
+    void _init_disk_device();
+    Status _init_remote_file_cache();
+
+    // call load_func(i) for i in [0, num_items) by the threads of pool, and wait for them
+    static void _parallel_load(ThreadPool* pool, size_t num_items,
+                               const std::function<void(size_t)>& load_func);
+    // add the rowset to its tablet or txn, return false if the rowset is invalid
+    bool _load_rowset(const RowsetMetaSharedPtr& rowset_meta);
+
 private:
     bool _stop_bg_worker = false;
 
@@ -173,6 +203,13 @@ private:
     // the actual capacity of the disk of this data dir
     int64_t _disk_capacity_bytes;
     TStorageMedium::type _storage_medium;
+    // the disk device of this data dir in /proc/diskstats, empty if it's unknown
+    std::string _disk_device;
+    int64_t _last_io_time_ms = -1;
+    int64_t _last_io_sample_ms = -1;
+    std::atomic<int32_t> _io_util_percent {0};
+    RateLimiter _clone_download_limiter {
+            []() { return config::clone_disk_download_speed_limit_mbps * 1024L * 1024; }};
     bool _is_used;
 
     TabletManager* _tablet_manager;
@@ -191,6 +228,7 @@ private:
 
     OlapMeta* _meta = nullptr;
     RowsetIdGenerator* _id_generator = nullptr;
+    std::unique_ptr<fs::RemoteFileCache> _remote_file_cache;
 
     std::mutex _check_path_mutex;
     std::condition_variable _check_path_cv;
@@ -207,6 +245,11 @@ private:
     IntGauge* disks_state;
     IntGauge* disks_compaction_score;
     IntGauge* disks_compaction_num;
+    IntGauge* disks_io_util_percent;
+    // the time to load the metas at startup
+    IntGauge* disks_load_rowset_meta_ms;
+    IntGauge* disks_load_tablet_ms;
+    IntGauge* disks_load_rowset_ms;
 };
 
 } // namespace doris
@@ -17,9 +17,12 @@
 
 #include "olap/delta_writer.h"
 
+#include <filesystem>
+
 #include "olap/data_dir.h"
 #include "olap/memtable.h"
 #include "olap/memtable_flush_executor.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/schema.h"
 #include "olap/schema_change.h"
@@ -353,6 +356,30 @@ Status DeltaWriter::close_wait(google::protobuf::RepeatedPtrField<PTabletInfo>*
     return Status::OK();
 }
 
+Status DeltaWriter::build_slave_pull_request(PTabletWriteSlaveRequest* request) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_delta_written_success) {
+        return Status::InternalError("the rowset is not committed");
+    }
+    if (_cur_rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+        return Status::NotSupported("only the beta rowsets can be pulled by the slave replicas");
+    }
+    _cur_rowset->rowset_meta()->to_rowset_pb(request->mutable_rowset_meta());
+    request->set_rowset_path(_cur_rowset->rowset_path_desc().filepath);
+    for (int64_t segment_id = 0; segment_id < _cur_rowset->num_segments(); ++segment_id) {
+        auto path_desc = BetaRowset::segment_file_path(_cur_rowset->rowset_path_desc(),
+                                                       _cur_rowset->rowset_id(), segment_id);
+        std::error_code ec;
+        auto file_size = std::filesystem::file_size(path_desc.filepath, ec);
+        if (ec) {
+            return Status::InternalError("failed to get the size of segment " +
+                                         path_desc.filepath + ": " + ec.message());
+        }
+        (*request->mutable_segments_size())[segment_id] = file_size;
+    }
+    return Status::OK();
+}
+
 Status DeltaWriter::cancel() {
     std::lock_guard<std::mutex> l(_lock);
     if (!_is_init || _is_cancelled) {
@@ -367,6 +394,14 @@ Status DeltaWriter::cancel() {
     return Status::OK();
 }
 
+int64_t DeltaWriter::active_memtable_mem_consumption() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_is_init || _is_cancelled || _mem_table == nullptr) {
+        return 0;
+    }
+    return _mem_table->memory_usage();
+}
+
 int64_t DeltaWriter::mem_consumption() const {
     if (_mem_tracker == nullptr) {
         // This method may be called before this writer is initialized.
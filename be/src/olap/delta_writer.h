@@ -69,6 +69,10 @@ public:
     // mem_consumption() should be 0 after this function returns.
     Status close_wait(google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec, bool is_broken);
 
+    // Fill the rowset meta and the segment files of the rowset committed by close_wait() into
+    // the request to ask a slave replica to pull the rowset, in the single replica load.
+    Status build_slave_pull_request(PTabletWriteSlaveRequest* request);
+
     // abandon current memtable and wait for all pending-flushing memtables to be destructed.
     // mem_consumption() should be 0 after this function returns.
     Status cancel();
@@ -84,6 +88,9 @@ public:
 
     int64_t mem_consumption() const;
 
+    // the mem consumption of the memtable being written, without the ones being flushed
+    int64_t active_memtable_mem_consumption();
+
     // Wait all memtable in flush queue to be flushed
     Status wait_flush();
 
@@ -161,6 +161,16 @@ public:
     // If an error was encountered, returns a non-OK status.
     virtual Status readv(uint64_t offset, const Slice* res, size_t res_cnt) const = 0;
 
+    // Reads the "req_cnt" ranges of "requests" at once if it's supported by the block,
+    // see RandomAccessFile::read_batch_at().
+    // If an error was encountered, returns a non-OK status.
+    virtual Status read_batch(const ReadRequest* requests, size_t req_cnt) const {
+        for (size_t i = 0; i < req_cnt; ++i) {
+            RETURN_IF_ERROR(read(requests[i].offset, requests[i].result));
+        }
+        return Status::OK();
+    }
+
     // Returns the memory usage of this object including the object itself.
     // virtual size_t memory_footprint() const = 0;
 };
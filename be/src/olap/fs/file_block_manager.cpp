@@ -271,6 +271,8 @@ public:
 
     virtual Status readv(uint64_t offset, const Slice* results, size_t res_cnt) const override;
 
+    Status read_batch(const ReadRequest* requests, size_t req_cnt) const override;
+
     void handle_error(const Status& s) const;
 
 private:
@@ -362,6 +364,22 @@ Status FileReadableBlock::readv(uint64_t offset, const Slice* results, size_t re
     return Status::OK();
 }
 
+Status FileReadableBlock::read_batch(const ReadRequest* requests, size_t req_cnt) const {
+    DCHECK(!_closed.load());
+
+    RETURN_IF_ERROR(_file->read_batch_at(requests, req_cnt));
+
+    if (_block_manager->_metrics) {
+        size_t bytes_read = 0;
+        for (size_t i = 0; i < req_cnt; ++i) {
+            bytes_read += requests[i].result.size;
+        }
+        _block_manager->_metrics->total_bytes_read->increment(bytes_read);
+    }
+
+    return Status::OK();
+}
+
 } // namespace internal
 
 ////////////////////////////////////////////////////////////
@@ -374,13 +392,16 @@ FileBlockManager::FileBlockManager(Env* env, BlockManagerOptions opts)
         _metrics.reset(new internal::BlockManagerMetrics());
     }
 
-#ifdef BE_TEST
+#ifndef BE_TEST
+    if (StorageEngine::instance() != nullptr) {
+        _file_cache.reset(new FileCache<RandomAccessFile>("Readable_file_cache",
+                                                          StorageEngine::instance()->file_cache()));
+        return;
+    }
+#endif
+    // the tests and the tools read the files without a storage engine
     _file_cache.reset(new FileCache<RandomAccessFile>("Readable_file_cache",
                                                       config::file_descriptor_cache_capacity));
-#else
-    _file_cache.reset(new FileCache<RandomAccessFile>("Readable_file_cache",
-                                                      StorageEngine::instance()->file_cache()));
-#endif
 }
 
 FileBlockManager::~FileBlockManager() {}
@@ -412,7 +433,9 @@ Status FileBlockManager::open_block(const FilePathDesc& path_desc,
     bool found = _file_cache->lookup(path_desc.filepath, file_handle.get());
     if (!found) {
         std::unique_ptr<RandomAccessFile> file;
-        RETURN_IF_ERROR(_env->new_random_access_file(path_desc.filepath, &file));
+        RandomAccessFileOptions file_opts;
+        file_opts.use_direct_io = config::enable_segment_direct_io_read;
+        RETURN_IF_ERROR(_env->new_random_access_file(file_opts, path_desc.filepath, &file));
         _file_cache->insert(path_desc.filepath, file.release(), file_handle.get());
     }
 
@@ -18,6 +18,7 @@
 #include "olap/fs/remote_block_manager.h"
 
 #include <atomic>
+#include <cstring>
 #include <cstddef>
 #include <memory>
 #include <numeric>
@@ -31,7 +32,10 @@
 #include "env/env_posix.h"
 #include "env/env_util.h"
 #include "gutil/strings/substitute.h"
+#include "olap/data_dir.h"
 #include "olap/fs/block_id.h"
+#include "olap/fs/remote_file_cache.h"
+#include "olap/storage_engine.h"
 #include "util/storage_backend.h"
 
 using std::shared_ptr;
@@ -181,7 +185,8 @@ Status RemoteWritableBlock::_close(SyncMode mode) {
 class RemoteReadableBlock : public ReadableBlock {
 public:
     RemoteReadableBlock(RemoteBlockManager* block_manager, const FilePathDesc& path_desc,
-                        std::shared_ptr<OpenedFileHandle<RandomAccessFile>> file_handle);
+                        std::shared_ptr<OpenedFileHandle<RandomAccessFile>> file_handle,
+                        RemoteFileCache* remote_file_cache);
 
     virtual ~RemoteReadableBlock();
 
@@ -212,6 +217,8 @@ private:
     std::shared_ptr<OpenedFileHandle<RandomAccessFile>> _file_handle;
     // the backing file of OpenedFileHandle, not owned.
     RandomAccessFile* _file = nullptr;
+    // the local cache of the remote file, nullptr if not enabled, not owned.
+    RemoteFileCache* _remote_file_cache;
 
     // Whether or not this block has been closed. Close() is thread-safe, so
     // this must be an atomic primitive.
@@ -222,12 +229,29 @@ private:
 
 RemoteReadableBlock::RemoteReadableBlock(
         RemoteBlockManager* block_manager, const FilePathDesc& path_desc,
-        std::shared_ptr<OpenedFileHandle<RandomAccessFile>> file_handle) {}
+        std::shared_ptr<OpenedFileHandle<RandomAccessFile>> file_handle,
+        RemoteFileCache* remote_file_cache)
+        : _block_manager(block_manager),
+          _path_desc(path_desc),
+          _file_handle(std::move(file_handle)),
+          _remote_file_cache(remote_file_cache),
+          _closed(false) {
+    if (_file_handle != nullptr) {
+        _file = _file_handle->file();
+    }
+}
 
-RemoteReadableBlock::~RemoteReadableBlock() {}
+RemoteReadableBlock::~RemoteReadableBlock() {
+    WARN_IF_ERROR(close(), Substitute("Failed to close block $0", _path_desc.filepath));
+}
 
 Status RemoteReadableBlock::close() {
-    return Status::IOError("invalid function", 0, "");
+    bool expected = false;
+    if (_closed.compare_exchange_strong(expected, true)) {
+        _file_handle.reset();
+        _file = nullptr;
+    }
+    return Status::OK();
 }
 
 BlockManager* RemoteReadableBlock::block_manager() const {
@@ -244,7 +268,11 @@ const FilePathDesc& RemoteReadableBlock::path_desc() const {
 }
 
 Status RemoteReadableBlock::size(uint64_t* sz) const {
-    return Status::IOError("invalid function", 0, "");
+    DCHECK(!_closed.load());
+    if (_file != nullptr) {
+        return _file->size(sz);
+    }
+    return _block_manager->_storage_backend->file_size(_path_desc.remote_path, sz);
 }
 
 Status RemoteReadableBlock::read(uint64_t offset, Slice result) const {
@@ -252,7 +280,33 @@ Status RemoteReadableBlock::read(uint64_t offset, Slice result) const {
 }
 
 Status RemoteReadableBlock::readv(uint64_t offset, const Slice* results, size_t res_cnt) const {
-    return Status::IOError("invalid function", 0, "");
+    DCHECK(!_closed.load());
+    // the file is not uploaded yet, or it's kept on the local disk
+    if (_file != nullptr) {
+        return _file->readv_at(offset, results, res_cnt);
+    }
+    StorageBackend* storage_backend = _block_manager->_storage_backend.get();
+    if (_remote_file_cache != nullptr) {
+        return _remote_file_cache->read(storage_backend, _path_desc.remote_path, offset, results,
+                                        res_cnt);
+    }
+    size_t bytes_req = 0;
+    for (size_t i = 0; i < res_cnt; ++i) {
+        bytes_req += results[i].size;
+    }
+    std::string content;
+    RETURN_IF_ERROR(
+            storage_backend->read_range(_path_desc.remote_path, offset, bytes_req, &content));
+    if (content.size() < bytes_req) {
+        return Status::EndOfFile(Substitute("EOF trying to read $0 bytes at offset $1 of $2",
+                                            bytes_req, offset, _path_desc.remote_path));
+    }
+    const char* src = content.data();
+    for (size_t i = 0; i < res_cnt; ++i) {
+        memcpy(results[i].data, src, results[i].size);
+        src += results[i].size;
+    }
+    return Status::OK();
 }
 
 } // namespace internal
@@ -264,7 +318,15 @@ Status RemoteReadableBlock::readv(uint64_t offset, const Slice* results, size_t
 RemoteBlockManager::RemoteBlockManager(Env* local_env,
                                        std::shared_ptr<StorageBackend> storage_backend,
                                        const BlockManagerOptions& opts)
-        : _local_env(local_env), _storage_backend(storage_backend), _opts(opts) {}
+        : _local_env(local_env), _storage_backend(storage_backend), _opts(opts) {
+#ifdef BE_TEST
+    _file_cache.reset(new FileCache<RandomAccessFile>("Readable_file_cache",
+                                                      config::file_descriptor_cache_capacity));
+#else
+    _file_cache.reset(new FileCache<RandomAccessFile>("Readable_file_cache",
+                                                      StorageEngine::instance()->file_cache()));
+#endif
+}
 
 RemoteBlockManager::~RemoteBlockManager() {}
 
@@ -307,10 +369,28 @@ Status RemoteBlockManager::open_block(const FilePathDesc& path_desc,
         }
     }
 
-    block->reset(new internal::RemoteReadableBlock(this, path_desc, file_handle));
+    block->reset(new internal::RemoteReadableBlock(this, path_desc, file_handle,
+                                                   _remote_file_cache(path_desc)));
     return Status::OK();
 }
 
+RemoteFileCache* RemoteBlockManager::_remote_file_cache(const FilePathDesc& path_desc) const {
+    StorageEngine* engine = StorageEngine::instance();
+    if (engine == nullptr || path_desc.remote_path.empty()) {
+        return nullptr;
+    }
+    // the cache of the data dir that the local path of the block belongs to
+    for (DataDir* store : engine->get_stores()) {
+        const std::string& root = store->path();
+        if (path_desc.filepath.size() > root.size() &&
+            path_desc.filepath.compare(0, root.size(), root) == 0 &&
+            path_desc.filepath[root.size()] == '/') {
+            return store->remote_file_cache();
+        }
+    }
+    return nullptr;
+}
+
 Status RemoteBlockManager::delete_block(const FilePathDesc& path_desc, bool is_dir) {
     if (is_dir) {
         if (_local_env->path_exists(path_desc.filepath).ok()) {
@@ -35,6 +35,12 @@ class StorageBackend;
 
 namespace fs {
 
+class RemoteFileCache;
+
+namespace internal {
+class RemoteReadableBlock;
+} // namespace internal
+
 // The remote-backed block manager.
 class RemoteBlockManager : public BlockManager {
 public:
@@ -62,6 +68,11 @@ public:
                      const FilePathDesc& dest_path_desc) override;
 
 private:
+    friend class internal::RemoteReadableBlock;
+
+    // the local cache of the remote file, nullptr if not enabled
+    RemoteFileCache* _remote_file_cache(const FilePathDesc& path_desc) const;
+
     Env* _local_env;
     std::shared_ptr<StorageBackend> _storage_backend;
     const BlockManagerOptions _opts;
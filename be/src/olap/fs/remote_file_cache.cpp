@@ -0,0 +1,271 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/fs/remote_file_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "env/env.h"
+#include "gutil/strings/numbers.h"
+#include "gutil/strings/substitute.h"
+#include "util/murmur_hash3.h"
+#include "util/storage_backend.h"
+#include "util/threadpool.h"
+
+namespace doris {
+namespace fs {
+
+static const std::string TMP_FILE_SUFFIX = ".tmp";
+
+RemoteFileCache::RemoteFileCache(std::string cache_dir, int64_t capacity, int64_t block_size)
+        : _cache_dir(std::move(cache_dir)), _capacity(capacity), _block_size(block_size) {}
+
+RemoteFileCache::~RemoteFileCache() {
+    if (_fill_pool) {
+        _fill_pool->shutdown();
+    }
+}
+
+Status RemoteFileCache::init() {
+    RETURN_IF_ERROR(Env::Default()->create_dirs(_cache_dir));
+    int fill_threads = std::max(1, config::remote_file_cache_fill_thread_num);
+    RETURN_IF_ERROR(ThreadPoolBuilder("RemoteFileCacheFill")
+                            .set_min_threads(1)
+                            .set_max_threads(fill_threads)
+                            .build(&_fill_pool));
+
+    std::vector<std::string> files;
+    RETURN_IF_ERROR(Env::Default()->get_children(_cache_dir, &files));
+    // the blocks used most recently are at the front of the LRU list
+    std::vector<std::pair<uint64_t, std::string>> blocks;
+    for (auto& file : files) {
+        if (file == "." || file == "..") {
+            continue;
+        }
+        std::string path = _cache_dir + "/" + file;
+        if (file.size() > TMP_FILE_SUFFIX.size() &&
+            file.compare(file.size() - TMP_FILE_SUFFIX.size(), TMP_FILE_SUFFIX.size(),
+                         TMP_FILE_SUFFIX) == 0) {
+            // the fill interrupted by the restart
+            Env::Default()->delete_file(path);
+            continue;
+        }
+        uint64_t mtime = 0;
+        if (Env::Default()->get_file_modified_time(path, &mtime).ok()) {
+            blocks.emplace_back(mtime, file);
+        }
+    }
+    std::sort(blocks.begin(), blocks.end());
+
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        for (auto& block : blocks) {
+            uint64_t size = 0;
+            if (Env::Default()->get_file_size(_cache_dir + "/" + block.second, &size).ok()) {
+                _insert(block.second, size, &evicted);
+            }
+        }
+    }
+    _remove_files(evicted);
+    LOG(INFO) << "load remote file cache " << _cache_dir << ", blocks=" << _entries.size()
+              << ", bytes=" << _cached_bytes;
+    return Status::OK();
+}
+
+int64_t RemoteFileCache::cached_bytes() const {
+    std::lock_guard<std::mutex> l(_lock);
+    return _cached_bytes;
+}
+
+std::string RemoteFileCache::_block_key(const std::string& remote_path, uint64_t block_index) {
+    uint64_t hash[2];
+    murmur_hash3_x64_128(remote_path.data(), remote_path.size(), 0, hash);
+    char buf0[kFastToBufferSize];
+    char buf1[kFastToBufferSize];
+    return strings::Substitute("$0$1_$2", FastHex64ToBuffer(hash[0], buf0),
+                               FastHex64ToBuffer(hash[1], buf1), block_index);
+}
+
+Status RemoteFileCache::read(StorageBackend* backend, const std::string& remote_path,
+                             uint64_t offset, const Slice* results, size_t res_cnt) {
+    for (size_t i = 0; i < res_cnt; ++i) {
+        char* dst = results[i].data;
+        size_t rem = results[i].size;
+        while (rem > 0) {
+            uint64_t block_index = offset / _block_size;
+            uint64_t offset_in_block = offset % _block_size;
+            size_t size = std::min<size_t>(rem, _block_size - offset_in_block);
+            RETURN_IF_ERROR(
+                    _read_block(backend, remote_path, block_index, offset_in_block, size, dst));
+            dst += size;
+            rem -= size;
+            offset += size;
+        }
+    }
+    return Status::OK();
+}
+
+Status RemoteFileCache::_read_block(StorageBackend* backend, const std::string& remote_path,
+                                    uint64_t block_index, uint64_t offset_in_block, size_t size,
+                                    char* dst) {
+    std::string key = _block_key(remote_path, block_index);
+    int64_t cached_size = -1;
+    std::shared_ptr<Download> download;
+    bool owner = false;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            _lru.splice(_lru.begin(), _lru, it->second.lru_iter);
+            cached_size = it->second.size;
+        } else {
+            auto& d = _downloads[key];
+            if (d == nullptr) {
+                d = std::make_shared<Download>();
+                owner = true;
+            }
+            download = d;
+        }
+    }
+
+    if (cached_size >= 0) {
+        if (offset_in_block + size > static_cast<uint64_t>(cached_size)) {
+            return Status::EndOfFile(strings::Substitute(
+                    "EOF trying to read $0 bytes at offset $1 of $2", size,
+                    block_index * _block_size + offset_in_block, remote_path));
+        }
+        Status st = _read_local(key, offset_in_block, size, dst);
+        if (st.ok()) {
+            return st;
+        }
+        LOG(WARNING) << "failed to read remote file cache, key=" << key << ", " << st;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            auto it = _entries.find(key);
+            if (it != _entries.end()) {
+                _cached_bytes -= it->second.size;
+                _lru.erase(it->second.lru_iter);
+                _entries.erase(it);
+            }
+        }
+        return _read_block(backend, remote_path, block_index, offset_in_block, size, dst);
+    }
+
+    if (owner) {
+        std::string data;
+        Status st = backend->read_range(remote_path, block_index * _block_size, _block_size,
+                                        &data);
+        {
+            std::lock_guard<std::mutex> l(download->lock);
+            download->status = st;
+            download->data = std::move(data);
+            download->done = true;
+        }
+        download->cond.notify_all();
+        if (!st.ok() || download->data.empty() ||
+            !_fill_pool->submit_func([this, key, download]() { _fill(key, download); }).ok()) {
+            std::lock_guard<std::mutex> l(_lock);
+            _downloads.erase(key);
+        }
+    } else {
+        std::unique_lock<std::mutex> l(download->lock);
+        download->cond.wait(l, [&download] { return download->done; });
+    }
+
+    RETURN_IF_ERROR(download->status);
+    if (offset_in_block + size > download->data.size()) {
+        return Status::EndOfFile(strings::Substitute(
+                "EOF trying to read $0 bytes at offset $1 of $2", size,
+                block_index * _block_size + offset_in_block, remote_path));
+    }
+    memcpy(dst, download->data.data() + offset_in_block, size);
+    return Status::OK();
+}
+
+Status RemoteFileCache::_read_local(const std::string& key, uint64_t offset_in_block,
+                                    size_t size, char* dst) {
+    std::unique_ptr<RandomAccessFile> file;
+    RETURN_IF_ERROR(Env::Default()->new_random_access_file(_cache_dir + "/" + key, &file));
+    Slice result(dst, size);
+    return file->read_at(offset_in_block, &result);
+}
+
+void RemoteFileCache::_fill(const std::string& key, std::shared_ptr<Download> download) {
+    std::string path = _cache_dir + "/" + key;
+    std::string tmp_path = path + TMP_FILE_SUFFIX;
+    Status st;
+    {
+        std::unique_ptr<WritableFile> file;
+        st = Env::Default()->new_writable_file(tmp_path, &file);
+        if (st.ok()) {
+            st = file->append(download->data);
+        }
+        if (st.ok()) {
+            st = file->close();
+        }
+    }
+    if (st.ok()) {
+        st = Env::Default()->rename_file(tmp_path, path);
+    }
+
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (st.ok()) {
+            _insert(key, download->data.size(), &evicted);
+        }
+        _downloads.erase(key);
+    }
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to fill remote file cache, key=" << key << ", " << st;
+        Env::Default()->delete_file(tmp_path);
+    }
+    _remove_files(evicted);
+}
+
+void RemoteFileCache::_insert(const std::string& key, int64_t size,
+                              std::vector<std::string>* evicted) {
+    if (_entries.count(key) > 0) {
+        return;
+    }
+    _lru.push_front(key);
+    _entries[key] = {size, _lru.begin()};
+    _cached_bytes += size;
+    while (_cached_bytes > _capacity && !_lru.empty()) {
+        const std::string& victim = _lru.back();
+        auto it = _entries.find(victim);
+        _cached_bytes -= it->second.size;
+        _entries.erase(it);
+        evicted->push_back(victim);
+        _lru.pop_back();
+    }
+}
+
+void RemoteFileCache::_remove_files(const std::vector<std::string>& keys) {
+    for (auto& key : keys) {
+        Env::Default()->delete_file(_cache_dir + "/" + key);
+    }
+}
+
+} // namespace fs
+} // namespace doris
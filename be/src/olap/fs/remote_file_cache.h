@@ -0,0 +1,108 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class StorageBackend;
+class ThreadPool;
+
+namespace fs {
+
+// A cache of the remote files on the local disk, in blocks of a fixed size.
+//
+// Each cached block is a file named by the hash of the remote path and the block index
+// in the cache directory, so the cache is rebuilt by listing the directory after a
+// restart. The blocks are evicted by LRU when the cached bytes exceed the capacity.
+// The remote files are immutable, so a cached block never becomes stale.
+//
+// A missed block is read from the remote storage by one of the concurrent readers,
+// and the others wait for it. The block is written to the local disk in background.
+//
+// Thread-safe.
+class RemoteFileCache {
+public:
+    RemoteFileCache(std::string cache_dir, int64_t capacity, int64_t block_size);
+    ~RemoteFileCache();
+
+    // create the cache directory, and load the blocks cached before
+    Status init();
+
+    // Read "results" aggregate bytes beginning from `offset` of the remote file,
+    // through the cache.
+    Status read(StorageBackend* backend, const std::string& remote_path, uint64_t offset,
+                const Slice* results, size_t res_cnt);
+
+    int64_t cached_bytes() const;
+
+    const std::string& cache_dir() const { return _cache_dir; }
+
+private:
+    struct Entry {
+        int64_t size;
+        std::list<std::string>::iterator lru_iter;
+    };
+
+    // a block being read from the remote storage and written to the local disk
+    struct Download {
+        std::mutex lock;
+        std::condition_variable cond;
+        bool done = false;
+        Status status;
+        std::string data;
+    };
+
+    static std::string _block_key(const std::string& remote_path, uint64_t block_index);
+
+    // read `size` bytes at `offset_in_block` of the block into `dst`
+    Status _read_block(StorageBackend* backend, const std::string& remote_path,
+                       uint64_t block_index, uint64_t offset_in_block, size_t size, char* dst);
+    Status _read_local(const std::string& key, uint64_t offset_in_block, size_t size,
+                       char* dst);
+    void _fill(const std::string& key, std::shared_ptr<Download> download);
+    // insert the block, and evict the blocks over the capacity. Must hold the lock.
+    void _insert(const std::string& key, int64_t size, std::vector<std::string>* evicted);
+    void _remove_files(const std::vector<std::string>& keys);
+
+    const std::string _cache_dir;
+    const int64_t _capacity;
+    const int64_t _block_size;
+    std::unique_ptr<ThreadPool> _fill_pool;
+
+    mutable std::mutex _lock;
+    // the keys of the cached blocks, the most recently used first
+    std::list<std::string> _lru;
+    std::unordered_map<std::string, Entry> _entries;
+    std::unordered_map<std::string, std::shared_ptr<Download>> _downloads;
+    int64_t _cached_bytes = 0;
+};
+
+} // namespace fs
+} // namespace doris
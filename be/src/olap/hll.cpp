@@ -18,6 +18,8 @@
 #include "olap/hll.h"
 
 #include <algorithm>
+#include <array>
+#include <cmath>
 #include <map>
 
 #include "common/logging.h"
@@ -31,6 +33,15 @@ using std::stringstream;
 
 namespace doris {
 
+// 2^-value of every register value, to sum the harmonic mean of the registers without powf.
+static const std::array<float, 256> inverse_powers_of_two = [] {
+    std::array<float, 256> powers;
+    for (size_t i = 0; i < powers.size(); ++i) {
+        powers[i] = std::ldexp(1.0f, -static_cast<int>(i));
+    }
+    return powers;
+}();
+
 HyperLogLog::HyperLogLog(const Slice& src) {
     // When deserialize return false, we make this object a empty
     if (!deserialize(src)) {
@@ -52,8 +63,78 @@ void HyperLogLog::_convert_explicit_to_register() {
     phmap::flat_hash_set<uint64_t>().swap(_hash_set);
 }
 
-// Change HLL_DATA_EXPLICIT to HLL_DATA_FULL directly, because HLL_DATA_SPARSE
-// is implemented in the same way in memory with HLL_DATA_FULL.
+// Keep the register values of the explicit values in sorted sparse registers.
+void HyperLogLog::_convert_explicit_to_sparse() {
+    DCHECK(_type == HLL_DATA_EXPLICIT)
+            << "_type(" << _type << ") should be explicit(" << HLL_DATA_EXPLICIT << ")";
+    _sparse_registers.reserve(_hash_set.size());
+    for (auto value : _hash_set) {
+        uint8_t register_value;
+        int idx = _register_of(value, &register_value);
+        _sparse_registers.push_back(idx << 8 | register_value);
+    }
+    phmap::flat_hash_set<uint64_t>().swap(_hash_set);
+    _type = HLL_DATA_SPARSE;
+    // the max value of a register is the last one of the same index after sorting
+    std::sort(_sparse_registers.begin(), _sparse_registers.end());
+    auto end = std::unique(_sparse_registers.rbegin(), _sparse_registers.rend(),
+                           [](uint32_t a, uint32_t b) { return (a >> 8) == (b >> 8); });
+    _sparse_registers.erase(_sparse_registers.begin(), end.base());
+    if (_sparse_registers.size() > HLL_SPARSE_IN_MEMORY_THRESHOLD) {
+        _convert_sparse_to_register();
+    }
+}
+
+void HyperLogLog::_convert_sparse_to_register() {
+    DCHECK(_type == HLL_DATA_SPARSE)
+            << "_type(" << _type << ") should be sparse(" << HLL_DATA_SPARSE << ")";
+    _registers = new uint8_t[HLL_REGISTERS_COUNT];
+    memset(_registers, 0, HLL_REGISTERS_COUNT);
+    for (auto value : _sparse_registers) {
+        _registers[value >> 8] = value & 0xff;
+    }
+    std::vector<uint32_t>().swap(_sparse_registers);
+    _type = HLL_DATA_FULL;
+}
+
+void HyperLogLog::_update_sparse_registers(uint64_t hash_value) {
+    uint8_t register_value;
+    uint32_t idx = _register_of(hash_value, &register_value);
+    auto it = std::lower_bound(_sparse_registers.begin(), _sparse_registers.end(), idx << 8);
+    if (it != _sparse_registers.end() && (*it >> 8) == idx) {
+        *it = std::max(*it, idx << 8 | register_value);
+        return;
+    }
+    _sparse_registers.insert(it, idx << 8 | register_value);
+    if (_sparse_registers.size() > HLL_SPARSE_IN_MEMORY_THRESHOLD) {
+        _convert_sparse_to_register();
+    }
+}
+
+void HyperLogLog::_merge_sparse_registers(const std::vector<uint32_t>& other_registers) {
+    std::vector<uint32_t> registers;
+    registers.reserve(_sparse_registers.size() + other_registers.size());
+    auto it = _sparse_registers.begin();
+    auto other_it = other_registers.begin();
+    while (it != _sparse_registers.end() && other_it != other_registers.end()) {
+        if ((*it >> 8) == (*other_it >> 8)) {
+            registers.push_back(std::max(*it++, *other_it++));
+        } else if (*it < *other_it) {
+            registers.push_back(*it++);
+        } else {
+            registers.push_back(*other_it++);
+        }
+    }
+    registers.insert(registers.end(), it, _sparse_registers.end());
+    registers.insert(registers.end(), other_it, other_registers.end());
+    _sparse_registers.swap(registers);
+    if (_sparse_registers.size() > HLL_SPARSE_IN_MEMORY_THRESHOLD) {
+        _convert_sparse_to_register();
+    }
+}
+
+// HLL_DATA_EXPLICIT changes to HLL_DATA_SPARSE, which only keeps the non-zero registers in
+// memory, and HLL_DATA_SPARSE changes to HLL_DATA_FULL when there are too many registers.
 void HyperLogLog::update(uint64_t hash_value) {
     switch (_type) {
     case HLL_DATA_EMPTY:
@@ -65,10 +146,15 @@ void HyperLogLog::update(uint64_t hash_value) {
             _hash_set.insert(hash_value);
             break;
         }
-        _convert_explicit_to_register();
-        _type = HLL_DATA_FULL;
+        _convert_explicit_to_sparse();
+        if (_type == HLL_DATA_FULL) {
+            _update_registers(hash_value);
+            break;
+        }
         // fall through
     case HLL_DATA_SPARSE:
+        _update_sparse_registers(hash_value);
+        break;
     case HLL_DATA_FULL:
         _update_registers(hash_value);
         break;
@@ -83,19 +169,7 @@ void HyperLogLog::merge(const HyperLogLog& other) {
     switch (_type) {
     case HLL_DATA_EMPTY: {
         // _type must change
-        _type = other._type;
-        switch (other._type) {
-        case HLL_DATA_EXPLICIT:
-            _hash_set = other._hash_set;
-            break;
-        case HLL_DATA_SPARSE:
-        case HLL_DATA_FULL:
-            _registers = new uint8_t[HLL_REGISTERS_COUNT];
-            memcpy(_registers, other._registers, HLL_REGISTERS_COUNT);
-            break;
-        default:
-            break;
-        }
+        *this = other;
         break;
     }
     case HLL_DATA_EXPLICIT: {
@@ -105,11 +179,13 @@ void HyperLogLog::merge(const HyperLogLog& other) {
             // HLL_EXPLICIT_INT64_NUM. This is OK because the max value is 2 * 160.
             _hash_set.insert(other._hash_set.begin(), other._hash_set.end());
             if (_hash_set.size() > HLL_EXPLICIT_INT64_NUM) {
-                _convert_explicit_to_register();
-                _type = HLL_DATA_FULL;
+                _convert_explicit_to_sparse();
             }
         } break;
         case HLL_DATA_SPARSE:
+            _convert_explicit_to_sparse();
+            merge(other);
+            break;
         case HLL_DATA_FULL:
             _convert_explicit_to_register();
             _merge_registers(other._registers);
@@ -120,7 +196,25 @@ void HyperLogLog::merge(const HyperLogLog& other) {
         }
         break;
     }
-    case HLL_DATA_SPARSE:
+    case HLL_DATA_SPARSE: {
+        switch (other._type) {
+        case HLL_DATA_EXPLICIT:
+            for (auto hash_value : other._hash_set) {
+                update(hash_value);
+            }
+            break;
+        case HLL_DATA_SPARSE:
+            _merge_sparse_registers(other._sparse_registers);
+            break;
+        case HLL_DATA_FULL:
+            _convert_sparse_to_register();
+            _merge_registers(other._registers);
+            break;
+        default:
+            break;
+        }
+        break;
+    }
     case HLL_DATA_FULL: {
         switch (other._type) {
         case HLL_DATA_EXPLICIT:
@@ -129,6 +223,11 @@ void HyperLogLog::merge(const HyperLogLog& other) {
             }
             break;
         case HLL_DATA_SPARSE:
+            for (auto value : other._sparse_registers) {
+                uint8_t& reg = _registers[value >> 8];
+                reg = std::max(reg, uint8_t(value & 0xff));
+            }
+            break;
         case HLL_DATA_FULL:
             _merge_registers(other._registers);
             break;
@@ -148,6 +247,7 @@ size_t HyperLogLog::max_serialized_size() const {
     case HLL_DATA_EXPLICIT:
         return 2 + _hash_set.size() * 8;
     case HLL_DATA_SPARSE:
+        return 1 + 4 + 3 * _sparse_registers.size();
     case HLL_DATA_FULL:
         return 1 + HLL_REGISTERS_COUNT;
     }
@@ -175,7 +275,18 @@ size_t HyperLogLog::serialize(uint8_t* dst) const {
         }
         break;
     }
-    case HLL_DATA_SPARSE:
+    case HLL_DATA_SPARSE: {
+        // at most HLL_SPARSE_IN_MEMORY_THRESHOLD registers, less than HLL_SPARSE_THRESHOLD
+        *ptr++ = HLL_DATA_SPARSE;
+        encode_fixed32_le(ptr, _sparse_registers.size());
+        ptr += 4;
+        for (auto value : _sparse_registers) {
+            encode_fixed16_le(ptr, value >> 8);
+            ptr += 2;
+            *ptr++ = value & 0xff;
+        }
+        break;
+    }
     case HLL_DATA_FULL: {
         uint32_t num_non_zero_registers = 0;
         for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
@@ -285,11 +396,29 @@ bool HyperLogLog::deserialize(const Slice& slice) {
         break;
     }
     case HLL_DATA_SPARSE: {
-        _registers = new uint8_t[HLL_REGISTERS_COUNT];
-        memset(_registers, 0, HLL_REGISTERS_COUNT);
         // 2-5(4 byte): number of registers
         uint32_t num_registers = decode_fixed32_le(ptr);
         ptr += 4;
+        if (num_registers <= HLL_SPARSE_IN_MEMORY_THRESHOLD) {
+            _sparse_registers.reserve(num_registers);
+            for (uint32_t i = 0; i < num_registers; ++i) {
+                uint16_t register_idx = decode_fixed16_le(ptr);
+                ptr += 2;
+                uint8_t register_value = *ptr++;
+                if (register_idx < HLL_REGISTERS_COUNT && register_value != 0) {
+                    _sparse_registers.push_back(uint32_t(register_idx) << 8 | register_value);
+                }
+            }
+            // the registers are serialized in the order of the index, sort them in case not
+            std::sort(_sparse_registers.begin(), _sparse_registers.end());
+            auto end = std::unique(_sparse_registers.rbegin(), _sparse_registers.rend(),
+                                   [](uint32_t a, uint32_t b) { return (a >> 8) == (b >> 8); });
+            _sparse_registers.erase(_sparse_registers.begin(), end.base());
+            break;
+        }
+        _type = HLL_DATA_FULL;
+        _registers = new uint8_t[HLL_REGISTERS_COUNT];
+        memset(_registers, 0, HLL_REGISTERS_COUNT);
         for (uint32_t i = 0; i < num_registers; ++i) {
             // 2 bytes: register index
             // 1 byte: register value
@@ -338,11 +467,21 @@ int64_t HyperLogLog::estimate_cardinality() const {
     float harmonic_mean = 0;
     int num_zero_registers = 0;
 
-    for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
-        harmonic_mean += powf(2.0f, -_registers[i]);
-
-        if (_registers[i] == 0) {
-            ++num_zero_registers;
+    if (_type == HLL_DATA_SPARSE) {
+        // sum in the order of the index as the full registers, to get the same estimate
+        auto it = _sparse_registers.begin();
+        for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
+            uint8_t value = 0;
+            if (it != _sparse_registers.end() && (*it >> 8) == i) {
+                value = *it++ & 0xff;
+            }
+            harmonic_mean += inverse_powers_of_two[value];
+            num_zero_registers += (value == 0);
+        }
+    } else {
+        for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
+            harmonic_mean += inverse_powers_of_two[_registers[i]];
+            num_zero_registers += (_registers[i] == 0);
         }
     }
 
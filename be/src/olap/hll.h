@@ -23,6 +23,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <vector>
 #include <parallel_hashmap/phmap.h>
 
 #ifdef __x86_64__
@@ -39,6 +40,8 @@ const static int HLL_COLUMN_PRECISION = 14;
 const static int HLL_ZERO_COUNT_BITS = (64 - HLL_COLUMN_PRECISION);
 const static int HLL_EXPLICIT_INT64_NUM = 160;
 const static int HLL_SPARSE_THRESHOLD = 4096;
+// max number of non-zero registers kept sparse in memory, 4 bytes for each one
+const static int HLL_SPARSE_IN_MEMORY_THRESHOLD = 1024;
 const static int HLL_REGISTERS_COUNT = 16 * 1024;
 // maximum size in byte of serialized HLL: type(1) + registers (2^14)
 const static int HLL_COLUMN_DEFAULT_LEN = HLL_REGISTERS_COUNT + 1;
@@ -73,6 +76,11 @@ const static int HLL_EMPTY_SIZE = 1;
 // A HLL value will change in the sequence empty -> explicit -> sparse -> full, and not
 // allow reverse.
 //
+// In memory, a HLL_DATA_SPARSE value only holds its non-zero registers too, until there are
+// more than HLL_SPARSE_IN_MEMORY_THRESHOLD of them. So a HLL value with a few hundred of
+// distinct values, such as the state of a small group of an aggregation, doesn't allocate
+// all the registers.
+//
 // NOTE: This values are persisted in storage devices, so don't change exist
 // enum values.
 enum HllDataType {
@@ -99,7 +107,10 @@ public:
             this->_hash_set = other._hash_set;
             break;
         }
-        case HLL_DATA_SPARSE:
+        case HLL_DATA_SPARSE: {
+            this->_sparse_registers = other._sparse_registers;
+            break;
+        }
         case HLL_DATA_FULL: {
             _registers = new uint8_t[HLL_REGISTERS_COUNT];
             memcpy(_registers, other._registers, HLL_REGISTERS_COUNT);
@@ -120,7 +131,11 @@ public:
             other._type = HLL_DATA_EMPTY;
             break;
         }
-        case HLL_DATA_SPARSE:
+        case HLL_DATA_SPARSE: {
+            this->_sparse_registers = std::move(other._sparse_registers);
+            other._type = HLL_DATA_EMPTY;
+            break;
+        }
         case HLL_DATA_FULL: {
             this->_registers = other._registers;
             other._registers = nullptr;
@@ -134,10 +149,7 @@ public:
 
     HyperLogLog& operator=(HyperLogLog&& other) {
         if (this != &other) {
-            if (_registers != nullptr) {
-                delete[] _registers;
-                _registers = nullptr;
-            }
+            clear();
 
             this->_type = other._type;
             switch (other._type) {
@@ -148,7 +160,11 @@ public:
                 other._type = HLL_DATA_EMPTY;
                 break;
             }
-            case HLL_DATA_SPARSE:
+            case HLL_DATA_SPARSE: {
+                this->_sparse_registers = std::move(other._sparse_registers);
+                other._type = HLL_DATA_EMPTY;
+                break;
+            }
             case HLL_DATA_FULL: {
                 this->_registers = other._registers;
                 other._registers = nullptr;
@@ -164,10 +180,7 @@ public:
 
     HyperLogLog& operator=(const HyperLogLog& other) {
         if (this != &other) {
-            if (_registers != nullptr) {
-                delete[] _registers;
-                _registers = nullptr;
-            }
+            clear();
 
             this->_type = other._type;
             switch (other._type) {
@@ -177,7 +190,10 @@ public:
                 this->_hash_set = other._hash_set;
                 break;
             }
-            case HLL_DATA_SPARSE:
+            case HLL_DATA_SPARSE: {
+                this->_sparse_registers = other._sparse_registers;
+                break;
+            }
             case HLL_DATA_FULL: {
                 _registers = new uint8_t[HLL_REGISTERS_COUNT];
                 memcpy(_registers, other._registers, HLL_REGISTERS_COUNT);
@@ -194,6 +210,7 @@ public:
     void clear() {
         _type = HLL_DATA_EMPTY;
         _hash_set.clear();
+        std::vector<uint32_t>().swap(_sparse_registers);
         delete[] _registers;
         _registers = nullptr;
     }
@@ -216,7 +233,9 @@ public:
         size_t size = sizeof(*this);
         if (_type == HLL_DATA_EXPLICIT)
             size += _hash_set.size() * sizeof(uint64_t);
-        else if (_type == HLL_DATA_SPARSE || _type == HLL_DATA_FULL)
+        else if (_type == HLL_DATA_SPARSE)
+            size += _sparse_registers.capacity() * sizeof(uint32_t);
+        else if (_type == HLL_DATA_FULL)
             size += HLL_REGISTERS_COUNT;
         return size;
     }
@@ -270,25 +289,46 @@ private:
     HllDataType _type = HLL_DATA_EMPTY;
     phmap::flat_hash_set<uint64_t> _hash_set;
 
+    // The non-zero registers of HLL_DATA_SPARSE, each one is (index << 8 | value), sorted by
+    // the index.
+    std::vector<uint32_t> _sparse_registers;
+
     // This field is much space consuming(HLL_REGISTERS_COUNT), we create
     // it only when it is really needed.
     uint8_t* _registers = nullptr;
 
 private:
     void _convert_explicit_to_register();
+    // NOTE: these functions set _type, the result may be full if there are too many registers.
+    void _convert_explicit_to_sparse();
+    void _convert_sparse_to_register();
 
-    // update one hash value into this registers
-    void _update_registers(uint64_t hash_value) {
+    // Return the register index of a hash value, and the register value of it in `value`.
+    static int _register_of(uint64_t hash_value, uint8_t* value) {
         // Use the lower bits to index into the number of streams and then
         // find the first 1 bit after the index bits.
         int idx = hash_value % HLL_REGISTERS_COUNT;
         hash_value >>= HLL_COLUMN_PRECISION;
         // make sure max first_one_bit is HLL_ZERO_COUNT_BITS + 1
         hash_value |= ((uint64_t)1 << HLL_ZERO_COUNT_BITS);
-        uint8_t first_one_bit = __builtin_ctzl(hash_value) + 1;
+        *value = __builtin_ctzl(hash_value) + 1;
+        return idx;
+    }
+
+    // update one hash value into this registers
+    void _update_registers(uint64_t hash_value) {
+        uint8_t first_one_bit;
+        int idx = _register_of(hash_value, &first_one_bit);
         _registers[idx] = (_registers[idx] < first_one_bit ? first_one_bit : _registers[idx]);
     }
 
+    // update one hash value into the sparse registers, may convert them to the full registers
+    void _update_sparse_registers(uint64_t hash_value);
+
+    // absorb other sparse registers into the sparse registers, may convert them to the full
+    // registers
+    void _merge_sparse_registers(const std::vector<uint32_t>& other_registers);
+
     // absorb other registers into this registers
     void _merge_registers(const uint8_t* other_registers) {
 #ifdef __AVX2__
@@ -302,6 +342,17 @@ private:
             src += 32;
             dst += 32;
         }
+#elif defined(__SSE2__)
+        int loop = HLL_REGISTERS_COUNT / 16; // 16 = 128/8
+        uint8_t* dst = _registers;
+        const uint8_t* src = other_registers;
+        for (int i = 0; i < loop; i++) {
+            __m128i xa = _mm_loadu_si128((const __m128i*)dst);
+            __m128i xb = _mm_loadu_si128((const __m128i*)src);
+            _mm_storeu_si128((__m128i*)dst, _mm_max_epu8(xa, xb));
+            src += 16;
+            dst += 16;
+        }
 #else
         for (int i = 0; i < HLL_REGISTERS_COUNT; ++i) {
             _registers[i] =
@@ -17,7 +17,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <roaring/roaring.hh>
 
 #include "common/status.h"
 #include "olap/olap_common.h"
@@ -32,6 +34,13 @@ class RowBlockV2;
 class Schema;
 class Conditions;
 class ColumnPredicate;
+class LateRuntimeFilter;
+class RuntimeState;
+class TopNColumnPredicate;
+
+namespace segment_v2 {
+class PagePrefetchBudget;
+} // namespace segment_v2
 
 class StorageReadOptions {
 public:
@@ -79,10 +88,39 @@ public:
     // to unify Conditions and ColumnPredicate
     std::vector<ColumnPredicate*> column_predicates;
 
+    // (column id, LIKE pattern) pairs, only used by ngram bloom filter index to filter pages,
+    // the rows are still filtered by the LIKE conjuncts in scan node.
+    std::vector<std::pair<uint32_t, std::string>> like_predicates;
+
+    // the predicate of the boundary of a Top-N sort, also in `column_predicates`, nullptr if not
+    // existed. The boundary tightens while reading, it's used to filter pages when a segment is
+    // first read.
+    const TopNColumnPredicate* topn_predicate = nullptr;
+
+    // the runtime filters arriving after the scan starts, applied to the pages and the rows
+    // when a segment is first read if they are published by then, nullptr if not existed
+    const std::vector<std::shared_ptr<LateRuntimeFilter>>* late_runtime_filters = nullptr;
+
+    // segment id -> the rows deleted by later loads, only set in merge-on-write
+    // unique key tablets, the deleted rows are skipped before any index is applied
+    std::map<uint32_t, std::shared_ptr<roaring::Roaring>> delete_bitmap;
+
     // REQUIRED (null is not allowed)
     OlapReaderStatistics* stats = nullptr;
+    // the read of a cancelled query stops at the next block or the next index applied,
+    // it can't be cancelled if it's nullptr
+    const RuntimeState* runtime_state = nullptr;
     bool use_page_cache = false;
+    bool bypass_page_cache_admission = false;
+    // read ahead the data pages within this budget, no read-ahead if it's nullptr
+    segment_v2::PagePrefetchBudget* page_prefetch_budget = nullptr;
     int block_row_max = 4096;
+    // the rows of a block read from a segment are also bounded by it if it's not nullptr, the
+    // reader may lower it between the blocks
+    const int* block_row_limit = nullptr;
+    // remember the locations of the rows of each returned block, see
+    // RowwiseIterator::current_block_row_locations()
+    bool record_rowids = false;
 };
 
 // Used to read data in RowBlockV2 one by one
@@ -119,6 +157,12 @@ public:
     // Return the data id such as segment id, used for keep the insert order when do
     // merge sort in priority queue
     virtual uint64_t data_id() const { return 0; }
+
+    // The locations of the rows of the last returned block, in the order of the rows.
+    // Only supported if StorageReadOptions::record_rowids is set, the rowset id is not set.
+    virtual Status current_block_row_locations(std::vector<RowLocation>* locations) {
+        return Status::NotSupported("to be implemented");
+    }
 };
 
 } // namespace doris
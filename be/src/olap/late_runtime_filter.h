@@ -0,0 +1,66 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "exprs/bloomfilter_predicate.h"
+#include "gen_cpp/PaloInternalService_types.h"
+
+namespace doris {
+
+// The storage filters of a runtime filter which arrives after the scan has started. They are
+// published by the scan node once the filter is ready, and each segment opened after that prunes
+// its pages by the conditions (min/max and IN filters, through the zone maps and the bloom filter
+// indexes) and filters its rows by the bloom filters before reading the other columns.
+// The segments opened before the filter is ready filter the next blocks by the bloom filters on
+// their first read predicate columns, and are otherwise only filtered by the scanner.
+class LateRuntimeFilter {
+public:
+    using BloomFilter = std::pair<std::string, std::shared_ptr<IBloomFilterFuncBase>>;
+
+    // Only the first publish takes effect, the filters can't change after being published.
+    void publish(std::vector<TCondition> conditions, std::vector<BloomFilter> bloom_filters) {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_published.load(std::memory_order_relaxed)) {
+            return;
+        }
+        _conditions = std::move(conditions);
+        _bloom_filters = std::move(bloom_filters);
+        _published.store(true, std::memory_order_release);
+    }
+
+    bool is_published() const { return _published.load(std::memory_order_acquire); }
+
+    // only valid after is_published() returns true
+    const std::vector<TCondition>& conditions() const { return _conditions; }
+    const std::vector<BloomFilter>& bloom_filters() const { return _bloom_filters; }
+
+private:
+    std::mutex _lock;
+    std::atomic<bool> _published {false};
+    std::vector<TCondition> _conditions;
+    std::vector<BloomFilter> _bloom_filters;
+};
+
+} // namespace doris
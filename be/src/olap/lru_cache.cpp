@@ -7,10 +7,12 @@
 #include <rapidjson/document.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <strings.h>
 
 #include <sstream>
 #include <string>
 
+#include "olap/clock_cache.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/olap_index.h"
@@ -30,6 +32,10 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(usage_ratio, MetricUnit::NOUNIT);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(lookup_count, MetricUnit::OPERATIONS);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(hit_count, MetricUnit::OPERATIONS);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(hit_ratio, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(protected_usage, MetricUnit::BYTES);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(protected_hit_count, MetricUnit::OPERATIONS);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(protected_hit_ratio, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(probation_hit_ratio, MetricUnit::NOUNIT);
 
 uint32_t CacheKey::hash(const char* data, size_t n, uint32_t seed) const {
     // Similar to murmur hash
@@ -176,10 +182,12 @@ void HandleTable::_resize() {
     _length = new_length;
 }
 
-LRUCache::LRUCache(LRUCacheType type) : _type(type) {
+LRUCache::LRUCache(LRUCacheType type, LRUCachePolicy policy) : _type(type), _policy(policy) {
     // Make empty circular linked list
     _lru_normal.next = &_lru_normal;
     _lru_normal.prev = &_lru_normal;
+    _lru_protected.next = &_lru_protected;
+    _lru_protected.prev = &_lru_protected;
     _lru_durable.next = &_lru_durable;
     _lru_durable.prev = &_lru_durable;
 }
@@ -208,6 +216,34 @@ void LRUCache::_lru_append(LRUHandle* list, LRUHandle* e) {
     e->next->prev = e;
 }
 
+void LRUCache::_lru_append(LRUHandle* e) {
+    if (e->priority == CachePriority::DURABLE) {
+        _lru_append(&_lru_durable, e);
+    } else if (e->in_protected) {
+        _lru_append(&_lru_protected, e);
+        _demote_protected();
+    } else {
+        _lru_append(&_lru_normal, e);
+    }
+}
+
+void LRUCache::_remove_from_protected(LRUHandle* e) {
+    if (e->in_protected) {
+        e->in_protected = false;
+        _protected_usage -= e->total_size;
+    }
+}
+
+void LRUCache::_demote_protected() {
+    // the entries in use are not in the list, they are demoted after released
+    while (_protected_usage > _protected_capacity && _lru_protected.next != &_lru_protected) {
+        LRUHandle* old = _lru_protected.next;
+        _lru_remove(old);
+        _remove_from_protected(old);
+        _lru_append(&_lru_normal, old);
+    }
+}
+
 Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
     std::lock_guard<std::mutex> l(_mutex);
     ++_lookup_count;
@@ -221,6 +257,16 @@ Cache::Handle* LRUCache::lookup(const CacheKey& key, uint32_t hash) {
         }
         e->refs++;
         ++_hit_count;
+        if (_policy == LRUCachePolicy::SLRU && e->priority == CachePriority::NORMAL) {
+            if (e->in_protected) {
+                ++_protected_hit_count;
+            } else {
+                // hit again in the probationary segment, promote it
+                e->in_protected = true;
+                _protected_usage += e->total_size;
+                _demote_protected();
+            }
+        }
     }
     return reinterpret_cast<Cache::Handle*>(e);
 }
@@ -241,17 +287,14 @@ void LRUCache::release(Cache::Handle* handle) {
             if (_usage > _capacity) {
                 // take this opportunity and remove the item
                 _table.remove(e);
+                _remove_from_protected(e);
                 e->in_cache = false;
                 _unref(e);
                 _usage -= e->total_size;
                 last_ref = true;
             } else {
                 // put it to LRU free list
-                if (e->priority == CachePriority::NORMAL) {
-                    _lru_append(&_lru_normal, e);
-                } else if (e->priority == CachePriority::DURABLE) {
-                    _lru_append(&_lru_durable, e);
-                }
+                _lru_append(e);
             }
         }
     }
@@ -271,7 +314,15 @@ void LRUCache::_evict_from_lru(size_t total_size, LRUHandle** to_remove_head) {
         old->next = *to_remove_head;
         *to_remove_head = old;
     }
-    // 2. evict durable cache entries if need
+    // 2. evict protected cache entries of SLRU if need
+    while (_usage + total_size > _capacity && _lru_protected.next != &_lru_protected) {
+        LRUHandle* old = _lru_protected.next;
+        DCHECK(old->priority == CachePriority::NORMAL);
+        _evict_one_entry(old);
+        old->next = *to_remove_head;
+        *to_remove_head = old;
+    }
+    // 3. evict durable cache entries if need
     while (_usage + total_size > _capacity && _lru_durable.next != &_lru_durable) {
         LRUHandle* old = _lru_durable.next;
         DCHECK(old->priority == CachePriority::DURABLE);
@@ -286,6 +337,7 @@ void LRUCache::_evict_one_entry(LRUHandle* e) {
     DCHECK(e->refs == 1); // LRU list contains elements which may be evicted
     _lru_remove(e);
     _table.remove(e);
+    _remove_from_protected(e);
     e->in_cache = false;
     _unref(e);
     _usage -= e->total_size;
@@ -305,6 +357,8 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
     e->refs = 2; // one for the returned handle, one for LRUCache.
     e->next = e->prev = nullptr;
     e->in_cache = true;
+    e->in_protected = false;
+    e->visited = false;
     e->priority = priority;
     memcpy(e->key_data, key.data(), key.size());
     LRUHandle* to_remove_head = nullptr;
@@ -321,6 +375,7 @@ Cache::Handle* LRUCache::insert(const CacheKey& key, uint32_t hash, void* value,
         auto old = _table.insert(e);
         _usage += e->total_size;
         if (old != nullptr) {
+            _remove_from_protected(old);
             old->in_cache = false;
             if (_unref(old)) {
                 _usage -= old->total_size;
@@ -359,6 +414,7 @@ void LRUCache::erase(const CacheKey& key, uint32_t hash) {
                     _lru_remove(e);
                 }
             }
+            _remove_from_protected(e);
             e->in_cache = false;
         }
     }
@@ -378,6 +434,12 @@ int64_t LRUCache::prune() {
             old->next = to_remove_head;
             to_remove_head = old;
         }
+        while (_lru_protected.next != &_lru_protected) {
+            LRUHandle* old = _lru_protected.next;
+            _evict_one_entry(old);
+            old->next = to_remove_head;
+            to_remove_head = old;
+        }
         while (_lru_durable.next != &_lru_durable) {
             LRUHandle* old = _lru_durable.next;
             _evict_one_entry(old);
@@ -410,6 +472,17 @@ int64_t LRUCache::prune_if(CacheValuePredicate pred) {
             p = next;
         }
 
+        p = _lru_protected.next;
+        while (p != &_lru_protected) {
+            LRUHandle* next = p->next;
+            if (pred(p->value)) {
+                _evict_one_entry(p);
+                p->next = to_remove_head;
+                to_remove_head = p;
+            }
+            p = next;
+        }
+
         p = _lru_durable.next;
         while (p != &_lru_durable) {
             LRUHandle* next = p->next;
@@ -439,15 +512,18 @@ uint32_t ShardedLRUCache::_shard(uint32_t hash) {
     return hash >> (32 - kNumShardBits);
 }
 
-ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type)
+ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
+                                 LRUCachePolicy policy, int32_t protected_percentage)
         : _name(name),
+          _policy(policy),
           _last_id(1),
           _mem_tracker(MemTracker::create_tracker(-1, name, nullptr, MemTrackerLevel::OVERVIEW)) {
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_END_CLEAR(_mem_tracker);
     const size_t per_shard = (total_capacity + (kNumShards - 1)) / kNumShards;
     for (int s = 0; s < kNumShards; s++) {
-        _shards[s] = new LRUCache(type);
+        _shards[s] = new LRUCache(type, policy);
         _shards[s]->set_capacity(per_shard);
+        _shards[s]->set_protected_capacity(per_shard * protected_percentage / 100);
     }
 
     _entity = DorisMetrics::instance()->metric_registry()->register_entity(
@@ -459,6 +535,12 @@ ShardedLRUCache::ShardedLRUCache(const std::string& name, size_t total_capacity,
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, lookup_count);
     INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, hit_count);
     INT_DOUBLE_METRIC_REGISTER(_entity, hit_ratio);
+    if (_policy == LRUCachePolicy::SLRU) {
+        INT_GAUGE_METRIC_REGISTER(_entity, protected_usage);
+        INT_ATOMIC_COUNTER_METRIC_REGISTER(_entity, protected_hit_count);
+        INT_DOUBLE_METRIC_REGISTER(_entity, protected_hit_ratio);
+        INT_DOUBLE_METRIC_REGISTER(_entity, probation_hit_ratio);
+    }
 }
 
 ShardedLRUCache::~ShardedLRUCache() {
@@ -548,6 +630,25 @@ void ShardedLRUCache::update_cache_metrics() const {
     usage_ratio->set_value(total_capacity == 0 ? 0 : ((double)total_usage / total_capacity));
     hit_ratio->set_value(total_lookup_count == 0 ? 0
                                                  : ((double)total_hit_count / total_lookup_count));
+
+    if (_policy == LRUCachePolicy::SLRU) {
+        size_t total_protected_usage = 0;
+        size_t total_protected_hit_count = 0;
+        for (int i = 0; i < kNumShards; i++) {
+            total_protected_usage += _shards[i]->get_protected_usage();
+            total_protected_hit_count += _shards[i]->get_protected_hit_count();
+        }
+        protected_usage->set_value(total_protected_usage);
+        protected_hit_count->set_value(total_protected_hit_count);
+        // the hits of DURABLE entries are counted in probationary hits
+        size_t total_probation_hit_count = total_hit_count - total_protected_hit_count;
+        protected_hit_ratio->set_value(
+                total_lookup_count == 0 ? 0
+                                        : ((double)total_protected_hit_count / total_lookup_count));
+        probation_hit_ratio->set_value(
+                total_lookup_count == 0 ? 0
+                                        : ((double)total_probation_hit_count / total_lookup_count));
+    }
 }
 
 Cache* new_lru_cache(const std::string& name, size_t capacity) {
@@ -558,4 +659,35 @@ Cache* new_typed_lru_cache(const std::string& name, size_t capacity, LRUCacheTyp
     return new ShardedLRUCache(name, capacity, type);
 }
 
+Cache* new_slru_cache(const std::string& name, size_t capacity, int32_t protected_percentage) {
+    return new ShardedLRUCache(name, capacity, LRUCacheType::SIZE, LRUCachePolicy::SLRU,
+                               protected_percentage);
+}
+
+bool parse_lru_cache_policy(const std::string& name, LRUCachePolicy* policy) {
+    if (strcasecmp(name.c_str(), "LRU") == 0) {
+        *policy = LRUCachePolicy::LRU;
+    } else if (strcasecmp(name.c_str(), "SLRU") == 0) {
+        *policy = LRUCachePolicy::SLRU;
+    } else if (strcasecmp(name.c_str(), "CLOCK") == 0) {
+        *policy = LRUCachePolicy::CLOCK;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+Cache* new_cache_by_policy(const std::string& name, size_t capacity, LRUCacheType type,
+                           const std::string& policy_name, int32_t protected_percentage) {
+    LRUCachePolicy policy = LRUCachePolicy::LRU;
+    if (!parse_lru_cache_policy(policy_name, &policy)) {
+        LOG(WARNING) << "unknown policy " << policy_name << " of cache " << name
+                     << ", use LRU instead";
+    }
+    if (policy == LRUCachePolicy::CLOCK) {
+        return new ShardedClockCache(name, capacity, type);
+    }
+    return new ShardedLRUCache(name, capacity, type, policy, protected_percentage);
+}
+
 } // namespace doris
@@ -52,12 +52,40 @@ enum LRUCacheType {
     NUMBER // The capacity of cache is based on the number of cache entry.
 };
 
+// The eviction policy of the NORMAL entries, DURABLE entries are always evicted at last.
+enum class LRUCachePolicy {
+    // Plain LRU.
+    LRU,
+    // Segmented LRU, the entries are inserted into a probationary segment and only
+    // promoted to the protected segment when they are hit again. The entries which are
+    // used only once, such as the pages of a big scan, are evicted from the probationary
+    // segment first and can not flush the frequently used entries out of the cache.
+    SLRU,
+    // CLOCK (second chance), see ShardedClockCache. Hits only take a shared lock, at the
+    // cost of a coarser recency than LRU.
+    CLOCK
+};
+
 // Create a new cache with a specified name and a fixed SIZE capacity.
 // This implementation of Cache uses a least-recently-used eviction policy.
 extern Cache* new_lru_cache(const std::string& name, size_t capacity);
 
 extern Cache* new_typed_lru_cache(const std::string& name, size_t capacity, LRUCacheType type);
 
+// Create a new SIZE typed cache using SLRU, `protected_percentage` of the capacity is
+// reserved for the protected segment.
+extern Cache* new_slru_cache(const std::string& name, size_t capacity,
+                             int32_t protected_percentage);
+
+// Parse the policy name, "LRU", "SLRU" or "CLOCK" (case insensitive), return false if unknown.
+extern bool parse_lru_cache_policy(const std::string& name, LRUCachePolicy* policy);
+
+// Create a cache of the policy named `policy_name`, LRU is used if the name is unknown.
+// `protected_percentage` is only used by SLRU.
+extern Cache* new_cache_by_policy(const std::string& name, size_t capacity, LRUCacheType type,
+                                  const std::string& policy_name,
+                                  int32_t protected_percentage = 0);
+
 class CacheKey {
 public:
     CacheKey() : _data(nullptr), _size(0) {}
@@ -234,6 +262,8 @@ typedef struct LRUHandle {
     size_t key_length;
     size_t total_size; // including key length
     bool in_cache;     // Whether entry is in the cache.
+    bool in_protected; // Whether entry is in the protected segment of SLRU.
+    bool visited;      // Whether entry is hit since the clock hand passed it, only for CLOCK.
     uint32_t refs;
     uint32_t hash; // Hash of key(); used for fast sharding and comparisons
     CachePriority priority = CachePriority::NORMAL;
@@ -302,11 +332,13 @@ private:
 // A single shard of sharded cache.
 class LRUCache {
 public:
-    LRUCache(LRUCacheType type);
+    LRUCache(LRUCacheType type, LRUCachePolicy policy = LRUCachePolicy::LRU);
     ~LRUCache();
 
     // Separate from constructor so caller can easily make an array of LRUCache
     void set_capacity(size_t capacity) { _capacity = capacity; }
+    // The capacity of the protected segment, only used by SLRU.
+    void set_protected_capacity(size_t capacity) { _protected_capacity = capacity; }
 
     // Like Cache methods, but with an extra "hash" parameter.
     Cache::Handle* insert(const CacheKey& key, uint32_t hash, void* value, size_t charge,
@@ -320,30 +352,48 @@ public:
 
     uint64_t get_lookup_count() const { return _lookup_count; }
     uint64_t get_hit_count() const { return _hit_count; }
+    // The hits of the entries in the protected segment, the others are the hits of the
+    // probationary segment and the DURABLE entries.
+    uint64_t get_protected_hit_count() const { return _protected_hit_count; }
     size_t get_usage() const { return _usage; }
     size_t get_capacity() const { return _capacity; }
+    size_t get_protected_usage() const { return _protected_usage; }
 
 private:
     void _lru_remove(LRUHandle* e);
     void _lru_append(LRUHandle* list, LRUHandle* e);
+    // Put the unused entry to the LRU list of its priority and segment.
+    void _lru_append(LRUHandle* e);
     bool _unref(LRUHandle* e);
     void _evict_from_lru(size_t total_size, LRUHandle** to_remove_head);
     void _evict_one_entry(LRUHandle* e);
+    // Must be called when the entry is removed from the cache.
+    void _remove_from_protected(LRUHandle* e);
+    // Move the oldest unused protected entries back to the probationary segment until
+    // the protected segment fits its capacity.
+    void _demote_protected();
 
 private:
     LRUCacheType _type;
+    LRUCachePolicy _policy;
 
     // Initialized before use.
     size_t _capacity = 0;
+    size_t _protected_capacity = 0;
 
     // _mutex protects the following state.
     std::mutex _mutex;
     size_t _usage = 0;
+    // The total size of the entries in the protected segment.
+    size_t _protected_usage = 0;
 
     // Dummy head of LRU list.
     // Entries have refs==1 and in_cache==true.
     // _lru_normal.prev is newest entry, _lru_normal.next is oldest entry.
+    // For SLRU, it's the probationary segment.
     LRUHandle _lru_normal;
+    // The protected segment of SLRU.
+    LRUHandle _lru_protected;
     // _lru_durable.prev is newest entry, _lru_durable.next is oldest entry.
     LRUHandle _lru_durable;
 
@@ -351,6 +401,7 @@ private:
 
     uint64_t _lookup_count = 0; // cache查找总次数
     uint64_t _hit_count = 0;    // 命中cache的总次数
+    uint64_t _protected_hit_count = 0;
 };
 
 static const int kNumShardBits = 4;
@@ -358,7 +409,9 @@ static const int kNumShards = 1 << kNumShardBits;
 
 class ShardedLRUCache : public Cache {
 public:
-    explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type);
+    explicit ShardedLRUCache(const std::string& name, size_t total_capacity, LRUCacheType type,
+                             LRUCachePolicy policy = LRUCachePolicy::LRU,
+                             int32_t protected_percentage = 0);
     // TODO(fdy): 析构时清除所有cache元素
     virtual ~ShardedLRUCache();
     virtual Handle* insert(const CacheKey& key, void* value, size_t charge,
@@ -381,6 +434,7 @@ private:
     static uint32_t _shard(uint32_t hash);
 
     std::string _name;
+    LRUCachePolicy _policy;
     LRUCache* _shards[kNumShards];
     std::atomic<uint64_t> _last_id;
 
@@ -392,6 +446,11 @@ private:
     IntAtomicCounter* lookup_count = nullptr;
     IntAtomicCounter* hit_count = nullptr;
     DoubleGauge* hit_ratio = nullptr;
+    // only registered for SLRU
+    IntGauge* protected_usage = nullptr;
+    IntAtomicCounter* protected_hit_count = nullptr;
+    DoubleGauge* protected_hit_ratio = nullptr;
+    DoubleGauge* probation_hit_ratio = nullptr;
 };
 
 } // namespace doris
@@ -0,0 +1,211 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "olap/match_predicate.h"
+
+#include <algorithm>
+
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "runtime/string_value.h"
+#include "runtime/vectorized_row_batch.h"
+#include "vec/columns/column_dictionary.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/predicate_column.h"
+
+namespace doris {
+
+MatchPredicate::MatchPredicate(uint32_t column_id, MatchType match_type, const std::string& query,
+                               const std::string& parser_name,
+                               segment_v2::InvertedIndexParserType parser_type)
+        : ColumnPredicate(column_id),
+          _match_type(match_type),
+          _parser_name(parser_name),
+          _parser_type(parser_type) {
+    segment_v2::tokenize_by_parser(_parser_type, Slice(query), &_terms);
+    std::sort(_terms.begin(), _terms.end());
+    _terms.erase(std::unique(_terms.begin(), _terms.end()), _terms.end());
+}
+
+// a query without any term matches nothing
+bool MatchPredicate::_match(const char* data, size_t size) const {
+    if (_terms.empty()) {
+        return false;
+    }
+    std::vector<std::string> value_terms;
+    segment_v2::tokenize_by_parser(_parser_type, Slice(data, size), &value_terms);
+    if (_match_type == MatchType::MATCH_ANY) {
+        for (auto& term : value_terms) {
+            if (std::binary_search(_terms.begin(), _terms.end(), term)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    std::vector<bool> found(_terms.size(), false);
+    size_t num_found = 0;
+    for (auto& term : value_terms) {
+        auto it = std::lower_bound(_terms.begin(), _terms.end(), term);
+        if (it != _terms.end() && *it == term && !found[it - _terms.begin()]) {
+            found[it - _terms.begin()] = true;
+            if (++num_found == _terms.size()) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void MatchPredicate::evaluate(VectorizedRowBatch* batch) const {
+    uint16_t n = batch->size();
+    if (n == 0) {
+        return;
+    }
+    uint16_t* sel = batch->selected();
+    const Slice* col_vector = reinterpret_cast<const Slice*>(batch->column(_column_id)->col_data());
+    bool* is_null = batch->column(_column_id)->no_nulls() ? nullptr
+                                                           : batch->column(_column_id)->is_null();
+    uint16_t new_size = 0;
+    for (uint16_t j = 0; j != n; ++j) {
+        uint16_t i = batch->selected_in_use() ? sel[j] : j;
+        sel[new_size] = i;
+        new_size += (is_null == nullptr || !is_null[i]) &&
+                    _match(col_vector[i].data, col_vector[i].size);
+    }
+    if (new_size < n) {
+        batch->set_size(new_size);
+        batch->set_selected_in_use(true);
+    }
+}
+
+void MatchPredicate::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const {
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        uint16_t idx = sel[i];
+        sel[new_size] = idx;
+        const Slice* cell_value = reinterpret_cast<const Slice*>(block->cell(idx).cell_ptr());
+        new_size += !block->cell(idx).is_null() && _match(cell_value->data, cell_value->size);
+    }
+    *size = new_size;
+}
+
+void MatchPredicate::evaluate_or(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                                 bool* flags) const {
+    for (uint16_t i = 0; i < size; ++i) {
+        if (flags[i]) continue;
+        uint16_t idx = sel[i];
+        const Slice* cell_value = reinterpret_cast<const Slice*>(block->cell(idx).cell_ptr());
+        flags[i] |= !block->cell(idx).is_null() && _match(cell_value->data, cell_value->size);
+    }
+}
+
+void MatchPredicate::evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                                  bool* flags) const {
+    for (uint16_t i = 0; i < size; ++i) {
+        if (!flags[i]) continue;
+        uint16_t idx = sel[i];
+        const Slice* cell_value = reinterpret_cast<const Slice*>(block->cell(idx).cell_ptr());
+        flags[i] &= !block->cell(idx).is_null() && _match(cell_value->data, cell_value->size);
+    }
+}
+
+// call op(i, matched) for the i-th selected row
+template <typename Op>
+void MatchPredicate::_evaluate_column(const vectorized::IColumn& column, uint16_t* sel,
+                                      uint16_t size, Op op) const {
+    const vectorized::IColumn* nested_column = &column;
+    const uint8_t* null_map = nullptr;
+    if (column.is_nullable()) {
+        auto* nullable_col = vectorized::check_and_get_column<vectorized::ColumnNullable>(column);
+        null_map = nullable_col->get_null_map_column().get_data().data();
+        nested_column = &nullable_col->get_nested_column();
+    }
+    if (nested_column->is_column_dictionary()) {
+        auto* dict_col =
+                vectorized::check_and_get_column<vectorized::ColumnDictI32>(*nested_column);
+        auto& codes = dict_col->get_data();
+        for (uint16_t i = 0; i < size; ++i) {
+            uint16_t idx = sel[i];
+            if (null_map != nullptr && null_map[idx]) {
+                op(i, false);
+                continue;
+            }
+            StringRef value = dict_col->get_dict_value(codes[idx]);
+            op(i, _match(value.data, value.size));
+        }
+    } else {
+        auto* pred_col =
+                vectorized::check_and_get_column<vectorized::ColumnStringValue>(*nested_column);
+        auto& data = pred_col->get_data();
+        for (uint16_t i = 0; i < size; ++i) {
+            uint16_t idx = sel[i];
+            op(i, (null_map == nullptr || !null_map[idx]) && _match(data[idx].ptr, data[idx].len));
+        }
+    }
+}
+
+void MatchPredicate::evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const {
+    uint16_t new_size = 0;
+    _evaluate_column(column, sel, *size, [&](uint16_t i, bool matched) {
+        sel[new_size] = sel[i];
+        new_size += matched;
+    });
+    *size = new_size;
+}
+
+void MatchPredicate::evaluate_and(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                                  bool* flags) const {
+    _evaluate_column(column, sel, size, [&](uint16_t i, bool matched) { flags[i] &= matched; });
+}
+
+void MatchPredicate::evaluate_or(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                                 bool* flags) const {
+    _evaluate_column(column, sel, size, [&](uint16_t i, bool matched) { flags[i] |= matched; });
+}
+
+Status MatchPredicate::evaluate_inverted_index(BitmapIndexIterator* iterator,
+                                               roaring::Roaring* bitmap) const {
+    roaring::Roaring matched;
+    for (size_t i = 0; i < _terms.size(); ++i) {
+        Slice term(_terms[i]);
+        bool exact_match = false;
+        Status s = iterator->seek_dictionary(&term, &exact_match);
+        if (!s.ok() && !s.is_not_found()) {
+            return s;
+        }
+        roaring::Roaring term_rows;
+        if (s.ok() && exact_match) {
+            RETURN_IF_ERROR(iterator->read_bitmap(iterator->current_ordinal(), &term_rows));
+        }
+        if (_match_type == MatchType::MATCH_ANY) {
+            matched |= term_rows;
+        } else {
+            if (i == 0) {
+                matched = std::move(term_rows);
+            } else {
+                matched &= term_rows;
+            }
+            if (matched.isEmpty()) {
+                break;
+            }
+        }
+    }
+    *bitmap &= matched;
+    return Status::OK();
+}
+
+} //namespace doris
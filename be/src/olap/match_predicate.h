@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <roaring/roaring.hh>
+#include <string>
+#include <vector>
+
+#include "olap/column_predicate.h"
+#include "olap/rowset/segment_v2/inverted_index_parser.h"
+
+namespace doris {
+
+enum class MatchType {
+    // the value contains any term of the query
+    MATCH_ANY,
+    // the value contains all terms of the query
+    MATCH_ALL,
+};
+
+// A match condition pushed down to storage engine, see ReaderParams::match_conditions.
+struct MatchCondition {
+    std::string column_name;
+    MatchType match_type = MatchType::MATCH_ANY;
+    std::string query;
+};
+
+// Matches the terms of a string column against the terms of the query, both are split by
+// the parser of the column's inverted index. It is evaluated by the inverted index in
+// SegmentIterator if the segment has one, otherwise the values are split row by row.
+class MatchPredicate : public ColumnPredicate {
+public:
+    MatchPredicate(uint32_t column_id, MatchType match_type, const std::string& query,
+                   const std::string& parser_name, segment_v2::InvertedIndexParserType parser_type);
+
+    PredicateType type() const override { return PredicateType::MATCH; }
+
+    const std::string& parser_name() const { return _parser_name; }
+
+    void evaluate(VectorizedRowBatch* batch) const override;
+
+    void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
+    void evaluate_or(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                     bool* flags) const override;
+    void evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                      bool* flags) const override;
+
+    // bitmap index can't evaluate terms, SegmentIterator uses inverted index instead
+    Status evaluate(const Schema& schema, const std::vector<BitmapIndexIterator*>& iterators,
+                    uint32_t num_rows, roaring::Roaring* roaring) const override {
+        return Status::OK();
+    }
+
+    void evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const override;
+    void evaluate_and(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                      bool* flags) const override;
+    void evaluate_or(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                     bool* flags) const override;
+
+    // Intersect `bitmap` with the rows matched by the posting lists of inverted index.
+    Status evaluate_inverted_index(BitmapIndexIterator* iterator, roaring::Roaring* bitmap) const;
+
+private:
+    bool _match(const char* data, size_t size) const;
+
+    template <typename Op>
+    void _evaluate_column(const vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                          Op op) const;
+
+    MatchType _match_type;
+    std::string _parser_name;
+    segment_v2::InvertedIndexParserType _parser_type;
+    // sorted distinct terms of the query
+    std::vector<std::string> _terms;
+};
+
+} //namespace doris
@@ -17,6 +17,7 @@
 
 #include "olap/memtable.h"
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "olap/row.h"
 #include "olap/rowset/column_data_writer.h"
@@ -24,6 +25,7 @@
 #include "olap/schema.h"
 #include "runtime/tuple.h"
 #include "util/doris_metrics.h"
+#include "vec/core/sort_block.h"
 #include "vec/core/field.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/aggregate_functions/aggregate_function_reader.h"
@@ -49,10 +51,23 @@ MemTable::MemTable(int64_t tablet_id, Schema* schema, const TabletSchema* tablet
           _mem_usage(0) {
     if (support_vec) {
         _skip_list = nullptr;
-        _vec_row_comparator = std::make_shared<RowInBlockComparator>(_schema);
-        // TODO: Support ZOrderComparator in the future
-        _vec_skip_list = new VecTable(_vec_row_comparator.get(), _table_mem_pool.get(),
-                                      _keys_type == KeysType::DUP_KEYS);
+        _vec_row_comparator = std::make_shared<RowInBlockComparator>(_schema, tablet_schema);
+        // The rows of DUP_KEYS are only sorted without aggregation, so they're sorted at once
+        // when flushing, which is much cheaper than inserting into the skiplist row by row.
+        _is_batch_sort = _keys_type == KeysType::DUP_KEYS &&
+                         tablet_schema->sort_type() != SortType::ZORDER &&
+                         config::enable_memtable_batch_sort;
+        // The rows of the same key are aggregated in a hash table, which is much cheaper than
+        // searching the skiplist when there're many rows of the same keys.
+        _is_hash_agg = _keys_type != KeysType::DUP_KEYS && config::enable_memtable_hash_aggregation;
+        // the rows sorted by batch are already checked in order when flushing
+        _in_order = !_is_batch_sort && config::enable_memtable_ordered_append;
+        if (_is_batch_sort || _is_hash_agg) {
+            _vec_skip_list = nullptr;
+        } else {
+            _vec_skip_list = new VecTable(_vec_row_comparator.get(), _table_mem_pool.get(),
+                                          _keys_type == KeysType::DUP_KEYS);
+        }
     } else {
         _vec_skip_list = nullptr;
         if (tablet_schema->sort_type() == SortType::ZORDER) {
@@ -101,8 +116,22 @@ int MemTable::RowCursorComparator::operator()(const char* left, const char* righ
     return compare_row(lhs_row, rhs_row);
 }
 
+MemTable::RowInBlockComparator::RowInBlockComparator(const Schema* schema,
+                                                     const TabletSchema* tablet_schema)
+        : _schema(schema) {
+    if (tablet_schema->sort_type() == SortType::ZORDER) {
+        _zorder_comparator.reset(new vectorized::BlockZOrderComparator(*tablet_schema));
+    }
+}
+
 int MemTable::RowInBlockComparator::operator()(const RowInBlock* left,
                                                const RowInBlock* right) const {
+    if (_zorder_comparator != nullptr) {
+        int res = _zorder_comparator->compare_at(left->_row_pos, right->_row_pos, *_pblock);
+        if (res != 0) {
+            return res;
+        }
+    }
     return _pblock->compare_at(left->_row_pos, right->_row_pos, _schema->num_key_columns(),
                                *_pblock, -1);
 }
@@ -125,9 +154,101 @@ void MemTable::insert(const vectorized::Block* block, size_t row_pos, size_t num
     _mem_usage += newsize - oldsize;
     _mem_tracker->consume(newsize - oldsize);
 
+    if (_is_batch_sort) {
+        _rows += num_rows;
+        return;
+    }
+    size_t old_hash_agg_size = _hash_agg_memory_usage();
     for (int i = 0; i < num_rows; i++) {
         _row_in_blocks.emplace_back(new RowInBlock {cursor_in_mutableblock + i});
-        _insert_one_row_from_block(_row_in_blocks.back());
+        if (_in_order && _append_ordered_row(_row_in_blocks.back())) {
+            continue;
+        }
+        if (_is_hash_agg) {
+            _insert_one_row_to_hash_table(_row_in_blocks.back());
+        } else {
+            _insert_one_row_from_block(_row_in_blocks.back());
+        }
+    }
+    if (_is_hash_agg) {
+        size_t new_hash_agg_size = _hash_agg_memory_usage();
+        _mem_usage += new_hash_agg_size - old_hash_agg_size;
+        _mem_tracker->consume(new_hash_agg_size - old_hash_agg_size);
+    }
+}
+
+bool MemTable::_append_ordered_row(RowInBlock* row_in_block) {
+    if (!_ordered_rows.empty()) {
+        int res = (*_vec_row_comparator)(_ordered_rows.back(), row_in_block);
+        if (res > 0) {
+            _move_ordered_rows();
+            return false;
+        }
+        if (res == 0 && _keys_type != KeysType::DUP_KEYS) {
+            _rows++;
+            _aggregate_two_row_in_block(row_in_block, _ordered_rows.back());
+            return true;
+        }
+    }
+    _rows++;
+    if (_keys_type != KeysType::DUP_KEYS) {
+        _init_agg_row_in_block(row_in_block);
+    }
+    _ordered_rows.push_back(row_in_block);
+    return true;
+}
+
+void MemTable::_move_ordered_rows() {
+    _in_order = false;
+    // the keys of the ordered rows are distinct except for DUP_KEYS
+    for (auto row : _ordered_rows) {
+        if (_is_hash_agg) {
+            _hash_agg_table.emplace(_serialize_keys(row), row);
+        } else {
+            bool overwritten = false;
+            _vec_skip_list->Insert(row, &overwritten);
+        }
+    }
+    _ordered_rows.clear();
+}
+
+size_t MemTable::_hash_agg_memory_usage() const {
+    return _hash_agg_arena.size() +
+           _hash_agg_table.capacity() * (sizeof(StringRef) + sizeof(RowInBlock*) + 1);
+}
+
+StringRef MemTable::_serialize_keys(const RowInBlock* row_in_block) {
+    const char* begin = nullptr;
+    size_t key_size = 0;
+    auto& columns = _input_mutable_block.mutable_columns();
+    for (size_t cid = 0; cid < _schema->num_key_columns(); ++cid) {
+        key_size += columns[cid]->serialize_value_into_arena(row_in_block->_row_pos,
+                                                             _hash_agg_arena, begin)
+                            .size;
+    }
+    return StringRef(begin, key_size);
+}
+
+void MemTable::_insert_one_row_to_hash_table(RowInBlock* row_in_block) {
+    _rows++;
+    StringRef key = _serialize_keys(row_in_block);
+    auto [it, inserted] = _hash_agg_table.try_emplace(key, row_in_block);
+    if (!inserted) {
+        // the key is kept by the first row
+        _hash_agg_arena.rollback(key.size);
+        _aggregate_two_row_in_block(row_in_block, it->second);
+        return;
+    }
+    _init_agg_row_in_block(row_in_block);
+}
+
+void MemTable::_init_agg_row_in_block(RowInBlock* row_in_block) {
+    row_in_block->init_agg_places(_agg_functions, _schema->num_key_columns());
+    for (auto cid = _schema->num_key_columns(); cid < _schema->num_columns(); cid++) {
+        auto col_ptr = _input_mutable_block.mutable_columns()[cid].get();
+        auto place = row_in_block->_agg_places[cid];
+        _agg_functions[cid]->add(place, const_cast<const doris::vectorized::IColumn**>(&col_ptr),
+                                 row_in_block->_row_pos, nullptr);
     }
 }
 
@@ -145,15 +266,7 @@ void MemTable::_insert_one_row_from_block(RowInBlock* row_in_block) {
     if (is_exist) {
         _aggregate_two_row_in_block(row_in_block, _vec_hint.curr->key);
     } else {
-        row_in_block->init_agg_places(_agg_functions, _schema->num_key_columns());
-        for (auto cid = _schema->num_key_columns(); cid < _schema->num_columns(); cid++) {
-            auto col_ptr = _input_mutable_block.mutable_columns()[cid].get();
-            auto place = row_in_block->_agg_places[cid];
-            _agg_functions[cid]->add(place,
-                                     const_cast<const doris::vectorized::IColumn**>(&col_ptr),
-                                     row_in_block->_row_pos, nullptr);
-        }
-
+        _init_agg_row_in_block(row_in_block);
         _vec_skip_list->InsertWithHint(row_in_block, is_exist, &_vec_hint);
     }
 }
@@ -236,8 +349,61 @@ void MemTable::_aggregate_two_row_in_block(RowInBlock* new_row, RowInBlock* row_
     }
 }
 vectorized::Block MemTable::_collect_vskiplist_results() {
-    VecTable::Iterator it(_vec_skip_list);
+    if (_is_batch_sort) {
+        vectorized::Block block = _input_mutable_block.to_block();
+        // sorted by the key columns, and the nulls are in front as the storage layer
+        vectorized::SortDescription description;
+        for (size_t cid = 0; cid < _schema->num_key_columns(); ++cid) {
+            description.emplace_back(cid, 1, -1);
+        }
+        if (!vectorized::is_already_sorted(block, description)) {
+            vectorized::sort_block(block, description);
+        }
+        return block;
+    }
+    if (_in_order && _keys_type == KeysType::DUP_KEYS) {
+        // all the rows are in order as they are inserted
+        return _input_mutable_block.to_block();
+    }
+    std::vector<RowInBlock*> sorted_rows;
+    if (_in_order) {
+        // the rows are appended in order, no need to sort
+        sorted_rows.swap(_ordered_rows);
+    } else if (_is_hash_agg) {
+        // Sort the distinct keys only, before the columns of `_input_mutable_block` read by
+        // the comparator are moved to `in_block`.
+        sorted_rows.reserve(_hash_agg_table.size());
+        for (auto& [key, row] : _hash_agg_table) {
+            sorted_rows.push_back(row);
+        }
+        std::sort(sorted_rows.begin(), sorted_rows.end(),
+                  [this](const RowInBlock* lhs, const RowInBlock* rhs) {
+                      return (*_vec_row_comparator)(lhs, rhs) < 0;
+                  });
+    }
     vectorized::Block in_block = _input_mutable_block.to_block();
+    auto& block_data = in_block.get_columns_with_type_and_name();
+    auto insert_agg_row = [&](RowInBlock* row) {
+        // move key columns
+        for (size_t i = 0; i < _schema->num_key_columns(); ++i) {
+            _output_mutable_block.get_column_by_position(i)->insert_from(
+                    *block_data[i].column.get(), row->_row_pos);
+        }
+        // get value columns from agg_places
+        for (size_t i = _schema->num_key_columns(); i < _schema->num_columns(); ++i) {
+            auto function = _agg_functions[i];
+            function->insert_result_into(row->_agg_places[i],
+                                         *(_output_mutable_block.get_column_by_position(i)));
+            function->destroy(row->_agg_places[i]);
+        }
+    };
+    if (_in_order || _is_hash_agg) {
+        for (auto row : sorted_rows) {
+            insert_agg_row(row);
+        }
+        return _output_mutable_block.to_block();
+    }
+    VecTable::Iterator it(_vec_skip_list);
     // TODO: should try to insert data by column, not by row. to opt the the code
     if (_keys_type == KeysType::DUP_KEYS) {
         for (it.SeekToFirst(); it.Valid(); it.Next()) {
@@ -245,19 +411,7 @@ vectorized::Block MemTable::_collect_vskiplist_results() {
         }
     } else {
         for (it.SeekToFirst(); it.Valid(); it.Next()) {
-            auto& block_data = in_block.get_columns_with_type_and_name();
-            // move key columns
-            for (size_t i = 0; i < _schema->num_key_columns(); ++i) {
-                _output_mutable_block.get_column_by_position(i)->insert_from(
-                        *block_data[i].column.get(), it.key()->_row_pos);
-            }
-            // get value columns from agg_places
-            for (size_t i = _schema->num_key_columns(); i < _schema->num_columns(); ++i) {
-                auto function = _agg_functions[i];
-                function->insert_result_into(it.key()->_agg_places[i],
-                                             *(_output_mutable_block.get_column_by_position(i)));
-                function->destroy(it.key()->_agg_places[i]);
-            }
+            insert_agg_row(it.key());
         }
     }
     return _output_mutable_block.to_block();
@@ -295,9 +449,14 @@ Status MemTable::_do_flush(int64_t& duration_ns) {
         }
     } else {
         vectorized::Block block = _collect_vskiplist_results();
-        RETURN_NOT_OK(_rowset_writer->add_block(&block));
-        _flush_size = block.allocated_bytes();
-        RETURN_NOT_OK(_rowset_writer->flush());
+        Status st = _rowset_writer->flush_single_block(&block, &_flush_size);
+        if (st == Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED)) {
+            RETURN_NOT_OK(_rowset_writer->add_block(&block));
+            _flush_size = block.allocated_bytes();
+            RETURN_NOT_OK(_rowset_writer->flush());
+        } else {
+            RETURN_NOT_OK(st);
+        }
     }
     return Status::OK();
 }
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <parallel_hashmap/phmap.h>
+
 #include <ostream>
 
 #include "common/object_pool.h"
@@ -24,7 +26,9 @@
 #include "olap/skiplist.h"
 #include "runtime/mem_tracker.h"
 #include "util/tuple_row_zorder_compare.h"
+#include "vec/olap/block_zorder_compare.h"
 #include "vec/core/block.h"
+#include "vec/common/arena.h"
 #include "vec/common/string_ref.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 
@@ -102,7 +106,7 @@ private:
 
     class RowInBlockComparator {
     public:
-        RowInBlockComparator(const Schema* schema) : _schema(schema) {};
+        RowInBlockComparator(const Schema* schema, const TabletSchema* tablet_schema);
         // call set_block before operator().
         // only first time insert block to create _input_mutable_block,
         // so can not Comparator of construct to set pblock
@@ -112,6 +116,8 @@ private:
     private:
         const Schema* _schema;
         vectorized::MutableBlock* _pblock; // 对应Memtable::_input_mutable_block
+        // set for tablets with SortType::ZORDER
+        std::unique_ptr<vectorized::BlockZOrderComparator> _zorder_comparator;
     };
 
 private:
@@ -142,7 +148,19 @@ private:
     void _aggregate_two_row(const ContiguousRow& new_row, TableKey row_in_skiplist);
     // for vectorized
     void _insert_one_row_from_block(RowInBlock* row_in_block);
+    // aggregate the row into the row of the same key in `_hash_agg_table`, or insert it
+    void _insert_one_row_to_hash_table(RowInBlock* row_in_block);
+    // serialize the keys of the row into `_hash_agg_arena`
+    StringRef _serialize_keys(const RowInBlock* row_in_block);
+    // append the row to `_ordered_rows` if it's not less than the last one, return false if
+    // it's out of order
+    bool _append_ordered_row(RowInBlock* row_in_block);
+    // move `_ordered_rows` into the skiplist or the hash table once a row is out of order
+    void _move_ordered_rows();
+    // create the aggregate states of the first row of a key, and add the values into them
+    void _init_agg_row_in_block(RowInBlock* row_in_block);
     void _aggregate_two_row_in_block(RowInBlock* new_row, RowInBlock* row_in_skiplist);
+    size_t _hash_agg_memory_usage() const;
 
     int64_t _tablet_id;
     Schema* _schema;
@@ -176,6 +194,22 @@ private:
 
     VecTable* _vec_skip_list;
     VecTable::Hint _vec_hint;
+    // the vectorized rows are sorted at once when flushing, and `_vec_skip_list` is not used
+    bool _is_batch_sort = false;
+    // The vectorized rows of AGG_KEYS and UNIQUE_KEYS are aggregated by a hash table of the
+    // serialized keys, and only the distinct keys are sorted when flushing.
+    // `_vec_skip_list` is not used.
+    bool _is_hash_agg = false;
+    // the serialized keys of `_hash_agg_table`
+    vectorized::Arena _hash_agg_arena;
+    phmap::flat_hash_map<StringRef, RowInBlock*> _hash_agg_table;
+    // The vectorized rows are appended to `_ordered_rows` without the skiplist or the hash
+    // table while each row is not less than the last one, and a row of the same key as the last
+    // one is aggregated into it. So the rows are neither compared against the other rows nor
+    // sorted when flushing. Once a row is out of order, the ordered rows are moved into the
+    // skiplist or the hash table, which are used by the rest of the rows.
+    bool _in_order = false;
+    std::vector<RowInBlock*> _ordered_rows;
 
     RowsetWriter* _rowset_writer;
 
@@ -17,15 +17,24 @@
 
 #include "olap/merger.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
+#include "gutil/strings/substitute.h"
+#include "olap/key_coder.h"
 #include "olap/olap_define.h"
 #include "olap/tuple_reader.h"
 #include "vec/olap/block_reader.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/segment_loader.h"
+#include "olap/short_key_index.h"
 #include "olap/tablet.h"
+#include "olap/types.h"
 #include "util/trace.h"
+#include "vec/olap/vertical_block_reader.h"
+#include "vec/olap/vertical_merge_iterator.h"
 
 namespace doris {
 
@@ -89,7 +98,8 @@ Status Merger::merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
 
 Status Merger::vmerge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
                               const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
-                              RowsetWriter* dst_rowset_writer, Statistics* stats_output) {
+                              RowsetWriter* dst_rowset_writer, Statistics* stats_output,
+                              const KeyRange* key_range) {
     TRACE_COUNTER_SCOPE_LATENCY_US("merge_rowsets_latency_us");
 
     vectorized::BlockReader reader;
@@ -98,6 +108,14 @@ Status Merger::vmerge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
     reader_params.reader_type = reader_type;
     reader_params.rs_readers = src_rowset_readers;
     reader_params.version = dst_rowset_writer->version();
+    if (key_range != nullptr) {
+        reader_params.start_key.push_back(key_range->start);
+        if (key_range->end.size() > 0) {
+            reader_params.end_key.push_back(key_range->end);
+        }
+        reader_params.start_key_include = true;
+        reader_params.end_key_include = false;
+    }
 
     const auto& schema = tablet->tablet_schema();
     reader_params.return_columns.resize(schema.num_columns());
@@ -133,4 +151,210 @@ Status Merger::vmerge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
     return Status::OK();
 }
 
+namespace {
+
+// decode the short key encoded by encode_key() into the values of the short key columns
+Status decode_short_key(const TabletSchema& tablet_schema, const std::string& encoded_key,
+                        MemPool* pool, OlapTuple* tuple) {
+    Slice key(encoded_key);
+    for (size_t cid = 0; cid < tablet_schema.num_short_key_columns(); ++cid) {
+        if (key.empty()) {
+            return Status::Corruption("the short key is shorter than the short key columns");
+        }
+        uint8_t marker = key[0];
+        key.remove_prefix(1);
+        if (marker == KEY_NULL_FIRST_MARKER) {
+            tuple->add_null();
+            continue;
+        }
+        if (marker != KEY_NORMAL_MARKER) {
+            return Status::Corruption(
+                    strings::Substitute("invalid marker $0 of the short key", marker));
+        }
+        const TabletColumn& column = tablet_schema.column(cid);
+        alignas(16) uint8_t cell[32];
+        RETURN_IF_ERROR(get_key_coder(column.type())
+                                ->decode_ascending(&key, column.index_length(), cell, pool));
+        tuple->add_value(get_scalar_type_info(column.type())->to_string(cell));
+    }
+    return Status::OK();
+}
+
+} // namespace
+
+Status Merger::split_key_ranges(const TabletSchema& tablet_schema,
+                                const std::vector<RowsetSharedPtr>& rowsets, int num_ranges,
+                                std::vector<KeyRange>* ranges, size_t max_keys_per_segment) {
+    // the short keys with the number of the rows of the segment each of them stands for
+    std::vector<std::pair<std::string, int64_t>> short_keys;
+    int64_t total_rows = 0;
+    for (auto& rowset : rowsets) {
+        SegmentCacheHandle segment_cache_handle;
+        RETURN_NOT_OK(SegmentLoader::instance()->load_segments(
+                std::static_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
+        for (auto& segment : segment_cache_handle.get_segments()) {
+            std::vector<std::string> keys;
+            RETURN_NOT_OK(segment->get_short_keys(&keys, max_keys_per_segment));
+            if (keys.empty()) {
+                continue;
+            }
+            int64_t key_rows = std::max<int64_t>(segment->num_rows() / keys.size(), 1);
+            for (auto& key : keys) {
+                short_keys.emplace_back(std::move(key), key_rows);
+                total_rows += key_rows;
+            }
+        }
+    }
+    // the encoded short keys are ordered by memcmp
+    std::sort(short_keys.begin(), short_keys.end());
+
+    // the boundaries of the ranges are the short keys at the quantiles of the rows
+    MemPool pool("SplitKeyRanges");
+    std::vector<OlapTuple> boundaries;
+    const std::string* last_key = nullptr;
+    int64_t rows = 0;
+    int quantile = 1;
+    for (auto& [key, key_rows] : short_keys) {
+        if (quantile >= num_ranges) {
+            break;
+        }
+        if (rows >= total_rows * quantile / num_ranges) {
+            if (last_key == nullptr || key != *last_key) {
+                OlapTuple boundary;
+                RETURN_NOT_OK(decode_short_key(tablet_schema, key, &pool, &boundary));
+                boundaries.push_back(std::move(boundary));
+                last_key = &key;
+            }
+            while (quantile < num_ranges && rows >= total_rows * quantile / num_ranges) {
+                ++quantile;
+            }
+        }
+        rows += key_rows;
+    }
+
+    // the first range starts from the null keys, which are the smallest
+    OlapTuple start;
+    for (size_t cid = 0; cid < tablet_schema.num_short_key_columns(); ++cid) {
+        start.add_null();
+    }
+    for (auto& boundary : boundaries) {
+        KeyRange range;
+        range.start = std::move(start);
+        range.end = boundary;
+        ranges->push_back(std::move(range));
+        start = std::move(boundary);
+    }
+    // the last range has no upper bound, there is no max key of the strings
+    KeyRange last_range;
+    last_range.start = std::move(start);
+    ranges->push_back(std::move(last_range));
+    return Status::OK();
+}
+
+void Merger::vertical_split_columns(const TabletSchema& tablet_schema,
+                                    std::vector<std::vector<uint32_t>>* column_groups) {
+    uint32_t num_key_cols = tablet_schema.num_key_columns();
+    uint32_t total_cols = tablet_schema.num_columns();
+    std::vector<uint32_t> key_columns(num_key_cols);
+    std::iota(key_columns.begin(), key_columns.end(), 0);
+    // the sequence column decides the merged order, so it's merged with the key columns
+    int32_t sequence_col_idx = tablet_schema.sequence_col_idx();
+    if (sequence_col_idx != -1) {
+        key_columns.push_back(sequence_col_idx);
+    }
+    column_groups->push_back(std::move(key_columns));
+
+    std::vector<uint32_t> value_columns;
+    for (uint32_t i = num_key_cols; i < total_cols; ++i) {
+        if (static_cast<int32_t>(i) == sequence_col_idx) {
+            continue;
+        }
+        value_columns.push_back(i);
+        if (value_columns.size() >= config::vertical_compaction_num_columns_per_group) {
+            column_groups->push_back(std::move(value_columns));
+            value_columns.clear();
+        }
+    }
+    if (!value_columns.empty()) {
+        column_groups->push_back(std::move(value_columns));
+    }
+}
+
+Status Merger::vertical_compact_one_group(
+        TabletSharedPtr tablet, ReaderType reader_type, bool is_key,
+        const std::vector<uint32_t>& column_group, vectorized::RowSourcesBuffer* row_source_buf,
+        const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+        RowsetWriter* dst_rowset_writer, uint32_t max_rows_per_segment,
+        Statistics* stats_output) {
+    // the rowset readers can't be inited twice, create new ones for each group
+    std::vector<RowsetReaderSharedPtr> rs_readers;
+    for (auto& src_reader : src_rowset_readers) {
+        RowsetReaderSharedPtr rs_reader;
+        RETURN_NOT_OK(src_reader->rowset()->create_reader(&rs_reader));
+        rs_readers.push_back(std::move(rs_reader));
+    }
+
+    vectorized::VerticalBlockReader reader(row_source_buf);
+    TabletReader::ReaderParams reader_params;
+    reader_params.is_key_column_group = is_key;
+    reader_params.tablet = tablet;
+    reader_params.reader_type = reader_type;
+    reader_params.rs_readers = rs_readers;
+    reader_params.version = dst_rowset_writer->version();
+    reader_params.return_columns = column_group;
+    reader_params.origin_return_columns = &reader_params.return_columns;
+    RETURN_NOT_OK(reader.init(reader_params));
+
+    const auto& schema = tablet->tablet_schema();
+    vectorized::Block block = schema.create_block(reader.return_columns());
+    size_t output_rows = 0;
+    bool eof = false;
+    while (!eof) {
+        // Read one block from block reader
+        RETURN_NOT_OK_LOG(
+                reader.next_block_with_aggregation(&block, nullptr, nullptr, &eof),
+                "failed to read next block when merging rowsets of tablet " + tablet->full_name());
+        RETURN_NOT_OK_LOG(
+                dst_rowset_writer->add_columns(&block, column_group, is_key, max_rows_per_segment),
+                "failed to write block when merging rowsets of tablet " + tablet->full_name());
+        output_rows += block.rows();
+        block.clear_column_data();
+    }
+
+    if (is_key && stats_output != nullptr) {
+        stats_output->output_rows = output_rows;
+        stats_output->merged_rows = reader.merged_rows();
+        stats_output->filtered_rows = reader.filtered_rows();
+    }
+    RETURN_NOT_OK_LOG(dst_rowset_writer->flush_columns(),
+                      "failed to flush columns when merging rowsets of tablet " +
+                              tablet->full_name());
+    return Status::OK();
+}
+
+Status Merger::vertical_merge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
+                                      const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+                                      RowsetWriter* dst_rowset_writer,
+                                      uint32_t max_rows_per_segment, Statistics* stats_output) {
+    TRACE_COUNTER_SCOPE_LATENCY_US("vertical_merge_rowsets_latency_us");
+
+    std::vector<std::vector<uint32_t>> column_groups;
+    vertical_split_columns(tablet->tablet_schema(), &column_groups);
+
+    vectorized::RowSourcesBuffer row_sources_buf;
+    for (size_t i = 0; i < column_groups.size(); ++i) {
+        bool is_key = (i == 0);
+        RETURN_IF_ERROR(vertical_compact_one_group(tablet, reader_type, is_key, column_groups[i],
+                                                   &row_sources_buf, src_rowset_readers,
+                                                   dst_rowset_writer, max_rows_per_segment,
+                                                   stats_output));
+        // the value column groups replay the row sources from the beginning
+        row_sources_buf.seek_to_begin();
+    }
+    RETURN_NOT_OK_LOG(
+            dst_rowset_writer->final_flush(),
+            "failed to flush rowset when merging rowsets of tablet " + tablet->full_name());
+    return Status::OK();
+}
+
 } // namespace doris
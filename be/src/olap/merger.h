@@ -20,9 +20,14 @@
 #include "olap/olap_define.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/tablet.h"
+#include "olap/tuple.h"
 
 namespace doris {
 
+namespace vectorized {
+class RowSourcesBuffer;
+} // namespace vectorized
+
 class Merger {
 public:
     struct Statistics {
@@ -39,9 +44,47 @@ public:
                                 const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
                                 RowsetWriter* dst_rowset_writer, Statistics* stats_output);
 
+    // A range of the short keys, [start, end), or [start, +inf) if `end` is empty.
+    struct KeyRange {
+        OlapTuple start;
+        OlapTuple end;
+    };
+
+    // only merge the rows in `key_range` if it's not nullptr
     static Status vmerge_rowsets(TabletSharedPtr tablet, ReaderType reader_type,
                                  const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
-                                 RowsetWriter* dst_rowset_writer, Statistics* stats_output);
+                                 RowsetWriter* dst_rowset_writer, Statistics* stats_output,
+                                 const KeyRange* key_range = nullptr);
+
+    // Split the keys of `rowsets` into at most `num_ranges` ordered ranges of about the same
+    // number of rows, by the short key index of the segments. The ranges cover all the keys.
+    // At most `max_keys_per_segment` short keys of a segment are sampled if it's not 0.
+    static Status split_key_ranges(const TabletSchema& tablet_schema,
+                                   const std::vector<RowsetSharedPtr>& rowsets, int num_ranges,
+                                   std::vector<KeyRange>* ranges,
+                                   size_t max_keys_per_segment = 0);
+
+    // Split the columns into groups for vertical compaction, the first group consists of the
+    // key columns and the sequence column, others are value columns.
+    static void vertical_split_columns(const TabletSchema& tablet_schema,
+                                       std::vector<std::vector<uint32_t>>* column_groups);
+
+    // merge rows from `src_rowset_readers` column group by column group, the key column group
+    // is merged first and the order of the rows is replayed by the value column groups.
+    // `dst_rowset_writer` must be created with `is_vertical`.
+    static Status vertical_merge_rowsets(
+            TabletSharedPtr tablet, ReaderType reader_type,
+            const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+            RowsetWriter* dst_rowset_writer, uint32_t max_rows_per_segment,
+            Statistics* stats_output);
+
+private:
+    static Status vertical_compact_one_group(
+            TabletSharedPtr tablet, ReaderType reader_type, bool is_key,
+            const std::vector<uint32_t>& column_group, vectorized::RowSourcesBuffer* row_source_buf,
+            const std::vector<RowsetReaderSharedPtr>& src_rowset_readers,
+            RowsetWriter* dst_rowset_writer, uint32_t max_rows_per_segment,
+            Statistics* stats_output);
 };
 
 } // namespace doris
@@ -262,6 +262,10 @@ struct OlapReaderStatistics {
     int64_t raw_rows_read = 0;
 
     int64_t rows_vec_cond_filtered = 0;
+    // the runtime bloom filters no longer evaluated on a segment since they filter too few rows
+    int64_t runtime_filters_dropped = 0;
+    // the runtime bloom filters applied to a segment after it has been opened
+    int64_t runtime_filters_applied_in_flight = 0;
     int64_t rows_vec_del_cond_filtered = 0;
     int64_t vec_cond_ns = 0;
     int64_t short_cond_ns = 0;
@@ -280,14 +284,21 @@ struct OlapReaderStatistics {
     int64_t rows_del_filtered = 0;
     // the number of rows filtered by various column indexes.
     int64_t rows_conditions_filtered = 0;
+    // the number of rows deleted by later loads in merge-on-write unique key tablets
+    int64_t rows_del_by_bitmap = 0;
 
     int64_t index_load_ns = 0;
 
     int64_t total_pages_num = 0;
     int64_t cached_pages_num = 0;
+    // the data pages read ahead by the page prefetcher, and the time waiting for them
+    int64_t prefetched_pages_num = 0;
+    int64_t page_prefetch_wait_ns = 0;
 
     int64_t rows_bitmap_index_filtered = 0;
     int64_t bitmap_index_filter_timer = 0;
+    int64_t rows_inverted_index_filtered = 0;
+    int64_t inverted_index_filter_timer = 0;
     // number of segment filtered by column stat when creating seg iterator
     int64_t filtered_segment_number = 0;
     // total number of segment
@@ -387,4 +398,27 @@ struct RowsetId {
     }
 };
 
+// The location of a row in a rowset
+struct RowLocation {
+    RowLocation() = default;
+    RowLocation(RowsetId rowset_id, uint32_t segment_id, uint32_t row_id)
+            : rowset_id(rowset_id), segment_id(segment_id), row_id(row_id) {}
+
+    RowsetId rowset_id;
+    uint32_t segment_id = 0;
+    uint32_t row_id = 0;
+};
+
+// The location of a row in the cluster, carried by the row locator column of a scan to fetch
+// the other columns of the row later. It's stored as the raw bytes of this struct.
+struct GlobalRowLocation {
+    GlobalRowLocation() = default;
+    GlobalRowLocation(int64_t backend_id, int64_t tablet_id, const RowLocation& row_location)
+            : backend_id(backend_id), tablet_id(tablet_id), row_location(row_location) {}
+
+    int64_t backend_id = 0;
+    int64_t tablet_id = 0;
+    RowLocation row_location;
+};
+
 } // namespace doris
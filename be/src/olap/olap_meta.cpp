@@ -17,15 +17,18 @@
 
 #include "olap/olap_meta.h"
 
+#include <algorithm>
 #include <sstream>
 #include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "olap/olap_define.h"
 #include "rocksdb/db.h"
 #include "rocksdb/options.h"
 #include "rocksdb/slice.h"
 #include "rocksdb/slice_transform.h"
+#include "rocksdb/write_batch.h"
 #include "util/doris_metrics.h"
 #include "util/runtime_profile.h"
 
@@ -124,9 +127,7 @@ Status OlapMeta::put(const int column_family_index, const std::string& key,
     rocksdb::Status s;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
-        s = _db->Put(write_options, handle, rocksdb::Slice(key), rocksdb::Slice(value));
+        s = _write({{handle, &key, &value}});
     }
     DorisMetrics::instance()->meta_write_request_duration_us->increment(duration_ns / 1000);
     if (!s.ok()) {
@@ -136,6 +137,30 @@ Status OlapMeta::put(const int column_family_index, const std::string& key,
     return Status::OK();
 }
 
+Status OlapMeta::put(const int column_family_index,
+                     const std::vector<std::pair<std::string, std::string>>& entries) {
+    DorisMetrics::instance()->meta_write_request_total->increment(1);
+    rocksdb::ColumnFamilyHandle* handle = _handles[column_family_index];
+    int64_t duration_ns = 0;
+    rocksdb::Status s;
+    {
+        SCOPED_RAW_TIMER(&duration_ns);
+        std::vector<WriteOp> ops;
+        ops.reserve(entries.size());
+        for (const auto& [key, value] : entries) {
+            ops.push_back({handle, &key, &value});
+        }
+        s = _write(std::move(ops));
+    }
+    DorisMetrics::instance()->meta_write_request_duration_us->increment(duration_ns / 1000);
+    if (!s.ok()) {
+        LOG(WARNING) << "rocks db put " << entries.size()
+                     << " keys failed, reason:" << s.ToString();
+        return Status::OLAPInternalError(OLAP_ERR_META_PUT);
+    }
+    return Status::OK();
+}
+
 Status OlapMeta::remove(const int column_family_index, const std::string& key) {
     DorisMetrics::instance()->meta_write_request_total->increment(1);
     rocksdb::ColumnFamilyHandle* handle = _handles[column_family_index];
@@ -143,9 +168,7 @@ Status OlapMeta::remove(const int column_family_index, const std::string& key) {
     int64_t duration_ns = 0;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        WriteOptions write_options;
-        write_options.sync = config::sync_tablet_meta;
-        s = _db->Delete(write_options, handle, rocksdb::Slice(key));
+        s = _write({{handle, &key, nullptr}});
     }
     DorisMetrics::instance()->meta_write_request_duration_us->increment(duration_ns / 1000);
     if (!s.ok()) {
@@ -155,6 +178,67 @@ Status OlapMeta::remove(const int column_family_index, const std::string& key) {
     return Status::OK();
 }
 
+struct OlapMeta::PendingWrite {
+    std::vector<WriteOp> ops;
+    rocksdb::Status status;
+    bool done = false;
+};
+
+rocksdb::Status OlapMeta::_write(std::vector<WriteOp> ops) {
+    PendingWrite write;
+    write.ops = std::move(ops);
+    if (!config::enable_meta_group_commit) {
+        return _write_batch({&write});
+    }
+
+    std::unique_lock<std::mutex> l(_write_lock);
+    _pending_writes.push_back(&write);
+    while (!write.done && &write != _pending_writes.front()) {
+        _write_cond.wait(l);
+    }
+    if (write.done) {
+        // committed by the leader of its group
+        return write.status;
+    }
+
+    // This write is the leader, commit it with the writes queued behind it. The writes queued
+    // during the commit are committed by the next group.
+    size_t group_size = std::min<size_t>(_pending_writes.size(),
+                                         std::max(1, config::meta_group_commit_max_writes));
+    std::vector<PendingWrite*> group(_pending_writes.begin(),
+                                     _pending_writes.begin() + group_size);
+    l.unlock();
+    rocksdb::Status s = _write_batch(group);
+    l.lock();
+    for (PendingWrite* pending_write : group) {
+        DCHECK(pending_write == _pending_writes.front());
+        _pending_writes.pop_front();
+        pending_write->status = s;
+        pending_write->done = true;
+    }
+    // wake up the writes of the group and the leader of the next group
+    _write_cond.notify_all();
+    return s;
+}
+
+rocksdb::Status OlapMeta::_write_batch(const std::vector<PendingWrite*>& group) {
+    rocksdb::WriteBatch batch;
+    for (const PendingWrite* pending_write : group) {
+        for (const WriteOp& op : pending_write->ops) {
+            rocksdb::Status s = op.value == nullptr
+                                        ? batch.Delete(op.handle, rocksdb::Slice(*op.key))
+                                        : batch.Put(op.handle, rocksdb::Slice(*op.key),
+                                                    rocksdb::Slice(*op.value));
+            if (!s.ok()) {
+                return s;
+            }
+        }
+    }
+    WriteOptions write_options;
+    write_options.sync = config::sync_tablet_meta;
+    return _db->Write(write_options, &batch);
+}
+
 Status OlapMeta::iterate(const int column_family_index, const std::string& prefix,
                          std::function<bool(const std::string&, const std::string&)> const& func) {
     rocksdb::ColumnFamilyHandle* handle = _handles[column_family_index];
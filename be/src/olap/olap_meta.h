@@ -17,9 +17,14 @@
 
 #pragma once
 
+#include <condition_variable>
+#include <deque>
 #include <functional>
 #include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "olap/olap_define.h"
 #include "rocksdb/db.h"
@@ -40,6 +45,10 @@ public:
 
     Status put(const int column_family_index, const std::string& key, const std::string& value);
 
+    // Put the key-value pairs atomically by one write batch.
+    Status put(const int column_family_index,
+               const std::vector<std::pair<std::string, std::string>>& entries);
+
     Status remove(const int column_family_index, const std::string& key);
 
     Status iterate(const int column_family_index, const std::string& prefix,
@@ -48,9 +57,30 @@ public:
     std::string get_root_path();
 
 private:
+    // A put or remove of a key, the key and the value are owned by the caller.
+    struct WriteOp {
+        rocksdb::ColumnFamilyHandle* handle;
+        const std::string* key;
+        // null for a remove
+        const std::string* value;
+    };
+    struct PendingWrite;
+
+    // Write the ops atomically. With the group commit, the ops of the concurrent writes are
+    // committed together by one write batch, which pays for one wal sync, and each write
+    // returns after the group is durable.
+    rocksdb::Status _write(std::vector<WriteOp> ops);
+    rocksdb::Status _write_batch(const std::vector<PendingWrite*>& group);
+
     std::string _root_path;
     rocksdb::DB* _db;
     std::vector<rocksdb::ColumnFamilyHandle*> _handles;
+
+    // the writes waiting for the group commit, the first one is the leader which commits the
+    // group of the writes in the queue
+    std::mutex _write_lock;
+    std::condition_variable _write_cond;
+    std::deque<PendingWrite*> _pending_writes;
 };
 
 } // namespace doris
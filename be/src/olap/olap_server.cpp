@@ -19,6 +19,7 @@
 #include <sys/socket.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 #include <cmath>
 #include <ctime>
@@ -32,6 +33,7 @@
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/storage_engine.h"
+#include "olap/task/engine_storage_migration_task.h"
 #include "util/time.h"
 
 using std::string;
@@ -70,6 +72,7 @@ Status StorageEngine::start_bg_threads() {
     ThreadPoolBuilder("CompactionTaskThreadPool")
             .set_min_threads(max_thread_num)
             .set_max_threads(max_thread_num)
+            .set_work_stealing(config::enable_work_stealing_thread_pool)
             .build(&_compaction_thread_pool);
 
     // compaction tasks producer thread
@@ -99,6 +102,17 @@ Status StorageEngine::start_bg_threads() {
             [this]() { this->_fd_cache_clean_callback(); }, &_fd_cache_clean_thread));
     LOG(INFO) << "fd cache clean thread started";
 
+    RETURN_IF_ERROR(Thread::create(
+            "StorageEngine", "tablet_tiering_thread",
+            [this]() { this->_tablet_tiering_callback(); }, &_tablet_tiering_thread));
+    LOG(INFO) << "tablet tiering thread started";
+
+    RETURN_IF_ERROR(Thread::create(
+            "StorageEngine", "delete_predicate_bitmap_thread",
+            [this]() { this->_delete_predicate_bitmap_callback(); },
+            &_delete_predicate_bitmap_thread));
+    LOG(INFO) << "delete predicate bitmap thread started";
+
     // path scan and gc thread
     if (config::path_gc_check) {
         for (auto data_dir : get_stores()) {
@@ -145,6 +159,163 @@ void StorageEngine::_fd_cache_clean_callback() {
     }
 }
 
+void StorageEngine::_tablet_tiering_callback() {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    int32_t interval = std::max(1, config::tablet_auto_tiering_interval_sec);
+    // the first round is after an interval, so the scan heat covers the scans of the interval
+    while (!_stop_background_threads_latch.wait_for(std::chrono::seconds(interval))) {
+        if (config::enable_tablet_auto_tiering && available_storage_medium_type_count() > 1) {
+            _adjust_tablet_tiering();
+        }
+        interval = config::tablet_auto_tiering_interval_sec;
+        if (interval <= 0) {
+            LOG(WARNING) << "tablet auto tiering interval config is illegal: " << interval
+                         << ", force set to 600";
+            interval = 600;
+        }
+    }
+}
+
+void StorageEngine::_delete_predicate_bitmap_callback() {
+#ifdef GOOGLE_PROFILER
+    ProfilerRegisterThread();
+#endif
+    int32_t interval = std::max(1, config::delete_predicate_bitmap_interval_sec);
+    while (!_stop_background_threads_latch.wait_for(std::chrono::seconds(interval))) {
+        if (config::enable_delete_predicate_bitmap) {
+            int budget = config::delete_predicate_bitmap_max_rowsets_per_round;
+            for (auto& tablet : _tablet_manager->get_all_tablets()) {
+                if (budget <= 0) {
+                    break;
+                }
+                if (tablet->tablet_state() != TABLET_RUNNING) {
+                    continue;
+                }
+                int num_rowsets = 0;
+                Status st = tablet->calc_delete_predicate_bitmaps(budget, &num_rowsets);
+                if (!st.ok()) {
+                    LOG(WARNING) << "failed to calc the delete predicate bitmaps of tablet "
+                                 << tablet->full_name() << ": " << st;
+                }
+                budget -= num_rowsets;
+            }
+        }
+        interval = config::delete_predicate_bitmap_interval_sec;
+        if (interval <= 0) {
+            LOG(WARNING) << "delete predicate bitmap interval config is illegal: " << interval
+                         << ", force set to 60";
+            interval = 60;
+        }
+    }
+}
+
+void StorageEngine::_adjust_tablet_tiering() {
+    int64_t ssd_budget = 0;
+    for (auto store : get_stores()) {
+        if (store->is_used() && store->is_ssd_disk()) {
+            ssd_budget += store->get_dir_info().disk_capacity *
+                          config::tablet_auto_tiering_ssd_usage_percent / 100;
+        }
+    }
+
+    std::vector<TabletHeat> tablets;
+    for (auto& tablet : _tablet_manager->get_all_tablets()) {
+        if (tablet->data_dir()->is_remote()) {
+            continue;
+        }
+        double heat = tablet->update_scan_heat();
+        tablets.push_back({tablet, heat, static_cast<int64_t>(tablet->tablet_footprint()),
+                           tablet->data_dir()->is_ssd_disk()});
+    }
+    std::vector<size_t> promotion_indexes;
+    std::vector<size_t> demotion_indexes;
+    int64_t hot_bytes =
+            _plan_tablet_tiering(&tablets, ssd_budget, &promotion_indexes, &demotion_indexes);
+    std::vector<TabletSharedPtr> promotions;
+    for (size_t i : promotion_indexes) {
+        promotions.push_back(tablets[i].tablet);
+    }
+    std::vector<TabletSharedPtr> demotions;
+    for (size_t i : demotion_indexes) {
+        demotions.push_back(tablets[i].tablet);
+    }
+
+    int32_t num_migrated = 0;
+    int64_t migrated_bytes = 0;
+    auto migrate = [&](const TabletSharedPtr& tablet, TStorageMedium::type storage_medium) {
+        if (num_migrated >= config::tablet_auto_tiering_max_migrations_per_round ||
+            migrated_bytes >= config::tablet_auto_tiering_max_bytes_per_round) {
+            return false;
+        }
+        if (_migrate_tablet_to_medium(tablet, storage_medium)) {
+            num_migrated++;
+            migrated_bytes += tablet->tablet_footprint();
+        }
+        return true;
+    };
+    for (auto& tablet : demotions) {
+        if (!migrate(tablet, TStorageMedium::HDD)) {
+            break;
+        }
+    }
+    for (auto& tablet : promotions) {
+        if (!migrate(tablet, TStorageMedium::SSD)) {
+            break;
+        }
+    }
+    if (num_migrated > 0) {
+        LOG(INFO) << "tablet auto tiering migrated " << num_migrated << " tablets of "
+                  << migrated_bytes << " bytes, hot tablets: " << hot_bytes
+                  << " bytes, ssd budget: " << ssd_budget << " bytes";
+    }
+}
+
+int64_t StorageEngine::_plan_tablet_tiering(std::vector<TabletHeat>* tablets, int64_t ssd_budget,
+                                            std::vector<size_t>* promotions,
+                                            std::vector<size_t>* demotions) {
+    std::stable_sort(tablets->begin(), tablets->end(),
+                     [](const TabletHeat& a, const TabletHeat& b) { return a.heat > b.heat; });
+
+    // the hottest tablets which fit in the budget are kept on SSD, in the order of heat
+    int64_t hot_bytes = 0;
+    for (size_t i = 0; i < tablets->size(); ++i) {
+        const auto& item = (*tablets)[i];
+        if (item.heat > 0 && hot_bytes + item.size <= ssd_budget) {
+            hot_bytes += item.size;
+            if (!item.on_ssd) {
+                promotions->push_back(i);
+            }
+        } else if (item.on_ssd) {
+            demotions->push_back(i);
+        }
+    }
+    // demote the coldest tablets first to make room for the promoted ones
+    std::reverse(demotions->begin(), demotions->end());
+    return hot_bytes;
+}
+
+bool StorageEngine::_migrate_tablet_to_medium(const TabletSharedPtr& tablet,
+                                              TStorageMedium::type storage_medium) {
+    int64_t tablet_size = tablet->tablet_footprint();
+    for (auto store : get_stores_for_create_tablet(storage_medium)) {
+        if (store->storage_medium() != storage_medium || store->reach_capacity_limit(tablet_size)) {
+            continue;
+        }
+        EngineStorageMigrationTask task(tablet, store);
+        Status st = execute_task(&task);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to migrate tablet " << tablet->tablet_id() << " to "
+                         << store->path() << ": " << st;
+            return false;
+        }
+        VLOG_NOTICE << "migrated tablet " << tablet->tablet_id() << " to " << store->path();
+        return true;
+    }
+    return false;
+}
+
 void StorageEngine::_garbage_sweeper_thread_callback() {
 #ifdef GOOGLE_PROFILER
     ProfilerRegisterThread();
@@ -421,9 +592,21 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
     std::vector<TabletSharedPtr> tablets_compaction;
     uint32_t max_compaction_score = 0;
 
+    bool is_cost_based = false;
+    {
+        std::lock_guard<std::mutex> lock(*config::get_mutable_string_config_lock());
+        is_cost_based = config::compaction_tablet_pick_policy == "cost_based";
+    }
+
     std::random_device rd;
     std::mt19937 g(rd());
     std::shuffle(data_dirs.begin(), data_dirs.end(), g);
+    if (is_cost_based) {
+        // submit the tasks of the idle disks first, the ties are kept in the shuffled order
+        std::stable_sort(data_dirs.begin(), data_dirs.end(), [](DataDir* lhs, DataDir* rhs) {
+            return lhs->io_util_percent() < rhs->io_util_percent();
+        });
+    }
 
     // Copy _tablet_submitted_xxx_compaction map so that we don't need to hold _tablet_submitted_compaction_mutex
     // when travesing the data dir
@@ -444,6 +627,11 @@ std::vector<TabletSharedPtr> StorageEngine::_generate_compaction_tasks(
         int count = copied_cumu_map[data_dir].size() + copied_base_map[data_dir].size();
         int thread_per_disk = data_dir->is_ssd_disk() ? config::compaction_task_num_per_fast_disk
                                                       : config::compaction_task_num_per_disk;
+        if (is_cost_based &&
+            data_dir->io_util_percent() >= config::compaction_cost_based_max_disk_io_util_percent) {
+            // leave the io bandwidth of the busy disk to the queries
+            thread_per_disk = 1;
+        }
         if (count >= thread_per_disk) {
             // Return if no available slot
             need_pick_tablet = false;
@@ -16,35 +16,55 @@
 // under the License.
 
 #include "olap/page_cache.h"
+
+#include "common/config.h"
 #include "runtime/thread_context.h"
 
 namespace doris {
 
+static Cache* new_data_page_cache(const std::string& name, size_t capacity) {
+    return new_cache_by_policy(name, capacity, LRUCacheType::SIZE, config::data_page_cache_policy,
+                               config::data_page_cache_slru_protected_percentage);
+}
+
 StoragePageCache* StoragePageCache::_s_instance = nullptr;
 
-void StoragePageCache::create_global_cache(size_t capacity, int32_t index_cache_percentage) {
+void StoragePageCache::create_global_cache(size_t capacity, int32_t index_cache_percentage,
+                                           int32_t decoded_cache_percentage) {
     DCHECK(_s_instance == nullptr);
-    static StoragePageCache instance(capacity, index_cache_percentage);
+    static StoragePageCache instance(capacity, index_cache_percentage, decoded_cache_percentage);
     _s_instance = &instance;
 }
 
-StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percentage)
+StoragePageCache::StoragePageCache(size_t capacity, int32_t index_cache_percentage,
+                                   int32_t decoded_cache_percentage)
         : _index_cache_percentage(index_cache_percentage),
           _mem_tracker(MemTracker::create_tracker(capacity, "StoragePageCache", nullptr,
                                                   MemTrackerLevel::OVERVIEW)) {
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    CHECK(decoded_cache_percentage >= 0 && decoded_cache_percentage < 100)
+            << "invalid decoded page cache percentage";
+    size_t data_capacity = 0;
     if (index_cache_percentage == 0) {
-        _data_page_cache = std::unique_ptr<Cache>(new_lru_cache("DataPageCache", capacity));
+        data_capacity = capacity;
     } else if (index_cache_percentage == 100) {
         _index_page_cache = std::unique_ptr<Cache>(new_lru_cache("IndexPageCache", capacity));
     } else if (index_cache_percentage > 0 && index_cache_percentage < 100) {
-        _data_page_cache = std::unique_ptr<Cache>(
-                new_lru_cache("DataPageCache", capacity * (100 - index_cache_percentage) / 100));
+        data_capacity = capacity * (100 - index_cache_percentage) / 100;
         _index_page_cache = std::unique_ptr<Cache>(
                 new_lru_cache("IndexPageCache", capacity * index_cache_percentage / 100));
     } else {
         CHECK(false) << "invalid index page cache percentage";
     }
+    if (index_cache_percentage < 100) {
+        size_t decoded_capacity = data_capacity * decoded_cache_percentage / 100;
+        _data_page_cache = std::unique_ptr<Cache>(
+                new_data_page_cache("DataPageCache", data_capacity - decoded_capacity));
+        if (decoded_capacity > 0) {
+            _decoded_page_cache =
+                    std::unique_ptr<Cache>(new_lru_cache("DecodedPageCache", decoded_capacity));
+        }
+    }
 }
 
 bool StoragePageCache::lookup(const CacheKey& key, PageCacheHandle* handle,
@@ -72,4 +92,22 @@ void StoragePageCache::insert(const CacheKey& key, const Slice& data, PageCacheH
     *handle = PageCacheHandle(cache, lru_handle);
 }
 
+bool StoragePageCache::lookup_decoded(const CacheKey& key, PageCacheHandle* handle) {
+    auto lru_handle = _decoded_page_cache->lookup(key.encode());
+    if (lru_handle == nullptr) {
+        return false;
+    }
+    *handle = PageCacheHandle(_decoded_page_cache.get(), lru_handle);
+    return true;
+}
+
+void StoragePageCache::insert_decoded(const CacheKey& key, const Slice& data,
+                                      PageCacheHandle* handle) {
+    auto deleter = [](const doris::CacheKey& key, void* value) { delete[](uint8_t*) value; };
+
+    auto lru_handle = _decoded_page_cache->insert(key.encode(), data.data, data.size, deleter,
+                                                  CachePriority::NORMAL);
+    *handle = PageCacheHandle(_decoded_page_cache.get(), lru_handle);
+}
+
 } // namespace doris
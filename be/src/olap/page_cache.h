@@ -54,14 +54,17 @@ public:
         }
     };
 
-    // Create global instance of this class
-    static void create_global_cache(size_t capacity, int32_t index_cache_percentage);
+    // Create global instance of this class, `decoded_cache_percentage` of the capacity of the
+    // data page cache is used by the decoded page cache.
+    static void create_global_cache(size_t capacity, int32_t index_cache_percentage,
+                                    int32_t decoded_cache_percentage = 0);
 
     // Return global instance.
     // Client should call create_global_cache before.
     static StoragePageCache* instance() { return _s_instance; }
 
-    StoragePageCache(size_t capacity, int32_t index_cache_percentage);
+    StoragePageCache(size_t capacity, int32_t index_cache_percentage,
+                     int32_t decoded_cache_percentage = 0);
 
     // Lookup the given page in the cache.
     //
@@ -88,6 +91,14 @@ public:
         return _get_page_cache(page_type) != nullptr;
     }
 
+    // The decoded page cache keeps the values of the data pages after decoding, e.g. the
+    // unshuffled values of the bitshuffle pages, with the same keys as the page cache.
+    bool lookup_decoded(const CacheKey& key, PageCacheHandle* handle);
+
+    void insert_decoded(const CacheKey& key, const Slice& data, PageCacheHandle* handle);
+
+    bool is_decoded_cache_available() const { return _decoded_page_cache != nullptr; }
+
 private:
     StoragePageCache();
     static StoragePageCache* _s_instance;
@@ -95,6 +106,7 @@ private:
     int32_t _index_cache_percentage = 0;
     std::unique_ptr<Cache> _data_page_cache = nullptr;
     std::unique_ptr<Cache> _index_page_cache = nullptr;
+    std::unique_ptr<Cache> _decoded_page_cache = nullptr;
 
     std::shared_ptr<MemTracker> _mem_tracker = nullptr;
 
@@ -23,6 +23,7 @@
 #include <charconv>
 #include <unordered_set>
 
+#include "olap/bitmap_filter_predicate.h"
 #include "olap/bloom_filter_predicate.h"
 #include "olap/collect_iterator.h"
 #include "olap/comparison_predicate.h"
@@ -159,23 +160,25 @@ Status TabletReader::_capture_rs_readers(const ReaderParams& read_params,
     for (int i = 0; i < _keys_param.start_keys.size(); ++i) {
         // lower bound
         RowCursor& start_key = _keys_param.start_keys[i];
-        RowCursor& end_key = _keys_param.end_keys[i];
-
-        if (!is_lower_key_included) {
-            if (compare_row_key(start_key, end_key) >= 0) {
-                VLOG_NOTICE << "return EOF when lower key not include"
-                            << ", start_key=" << start_key.to_string()
-                            << ", end_key=" << end_key.to_string();
-                eof = true;
-                break;
-            }
-        } else {
-            if (compare_row_key(start_key, end_key) > 0) {
-                VLOG_NOTICE << "return EOF when lower key include="
-                            << ", start_key=" << start_key.to_string()
-                            << ", end_key=" << end_key.to_string();
-                eof = true;
-                break;
+        // no upper bound if there is no end key of the range
+        if (i < _keys_param.end_keys.size()) {
+            RowCursor& end_key = _keys_param.end_keys[i];
+            if (!is_lower_key_included) {
+                if (compare_row_key(start_key, end_key) >= 0) {
+                    VLOG_NOTICE << "return EOF when lower key not include"
+                                << ", start_key=" << start_key.to_string()
+                                << ", end_key=" << end_key.to_string();
+                    eof = true;
+                    break;
+                }
+            } else {
+                if (compare_row_key(start_key, end_key) > 0) {
+                    VLOG_NOTICE << "return EOF when lower key include="
+                                << ", start_key=" << start_key.to_string()
+                                << ", end_key=" << end_key.to_string();
+                    eof = true;
+                    break;
+                }
             }
         }
 
@@ -189,7 +192,8 @@ Status TabletReader::_capture_rs_readers(const ReaderParams& read_params,
 
     bool need_ordered_result = true;
     if (read_params.reader_type == READER_QUERY) {
-        if (_tablet->tablet_schema().keys_type() == DUP_KEYS) {
+        if (_tablet->tablet_schema().keys_type() == DUP_KEYS ||
+            _tablet->enable_unique_key_merge_on_write()) {
             // duplicated keys are allowed, no need to merge sort keys in rowset
             need_ordered_result = false;
         }
@@ -211,16 +215,33 @@ Status TabletReader::_capture_rs_readers(const ReaderParams& read_params,
     _reader_context.all_conditions = &_all_conditions;
     _reader_context.predicates = &_col_predicates;
     _reader_context.value_predicates = &_value_col_predicates;
+    _reader_context.like_predicates = &_like_predicates;
+    _reader_context.topn_predicate = _topn_predicate;
+    _reader_context.late_runtime_filters = &_late_runtime_filters;
+    _reader_context.record_rowids = read_params.record_rowids;
     _reader_context.lower_bound_keys = &_keys_param.start_keys;
     _reader_context.is_lower_keys_included = &_is_lower_keys_included;
     _reader_context.upper_bound_keys = &_keys_param.end_keys;
     _reader_context.is_upper_keys_included = &_is_upper_keys_included;
     _reader_context.delete_handler = &_delete_handler;
+    // the delete bitmap of non merge-on-write tablets holds the rows deleted by the delete
+    // predicates, see Tablet::calc_delete_predicate_bitmaps()
+    if (_tablet->enable_unique_key_merge_on_write() ||
+        !_tablet->tablet_meta()->delete_bitmap()->empty()) {
+        // hold the delete bitmap, the tablet meta may be replaced during reading
+        _delete_bitmap = _tablet->tablet_meta()->delete_bitmap();
+        _reader_context.delete_bitmap = _delete_bitmap.get();
+        _reader_context.version = read_params.version;
+    }
     _reader_context.stats = &_stats;
     _reader_context.runtime_state = read_params.runtime_state;
     _reader_context.use_page_cache = read_params.use_page_cache;
+    _reader_context.bypass_page_cache_admission = read_params.bypass_page_cache_admission;
+    _reader_context.page_prefetch_budget = read_params.page_prefetch_budget;
     _reader_context.sequence_id_idx = _sequence_col_idx;
     _reader_context.batch_size = _batch_size;
+    _reader_context.block_row_limit = &_block_row_limit;
+    _reader_context.push_down_agg_type_opt = read_params.push_down_agg_type_opt;
 
     *valid_rs_readers = *rs_readers;
 
@@ -235,6 +256,7 @@ Status TabletReader::_init_params(const ReaderParams& read_params) {
     _need_agg_finalize = read_params.need_agg_finalize;
     _reader_type = read_params.reader_type;
     _tablet = read_params.tablet;
+    _late_runtime_filters = read_params.late_runtime_filters;
 
     _init_conditions_param(read_params);
     _init_load_bf_columns(read_params);
@@ -444,9 +466,13 @@ void TabletReader::_init_conditions_param(const ReaderParams& read_params) {
     for (const auto& condition : read_params.conditions) {
         ColumnPredicate* predicate = _parse_to_predicate(condition);
         if (predicate != nullptr) {
+            // the value columns of merge-on-write unique key tablet are not replaced at
+            // read time, so the predicates on them can be pushed down like key columns
             if (_tablet->tablet_schema()
-                        .column(_tablet->field_index(condition.column_name))
-                        .aggregation() != FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE) {
+                                .column(_tablet->field_index(condition.column_name))
+                                .aggregation() !=
+                        FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE &&
+                !_tablet->enable_unique_key_merge_on_write()) {
                 _value_col_predicates.push_back(predicate);
             } else {
                 _col_predicates.push_back(predicate);
@@ -462,6 +488,35 @@ void TabletReader::_init_conditions_param(const ReaderParams& read_params) {
     for (const auto& filter : read_params.bloom_filters) {
         _col_predicates.emplace_back(_parse_to_predicate(filter));
     }
+
+    for (const auto& filter : read_params.bitmap_filters) {
+        ColumnPredicate* predicate = _parse_to_predicate(filter);
+        if (predicate != nullptr) {
+            _col_predicates.push_back(predicate);
+        }
+    }
+
+    for (const auto& like_predicate : read_params.like_predicates) {
+        int32_t index = _tablet->field_index(like_predicate.first);
+        if (index < 0) {
+            continue;
+        }
+        _like_predicates.emplace_back(index, like_predicate.second);
+    }
+
+    for (const auto& condition : read_params.match_conditions) {
+        ColumnPredicate* predicate = _parse_to_predicate(condition);
+        if (predicate != nullptr) {
+            _col_predicates.push_back(predicate);
+        }
+    }
+
+    if (read_params.topn_predicate != nullptr) {
+        _topn_predicate = _parse_to_predicate(read_params.topn_column, read_params.topn_predicate);
+        if (_topn_predicate != nullptr) {
+            _col_predicates.push_back(_topn_predicate);
+        }
+    }
 }
 
 #define COMPARISON_PREDICATE_CONDITION_VALUE(NAME, PREDICATE)                                      \
@@ -580,6 +635,63 @@ ColumnPredicate* TabletReader::_parse_to_predicate(
                                                                       column.type());
 }
 
+ColumnPredicate* TabletReader::_parse_to_predicate(
+        const std::pair<std::string, std::shared_ptr<BitmapFilterFunc>>& bitmap_filter) {
+    int32_t index = _tablet->field_index(bitmap_filter.first);
+    if (index < 0) {
+        return nullptr;
+    }
+    const TabletColumn& column = _tablet->tablet_schema().column(index);
+    return BitmapFilterColumnPredicateFactory::create_column_predicate(index, bitmap_filter.second,
+                                                                       column.type());
+}
+
+TopNColumnPredicate* TabletReader::_parse_to_predicate(
+        const std::string& column_name,
+        const std::shared_ptr<TopNRuntimePredicate>& runtime_predicate) const {
+    int32_t index = _tablet->field_index(column_name);
+    if (index < 0) {
+        return nullptr;
+    }
+    const TabletColumn& column = _tablet->tablet_schema().column(index);
+    // the rows can't be filtered by the value columns before they are aggregated
+    if (column.aggregation() != FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE &&
+        !_tablet->enable_unique_key_merge_on_write()) {
+        return nullptr;
+    }
+    bool is_asc = runtime_predicate->is_asc();
+    return new TopNColumnPredicate(
+            index, column_name, runtime_predicate,
+            [this, &column, index, is_asc](const std::string& value) {
+                return is_asc ? _new_le_pred(column, index, value, false)
+                              : _new_ge_pred(column, index, value, false);
+            });
+}
+
+ColumnPredicate* TabletReader::_parse_to_predicate(const MatchCondition& condition) const {
+    int32_t index = _tablet->field_index(condition.column_name);
+    if (index < 0) {
+        return nullptr;
+    }
+    const TabletColumn& column = _tablet->tablet_schema().column(index);
+    if ((column.type() != OLAP_FIELD_TYPE_CHAR && column.type() != OLAP_FIELD_TYPE_VARCHAR &&
+         column.type() != OLAP_FIELD_TYPE_STRING) ||
+        column.aggregation() != FieldAggregationMethod::OLAP_FIELD_AGGREGATION_NONE) {
+        LOG(WARNING) << "ignore match condition on column " << condition.column_name;
+        return nullptr;
+    }
+    // split the value by the parser of inverted index, to get the same result as the index
+    const std::string& parser_name = column.has_inverted_index()
+                                             ? column.inverted_index_parser()
+                                             : segment_v2::INVERTED_INDEX_PARSER_ENGLISH;
+    segment_v2::InvertedIndexParserType parser_type;
+    if (!segment_v2::parse_inverted_index_parser(parser_name, &parser_type).ok()) {
+        return nullptr;
+    }
+    return new MatchPredicate(index, condition.match_type, condition.query, parser_name,
+                              parser_type);
+}
+
 ColumnPredicate* TabletReader::_parse_to_predicate(const TCondition& condition,
                                                    bool opposite) const {
     // TODO: not equal and not in predicate is not pushed down
@@ -20,6 +20,7 @@
 #include <gen_cpp/PaloInternalService_types.h>
 #include <thrift/protocol/TDebugProtocol.h>
 
+#include <limits>
 #include <list>
 #include <memory>
 #include <queue>
@@ -29,15 +30,19 @@
 #include <utility>
 #include <vector>
 
+#include "exprs/bitmapfilter_predicate.h"
 #include "exprs/bloomfilter_predicate.h"
 #include "olap/column_predicate.h"
 #include "olap/collect_iterator.h"
 #include "olap/delete_handler.h"
+#include "olap/late_runtime_filter.h"
+#include "olap/match_predicate.h"
 #include "olap/olap_cond.h"
 #include "olap/olap_define.h"
 #include "olap/row_cursor.h"
 #include "olap/rowset/rowset_reader.h"
 #include "olap/tablet.h"
+#include "olap/topn_predicate.h"
 #include "util/runtime_profile.h"
 
 namespace doris {
@@ -78,15 +83,35 @@ public:
         // 2. when read column index page
         //     if config::disable_storage_page_cache is false, we use page cache
         bool use_page_cache = false;
+        // read the data pages through page cache but don't insert the missed pages,
+        // used by big scans to keep the cached pages of other queries
+        bool bypass_page_cache_admission = false;
+        // read ahead the data pages within this budget, no read-ahead if it's nullptr
+        segment_v2::PagePrefetchBudget* page_prefetch_budget = nullptr;
         Version version = Version(-1, 0);
 
         std::vector<OlapTuple> start_key;
+        // the key ranges from the start keys without an end key have no upper bound
         std::vector<OlapTuple> end_key;
         bool start_key_include = false;
         bool end_key_include = false;
 
         std::vector<TCondition> conditions;
         std::vector<std::pair<string, std::shared_ptr<IBloomFilterFuncBase>>> bloom_filters;
+        std::vector<std::pair<std::string, std::shared_ptr<BitmapFilterFunc>>> bitmap_filters;
+        // (column name, LIKE pattern), only used to filter pages by ngram bloom filter index
+        std::vector<std::pair<std::string, std::string>> like_predicates;
+        // MATCH conditions on string columns without aggregation, conditions on other
+        // columns are ignored
+        std::vector<MatchCondition> match_conditions;
+        // the boundary of a Top-N sort on the column `topn_column`, published while reading
+        std::string topn_column;
+        std::shared_ptr<TopNRuntimePredicate> topn_predicate;
+        // the runtime filters which were not ready when the scan started, published while
+        // reading, only on the columns whose rows can be filtered before being merged
+        std::vector<std::shared_ptr<LateRuntimeFilter>> late_runtime_filters;
+        // remember the locations of the rows of each block, see current_block_row_locations()
+        bool record_rowids = false;
 
         // The ColumnData will be set when using Merger, eg Cumulative, BE.
         std::vector<RowsetReaderSharedPtr> rs_readers;
@@ -94,6 +119,12 @@ public:
         RuntimeProfile* profile = nullptr;
         RuntimeState* runtime_state = nullptr;
 
+        // only for vertical compaction, whether `return_columns` is the key column group
+        bool is_key_column_group = false;
+
+        // the aggregate without grouping answered from the segment metadata
+        TPushAggOp::type push_down_agg_type_opt = TPushAggOp::NONE;
+
         // use only in vec exec engine
         std::vector<uint32_t>* origin_return_columns = nullptr;
         std::unordered_set<uint32_t>* tablet_columns_convert_to_null_set = nullptr;
@@ -127,15 +158,25 @@ public:
         return Status::OLAPInternalError(OLAP_ERR_READER_INITIALIZE_ERROR);
     }
 
+    // The locations of the rows of the last block read by next_block_with_aggregation(), only
+    // supported if ReaderParams::record_rowids is set and the rows are not merged.
+    virtual Status current_block_row_locations(std::vector<RowLocation>* locations) {
+        return Status::NotSupported("to be implemented");
+    }
+
     uint64_t merged_rows() const { return _merged_rows; }
 
     uint64_t filtered_rows() const {
-        return _stats.rows_del_filtered + _stats.rows_conditions_filtered +
-               _stats.rows_vec_del_cond_filtered;
+        return _stats.rows_del_filtered + _stats.rows_del_by_bitmap +
+               _stats.rows_conditions_filtered + _stats.rows_vec_del_cond_filtered;
     }
 
     void set_batch_size(int batch_size) { _batch_size = batch_size; }
 
+    // Bound the rows of the blocks read from the segments by the next calls, to get smaller
+    // blocks of wide rows, it doesn't raise the batch size.
+    void set_block_row_limit(int rows) { _block_row_limit = rows; }
+
     const OlapReaderStatistics& stats() const { return _stats; }
     OlapReaderStatistics* mutable_stats() { return &_stats; }
 
@@ -170,9 +211,18 @@ protected:
 
     ColumnPredicate* _parse_to_predicate(const TCondition& condition, bool opposite = false) const;
 
+    ColumnPredicate* _parse_to_predicate(const MatchCondition& condition) const;
+
     ColumnPredicate* _parse_to_predicate(
             const std::pair<std::string, std::shared_ptr<IBloomFilterFuncBase>>& bloom_filter);
 
+    ColumnPredicate* _parse_to_predicate(
+            const std::pair<std::string, std::shared_ptr<BitmapFilterFunc>>& bitmap_filter);
+
+    TopNColumnPredicate* _parse_to_predicate(
+            const std::string& column_name,
+            const std::shared_ptr<TopNRuntimePredicate>& runtime_predicate) const;
+
     Status _init_delete_condition(const ReaderParams& read_params);
 
     Status _init_return_columns(const ReaderParams& read_params);
@@ -195,6 +245,7 @@ protected:
 
     TabletSharedPtr _tablet;
     RowsetReaderContext _reader_context;
+    int _block_row_limit = std::numeric_limits<int>::max();
     KeysParam _keys_param;
     std::vector<bool> _is_lower_keys_included;
     std::vector<bool> _is_upper_keys_included;
@@ -205,7 +256,13 @@ protected:
     Conditions _all_conditions;
     std::vector<ColumnPredicate*> _col_predicates;
     std::vector<ColumnPredicate*> _value_col_predicates;
+    std::vector<std::pair<uint32_t, std::string>> _like_predicates;
+    // owned by _col_predicates
+    TopNColumnPredicate* _topn_predicate = nullptr;
+    std::vector<std::shared_ptr<LateRuntimeFilter>> _late_runtime_filters;
     DeleteHandler _delete_handler;
+    // only set in merge-on-write unique key tablets
+    std::shared_ptr<DeleteBitmap> _delete_bitmap;
 
     bool _aggregation = false;
     // for agg query, we don't need to finalize when scan agg object data
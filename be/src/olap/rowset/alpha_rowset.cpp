@@ -89,7 +89,8 @@ void AlphaRowset::make_visible_extra(Version version) {
     }
 }
 
-Status AlphaRowset::link_files_to(const FilePathDesc& dir_desc, RowsetId new_rowset_id) {
+Status AlphaRowset::link_files_to(const FilePathDesc& dir_desc, RowsetId new_rowset_id,
+                                  size_t new_rowset_start_seg_id) {
     for (auto& segment_group : _segment_groups) {
         auto status = segment_group->link_segments_to_path(dir_desc.filepath, new_rowset_id);
         if (!status.ok()) {
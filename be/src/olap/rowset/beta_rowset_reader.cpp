@@ -16,6 +16,7 @@
 // under the License.
 
 #include "beta_rowset_reader.h"
+#include <algorithm>
 #include <utility>
 #include "olap/delete_handler.h"
 #include "olap/generic_iterators.h"
@@ -26,6 +27,7 @@
 #include "olap/row_cursor.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/schema.h"
+#include "olap/tablet_meta.h"
 
 #include "vec/core/block.h"
 
@@ -36,7 +38,8 @@ BetaRowsetReader::BetaRowsetReader(BetaRowsetSharedPtr rowset)
     _rowset->acquire();
 }
 
-Status BetaRowsetReader::init(RowsetReaderContext* read_context) {
+Status BetaRowsetReader::_create_segment_iterators(RowsetReaderContext* read_context,
+                                                   std::vector<RowwiseIterator*>* out_iters) {
     RETURN_NOT_OK(_rowset->load());
     _context = read_context;
     if (_context->stats != nullptr) {
@@ -50,20 +53,34 @@ Status BetaRowsetReader::init(RowsetReaderContext* read_context) {
                                        *(_context->return_columns));
 
     // convert RowsetReaderContext to StorageReadOptions
-    StorageReadOptions read_options;
+    StorageReadOptions& read_options = _read_options;
     read_options.stats = _stats;
+    read_options.runtime_state = read_context->runtime_state;
     read_options.conditions = read_context->conditions;
     if (read_context->lower_bound_keys != nullptr) {
         for (int i = 0; i < read_context->lower_bound_keys->size(); ++i) {
+            // the ranges without an upper bound key are not bounded above
+            const RowCursor* upper_key = i < read_context->upper_bound_keys->size()
+                                                 ? &read_context->upper_bound_keys->at(i)
+                                                 : nullptr;
             read_options.key_ranges.emplace_back(&read_context->lower_bound_keys->at(i),
                                                  read_context->is_lower_keys_included->at(i),
-                                                 &read_context->upper_bound_keys->at(i),
+                                                 upper_key,
                                                  read_context->is_upper_keys_included->at(i));
         }
     }
     if (read_context->delete_handler != nullptr) {
+        // the delete predicates of the versions <= the latest marks of the rowset in the delete
+        // bitmap are already evaluated, their deleted rows are removed by the delete bitmap
+        int64_t delete_version = _rowset->end_version();
+        if (read_context->delete_bitmap != nullptr &&
+            !read_context->tablet_schema->enable_unique_key_merge_on_write()) {
+            int64_t bitmap_version = read_context->delete_bitmap->max_version(
+                    {_rowset->rowset_id(), 0, read_context->version.second});
+            delete_version = std::max(delete_version, bitmap_version);
+        }
         read_context->delete_handler->get_delete_conditions_after_version(
-                _rowset->end_version(), &read_options.delete_conditions,
+                delete_version, &read_options.delete_conditions,
                 read_options.delete_condition_predicates.get());
     }
     if (read_context->predicates != nullptr) {
@@ -84,38 +101,112 @@ Status BetaRowsetReader::init(RowsetReaderContext* read_context) {
             read_options.conditions = read_context->all_conditions;
         }
     }
+    if (read_context->like_predicates != nullptr) {
+        read_options.like_predicates = *read_context->like_predicates;
+    }
+    read_options.topn_predicate = read_context->topn_predicate;
+    read_options.late_runtime_filters = read_context->late_runtime_filters;
     read_options.use_page_cache = read_context->use_page_cache;
+    read_options.bypass_page_cache_admission = read_context->bypass_page_cache_admission;
+    read_options.page_prefetch_budget = read_context->page_prefetch_budget;
+    read_options.record_rowids = read_context->record_rowids;
+    read_options.block_row_limit = read_context->block_row_limit;
 
     // load segments
     RETURN_NOT_OK(SegmentLoader::instance()->load_segments(
             _rowset, &_segment_cache_handle,
             read_context->reader_type == ReaderType::READER_QUERY));
 
+    auto& all_segments = _segment_cache_handle.get_segments();
+    int64_t segment_end = _segment_end < 0 ? all_segments.size()
+                                           : std::min<int64_t>(_segment_end, all_segments.size());
+    std::vector<segment_v2::SegmentSharedPtr> segments;
+    for (int64_t i = _segment_begin; i < segment_end; ++i) {
+        segments.push_back(all_segments[i]);
+    }
+
+    if (read_context->delete_bitmap != nullptr) {
+        for (auto& seg_ptr : segments) {
+            auto segment_delete_bitmap = std::make_shared<roaring::Roaring>();
+            read_context->delete_bitmap->get_agg(
+                    {_rowset->rowset_id(), seg_ptr->id(), read_context->version.second},
+                    segment_delete_bitmap.get());
+            if (!segment_delete_bitmap->isEmpty()) {
+                read_options.delete_bitmap.emplace(seg_ptr->id(), segment_delete_bitmap);
+            }
+        }
+    }
+
+    // the aggregate pushed down is answered by the segment metadata if no rows are filtered
+    bool push_down_agg = config::enable_storage_vectorization && read_context->is_vec &&
+                         read_context->push_down_agg_type_opt != TPushAggOp::NONE &&
+                         _rowset->keys_type() == DUP_KEYS && read_options.key_ranges.empty() &&
+                         (read_options.conditions == nullptr ||
+                          read_options.conditions->empty()) &&
+                         read_options.delete_conditions.empty() &&
+                         read_options.column_predicates.empty() &&
+                         read_options.like_predicates.empty() && !read_context->record_rowids;
+
     // create iterator for each segment
     std::vector<std::unique_ptr<RowwiseIterator>> seg_iterators;
-    for (auto& seg_ptr : _segment_cache_handle.get_segments()) {
+    for (auto& seg_ptr : segments) {
         std::unique_ptr<RowwiseIterator> iter;
-        auto s = seg_ptr->new_iterator(*_schema, read_options, &iter);
-        if (!s.ok()) {
-            LOG(WARNING) << "failed to create iterator[" << seg_ptr->id() << "]: " << s.to_string();
-            return Status::OLAPInternalError(OLAP_ERR_ROWSET_READER_INIT);
+        if (push_down_agg && read_options.delete_bitmap.count(seg_ptr->id()) == 0) {
+            iter.reset(vectorized::new_statistics_iterator(seg_ptr, *_schema,
+                                                           read_context->push_down_agg_type_opt));
+        }
+        if (iter == nullptr) {
+            auto s = seg_ptr->new_iterator(*_schema, read_options, &iter);
+            if (!s.ok()) {
+                LOG(WARNING) << "failed to create iterator[" << seg_ptr->id()
+                             << "]: " << s.to_string();
+                return Status::OLAPInternalError(OLAP_ERR_ROWSET_READER_INIT);
+            }
         }
         seg_iterators.push_back(std::move(iter));
     }
 
-    std::vector<RowwiseIterator*> iterators;
     for (auto& owned_it : seg_iterators) {
-        // transfer ownership of segment iterator to `_iterator`
-        iterators.push_back(owned_it.release());
+        // transfer ownership of segment iterator to the caller
+        out_iters->push_back(owned_it.release());
+    }
+    return Status::OK();
+}
+
+Status BetaRowsetReader::get_segment_iterators(RowsetReaderContext* read_context,
+                                               std::vector<RowwiseIterator*>* out_iters) {
+    std::vector<RowwiseIterator*> iterators;
+    auto s = _create_segment_iterators(read_context, &iterators);
+    for (auto iter : iterators) {
+        if (s.ok()) {
+            s = iter->init(_read_options);
+        }
+        if (s.ok()) {
+            out_iters->push_back(iter);
+        } else {
+            delete iter;
+        }
     }
+    if (!s.ok()) {
+        LOG(WARNING) << "failed to init segment iterators: " << s.to_string();
+        return Status::OLAPInternalError(OLAP_ERR_ROWSET_READER_INIT);
+    }
+    return Status::OK();
+}
+
+Status BetaRowsetReader::init(RowsetReaderContext* read_context) {
+    std::vector<RowwiseIterator*> iterators;
+    RETURN_NOT_OK(_create_segment_iterators(read_context, &iterators));
 
     // merge or union segment iterator
     RowwiseIterator* final_iterator;
     if (config::enable_storage_vectorization && read_context->is_vec) {
         if (read_context->need_ordered_result &&
             _rowset->rowset_meta()->is_segments_overlapping()) {
-            final_iterator =
-                    vectorized::new_merge_iterator(iterators, read_context->sequence_id_idx);
+            const auto* tablet_schema = read_context->tablet_schema;
+            final_iterator = vectorized::new_merge_iterator(
+                    iterators, read_context->sequence_id_idx, tablet_schema->sort_type(),
+                    tablet_schema->sort_col_num());
         } else {
             final_iterator = vectorized::new_union_iterator(iterators);
         }
@@ -128,7 +219,7 @@ Status BetaRowsetReader::init(RowsetReaderContext* read_context) {
         }
     }
 
-    auto s = final_iterator->init(read_options);
+    auto s = final_iterator->init(_read_options);
     if (!s.ok()) {
         LOG(WARNING) << "failed to init iterator: " << s.to_string();
         return Status::OLAPInternalError(OLAP_ERR_ROWSET_READER_INIT);
@@ -236,4 +327,12 @@ Status BetaRowsetReader::next_block(vectorized::Block* block) {
     return Status::OK();
 }
 
+Status BetaRowsetReader::current_block_row_locations(std::vector<RowLocation>* locations) {
+    RETURN_NOT_OK(_iterator->current_block_row_locations(locations));
+    for (auto& location : *locations) {
+        location.rowset_id = _rowset->rowset_id();
+    }
+    return Status::OK();
+}
+
 } // namespace doris
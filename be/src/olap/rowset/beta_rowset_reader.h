@@ -36,6 +36,19 @@ public:
 
     Status init(RowsetReaderContext* read_context) override;
 
+    // Create and init an iterator for each segment of the rowset, instead of the merged
+    // iterator of `init`. Used by vertical compaction, which merges the segments of all the
+    // input rowsets. The iterators are owned by the caller, and must not outlive this reader.
+    Status get_segment_iterators(RowsetReaderContext* read_context,
+                                 std::vector<RowwiseIterator*>* out_iters);
+
+    // Read only the segments [begin, end) of the rowset, so that the segments of a rowset
+    // can be read by several readers in parallel. Must be called before init.
+    void set_segment_range(int64_t begin, int64_t end) {
+        _segment_begin = begin;
+        _segment_end = end;
+    }
+
     // It's ok, because we only get ref here, the block's owner is this reader.
     Status next_block(RowBlock** block) override;
     Status next_block(vectorized::Block* block) override;
@@ -53,7 +66,12 @@ public:
 
     RowsetTypePB type() const override { return RowsetTypePB::BETA_ROWSET; }
 
+    Status current_block_row_locations(std::vector<RowLocation>* locations) override;
+
 private:
+    Status _create_segment_iterators(RowsetReaderContext* read_context,
+                                     std::vector<RowwiseIterator*>* out_iters);
+
     std::unique_ptr<Schema> _schema;
     RowsetReaderContext* _context;
     BetaRowsetSharedPtr _rowset;
@@ -61,6 +79,8 @@ private:
     OlapReaderStatistics _owned_stats;
     OlapReaderStatistics* _stats;
 
+    StorageReadOptions _read_options;
+
     std::unique_ptr<RowwiseIterator> _iterator;
 
     std::unique_ptr<RowBlockV2> _input_block;
@@ -70,6 +90,10 @@ private:
     // make sure this handle is initialized and valid before
     // reading data.
     SegmentCacheHandle _segment_cache_handle;
+
+    // the range of the segments to read, all the segments by default
+    int64_t _segment_begin = 0;
+    int64_t _segment_end = -1;
 };
 
 } // namespace doris
@@ -18,6 +18,7 @@
 #include "olap/rowset/beta_rowset_writer.h"
 
 #include <ctime> // time
+#include <numeric>
 
 #include "common/config.h"
 #include "common/logging.h"
@@ -35,6 +36,7 @@
 #include "runtime/exec_env.h"
 #include "util/storage_backend.h"
 #include "util/storage_backend_mgr.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
@@ -47,6 +49,11 @@ BetaRowsetWriter::BetaRowsetWriter()
           _total_index_size(0) {}
 
 BetaRowsetWriter::~BetaRowsetWriter() {
+    if (_segment_write_token != nullptr) {
+        // the segments being written refer to the files and statistics of this writer
+        _segment_write_token->wait();
+        _pending_segment_writers.clear();
+    }
     // TODO(lingbin): Should wrapper exception logic, no need to know file ops directly.
     if (!_already_built) {       // abnormal exit, remove all files generated
         _segment_writer.reset(); // ensure all files are closed
@@ -94,6 +101,12 @@ Status BetaRowsetWriter::init(const RowsetWriterContext& rowset_writer_context)
     }
     _rowset_meta->set_tablet_uid(_context.tablet_uid);
 
+    auto storage_engine = StorageEngine::instance();
+    if (config::enable_parallel_segment_write && storage_engine != nullptr &&
+        storage_engine->segment_write_thread_pool() != nullptr) {
+        _segment_write_token = storage_engine->segment_write_thread_pool()->new_token(
+                ThreadPool::ExecutionMode::CONCURRENT);
+    }
     return Status::OK();
 }
 
@@ -101,8 +114,18 @@ Status BetaRowsetWriter::add_block(const vectorized::Block* block) {
     if (block->rows() == 0) {
         return Status::OK();
     }
-    if (UNLIKELY(_segment_writer == nullptr)) {
-        RETURN_NOT_OK(_create_segment_writer(&_segment_writer));
+    if (_segment_write_token != nullptr) {
+        return _add_block_parallel(block);
+    }
+    RETURN_NOT_OK(_append_block(block, &_segment_writer));
+    _num_rows_written += block->rows();
+    return Status::OK();
+}
+
+Status BetaRowsetWriter::_append_block(const vectorized::Block* block,
+                                       std::unique_ptr<segment_v2::SegmentWriter>* writer) {
+    if (UNLIKELY(*writer == nullptr)) {
+        RETURN_NOT_OK(_create_segment_writer(writer));
     }
     size_t block_size_in_bytes = block->bytes();
     size_t block_row_num = block->rows();
@@ -110,28 +133,109 @@ Status BetaRowsetWriter::add_block(const vectorized::Block* block) {
     size_t row_offset = 0;
 
     do {
-        auto max_row_add = _segment_writer->max_row_to_add(row_avg_size_in_bytes);
+        auto max_row_add = (*writer)->max_row_to_add(row_avg_size_in_bytes);
         if (UNLIKELY(max_row_add < 1)) {
             // no space for another signle row, need flush now
-            RETURN_NOT_OK(_flush_segment_writer(&_segment_writer));
-            RETURN_NOT_OK(_create_segment_writer(&_segment_writer));
-            max_row_add = _segment_writer->max_row_to_add(row_avg_size_in_bytes);
+            RETURN_NOT_OK(_flush_segment_writer(writer));
+            RETURN_NOT_OK(_create_segment_writer(writer));
+            max_row_add = (*writer)->max_row_to_add(row_avg_size_in_bytes);
             DCHECK(max_row_add > 0);
         }
 
         size_t input_row_num = std::min(block_row_num - row_offset, size_t(max_row_add));
-        auto s = _segment_writer->append_block(block, row_offset, input_row_num);
+        auto s = (*writer)->append_block(block, row_offset, input_row_num);
         if (UNLIKELY(!s.ok())) {
             LOG(WARNING) << "failed to append block: " << s.to_string();
             return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
         }
         row_offset += input_row_num;
     } while (row_offset < block_row_num);
+    return Status::OK();
+}
+
+size_t BetaRowsetWriter::_parallel_segment_rows(const vectorized::Block* block) const {
+    size_t row_avg_size_in_bytes = std::max((size_t)1, block->bytes() / block->rows());
+    int64_t max_rows = std::min<int64_t>(config::parallel_segment_write_rows_per_segment,
+                                         _context.max_rows_per_segment);
+    max_rows = std::min<int64_t>(max_rows, MAX_SEGMENT_SIZE / row_avg_size_in_bytes);
+    return std::max<int64_t>(max_rows, 1);
+}
+
+Status BetaRowsetWriter::_write_segment(segment_v2::SegmentWriter* writer,
+                                        const vectorized::Block* block, size_t row_pos,
+                                        size_t num_rows) {
+    auto s = writer->append_block(block, row_pos, num_rows);
+    if (UNLIKELY(!s.ok())) {
+        LOG(WARNING) << "failed to append block: " << s.to_string();
+        return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+    }
+    return _finalize_segment(writer);
+}
 
+Status BetaRowsetWriter::_add_block_parallel(const vectorized::Block* block) {
+    // check the segments finished so far to stop early on error
+    {
+        std::lock_guard<SpinLock> l(_lock);
+        RETURN_NOT_OK(_parallel_write_status);
+    }
+    size_t segment_rows = _parallel_segment_rows(block);
+    size_t block_row_num = block->rows();
+    size_t row_offset = 0;
+    while (row_offset < block_row_num) {
+        if (_pending_block == nullptr) {
+            _pending_block.reset(new vectorized::MutableBlock(block->clone_empty()));
+        }
+        size_t num_rows = std::min(block_row_num - row_offset,
+                                   segment_rows - std::min(segment_rows, _pending_block->rows()));
+        _pending_block->add_rows(block, row_offset, num_rows);
+        row_offset += num_rows;
+        if (_pending_block->rows() >= segment_rows) {
+            RETURN_NOT_OK(_submit_pending_block());
+        }
+    }
     _num_rows_written += block_row_num;
     return Status::OK();
 }
 
+Status BetaRowsetWriter::_submit_pending_block() {
+    if (_pending_block == nullptr || _pending_block->rows() == 0) {
+        return Status::OK();
+    }
+    if (_pending_segment_writers.size() >=
+        std::max<size_t>(1, config::parallel_segment_write_max_pending_segments)) {
+        RETURN_NOT_OK(_wait_pending_segments());
+    }
+    auto block = std::make_shared<vectorized::Block>(_pending_block->to_block());
+    _pending_block.reset();
+
+    // the segment id is allocated in order, so the keys are still ordered across segments
+    std::unique_ptr<segment_v2::SegmentWriter> writer;
+    RETURN_NOT_OK(_create_segment_writer(&writer));
+    segment_v2::SegmentWriter* writer_ptr = writer.get();
+    _pending_segment_writers.push_back(std::move(writer));
+    auto write_segment = [this, writer_ptr, block]() {
+        Status st = _write_segment(writer_ptr, block.get(), 0, block->rows());
+        if (!st.ok()) {
+            std::lock_guard<SpinLock> l(_lock);
+            if (_parallel_write_status.ok()) {
+                _parallel_write_status = st;
+            }
+        }
+    };
+    if (!_segment_write_token->submit_func(write_segment).ok()) {
+        // the thread pool is shutting down
+        write_segment();
+    }
+    return Status::OK();
+}
+
+Status BetaRowsetWriter::_wait_pending_segments() {
+    _segment_write_token->wait();
+    _pending_segment_writers.clear();
+    std::lock_guard<SpinLock> l(_lock);
+    return _parallel_write_status;
+}
+
 template <typename RowType>
 Status BetaRowsetWriter::_add_row(const RowType& row) {
     if (PREDICT_FALSE(_segment_writer == nullptr)) {
@@ -156,10 +260,11 @@ template Status BetaRowsetWriter::_add_row(const ContiguousRow& row);
 
 Status BetaRowsetWriter::add_rowset(RowsetSharedPtr rowset) {
     assert(rowset->rowset_meta()->rowset_type() == BETA_ROWSET);
-    RETURN_NOT_OK(rowset->link_files_to(_context.path_desc, _context.rowset_id));
+    RETURN_NOT_OK(rowset->link_files_to(_context.path_desc, _context.rowset_id, _num_segment));
     _num_rows_written += rowset->num_rows();
     _total_data_size += rowset->rowset_meta()->data_disk_size();
     _total_index_size += rowset->rowset_meta()->index_disk_size();
+    _add_rowset_key_bounds(rowset);
     _num_segment += rowset->num_segments();
     // TODO update zonemap
     if (rowset->rowset_meta()->has_delete_predicate()) {
@@ -202,6 +307,7 @@ Status BetaRowsetWriter::add_rowset_for_migration(RowsetSharedPtr rowset) {
     _num_rows_written += rowset->num_rows();
     _total_data_size += rowset->rowset_meta()->data_disk_size();
     _total_index_size += rowset->rowset_meta()->index_disk_size();
+    _add_rowset_key_bounds(rowset);
     _num_segment += rowset->num_segments();
     // TODO update zonemap
     if (rowset->rowset_meta()->has_delete_predicate()) {
@@ -211,6 +317,10 @@ Status BetaRowsetWriter::add_rowset_for_migration(RowsetSharedPtr rowset) {
 }
 
 Status BetaRowsetWriter::flush() {
+    if (_segment_write_token != nullptr) {
+        RETURN_NOT_OK(_submit_pending_block());
+        RETURN_NOT_OK(_wait_pending_segments());
+    }
     if (_segment_writer != nullptr) {
         RETURN_NOT_OK(_flush_segment_writer(&_segment_writer));
     }
@@ -250,6 +360,61 @@ Status BetaRowsetWriter::flush_single_memtable(MemTable* memtable, int64_t* flus
     return Status::OK();
 }
 
+Status BetaRowsetWriter::flush_single_block(const vectorized::Block* block, int64_t* flush_size) {
+    if (block->rows() == 0) {
+        *flush_size = 0;
+        return Status::OK();
+    }
+    int64_t current_flush_size = _total_data_size + _total_index_size;
+    ThreadPool* pool = nullptr;
+    auto storage_engine = StorageEngine::instance();
+    if (config::enable_parallel_segment_write && storage_engine != nullptr) {
+        pool = storage_engine->segment_write_thread_pool();
+    }
+    size_t segment_rows = _parallel_segment_rows(block);
+    size_t block_row_num = block->rows();
+    if (pool == nullptr || block_row_num <= segment_rows) {
+        // Create segment writer for each block, so that
+        // all memtables can be flushed in parallel.
+        std::unique_ptr<segment_v2::SegmentWriter> writer;
+        RETURN_NOT_OK(_append_block(block, &writer));
+        RETURN_NOT_OK(_flush_segment_writer(&writer));
+    } else {
+        // Allocate the segment ids at once, so that the segments of the block are continuous
+        // even if other memtables are flushed at the same time.
+        size_t num_segments = (block_row_num + segment_rows - 1) / segment_rows;
+        uint32_t first_segment_id = _num_segment.fetch_add(static_cast<int32_t>(num_segments));
+        std::vector<std::unique_ptr<segment_v2::SegmentWriter>> writers(num_segments);
+        std::vector<Status> statuses(num_segments);
+        auto token = pool->new_token(ThreadPool::ExecutionMode::CONCURRENT);
+        Status st;
+        for (size_t i = 0; i < num_segments && st.ok(); ++i) {
+            st = _create_segment_writer(first_segment_id + i, &writers[i]);
+            if (!st.ok()) {
+                break;
+            }
+            size_t row_pos = i * segment_rows;
+            size_t num_rows = std::min(segment_rows, block_row_num - row_pos);
+            auto write_segment = [this, &writers, &statuses, block, i, row_pos, num_rows]() {
+                statuses[i] = _write_segment(writers[i].get(), block, row_pos, num_rows);
+            };
+            if (!token->submit_func(write_segment).ok()) {
+                // the thread pool is shutting down
+                write_segment();
+            }
+        }
+        token->wait();
+        RETURN_NOT_OK(st);
+        for (auto& status : statuses) {
+            RETURN_NOT_OK(status);
+        }
+    }
+    _num_rows_written += block_row_num;
+
+    *flush_size = (_total_data_size + _total_index_size) - current_flush_size;
+    return Status::OK();
+}
+
 RowsetSharedPtr BetaRowsetWriter::build() {
     // TODO(lingbin): move to more better place, or in a CreateBlockBatch?
     for (auto& wblock : _wblocks) {
@@ -258,6 +423,7 @@ RowsetSharedPtr BetaRowsetWriter::build() {
     // When building a rowset, we must ensure that the current _segment_writer has been
     // flushed, that is, the current _segment_writer is nullptr
     DCHECK(_segment_writer == nullptr) << "segment must be null when build rowset";
+    DCHECK(_pending_segment_writers.empty()) << "segments must be flushed when build rowset";
     _rowset_meta->set_num_rows(_num_rows_written);
     _rowset_meta->set_total_disk_size(_total_data_size);
     _rowset_meta->set_data_disk_size(_total_data_size);
@@ -266,6 +432,14 @@ RowsetSharedPtr BetaRowsetWriter::build() {
     _rowset_meta->set_empty(_num_rows_written == 0);
     _rowset_meta->set_creation_time(time(nullptr));
     _rowset_meta->set_num_segments(_num_segment);
+    // the key bounds are recorded only if they are known for all segments
+    if (_segments_key_bounds.size() == static_cast<size_t>(_num_segment)) {
+        std::vector<KeyBoundsPB> segments_key_bounds;
+        for (auto& [segment_id, key_bounds] : _segments_key_bounds) {
+            segments_key_bounds.push_back(std::move(key_bounds));
+        }
+        _rowset_meta->set_segments_key_bounds(segments_key_bounds);
+    }
     if (_num_segment <= 1) {
         _rowset_meta->set_segments_overlap(NONOVERLAPPING);
     }
@@ -288,8 +462,29 @@ RowsetSharedPtr BetaRowsetWriter::build() {
 
 Status BetaRowsetWriter::_create_segment_writer(
         std::unique_ptr<segment_v2::SegmentWriter>* writer) {
+    std::vector<uint32_t> column_ids(_context.tablet_schema->num_columns());
+    std::iota(column_ids.begin(), column_ids.end(), 0);
+    return _create_segment_writer(column_ids, true, writer);
+}
+
+Status BetaRowsetWriter::_create_segment_writer(
+        uint32_t segment_id, std::unique_ptr<segment_v2::SegmentWriter>* writer) {
+    std::vector<uint32_t> column_ids(_context.tablet_schema->num_columns());
+    std::iota(column_ids.begin(), column_ids.end(), 0);
+    return _do_create_segment_writer(segment_id, column_ids, true, writer);
+}
+
+Status BetaRowsetWriter::_create_segment_writer(
+        const std::vector<uint32_t>& column_ids, bool is_key,
+        std::unique_ptr<segment_v2::SegmentWriter>* writer) {
+    return _do_create_segment_writer(_num_segment++, column_ids, is_key, writer);
+}
+
+Status BetaRowsetWriter::_do_create_segment_writer(
+        uint32_t segment_id, const std::vector<uint32_t>& column_ids, bool is_key,
+        std::unique_ptr<segment_v2::SegmentWriter>* writer) {
     auto path_desc =
-            BetaRowset::segment_file_path(_context.path_desc, _context.rowset_id, _num_segment++);
+            BetaRowset::segment_file_path(_context.path_desc, _context.rowset_id, segment_id);
     // TODO(lingbin): should use a more general way to get BlockManager object
     // and tablets with the same type should share one BlockManager object;
     fs::BlockManager* block_mgr = fs::fs_util::block_manager(_context.path_desc);
@@ -305,7 +500,7 @@ Status BetaRowsetWriter::_create_segment_writer(
 
     DCHECK(wblock != nullptr);
     segment_v2::SegmentWriterOptions writer_options;
-    writer->reset(new segment_v2::SegmentWriter(wblock.get(), _num_segment, _context.tablet_schema,
+    writer->reset(new segment_v2::SegmentWriter(wblock.get(), segment_id, _context.tablet_schema,
                                                 _context.data_dir, _context.max_rows_per_segment,
                                                 writer_options));
     {
@@ -313,7 +508,7 @@ Status BetaRowsetWriter::_create_segment_writer(
         _wblocks.push_back(std::move(wblock));
     }
 
-    auto s = (*writer)->init(config::push_write_mbytes_per_sec);
+    auto s = (*writer)->init(config::push_write_mbytes_per_sec, column_ids, is_key);
     if (!s.ok()) {
         LOG(WARNING) << "failed to init segment writer: " << s.to_string();
         writer->reset(nullptr);
@@ -323,20 +518,45 @@ Status BetaRowsetWriter::_create_segment_writer(
 }
 
 Status BetaRowsetWriter::_flush_segment_writer(std::unique_ptr<segment_v2::SegmentWriter>* writer) {
-    if ((*writer)->num_rows_written() == 0) {
+    if (*writer == nullptr || (*writer)->num_rows_written() == 0) {
         return Status::OK();
     }
+    RETURN_NOT_OK(_finalize_segment(writer->get()));
+    writer->reset();
+    return Status::OK();
+}
+
+Status BetaRowsetWriter::_finalize_segment(segment_v2::SegmentWriter* writer) {
     uint64_t segment_size;
     uint64_t index_size;
-    Status s = (*writer)->finalize(&segment_size, &index_size);
+    Status s = writer->finalize(&segment_size, &index_size);
     if (!s.ok()) {
         LOG(WARNING) << "failed to finalize segment: " << s.to_string();
         return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
     }
     _total_data_size += segment_size;
     _total_index_size += index_size;
-    writer->reset();
+    _add_segment_key_bounds(*writer);
     return Status::OK();
 }
 
+void BetaRowsetWriter::_add_rowset_key_bounds(const RowsetSharedPtr& rowset) {
+    if (!rowset->rowset_meta()->has_segments_key_bounds()) {
+        return;
+    }
+    std::lock_guard<SpinLock> l(_lock);
+    uint32_t segment_id = _num_segment;
+    for (const auto& key_bounds : rowset->rowset_meta()->segments_key_bounds()) {
+        _segments_key_bounds.emplace(segment_id++, key_bounds);
+    }
+}
+
+void BetaRowsetWriter::_add_segment_key_bounds(const segment_v2::SegmentWriter& writer) {
+    KeyBoundsPB key_bounds;
+    key_bounds.set_min_key(writer.min_encoded_key());
+    key_bounds.set_max_key(writer.max_encoded_key());
+    std::lock_guard<SpinLock> l(_lock);
+    _segments_key_bounds.emplace(writer.get_segment_id(), std::move(key_bounds));
+}
+
 } // namespace doris
@@ -18,11 +18,15 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 #define DORIS_BE_SRC_OLAP_ROWSET_BETA_ROWSET_WRITER_H
 
+#include <map>
+
 #include "olap/rowset/rowset_writer.h"
 #include "vector"
 
 namespace doris {
 
+class ThreadPoolToken;
+
 namespace fs {
 class WritableBlock;
 }
@@ -58,6 +62,10 @@ public:
     // Return the file size flushed to disk in "flush_size"
     Status flush_single_memtable(MemTable* memtable, int64_t* flush_size) override;
 
+    // The rows are split into several segments which are written in parallel by the segment
+    // write thread pool if `enable_parallel_segment_write` is true.
+    Status flush_single_block(const vectorized::Block* block, int64_t* flush_size) override;
+
     RowsetSharedPtr build() override;
 
     Version version() override { return _context.version; }
@@ -68,15 +76,46 @@ public:
 
     RowsetTypePB type() const override { return RowsetTypePB::BETA_ROWSET; }
 
-private:
+protected:
     template <typename RowType>
     Status _add_row(const RowType& row);
 
     Status _create_segment_writer(std::unique_ptr<segment_v2::SegmentWriter>* writer);
+    // create a segment writer to write the columns `column_ids`
+    Status _create_segment_writer(const std::vector<uint32_t>& column_ids, bool is_key,
+                                  std::unique_ptr<segment_v2::SegmentWriter>* writer);
+    // create a segment writer of all columns with an allocated segment id
+    Status _create_segment_writer(uint32_t segment_id,
+                                  std::unique_ptr<segment_v2::SegmentWriter>* writer);
+    Status _do_create_segment_writer(uint32_t segment_id, const std::vector<uint32_t>& column_ids,
+                                     bool is_key,
+                                     std::unique_ptr<segment_v2::SegmentWriter>* writer);
+
+    // append the rows of `block` to `*writer`, and switch to a new segment writer when it's full
+    Status _append_block(const vectorized::Block* block,
+                         std::unique_ptr<segment_v2::SegmentWriter>* writer);
 
     Status _flush_segment_writer(std::unique_ptr<segment_v2::SegmentWriter>* writer);
-
-private:
+    // finalize the segment, and count its size and key bounds into the rowset
+    Status _finalize_segment(segment_v2::SegmentWriter* writer);
+
+    // max rows of a segment written in parallel, for the rows of `block`
+    size_t _parallel_segment_rows(const vectorized::Block* block) const;
+    // write the rows [row_pos, row_pos + num_rows) of `block` into a whole segment
+    Status _write_segment(segment_v2::SegmentWriter* writer, const vectorized::Block* block,
+                          size_t row_pos, size_t num_rows);
+    // buffer the rows of `block`, and submit them to write a segment once there're enough rows
+    Status _add_block_parallel(const vectorized::Block* block);
+    Status _submit_pending_block();
+    // wait for all segments submitted by `_submit_pending_block` to finish
+    Status _wait_pending_segments();
+    // record the key bounds of a finalized segment
+    void _add_segment_key_bounds(const segment_v2::SegmentWriter& writer);
+    // record the key bounds of the segments linked from `rowset`, called before the segments
+    // are counted into `_num_segment`
+    void _add_rowset_key_bounds(const RowsetSharedPtr& rowset);
+
+protected:
     RowsetWriterContext _context;
     std::shared_ptr<RowsetMeta> _rowset_meta;
 
@@ -85,9 +124,11 @@ private:
     /// Because we want to flush memtables in parallel.
     /// In other processes, such as merger or schema change, we will use this unified writer for data writing.
     std::unique_ptr<segment_v2::SegmentWriter> _segment_writer;
-    mutable SpinLock _lock; // lock to protect _wblocks.
+    mutable SpinLock _lock; // lock to protect _wblocks and _segments_key_bounds.
     // TODO(lingbin): it is better to wrapper in a Batch?
     std::vector<std::unique_ptr<fs::WritableBlock>> _wblocks;
+    // segment id -> key bounds, segments may be flushed in parallel
+    std::map<uint32_t, KeyBoundsPB> _segments_key_bounds;
 
     // counters and statistics maintained during data write
     std::atomic<int64_t> _num_rows_written;
@@ -95,6 +136,15 @@ private:
     std::atomic<int64_t> _total_index_size;
     // TODO rowset Zonemap
 
+    // not null if the segments of `add_block` are written in parallel
+    std::unique_ptr<ThreadPoolToken> _segment_write_token;
+    // the rows buffered for the next segment written in parallel
+    std::unique_ptr<vectorized::MutableBlock> _pending_block;
+    // the writers of the segments submitted to `_segment_write_token`
+    std::vector<std::unique_ptr<segment_v2::SegmentWriter>> _pending_segment_writers;
+    // the first error of the segments written in parallel, protected by `_lock`
+    Status _parallel_write_status;
+
     bool _is_pending = false;
     bool _already_built = false;
 };
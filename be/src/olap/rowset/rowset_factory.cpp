@@ -25,6 +25,7 @@
 #include "olap/rowset/alpha_rowset_writer.h"
 #include "olap/rowset/beta_rowset_writer.h"
 #include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/vertical_beta_rowset_writer.h"
 
 namespace doris {
 
@@ -49,7 +50,11 @@ Status RowsetFactory::create_rowset_writer(const RowsetWriterContext& context,
         return (*output)->init(context);
     }
     if (context.rowset_type == BETA_ROWSET) {
-        output->reset(new BetaRowsetWriter);
+        if (context.is_vertical) {
+            output->reset(new VerticalBetaRowsetWriter);
+        } else {
+            output->reset(new BetaRowsetWriter);
+        }
         return (*output)->init(context);
     }
     return Status::OLAPInternalError(OLAP_ERR_ROWSET_TYPE_NOT_FOUND);
@@ -94,6 +94,21 @@ Status RowsetMetaManager::save(OlapMeta* meta, TabletUid tablet_uid, const Rowse
     return status;
 }
 
+Status RowsetMetaManager::save(OlapMeta* meta,
+                               const std::vector<RowsetMetaSharedPtr>& rowset_metas) {
+    std::vector<std::pair<std::string, std::string>> entries(rowset_metas.size());
+    for (size_t i = 0; i < rowset_metas.size(); ++i) {
+        const RowsetMetaSharedPtr& rowset_meta = rowset_metas[i];
+        entries[i].first = ROWSET_PREFIX + rowset_meta->tablet_uid().to_string() + "_" +
+                           rowset_meta->rowset_id().to_string();
+        if (!rowset_meta->get_rowset_pb().SerializeToString(&entries[i].second)) {
+            LOG(WARNING) << "serialize rowset pb failed. rowset id:" << entries[i].first;
+            return Status::OLAPInternalError(OLAP_ERR_SERIALIZE_PROTOBUF_ERROR);
+        }
+    }
+    return meta->put(META_COLUMN_FAMILY_INDEX, entries);
+}
+
 Status RowsetMetaManager::remove(OlapMeta* meta, TabletUid tablet_uid, const RowsetId& rowset_id) {
     std::string key = ROWSET_PREFIX + tablet_uid.to_string() + "_" + rowset_id.to_string();
     VLOG_NOTICE << "start to remove rowset, key:" << key;
@@ -19,6 +19,7 @@
 #define DORIS_BE_SRC_OLAP_ROWSET_ROWSET_META_MANAGER_H
 
 #include <string>
+#include <vector>
 
 #include "olap/olap_meta.h"
 #include "olap/rowset/rowset_meta.h"
@@ -41,6 +42,9 @@ public:
     static Status save(OlapMeta* meta, TabletUid tablet_uid, const RowsetId& rowset_id,
                        const RowsetMetaPB& rowset_meta_pb);
 
+    // Save the metas of the rowsets atomically by one write batch.
+    static Status save(OlapMeta* meta, const std::vector<RowsetMetaSharedPtr>& rowset_metas);
+
     static Status remove(OlapMeta* meta, TabletUid tablet_uid, const RowsetId& rowset_id);
 
     static Status traverse_rowset_metas(
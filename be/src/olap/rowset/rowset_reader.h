@@ -61,6 +61,12 @@ public:
     virtual int64_t filtered_rows() = 0;
 
     virtual RowsetTypePB type() const = 0;
+
+    // The locations of the rows of the last block read by next_block(vectorized::Block*),
+    // only supported if RowsetReaderContext::record_rowids is set.
+    virtual Status current_block_row_locations(std::vector<RowLocation>* locations) {
+        return Status::NotSupported("to be implemented");
+    }
 };
 
 } // namespace doris
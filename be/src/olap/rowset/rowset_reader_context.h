@@ -18,6 +18,7 @@
 #ifndef DORIS_BE_SRC_OLAP_ROWSET_ROWSET_READER_CONTEXT_H
 #define DORIS_BE_SRC_OLAP_ROWSET_ROWSET_READER_CONTEXT_H
 
+#include "gen_cpp/PlanNodes_types.h"
 #include "olap/column_predicate.h"
 #include "olap/olap_common.h"
 #include "runtime/runtime_state.h"
@@ -26,8 +27,15 @@ namespace doris {
 
 class RowCursor;
 class Conditions;
+class DeleteBitmap;
 class DeleteHandler;
 class TabletSchema;
+class LateRuntimeFilter;
+class TopNColumnPredicate;
+
+namespace segment_v2 {
+class PagePrefetchBudget;
+} // namespace segment_v2
 
 struct RowsetReaderContext {
     ReaderType reader_type = READER_QUERY;
@@ -52,17 +60,35 @@ struct RowsetReaderContext {
     const std::vector<ColumnPredicate*>* predicates = nullptr;
     // value column predicate in UNIQUE table
     const std::vector<ColumnPredicate*>* value_predicates = nullptr;
+    // (column id, LIKE pattern) pairs used to filter pages by ngram bloom filter index
+    const std::vector<std::pair<uint32_t, std::string>>* like_predicates = nullptr;
+    // the predicate of the boundary of a Top-N sort, also in `predicates`
+    const TopNColumnPredicate* topn_predicate = nullptr;
+    // the runtime filters arriving after the scan starts
+    const std::vector<std::shared_ptr<LateRuntimeFilter>>* late_runtime_filters = nullptr;
+    // remember the locations of the rows of each block read, the rows must not be merged
+    bool record_rowids = false;
     const std::vector<RowCursor>* lower_bound_keys = nullptr;
     const std::vector<bool>* is_lower_keys_included = nullptr;
     const std::vector<RowCursor>* upper_bound_keys = nullptr;
     const std::vector<bool>* is_upper_keys_included = nullptr;
     const DeleteHandler* delete_handler = nullptr;
+    // the rows deleted by later loads in merge-on-write unique key tablets,
+    // only the marks of the versions <= version.second are applied
+    const DeleteBitmap* delete_bitmap = nullptr;
+    Version version {-1, -1};
     OlapReaderStatistics* stats = nullptr;
     RuntimeState* runtime_state = nullptr;
     bool use_page_cache = false;
+    bool bypass_page_cache_admission = false;
+    segment_v2::PagePrefetchBudget* page_prefetch_budget = nullptr;
     int sequence_id_idx = -1;
     int batch_size = 1024;
+    // see StorageReadOptions::block_row_limit
+    const int* block_row_limit = nullptr;
     bool is_vec = false;
+    // the aggregate answered from the segment metadata if no rows are filtered, vec only
+    TPushAggOp::type push_down_agg_type_opt = TPushAggOp::NONE;
 };
 
 } // namespace doris
@@ -48,6 +48,25 @@ public:
         return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
     }
 
+    // Add the columns `col_ids` of the rows, used by vertical compaction. The key columns
+    // (`is_key` is true) are added first and decide the segments, every segment has at most
+    // `max_rows_per_segment` rows. Then the value columns are added group by group,
+    // and each group must have the same rows.
+    virtual Status add_columns(const vectorized::Block* block, const std::vector<uint32_t>& col_ids,
+                               bool is_key, uint32_t max_rows_per_segment) {
+        return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
+    }
+
+    // flush the columns added by `add_columns` after all rows of a column group are added
+    virtual Status flush_columns() {
+        return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
+    }
+
+    // finish the segments after all column groups are flushed
+    virtual Status final_flush() {
+        return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
+    }
+
     // Precondition: the input `rowset` should have the same type of the rowset we're building
     virtual Status add_rowset(RowsetSharedPtr rowset) = 0;
 
@@ -65,6 +84,12 @@ public:
         return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
     }
 
+    // Write the sorted rows of a vectorized memtable into new segments, independent of the
+    // segment written by `add_block`, so that the memtables can be flushed in parallel.
+    virtual Status flush_single_block(const vectorized::Block* block, int64_t* flush_size) {
+        return Status::OLAPInternalError(OLAP_ERR_FUNC_NOT_IMPLEMENTED);
+    }
+
     // finish building and return pointer to the built rowset (guaranteed to be inited).
     // return nullptr when failed
     virtual RowsetSharedPtr build() = 0;
@@ -71,6 +71,9 @@ struct RowsetWriterContext {
     // ATTN: not support for RowsetConvertor.
     // (because it hard to refactor, and RowsetConvertor will be deprecated in future)
     DataDir* data_dir = nullptr;
+    // whether the rowset is written by vertical compaction, which adds the rows column group
+    // by column group by `RowsetWriter::add_columns`
+    bool is_vertical = false;
 };
 
 } // namespace doris
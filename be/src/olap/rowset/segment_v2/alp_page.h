@@ -0,0 +1,470 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gutil/strings/substitute.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/options.h"      // for PageBuilderOptions/PageDecoderOptions
+#include "olap/rowset/segment_v2/page_builder.h" // for PageBuilder
+#include "olap/rowset/segment_v2/page_decoder.h" // for PageDecoder
+#include "olap/types.h"
+#include "util/bit_stream_utils.inline.h"
+#include "util/coding.h"
+#include "util/faststring.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// ALP (adaptive lossless floating point) style encoding of FLOAT and DOUBLE pages.
+//
+// Most floating point metrics are decimals with a few digits, e.g. 12.34, so a value v is
+// encoded as the integer d = round(v * 10^e). The exponent e is chosen per block by sampling,
+// and d is bit packed with frame of reference. A value which doesn't round trip exactly
+// (e.g. NaN, -0.0 or a value with too many digits) is stored as an exception.
+//
+//   AlpPage := NumValues(4 bytes), Block^N, BlockOffset^N (4 bytes each)
+//   Block := Exponent(1 byte), BitWidth(1 byte), NumExceptions(2 bytes), MinValue(8 bytes),
+//            PackedValues, ExceptionPosition^K (2 bytes each), ExceptionValue^K
+//
+// A block is decoded by unpacking the integers, converting them by d / 10^e in a flat loop, and
+// patching the exceptions at last. The division is correctly rounded, so a decimal with at most
+// 15 significant digits always round trips for DOUBLE.
+static constexpr size_t ALP_BLOCK_SIZE = 1024;
+static constexpr size_t ALP_PAGE_HEADER_SIZE = sizeof(uint32_t);
+static constexpr size_t ALP_BLOCK_HEADER_SIZE = 4 + sizeof(int64_t);
+// number of values sampled from a block to choose the exponent
+static constexpr size_t ALP_SAMPLE_SIZE = 32;
+
+template <typename T>
+struct AlpTraits {};
+
+template <>
+struct AlpTraits<double> {
+    static constexpr int MAX_EXPONENT = 18;
+    static double exp10(int e) {
+        static const double POW10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,
+                                       1e7,  1e8,  1e9,  1e10, 1e11, 1e12, 1e13,
+                                       1e14, 1e15, 1e16, 1e17, 1e18};
+        return POW10[e];
+    }
+};
+
+template <>
+struct AlpTraits<float> {
+    static constexpr int MAX_EXPONENT = 10;
+    static float exp10(int e) {
+        static const float POW10[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                      1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+        return POW10[e];
+    }
+};
+
+// The encoding and decoding of a value with the exponent. The decoder must use the same
+// formula, so that the exceptions found by the encoder are exactly the values which don't
+// round trip.
+template <typename T>
+struct AlpCodec {
+    // the integers are limited to convert to T exactly enough, and not to overflow
+    static constexpr double MAX_ENCODED = 9.0e18;
+
+    static bool encode(T value, int e, int64_t* encoded) {
+        T scaled = value * AlpTraits<T>::exp10(e);
+        if (!(std::abs(scaled) < static_cast<T>(MAX_ENCODED))) {
+            // NaN, infinity or out of range
+            return false;
+        }
+        int64_t d = static_cast<int64_t>(std::nearbyint(scaled));
+        T decoded = decode(d, e);
+        if (memcmp(&decoded, &value, sizeof(T)) != 0) {
+            return false;
+        }
+        *encoded = d;
+        return true;
+    }
+
+    static T decode(int64_t encoded, int e) {
+        return static_cast<T>(encoded) / AlpTraits<T>::exp10(e);
+    }
+};
+
+template <FieldType Type>
+class AlpPageBuilder : public PageBuilder {
+public:
+    explicit AlpPageBuilder(const PageBuilderOptions& options)
+            : _options(options),
+              // the decoded page takes as much memory as a plain page
+              _max_count(std::max<size_t>(options.data_page_size / SIZE_OF_TYPE, 1)) {
+        reset();
+    }
+
+    bool is_page_full() override { return _count >= _max_count; }
+
+    Status add(const uint8_t* vals, size_t* count) override {
+        DCHECK(!_finished);
+        size_t to_add = std::min(*count, _max_count - _count);
+        if (to_add == 0) {
+            *count = 0;
+            return Status::OK();
+        }
+        auto new_vals = reinterpret_cast<const CppType*>(vals);
+        if (_count == 0) {
+            _first_value = new_vals[0];
+        }
+        for (size_t i = 0; i < to_add; ++i) {
+            _pending_values.push_back(new_vals[i]);
+            if (_pending_values.size() == ALP_BLOCK_SIZE) {
+                _flush_block();
+            }
+        }
+        _last_value = new_vals[to_add - 1];
+        _count += to_add;
+        *count = to_add;
+        return Status::OK();
+    }
+
+    OwnedSlice finish() override {
+        DCHECK(!_finished);
+        _finished = true;
+        if (!_pending_values.empty()) {
+            _flush_block();
+        }
+        encode_fixed32_le(_buffer.data(), _count);
+        for (uint32_t offset : _block_offsets) {
+            put_fixed32_le(&_buffer, offset);
+        }
+        return _buffer.build();
+    }
+
+    void reset() override {
+        _count = 0;
+        _finished = false;
+        _pending_values.clear();
+        _block_offsets.clear();
+        _buffer.clear();
+        _buffer.resize(ALP_PAGE_HEADER_SIZE);
+    }
+
+    size_t count() const override { return _count; }
+
+    uint64_t size() const override {
+        return _buffer.size() + _pending_values.size() * SIZE_OF_TYPE +
+               _block_offsets.size() * sizeof(uint32_t);
+    }
+
+    Status get_first_value(void* value) const override {
+        if (_count == 0) {
+            return Status::NotFound("page is empty");
+        }
+        memcpy(value, &_first_value, SIZE_OF_TYPE);
+        return Status::OK();
+    }
+
+    Status get_last_value(void* value) const override {
+        if (_count == 0) {
+            return Status::NotFound("page is empty");
+        }
+        memcpy(value, &_last_value, SIZE_OF_TYPE);
+        return Status::OK();
+    }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    enum { SIZE_OF_TYPE = TypeTraits<Type>::size };
+
+    // the exponent with the least exceptions in the sample, the smaller one is preferred
+    // because it leads to a narrower bit width
+    int _choose_exponent() const {
+        size_t num_values = _pending_values.size();
+        size_t step = std::max<size_t>(num_values / ALP_SAMPLE_SIZE, 1);
+        int best_exponent = 0;
+        size_t best_exceptions = std::numeric_limits<size_t>::max();
+        for (int e = 0; e <= AlpTraits<CppType>::MAX_EXPONENT; ++e) {
+            size_t exceptions = 0;
+            int64_t encoded;
+            for (size_t i = 0; i < num_values; i += step) {
+                if (!AlpCodec<CppType>::encode(_pending_values[i], e, &encoded)) {
+                    ++exceptions;
+                }
+            }
+            if (exceptions < best_exceptions) {
+                best_exceptions = exceptions;
+                best_exponent = e;
+                if (exceptions == 0) {
+                    break;
+                }
+            }
+        }
+        return best_exponent;
+    }
+
+    void _flush_block() {
+        size_t num_values = _pending_values.size();
+        DCHECK_GT(num_values, 0);
+        _block_offsets.push_back(_buffer.size());
+
+        int exponent = _choose_exponent();
+        _encoded.resize(num_values);
+        _exception_positions.clear();
+        bool has_encoded = false;
+        int64_t fill_value = 0;
+        for (size_t i = 0; i < num_values; ++i) {
+            if (AlpCodec<CppType>::encode(_pending_values[i], exponent, &_encoded[i])) {
+                if (!has_encoded) {
+                    has_encoded = true;
+                    fill_value = _encoded[i];
+                }
+            } else {
+                _exception_positions.push_back(i);
+            }
+        }
+        // the exceptions take a valid value in the packed values to not widen the range
+        for (uint16_t pos : _exception_positions) {
+            _encoded[pos] = fill_value;
+        }
+        int64_t min_value = *std::min_element(_encoded.begin(), _encoded.end());
+        int64_t max_value = *std::max_element(_encoded.begin(), _encoded.end());
+        uint64_t max_packed = static_cast<uint64_t>(max_value) - static_cast<uint64_t>(min_value);
+        int bit_width = max_packed == 0 ? 0 : 64 - __builtin_clzll(max_packed);
+
+        _buffer.push_back(static_cast<char>(exponent));
+        _buffer.push_back(static_cast<char>(bit_width));
+        put_fixed16_le(&_buffer, static_cast<uint16_t>(_exception_positions.size()));
+        put_fixed64_le(&_buffer, static_cast<uint64_t>(min_value));
+        if (bit_width > 0) {
+            BitWriter writer(&_packed_buffer);
+            for (int64_t value : _encoded) {
+                writer.PutValue(static_cast<uint64_t>(value) - static_cast<uint64_t>(min_value),
+                                bit_width);
+            }
+            writer.Flush();
+            _buffer.append(_packed_buffer.data(), _packed_buffer.size());
+        }
+        for (uint16_t pos : _exception_positions) {
+            put_fixed16_le(&_buffer, pos);
+        }
+        for (uint16_t pos : _exception_positions) {
+            _buffer.append(&_pending_values[pos], SIZE_OF_TYPE);
+        }
+        _pending_values.clear();
+    }
+
+    PageBuilderOptions _options;
+    size_t _max_count;
+    size_t _count = 0;
+    bool _finished = false;
+    faststring _buffer;
+    // values of the current block, not encoded yet
+    std::vector<CppType> _pending_values;
+    std::vector<int64_t> _encoded;
+    std::vector<uint16_t> _exception_positions;
+    faststring _packed_buffer;
+    std::vector<uint32_t> _block_offsets;
+    CppType _first_value;
+    CppType _last_value;
+};
+
+template <FieldType Type>
+class AlpPageDecoder : public PageDecoder {
+public:
+    AlpPageDecoder(Slice data, const PageDecoderOptions& options)
+            : _data(data), _options(options) {}
+
+    Status init() override {
+        CHECK(!_parsed);
+        if (_data.size < ALP_PAGE_HEADER_SIZE) {
+            return Status::Corruption(strings::Substitute(
+                    "not enough bytes for header in AlpPageDecoder, data size: $0", _data.size));
+        }
+        _num_elements = decode_fixed32_le((const uint8_t*)_data.data);
+        _num_blocks = (_num_elements + ALP_BLOCK_SIZE - 1) / ALP_BLOCK_SIZE;
+        if (_data.size < ALP_PAGE_HEADER_SIZE + _num_blocks * sizeof(uint32_t)) {
+            return Status::Corruption(strings::Substitute(
+                    "not enough bytes for $0 blocks in AlpPageDecoder", _num_blocks));
+        }
+        _blocks_end = _data.size - _num_blocks * sizeof(uint32_t);
+        size_t prev_offset = ALP_PAGE_HEADER_SIZE;
+        for (size_t i = 0; i < _num_blocks; ++i) {
+            size_t offset = _block_offset(i);
+            if (offset < prev_offset || offset + ALP_BLOCK_HEADER_SIZE > _blocks_end) {
+                return Status::Corruption(strings::Substitute(
+                        "invalid offset $0 of block $1 in AlpPageDecoder", offset, i));
+            }
+            prev_offset = offset + ALP_BLOCK_HEADER_SIZE;
+        }
+        _parsed = true;
+        return Status::OK();
+    }
+
+    Status seek_to_position_in_page(size_t pos) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        DCHECK_LE(pos, _num_elements)
+                << "Tried to seek to " << pos << " which is > number of elements (" << _num_elements
+                << ") in the block!";
+        // the block is decoded when it's read
+        _cur_index = pos;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, ColumnBlockView* dst) override { return next_batch<true>(n, dst); }
+
+    template <bool forward_index>
+    Status next_batch(size_t* n, ColumnBlockView* dst) {
+        DCHECK(_parsed) << "Must call init() firstly";
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        uint8_t* data_ptr = dst->data();
+        size_t cur_index = _cur_index;
+        size_t fetched = 0;
+        while (fetched < to_fetch) {
+            size_t block = cur_index / ALP_BLOCK_SIZE;
+            size_t index_in_block = cur_index % ALP_BLOCK_SIZE;
+            RETURN_IF_ERROR(_decode_block(block));
+            size_t num = std::min(to_fetch - fetched, _num_values_of_block(block) - index_in_block);
+            memcpy(data_ptr + fetched * SIZE_OF_TYPE, &_block_values[index_in_block],
+                   num * SIZE_OF_TYPE);
+            fetched += num;
+            cur_index += num;
+        }
+        if (forward_index) {
+            _cur_index = cur_index;
+        }
+        *n = to_fetch;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        size_t fetched = 0;
+        while (fetched < to_fetch) {
+            size_t block = _cur_index / ALP_BLOCK_SIZE;
+            size_t index_in_block = _cur_index % ALP_BLOCK_SIZE;
+            RETURN_IF_ERROR(_decode_block(block));
+            size_t num = std::min(to_fetch - fetched, _num_values_of_block(block) - index_in_block);
+            dst->insert_many_fix_len_data((char*)&_block_values[index_in_block], num);
+            fetched += num;
+            _cur_index += num;
+        }
+        *n = to_fetch;
+        return Status::OK();
+    }
+
+    Status peek_next_batch(size_t* n, ColumnBlockView* dst) override {
+        return next_batch<false>(n, dst);
+    }
+
+    size_t count() const override { return _num_elements; }
+
+    size_t current_index() const override { return _cur_index; }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    enum { SIZE_OF_TYPE = TypeTraits<Type>::size };
+
+    size_t _block_offset(size_t block) const {
+        return decode_fixed32_le((const uint8_t*)_data.data + _blocks_end +
+                                 block * sizeof(uint32_t));
+    }
+
+    size_t _num_values_of_block(size_t block) const {
+        return std::min(ALP_BLOCK_SIZE, _num_elements - block * ALP_BLOCK_SIZE);
+    }
+
+    Status _decode_block(size_t block) {
+        if (block == _decoded_block) {
+            return Status::OK();
+        }
+        const uint8_t* ptr = (const uint8_t*)_data.data + _block_offset(block);
+        size_t block_end_offset = block + 1 < _num_blocks ? _block_offset(block + 1) : _blocks_end;
+        const uint8_t* block_end = (const uint8_t*)_data.data + block_end_offset;
+        size_t num_values = _num_values_of_block(block);
+
+        int exponent = ptr[0];
+        int bit_width = ptr[1];
+        size_t num_exceptions = decode_fixed16_le(ptr + 2);
+        uint64_t min_value = decode_fixed64_le(ptr + 4);
+        ptr += ALP_BLOCK_HEADER_SIZE;
+        size_t packed_size = (num_values * bit_width + 7) / 8;
+        if (exponent > AlpTraits<CppType>::MAX_EXPONENT || bit_width > 64 ||
+            num_exceptions > num_values ||
+            ptr + packed_size + num_exceptions * (sizeof(uint16_t) + SIZE_OF_TYPE) > block_end) {
+            return Status::Corruption(
+                    strings::Substitute("invalid block $0 in AlpPageDecoder", block));
+        }
+
+        if (bit_width > 0) {
+            BitReader reader(ptr, packed_size);
+            for (size_t i = 0; i < num_values; ++i) {
+                reader.GetValue(bit_width, &_encoded[i]);
+            }
+        } else {
+            std::fill(_encoded, _encoded + num_values, 0);
+        }
+        ptr += packed_size;
+
+        for (size_t i = 0; i < num_values; ++i) {
+            _encoded[i] += min_value;
+        }
+        for (size_t i = 0; i < num_values; ++i) {
+            _block_values[i] =
+                    AlpCodec<CppType>::decode(static_cast<int64_t>(_encoded[i]), exponent);
+        }
+
+        const uint8_t* exception_values = ptr + num_exceptions * sizeof(uint16_t);
+        for (size_t i = 0; i < num_exceptions; ++i) {
+            size_t pos = decode_fixed16_le(ptr + i * sizeof(uint16_t));
+            if (pos >= num_values) {
+                return Status::Corruption(strings::Substitute(
+                        "invalid exception position $0 of block $1 in AlpPageDecoder", pos,
+                        block));
+            }
+            memcpy(&_block_values[pos], exception_values + i * SIZE_OF_TYPE, SIZE_OF_TYPE);
+        }
+        _decoded_block = block;
+        return Status::OK();
+    }
+
+    Slice _data;
+    PageDecoderOptions _options;
+    bool _parsed = false;
+    size_t _num_elements = 0;
+    size_t _num_blocks = 0;
+    // end of the blocks, where the block offsets start
+    size_t _blocks_end = 0;
+    size_t _cur_index = 0;
+
+    size_t _decoded_block = std::numeric_limits<size_t>::max();
+    uint64_t _encoded[ALP_BLOCK_SIZE];
+    CppType _block_values[ALP_BLOCK_SIZE];
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -111,6 +111,9 @@ public:
 
     size_t current_index() const override { return _data_page_decoder->current_index(); }
 
+    // the codes of the dict encoded pages
+    Slice decoded_values() const override { return _data_page_decoder->decoded_values(); }
+
     bool is_dict_encoding() const;
 
     void set_dict_decoder(PageDecoder* dict_decoder, StringRef* dict_word_info);
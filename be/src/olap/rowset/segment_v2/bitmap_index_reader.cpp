@@ -17,6 +17,11 @@
 
 #include "olap/rowset/segment_v2/bitmap_index_reader.h"
 
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <vector>
+
 #include "olap/types.h"
 
 namespace doris {
@@ -67,11 +72,43 @@ Status BitmapIndexIterator::read_bitmap(rowid_t ordinal, roaring::Roaring* resul
 
 Status BitmapIndexIterator::read_union_bitmap(rowid_t from, rowid_t to, roaring::Roaring* result) {
     DCHECK(0 <= from && from <= to && to <= _reader->bitmap_nums());
+    if (from == to) {
+        return Status::OK();
+    }
+
+    // the bitmaps are read by batches without seeking each of them, and the bitmaps of a batch
+    // are unioned with the result by one fastunion, which repairs the containers only once
+    static constexpr size_t UNION_BATCH_SIZE = 1024;
+    size_t num_to_read = std::min<size_t>(UNION_BATCH_SIZE, to - from);
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    RETURN_IF_ERROR(
+            ColumnVectorBatch::create(num_to_read, false, _reader->type_info(), nullptr, &cvb));
+    ColumnBlock block(cvb.get(), _pool.get());
+
+    std::vector<roaring::Roaring> bitmaps;
+    std::vector<const roaring::Roaring*> inputs;
+    RETURN_IF_ERROR(_bitmap_column_iter.seek_to_ordinal(from));
+    for (rowid_t pos = from; pos < to;) {
+        ColumnBlockView column_block_view(&block);
+        size_t num_read = std::min<size_t>(num_to_read, to - pos);
+        RETURN_IF_ERROR(_bitmap_column_iter.next_batch(&num_read, &column_block_view));
+        if (num_read == 0) {
+            return Status::Corruption(
+                    fmt::format("read no bitmap at {} of the bitmap index", pos));
+        }
 
-    for (rowid_t pos = from; pos < to; pos++) {
-        roaring::Roaring bitmap;
-        RETURN_IF_ERROR(read_bitmap(pos, &bitmap));
-        *result |= bitmap;
+        const auto* slices = reinterpret_cast<const Slice*>(block.data());
+        bitmaps.clear();
+        bitmaps.reserve(num_read);
+        inputs.clear();
+        inputs.push_back(result);
+        for (size_t i = 0; i < num_read; ++i) {
+            bitmaps.push_back(roaring::Roaring::read(slices[i].data, false));
+            inputs.push_back(&bitmaps.back());
+        }
+        *result = roaring::Roaring::fastunion(inputs.size(), inputs.data());
+        _pool->clear();
+        pos += num_read;
     }
     return Status::OK();
 }
@@ -217,7 +217,11 @@ public:
               _size_of_element(0),
               _cur_index(0) {}
 
-    ~BitShufflePageDecoder() { ChunkAllocator::instance()->free(_chunk); }
+    ~BitShufflePageDecoder() {
+        if (_owns_chunk) {
+            ChunkAllocator::instance()->free(_chunk);
+        }
+    }
 
     Status init() override {
         CHECK(!_parsed);
@@ -373,6 +377,13 @@ public:
 
     size_t current_index() const override { return _cur_index; }
 
+    Slice decoded_values() const override {
+        if (_num_elements == 0) {
+            return Slice();
+        }
+        return Slice(_chunk.data, _num_element_after_padding * _size_of_element);
+    }
+
 private:
     void _copy_next_values(size_t n, void* data) {
         memcpy(data, &_chunk.data[_cur_index * SIZE_OF_TYPE], n * SIZE_OF_TYPE);
@@ -380,6 +391,14 @@ private:
 
     Status _decode() {
         if (_num_elements > 0) {
+            size_t decoded_size = _num_element_after_padding * _size_of_element;
+            if (_options.decoded_values.size == decoded_size) {
+                // the page was decoded before, read the values decoded from the cache
+                _chunk.data = reinterpret_cast<uint8_t*>(_options.decoded_values.data);
+                _chunk.size = decoded_size;
+                _owns_chunk = false;
+                return Status::OK();
+            }
             int64_t bytes;
             if (!ChunkAllocator::instance()->allocate_align(
                         _num_element_after_padding * _size_of_element, &_chunk)) {
@@ -411,6 +430,8 @@ private:
     int _size_of_element;
     size_t _cur_index;
     Chunk _chunk;
+    // false if _chunk is the decoded values from PageDecoderOptions
+    bool _owns_chunk = true;
     friend class BinaryDictPageDecoder;
 };
 
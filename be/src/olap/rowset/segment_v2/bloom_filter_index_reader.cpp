@@ -23,6 +23,32 @@
 namespace doris {
 namespace segment_v2 {
 
+void get_like_pattern_ngrams(const std::string& pattern, size_t gram_size,
+                             std::vector<std::string>* grams) {
+    if (gram_size == 0) {
+        return;
+    }
+    auto add_grams = [&](const std::string& literal) {
+        for (size_t pos = 0; pos + gram_size <= literal.size(); ++pos) {
+            grams->emplace_back(literal, pos, gram_size);
+        }
+    };
+    // '%' and '_' are wildcards, '\\' escapes the next char
+    std::string literal;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i];
+        if (c == '\\' && i + 1 < pattern.size()) {
+            literal.push_back(pattern[++i]);
+        } else if (c == '%' || c == '_') {
+            add_grams(literal);
+            literal.clear();
+        } else {
+            literal.push_back(c);
+        }
+    }
+    add_grams(literal);
+}
+
 Status BloomFilterIndexReader::load(bool use_page_cache, bool kept_in_memory) {
     const IndexedColumnMetaPB& bf_index_meta = _bloom_filter_index_meta->bloom_filter();
 
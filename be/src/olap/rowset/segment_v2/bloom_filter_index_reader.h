@@ -19,6 +19,8 @@
 
 #include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/segment_v2.pb.h"
@@ -39,6 +41,12 @@ class IndexedColumnReader;
 class IndexedColumnIterator;
 class BloomFilter;
 
+// Append the grams which must be contained by the values matching the LIKE pattern,
+// that is all the `gram_size` bytes substrings of the literal parts of the pattern.
+// Nothing is appended if no literal part is as long as `gram_size`.
+void get_like_pattern_ngrams(const std::string& pattern, size_t gram_size,
+                             std::vector<std::string>* grams);
+
 class BloomFilterIndexReader {
 public:
     explicit BloomFilterIndexReader(const FilePathDesc& path_desc,
@@ -28,6 +28,7 @@
 #include "olap/rowset/segment_v2/indexed_column_writer.h"
 #include "olap/types.h"
 #include "runtime/mem_pool.h"
+#include "util/bit_util.h"
 #include "util/faststring.h"
 #include "util/slice.h"
 
@@ -170,8 +171,99 @@ private:
     std::vector<std::unique_ptr<BloomFilter>> _bfs;
 };
 
+// Builder for ngram bloom filter, all the grams of values of a data page are added
+// to a fixed size bloom filter. The values shorter than gram size are not added, because
+// the LIKE patterns which can be checked by the index have at least one gram.
+class NGramBloomFilterIndexWriterImpl : public BloomFilterIndexWriter {
+public:
+    NGramBloomFilterIndexWriterImpl(int32_t gram_size, int32_t bf_size)
+            : _gram_size(gram_size), _bf_size(bf_size) {}
+
+    ~NGramBloomFilterIndexWriterImpl() override = default;
+
+    void add_values(const void* values, size_t count) override {
+        const Slice* v = (const Slice*)values;
+        for (int i = 0; i < count; ++i, ++v) {
+            if (v->size < _gram_size) {
+                continue;
+            }
+            for (size_t pos = 0; pos + _gram_size <= v->size; ++pos) {
+                _bf->add_bytes(v->data + pos, _gram_size);
+            }
+        }
+    }
+
+    void add_nulls(uint32_t count) override {}
+
+    Status init() {
+        RETURN_IF_ERROR(BloomFilter::create(BLOCK_BLOOM_FILTER, &_bf));
+        return _bf->init(_bf_size, HASH_MURMUR3_X64_64);
+    }
+
+    Status flush() override {
+        _bf_buffer_size += _bf->size();
+        _bfs.push_back(std::move(_bf));
+        return init();
+    }
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) override {
+        index_meta->set_type(NGRAM_BLOOM_FILTER_INDEX);
+        BloomFilterIndexPB* meta = index_meta->mutable_ngram_bloom_filter_index();
+        meta->set_hash_strategy(HASH_MURMUR3_X64_64);
+        meta->set_algorithm(BLOCK_BLOOM_FILTER);
+        meta->set_gram_size(_gram_size);
+
+        const auto* bf_type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = true;
+        options.write_value_index = false;
+        options.encoding = PLAIN_ENCODING;
+        IndexedColumnWriter bf_writer(options, bf_type_info, wblock);
+        RETURN_IF_ERROR(bf_writer.init());
+        for (auto& bf : _bfs) {
+            Slice data(bf->data(), bf->size());
+            bf_writer.add(&data);
+        }
+        RETURN_IF_ERROR(bf_writer.finish(meta->mutable_bloom_filter()));
+        return Status::OK();
+    }
+
+    uint64_t size() override { return _bf_buffer_size + _bf_size; }
+
+private:
+    const size_t _gram_size;
+    const uint32_t _bf_size;
+    uint64_t _bf_buffer_size = 0;
+    // bloom filter of current page
+    std::unique_ptr<BloomFilter> _bf;
+    std::vector<std::unique_ptr<BloomFilter>> _bfs;
+};
+
 } // namespace
 
+Status BloomFilterIndexWriter::create_ngram(int32_t gram_size, int32_t bf_size,
+                                            const TypeInfo* type_info,
+                                            std::unique_ptr<BloomFilterIndexWriter>* res) {
+    FieldType type = type_info->type();
+    if (type != OLAP_FIELD_TYPE_CHAR && type != OLAP_FIELD_TYPE_VARCHAR &&
+        type != OLAP_FIELD_TYPE_STRING) {
+        return Status::NotSupported("unsupported type for ngram bloom filter index: " +
+                                    std::to_string(type));
+    }
+    if (gram_size <= 0) {
+        return Status::InvalidArgument("invalid gram size of ngram bloom filter index: " +
+                                       std::to_string(gram_size));
+    }
+    // the block bloom filter requires the size is power of 2
+    int64_t num_bytes = BitUtil::RoundUpToPowerOfTwo(
+            std::max<int64_t>(bf_size, BloomFilter::MINIMUM_BYTES));
+    num_bytes = std::min<int64_t>(num_bytes, BloomFilter::MAXIMUM_BYTES);
+    auto writer = std::make_unique<NGramBloomFilterIndexWriterImpl>(gram_size, num_bytes);
+    RETURN_IF_ERROR(writer->init());
+    *res = std::move(writer);
+    return Status::OK();
+}
+
 // TODO currently we don't support bloom filter index for tinyint/hll/float/double
 Status BloomFilterIndexWriter::create(const BloomFilterOptions& bf_options,
                                       const TypeInfo* type_info,
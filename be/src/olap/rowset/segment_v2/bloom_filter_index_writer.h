@@ -41,6 +41,12 @@ public:
     static Status create(const BloomFilterOptions& bf_options, const TypeInfo* type_info,
                          std::unique_ptr<BloomFilterIndexWriter>* res);
 
+    // Create the writer of ngram bloom filter index, which adds all the `gram_size` bytes
+    // substrings of the values to a `bf_size` bytes bloom filter per page. It's used to
+    // skip the pages for LIKE '%substr%', only string types are supported.
+    static Status create_ngram(int32_t gram_size, int32_t bf_size, const TypeInfo* type_info,
+                               std::unique_ptr<BloomFilterIndexWriter>* res);
+
     BloomFilterIndexWriter() = default;
     virtual ~BloomFilterIndexWriter() = default;
 
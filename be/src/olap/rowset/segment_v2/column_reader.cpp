@@ -17,16 +17,26 @@
 
 #include "olap/rowset/segment_v2/column_reader.h"
 
+#include <algorithm>
+
 #include "common/logging.h"
+#include "common/config.h"
 #include "gutil/strings/substitute.h"                // for Substitute
 #include "olap/column_block.h"                       // for ColumnBlockView
+#include "olap/hll.h"
+#include "olap/page_cache.h"
 #include "olap/rowset/segment_v2/binary_dict_page.h" // for BinaryDictPageDecoder
 #include "olap/rowset/segment_v2/bloom_filter_index_reader.h"
 #include "olap/rowset/segment_v2/encoding_info.h" // for EncodingInfo
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
 #include "olap/rowset/segment_v2/page_handle.h"   // for PageHandle
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/page_prefetcher.h"
 #include "olap/rowset/segment_v2/page_pointer.h" // for PagePointer
+#include "olap/storage_engine.h"
 #include "olap/types.h"                          // for TypeInfo
+#include "olap/wrapper_field.h"
+#include "runtime/mem_pool.h"
 #include "util/block_compression.h"
 #include "util/coding.h"       // for get_varint32
 #include "util/rle_encoding.h" // for RleDecoder
@@ -105,6 +115,12 @@ Status ColumnReader::init() {
     }
     RETURN_IF_ERROR(EncodingInfo::get(_type_info.get(), _meta.encoding(), &_encoding_info));
     RETURN_IF_ERROR(get_block_compression_codec(_meta.compression(), &_compress_codec));
+    if (_meta.has_compression_dict()) {
+        // the dictionary is loaded once, and shared by all iterators of the column
+        RETURN_IF_ERROR(get_block_compression_codec(_meta.compression(), _meta.compression_dict(),
+                                                    &_dict_compress_codec));
+        _compress_codec = _dict_compress_codec.get();
+    }
 
     for (int i = 0; i < _meta.indexes_size(); i++) {
         auto& index_meta = _meta.indexes(i);
@@ -121,6 +137,12 @@ Status ColumnReader::init() {
         case BLOOM_FILTER_INDEX:
             _bf_index_meta = &index_meta.bloom_filter_index();
             break;
+        case NGRAM_BLOOM_FILTER_INDEX:
+            _ngram_bf_index_meta = &index_meta.ngram_bloom_filter_index();
+            break;
+        case INVERTED_INDEX:
+            _inverted_index_meta = &index_meta.inverted_index();
+            break;
         default:
             return Status::Corruption(
                     strings::Substitute("Bad file $0: invalid column index type $1",
@@ -143,6 +165,12 @@ Status ColumnReader::new_bitmap_index_iterator(BitmapIndexIterator** iterator) {
     return Status::OK();
 }
 
+Status ColumnReader::new_inverted_index_iterator(BitmapIndexIterator** iterator) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    RETURN_IF_ERROR(_inverted_index->new_iterator(iterator));
+    return Status::OK();
+}
+
 Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const PagePointer& pp,
                                PageHandle* handle, Slice* page_body, PageFooterPB* footer) {
     iter_opts.sanity_check();
@@ -153,6 +181,7 @@ Status ColumnReader::read_page(const ColumnIteratorOptions& iter_opts, const Pag
     opts.stats = iter_opts.stats;
     opts.verify_checksum = _opts.verify_checksum;
     opts.use_page_cache = iter_opts.use_page_cache;
+    opts.bypass_page_cache_admission = iter_opts.bypass_page_cache_admission;
     opts.kept_in_memory = _opts.kept_in_memory;
     opts.type = iter_opts.type;
 
@@ -220,16 +249,17 @@ bool ColumnReader::_zone_map_match_condition(const ZoneMapPB& zone_map,
 Status ColumnReader::_get_filtered_pages(CondColumn* cond_column, CondColumn* delete_condition,
                                          std::vector<uint32_t>* page_indexes) {
     FieldType type = _type_info->type();
-    const std::vector<ZoneMapPB>& zone_maps = _zone_map_index->page_zone_maps();
     int32_t page_size = _zone_map_index->num_pages();
     std::unique_ptr<WrapperField> min_value(WrapperField::create_by_type(type, _meta.length()));
     std::unique_ptr<WrapperField> max_value(WrapperField::create_by_type(type, _meta.length()));
+    ZoneMapPB zone_map;
     for (int32_t i = 0; i < page_size; ++i) {
-        if (zone_maps[i].pass_all()) {
+        RETURN_IF_ERROR(_zone_map_index->page_zone_map(i, &zone_map));
+        if (zone_map.pass_all()) {
             page_indexes->push_back(i);
         } else {
-            _parse_zone_map(zone_maps[i], min_value.get(), max_value.get());
-            if (_zone_map_match_condition(zone_maps[i], min_value.get(), max_value.get(),
+            _parse_zone_map(zone_map, min_value.get(), max_value.get());
+            if (_zone_map_match_condition(zone_map, min_value.get(), max_value.get(),
                                           cond_column)) {
                 bool should_read = true;
                 if (delete_condition != nullptr) {
@@ -267,24 +297,45 @@ Status ColumnReader::get_row_ranges_by_bloom_filter(CondColumn* cond_column,
     RowRanges bf_row_ranges;
     std::unique_ptr<BloomFilterIndexIterator> bf_iter;
     RETURN_IF_ERROR(_bloom_filter_index->new_iterator(&bf_iter));
-    size_t range_size = row_ranges->range_size();
-    // get covered page ids
     std::set<uint32_t> page_ids;
-    for (int i = 0; i < range_size; ++i) {
-        int64_t from = row_ranges->get_range_from(i);
-        int64_t idx = from;
-        int64_t to = row_ranges->get_range_to(i);
-        auto iter = _ordinal_index->seek_at_or_before(from);
-        while (idx < to && iter.valid()) {
-            page_ids.insert(iter.page_index());
-            idx = iter.last_ordinal() + 1;
-            iter.next();
+    _get_covered_page_ids(*row_ranges, &page_ids);
+    for (auto& pid : page_ids) {
+        std::unique_ptr<BloomFilter> bf;
+        RETURN_IF_ERROR(bf_iter->read_bloom_filter(pid, &bf));
+        if (cond_column->eval(bf.get())) {
+            bf_row_ranges.add(RowRange(_ordinal_index->get_first_ordinal(pid),
+                                       _ordinal_index->get_last_ordinal(pid) + 1));
         }
     }
+    RowRanges::ranges_intersection(*row_ranges, bf_row_ranges, row_ranges);
+    return Status::OK();
+}
+
+Status ColumnReader::get_row_ranges_by_ngram_bloom_filter(
+        const std::vector<std::string>& like_patterns, RowRanges* row_ranges) {
+    RETURN_IF_ERROR(_ensure_index_loaded());
+    size_t gram_size = _ngram_bf_index_meta->gram_size();
+    std::vector<std::string> grams;
+    for (auto& pattern : like_patterns) {
+        get_like_pattern_ngrams(pattern, gram_size, &grams);
+    }
+    if (grams.empty()) {
+        // no literal substring is long enough to be checked
+        return Status::OK();
+    }
+
+    RowRanges bf_row_ranges;
+    std::unique_ptr<BloomFilterIndexIterator> bf_iter;
+    RETURN_IF_ERROR(_ngram_bloom_filter_index->new_iterator(&bf_iter));
+    std::set<uint32_t> page_ids;
+    _get_covered_page_ids(*row_ranges, &page_ids);
     for (auto& pid : page_ids) {
         std::unique_ptr<BloomFilter> bf;
         RETURN_IF_ERROR(bf_iter->read_bloom_filter(pid, &bf));
-        if (cond_column->eval(bf.get())) {
+        bool may_match = std::all_of(grams.begin(), grams.end(), [&](std::string& gram) {
+            return bf->test_bytes(gram.data(), gram.size());
+        });
+        if (may_match) {
             bf_row_ranges.add(RowRange(_ordinal_index->get_first_ordinal(pid),
                                        _ordinal_index->get_last_ordinal(pid) + 1));
         }
@@ -293,12 +344,67 @@ Status ColumnReader::get_row_ranges_by_bloom_filter(CondColumn* cond_column,
     return Status::OK();
 }
 
+void ColumnReader::_get_covered_page_ids(const RowRanges& row_ranges,
+                                         std::set<uint32_t>* page_ids) const {
+    size_t range_size = row_ranges.range_size();
+    for (int i = 0; i < range_size; ++i) {
+        int64_t from = row_ranges.get_range_from(i);
+        int64_t idx = from;
+        int64_t to = row_ranges.get_range_to(i);
+        auto iter = _ordinal_index->seek_at_or_before(from);
+        while (idx < to && iter.valid()) {
+            page_ids->insert(iter.page_index());
+            idx = iter.last_ordinal() + 1;
+            iter.next();
+        }
+    }
+}
+
+size_t ColumnReader::index_mem_usage() const {
+    size_t bytes = 0;
+    if (_ordinal_index_meta != nullptr && !_ordinal_index_meta->root_page().is_root_data_page()) {
+        bytes += _ordinal_index_meta->root_page().root_page().size();
+    }
+    if (_zone_map_index_meta != nullptr) {
+        bytes += _zone_map_index_meta->page_zone_maps().size();
+    }
+    for (auto& sub_reader : _sub_readers) {
+        bytes += sub_reader->index_mem_usage();
+    }
+    return bytes;
+}
+
 Status ColumnReader::_load_ordinal_index(bool use_page_cache, bool kept_in_memory) {
     DCHECK(_ordinal_index_meta != nullptr);
     _ordinal_index.reset(new OrdinalIndexReader(_path_desc, _ordinal_index_meta, _num_rows));
     return _ordinal_index->load(use_page_cache, kept_in_memory);
 }
 
+Status ColumnReader::merge_ndv_sketch(HyperLogLog* sketch, bool* has_sketch) const {
+    *has_sketch = _meta.has_ndv_sketch();
+    if (!*has_sketch) {
+        return Status::OK();
+    }
+    IndexedColumnReader sketch_reader(_path_desc, _meta.ndv_sketch());
+    RETURN_IF_ERROR(sketch_reader.load(!config::disable_storage_page_cache, false));
+    IndexedColumnIterator sketch_iter(&sketch_reader);
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    RETURN_IF_ERROR(ColumnVectorBatch::create(1, false, sketch_reader.type_info(), nullptr, &cvb));
+    MemPool pool("NdvSketch");
+    ColumnBlock block(cvb.get(), &pool);
+    ColumnBlockView column_block_view(&block);
+    RETURN_IF_ERROR(sketch_iter.seek_to_ordinal(0));
+    size_t num_read = 1;
+    RETURN_IF_ERROR(sketch_iter.next_batch(&num_read, &column_block_view));
+    HyperLogLog segment_sketch;
+    const auto* value = reinterpret_cast<const Slice*>(cvb->data());
+    if (num_read != 1 || !segment_sketch.deserialize(*value)) {
+        return Status::Corruption("invalid ndv sketch");
+    }
+    sketch->merge(segment_sketch);
+    return Status::OK();
+}
+
 Status ColumnReader::_load_zone_map_index(bool use_page_cache, bool kept_in_memory) {
     if (_zone_map_index_meta != nullptr) {
         _zone_map_index.reset(new ZoneMapIndexReader(_path_desc, _zone_map_index_meta));
@@ -323,6 +429,24 @@ Status ColumnReader::_load_bloom_filter_index(bool use_page_cache, bool kept_in_
     return Status::OK();
 }
 
+Status ColumnReader::_load_ngram_bloom_filter_index(bool use_page_cache, bool kept_in_memory) {
+    if (_ngram_bf_index_meta != nullptr) {
+        _ngram_bloom_filter_index.reset(
+                new BloomFilterIndexReader(_path_desc, _ngram_bf_index_meta));
+        return _ngram_bloom_filter_index->load(use_page_cache, kept_in_memory);
+    }
+    return Status::OK();
+}
+
+Status ColumnReader::_load_inverted_index(bool use_page_cache, bool kept_in_memory) {
+    if (_inverted_index_meta != nullptr) {
+        _inverted_index.reset(
+                new BitmapIndexReader(_path_desc, &_inverted_index_meta->postings()));
+        return _inverted_index->load(use_page_cache, kept_in_memory);
+    }
+    return Status::OK();
+}
+
 Status ColumnReader::seek_to_first(OrdinalPageIndexIterator* iter) {
     RETURN_IF_ERROR(_ensure_index_loaded());
     *iter = _ordinal_index->begin();
@@ -341,6 +465,24 @@ Status ColumnReader::seek_at_or_before(ordinal_t ordinal, OrdinalPageIndexIterat
     return Status::OK();
 }
 
+Status ColumnReader::new_constant_iterator(ColumnIterator** iterator) {
+    *iterator = nullptr;
+    if (_zone_map_index_meta == nullptr ||
+        !ConstantColumnIterator::is_supported(_type_info->type())) {
+        return Status::OK();
+    }
+    const ZoneMapPB& zone_map = _zone_map_index_meta->segment_zone_map();
+    if (zone_map.pass_all() || zone_map.has_null() || !zone_map.has_not_null() ||
+        zone_map.min() != zone_map.max()) {
+        return Status::OK();
+    }
+    std::unique_ptr<WrapperField> value(
+            WrapperField::create_by_type(_type_info->type(), _meta.length()));
+    RETURN_IF_ERROR(value->from_string(zone_map.min()));
+    *iterator = new ConstantColumnIterator(this, value->cell_ptr(), _type_info->size());
+    return Status::OK();
+}
+
 Status ColumnReader::new_iterator(ColumnIterator** iterator) {
     if (is_empty()) {
         *iterator = new EmptyFileColumnIterator();
@@ -467,6 +609,19 @@ FileColumnIterator::FileColumnIterator(ColumnReader* reader) : _reader(reader) {
 
 FileColumnIterator::~FileColumnIterator() {}
 
+Status FileColumnIterator::init(const ColumnIteratorOptions& opts) {
+    _opts = opts;
+    int32_t depth = config::column_page_prefetch_depth;
+    if (_opts.prefetch_budget != nullptr && depth > 0 && StorageEngine::instance() != nullptr) {
+        ThreadPool* pool = StorageEngine::instance()->page_prefetch_thread_pool();
+        if (pool != nullptr) {
+            _prefetcher = std::make_unique<PagePrefetcher>(_reader, _opts, pool,
+                                                           _opts.prefetch_budget, depth);
+        }
+    }
+    return Status::OK();
+}
+
 Status FileColumnIterator::seek_to_first() {
     RETURN_IF_ERROR(_reader->seek_to_first(&_page_iter));
     RETURN_IF_ERROR(_read_data_page(_page_iter));
@@ -653,11 +808,43 @@ Status FileColumnIterator::_read_data_page(const OrdinalPageIndexIterator& iter)
     Slice page_body;
     PageFooterPB footer;
     _opts.type = DATA_PAGE;
-    RETURN_IF_ERROR(_reader->read_page(_opts, iter.page(), &handle, &page_body, &footer));
+    Status prefetch_status;
+    if (_prefetcher != nullptr && _prefetcher->take(iter.page_index(), &prefetch_status,
+                                                    &handle, &page_body, &footer)) {
+        RETURN_IF_ERROR(prefetch_status);
+    } else {
+        RETURN_IF_ERROR(_reader->read_page(_opts, iter.page(), &handle, &page_body, &footer));
+    }
+    if (_prefetcher != nullptr) {
+        _prefetcher->prefetch_after(iter);
+    }
+
+    // the data pages decoded before are read from the decoded page cache, so the values are
+    // not decoded (e.g. unshuffled) again
+    auto page_cache = StoragePageCache::instance();
+    auto encoding = _reader->encoding_info()->encoding();
+    bool use_decoded_cache = _opts.use_page_cache && page_cache->is_decoded_cache_available() &&
+                             (encoding == BIT_SHUFFLE || encoding == DICT_ENCODING);
+    StoragePageCache::CacheKey decoded_key(_opts.rblock->path_desc().filepath,
+                                           iter.page().offset);
+    PageCacheHandle decoded_handle;
+    bool decoded_cached =
+            use_decoded_cache && page_cache->lookup_decoded(decoded_key, &decoded_handle);
+
     // parse data page
     RETURN_IF_ERROR(ParsedPage::create(std::move(handle), page_body, footer.data_page_footer(),
                                        _reader->encoding_info(), iter.page(), iter.page_index(),
-                                       &_page));
+                                       &_page, std::move(decoded_handle)));
+    if (use_decoded_cache && !decoded_cached) {
+        Slice values = _page.data_decoder->decoded_values();
+        size_t max_page_bytes = config::decoded_page_cache_max_page_bytes;
+        if (values.size > 0 && values.size <= max_page_bytes) {
+            std::unique_ptr<uint8_t[]> buf(new uint8_t[values.size]);
+            memcpy(buf.get(), values.data, values.size);
+            page_cache->insert_decoded(decoded_key, Slice(buf.release(), values.size),
+                                       &decoded_handle);
+        }
+    }
 
     // dictionary page is read when the first data page that uses it is read,
     // this is to optimize the memory usage: when there is no query on one column, we could
@@ -709,6 +896,14 @@ Status FileColumnIterator::get_row_ranges_by_bloom_filter(CondColumn* cond_colum
     return Status::OK();
 }
 
+Status FileColumnIterator::get_row_ranges_by_ngram_bloom_filter(
+        const std::vector<std::string>& like_patterns, RowRanges* row_ranges) {
+    if (_reader->has_ngram_bloom_filter_index()) {
+        RETURN_IF_ERROR(_reader->get_row_ranges_by_ngram_bloom_filter(like_patterns, row_ranges));
+    }
+    return Status::OK();
+}
+
 Status DefaultValueColumnIterator::init(const ColumnIteratorOptions& opts) {
     _opts = opts;
     // be consistent with segment v1
@@ -847,5 +1042,78 @@ Status DefaultValueColumnIterator::next_batch(size_t* n, vectorized::MutableColu
     return Status::OK();
 }
 
+ConstantColumnIterator::ConstantColumnIterator(ColumnReader* reader, const void* value,
+                                               size_t type_size)
+        : _reader(reader), _type_size(type_size), _values(BATCH_SIZE * type_size) {
+    for (size_t i = 0; i < BATCH_SIZE; ++i) {
+        memcpy(_values.data() + i * _type_size, value, _type_size);
+    }
+}
+
+// the floating points are excluded since their zone maps are rounded, and the strings since
+// their zone maps are truncated
+bool ConstantColumnIterator::is_supported(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_BOOL:
+    case OLAP_FIELD_TYPE_TINYINT:
+    case OLAP_FIELD_TYPE_SMALLINT:
+    case OLAP_FIELD_TYPE_INT:
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_LARGEINT:
+    case OLAP_FIELD_TYPE_DATE:
+    case OLAP_FIELD_TYPE_DATETIME:
+    case OLAP_FIELD_TYPE_DECIMAL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Status ConstantColumnIterator::seek_to_ordinal(ordinal_t ord) {
+    if (ord > _reader->num_rows()) {
+        return Status::InternalError(strings::Substitute(
+                "seek to ordinal $0 of a column of $1 rows", ord, _reader->num_rows()));
+    }
+    _current_ordinal = ord;
+    return Status::OK();
+}
+
+Status ConstantColumnIterator::next_batch(size_t* n, ColumnBlockView* dst, bool* has_null) {
+    *n = std::min<uint64_t>(*n, _reader->num_rows() - _current_ordinal);
+    *has_null = false;
+    if (dst->is_nullable()) {
+        dst->set_null_bits(*n, false);
+    }
+    for (size_t i = 0; i < *n; ++i) {
+        memcpy(dst->data(), _values.data(), _type_size);
+        dst->advance(1);
+    }
+    _current_ordinal += *n;
+    return Status::OK();
+}
+
+Status ConstantColumnIterator::next_batch(size_t* n, vectorized::MutableColumnPtr& dst,
+                                          bool* has_null) {
+    *n = std::min<uint64_t>(*n, _reader->num_rows() - _current_ordinal);
+    *has_null = false;
+    for (size_t inserted = 0; inserted < *n;) {
+        size_t count = std::min(*n - inserted, BATCH_SIZE);
+        dst->insert_many_fix_len_data(_values.data(), count);
+        inserted += count;
+    }
+    _current_ordinal += *n;
+    return Status::OK();
+}
+
+Status ConstantColumnIterator::get_row_ranges_by_zone_map(CondColumn* cond_column,
+                                                          CondColumn* delete_condition,
+                                                          RowRanges* row_ranges) {
+    if (delete_condition != nullptr) {
+        RETURN_IF_ERROR(
+                _reader->get_row_ranges_by_zone_map(nullptr, delete_condition, row_ranges));
+    }
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
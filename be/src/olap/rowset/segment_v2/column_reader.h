@@ -20,6 +20,9 @@
 #include <cstddef> // for size_t
 #include <cstdint> // for uint32_t
 #include <memory>  // for unique_ptr
+#include <set>
+#include <string>
+#include <vector>
 
 #include "common/logging.h"
 #include "common/status.h"                              // for Status
@@ -42,6 +45,7 @@ class ColumnBlock;
 class TypeInfo;
 class BlockCompressionCodec;
 class WrapperField;
+class HyperLogLog;
 
 namespace fs {
 class ReadableBlock;
@@ -54,6 +58,8 @@ class PageHandle;
 struct PagePointer;
 class ColumnIterator;
 class BloomFilterIndexReader;
+class PagePrefetchBudget;
+class PagePrefetcher;
 
 struct ColumnReaderOptions {
     // whether verify checksum when read page
@@ -67,6 +73,11 @@ struct ColumnIteratorOptions {
     // reader statistics
     OlapReaderStatistics* stats = nullptr;
     bool use_page_cache = false;
+    bool bypass_page_cache_admission = false;
+    // read ahead the data pages within this budget, no read-ahead if it's nullptr
+    PagePrefetchBudget* prefetch_budget = nullptr;
+    // the rows to read, only the pages of these rows are read ahead. all rows if it's nullptr
+    const roaring::Roaring* row_bitmap = nullptr;
     // for page cache allocation
     // page types are divided into DATA_PAGE & INDEX_PAGE
     // INDEX_PAGE including index_page, dict_page and short_key_page
@@ -94,8 +105,15 @@ public:
 
     // create a new column iterator. Client should delete returned iterator
     Status new_iterator(ColumnIterator** iterator);
+    // Create a ConstantColumnIterator if all the rows of the segment have the same non-null
+    // value by the zone map of the segment, otherwise *iterator is nullptr.
+    // Client should delete returned iterator
+    Status new_constant_iterator(ColumnIterator** iterator);
     // Client should delete returned iterator
     Status new_bitmap_index_iterator(BitmapIndexIterator** iterator);
+    // Iterator over the term dictionary and posting lists of inverted index.
+    // Client should delete returned iterator
+    Status new_inverted_index_iterator(BitmapIndexIterator** iterator);
 
     // Seek to the first entry in the column.
     Status seek_to_first(OrdinalPageIndexIterator* iter);
@@ -112,12 +130,30 @@ public:
     bool has_zone_map() const { return _zone_map_index_meta != nullptr; }
     bool has_bitmap_index() const { return _bitmap_index_meta != nullptr; }
     bool has_bloom_filter_index() const { return _bf_index_meta != nullptr; }
+    bool has_ngram_bloom_filter_index() const { return _ngram_bf_index_meta != nullptr; }
+    bool has_inverted_index() const { return _inverted_index_meta != nullptr; }
+    const std::string& inverted_index_parser() const { return _inverted_index_meta->parser(); }
 
     // Check if this column could match `cond' using segment zone map.
     // Since segment zone map is stored in metadata, this function is fast without I/O.
     // Return true if segment zone map is absent or `cond' could be satisfied, false otherwise.
     bool match_condition(CondColumn* cond) const;
 
+    // Merge the HyperLogLog of the values of the column into `sketch`, set `*has_sketch` to
+    // false if the column has no ndv sketch.
+    Status merge_ndv_sketch(HyperLogLog* sketch, bool* has_sketch) const;
+
+    // The bytes of the ordinal and the zone map indexes of the column (and its sub columns) once
+    // they are loaded, estimated by the sizes of their pages, which are close to the loaded
+    // compact forms. They are loaded on the first access, the estimate is known before that.
+    size_t index_mem_usage() const;
+
+    // the zone map of the whole segment, nullptr if the column has no zone map
+    const ZoneMapPB* segment_zone_map() const {
+        return _zone_map_index_meta == nullptr ? nullptr
+                                               : &_zone_map_index_meta->segment_zone_map();
+    }
+
     // get row ranges with zone map
     // - cond_column is user's query predicate
     // - delete_condition is a delete predicate of one version
@@ -127,9 +163,15 @@ public:
     // get row ranges with bloom filter index
     Status get_row_ranges_by_bloom_filter(CondColumn* cond_column, RowRanges* row_ranges);
 
+    // get row ranges with ngram bloom filter index, the pages which can't match all the
+    // LIKE patterns are skipped
+    Status get_row_ranges_by_ngram_bloom_filter(const std::vector<std::string>& like_patterns,
+                                                RowRanges* row_ranges);
+
     PagePointer get_dict_page_pointer() const { return _meta.dict_page(); }
 
     bool is_empty() const { return _num_rows == 0; }
+    uint64_t num_rows() const { return _num_rows; }
 
 private:
     ColumnReader(const ColumnReaderOptions& opts, const ColumnMetaPB& meta, uint64_t num_rows,
@@ -145,6 +187,9 @@ private:
             RETURN_IF_ERROR(_load_ordinal_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bitmap_index(use_page_cache, _opts.kept_in_memory));
             RETURN_IF_ERROR(_load_bloom_filter_index(use_page_cache, _opts.kept_in_memory));
+            RETURN_IF_ERROR(
+                    _load_ngram_bloom_filter_index(use_page_cache, _opts.kept_in_memory));
+            RETURN_IF_ERROR(_load_inverted_index(use_page_cache, _opts.kept_in_memory));
             return Status::OK();
         });
     }
@@ -153,6 +198,8 @@ private:
     Status _load_ordinal_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bitmap_index(bool use_page_cache, bool kept_in_memory);
     Status _load_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
+    Status _load_ngram_bloom_filter_index(bool use_page_cache, bool kept_in_memory);
+    Status _load_inverted_index(bool use_page_cache, bool kept_in_memory);
 
     bool _zone_map_match_condition(const ZoneMapPB& zone_map, WrapperField* min_value_container,
                                    WrapperField* max_value_container, CondColumn* cond) const;
@@ -165,6 +212,9 @@ private:
 
     Status _calculate_row_ranges(const std::vector<uint32_t>& page_indexes, RowRanges* row_ranges);
 
+    // get the ids of the pages covered by row_ranges
+    void _get_covered_page_ids(const RowRanges& row_ranges, std::set<uint32_t>* page_ids) const;
+
 private:
     ColumnMetaPB _meta;
     ColumnReaderOptions _opts;
@@ -176,18 +226,25 @@ private:
     const EncodingInfo* _encoding_info =
             nullptr; // initialized in init(), used for create PageDecoder
     const BlockCompressionCodec* _compress_codec = nullptr; // initialized in init()
+    // the codec with the dictionary stored in the column meta, owned by the reader
+    std::unique_ptr<BlockCompressionCodec> _dict_compress_codec;
 
     // meta for various column indexes (null if the index is absent)
     const ZoneMapIndexPB* _zone_map_index_meta = nullptr;
     const OrdinalIndexPB* _ordinal_index_meta = nullptr;
     const BitmapIndexPB* _bitmap_index_meta = nullptr;
     const BloomFilterIndexPB* _bf_index_meta = nullptr;
+    const BloomFilterIndexPB* _ngram_bf_index_meta = nullptr;
+    const InvertedIndexPB* _inverted_index_meta = nullptr;
 
     DorisCallOnce<Status> _load_index_once;
     std::unique_ptr<ZoneMapIndexReader> _zone_map_index;
     std::unique_ptr<OrdinalIndexReader> _ordinal_index;
     std::unique_ptr<BitmapIndexReader> _bitmap_index;
     std::unique_ptr<BloomFilterIndexReader> _bloom_filter_index;
+    std::unique_ptr<BloomFilterIndexReader> _ngram_bloom_filter_index;
+    // inverted index shares the layout of bitmap index
+    std::unique_ptr<BitmapIndexReader> _inverted_index;
 
     std::vector<std::unique_ptr<ColumnReader>> _sub_readers;
 };
@@ -242,6 +299,11 @@ public:
         return Status::OK();
     }
 
+    virtual Status get_row_ranges_by_ngram_bloom_filter(
+            const std::vector<std::string>& like_patterns, RowRanges* row_ranges) {
+        return Status::OK();
+    }
+
 protected:
     ColumnIteratorOptions _opts;
 };
@@ -253,6 +315,8 @@ public:
     explicit FileColumnIterator(ColumnReader* reader);
     ~FileColumnIterator() override;
 
+    Status init(const ColumnIteratorOptions& opts) override;
+
     Status seek_to_first() override;
 
     Status seek_to_ordinal(ordinal_t ord) override;
@@ -273,6 +337,9 @@ public:
 
     Status get_row_ranges_by_bloom_filter(CondColumn* cond_column, RowRanges* row_ranges) override;
 
+    Status get_row_ranges_by_ngram_bloom_filter(const std::vector<std::string>& like_patterns,
+                                                RowRanges* row_ranges) override;
+
     ParsedPage* get_current_page() { return &_page; }
 
     bool is_nullable() { return _reader->is_nullable(); }
@@ -304,6 +371,9 @@ private:
     ordinal_t _current_ordinal = 0;
 
     std::unique_ptr<StringRef[]> _dict_word_info;
+
+    // read ahead the data pages after the current page, nullptr if read-ahead is disabled
+    std::unique_ptr<PagePrefetcher> _prefetcher;
 };
 
 class EmptyFileColumnIterator final : public ColumnIterator {
@@ -437,5 +507,44 @@ private:
     ordinal_t _current_rowid = 0;
 };
 
+// Read a column whose rows all have the same non-null value in the segment, known by the zone
+// map of the segment, without reading and decoding its pages. The value satisfies the
+// conditions of the column once the segment isn't pruned by its zone map, so only the delete
+// conditions are checked by the page zone maps.
+class ConstantColumnIterator final : public ColumnIterator {
+public:
+    // `value` is in the storage format of the type
+    ConstantColumnIterator(ColumnReader* reader, const void* value, size_t type_size);
+
+    // the types whose values in the zone maps are exact in the storage format
+    static bool is_supported(FieldType type);
+
+    Status seek_to_first() override {
+        _current_ordinal = 0;
+        return Status::OK();
+    }
+
+    Status seek_to_ordinal(ordinal_t ord) override;
+
+    Status next_batch(size_t* n, ColumnBlockView* dst, bool* has_null) override;
+
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst, bool* has_null) override;
+
+    ordinal_t get_current_ordinal() const override { return _current_ordinal; }
+
+    Status get_row_ranges_by_zone_map(CondColumn* cond_column, CondColumn* delete_condition,
+                                      RowRanges* row_ranges) override;
+
+private:
+    // the rows inserted into a vectorized column at a time
+    static constexpr size_t BATCH_SIZE = 1024;
+
+    ColumnReader* _reader;
+    size_t _type_size;
+    // the value repeated BATCH_SIZE times
+    std::vector<char> _values;
+    ordinal_t _current_ordinal = 0;
+};
+
 } // namespace segment_v2
 } // namespace doris
@@ -23,10 +23,13 @@
 #include "env/env.h"
 #include "gutil/strings/substitute.h"
 #include "olap/fs/block_manager.h"
+#include "olap/hll.h"
 #include "olap/rowset/segment_v2/bitmap_index_writer.h"
+#include "olap/rowset/segment_v2/inverted_index_writer.h"
 #include "olap/rowset/segment_v2/bloom_filter.h"
 #include "olap/rowset/segment_v2/bloom_filter_index_writer.h"
 #include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
 #include "olap/rowset/segment_v2/options.h"
 #include "olap/rowset/segment_v2/ordinal_page_index.h"
 #include "olap/rowset/segment_v2/page_builder.h"
@@ -34,6 +37,7 @@
 #include "olap/rowset/segment_v2/zone_map_index.h"
 #include "util/block_compression.h"
 #include "util/faststring.h"
+#include "util/hash_util.hpp"
 #include "util/rle_encoding.h"
 
 namespace doris {
@@ -265,9 +269,12 @@ ScalarColumnWriter::~ScalarColumnWriter() {
 
 Status ScalarColumnWriter::init() {
     RETURN_IF_ERROR(get_block_compression_codec(_opts.meta->compression(), &_compress_codec));
+    _training_compression_dict = _opts.train_compression_dict &&
+                                 _opts.meta->compression() == CompressionTypePB::ZSTD;
 
     PageBuilder* page_builder = nullptr;
 
+    bool adaptive_encoding = _opts.adaptive_encoding && _opts.meta->encoding() == DEFAULT_ENCODING;
     RETURN_IF_ERROR(
             EncodingInfo::get(get_field()->type_info(), _opts.meta->encoding(), &_encoding_info));
     _opts.meta->set_encoding(_encoding_info->encoding());
@@ -284,6 +291,22 @@ Status ScalarColumnWriter::init() {
     // because the default encoding of a data type can be changed in the future
     DCHECK_NE(_opts.meta->encoding(), DEFAULT_ENCODING);
     _page_builder.reset(page_builder);
+    if (adaptive_encoding) {
+        std::vector<const EncodingInfo*> candidates;
+        EncodingInfo::get_candidates(get_field()->type_info(), &candidates);
+        for (auto encoding_info : candidates) {
+            if (encoding_info == _encoding_info) {
+                continue;
+            }
+            PageBuilder* candidate_builder = nullptr;
+            if (!encoding_info->create_page_builder(opts, &candidate_builder).ok() ||
+                candidate_builder == nullptr) {
+                continue;
+            }
+            _encoding_candidates.push_back(
+                    {encoding_info, std::unique_ptr<PageBuilder>(candidate_builder)});
+        }
+    }
     // create ordinal builder
     _ordinal_index_builder.reset(new OrdinalIndexWriter());
     // create null bitmap builder
@@ -293,6 +316,9 @@ Status ScalarColumnWriter::init() {
     if (_opts.need_zone_map) {
         _zone_map_index_builder.reset(new ZoneMapIndexWriter(get_field()));
     }
+    if (_opts.need_ndv_sketch) {
+        _ndv_sketch.reset(new HyperLogLog());
+    }
     if (_opts.need_bitmap_index) {
         RETURN_IF_ERROR(
                 BitmapIndexWriter::create(get_field()->type_info(), &_bitmap_index_builder));
@@ -301,6 +327,15 @@ Status ScalarColumnWriter::init() {
         RETURN_IF_ERROR(BloomFilterIndexWriter::create(
                 BloomFilterOptions(), get_field()->type_info(), &_bloom_filter_index_builder));
     }
+    if (_opts.ngram_bf_gram_size > 0) {
+        RETURN_IF_ERROR(BloomFilterIndexWriter::create_ngram(
+                _opts.ngram_bf_gram_size, _opts.ngram_bf_size, get_field()->type_info(),
+                &_ngram_bf_index_builder));
+    }
+    if (!_opts.inverted_index_parser.empty()) {
+        RETURN_IF_ERROR(InvertedIndexWriter::create(
+                get_field()->type_info(), _opts.inverted_index_parser, &_inverted_index_builder));
+    }
     return Status::OK();
 }
 
@@ -316,6 +351,12 @@ Status ScalarColumnWriter::append_nulls(size_t num_rows) {
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_nulls(num_rows);
     }
+    if (_ngram_bf_index_builder != nullptr) {
+        _ngram_bf_index_builder->add_nulls(num_rows);
+    }
+    if (_inverted_index_builder != nullptr) {
+        _inverted_index_builder->add_nulls(num_rows);
+    }
     return Status::OK();
 }
 
@@ -339,15 +380,27 @@ Status ScalarColumnWriter::append_data(const uint8_t** ptr, size_t num_rows) {
 
 Status ScalarColumnWriter::append_data_in_current_page(const uint8_t** ptr, size_t* num_written) {
     RETURN_IF_ERROR(_page_builder->add(*ptr, num_written));
+    if (!_encoding_candidates.empty()) {
+        _add_to_encoding_candidates(*ptr, *num_written);
+    }
     if (_opts.need_zone_map) {
         _zone_map_index_builder->add_values(*ptr, *num_written);
     }
+    if (_ndv_sketch != nullptr) {
+        _add_to_ndv_sketch(*ptr, *num_written);
+    }
     if (_opts.need_bitmap_index) {
         _bitmap_index_builder->add_values(*ptr, *num_written);
     }
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_values(*ptr, *num_written);
     }
+    if (_ngram_bf_index_builder != nullptr) {
+        _ngram_bf_index_builder->add_values(*ptr, *num_written);
+    }
+    if (_inverted_index_builder != nullptr) {
+        _inverted_index_builder->add_values(*ptr, *num_written);
+    }
 
     _next_rowid += *num_written;
     *ptr += get_field()->size() * (*num_written);
@@ -361,15 +414,27 @@ Status ScalarColumnWriter::append_data_in_current_page(const uint8_t** ptr, size
 
 Status ScalarColumnWriter::append_data_in_current_page(const uint8_t* ptr, size_t* num_written) {
     RETURN_IF_ERROR(_page_builder->add(ptr, num_written));
+    if (!_encoding_candidates.empty()) {
+        _add_to_encoding_candidates(ptr, *num_written);
+    }
     if (_opts.need_zone_map) {
         _zone_map_index_builder->add_values(ptr, *num_written);
     }
+    if (_ndv_sketch != nullptr) {
+        _add_to_ndv_sketch(ptr, *num_written);
+    }
     if (_opts.need_bitmap_index) {
         _bitmap_index_builder->add_values(ptr, *num_written);
     }
     if (_opts.need_bloom_filter) {
         _bloom_filter_index_builder->add_values(ptr, *num_written);
     }
+    if (_ngram_bf_index_builder != nullptr) {
+        _ngram_bf_index_builder->add_values(ptr, *num_written);
+    }
+    if (_inverted_index_builder != nullptr) {
+        _inverted_index_builder->add_values(ptr, *num_written);
+    }
 
     _next_rowid += *num_written;
     if (is_nullable()) {
@@ -388,17 +453,29 @@ uint64_t ScalarColumnWriter::estimate_buffer_size() {
     if (_opts.need_zone_map) {
         size += _zone_map_index_builder->size();
     }
+    if (_ndv_sketch != nullptr) {
+        size += _ndv_sketch->memory_consumed();
+    }
     if (_opts.need_bitmap_index) {
         size += _bitmap_index_builder->size();
     }
     if (_opts.need_bloom_filter) {
         size += _bloom_filter_index_builder->size();
     }
+    if (_ngram_bf_index_builder != nullptr) {
+        size += _ngram_bf_index_builder->size();
+    }
+    if (_inverted_index_builder != nullptr) {
+        size += _inverted_index_builder->size();
+    }
     return size;
 }
 
 Status ScalarColumnWriter::finish() {
     RETURN_IF_ERROR(finish_current_page());
+    if (_training_compression_dict) {
+        RETURN_IF_ERROR(_train_compression_dict());
+    }
     _opts.meta->set_num_rows(_next_rowid);
     return Status::OK();
 }
@@ -434,25 +511,64 @@ Status ScalarColumnWriter::write_ordinal_index() {
 
 Status ScalarColumnWriter::write_zone_map() {
     if (_opts.need_zone_map) {
-        return _zone_map_index_builder->finish(_wblock, _opts.meta->add_indexes());
+        RETURN_IF_ERROR(_zone_map_index_builder->finish(_wblock, _opts.meta->add_indexes()));
+    }
+    // the ndv sketch is written with the zone map, they are both the statistics of the values
+    if (_ndv_sketch != nullptr) {
+        std::string sketch(_ndv_sketch->max_serialized_size(), '\0');
+        sketch.resize(_ndv_sketch->serialize(reinterpret_cast<uint8_t*>(sketch.data())));
+        IndexedColumnWriterOptions options;
+        options.write_ordinal_index = true;
+        options.write_value_index = false;
+        options.encoding = PLAIN_ENCODING;
+        IndexedColumnWriter sketch_writer(options, get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>(),
+                                          _wblock);
+        RETURN_IF_ERROR(sketch_writer.init());
+        Slice data(sketch);
+        RETURN_IF_ERROR(sketch_writer.add(&data));
+        RETURN_IF_ERROR(sketch_writer.finish(_opts.meta->mutable_ndv_sketch()));
     }
     return Status::OK();
 }
 
 Status ScalarColumnWriter::write_bitmap_index() {
     if (_opts.need_bitmap_index) {
-        return _bitmap_index_builder->finish(_wblock, _opts.meta->add_indexes());
+        RETURN_IF_ERROR(_bitmap_index_builder->finish(_wblock, _opts.meta->add_indexes()));
+    }
+    // inverted index is written with bitmap index, they share the posting list layout
+    if (_inverted_index_builder != nullptr) {
+        RETURN_IF_ERROR(_inverted_index_builder->finish(_wblock, _opts.meta->add_indexes()));
     }
     return Status::OK();
 }
 
 Status ScalarColumnWriter::write_bloom_filter_index() {
     if (_opts.need_bloom_filter) {
-        return _bloom_filter_index_builder->finish(_wblock, _opts.meta->add_indexes());
+        RETURN_IF_ERROR(_bloom_filter_index_builder->finish(_wblock, _opts.meta->add_indexes()));
+    }
+    if (_ngram_bf_index_builder != nullptr) {
+        RETURN_IF_ERROR(_ngram_bf_index_builder->finish(_wblock, _opts.meta->add_indexes()));
     }
     return Status::OK();
 }
 
+void ScalarColumnWriter::_add_to_ndv_sketch(const uint8_t* ptr, size_t num_written) {
+    auto type = get_field()->type();
+    if (type == OLAP_FIELD_TYPE_CHAR || type == OLAP_FIELD_TYPE_VARCHAR ||
+        type == OLAP_FIELD_TYPE_STRING) {
+        const auto* values = reinterpret_cast<const Slice*>(ptr);
+        for (size_t i = 0; i < num_written; ++i) {
+            _ndv_sketch->update(HashUtil::murmur_hash64A(values[i].data, values[i].size,
+                                                         HashUtil::MURMUR_SEED));
+        }
+    } else {
+        size_t size = get_field()->size();
+        for (size_t i = 0; i < num_written; ++i, ptr += size) {
+            _ndv_sketch->update(HashUtil::murmur_hash64A(ptr, size, HashUtil::MURMUR_SEED));
+        }
+    }
+}
+
 // write a data page into file and update ordinal index
 Status ScalarColumnWriter::_write_data_page(Page* page) {
     PagePointer pp;
@@ -465,6 +581,81 @@ Status ScalarColumnWriter::_write_data_page(Page* page) {
     return Status::OK();
 }
 
+void ScalarColumnWriter::_add_to_encoding_candidates(const uint8_t* ptr, size_t num_written) {
+    // a candidate which can't hold the values of the current page is dropped, so all candidates
+    // encode the same values of the first page
+    auto it = _encoding_candidates.begin();
+    while (it != _encoding_candidates.end()) {
+        size_t count = num_written;
+        if (!it->page_builder->add(ptr, &count).ok() || count != num_written) {
+            it = _encoding_candidates.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// relative cost to decode a byte of the encoded page, PLAIN_ENCODING is the cheapest
+static double encoding_decode_cost(EncodingTypePB encoding) {
+    switch (encoding) {
+    case PLAIN_ENCODING:
+        return 1.0;
+    case DICT_ENCODING:
+        return 1.1;
+    case BIT_SHUFFLE:
+    case FOR_ENCODING:
+    case DELTA_ENCODING:
+        return 1.2;
+    case DELTA_OF_DELTA_ENCODING:
+        return 1.25;
+    case RLE:
+    case ALP_ENCODING:
+        return 1.3;
+    case PREFIX_ENCODING:
+        return 2.0;
+    default:
+        return 1.5;
+    }
+}
+
+Status ScalarColumnWriter::_choose_encoding(OwnedSlice* encoded_values) {
+    // the dictionary is not in the data page, so the size of a dict page is estimated before
+    // finishing it
+    auto page_size = [](const EncodingInfo* encoding_info, const OwnedSlice& finished,
+                        uint64_t size_before_finish) {
+        if (encoding_info->encoding() == DICT_ENCODING) {
+            return std::max<uint64_t>(size_before_finish, finished.slice().size);
+        }
+        return uint64_t(finished.slice().size);
+    };
+
+    uint64_t size_before_finish = _page_builder->size();
+    *encoded_values = _page_builder->finish();
+    double best_score = page_size(_encoding_info, *encoded_values, size_before_finish) *
+                        encoding_decode_cost(_encoding_info->encoding());
+    const EncodingInfo* default_encoding_info = _encoding_info;
+    for (auto& candidate : _encoding_candidates) {
+        size_before_finish = candidate.page_builder->size();
+        OwnedSlice candidate_values = candidate.page_builder->finish();
+        double score = page_size(candidate.encoding_info, candidate_values, size_before_finish) *
+                       encoding_decode_cost(candidate.encoding_info->encoding());
+        if (score < best_score) {
+            best_score = score;
+            *encoded_values = std::move(candidate_values);
+            _encoding_info = candidate.encoding_info;
+            _page_builder.swap(candidate.page_builder);
+        }
+    }
+    _encoding_candidates.clear();
+    if (_encoding_info != default_encoding_info) {
+        _opts.meta->set_encoding(_encoding_info->encoding());
+        VLOG_DEBUG << "choose encoding " << EncodingTypePB_Name(_encoding_info->encoding())
+                   << " instead of " << EncodingTypePB_Name(default_encoding_info->encoding())
+                   << " for column " << get_field()->name();
+    }
+    return Status::OK();
+}
+
 Status ScalarColumnWriter::finish_current_page() {
     if (_next_rowid == _first_rowid) {
         return Status::OK();
@@ -479,10 +670,18 @@ Status ScalarColumnWriter::finish_current_page() {
     if (_opts.need_bloom_filter) {
         RETURN_IF_ERROR(_bloom_filter_index_builder->flush());
     }
+    if (_ngram_bf_index_builder != nullptr) {
+        RETURN_IF_ERROR(_ngram_bf_index_builder->flush());
+    }
 
     // build data page body : encoded values + [nullmap]
     std::vector<Slice> body;
-    OwnedSlice encoded_values = _page_builder->finish();
+    OwnedSlice encoded_values;
+    if (!_encoding_candidates.empty()) {
+        RETURN_IF_ERROR(_choose_encoding(&encoded_values));
+    } else {
+        encoded_values = _page_builder->finish();
+    }
     _page_builder->reset();
     body.push_back(encoded_values.slice());
 
@@ -508,8 +707,12 @@ Status ScalarColumnWriter::finish_current_page() {
     }
     // trying to compress page body
     OwnedSlice compressed_body;
-    RETURN_IF_ERROR(PageIO::compress_page_body(_compress_codec, _opts.compression_min_space_saving,
-                                               body, &compressed_body));
+    if (!_training_compression_dict) {
+        RETURN_IF_ERROR(PageIO::compress_page_body(
+                _compress_codec, _opts.compression_min_space_saving, body, &compressed_body));
+    } else {
+        _compression_dict_sample_bytes += page->footer.uncompressed_size();
+    }
     if (compressed_body.slice().empty()) {
         // page body is uncompressed
         page->data.emplace_back(std::move(encoded_values));
@@ -521,6 +724,48 @@ Status ScalarColumnWriter::finish_current_page() {
 
     _push_back_page(page.release());
     _first_rowid = _next_rowid;
+    if (_training_compression_dict &&
+        _compression_dict_sample_bytes >= config::zstd_dict_train_sample_bytes) {
+        RETURN_IF_ERROR(_train_compression_dict());
+    }
+    return Status::OK();
+}
+
+Status ScalarColumnWriter::_train_compression_dict() {
+    _training_compression_dict = false;
+    // all pages are uncompressed now
+    std::vector<Slice> samples;
+    for (Page* page = _pages.head; page != nullptr; page = page->next) {
+        for (auto& data : page->data) {
+            samples.push_back(data.slice());
+        }
+    }
+    std::string dict;
+    RETURN_IF_ERROR(train_compression_dict(_opts.meta->compression(), samples,
+                                           config::zstd_dict_max_bytes, &dict));
+    if (!dict.empty()) {
+        RETURN_IF_ERROR(get_block_compression_codec(_opts.meta->compression(), dict,
+                                                    &_dict_compress_codec));
+        _compress_codec = _dict_compress_codec.get();
+        _opts.meta->set_compression_dict(std::move(dict));
+    }
+
+    for (Page* page = _pages.head; page != nullptr; page = page->next) {
+        std::vector<Slice> body;
+        size_t body_size = 0;
+        for (auto& data : page->data) {
+            body.push_back(data.slice());
+            body_size += data.slice().size;
+        }
+        OwnedSlice compressed_body;
+        RETURN_IF_ERROR(PageIO::compress_page_body(
+                _compress_codec, _opts.compression_min_space_saving, body, &compressed_body));
+        if (!compressed_body.slice().empty()) {
+            _data_size = _data_size - body_size + compressed_body.slice().size;
+            page->data.clear();
+            page->data.emplace_back(std::move(compressed_body));
+        }
+    }
     return Status::OK();
 }
 
@@ -31,6 +31,7 @@ namespace doris {
 
 class TypeInfo;
 class BlockCompressionCodec;
+class HyperLogLog;
 
 namespace fs {
 class WritableBlock;
@@ -50,18 +51,35 @@ struct ColumnWriterOptions {
     bool need_zone_map = false;
     bool need_bitmap_index = false;
     bool need_bloom_filter = false;
+    // build ngram bloom filter index if ngram_bf_gram_size > 0
+    int32_t ngram_bf_gram_size = 0;
+    int32_t ngram_bf_size = 0;
+    // build inverted index with this parser if it's not empty
+    std::string inverted_index_parser;
+    // choose the encoding by the first data page if the encoding of meta is DEFAULT_ENCODING
+    bool adaptive_encoding = false;
+    // train a dictionary from the first data pages to compress all pages, for ZSTD only
+    bool train_compression_dict = false;
+    // build the HyperLogLog of the values, written with the zone map
+    bool need_ndv_sketch = false;
     std::string to_string() {
         std::stringstream ss;
         ss << std::boolalpha << "meta=" << meta->DebugString()
            << ", data_page_size=" << data_page_size
            << ", compression_min_space_saving = " << compression_min_space_saving
            << ", need_zone_map=" << need_zone_map << ", need_bitmap_index=" << need_bitmap_index
-           << ", need_bloom_filter" << need_bloom_filter;
+           << ", need_bloom_filter" << need_bloom_filter
+           << ", ngram_bf_gram_size=" << ngram_bf_gram_size << ", ngram_bf_size=" << ngram_bf_size
+           << ", inverted_index_parser=" << inverted_index_parser
+           << ", adaptive_encoding=" << adaptive_encoding
+           << ", train_compression_dict=" << train_compression_dict
+           << ", need_ndv_sketch=" << need_ndv_sketch;
         return ss.str();
     }
 };
 
 class BitmapIndexWriter;
+class InvertedIndexWriter;
 class EncodingInfo;
 class NullBitmapBuilder;
 class OrdinalIndexWriter;
@@ -240,6 +258,14 @@ private:
 
     Status _write_data_page(Page* page);
 
+    // feed the values added to `_page_builder` to the candidate encodings
+    void _add_to_encoding_candidates(const uint8_t* ptr, size_t num_written);
+    // finish the first page with all candidate encodings, and switch to the best one
+    Status _choose_encoding(OwnedSlice* encoded_values);
+    // train the compression dictionary from the uncompressed pages, and compress them
+    Status _train_compression_dict();
+    void _add_to_ndv_sketch(const uint8_t* ptr, size_t num_written);
+
 private:
     fs::WritableBlock* _wblock = nullptr;
     // total size of data page list
@@ -250,14 +276,30 @@ private:
     ordinal_t _first_rowid = 0;
 
     const BlockCompressionCodec* _compress_codec = nullptr;
+    // the codec with the trained dictionary, which is `_compress_codec' once it's trained
+    std::unique_ptr<BlockCompressionCodec> _dict_compress_codec;
+    // the pages are not compressed until the dictionary is trained
+    bool _training_compression_dict = false;
+    size_t _compression_dict_sample_bytes = 0;
 
     std::unique_ptr<OrdinalIndexWriter> _ordinal_index_builder;
     std::unique_ptr<ZoneMapIndexWriter> _zone_map_index_builder;
     std::unique_ptr<BitmapIndexWriter> _bitmap_index_builder;
+    std::unique_ptr<InvertedIndexWriter> _inverted_index_builder;
     std::unique_ptr<BloomFilterIndexWriter> _bloom_filter_index_builder;
+    std::unique_ptr<BloomFilterIndexWriter> _ngram_bf_index_builder;
+    std::unique_ptr<HyperLogLog> _ndv_sketch;
 
     // call before flush data page.
     FlushPageCallback* _new_page_callback = nullptr;
+
+    // page builders of the other encodings tried on the first page in adaptive encoding mode,
+    // cleared once the encoding is chosen
+    struct EncodingCandidate {
+        const EncodingInfo* encoding_info;
+        std::unique_ptr<PageBuilder> page_builder;
+    };
+    std::vector<EncodingCandidate> _encoding_candidates;
 };
 
 class ArrayColumnWriter final : public ColumnWriter, public FlushPageCallback {
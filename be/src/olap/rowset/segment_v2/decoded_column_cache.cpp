@@ -0,0 +1,388 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "olap/rowset/segment_v2/decoded_column_cache.h"
+
+#include <string_view>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "gutil/strings/substitute.h"
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/fs/fs_util.h"
+#include "olap/types.h"
+
+namespace doris {
+namespace segment_v2 {
+
+namespace {
+
+// the rows decoded by one next_batch when loading a column
+constexpr size_t kLoadBatchSize = 4096;
+// the string columns of more distinct values are kept as the values of the rows
+constexpr size_t kMaxDictSize = 65536;
+
+StringRef copy_string(const Slice& s, MemPool* pool) {
+    char* data = reinterpret_cast<char*>(pool->allocate(s.size));
+    memcpy(data, s.data, s.size);
+    return StringRef(data, s.size);
+}
+
+bool is_string_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_CHAR || type == OLAP_FIELD_TYPE_VARCHAR ||
+           type == OLAP_FIELD_TYPE_STRING;
+}
+
+} // namespace
+
+bool DecodedColumn::is_supported(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_BOOL:
+    case OLAP_FIELD_TYPE_TINYINT:
+    case OLAP_FIELD_TYPE_SMALLINT:
+    case OLAP_FIELD_TYPE_INT:
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_LARGEINT:
+    case OLAP_FIELD_TYPE_FLOAT:
+    case OLAP_FIELD_TYPE_DOUBLE:
+    case OLAP_FIELD_TYPE_DATE:
+    case OLAP_FIELD_TYPE_DATETIME:
+    case OLAP_FIELD_TYPE_DECIMAL:
+    case OLAP_FIELD_TYPE_CHAR:
+    case OLAP_FIELD_TYPE_VARCHAR:
+    case OLAP_FIELD_TYPE_STRING:
+        return true;
+    default:
+        return false;
+    }
+}
+
+size_t DecodedColumn::memory_usage() const {
+    return sizeof(DecodedColumn) + nulls.capacity() + values.capacity() +
+           codes.capacity() * sizeof(int32_t) +
+           (dict.capacity() + strings.capacity()) * sizeof(StringRef) +
+           pool.total_reserved_bytes();
+}
+
+Status DecodedColumn::load(ColumnReader* reader, const FilePathDesc& path_desc, FieldType type,
+                           uint64_t num_rows, std::shared_ptr<const DecodedColumn>* column) {
+    if (!is_supported(type)) {
+        return Status::NotSupported(
+                strings::Substitute("the column of type $0 can't be decoded in memory", type));
+    }
+    std::unique_ptr<fs::ReadableBlock> rblock;
+    fs::BlockManager* block_mgr = fs::fs_util::block_manager(path_desc);
+    RETURN_IF_ERROR(block_mgr->open_block(path_desc, &rblock));
+
+    ColumnIterator* raw_iter = nullptr;
+    RETURN_IF_ERROR(reader->new_iterator(&raw_iter));
+    std::unique_ptr<ColumnIterator> iter(raw_iter);
+    OlapReaderStatistics stats;
+    ColumnIteratorOptions iter_opts;
+    iter_opts.rblock = rblock.get();
+    iter_opts.stats = &stats;
+    // the pages are only decoded once, don't keep them in the page cache
+    iter_opts.use_page_cache = false;
+    RETURN_IF_ERROR(iter->init(iter_opts));
+    RETURN_IF_ERROR(iter->seek_to_first());
+
+    const TypeInfo* type_info = get_scalar_type_info(type);
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    RETURN_IF_ERROR(ColumnVectorBatch::create(kLoadBatchSize, reader->is_nullable(), type_info,
+                                              nullptr, &cvb));
+    MemPool read_pool("DecodedColumnLoad");
+
+    auto decoded = std::make_shared<DecodedColumn>();
+    decoded->num_rows = num_rows;
+    decoded->type_size = is_string_type(type) ? 0 : type_info->size();
+    if (reader->is_nullable()) {
+        decoded->nulls.reserve(num_rows);
+    }
+    if (decoded->is_string()) {
+        decoded->codes.reserve(num_rows);
+    } else {
+        decoded->values.reserve(num_rows * decoded->type_size);
+    }
+
+    bool has_any_null = false;
+    bool use_dict = decoded->is_string();
+    std::unordered_map<std::string_view, int32_t> dict_codes;
+    auto append_string = [&](const Slice& s) {
+        if (use_dict) {
+            auto it = dict_codes.find(std::string_view(s.data, s.size));
+            if (it != dict_codes.end()) {
+                decoded->codes.push_back(it->second);
+                return;
+            }
+            if (decoded->dict.size() < kMaxDictSize) {
+                StringRef value = copy_string(s, &decoded->pool);
+                int32_t code = decoded->dict.size();
+                decoded->dict.push_back(value);
+                dict_codes.emplace(std::string_view(value.data, value.size), code);
+                decoded->codes.push_back(code);
+                return;
+            }
+            // too many distinct values, keep the values of the rows instead, the bytes of the
+            // dictionary are still owned by the pool
+            decoded->strings.reserve(num_rows);
+            for (int32_t code : decoded->codes) {
+                decoded->strings.push_back(decoded->dict[code]);
+            }
+            decoded->codes = std::vector<int32_t>();
+            decoded->dict = std::vector<StringRef>();
+            dict_codes.clear();
+            use_dict = false;
+        }
+        decoded->strings.push_back(copy_string(s, &decoded->pool));
+    };
+
+    uint64_t read_rows = 0;
+    while (read_rows < num_rows) {
+        size_t n = std::min<uint64_t>(kLoadBatchSize, num_rows - read_rows);
+        ColumnBlock block(cvb.get(), &read_pool);
+        ColumnBlockView view(&block);
+        bool has_null = false;
+        RETURN_IF_ERROR(iter->next_batch(&n, &view, &has_null));
+        if (n == 0) {
+            return Status::Corruption(strings::Substitute(
+                    "read $0 rows of a column of $1 rows in $2", read_rows, num_rows,
+                    path_desc.filepath));
+        }
+        has_any_null |= has_null;
+        for (size_t i = 0; i < n; ++i) {
+            bool is_null = block.is_null(i);
+            if (reader->is_nullable()) {
+                decoded->nulls.push_back(is_null);
+            }
+            if (!decoded->is_string()) {
+                const char* cell = reinterpret_cast<const char*>(block.cell_ptr(i));
+                decoded->values.insert(decoded->values.end(), cell, cell + decoded->type_size);
+            } else if (is_null) {
+                // a placeholder which is never read
+                if (use_dict) {
+                    decoded->codes.push_back(0);
+                } else {
+                    decoded->strings.emplace_back();
+                }
+            } else {
+                append_string(*reinterpret_cast<const Slice*>(block.cell_ptr(i)));
+            }
+        }
+        read_pool.clear();
+        read_rows += n;
+    }
+
+    if (!has_any_null) {
+        decoded->nulls = std::vector<uint8_t>();
+    }
+    if (decoded->is_string() && !use_dict) {
+        decoded->codes = std::vector<int32_t>();
+    }
+    decoded->dict.shrink_to_fit();
+    *column = std::move(decoded);
+    return Status::OK();
+}
+
+DecodedColumnCache* DecodedColumnCache::_s_instance = nullptr;
+
+void DecodedColumnCache::create_global_cache(size_t capacity) {
+    DCHECK(_s_instance == nullptr);
+    static DecodedColumnCache instance(capacity);
+    _s_instance = &instance;
+}
+
+DecodedColumnCache::DecodedColumnCache(size_t capacity) {
+    _cache.reset(new_typed_lru_cache("DecodedColumnCache", capacity, LRUCacheType::SIZE));
+    ThreadPoolBuilder("DecodedColumnLoadThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::decoded_column_cache_load_threads))
+            .build(&_load_pool);
+}
+
+DecodedColumnCache::~DecodedColumnCache() {
+    _load_pool->shutdown();
+}
+
+std::string DecodedColumnCache::cache_key(const FilePathDesc& path_desc,
+                                          int32_t column_unique_id) {
+    return path_desc.filepath + ":" + std::to_string(column_unique_id);
+}
+
+DecodedColumnSharedPtr DecodedColumnCache::lookup(const std::string& key) {
+    auto handle = _cache->lookup(key);
+    if (handle == nullptr) {
+        return nullptr;
+    }
+    DecodedColumnSharedPtr column = *reinterpret_cast<DecodedColumnSharedPtr*>(
+            _cache->value(handle));
+    _cache->release(handle);
+    return column;
+}
+
+void DecodedColumnCache::insert(const std::string& key, DecodedColumnSharedPtr column) {
+    auto deleter = [](const doris::CacheKey& key, void* value) {
+        delete reinterpret_cast<DecodedColumnSharedPtr*>(value);
+    };
+    size_t charge = column->memory_usage();
+    auto value = new DecodedColumnSharedPtr(std::move(column));
+    auto handle = _cache->insert(key, value, charge, deleter, CachePriority::NORMAL);
+    _cache->release(handle);
+}
+
+void DecodedColumnCache::load_async(const std::string& key, std::shared_ptr<const void> holder,
+                                    ColumnReader* reader, const FilePathDesc& path_desc,
+                                    FieldType type, uint64_t num_rows) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (!_loading.insert(key).second) {
+            return;
+        }
+    }
+    auto st = _load_pool->submit_func([this, key, holder, reader, path_desc, type, num_rows]() {
+        DecodedColumnSharedPtr column;
+        Status st = DecodedColumn::load(reader, path_desc, type, num_rows, &column);
+        if (st.ok()) {
+            insert(key, std::move(column));
+        } else {
+            LOG(WARNING) << "failed to load the decoded column " << key << ": " << st;
+        }
+        std::lock_guard<std::mutex> l(_lock);
+        _loading.erase(key);
+    });
+    if (!st.ok()) {
+        std::lock_guard<std::mutex> l(_lock);
+        _loading.erase(key);
+    }
+}
+
+Status DecodedColumnIterator::seek_to_ordinal(ordinal_t ord) {
+    if (ord > _column->num_rows) {
+        return Status::InternalError(strings::Substitute(
+                "seek to ordinal $0 of a column of $1 rows", ord, _column->num_rows));
+    }
+    _current_ordinal = ord;
+    return Status::OK();
+}
+
+Status DecodedColumnIterator::next_batch(size_t* n, ColumnBlockView* dst, bool* has_null) {
+    *n = std::min<uint64_t>(*n, _column->num_rows - _current_ordinal);
+    *has_null = false;
+    for (size_t i = 0; i < *n; ++i) {
+        size_t row = _current_ordinal + i;
+        bool is_null = !_column->nulls.empty() && _column->nulls[row];
+        if (dst->is_nullable()) {
+            dst->set_null_bits(1, is_null);
+        }
+        if (is_null) {
+            *has_null = true;
+        } else if (!_column->is_string()) {
+            memcpy(dst->data(), _column->values.data() + row * _column->type_size,
+                   _column->type_size);
+        } else {
+            const StringRef& value = _column->is_dict_encoded()
+                                             ? _column->dict[_column->codes[row]]
+                                             : _column->strings[row];
+            char* data = reinterpret_cast<char*>(dst->pool()->allocate(value.size));
+            memcpy(data, value.data, value.size);
+            *reinterpret_cast<Slice*>(dst->data()) = Slice(data, value.size);
+        }
+        dst->advance(1);
+    }
+    _current_ordinal += *n;
+    return Status::OK();
+}
+
+Status DecodedColumnIterator::next_batch(size_t* n, vectorized::MutableColumnPtr& dst,
+                                         bool* has_null) {
+    *n = std::min<uint64_t>(*n, _column->num_rows - _current_ordinal);
+    *has_null = false;
+    if (_column->nulls.empty()) {
+        _insert_values(dst, _current_ordinal, *n);
+    } else {
+        const uint8_t* nulls = _column->nulls.data() + _current_ordinal;
+        size_t i = 0;
+        while (i < *n) {
+            size_t run_end = i + 1;
+            while (run_end < *n && nulls[run_end] == nulls[i]) {
+                ++run_end;
+            }
+            if (nulls[i]) {
+                *has_null = true;
+                for (size_t j = i; j < run_end; ++j) {
+                    dst->insert_data(nullptr, 0);
+                }
+            } else {
+                _insert_values(dst, _current_ordinal + i, run_end - i);
+            }
+            i = run_end;
+        }
+    }
+    _current_ordinal += *n;
+    return Status::OK();
+}
+
+void DecodedColumnIterator::_insert_values(vectorized::MutableColumnPtr& dst, size_t start,
+                                           size_t count) {
+    if (count == 0) {
+        return;
+    }
+    if (!_column->is_string()) {
+        dst->insert_many_fix_len_data(_column->values.data() + start * _column->type_size,
+                                      count);
+    } else if (_column->is_dict_encoded()) {
+        dst->insert_many_dict_data(_column->codes.data(), start, _column->dict.data(), count,
+                                   _column->dict.size());
+    } else {
+        dst = dst->convert_to_predicate_column_if_dictionary();
+        for (size_t i = start; i < start + count; ++i) {
+            dst->insert_data(_column->strings[i].data, _column->strings[i].size);
+        }
+    }
+}
+
+Status DecodedColumnIterator::get_row_ranges_by_zone_map(CondColumn* cond_column,
+                                                        CondColumn* delete_condition,
+                                                        RowRanges* row_ranges) {
+    if (_reader->has_zone_map()) {
+        RETURN_IF_ERROR(
+                _reader->get_row_ranges_by_zone_map(cond_column, delete_condition, row_ranges));
+    }
+    return Status::OK();
+}
+
+Status DecodedColumnIterator::get_row_ranges_by_bloom_filter(CondColumn* cond_column,
+                                                            RowRanges* row_ranges) {
+    if (cond_column != nullptr && cond_column->can_do_bloom_filter() &&
+        _reader->has_bloom_filter_index()) {
+        RETURN_IF_ERROR(_reader->get_row_ranges_by_bloom_filter(cond_column, row_ranges));
+    }
+    return Status::OK();
+}
+
+Status DecodedColumnIterator::get_row_ranges_by_ngram_bloom_filter(
+        const std::vector<std::string>& like_patterns, RowRanges* row_ranges) {
+    if (_reader->has_ngram_bloom_filter_index()) {
+        RETURN_IF_ERROR(_reader->get_row_ranges_by_ngram_bloom_filter(like_patterns, row_ranges));
+    }
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
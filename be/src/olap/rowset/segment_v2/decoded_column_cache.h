@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "common/status.h"
+#include "olap/lru_cache.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "runtime/mem_pool.h"
+#include "util/threadpool.h"
+#include "vec/common/string_ref.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// All the values of a column of a segment, decoded from the pages and kept in memory, so the
+// scans of the hot (in memory) tablets don't need to read and decode the pages again.
+// The string values are kept as a dictionary and the codes of the rows if the column has few
+// distinct values, or as the values of the rows otherwise. The bytes of the strings are owned
+// by `pool`. For the null rows `nulls` is 1 and the value is a placeholder.
+struct DecodedColumn {
+    DecodedColumn() : pool("DecodedColumn") {}
+
+    // Read and decode all the rows of the column of `reader`.
+    static Status load(ColumnReader* reader, const FilePathDesc& path_desc, FieldType type,
+                       uint64_t num_rows, std::shared_ptr<const DecodedColumn>* column);
+
+    static bool is_supported(FieldType type);
+
+    bool is_string() const { return type_size == 0; }
+    bool is_dict_encoded() const { return !codes.empty(); }
+    size_t memory_usage() const;
+
+    uint64_t num_rows = 0;
+    // the size of the values of the fixed length types in the storage format, 0 for strings
+    size_t type_size = 0;
+    // empty if the column has no null
+    std::vector<uint8_t> nulls;
+    // the values of the fixed length types in the storage format
+    std::vector<char> values;
+    std::vector<StringRef> dict;
+    std::vector<int32_t> codes;
+    std::vector<StringRef> strings;
+    MemPool pool;
+};
+
+using DecodedColumnSharedPtr = std::shared_ptr<const DecodedColumn>;
+
+// The cache of the decoded columns of the segments of the in memory tablets. A column is loaded
+// by a background thread when it's read for the first time, and the later reads are served from
+// the cache by a DecodedColumnIterator. The cache is keyed by the segment file and the unique id
+// of the column, the segments are immutable, so a new rowset only adds the new entries, and the
+// entries of the compacted rowsets are evicted by LRU.
+class DecodedColumnCache {
+public:
+    // Create the global instance, `capacity` is the memory limit of the decoded columns.
+    static void create_global_cache(size_t capacity);
+
+    static DecodedColumnCache* instance() { return _s_instance; }
+
+    DecodedColumnCache(size_t capacity);
+    ~DecodedColumnCache();
+
+    static std::string cache_key(const FilePathDesc& path_desc, int32_t column_unique_id);
+
+    // Return the decoded column of `key`, or nullptr if it's not in the cache.
+    DecodedColumnSharedPtr lookup(const std::string& key);
+
+    // Load the column in the background if it's not being loaded, `holder` is kept alive until
+    // the load is done, as the owner of `reader`.
+    void load_async(const std::string& key, std::shared_ptr<const void> holder,
+                    ColumnReader* reader, const FilePathDesc& path_desc, FieldType type,
+                    uint64_t num_rows);
+
+    void insert(const std::string& key, DecodedColumnSharedPtr column);
+
+private:
+    static DecodedColumnCache* _s_instance;
+
+    std::unique_ptr<Cache> _cache;
+    std::unique_ptr<ThreadPool> _load_pool;
+
+    std::mutex _lock;
+    // the keys of the columns being loaded
+    std::unordered_set<std::string> _loading;
+};
+
+// Read a column from its DecodedColumn in the cache. The indexes are still read by the reader.
+class DecodedColumnIterator final : public ColumnIterator {
+public:
+    DecodedColumnIterator(ColumnReader* reader, DecodedColumnSharedPtr column)
+            : _reader(reader), _column(std::move(column)) {}
+
+    Status seek_to_first() override {
+        _current_ordinal = 0;
+        return Status::OK();
+    }
+
+    Status seek_to_ordinal(ordinal_t ord) override;
+
+    Status next_batch(size_t* n, ColumnBlockView* dst, bool* has_null) override;
+
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst, bool* has_null) override;
+
+    ordinal_t get_current_ordinal() const override { return _current_ordinal; }
+
+    Status get_row_ranges_by_zone_map(CondColumn* cond_column, CondColumn* delete_condition,
+                                      RowRanges* row_ranges) override;
+
+    Status get_row_ranges_by_bloom_filter(CondColumn* cond_column, RowRanges* row_ranges) override;
+
+    Status get_row_ranges_by_ngram_bloom_filter(const std::vector<std::string>& like_patterns,
+                                                RowRanges* row_ranges) override;
+
+private:
+    // insert the non-null values of the rows [start, start + count)
+    void _insert_values(vectorized::MutableColumnPtr& dst, size_t start, size_t count);
+
+    ColumnReader* _reader;
+    DecodedColumnSharedPtr _column;
+    ordinal_t _current_ordinal = 0;
+};
+
+} // namespace segment_v2
+} // namespace doris
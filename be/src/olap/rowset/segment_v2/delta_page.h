@@ -0,0 +1,444 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "gutil/strings/substitute.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/options.h"      // for PageBuilderOptions/PageDecoderOptions
+#include "olap/rowset/segment_v2/page_builder.h" // for PageBuilder
+#include "olap/rowset/segment_v2/page_decoder.h" // for PageDecoder
+#include "olap/types.h"
+#include "util/bit_stream_utils.inline.h"
+#include "util/coding.h"
+#include "util/faststring.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// Delta and delta-of-delta encoding of integer pages, for the sorted columns such as timestamps
+// and sequence ids.
+//
+// The values are split into blocks of DELTA_BLOCK_SIZE values. Each block is encoded
+// independently, and the offsets of the blocks are stored as checkpoints at the end of the page,
+// so seeking to a position only decodes one block.
+//
+//   DeltaPage := NumValues(4 bytes), Block^N, BlockOffset^N (4 bytes each)
+//   Block := FirstValue(8 bytes), [FirstDelta(8 bytes)], MinResidual(8 bytes), BitWidth(1 byte),
+//            PackedResiduals
+//
+// For DELTA_ENCODING, the residuals are the differences of the adjacent values. For
+// DELTA_OF_DELTA_ENCODING, the residuals are the differences of the adjacent deltas, and the
+// first delta of the block is stored in FirstDelta. Each residual minus MinResidual is bit
+// packed with BitWidth bits. The arithmetic wraps around in 64 bits, so that the deltas of any
+// integers up to 64 bits can be represented.
+static constexpr size_t DELTA_BLOCK_SIZE = 128;
+static constexpr size_t DELTA_PAGE_HEADER_SIZE = sizeof(uint32_t);
+
+template <FieldType Type, bool delta_of_delta>
+class DeltaPageBuilder : public PageBuilder {
+public:
+    explicit DeltaPageBuilder(const PageBuilderOptions& options)
+            : _options(options),
+              // the decoded page takes as much memory as a plain page
+              _max_count(std::max<size_t>(options.data_page_size / SIZE_OF_TYPE, 1)) {
+        reset();
+    }
+
+    bool is_page_full() override { return _count >= _max_count; }
+
+    Status add(const uint8_t* vals, size_t* count) override {
+        DCHECK(!_finished);
+        size_t to_add = std::min(*count, _max_count - _count);
+        if (to_add == 0) {
+            *count = 0;
+            return Status::OK();
+        }
+        auto new_vals = reinterpret_cast<const CppType*>(vals);
+        if (_count == 0) {
+            _first_value = new_vals[0];
+        }
+        for (size_t i = 0; i < to_add; ++i) {
+            _pending_values.push_back(static_cast<uint64_t>(new_vals[i]));
+            if (_pending_values.size() == DELTA_BLOCK_SIZE) {
+                _flush_block();
+            }
+        }
+        _last_value = new_vals[to_add - 1];
+        _count += to_add;
+        *count = to_add;
+        return Status::OK();
+    }
+
+    OwnedSlice finish() override {
+        DCHECK(!_finished);
+        _finished = true;
+        if (!_pending_values.empty()) {
+            _flush_block();
+        }
+        encode_fixed32_le(_buffer.data(), _count);
+        for (uint32_t offset : _block_offsets) {
+            put_fixed32_le(&_buffer, offset);
+        }
+        return _buffer.build();
+    }
+
+    void reset() override {
+        _count = 0;
+        _finished = false;
+        _pending_values.clear();
+        _block_offsets.clear();
+        _buffer.clear();
+        _buffer.resize(DELTA_PAGE_HEADER_SIZE);
+    }
+
+    size_t count() const override { return _count; }
+
+    uint64_t size() const override {
+        return _buffer.size() + _pending_values.size() * SIZE_OF_TYPE +
+               _block_offsets.size() * sizeof(uint32_t);
+    }
+
+    Status get_first_value(void* value) const override {
+        if (_count == 0) {
+            return Status::NotFound("page is empty");
+        }
+        memcpy(value, &_first_value, SIZE_OF_TYPE);
+        return Status::OK();
+    }
+
+    Status get_last_value(void* value) const override {
+        if (_count == 0) {
+            return Status::NotFound("page is empty");
+        }
+        memcpy(value, &_last_value, SIZE_OF_TYPE);
+        return Status::OK();
+    }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    enum { SIZE_OF_TYPE = TypeTraits<Type>::size };
+
+    void _flush_block() {
+        size_t num_values = _pending_values.size();
+        DCHECK_GT(num_values, 0);
+        _block_offsets.push_back(_buffer.size());
+        put_fixed64_le(&_buffer, _pending_values[0]);
+
+        _residuals.clear();
+        uint64_t prev_delta = 0;
+        for (size_t i = 1; i < num_values; ++i) {
+            uint64_t delta = _pending_values[i] - _pending_values[i - 1];
+            if (!delta_of_delta) {
+                _residuals.push_back(delta);
+            } else if (i > 1) {
+                _residuals.push_back(delta - prev_delta);
+            }
+            prev_delta = delta;
+        }
+        if (delta_of_delta) {
+            put_fixed64_le(&_buffer, num_values > 1 ? _pending_values[1] - _pending_values[0] : 0);
+        }
+
+        int64_t min_residual = 0;
+        if (!_residuals.empty()) {
+            min_residual = static_cast<int64_t>(_residuals[0]);
+            for (uint64_t residual : _residuals) {
+                min_residual = std::min(min_residual, static_cast<int64_t>(residual));
+            }
+        }
+        uint64_t max_packed = 0;
+        for (uint64_t residual : _residuals) {
+            max_packed = std::max(max_packed, residual - static_cast<uint64_t>(min_residual));
+        }
+        int bit_width = max_packed == 0 ? 0 : 64 - __builtin_clzll(max_packed);
+        put_fixed64_le(&_buffer, static_cast<uint64_t>(min_residual));
+        _buffer.push_back(static_cast<char>(bit_width));
+        if (bit_width > 0) {
+            BitWriter writer(&_packed_buffer);
+            for (uint64_t residual : _residuals) {
+                writer.PutValue(residual - static_cast<uint64_t>(min_residual), bit_width);
+            }
+            writer.Flush();
+            _buffer.append(_packed_buffer.data(), _packed_buffer.size());
+        }
+        _pending_values.clear();
+    }
+
+    PageBuilderOptions _options;
+    size_t _max_count;
+    size_t _count = 0;
+    bool _finished = false;
+    faststring _buffer;
+    // values of the current block, not encoded yet
+    std::vector<uint64_t> _pending_values;
+    std::vector<uint64_t> _residuals;
+    faststring _packed_buffer;
+    std::vector<uint32_t> _block_offsets;
+    CppType _first_value;
+    CppType _last_value;
+};
+
+template <FieldType Type, bool delta_of_delta>
+class DeltaPageDecoder : public PageDecoder {
+public:
+    DeltaPageDecoder(Slice data, const PageDecoderOptions& options)
+            : _data(data), _options(options) {}
+
+    Status init() override {
+        CHECK(!_parsed);
+        if (_data.size < DELTA_PAGE_HEADER_SIZE) {
+            return Status::Corruption(strings::Substitute(
+                    "not enough bytes for header in DeltaPageDecoder, data size: $0", _data.size));
+        }
+        _num_elements = decode_fixed32_le((const uint8_t*)_data.data);
+        _num_blocks = (_num_elements + DELTA_BLOCK_SIZE - 1) / DELTA_BLOCK_SIZE;
+        if (_data.size < DELTA_PAGE_HEADER_SIZE + _num_blocks * sizeof(uint32_t)) {
+            return Status::Corruption(strings::Substitute(
+                    "not enough bytes for $0 blocks in DeltaPageDecoder", _num_blocks));
+        }
+        _blocks_end = _data.size - _num_blocks * sizeof(uint32_t);
+        size_t prev_offset = DELTA_PAGE_HEADER_SIZE;
+        for (size_t i = 0; i < _num_blocks; ++i) {
+            size_t offset = _block_offset(i);
+            if (offset < prev_offset || offset + _block_header_size() > _blocks_end) {
+                return Status::Corruption(strings::Substitute(
+                        "invalid offset $0 of block $1 in DeltaPageDecoder", offset, i));
+            }
+            prev_offset = offset + _block_header_size();
+        }
+        _parsed = true;
+        return Status::OK();
+    }
+
+    Status seek_to_position_in_page(size_t pos) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        DCHECK_LE(pos, _num_elements)
+                << "Tried to seek to " << pos << " which is > number of elements (" << _num_elements
+                << ") in the block!";
+        // the block is decoded when it's read
+        _cur_index = pos;
+        return Status::OK();
+    }
+
+    Status seek_at_or_after_value(const void* value, bool* exact_match) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        if (_num_elements == 0) {
+            return Status::NotFound("page is empty");
+        }
+        // the first block whose first value >= value
+        size_t left = 0;
+        size_t right = _num_blocks;
+        while (left < right) {
+            size_t mid = left + (right - left) / 2;
+            CppType first_value = _block_first_value(mid);
+            if (TypeTraits<Type>::cmp(&first_value, value) < 0) {
+                left = mid + 1;
+            } else {
+                right = mid;
+            }
+        }
+        // the values equal to `value` may be at the end of the previous block
+        if (left > 0) {
+            RETURN_IF_ERROR(_decode_block(left - 1));
+            size_t num_values = _num_values_of_block(left - 1);
+            for (size_t i = 0; i < num_values; ++i) {
+                int cmp = TypeTraits<Type>::cmp(&_block_values[i], value);
+                if (cmp >= 0) {
+                    *exact_match = cmp == 0;
+                    _cur_index = (left - 1) * DELTA_BLOCK_SIZE + i;
+                    return Status::OK();
+                }
+            }
+        }
+        if (left >= _num_blocks) {
+            return Status::NotFound("all value small than the value");
+        }
+        CppType first_value = _block_first_value(left);
+        *exact_match = TypeTraits<Type>::cmp(&first_value, value) == 0;
+        _cur_index = left * DELTA_BLOCK_SIZE;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, ColumnBlockView* dst) override { return next_batch<true>(n, dst); }
+
+    template <bool forward_index>
+    Status next_batch(size_t* n, ColumnBlockView* dst) {
+        DCHECK(_parsed) << "Must call init() firstly";
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        uint8_t* data_ptr = dst->data();
+        size_t cur_index = _cur_index;
+        size_t fetched = 0;
+        while (fetched < to_fetch) {
+            size_t block = cur_index / DELTA_BLOCK_SIZE;
+            size_t index_in_block = cur_index % DELTA_BLOCK_SIZE;
+            RETURN_IF_ERROR(_decode_block(block));
+            size_t num = std::min(to_fetch - fetched, _num_values_of_block(block) - index_in_block);
+            memcpy(data_ptr + fetched * SIZE_OF_TYPE, &_block_values[index_in_block],
+                   num * SIZE_OF_TYPE);
+            fetched += num;
+            cur_index += num;
+        }
+        if (forward_index) {
+            _cur_index = cur_index;
+        }
+        *n = to_fetch;
+        return Status::OK();
+    }
+
+    Status next_batch(size_t* n, vectorized::MutableColumnPtr& dst) override {
+        DCHECK(_parsed) << "Must call init() firstly";
+        if (PREDICT_FALSE(*n == 0 || _cur_index >= _num_elements)) {
+            *n = 0;
+            return Status::OK();
+        }
+        size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
+        size_t fetched = 0;
+        while (fetched < to_fetch) {
+            size_t block = _cur_index / DELTA_BLOCK_SIZE;
+            size_t index_in_block = _cur_index % DELTA_BLOCK_SIZE;
+            RETURN_IF_ERROR(_decode_block(block));
+            size_t num = std::min(to_fetch - fetched, _num_values_of_block(block) - index_in_block);
+            dst->insert_many_fix_len_data((char*)&_block_values[index_in_block], num);
+            fetched += num;
+            _cur_index += num;
+        }
+        *n = to_fetch;
+        return Status::OK();
+    }
+
+    Status peek_next_batch(size_t* n, ColumnBlockView* dst) override {
+        return next_batch<false>(n, dst);
+    }
+
+    size_t count() const override { return _num_elements; }
+
+    size_t current_index() const override { return _cur_index; }
+
+private:
+    typedef typename TypeTraits<Type>::CppType CppType;
+    enum { SIZE_OF_TYPE = TypeTraits<Type>::size };
+
+    static constexpr size_t _block_header_size() {
+        // FirstValue, [FirstDelta], MinResidual, BitWidth
+        return (delta_of_delta ? 3 : 2) * sizeof(uint64_t) + 1;
+    }
+
+    size_t _block_offset(size_t block) const {
+        return decode_fixed32_le((const uint8_t*)_data.data + _blocks_end +
+                                 block * sizeof(uint32_t));
+    }
+
+    size_t _num_values_of_block(size_t block) const {
+        return std::min(DELTA_BLOCK_SIZE, _num_elements - block * DELTA_BLOCK_SIZE);
+    }
+
+    CppType _block_first_value(size_t block) const {
+        return static_cast<CppType>(
+                decode_fixed64_le((const uint8_t*)_data.data + _block_offset(block)));
+    }
+
+    Status _decode_block(size_t block) {
+        if (block == _decoded_block) {
+            return Status::OK();
+        }
+        const uint8_t* ptr = (const uint8_t*)_data.data + _block_offset(block);
+        size_t block_end = block + 1 < _num_blocks ? _block_offset(block + 1) : _blocks_end;
+        size_t num_values = _num_values_of_block(block);
+
+        uint64_t first_value = decode_fixed64_le(ptr);
+        ptr += sizeof(uint64_t);
+        uint64_t first_delta = 0;
+        if (delta_of_delta) {
+            first_delta = decode_fixed64_le(ptr);
+            ptr += sizeof(uint64_t);
+        }
+        uint64_t min_residual = decode_fixed64_le(ptr);
+        ptr += sizeof(uint64_t);
+        int bit_width = *ptr++;
+        if (bit_width > 64) {
+            return Status::Corruption(strings::Substitute(
+                    "invalid bit width $0 of block $1 in DeltaPageDecoder", bit_width, block));
+        }
+
+        size_t num_residuals = delta_of_delta ? (num_values > 2 ? num_values - 2 : 0)
+                                              : num_values - 1;
+        if (bit_width > 0) {
+            const uint8_t* packed_end = (const uint8_t*)_data.data + block_end;
+            BitReader reader(ptr, packed_end - ptr);
+            for (size_t i = 0; i < num_residuals; ++i) {
+                if (!reader.GetValue(bit_width, &_residuals[i])) {
+                    return Status::Corruption(strings::Substitute(
+                            "not enough residuals of block $0 in DeltaPageDecoder", block));
+                }
+            }
+        } else {
+            std::fill(_residuals, _residuals + num_residuals, 0);
+        }
+
+        // restore the values by prefix sums, the loops are kept simple to be vectorized
+        for (size_t i = 0; i < num_residuals; ++i) {
+            _residuals[i] += min_residual;
+        }
+        _values[0] = first_value;
+        if (delta_of_delta) {
+            if (num_values > 1) {
+                uint64_t delta = first_delta;
+                _values[1] = first_value + delta;
+                for (size_t i = 0; i < num_residuals; ++i) {
+                    delta += _residuals[i];
+                    _values[i + 2] = _values[i + 1] + delta;
+                }
+            }
+        } else {
+            for (size_t i = 0; i < num_residuals; ++i) {
+                _values[i + 1] = _values[i] + _residuals[i];
+            }
+        }
+        for (size_t i = 0; i < num_values; ++i) {
+            _block_values[i] = static_cast<CppType>(_values[i]);
+        }
+        _decoded_block = block;
+        return Status::OK();
+    }
+
+    Slice _data;
+    PageDecoderOptions _options;
+    bool _parsed = false;
+    size_t _num_elements = 0;
+    size_t _num_blocks = 0;
+    // end of the blocks, where the block offsets start
+    size_t _blocks_end = 0;
+    size_t _cur_index = 0;
+
+    size_t _decoded_block = std::numeric_limits<size_t>::max();
+    uint64_t _residuals[DELTA_BLOCK_SIZE];
+    uint64_t _values[DELTA_BLOCK_SIZE];
+    CppType _block_values[DELTA_BLOCK_SIZE];
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 
 #include "common/status.h"
 #include "gen_cpp/segment_v2.pb.h"
@@ -44,6 +45,10 @@ public:
     // and support fast value seek operation
     static EncodingTypePB get_default_encoding(const TypeInfo* type_info, bool optimize_value_seek);
 
+    // Get all encodings registered for the type, the default encoding comes first
+    static void get_candidates(const TypeInfo* type_info,
+                               std::vector<const EncodingInfo*>* candidates);
+
     Status create_page_builder(const PageBuilderOptions& opts, PageBuilder** builder) const {
         return _create_builder_func(opts, builder);
     }
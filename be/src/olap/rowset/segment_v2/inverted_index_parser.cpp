@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "olap/rowset/segment_v2/inverted_index_parser.h"
+
+#include <cctype>
+
+namespace doris {
+namespace segment_v2 {
+
+Status parse_inverted_index_parser(const std::string& parser_name,
+                                   InvertedIndexParserType* parser_type) {
+    if (parser_name == INVERTED_INDEX_PARSER_NONE) {
+        *parser_type = InvertedIndexParserType::PARSER_NONE;
+    } else if (parser_name == INVERTED_INDEX_PARSER_ENGLISH) {
+        *parser_type = InvertedIndexParserType::PARSER_ENGLISH;
+    } else if (parser_name == INVERTED_INDEX_PARSER_WHITESPACE) {
+        *parser_type = InvertedIndexParserType::PARSER_WHITESPACE;
+    } else {
+        return Status::InvalidArgument("unknown inverted index parser: " + parser_name);
+    }
+    return Status::OK();
+}
+
+void tokenize_by_parser(InvertedIndexParserType parser_type, const Slice& value,
+                        std::vector<std::string>* terms) {
+    switch (parser_type) {
+    case InvertedIndexParserType::PARSER_NONE: {
+        // skip the padding zeros of CHAR column
+        size_t size = value.size;
+        while (size > 0 && value.data[size - 1] == '\0') {
+            --size;
+        }
+        terms->emplace_back(value.data, size);
+        break;
+    }
+    case InvertedIndexParserType::PARSER_ENGLISH: {
+        std::string term;
+        for (size_t i = 0; i < value.size; ++i) {
+            unsigned char c = value.data[i];
+            if (std::isalnum(c)) {
+                term.push_back(std::tolower(c));
+            } else if (!term.empty()) {
+                terms->push_back(std::move(term));
+                term.clear();
+            }
+        }
+        if (!term.empty()) {
+            terms->push_back(std::move(term));
+        }
+        break;
+    }
+    case InvertedIndexParserType::PARSER_WHITESPACE: {
+        size_t start = 0;
+        for (size_t i = 0; i <= value.size; ++i) {
+            if (i == value.size || std::isspace(static_cast<unsigned char>(value.data[i]))) {
+                if (i > start) {
+                    terms->emplace_back(value.data + start, i - start);
+                }
+                start = i + 1;
+            }
+        }
+        break;
+    }
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,48 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace segment_v2 {
+
+// Parser of inverted index, which splits a value into the terms of the posting lists.
+//  - none: the whole value is one term
+//  - english: maximal runs of ASCII letters and digits, lowercased
+//  - whitespace: runs of non-whitespace bytes, case sensitive
+enum class InvertedIndexParserType { PARSER_NONE, PARSER_ENGLISH, PARSER_WHITESPACE };
+
+const std::string INVERTED_INDEX_PARSER_NONE = "none";
+const std::string INVERTED_INDEX_PARSER_ENGLISH = "english";
+const std::string INVERTED_INDEX_PARSER_WHITESPACE = "whitespace";
+
+Status parse_inverted_index_parser(const std::string& parser_name,
+                                   InvertedIndexParserType* parser_type);
+
+// Append the terms of `value` to `terms`, a term may appear more than once.
+void tokenize_by_parser(InvertedIndexParserType parser_type, const Slice& value,
+                        std::vector<std::string>* terms);
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,169 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "olap/rowset/segment_v2/inverted_index_writer.h"
+
+#include <map>
+#include <roaring/roaring.hh>
+#include <vector>
+
+#include "olap/rowset/segment_v2/common.h"
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/rowset/segment_v2/inverted_index_parser.h"
+#include "olap/types.h"
+#include "util/faststring.h"
+#include "util/slice.h"
+
+namespace doris {
+namespace segment_v2 {
+
+namespace {
+
+class InvertedIndexWriterImpl : public InvertedIndexWriter {
+public:
+    InvertedIndexWriterImpl(const std::string& parser_name, InvertedIndexParserType parser_type)
+            : _parser_name(parser_name), _parser_type(parser_type) {}
+
+    ~InvertedIndexWriterImpl() override = default;
+
+    void add_values(const void* values, size_t count) override {
+        auto p = reinterpret_cast<const Slice*>(values);
+        std::vector<std::string> terms;
+        for (size_t i = 0; i < count; ++i) {
+            terms.clear();
+            tokenize_by_parser(_parser_type, *p, &terms);
+            for (auto& term : terms) {
+                add_term(term);
+            }
+            p++;
+            _rid++;
+        }
+    }
+
+    void add_term(const std::string& term) {
+        auto it = _mem_index.find(term);
+        uint64_t old_size = 0;
+        if (it != _mem_index.end()) {
+            old_size = it->second.getSizeInBytes(false);
+            it->second.add(_rid);
+        } else {
+            it = _mem_index.emplace(term, roaring::Roaring::bitmapOf(1, _rid)).first;
+            _terms_size += term.size();
+        }
+        _posting_list_size += it->second.getSizeInBytes(false) - old_size;
+    }
+
+    void add_nulls(uint32_t count) override {
+        _null_bitmap.addRange(_rid, _rid + count);
+        _rid += count;
+    }
+
+    Status finish(fs::WritableBlock* wblock, ColumnIndexMetaPB* index_meta) override {
+        index_meta->set_type(INVERTED_INDEX);
+        InvertedIndexPB* inverted_index_meta = index_meta->mutable_inverted_index();
+        inverted_index_meta->set_parser(_parser_name);
+        BitmapIndexPB* meta = inverted_index_meta->mutable_postings();
+
+        meta->set_bitmap_type(BitmapIndexPB::ROARING_BITMAP);
+        meta->set_has_null(!_null_bitmap.isEmpty());
+
+        { // write term dictionary
+            const auto* term_type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+            IndexedColumnWriterOptions options;
+            options.write_ordinal_index = false;
+            options.write_value_index = true;
+            options.encoding = EncodingInfo::get_default_encoding(term_type_info, true);
+            options.compression = LZ4F;
+
+            IndexedColumnWriter dict_column_writer(options, term_type_info, wblock);
+            RETURN_IF_ERROR(dict_column_writer.init());
+            for (auto const& it : _mem_index) {
+                Slice term(it.first);
+                RETURN_IF_ERROR(dict_column_writer.add(&term));
+            }
+            RETURN_IF_ERROR(dict_column_writer.finish(meta->mutable_dict_column()));
+        }
+        { // write posting lists
+            std::vector<roaring::Roaring*> bitmaps;
+            for (auto& it : _mem_index) {
+                bitmaps.push_back(&(it.second));
+            }
+            if (!_null_bitmap.isEmpty()) {
+                bitmaps.push_back(&_null_bitmap);
+            }
+
+            const auto* bitmap_type_info = get_scalar_type_info<OLAP_FIELD_TYPE_OBJECT>();
+            IndexedColumnWriterOptions options;
+            options.write_ordinal_index = true;
+            options.write_value_index = false;
+            options.encoding = EncodingInfo::get_default_encoding(bitmap_type_info, false);
+            // we already store compressed bitmap, use NO_COMPRESSION to save some cpu
+            options.compression = NO_COMPRESSION;
+
+            IndexedColumnWriter bitmap_column_writer(options, bitmap_type_info, wblock);
+            RETURN_IF_ERROR(bitmap_column_writer.init());
+
+            faststring buf;
+            for (auto bitmap : bitmaps) {
+                bitmap->runOptimize();
+                buf.resize(bitmap->getSizeInBytes(false));
+                bitmap->write(reinterpret_cast<char*>(buf.data()), false);
+                Slice buf_slice(buf);
+                RETURN_IF_ERROR(bitmap_column_writer.add(&buf_slice));
+            }
+            RETURN_IF_ERROR(bitmap_column_writer.finish(meta->mutable_bitmap_column()));
+        }
+        return Status::OK();
+    }
+
+    uint64_t size() const override {
+        return _null_bitmap.getSizeInBytes(false) + _posting_list_size + _terms_size +
+               _mem_index.size() * sizeof(std::string);
+    }
+
+private:
+    const std::string _parser_name;
+    const InvertedIndexParserType _parser_type;
+    rowid_t _rid = 0;
+    uint64_t _posting_list_size = 0;
+    uint64_t _terms_size = 0;
+    // row id list for null value
+    roaring::Roaring _null_bitmap;
+    // term to its row id list
+    std::map<std::string, roaring::Roaring> _mem_index;
+};
+
+} // namespace
+
+Status InvertedIndexWriter::create(const TypeInfo* type_info, const std::string& parser_name,
+                                   std::unique_ptr<InvertedIndexWriter>* res) {
+    FieldType type = type_info->type();
+    if (type != OLAP_FIELD_TYPE_CHAR && type != OLAP_FIELD_TYPE_VARCHAR &&
+        type != OLAP_FIELD_TYPE_STRING) {
+        return Status::NotSupported("unsupported type for inverted index: " +
+                                    std::to_string(type));
+    }
+    InvertedIndexParserType parser_type;
+    RETURN_IF_ERROR(parse_inverted_index_parser(parser_name, &parser_type));
+    res->reset(new InvertedIndexWriterImpl(parser_name, parser_type));
+    return Status::OK();
+}
+
+} // namespace segment_v2
+} // namespace doris
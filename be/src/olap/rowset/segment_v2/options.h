@@ -19,6 +19,8 @@
 
 #include <cstddef>
 
+#include "util/slice.h"
+
 namespace doris {
 namespace segment_v2 {
 
@@ -32,7 +34,11 @@ struct PageBuilderOptions {
     size_t dict_page_size = DEFAULT_PAGE_SIZE;
 };
 
-struct PageDecoderOptions {};
+struct PageDecoderOptions {
+    // the values of the page decoded before, from the decoded page cache, the decoders which
+    // support it (the bitshuffle decoder) read them instead of decoding the page again
+    Slice decoded_values;
+};
 
 } // namespace segment_v2
 } // namespace doris
@@ -84,6 +84,11 @@ public:
     // for test
     int32_t num_data_pages() const { return _num_pages; }
 
+    // the bytes of the loaded index
+    size_t mem_usage() const {
+        return _ordinals.capacity() * sizeof(ordinal_t) + _pages.capacity() * sizeof(PagePointer);
+    }
+
 private:
     friend OrdinalPageIndexIterator;
 
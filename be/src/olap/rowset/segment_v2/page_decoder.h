@@ -102,6 +102,11 @@ public:
 
     bool has_remaining() const { return current_index() < count(); }
 
+    // Return the values decoded by init() which can be kept in the decoded page cache and
+    // passed by PageDecoderOptions::decoded_values to the decoders of the same page later,
+    // empty if the decoder doesn't support it.
+    virtual Slice decoded_values() const { return Slice(); }
+
 private:
     DISALLOW_COPY_AND_ASSIGN(PageDecoder);
 };
@@ -196,7 +196,8 @@ Status PageIO::read_and_decompress_page(const PageReadOptions& opts, PageHandle*
     }
 
     *body = Slice(page_slice.data, page_slice.size - 4 - footer_size);
-    if (opts.use_page_cache && cache->is_cache_available(opts.type)) {
+    bool bypass_admission = opts.bypass_page_cache_admission && opts.type == DATA_PAGE;
+    if (opts.use_page_cache && cache->is_cache_available(opts.type) && !bypass_admission) {
         // insert this page into cache and return the cache handle
         cache->insert(cache_key, page_slice, &cache_handle, opts.type, opts.kept_in_memory);
         *handle = PageHandle(std::move(cache_handle));
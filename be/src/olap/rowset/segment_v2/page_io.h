@@ -51,6 +51,8 @@ struct PageReadOptions {
     bool verify_checksum = true;
     // whether to use page cache in read path
     bool use_page_cache = true;
+    // if true, the data page missed in page cache is not inserted into it
+    bool bypass_page_cache_admission = false;
     // if true, use DURABLE CachePriority in page cache
     // currently used for in memory olap table
     bool kept_in_memory = false;
@@ -0,0 +1,157 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/page_prefetcher.h"
+
+#include <algorithm>
+
+#include "common/logging.h"
+#include "util/runtime_profile.h"
+#include "util/threadpool.h"
+
+namespace doris {
+namespace segment_v2 {
+
+PagePrefetcher::PagePrefetcher(ColumnReader* reader, const ColumnIteratorOptions& opts,
+                               ThreadPool* pool, PagePrefetchBudget* budget, int32_t depth)
+        : _reader(reader), _opts(opts), _pool(pool), _budget(budget), _depth(depth) {
+    _opts.type = DATA_PAGE;
+}
+
+PagePrefetcher::~PagePrefetcher() {
+    std::unique_lock<std::mutex> l(_lock);
+    _cond.wait(l, [this] { return _num_in_flight == 0; });
+    for (size_t i = 0; i < _pages.size(); ++i) {
+        _budget->release();
+    }
+}
+
+void PagePrefetcher::prefetch_after(const OrdinalPageIndexIterator& iter) {
+    OrdinalPageIndexIterator next = iter;
+    next.next();
+    // skip the pages considered before, each page is considered once in a forward scan
+    while (next.valid() && next.page_index() < _next_page_index) {
+        next.next();
+    }
+    int32_t num_ahead = 0;
+    for (auto& it : _pages) {
+        num_ahead += it.first > iter.page_index();
+    }
+    for (; next.valid() && num_ahead < _depth; next.next()) {
+        if (_pages.count(next.page_index()) > 0) {
+            continue;
+        }
+        if (_opts.row_bitmap != nullptr) {
+            // skip the page if none of its rows is selected
+            uint64_t first = next.first_ordinal();
+            uint64_t last = next.last_ordinal();
+            uint64_t before = first == 0 ? 0 : _opts.row_bitmap->rank(first - 1);
+            if (_opts.row_bitmap->rank(last) == before) {
+                _next_page_index = next.page_index() + 1;
+                continue;
+            }
+        }
+        if (!_budget->try_acquire()) {
+            // try again at the next page boundary
+            break;
+        }
+        auto page = std::make_shared<PrefetchedPage>();
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            _num_in_flight++;
+        }
+        PagePointer pp = next.page();
+        Status st = _pool->submit_func([this, page, pp]() { _read_page(page, pp); });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(_lock);
+            _num_in_flight--;
+            _budget->release();
+            break;
+        }
+        _pages.emplace(next.page_index(), std::move(page));
+        _next_page_index = next.page_index() + 1;
+        num_ahead++;
+    }
+}
+
+void PagePrefetcher::_read_page(std::shared_ptr<PrefetchedPage> page, PagePointer pp) {
+    ColumnIteratorOptions opts = _opts;
+    opts.stats = &page->stats;
+    PageHandle handle;
+    Slice page_body;
+    PageFooterPB footer;
+    Status st = _reader->read_page(opts, pp, &handle, &page_body, &footer);
+
+    std::lock_guard<std::mutex> l(_lock);
+    page->status = st;
+    page->handle = std::move(handle);
+    page->page_body = page_body;
+    page->footer = std::move(footer);
+    page->done = true;
+    _num_in_flight--;
+    _cond.notify_all();
+}
+
+bool PagePrefetcher::take(int32_t page_index, Status* status, PageHandle* handle,
+                          Slice* page_body, PageFooterPB* footer) {
+    if (page_index <= _last_page_index) {
+        // the scan seeks back, consider the pages after it again
+        _next_page_index = page_index + 1;
+    }
+    _last_page_index = page_index;
+    _discard_before(page_index);
+    auto it = _pages.find(page_index);
+    if (it == _pages.end()) {
+        return false;
+    }
+    std::shared_ptr<PrefetchedPage> page = std::move(it->second);
+    _pages.erase(it);
+    _budget->release();
+    {
+        SCOPED_RAW_TIMER(&_opts.stats->page_prefetch_wait_ns);
+        std::unique_lock<std::mutex> l(_lock);
+        _cond.wait(l, [&page] { return page->done; });
+    }
+    _merge_stats(page->stats);
+    _opts.stats->prefetched_pages_num++;
+    *status = page->status;
+    *handle = std::move(page->handle);
+    *page_body = page->page_body;
+    *footer = std::move(page->footer);
+    return true;
+}
+
+void PagePrefetcher::_discard_before(int32_t page_index) {
+    auto end = _pages.lower_bound(page_index);
+    for (auto it = _pages.begin(); it != end; ++it) {
+        // the page in flight is freed when its read finishes
+        _budget->release();
+    }
+    _pages.erase(_pages.begin(), end);
+}
+
+void PagePrefetcher::_merge_stats(const OlapReaderStatistics& stats) {
+    _opts.stats->io_ns += stats.io_ns;
+    _opts.stats->decompress_ns += stats.decompress_ns;
+    _opts.stats->compressed_bytes_read += stats.compressed_bytes_read;
+    _opts.stats->uncompressed_bytes_read += stats.uncompressed_bytes_read;
+    _opts.stats->total_pages_num += stats.total_pages_num;
+    _opts.stats->cached_pages_num += stats.cached_pages_num;
+}
+
+} // namespace segment_v2
+} // namespace doris
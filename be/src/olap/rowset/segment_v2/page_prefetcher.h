@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "common/status.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/ordinal_page_index.h"
+#include "olap/rowset/segment_v2/page_handle.h"
+#include "util/slice.h"
+
+namespace doris {
+
+class ThreadPool;
+
+namespace segment_v2 {
+
+// The number of data pages that all the column iterators of one scan are allowed to read
+// ahead, counting both the pages in flight and the pages read but not consumed yet.
+// It's shared by the scanners of a scan node, so it bounds the memory and the IO queue
+// depth taken by the read-ahead of one query.
+class PagePrefetchBudget {
+public:
+    explicit PagePrefetchBudget(int32_t max_pages) : _max_pages(max_pages) {}
+
+    bool try_acquire() {
+        int32_t pages = _pages.load(std::memory_order_relaxed);
+        while (pages < _max_pages) {
+            if (_pages.compare_exchange_weak(pages, pages + 1)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void release() { _pages.fetch_sub(1); }
+
+    int32_t pending_pages() const { return _pages.load(std::memory_order_relaxed); }
+
+private:
+    const int32_t _max_pages;
+    std::atomic<int32_t> _pages {0};
+};
+
+// Reads the data pages following the current page of a FileColumnIterator in a thread pool,
+// so that the scanner thread doesn't wait for the IO at every page boundary.
+// A page is read ahead only if some rows of it are selected by `row_bitmap`, and at most
+// `depth` pages are read ahead for one column. The pages read ahead are kept here until
+// the iterator takes them.
+//
+// Not thread-safe, it's used by one column iterator only.
+class PagePrefetcher {
+public:
+    PagePrefetcher(ColumnReader* reader, const ColumnIteratorOptions& opts, ThreadPool* pool,
+                   PagePrefetchBudget* budget, int32_t depth);
+
+    // wait for all the pages in flight, because they refer to the file and the reader
+    ~PagePrefetcher();
+
+    // read ahead the pages after the page pointed by `iter`
+    void prefetch_after(const OrdinalPageIndexIterator& iter);
+
+    // take the page `page_index` if it's read ahead, waiting for the read if it's in flight.
+    // the pages before `page_index` are discarded, because the scan has passed them.
+    // return false if the page isn't read ahead, and the caller should read it itself.
+    bool take(int32_t page_index, Status* status, PageHandle* handle, Slice* page_body,
+              PageFooterPB* footer);
+
+private:
+    struct PrefetchedPage {
+        bool done = false;
+        Status status;
+        PageHandle handle;
+        Slice page_body;
+        PageFooterPB footer;
+        OlapReaderStatistics stats;
+    };
+
+    void _read_page(std::shared_ptr<PrefetchedPage> page, PagePointer pp);
+    void _discard_before(int32_t page_index);
+    void _merge_stats(const OlapReaderStatistics& stats);
+
+    ColumnReader* _reader;
+    ColumnIteratorOptions _opts;
+    ThreadPool* _pool;
+    PagePrefetchBudget* _budget;
+    const int32_t _depth;
+
+    // the pages read ahead or in flight, by page index
+    std::map<int32_t, std::shared_ptr<PrefetchedPage>> _pages;
+    // the pages before this index have been considered
+    int32_t _next_page_index = 0;
+    // the page taken last time
+    int32_t _last_page_index = -1;
+
+    std::mutex _lock;
+    std::condition_variable _cond;
+    int32_t _num_in_flight = 0;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -37,7 +37,8 @@ namespace segment_v2 {
 struct ParsedPage {
     static Status create(PageHandle handle, const Slice& body, const DataPageFooterPB& footer,
                          const EncodingInfo* encoding, const PagePointer& page_pointer,
-                         uint32_t page_index, ParsedPage* result) {
+                         uint32_t page_index, ParsedPage* result,
+                         PageCacheHandle decoded_handle = PageCacheHandle()) {
         result->~ParsedPage();
         ParsedPage* page = new (result)(ParsedPage);
         page->page_handle = std::move(handle);
@@ -53,6 +54,10 @@ struct ParsedPage {
 
         Slice data_slice(body.data, body.size - null_size);
         PageDecoderOptions opts;
+        if (decoded_handle.cache() != nullptr) {
+            opts.decoded_values = decoded_handle.data();
+            page->decoded_handle = std::move(decoded_handle);
+        }
         RETURN_IF_ERROR(encoding->create_page_decoder(data_slice, opts, &page->data_decoder));
         RETURN_IF_ERROR(page->data_decoder->init());
 
@@ -73,6 +78,8 @@ struct ParsedPage {
     }
 
     PageHandle page_handle;
+    // the entry of the decoded page cache the decoder reads, if any
+    PageCacheHandle decoded_handle;
 
     bool has_null;
     Slice null_bitmap;
@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/primary_key_index.h"
+
+#include "olap/rowset/segment_v2/bloom_filter.h"
+#include "olap/rowset/segment_v2/bloom_filter_index_reader.h"
+#include "olap/rowset/segment_v2/encoding_info.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/rowset/segment_v2/indexed_column_writer.h"
+#include "olap/types.h"
+
+namespace doris {
+namespace segment_v2 {
+
+PrimaryKeyIndexBuilder::PrimaryKeyIndexBuilder(fs::WritableBlock* wblock) : _wblock(wblock) {}
+
+PrimaryKeyIndexBuilder::~PrimaryKeyIndexBuilder() = default;
+
+Status PrimaryKeyIndexBuilder::init() {
+    const auto* type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+    IndexedColumnWriterOptions options;
+    options.write_ordinal_index = true;
+    options.write_value_index = true;
+    options.encoding = EncodingInfo::get_default_encoding(type_info, true);
+    options.compression = LZ4F;
+    _index_builder.reset(new IndexedColumnWriter(options, type_info, _wblock));
+    return _index_builder->init();
+}
+
+Status PrimaryKeyIndexBuilder::add_item(const Slice& key) {
+    DCHECK(_num_rows == 0 || Slice(_max_key).compare(key) < 0)
+            << "primary keys must be added in ascending order";
+    RETURN_IF_ERROR(_index_builder->add(&key));
+    if (UNLIKELY(_num_rows == 0)) {
+        _min_key.assign(key.data, key.size);
+    }
+    _max_key.assign(key.data, key.size);
+    _size += key.size;
+    _num_rows++;
+    uint64_t hash = 0;
+    murmur_hash3_x64_64(key.data, key.size, BloomFilter::DEFAULT_SEED, &hash);
+    _key_hashes.push_back(hash);
+    return Status::OK();
+}
+
+Status PrimaryKeyIndexBuilder::finalize(PrimaryKeyIndexMetaPB* meta) {
+    RETURN_IF_ERROR(_index_builder->finish(meta->mutable_primary_key_index()));
+    meta->set_min_key(_min_key);
+    meta->set_max_key(_max_key);
+
+    // write the bloom filter of the keys in the format of a bloom filter index with one page
+    BloomFilterOptions bf_options;
+    std::unique_ptr<BloomFilter> bf;
+    RETURN_IF_ERROR(BloomFilter::create(BLOCK_BLOOM_FILTER, &bf));
+    RETURN_IF_ERROR(bf->init(_key_hashes.size(), bf_options.fpp, bf_options.strategy));
+    for (uint64_t hash : _key_hashes) {
+        bf->add_hash(hash);
+    }
+    BloomFilterIndexPB* bf_meta = meta->mutable_bloom_filter_index();
+    bf_meta->set_hash_strategy(bf_options.strategy);
+    bf_meta->set_algorithm(BLOCK_BLOOM_FILTER);
+    IndexedColumnWriterOptions options;
+    options.write_ordinal_index = true;
+    options.write_value_index = false;
+    options.encoding = PLAIN_ENCODING;
+    IndexedColumnWriter bf_writer(options, get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>(),
+                                  _wblock);
+    RETURN_IF_ERROR(bf_writer.init());
+    Slice data(bf->data(), bf->size());
+    RETURN_IF_ERROR(bf_writer.add(&data));
+    return bf_writer.finish(bf_meta->mutable_bloom_filter());
+}
+
+PrimaryKeyIndexReader::~PrimaryKeyIndexReader() = default;
+
+Status PrimaryKeyIndexReader::parse(const FilePathDesc& path_desc,
+                                    const PrimaryKeyIndexMetaPB& meta) {
+    _index_reader.reset(new IndexedColumnReader(path_desc, meta.primary_key_index()));
+    RETURN_IF_ERROR(_index_reader->load(true, false));
+    _min_key = meta.min_key();
+    _max_key = meta.max_key();
+    if (meta.has_bloom_filter_index()) {
+        BloomFilterIndexReader bf_reader(path_desc, &meta.bloom_filter_index());
+        RETURN_IF_ERROR(bf_reader.load(true, false));
+        std::unique_ptr<BloomFilterIndexIterator> bf_iter;
+        RETURN_IF_ERROR(bf_reader.new_iterator(&bf_iter));
+        RETURN_IF_ERROR(bf_iter->read_bloom_filter(0, &_bf));
+    }
+    return Status::OK();
+}
+
+bool PrimaryKeyIndexReader::check_present(const Slice& key) const {
+    return _bf == nullptr || _bf->test_hash(_bf->hash(key.data, key.size));
+}
+
+Status PrimaryKeyIndexReader::new_iterator(
+        std::unique_ptr<IndexedColumnIterator>* index_iterator) const {
+    DCHECK(_index_reader != nullptr);
+    index_iterator->reset(new IndexedColumnIterator(_index_reader.get()));
+    return Status::OK();
+}
+
+uint32_t PrimaryKeyIndexReader::num_rows() const {
+    DCHECK(_index_reader != nullptr);
+    return _index_reader->num_values();
+}
+
+} // namespace segment_v2
+} // namespace doris
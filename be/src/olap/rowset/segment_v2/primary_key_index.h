@@ -0,0 +1,117 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "env/env.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "gutil/macros.h"
+#include "util/slice.h"
+
+namespace doris {
+
+namespace fs {
+class WritableBlock;
+}
+
+namespace segment_v2 {
+
+class IndexedColumnIterator;
+class IndexedColumnReader;
+class IndexedColumnWriter;
+class BloomFilter;
+
+// Build the primary key index of a segment in a merge-on-write unique key tablet.
+//
+// The index stores the full encoded key of every row in row order, so the i-th value is
+// the key of row i. As the rows of a segment are sorted and unique by key, the index is
+// an IndexedColumn with both value index (to look up the row of a key) and ordinal index
+// (to scan the keys of the segment). A bloom filter of all the keys is written with the
+// index, so most lookups of the keys not in the segment don't read the index pages.
+// Usage:
+//      PrimaryKeyIndexBuilder builder(wblock);
+//      builder.init();
+//      builder.add_item(key1);
+//      ...
+//      builder.add_item(keyN);
+//      builder.finalize(&meta);
+class PrimaryKeyIndexBuilder {
+public:
+    explicit PrimaryKeyIndexBuilder(fs::WritableBlock* wblock);
+    ~PrimaryKeyIndexBuilder();
+
+    Status init();
+
+    // `key` must be greater than the last added key
+    Status add_item(const Slice& key);
+
+    uint32_t num_rows() const { return _num_rows; }
+
+    // size of the added keys, used to estimate the segment size
+    uint64_t size() const { return _size; }
+
+    Status finalize(PrimaryKeyIndexMetaPB* meta);
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(PrimaryKeyIndexBuilder);
+
+    fs::WritableBlock* _wblock;
+    uint32_t _num_rows = 0;
+    uint64_t _size = 0;
+    std::string _min_key;
+    std::string _max_key;
+    std::unique_ptr<IndexedColumnWriter> _index_builder;
+    // the hashes of the added keys, added to the bloom filter when it's sized by the number
+    // of keys in finalize()
+    std::vector<uint64_t> _key_hashes;
+};
+
+// thread-safe reader for the primary key index of a segment
+class PrimaryKeyIndexReader {
+public:
+    PrimaryKeyIndexReader() = default;
+    ~PrimaryKeyIndexReader();
+
+    Status parse(const FilePathDesc& path_desc, const PrimaryKeyIndexMetaPB& meta);
+
+    Status new_iterator(std::unique_ptr<IndexedColumnIterator>* index_iterator) const;
+
+    uint32_t num_rows() const;
+
+    Slice min_key() const { return Slice(_min_key); }
+    Slice max_key() const { return Slice(_max_key); }
+
+    // false if `key` is surely not in the segment, always true for the segments written
+    // without the bloom filter
+    bool check_present(const Slice& key) const;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN(PrimaryKeyIndexReader);
+
+    std::unique_ptr<IndexedColumnReader> _index_reader;
+    std::unique_ptr<BloomFilter> _bf;
+    std::string _min_key;
+    std::string _max_key;
+};
+
+} // namespace segment_v2
+} // namespace doris
@@ -215,15 +215,8 @@ public:
         }
 
         size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
-        size_t remaining = to_fetch;
-        uint8_t* data_ptr = dst->data();
-        bool result = false;
-        while (remaining > 0) {
-            result = _rle_decoder.Get(reinterpret_cast<CppType*>(data_ptr));
-            DCHECK(result);
-            remaining--;
-            data_ptr += SIZE_OF_TYPE;
-        }
+        size_t result = _rle_decoder.GetBatch(reinterpret_cast<CppType*>(dst->data()), to_fetch);
+        DCHECK_EQ(result, to_fetch);
 
         _cur_index += to_fetch;
         *n = to_fetch;
@@ -238,14 +231,14 @@ public:
         }
 
         size_t to_fetch = std::min(*n, static_cast<size_t>(_num_elements - _cur_index));
-        size_t remaining = to_fetch;
-        bool result = false;
-        CppType value;
-        while (remaining > 0) {
-            result = _rle_decoder.Get(&value);
-            DCHECK(result);
-            dst->insert_data((char*)(&value), SIZE_OF_TYPE);
-            remaining--;
+        // decoded into a buffer on the stack, a batch at a time
+        CppType values[BATCH_SIZE];
+        for (size_t remaining = to_fetch; remaining > 0;) {
+            size_t num = std::min(remaining, BATCH_SIZE);
+            size_t result = _rle_decoder.GetBatch(values, num);
+            DCHECK_EQ(result, num);
+            dst->insert_many_fix_len_data(reinterpret_cast<const char*>(values), num);
+            remaining -= num;
         }
 
         _cur_index += to_fetch;
@@ -260,6 +253,7 @@ public:
 private:
     typedef typename TypeTraits<Type>::CppType CppType;
     enum { SIZE_OF_TYPE = TypeTraits<Type>::size };
+    static constexpr size_t BATCH_SIZE = 1024;
 
     Slice _data;
     PageDecoderOptions _options;
@@ -19,12 +19,16 @@
 
 #include <utility>
 
+#include "common/config.h"
 #include "common/logging.h" // LOG
 #include "gutil/strings/substitute.h"
 #include "olap/fs/fs_util.h"
 #include "olap/rowset/segment_v2/column_reader.h" // ColumnReader
+#include "olap/rowset/segment_v2/decoded_column_cache.h"
 #include "olap/rowset/segment_v2/empty_segment_iterator.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/rowset/segment_v2/segment_writer.h" // k_segment_magic_length
 #include "olap/storage_engine.h"
@@ -51,7 +55,10 @@ Segment::Segment(const FilePathDesc& path_desc, uint32_t segment_id,
                  const TabletSchema* tablet_schema)
         : _path_desc(path_desc), _segment_id(segment_id), _tablet_schema(tablet_schema) {
 #ifndef BE_TEST
-    _mem_tracker = StorageEngine::instance()->tablet_mem_tracker();
+    // the tools read the segments without a storage engine
+    _mem_tracker = StorageEngine::instance() != nullptr
+                           ? StorageEngine::instance()->tablet_mem_tracker()
+                           : MemTracker::get_process_tracker();
 #else
     _mem_tracker = MemTracker::get_process_tracker();
 #endif
@@ -177,6 +184,40 @@ Status Segment::_load_index() {
     });
 }
 
+Status Segment::load_primary_key_index() {
+    if (!_is_open) {
+        RETURN_IF_ERROR(_open());
+    }
+    if (!has_primary_key_index()) {
+        return Status::NotSupported(strings::Substitute(
+                "segment $0 has no primary key index", _path_desc.filepath));
+    }
+    return _load_pk_index_once.call([this] {
+        _pk_index_reader.reset(new PrimaryKeyIndexReader());
+        return _pk_index_reader->parse(_path_desc, _footer.primary_key_index_meta());
+    });
+}
+
+Status Segment::lookup_row_key(const Slice& key, uint32_t* row_id) {
+    RETURN_IF_ERROR(load_primary_key_index());
+    if (key.compare(_pk_index_reader->min_key()) < 0 ||
+        key.compare(_pk_index_reader->max_key()) > 0) {
+        return Status::NotFound("key is out of the range of segment");
+    }
+    if (!_pk_index_reader->check_present(key)) {
+        return Status::NotFound("key is not in segment");
+    }
+    std::unique_ptr<IndexedColumnIterator> index_iterator;
+    RETURN_IF_ERROR(_pk_index_reader->new_iterator(&index_iterator));
+    bool exact_match = false;
+    RETURN_IF_ERROR(index_iterator->seek_at_or_after(&key, &exact_match));
+    if (!exact_match) {
+        return Status::NotFound("key is not in segment");
+    }
+    *row_id = index_iterator->get_current_ordinal();
+    return Status::OK();
+}
+
 Status Segment::_create_column_readers() {
     for (uint32_t ordinal = 0; ordinal < _footer.columns().size(); ++ordinal) {
         auto& column_pb = _footer.columns(ordinal);
@@ -218,9 +259,48 @@ Status Segment::new_column_iterator(uint32_t cid, ColumnIterator** iter) {
         *iter = default_value_iter.release();
         return Status::OK();
     }
+    if (config::enable_segment_constant_column) {
+        RETURN_IF_ERROR(_column_readers[cid]->new_constant_iterator(iter));
+        if (*iter != nullptr) {
+            return Status::OK();
+        }
+    }
+    auto cache = DecodedColumnCache::instance();
+    const TabletColumn& tablet_column = _tablet_schema->column(cid);
+    if (cache != nullptr && _tablet_schema->is_in_memory() &&
+        DecodedColumn::is_supported(tablet_column.type())) {
+        std::string key = DecodedColumnCache::cache_key(_path_desc, tablet_column.unique_id());
+        auto column = cache->lookup(key);
+        if (column != nullptr) {
+            *iter = new DecodedColumnIterator(_column_readers[cid].get(), std::move(column));
+            return Status::OK();
+        }
+        cache->load_async(key, shared_from_this(), _column_readers[cid].get(), _path_desc,
+                          tablet_column.type(), _footer.num_rows());
+    }
     return _column_readers[cid]->new_iterator(iter);
 }
 
+size_t Segment::meta_mem_usage() const {
+    size_t bytes = _footer.SpaceUsedLong() + _footer.short_key_index_page().size();
+    for (auto& reader : _column_readers) {
+        if (reader != nullptr) {
+            bytes += reader->index_mem_usage();
+        }
+    }
+    return bytes;
+}
+
+Status Segment::get_short_keys(std::vector<std::string>* keys, size_t max_keys) {
+    RETURN_IF_ERROR(_load_index());
+    size_t num_items = _sk_index_decoder->num_items();
+    size_t num_keys = max_keys == 0 ? num_items : std::min(num_items, max_keys);
+    for (size_t i = 0; i < num_keys; ++i) {
+        keys->push_back(_sk_index_decoder->key(i * num_items / num_keys).to_string());
+    }
+    return Status::OK();
+}
+
 Status Segment::new_bitmap_index_iterator(uint32_t cid, BitmapIndexIterator** iter) {
     if (_column_readers[cid] != nullptr && _column_readers[cid]->has_bitmap_index()) {
         return _column_readers[cid]->new_bitmap_index_iterator(iter);
@@ -228,5 +308,29 @@ Status Segment::new_bitmap_index_iterator(uint32_t cid, BitmapIndexIterator** it
     return Status::OK();
 }
 
+const ZoneMapPB* Segment::segment_zone_map(uint32_t cid) const {
+    if (cid >= _column_readers.size() || _column_readers[cid] == nullptr) {
+        return nullptr;
+    }
+    return _column_readers[cid]->segment_zone_map();
+}
+
+Status Segment::merge_ndv_sketch(uint32_t cid, HyperLogLog* sketch, bool* has_sketch) const {
+    if (cid >= _column_readers.size() || _column_readers[cid] == nullptr) {
+        *has_sketch = false;
+        return Status::OK();
+    }
+    return _column_readers[cid]->merge_ndv_sketch(sketch, has_sketch);
+}
+
+Status Segment::new_inverted_index_iterator(uint32_t cid, const std::string& parser,
+                                            BitmapIndexIterator** iter) {
+    if (_column_readers[cid] != nullptr && _column_readers[cid]->has_inverted_index() &&
+        _column_readers[cid]->inverted_index_parser() == parser) {
+        return _column_readers[cid]->new_inverted_index_iterator(iter);
+    }
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -34,6 +34,7 @@
 
 namespace doris {
 
+class HyperLogLog;
 class SegmentGroup;
 class TabletSchema;
 class ShortKeyIndexDecoder;
@@ -44,6 +45,7 @@ namespace segment_v2 {
 
 class BitmapIndexIterator;
 class ColumnReader;
+class PrimaryKeyIndexReader;
 class ColumnIterator;
 class Segment;
 class SegmentIterator;
@@ -71,10 +73,40 @@ public:
 
     uint32_t num_rows() const { return _footer.num_rows(); }
 
+    // false if the footer of a remote segment has not been read yet
+    bool is_open() const { return _is_open; }
+
     Status new_column_iterator(uint32_t cid, ColumnIterator** iter);
 
     Status new_bitmap_index_iterator(uint32_t cid, BitmapIndexIterator** iter);
 
+    // The zone map of the column `cid` of the whole segment, nullptr if the column has no
+    // zone map or isn't in this segment. The zone maps are in the footer, so no I/O.
+    const ZoneMapPB* segment_zone_map(uint32_t cid) const;
+
+    // Merge the HyperLogLog of the values of the column `cid` into `sketch`, set `*has_sketch`
+    // to false if the column has no sketch or isn't in this segment.
+    Status merge_ndv_sketch(uint32_t cid, HyperLogLog* sketch, bool* has_sketch) const;
+
+    // Set *iter to nullptr if the column has no inverted index built by `parser`.
+    Status new_inverted_index_iterator(uint32_t cid, const std::string& parser,
+                                       BitmapIndexIterator** iter);
+
+    bool has_primary_key_index() const { return _footer.has_primary_key_index_meta(); }
+
+    // Load and parse primary key index, only for segments having primary key index.
+    // May be called multiple times, subsequent calls will no op.
+    Status load_primary_key_index();
+
+    const PrimaryKeyIndexReader* get_primary_key_index() const {
+        DCHECK(_load_pk_index_once.has_called() && _load_pk_index_once.stored_result().ok());
+        return _pk_index_reader.get();
+    }
+
+    // Set *row_id to the row whose full encoded key is `key`,
+    // return NotFound if the segment doesn't contain the key.
+    Status lookup_row_key(const Slice& key, uint32_t* row_id);
+
     size_t num_short_keys() const { return _tablet_schema->num_short_key_columns(); }
 
     uint32_t num_rows_per_block() const {
@@ -99,6 +131,15 @@ public:
         return _sk_index_decoder->num_items() - 1;
     }
 
+    // Append the encoded short keys of the first rows of the row blocks of the segment,
+    // in the order of the keys. Only `max_keys` keys evenly spaced are appended if it's
+    // not 0 and there are more keys.
+    Status get_short_keys(std::vector<std::string>* keys, size_t max_keys = 0);
+
+    // The bytes of the metadata of the segment, i.e. the footer, the short key index and the
+    // indexes of the column readers, counting the lazily loaded indexes as loaded.
+    size_t meta_mem_usage() const;
+
     // only used by UT
     const SegmentFooterPB& footer() const { return _footer; }
 
@@ -140,6 +181,9 @@ private:
     PageHandle _sk_index_handle;
     // short key index decoder
     std::unique_ptr<ShortKeyIndexDecoder> _sk_index_decoder;
+    // used to guarantee that primary key index will be loaded at most once
+    DorisCallOnce<Status> _load_pk_index_once;
+    std::unique_ptr<PrimaryKeyIndexReader> _pk_index_reader;
     // segment footer need not to be read for remote storage, so _is_open is false. When remote file
     // need to be read. footer will be read and _is_open will be set to true.
     bool _is_open = false;
@@ -17,14 +17,21 @@
 
 #include "olap/rowset/segment_v2/segment_iterator.h"
 
+#include <algorithm>
+#include <limits>
+#include <map>
 #include <memory>
 #include <set>
 #include <utility>
 
+#include "common/config.h"
 #include "gutil/strings/substitute.h"
+#include "olap/bloom_filter_predicate.h"
 #include "olap/column_predicate.h"
 #include "olap/fs/fs_util.h"
 #include "olap/in_list_predicate.h"
+#include "olap/late_runtime_filter.h"
+#include "olap/match_predicate.h"
 #include "olap/olap_common.h"
 #include "olap/row.h"
 #include "olap/row_block2.h"
@@ -32,8 +39,11 @@
 #include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/segment.h"
 #include "olap/short_key_index.h"
+#include "olap/topn_predicate.h"
+#include "runtime/runtime_state.h"
 #include "util/doris_metrics.h"
 #include "util/simd/bits.h"
+#include "util/time.h"
 #include "vec/columns/column_dictionary.h"
 
 using strings::Substitute;
@@ -140,12 +150,19 @@ Status SegmentIterator::_init(bool is_vec) {
     fs::BlockManager* block_mgr = fs::fs_util::block_manager(_segment->_path_desc);
     RETURN_IF_ERROR(block_mgr->open_block(_segment->_path_desc, &_rblock));
     _row_bitmap.addRange(0, _segment->num_rows());
+    auto delete_bitmap_iter = _opts.delete_bitmap.find(_segment->id());
+    if (delete_bitmap_iter != _opts.delete_bitmap.end()) {
+        size_t pre_size = _row_bitmap.cardinality();
+        _row_bitmap -= *delete_bitmap_iter->second;
+        _opts.stats->rows_del_by_bitmap += (pre_size - _row_bitmap.cardinality());
+    }
     RETURN_IF_ERROR(_init_return_column_iterators());
     RETURN_IF_ERROR(_init_bitmap_index_iterators());
     // z-order can not use prefix index
     if (_segment->_tablet_schema->sort_type() != SortType::ZORDER) {
         RETURN_IF_ERROR(_get_row_ranges_by_keys());
     }
+    RETURN_IF_ERROR(_check_cancelled());
     RETURN_IF_ERROR(_get_row_ranges_by_column_conditions());
     if (is_vec) {
         _vec_init_lazy_materialization();
@@ -157,6 +174,13 @@ Status SegmentIterator::_init(bool is_vec) {
     return Status::OK();
 }
 
+Status SegmentIterator::_check_cancelled() const {
+    if (_opts.runtime_state != nullptr && _opts.runtime_state->is_cancelled()) {
+        return Status::Cancelled("Cancelled");
+    }
+    return Status::OK();
+}
+
 Status SegmentIterator::_get_row_ranges_by_keys() {
     DorisMetrics::instance()->segment_row_total->increment(num_rows());
 
@@ -167,6 +191,8 @@ Status SegmentIterator::_get_row_ranges_by_keys() {
 
     RowRanges result_ranges;
     for (auto& key_range : _opts.key_ranges) {
+        // there may be many key ranges, each of them seeks the short key index and the keys
+        RETURN_IF_ERROR(_check_cancelled());
         rowid_t lower_rowid = 0;
         rowid_t upper_rowid = num_rows();
         RETURN_IF_ERROR(_prepare_seek(key_range));
@@ -232,10 +258,17 @@ Status SegmentIterator::_get_row_ranges_by_column_conditions() {
     if (_row_bitmap.isEmpty()) {
         return Status::OK();
     }
+    RETURN_IF_ERROR(_apply_constant_column_predicates());
+    if (_row_bitmap.isEmpty()) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_apply_inverted_index());
+    RETURN_IF_ERROR(_check_cancelled());
     RETURN_IF_ERROR(_apply_bitmap_index());
 
     if (!_row_bitmap.isEmpty() &&
-        (_opts.conditions != nullptr || !_opts.delete_conditions.empty())) {
+        (_opts.conditions != nullptr || !_opts.delete_conditions.empty() ||
+         !_opts.like_predicates.empty())) {
         RowRanges condition_row_ranges = RowRanges::create_single(_segment->num_rows());
         RETURN_IF_ERROR(_get_row_ranges_from_conditions(&condition_row_ranges));
         size_t pre_size = _row_bitmap.cardinality();
@@ -243,6 +276,14 @@ Status SegmentIterator::_get_row_ranges_by_column_conditions() {
         _opts.stats->rows_conditions_filtered += (pre_size - _row_bitmap.cardinality());
     }
 
+    if (!_row_bitmap.isEmpty() && _opts.topn_predicate != nullptr) {
+        RETURN_IF_ERROR(_apply_topn_predicate());
+    }
+
+    if (!_row_bitmap.isEmpty() && _opts.late_runtime_filters != nullptr) {
+        RETURN_IF_ERROR(_apply_late_runtime_filters());
+    }
+
     // TODO(hkp): calculate filter rate to decide whether to
     // use zone map/bloom filter/secondary index or not.
     return Status::OK();
@@ -267,6 +308,20 @@ Status SegmentIterator::_get_row_ranges_from_conditions(RowRanges* condition_row
                 column_cond, &column_bf_row_ranges));
         RowRanges::ranges_intersection(bf_row_ranges, column_bf_row_ranges, &bf_row_ranges);
     }
+    // LIKE patterns only use ngram bloom filter index
+    std::map<uint32_t, std::vector<std::string>> like_patterns;
+    for (auto& like_predicate : _opts.like_predicates) {
+        uint32_t cid = like_predicate.first;
+        if (cid < _column_iterators.size() && _column_iterators[cid] != nullptr) {
+            like_patterns[cid].push_back(like_predicate.second);
+        }
+    }
+    for (auto& [cid, patterns] : like_patterns) {
+        RowRanges column_bf_row_ranges = RowRanges::create_single(num_rows());
+        RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_ngram_bloom_filter(
+                patterns, &column_bf_row_ranges));
+        RowRanges::ranges_intersection(bf_row_ranges, column_bf_row_ranges, &bf_row_ranges);
+    }
     size_t pre_size = condition_row_ranges->count();
     RowRanges::ranges_intersection(*condition_row_ranges, bf_row_ranges, condition_row_ranges);
     _opts.stats->rows_bf_filtered += (pre_size - condition_row_ranges->count());
@@ -315,6 +370,85 @@ Status SegmentIterator::_get_row_ranges_from_conditions(RowRanges* condition_row
     return Status::OK();
 }
 
+Status SegmentIterator::_apply_topn_predicate() {
+    TCondition condition;
+    if (!_opts.topn_predicate->get_condition(&condition)) {
+        return Status::OK();
+    }
+    ColumnId cid = _opts.topn_predicate->column_id();
+    if (cid >= _column_iterators.size() || _column_iterators[cid] == nullptr) {
+        return Status::OK();
+    }
+    CondColumn column_cond(*_segment->_tablet_schema, cid);
+    RETURN_IF_ERROR(column_cond.add_cond(condition, _segment->_tablet_schema->column(cid)));
+    RowRanges row_ranges = RowRanges::create_single(num_rows());
+    RETURN_IF_ERROR(
+            _column_iterators[cid]->get_row_ranges_by_zone_map(&column_cond, nullptr, &row_ranges));
+    size_t pre_size = _row_bitmap.cardinality();
+    _row_bitmap &= RowRanges::ranges_to_roaring(row_ranges);
+    _opts.stats->rows_stats_filtered += (pre_size - _row_bitmap.cardinality());
+    return Status::OK();
+}
+
+Status SegmentIterator::_apply_late_runtime_filters() {
+    const TabletSchema& tablet_schema = *_segment->_tablet_schema;
+    auto is_read_column = [this](int32_t cid) {
+        return cid >= 0 && cid < _column_iterators.size() && _column_iterators[cid] != nullptr;
+    };
+
+    std::map<int32_t, std::unique_ptr<CondColumn>> column_conds;
+    for (const auto& filter : *_opts.late_runtime_filters) {
+        if (!filter->is_published()) {
+            _pending_late_runtime_filters.push_back(filter.get());
+            continue;
+        }
+        for (const auto& condition : filter->conditions()) {
+            int32_t cid = tablet_schema.field_index(condition.column_name);
+            if (!is_read_column(cid)) {
+                continue;
+            }
+            auto& column_cond = column_conds[cid];
+            if (column_cond == nullptr) {
+                column_cond = std::make_unique<CondColumn>(tablet_schema, cid);
+            }
+            RETURN_IF_ERROR(column_cond->add_cond(condition, tablet_schema.column(cid)));
+        }
+        for (const auto& bloom_filter : filter->bloom_filters()) {
+            int32_t cid = tablet_schema.field_index(bloom_filter.first);
+            if (!is_read_column(cid)) {
+                continue;
+            }
+            ColumnPredicate* predicate = BloomFilterColumnPredicateFactory::create_column_predicate(
+                    cid, bloom_filter.second, tablet_schema.column(cid).type());
+            if (predicate != nullptr) {
+                _late_runtime_filter_predicates.emplace_back(predicate);
+                _col_predicates.push_back(predicate);
+            }
+        }
+    }
+
+    // IN filters probe the bloom filter indexes, both min/max and IN filters the zone maps
+    for (auto& [cid, column_cond] : column_conds) {
+        RowRanges row_ranges = RowRanges::create_single(num_rows());
+        RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_bloom_filter(column_cond.get(),
+                                                                              &row_ranges));
+        size_t pre_size = _row_bitmap.cardinality();
+        _row_bitmap &= RowRanges::ranges_to_roaring(row_ranges);
+        _opts.stats->rows_bf_filtered += (pre_size - _row_bitmap.cardinality());
+
+        RowRanges zone_map_row_ranges = RowRanges::create_single(num_rows());
+        RETURN_IF_ERROR(_column_iterators[cid]->get_row_ranges_by_zone_map(
+                column_cond.get(), nullptr, &zone_map_row_ranges));
+        pre_size = _row_bitmap.cardinality();
+        _row_bitmap &= RowRanges::ranges_to_roaring(zone_map_row_ranges);
+        _opts.stats->rows_stats_filtered += (pre_size - _row_bitmap.cardinality());
+        if (_row_bitmap.isEmpty()) {
+            break;
+        }
+    }
+    return Status::OK();
+}
+
 // filter rows by evaluating column predicates using bitmap indexes.
 // upon return, predicates that've been evaluated by bitmap indexes are removed from _col_predicates.
 Status SegmentIterator::_apply_bitmap_index() {
@@ -322,16 +456,46 @@ Status SegmentIterator::_apply_bitmap_index() {
     size_t input_rows = _row_bitmap.cardinality();
     std::vector<ColumnPredicate*> remaining_predicates;
 
+    auto can_apply = [this](const ColumnPredicate* pred) {
+        return _bitmap_index_iterators[pred->column_id()] != nullptr &&
+               pred->type() != PredicateType::MATCH && pred->can_do_bitmap_index_filter();
+    };
+    auto is_range = [](const ColumnPredicate* pred) {
+        return pred->type() == PredicateType::LT || pred->type() == PredicateType::LE ||
+               pred->type() == PredicateType::GT || pred->type() == PredicateType::GE;
+    };
+    // the range predicates of a column are evaluated together, e.g. BETWEEN only unions the
+    // bitmaps of the values between its bounds
+    std::map<ColumnId, std::vector<ColumnPredicate*>> range_predicates;
     for (auto pred : _col_predicates) {
-        if (_bitmap_index_iterators[pred->column_id()] == nullptr) {
+        if (can_apply(pred) && is_range(pred)) {
+            range_predicates[pred->column_id()].push_back(pred);
+        }
+    }
+    std::set<ColumnId> range_applied_columns;
+    for (auto& [cid, predicates] : range_predicates) {
+        if (_row_bitmap.isEmpty()) {
+            break;
+        }
+        bool applied = false;
+        RETURN_IF_ERROR(_apply_bitmap_index_range(cid, predicates, &applied));
+        if (applied) {
+            range_applied_columns.insert(cid);
+        }
+    }
+
+    for (auto pred : _col_predicates) {
+        if (!can_apply(pred)) {
             // no bitmap index for this column
             remaining_predicates.push_back(pred);
-        } else {
+        } else if (is_range(pred)) {
+            if (range_applied_columns.count(pred->column_id()) == 0) {
+                remaining_predicates.push_back(pred);
+            }
+        } else if (!_row_bitmap.isEmpty()) {
+            // no need to process further predicates once all rows have been pruned
             RETURN_IF_ERROR(pred->evaluate(_schema, _bitmap_index_iterators, _segment->num_rows(),
                                            &_row_bitmap));
-            if (_row_bitmap.isEmpty()) {
-                break; // all rows have been pruned, no need to process further predicates
-            }
         }
     }
     _col_predicates = std::move(remaining_predicates);
@@ -339,6 +503,126 @@ Status SegmentIterator::_apply_bitmap_index() {
     return Status::OK();
 }
 
+Status SegmentIterator::_apply_bitmap_index_range(ColumnId cid,
+                                                  const std::vector<ColumnPredicate*>& predicates,
+                                                  bool* applied) {
+    BitmapIndexIterator* iterator = _bitmap_index_iterators[cid];
+    // the null bitmap is stored after the bitmaps of the values
+    rowid_t ordinal_limit = iterator->bitmap_nums() - (iterator->has_null_bitmap() ? 1 : 0);
+    rowid_t from = 0;
+    rowid_t to = ordinal_limit;
+    for (auto pred : predicates) {
+        RETURN_IF_ERROR(pred->seek_bitmap_index_range(iterator, &from, &to));
+    }
+    to = std::max(from, to);
+
+    // union the bitmaps of the values in the range, or the fewer ones of the values out of it
+    rowid_t num_in_range = to - from;
+    rowid_t num_out_of_range = ordinal_limit - num_in_range;
+    if (std::min(num_in_range, num_out_of_range) >
+        static_cast<rowid_t>(std::max(config::bitmap_index_max_range_union_bitmaps, 0))) {
+        *applied = false;
+        return Status::OK();
+    }
+    *applied = true;
+    if (iterator->has_null_bitmap()) {
+        roaring::Roaring null_bitmap;
+        RETURN_IF_ERROR(iterator->read_null_bitmap(&null_bitmap));
+        _row_bitmap -= null_bitmap;
+    }
+    roaring::Roaring bitmap;
+    if (num_in_range <= num_out_of_range) {
+        RETURN_IF_ERROR(iterator->read_union_bitmap(from, to, &bitmap));
+        _row_bitmap &= bitmap;
+    } else {
+        RETURN_IF_ERROR(iterator->read_union_bitmap(0, from, &bitmap));
+        RETURN_IF_ERROR(iterator->read_union_bitmap(to, ordinal_limit, &bitmap));
+        _row_bitmap -= bitmap;
+    }
+    return Status::OK();
+}
+
+// filter rows by evaluating MATCH predicates using inverted indexes.
+// upon return, predicates that've been evaluated by inverted indexes are removed from
+// _col_predicates.
+Status SegmentIterator::_apply_inverted_index() {
+    SCOPED_RAW_TIMER(&_opts.stats->inverted_index_filter_timer);
+    size_t input_rows = _row_bitmap.cardinality();
+    std::vector<ColumnPredicate*> remaining_predicates;
+
+    for (auto pred : _col_predicates) {
+        if (pred->type() != PredicateType::MATCH || _row_bitmap.isEmpty()) {
+            remaining_predicates.push_back(pred);
+            continue;
+        }
+        auto match_pred = static_cast<MatchPredicate*>(pred);
+        BitmapIndexIterator* iter = nullptr;
+        RETURN_IF_ERROR(_segment->new_inverted_index_iterator(
+                pred->column_id(), match_pred->parser_name(), &iter));
+        if (iter == nullptr) {
+            // no inverted index built by the parser of predicate
+            remaining_predicates.push_back(pred);
+            continue;
+        }
+        std::unique_ptr<BitmapIndexIterator> iter_ptr(iter);
+        RETURN_IF_ERROR(match_pred->evaluate_inverted_index(iter, &_row_bitmap));
+    }
+    _col_predicates = std::move(remaining_predicates);
+    _opts.stats->rows_inverted_index_filtered += (input_rows - _row_bitmap.cardinality());
+    return Status::OK();
+}
+
+// upon return, the predicates of the constant columns that all the rows satisfy are removed
+// from _col_predicates, and the rows are all filtered if any of them isn't satisfied.
+Status SegmentIterator::_apply_constant_column_predicates() {
+    auto can_apply = [this](const ColumnPredicate* pred) {
+        switch (pred->type()) {
+        case PredicateType::EQ:
+        case PredicateType::NE:
+        case PredicateType::LT:
+        case PredicateType::LE:
+        case PredicateType::GT:
+        case PredicateType::GE:
+        case PredicateType::IN_LIST:
+        case PredicateType::NOT_IN_LIST:
+        case PredicateType::IS_NULL:
+        case PredicateType::IS_NOT_NULL:
+            break;
+        default:
+            return false;
+        }
+        ColumnId cid = pred->column_id();
+        return cid < _column_iterators.size() && _schema.column(cid) != nullptr &&
+               dynamic_cast<ConstantColumnIterator*>(_column_iterators[cid]) != nullptr;
+    };
+
+    std::vector<ColumnPredicate*> remaining_predicates;
+    for (auto pred : _col_predicates) {
+        if (!can_apply(pred)) {
+            remaining_predicates.push_back(pred);
+            continue;
+        }
+        ColumnId cid = pred->column_id();
+        const Field* field = _schema.column(cid);
+        auto column = Schema::get_predicate_column_nullable_ptr(field->type(),
+                                                                field->is_nullable());
+        size_t num = 1;
+        bool has_null = false;
+        RETURN_IF_ERROR(_column_iterators[cid]->seek_to_first());
+        RETURN_IF_ERROR(_column_iterators[cid]->next_batch(&num, column, &has_null));
+        uint16_t sel = 0;
+        uint16_t size = 1;
+        pred->evaluate(*column, &sel, &size);
+        if (size == 0) {
+            _opts.stats->rows_stats_filtered += _row_bitmap.cardinality();
+            _row_bitmap = roaring::Roaring();
+            return Status::OK();
+        }
+    }
+    _col_predicates = std::move(remaining_predicates);
+    return Status::OK();
+}
+
 Status SegmentIterator::_init_return_column_iterators() {
     if (_cur_rowid >= num_rows()) {
         return Status::OK();
@@ -349,7 +633,10 @@ Status SegmentIterator::_init_return_column_iterators() {
             ColumnIteratorOptions iter_opts;
             iter_opts.stats = _opts.stats;
             iter_opts.use_page_cache = _opts.use_page_cache;
+            iter_opts.bypass_page_cache_admission = _opts.bypass_page_cache_admission;
             iter_opts.rblock = _rblock.get();
+            iter_opts.prefetch_budget = _opts.page_prefetch_budget;
+            iter_opts.row_bitmap = &_row_bitmap;
             RETURN_IF_ERROR(_column_iterators[cid]->init(iter_opts));
         }
     }
@@ -513,6 +800,7 @@ Status SegmentIterator::next_batch(RowBlockV2* block) {
         }
         _inited = true;
     }
+    RETURN_IF_ERROR(_check_cancelled());
 
     uint32_t nrows_read = 0;
     uint32_t nrows_read_limit = block->capacity();
@@ -619,8 +907,8 @@ Status SegmentIterator::next_batch(RowBlockV2* block) {
  *    
  *   When Lazy Materialization enable, we need to read column at least two times.
  *   Firt time to read Pred col, second time to read non-pred.
- *   Here's an interesting question to research, whether read Pred col once is the best plan.
- *   (why not read Pred col twice or more?)
+ *   The string columns only used by short circuit predicates are read in between, only for the
+ *   rows passing the other predicates, if there are other predicates to evaluate first.
  *
  *   When Lazy Materialization disable, we just need to read once.
  *   
@@ -658,6 +946,7 @@ void SegmentIterator::_vec_init_lazy_materialization() {
             // Step1: check pred using short eval or vec eval
             if (type == OLAP_FIELD_TYPE_VARCHAR || type == OLAP_FIELD_TYPE_CHAR ||
                 type == OLAP_FIELD_TYPE_STRING || predicate->type() == PredicateType::BF ||
+                predicate->type() == PredicateType::BITMAP_FILTER ||
                 predicate->type() == PredicateType::IN_LIST ||
                 predicate->type() == PredicateType::NOT_IN_LIST ||
                 predicate->type() == PredicateType::IS_NULL ||
@@ -727,7 +1016,69 @@ void SegmentIterator::_vec_init_lazy_materialization() {
         }
     }
 
-    // Step 3: fill column ids for read and output
+    // Step 3: move the short circuit predicates on the string columns to the second stage, their
+    // columns are read only for the rows passing the other predicates
+    if (_lazy_materialization_read && config::enable_second_stage_lazy_materialization) {
+        std::set<ColumnId> second_stage_column_ids;
+        for (auto predicate : _short_cir_eval_predicate) {
+            auto cid = predicate->column_id();
+            FieldType type = _schema.column(cid)->type();
+            if ((type == OLAP_FIELD_TYPE_VARCHAR || type == OLAP_FIELD_TYPE_CHAR ||
+                 type == OLAP_FIELD_TYPE_STRING) &&
+                std::find(_vec_pred_column_ids.begin(), _vec_pred_column_ids.end(), cid) ==
+                        _vec_pred_column_ids.end() &&
+                del_cond_id_set.count(cid) == 0) {
+                second_stage_column_ids.insert(cid);
+            }
+        }
+        // there must be other predicates to evaluate first
+        if (!second_stage_column_ids.empty() &&
+            (_is_need_vec_eval ||
+             second_stage_column_ids.size() < _short_cir_pred_column_ids.size())) {
+            std::vector<ColumnPredicate*> first_stage_predicates;
+            for (auto predicate : _short_cir_eval_predicate) {
+                if (second_stage_column_ids.count(predicate->column_id()) > 0) {
+                    _second_stage_eval_predicate.push_back(predicate);
+                } else {
+                    first_stage_predicates.push_back(predicate);
+                }
+            }
+            _short_cir_eval_predicate = std::move(first_stage_predicates);
+            std::vector<ColumnId> short_cir_pred_column_ids;
+            for (auto cid : _short_cir_pred_column_ids) {
+                if (second_stage_column_ids.count(cid) == 0) {
+                    short_cir_pred_column_ids.push_back(cid);
+                }
+            }
+            _short_cir_pred_column_ids = std::move(short_cir_pred_column_ids);
+            _is_need_short_eval = !_short_cir_pred_column_ids.empty();
+            for (auto cid : second_stage_column_ids) {
+                pred_column_ids.erase(cid);
+            }
+            _second_stage_column_ids.assign(second_stage_column_ids.begin(),
+                                            second_stage_column_ids.end());
+        }
+    }
+
+    // measure the short circuit predicates on the first batches to order them, and to drop the
+    // ineffective runtime filters
+    if (config::predicate_reorder_sample_batches > 0) {
+        auto need_measure = [](const std::vector<ColumnPredicate*>& predicates) {
+            return predicates.size() > 1 ||
+                   (config::runtime_filter_min_filtered_percent > 0 &&
+                    std::any_of(predicates.begin(), predicates.end(), [](auto predicate) {
+                        return predicate->type() == PredicateType::BF;
+                    }));
+        };
+        if (need_measure(_short_cir_eval_predicate)) {
+            _short_cir_eval_stats.resize(_short_cir_eval_predicate.size());
+        }
+        if (need_measure(_second_stage_eval_predicate)) {
+            _second_stage_eval_stats.resize(_second_stage_eval_predicate.size());
+        }
+    }
+
+    // Step 4: fill column ids for read and output
     if (_lazy_materialization_read) {
         // insert pred cid to first_read_columns
         for (auto cid : pred_column_ids) {
@@ -899,17 +1250,8 @@ void SegmentIterator::_evaluate_short_circuit_predicate(uint16_t* vec_sel_rowid_
     }
 
     uint16_t original_size = *selected_size_ptr;
-    for (auto predicate : _short_cir_eval_predicate) {
-        auto column_id = predicate->column_id();
-        auto& short_cir_column = _current_return_columns[column_id];
-        auto* col_ptr = short_cir_column.get();
-        // range comparison predicate needs to sort the dict and convert the encoding
-        if (predicate->type() == PredicateType::LT || predicate->type() == PredicateType::LE ||
-            predicate->type() == PredicateType::GT || predicate->type() == PredicateType::GE) {
-            col_ptr->convert_dict_codes_if_necessary();
-        }
-        predicate->evaluate(*short_cir_column, vec_sel_rowid_idx, selected_size_ptr);
-    }
+    _evaluate_predicates(_short_cir_eval_predicate, &_short_cir_eval_stats, vec_sel_rowid_idx,
+                         selected_size_ptr);
     _opts.stats->rows_vec_cond_filtered += original_size - *selected_size_ptr;
 
     // evaluate delete condition
@@ -919,6 +1261,107 @@ void SegmentIterator::_evaluate_short_circuit_predicate(uint16_t* vec_sel_rowid_
     _opts.stats->rows_vec_del_cond_filtered += original_size - *selected_size_ptr;
 }
 
+void SegmentIterator::_evaluate_second_stage_predicate(uint16_t* sel_rowid_idx,
+                                                       uint16_t* selected_size,
+                                                       uint16_t* second_stage_sel) {
+    _read_columns_by_rowids(_second_stage_column_ids, _block_rowids, sel_rowid_idx, *selected_size,
+                            &_current_return_columns);
+
+    SCOPED_RAW_TIMER(&_opts.stats->short_cond_ns);
+    // the second stage columns only hold the rows `sel_rowid_idx`
+    uint16_t size = *selected_size;
+    for (uint16_t i = 0; i < size; ++i) {
+        second_stage_sel[i] = i;
+    }
+    _evaluate_predicates(_second_stage_eval_predicate, &_second_stage_eval_stats,
+                         second_stage_sel, &size);
+    // second_stage_sel[i] >= i, the rows are mapped in place
+    for (uint16_t i = 0; i < size; ++i) {
+        sel_rowid_idx[i] = sel_rowid_idx[second_stage_sel[i]];
+    }
+    _opts.stats->rows_vec_cond_filtered += *selected_size - size;
+    *selected_size = size;
+}
+
+void SegmentIterator::_evaluate_predicates(const std::vector<ColumnPredicate*>& predicates,
+                                           std::vector<PredicateEvalStats>* stats,
+                                           uint16_t* sel_rowid_idx, uint16_t* selected_size) {
+    bool measure = !stats->empty();
+    for (size_t i = 0; i < predicates.size() && *selected_size > 0; ++i) {
+        auto predicate = predicates[i];
+        int64_t start_ns = measure ? MonotonicNanos() : 0;
+        uint16_t input_rows = *selected_size;
+        auto* col_ptr = _current_return_columns[predicate->column_id()].get();
+        // range comparison predicate needs to sort the dict and convert the encoding
+        if (predicate->type() == PredicateType::LT || predicate->type() == PredicateType::LE ||
+            predicate->type() == PredicateType::GT || predicate->type() == PredicateType::GE) {
+            col_ptr->convert_dict_codes_if_necessary();
+        }
+        predicate->evaluate(*col_ptr, sel_rowid_idx, selected_size);
+        if (measure) {
+            auto& predicate_stats = (*stats)[i];
+            predicate_stats.input_rows += input_rows;
+            predicate_stats.output_rows += *selected_size;
+            predicate_stats.cost_ns += MonotonicNanos() - start_ns;
+        }
+    }
+}
+
+void SegmentIterator::_drop_ineffective_runtime_filters(
+        std::vector<ColumnPredicate*>* predicates, std::vector<PredicateEvalStats>* stats,
+        OlapReaderStatistics* reader_stats) {
+    if (stats->empty() || config::runtime_filter_min_filtered_percent <= 0) {
+        return;
+    }
+    size_t num_kept = 0;
+    for (size_t i = 0; i < predicates->size(); ++i) {
+        auto predicate = (*predicates)[i];
+        const auto& predicate_stats = (*stats)[i];
+        // the filters never reached are kept
+        if (predicate->type() == PredicateType::BF && predicate_stats.input_rows > 0 &&
+            (predicate_stats.input_rows - predicate_stats.output_rows) * 100 <
+                    predicate_stats.input_rows * config::runtime_filter_min_filtered_percent) {
+            VLOG_DEBUG << "drop the runtime filter on column " << predicate->column_id()
+                       << ", filtered " << predicate_stats.input_rows - predicate_stats.output_rows
+                       << " of " << predicate_stats.input_rows << " rows";
+            reader_stats->runtime_filters_dropped++;
+            continue;
+        }
+        (*predicates)[num_kept] = predicate;
+        (*stats)[num_kept] = predicate_stats;
+        ++num_kept;
+    }
+    predicates->resize(num_kept);
+    stats->resize(num_kept);
+}
+
+void SegmentIterator::_reorder_predicates(std::vector<ColumnPredicate*>* predicates,
+                                          std::vector<PredicateEvalStats>* stats) {
+    if (stats->empty()) {
+        return;
+    }
+    // the cost to filter out a row, the predicates never reached or filtering nothing are last
+    std::vector<std::pair<double, ColumnPredicate*>> ranked_predicates;
+    for (size_t i = 0; i < predicates->size(); ++i) {
+        const auto& predicate_stats = (*stats)[i];
+        double rank = std::numeric_limits<double>::max();
+        if (predicate_stats.output_rows < predicate_stats.input_rows) {
+            double cost_per_row =
+                    static_cast<double>(predicate_stats.cost_ns) / predicate_stats.input_rows;
+            double filter_rate = 1 - static_cast<double>(predicate_stats.output_rows) /
+                                             predicate_stats.input_rows;
+            rank = cost_per_row / filter_rate;
+        }
+        ranked_predicates.emplace_back(rank, (*predicates)[i]);
+    }
+    std::stable_sort(ranked_predicates.begin(), ranked_predicates.end(),
+                     [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    for (size_t i = 0; i < predicates->size(); ++i) {
+        (*predicates)[i] = ranked_predicates[i].second;
+    }
+    stats->clear();
+}
+
 void SegmentIterator::_read_columns_by_rowids(std::vector<ColumnId>& read_column_ids,
                                               std::vector<rowid_t>& rowid_vector,
                                               uint16_t* sel_rowid_idx, size_t select_size,
@@ -938,6 +1381,55 @@ void SegmentIterator::_read_columns_by_rowids(std::vector<ColumnId>& read_column
     }
 }
 
+void SegmentIterator::_record_output_rowids(const uint16_t* sel_rowid_idx,
+                                            uint16_t select_size) {
+    if (!_opts.record_rowids) {
+        return;
+    }
+    _output_rowids.resize(select_size);
+    for (uint16_t i = 0; i < select_size; ++i) {
+        _output_rowids[i] = _block_rowids[sel_rowid_idx == nullptr ? i : sel_rowid_idx[i]];
+    }
+}
+
+void SegmentIterator::_apply_arrived_runtime_filters() {
+    const TabletSchema& tablet_schema = *_segment->_tablet_schema;
+    // the pages are already pruned, only the bloom filters on the predicate columns read before
+    // the short circuit predicates are evaluated can still be applied
+    auto is_first_read_pred_column = [this](int32_t cid) {
+        return (_is_need_vec_eval || _is_need_short_eval) && cid >= 0 &&
+               cid < static_cast<int32_t>(_is_pred_column.size()) && _is_pred_column[cid] &&
+               std::find(_second_stage_column_ids.begin(), _second_stage_column_ids.end(), cid) ==
+                       _second_stage_column_ids.end();
+    };
+    for (auto it = _pending_late_runtime_filters.begin();
+         it != _pending_late_runtime_filters.end();) {
+        if (!(*it)->is_published()) {
+            ++it;
+            continue;
+        }
+        for (const auto& bloom_filter : (*it)->bloom_filters()) {
+            int32_t cid = tablet_schema.field_index(bloom_filter.first);
+            if (!is_first_read_pred_column(cid)) {
+                continue;
+            }
+            ColumnPredicate* predicate = BloomFilterColumnPredicateFactory::create_column_predicate(
+                    cid, bloom_filter.second, tablet_schema.column(cid).type());
+            if (predicate == nullptr) {
+                continue;
+            }
+            _late_runtime_filter_predicates.emplace_back(predicate);
+            _short_cir_eval_predicate.push_back(predicate);
+            if (!_short_cir_eval_stats.empty()) {
+                _short_cir_eval_stats.emplace_back();
+            }
+            _is_need_short_eval = true;
+            _opts.stats->runtime_filters_applied_in_flight++;
+        }
+        it = _pending_late_runtime_filters.erase(it);
+    }
+}
+
 Status SegmentIterator::next_batch(vectorized::Block* block) {
     bool is_mem_reuse = block->mem_reuse();
     DCHECK(is_mem_reuse);
@@ -946,7 +1438,7 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
     if (UNLIKELY(!_inited)) {
         RETURN_IF_ERROR(_init(true));
         _inited = true;
-        if (_lazy_materialization_read) {
+        if (_lazy_materialization_read || _opts.record_rowids) {
             _block_rowids.resize(_opts.block_row_max);
         }
         _current_return_columns.resize(_schema.columns().size());
@@ -962,12 +1454,20 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
             }
         }
     }
+    RETURN_IF_ERROR(_check_cancelled());
+    if (!_pending_late_runtime_filters.empty()) {
+        _apply_arrived_runtime_filters();
+    }
 
     _init_current_block(block, _current_return_columns);
 
     uint32_t nrows_read = 0;
     uint32_t nrows_read_limit = _opts.block_row_max;
-    _read_columns_by_index(nrows_read_limit, nrows_read, _lazy_materialization_read);
+    if (_opts.block_row_limit != nullptr) {
+        nrows_read_limit = std::clamp(*_opts.block_row_limit, 1, _opts.block_row_max);
+    }
+    _read_columns_by_index(nrows_read_limit, nrows_read,
+                           _lazy_materialization_read || _opts.record_rowids);
 
     _opts.stats->blocks_load += 1;
     _opts.stats->raw_rows_read += nrows_read;
@@ -986,6 +1486,7 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
 
     if (!_is_need_vec_eval && !_is_need_short_eval) {
         _output_non_pred_columns(block);
+        _record_output_rowids(nullptr, nrows_read);
     } else {
         uint16_t selected_size = nrows_read;
         uint16_t sel_rowid_idx[selected_size];
@@ -999,6 +1500,22 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
         //          In SSB test, it make no difference; So need more scenarios to test
         _evaluate_short_circuit_predicate(sel_rowid_idx, &selected_size);
 
+        // step 2.5: evaluate the second stage predicates on the rows passing the others
+        uint16_t second_stage_sel[_second_stage_column_ids.empty() ? 1 : nrows_read];
+        if (!_second_stage_column_ids.empty()) {
+            _evaluate_second_stage_predicate(sel_rowid_idx, &selected_size, second_stage_sel);
+        }
+        if (_sampled_batches < config::predicate_reorder_sample_batches &&
+            ++_sampled_batches == config::predicate_reorder_sample_batches) {
+            _drop_ineffective_runtime_filters(&_short_cir_eval_predicate, &_short_cir_eval_stats,
+                                              _opts.stats);
+            _drop_ineffective_runtime_filters(&_second_stage_eval_predicate,
+                                              &_second_stage_eval_stats, _opts.stats);
+            _reorder_predicates(&_short_cir_eval_predicate, &_short_cir_eval_stats);
+            _reorder_predicates(&_second_stage_eval_predicate, &_second_stage_eval_stats);
+        }
+        _record_output_rowids(sel_rowid_idx, selected_size);
+
         if (!_lazy_materialization_read) {
             Status ret = _output_column_by_sel_idx(block, _first_read_column_ids, sel_rowid_idx,
                                                    selected_size);
@@ -1024,6 +1541,10 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
         // todo(wb) need to tell input columnids from output columnids
         RETURN_IF_ERROR(_output_column_by_sel_idx(block, _first_read_column_ids, sel_rowid_idx,
                                                   selected_size));
+        // 4.4 output the second stage predicate column, which only holds the rows passing the
+        // first stage
+        RETURN_IF_ERROR(_output_column_by_sel_idx(block, _second_stage_column_ids,
+                                                  second_stage_sel, selected_size));
     }
 
     // shrink char_type suffix zero data
@@ -1032,5 +1553,48 @@ Status SegmentIterator::next_batch(vectorized::Block* block) {
     return Status::OK();
 }
 
+Status SegmentIterator::current_block_row_locations(std::vector<RowLocation>* locations) {
+    if (!_opts.record_rowids) {
+        return Status::NotSupported("the rowids are not recorded");
+    }
+    locations->clear();
+    locations->reserve(_output_rowids.size());
+    for (auto rowid : _output_rowids) {
+        locations->emplace_back(RowsetId(), _segment->id(), rowid);
+    }
+    return Status::OK();
+}
+
+Status SegmentIterator::read_by_rowids(const rowid_t* rowids, size_t count,
+                                       vectorized::Block* block) {
+    DCHECK(!_inited);
+    if (_rblock == nullptr) {
+        fs::BlockManager* block_mgr = fs::fs_util::block_manager(_segment->_path_desc);
+        RETURN_IF_ERROR(block_mgr->open_block(_segment->_path_desc, &_rblock));
+        RETURN_IF_ERROR(_init_return_column_iterators());
+        _vec_init_char_column_id();
+    }
+    for (size_t i = 0; i < _schema.num_column_ids(); ++i) {
+        auto cid = _schema.column_id(i);
+        auto column = (*std::move(block->get_by_position(i).column)).assume_mutable();
+        size_t start = 0;
+        while (start < count) {
+            DCHECK(rowids[start] < num_rows());
+            // read the consecutive rows at once
+            size_t end = start + 1;
+            while (end < count && rowids[end] == rowids[end - 1] + 1) {
+                ++end;
+            }
+            size_t n = end - start;
+            RETURN_IF_ERROR(_column_iterators[cid]->seek_to_ordinal(rowids[start]));
+            RETURN_IF_ERROR(_column_iterators[cid]->next_batch(&n, column));
+            start = end;
+        }
+        block->replace_by_position(i, std::move(column));
+    }
+    block->shrink_char_type_column_suffix_zero(_char_type_idx);
+    return Status::OK();
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -59,6 +59,13 @@ public:
     bool is_lazy_materialization_read() const override { return _lazy_materialization_read; }
     uint64_t data_id() const override { return _segment->id(); }
 
+    Status current_block_row_locations(std::vector<RowLocation>* locations) override;
+
+    // Read the rows `rowids` of the columns of the schema into `block`, in the order of
+    // `rowids`, which must be ascending. The options passed to init() other than the io ones
+    // are ignored, it can't be mixed with next_batch().
+    Status read_by_rowids(const rowid_t* rowids, size_t count, vectorized::Block* block);
+
 private:
     Status _init(bool is_vec = false);
 
@@ -66,6 +73,7 @@ private:
     Status _init_bitmap_index_iterators();
 
     // calculate row ranges that fall into requested key ranges using short key index
+    Status _check_cancelled() const;
     Status _get_row_ranges_by_keys();
     Status _prepare_seek(const StorageReadOptions::KeyRange& key_range);
     Status _lookup_ordinal(const RowCursor& key, bool is_include, rowid_t upper_bound,
@@ -75,7 +83,23 @@ private:
     // calculate row ranges that satisfy requested column conditions using various column index
     Status _get_row_ranges_by_column_conditions();
     Status _get_row_ranges_from_conditions(RowRanges* condition_row_ranges);
+    // filter the pages by the zone maps with the latest boundary of the Top-N sort
+    Status _apply_topn_predicate();
+    // filter the pages by the conditions of the late runtime filters published by now, and add
+    // their bloom filters to the column predicates
+    Status _apply_late_runtime_filters();
+    // add the bloom filters of the late runtime filters published after the segment was opened
+    // to the short circuit predicates, so they filter the next blocks
+    void _apply_arrived_runtime_filters();
     Status _apply_bitmap_index();
+    // evaluate the range predicates of the column `cid` by the bitmaps of one dictionary range,
+    // `applied` is false if there are too many bitmaps to union
+    Status _apply_bitmap_index_range(ColumnId cid, const std::vector<ColumnPredicate*>& predicates,
+                                     bool* applied);
+    Status _apply_inverted_index();
+    // evaluate the predicates of the columns having the same value in all the rows of the
+    // segment once, the rows are all filtered or the predicate is removed
+    Status _apply_constant_column_predicates();
 
     void _init_lazy_materialization();
     void _vec_init_lazy_materialization();
@@ -101,10 +125,37 @@ private:
                              std::vector<vectorized::MutableColumnPtr>& non_pred_vector);
     void _evaluate_vectorization_predicate(uint16_t* sel_rowid_idx, uint16_t& selected_size);
     void _evaluate_short_circuit_predicate(uint16_t* sel_rowid_idx, uint16_t* selected_size);
+    // read the columns of the second stage predicates for the rows `sel_rowid_idx` passing the
+    // others and evaluate them. Upon return, `sel_rowid_idx` holds the rows passing all the
+    // predicates, and `second_stage_sel` their positions in the second stage columns.
+    void _evaluate_second_stage_predicate(uint16_t* sel_rowid_idx, uint16_t* selected_size,
+                                          uint16_t* second_stage_sel);
+    // the cost and the selectivity of a predicate measured on the first batches
+    struct PredicateEvalStats {
+        int64_t input_rows = 0;
+        int64_t output_rows = 0;
+        int64_t cost_ns = 0;
+    };
+    // evaluate the short circuit `predicates` one after another on the rows passing the previous
+    // ones, `stats` are updated if they are not empty
+    void _evaluate_predicates(const std::vector<ColumnPredicate*>& predicates,
+                              std::vector<PredicateEvalStats>* stats, uint16_t* sel_rowid_idx,
+                              uint16_t* selected_size);
+    // remove the runtime bloom filters filtering less than runtime_filter_min_filtered_percent of
+    // the measured rows from `predicates`, a runtime filter isn't needed by the correctness
+    static void _drop_ineffective_runtime_filters(std::vector<ColumnPredicate*>* predicates,
+                                                  std::vector<PredicateEvalStats>* stats,
+                                                  OlapReaderStatistics* reader_stats);
+    // order `predicates` by the measured cost per filtered row, and stop measuring them
+    static void _reorder_predicates(std::vector<ColumnPredicate*>* predicates,
+                                    std::vector<PredicateEvalStats>* stats);
     void _output_non_pred_columns(vectorized::Block* block);
     void _read_columns_by_rowids(std::vector<ColumnId>& read_column_ids,
                                  std::vector<rowid_t>& rowid_vector, uint16_t* sel_rowid_idx,
                                  size_t select_size, vectorized::MutableColumns* mutable_columns);
+    // remember the rowids of the selected rows of `_block_rowids`, all the rows if
+    // `sel_rowid_idx` is nullptr
+    void _record_output_rowids(const uint16_t* sel_rowid_idx, uint16_t select_size);
 
     template <class Container>
     Status _output_column_by_sel_idx(vectorized::Block* block, const Container& column_ids,
@@ -146,6 +197,8 @@ private:
     // remember the rowids we've read for the current row block.
     // could be a local variable of next_batch(), kept here to reuse vector memory
     std::vector<rowid_t> _block_rowids;
+    // the rowids of the rows of the last returned block, only if `_opts.record_rowids`
+    std::vector<rowid_t> _output_rowids;
     bool _is_need_vec_eval = false;
     bool _is_need_short_eval = false;
 
@@ -158,6 +211,15 @@ private:
     vectorized::MutableColumns _current_return_columns;
     std::unique_ptr<AndBlockColumnPredicate> _pre_eval_block_predicate;
     std::vector<ColumnPredicate*> _short_cir_eval_predicate;
+    // the short circuit predicates on the columns only read for the rows passing the other
+    // predicates, only with lazy materialization, see _vec_init_lazy_materialization()
+    std::vector<ColumnPredicate*> _second_stage_eval_predicate;
+    std::vector<ColumnId> _second_stage_column_ids;
+    // the stats of `_short_cir_eval_predicate` and `_second_stage_eval_predicate` measured on
+    // the first `config::predicate_reorder_sample_batches` batches, empty when not measured
+    std::vector<PredicateEvalStats> _short_cir_eval_stats;
+    std::vector<PredicateEvalStats> _second_stage_eval_stats;
+    int _sampled_batches = 0;
     // when lazy materialization is enable, segmentIter need to read data at least twice
     // first, read predicate columns by various index
     // second, read non-predicate columns
@@ -171,6 +233,11 @@ private:
     StorageReadOptions _opts;
     // make a copy of `_opts.column_predicates` in order to make local changes
     std::vector<ColumnPredicate*> _col_predicates;
+    // the predicates of the bloom filters of the late runtime filters, also in `_col_predicates`
+    std::vector<std::unique_ptr<ColumnPredicate>> _late_runtime_filter_predicates;
+    // the late runtime filters not published yet when the segment was opened, see
+    // _apply_arrived_runtime_filters()
+    std::vector<const LateRuntimeFilter*> _pending_late_runtime_filters;
 
     // row schema of the key to seek
     // only used in `_get_row_ranges_by_keys`
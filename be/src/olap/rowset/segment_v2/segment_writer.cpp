@@ -17,6 +17,9 @@
 
 #include "olap/rowset/segment_v2/segment_writer.h"
 
+#include <numeric>
+
+#include "common/config.h"
 #include "common/logging.h" // LOG
 #include "env/env.h"        // Env
 #include "olap/data_dir.h"
@@ -25,6 +28,7 @@
 #include "olap/row_cursor.h"                      // RowCursor
 #include "olap/rowset/segment_v2/column_writer.h" // ColumnWriter
 #include "olap/rowset/segment_v2/page_io.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
 #include "olap/schema.h"
 #include "olap/short_key_index.h"
 #include "runtime/mem_tracker.h"
@@ -56,6 +60,9 @@ SegmentWriter::SegmentWriter(fs::WritableBlock* wblock, uint32_t segment_id,
         _short_key_coders.push_back(get_key_coder(column.type()));
         _short_key_index_size.push_back(column.index_length());
     }
+    for (size_t cid = 0; cid < _tablet_schema->num_key_columns(); ++cid) {
+        _key_coders.push_back(get_key_coder(_tablet_schema->column(cid).type()));
+    }
 }
 
 SegmentWriter::~SegmentWriter() {
@@ -77,20 +84,43 @@ void SegmentWriter::init_column_meta(ColumnMetaPB* meta, uint32_t* column_id,
     }
 }
 
-Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))) {
-    uint32_t column_id = 0;
-    _column_writers.reserve(_tablet_schema->columns().size());
-    for (auto& column : _tablet_schema->columns()) {
+Status SegmentWriter::init(uint32_t write_mbytes_per_sec) {
+    std::vector<uint32_t> column_ids(_tablet_schema->num_columns());
+    std::iota(column_ids.begin(), column_ids.end(), 0);
+    return init(write_mbytes_per_sec, column_ids, true);
+}
+
+Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused)),
+                           const std::vector<uint32_t>& col_ids, bool has_key) {
+    DCHECK(_column_writers.empty());
+    _column_ids = col_ids;
+    _has_key = has_key;
+    _num_rows_written = 0;
+    _column_writers.reserve(col_ids.size());
+    for (auto cid : col_ids) {
+        const auto& column = _tablet_schema->column(cid);
         ColumnWriterOptions opts;
         opts.meta = _footer.add_columns();
 
-        init_column_meta(opts.meta, &column_id, column);
+        init_column_meta(opts.meta, &_next_column_meta_id, column);
 
         // now we create zone map for key columns in AGG_KEYS or all column in UNIQUE_KEYS or DUP_KEYS
         // and not support zone map for array type.
         opts.need_zone_map = column.is_key() || _tablet_schema->keys_type() != KeysType::AGG_KEYS;
         opts.need_bloom_filter = column.is_bf_column();
         opts.need_bitmap_index = column.has_bitmap_index();
+        if (column.has_ngram_bf_index()) {
+            opts.ngram_bf_gram_size = column.ngram_bf_gram_size();
+            opts.ngram_bf_size = column.ngram_bf_size();
+        }
+        opts.inverted_index_parser = column.inverted_index_parser();
+        opts.adaptive_encoding = config::enable_adaptive_column_encoding;
+        if (config::enable_zstd_dict_compression &&
+            (column.type() == OLAP_FIELD_TYPE_CHAR || column.type() == OLAP_FIELD_TYPE_VARCHAR ||
+             column.type() == OLAP_FIELD_TYPE_STRING)) {
+            opts.meta->set_compression(ZSTD);
+            opts.train_compression_dict = true;
+        }
         if (column.type() == FieldType::OLAP_FIELD_TYPE_ARRAY) {
             opts.need_zone_map = false;
             if (opts.need_bloom_filter) {
@@ -99,22 +129,68 @@ Status SegmentWriter::init(uint32_t write_mbytes_per_sec __attribute__((unused))
             if (opts.need_bitmap_index) {
                 return Status::NotSupported("Do not support bitmap index for array type");
             }
+            if (opts.ngram_bf_gram_size > 0) {
+                return Status::NotSupported(
+                        "Do not support ngram bloom filter index for array type");
+            }
+            if (!opts.inverted_index_parser.empty()) {
+                return Status::NotSupported("Do not support inverted index for array type");
+            }
         }
+        opts.need_ndv_sketch = config::enable_segment_ndv_sketch &&
+                               column.type() != OLAP_FIELD_TYPE_ARRAY &&
+                               column.type() != OLAP_FIELD_TYPE_HLL &&
+                               column.type() != OLAP_FIELD_TYPE_OBJECT &&
+                               column.type() != OLAP_FIELD_TYPE_QUANTILE_STATE;
 
         std::unique_ptr<ColumnWriter> writer;
         RETURN_IF_ERROR(ColumnWriter::create(opts, &column, _wblock, &writer));
         RETURN_IF_ERROR(writer->init());
         _column_writers.push_back(std::move(writer));
     }
+    if (!has_key) {
+        return Status::OK();
+    }
     _index_builder.reset(new ShortKeyIndexBuilder(_segment_id, _opts.num_rows_per_block));
+    if (_tablet_schema->keys_type() == UNIQUE_KEYS &&
+        _tablet_schema->enable_unique_key_merge_on_write()) {
+        _primary_key_index_builder.reset(new PrimaryKeyIndexBuilder(_wblock));
+        RETURN_IF_ERROR(_primary_key_index_builder->init());
+    }
     return Status::OK();
 }
 
 Status SegmentWriter::append_block(const vectorized::Block* block, size_t row_pos,
                                    size_t num_rows) {
     assert(block && num_rows > 0 && row_pos + num_rows <= block->rows() &&
-           block->columns() == _column_writers.size());
-    _olap_data_convertor.set_source_content(block, row_pos, num_rows);
+           block->columns() >= _column_writers.size());
+    _olap_data_convertor.set_source_content_with_specified_columns(block, row_pos, num_rows,
+                                                                   _column_ids);
+
+    // convert column data from engine format to storage layer format
+    std::vector<vectorized::IOlapColumnDataAccessorSPtr> short_key_columns;
+    std::vector<vectorized::IOlapColumnDataAccessorSPtr> key_columns;
+    size_t num_key_columns = _tablet_schema->num_short_key_columns();
+    for (size_t i = 0; i < _column_writers.size(); ++i) {
+        auto cid = _column_ids[i];
+        auto converted_result = _olap_data_convertor.convert_column_data(cid);
+        if (converted_result.first != Status::OK()) {
+            return converted_result.first;
+        }
+        if (cid < num_key_columns) {
+            short_key_columns.push_back(converted_result.second);
+        }
+        if (cid < _key_coders.size()) {
+            key_columns.push_back(converted_result.second);
+        }
+        _column_writers[i]->append(converted_result.second->get_nullmap(),
+                                   converted_result.second->get_data(), num_rows);
+    }
+    _num_rows_written += num_rows;
+    if (!_has_key) {
+        _olap_data_convertor.clear_source_content();
+        return Status::OK();
+    }
 
     // find all row pos for short key indexes
     std::vector<size_t> short_key_pos;
@@ -126,19 +202,33 @@ Status SegmentWriter::append_block(const vectorized::Block* block, size_t row_po
         short_key_pos.push_back(_short_key_row_pos - _row_count);
     }
 
-    // convert column data from engine format to storage layer format
-    std::vector<vectorized::IOlapColumnDataAccessorSPtr> short_key_columns;
-    size_t num_key_columns = _tablet_schema->num_short_key_columns();
-    for (size_t cid = 0; cid < _column_writers.size(); ++cid) {
-        auto converted_result = _olap_data_convertor.convert_column_data(cid);
-        if (converted_result.first != Status::OK()) {
-            return converted_result.first;
+    // add the full keys of all rows into primary key index
+    if (_primary_key_index_builder != nullptr) {
+        std::vector<const void*> key_column_fields;
+        for (size_t pos = 0; pos < num_rows; ++pos) {
+            for (const auto& column : key_columns) {
+                key_column_fields.push_back(column->get_data_at(pos));
+            }
+            std::string encoded_key = _full_encode_keys(key_column_fields);
+            RETURN_IF_ERROR(_primary_key_index_builder->add_item(encoded_key));
+            key_column_fields.clear();
         }
-        if (cid < num_key_columns) {
-            short_key_columns.push_back(converted_result.second);
+    }
+
+    // the rows are sorted by keys, so the first and last rows bound the keys of the segment
+    if (key_columns.size() == _key_coders.size()) {
+        std::vector<const void*> key_column_fields;
+        if (_row_count == 0) {
+            for (const auto& column : key_columns) {
+                key_column_fields.push_back(column->get_data_at(0));
+            }
+            _min_encoded_key = _full_encode_keys(key_column_fields);
+            key_column_fields.clear();
+        }
+        for (const auto& column : key_columns) {
+            key_column_fields.push_back(column->get_data_at(num_rows - 1));
         }
-        _column_writers[cid]->append(converted_result.second->get_nullmap(),
-                                     converted_result.second->get_data(), num_rows);
+        _max_encoded_key = _full_encode_keys(key_column_fields);
     }
 
     // create short key indexes
@@ -189,13 +279,49 @@ std::string SegmentWriter::encode_short_keys(const std::vector<const void*> key_
     return encoded_keys;
 }
 
+std::string SegmentWriter::_full_encode_keys(const std::vector<const void*>& key_column_fields,
+                                             bool null_first) {
+    assert(key_column_fields.size() == _key_coders.size());
+
+    std::string encoded_keys;
+    for (size_t cid = 0; cid < _key_coders.size(); ++cid) {
+        auto field = key_column_fields[cid];
+        if (UNLIKELY(!field)) {
+            if (null_first) {
+                encoded_keys.push_back(KEY_NULL_FIRST_MARKER);
+            } else {
+                encoded_keys.push_back(KEY_NULL_LAST_MARKER);
+            }
+            continue;
+        }
+        encoded_keys.push_back(KEY_NORMAL_MARKER);
+        _key_coders[cid]->full_encode_ascending(field, &encoded_keys);
+    }
+    return encoded_keys;
+}
+
 template <typename RowType>
 Status SegmentWriter::append_row(const RowType& row) {
+    DCHECK(_has_key && _column_writers.size() == _tablet_schema->num_columns());
     for (size_t cid = 0; cid < _column_writers.size(); ++cid) {
         auto cell = row.cell(cid);
         RETURN_IF_ERROR(_column_writers[cid]->append(cell));
     }
 
+    std::vector<const void*> key_column_fields;
+    for (size_t cid = 0; cid < _key_coders.size(); ++cid) {
+        auto cell = row.cell(cid);
+        key_column_fields.push_back(cell.is_null() ? nullptr : cell.cell_ptr());
+    }
+    // the rows are sorted by keys, so the last row appended has the max key
+    _max_encoded_key = _full_encode_keys(key_column_fields);
+    if (_row_count == 0) {
+        _min_encoded_key = _max_encoded_key;
+    }
+    if (_primary_key_index_builder != nullptr) {
+        RETURN_IF_ERROR(_primary_key_index_builder->add_item(_max_encoded_key));
+    }
+
     // At the begin of one block, so add a short key index entry
     if ((_row_count % _opts.num_rows_per_block) == 0) {
         std::string encoded_key;
@@ -203,6 +329,7 @@ Status SegmentWriter::append_row(const RowType& row) {
         RETURN_IF_ERROR(_index_builder->add_item(encoded_key));
     }
     ++_row_count;
+    ++_num_rows_written;
     return Status::OK();
 }
 
@@ -219,7 +346,12 @@ uint64_t SegmentWriter::estimate_segment_size() {
     for (auto& column_writer : _column_writers) {
         size += column_writer->estimate_buffer_size();
     }
-    size += _index_builder->size();
+    if (_index_builder != nullptr) {
+        size += _index_builder->size();
+    }
+    if (_primary_key_index_builder != nullptr) {
+        size += _primary_key_index_builder->size();
+    }
 
     // update the mem_tracker of segment size
     _mem_tracker->consume(size - _mem_tracker->consumption());
@@ -227,11 +359,26 @@ uint64_t SegmentWriter::estimate_segment_size() {
 }
 
 Status SegmentWriter::finalize(uint64_t* segment_file_size, uint64_t* index_size) {
+    uint64_t columns_index_size = 0;
+    RETURN_IF_ERROR(finalize_columns(&columns_index_size));
+    uint64_t footer_index_size = 0;
+    RETURN_IF_ERROR(finalize_footer(segment_file_size, &footer_index_size));
+    *index_size = columns_index_size + footer_index_size;
+    return Status::OK();
+}
+
+Status SegmentWriter::finalize_columns(uint64_t* index_size) {
     // check disk capacity
     if (_data_dir != nullptr && _data_dir->reach_capacity_limit((int64_t)estimate_segment_size())) {
         return Status::InternalError(
                 fmt::format("disk {} exceed capacity limit.", _data_dir->path_hash()));
     }
+    // value columns must have the same number of rows as the key columns
+    if (!_has_key && _num_rows_written != _row_count) {
+        return Status::InternalError(
+                fmt::format("segment {} has {} rows, but {} rows are written to value columns",
+                            _segment_id, _row_count, _num_rows_written));
+    }
     for (auto& column_writer : _column_writers) {
         RETURN_IF_ERROR(column_writer->finish());
     }
@@ -241,7 +388,19 @@ Status SegmentWriter::finalize(uint64_t* segment_file_size, uint64_t* index_size
     RETURN_IF_ERROR(_write_zone_map());
     RETURN_IF_ERROR(_write_bitmap_index());
     RETURN_IF_ERROR(_write_bloom_filter_index());
+    *index_size = _wblock->bytes_appended() - index_offset;
+    // the pages of the columns are flushed, release the memory of this column group
+    _column_writers.clear();
+    _column_ids.clear();
+    _olap_data_convertor.clear_source_content();
+    return Status::OK();
+}
+
+Status SegmentWriter::finalize_footer(uint64_t* segment_file_size, uint64_t* index_size) {
+    DCHECK(_column_writers.empty()) << "all column groups must be finalized";
+    uint64_t index_offset = _wblock->bytes_appended();
     RETURN_IF_ERROR(_write_short_key_index());
+    RETURN_IF_ERROR(_write_primary_key_index());
     *index_size = _wblock->bytes_appended() - index_offset;
     RETURN_IF_ERROR(_write_footer());
     RETURN_IF_ERROR(_wblock->finalize());
@@ -297,6 +456,14 @@ Status SegmentWriter::_write_short_key_index() {
     return Status::OK();
 }
 
+Status SegmentWriter::_write_primary_key_index() {
+    if (_primary_key_index_builder == nullptr) {
+        return Status::OK();
+    }
+    CHECK_EQ(_primary_key_index_builder->num_rows(), _row_count);
+    return _primary_key_index_builder->finalize(_footer.mutable_primary_key_index_meta());
+}
+
 Status SegmentWriter::_write_footer() {
     _footer.set_num_rows(_row_count);
 
@@ -49,6 +49,7 @@ class WritableBlock;
 namespace segment_v2 {
 
 class ColumnWriter;
+class PrimaryKeyIndexBuilder;
 
 extern const char* k_segment_magic;
 extern const uint32_t k_segment_magic_length;
@@ -66,6 +67,12 @@ public:
 
     Status init(uint32_t write_mbytes_per_sec);
 
+    // Init the writer to write the columns `col_ids` only, used by vertical compaction,
+    // which writes the key columns (`has_key` is true) first and then the value columns
+    // group by group into the same segment.
+    Status init(uint32_t write_mbytes_per_sec, const std::vector<uint32_t>& col_ids,
+                bool has_key);
+
     template <typename RowType>
     Status append_row(const RowType& row);
 
@@ -75,10 +82,25 @@ public:
 
     uint64_t estimate_segment_size();
 
-    uint32_t num_rows_written() { return _row_count; }
+    // number of rows written of the current column group
+    uint32_t num_rows_written() { return _num_rows_written; }
+
+    // number of rows of the segment, decided by the key columns
+    uint32_t row_count() const { return _row_count; }
+
+    uint32_t get_segment_id() const { return _segment_id; }
+
+    // the full encoded keys of the first and the last rows, empty if no row is written
+    const std::string& min_encoded_key() const { return _min_encoded_key; }
+    const std::string& max_encoded_key() const { return _max_encoded_key; }
 
     Status finalize(uint64_t* segment_file_size, uint64_t* index_size);
 
+    // write the data and indexes of the current column group, and release its column writers
+    Status finalize_columns(uint64_t* index_size);
+    // write the short key index, primary key index and footer after all columns are written
+    Status finalize_footer(uint64_t* segment_file_size, uint64_t* index_size);
+
     static void init_column_meta(ColumnMetaPB* meta, uint32_t* column_id,
                                  const TabletColumn& column);
 
@@ -90,11 +112,15 @@ private:
     Status _write_bitmap_index();
     Status _write_bloom_filter_index();
     Status _write_short_key_index();
+    Status _write_primary_key_index();
     Status _write_footer();
     Status _write_raw_data(const std::vector<Slice>& slices);
 
     std::string encode_short_keys(const std::vector<const void*> key_column_fields,
                                   bool null_first = true);
+    // encode all key columns in full, used by primary key index and key bounds
+    std::string _full_encode_keys(const std::vector<const void*>& key_column_fields,
+                                  bool null_first = true);
 
 private:
     uint32_t _segment_id;
@@ -109,13 +135,25 @@ private:
     SegmentFooterPB _footer;
     std::unique_ptr<ShortKeyIndexBuilder> _index_builder;
     std::vector<std::unique_ptr<ColumnWriter>> _column_writers;
+    // the tablet column ids of `_column_writers`
+    std::vector<uint32_t> _column_ids;
+    bool _has_key = true;
+    // the next column id of the column meta in footer
+    uint32_t _next_column_meta_id = 0;
     std::shared_ptr<MemTracker> _mem_tracker;
     uint32_t _row_count = 0;
+    uint32_t _num_rows_written = 0;
 
     vectorized::OlapBlockDataConvertor _olap_data_convertor;
     std::vector<const KeyCoder*> _short_key_coders;
     std::vector<uint16_t> _short_key_index_size;
     size_t _short_key_row_pos = 0;
+
+    // only set in merge-on-write unique key tablets
+    std::unique_ptr<PrimaryKeyIndexBuilder> _primary_key_index_builder;
+    std::vector<const KeyCoder*> _key_coders;
+    std::string _min_encoded_key;
+    std::string _max_encoded_key;
 };
 
 } // namespace segment_v2
@@ -128,7 +128,8 @@ Status ZoneMapIndexReader::load(bool use_page_cache, bool kept_in_memory) {
     IndexedColumnIterator iter(&reader);
 
     MemPool pool("ZoneMapIndexReader ColumnBlock");
-    _page_zone_maps.resize(reader.num_values());
+    _offsets.reserve(reader.num_values() + 1);
+    _offsets.push_back(0);
 
     // read and cache all page zone maps
     for (int i = 0; i < reader.num_values(); ++i) {
@@ -145,11 +146,20 @@ Status ZoneMapIndexReader::load(bool use_page_cache, bool kept_in_memory) {
         DCHECK(num_to_read == num_read);
 
         Slice* value = reinterpret_cast<Slice*>(cvb->data());
-        if (!_page_zone_maps[i].ParseFromArray(value->data, value->size)) {
-            return Status::Corruption("Failed to parse zone map");
-        }
+        _data.append(value->data, value->size);
+        _offsets.push_back(_data.size());
         pool.clear();
     }
+    _data.shrink_to_fit();
+    return Status::OK();
+}
+
+Status ZoneMapIndexReader::page_zone_map(int32_t page, ZoneMapPB* zone_map) const {
+    DCHECK_LT(page, num_pages());
+    if (!zone_map->ParseFromArray(_data.data() + _offsets[page],
+                                  _offsets[page + 1] - _offsets[page])) {
+        return Status::Corruption("Failed to parse zone map");
+    }
     return Status::OK();
 }
 
@@ -120,18 +120,25 @@ public:
     explicit ZoneMapIndexReader(const FilePathDesc& path_desc, const ZoneMapIndexPB* index_meta)
             : _path_desc(path_desc), _index_meta(index_meta) {}
 
-    // load all page zone maps into memory
+    // load all page zone maps into memory, they are kept serialized and parsed on demand,
+    // which takes much less memory than the parsed ZoneMapPBs
     Status load(bool use_page_cache, bool kept_in_memory);
 
-    const std::vector<ZoneMapPB>& page_zone_maps() const { return _page_zone_maps; }
+    // parse the zone map of the `page`-th data page
+    Status page_zone_map(int32_t page, ZoneMapPB* zone_map) const;
 
-    int32_t num_pages() const { return _page_zone_maps.size(); }
+    int32_t num_pages() const { return _offsets.empty() ? 0 : _offsets.size() - 1; }
+
+    // the bytes of the loaded zone maps
+    size_t mem_usage() const { return _data.capacity() + _offsets.capacity() * sizeof(uint32_t); }
 
 private:
     FilePathDesc _path_desc;
     const ZoneMapIndexPB* _index_meta;
 
-    std::vector<ZoneMapPB> _page_zone_maps;
+    // the serialized zone map of the i-th page is _data[_offsets[i], _offsets[i + 1])
+    std::string _data;
+    std::vector<uint32_t> _offsets;
 };
 
 } // namespace segment_v2
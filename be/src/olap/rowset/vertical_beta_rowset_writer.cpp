@@ -0,0 +1,150 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/vertical_beta_rowset_writer.h"
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+
+namespace doris {
+
+VerticalBetaRowsetWriter::~VerticalBetaRowsetWriter() {
+    // ensure all files are closed before they are removed by BetaRowsetWriter on failure
+    _segment_writers.clear();
+}
+
+Status VerticalBetaRowsetWriter::add_columns(const vectorized::Block* block,
+                                             const std::vector<uint32_t>& col_ids, bool is_key,
+                                             uint32_t max_rows_per_segment) {
+    _is_key_group = is_key;
+    size_t num_rows = block->rows();
+    if (num_rows == 0) {
+        return Status::OK();
+    }
+    DCHECK_GT(max_rows_per_segment, 0);
+
+    size_t row_offset = 0;
+    if (is_key) {
+        // the key columns decide the segments
+        if (UNLIKELY(_segment_writers.empty())) {
+            std::unique_ptr<segment_v2::SegmentWriter> writer;
+            RETURN_NOT_OK(_create_segment_writer(col_ids, true, &writer));
+            _segment_writers.push_back(std::move(writer));
+        }
+        while (row_offset < num_rows) {
+            auto& writer = _segment_writers.back();
+            if (writer->num_rows_written() >= max_rows_per_segment) {
+                RETURN_NOT_OK(_flush_columns(&writer));
+                std::unique_ptr<segment_v2::SegmentWriter> new_writer;
+                RETURN_NOT_OK(_create_segment_writer(col_ids, true, &new_writer));
+                _segment_writers.push_back(std::move(new_writer));
+                continue;
+            }
+            size_t num_rows_to_add =
+                    std::min(num_rows - row_offset,
+                             size_t(max_rows_per_segment - writer->num_rows_written()));
+            auto s = writer->append_block(block, row_offset, num_rows_to_add);
+            if (UNLIKELY(!s.ok())) {
+                LOG(WARNING) << "failed to append block: " << s.to_string();
+                return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+            }
+            row_offset += num_rows_to_add;
+        }
+        _num_rows_written += num_rows;
+        return Status::OK();
+    }
+
+    // the value columns are filled into the segments in order
+    while (row_offset < num_rows) {
+        if (_cur_writer_idx >= _segment_writers.size()) {
+            LOG(WARNING) << "the value columns have more rows than the key columns, rowset_id="
+                         << _context.rowset_id;
+            return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+        }
+        auto& writer = _segment_writers[_cur_writer_idx];
+        if (!_cur_writer_inited) {
+            RETURN_NOT_OK(writer->init(config::push_write_mbytes_per_sec, col_ids, false));
+            _cur_writer_inited = true;
+        }
+        size_t num_rows_remaining = writer->row_count() - writer->num_rows_written();
+        if (num_rows_remaining == 0) {
+            RETURN_NOT_OK(_flush_columns(&writer));
+            ++_cur_writer_idx;
+            _cur_writer_inited = false;
+            continue;
+        }
+        size_t num_rows_to_add = std::min(num_rows - row_offset, num_rows_remaining);
+        auto s = writer->append_block(block, row_offset, num_rows_to_add);
+        if (UNLIKELY(!s.ok())) {
+            LOG(WARNING) << "failed to append block: " << s.to_string();
+            return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+        }
+        row_offset += num_rows_to_add;
+    }
+    return Status::OK();
+}
+
+Status VerticalBetaRowsetWriter::flush_columns() {
+    if (_segment_writers.empty()) {
+        return Status::OK();
+    }
+    if (_is_key_group) {
+        return _flush_columns(&_segment_writers.back());
+    }
+    // every segment must be filled by the value columns
+    if (!_cur_writer_inited || _cur_writer_idx + 1 != _segment_writers.size()) {
+        LOG(WARNING) << "the value columns have less rows than the key columns, rowset_id="
+                     << _context.rowset_id;
+        return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+    }
+    RETURN_NOT_OK(_flush_columns(&_segment_writers[_cur_writer_idx]));
+    _cur_writer_idx = 0;
+    _cur_writer_inited = false;
+    return Status::OK();
+}
+
+Status VerticalBetaRowsetWriter::_flush_columns(
+        std::unique_ptr<segment_v2::SegmentWriter>* segment_writer) {
+    uint64_t index_size = 0;
+    auto s = (*segment_writer)->finalize_columns(&index_size);
+    if (!s.ok()) {
+        LOG(WARNING) << "failed to finalize columns of segment: " << s.to_string();
+        return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+    }
+    _total_index_size += index_size;
+    return Status::OK();
+}
+
+Status VerticalBetaRowsetWriter::final_flush() {
+    for (auto& segment_writer : _segment_writers) {
+        uint64_t segment_size = 0;
+        uint64_t index_size = 0;
+        auto s = segment_writer->finalize_footer(&segment_size, &index_size);
+        if (!s.ok()) {
+            LOG(WARNING) << "failed to finalize segment: " << s.to_string();
+            return Status::OLAPInternalError(OLAP_ERR_WRITER_DATA_WRITE_ERROR);
+        }
+        _total_data_size += segment_size;
+        _total_index_size += index_size;
+        _add_segment_key_bounds(*segment_writer);
+    }
+    _segment_writers.clear();
+    return Status::OK();
+}
+
+} // namespace doris
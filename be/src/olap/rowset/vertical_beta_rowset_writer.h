@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "olap/rowset/beta_rowset_writer.h"
+
+namespace doris {
+
+// Rowset writer of vertical compaction.
+//
+// The key columns are written first, and the segments are split by the number of rows.
+// Then the value columns are written group by group, each group is written into the
+// segments in order with the same number of rows as the key columns. All the segment files
+// are kept open until `final_flush`, which writes the footers of the segments.
+// Usage:
+//      writer.add_columns(block, key_column_ids, true, max_rows_per_segment);
+//      ...
+//      writer.flush_columns();
+//      writer.add_columns(block, value_column_ids, false, max_rows_per_segment);
+//      ...
+//      writer.flush_columns();
+//      writer.final_flush();
+//      writer.build();
+class VerticalBetaRowsetWriter : public BetaRowsetWriter {
+public:
+    VerticalBetaRowsetWriter() = default;
+    ~VerticalBetaRowsetWriter() override;
+
+    Status add_columns(const vectorized::Block* block, const std::vector<uint32_t>& col_ids,
+                       bool is_key, uint32_t max_rows_per_segment) override;
+
+    Status flush_columns() override;
+
+    Status final_flush() override;
+
+private:
+    Status _flush_columns(std::unique_ptr<segment_v2::SegmentWriter>* segment_writer);
+
+    std::vector<std::unique_ptr<segment_v2::SegmentWriter>> _segment_writers;
+    // the segment written by the current value column group
+    size_t _cur_writer_idx = 0;
+    // whether the segment at `_cur_writer_idx` is inited for the current column group
+    bool _cur_writer_inited = false;
+    bool _is_key_group = true;
+};
+
+} // namespace doris
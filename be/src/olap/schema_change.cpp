@@ -21,10 +21,12 @@
 #include <signal.h>
 
 #include <algorithm>
+#include <numeric>
 #include <vector>
 
 #include "agent/cgroups_mgr.h"
 #include "common/resource_tls.h"
+#include "gutil/strings/substitute.h"
 #include "olap/merger.h"
 #include "olap/row.h"
 #include "olap/row_block.h"
@@ -38,6 +40,13 @@
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "util/defer_op.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/core/sort_block.h"
+#include "vec/data_types/data_type_factory.hpp"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+#include "vec/functions/simple_function_factory.h"
 
 using std::deque;
 using std::list;
@@ -666,6 +675,150 @@ Status RowBlockChanger::change_row_block(const RowBlock* ref_block, int32_t data
 #undef TYPE_REINTERPRET_CAST
 #undef ASSIGN_DEFAULT_VALUE
 
+namespace {
+
+bool is_integer_type(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_TINYINT:
+    case OLAP_FIELD_TYPE_SMALLINT:
+    case OLAP_FIELD_TYPE_INT:
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_LARGEINT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool is_string_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_VARCHAR || type == OLAP_FIELD_TYPE_STRING;
+}
+
+// the types whose default values are parsed from the strings by the cast function
+bool is_parsable_type(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_FLOAT:
+    case OLAP_FIELD_TYPE_DOUBLE:
+    case OLAP_FIELD_TYPE_DECIMAL:
+    case OLAP_FIELD_TYPE_DATE:
+    case OLAP_FIELD_TYPE_DATETIME:
+        return true;
+    default:
+        return is_integer_type(type);
+    }
+}
+
+// Cast the column to `type` by the vectorized cast function. The result is nullable, and a
+// value which can't be converted fails the schema change rather than being written as null.
+Status cast_column(const vectorized::ColumnWithTypeAndName& arg,
+                   const vectorized::DataTypePtr& type, const std::string& column_name,
+                   vectorized::ColumnPtr* result) {
+    vectorized::DataTypePtr result_type = vectorized::make_nullable(type);
+    auto param_type = std::make_shared<vectorized::DataTypeString>();
+    const std::string& type_name = vectorized::DataTypeFactory::instance().get(result_type);
+    size_t rows = arg.column->size();
+    vectorized::ColumnsWithTypeAndName arguments {
+            arg, {param_type->create_column_const(rows, type_name), param_type, type_name}};
+    auto function = vectorized::SimpleFunctionFactory::instance().get_function(
+            "CAST", arguments, result_type);
+    if (function == nullptr) {
+        LOG(WARNING) << "the column type which was altered from was unsupported. column="
+                     << column_name << ", from_type=" << arg.type->get_name()
+                     << ", to_type=" << result_type->get_name();
+        return Status::OLAPInternalError(OLAP_ERR_SCHEMA_CHANGE_INFO_INVALID);
+    }
+    vectorized::Block block(arguments);
+    block.insert({nullptr, result_type, column_name});
+    RETURN_IF_ERROR(function->execute(nullptr, block, {0, 1}, 2, rows));
+
+    vectorized::ColumnPtr converted =
+            block.get_by_position(2).column->convert_to_full_column_if_const();
+    const auto& converted_nullable = assert_cast<const vectorized::ColumnNullable&>(*converted);
+    const auto* arg_nullable =
+            vectorized::check_and_get_column<vectorized::ColumnNullable>(*arg.column);
+    for (size_t row = 0; row < rows; ++row) {
+        if (converted_nullable.is_null_at(row) &&
+            (arg_nullable == nullptr || !arg_nullable->is_null_at(row))) {
+            LOG(WARNING) << "failed to convert the value of column " << column_name << " from "
+                         << arg.type->get_name() << " to " << result_type->get_name()
+                         << ", value=" << arg.type->to_string(*arg.column, row);
+            return Status::OLAPInternalError(OLAP_ERR_DATA_QUALITY_ERR);
+        }
+    }
+    *result = std::move(converted);
+    return Status::OK();
+}
+
+} // namespace
+
+bool BlockChanger::is_supported() const {
+    for (size_t i = 0; i < _new_schema.num_columns(); ++i) {
+        const ColumnMapping& mapping = _schema_mapping[i];
+        FieldType new_type = _new_schema.column(i).type();
+        if (!mapping.materialized_function.empty()) {
+            return false;
+        }
+        if (mapping.ref_column >= 0) {
+            FieldType ref_type = _base_schema.column(mapping.ref_column).type();
+            if (ref_type != new_type && !(is_integer_type(ref_type) && is_integer_type(new_type))) {
+                return false;
+            }
+        } else if (!mapping.default_value->is_null() && !is_string_type(new_type) &&
+                   !is_parsable_type(new_type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+Status BlockChanger::change_block(const vectorized::Block& ref_block,
+                                  vectorized::Block* new_block) const {
+    const size_t rows = ref_block.rows();
+    for (size_t i = 0; i < _new_schema.num_columns(); ++i) {
+        const ColumnMapping& mapping = _schema_mapping[i];
+        const TabletColumn& new_column = _new_schema.column(i);
+        const vectorized::DataTypePtr new_type = new_block->get_by_position(i).type;
+        vectorized::ColumnPtr column;
+        if (mapping.ref_column >= 0) {
+            const auto& ref = ref_block.get_by_position(mapping.ref_column);
+            if (_base_schema.column(mapping.ref_column).type() == new_column.type()) {
+                column = ref.column;
+            } else {
+                RETURN_IF_ERROR(cast_column(ref, new_type, new_column.name(), &column));
+            }
+        } else if (mapping.default_value->is_null()) {
+            // new column, write default value
+            column = vectorized::make_nullable(new_type)
+                             ->create_column_const_with_default_value(rows)
+                             ->convert_to_full_column_if_const();
+        } else {
+            auto string_type = std::make_shared<vectorized::DataTypeString>();
+            vectorized::ColumnWithTypeAndName default_value {
+                    string_type->create_column_const(rows, mapping.default_value->to_string()),
+                    string_type, new_column.name()};
+            if (is_string_type(new_column.type())) {
+                column = default_value.column->convert_to_full_column_if_const();
+            } else {
+                RETURN_IF_ERROR(cast_column(default_value, new_type, new_column.name(), &column));
+            }
+        }
+
+        if (new_type->is_nullable()) {
+            column = vectorized::make_nullable(column);
+        } else if (column->is_nullable()) {
+            const auto& nullable = assert_cast<const vectorized::ColumnNullable&>(*column);
+            if (nullable.has_null()) {
+                LOG(WARNING) << "null values are written into the not nullable column "
+                             << new_column.name();
+                return Status::OLAPInternalError(OLAP_ERR_DATA_QUALITY_ERR);
+            }
+            column = nullable.get_nested_column_ptr();
+        }
+        new_block->replace_by_position(i, std::move(column));
+    }
+    return Status::OK();
+}
+
 RowBlockSorter::RowBlockSorter(RowBlockAllocator* row_block_allocator)
         : _row_block_allocator(row_block_allocator), _swap_row_block(nullptr) {}
 
@@ -1374,6 +1527,258 @@ bool SchemaChangeWithSorting::_external_sorting(vector<RowsetSharedPtr>& src_row
     return true;
 }
 
+namespace {
+
+// Check the row num of the new rowset as the row based schema change does.
+Status check_row_nums(const RowsetReaderSharedPtr& rowset_reader, RowsetWriter* rowset_writer,
+                      const SchemaChange& schema_change) {
+    Status res = Status::OK();
+    if (config::row_nums_check) {
+        if (rowset_reader->rowset()->num_rows() != rowset_writer->num_rows() +
+                                                           schema_change.merged_rows() +
+                                                           schema_change.filtered_rows()) {
+            LOG(WARNING) << "fail to check row num! "
+                         << "source_rows=" << rowset_reader->rowset()->num_rows()
+                         << ", merged_rows=" << schema_change.merged_rows()
+                         << ", filtered_rows=" << schema_change.filtered_rows()
+                         << ", new_index_rows=" << rowset_writer->num_rows();
+            res = Status::OLAPInternalError(OLAP_ERR_ALTER_STATUS_ERR);
+        }
+    }
+    LOG(INFO) << "all row nums. source_rows=" << rowset_reader->rowset()->num_rows()
+              << ", merged_rows=" << schema_change.merged_rows()
+              << ", filtered_rows=" << schema_change.filtered_rows()
+              << ", new_index_rows=" << rowset_writer->num_rows();
+    return res;
+}
+
+// Read the next block of the rowset, `eof` is set if there is no row left.
+Status read_next_block(const RowsetReaderSharedPtr& rowset_reader, vectorized::Block* block,
+                       bool* eof) {
+    block->clear_column_data();
+    Status st = rowset_reader->next_block(block);
+    if (st == Status::OLAPInternalError(OLAP_ERR_DATA_EOF)) {
+        *eof = true;
+        return Status::OK();
+    }
+    RETURN_NOT_OK_LOG(st, "failed to read the block of the rowset for schema change");
+    *eof = false;
+    return Status::OK();
+}
+
+std::vector<uint32_t> all_columns(const TabletSchema& tablet_schema) {
+    std::vector<uint32_t> columns(tablet_schema.num_columns());
+    std::iota(columns.begin(), columns.end(), 0);
+    return columns;
+}
+
+// Whether the delete predicates are still valid on the new schema, which means the rowsets could
+// be linked into the new tablet with their delete predicates instead of being rewritten.
+bool is_delete_predicates_valid(const TabletSchema& new_schema,
+                                const DelPredicateArray& delete_predicates) {
+    DeleteHandler delete_handler;
+    Status st = delete_handler.init(new_schema, delete_predicates, INT64_MAX);
+    delete_handler.finalize();
+    return st.ok();
+}
+
+} // namespace
+
+Status VSchemaChangeDirectly::process(RowsetReaderSharedPtr rowset_reader,
+                                      RowsetWriter* rowset_writer, TabletSharedPtr new_tablet,
+                                      TabletSharedPtr base_tablet) {
+    if (rowset_reader->rowset()->empty() || rowset_reader->rowset()->num_rows() == 0) {
+        Status res = rowset_writer->flush();
+        if (!res.ok()) {
+            LOG(WARNING) << "create empty version for schema change failed."
+                         << "version=" << rowset_writer->version().first << "-"
+                         << rowset_writer->version().second;
+            return Status::OLAPInternalError(OLAP_ERR_INPUT_PARAMETER_ERROR);
+        }
+        return Status::OK();
+    }
+
+    // Reset filtered_rows and merged_rows statistic
+    reset_merged_rows();
+    reset_filtered_rows();
+
+    const TabletSchema& new_schema = new_tablet->tablet_schema();
+    const std::vector<uint32_t> new_columns = all_columns(new_schema);
+    vectorized::Block ref_block =
+            base_tablet->tablet_schema().create_block(all_columns(base_tablet->tablet_schema()));
+    bool eof = false;
+    RETURN_IF_ERROR(read_next_block(rowset_reader, &ref_block, &eof));
+    while (!eof) {
+        vectorized::Block new_block = new_schema.create_block(new_columns);
+        RETURN_IF_ERROR(_block_changer.change_block(ref_block, &new_block));
+        RETURN_NOT_OK_LOG(rowset_writer->add_block(&new_block),
+                          "failed to write block for direct schema change");
+        RETURN_IF_ERROR(read_next_block(rowset_reader, &ref_block, &eof));
+    }
+
+    if (!rowset_writer->flush()) {
+        return Status::OLAPInternalError(OLAP_ERR_ALTER_STATUS_ERR);
+    }
+
+    // rows filtered by the delete conditions
+    add_filtered_rows(rowset_reader->filtered_rows());
+    return check_row_nums(rowset_reader, rowset_writer, *this);
+}
+
+VSchemaChangeWithSorting::VSchemaChangeWithSorting(const BlockChanger& block_changer,
+                                                   size_t memory_limitation)
+        : _block_changer(block_changer), _memory_limitation(memory_limitation) {
+    // the same temporary versions as the row based schema change with sorting
+    _temp_delta_versions.first = (1 << 28);
+    _temp_delta_versions.second = (1 << 28);
+}
+
+Status VSchemaChangeWithSorting::process(RowsetReaderSharedPtr rowset_reader,
+                                         RowsetWriter* rowset_writer, TabletSharedPtr new_tablet,
+                                         TabletSharedPtr base_tablet) {
+    if (rowset_reader->rowset()->empty() || rowset_reader->rowset()->num_rows() == 0) {
+        Status res = rowset_writer->flush();
+        if (!res.ok()) {
+            LOG(WARNING) << "create empty version for schema change failed."
+                         << " version=" << rowset_writer->version().first << "-"
+                         << rowset_writer->version().second;
+            return Status::OLAPInternalError(OLAP_ERR_INPUT_PARAMETER_ERROR);
+        }
+        return Status::OK();
+    }
+
+    // src_rowsets to store the rowset generated by internal sorting
+    std::vector<RowsetSharedPtr> src_rowsets;
+    Defer defer {[&]() {
+        // remove the intermediate rowsets generated by internal sorting
+        for (auto& row_set : src_rowsets) {
+            StorageEngine::instance()->add_unused_rowset(row_set);
+        }
+    }};
+
+    _temp_delta_versions.first = _temp_delta_versions.second;
+
+    // Reset filtered_rows and merged_rows statistic
+    reset_merged_rows();
+    reset_filtered_rows();
+
+    // the changed blocks are sorted and written into a temporary rowset once they exceed the
+    // memory limitation
+    vectorized::MutableBlock sort_buffer;
+    auto sort_and_write = [&]() -> Status {
+        vectorized::Block block = sort_buffer.to_block();
+        sort_buffer.clear();
+        RowsetSharedPtr rowset;
+        RETURN_IF_ERROR(_internal_sorting(
+                &block, Version(_temp_delta_versions.second, _temp_delta_versions.second),
+                new_tablet, &rowset));
+        src_rowsets.push_back(std::move(rowset));
+        // increase temp version
+        ++_temp_delta_versions.second;
+        return Status::OK();
+    };
+
+    const TabletSchema& new_schema = new_tablet->tablet_schema();
+    const std::vector<uint32_t> new_columns = all_columns(new_schema);
+    vectorized::Block ref_block =
+            base_tablet->tablet_schema().create_block(all_columns(base_tablet->tablet_schema()));
+    bool eof = false;
+    RETURN_IF_ERROR(read_next_block(rowset_reader, &ref_block, &eof));
+    while (!eof) {
+        vectorized::Block new_block = new_schema.create_block(new_columns);
+        RETURN_IF_ERROR(_block_changer.change_block(ref_block, &new_block));
+        sort_buffer.merge(std::move(new_block));
+        if (sort_buffer.allocated_bytes() >= _memory_limitation) {
+            RETURN_IF_ERROR(sort_and_write());
+        }
+        RETURN_IF_ERROR(read_next_block(rowset_reader, &ref_block, &eof));
+    }
+    if (!sort_buffer.empty()) {
+        RETURN_IF_ERROR(sort_and_write());
+    }
+
+    if (src_rowsets.empty()) {
+        Status res = rowset_writer->flush();
+        if (!res.ok()) {
+            LOG(WARNING) << "create empty version for schema change failed."
+                         << " version=" << rowset_writer->version().first << "-"
+                         << rowset_writer->version().second;
+            return Status::OLAPInternalError(OLAP_ERR_ALTER_STATUS_ERR);
+        }
+    } else {
+        RETURN_IF_ERROR(_external_sorting(src_rowsets, rowset_writer, new_tablet));
+    }
+
+    add_filtered_rows(rowset_reader->filtered_rows());
+    return check_row_nums(rowset_reader, rowset_writer, *this);
+}
+
+Status VSchemaChangeWithSorting::_internal_sorting(vectorized::Block* block,
+                                                   const Version& version,
+                                                   TabletSharedPtr new_tablet,
+                                                   RowsetSharedPtr* rowset) {
+    // sort by the keys, the null values are less than the others as in the storage
+    vectorized::SortDescription sort_description;
+    for (size_t i = 0; i < new_tablet->tablet_schema().num_key_columns(); ++i) {
+        sort_description.emplace_back(i, 1, -1);
+    }
+    vectorized::sort_block(*block, sort_description);
+
+    RowsetWriterContext context;
+    context.rowset_id = StorageEngine::instance()->next_rowset_id();
+    context.tablet_uid = new_tablet->tablet_uid();
+    context.tablet_id = new_tablet->tablet_id();
+    context.partition_id = new_tablet->partition_id();
+    context.tablet_schema_hash = new_tablet->schema_hash();
+    context.rowset_type = BETA_ROWSET;
+    context.path_desc = new_tablet->tablet_path_desc();
+    context.tablet_schema = &(new_tablet->tablet_schema());
+    context.data_dir = new_tablet->data_dir();
+    context.rowset_state = VISIBLE;
+    context.version = version;
+    context.segments_overlap = NONOVERLAPPING;
+
+    std::unique_ptr<RowsetWriter> rowset_writer;
+    RETURN_IF_ERROR(RowsetFactory::create_rowset_writer(context, &rowset_writer));
+    Defer defer {[&]() {
+        new_tablet->data_dir()->remove_pending_ids(ROWSET_ID_PREFIX +
+                                                   rowset_writer->rowset_id().to_string());
+    }};
+    RETURN_NOT_OK_LOG(rowset_writer->add_block(block),
+                      "failed to write the sorted block for schema change");
+    RETURN_NOT_OK_LOG(rowset_writer->flush(), "failed to flush the sorted block");
+    *rowset = rowset_writer->build();
+    if (*rowset == nullptr) {
+        LOG(WARNING) << "failed to build the rowset of the sorted block";
+        return Status::OLAPInternalError(OLAP_ERR_ALTER_STATUS_ERR);
+    }
+    return Status::OK();
+}
+
+Status VSchemaChangeWithSorting::_external_sorting(const std::vector<RowsetSharedPtr>& src_rowsets,
+                                                   RowsetWriter* rowset_writer,
+                                                   TabletSharedPtr new_tablet) {
+    std::vector<RowsetReaderSharedPtr> rs_readers;
+    for (auto& rowset : src_rowsets) {
+        RowsetReaderSharedPtr rs_reader;
+        RETURN_NOT_OK_LOG(rowset->create_reader(&rs_reader), "failed to create rowset reader.");
+        rs_readers.push_back(std::move(rs_reader));
+    }
+
+    Merger::Statistics stats;
+    auto res = Merger::vmerge_rowsets(new_tablet, READER_ALTER_TABLE, rs_readers, rowset_writer,
+                                      &stats);
+    if (!res.ok()) {
+        LOG(WARNING) << "failed to merge rowsets. tablet=" << new_tablet->full_name()
+                     << ", version=" << rowset_writer->version().first << "-"
+                     << rowset_writer->version().second;
+        return res;
+    }
+    add_merged_rows(stats.merged_rows);
+    add_filtered_rows(stats.filtered_rows);
+    return Status::OK();
+}
+
 SchemaChangeHandler::SchemaChangeHandler() {}
 
 SchemaChangeHandler::~SchemaChangeHandler() {}
@@ -1797,6 +2202,9 @@ Status SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangeParams
     // Add filter information in change, and filter column information will be set in _parse_request
     // And filter some data every time the row block changes
     RowBlockChanger rb_changer(sc_params.new_tablet->tablet_schema(), sc_params.delete_handler);
+    BlockChanger block_changer(sc_params.base_tablet->tablet_schema(),
+                               sc_params.new_tablet->tablet_schema(),
+                               rb_changer.get_schema_mapping());
 
     bool sc_sorting = false;
     bool sc_directly = false;
@@ -1811,7 +2219,17 @@ Status SchemaChangeHandler::_convert_historical_rowsets(const SchemaChangeParams
     }
 
     // b. Generate historical data converter
-    if (sc_sorting) {
+    if ((sc_sorting || sc_directly) &&
+        _can_change_vectorized(sc_params, block_changer, sc_sorting)) {
+        LOG(INFO) << "doing vectorized schema change " << (sc_sorting ? "with sorting" : "directly")
+                  << " for base_tablet " << sc_params.base_tablet->full_name();
+        if (sc_sorting) {
+            sc_procedure = new (nothrow) VSchemaChangeWithSorting(
+                    block_changer, config::memory_limitation_per_thread_for_schema_change_bytes);
+        } else {
+            sc_procedure = new (nothrow) VSchemaChangeDirectly(block_changer);
+        }
+    } else if (sc_sorting) {
         LOG(INFO) << "doing schema change with sorting for base_tablet "
                   << sc_params.base_tablet->full_name();
         sc_procedure = new (nothrow) SchemaChangeWithSorting(
@@ -1931,6 +2349,25 @@ PROCESS_ALTER_EXIT : {
     return res;
 }
 
+bool SchemaChangeHandler::_can_change_vectorized(const SchemaChangeParams& sc_params,
+                                                 const BlockChanger& block_changer,
+                                                 bool sc_sorting) {
+    if (!config::enable_vectorized_alter_table ||
+        sc_params.new_tablet->tablet_meta()->preferred_rowset_type() != BETA_ROWSET) {
+        return false;
+    }
+    // the rows of the same keys of the other key types are aggregated by the row based merger
+    if (sc_sorting && sc_params.new_tablet->keys_type() != DUP_KEYS) {
+        return false;
+    }
+    for (const auto& rs_reader : sc_params.ref_rowset_readers) {
+        if (rs_reader->rowset()->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            return false;
+        }
+    }
+    return block_changer.is_supported();
+}
+
 // @static
 // Analyze the mapping of the column and the mapping of the filter key
 Status SchemaChangeHandler::_parse_request(
@@ -1940,6 +2377,17 @@ Status SchemaChangeHandler::_parse_request(
                 materialized_function_map) {
     Status res = Status::OK();
 
+    // the converted rowsets get new rowset ids but no delete bitmap, so the deleted keys of the
+    // merge-on-write tablets would come back
+    if (base_tablet->enable_unique_key_merge_on_write() ||
+        new_tablet->enable_unique_key_merge_on_write()) {
+        LOG(WARNING) << "schema change of merge-on-write tablet is not supported. base_tablet="
+                     << base_tablet->full_name() << ", new_tablet=" << new_tablet->full_name();
+        return Status::NotSupported(
+                strings::Substitute("schema change of merge-on-write tablet $0 is not supported",
+                                    base_tablet->tablet_id()));
+    }
+
     // set column mapping
     for (int i = 0, new_schema_size = new_tablet->tablet_schema().num_columns();
          i < new_schema_size; ++i) {
@@ -2079,8 +2527,11 @@ Status SchemaChangeHandler::_parse_request(
         }
     }
 
-    if (base_tablet->delete_predicates().size() != 0) {
-        //there exists delete condition in header, can't do linked schema change
+    if (base_tablet->delete_predicates().size() != 0 &&
+        !is_delete_predicates_valid(new_tablet_schema, base_tablet->delete_predicates())) {
+        // there exists delete condition on the dropped columns, can't do linked schema change.
+        // Otherwise the delete predicates are linked with their rowsets, and the added columns
+        // are read by their default values from the linked segments.
         *sc_directly = true;
     }
 
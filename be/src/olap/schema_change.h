@@ -29,6 +29,7 @@
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/tablet.h"
+#include "vec/core/block.h"
 
 namespace doris {
 // defined in 'field.h'
@@ -73,6 +74,29 @@ private:
     DISALLOW_COPY_AND_ASSIGN(RowBlockChanger);
 };
 
+// Change the blocks of the base schema to the blocks of the new schema by the schema mapping,
+// the columns of the different types are converted by the vectorized cast functions. The rows
+// deleted by the delete conditions are filtered by the rowset readers.
+class BlockChanger {
+public:
+    BlockChanger(const TabletSchema& base_schema, const TabletSchema& new_schema,
+                 const SchemaMapping& schema_mapping)
+            : _base_schema(base_schema), _new_schema(new_schema), _schema_mapping(schema_mapping) {}
+
+    // Whether all the columns of the new schema can be changed by the block changer.
+    bool is_supported() const;
+
+    // `new_block` is created by the new schema.
+    Status change_block(const vectorized::Block& ref_block, vectorized::Block* new_block) const;
+
+private:
+    const TabletSchema& _base_schema;
+    const TabletSchema& _new_schema;
+    const SchemaMapping& _schema_mapping;
+
+    DISALLOW_COPY_AND_ASSIGN(BlockChanger);
+};
+
 class RowBlockAllocator {
 public:
     RowBlockAllocator(const TabletSchema& tablet_schema, size_t memory_limitation);
@@ -176,6 +200,45 @@ private:
     DISALLOW_COPY_AND_ASSIGN(SchemaChangeWithSorting);
 };
 
+// @brief vectorized schema change without sorting.
+class VSchemaChangeDirectly : public SchemaChange {
+public:
+    explicit VSchemaChangeDirectly(const BlockChanger& block_changer)
+            : _block_changer(block_changer) {}
+
+    Status process(RowsetReaderSharedPtr rowset_reader, RowsetWriter* rowset_writer,
+                   TabletSharedPtr new_tablet, TabletSharedPtr base_tablet) override;
+
+private:
+    const BlockChanger& _block_changer;
+
+    DISALLOW_COPY_AND_ASSIGN(VSchemaChangeDirectly);
+};
+
+// @brief vectorized schema change with sorting of the tablets of the duplicate keys. The
+// changed blocks are sorted in memory by sort_block and written into the temporary rowsets,
+// which are merged into the new rowset by the BlockReader.
+class VSchemaChangeWithSorting : public SchemaChange {
+public:
+    VSchemaChangeWithSorting(const BlockChanger& block_changer, size_t memory_limitation);
+
+    Status process(RowsetReaderSharedPtr rowset_reader, RowsetWriter* rowset_writer,
+                   TabletSharedPtr new_tablet, TabletSharedPtr base_tablet) override;
+
+private:
+    Status _internal_sorting(vectorized::Block* block, const Version& version,
+                             TabletSharedPtr new_tablet, RowsetSharedPtr* rowset);
+
+    Status _external_sorting(const std::vector<RowsetSharedPtr>& src_rowsets,
+                             RowsetWriter* rowset_writer, TabletSharedPtr new_tablet);
+
+    const BlockChanger& _block_changer;
+    size_t _memory_limitation;
+    Version _temp_delta_versions;
+
+    DISALLOW_COPY_AND_ASSIGN(VSchemaChangeWithSorting);
+};
+
 class SchemaChangeHandler {
 public:
     static SchemaChangeHandler* instance() {
@@ -222,6 +285,10 @@ private:
 
     Status _convert_historical_rowsets(const SchemaChangeParams& sc_params);
 
+    // Whether the historical rowsets can be converted by the vectorized schema change.
+    static bool _can_change_vectorized(const SchemaChangeParams& sc_params,
+                                       const BlockChanger& block_changer, bool sc_sorting);
+
     static Status _parse_request(TabletSharedPtr base_tablet, TabletSharedPtr new_tablet,
                                  RowBlockChanger* rb_changer, bool* sc_sorting, bool* sc_directly,
                                  const std::unordered_map<std::string, AlterMaterializedViewParam>&
@@ -17,6 +17,7 @@
 
 #include "olap/segment_loader.h"
 
+#include "common/config.h"
 #include "olap/rowset/rowset.h"
 #include "util/stopwatch.hpp"
 
@@ -24,15 +25,15 @@ namespace doris {
 
 SegmentLoader* SegmentLoader::_s_instance = nullptr;
 
-void SegmentLoader::create_global_instance(size_t capacity) {
+void SegmentLoader::create_global_instance(size_t capacity, LRUCacheType type) {
     DCHECK(_s_instance == nullptr);
-    static SegmentLoader instance(capacity);
+    static SegmentLoader instance(capacity, type);
     _s_instance = &instance;
 }
 
-SegmentLoader::SegmentLoader(size_t capacity) {
-    _cache = std::unique_ptr<Cache>(
-            new_typed_lru_cache("SegmentLoader:SegmentCache", capacity, LRUCacheType::NUMBER));
+SegmentLoader::SegmentLoader(size_t capacity, LRUCacheType type) {
+    _cache = std::unique_ptr<Cache>(new_cache_by_policy("SegmentLoader:SegmentCache", capacity,
+                                                        type, config::segment_cache_policy));
 }
 
 bool SegmentLoader::_lookup(const SegmentLoader::CacheKey& key, SegmentCacheHandle* handle) {
@@ -52,8 +53,12 @@ void SegmentLoader::_insert(const SegmentLoader::CacheKey& key, SegmentLoader::C
         delete cache_value;
     };
 
-    auto lru_handle = _cache->insert(key.encode(), &value, sizeof(SegmentLoader::CacheValue),
-                                     deleter, CachePriority::NORMAL);
+    size_t charge = sizeof(SegmentLoader::CacheValue);
+    for (auto& segment : value.segments) {
+        charge += segment->meta_mem_usage();
+    }
+    auto lru_handle =
+            _cache->insert(key.encode(), &value, charge, deleter, CachePriority::NORMAL);
     *handle = SegmentCacheHandle(_cache.get(), lru_handle);
 }
 
@@ -65,19 +65,17 @@ public:
     };
 
     // Create global instance of this class.
-    // "capacity" is the capacity of lru cache.
-    // TODO: Currently we use the number of rowset as the cache capacity.
-    // That is, the limit of cache is the number of rowset.
-    // This is because currently we cannot accurately estimate the memory occupied by a segment.
-    // After the estimation of segment memory usage is provided later, it is recommended
-    // to use Memory as the capacity limit of the cache.
-    static void create_global_instance(size_t capacity);
+    // "capacity" is the capacity of lru cache, the number of rowsets if `type` is NUMBER, or
+    // the bytes of the metadata of the segments (Segment::meta_mem_usage()) if `type` is SIZE.
+    // The entries are charged by the bytes of the metadata in both cases, which are
+    // recorded in the mem tracker of the cache.
+    static void create_global_instance(size_t capacity, LRUCacheType type = LRUCacheType::NUMBER);
 
     // Return global instance.
     // Client should call create_global_cache before.
     static SegmentLoader* instance() { return _s_instance; }
 
-    SegmentLoader(size_t capacity);
+    SegmentLoader(size_t capacity, LRUCacheType type = LRUCacheType::NUMBER);
 
     // Load segments of "rowset", return the "cache_handle" which contains segments.
     // If use_cache is true, it will be loaded from _cache.
@@ -106,6 +106,25 @@ void encode_key(std::string* buf, const RowType& row, size_t num_keys) {
     }
 }
 
+// Similar to `encode_key`, but encode the whole values of the cells, as the keys of the
+// primary key index.
+template <typename RowType, bool null_first = true>
+void full_encode_key(std::string* buf, const RowType& row, size_t num_keys) {
+    for (auto cid = 0; cid < num_keys; cid++) {
+        auto cell = row.cell(cid);
+        if (cell.is_null()) {
+            if (null_first) {
+                buf->push_back(KEY_NULL_FIRST_MARKER);
+            } else {
+                buf->push_back(KEY_NULL_LAST_MARKER);
+            }
+            continue;
+        }
+        buf->push_back(KEY_NORMAL_MARKER);
+        row.schema()->column(cid)->full_encode_ascending(cell.cell_ptr(), buf);
+    }
+}
+
 // Encode a segment short key indices to one ShortKeyPage. This version
 // only accepts binary key, client should assure that input key is sorted,
 // otherwise error could happens. This builder would arrange the page body in the
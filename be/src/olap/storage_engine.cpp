@@ -163,9 +163,23 @@ StorageEngine::~StorageEngine() {
     if (_tablet_meta_checkpoint_thread_pool) {
         _tablet_meta_checkpoint_thread_pool->shutdown();
     }
+    if (_segment_write_thread_pool) {
+        _segment_write_thread_pool->shutdown();
+    }
+    if (_page_prefetch_thread_pool) {
+        _page_prefetch_thread_pool->shutdown();
+    }
+    if (_publish_version_thread_pool) {
+        _publish_version_thread_pool->shutdown();
+    }
+    if (_compaction_key_range_thread_pool) {
+        _compaction_key_range_thread_pool->shutdown();
+    }
 }
 
 void StorageEngine::load_data_dirs(const std::vector<DataDir*>& data_dirs) {
+    MonotonicStopWatch watch;
+    watch.start();
     std::vector<std::thread> threads;
     for (auto data_dir : data_dirs) {
         threads.emplace_back([data_dir] {
@@ -180,6 +194,8 @@ void StorageEngine::load_data_dirs(const std::vector<DataDir*>& data_dirs) {
     for (auto& thread : threads) {
         thread.join();
     }
+    LOG(INFO) << "finish to load " << data_dirs.size() << " data dirs, cost "
+              << watch.elapsed_time() / 1000 / 1000 << "ms";
 }
 
 Status StorageEngine::_open() {
@@ -196,7 +212,10 @@ Status StorageEngine::_open() {
     _index_stream_lru_cache =
             new_lru_cache("SegmentIndexCache", config::index_stream_cache_capacity);
 
-    _file_cache.reset(new_lru_cache("FileHandlerCache", config::file_descriptor_cache_capacity));
+    _file_cache.reset(new_cache_by_policy("FileHandlerCache",
+                                          config::file_descriptor_cache_capacity,
+                                          LRUCacheType::SIZE,
+                                          config::file_descriptor_cache_policy));
 
     auto dirs = get_stores<false>();
     load_data_dirs(dirs);
@@ -204,6 +223,26 @@ Status StorageEngine::_open() {
     _memtable_flush_executor.reset(new MemTableFlushExecutor());
     _memtable_flush_executor->init(dirs);
 
+    ThreadPoolBuilder("SegmentWriteThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::parallel_segment_write_thread_num))
+            .build(&_segment_write_thread_pool);
+
+    ThreadPoolBuilder("PagePrefetchThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::column_page_prefetch_thread_num))
+            .build(&_page_prefetch_thread_pool);
+
+    ThreadPoolBuilder("PublishVersionThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::publish_version_tablet_thread_num))
+            .build(&_publish_version_thread_pool);
+
+    ThreadPoolBuilder("CompactionKeyRangeThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::compaction_key_range_thread_num))
+            .build(&_compaction_key_range_thread_pool);
+
     _parse_default_rowset_type();
 
     return Status::OK();
@@ -408,6 +447,7 @@ int64_t StorageEngine::get_file_or_directory_size(std::filesystem::path file_pat
 void StorageEngine::_start_disk_stat_monitor() {
     for (auto& it : _store_map) {
         it.second->health_check();
+        it.second->update_io_util();
     }
 
     _update_storage_medium_type_count();
@@ -583,6 +623,8 @@ void StorageEngine::stop() {
     THREAD_JOIN(_disk_stat_monitor_thread);
     THREAD_JOIN(_fd_cache_clean_thread);
     THREAD_JOIN(_tablet_checkpoint_tasks_producer_thread);
+    THREAD_JOIN(_tablet_tiering_thread);
+    THREAD_JOIN(_delete_predicate_bitmap_thread);
 #undef THREAD_JOIN
 
 #define THREADS_JOIN(threads)            \
@@ -137,6 +137,12 @@ public:
     TabletManager* tablet_manager() { return _tablet_manager.get(); }
     TxnManager* txn_manager() { return _txn_manager.get(); }
     MemTableFlushExecutor* memtable_flush_executor() { return _memtable_flush_executor.get(); }
+    ThreadPool* segment_write_thread_pool() { return _segment_write_thread_pool.get(); }
+    ThreadPool* page_prefetch_thread_pool() { return _page_prefetch_thread_pool.get(); }
+    ThreadPool* publish_version_thread_pool() { return _publish_version_thread_pool.get(); }
+    ThreadPool* compaction_key_range_thread_pool() {
+        return _compaction_key_range_thread_pool.get();
+    }
 
     bool check_rowset_id_in_unused_rowsets(const RowsetId& rowset_id);
 
@@ -240,6 +246,28 @@ private:
 
     void _tablet_checkpoint_callback(const std::vector<DataDir*>& data_dirs);
 
+    // move the tablets between the SSD and HDD data dirs by their scan heat
+    void _tablet_tiering_callback();
+    // evaluate the delete predicates of the tablets into their delete bitmaps
+    void _delete_predicate_bitmap_callback();
+    void _adjust_tablet_tiering();
+    struct TabletHeat {
+        TabletSharedPtr tablet;
+        double heat;
+        int64_t size;
+        bool on_ssd;
+    };
+    // sort the tablets by their heat, and choose the ones to promote to SSD and to demote to HDD,
+    // in the order to migrate them, as the indexes of the sorted tablets. Return the bytes of the
+    // tablets kept on SSD.
+    static int64_t _plan_tablet_tiering(std::vector<TabletHeat>* tablets, int64_t ssd_budget,
+                                        std::vector<size_t>* promotions,
+                                        std::vector<size_t>* demotions);
+    // migrate the tablet to a data dir of `storage_medium`, return false if there is no data dir
+    // of enough capacity
+    bool _migrate_tablet_to_medium(const TabletSharedPtr& tablet,
+                                   TStorageMedium::type storage_medium);
+
     // parse the default rowset type config to RowsetTypePB
     void _parse_default_rowset_type();
 
@@ -355,6 +383,8 @@ private:
     std::vector<scoped_refptr<Thread>> _path_scan_threads;
     // thread to produce tablet checkpoint tasks
     scoped_refptr<Thread> _tablet_checkpoint_tasks_producer_thread;
+    scoped_refptr<Thread> _tablet_tiering_thread;
+    scoped_refptr<Thread> _delete_predicate_bitmap_thread;
 
     // For tablet and disk-stat report
     std::mutex _report_mtx;
@@ -368,6 +398,13 @@ private:
     std::unique_ptr<RowsetIdGenerator> _rowset_id_generator;
 
     std::unique_ptr<MemTableFlushExecutor> _memtable_flush_executor;
+    // used to write the segments of a rowset writer in parallel
+    std::unique_ptr<ThreadPool> _segment_write_thread_pool;
+    std::unique_ptr<ThreadPool> _page_prefetch_thread_pool;
+    // used to publish the tablets of a publish version task in parallel
+    std::unique_ptr<ThreadPool> _publish_version_thread_pool;
+    // used to merge the key ranges of a compaction in parallel
+    std::unique_ptr<ThreadPool> _compaction_key_range_thread_pool;
 
     // Used to control the migration from segment_v1 to segment_v2, can be deleted in futrue.
     // Type of new loaded data
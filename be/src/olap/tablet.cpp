@@ -29,21 +29,30 @@
 #include <set>
 
 #include "olap/base_compaction.h"
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
 #include "olap/cumulative_compaction.h"
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/reader.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/rowset/rowset_meta_manager.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/rowset/segment_v2/primary_key_index.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/segment_loader.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_meta_manager.h"
+#include "olap/types.h"
 #include "util/path_util.h"
 #include "util/pretty_printer.h"
 #include "util/scoped_cleanup.h"
 #include "util/time.h"
 #include "util/trace.h"
+#include "vec/olap/block_reader.h"
 
 namespace doris {
 
@@ -201,6 +210,8 @@ Status Tablet::revise_tablet_meta(const std::vector<RowsetMetaSharedPtr>& rowset
     _stale_rs_version_map.clear();
     _tablet_meta->clear_stale_rowset();
 
+    _mark_report_dirty();
+
     LOG(INFO) << "finish to revise tablet. res=" << res << ", "
               << "table=" << full_name();
     return res;
@@ -245,6 +256,7 @@ Status Tablet::add_rowset(RowsetSharedPtr rowset, bool need_persist) {
         }
     }
     ++_newly_created_rowset_num;
+    _mark_report_dirty();
     return Status::OK();
 }
 
@@ -310,8 +322,10 @@ void Tablet::modify_rowsets(std::vector<RowsetSharedPtr>& to_add,
         for (auto& rs : to_delete) {
             LOG(INFO) << "add unused rowset " << rs->rowset_id() << " because of same version";
             StorageEngine::instance()->add_unused_rowset(rs);
+            _tablet_meta->delete_bitmap()->remove_rowset(rs->rowset_id());
         }
     }
+    _mark_report_dirty();
 }
 
 // snapshot manager may call this api to check if version exists, so that
@@ -337,6 +351,21 @@ const RowsetSharedPtr Tablet::get_stale_rowset_by_version(const Version& version
     return iter->second;
 }
 
+RowsetSharedPtr Tablet::get_rowset(const RowsetId& rowset_id) {
+    std::shared_lock rdlock(_meta_lock);
+    for (auto& version_rowset : _rs_version_map) {
+        if (version_rowset.second->rowset_id() == rowset_id) {
+            return version_rowset.second;
+        }
+    }
+    for (auto& stale_version_rowset : _stale_rs_version_map) {
+        if (stale_version_rowset.second->rowset_id() == rowset_id) {
+            return stale_version_rowset.second;
+        }
+    }
+    return nullptr;
+}
+
 // Already under _meta_lock
 const RowsetSharedPtr Tablet::rowset_with_max_version() const {
     Version max_version = _tablet_meta->max_version();
@@ -370,6 +399,32 @@ RowsetSharedPtr Tablet::_rowset_with_largest_size() {
 // add inc rowset should not persist tablet meta, because it will be persisted when publish txn.
 Status Tablet::add_inc_rowset(const RowsetSharedPtr& rowset) {
     DCHECK(rowset != nullptr);
+    std::unique_lock<std::mutex> rowset_update_lock(_rowset_update_lock, std::defer_lock);
+    DeleteBitmap delete_bitmap;
+    if (enable_unique_key_merge_on_write()) {
+        // mark the rows of the older rowsets replaced by this rowset before it's visible
+        rowset_update_lock.lock();
+        std::vector<RowsetSharedPtr> specified_rowsets;
+        {
+            std::shared_lock rdlock(_meta_lock);
+            if (_contains_rowset(rowset->rowset_id())) {
+                return Status::OK();
+            }
+            for (auto& it : _rs_version_map) {
+                if (it.first.second < rowset->start_version()) {
+                    specified_rowsets.push_back(it.second);
+                }
+            }
+        }
+        // a key is looked up in the newer rowsets first
+        std::sort(specified_rowsets.begin(), specified_rowsets.end(),
+                  [](const RowsetSharedPtr& a, const RowsetSharedPtr& b) {
+                      return a->end_version() > b->end_version();
+                  });
+        RETURN_NOT_OK(calc_delete_bitmap(rowset, specified_rowsets, &delete_bitmap,
+                                         rowset->end_version(), true));
+    }
+
     std::lock_guard<std::shared_mutex> wrlock(_meta_lock);
     if (_contains_rowset(rowset->rowset_id())) {
         return Status::OK();
@@ -382,6 +437,190 @@ Status Tablet::add_inc_rowset(const RowsetSharedPtr& rowset) {
     _timestamped_version_tracker.add_version(rowset->version());
 
     ++_newly_created_rowset_num;
+
+    if (enable_unique_key_merge_on_write()) {
+        _tablet_meta->delete_bitmap()->merge(delete_bitmap);
+        // the delete bitmap is only persisted in tablet meta
+        save_meta();
+    }
+    _mark_report_dirty();
+    return Status::OK();
+}
+
+Status Tablet::calc_delete_bitmap(const RowsetSharedPtr& rowset,
+                                  const std::vector<RowsetSharedPtr>& specified_rowsets,
+                                  DeleteBitmap* delete_bitmap, int64_t version,
+                                  bool check_pre_segments) {
+    if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+        return Status::NotSupported("merge-on-write only supports beta rowset");
+    }
+    SegmentCacheHandle segment_cache_handle;
+    RETURN_NOT_OK(SegmentLoader::instance()->load_segments(
+            std::static_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
+    std::vector<SegmentCacheHandle> specified_cache_handles(specified_rowsets.size());
+    for (size_t i = 0; i < specified_rowsets.size(); ++i) {
+        if (specified_rowsets[i]->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            return Status::NotSupported("merge-on-write only supports beta rowset");
+        }
+        RETURN_NOT_OK(SegmentLoader::instance()->load_segments(
+                std::static_pointer_cast<BetaRowset>(specified_rowsets[i]),
+                &specified_cache_handles[i], true));
+    }
+
+    // Set `*found` if `key` is in `segments`, and mark the row in the latest segment.
+    auto lookup_and_mark = [&](const RowsetId& rowset_id,
+                               const std::vector<segment_v2::SegmentSharedPtr>& segments,
+                               size_t num_segments, const Slice& key, bool* found) -> Status {
+        for (size_t i = num_segments; i > 0 && !*found; --i) {
+            auto& segment = segments[i - 1];
+            uint32_t row_id = 0;
+            Status st = segment->lookup_row_key(key, &row_id);
+            if (st.is_not_found()) {
+                continue;
+            }
+            RETURN_NOT_OK(st);
+            delete_bitmap->add({rowset_id, segment->id(), version}, row_id);
+            *found = true;
+        }
+        return Status::OK();
+    };
+
+    constexpr size_t batch_size = 1024;
+    const auto* type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+    auto& segments = segment_cache_handle.get_segments();
+    for (size_t seg_idx = 0; seg_idx < segments.size(); ++seg_idx) {
+        RETURN_NOT_OK(segments[seg_idx]->load_primary_key_index());
+        const auto* pk_index = segments[seg_idx]->get_primary_key_index();
+        std::unique_ptr<segment_v2::IndexedColumnIterator> index_iterator;
+        RETURN_NOT_OK(pk_index->new_iterator(&index_iterator));
+
+        std::unique_ptr<ColumnVectorBatch> cvb;
+        RETURN_NOT_OK(ColumnVectorBatch::create(batch_size, false, type_info, nullptr, &cvb));
+        MemPool pool("CalcDeleteBitmap");
+        uint32_t total_rows = pk_index->num_rows();
+        for (uint32_t row_id = 0; row_id < total_rows;) {
+            size_t num_read = std::min<size_t>(batch_size, total_rows - row_id);
+            ColumnBlock block(cvb.get(), &pool);
+            ColumnBlockView column_block_view(&block);
+            RETURN_NOT_OK(index_iterator->seek_to_ordinal(row_id));
+            RETURN_NOT_OK(index_iterator->next_batch(&num_read, &column_block_view));
+            DCHECK_GT(num_read, 0);
+            const auto* keys = reinterpret_cast<const Slice*>(cvb->data());
+            for (size_t i = 0; i < num_read; ++i) {
+                // the key is replaced by (so only need to be looked up in) the latest one,
+                // whose older copies are already marked when it was written
+                bool found = false;
+                if (check_pre_segments) {
+                    RETURN_NOT_OK(lookup_and_mark(rowset->rowset_id(), segments, seg_idx,
+                                                  keys[i], &found));
+                }
+                for (size_t j = 0; j < specified_rowsets.size() && !found; ++j) {
+                    auto& specified_segments = specified_cache_handles[j].get_segments();
+                    RETURN_NOT_OK(lookup_and_mark(specified_rowsets[j]->rowset_id(),
+                                                  specified_segments, specified_segments.size(),
+                                                  keys[i], &found));
+                }
+            }
+            row_id += num_read;
+            pool.clear();
+        }
+    }
+    return Status::OK();
+}
+
+Status Tablet::calc_delete_predicate_bitmaps(int max_rowsets, int* num_rowsets) {
+    *num_rowsets = 0;
+    // the delete bitmap of merge-on-write tablets is converted by compaction, which can't
+    // tell the marks of the delete predicates
+    if (enable_unique_key_merge_on_write()) {
+        return Status::OK();
+    }
+    int64_t max_delete_version = -1;
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rdlock(_meta_lock);
+        for (const auto& delete_predicate : _tablet_meta->delete_predicates()) {
+            max_delete_version = std::max(max_delete_version, delete_predicate.version());
+        }
+        if (max_delete_version < 0) {
+            return Status::OK();
+        }
+        for (auto& [version, rowset] : _rs_version_map) {
+            if (version.second < max_delete_version && rowset->num_rows() > 0 &&
+                rowset->rowset_meta()->rowset_type() == BETA_ROWSET &&
+                !rowset->rowset_meta()->has_delete_predicate()) {
+                rowsets.push_back(rowset);
+            }
+        }
+    }
+
+    for (auto& rowset : rowsets) {
+        if (*num_rowsets >= max_rowsets) {
+            break;
+        }
+        if (_tablet_meta->delete_bitmap()->max_version(
+                    {rowset->rowset_id(), 0, max_delete_version}) == max_delete_version) {
+            continue;
+        }
+        RETURN_NOT_OK(_calc_delete_predicate_bitmap(rowset, max_delete_version));
+        ++*num_rowsets;
+    }
+    if (*num_rowsets > 0) {
+        std::lock_guard<std::shared_mutex> wrlock(_meta_lock);
+        save_meta();
+    }
+    return Status::OK();
+}
+
+Status Tablet::_calc_delete_predicate_bitmap(const RowsetSharedPtr& rowset, int64_t version) {
+    SegmentCacheHandle segment_cache_handle;
+    RETURN_NOT_OK(SegmentLoader::instance()->load_segments(
+            std::static_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
+    RowsetReaderSharedPtr rs_reader;
+    RETURN_NOT_OK(rowset->create_reader(&rs_reader));
+
+    // read the rowset as a query of `version`, the rows not returned are deleted
+    vectorized::BlockReader reader;
+    TabletReader::ReaderParams reader_params;
+    reader_params.tablet = std::static_pointer_cast<Tablet>(shared_from_this());
+    reader_params.reader_type = READER_QUERY;
+    reader_params.direct_mode = true;
+    reader_params.record_rowids = true;
+    reader_params.version = Version(0, version);
+    reader_params.rs_readers.push_back(rs_reader);
+    reader_params.return_columns.push_back(0);
+    reader_params.origin_return_columns = &reader_params.return_columns;
+    RETURN_NOT_OK(reader.init(reader_params));
+
+    const auto& segments = segment_cache_handle.get_segments();
+    std::vector<roaring::Roaring> delete_bitmaps(segments.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        delete_bitmaps[i].addRange(0, segments[i]->num_rows());
+    }
+    vectorized::Block block = tablet_schema().create_block(reader_params.return_columns);
+    std::vector<RowLocation> row_locations;
+    bool eof = false;
+    while (!eof) {
+        RETURN_NOT_OK(reader.next_block_with_aggregation(&block, nullptr, nullptr, &eof));
+        RETURN_NOT_OK(reader.current_block_row_locations(&row_locations));
+        for (const auto& row_location : row_locations) {
+            DCHECK_LT(row_location.segment_id, delete_bitmaps.size());
+            delete_bitmaps[row_location.segment_id].remove(row_location.row_id);
+        }
+        block.clear_column_data();
+    }
+
+    // the empty bitmaps are also kept, they tell the segments are evaluated
+    std::shared_lock rdlock(_meta_lock);
+    auto it = _rs_version_map.find(rowset->version());
+    if (it == _rs_version_map.end() || it->second->rowset_id() != rowset->rowset_id()) {
+        // compacted during the evaluation
+        return Status::OK();
+    }
+    for (size_t i = 0; i < segments.size(); ++i) {
+        _tablet_meta->delete_bitmap()->set({rowset->rowset_id(), segments[i]->id(), version},
+                                           delete_bitmaps[i]);
+    }
     return Status::OK();
 }
 
@@ -391,6 +630,7 @@ void Tablet::_delete_stale_rowset_by_version(const Version& version) {
         return;
     }
     _tablet_meta->delete_stale_rs_meta_by_version(version);
+    _tablet_meta->delete_bitmap()->remove_rowset(rowset_meta->rowset_id());
     VLOG_NOTICE << "delete stale rowset. tablet=" << full_name() << ", version=" << version;
 }
 
@@ -732,12 +972,38 @@ uint32_t Tablet::calc_compaction_score(
     }
 }
 
+int64_t Tablet::calc_compaction_input_size(CompactionType compaction_type) {
+    std::shared_lock rdlock(_meta_lock);
+    const int64_t point = cumulative_layer_point();
+    int64_t input_size = 0;
+    for (auto& rs_meta : _tablet_meta->all_rs_metas()) {
+        bool is_cumulative = rs_meta->start_version() >= point;
+        if (is_cumulative == (compaction_type == CompactionType::CUMULATIVE_COMPACTION)) {
+            input_size += rs_meta->total_disk_size();
+        }
+    }
+    return input_size;
+}
+
+void Tablet::set_cumulative_compaction_policy(
+        std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy) {
+    const std::string& table_policy = _schema.compaction_policy();
+    if (table_policy.empty() || cumulative_compaction_policy->name() == table_policy) {
+        _cumulative_compaction_policy = cumulative_compaction_policy;
+    } else if (_cumulative_compaction_policy == nullptr ||
+               _cumulative_compaction_policy->name() != table_policy) {
+        _cumulative_compaction_policy =
+                CumulativeCompactionPolicyFactory::create_cumulative_compaction_policy(
+                        table_policy);
+    }
+}
+
 const uint32_t Tablet::_calc_cumulative_compaction_score(
         std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy) {
 #ifndef BE_TEST
     if (_cumulative_compaction_policy == nullptr ||
         _cumulative_compaction_policy->name() != cumulative_compaction_policy->name()) {
-        _cumulative_compaction_policy = cumulative_compaction_policy;
+        set_cumulative_compaction_policy(cumulative_compaction_policy);
     }
 #endif
     uint32_t score = 0;
@@ -1012,9 +1278,17 @@ Status Tablet::_contains_version(const Version& version) {
 }
 
 Status Tablet::set_partition_id(int64_t partition_id) {
+    _mark_report_dirty();
     return _tablet_meta->set_partition_id(partition_id);
 }
 
+void Tablet::_mark_report_dirty() {
+    StorageEngine* engine = StorageEngine::instance();
+    if (engine != nullptr) {
+        engine->tablet_manager()->mark_tablet_report_dirty(tablet_id());
+    }
+}
+
 TabletInfo Tablet::get_tablet_info() const {
     return TabletInfo(tablet_id(), schema_hash(), tablet_uid());
 }
@@ -1319,6 +1593,13 @@ double Tablet::calculate_scan_frequency() {
     return scan_frequency;
 }
 
+double Tablet::update_scan_heat() {
+    int64_t current_bytes = query_scan_bytes->value();
+    _scan_heat = _scan_heat / 2 + (current_bytes - _last_record_scan_bytes);
+    _last_record_scan_bytes = current_bytes;
+    return _scan_heat;
+}
+
 Status Tablet::prepare_compaction_and_calculate_permits(CompactionType compaction_type,
                                                         TabletSharedPtr tablet, int64_t* permits) {
     std::vector<RowsetSharedPtr> compaction_rowsets;
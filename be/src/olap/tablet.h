@@ -95,6 +95,7 @@ public:
     size_t next_unique_id() const;
     size_t row_size() const;
     int32_t field_index(const std::string& field_name) const;
+    bool enable_unique_key_merge_on_write() const;
 
     // operation in rowsets
     Status add_rowset(RowsetSharedPtr rowset, bool need_persist = true);
@@ -106,6 +107,8 @@ public:
     const RowsetSharedPtr get_rowset_by_version(const Version& version,
                                                 bool find_is_stale = false) const;
     const RowsetSharedPtr get_stale_rowset_by_version(const Version& version) const;
+    // The visible or stale rowset of `rowset_id`, nullptr if not found. Takes _meta_lock.
+    RowsetSharedPtr get_rowset(const RowsetId& rowset_id);
 
     const RowsetSharedPtr rowset_with_max_version() const;
 
@@ -150,11 +153,33 @@ public:
 
     std::mutex& get_schema_change_lock() { return _schema_change_lock; }
 
+    // serializes the updates of delete bitmap in merge-on-write unique key tablets,
+    // held by publishing and the commit of compaction
+    std::mutex& get_rowset_update_lock() { return _rowset_update_lock; }
+
+    // Mark the rows of `specified_rowsets` which have the same keys as the rows of `rowset`
+    // in `delete_bitmap` with `version`. If `check_pre_segments` is true, the rows of the
+    // earlier segments of `rowset` are also marked, as they are replaced by the later ones.
+    // The rowsets must be merge-on-write rowsets which have primary key index.
+    Status calc_delete_bitmap(const RowsetSharedPtr& rowset,
+                              const std::vector<RowsetSharedPtr>& specified_rowsets,
+                              DeleteBitmap* delete_bitmap, int64_t version,
+                              bool check_pre_segments = false);
+
+    // Evaluate the delete predicates on the older rowsets once, and mark the deleted rows in the
+    // delete bitmap of the tablet meta with the version of the latest delete predicate, so the
+    // reads of the versions after it don't evaluate the predicates on these rowsets again.
+    // At most `max_rowsets` rowsets are evaluated, the number of them is set in `num_rowsets`.
+    Status calc_delete_predicate_bitmaps(int max_rowsets, int* num_rowsets);
+
     // operation for compaction
     bool can_do_compaction(size_t path_hash, CompactionType compaction_type);
     uint32_t calc_compaction_score(
             CompactionType compaction_type,
             std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy);
+    // Estimated bytes rewritten by the compaction, which is the total disk size of the rowsets
+    // in the part of the compaction type, split by the cumulative point.
+    int64_t calc_compaction_input_size(CompactionType compaction_type);
 
     // operation for clone
     void calc_missed_versions(int64_t spec_version, std::vector<Version>* missed_versions);
@@ -234,6 +259,10 @@ public:
 
     double calculate_scan_frequency();
 
+    // Add the bytes scanned from the tablet since the last call to its scan heat after halving
+    // it, and return the new heat. Only called by the tablet tiering thread.
+    double update_scan_heat();
+
     Status prepare_compaction_and_calculate_permits(CompactionType compaction_type,
                                                     TabletSharedPtr tablet, int64_t* permits);
     void execute_compaction(CompactionType compaction_type);
@@ -242,10 +271,9 @@ public:
     void set_clone_occurred(bool clone_occurred) { _is_clone_occurred = clone_occurred; }
     bool get_clone_occurred() { return _is_clone_occurred; }
 
+    // the policy of the table property "compaction_policy" takes precedence over the given one
     void set_cumulative_compaction_policy(
-            std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy) {
-        _cumulative_compaction_policy = cumulative_compaction_policy;
-    }
+            std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy);
 
     std::shared_ptr<CumulativeCompactionPolicy> get_cumulative_compaction_policy() {
         return _cumulative_compaction_policy;
@@ -259,6 +287,8 @@ public:
 private:
     Status _init_once_action();
     void _print_missed_versions(const std::vector<Version>& missed_versions) const;
+    // include the tablet in the next incremental tablet report
+    void _mark_report_dirty();
     bool _contains_rowset(const RowsetId rowset_id);
     Status _contains_version(const Version& version);
 
@@ -271,6 +301,8 @@ private:
     /// Delete stale rowset by version. This method not only delete the version in expired rowset map,
     /// but also delete the version in rowset meta vector.
     void _delete_stale_rowset_by_version(const Version& version);
+    // mark the rows of `rowset` deleted by the delete predicates of versions <= `version`
+    Status _calc_delete_predicate_bitmap(const RowsetSharedPtr& rowset, int64_t version);
     Status _capture_consistent_rowsets_unlocked(const std::vector<Version>& version_path,
                                                 std::vector<RowsetSharedPtr>* rowsets) const;
 
@@ -296,6 +328,7 @@ private:
     std::mutex _base_compaction_lock;
     std::mutex _cumulative_compaction_lock;
     std::mutex _schema_change_lock;
+    std::mutex _rowset_update_lock;
     std::shared_mutex _migration_lock;
 
     // TODO(lingbin): There is a _meta_lock TabletMeta too, there should be a comment to
@@ -334,6 +367,9 @@ private:
     int64_t _last_record_scan_count;
     // the timestamp of the last record.
     time_t _last_record_scan_count_timestamp;
+    // the value of metric 'query_scan_bytes' when the scan heat was last updated
+    int64_t _last_record_scan_bytes = 0;
+    double _scan_heat = 0;
 
     std::shared_ptr<CumulativeCompaction> _cumulative_compaction;
     std::shared_ptr<BaseCompaction> _base_compaction;
@@ -453,4 +489,8 @@ inline size_t Tablet::row_size() const {
     return _schema.row_size();
 }
 
+inline bool Tablet::enable_unique_key_merge_on_write() const {
+    return _schema.keys_type() == UNIQUE_KEYS && _schema.enable_unique_key_merge_on_write();
+}
+
 } // namespace doris
@@ -0,0 +1,121 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "gutil/macros.h"
+#include "olap/olap_common.h"
+#include "olap/tablet.h"
+
+namespace doris {
+
+// A map from the tablet id to the tablet, for lookup without taking the lock of the writers.
+//
+// The tablets are hashed to a fixed number of buckets, and each bucket is an immutable sorted
+// array published by an atomic shared_ptr (read-copy-update). A writer copies the bucket it
+// changes and publishes the new one, a reader keeps the bucket it loaded alive until it
+// returns, so it never sees a partial update.
+//
+// find() may be called concurrently with anything, the writers must be serialized by the
+// caller, e.g. by holding the exclusive lock of the tablets shard.
+class TabletLookupMap {
+public:
+    TabletLookupMap() : _buckets(NUM_BUCKETS) {}
+    TabletLookupMap(TabletLookupMap&& other) = default;
+
+    TabletSharedPtr find(TTabletId tablet_id) const {
+        std::shared_ptr<const Bucket> bucket = std::atomic_load(&_bucket(tablet_id));
+        if (bucket == nullptr) {
+            return nullptr;
+        }
+        auto it = _lower_bound(*bucket, tablet_id);
+        if (it != bucket->end() && it->first == tablet_id) {
+            return it->second;
+        }
+        return nullptr;
+    }
+
+    void insert_or_assign(TTabletId tablet_id, const TabletSharedPtr& tablet) {
+        std::shared_ptr<const Bucket>& slot = _bucket(tablet_id);
+        auto bucket = slot == nullptr ? std::make_shared<Bucket>()
+                                      : std::make_shared<Bucket>(*slot);
+        auto it = _lower_bound(*bucket, tablet_id);
+        if (it != bucket->end() && it->first == tablet_id) {
+            it->second = tablet;
+        } else {
+            bucket->emplace(it, tablet_id, tablet);
+        }
+        std::atomic_store(&slot, std::shared_ptr<const Bucket>(std::move(bucket)));
+    }
+
+    void erase(TTabletId tablet_id) {
+        std::shared_ptr<const Bucket>& slot = _bucket(tablet_id);
+        if (slot == nullptr) {
+            return;
+        }
+        auto it = _lower_bound(*slot, tablet_id);
+        if (it == slot->end() || it->first != tablet_id) {
+            return;
+        }
+        auto bucket = std::make_shared<Bucket>();
+        bucket->reserve(slot->size() - 1);
+        bucket->insert(bucket->end(), slot->begin(), it);
+        bucket->insert(bucket->end(), it + 1, slot->end());
+        std::atomic_store(&slot, std::shared_ptr<const Bucket>(std::move(bucket)));
+    }
+
+private:
+    // sorted by the tablet id
+    using Bucket = std::vector<std::pair<TTabletId, TabletSharedPtr>>;
+
+    // the buckets are small enough to copy on write with 100k tablets in a shard
+    static constexpr int NUM_BUCKETS_BITS = 12;
+    static constexpr size_t NUM_BUCKETS = 1 << NUM_BUCKETS_BITS;
+
+    template <typename Vec>
+    static auto _lower_bound(Vec& bucket, TTabletId tablet_id) -> decltype(bucket.begin()) {
+        return std::lower_bound(
+                bucket.begin(), bucket.end(), tablet_id,
+                [](const std::pair<TTabletId, TabletSharedPtr>& entry, TTabletId id) {
+                    return entry.first < id;
+                });
+    }
+
+    // the tablets of a shard share the low bits of their ids, so mix all the bits
+    static size_t _bucket_index(TTabletId tablet_id) {
+        uint64_t hash = static_cast<uint64_t>(tablet_id) * 0x9E3779B97F4A7C15ULL;
+        return hash >> (64 - NUM_BUCKETS_BITS);
+    }
+    std::shared_ptr<const Bucket>& _bucket(TTabletId tablet_id) {
+        return _buckets[_bucket_index(tablet_id)];
+    }
+    const std::shared_ptr<const Bucket>& _bucket(TTabletId tablet_id) const {
+        return _buckets[_bucket_index(tablet_id)];
+    }
+
+    std::vector<std::shared_ptr<const Bucket>> _buckets;
+
+    DISALLOW_COPY_AND_ASSIGN(TabletLookupMap);
+};
+
+} // namespace doris
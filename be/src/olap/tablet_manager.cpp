@@ -53,6 +53,7 @@
 #include "service/backend_options.h"
 #include "util/doris_metrics.h"
 #include "util/file_utils.h"
+#include "util/hash_util.hpp"
 #include "util/histogram.h"
 #include "util/path_util.h"
 #include "util/pretty_printer.h"
@@ -194,9 +195,11 @@ Status TabletManager::_add_tablet_to_map_unlocked(TTabletId tablet_id,
     // the perspective of root path.
     // Example: unregister all tables when a bad disk found.
     tablet->register_tablet_into_dir();
-    tablet_map_t& tablet_map = _get_tablet_map(tablet_id);
-    tablet_map[tablet_id] = tablet;
+    tablets_shard& shard = _get_tablets_shard(tablet_id);
+    shard.tablet_map[tablet_id] = tablet;
+    shard.lookup_map.insert_or_assign(tablet_id, tablet);
     _add_tablet_to_partition(tablet);
+    mark_tablet_report_dirty(tablet_id);
 
     VLOG_NOTICE << "add tablet to map successfully."
                 << " tablet_id=" << tablet_id;
@@ -519,8 +522,9 @@ Status TabletManager::drop_tablets_on_error_root_path(
                 continue;
             } else {
                 _remove_tablet_from_partition(dropped_tablet);
-                tablet_map_t& tablet_map = _get_tablet_map(tablet_id);
-                tablet_map.erase(tablet_id);
+                tablets_shard& shard = _get_tablets_shard(tablet_id);
+                shard.tablet_map.erase(tablet_id);
+                shard.lookup_map.erase(tablet_id);
             }
         }
     }
@@ -528,7 +532,7 @@ Status TabletManager::drop_tablets_on_error_root_path(
 }
 
 TabletSharedPtr TabletManager::get_tablet(TTabletId tablet_id, bool include_deleted, string* err) {
-    std::shared_lock rdlock(_get_tablets_shard_lock(tablet_id));
+    // no shard lock, the tablet is looked up in the lookup map
     return _get_tablet_unlocked(tablet_id, include_deleted, err);
 }
 
@@ -567,7 +571,6 @@ TabletSharedPtr TabletManager::_get_tablet_unlocked(TTabletId tablet_id, bool in
 
 TabletSharedPtr TabletManager::get_tablet(TTabletId tablet_id, TabletUid tablet_uid,
                                           bool include_deleted, string* err) {
-    std::shared_lock rdlock(_get_tablets_shard_lock(tablet_id));
     TabletSharedPtr tablet = _get_tablet_unlocked(tablet_id, include_deleted, err);
     if (tablet != nullptr && tablet->tablet_uid() == tablet_uid) {
         return tablet;
@@ -625,6 +628,11 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
     int64_t now_ms = UnixMillis();
     const string& compaction_type_str =
             compaction_type == CompactionType::BASE_COMPACTION ? "base" : "cumulative";
+    bool is_cost_based = false;
+    {
+        std::lock_guard<std::mutex> lock(*config::get_mutable_string_config_lock());
+        is_cost_based = config::compaction_tablet_pick_policy == "cost_based";
+    }
     double highest_score = 0.0;
     uint32_t compaction_score = 0;
     double tablet_scan_frequency = 0.0;
@@ -674,13 +682,21 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
                     compaction_type, cumulative_compaction_policy);
 
             double scan_frequency = 0.0;
-            if (config::compaction_tablet_scan_frequency_factor != 0) {
+            if (is_cost_based || config::compaction_tablet_scan_frequency_factor != 0) {
                 scan_frequency = tablet_ptr->calculate_scan_frequency();
             }
 
-            double tablet_score =
-                    config::compaction_tablet_scan_frequency_factor * scan_frequency +
-                    config::compaction_tablet_compaction_score_factor * current_compaction_score;
+            double tablet_score = 0.0;
+            if (is_cost_based) {
+                tablet_score = calc_cost_based_compaction_priority(
+                        current_compaction_score,
+                        tablet_ptr->calc_compaction_input_size(compaction_type), scan_frequency);
+            } else {
+                tablet_score =
+                        config::compaction_tablet_scan_frequency_factor * scan_frequency +
+                        config::compaction_tablet_compaction_score_factor *
+                                current_compaction_score;
+            }
             if (tablet_score > highest_score) {
                 highest_score = tablet_score;
                 compaction_score = current_compaction_score;
@@ -702,6 +718,22 @@ TabletSharedPtr TabletManager::find_best_tablet_to_compaction(
     return best_tablet;
 }
 
+double TabletManager::calc_cost_based_compaction_priority(uint32_t compaction_score,
+                                                         int64_t input_size,
+                                                         double scan_frequency) {
+    if (compaction_score <= 1) {
+        // nothing to merge away
+        return 0.0;
+    }
+    if (compaction_score >= config::max_tablet_version_num / 2) {
+        // compact it in time regardless of the cost, otherwise the loads will fail soon
+        static constexpr double kUrgentPriority = 1e12;
+        return kUrgentPriority + compaction_score;
+    }
+    double input_mb = std::max(input_size / (1024.0 * 1024.0), 1.0);
+    return (compaction_score - 1) * (1.0 + std::max(scan_frequency, 0.0)) / input_mb;
+}
+
 Status TabletManager::load_tablet_from_meta(DataDir* data_dir, TTabletId tablet_id,
                                             TSchemaHash schema_hash, const string& meta_binary,
                                             bool update_meta, bool force, bool restore,
@@ -861,6 +893,14 @@ Status TabletManager::build_all_report_tablets_info(std::map<TTabletId, TTablet>
     LOG(INFO) << "find expired transactions for " << expire_txn_map.size() << " tablets";
 
     DorisMetrics::instance()->report_all_tablets_requests_total->increment(1);
+    std::lock_guard<std::mutex> report_lock(_report_lock);
+    {
+        // all the tablets are reported
+        std::lock_guard<std::mutex> l(_report_dirty_tablets_lock);
+        _report_dirty_tablets.clear();
+    }
+    _report_signatures.clear();
+    _report_checksum = 0;
     HistogramStat tablet_version_num_hist;
     auto local_cache = std::make_shared<std::vector<TTabletStat>>();
     for (const auto& tablets_shard : _tablets_shards) {
@@ -878,6 +918,9 @@ Status TabletManager::build_all_report_tablets_info(std::map<TTabletId, TTablet>
                 tablet_info.__set_transaction_ids(find->second);
                 expire_txn_map.erase(find);
             }
+            uint64_t signature = _report_signature(tablet_info);
+            _report_signatures[tablet_id] = signature;
+            _report_checksum ^= signature;
             t_tablet.tablet_infos.push_back(tablet_info);
             tablet_version_num_hist.add(tablet_ptr->version_count());
             tablets_info->emplace(tablet_id, t_tablet);
@@ -899,6 +942,100 @@ Status TabletManager::build_all_report_tablets_info(std::map<TTabletId, TTablet>
     return Status::OK();
 }
 
+Status TabletManager::build_incremental_report_tablets_info(
+        std::map<TTabletId, TTablet>* tablets_info) {
+    DCHECK(tablets_info != nullptr);
+    DorisMetrics::instance()->report_incremental_tablets_requests_total->increment(1);
+    std::lock_guard<std::mutex> report_lock(_report_lock);
+    std::unordered_set<TTabletId> dirty_tablets;
+    {
+        std::lock_guard<std::mutex> l(_report_dirty_tablets_lock);
+        dirty_tablets.swap(_report_dirty_tablets);
+    }
+
+    std::vector<TTabletStat> changed_stats;
+    for (TTabletId tablet_id : dirty_tablets) {
+        TabletSharedPtr tablet = get_tablet(tablet_id);
+        if (tablet == nullptr) {
+            // dropped, FE will find it in the next full report
+            continue;
+        }
+        TTabletInfo tablet_info;
+        tablet->build_tablet_report_info(&tablet_info);
+        uint64_t signature = _report_signature(tablet_info);
+        uint64_t& last_signature = _report_signatures[tablet_id];
+        if (last_signature == signature) {
+            continue;
+        }
+        _report_checksum ^= last_signature ^ signature;
+        last_signature = signature;
+
+        TTabletStat t_tablet_stat;
+        t_tablet_stat.__set_tablet_id(tablet_info.tablet_id);
+        t_tablet_stat.__set_data_size(tablet_info.data_size);
+        t_tablet_stat.__set_row_num(tablet_info.row_count);
+        t_tablet_stat.__set_version_count(tablet_info.version_count);
+        changed_stats.emplace_back(std::move(t_tablet_stat));
+        TTablet t_tablet;
+        t_tablet.tablet_infos.push_back(std::move(tablet_info));
+        tablets_info->emplace(tablet_id, std::move(t_tablet));
+    }
+
+    if (!changed_stats.empty()) {
+        // update the stats of the changed tablets in a copy of the cache
+        std::shared_ptr<std::vector<TTabletStat>> old_cache;
+        {
+            std::lock_guard<std::mutex> guard(_tablet_stat_cache_mutex);
+            old_cache = _tablet_stat_list_cache;
+        }
+        auto local_cache = std::make_shared<std::vector<TTabletStat>>(*old_cache);
+        std::unordered_map<int64_t, size_t> stat_index;
+        for (size_t i = 0; i < local_cache->size(); ++i) {
+            stat_index[(*local_cache)[i].tablet_id] = i;
+        }
+        for (auto& stat : changed_stats) {
+            auto it = stat_index.find(stat.tablet_id);
+            if (it != stat_index.end()) {
+                (*local_cache)[it->second] = std::move(stat);
+            } else {
+                local_cache->emplace_back(std::move(stat));
+            }
+        }
+        std::lock_guard<std::mutex> guard(_tablet_stat_cache_mutex);
+        _tablet_stat_list_cache = local_cache;
+    }
+    LOG(INFO) << "success to build incremental report tablets info. dirty_tablet_count="
+              << dirty_tablets.size() << ", changed_tablet_count=" << tablets_info->size();
+    return Status::OK();
+}
+
+int64_t TabletManager::report_tablets_checksum() {
+    std::lock_guard<std::mutex> report_lock(_report_lock);
+    return static_cast<int64_t>(_report_checksum);
+}
+
+void TabletManager::mark_tablet_report_dirty(TTabletId tablet_id) {
+    std::lock_guard<std::mutex> l(_report_dirty_tablets_lock);
+    _report_dirty_tablets.insert(tablet_id);
+}
+
+uint64_t TabletManager::_report_signature(const TTabletInfo& tablet_info) {
+    // the fields FE compares with its meta
+    int64_t fields[] = {tablet_info.tablet_id,
+                        tablet_info.schema_hash,
+                        tablet_info.version,
+                        tablet_info.row_count,
+                        tablet_info.data_size,
+                        tablet_info.version_count,
+                        tablet_info.partition_id,
+                        tablet_info.path_hash,
+                        tablet_info.storage_medium,
+                        tablet_info.__isset.used && !tablet_info.used,
+                        tablet_info.version_miss,
+                        tablet_info.is_in_memory};
+    return HashUtil::hash64(fields, sizeof(fields), 0);
+}
+
 Status TabletManager::start_trash_sweep() {
     {
         std::vector<TabletSharedPtr>
@@ -1289,8 +1426,9 @@ Status TabletManager::_drop_tablet_directly_unlocked(TTabletId tablet_id, bool k
         return Status::OLAPInternalError(OLAP_ERR_TABLE_NOT_FOUND);
     }
     _remove_tablet_from_partition(dropped_tablet);
-    tablet_map_t& tablet_map = _get_tablet_map(tablet_id);
-    tablet_map.erase(tablet_id);
+    tablets_shard& shard = _get_tablets_shard(tablet_id);
+    shard.tablet_map.erase(tablet_id);
+    shard.lookup_map.erase(tablet_id);
     if (!keep_files) {
         // drop tablet will update tablet meta, should lock
         std::lock_guard<std::shared_mutex> wrlock(dropped_tablet->get_header_lock());
@@ -1316,12 +1454,7 @@ Status TabletManager::_drop_tablet_directly_unlocked(TTabletId tablet_id, bool k
 
 TabletSharedPtr TabletManager::_get_tablet_unlocked(TTabletId tablet_id) {
     VLOG_NOTICE << "begin to get tablet. tablet_id=" << tablet_id;
-    tablet_map_t& tablet_map = _get_tablet_map(tablet_id);
-    const auto& iter = tablet_map.find(tablet_id);
-    if (iter != tablet_map.end()) {
-        return iter->second;
-    }
-    return nullptr;
+    return _get_tablets_shard(tablet_id).lookup_map.find(tablet_id);
 }
 
 void TabletManager::_add_tablet_to_partition(const TabletSharedPtr& tablet) {
@@ -1354,6 +1487,19 @@ void TabletManager::obtain_specific_quantity_tablets(vector<TabletInfo>& tablets
     }
 }
 
+std::vector<TabletSharedPtr> TabletManager::get_all_tablets() {
+    std::vector<TabletSharedPtr> tablets;
+    for (const auto& tablets_shard : _tablets_shards) {
+        std::shared_lock rdlock(tablets_shard.lock);
+        for (const auto& item : tablets_shard.tablet_map) {
+            if (item.second != nullptr) {
+                tablets.push_back(item.second);
+            }
+        }
+    }
+    return tablets;
+}
+
 std::shared_mutex& TabletManager::_get_tablets_shard_lock(TTabletId tabletId) {
     return _get_tablets_shard(tabletId).lock;
 }
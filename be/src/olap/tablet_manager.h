@@ -36,6 +36,7 @@
 #include "olap/olap_meta.h"
 #include "olap/options.h"
 #include "olap/tablet.h"
+#include "olap/tablet_lookup_map.h"
 
 namespace doris {
 
@@ -75,6 +76,13 @@ public:
             const std::unordered_set<TTabletId>& tablet_submitted_compaction, uint32_t* score,
             std::shared_ptr<CumulativeCompactionPolicy> cumulative_compaction_policy);
 
+    // Priority of a tablet to compact in cost_based policy, which is the read amplification
+    // saving per MB rewritten, weighted by the scan frequency. The saving is the number of
+    // the versions merged away, i.e. compaction score - 1. The tablets close to the version
+    // limit are always in front of others.
+    static double calc_cost_based_compaction_priority(uint32_t compaction_score,
+                                                      int64_t input_size, double scan_frequency);
+
     TabletSharedPtr get_tablet(TTabletId tablet_id, bool include_deleted = false,
                                std::string* err = nullptr);
 
@@ -117,6 +125,18 @@ public:
 
     Status build_all_report_tablets_info(std::map<TTabletId, TTablet>* tablets_info);
 
+    // Build the report info of the tablets marked dirty since the last report, skipping
+    // the tablets whose report info is not changed. The dropped tablets are only known by
+    // FE from the next full report built by build_all_report_tablets_info().
+    Status build_incremental_report_tablets_info(std::map<TTabletId, TTablet>* tablets_info);
+
+    // The checksum of the report info of all the tablets, as of the last report.
+    int64_t report_tablets_checksum();
+
+    // Mark that the report info of the tablet may be changed, e.g. its versions, rows or
+    // data size, so it's included in the next incremental report.
+    void mark_tablet_report_dirty(TTabletId tablet_id);
+
     Status start_trash_sweep();
 
     void try_delete_unused_tablet_path(DataDir* data_dir, TTabletId tablet_id,
@@ -131,6 +151,8 @@ public:
 
     void obtain_specific_quantity_tablets(std::vector<TabletInfo>& tablets_info, int64_t num);
 
+    std::vector<TabletSharedPtr> get_all_tablets();
+
     void register_clone_tablet(int64_t tablet_id);
     void unregister_clone_tablet(int64_t tablet_id);
 
@@ -183,6 +205,8 @@ private:
 
     std::shared_mutex& _get_tablets_shard_lock(TTabletId tabletId);
 
+    static uint64_t _report_signature(const TTabletInfo& tablet_info);
+
     Status _get_storage_param(DataDir* data_dir, const std::string& storage_name,
                               StorageParamPB* storage_param);
 
@@ -193,13 +217,16 @@ private:
 
     struct tablets_shard {
         tablets_shard() = default;
-        tablets_shard(tablets_shard&& shard) {
+        tablets_shard(tablets_shard&& shard) : lookup_map(std::move(shard.lookup_map)) {
             tablet_map = std::move(shard.tablet_map);
             tablets_under_clone = std::move(shard.tablets_under_clone);
         }
-        // protect tablet_map, tablets_under_clone and tablets_under_restore
+        // protect tablet_map, tablets_under_clone and tablets_under_restore, and serialize
+        // the writers of lookup_map
         mutable std::shared_mutex lock;
         tablet_map_t tablet_map;
+        // the same tablets as tablet_map, to get a tablet without the lock
+        TabletLookupMap lookup_map;
         std::set<int64_t> tablets_under_clone;
     };
 
@@ -222,6 +249,15 @@ private:
     std::shared_ptr<std::vector<TTabletStat>> _tablet_stat_list_cache =
             std::make_shared<std::vector<TTabletStat>>();
 
+    std::mutex _report_dirty_tablets_lock;
+    std::unordered_set<TTabletId> _report_dirty_tablets;
+    // Protect _report_signatures and _report_checksum, held while building a report
+    std::mutex _report_lock;
+    // tablet id => the signature of the report info of the tablet in the last report
+    std::unordered_map<TTabletId, uint64_t> _report_signatures;
+    // the xor of _report_signatures
+    uint64_t _report_checksum = 0;
+
     tablet_map_t& _get_tablet_map(TTabletId tablet_id);
 
     tablets_shard& _get_tablets_shard(TTabletId tabletId);
@@ -24,6 +24,7 @@
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/rowset/alpha_rowset_meta.h"
+#include "olap/rowset/segment_v2/inverted_index_parser.h"
 #include "olap/tablet_meta_manager.h"
 #include "util/uid_util.h"
 #include "util/url_coding.h"
@@ -34,6 +35,48 @@ using std::vector;
 
 namespace doris {
 
+static const int32_t DEFAULT_NGRAM_BF_GRAM_SIZE = 3;
+static const int32_t DEFAULT_NGRAM_BF_SIZE = 256;
+
+static void init_ngram_bf_index_from_properties(const TOlapTableIndex& index, ColumnPB* column) {
+    int32_t gram_size = DEFAULT_NGRAM_BF_GRAM_SIZE;
+    int32_t bf_size = DEFAULT_NGRAM_BF_SIZE;
+    if (index.__isset.properties) {
+        auto it = index.properties.find("gram_size");
+        if (it != index.properties.end()) {
+            gram_size = std::atoi(it->second.c_str());
+        }
+        it = index.properties.find("bf_size");
+        if (it != index.properties.end()) {
+            bf_size = std::atoi(it->second.c_str());
+        }
+    }
+    if (gram_size <= 0 || bf_size <= 0) {
+        LOG(WARNING) << "invalid ngram bloom filter index of column " << column->name()
+                     << ", gram_size=" << gram_size << ", bf_size=" << bf_size;
+        return;
+    }
+    column->set_ngram_bf_gram_size(gram_size);
+    column->set_ngram_bf_size(bf_size);
+}
+
+static void init_inverted_index_from_properties(const TOlapTableIndex& index, ColumnPB* column) {
+    std::string parser = INVERTED_INDEX_PARSER_ENGLISH;
+    if (index.__isset.properties) {
+        auto it = index.properties.find("parser");
+        if (it != index.properties.end()) {
+            parser = it->second;
+        }
+    }
+    InvertedIndexParserType parser_type;
+    if (!parse_inverted_index_parser(parser, &parser_type).ok()) {
+        LOG(WARNING) << "invalid inverted index parser of column " << column->name()
+                     << ", parser=" << parser;
+        return;
+    }
+    column->set_inverted_index_parser(parser);
+}
+
 Status TabletMeta::create(const TCreateTabletReq& request, const TabletUid& tablet_uid,
                           uint64_t shard_id, uint32_t next_unique_id,
                           const unordered_map<uint32_t, uint32_t>& col_ordinal_to_unique_id,
@@ -43,19 +86,23 @@ Status TabletMeta::create(const TCreateTabletReq& request, const TabletUid& tabl
             request.tablet_schema.schema_hash, shard_id, request.tablet_schema, next_unique_id,
             col_ordinal_to_unique_id, tablet_uid,
             request.__isset.tablet_type ? request.tablet_type : TTabletType::TABLET_TYPE_DISK,
-            request.storage_medium, request.storage_param.storage_name));
+            request.storage_medium, request.storage_param.storage_name,
+            request.__isset.enable_unique_key_merge_on_write &&
+                    request.enable_unique_key_merge_on_write));
     return Status::OK();
 }
 
-TabletMeta::TabletMeta() : _tablet_uid(0, 0), _schema(new TabletSchema) {}
+TabletMeta::TabletMeta()
+        : _tablet_uid(0, 0), _schema(new TabletSchema), _delete_bitmap(new DeleteBitmap()) {}
 
 TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id,
                        int32_t schema_hash, uint64_t shard_id, const TTabletSchema& tablet_schema,
                        uint32_t next_unique_id,
                        const std::unordered_map<uint32_t, uint32_t>& col_ordinal_to_unique_id,
                        TabletUid tablet_uid, TTabletType::type tabletType,
-                       TStorageMedium::type t_storage_medium, const std::string& storage_name)
-        : _tablet_uid(0, 0), _schema(new TabletSchema) {
+                       TStorageMedium::type t_storage_medium, const std::string& storage_name,
+                       bool enable_unique_key_merge_on_write)
+        : _tablet_uid(0, 0), _schema(new TabletSchema), _delete_bitmap(new DeleteBitmap()) {
     TabletMetaPB tablet_meta_pb;
     tablet_meta_pb.set_table_id(table_id);
     tablet_meta_pb.set_partition_id(partition_id);
@@ -99,6 +146,8 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
         schema->set_sort_type(SortType::LEXICAL);
     }
     schema->set_sort_col_num(tablet_schema.sort_col_num);
+    schema->set_enable_unique_key_merge_on_write(enable_unique_key_merge_on_write &&
+                                                 tablet_schema.keys_type == TKeysType::UNIQUE_KEYS);
     tablet_meta_pb.set_in_restore_mode(false);
 
     // set column information
@@ -126,6 +175,18 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
                         column->set_has_bitmap_index(true);
                         break;
                     }
+                } else if (index.index_type == TIndexType::type::NGRAM_BF) {
+                    DCHECK_EQ(index.columns.size(), 1);
+                    if (boost::iequals(tcolumn.column_name, index.columns[0])) {
+                        init_ngram_bf_index_from_properties(index, column);
+                        break;
+                    }
+                } else if (index.index_type == TIndexType::type::INVERTED) {
+                    DCHECK_EQ(index.columns.size(), 1);
+                    if (boost::iequals(tcolumn.column_name, index.columns[0])) {
+                        init_inverted_index_from_properties(index, column);
+                        break;
+                    }
                 }
             }
         }
@@ -136,6 +197,9 @@ TabletMeta::TabletMeta(int64_t table_id, int64_t partition_id, int64_t tablet_id
         schema->set_bf_fpp(tablet_schema.bloom_filter_fpp);
     }
 
+    if (tablet_schema.__isset.compaction_policy) {
+        schema->set_compaction_policy(boost::to_upper_copy(tablet_schema.compaction_policy));
+    }
     if (tablet_schema.__isset.is_in_memory) {
         schema->set_is_in_memory(tablet_schema.is_in_memory);
     }
@@ -163,7 +227,8 @@ TabletMeta::TabletMeta(const TabletMeta& b)
           _stale_rs_metas(b._stale_rs_metas),
           _del_pred_array(b._del_pred_array),
           _in_restore_mode(b._in_restore_mode),
-          _preferred_rowset_type(b._preferred_rowset_type) {}
+          _preferred_rowset_type(b._preferred_rowset_type),
+          _delete_bitmap(new DeleteBitmap(*b._delete_bitmap)) {}
 
 void TabletMeta::_init_column_from_tcolumn(uint32_t unique_id, const TColumn& tcolumn,
                                            ColumnPB* column) {
@@ -407,6 +472,10 @@ void TabletMeta::init_from_pb(const TabletMetaPB& tablet_meta_pb) {
 
     _remote_storage_name = tablet_meta_pb.remote_storage_name();
     _storage_medium = tablet_meta_pb.storage_medium();
+
+    if (tablet_meta_pb.has_delete_bitmap()) {
+        _delete_bitmap->init_from_pb(tablet_meta_pb.delete_bitmap());
+    }
 }
 
 void TabletMeta::to_meta_pb(TabletMetaPB* tablet_meta_pb) {
@@ -454,6 +523,10 @@ void TabletMeta::to_meta_pb(TabletMetaPB* tablet_meta_pb) {
 
     tablet_meta_pb->set_remote_storage_name(_remote_storage_name);
     tablet_meta_pb->set_storage_medium(_storage_medium);
+
+    if (!_delete_bitmap->empty()) {
+        _delete_bitmap->to_pb(tablet_meta_pb->mutable_delete_bitmap());
+    }
 }
 
 uint32_t TabletMeta::mem_size() const {
@@ -676,4 +749,138 @@ bool operator!=(const TabletMeta& a, const TabletMeta& b) {
     return !(a == b);
 }
 
+DeleteBitmap::DeleteBitmap(const DeleteBitmap& other) {
+    std::shared_lock rdlock(other._lock);
+    _delete_bitmap = other._delete_bitmap;
+}
+
+DeleteBitmap& DeleteBitmap::operator=(const DeleteBitmap& other) {
+    if (this != &other) {
+        std::map<BitmapKey, roaring::Roaring> delete_bitmap;
+        {
+            std::shared_lock rdlock(other._lock);
+            delete_bitmap = other._delete_bitmap;
+        }
+        std::lock_guard<std::shared_mutex> wrlock(_lock);
+        _delete_bitmap.swap(delete_bitmap);
+    }
+    return *this;
+}
+
+void DeleteBitmap::add(const BitmapKey& bmk, uint32_t row_id) {
+    std::lock_guard<std::shared_mutex> wrlock(_lock);
+    _delete_bitmap[bmk].add(row_id);
+}
+
+bool DeleteBitmap::contains(const BitmapKey& bmk, uint32_t row_id) const {
+    std::shared_lock rdlock(_lock);
+    auto it = _delete_bitmap.find(bmk);
+    return it != _delete_bitmap.end() && it->second.contains(row_id);
+}
+
+void DeleteBitmap::set(const BitmapKey& bmk, const roaring::Roaring& segment_delete_bitmap) {
+    std::lock_guard<std::shared_mutex> wrlock(_lock);
+    _delete_bitmap[bmk] = segment_delete_bitmap;
+}
+
+void DeleteBitmap::get_agg(const BitmapKey& bmk, roaring::Roaring* segment_delete_bitmap) const {
+    const auto& [rowset_id, segment_id, version] = bmk;
+    std::shared_lock rdlock(_lock);
+    // the marks of a segment are ordered by version
+    for (auto it = _delete_bitmap.lower_bound({rowset_id, segment_id, 0});
+         it != _delete_bitmap.end(); ++it) {
+        const auto& [cur_rowset_id, cur_segment_id, cur_version] = it->first;
+        if (cur_rowset_id != rowset_id || cur_segment_id != segment_id ||
+            cur_version > version) {
+            break;
+        }
+        *segment_delete_bitmap |= it->second;
+    }
+}
+
+bool DeleteBitmap::contains_agg(const BitmapKey& bmk, uint32_t row_id) const {
+    const auto& [rowset_id, segment_id, version] = bmk;
+    std::shared_lock rdlock(_lock);
+    for (auto it = _delete_bitmap.lower_bound({rowset_id, segment_id, 0});
+         it != _delete_bitmap.end(); ++it) {
+        const auto& [cur_rowset_id, cur_segment_id, cur_version] = it->first;
+        if (cur_rowset_id != rowset_id || cur_segment_id != segment_id ||
+            cur_version > version) {
+            break;
+        }
+        if (it->second.contains(row_id)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int64_t DeleteBitmap::max_version(const BitmapKey& bmk) const {
+    const auto& [rowset_id, segment_id, version] = bmk;
+    std::shared_lock rdlock(_lock);
+    auto it = _delete_bitmap.upper_bound(bmk);
+    if (it == _delete_bitmap.begin()) {
+        return -1;
+    }
+    --it;
+    const auto& [cur_rowset_id, cur_segment_id, cur_version] = it->first;
+    if (cur_rowset_id != rowset_id || cur_segment_id != segment_id) {
+        return -1;
+    }
+    return cur_version;
+}
+
+void DeleteBitmap::remove_rowset(const RowsetId& rowset_id) {
+    std::lock_guard<std::shared_mutex> wrlock(_lock);
+    auto it = _delete_bitmap.lower_bound({rowset_id, 0, 0});
+    while (it != _delete_bitmap.end() && std::get<0>(it->first) == rowset_id) {
+        it = _delete_bitmap.erase(it);
+    }
+}
+
+void DeleteBitmap::merge(const DeleteBitmap& other) {
+    if (this == &other) {
+        return;
+    }
+    std::shared_lock rdlock(other._lock);
+    std::lock_guard<std::shared_mutex> wrlock(_lock);
+    for (auto& [bmk, segment_delete_bitmap] : other._delete_bitmap) {
+        _delete_bitmap[bmk] |= segment_delete_bitmap;
+    }
+}
+
+bool DeleteBitmap::empty() const {
+    std::shared_lock rdlock(_lock);
+    return _delete_bitmap.empty();
+}
+
+void DeleteBitmap::to_pb(DeleteBitmapPB* delete_bitmap_pb) const {
+    std::shared_lock rdlock(_lock);
+    for (auto& [bmk, segment_delete_bitmap] : _delete_bitmap) {
+        const auto& [rowset_id, segment_id, version] = bmk;
+        delete_bitmap_pb->add_rowset_ids(rowset_id.to_string());
+        delete_bitmap_pb->add_segment_ids(segment_id);
+        delete_bitmap_pb->add_versions(version);
+        std::string buf(segment_delete_bitmap.getSizeInBytes(), '\0');
+        segment_delete_bitmap.write(buf.data());
+        delete_bitmap_pb->add_segment_delete_bitmaps(std::move(buf));
+    }
+}
+
+void DeleteBitmap::init_from_pb(const DeleteBitmapPB& delete_bitmap_pb) {
+    DCHECK(delete_bitmap_pb.rowset_ids_size() == delete_bitmap_pb.segment_ids_size() &&
+           delete_bitmap_pb.rowset_ids_size() == delete_bitmap_pb.versions_size() &&
+           delete_bitmap_pb.rowset_ids_size() == delete_bitmap_pb.segment_delete_bitmaps_size());
+    std::lock_guard<std::shared_mutex> wrlock(_lock);
+    _delete_bitmap.clear();
+    for (int i = 0; i < delete_bitmap_pb.rowset_ids_size(); ++i) {
+        RowsetId rowset_id;
+        rowset_id.init(delete_bitmap_pb.rowset_ids(i));
+        const std::string& buf = delete_bitmap_pb.segment_delete_bitmaps(i);
+        _delete_bitmap[{rowset_id, delete_bitmap_pb.segment_ids(i),
+                        delete_bitmap_pb.versions(i)}] =
+                roaring::Roaring::read(buf.data(), true);
+    }
+}
+
 } // namespace doris
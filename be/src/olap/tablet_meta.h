@@ -17,9 +17,12 @@
 
 #pragma once
 
+#include <map>
 #include <mutex>
+#include <roaring/roaring.hh>
 #include <shared_mutex>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "common/logging.h"
@@ -67,6 +70,48 @@ class DataDir;
 class TabletMeta;
 using TabletMetaSharedPtr = std::shared_ptr<TabletMeta>;
 
+// The rows deleted by later loads in a merge-on-write unique key tablet.
+//
+// A load marks the rows of the older rowsets which have the same keys as its own rows,
+// and the marks are keyed by (rowset id, segment id, version of the load), so a reader
+// of version v skips the rows marked by the loads of versions <= v only.
+// This class is thread-safe.
+class DeleteBitmap {
+public:
+    using SegmentId = uint32_t;
+    using BitmapKey = std::tuple<RowsetId, SegmentId, int64_t>;
+
+    DeleteBitmap() = default;
+    DeleteBitmap(const DeleteBitmap& other);
+    DeleteBitmap& operator=(const DeleteBitmap& other);
+
+    // mark the row `row_id` deleted
+    void add(const BitmapKey& bmk, uint32_t row_id);
+    // whether the row `row_id` is marked by exactly the version of `bmk`
+    bool contains(const BitmapKey& bmk, uint32_t row_id) const;
+    void set(const BitmapKey& bmk, const roaring::Roaring& segment_delete_bitmap);
+
+    // Get the union of the marks of the segment whose versions are <= the version of `bmk`.
+    void get_agg(const BitmapKey& bmk, roaring::Roaring* segment_delete_bitmap) const;
+    // whether the row `row_id` is marked by any version <= the version of `bmk`
+    bool contains_agg(const BitmapKey& bmk, uint32_t row_id) const;
+    // The max version <= the version of `bmk` of the marks of the segment, or -1 if there is
+    // no such mark.
+    int64_t max_version(const BitmapKey& bmk) const;
+
+    // Remove all the marks of the rowset, called when the rowset is removed from tablet.
+    void remove_rowset(const RowsetId& rowset_id);
+    void merge(const DeleteBitmap& other);
+    bool empty() const;
+
+    void to_pb(DeleteBitmapPB* delete_bitmap_pb) const;
+    void init_from_pb(const DeleteBitmapPB& delete_bitmap_pb);
+
+private:
+    mutable std::shared_mutex _lock;
+    std::map<BitmapKey, roaring::Roaring> _delete_bitmap;
+};
+
 // Class encapsulates meta of tablet.
 // The concurrency control is handled in Tablet Class, not in this class.
 class TabletMeta {
@@ -83,7 +128,8 @@ public:
                uint64_t shard_id, const TTabletSchema& tablet_schema, uint32_t next_unique_id,
                const std::unordered_map<uint32_t, uint32_t>& col_ordinal_to_unique_id,
                TabletUid tablet_uid, TTabletType::type tabletType,
-               TStorageMedium::type t_storage_medium, const std::string& remote_storage_name);
+               TStorageMedium::type t_storage_medium, const std::string& remote_storage_name,
+               bool enable_unique_key_merge_on_write = false);
     // If need add a filed in TableMeta, filed init copy in copy construct function
     TabletMeta(const TabletMeta& tablet_meta);
     TabletMeta(TabletMeta&& tablet_meta) = delete;
@@ -175,6 +221,9 @@ public:
 
     StorageMediumPB storage_medium() const { return _storage_medium; }
 
+    // only has marks in merge-on-write unique key tablets
+    std::shared_ptr<DeleteBitmap> delete_bitmap() const { return _delete_bitmap; }
+
 private:
     Status _save_meta(DataDir* data_dir);
     void _init_column_from_tcolumn(uint32_t unique_id, const TColumn& tcolumn, ColumnPB* column);
@@ -210,6 +259,7 @@ private:
     RowsetTypePB _preferred_rowset_type = BETA_ROWSET;
     std::string _remote_storage_name;
     StorageMediumPB _storage_medium;
+    std::shared_ptr<DeleteBitmap> _delete_bitmap;
 
     std::shared_mutex _meta_lock;
 };
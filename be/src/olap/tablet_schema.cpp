@@ -332,6 +332,9 @@ void TabletColumn::init_from_pb(const ColumnPB& column) {
     } else {
         _has_bitmap_index = false;
     }
+    _ngram_bf_gram_size = column.ngram_bf_gram_size();
+    _ngram_bf_size = column.ngram_bf_size();
+    _inverted_index_parser = column.inverted_index_parser();
     _has_referenced_column = column.has_referenced_column_id();
     if (_has_referenced_column) {
         _referenced_column_id = column.referenced_column_id();
@@ -375,6 +378,13 @@ void TabletColumn::to_schema_pb(ColumnPB* column) {
     if (_has_bitmap_index) {
         column->set_has_bitmap_index(_has_bitmap_index);
     }
+    if (_ngram_bf_gram_size > 0) {
+        column->set_ngram_bf_gram_size(_ngram_bf_gram_size);
+        column->set_ngram_bf_size(_ngram_bf_size);
+    }
+    if (!_inverted_index_parser.empty()) {
+        column->set_inverted_index_parser(_inverted_index_parser);
+    }
     column->set_visible(_visible);
 
     if (_type == OLAP_FIELD_TYPE_ARRAY) {
@@ -437,6 +447,8 @@ void TabletSchema::init_from_pb(const TabletSchemaPB& schema) {
     _sequence_col_idx = schema.sequence_col_idx();
     _sort_type = schema.sort_type();
     _sort_col_num = schema.sort_col_num();
+    _enable_unique_key_merge_on_write = schema.enable_unique_key_merge_on_write();
+    _compaction_policy = schema.compaction_policy();
 }
 
 void TabletSchema::to_schema_pb(TabletSchemaPB* tablet_meta_pb) {
@@ -457,6 +469,10 @@ void TabletSchema::to_schema_pb(TabletSchemaPB* tablet_meta_pb) {
     tablet_meta_pb->set_sequence_col_idx(_sequence_col_idx);
     tablet_meta_pb->set_sort_type(_sort_type);
     tablet_meta_pb->set_sort_col_num(_sort_col_num);
+    tablet_meta_pb->set_enable_unique_key_merge_on_write(_enable_unique_key_merge_on_write);
+    if (!_compaction_policy.empty()) {
+        tablet_meta_pb->set_compaction_policy(_compaction_policy);
+    }
 }
 
 uint32_t TabletSchema::mem_size() const {
@@ -544,6 +560,9 @@ bool operator==(const TabletColumn& a, const TabletColumn& b) {
         if (a._referenced_column != b._referenced_column) return false;
     }
     if (a._has_bitmap_index != b._has_bitmap_index) return false;
+    if (a._ngram_bf_gram_size != b._ngram_bf_gram_size) return false;
+    if (a._ngram_bf_size != b._ngram_bf_size) return false;
+    if (a._inverted_index_parser != b._inverted_index_parser) return false;
     return true;
 }
 
@@ -570,6 +589,8 @@ bool operator==(const TabletSchema& a, const TabletSchema& b) {
     }
     if (a._is_in_memory != b._is_in_memory) return false;
     if (a._delete_sign_idx != b._delete_sign_idx) return false;
+    if (a._enable_unique_key_merge_on_write != b._enable_unique_key_merge_on_write) return false;
+    if (a._compaction_policy != b._compaction_policy) return false;
     return true;
 }
 
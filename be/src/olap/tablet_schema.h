@@ -47,6 +47,11 @@ public:
     bool is_nullable() const { return _is_nullable; }
     bool is_bf_column() const { return _is_bf_column; }
     bool has_bitmap_index() const { return _has_bitmap_index; }
+    bool has_ngram_bf_index() const { return _ngram_bf_gram_size > 0; }
+    int32_t ngram_bf_gram_size() const { return _ngram_bf_gram_size; }
+    int32_t ngram_bf_size() const { return _ngram_bf_size; }
+    bool has_inverted_index() const { return !_inverted_index_parser.empty(); }
+    const std::string& inverted_index_parser() const { return _inverted_index_parser; }
     bool is_length_variable_type() const {
         return _type == OLAP_FIELD_TYPE_CHAR || _type == OLAP_FIELD_TYPE_VARCHAR ||
                _type == OLAP_FIELD_TYPE_STRING || _type == OLAP_FIELD_TYPE_HLL ||
@@ -104,6 +109,11 @@ private:
     std::string _referenced_column;
 
     bool _has_bitmap_index = false;
+    // the gram size and the bytes of one page's bloom filter of ngram bloom filter index
+    int32_t _ngram_bf_gram_size = 0;
+    int32_t _ngram_bf_size = 0;
+    // name of the parser of inverted index, empty if the column has no inverted index
+    std::string _inverted_index_parser;
     bool _visible = true;
 
     TabletColumn* _parent = nullptr;
@@ -145,6 +155,14 @@ public:
     void set_delete_sign_idx(int32_t delete_sign_idx) { _delete_sign_idx = delete_sign_idx; }
     bool has_sequence_col() const { return _sequence_col_idx != -1; }
     int32_t sequence_col_idx() const { return _sequence_col_idx; }
+    // unique key tablet which resolves the duplicated keys at load time by delete bitmaps,
+    // rather than merging the rowsets at read time
+    bool enable_unique_key_merge_on_write() const { return _enable_unique_key_merge_on_write; }
+    void set_enable_unique_key_merge_on_write(bool enable) {
+        _enable_unique_key_merge_on_write = enable;
+    }
+    // the cumulative compaction policy of the table, empty to use the policy of the BE
+    const std::string& compaction_policy() const { return _compaction_policy; }
     vectorized::Block create_block(
             const std::vector<uint32_t>& return_columns,
             const std::unordered_set<uint32_t>* tablet_columns_need_convert_null = nullptr) const;
@@ -175,6 +193,8 @@ private:
     bool _is_in_memory = false;
     int32_t _delete_sign_idx = -1;
     int32_t _sequence_col_idx = -1;
+    bool _enable_unique_key_merge_on_write = false;
+    std::string _compaction_policy;
 };
 
 bool operator==(const TabletSchema& a, const TabletSchema& b);
@@ -17,6 +17,9 @@
 
 #include "olap/task/engine_clone_task.h"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
 #include <set>
 
 #include "env/env.h"
@@ -29,8 +32,10 @@
 #include "olap/rowset/rowset.h"
 #include "olap/rowset/rowset_factory.h"
 #include "olap/snapshot_manager.h"
+#include "olap/tablet_meta.h"
 #include "runtime/client_cache.h"
 #include "runtime/thread_context.h"
+#include "util/threadpool.h"
 #include "util/thrift_rpc_helper.h"
 
 using std::set;
@@ -48,6 +53,17 @@ const uint32_t DOWNLOAD_FILE_MAX_RETRY = 3;
 const uint32_t LIST_REMOTE_FILE_TIMEOUT = 15;
 const uint32_t GET_LENGTH_TIMEOUT = 10;
 
+// The cloned rowsets get new rowset ids but not the delete bitmap of the merge-on-write tablets,
+// so the deleted keys would come back, reject them until the delete bitmap is cloned.
+static Status check_not_merge_on_write(const TabletSchema& tablet_schema, int64_t tablet_id) {
+    if (tablet_schema.keys_type() == UNIQUE_KEYS &&
+        tablet_schema.enable_unique_key_merge_on_write()) {
+        return Status::NotSupported(
+                Substitute("clone of merge-on-write tablet $0 is not supported", tablet_id));
+    }
+    return Status::OK();
+}
+
 EngineCloneTask::EngineCloneTask(const TCloneReq& clone_req, const TMasterInfo& master_info,
                                  int64_t signature, std::vector<string>* error_msgs,
                                  std::vector<TTabletInfo>* tablet_infos, Status* res_status)
@@ -81,6 +97,13 @@ Status EngineCloneTask::_do_clone() {
     bool is_new_tablet = tablet == nullptr;
     // try to repair a tablet with missing version
     if (tablet != nullptr) {
+        status = check_not_merge_on_write(tablet->tablet_schema(), _clone_req.tablet_id);
+        if (!status.ok()) {
+            LOG(WARNING) << "failed to clone tablet: " << status << ". signature: " << _signature;
+            _error_msgs->push_back(status.get_error_msg());
+            *_res_status = status;
+            return status;
+        }
         std::shared_lock migration_rlock(tablet->get_migration_lock(), std::try_to_lock);
         if (!migration_rlock.owns_lock()) {
             return Status::OLAPInternalError(OLAP_ERR_RWLOCK_ERROR);
@@ -170,6 +193,19 @@ Status EngineCloneTask::_do_clone() {
                 _error_msgs->push_back("errors while set tablet uid.");
                 status = Status::InternalError("Errors while set tablet uid");
             } else {
+                TabletMeta cloned_tablet_meta;
+                status = cloned_tablet_meta.create_from_file(header_path);
+                if (status.ok()) {
+                    status = check_not_merge_on_write(cloned_tablet_meta.tablet_schema(),
+                                                      _clone_req.tablet_id);
+                }
+                if (!status.ok()) {
+                    LOG(WARNING) << "failed to clone tablet: " << status
+                                 << ". signature: " << _signature;
+                    _error_msgs->push_back(status.get_error_msg());
+                }
+            }
+            if (status.ok()) {
                 Status load_header_status =
                         StorageEngine::instance()->tablet_manager()->load_tablet_from_dir(
                                 store, _clone_req.tablet_id, _clone_req.schema_hash,
@@ -448,11 +484,11 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
         }
     }
 
-    // Get copy from remote
-    uint64_t total_file_size = 0;
-    MonotonicStopWatch watch;
-    watch.start();
-    for (auto& file_name : file_name_list) {
+    // Get copy from remote, the files are downloaded in parallel except the header file, which
+    // is downloaded after all the others.
+    std::atomic<uint64_t> total_file_size {0};
+    auto download_file = [data_dir, &remote_url_prefix, &local_path,
+                          &total_file_size](const std::string& file_name) {
         auto remote_file_url = remote_url_prefix + file_name;
 
         // get file length
@@ -483,11 +519,14 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
                   << " to: " << local_file_path << ". size(B): " << file_size
                   << ", timeout(s): " << estimate_timeout;
 
-        auto download_cb = [&remote_file_url, estimate_timeout, &local_file_path,
+        auto download_cb = [data_dir, &remote_file_url, estimate_timeout, &local_file_path,
                             file_size](HttpClient* client) {
             RETURN_IF_ERROR(client->init(remote_file_url));
             client->set_timeout_ms(estimate_timeout * 1000);
-            RETURN_IF_ERROR(client->download(local_file_path));
+            bool verify_checksum = config::clone_verify_checksum;
+            uint32_t crc = 0;
+            RETURN_IF_ERROR(client->download(local_file_path, data_dir->clone_download_limiter(),
+                                             verify_checksum ? &crc : nullptr));
 
             // Check file length
             uint64_t local_file_size = std::filesystem::file_size(local_file_path);
@@ -497,11 +536,63 @@ Status EngineCloneTask::_download_files(DataDir* data_dir, const std::string& re
                              << ", local_file_size=" << local_file_size;
                 return Status::InternalError("downloaded file size is not equal");
             }
+            // Check the crc32c computed while downloading with the one of the source file
+            if (verify_checksum) {
+                std::string remote_crc;
+                RETURN_IF_ERROR(client->init(remote_file_url + "&checksum=crc32c"));
+                client->set_timeout_ms(estimate_timeout * 1000);
+                RETURN_IF_ERROR(client->execute(&remote_crc));
+                if (remote_crc != std::to_string(crc)) {
+                    LOG(WARNING) << "download file checksum error"
+                                 << ", remote_path=" << remote_file_url
+                                 << ", remote_crc32c=" << remote_crc << ", local_crc32c=" << crc;
+                    return Status::InternalError("downloaded file checksum is not equal");
+                }
+            }
             chmod(local_file_path.c_str(), S_IRUSR | S_IWUSR);
             return Status::OK();
         };
-        RETURN_IF_ERROR(HttpClient::execute_with_retry(DOWNLOAD_FILE_MAX_RETRY, 1, download_cb));
-    } // Clone files from remote backend
+        return HttpClient::execute_with_retry(DOWNLOAD_FILE_MAX_RETRY, 1, download_cb);
+    };
+
+    MonotonicStopWatch watch;
+    watch.start();
+    size_t num_parallel_files = file_name_list.size();
+    if (num_parallel_files > 0 && StringPiece(file_name_list.back()).ends_with(".hdr")) {
+        --num_parallel_files;
+    }
+    std::unique_ptr<ThreadPool> download_pool;
+    RETURN_IF_ERROR(ThreadPoolBuilder("CloneDownloadPool")
+                            .set_min_threads(1)
+                            .set_max_threads(std::max(1, config::clone_download_parallelism))
+                            .build(&download_pool));
+    std::mutex status_lock;
+    Status download_status;
+    for (size_t i = 0; i < num_parallel_files; ++i) {
+        Status st = download_pool->submit_func([&, i]() {
+            {
+                std::lock_guard<std::mutex> l(status_lock);
+                if (!download_status.ok()) {
+                    return;
+                }
+            }
+            Status s = download_file(file_name_list[i]);
+            std::lock_guard<std::mutex> l(status_lock);
+            if (!s.ok() && download_status.ok()) {
+                download_status = s;
+            }
+        });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(status_lock);
+            download_status = st;
+            break;
+        }
+    }
+    download_pool->wait();
+    RETURN_IF_ERROR(download_status);
+    if (num_parallel_files < file_name_list.size()) {
+        RETURN_IF_ERROR(download_file(file_name_list.back()));
+    }
 
     uint64_t total_time_ms = watch.elapsed_time() / 1000 / 1000;
     total_time_ms = total_time_ms > 0 ? total_time_ms : 0;
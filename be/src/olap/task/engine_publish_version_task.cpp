@@ -19,9 +19,12 @@
 
 #include <map>
 
+#include "common/config.h"
 #include "olap/data_dir.h"
 #include "olap/rowset/rowset_meta_manager.h"
 #include "olap/tablet_manager.h"
+#include "util/countdown_latch.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
@@ -56,8 +59,10 @@ Status EnginePublishVersionTask::finish() {
         Version version(par_ver_info.version, par_ver_info.version);
 
         // each tablet
+        std::vector<TabletInfo> tablet_infos;
+        std::vector<TabletSharedPtr> tablets;
+        std::vector<RowsetSharedPtr> rowsets;
         for (auto& tablet_rs : tablet_related_rs) {
-            Status publish_status = Status::OK();
             TabletInfo tablet_info = tablet_rs.first;
             RowsetSharedPtr rowset = tablet_rs.second;
             VLOG_CRITICAL << "begin to publish version on tablet. "
@@ -83,33 +88,71 @@ Status EnginePublishVersionTask::finish() {
                 res = Status::OLAPInternalError(OLAP_ERR_PUSH_TABLE_NOT_EXIST);
                 continue;
             }
+            tablet_infos.push_back(tablet_info);
+            tablets.push_back(std::move(tablet));
+            rowsets.push_back(std::move(rowset));
+        }
 
-            publish_status = StorageEngine::instance()->txn_manager()->publish_txn(
-                    partition_id, tablet, transaction_id, version);
-            if (publish_status != Status::OK()) {
-                LOG(WARNING) << "failed to publish version. rowset_id=" << rowset->rowset_id()
-                             << ", tablet_id=" << tablet_info.tablet_id
-                             << ", txn_id=" << transaction_id;
-                _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = publish_status;
-                continue;
+        // the rowset metas of the tablets of a data dir are saved by one write batch
+        std::vector<Status> publish_statuses;
+        StorageEngine::instance()->txn_manager()->publish_txn(partition_id, tablets,
+                                                              transaction_id, version,
+                                                              &publish_statuses);
+
+        // add visible rowsets to the tablets in parallel
+        auto add_inc_rowset = [&](size_t i) {
+            Status st = tablets[i]->add_inc_rowset(rowsets[i]);
+            if (st != Status::OLAPInternalError(OLAP_ERR_PUSH_VERSION_ALREADY_EXIST)) {
+                publish_statuses[i] = st;
+            }
+        };
+        ThreadPool* publish_pool = StorageEngine::instance()->publish_version_thread_pool();
+        std::unique_ptr<ThreadPoolToken> token;
+        if (publish_pool != nullptr && config::publish_version_tablet_parallelism > 1 &&
+            tablets.size() > 1) {
+            token = publish_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT,
+                                            config::publish_version_tablet_parallelism);
+        }
+        if (token == nullptr) {
+            for (size_t i = 0; i < tablets.size(); ++i) {
+                if (publish_statuses[i].ok()) {
+                    add_inc_rowset(i);
+                }
+            }
+        } else {
+            CountDownLatch latch(tablets.size());
+            for (size_t i = 0; i < tablets.size(); ++i) {
+                if (!publish_statuses[i].ok()) {
+                    latch.count_down();
+                    continue;
+                }
+                auto st = token->submit_func([&, i]() {
+                    add_inc_rowset(i);
+                    latch.count_down();
+                });
+                if (!st.ok()) {
+                    // add it by this thread if the pool is shutting down
+                    add_inc_rowset(i);
+                    latch.count_down();
+                }
             }
+            latch.wait();
+        }
 
-            // add visible rowset to tablet
-            publish_status = tablet->add_inc_rowset(rowset);
-            if (publish_status != Status::OK() &&
-                publish_status != Status::OLAPInternalError(OLAP_ERR_PUSH_VERSION_ALREADY_EXIST)) {
-                LOG(WARNING) << "fail to add visible rowset to tablet. rowset_id="
-                             << rowset->rowset_id() << ", tablet_id=" << tablet_info.tablet_id
-                             << ", txn_id=" << transaction_id << ", res=" << publish_status;
+        for (size_t i = 0; i < tablets.size(); ++i) {
+            const TabletInfo& tablet_info = tablet_infos[i];
+            if (!publish_statuses[i].ok()) {
+                LOG(WARNING) << "failed to publish version. rowset_id=" << rowsets[i]->rowset_id()
+                             << ", tablet_id=" << tablet_info.tablet_id
+                             << ", txn_id=" << transaction_id << ", res=" << publish_statuses[i];
                 _error_tablet_ids->push_back(tablet_info.tablet_id);
-                res = publish_status;
+                res = publish_statuses[i];
                 continue;
             }
             partition_related_tablet_infos.erase(tablet_info);
-            VLOG_NOTICE << "publish version successfully on tablet. tablet=" << tablet->full_name()
-                        << ", transaction_id=" << transaction_id << ", version=" << version.first
-                        << ", res=" << publish_status;
+            VLOG_NOTICE << "publish version successfully on tablet. tablet="
+                        << tablets[i]->full_name() << ", transaction_id=" << transaction_id
+                        << ", version=" << version.first;
         }
 
         // check if the related tablet remained all have the version
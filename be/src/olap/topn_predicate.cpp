@@ -0,0 +1,215 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/topn_predicate.h"
+
+#include <cstring>
+#include <vector>
+
+#include "olap/schema.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+
+namespace doris {
+
+const ColumnPredicate* TopNColumnPredicate::_current() const {
+    if (_runtime_predicate->version() != _version) {
+        _version = _runtime_predicate->get(&_value);
+        _predicate.reset(_creator(_value));
+    }
+    return _predicate.get();
+}
+
+uint16_t TopNColumnPredicate::_merge_null_rows(const uint8_t* null_map, uint16_t* origin_sel,
+                                               uint16_t origin_size, uint16_t* sel,
+                                               uint16_t size) {
+    uint16_t new_size = 0;
+    uint16_t j = 0;
+    for (uint16_t i = 0; i < origin_size; ++i) {
+        uint16_t idx = origin_sel[i];
+        if (j < size && sel[j] == idx) {
+            origin_sel[new_size++] = idx;
+            ++j;
+        } else if (null_map[idx]) {
+            origin_sel[new_size++] = idx;
+        }
+    }
+    memcpy(sel, origin_sel, new_size * sizeof(uint16_t));
+    return new_size;
+}
+
+void TopNColumnPredicate::evaluate(VectorizedRowBatch* batch) const {
+    // only used by the segment v1, on which the nulls are not kept
+    auto predicate = _current();
+    if (predicate != nullptr && !_runtime_predicate->nulls_first()) {
+        predicate->evaluate(batch);
+    }
+}
+
+void TopNColumnPredicate::evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        return;
+    }
+    if (!_keep_nulls(block->is_nullable())) {
+        predicate->evaluate(block, sel, size);
+        return;
+    }
+    std::unique_ptr<bool[]> flags(new bool[*size]);
+    for (uint16_t i = 0; i < *size; ++i) {
+        flags[i] = block->is_null(sel[i]);
+    }
+    predicate->evaluate_or(block, sel, *size, flags.get());
+    uint16_t new_size = 0;
+    for (uint16_t i = 0; i < *size; ++i) {
+        if (flags[i]) {
+            sel[new_size++] = sel[i];
+        }
+    }
+    *size = new_size;
+}
+
+void TopNColumnPredicate::evaluate_or(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                                      bool* flags) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        memset(flags, 1, size);
+        return;
+    }
+    if (_keep_nulls(block->is_nullable())) {
+        for (uint16_t i = 0; i < size; ++i) {
+            flags[i] |= block->is_null(sel[i]);
+        }
+    }
+    predicate->evaluate_or(block, sel, size, flags);
+}
+
+void TopNColumnPredicate::evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                                       bool* flags) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        return;
+    }
+    if (!_keep_nulls(block->is_nullable())) {
+        predicate->evaluate_and(block, sel, size, flags);
+        return;
+    }
+    std::unique_ptr<bool[]> pass(new bool[size]);
+    for (uint16_t i = 0; i < size; ++i) {
+        pass[i] = block->is_null(sel[i]);
+    }
+    predicate->evaluate_or(block, sel, size, pass.get());
+    for (uint16_t i = 0; i < size; ++i) {
+        flags[i] &= pass[i];
+    }
+}
+
+Status TopNColumnPredicate::evaluate(const Schema& schema,
+                                     const std::vector<BitmapIndexIterator*>& iterators,
+                                     uint32_t num_rows, roaring::Roaring* roaring) const {
+    auto predicate = _current();
+    if (predicate == nullptr || _keep_nulls(schema.column(_column_id)->is_nullable())) {
+        return Status::OK();
+    }
+    return predicate->evaluate(schema, iterators, num_rows, roaring);
+}
+
+void TopNColumnPredicate::evaluate(vectorized::IColumn& column, uint16_t* sel,
+                                   uint16_t* size) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        return;
+    }
+    if (!_keep_nulls(column.is_nullable())) {
+        predicate->evaluate(column, sel, size);
+        return;
+    }
+    std::vector<uint16_t> origin_sel(sel, sel + *size);
+    uint16_t new_size = *size;
+    predicate->evaluate(column, sel, &new_size);
+    const auto& null_map =
+            assert_cast<const vectorized::ColumnNullable&>(column).get_null_map_data();
+    *size = _merge_null_rows(null_map.data(), origin_sel.data(), origin_sel.size(), sel, new_size);
+}
+
+void TopNColumnPredicate::evaluate_and(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                                       bool* flags) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        return;
+    }
+    if (!_keep_nulls(column.is_nullable())) {
+        predicate->evaluate_and(column, sel, size, flags);
+        return;
+    }
+    const auto& null_map =
+            assert_cast<const vectorized::ColumnNullable&>(column).get_null_map_data();
+    std::unique_ptr<bool[]> pass(new bool[size]);
+    for (uint16_t i = 0; i < size; ++i) {
+        pass[i] = null_map[sel[i]];
+    }
+    predicate->evaluate_or(column, sel, size, pass.get());
+    for (uint16_t i = 0; i < size; ++i) {
+        flags[i] &= pass[i];
+    }
+}
+
+void TopNColumnPredicate::evaluate_or(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                                      bool* flags) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        memset(flags, 1, size);
+        return;
+    }
+    if (_keep_nulls(column.is_nullable())) {
+        const auto& null_map =
+                assert_cast<const vectorized::ColumnNullable&>(column).get_null_map_data();
+        for (uint16_t i = 0; i < size; ++i) {
+            flags[i] |= null_map[sel[i]];
+        }
+    }
+    predicate->evaluate_or(column, sel, size, flags);
+}
+
+void TopNColumnPredicate::evaluate_vec(vectorized::IColumn& column, uint16_t size,
+                                       bool* flags) const {
+    auto predicate = _current();
+    if (predicate == nullptr) {
+        memset(flags, 1, size);
+        return;
+    }
+    predicate->evaluate_vec(column, size, flags);
+    if (_keep_nulls(column.is_nullable())) {
+        const auto& null_map =
+                assert_cast<const vectorized::ColumnNullable&>(column).get_null_map_data();
+        for (uint16_t i = 0; i < size; ++i) {
+            flags[i] |= null_map[i];
+        }
+    }
+}
+
+bool TopNColumnPredicate::get_condition(TCondition* condition) const {
+    if (_current() == nullptr) {
+        return false;
+    }
+    condition->__set_column_name(_column_name);
+    condition->__set_condition_op(_runtime_predicate->is_asc() ? "<=" : ">=");
+    condition->__set_condition_values({_value});
+    return true;
+}
+
+} // namespace doris
@@ -0,0 +1,137 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "gen_cpp/PaloInternalService_types.h"
+#include "olap/column_predicate.h"
+
+namespace doris {
+
+// The boundary of a Top-N sort on a column, i.e. the value of the column of the last row the
+// sort keeps. It's published by the sort node while it reads its input, and the scan below it
+// skips the rows after the boundary, which can't be in the result. The boundary only tightens.
+class TopNRuntimePredicate {
+public:
+    TopNRuntimePredicate(bool is_asc, bool nulls_first)
+            : _is_asc(is_asc), _nulls_first(nulls_first) {}
+
+    bool is_asc() const { return _is_asc; }
+    bool nulls_first() const { return _nulls_first; }
+
+    // `value` is in the format of the conditions pushed down to the storage
+    void update(std::string value) {
+        std::lock_guard<std::mutex> l(_lock);
+        _value = std::move(value);
+        _version.fetch_add(1, std::memory_order_release);
+    }
+
+    // 0 until the first update, increased by each update
+    uint64_t version() const { return _version.load(std::memory_order_acquire); }
+
+    uint64_t get(std::string* value) const {
+        std::lock_guard<std::mutex> l(_lock);
+        *value = _value;
+        return _version.load(std::memory_order_relaxed);
+    }
+
+private:
+    const bool _is_asc;
+    const bool _nulls_first;
+
+    mutable std::mutex _lock;
+    std::string _value;
+    std::atomic<uint64_t> _version {0};
+};
+
+// The column predicate of the latest boundary of a TopNRuntimePredicate: `column <= boundary`
+// for an ascending sort, `column >= boundary` for a descending one, and the nulls pass it if they
+// are sorted first. The rows equal to the boundary are kept for the other ordering columns.
+//
+// The comparison predicate of the boundary is rebuilt by `creator` when the boundary changes. All
+// the rows pass until the first boundary is published, or if `creator` returns nullptr.
+// Not thread safe, each reader has its own one.
+class TopNColumnPredicate : public ColumnPredicate {
+public:
+    using PredicateCreator = std::function<ColumnPredicate*(const std::string&)>;
+
+    TopNColumnPredicate(uint32_t column_id, std::string column_name,
+                        std::shared_ptr<TopNRuntimePredicate> runtime_predicate,
+                        PredicateCreator creator)
+            : ColumnPredicate(column_id),
+              _column_name(std::move(column_name)),
+              _runtime_predicate(std::move(runtime_predicate)),
+              _creator(std::move(creator)) {}
+
+    ~TopNColumnPredicate() override = default;
+
+    PredicateType type() const override {
+        return _runtime_predicate->is_asc() ? PredicateType::LE : PredicateType::GE;
+    }
+
+    void evaluate(VectorizedRowBatch* batch) const override;
+
+    void evaluate(ColumnBlock* block, uint16_t* sel, uint16_t* size) const override;
+    void evaluate_or(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                     bool* flags) const override;
+    void evaluate_and(ColumnBlock* block, uint16_t* sel, uint16_t size,
+                      bool* flags) const override;
+
+    Status evaluate(const Schema& schema, const std::vector<BitmapIndexIterator*>& iterators,
+                    uint32_t num_rows, roaring::Roaring* roaring) const override;
+
+    void evaluate(vectorized::IColumn& column, uint16_t* sel, uint16_t* size) const override;
+    void evaluate_and(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                      bool* flags) const override;
+    void evaluate_or(vectorized::IColumn& column, uint16_t* sel, uint16_t size,
+                     bool* flags) const override;
+
+    void evaluate_vec(vectorized::IColumn& column, uint16_t size, bool* flags) const override;
+
+    // The condition of the latest boundary, to prune the pages by the zone maps.
+    // Return false if there is no boundary yet.
+    bool get_condition(TCondition* condition) const;
+
+private:
+    // rebuild the comparison predicate if the boundary changed, return nullptr if all rows pass
+    const ColumnPredicate* _current() const;
+
+    bool _keep_nulls(bool is_nullable) const {
+        return is_nullable && _runtime_predicate->nulls_first();
+    }
+
+    // merge the null rows of `origin_sel` back into `sel`, the rows `origin_sel` selected before
+    // the comparison predicate filtered out the nulls, `origin_sel` is used as the buffer
+    static uint16_t _merge_null_rows(const uint8_t* null_map, uint16_t* origin_sel,
+                                     uint16_t origin_size, uint16_t* sel, uint16_t size);
+
+    const std::string _column_name;
+    std::shared_ptr<TopNRuntimePredicate> _runtime_predicate;
+    PredicateCreator _creator;
+
+    mutable uint64_t _version = 0;
+    mutable std::string _value;
+    mutable std::unique_ptr<ColumnPredicate> _predicate;
+};
+
+} // namespace doris
@@ -313,6 +313,82 @@ Status TxnManager::publish_txn(OlapMeta* meta, TPartitionId partition_id,
     }
 }
 
+void TxnManager::publish_txn(TPartitionId partition_id, const std::vector<TabletSharedPtr>& tablets,
+                             TTransactionId transaction_id, const Version& version,
+                             std::vector<Status>* statuses) {
+    pair<int64_t, int64_t> key(partition_id, transaction_id);
+    std::vector<TabletInfo> tablet_infos;
+    tablet_infos.reserve(tablets.size());
+    for (const auto& tablet : tablets) {
+        tablet_infos.emplace_back(tablet->tablet_id(), tablet->schema_hash(), tablet->tablet_uid());
+    }
+    statuses->assign(tablets.size(), Status::OK());
+    std::vector<RowsetSharedPtr> rowsets(tablets.size());
+    std::unique_lock<std::mutex> txn_lock(_get_txn_lock(transaction_id));
+    {
+        std::shared_lock rlock(_get_txn_map_lock(transaction_id));
+        txn_tablet_map_t& txn_tablet_map = _get_txn_tablet_map(transaction_id);
+        auto it = txn_tablet_map.find(key);
+        for (size_t i = 0; i < tablets.size(); ++i) {
+            if (it != txn_tablet_map.end()) {
+                auto load_itr = it->second.find(tablet_infos[i]);
+                if (load_itr != it->second.end()) {
+                    rowsets[i] = load_itr->second.rowset;
+                }
+            }
+            if (rowsets[i] == nullptr) {
+                (*statuses)[i] = Status::OLAPInternalError(OLAP_ERR_TRANSACTION_NOT_EXIST);
+            }
+        }
+    }
+    // save meta need access disk, it maybe very slow, so that it is not in global txn lock.
+    // the metas of the rowsets of a data dir are saved together
+    std::map<OlapMeta*, std::vector<size_t>> meta_to_tablets;
+    for (size_t i = 0; i < tablets.size(); ++i) {
+        if (rowsets[i] != nullptr) {
+            rowsets[i]->make_visible(version);
+            meta_to_tablets[tablets[i]->data_dir()->get_meta()].push_back(i);
+        }
+    }
+    for (const auto& [meta, indexes] : meta_to_tablets) {
+        std::vector<RowsetMetaSharedPtr> rowset_metas;
+        rowset_metas.reserve(indexes.size());
+        for (size_t i : indexes) {
+            rowset_metas.push_back(rowsets[i]->rowset_meta());
+        }
+        Status save_status = RowsetMetaManager::save(meta, rowset_metas);
+        if (!save_status.ok()) {
+            LOG(WARNING) << "save committed rowsets failed when publish txn. txn id:"
+                         << transaction_id << ", rowset num: " << indexes.size()
+                         << ", root path: " << meta->get_root_path();
+            for (size_t i : indexes) {
+                (*statuses)[i] = Status::OLAPInternalError(OLAP_ERR_ROWSET_SAVE_FAILED);
+            }
+        }
+    }
+    {
+        std::lock_guard<std::shared_mutex> wrlock(_get_txn_map_lock(transaction_id));
+        txn_tablet_map_t& txn_tablet_map = _get_txn_tablet_map(transaction_id);
+        auto it = txn_tablet_map.find(key);
+        if (it == txn_tablet_map.end()) {
+            return;
+        }
+        for (size_t i = 0; i < tablets.size(); ++i) {
+            if ((*statuses)[i].ok()) {
+                it->second.erase(tablet_infos[i]);
+            }
+        }
+        VLOG_NOTICE << "publish txn successfully."
+                    << " partition_id: " << key.first << ", txn_id: " << key.second
+                    << ", tablet num: " << tablets.size() << ", version: " << version.first << ","
+                    << version.second;
+        if (it->second.empty()) {
+            txn_tablet_map.erase(it);
+            _clear_txn_partition_map_unlocked(transaction_id, partition_id);
+        }
+    }
+}
+
 // txn could be rollbacked if it does not have related rowset
 // if the txn has related rowset then could not rollback it, because it
 // may be committed in another thread and our current thread meets errors when writing to data file
@@ -80,6 +80,12 @@ public:
     Status publish_txn(TPartitionId partition_id, const TabletSharedPtr& tablet,
                        TTransactionId transaction_id, const Version& version);
 
+    // Publish the txn on the tablets of a partition, the metas of the visible rowsets of each
+    // data dir are saved by one write batch. The status of tablets[i] is set to statuses[i].
+    void publish_txn(TPartitionId partition_id, const std::vector<TabletSharedPtr>& tablets,
+                     TTransactionId transaction_id, const Version& version,
+                     std::vector<Status>* statuses);
+
     // delete the txn from manager if it is not committed(not have a valid rowset)
     Status rollback_txn(TPartitionId partition_id, const TabletSharedPtr& tablet,
                         TTransactionId transaction_id);
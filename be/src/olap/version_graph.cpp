@@ -31,6 +31,7 @@ void TimestampedVersionTracker::_construct_versioned_tracker(
         const std::vector<RowsetMetaSharedPtr>& rs_metas) {
     int64_t max_version = 0;
 
+    _invalidate_cached_path();
     // construct the rowset graph
     _version_graph.reconstruct_version_graph(rs_metas, &max_version);
 }
@@ -267,6 +268,7 @@ void TimestampedVersionTracker::get_stale_version_path_json_doc(rapidjson::Docum
 
 void TimestampedVersionTracker::recover_versioned_tracker(
         const std::map<int64_t, PathVersionListSharedPtr>& stale_version_path_map) {
+    _invalidate_cached_path();
     auto _path_map_iter = stale_version_path_map.begin();
     // Recover `stale_version_path_map`.
     while (_path_map_iter != stale_version_path_map.end()) {
@@ -288,6 +290,7 @@ void TimestampedVersionTracker::recover_versioned_tracker(
 }
 
 void TimestampedVersionTracker::add_version(const Version& version) {
+    _invalidate_cached_path();
     _version_graph.add_version_to_graph(version);
 }
 
@@ -321,7 +324,22 @@ void TimestampedVersionTracker::add_stale_path_version(
 // Capture consistent versions from graph.
 Status TimestampedVersionTracker::capture_consistent_versions(
         const Version& spec_version, std::vector<Version>* version_path) const {
-    return _version_graph.capture_consistent_versions(spec_version, version_path);
+    std::shared_ptr<const CachedVersionPath> cached = std::atomic_load(&_cached_path);
+    if (cached != nullptr && cached->spec_version == spec_version) {
+        if (version_path != nullptr) {
+            *version_path = cached->version_path;
+        }
+        return Status::OK();
+    }
+
+    auto path = std::make_shared<CachedVersionPath>();
+    path->spec_version = spec_version;
+    RETURN_NOT_OK(_version_graph.capture_consistent_versions(spec_version, &path->version_path));
+    if (version_path != nullptr) {
+        *version_path = path->version_path;
+    }
+    std::atomic_store(&_cached_path, std::shared_ptr<const CachedVersionPath>(std::move(path)));
+    return Status::OK();
 }
 
 void TimestampedVersionTracker::capture_expired_paths(
@@ -359,6 +377,7 @@ PathVersionListSharedPtr TimestampedVersionTracker::fetch_and_delete_path_by_id(
 
     _stale_version_path_map.erase(path_id);
 
+    _invalidate_cached_path();
     for (auto& version : ptr->timestamped_versions()) {
         _version_graph.delete_version_from_graph(version->version());
     }
@@ -21,6 +21,9 @@
 #include <rapidjson/prettywriter.h>
 #include <rapidjson/stringbuffer.h>
 
+#include <atomic>
+#include <memory>
+
 #include "olap/olap_common.h"
 #include "olap/olap_define.h"
 #include "olap/rowset/rowset_meta.h"
@@ -156,6 +159,9 @@ public:
     /// Given a spec_version, this method can find a version path which is the shortest path
     /// in the graph. The version paths are added to version_path as return info.
     /// If this version not in main version, version_path can be included expired rowset.
+    /// The path of the last spec_version is cached until the graph is changed, so the
+    /// repeated reads of the same version skip the graph search.
+    /// It may be called concurrently, but not concurrently with the methods changing the tracker.
     Status capture_consistent_versions(const Version& spec_version,
                                        std::vector<Version>* version_path) const;
 
@@ -209,6 +215,17 @@ private:
     std::map<int64_t, PathVersionListSharedPtr> _stale_version_path_map;
 
     VersionGraph _version_graph;
+
+    struct CachedVersionPath {
+        Version spec_version;
+        std::vector<Version> version_path;
+    };
+    // the path captured last time, accessed by std::atomic_load and std::atomic_store
+    mutable std::shared_ptr<const CachedVersionPath> _cached_path;
+
+    void _invalidate_cached_path() {
+        std::atomic_store(&_cached_path, std::shared_ptr<const CachedVersionPath>());
+    }
 };
 
 } // namespace doris
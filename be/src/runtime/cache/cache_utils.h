@@ -49,7 +49,7 @@ struct CacheStat {
     uint32 read_count;
     CacheStat() { init(); }
 
-    long cache_time_second() {
+    static long cache_time_second() {
         struct timeval tv;
         gettimeofday(&tv, nullptr);
         return tv.tv_sec;
@@ -16,8 +16,11 @@
 // under the License.
 #include "runtime/cache/result_cache.h"
 
+#include <queue>
+
 #include "gen_cpp/internal_service.pb.h"
 #include "util/doris_metrics.h"
+#include "util/file_utils.h"
 
 namespace doris {
 
@@ -71,6 +74,31 @@ void ResultNodeList::clear() {
     }
     _node_count = 0;
 }
+ResultCache::ResultCache(int32 max_size, int32 elasticity_size, const std::string& spill_path,
+                         int32 spill_max_size) {
+    _max_size = max_size * 1024 * 1024;
+    _elasticity_size = elasticity_size * 1024 * 1024;
+    _cache_size = 0;
+    _spill_size = 0;
+    _spill_max_size = static_cast<size_t>(spill_max_size) * 1024 * 1024;
+    _node_count = 0;
+    _partition_count = 0;
+    if (!spill_path.empty() && _spill_max_size > 0) {
+        // the files spilled before the restart are useless
+        std::string dir = spill_path + "/result_cache";
+        Status st = FileUtils::remove_all(dir);
+        if (st.ok()) {
+            st = FileUtils::create_dir(dir);
+        }
+        if (st.ok()) {
+            _spill_dir = dir;
+        } else {
+            LOG(WARNING) << "failed to init the result cache spill dir " << dir << ": "
+                         << st.to_string();
+        }
+    }
+}
+
 /**
  * Find the node and update partition data
  * New node, the node updated in the first partition will move to the tail of the list
@@ -87,6 +115,7 @@ void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* res
     if (it != _node_map.end()) {
         node = it->second;
         _cache_size -= node->get_data_size();
+        _spill_size -= node->get_spill_size();
         _partition_count -= node->get_partition_count();
         status = node->update_partition(request, update_first);
     } else {
@@ -100,6 +129,7 @@ void ResultCache::update(const PUpdateCacheRequest* request, PCacheResponse* res
         _node_list.move_tail(node);
     }
     _cache_size += node->get_data_size();
+    _spill_size += node->get_spill_size();
     _partition_count += node->get_partition_count();
     response->set_status(status);
 
@@ -129,16 +159,21 @@ void ResultCache::fetch(const PFetchCacheRequest* request, PFetchCacheResult* re
 
         for (auto part_it = part_rowbatch_list.begin(); part_it != part_rowbatch_list.end();
              part_it++) {
-            PCacheValue* srcValue = (*part_it)->get_value();
-            if (srcValue != nullptr) {
-                PCacheValue* value = result->add_values();
-                value->CopyFrom(*srcValue);
-                LOG(INFO) << "fetch cache partition key:" << srcValue->param().partition_key();
-            } else {
+            if (!(*part_it)->has_value()) {
                 LOG(WARNING) << "prowbatch of cache is null";
                 status = PCacheStatus::EMPTY_DATA;
                 break;
             }
+            PCacheValue* value = result->add_values();
+            Status st = (*part_it)->get_value(value);
+            if (!st.ok()) {
+                LOG(WARNING) << "failed to get the cache partition "
+                             << (*part_it)->get_partition_key() << ": " << st.to_string();
+                result->mutable_values()->RemoveLast();
+                status = PCacheStatus::EMPTY_DATA;
+                break;
+            }
+            LOG(INFO) << "fetch cache partition key:" << value->param().partition_key();
         }
         if (status == PCacheStatus::CACHE_OK && part_rowbatch_list.empty()) {
             status = PCacheStatus::EMPTY_DATA;
@@ -175,6 +210,7 @@ void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* respo
         _node_list.clear();
         _node_map.clear();
         _cache_size = 0;
+        _spill_size = 0;
         _node_count = 0;
         _partition_count = 0;
         break;
@@ -189,71 +225,95 @@ void ResultCache::clear(const PClearCacheRequest* request, PCacheResponse* respo
 }
 
 //private method
-ResultNode* find_min_time_node(ResultNode* result_node) {
-    if (result_node->get_prev()) {
-        if (result_node->get_prev()->first_partition_last_time() <=
-            result_node->first_partition_last_time()) {
-            return result_node->get_prev();
-        }
-    }
-
-    if (result_node->get_next()) {
-        if (result_node->get_next()->first_partition_last_time() <
-            result_node->first_partition_last_time()) {
-            return result_node->get_next();
-        }
-    }
-    return result_node;
-}
-
 /*
-* Two-dimensional array, prune the min last_read_time PartitionRowBatch.
-* The following example is the last read time array.
-* 1 and 2 is the read time, nodes with pruning read time < 3
-* Before:
-*   1,2         //_head ResultNode*
-*   1,2,3,4,5   
-*   2,4,3,6,8   
-*   5,7,9,11,13 //_tail ResultNode*
-* After:
-*   4,5         //_head
-*   4,3,6,8
-*   5,7,9,11,13 //_tail
+* Prune the partitions until the cache size is under the max size. The candidates are the first
+* in-memory partitions of the nodes, the one with the least retain score is spilled, or pruned
+* if it can't be spilled. Only the first partition of a node is pruned, so the partitions in the
+* cache are always the latest ones, which a time-series query reuses.
 */
 void ResultCache::prune() {
     if (_cache_size <= (_max_size + _elasticity_size)) {
         return;
     }
     LOG(INFO) << "begin prune cache, cache_size : " << _cache_size << ", max_size : " << _max_size
-              << ", elasticity_size : " << _elasticity_size;
-    ResultNode* result_node = _node_list.get_head();
-    while (_cache_size > _max_size) {
-        if (result_node == nullptr) {
-            break;
+              << ", elasticity_size : " << _elasticity_size << ", spill_size : " << _spill_size;
+    long now = CacheStat::cache_time_second();
+    using Candidate = std::pair<double, ResultNode*>;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    for (auto& [sql_key, node] : _node_map) {
+        PartitionRowBatch* partition = node->first_memory_partition();
+        if (partition != nullptr) {
+            candidates.emplace(partition->retain_score(now), node);
         }
-        result_node = find_min_time_node(result_node);
-        _cache_size -= result_node->prune_first();
-        if (result_node->get_data_size() == 0) {
-            ResultNode* next_node;
-            if (result_node->get_next()) {
-                next_node = result_node->get_next();
-            } else if (result_node->get_prev()) {
-                next_node = result_node->get_prev();
-            } else {
-                next_node = _node_list.get_head();
-            }
-            remove(result_node);
-            result_node = next_node;
+    }
+    while (_cache_size > _max_size && !candidates.empty()) {
+        ResultNode* node = candidates.top().second;
+        candidates.pop();
+        PartitionRowBatch* partition = node->first_memory_partition();
+        DCHECK(partition != nullptr);
+        if (!spill(node, partition)) {
+            // the first partition may be a spilled one, then the spill path is full and
+            // the partition is tried again
+            _spill_size -= node->get_spill_size();
+            _cache_size -= node->prune_first();
+            _spill_size += node->get_spill_size();
+        }
+        if (node->first_memory_partition() != nullptr) {
+            candidates.emplace(node->first_memory_partition()->retain_score(now), node);
+        } else if (node->get_partition_count() == 0) {
+            remove(node);
         }
     }
-    LOG(INFO) << "finish prune, cache_size : " << _cache_size;
+    LOG(INFO) << "finish prune, cache_size : " << _cache_size << ", spill_size : " << _spill_size;
     _node_count = _node_map.size();
     _cache_size = 0;
+    _spill_size = 0;
     _partition_count = 0;
     for (auto node_it = _node_map.begin(); node_it != _node_map.end(); node_it++) {
         _partition_count += node_it->second->get_partition_count();
         _cache_size += node_it->second->get_data_size();
+        _spill_size += node_it->second->get_spill_size();
+    }
+}
+
+bool ResultCache::spill(ResultNode* node, PartitionRowBatch* partition) {
+    if (_spill_dir.empty() || partition->get_data_size() > _spill_max_size) {
+        return false;
+    }
+    // make room by pruning the spilled first partitions, the least recently read first
+    while (_spill_size + partition->get_data_size() > _spill_max_size) {
+        ResultNode* oldest = nullptr;
+        for (auto& [sql_key, spilled_node] : _node_map) {
+            if (spilled_node->first_partition_spilled() &&
+                (oldest == nullptr ||
+                 spilled_node->first_partition_last_time() < oldest->first_partition_last_time())) {
+                oldest = spilled_node;
+            }
+        }
+        if (oldest == nullptr) {
+            return false;
+        }
+        _spill_size -= oldest->get_spill_size();
+        oldest->prune_first();
+        _spill_size += oldest->get_spill_size();
+        // a node with all the partitions spilled is not a candidate of prune(), so it's
+        // safe to remove it
+        if (oldest->get_partition_count() == 0) {
+            remove(oldest);
+        }
+    }
+    std::string path = _spill_dir + "/" + node->get_sql_key().to_string() + "_" +
+                       std::to_string(partition->get_partition_key());
+    size_t data_size = partition->get_data_size();
+    Status st = node->spill_partition(partition, path);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to spill the cache partition to " << path << ": "
+                     << st.to_string();
+        return false;
     }
+    _cache_size -= data_size;
+    _spill_size += partition->get_spill_size();
+    return true;
 }
 
 void ResultCache::remove(ResultNode* result_node) {
@@ -269,6 +329,7 @@ void ResultCache::update_monitor() {
     DorisMetrics::instance()->query_cache_memory_total_byte->set_value(_cache_size);
     DorisMetrics::instance()->query_cache_sql_total_count->set_value(_node_count);
     DorisMetrics::instance()->query_cache_partition_total_count->set_value(_partition_count);
+    DorisMetrics::instance()->query_cache_spill_total_byte->set_value(_spill_size);
 }
 
 } // namespace doris
@@ -27,6 +27,7 @@
 #include <map>
 #include <mutex>
 #include <shared_mutex>
+#include <string>
 #include <thread>
 
 #include "common/config.h"
@@ -74,16 +75,14 @@ private:
  * Two data structures, one is unordered_map and the other is a doubly linked list, corresponding to a result node.
  * If the cache is hit, the node will be moved to the end of the linked list.
  * If the cache is cleared, nodes that are expired or have not been accessed for a long time will be cleared.
+ * When the memory is full, the partition with the least retain score (see PartitionRowBatch) among
+ * the first in-memory partitions of the nodes is spilled to the spill path, or pruned if it can't
+ * be spilled.
  */
 class ResultCache {
 public:
-    ResultCache(int32 max_size, int32 elasticity_size) {
-        _max_size = max_size * 1024 * 1024;
-        _elasticity_size = elasticity_size * 1024 * 1024;
-        _cache_size = 0;
-        _node_count = 0;
-        _partition_count = 0;
-    }
+    ResultCache(int32 max_size, int32 elasticity_size, const std::string& spill_path = "",
+                int32 spill_max_size = 0);
 
     virtual ~ResultCache() {}
     void update(const PUpdateCacheRequest* request, PCacheResponse* response);
@@ -93,8 +92,13 @@ public:
 
     size_t get_cache_size() { return _cache_size; }
 
+    size_t get_spill_size() { return _spill_size; }
+
 private:
     void prune();
+    // Spill `partition` of `node`, making room by pruning the spilled partitions if the spill
+    // path is full. Returns false if it's not spilled.
+    bool spill(ResultNode* node, PartitionRowBatch* partition);
     void remove(ResultNode* result_node);
     void update_monitor();
 
@@ -106,6 +110,11 @@ private:
     ResultNodeList _node_list;
     size_t _cache_size;
     size_t _max_size;
+    // the cache files are in the "result_cache" sub-directory of the spill path, empty means
+    // the partitions are not spilled
+    std::string _spill_dir;
+    size_t _spill_size;
+    size_t _spill_max_size;
     double _elasticity_size;
     size_t _node_count;
     size_t _partition_count;
@@ -16,8 +16,13 @@
 // under the License.
 #include "runtime/cache/result_node.h"
 
+#include "env/env.h"
+#include "env/env_util.h"
 #include "gen_cpp/internal_service.pb.h"
+#include "gen_cpp/segment_v2.pb.h"
 #include "runtime/cache/cache_utils.h"
+#include "util/block_compression.h"
+#include "util/file_utils.h"
 
 namespace doris {
 
@@ -27,19 +32,93 @@ bool compare_partition(const PartitionRowBatch* left_node, const PartitionRowBat
 
 //return new batch size,only include the size of PRowBatch
 void PartitionRowBatch::set_row_batch(const PCacheValue& value) {
-    if (_cache_value != nullptr && !check_newer(value.param())) {
-        LOG(WARNING) << "set old version data, cache ver:" << _cache_value->param().last_version()
-                     << ",cache time:" << _cache_value->param().last_version_time()
+    if (_has_value && !check_newer(value.param())) {
+        LOG(WARNING) << "set old version data, cache ver:" << _param.last_version()
+                     << ",cache time:" << _param.last_version_time()
                      << ", setdata ver:" << value.param().last_version()
                      << ",setdata time:" << value.param().last_version_time();
         return;
     }
-    SAFE_DELETE(_cache_value);
-    _cache_value = new PCacheValue(value);
-    _data_size += _cache_value->data_size();
+    remove_spill_file();
+    std::string raw = value.SerializeAsString();
+    _raw_size = raw.size();
+    _compressed = false;
+    const BlockCompressionCodec* codec = nullptr;
+    if (get_block_compression_codec(segment_v2::CompressionTypePB::LZ4, &codec).ok() &&
+        codec != nullptr) {
+        _data.resize(codec->max_compressed_len(raw.size()));
+        Slice compressed(_data);
+        // keep the raw data if it can't be compressed
+        if (codec->compress(Slice(raw), &compressed).ok() && compressed.size < raw.size()) {
+            _data.resize(compressed.size);
+            _compressed = true;
+        }
+    }
+    if (!_compressed) {
+        _data = std::move(raw);
+    }
+    _data.shrink_to_fit();
+    _param = value.param();
+    _compute_time_ms = value.compute_time_ms();
+    _has_value = true;
+    _data_size = _data.size();
     _cache_stat.update();
-    LOG(INFO) << "finish set row batch, row num:" << _cache_value->rows_size()
-              << ", data size:" << _data_size;
+    LOG(INFO) << "finish set row batch, row num:" << value.rows_size()
+              << ", data size:" << _data_size << ", raw size:" << _raw_size;
+}
+
+Status PartitionRowBatch::get_value(PCacheValue* value) const {
+    std::string spilled;
+    const std::string* data = &_data;
+    if (is_spilled()) {
+        RETURN_IF_ERROR(env_util::read_file_to_string(Env::Default(), _spill_path, &spilled));
+        data = &spilled;
+    }
+    std::string raw;
+    if (_compressed) {
+        const BlockCompressionCodec* codec = nullptr;
+        RETURN_IF_ERROR(get_block_compression_codec(segment_v2::CompressionTypePB::LZ4, &codec));
+        raw.resize(_raw_size);
+        Slice decompressed(raw);
+        RETURN_IF_ERROR(codec->decompress(Slice(*data), &decompressed));
+        if (decompressed.size != _raw_size) {
+            return Status::Corruption("the decompressed size of the cached value mismatch");
+        }
+        data = &raw;
+    }
+    if (!value->ParseFromString(*data)) {
+        return Status::Corruption("failed to parse the cached value");
+    }
+    return Status::OK();
+}
+
+Status PartitionRowBatch::spill(const std::string& path) {
+    DCHECK(!is_spilled());
+    RETURN_IF_ERROR(env_util::write_string_to_file(Env::Default(), Slice(_data), path));
+    _spill_path = path;
+    _spill_size = _data.size();
+    std::string().swap(_data);
+    _data_size = 0;
+    return Status::OK();
+}
+
+void PartitionRowBatch::remove_spill_file() {
+    if (!is_spilled()) {
+        return;
+    }
+    Status st = FileUtils::remove(_spill_path);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to remove the spilled cache file " << _spill_path << ": "
+                     << st.to_string();
+    }
+    _spill_path.clear();
+    _spill_size = 0;
+}
+
+double PartitionRowBatch::retain_score(long now) const {
+    double idle_seconds = std::max(now - _cache_stat.last_read_time, 0L) + 1;
+    return (_compute_time_ms + 1.0) * _cache_stat.read_count /
+           (std::max<size_t>(_data_size, 1) * idle_seconds);
 }
 
 bool PartitionRowBatch::is_hit_cache(const PCacheParam& param) {
@@ -52,7 +131,9 @@ bool PartitionRowBatch::is_hit_cache(const PCacheParam& param) {
 
 void PartitionRowBatch::clear() {
     LOG(INFO) << "clear partition rowbatch.";
-    SAFE_DELETE(_cache_value);
+    remove_spill_file();
+    std::string().swap(_data);
+    _has_value = false;
     _partition_key = 0;
     _data_size = 0;
     _cache_stat.init();
@@ -103,6 +184,7 @@ PCacheStatus ResultNode::update_sql_cache(const PUpdateCacheRequest* request,
         // compatible with previous version
         for (auto it = _partition_list.begin(); it != _partition_list.end(); it++) {
             _data_size -= (*it)->get_data_size();
+            _spill_size -= (*it)->get_spill_size();
         }
         // clear old cache, and create new cache node
         for (auto it = _partition_list.begin(); it != _partition_list.end();) {
@@ -150,6 +232,7 @@ PCacheStatus ResultNode::update_partition_cache(const PUpdateCacheRequest* reque
         } else {
             partition = it->second;
             _data_size -= partition->get_data_size();
+            _spill_size -= partition->get_spill_size();
             partition->set_row_batch(value);
 #ifdef PARTITION_CACHE_DEV
             LOG(INFO) << "update index:" << i << ", pkey:" << partition->get_partition_key()
@@ -158,6 +241,7 @@ PCacheStatus ResultNode::update_partition_cache(const PUpdateCacheRequest* reque
 #endif
         }
         _data_size += partition->get_data_size();
+        _spill_size += partition->get_spill_size();
     }
     _partition_list.sort(compare_partition);
     VLOG(1) << "finish update partition cache batches:" << _partition_list.size();
@@ -236,12 +320,11 @@ PCacheStatus ResultNode::fetch_partition(const PFetchCacheRequest* request,
                       << ", param part Key : " << request->params(param_idx).partition_key()
                       << ", batch part key : " << (*part_it)->get_partition_key()
                       << ", param part version : " << request->params(param_idx).last_version()
-                      << ", batch part version : "
-                      << (*part_it)->get_value()->param().last_version()
+                      << ", batch part version : " << (*part_it)->get_param().last_version()
                       << ", param part version time : "
                       << request->params(param_idx).last_version_time()
                       << ", batch part version time : "
-                      << (*part_it)->get_value()->param().last_version_time();
+                      << (*part_it)->get_param().last_version_time();
 #endif
             if ((*part_it)->is_hit_cache(request->params(param_idx))) {
                 if (begin_idx < 0) {
@@ -291,6 +374,7 @@ size_t ResultNode::prune_first() {
     }
     PartitionRowBatch* part_node = *_partition_list.begin();
     size_t prune_size = part_node->get_data_size();
+    _spill_size -= part_node->get_spill_size();
     _partition_list.erase(_partition_list.begin());
     _partition_map.erase(part_node->get_partition_key());
     part_node->clear();
@@ -299,6 +383,23 @@ size_t ResultNode::prune_first() {
     return prune_size;
 }
 
+PartitionRowBatch* ResultNode::first_memory_partition() const {
+    for (auto* partition : _partition_list) {
+        if (!partition->is_spilled()) {
+            return partition;
+        }
+    }
+    return nullptr;
+}
+
+Status ResultNode::spill_partition(PartitionRowBatch* partition, const std::string& path) {
+    size_t data_size = partition->get_data_size();
+    RETURN_IF_ERROR(partition->spill(path));
+    _data_size -= data_size;
+    _spill_size += partition->get_spill_size();
+    return Status::OK();
+}
+
 void ResultNode::clear() {
     CacheWriteLock write_lock(_node_mtx);
     LOG(INFO) << "clear result node:" << _sql_key;
@@ -310,6 +411,7 @@ void ResultNode::clear() {
         it = _partition_list.erase(it);
     }
     _data_size = 0;
+    _spill_size = 0;
 }
 
 void ResultNode::append(ResultNode* tail) {
@@ -31,6 +31,7 @@
 #include <string>
 
 #include "common/config.h"
+#include "common/status.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "olap/olap_define.h"
 #include "runtime/cache/cache_utils.h"
@@ -50,12 +51,20 @@ class PUpdateCacheRequest;
 class PClearCacheRequest;
 
 /**
-* Cache one partition data, request param must match version and time of cache
+* Cache one partition data, request param must match version and time of cache.
+* The value is kept serialized and LZ4 compressed, and may be spilled to a file when it's
+* pruned from the memory.
 */
 class PartitionRowBatch {
 public:
     PartitionRowBatch(int64 partition_key)
-            : _partition_key(partition_key), _cache_value(nullptr), _data_size(0) {}
+            : _partition_key(partition_key),
+              _has_value(false),
+              _compressed(false),
+              _raw_size(0),
+              _data_size(0),
+              _spill_size(0),
+              _compute_time_ms(0) {}
 
     ~PartitionRowBatch() {}
 
@@ -65,9 +74,26 @@ public:
 
     int64 get_partition_key() const { return _partition_key; }
 
-    PCacheValue* get_value() { return _cache_value; }
+    bool has_value() const { return _has_value; }
 
-    size_t get_data_size() { return _data_size; }
+    const PCacheParam& get_param() const { return _param; }
+
+    // Decompress the value, reading it from the spill file if it has been spilled.
+    Status get_value(PCacheValue* value) const;
+
+    // Write the value to the file `path` and release its memory.
+    Status spill(const std::string& path);
+
+    bool is_spilled() const { return !_spill_path.empty(); }
+
+    // The size of the value in the memory, it's 0 once the value is spilled.
+    size_t get_data_size() const { return _data_size; }
+
+    size_t get_spill_size() const { return _spill_size; }
+
+    // The recomputation time saved per byte by keeping the value in the memory, weighted by
+    // the read count and decayed by the idle time. The value with the least score is pruned.
+    double retain_score(long now) const;
 
     const CacheStat* get_stat() const { return &_cache_stat; }
 
@@ -76,10 +102,10 @@ private:
         if (req_param.partition_key() != _partition_key) {
             return false;
         }
-        if (req_param.last_version() > _cache_value->param().last_version()) {
+        if (req_param.last_version() > _param.last_version()) {
             return false;
         }
-        if (req_param.last_version_time() > _cache_value->param().last_version_time()) {
+        if (req_param.last_version_time() > _param.last_version_time()) {
             return false;
         }
         return true;
@@ -90,19 +116,29 @@ private:
         if (up_param.last_version() == 0 || up_param.last_version_time() == 0) {
             return true;
         }
-        if (up_param.last_version_time() > _cache_value->param().last_version_time()) {
+        if (up_param.last_version_time() > _param.last_version_time()) {
             return true;
         }
-        if (up_param.last_version() > _cache_value->param().last_version()) {
+        if (up_param.last_version() > _param.last_version()) {
             return true;
         }
         return false;
     }
 
+    void remove_spill_file();
+
 private:
     int64 _partition_key;
-    PCacheValue* _cache_value;
+    bool _has_value;
+    PCacheParam _param;
+    // the serialized PCacheValue, compressed if `_compressed`, empty once spilled
+    std::string _data;
+    bool _compressed;
+    size_t _raw_size;
     size_t _data_size;
+    std::string _spill_path;
+    size_t _spill_size;
+    int64 _compute_time_ms;
     CacheStat _cache_stat;
 };
 
@@ -118,10 +154,10 @@ typedef std::unordered_map<PartitionKey, PartitionRowBatch*> PartitionRowBatchMa
 */
 class ResultNode {
 public:
-    ResultNode() : _sql_key(0, 0), _prev(nullptr), _next(nullptr), _data_size(0) {}
+    ResultNode() : _sql_key(0, 0), _prev(nullptr), _next(nullptr), _data_size(0), _spill_size(0) {}
 
     ResultNode(const UniqueId& sql_key)
-            : _sql_key(sql_key), _prev(nullptr), _next(nullptr), _data_size(0) {}
+            : _sql_key(sql_key), _prev(nullptr), _next(nullptr), _data_size(0), _spill_size(0) {}
 
     virtual ~ResultNode() {}
 
@@ -135,6 +171,16 @@ public:
     size_t prune_first();
     void clear();
 
+    // The first partition whose value is in the memory, nullptr if all of them are spilled.
+    PartitionRowBatch* first_memory_partition() const;
+
+    bool first_partition_spilled() const {
+        return !_partition_list.empty() && (*_partition_list.begin())->is_spilled();
+    }
+
+    // Spill `partition` of this node to the file `path`.
+    Status spill_partition(PartitionRowBatch* partition, const std::string& path);
+
     ResultNode* get_prev() { return _prev; }
 
     void set_prev(ResultNode* prev) { _prev = prev; }
@@ -151,6 +197,8 @@ public:
 
     size_t get_data_size() const { return _data_size; }
 
+    size_t get_spill_size() const { return _spill_size; }
+
     UniqueId get_sql_key() { return _sql_key; }
 
     bool sql_key_null() { return _sql_key.hi == 0 && _sql_key.lo == 0; }
@@ -185,6 +233,7 @@ private:
     ResultNode* _prev;
     ResultNode* _next;
     size_t _data_size;
+    size_t _spill_size;
     PartitionRowBatchList _partition_list;
     PartitionRowBatchMap _partition_map;
 };
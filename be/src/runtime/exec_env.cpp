@@ -18,6 +18,8 @@
 #include "runtime/exec_env.h"
 
 #include "gen_cpp/HeartbeatService_types.h"
+#include "runtime/fair_scan_scheduler.h"
+#include "runtime/workload_group.h"
 
 namespace doris {
 
@@ -27,6 +27,7 @@
 namespace doris {
 namespace vectorized {
 class VDataStreamMgr;
+class TaskScheduler;
 }
 class BfdParser;
 class BrokerMgr;
@@ -36,12 +37,14 @@ class BrpcClientCache;
 
 class BufferPool;
 class CgroupsMgr;
+class WorkloadGroupMgr;
 class DataStreamMgr;
 class DiskIoMgr;
 class EtlJobMgr;
 class EvHttpServer;
 class ExternalScanContextMgr;
 class FragmentMgr;
+class GroupCommitMgr;
 class ResultCache;
 class LoadPathMgr;
 class LoadStreamMgr;
@@ -50,6 +53,7 @@ class StorageEngine;
 class MemTrackerTaskPool;
 class PriorityThreadPool;
 class PriorityWorkStealingThreadPool;
+class FairScanScheduler;
 class ReservationTracker;
 class ResultBufferMgr;
 class ResultQueueMgr;
@@ -104,6 +108,9 @@ public:
     ExternalScanContextMgr* external_scan_context_mgr() { return _external_scan_context_mgr; }
     DataStreamMgr* stream_mgr() { return _stream_mgr; }
     doris::vectorized::VDataStreamMgr* vstream_mgr() { return _vstream_mgr; }
+    doris::vectorized::TaskScheduler* pipeline_task_scheduler() {
+        return _pipeline_task_scheduler;
+    }
     ResultBufferMgr* result_mgr() { return _result_mgr; }
     ResultQueueMgr* result_queue_mgr() { return _result_queue_mgr; }
     ClientCache<BackendServiceClient>* client_cache() { return _backend_client_cache; }
@@ -126,10 +133,14 @@ public:
     }
     ThreadResourceMgr* thread_mgr() { return _thread_mgr; }
     PriorityThreadPool* scan_thread_pool() { return _scan_thread_pool; }
+    FairScanScheduler* fair_scan_scheduler() { return _fair_scan_scheduler.get(); }
     ThreadPool* limited_scan_thread_pool() { return _limited_scan_thread_pool.get(); }
     PriorityThreadPool* etl_thread_pool() { return _etl_thread_pool; }
     ThreadPool* send_batch_thread_pool() { return _send_batch_thread_pool.get(); }
+    ThreadPool* tablet_write_thread_pool() { return _tablet_write_thread_pool.get(); }
+    ThreadPool* remote_read_thread_pool() { return _remote_read_thread_pool.get(); }
     CgroupsMgr* cgroups_mgr() { return _cgroups_mgr; }
+    WorkloadGroupMgr* workload_group_mgr() { return _workload_group_mgr.get(); }
     FragmentMgr* fragment_mgr() { return _fragment_mgr; }
     ResultCache* result_cache() { return _result_cache; }
     TMasterInfo* master_info() { return _master_info; }
@@ -157,6 +168,7 @@ public:
     void set_storage_engine(StorageEngine* storage_engine) { _storage_engine = storage_engine; }
 
     StreamLoadExecutor* stream_load_executor() { return _stream_load_executor; }
+    GroupCommitMgr* group_commit_mgr() { return _group_commit_mgr; }
     RoutineLoadTaskExecutor* routine_load_task_executor() { return _routine_load_task_executor; }
     HeartbeatFlags* heartbeat_flags() { return _heartbeat_flags; }
 
@@ -180,6 +192,8 @@ private:
     ExternalScanContextMgr* _external_scan_context_mgr = nullptr;
     DataStreamMgr* _stream_mgr = nullptr;
     doris::vectorized::VDataStreamMgr* _vstream_mgr = nullptr;
+    // runs the tasks of the fragments executed by the pipeline engine
+    doris::vectorized::TaskScheduler* _pipeline_task_scheduler = nullptr;
     ResultBufferMgr* _result_mgr = nullptr;
     ResultQueueMgr* _result_queue_mgr = nullptr;
     ClientCache<BackendServiceClient>* _backend_client_cache = nullptr;
@@ -205,11 +219,17 @@ private:
 
     // TODO(cmy): find a better way to unify these 2 pools.
     PriorityThreadPool* _scan_thread_pool = nullptr;
+    // shares the threads of _scan_thread_pool among the queries
+    std::unique_ptr<FairScanScheduler> _fair_scan_scheduler;
     std::unique_ptr<ThreadPool> _limited_scan_thread_pool;
 
     std::unique_ptr<ThreadPool> _send_batch_thread_pool;
+    std::unique_ptr<ThreadPool> _tablet_write_thread_pool;
+    // the prefetched and hedged reads of the external files
+    std::unique_ptr<ThreadPool> _remote_read_thread_pool;
     PriorityThreadPool* _etl_thread_pool = nullptr;
     CgroupsMgr* _cgroups_mgr = nullptr;
+    std::unique_ptr<WorkloadGroupMgr> _workload_group_mgr;
     FragmentMgr* _fragment_mgr = nullptr;
     ResultCache* _result_cache = nullptr;
     TMasterInfo* _master_info = nullptr;
@@ -231,6 +251,7 @@ private:
     StorageEngine* _storage_engine = nullptr;
 
     StreamLoadExecutor* _stream_load_executor = nullptr;
+    GroupCommitMgr* _group_commit_mgr = nullptr;
     RoutineLoadTaskExecutor* _routine_load_task_executor = nullptr;
     SmallFileMgr* _small_file_mgr = nullptr;
     HeartbeatFlags* _heartbeat_flags = nullptr;
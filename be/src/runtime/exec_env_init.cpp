@@ -23,6 +23,7 @@
 #include "gen_cpp/TExtDataSourceService.h"
 #include "gen_cpp/TPaloBrokerService.h"
 #include "olap/page_cache.h"
+#include "olap/rowset/segment_v2/decoded_column_cache.h"
 #include "olap/segment_loader.h"
 #include "olap/storage_engine.h"
 #include "runtime/broker_mgr.h"
@@ -35,8 +36,10 @@
 #include "runtime/etl_job_mgr.h"
 #include "runtime/exec_env.h"
 #include "runtime/external_scan_context_mgr.h"
+#include "runtime/fair_scan_scheduler.h"
 #include "runtime/fold_constant_executor.h"
 #include "runtime/fragment_mgr.h"
+#include "runtime/group_commit_mgr.h"
 #include "runtime/heartbeat_flags.h"
 #include "runtime/load_channel_mgr.h"
 #include "runtime/load_path_mgr.h"
@@ -50,15 +53,20 @@
 #include "runtime/stream_load/stream_load_executor.h"
 #include "runtime/thread_resource_mgr.h"
 #include "runtime/tmp_file_mgr.h"
+#include "runtime/workload_group.h"
 #include "util/bfd_parser.h"
 #include "util/brpc_client_cache.h"
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
 #include "util/doris_metrics.h"
 #include "util/mem_info.h"
 #include "util/metrics.h"
+#include "util/cpu_info.h"
 #include "util/parse_util.h"
 #include "util/pretty_printer.h"
 #include "util/priority_thread_pool.hpp"
 #include "util/priority_work_stealing_thread_pool.hpp"
+#include "vec/exec/pipeline/task_scheduler.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 
 namespace doris {
@@ -102,15 +110,27 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     if (config::doris_enable_scanner_thread_pool_per_disk &&
         config::doris_scanner_thread_pool_thread_num >= store_paths.size() &&
         store_paths.size() > 0) {
+        // the threads of the queue of a store path run on the NUMA node closest to its disk,
+        // so do the page cache and the blocks filled by them
+        std::vector<int> queue_numa_nodes;
+        if (config::enable_numa_aware_scanner && CpuInfo::get_max_num_numa_nodes() > 1) {
+            for (auto& store_path : store_paths) {
+                int disk_id = DiskInfo::disk_id(store_path.path.c_str());
+                queue_numa_nodes.push_back(disk_id < 0 ? -1 : DiskInfo::numa_node(disk_id));
+                LOG(INFO) << "scan threads of " << store_path.path << " run on NUMA node "
+                          << queue_numa_nodes.back();
+            }
+        }
         _scan_thread_pool = new PriorityWorkStealingThreadPool(
                 config::doris_scanner_thread_pool_thread_num, store_paths.size(),
-                config::doris_scanner_thread_pool_queue_size);
+                config::doris_scanner_thread_pool_queue_size, std::move(queue_numa_nodes));
         LOG(INFO) << "scan thread pool use PriorityWorkStealingThreadPool";
     } else {
         _scan_thread_pool = new PriorityThreadPool(config::doris_scanner_thread_pool_thread_num,
                                                    config::doris_scanner_thread_pool_queue_size);
         LOG(INFO) << "scan thread pool use PriorityThreadPool";
     }
+    _fair_scan_scheduler.reset(new FairScanScheduler(_scan_thread_pool));
 
     ThreadPoolBuilder("LimitedScanThreadPool")
             .set_min_threads(1)
@@ -124,12 +144,26 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
             .set_max_queue_size(config::send_batch_thread_pool_queue_size)
             .build(&_send_batch_thread_pool);
 
+    ThreadPoolBuilder("TabletWriteThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(config::tablet_writer_write_thread_num)
+            .build(&_tablet_write_thread_pool);
+
+    ThreadPoolBuilder("RemoteReadThreadPool")
+            .set_min_threads(1)
+            .set_max_threads(config::remote_read_thread_pool_thread_num)
+            .build(&_remote_read_thread_pool);
+
     _etl_thread_pool = new PriorityThreadPool(config::etl_thread_pool_size,
                                               config::etl_thread_pool_queue_size);
     _cgroups_mgr = new CgroupsMgr(this, config::doris_cgroups);
     _fragment_mgr = new FragmentMgr(this);
-    _result_cache = new ResultCache(config::query_cache_max_size_mb,
-                                    config::query_cache_elasticity_size_mb);
+    _pipeline_task_scheduler = new doris::vectorized::TaskScheduler(
+            config::pipeline_executor_size > 0 ? config::pipeline_executor_size
+                                               : CpuInfo::num_cores());
+    _result_cache = new ResultCache(
+            config::query_cache_max_size_mb, config::query_cache_elasticity_size_mb,
+            config::query_cache_spill_path, config::query_cache_spill_max_size_mb);
     _master_info = new TMasterInfo();
     _etl_job_mgr = new EtlJobMgr(this);
     _load_path_mgr = new LoadPathMgr(this);
@@ -142,6 +176,7 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     _internal_client_cache = new BrpcClientCache<PBackendService_Stub>();
     _function_client_cache = new BrpcClientCache<PFunctionService_Stub>();
     _stream_load_executor = new StreamLoadExecutor(this);
+    _group_commit_mgr = new GroupCommitMgr(this);
     _routine_load_task_executor = new RoutineLoadTaskExecutor(this);
     _small_file_mgr = new SmallFileMgr(this, config::small_file_dir);
 
@@ -159,9 +194,13 @@ Status ExecEnv::_init(const std::vector<StorePath>& store_paths) {
     }
     _broker_mgr->init();
     _small_file_mgr->init();
+    RETURN_IF_ERROR(_pipeline_task_scheduler->start());
     _init_mem_tracker();
+    _workload_group_mgr.reset(new WorkloadGroupMgr());
+    RETURN_IF_ERROR(_workload_group_mgr->init(_query_pool_mem_tracker, _cgroups_mgr));
 
     RETURN_IF_ERROR(_load_channel_mgr->init(MemTracker::get_process_tracker()->limit()));
+    RETURN_IF_ERROR(_group_commit_mgr->init());
     _heartbeat_flags = new HeartbeatFlags();
     _register_metrics();
     _is_init = true;
@@ -255,12 +294,34 @@ Status ExecEnv::_init_mem_tracker() {
         storage_cache_limit = storage_cache_limit / 2;
     }
     int32_t index_page_cache_percentage = config::index_page_cache_percentage;
-    StoragePageCache::create_global_cache(storage_cache_limit, index_page_cache_percentage);
+    StoragePageCache::create_global_cache(storage_cache_limit, index_page_cache_percentage,
+                                          config::decoded_page_cache_percentage);
     LOG(INFO) << "Storage page cache memory limit: "
               << PrettyPrinter::print(storage_cache_limit, TUnit::BYTES)
               << ", origin config value: " << config::storage_page_cache_limit;
 
-    SegmentLoader::create_global_instance(config::segment_cache_capacity);
+    int64_t segment_cache_memory_limit =
+            ParseUtil::parse_mem_spec(config::segment_cache_memory_limit,
+                                      global_memory_limit_bytes, MemInfo::physical_mem(),
+                                      &is_percent);
+    if (segment_cache_memory_limit > 0) {
+        SegmentLoader::create_global_instance(segment_cache_memory_limit, LRUCacheType::SIZE);
+        LOG(INFO) << "Segment cache memory limit: "
+                  << PrettyPrinter::print(segment_cache_memory_limit, TUnit::BYTES)
+                  << ", origin config value: " << config::segment_cache_memory_limit;
+    } else {
+        SegmentLoader::create_global_instance(config::segment_cache_capacity);
+    }
+
+    if (config::enable_decoded_column_cache) {
+        int64_t decoded_column_cache_limit = ParseUtil::parse_mem_spec(
+                config::decoded_column_cache_limit, global_memory_limit_bytes,
+                MemInfo::physical_mem(), &is_percent);
+        segment_v2::DecodedColumnCache::create_global_cache(decoded_column_cache_limit);
+        LOG(INFO) << "Decoded column cache memory limit: "
+                  << PrettyPrinter::print(decoded_column_cache_limit, TUnit::BYTES)
+                  << ", origin config value: " << config::decoded_column_cache_limit;
+    }
 
     // 4. init other managers
     RETURN_IF_ERROR(_disk_io_mgr->init(global_memory_limit_bytes));
@@ -306,6 +367,8 @@ void ExecEnv::_destroy() {
         return;
     }
     _deregister_metrics();
+    // the batches are flushed by the stream load executor
+    SAFE_DELETE(_group_commit_mgr);
     SAFE_DELETE(_internal_client_cache);
     SAFE_DELETE(_function_client_cache);
     SAFE_DELETE(_load_stream_mgr);
@@ -318,9 +381,16 @@ void ExecEnv::_destroy() {
     SAFE_DELETE(_etl_job_mgr);
     SAFE_DELETE(_master_info);
     SAFE_DELETE(_fragment_mgr);
+    if (_pipeline_task_scheduler != nullptr) {
+        _pipeline_task_scheduler->shutdown();
+    }
+    SAFE_DELETE(_pipeline_task_scheduler);
+    _workload_group_mgr.reset();
     SAFE_DELETE(_cgroups_mgr);
     SAFE_DELETE(_etl_thread_pool);
     SAFE_DELETE(_scan_thread_pool);
+    // after the threads of the scan thread pool which run its tasks are joined
+    _fair_scan_scheduler.reset();
     SAFE_DELETE(_thread_mgr);
     SAFE_DELETE(_broker_client_cache);
     SAFE_DELETE(_extdatasource_client_cache);
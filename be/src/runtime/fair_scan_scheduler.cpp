@@ -0,0 +1,96 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/fair_scan_scheduler.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "common/logging.h"
+#include "util/time.h"
+
+namespace doris {
+
+bool FairScanScheduler::offer(const TUniqueId& query_id, int weight,
+                              PriorityThreadPool::Task task) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _queues.find(query_id);
+        if (it == _queues.end()) {
+            int64_t min_vruntime = 0;
+            if (!_queues.empty()) {
+                min_vruntime = std::numeric_limits<int64_t>::max();
+                for (auto& [id, queue] : _queues) {
+                    min_vruntime = std::min(min_vruntime, queue.vruntime);
+                }
+            }
+            it = _queues.emplace(query_id, QueryQueue()).first;
+            it->second.vruntime = min_vruntime;
+        }
+        it->second.weight = std::max(weight, 1);
+        it->second.tasks.push_back({std::move(task.work_function), task.queue_id});
+    }
+    // every task offered to the thread pool runs one queued task, not necessarily this one
+    task.work_function = [this, queue_id = task.queue_id]() { _run_next(queue_id); };
+    return _thread_pool->offer(std::move(task));
+}
+
+void FairScanScheduler::_run_next(int queue_id) {
+    PendingTask task;
+    TUniqueId query_id;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto next = _queues.end();
+        for (auto it = _queues.begin(); it != _queues.end(); ++it) {
+            if (!it->second.tasks.empty() &&
+                (next == _queues.end() || it->second.vruntime < next->second.vruntime)) {
+                next = it;
+            }
+        }
+        if (next == _queues.end()) {
+            return;
+        }
+        query_id = next->first;
+        // prefer the task of the same queue of the thread pool, e.g. reading the same disk
+        auto& tasks = next->second.tasks;
+        auto pos = std::find_if(tasks.begin(), tasks.end(), [queue_id](const PendingTask& t) {
+            return t.queue_id == queue_id;
+        });
+        if (pos == tasks.end()) {
+            pos = tasks.begin();
+        }
+        task = std::move(*pos);
+        tasks.erase(pos);
+        ++next->second.running;
+    }
+
+    int64_t start = MonotonicNanos();
+    task.work_function();
+    int64_t elapsed = MonotonicNanos() - start;
+
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _queues.find(query_id);
+    DCHECK(it != _queues.end());
+    auto& queue = it->second;
+    queue.vruntime += elapsed / queue.weight;
+    if (--queue.running == 0 && queue.tasks.empty()) {
+        _queues.erase(it);
+    }
+}
+
+} // namespace doris
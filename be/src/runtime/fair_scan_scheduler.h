@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+#include "util/priority_thread_pool.hpp"
+
+namespace doris {
+
+// Share the threads of the scan thread pool among the queries by weighted fair queueing,
+// so a query with many scanners can't take over all the threads and starve the small queries.
+//
+// The scan tasks are queued by their queries, and each task offered to the thread pool only
+// runs the next task of the query which consumed the least scan time divided by its weight.
+// A scan task runs for one time slice and re-offers itself to continue, so the queries take
+// turns at the granularity of the slices. A query joining the scheduler starts with the least
+// consumed time of the queued queries, to neither starve nor monopolize the threads.
+class FairScanScheduler {
+public:
+    explicit FairScanScheduler(PriorityThreadPool* thread_pool) : _thread_pool(thread_pool) {}
+
+    // Queue the task of the query, the query gets a share of the threads proportional to
+    // `weight`. The priority and the queue id of the task are kept for the thread pool.
+    // Returns false if the thread pool has been shut down.
+    bool offer(const TUniqueId& query_id, int weight, PriorityThreadPool::Task task);
+
+private:
+    struct PendingTask {
+        PriorityThreadPool::WorkFunction work_function;
+        int queue_id = 0;
+    };
+
+    struct QueryQueue {
+        int weight = 1;
+        // the consumed scan time in nanoseconds divided by the weight
+        int64_t vruntime = 0;
+        int running = 0;
+        std::deque<PendingTask> tasks;
+    };
+
+    // Run the next task of the least served query, called by the threads of the thread pool.
+    // The task of the query in the queue `queue_id` of the thread pool is preferred.
+    void _run_next(int queue_id);
+
+    PriorityThreadPool* _thread_pool;
+
+    std::mutex _lock;
+    // the queries having queued or running tasks
+    std::unordered_map<TUniqueId, QueryQueue> _queues;
+};
+
+} // namespace doris
@@ -22,6 +22,7 @@
 
 #include <memory>
 #include <sstream>
+#include <unordered_set>
 
 #include "agent/cgroups_mgr.h"
 #include "common/object_pool.h"
@@ -39,24 +40,31 @@
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
 #include "runtime/plan_fragment_executor.h"
+#include "runtime/query_mem_arbitrator.h"
 #include "runtime/runtime_filter_mgr.h"
 #include "runtime/stream_load/load_stream_mgr.h"
 #include "runtime/stream_load/stream_load_context.h"
 #include "runtime/stream_load/stream_load_pipe.h"
 #include "runtime/thread_context.h"
+#include "runtime/workload_group.h"
 #include "service/backend_options.h"
 #include "util/debug_util.h"
 #include "util/doris_metrics.h"
+#include "util/mem_info.h"
 #include "util/stopwatch.hpp"
 #include "util/threadpool.h"
 #include "util/thrift_util.h"
 #include "util/uid_util.h"
 #include "util/url_coding.h"
+#include "vec/runtime/vspill_stream.h"
 
 namespace doris {
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(plan_fragment_count, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(timeout_canceled_fragment_count, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(query_queue_length, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(query_queue_wait_time_ms, MetricUnit::MILLISECONDS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(query_queue_timeout_count, MetricUnit::NOUNIT);
 
 std::string to_load_error_http_path(const std::string& file_name) {
     if (file_name.empty()) {
@@ -83,6 +91,12 @@ public:
     FragmentExecState(const TUniqueId& query_id, const TUniqueId& instance_id, int backend_num,
                       ExecEnv* exec_env, const TNetworkAddress& coord_addr);
 
+    ~FragmentExecState() {
+        if (_workload_group != nullptr) {
+            _workload_group->remove_fragment(_query_id);
+        }
+    }
+
     Status prepare(const TExecPlanFragmentParams& params);
 
     // just no use now
@@ -137,6 +151,22 @@ public:
 
     std::shared_ptr<QueryFragmentsCtx> get_fragments_ctx() { return _fragments_ctx; }
 
+    // Report the failure of the fragment which never runs to the coordinator.
+    void report_final_status(const Status& status) {
+        coordinator_callback(status, _executor.profile(), true);
+    }
+
+    // the fragment is admitted by the admission queue of FragmentMgr
+    void set_admitted() { _admitted = true; }
+    bool is_admitted() const { return _admitted; }
+
+    // Admit this fragment to the workload group, it leaves the group when it's destroyed.
+    Status set_workload_group(std::shared_ptr<WorkloadGroup> group) {
+        RETURN_IF_ERROR(group->add_fragment(_query_id));
+        _workload_group = std::move(group);
+        return Status::OK();
+    }
+
     void set_pipe(std::shared_ptr<StreamLoadPipe> pipe) { _pipe = pipe; }
     std::shared_ptr<StreamLoadPipe> get_pipe() const { return _pipe; }
 
@@ -171,6 +201,10 @@ private:
     std::shared_ptr<RuntimeFilterMergeControllerEntity> _merge_controller_handler;
     // The pipe for data transfering, such as insert.
     std::shared_ptr<StreamLoadPipe> _pipe;
+
+    std::shared_ptr<WorkloadGroup> _workload_group;
+
+    bool _admitted = false;
 };
 
 FragmentExecState::FragmentExecState(const TUniqueId& query_id,
@@ -228,7 +262,7 @@ Status FragmentExecState::execute() {
     int64_t duration_ns = 0;
     {
         SCOPED_RAW_TIMER(&duration_ns);
-        CgroupsMgr::apply_system_cgroup();
+        WorkloadGroup::bind_thread_cgroup(_workload_group.get());
         WARN_IF_ERROR(_executor.open(), strings::Substitute("Got error while opening fragment $0",
                                                             print_id(_fragment_instance_id)));
         _executor.close();
@@ -417,35 +451,50 @@ FragmentMgr::FragmentMgr(ExecEnv* exec_env)
         : _exec_env(exec_env),
           _fragment_map(),
           _fragments_ctx_map(),
-          _stop_background_threads_latch(1) {
+          _stop_background_threads_latch(1),
+          _query_replayer(exec_env) {
     _entity = DorisMetrics::instance()->metric_registry()->register_entity("FragmentMgr");
     INT_UGAUGE_METRIC_REGISTER(_entity, timeout_canceled_fragment_count);
+    INT_COUNTER_METRIC_REGISTER(_entity, query_queue_wait_time_ms);
+    INT_COUNTER_METRIC_REGISTER(_entity, query_queue_timeout_count);
     REGISTER_HOOK_METRIC(plan_fragment_count, [this]() {
         std::lock_guard<std::mutex> lock(_lock);
         return _fragment_map.size();
     });
+    REGISTER_HOOK_METRIC(query_queue_length,
+                         [this]() { return _admission_queue.num_waiting_queries(); });
 
     auto s = Thread::create(
             "FragmentMgr", "cancel_timeout_plan_fragment", [this]() { this->cancel_worker(); },
             &_cancel_thread);
     CHECK(s.ok()) << s.to_string();
 
+    s = Thread::create(
+            "FragmentMgr", "arbitrate_query_mem", [this]() { this->mem_arbitrate_worker(); },
+            &_mem_arbitrate_thread);
+    CHECK(s.ok()) << s.to_string();
+
     // TODO(zc): we need a better thread-pool
     // now one user can use all the thread pool, others have no resource.
     s = ThreadPoolBuilder("FragmentMgrThreadPool")
                 .set_min_threads(config::fragment_pool_thread_num_min)
                 .set_max_threads(config::fragment_pool_thread_num_max)
                 .set_max_queue_size(config::fragment_pool_queue_size)
+                .set_work_stealing(config::enable_work_stealing_thread_pool)
                 .build(&_thread_pool);
     CHECK(s.ok()) << s.to_string();
 }
 
 FragmentMgr::~FragmentMgr() {
     DEREGISTER_HOOK_METRIC(plan_fragment_count);
+    DEREGISTER_HOOK_METRIC(query_queue_length);
     _stop_background_threads_latch.count_down();
     if (_cancel_thread) {
         _cancel_thread->join();
     }
+    if (_mem_arbitrate_thread) {
+        _mem_arbitrate_thread->join();
+    }
     // Stop all the worker, should wait for a while?
     // _thread_pool->wait_for();
     _thread_pool->shutdown();
@@ -471,6 +520,9 @@ void FragmentMgr::_exec_actual(std::shared_ptr<FragmentExecState> exec_state, Fi
                               exec_state->executor()->runtime_state()->instance_mem_tracker());
 #endif
     exec_state->execute();
+    if (exec_state->is_admitted()) {
+        _admission_queue.release(exec_state->query_id());
+    }
 
     std::shared_ptr<QueryFragmentsCtx> fragments_ctx = exec_state->get_fragments_ctx();
     bool all_done = false;
@@ -560,6 +612,7 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
             return Status::OK();
         }
     }
+    _query_replayer.capture(params);
 
     std::shared_ptr<FragmentExecState> exec_state;
     if (!params.__isset.is_simplified_param) {
@@ -623,6 +676,19 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
                                                params.backend_num, _exec_env, fragments_ctx));
     }
 
+    if (params.__isset.query_options && params.query_options.__isset.workload_group) {
+        auto group_mgr = _exec_env->workload_group_mgr();
+        auto group = group_mgr == nullptr
+                             ? nullptr
+                             : group_mgr->get_group(params.query_options.workload_group);
+        if (group == nullptr) {
+            return Status::InvalidArgument(strings::Substitute(
+                    "unknown workload group $0, BE: $1", params.query_options.workload_group,
+                    BackendOptions::get_localhost()));
+        }
+        RETURN_IF_ERROR(exec_state->set_workload_group(std::move(group)));
+    }
+
     std::shared_ptr<RuntimeFilterMergeControllerEntity> handler;
     _runtimefilter_controller.add_entity(params, &handler);
     exec_state->set_merge_controller_handler(handler);
@@ -634,13 +700,40 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
         _cv.notify_all();
     }
 
+    // only the select queries wait in the admission queue, the loads run at once
+    if (params.__isset.query_options && params.query_options.query_type == TQueryType::SELECT) {
+        const TQueryOptions& options = params.query_options;
+        int64_t mem_reservation = options.__isset.mem_limit ? options.mem_limit : 0;
+        int priority = options.__isset.query_priority ? options.query_priority : 0;
+        bool admitted = _admission_queue.admit(
+                exec_state->query_id(), mem_reservation, priority,
+                config::query_queue_timeout_ms,
+                [this, exec_state, cb](const Status& status, int64_t wait_ms) {
+                    _on_fragment_admitted(exec_state, cb, status, wait_ms);
+                });
+        if (!admitted) {
+            VLOG_NOTICE << "fragment " << print_id(params.params.fragment_instance_id)
+                        << " waits in the admission queue";
+            return Status::OK();
+        }
+        exec_state->set_admitted();
+    }
+
+    return _submit_fragment(exec_state, cb);
+}
+
+Status FragmentMgr::_submit_fragment(std::shared_ptr<FragmentExecState> exec_state,
+                                     FinishCallback cb) {
     auto st = _thread_pool->submit_func(
             std::bind<void>(&FragmentMgr::_exec_actual, this, exec_state, cb));
     if (!st.ok()) {
         {
             // Remove the exec state added
             std::lock_guard<std::mutex> lock(_lock);
-            _fragment_map.erase(params.params.fragment_instance_id);
+            _fragment_map.erase(exec_state->fragment_instance_id());
+        }
+        if (exec_state->is_admitted()) {
+            _admission_queue.release(exec_state->query_id());
         }
         exec_state->cancel_before_execute();
         return Status::InternalError(
@@ -651,6 +744,30 @@ Status FragmentMgr::exec_plan_fragment(const TExecPlanFragmentParams& params, Fi
     return Status::OK();
 }
 
+void FragmentMgr::_on_fragment_admitted(std::shared_ptr<FragmentExecState> exec_state,
+                                        FinishCallback cb, const Status& status,
+                                        int64_t wait_ms) {
+    query_queue_wait_time_ms->increment(wait_ms);
+    if (status.ok()) {
+        exec_state->set_admitted();
+        Status st = _submit_fragment(exec_state, cb);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to run the admitted fragment "
+                         << print_id(exec_state->fragment_instance_id()) << ": "
+                         << st.to_string();
+        }
+        return;
+    }
+    query_queue_timeout_count->increment(1);
+    {
+        std::lock_guard<std::mutex> lock(_lock);
+        _fragment_map.erase(exec_state->fragment_instance_id());
+    }
+    exec_state->cancel_before_execute();
+    // the fragment never runs, so report its failure to the coordinator here
+    exec_state->report_final_status(status);
+}
+
 Status FragmentMgr::cancel(const TUniqueId& fragment_id, const PPlanFragmentCancelReason& reason,
                            const std::string& msg) {
     std::shared_ptr<FragmentExecState> exec_state;
@@ -689,6 +806,7 @@ void FragmentMgr::cancel_worker() {
             }
         }
         timeout_canceled_fragment_count->increment(to_cancel.size());
+        _admission_queue.check_timeout();
         for (auto& id : to_cancel) {
             cancel(id, PPlanFragmentCancelReason::TIMEOUT);
             LOG(INFO) << "FragmentMgr cancel worker going to cancel timeout fragment "
@@ -698,6 +816,70 @@ void FragmentMgr::cancel_worker() {
     LOG(INFO) << "FragmentMgr cancel worker is going to exit.";
 }
 
+void FragmentMgr::mem_arbitrate_worker() {
+    QueryMemArbitrator arbitrator;
+    do {
+        if (config::query_mem_arbitrate_interval_ms <= 0 || !MemInfo::initialized()) {
+            continue;
+        }
+        std::vector<std::shared_ptr<FragmentExecState>> exec_states;
+        std::unordered_map<TUniqueId, QueryMemUsage> usages;
+        {
+            std::lock_guard<std::mutex> lock(_lock);
+            for (auto& it : _fragment_map) {
+                RuntimeState* state = it.second->executor()->runtime_state();
+                if (state == nullptr || state->query_mem_tracker() == nullptr) {
+                    continue;
+                }
+                exec_states.push_back(it.second);
+                // all the fragments of a query share the query mem tracker
+                auto& usage = usages[state->query_id()];
+                usage.query_id = state->query_id();
+                usage.mem_bytes = state->query_mem_tracker()->consumption();
+                usage.can_spill |= state->enable_vectorized_exec() &&
+                                   vectorized::BlockSpillStream::can_spill(state);
+            }
+        }
+
+        std::vector<QueryMemUsage> queries;
+        for (auto& [query_id, usage] : usages) {
+            queries.push_back(usage);
+        }
+        std::vector<TUniqueId> to_spill;
+        std::vector<TUniqueId> to_cancel;
+        arbitrator.arbitrate(MemInfo::current_mem(), MemInfo::mem_limit(), std::move(queries),
+                             &to_spill, &to_cancel);
+
+        std::unordered_set<TUniqueId> spill_queries(to_spill.begin(), to_spill.end());
+        for (auto& exec_state : exec_states) {
+            RuntimeState* state = exec_state->executor()->runtime_state();
+            bool spill = spill_queries.count(state->query_id()) > 0;
+            if (spill && !state->is_spill_requested()) {
+                LOG(INFO) << "ask fragment " << print_id(exec_state->fragment_instance_id())
+                          << " to spill, process memory " << MemInfo::current_mem()
+                          << ", query memory " << usages[state->query_id()].mem_bytes;
+            }
+            state->set_spill_requested(spill);
+        }
+        for (auto& query_id : to_cancel) {
+            std::string msg = strings::Substitute(
+                    "cancel the query as the process memory $0 exceeds $1% of the limit $2, "
+                    "the query holds $3",
+                    MemInfo::current_mem(), config::query_cancel_process_mem_percent,
+                    MemInfo::mem_limit(), usages[query_id].mem_bytes);
+            LOG(WARNING) << msg << ", query_id=" << print_id(query_id);
+            for (auto& exec_state : exec_states) {
+                if (exec_state->query_id() == query_id) {
+                    cancel(exec_state->fragment_instance_id(),
+                           PPlanFragmentCancelReason::MEMORY_LIMIT_EXCEED, msg);
+                }
+            }
+        }
+    } while (!_stop_background_threads_latch.wait_for(std::chrono::milliseconds(
+            config::query_mem_arbitrate_interval_ms > 0 ? config::query_mem_arbitrate_interval_ms
+                                                        : 1000)));
+}
+
 void FragmentMgr::debug(std::stringstream& ss) {
     // Keep things simple
     std::lock_guard<std::mutex> lock(_lock);
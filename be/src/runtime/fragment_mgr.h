@@ -31,6 +31,8 @@
 #include "gen_cpp/internal_service.pb.h"
 #include "gutil/ref_counted.h"
 #include "http/rest_monitor_iface.h"
+#include "runtime/query_admission_queue.h"
+#include "runtime/query_replayer.h"
 #include "runtime_filter_mgr.h"
 #include "util/countdown_latch.h"
 #include "util/hash_util.hpp"
@@ -75,6 +77,10 @@ public:
 
     void cancel_worker();
 
+    // Arbitrate the memory among the queries by QueryMemArbitrator when the process memory is
+    // under pressure, i.e. ask the queries to spill, or cancel them as the last resort.
+    void mem_arbitrate_worker();
+
     virtual void debug(std::stringstream& ss);
 
     // input: TScanOpenParams fragment_instance_id
@@ -92,9 +98,18 @@ public:
 
     std::shared_ptr<StreamLoadPipe> get_pipe(const TUniqueId& fragment_instance_id);
 
+    QueryReplayer* query_replayer() { return &_query_replayer; }
+
 private:
     void _exec_actual(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb);
 
+    // submit the fragment admitted by the admission queue to the thread pool
+    Status _submit_fragment(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb);
+
+    // the fragment waiting in the admission queue is admitted, or timed out
+    void _on_fragment_admitted(std::shared_ptr<FragmentExecState> exec_state, FinishCallback cb,
+                               const Status& status, int64_t wait_ms);
+
     // This is input params
     ExecEnv* _exec_env;
 
@@ -109,13 +124,21 @@ private:
 
     CountDownLatch _stop_background_threads_latch;
     scoped_refptr<Thread> _cancel_thread;
+    scoped_refptr<Thread> _mem_arbitrate_thread;
     // every job is a pool
     std::unique_ptr<ThreadPool> _thread_pool;
 
+    // the queue of the fragments of the select queries waiting to run
+    QueryAdmissionQueue _admission_queue;
+
     std::shared_ptr<MetricEntity> _entity = nullptr;
     UIntGauge* timeout_canceled_fragment_count = nullptr;
+    IntCounter* query_queue_wait_time_ms = nullptr;
+    IntCounter* query_queue_timeout_count = nullptr;
 
     RuntimeFilterMergeController _runtimefilter_controller;
+
+    QueryReplayer _query_replayer;
 };
 
 } // namespace doris
@@ -0,0 +1,551 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/group_commit_mgr.h"
+
+#include <algorithm>
+#include <set>
+
+#include "common/config.h"
+#include "common/utils.h"
+#include "env/env.h"
+#include "env/env_util.h"
+#include "gen_cpp/FrontendService.h"
+#include "runtime/exec_env.h"
+#include "runtime/message_body_sink.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_context.h"
+#include "runtime/stream_load/stream_load_executor.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "util/file_utils.h"
+#include "util/thrift_rpc_helper.h"
+#include "util/thrift_util.h"
+#include "util/time.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+#ifdef BE_TEST
+extern TStreamLoadPutResult k_stream_load_put_result;
+#endif
+
+static const std::string GROUP_COMMIT_LABEL_PREFIX = "group_commit_";
+static const std::string META_FILE = "meta";
+static const std::string TMP_SUFFIX = ".tmp";
+
+struct GroupCommitMgr::Batch {
+    ~Batch() {
+        if (ctx != nullptr && ctx->unref()) {
+            delete ctx;
+        }
+    }
+
+    // the key of the table and params, empty if the batch is replayed
+    std::string key;
+    std::string dir;
+    // the put request built from the headers of the loads
+    TStreamLoadPutRequest request;
+    // the context of the internal load of the batch, in the transaction of the batch
+    StreamLoadContext* ctx = nullptr;
+    int64_t create_time_ms = 0;
+    // the bytes of the joined loads
+    int64_t bytes = 0;
+    // the number of the joined loads whose wal is not committed or aborted yet
+    int pending_loads = 0;
+    // no load can join a closed batch, it's flushed once it has no pending load
+    bool closed = false;
+    // the wals of the acknowledged loads
+    std::vector<std::string> wal_files;
+    // the time to load the failed batch again
+    int64_t retry_time_ms = 0;
+};
+
+GroupCommitMgr::GroupCommitMgr(ExecEnv* exec_env)
+        : _exec_env(exec_env), _stop_background_threads_latch(1) {}
+
+GroupCommitMgr::~GroupCommitMgr() {
+    _stop_background_threads_latch.count_down();
+    if (_background_thread) {
+        _background_thread->join();
+    }
+    if (_flush_pool) {
+        _flush_pool->shutdown();
+    }
+}
+
+Status GroupCommitMgr::init() {
+    _wal_path = config::group_commit_wal_path;
+    RETURN_IF_ERROR(FileUtils::create_dir(_wal_path));
+    RETURN_IF_ERROR(ThreadPoolBuilder("GroupCommitFlushThreadPool")
+                            .set_min_threads(1)
+                            .set_max_threads(config::group_commit_flush_threads)
+                            .build(&_flush_pool));
+    return Thread::create(
+            "GroupCommitMgr", "group_commit_background",
+            [this]() {
+                _replay_wals();
+                while (!_stop_background_threads_latch.wait_for(std::chrono::milliseconds(100))) {
+                    _close_expired_batches();
+                    _retry_failed_batches();
+                }
+            },
+            &_background_thread);
+}
+
+Status GroupCommitMgr::join(StreamLoadContext* ctx, const TStreamLoadPutRequest& request) {
+    // the request has the auth, the table and all the params of the load
+    std::string key = apache::thrift::ThriftDebugString(request);
+    std::shared_ptr<Batch> batch;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _open_batches.find(key);
+        if (it != _open_batches.end()) {
+            batch = it->second;
+            ++batch->pending_loads;
+            batch->bytes += ctx->body_bytes;
+            if (batch->bytes >= config::group_commit_data_bytes) {
+                _close_batch(batch);
+            }
+        }
+    }
+    if (batch == nullptr) {
+        RETURN_IF_ERROR(_create_batch(key, ctx, request, &batch));
+        std::lock_guard<std::mutex> l(_lock);
+        ++batch->pending_loads;
+        batch->bytes += ctx->body_bytes;
+        _batches[batch->ctx->label] = batch;
+        if (batch->bytes >= config::group_commit_data_bytes || _open_batches.count(key) > 0) {
+            // only this load is in the batch if another load has opened a batch of the key
+            batch->closed = true;
+        } else {
+            _open_batches[key] = batch;
+        }
+    }
+
+    ctx->group_commit_label = batch->ctx->label;
+    ctx->txn_id = batch->ctx->txn_id;
+    ctx->group_commit_wal = batch->dir + "/" + ctx->id.to_string();
+    auto file_sink =
+            std::make_shared<MessageBodyFileSink>(ctx->group_commit_wal + TMP_SUFFIX, true);
+    Status st = file_sink->open();
+    if (!st.ok()) {
+        abort(ctx);
+        return st;
+    }
+    ctx->body_sink = file_sink;
+    return Status::OK();
+}
+
+Status GroupCommitMgr::commit_wal(StreamLoadContext* ctx) {
+    if (ctx->group_commit_wal.empty()) {
+        return Status::InternalError("the load is not in a group commit batch");
+    }
+    const std::string& wal = ctx->group_commit_wal;
+    Status st = Env::Default()->rename_file(wal + TMP_SUFFIX, wal);
+    if (st.ok()) {
+        st = Env::Default()->sync_dir(wal.substr(0, wal.rfind('/')));
+    }
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to commit the wal " << wal << ", err=" << st.get_error_msg();
+        abort(ctx);
+        return st;
+    }
+
+    std::lock_guard<std::mutex> l(_lock);
+    auto& batch = _batches[ctx->group_commit_label];
+    DCHECK(batch != nullptr);
+    batch->wal_files.push_back(wal);
+    ctx->group_commit_wal.clear();
+    _release_load(batch);
+    return Status::OK();
+}
+
+void GroupCommitMgr::abort(StreamLoadContext* ctx) {
+    if (ctx->group_commit_wal.empty()) {
+        return;
+    }
+    FileUtils::remove(ctx->group_commit_wal + TMP_SUFFIX);
+    FileUtils::remove(ctx->group_commit_wal);
+
+    std::lock_guard<std::mutex> l(_lock);
+    auto& batch = _batches[ctx->group_commit_label];
+    DCHECK(batch != nullptr);
+    ctx->group_commit_wal.clear();
+    _release_load(batch);
+}
+
+Status GroupCommitMgr::_create_batch(const std::string& key, const StreamLoadContext* load_ctx,
+                                     const TStreamLoadPutRequest& request,
+                                     std::shared_ptr<Batch>* batch) {
+    auto new_batch = std::make_shared<Batch>();
+    new_batch->key = key;
+    new_batch->request = request;
+    new_batch->create_time_ms = MonotonicMillis();
+
+    StreamLoadContext* ctx = new StreamLoadContext(_exec_env);
+    ctx->ref();
+    new_batch->ctx = ctx;
+    ctx->load_type = TLoadType::MANUL_LOAD;
+    ctx->load_src_type = TLoadSourceType::RAW;
+    ctx->db = load_ctx->db;
+    ctx->table = load_ctx->table;
+    ctx->auth = load_ctx->auth;
+    ctx->label = GROUP_COMMIT_LABEL_PREFIX + generate_uuid_string();
+    ctx->timeout_second = load_ctx->timeout_second;
+    ctx->max_filter_ratio = load_ctx->max_filter_ratio;
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->begin_txn(ctx));
+
+    new_batch->dir = _wal_path + "/" + ctx->label;
+    Status st = FileUtils::create_dir(new_batch->dir);
+    if (st.ok()) {
+        st = _write_meta(*new_batch);
+    }
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to create the wal dir of group commit batch " << ctx->label
+                     << ", err=" << st.get_error_msg();
+        ctx->status = st;
+        _exec_env->stream_load_executor()->rollback_txn(ctx);
+        FileUtils::remove_all(new_batch->dir);
+        return st;
+    }
+    *batch = std::move(new_batch);
+    return Status::OK();
+}
+
+Status GroupCommitMgr::_write_meta(const Batch& batch) {
+    // The user and the password are not persisted, the replayed batches are loaded by an auth code
+    // like the routine loads.
+    TStreamLoadPutRequest meta = batch.request;
+    meta.user = "";
+    meta.passwd = "";
+    meta.__isset.auth_code_uuid = false;
+    meta.auth_code_uuid = "";
+    meta.txnId = batch.ctx->txn_id;
+
+    ThriftSerializer serializer(false, 1024);
+    std::string data;
+    RETURN_IF_ERROR(serializer.serialize(&meta, &data));
+    std::string path = batch.dir + "/" + META_FILE;
+    RETURN_IF_ERROR(env_util::write_string_to_file_sync(Env::Default(), data, path + TMP_SUFFIX));
+    RETURN_IF_ERROR(Env::Default()->rename_file(path + TMP_SUFFIX, path));
+    RETURN_IF_ERROR(Env::Default()->sync_dir(batch.dir));
+    return Env::Default()->sync_dir(_wal_path);
+}
+
+Status GroupCommitMgr::_read_meta(const std::string& dir, TStreamLoadPutRequest* request) {
+    std::string data;
+    RETURN_IF_ERROR(env_util::read_file_to_string(Env::Default(), dir + "/" + META_FILE, &data));
+    uint32_t len = data.size();
+    return deserialize_thrift_msg(reinterpret_cast<const uint8_t*>(data.data()), &len, false,
+                                  request);
+}
+
+void GroupCommitMgr::_release_load(const std::shared_ptr<Batch>& batch) {
+    --batch->pending_loads;
+    if (batch->closed && batch->pending_loads == 0) {
+        _close_batch(batch);
+    }
+}
+
+void GroupCommitMgr::_close_batch(const std::shared_ptr<Batch>& batch) {
+    batch->closed = true;
+    auto it = _open_batches.find(batch->key);
+    if (it != _open_batches.end() && it->second == batch) {
+        _open_batches.erase(it);
+    }
+    if (batch->pending_loads > 0) {
+        return;
+    }
+    Status st = _flush_pool->submit_func([this, batch]() { _flush(batch); });
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to submit the flush of group commit batch " << batch->ctx->label
+                     << ", err=" << st.get_error_msg();
+        _batches.erase(batch->ctx->label);
+    }
+}
+
+void GroupCommitMgr::_close_expired_batches() {
+    int64_t now = MonotonicMillis();
+    std::lock_guard<std::mutex> l(_lock);
+    std::vector<std::shared_ptr<Batch>> expired_batches;
+    for (auto& [key, batch] : _open_batches) {
+        if (now - batch->create_time_ms >= config::group_commit_interval_ms) {
+            expired_batches.push_back(batch);
+        }
+    }
+    for (auto& batch : expired_batches) {
+        _close_batch(batch);
+    }
+}
+
+void GroupCommitMgr::_flush(const std::shared_ptr<Batch>& batch) {
+    StreamLoadContext* ctx = batch->ctx;
+    Status st;
+    if (batch->wal_files.empty()) {
+        // all the loads are aborted
+        st = Status::Cancelled("no load in the group commit batch");
+    } else {
+        st = _load_batch(batch.get());
+    }
+    if (st.ok() || st.code() == TStatusCode::PUBLISH_TIMEOUT) {
+        LOG(INFO) << "group commit batch is committed, label=" << ctx->label
+                  << ", txn_id=" << ctx->txn_id << ", loads=" << batch->wal_files.size()
+                  << ", rows=" << ctx->number_loaded_rows << ", bytes=" << ctx->receive_bytes;
+        FileUtils::remove_all(batch->dir);
+    } else {
+        ctx->status = st;
+        if (ctx->need_rollback) {
+            _exec_env->stream_load_executor()->rollback_txn(ctx);
+            ctx->need_rollback = false;
+        }
+        _exec_env->load_stream_mgr()->remove(ctx->id);
+        if (batch->wal_files.empty()) {
+            FileUtils::remove_all(batch->dir);
+        } else {
+            // the wals are kept and loaded again later, or when the be restarts
+            LOG(WARNING) << "failed to load group commit batch " << ctx->label
+                         << ", err=" << st.get_error_msg() << ", wal dir=" << batch->dir
+                         << ", retry after " << config::group_commit_retry_interval_ms << "ms";
+            std::lock_guard<std::mutex> l(_lock);
+            _batches.erase(ctx->label);
+            batch->retry_time_ms = MonotonicMillis() + config::group_commit_retry_interval_ms;
+            _failed_batches.push_back(batch);
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> l(_lock);
+    _batches.erase(ctx->label);
+}
+
+Status GroupCommitMgr::_load_batch(Batch* batch) {
+    StreamLoadContext* ctx = batch->ctx;
+    ctx->use_streaming = true;
+    auto pipe = std::make_shared<StreamLoadPipe>();
+    RETURN_IF_ERROR(_exec_env->load_stream_mgr()->put(ctx->id, pipe));
+    ctx->body_sink = pipe;
+
+    TStreamLoadPutRequest request = batch->request;
+    set_request_auth(&request, ctx->auth);
+    request.txnId = ctx->txn_id;
+    request.__set_loadId(ctx->id.to_thrift());
+    request.fileType = TFileType::FILE_STREAM;
+    TNetworkAddress master_addr = _exec_env->master_info()->network_address;
+    int64_t stream_load_put_start_time = MonotonicNanos();
+#ifndef BE_TEST
+    RETURN_IF_ERROR(ThriftRpcHelper::rpc<FrontendServiceClient>(
+            master_addr.hostname, master_addr.port,
+            [&request, ctx](FrontendServiceConnection& client) {
+                client->streamLoadPut(ctx->put_result, request);
+            }));
+#else
+    ctx->put_result = k_stream_load_put_result;
+#endif
+    ctx->stream_load_put_cost_nanos = MonotonicNanos() - stream_load_put_start_time;
+    RETURN_IF_ERROR(Status(ctx->put_result.status));
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->execute_plan_fragment(ctx));
+
+    // The wals are concatenated into the body of the batch, the line delimiter of a group
+    // committed load is always '\n'.
+    Status st;
+    for (const auto& wal : batch->wal_files) {
+        std::string data;
+        st = env_util::read_file_to_string(Env::Default(), wal, &data);
+        if (!st.ok()) {
+            break;
+        }
+        if (!data.empty() && data.back() != '\n') {
+            data.push_back('\n');
+        }
+        const size_t append_bytes = 1024 * 1024;
+        for (size_t offset = 0; offset < data.size() && st.ok(); offset += append_bytes) {
+            st = pipe->append(data.data() + offset, std::min(append_bytes, data.size() - offset));
+        }
+        if (!st.ok()) {
+            break;
+        }
+        ctx->receive_bytes += data.size();
+    }
+    if (st.ok()) {
+        st = pipe->finish();
+    }
+    if (!st.ok()) {
+        pipe->cancel(st.get_error_msg());
+    }
+    // wait the fragment even if the body is cancelled, it's done with the pipe then
+    Status load_st = ctx->future.get();
+    RETURN_IF_ERROR(st);
+    RETURN_IF_ERROR(load_st);
+
+    int64_t commit_and_publish_start_time = MonotonicNanos();
+    RETURN_IF_ERROR(_exec_env->stream_load_executor()->commit_txn(ctx));
+    ctx->commit_and_publish_txn_cost_nanos = MonotonicNanos() - commit_and_publish_start_time;
+    return Status::OK();
+}
+
+void GroupCommitMgr::_retry_failed_batches() {
+    std::vector<std::shared_ptr<Batch>> batches;
+    {
+        int64_t now = MonotonicMillis();
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = std::partition(_failed_batches.begin(), _failed_batches.end(),
+                                 [now](const auto& batch) { return batch->retry_time_ms > now; });
+        batches.assign(it, _failed_batches.end());
+        _failed_batches.erase(it, _failed_batches.end());
+    }
+
+    for (auto& batch : batches) {
+        bool committed = false;
+        Status st = _restart_batch(batch.get(), &committed);
+        if (st.ok() && committed) {
+            LOG(INFO) << "group commit batch " << batch->ctx->label << " is already committed";
+            FileUtils::remove_all(batch->dir);
+            continue;
+        }
+        std::lock_guard<std::mutex> l(_lock);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to load group commit batch " << batch->ctx->label
+                         << " again, err=" << st.get_error_msg();
+            batch->retry_time_ms = MonotonicMillis() + config::group_commit_retry_interval_ms;
+            _failed_batches.push_back(batch);
+            continue;
+        }
+        LOG(INFO) << "load group commit batch " << batch->ctx->label
+                  << " again, loads=" << batch->wal_files.size();
+        _batches[batch->ctx->label] = batch;
+        _close_batch(batch);
+    }
+}
+
+Status GroupCommitMgr::_restart_batch(Batch* batch, bool* committed) {
+    // the context of a load is used only once
+    StreamLoadContext* old_ctx = batch->ctx;
+    StreamLoadContext* ctx = new StreamLoadContext(_exec_env);
+    ctx->ref();
+    batch->ctx = ctx;
+    ctx->load_type = TLoadType::MANUL_LOAD;
+    ctx->load_src_type = TLoadSourceType::RAW;
+    ctx->db = old_ctx->db;
+    ctx->table = old_ctx->table;
+    ctx->label = old_ctx->label;
+    ctx->auth = old_ctx->auth;
+    ctx->timeout_second = old_ctx->timeout_second;
+    ctx->max_filter_ratio = old_ctx->max_filter_ratio;
+    ctx->txn_id = old_ctx->txn_id;
+    if (old_ctx->unref()) {
+        delete old_ctx;
+    }
+
+    // The transaction of the batch may be still running, the label can be used again once
+    // it's aborted. If it has been committed, the label is used by a committed or finished job.
+    ctx->status = Status::Cancelled("load the group commit batch again");
+    _exec_env->stream_load_executor()->rollback_txn(ctx);
+    ctx->status = Status::OK();
+    Status st = _exec_env->stream_load_executor()->begin_txn(ctx);
+    if (!st.ok()) {
+        if (st.code() == TStatusCode::LABEL_ALREADY_EXISTS &&
+            (ctx->existing_job_status == "FINISHED" || ctx->existing_job_status == "COMMITTED")) {
+            *committed = true;
+            return Status::OK();
+        }
+        return st;
+    }
+    st = _write_meta(*batch);
+    if (!st.ok()) {
+        ctx->status = st;
+        _exec_env->stream_load_executor()->rollback_txn(ctx);
+        return st;
+    }
+    return Status::OK();
+}
+
+void GroupCommitMgr::_replay_wals() {
+    // the batches can't be loaded before the master fe is known
+    while (_exec_env->master_info()->network_address.port == 0) {
+        if (_stop_background_threads_latch.wait_for(std::chrono::seconds(1))) {
+            return;
+        }
+    }
+
+    std::set<std::string> dirs;
+    Status st = FileUtils::list_dirs_files(_wal_path, &dirs, nullptr, Env::Default());
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to list the wal dirs in " << _wal_path
+                     << ", err=" << st.get_error_msg();
+        return;
+    }
+    for (const auto& label : dirs) {
+        if (label.find(GROUP_COMMIT_LABEL_PREFIX) != 0) {
+            continue;
+        }
+        {
+            // the batches joined by the loads since the be starts
+            std::lock_guard<std::mutex> l(_lock);
+            if (_batches.count(label) > 0 ||
+                std::any_of(_failed_batches.begin(), _failed_batches.end(),
+                            [&label](const auto& batch) { return batch->ctx->label == label; })) {
+                continue;
+            }
+        }
+        auto batch = std::make_shared<Batch>();
+        batch->dir = _wal_path + "/" + label;
+        if (!_read_meta(batch->dir, &batch->request).ok()) {
+            // no load has joined the batch if its meta is not written
+            FileUtils::remove_all(batch->dir);
+            continue;
+        }
+        std::set<std::string> files;
+        if (!FileUtils::list_dirs_files(batch->dir, nullptr, &files, Env::Default()).ok()) {
+            continue;
+        }
+        for (const auto& file : files) {
+            if (file == META_FILE) {
+                continue;
+            }
+            if (file.size() >= TMP_SUFFIX.size() &&
+                file.compare(file.size() - TMP_SUFFIX.size(), TMP_SUFFIX.size(), TMP_SUFFIX) ==
+                        0) {
+                // the load is not acknowledged
+                FileUtils::remove(batch->dir + "/" + file);
+            } else {
+                batch->wal_files.push_back(batch->dir + "/" + file);
+            }
+        }
+
+        // the context of the batch before the crash, the batch is loaded in a new one
+        StreamLoadContext* ctx = new StreamLoadContext(_exec_env);
+        ctx->ref();
+        batch->ctx = ctx;
+        ctx->db = batch->request.db;
+        ctx->table = batch->request.tbl;
+        ctx->label = label;
+        ctx->auth.auth_code = batch->request.txnId;
+        if (batch->request.__isset.timeout) {
+            ctx->timeout_second = batch->request.timeout;
+        }
+        if (batch->request.__isset.max_filter_ratio) {
+            ctx->max_filter_ratio = batch->request.max_filter_ratio;
+        }
+        ctx->txn_id = batch->request.txnId;
+
+        LOG(INFO) << "replay group commit batch " << label << ", loads=" << batch->wal_files.size();
+        std::lock_guard<std::mutex> l(_lock);
+        _failed_batches.push_back(batch);
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,112 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/FrontendService_types.h"
+#include "gutil/ref_counted.h"
+#include "util/countdown_latch.h"
+#include "util/thread.h"
+#include "util/threadpool.h"
+
+namespace doris {
+
+class ExecEnv;
+class StreamLoadContext;
+
+// Group commit of the small stream loads.
+//
+// A group committed load joins the open batch of its table and params instead of beginning its
+// own transaction, and its body is written to a wal in the dir of the batch. The load is
+// acknowledged once its wal is synced, and all the loads of a batch are loaded in the
+// transaction of the batch, which is committed when the batch has been open for
+// group_commit_interval_ms or its bytes reach group_commit_data_bytes. So the tablets get one
+// rowset per batch instead of one rowset per load.
+//
+// The wal dir of a batch is removed after the batch is committed. A batch failed to load is
+// loaded again in a new transaction of its label after group_commit_retry_interval_ms, and the
+// batches left by a crash are loaded again when the BE starts. The label of a batch makes sure
+// it's committed only once.
+class GroupCommitMgr {
+public:
+    GroupCommitMgr(ExecEnv* exec_env);
+    ~GroupCommitMgr();
+
+    Status init();
+
+    // Join the load to an open batch of its table and params, the request is the put request
+    // built from the headers of the load. The transaction of the batch is begun by the first
+    // load joining it, so the auth of the load is checked before its body is received.
+    // On success, ctx->body_sink is set to the wal of the load.
+    Status join(StreamLoadContext* ctx, const TStreamLoadPutRequest& request);
+
+    // Add the load to its batch after its body is written to the wal by ctx->body_sink,
+    // the load is durable when it returns OK.
+    Status commit_wal(StreamLoadContext* ctx);
+
+    // Remove a joined load from its batch, its wal is removed.
+    void abort(StreamLoadContext* ctx);
+
+private:
+    struct Batch;
+
+    Status _create_batch(const std::string& key, const StreamLoadContext* load_ctx,
+                         const TStreamLoadPutRequest& request, std::shared_ptr<Batch>* batch);
+    Status _write_meta(const Batch& batch);
+    Status _read_meta(const std::string& dir, TStreamLoadPutRequest* request);
+
+    // release a load from the batch, the batch is flushed if it's closed and it has no
+    // pending load. Must be called with _lock held.
+    void _release_load(const std::shared_ptr<Batch>& batch);
+    void _close_batch(const std::shared_ptr<Batch>& batch);
+    void _flush(const std::shared_ptr<Batch>& batch);
+    Status _load_batch(Batch* batch);
+
+    void _close_expired_batches();
+    // Load the failed batches again after their retry time.
+    void _retry_failed_batches();
+    // Begin a new transaction of the label of the batch in a new context, the transaction of the
+    // batch is aborted first if it's still running. *committed is set if the batch has already
+    // been committed by its label, which is visible or will be.
+    Status _restart_batch(Batch* batch, bool* committed);
+    // Add the batches left in the wal dir to the failed batches.
+    void _replay_wals();
+
+    ExecEnv* _exec_env;
+    std::string _wal_path;
+
+    std::mutex _lock;
+    // the open batches by the key of their table and params
+    std::unordered_map<std::string, std::shared_ptr<Batch>> _open_batches;
+    // the batches not flushed yet by their label
+    std::unordered_map<std::string, std::shared_ptr<Batch>> _batches;
+    // the batches failed to load, and the batches replayed from the wal dir
+    std::vector<std::shared_ptr<Batch>> _failed_batches;
+
+    std::unique_ptr<ThreadPool> _flush_pool;
+    CountDownLatch _stop_background_threads_latch;
+    scoped_refptr<Thread> _background_thread;
+};
+
+} // namespace doris
@@ -81,7 +81,8 @@ protected:
         bool finished = false;
         auto index_id = request.index_id();
         RETURN_IF_ERROR(channel->close(request.sender_id(), request.backend_id(), &finished,
-                                       request.partition_ids(), response->mutable_tablet_vec()));
+                                       request.partition_ids(), response->mutable_tablet_vec(),
+                                       response->mutable_success_slave_tablet_node_ids()));
         if (finished) {
             std::lock_guard<std::mutex> l(_lock);
             _tablets_channels.erase(index_id);
@@ -91,6 +91,8 @@ Status LoadChannelMgr::init(int64_t process_mem_limit) {
     REGISTER_HOOK_METRIC(load_channel_mem_consumption,
                          [this]() { return _mem_tracker->consumption(); });
     _last_success_channel = new_lru_cache("LastestSuccessChannelCache", 1024);
+    _memtable_memory_manager = std::make_unique<MemTableMemoryManager>();
+    RETURN_IF_ERROR(_memtable_memory_manager->init(_mem_tracker));
     RETURN_IF_ERROR(_start_bg_worker());
     return Status::OK();
 }
@@ -145,39 +147,6 @@ void LoadChannelMgr::_finish_load_channel(const UniqueId load_id) {
     VLOG_CRITICAL << "removed load channel " << load_id;
 }
 
-void LoadChannelMgr::_handle_mem_exceed_limit() {
-    // lock so that only one thread can check mem limit
-    std::lock_guard<std::mutex> l(_lock);
-    if (!_mem_tracker->limit_exceeded()) {
-        return;
-    }
-
-    int64_t max_consume = 0;
-    std::shared_ptr<LoadChannel> channel;
-    for (auto& kv : _load_channels) {
-        if (kv.second->is_high_priority()) {
-            // do not select high priority channel to reduce memory
-            // to avoid blocking them.
-            continue;
-        }
-        if (kv.second->mem_consumption() > max_consume) {
-            max_consume = kv.second->mem_consumption();
-            channel = kv.second;
-        }
-    }
-    if (max_consume == 0) {
-        // should not happen, add log to observe
-        LOG(WARNING) << "failed to find suitable load channel when total load mem limit exceed";
-        return;
-    }
-    DCHECK(channel.get() != nullptr);
-
-    // force reduce mem limit of the selected channel
-    LOG(INFO) << "reducing memory of " << *channel << " because total load mem consumption "
-              << _mem_tracker->consumption() << " has exceeded limit " << _mem_tracker->limit();
-    channel->handle_mem_exceed_limit(true);
-}
-
 Status LoadChannelMgr::cancel(const PTabletWriterCancelRequest& params) {
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     UniqueId load_id(params.id());
@@ -29,6 +29,7 @@
 #include "gen_cpp/internal_service.pb.h"
 #include "gutil/ref_counted.h"
 #include "runtime/load_channel.h"
+#include "runtime/memtable_memory_manager.h"
 #include "runtime/tablets_channel.h"
 #include "runtime/thread_context.h"
 #include "util/countdown_latch.h"
@@ -58,6 +59,8 @@ public:
     // cancel all tablet stream for 'load_id' load
     Status cancel(const PTabletWriterCancelRequest& request);
 
+    MemTableMemoryManager* memtable_memory_manager() { return _memtable_memory_manager.get(); }
+
 private:
     static LoadChannel* _create_load_channel(const UniqueId& load_id, int64_t mem_limit,
                                              int64_t timeout_s, bool is_high_priority,
@@ -68,13 +71,13 @@ private:
                              const UniqueId& load_id, const Request& request);
 
     void _finish_load_channel(UniqueId load_id);
-    // check if the total load mem consumption exceeds limit.
-    // If yes, it will pick a load channel to try to reduce memory consumption.
-    void _handle_mem_exceed_limit();
 
     Status _start_bg_worker();
 
 protected:
+    // flush the memtables of all the load channels, it must outlive the load channels
+    std::unique_ptr<MemTableMemoryManager> _memtable_memory_manager;
+
     // lock protect the load channel map
     std::mutex _lock;
     // load id -> load channel
@@ -127,10 +130,11 @@ Status LoadChannelMgr::add_batch(const TabletWriterAddRequest& request,
     }
 
     if (!channel->is_high_priority()) {
-        // 2. check if mem consumption exceed limit
+        // 2. wait for the memtables to be flushed if mem consumption exceeds limit, so the
+        // sender doesn't send the next batch till the memory is reduced.
         // If this is a high priority load task, do not handle this.
         // because this may block for a while, which may lead to rpc timeout.
-        _handle_mem_exceed_limit();
+        _memtable_memory_manager->wait_until_under_limit();
     }
 
     // 3. add batch to load channel
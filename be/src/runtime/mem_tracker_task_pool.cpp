@@ -38,11 +38,14 @@ std::shared_ptr<MemTracker> MemTrackerTaskPool::register_task_mem_tracker_impl(
 }
 
 std::shared_ptr<MemTracker> MemTrackerTaskPool::register_query_mem_tracker(
-        const std::string& query_id, int64_t mem_limit) {
+        const std::string& query_id, int64_t mem_limit, std::shared_ptr<MemTracker> parent) {
     VLOG_FILE << "Register Query memory tracker, query id: " << query_id
               << " limit: " << PrettyPrinter::print(mem_limit, TUnit::BYTES);
+    if (parent == nullptr) {
+        parent = ExecEnv::GetInstance()->query_pool_mem_tracker();
+    }
     return register_task_mem_tracker_impl(query_id, mem_limit, fmt::format("queryId={}", query_id),
-                                          ExecEnv::GetInstance()->query_pool_mem_tracker());
+                                          parent);
 }
 
 std::shared_ptr<MemTracker> MemTrackerTaskPool::register_load_mem_tracker(
@@ -36,8 +36,11 @@ public:
                                                                int64_t mem_limit,
                                                                const std::string& label,
                                                                std::shared_ptr<MemTracker> parent);
-    std::shared_ptr<MemTracker> register_query_mem_tracker(const std::string& query_id,
-                                                           int64_t mem_limit);
+    // The query MemTracker is a child of `parent` if it's not null, e.g. the MemTracker of the
+    // workload group of the query, otherwise a child of the query pool MemTracker.
+    std::shared_ptr<MemTracker> register_query_mem_tracker(
+            const std::string& query_id, int64_t mem_limit,
+            std::shared_ptr<MemTracker> parent = nullptr);
     std::shared_ptr<MemTracker> register_load_mem_tracker(const std::string& load_id,
                                                           int64_t mem_limit);
 
@@ -0,0 +1,166 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/memtable_memory_manager.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "common/config.h"
+#include "olap/delta_writer.h"
+#include "runtime/mem_tracker.h"
+#include "util/time.h"
+
+namespace doris {
+
+// the interval to check the load memory by the background thread
+static constexpr int64_t CHECK_INTERVAL_MS = 100;
+
+MemTableMemoryManager::MemTableMemoryManager() = default;
+
+MemTableMemoryManager::~MemTableMemoryManager() {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _stopped = true;
+    }
+    _flush_cond.notify_all();
+    _checked_cond.notify_all();
+    if (_flush_thread) {
+        _flush_thread->join();
+    }
+}
+
+Status MemTableMemoryManager::init(std::shared_ptr<MemTracker> load_mem_tracker) {
+    _load_mem_tracker = std::move(load_mem_tracker);
+    return Thread::create(
+            "MemTableMemoryManager", "flush_memtables",
+            [this]() {
+                std::unique_lock<std::mutex> l(_lock);
+                while (!_stopped) {
+                    _flush_cond.wait_for(l, std::chrono::milliseconds(CHECK_INTERVAL_MS),
+                                         [this]() { return _stopped || _flush_requested; });
+                    if (_stopped) {
+                        break;
+                    }
+                    _flush_requested = false;
+                    _flush_memtables();
+                    _checked_cond.notify_all();
+                }
+            },
+            &_flush_thread);
+}
+
+void MemTableMemoryManager::register_writer(DeltaWriter* writer) {
+    std::lock_guard<std::mutex> l(_lock);
+    _writers.insert(writer);
+}
+
+void MemTableMemoryManager::deregister_writer(DeltaWriter* writer) {
+    // the writer is not flushed by the background thread after the lock is released
+    std::lock_guard<std::mutex> l(_lock);
+    _writers.erase(writer);
+}
+
+void MemTableMemoryManager::wait_until_under_limit() {
+    if (_load_mem_tracker == nullptr || !_load_mem_tracker->limit_exceeded()) {
+        return;
+    }
+    int64_t deadline_ms = MonotonicMillis() + config::load_memtable_mem_wait_max_ms;
+    std::unique_lock<std::mutex> l(_lock);
+    while (!_stopped && _load_mem_tracker->limit_exceeded()) {
+        int64_t wait_ms = deadline_ms - MonotonicMillis();
+        if (wait_ms <= 0) {
+            LOG(WARNING) << "load memory consumption " << _load_mem_tracker->consumption()
+                         << " still exceeds limit " << _load_mem_tracker->limit() << " after "
+                         << config::load_memtable_mem_wait_max_ms << "ms";
+            break;
+        }
+        _flush_requested = true;
+        _flush_cond.notify_one();
+        _checked_cond.wait_for(l, std::chrono::milliseconds(std::min(wait_ms, CHECK_INTERVAL_MS)));
+    }
+}
+
+void MemTableMemoryManager::_flush_memtables() {
+    int64_t soft_limit =
+            _load_mem_tracker->limit() * config::load_memtable_flush_soft_limit_percent / 100;
+    int64_t consumption = _load_mem_tracker->consumption();
+    if (consumption < soft_limit) {
+        return;
+    }
+
+    std::vector<std::pair<int64_t, DeltaWriter*>> memtables;
+    int64_t active_mem = 0;
+    int64_t writers_mem = 0;
+    for (auto writer : _writers) {
+        writers_mem += writer->mem_consumption();
+        int64_t mem = writer->active_memtable_mem_consumption();
+        if (mem > 0) {
+            memtables.emplace_back(mem, writer);
+            active_mem += mem;
+        }
+    }
+    int64_t mem_to_flush = _mem_to_flush(consumption, soft_limit, writers_mem - active_mem);
+    if (mem_to_flush <= 0) {
+        return;
+    }
+
+    int num_flushed = 0;
+    int64_t flushed_mem = _flush_largest(
+            std::move(memtables), mem_to_flush,
+            [](DeltaWriter* writer) { return writer->flush_memtable_and_wait(false); },
+            &num_flushed);
+    LOG(INFO) << "flush " << num_flushed << " memtables of " << flushed_mem
+              << " bytes because load memory consumption " << consumption
+              << " has exceeded soft limit " << soft_limit;
+}
+
+int64_t MemTableMemoryManager::_mem_to_flush(int64_t consumption, int64_t soft_limit,
+                                             int64_t flushing_mem) {
+    if (consumption < soft_limit) {
+        return 0;
+    }
+    // The memory of the memtables being flushed is released soon, only the rest has to be
+    // reduced by flushing more memtables. So the memtables are not flushed again and again
+    // while the previous flushes are not done, which makes tiny segments.
+    return consumption - flushing_mem - soft_limit;
+}
+
+int64_t MemTableMemoryManager::_flush_largest(
+        std::vector<std::pair<int64_t, DeltaWriter*>> memtables, int64_t mem_to_flush,
+        const std::function<Status(DeltaWriter*)>& flush, int* num_flushed) {
+    std::sort(memtables.begin(), memtables.end(),
+              [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+    int64_t flushed_mem = 0;
+    *num_flushed = 0;
+    for (auto& [mem, writer] : memtables) {
+        if (flushed_mem >= mem_to_flush) {
+            break;
+        }
+        Status st = flush(writer);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to flush memtable to reduce load memory, err="
+                         << st.get_error_msg();
+            continue;
+        }
+        flushed_mem += mem;
+        ++(*num_flushed);
+    }
+    return flushed_mem;
+}
+
+} // namespace doris
@@ -0,0 +1,93 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/ref_counted.h"
+#include "util/thread.h"
+
+namespace doris {
+
+class DeltaWriter;
+class MemTracker;
+
+// The manager of the memory of the memtables of all the load channels of the backend.
+//
+// Every DeltaWriter of a TabletsChannel is registered here with the memtable it's writing.
+// Once the load memory exceeds load_memtable_flush_soft_limit_percent of the load memory limit,
+// the background thread flushes the largest memtables across all the load channels, so that
+// the memory is reduced before the limit is reached, by the large memtables instead of the
+// ones of the load happening to hit the limit. When the limit is exceeded anyway, the add batch
+// requests wait for the flushes instead of flushing themselves, which holds the next batch of
+// the senders back until the memory is reduced.
+class MemTableMemoryManager {
+public:
+    MemTableMemoryManager();
+    ~MemTableMemoryManager();
+
+    // the load_mem_tracker tracks the memory of all the load channels, and its limit is the
+    // hard limit of the memory of the memtables
+    Status init(std::shared_ptr<MemTracker> load_mem_tracker);
+
+    void register_writer(DeltaWriter* writer);
+    void deregister_writer(DeltaWriter* writer);
+
+    // Wait at most load_memtable_mem_wait_max_ms till the load memory is under its limit,
+    // the background flushes are triggered at once.
+    void wait_until_under_limit();
+
+private:
+    // flush the largest memtables till the memory being flushed brings the load memory under
+    // the soft limit
+    void _flush_memtables();
+
+    // The bytes of the active memtables to flush, the memtables being flushed are counted as
+    // released already. It's not positive if nothing has to be flushed.
+    static int64_t _mem_to_flush(int64_t consumption, int64_t soft_limit, int64_t flushing_mem);
+
+    // Flush the largest of the active memtables by `flush` till at least `mem_to_flush` bytes
+    // are flushed, the memtables failing to flush are skipped. Return the bytes flushed.
+    static int64_t _flush_largest(std::vector<std::pair<int64_t, DeltaWriter*>> memtables,
+                                  int64_t mem_to_flush,
+                                  const std::function<Status(DeltaWriter*)>& flush,
+                                  int* num_flushed);
+
+    std::shared_ptr<MemTracker> _load_mem_tracker;
+
+    std::mutex _lock;
+    std::unordered_set<DeltaWriter*> _writers;
+
+    // notified to flush the memtables at once or to stop
+    std::condition_variable _flush_cond;
+    bool _flush_requested = false;
+    bool _stopped = false;
+    // notified after the memtables are checked by the background thread
+    std::condition_variable _checked_cond;
+
+    scoped_refptr<Thread> _flush_thread;
+};
+
+} // namespace doris
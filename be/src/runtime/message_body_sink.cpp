@@ -53,6 +53,14 @@ Status MessageBodyFileSink::append(const char* data, size_t size) {
 }
 
 Status MessageBodyFileSink::finish() {
+    if (_sync_on_finish && ::fdatasync(_fd) < 0) {
+        char errmsg[64];
+        LOG(WARNING) << "fail to sync, file=" << _path
+                     << ", error=" << strerror_r(errno, errmsg, 64);
+        ::close(_fd);
+        _fd = -1;
+        return Status::InternalError("fail to sync file");
+    }
     if (::close(_fd) < 0) {
         std::stringstream ss;
         char errmsg[64];
@@ -44,7 +44,9 @@ protected:
 // write message to a local file
 class MessageBodyFileSink : public MessageBodySink {
 public:
-    MessageBodyFileSink(const std::string& path) : _path(path) {}
+    // If sync_on_finish, the file is synced to the disk when finished.
+    MessageBodyFileSink(const std::string& path, bool sync_on_finish = false)
+            : _path(path), _sync_on_finish(sync_on_finish) {}
     virtual ~MessageBodyFileSink();
 
     Status open();
@@ -55,6 +57,7 @@ public:
 
 private:
     std::string _path;
+    bool _sync_on_finish;
     int _fd = -1;
 };
 
@@ -29,6 +29,7 @@
 #include "exec/exec_node.h"
 #include "exec/scan_node.h"
 #include "exprs/expr.h"
+#include "gutil/strings/substitute.h"
 #include "runtime/data_stream_mgr.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
@@ -44,6 +45,7 @@
 #include "util/pretty_printer.h"
 #include "util/uid_util.h"
 #include "vec/core/block.h"
+#include "vec/exec/pipeline/pipeline_fragment_context.h"
 #include "vec/exec/vexchange_node.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 
@@ -123,9 +125,23 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
     }
     _runtime_state->set_desc_tbl(desc_tbl);
 
-    // set up plan
-    DCHECK(request.__isset.fragment);
-    RETURN_IF_ERROR(ExecNode::create_tree(_runtime_state.get(), obj_pool(), request.fragment.plan,
+    // set up plan, the instances of a fragment on this host may share its plan fragment
+    if (fragments_ctx != nullptr && request.__isset.fragment_id) {
+        if (request.__isset.fragment) {
+            fragments_ctx->set_plan_fragment(request.fragment_id, request.fragment);
+        }
+        _shared_fragment = fragments_ctx->get_plan_fragment(request.fragment_id);
+        if (_shared_fragment == nullptr) {
+            return Status::InternalError(strings::Substitute(
+                    "the plan fragment $0 of query $1 is not sent yet", request.fragment_id,
+                    print_id(_query_id)));
+        }
+    } else {
+        DCHECK(request.__isset.fragment);
+    }
+    const TPlanFragment& fragment =
+            _shared_fragment != nullptr ? *_shared_fragment : request.fragment;
+    RETURN_IF_ERROR(ExecNode::create_tree(_runtime_state.get(), obj_pool(), fragment.plan,
                                           *desc_tbl, &_plan));
     _runtime_state->set_fragment_root_id(_plan->id());
 
@@ -172,9 +188,9 @@ Status PlanFragmentExecutor::prepare(const TExecPlanFragmentParams& request,
     _runtime_state->set_num_per_fragment_instances(params.num_senders);
 
     // set up sink, if required
-    if (request.fragment.__isset.output_sink) {
+    if (fragment.__isset.output_sink) {
         RETURN_IF_ERROR(DataSink::create_data_sink(
-                obj_pool(), request.fragment.output_sink, request.fragment.output_exprs, params,
+                obj_pool(), fragment.output_sink, fragment.output_exprs, params,
                 row_desc(), runtime_state()->enable_vectorized_exec(), &_sink, *desc_tbl));
         RETURN_IF_ERROR(_sink->prepare(runtime_state()));
 
@@ -232,7 +248,11 @@ Status PlanFragmentExecutor::open() {
     }
     Status status = Status::OK();
     if (_runtime_state->enable_vectorized_exec()) {
-        status = open_vectorized_internal();
+        if (_runtime_state->enable_pipeline_exec() && _sink != nullptr) {
+            status = open_pipeline_internal();
+        } else {
+            status = open_vectorized_internal();
+        }
     } else {
         status = open_internal();
     }
@@ -266,6 +286,7 @@ Status PlanFragmentExecutor::open_vectorized_internal() {
     }
     {
         SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        SCOPED_HARDWARE_COUNTERS(_runtime_state->hardware_counters());
         RETURN_IF_ERROR(_sink->open(runtime_state()));
     }
 
@@ -283,6 +304,8 @@ Status PlanFragmentExecutor::open_vectorized_internal() {
 
         SCOPED_TIMER(profile()->total_time_counter());
         SCOPED_CPU_TIMER(_fragment_cpu_timer);
+        // the events of the sink are counted by the fragment directly
+        SCOPED_HARDWARE_COUNTERS(_runtime_state->hardware_counters());
         // Collect this plan and sub plan statistics, and send to parent plan.
         if (_collect_query_statistics_with_every_batch) {
             _collect_query_statistics();
@@ -295,6 +318,21 @@ Status PlanFragmentExecutor::open_vectorized_internal() {
         RETURN_IF_ERROR(st);
     }
 
+    return finish_vectorized_sink();
+}
+
+Status PlanFragmentExecutor::open_pipeline_internal() {
+    {
+        SCOPED_TIMER(profile()->total_time_counter());
+        doris::vectorized::PipelineFragmentContext context(_runtime_state.get(), _plan,
+                                                           _sink.get());
+        RETURN_IF_ERROR(context.prepare());
+        RETURN_IF_ERROR(context.execute(_exec_env->pipeline_task_scheduler()));
+    }
+    return finish_vectorized_sink();
+}
+
+Status PlanFragmentExecutor::finish_vectorized_sink() {
     {
         SCOPED_TIMER(profile()->total_time_counter());
         _collect_query_statistics();
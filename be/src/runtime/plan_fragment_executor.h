@@ -193,6 +193,8 @@ private:
     // note that RuntimeState should be constructed before and destructed after `_sink' and `_row_batch',
     // therefore we declare it before `_sink' and `_row_batch'
     std::unique_ptr<RuntimeState> _runtime_state;
+    // the plan fragment shared with the other instances of the fragment by QueryFragmentsCtx
+    std::shared_ptr<const TPlanFragment> _shared_fragment;
     // Output sink for rows sent to this fragment. May not be set, in which case rows are
     // returned via get_next's row batch
     // Created in prepare (if required), owned by this object.
@@ -243,6 +245,10 @@ private:
     // have been stopped. _sink will be set to nullptr after successful execution.
     Status open_internal();
     Status open_vectorized_internal();
+    // Run the vectorized plan by the pipeline engine, see PipelineFragmentContext.
+    Status open_pipeline_internal();
+    // Close the sink after all blocks were sent to it and send the final report.
+    Status finish_vectorized_sink();
 
     // Executes get_next() logic and returns resulting status.
     Status get_next_internal(RowBatch** batch);
@@ -0,0 +1,163 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_admission_queue.h"
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "gutil/strings/substitute.h"
+#include "runtime/mem_tracker.h"
+#include "util/time.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+QueryAdmissionQueue::QueryAdmissionQueue(std::function<int64_t()> process_mem_limit)
+        : _process_mem_limit(std::move(process_mem_limit)) {
+    if (_process_mem_limit == nullptr) {
+        _process_mem_limit = []() { return MemTracker::get_process_tracker()->limit(); };
+    }
+}
+
+bool QueryAdmissionQueue::admit(const TUniqueId& query_id, int64_t mem_reservation, int priority,
+                                int64_t timeout_ms, AdmitCallback callback) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto running = _running_queries.find(query_id);
+    if (running != _running_queries.end()) {
+        ++running->second.fragments;
+        return true;
+    }
+    for (auto& waiting : _waiting_queries) {
+        if (waiting.query_id == query_id) {
+            waiting.callbacks.push_back(std::move(callback));
+            return false;
+        }
+    }
+    if (_waiting_queries.empty() && _can_admit(mem_reservation)) {
+        _run(query_id, mem_reservation, 1);
+        return true;
+    }
+
+    int64_t now = MonotonicMillis();
+    WaitingQuery waiting {query_id, mem_reservation, priority, now, now + timeout_ms, {}};
+    waiting.callbacks.push_back(std::move(callback));
+    auto pos = _waiting_queries.begin();
+    while (pos != _waiting_queries.end() && pos->priority >= priority) {
+        ++pos;
+    }
+    _waiting_queries.insert(pos, std::move(waiting));
+    return false;
+}
+
+void QueryAdmissionQueue::release(const TUniqueId& query_id) {
+    Callbacks callbacks;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _running_queries.find(query_id);
+        DCHECK(it != _running_queries.end());
+        if (it == _running_queries.end() || --it->second.fragments > 0) {
+            return;
+        }
+        _reserved_mem -= it->second.mem_reservation;
+        _running_queries.erase(it);
+        _admit_waiting(&callbacks);
+    }
+    for (auto& [callback, wait_ms] : callbacks) {
+        callback(Status::OK(), wait_ms);
+    }
+}
+
+void QueryAdmissionQueue::check_timeout() {
+    Callbacks timed_out;
+    Callbacks admitted;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        int64_t now = MonotonicMillis();
+        for (auto it = _waiting_queries.begin(); it != _waiting_queries.end();) {
+            if (it->deadline_ms > now) {
+                ++it;
+                continue;
+            }
+            LOG(INFO) << "query " << print_id(it->query_id) << " timed out in the admission queue"
+                      << " after " << now - it->enqueue_time_ms << "ms";
+            for (auto& callback : it->callbacks) {
+                timed_out.emplace_back(std::move(callback), now - it->enqueue_time_ms);
+            }
+            it = _waiting_queries.erase(it);
+        }
+        // the new head may be admitted, e.g. the limits have been changed
+        _admit_waiting(&admitted);
+    }
+    for (auto& [callback, wait_ms] : timed_out) {
+        callback(Status::TimedOut(strings::Substitute(
+                         "timed out in the query admission queue after $0ms", wait_ms)),
+                 wait_ms);
+    }
+    for (auto& [callback, wait_ms] : admitted) {
+        callback(Status::OK(), wait_ms);
+    }
+}
+
+size_t QueryAdmissionQueue::num_waiting_queries() {
+    std::lock_guard<std::mutex> l(_lock);
+    return _waiting_queries.size();
+}
+
+size_t QueryAdmissionQueue::num_running_queries() {
+    std::lock_guard<std::mutex> l(_lock);
+    return _running_queries.size();
+}
+
+bool QueryAdmissionQueue::_can_admit(int64_t mem_reservation) const {
+    if (_running_queries.empty()) {
+        return true;
+    }
+    if (config::query_queue_max_running_queries > 0 &&
+        _running_queries.size() >= config::query_queue_max_running_queries) {
+        return false;
+    }
+    int64_t mem_limit = _process_mem_limit();
+    if (config::query_queue_reservable_mem_percent > 0 && mem_limit > 0 &&
+        _reserved_mem + mem_reservation >
+                mem_limit * config::query_queue_reservable_mem_percent / 100) {
+        return false;
+    }
+    return true;
+}
+
+void QueryAdmissionQueue::_run(const TUniqueId& query_id, int64_t mem_reservation,
+                               int fragments) {
+    auto& running = _running_queries[query_id];
+    running.fragments = fragments;
+    running.mem_reservation = mem_reservation;
+    _reserved_mem += mem_reservation;
+}
+
+void QueryAdmissionQueue::_admit_waiting(Callbacks* callbacks) {
+    int64_t now = MonotonicMillis();
+    while (!_waiting_queries.empty() && _can_admit(_waiting_queries.front().mem_reservation)) {
+        auto& waiting = _waiting_queries.front();
+        _run(waiting.query_id, waiting.mem_reservation, waiting.callbacks.size());
+        for (auto& callback : waiting.callbacks) {
+            callbacks->emplace_back(std::move(callback), now - waiting.enqueue_time_ms);
+        }
+        _waiting_queries.pop_front();
+    }
+}
+
+} // namespace doris
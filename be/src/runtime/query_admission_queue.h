@@ -0,0 +1,99 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+// Limit the queries running on this backend by their number and their memory reservations,
+// which are the memory limits of the queries. The fragments of the admitted queries run at
+// once, the fragments of the other queries wait in the queue ordered by the priority of the
+// queries, and then by their arrival, until they are admitted or timed out.
+//
+// The limits are config::query_queue_max_running_queries and
+// config::query_queue_reservable_mem_percent of the process memory limit. A query is always
+// admitted when no query is running, so a query reserving more memory than the limit doesn't
+// wait forever. The waiting queries are admitted strictly in order, a big query at the head
+// is not overtaken by the smaller ones behind it.
+class QueryAdmissionQueue {
+public:
+    // Called with OK once the waiting fragment is admitted, or with TimedOut once it waited for
+    // longer than its timeout. `wait_ms` is the time the fragment waited in the queue.
+    using AdmitCallback = std::function<void(const Status& status, int64_t wait_ms)>;
+
+    // `process_mem_limit` returns the process memory limit, which is the limit of the process
+    // MemTracker by default.
+    explicit QueryAdmissionQueue(std::function<int64_t()> process_mem_limit = nullptr);
+
+    // Returns true if the fragment is admitted at once, and `callback` is never called then.
+    // Otherwise the fragment waits in the queue and `callback` will be called.
+    bool admit(const TUniqueId& query_id, int64_t mem_reservation, int priority,
+               int64_t timeout_ms, AdmitCallback callback);
+
+    // Called when an admitted fragment is finished, the query leaves when all its fragments are
+    // finished and the waiting queries may be admitted.
+    void release(const TUniqueId& query_id);
+
+    // Time out the fragments waiting for longer than their timeouts, called periodically.
+    void check_timeout();
+
+    size_t num_waiting_queries();
+    size_t num_running_queries();
+
+private:
+    struct RunningQuery {
+        int fragments = 0;
+        int64_t mem_reservation = 0;
+    };
+
+    struct WaitingQuery {
+        TUniqueId query_id;
+        int64_t mem_reservation;
+        int priority;
+        int64_t enqueue_time_ms;
+        int64_t deadline_ms;
+        std::vector<AdmitCallback> callbacks;
+    };
+
+    using Callbacks = std::vector<std::pair<AdmitCallback, int64_t>>;
+
+    bool _can_admit(int64_t mem_reservation) const;
+    void _run(const TUniqueId& query_id, int64_t mem_reservation, int fragments);
+    // admit the waiting queries from the head, the callbacks are called out of the lock
+    void _admit_waiting(Callbacks* callbacks);
+
+    std::function<int64_t()> _process_mem_limit;
+
+    std::mutex _lock;
+    std::unordered_map<TUniqueId, RunningQuery> _running_queries;
+    int64_t _reserved_mem = 0;
+    // ordered by the priority from high to low, and the arrival
+    std::list<WaitingQuery> _waiting_queries;
+};
+
+} // namespace doris
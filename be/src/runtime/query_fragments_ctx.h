@@ -18,7 +18,10 @@
 #pragma once
 
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
 #include "common/object_pool.h"
 #include "gen_cpp/PaloInternalService_types.h" // for TQueryOptions
@@ -26,6 +29,7 @@
 #include "runtime/datetime_value.h"
 #include "runtime/exec_env.h"
 #include "util/threadpool.h"
+#include "vec/runtime/vshared_hash_table_controller.h"
 
 namespace doris {
 
@@ -38,6 +42,7 @@ public:
     QueryFragmentsCtx(int total_fragment_num, ExecEnv* exec_env)
             : fragment_num(total_fragment_num), timeout_second(-1), _exec_env(exec_env) {
         _start_time = DateTimeValue::local_time();
+        _shared_hash_table_controller.reset(new vectorized::SharedHashTableController());
     }
 
     bool countdown() { return fragment_num.fetch_sub(1) == 1; }
@@ -62,6 +67,26 @@ public:
 
     ThreadPoolToken* get_token() { return _thread_token.get(); }
 
+    vectorized::SharedHashTableController* get_shared_hash_table_controller() {
+        return _shared_hash_table_controller.get();
+    }
+
+    // Keep the plan fragment sent with the first instance of the fragment, the other instances
+    // of the fragment on this host are sent without it and share it.
+    void set_plan_fragment(int fragment_id, const TPlanFragment& fragment) {
+        std::lock_guard<std::mutex> l(_plan_fragments_lock);
+        if (_plan_fragments.count(fragment_id) == 0) {
+            _plan_fragments.emplace(fragment_id, std::make_shared<const TPlanFragment>(fragment));
+        }
+    }
+
+    // Returns nullptr if the fragment was not sent yet.
+    std::shared_ptr<const TPlanFragment> get_plan_fragment(int fragment_id) {
+        std::lock_guard<std::mutex> l(_plan_fragments_lock);
+        auto it = _plan_fragments.find(fragment_id);
+        return it == _plan_fragments.end() ? nullptr : it->second;
+    }
+
 public:
     TUniqueId query_id;
     DescriptorTbl* desc_tbl;
@@ -92,6 +117,13 @@ private:
     // So that we can control the max thread that a query can be used to execute.
     // If this token is not set, the scanner will be executed in "_scan_thread_pool" in exec env.
     std::unique_ptr<ThreadPoolToken> _thread_token;
+
+    // Shares the hash tables of the broadcast joins between the instances of this query.
+    std::unique_ptr<vectorized::SharedHashTableController> _shared_hash_table_controller;
+
+    std::mutex _plan_fragments_lock;
+    // fragment id -> the plan fragment shared by the instances of the fragment
+    std::unordered_map<int, std::shared_ptr<const TPlanFragment>> _plan_fragments;
 };
 
 } // namespace doris
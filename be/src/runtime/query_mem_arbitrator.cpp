@@ -0,0 +1,75 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_mem_arbitrator.h"
+
+#include <algorithm>
+
+#include "common/config.h"
+
+namespace doris {
+
+void QueryMemArbitrator::arbitrate(int64_t process_mem, int64_t mem_limit,
+                                   std::vector<QueryMemUsage> queries,
+                                   std::vector<TUniqueId>* to_spill,
+                                   std::vector<TUniqueId>* to_cancel) {
+    to_spill->clear();
+    to_cancel->clear();
+    int64_t spill_limit = mem_limit / 100 * config::query_spill_process_mem_percent;
+    if (process_mem < spill_limit) {
+        _spilling_queries.clear();
+        return;
+    }
+
+    std::sort(queries.begin(), queries.end(),
+              [](const QueryMemUsage& lhs, const QueryMemUsage& rhs) {
+                  return lhs.mem_bytes > rhs.mem_bytes;
+              });
+
+    // ask the biggest queries to spill until the memory they hold covers the excess
+    int64_t bytes_to_free = process_mem - spill_limit;
+    bool has_new_spilling = false;
+    std::unordered_set<TUniqueId> spilling_queries;
+    for (const auto& query : queries) {
+        if (bytes_to_free <= 0) {
+            break;
+        }
+        if (!query.can_spill) {
+            continue;
+        }
+        to_spill->push_back(query.query_id);
+        spilling_queries.insert(query.query_id);
+        if (_spilling_queries.count(query.query_id) == 0) {
+            has_new_spilling = true;
+        }
+        bytes_to_free -= query.mem_bytes;
+    }
+    _spilling_queries.swap(spilling_queries);
+
+    // Cancellation is the last resort, when the spilling queries haven't released enough,
+    // or there is nothing to spill.
+    int64_t cancel_limit = mem_limit / 100 * config::query_cancel_process_mem_percent;
+    if (process_mem < cancel_limit || has_new_spilling || queries.empty()) {
+        return;
+    }
+    auto it = std::find_if(queries.begin(), queries.end(),
+                           [](const QueryMemUsage& query) { return !query.can_spill; });
+    to_cancel->push_back(it != queries.end() ? it->query_id : queries.front().query_id);
+}
+
+} // namespace doris
@@ -0,0 +1,59 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <unordered_set>
+#include <vector>
+
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+// The memory usage of a query on this backend.
+struct QueryMemUsage {
+    TUniqueId query_id;
+    int64_t mem_bytes = 0;
+    // whether the query has the operators which can spill their data
+    bool can_spill = false;
+};
+
+// Arbitrate the memory among the queries when the process memory is under pressure, instead
+// of cancelling the query whose allocation happens to fail first.
+//
+// Once the process memory exceeds config::query_spill_process_mem_percent of the mem limit,
+// the biggest queries which can spill are asked to spill until their memory covers the excess.
+// Only when the process memory still exceeds config::query_cancel_process_mem_percent of the
+// mem limit after all of them were asked to spill, the biggest query is cancelled, preferring
+// the ones which can't spill. At most one query is cancelled by each round.
+//
+// Not thread safe, it's called by the arbitrating thread of FragmentMgr.
+class QueryMemArbitrator {
+public:
+    // `to_spill` are the queries which should be spilling after this round, the others should
+    // stop spilling.
+    void arbitrate(int64_t process_mem, int64_t mem_limit, std::vector<QueryMemUsage> queries,
+                   std::vector<TUniqueId>* to_spill, std::vector<TUniqueId>* to_cancel);
+
+private:
+    // the queries asked to spill by the last round
+    std::unordered_set<TUniqueId> _spilling_queries;
+};
+
+} // namespace doris
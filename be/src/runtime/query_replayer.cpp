@@ -0,0 +1,359 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_replayer.h"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "common/config.h"
+#include "common/logging.h"
+#include "env/env.h"
+#include "gen_cpp/DataSinks_types.h"
+#include "gen_cpp/RuntimeProfile_types.h"
+#include "gutil/strings/numbers.h"
+#include "gutil/strings/split.h"
+#include "gutil/strings/substitute.h"
+#include "gutil/strings/util.h"
+#include "runtime/exec_env.h"
+#include "runtime/fragment_mgr.h"
+#include "runtime/plan_fragment_executor.h"
+#include "runtime/result_buffer_mgr.h"
+#include "service/backend_options.h"
+#include "util/file_utils.h"
+#include "util/runtime_profile.h"
+#include "util/stopwatch.hpp"
+#include "util/thrift_util.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+static const std::string kCaptureSuffix = ".thrift";
+static const int64_t kDefaultReplayTimeoutSec = 300;
+
+namespace {
+
+// the state shared by the callbacks of the replayed fragments
+struct ReplayState {
+    std::mutex lock;
+    std::condition_variable cv;
+    int unfinished = 0;
+    Status status;
+    // "<operator>\t<counter>" -> the value summed over the instances
+    std::map<std::string, int64_t> counters;
+};
+
+// Sum the counters of the profile tree flattened in pre-order into `counters`, the operators
+// are named by their path from the root, and the root is named by `root_name`.
+void collect_counters(const std::vector<TRuntimeProfileNode>& nodes,
+                      const std::string& root_name, std::map<std::string, int64_t>* counters) {
+    // the path from the root to the current node, with the children not visited yet
+    std::vector<std::pair<std::string, int>> path;
+    for (const auto& node : nodes) {
+        while (!path.empty() && path.back().second == 0) {
+            path.pop_back();
+        }
+        std::string name = root_name;
+        if (!path.empty()) {
+            name = path.back().first + "/" + node.name;
+            --path.back().second;
+        }
+        for (const auto& counter : node.counters) {
+            (*counters)[name + "\t" + counter.name] += counter.value;
+        }
+        path.emplace_back(std::move(name), node.num_children);
+    }
+}
+
+// "<operator>\t<counter>\t<value>" lines -> value
+void parse_profile(const std::string& profile, std::map<std::string, int64_t>* counters) {
+    std::vector<std::string> lines = strings::Split(profile, "\n", strings::SkipWhitespace());
+    for (const auto& line : lines) {
+        if (line[0] == '#') {
+            continue;
+        }
+        size_t pos = line.rfind('\t');
+        int64_t value = 0;
+        if (pos == std::string::npos || !safe_strto64(line.substr(pos + 1), &value)) {
+            continue;
+        }
+        (*counters)[line.substr(0, pos)] = value;
+    }
+}
+
+} // namespace
+
+void QueryReplayer::capture(const TExecPlanFragmentParams& params) {
+    if (!config::enable_query_capture) {
+        return;
+    }
+    const TUniqueId& query_id = params.params.query_id;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_replaying_queries.count(query_id) > 0) {
+            return;
+        }
+    }
+    // the simplified params of the later fragments don't carry the query options, they are
+    // captured if the first fragment of the query is captured
+    std::string dir = strings::Substitute("$0/$1", config::query_capture_dir, print_id(query_id));
+    if (params.__isset.query_options) {
+        if (params.query_options.query_type != TQueryType::SELECT) {
+            return;
+        }
+        Status st = FileUtils::create_dir(dir);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to create the query capture dir " << dir << ": "
+                         << st.to_string();
+            return;
+        }
+    } else if (!FileUtils::check_exist(dir)) {
+        return;
+    }
+
+    std::string buf;
+    ThriftSerializer serializer(false, 4096);
+    Status st = serializer.serialize(const_cast<TExecPlanFragmentParams*>(&params), &buf);
+    if (!st.ok()) {
+        LOG(WARNING) << "failed to serialize the fragment params of query " << print_id(query_id)
+                     << ": " << st.to_string();
+        return;
+    }
+    std::string path = fmt::format("{}/{:010d}_{}{}", dir, _capture_seq.fetch_add(1),
+                                   print_id(params.params.fragment_instance_id), kCaptureSuffix);
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(buf.data(), buf.size());
+    file.close();
+    if (file.fail()) {
+        LOG(WARNING) << "failed to write the captured fragment " << path;
+    }
+}
+
+Status QueryReplayer::replay(const std::string& query_id, std::string* profile) {
+    std::string dir = strings::Substitute("$0/$1", config::query_capture_dir, query_id);
+    std::vector<std::string> files;
+    RETURN_IF_ERROR(FileUtils::list_files(Env::Default(), dir, &files));
+    files.erase(std::remove_if(files.begin(), files.end(),
+                               [](const std::string& name) {
+                                   return !HasSuffixString(name, kCaptureSuffix);
+                               }),
+                files.end());
+    if (files.empty()) {
+        return Status::NotFound(strings::Substitute("no captured fragment of query $0", query_id));
+    }
+    // the names start with the capture sequence
+    std::sort(files.begin(), files.end());
+
+    std::vector<TExecPlanFragmentParams> fragments(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        std::string path = dir + "/" + files[i];
+        std::ifstream file(path, std::ios::binary);
+        std::stringstream buf;
+        buf << file.rdbuf();
+        if (file.fail()) {
+            return Status::IOError(strings::Substitute("failed to read $0", path));
+        }
+        std::string data = buf.str();
+        uint32_t len = data.size();
+        RETURN_IF_ERROR(deserialize_thrift_msg(reinterpret_cast<const uint8_t*>(data.data()),
+                                               &len, false, &fragments[i]));
+    }
+
+    // Run as a new query, the instance ids keep their offsets to the query id, and the exchanges
+    // and the runtime filters go to this backend.
+    const TUniqueId old_query_id = fragments[0].params.query_id;
+    const TUniqueId new_query_id = UniqueId::gen_uid().to_thrift();
+    auto remap = [&](const TUniqueId& id) {
+        TUniqueId new_id;
+        new_id.__set_hi(new_query_id.hi);
+        new_id.__set_lo(new_query_id.lo + (id.lo - old_query_id.lo));
+        return new_id;
+    };
+    TNetworkAddress be_addr;
+    be_addr.__set_hostname(BackendOptions::get_localhost());
+    be_addr.__set_port(config::be_port);
+    TNetworkAddress brpc_addr;
+    brpc_addr.__set_hostname(BackendOptions::get_localhost());
+    brpc_addr.__set_port(config::brpc_port);
+
+    int64_t timeout_sec = kDefaultReplayTimeoutSec;
+    std::vector<TUniqueId> result_instances;
+    for (auto& params : fragments) {
+        if (params.params.query_id != old_query_id) {
+            return Status::InternalError(strings::Substitute(
+                    "the captured fragments of $0 belong to different queries", query_id));
+        }
+        params.params.__set_query_id(new_query_id);
+        params.params.__set_fragment_instance_id(remap(params.params.fragment_instance_id));
+        for (auto& dest : params.params.destinations) {
+            dest.__set_fragment_instance_id(remap(dest.fragment_instance_id));
+            dest.__set_server(be_addr);
+            if (dest.__isset.brpc_server) {
+                dest.__set_brpc_server(brpc_addr);
+            }
+        }
+        if (params.params.__isset.runtime_filter_params) {
+            auto& filter_params = params.params.runtime_filter_params;
+            if (filter_params.__isset.runtime_filter_merge_addr) {
+                filter_params.__set_runtime_filter_merge_addr(brpc_addr);
+            }
+            for (auto& [filter_id, targets] : filter_params.rid_to_target_param) {
+                for (auto& target : targets) {
+                    target.__set_target_fragment_instance_id(
+                            remap(target.target_fragment_instance_id));
+                    target.__set_target_fragment_instance_addr(brpc_addr);
+                }
+            }
+        }
+        if (params.__isset.query_options) {
+            // the coordinator doesn't know the replayed query
+            params.query_options.__set_is_report_success(false);
+            if (params.query_options.__isset.query_timeout) {
+                timeout_sec = params.query_options.query_timeout;
+            }
+        }
+        if (params.__isset.fragment && params.fragment.__isset.output_sink &&
+            params.fragment.output_sink.type == TDataSinkType::RESULT_SINK) {
+            result_instances.push_back(params.params.fragment_instance_id);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _replaying_queries.insert(new_query_id);
+    }
+    LOG(INFO) << "replay query " << query_id << " as " << print_id(new_query_id) << ", "
+              << fragments.size() << " fragments";
+    MonotonicStopWatch watch;
+    watch.start();
+    FragmentMgr* fragment_mgr = _exec_env->fragment_mgr();
+    auto state = std::make_shared<ReplayState>();
+    std::vector<TUniqueId> submitted;
+    for (size_t i = 0; i < fragments.size(); ++i) {
+        const auto& params = fragments[i];
+        std::string name = params.__isset.fragment_id
+                                   ? strings::Substitute("Fragment $0", params.fragment_id)
+                                   : strings::Substitute("Fragment #$0", i);
+        {
+            std::lock_guard<std::mutex> l(state->lock);
+            ++state->unfinished;
+        }
+        Status st = fragment_mgr->exec_plan_fragment(
+                params, [state, name](PlanFragmentExecutor* executor) {
+                    TRuntimeProfileTree tree;
+                    executor->profile()->to_thrift(&tree);
+                    std::lock_guard<std::mutex> l(state->lock);
+                    collect_counters(tree.nodes, name, &state->counters);
+                    if (!executor->status().ok() && state->status.ok()) {
+                        state->status = executor->status();
+                    }
+                    --state->unfinished;
+                    state->cv.notify_all();
+                });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(state->lock);
+            --state->unfinished;
+            state->status = st;
+            break;
+        }
+        submitted.push_back(params.params.fragment_instance_id);
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_sec);
+    auto is_finished = [&state]() {
+        std::lock_guard<std::mutex> l(state->lock);
+        return state->unfinished == 0;
+    };
+    // drain the results, the result buffer may not be created yet when the fetch starts
+    int64_t result_rows = 0;
+    for (const auto& instance_id : result_instances) {
+        while (std::chrono::steady_clock::now() < deadline) {
+            TFetchDataResult result;
+            if (_exec_env->result_mgr()->fetch_data(instance_id, &result).ok()) {
+                result_rows += result.result_batch.rows.size();
+                if (result.eos) {
+                    break;
+                }
+            } else if (is_finished()) {
+                break;
+            } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+    }
+
+    Status status;
+    {
+        std::unique_lock<std::mutex> l(state->lock);
+        if (!state->cv.wait_until(l, deadline, [&state]() { return state->unfinished == 0; })) {
+            state->status = Status::TimedOut(
+                    strings::Substitute("replay of query $0 timed out", query_id));
+        }
+        status = state->status;
+    }
+    if (!status.ok()) {
+        for (const auto& instance_id : submitted) {
+            fragment_mgr->cancel(instance_id, PPlanFragmentCancelReason::INTERNAL_ERROR,
+                                 "replay failed");
+        }
+    }
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _replaying_queries.erase(new_query_id);
+    }
+    RETURN_IF_ERROR(status);
+
+    std::lock_guard<std::mutex> l(state->lock);
+    profile->append(
+            strings::Substitute("Query\tTotalTimeMs\t$0\n", watch.elapsed_time() / 1000000));
+    profile->append(strings::Substitute("Query\tResultRows\t$0\n", result_rows));
+    for (const auto& [counter, value] : state->counters) {
+        profile->append(counter).append("\t").append(std::to_string(value)).append("\n");
+    }
+    return Status::OK();
+}
+
+void QueryReplayer::diff_profiles(const std::string& baseline, const std::string& current,
+                                  std::string* diff) {
+    std::map<std::string, int64_t> baseline_counters;
+    std::map<std::string, int64_t> current_counters;
+    parse_profile(baseline, &baseline_counters);
+    parse_profile(current, &current_counters);
+    for (const auto& [counter, value] : current_counters) {
+        auto iter = baseline_counters.find(counter);
+        if (iter == baseline_counters.end() || iter->second == value) {
+            continue;
+        }
+        std::string change = iter->second == 0
+                                     ? "n/a"
+                                     : fmt::format("{:+.1f}%", (value - iter->second) * 100.0 /
+                                                                       iter->second);
+        diff->append(fmt::format("{}\t{}\t{}\t{}\n", counter, iter->second, value, change));
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,73 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+#include "common/status.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+class ExecEnv;
+
+// Capture the fragments of the select queries, and replay them on this backend to compare the
+// per operator profiles between builds.
+//
+// When enable_query_capture is on, the params of every fragment of a select query received by
+// this backend are saved in "<query_capture_dir>/<query id>/", in the order they are received.
+// A replay resubmits the captured fragments as a new query, with the exchange destinations and
+// the runtime filters redirected to this backend, drains the results and sums the counters of
+// every operator over the instances. The tablets scanned by the query must be present on this
+// backend, e.g. restored from the snapshots of the production tablets, and all the fragments of
+// the query must have been captured here, i.e. the query ran on a single backend.
+class QueryReplayer {
+public:
+    explicit QueryReplayer(ExecEnv* exec_env) : _exec_env(exec_env) {}
+
+    // Save the params if enable_query_capture is on and the fragment belongs to a select query,
+    // the errors are only logged.
+    void capture(const TExecPlanFragmentParams& params);
+
+    // Replay the captured query `query_id`, and output its counters to `profile`, one line of
+    // "<operator>\t<counter>\t<value>" per counter.
+    Status replay(const std::string& query_id, std::string* profile);
+
+    // Output the counters whose values differ between the two profiles output by replay(), one
+    // line of "<operator>\t<counter>\t<baseline value>\t<current value>\t<change>" per counter.
+    static void diff_profiles(const std::string& baseline, const std::string& current,
+                              std::string* diff);
+
+private:
+    ExecEnv* _exec_env;
+
+    // the sequence of the captured fragments, to keep them in the order they are received
+    std::atomic<int64_t> _capture_seq {0};
+
+    std::mutex _lock;
+    // the queries being replayed, which are not captured again
+    std::unordered_set<TUniqueId> _replaying_queries;
+};
+
+} // namespace doris
@@ -106,13 +106,7 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
     // copy one
     std::map<int32_t, int64_t> cmt_offset = ctx->kafka_info->cmt_offset;
 
-    //improve performance
-    Status (KafkaConsumerPipe::*append_data)(const char* data, size_t size);
-    if (ctx->format == TFileFormatType::FORMAT_JSON) {
-        append_data = &KafkaConsumerPipe::append_json;
-    } else {
-        append_data = &KafkaConsumerPipe::append_with_line_delimiter;
-    }
+    const bool is_json = ctx->format == TFileFormatType::FORMAT_JSON;
 
     MonotonicStopWatch watch;
     watch.start();
@@ -156,14 +150,23 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
                         << ", partition: " << msg->partition() << ", offset: " << msg->offset()
                         << ", len: " << msg->len();
 
-            Status st = (kafka_pipe.get()->*append_data)(static_cast<const char*>(msg->payload()),
-                                                         static_cast<size_t>(msg->len()));
+            int32_t partition = msg->partition();
+            int64_t offset = msg->offset();
+            size_t len = msg->len();
+            Status st;
+            if (is_json) {
+                // the json messages are passed to the parser by reference, the pipe owns them
+                st = kafka_pipe->append_json(msg);
+            } else {
+                st = kafka_pipe->append_with_line_delimiter(
+                        static_cast<const char*>(msg->payload()), len);
+                delete msg;
+            }
             if (st.ok()) {
                 left_rows--;
-                left_bytes -= msg->len();
-                cmt_offset[msg->partition()] = msg->offset();
-                VLOG_NOTICE << "consume partition[" << msg->partition() << " - " << msg->offset()
-                            << "]";
+                left_bytes -= len;
+                cmt_offset[partition] = offset;
+                VLOG_NOTICE << "consume partition[" << partition << " - " << offset << "]";
             } else {
                 // failed to append this msg, we must stop
                 LOG(WARNING) << "failed to append msg to pipe. grp: " << _grp_id;
@@ -175,7 +178,6 @@ Status KafkaDataConsumerGroup::start_all(StreamLoadContext* ctx) {
                     }
                 }
             }
-            delete msg;
         } else {
             // queue is empty and shutdown
             eos = true;
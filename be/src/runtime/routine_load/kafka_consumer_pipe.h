@@ -25,6 +25,7 @@
 
 #include "exec/file_reader.h"
 #include "librdkafka/rdkafka.h"
+#include "librdkafka/rdkafkacpp.h"
 #include "runtime/message_body_sink.h"
 #include "runtime/stream_load/stream_load_pipe.h"
 
@@ -48,7 +49,12 @@ public:
         return st;
     }
 
-    Status append_json(const char* data, size_t size) { return append_and_flush(data, size); }
+    // Append the json message by reference to its payload without copying it. The pipe takes the
+    // ownership of the message, which is deleted once the message is read or the pipe is released.
+    Status append_json(RdKafka::Message* msg) {
+        std::shared_ptr<RdKafka::Message> owner(msg);
+        return append(ByteBuffer::wrap(static_cast<char*>(msg->payload()), msg->len(), owner));
+    }
 };
 
 } // end namespace doris
@@ -25,6 +25,7 @@
 #include <sstream>
 #include <string>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "common/object_pool.h"
 #include "common/status.h"
@@ -38,6 +39,7 @@
 #include "runtime/mem_tracker.h"
 #include "runtime/mem_tracker_task_pool.h"
 #include "runtime/runtime_filter_mgr.h"
+#include "runtime/workload_group.h"
 #include "util/file_utils.h"
 #include "util/load_error_hub.h"
 #include "util/pretty_printer.h"
@@ -183,6 +185,12 @@ Status RuntimeState::init(const TUniqueId& fragment_instance_id, const TQueryOpt
 
     _exec_env = exec_env;
 
+    // the unknown groups are rejected by FragmentMgr before the fragment is prepared
+    if (_query_options.__isset.workload_group && _exec_env != nullptr &&
+        _exec_env->workload_group_mgr() != nullptr) {
+        _workload_group = _exec_env->workload_group_mgr()->get_group(_query_options.workload_group);
+    }
+
     if (_query_options.max_errors <= 0) {
         // TODO: fix linker error and uncomment this
         //_query_options.max_errors = config::max_errors;
@@ -193,6 +201,10 @@ Status RuntimeState::init(const TUniqueId& fragment_instance_id, const TQueryOpt
         _query_options.batch_size = DEFAULT_BATCH_SIZE;
     }
 
+    if (enable_hardware_counters()) {
+        _hardware_counters.reset(new HardwareCounters(&_profile, nullptr, "Fragment"));
+    }
+
     _db_name = "insert_stmt";
     _import_label = print_id(fragment_instance_id);
 
@@ -216,7 +228,8 @@ Status RuntimeState::init_mem_trackers(const TUniqueId& query_id) {
     if (query_type() == TQueryType::SELECT) {
         _query_mem_tracker =
                 _exec_env->task_pool_mem_tracker_registry()->register_query_mem_tracker(
-                        print_id(query_id), bytes_limit);
+                        print_id(query_id), bytes_limit,
+                        _workload_group ? _workload_group->mem_tracker() : nullptr);
     } else if (query_type() == TQueryType::LOAD) {
         _query_mem_tracker = _exec_env->task_pool_mem_tracker_registry()->register_load_mem_tracker(
                 print_id(query_id), bytes_limit);
@@ -388,6 +401,7 @@ Status RuntimeState::append_error_msg_to_file(std::function<std::string()> line,
     if (query_type() != TQueryType::LOAD) {
         return Status::OK();
     }
+    std::lock_guard<std::mutex> l(_error_log_file_lock);
     // If file havn't been opened, open it here
     if (_error_log_file == nullptr) {
         Status status = create_error_log_file();
@@ -466,4 +480,11 @@ int64_t RuntimeState::get_load_mem_limit() {
     }
 }
 
+int64_t RuntimeState::preferred_block_size_bytes() const {
+    if (_query_options.__isset.preferred_block_size_bytes) {
+        return _query_options.preferred_block_size_bytes;
+    }
+    return config::preferred_block_size_bytes;
+}
+
 } // end namespace doris
@@ -60,6 +60,7 @@ class ReservationTracker;
 class InitialReservations;
 class RowDescriptor;
 class RuntimeFilterMgr;
+class WorkloadGroup;
 
 // A collection of items that are part of the global state of a
 // query and shared across all execution nodes of that query.
@@ -126,6 +127,8 @@ public:
     ExecEnv* exec_env() { return _exec_env; }
     std::shared_ptr<MemTracker> query_mem_tracker() { return _query_mem_tracker; }
     std::shared_ptr<MemTracker> instance_mem_tracker() { return _instance_mem_tracker; }
+    // nullptr if the query doesn't run in a workload group
+    const std::shared_ptr<WorkloadGroup>& workload_group() const { return _workload_group; }
     ThreadResourceMgr::ResourcePool* resource_pool() { return _resource_pool; }
 
     void set_fragment_root_id(PlanNodeId id) {
@@ -140,6 +143,8 @@ public:
     // Returns runtime state profile
     RuntimeProfile* runtime_profile() { return &_profile; }
 
+    HardwareCounters* hardware_counters() { return _hardware_counters.get(); }
+
     // Returns true if codegen is enabled for this query.
     bool codegen_enabled() const { return !_query_options.disable_codegen; }
 
@@ -181,9 +186,9 @@ public:
     // _unreported_error_idx to _errors_log.size()
     void get_unreported_errors(std::vector<std::string>* new_errors);
 
-    bool is_cancelled() const { return _is_cancelled; }
+    bool is_cancelled() const { return _is_cancelled.load(std::memory_order_relaxed); }
     int codegen_level() const { return _query_options.codegen_level; }
-    void set_is_cancelled(bool v) { _is_cancelled = v; }
+    void set_is_cancelled(bool v) { _is_cancelled.store(v, std::memory_order_relaxed); }
 
     void set_backend_id(int64_t backend_id) { _backend_id = backend_id; }
     int64_t backend_id() const { return _backend_id; }
@@ -321,12 +326,29 @@ public:
 
     bool enable_spill() const { return _query_options.enable_spilling; }
 
+    // Set by the query memory arbitrator of FragmentMgr under memory pressure, the operators
+    // which support spilling spill their data while it's set.
+    void set_spill_requested(bool requested) {
+        _spill_requested.store(requested, std::memory_order_relaxed);
+    }
+    bool is_spill_requested() const { return _spill_requested.load(std::memory_order_relaxed); }
+
     int32_t runtime_filter_wait_time_ms() { return _query_options.runtime_filter_wait_time_ms; }
 
     int32_t runtime_filter_max_in_num() { return _query_options.runtime_filter_max_in_num; }
 
     bool enable_vectorized_exec() const { return _query_options.enable_vectorized_engine; }
 
+    bool enable_pipeline_exec() const {
+        return _query_options.__isset.enable_pipeline_engine &&
+               _query_options.enable_pipeline_engine;
+    }
+
+    bool enable_share_hash_table_for_broadcast_join() const {
+        return _query_options.__isset.enable_share_hash_table_for_broadcast_join &&
+               _query_options.enable_share_hash_table_for_broadcast_join;
+    }
+
     bool return_object_data_as_binary() const {
         return _query_options.return_object_data_as_binary;
     }
@@ -335,6 +357,14 @@ public:
         return _query_options.enable_enable_exchange_node_parallel_merge;
     }
 
+    bool enable_hardware_counters() const {
+        return _query_options.__isset.enable_hardware_counters &&
+               _query_options.enable_hardware_counters;
+    }
+
+    // the preferred bytes of the blocks sized by the observed row width, 0 to use batch_size()
+    int64_t preferred_block_size_bytes() const;
+
     // the following getters are only valid after Prepare()
     InitialReservations* initial_reservations() const { return _initial_reservations; }
 
@@ -377,12 +407,18 @@ private:
     // The query mem tracker must be released after the _instance_mem_tracker.
     std::shared_ptr<MemTracker> _query_mem_tracker;
 
+    // the workload group named by the query option workload_group
+    std::shared_ptr<WorkloadGroup> _workload_group;
+
     // Memory usage of this fragment instance
     std::shared_ptr<MemTracker> _instance_mem_tracker;
 
     // put runtime state before _obj_pool, so that it will be deconstructed after
     // _obj_pool. Because some of object in _obj_pool will use profile when deconstructing.
     RuntimeProfile _profile;
+    // the hardware events of the exec nodes and the sink of this fragment instance, only with
+    // the query option enable_hardware_counters
+    std::unique_ptr<HardwareCounters> _hardware_counters;
 
     DescriptorTbl* _desc_tbl;
     std::shared_ptr<ObjectPool> _obj_pool;
@@ -426,8 +462,9 @@ private:
     // state is responsible for returning this pool to the thread mgr.
     ThreadResourceMgr::ResourcePool* _resource_pool;
 
-    // if true, execution should stop with a CANCELLED status
-    bool _is_cancelled;
+    // if true, execution should stop with a CANCELLED status.
+    // It's set by the cancelling thread and polled by the long loops of the other threads.
+    std::atomic<bool> _is_cancelled;
 
     int _per_fragment_instance_idx;
     int _num_per_fragment_instances = 0;
@@ -468,6 +505,8 @@ private:
 
     std::atomic<int64_t> _num_bytes_load_total; // total bytes read from source
 
+    std::atomic<bool> _spill_requested {false};
+
     std::vector<std::string> _export_output_files;
 
     std::string _import_label;
@@ -481,6 +520,8 @@ private:
     int64_t _error_row_number;
     std::string _error_log_file_path;
     std::ofstream* _error_log_file = nullptr; // error file path, absolute path
+    // the scanners of a load may append the error messages in parallel
+    std::mutex _error_log_file_lock;
     std::unique_ptr<LoadErrorHub> _error_hub;
     std::mutex _create_error_hub_lock;
     std::vector<TTabletCommitInfo> _tablet_commit_infos;
@@ -19,6 +19,12 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <mutex>
+
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "gen_cpp/FrontendService.h"
@@ -35,10 +41,17 @@
 #include "util/broker_storage_backend.h"
 #include "util/file_utils.h"
 #include "util/s3_storage_backend.h"
+#include "util/threadpool.h"
 #include "util/thrift_rpc_helper.h"
 
 namespace doris {
 
+#ifdef BE_TEST
+// the status returned by the reports to frontend, and the number of the reports
+TStatus k_snapshot_loader_report_status;
+int k_snapshot_loader_report_count = 0;
+#endif
+
 SnapshotLoader::SnapshotLoader(ExecEnv* env, int64_t job_id, int64_t task_id,
                                const TNetworkAddress& broker_addr,
                                const std::map<std::string, std::string>& broker_prop)
@@ -82,16 +95,13 @@ Status SnapshotLoader::upload(const std::map<std::string, std::string>& src_to_d
     int tmp_counter = 1;
     RETURN_IF_ERROR(_report_every(0, &tmp_counter, 0, 0, TTaskType::type::UPLOAD));
 
-    Status status = Status::OK();
     // 1. validate local tablet snapshot paths
     RETURN_IF_ERROR(_check_local_snapshot_paths(src_to_dest_path, true));
 
-    // 2. for each src path, upload it to remote storage
-    // we report to frontend for every 10 files, and we will cancel the job if
+    // 2. for each src path, upload its files to remote storage by the transfer threads,
+    // and we report to frontend for every file, and we will cancel the job if
     // the job has already been cancelled in frontend.
-    int report_counter = 0;
-    int total_num = src_to_dest_path.size();
-    int finished_num = 0;
+    std::vector<std::function<Status()>> tasks;
     for (auto iter = src_to_dest_path.begin(); iter != src_to_dest_path.end(); iter++) {
         const std::string& src_path = iter->first;
         const std::string& dest_path = iter->second;
@@ -102,72 +112,33 @@ Status SnapshotLoader::upload(const std::map<std::string, std::string>& src_to_d
                 _get_tablet_id_and_schema_hash_from_file_path(src_path, &tablet_id, &schema_hash));
 
         // 2.1 get existing files from remote path
-        std::map<std::string, FileStat> remote_files;
-        RETURN_IF_ERROR(_storage_backend->list(dest_path, true, false, &remote_files));
+        auto remote_files = std::make_shared<std::map<std::string, FileStat>>();
+        RETURN_IF_ERROR(_storage_backend->list(dest_path, true, false, remote_files.get()));
 
-        for (auto& tmp : remote_files) {
+        for (auto& tmp : *remote_files) {
             VLOG_CRITICAL << "get remote file: " << tmp.first << ", checksum: " << tmp.second.md5;
         }
 
         // 2.2 list local files
         std::vector<std::string> local_files;
-        std::vector<std::string> local_files_with_checksum;
         RETURN_IF_ERROR(_get_existing_files_from_local(src_path, &local_files));
 
-        // 2.3 iterate local files
-        for (auto it = local_files.begin(); it != local_files.end(); it++) {
-            RETURN_IF_ERROR(_report_every(10, &report_counter, finished_num, total_num,
-                                          TTaskType::type::UPLOAD));
-
-            const std::string& local_file = *it;
-            // calc md5sum of localfile
-            std::string md5sum;
-            status = FileUtils::md5sum(src_path + "/" + local_file, &md5sum);
-            if (!status.ok()) {
-                std::stringstream ss;
-                ss << "failed to get md5sum of file: " << local_file << ": "
-                   << status.get_error_msg();
-                LOG(WARNING) << ss.str();
-                return Status::InternalError(ss.str());
-            }
-            VLOG_CRITICAL << "get file checksum: " << local_file << ": " << md5sum;
-            local_files_with_checksum.push_back(local_file + "." + md5sum);
-
-            // check if this local file need upload
-            bool need_upload = false;
-            auto find = remote_files.find(local_file);
-            if (find != remote_files.end()) {
-                if (md5sum != find->second.md5) {
-                    // remote storage file exist, but with different checksum
-                    LOG(WARNING) << "remote file checksum is invalid. remote: " << find->first
-                                 << ", local: " << md5sum;
-                    // TODO(cmy): save these files and delete them later
-                    need_upload = true;
-                }
-            } else {
-                need_upload = true;
-            }
-
-            if (!need_upload) {
-                VLOG_CRITICAL << "file exist in remote path, no need to upload: " << local_file;
-                continue;
-            }
-
-            // upload
-            std::string full_remote_file = dest_path + "/" + local_file;
-            std::string full_local_file = src_path + "/" + local_file;
-            RETURN_IF_ERROR(_storage_backend->upload_with_checksum(full_local_file,
-                                                                   full_remote_file, md5sum));
-        } // end for each tablet's local files
-
-        tablet_files->emplace(tablet_id, local_files_with_checksum);
-        finished_num++;
-        LOG(INFO) << "finished to write tablet to remote. local path: " << src_path
-                  << ", remote path: " << dest_path;
+        // 2.3 upload each local file, the files with checksum are filled by the tasks
+        std::vector<std::string>& local_files_with_checksum = (*tablet_files)[tablet_id];
+        local_files_with_checksum.resize(local_files.size());
+        for (size_t i = 0; i < local_files.size(); ++i) {
+            tasks.emplace_back([this, src_path, dest_path, remote_files,
+                                local_file = local_files[i],
+                                file_with_checksum = &local_files_with_checksum[i]]() {
+                return _upload_file(src_path, dest_path, local_file, *remote_files,
+                                    file_with_checksum);
+            });
+        }
     } // end for each tablet path
+    RETURN_IF_ERROR(_transfer_files(tasks, TTaskType::type::UPLOAD));
 
     LOG(INFO) << "finished to upload snapshots. job: " << _job_id << ", task id: " << _task_id;
-    return status;
+    return Status::OK();
 }
 
 /*
@@ -188,14 +159,11 @@ Status SnapshotLoader::download(const std::map<std::string, std::string>& src_to
     int tmp_counter = 1;
     RETURN_IF_ERROR(_report_every(0, &tmp_counter, 0, 0, TTaskType::type::DOWNLOAD));
 
-    Status status = Status::OK();
     // 1. validate local tablet snapshot paths
     RETURN_IF_ERROR(_check_local_snapshot_paths(src_to_dest_path, false));
 
-    // 2. for each src path, download it to local storage
-    int report_counter = 0;
-    int total_num = src_to_dest_path.size();
-    int finished_num = 0;
+    // 2. for each src path, download its files to local storage by the transfer threads
+    std::vector<std::function<Status()>> tasks;
     for (auto iter = src_to_dest_path.begin(); iter != src_to_dest_path.end(); iter++) {
         const std::string& remote_path = iter->first;
         const std::string& local_path = iter->second;
@@ -213,8 +181,8 @@ Status SnapshotLoader::download(const std::map<std::string, std::string>& src_to
                       << ", remote tablet id: " << remote_tablet_id;
 
         // 2.1. get local files
-        std::vector<std::string> local_files;
-        RETURN_IF_ERROR(_get_existing_files_from_local(local_path, &local_files));
+        auto local_files = std::make_shared<std::vector<std::string>>();
+        RETURN_IF_ERROR(_get_existing_files_from_local(local_path, local_files.get()));
 
         // 2.2. get remote files
         std::map<std::string, FileStat> remote_files;
@@ -236,92 +204,9 @@ Status SnapshotLoader::download(const std::map<std::string, std::string>& src_to
         }
         DataDir* data_dir = tablet->data_dir();
 
-        for (auto& iter : remote_files) {
-            RETURN_IF_ERROR(_report_every(10, &report_counter, finished_num, total_num,
-                                          TTaskType::type::DOWNLOAD));
-
-            bool need_download = false;
-            const std::string& remote_file = iter.first;
-            const FileStat& file_stat = iter.second;
-            auto find = std::find(local_files.begin(), local_files.end(), remote_file);
-            if (find == local_files.end()) {
-                // remote file does not exist in local, download it
-                need_download = true;
-            } else {
-                if (_end_with(remote_file, ".hdr")) {
-                    // this is a header file, download it.
-                    need_download = true;
-                } else {
-                    // check checksum
-                    std::string local_md5sum;
-                    Status st = FileUtils::md5sum(local_path + "/" + remote_file, &local_md5sum);
-                    if (!st.ok()) {
-                        LOG(WARNING) << "failed to get md5sum of local file: " << remote_file
-                                     << ". msg: " << st.get_error_msg() << ". download it";
-                        need_download = true;
-                    } else {
-                        VLOG_CRITICAL << "get local file checksum: " << remote_file << ": "
-                                      << local_md5sum;
-                        if (file_stat.md5 != local_md5sum) {
-                            // file's checksum does not equal, download it.
-                            need_download = true;
-                        }
-                    }
-                }
-            }
-
-            if (!need_download) {
-                LOG(INFO) << "remote file already exist in local, no need to download."
-                          << ", file: " << remote_file;
-                continue;
-            }
-
-            // begin to download
-            std::string full_remote_file = remote_path + "/" + remote_file + "." + file_stat.md5;
-            std::string local_file_name;
-            // we need to replace the tablet_id in remote file name with local tablet id
-            RETURN_IF_ERROR(_replace_tablet_id(remote_file, local_tablet_id, &local_file_name));
-            std::string full_local_file = local_path + "/" + local_file_name;
-            LOG(INFO) << "begin to download from " << full_remote_file << " to " << full_local_file;
-            size_t file_len = file_stat.size;
-
-            // check disk capacity
-            if (data_dir->reach_capacity_limit(file_len)) {
-                return Status::InternalError("capacity limit reached");
-            }
-            // remove file which will be downloaded now.
-            // this file will be added to local_files if it be downloaded successfully.
-            local_files.erase(find);
-            RETURN_IF_ERROR(_storage_backend->download(full_remote_file, full_local_file));
-
-            // 3. check md5 of the downloaded file
-            std::string downloaded_md5sum;
-            status = FileUtils::md5sum(full_local_file, &downloaded_md5sum);
-            if (!status.ok()) {
-                std::stringstream ss;
-                ss << "failed to get md5sum of file: " << full_local_file
-                   << ", err: " << status.get_error_msg();
-                LOG(WARNING) << ss.str();
-                return Status::InternalError(ss.str());
-            }
-            VLOG_CRITICAL << "get downloaded file checksum: " << full_local_file << ": "
-                          << downloaded_md5sum;
-            if (downloaded_md5sum != file_stat.md5) {
-                std::stringstream ss;
-                ss << "invalid md5 of downloaded file: " << full_local_file
-                   << ", expected: " << file_stat.md5 << ", get: " << downloaded_md5sum;
-                LOG(WARNING) << ss.str();
-                return Status::InternalError(ss.str());
-            }
-
-            // local_files always keep the updated local files
-            local_files.push_back(local_file_name);
-            LOG(INFO) << "finished to download file via broker. file: " << full_local_file
-                      << ", length: " << file_len;
-        } // end for all remote files
-
-        // finally, delete local files which are not in remote
-        for (const auto& local_file : local_files) {
+        // 2.3. delete local files which are not in remote, the downloaded files are all in
+        // remote, so it doesn't matter whether they are downloaded before or after this.
+        for (const auto& local_file : *local_files) {
             // replace the tablet id in local file name with the remote tablet id,
             // in order to compare the file name.
             std::string new_name;
@@ -347,11 +232,20 @@ Status SnapshotLoader::download(const std::map<std::string, std::string>& src_to
             }
         }
 
-        finished_num++;
+        // 2.4. download each remote file
+        for (const auto& [remote_file, file_stat] : remote_files) {
+            tasks.emplace_back([this, remote_path, local_path, remote_file = remote_file,
+                                file_stat = file_stat, local_files, local_tablet_id,
+                                data_dir]() {
+                return _download_file(remote_path, local_path, remote_file, file_stat,
+                                      *local_files, local_tablet_id, data_dir);
+            });
+        }
     } // end for src_to_dest_path
+    RETURN_IF_ERROR(_transfer_files(tasks, TTaskType::type::DOWNLOAD));
 
     LOG(INFO) << "finished to download snapshots. job: " << _job_id << ", task id: " << _task_id;
-    return status;
+    return Status::OK();
 }
 
 // move the snapshot files in snapshot_path
@@ -594,6 +488,160 @@ Status SnapshotLoader::_get_tablet_id_from_remote_path(const std::string& remote
     return Status::OK();
 }
 
+Status SnapshotLoader::_upload_file(const std::string& src_path, const std::string& dest_path,
+                                    const std::string& local_file,
+                                    const std::map<std::string, FileStat>& remote_files,
+                                    std::string* file_with_checksum) {
+    // calc md5sum of localfile
+    std::string md5sum;
+    Status status = FileUtils::md5sum(src_path + "/" + local_file, &md5sum);
+    if (!status.ok()) {
+        std::stringstream ss;
+        ss << "failed to get md5sum of file: " << local_file << ": " << status.get_error_msg();
+        LOG(WARNING) << ss.str();
+        return Status::InternalError(ss.str());
+    }
+    VLOG_CRITICAL << "get file checksum: " << local_file << ": " << md5sum;
+    *file_with_checksum = local_file + "." + md5sum;
+
+    // check if this local file need upload
+    auto find = remote_files.find(local_file);
+    if (find != remote_files.end()) {
+        if (md5sum == find->second.md5) {
+            VLOG_CRITICAL << "file exist in remote path, no need to upload: " << local_file;
+            return Status::OK();
+        }
+        // remote storage file exist, but with different checksum
+        LOG(WARNING) << "remote file checksum is invalid. remote: " << find->first
+                     << ", local: " << md5sum;
+        // TODO(cmy): save these files and delete them later
+    }
+
+    // upload
+    std::string full_remote_file = dest_path + "/" + local_file;
+    std::string full_local_file = src_path + "/" + local_file;
+    return _storage_backend->upload_with_checksum(full_local_file, full_remote_file, md5sum);
+}
+
+Status SnapshotLoader::_download_file(const std::string& remote_path,
+                                      const std::string& local_path,
+                                      const std::string& remote_file, const FileStat& file_stat,
+                                      const std::vector<std::string>& local_files,
+                                      int64_t local_tablet_id, DataDir* data_dir) {
+    bool need_download = false;
+    auto find = std::find(local_files.begin(), local_files.end(), remote_file);
+    if (find == local_files.end()) {
+        // remote file does not exist in local, download it
+        need_download = true;
+    } else {
+        if (_end_with(remote_file, ".hdr")) {
+            // this is a header file, download it.
+            need_download = true;
+        } else {
+            // check checksum
+            std::string local_md5sum;
+            Status st = FileUtils::md5sum(local_path + "/" + remote_file, &local_md5sum);
+            if (!st.ok()) {
+                LOG(WARNING) << "failed to get md5sum of local file: " << remote_file
+                             << ". msg: " << st.get_error_msg() << ". download it";
+                need_download = true;
+            } else {
+                VLOG_CRITICAL << "get local file checksum: " << remote_file << ": "
+                              << local_md5sum;
+                if (file_stat.md5 != local_md5sum) {
+                    // file's checksum does not equal, download it.
+                    need_download = true;
+                }
+            }
+        }
+    }
+
+    if (!need_download) {
+        LOG(INFO) << "remote file already exist in local, no need to download."
+                  << ", file: " << remote_file;
+        return Status::OK();
+    }
+
+    // begin to download
+    std::string full_remote_file = remote_path + "/" + remote_file + "." + file_stat.md5;
+    std::string local_file_name;
+    // we need to replace the tablet_id in remote file name with local tablet id
+    RETURN_IF_ERROR(_replace_tablet_id(remote_file, local_tablet_id, &local_file_name));
+    std::string full_local_file = local_path + "/" + local_file_name;
+    LOG(INFO) << "begin to download from " << full_remote_file << " to " << full_local_file;
+    size_t file_len = file_stat.size;
+
+    // check disk capacity
+    if (data_dir->reach_capacity_limit(file_len)) {
+        return Status::InternalError("capacity limit reached");
+    }
+
+    // the md5 is computed while downloading
+    std::string downloaded_md5sum;
+    Status status = _storage_backend->download_with_md5(full_remote_file, full_local_file,
+                                                        &downloaded_md5sum);
+    if (!status.ok()) {
+        std::stringstream ss;
+        ss << "failed to download file: " << full_local_file << ", err: " << status.get_error_msg();
+        LOG(WARNING) << ss.str();
+        return Status::InternalError(ss.str());
+    }
+    VLOG_CRITICAL << "get downloaded file checksum: " << full_local_file << ": "
+                  << downloaded_md5sum;
+    if (downloaded_md5sum != file_stat.md5) {
+        std::stringstream ss;
+        ss << "invalid md5 of downloaded file: " << full_local_file
+           << ", expected: " << file_stat.md5 << ", get: " << downloaded_md5sum;
+        LOG(WARNING) << ss.str();
+        return Status::InternalError(ss.str());
+    }
+    LOG(INFO) << "finished to download file. file: " << full_local_file
+              << ", length: " << file_len;
+    return Status::OK();
+}
+
+Status SnapshotLoader::_transfer_files(const std::vector<std::function<Status()>>& tasks,
+                                       TTaskType::type type) {
+    std::unique_ptr<ThreadPool> pool;
+    RETURN_IF_ERROR(ThreadPoolBuilder("SnapshotTransferPool")
+                            .set_min_threads(1)
+                            .set_max_threads(std::max(1, config::snapshot_transfer_parallelism))
+                            .build(&pool));
+    std::mutex lock;
+    Status status;
+    int finished_num = 0;
+    int total_num = tasks.size();
+    for (const auto& task : tasks) {
+        Status st = pool->submit_func([this, &task, &lock, &status, &finished_num, total_num,
+                                       type]() {
+            {
+                std::lock_guard<std::mutex> l(lock);
+                if (!status.ok()) {
+                    return;
+                }
+            }
+            Status task_status = task();
+            std::lock_guard<std::mutex> l(lock);
+            if (task_status.ok()) {
+                // report the progress of every file, which also checks whether the job is
+                // cancelled in frontend
+                int counter = 0;
+                task_status = _report_every(0, &counter, ++finished_num, total_num, type);
+            }
+            if (!task_status.ok() && status.ok()) {
+                status = task_status;
+            }
+        });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(lock);
+            status = st;
+            break;
+        }
+    }
+    pool->wait();
+    return status;
+}
+
 // only return CANCELLED if FE return that job is cancelled.
 // otherwise, return OK
 Status SnapshotLoader::_report_every(int report_threshold, int* counter, int32_t finished_num,
@@ -616,12 +664,18 @@ Status SnapshotLoader::_report_every(int report_threshold, int* counter, int32_t
     request.__set_total_num(total_num);
     TStatus report_st;
 
+#ifndef BE_TEST
     Status rpcStatus = ThriftRpcHelper::rpc<FrontendServiceClient>(
             master_addr.hostname, master_addr.port,
             [&request, &report_st](FrontendServiceConnection& client) {
                 client->snapshotLoaderReport(report_st, request);
             },
             10000);
+#else
+    Status rpcStatus = Status::OK();
+    report_st = k_snapshot_loader_report_status;
+    ++k_snapshot_loader_report_count;
+#endif
 
     if (!rpcStatus.ok()) {
         // rpc failed, ignore
@@ -20,6 +20,7 @@
 
 #include <stdint.h>
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -49,6 +50,9 @@ struct FileStat;
  * to local snapshot dir via broker.
  * It will also only download files which does not exist in local dir.
  *
+ * The files are uploaded and downloaded by snapshot_transfer_parallelism
+ * threads, and the progress is reported to frontend after each file.
+ *
  * Move:
  * move() is the final step of restore process. it will replace the 
  * old tablet data dir with the newly downloaded snapshot dir.
@@ -91,6 +95,25 @@ private:
 
     Status _get_tablet_id_from_remote_path(const std::string& remote_path, int64_t* tablet_id);
 
+    // Upload a local file if it doesn't exist in remote with the same checksum, and output its
+    // name with the checksum.
+    Status _upload_file(const std::string& src_path, const std::string& dest_path,
+                        const std::string& local_file,
+                        const std::map<std::string, FileStat>& remote_files,
+                        std::string* file_with_checksum);
+
+    // Download a remote file if it doesn't exist in local with the same checksum.
+    Status _download_file(const std::string& remote_path, const std::string& local_path,
+                          const std::string& remote_file, const FileStat& file_stat,
+                          const std::vector<std::string>& local_files, int64_t local_tablet_id,
+                          DataDir* data_dir);
+
+    // Run the tasks transferring the files by snapshot_transfer_parallelism threads, and report
+    // the progress to frontend after each file. Stop at the first error, or if the job is
+    // cancelled in frontend.
+    Status _transfer_files(const std::vector<std::function<Status()>>& tasks,
+                           TTaskType::type type);
+
     Status _report_every(int report_threshold, int* counter, int finished_num, int total_num,
                          TTaskType::type type);
 
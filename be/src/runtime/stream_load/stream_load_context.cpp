@@ -38,6 +38,11 @@ std::string StreamLoadContext::to_json() const {
     std::string need_two_phase_commit = two_phase_commit ? "true" : "false";
     writer.String(need_two_phase_commit.c_str());
 
+    if (group_commit) {
+        writer.Key("GroupCommitLabel");
+        writer.String(group_commit_label.c_str());
+    }
+
     // status
     writer.Key("Status");
     switch (status.code()) {
@@ -205,6 +205,14 @@ public:
     // csv with header type
     std::string header_type = "";
 
+    // If this load is group committed, its body is loaded by the batch labeled group_commit_label
+    // in the transaction txn_id, with the other loads of the batch.
+    bool group_commit = false;
+    std::string group_commit_label = "";
+    // the wal the body is written to, it's empty once the load is added to or removed from
+    // the batch
+    std::string group_commit_wal = "";
+
 public:
     ExecEnv* exec_env() { return _exec_env; }
 
@@ -0,0 +1,155 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/tablet_writer_stream.h"
+
+#include "common/config.h"
+#include "gen_cpp/internal_service.pb.h"
+#include "runtime/load_channel_mgr.h"
+#include "util/priority_thread_pool.hpp"
+#include "util/runtime_profile.h"
+#include "util/time.h"
+
+namespace doris {
+
+Status TabletWriterStreamReceiver::accept(brpc::Controller* cntl,
+                                          LoadChannelMgr* load_channel_mgr,
+                                          PriorityThreadPool* worker_pool) {
+    auto receiver = std::make_shared<TabletWriterStreamReceiver>(load_channel_mgr, worker_pool);
+    brpc::StreamOptions options;
+    options.handler = receiver.get();
+    options.max_buf_size = config::tablet_writer_stream_max_buf_bytes;
+    if (brpc::StreamAccept(&receiver->_stream_id, *cntl, &options) != 0) {
+        return Status::InternalError("failed to accept the tablet writer stream");
+    }
+    receiver->_self = receiver;
+    return Status::OK();
+}
+
+int TabletWriterStreamReceiver::on_received_messages(brpc::StreamId id,
+                                                     butil::IOBuf* const messages[],
+                                                     size_t size) {
+    std::unique_lock<std::mutex> l(_lock);
+    for (size_t i = 0; i < size; ++i) {
+        auto message = std::make_unique<butil::IOBuf>();
+        message->swap(*messages[i]);
+        _queued_bytes += message->size();
+        _messages.push_back(std::move(message));
+    }
+    if (!_processing) {
+        _processing = true;
+        auto self = shared_from_this();
+        if (!_worker_pool->offer([self]() { self->_process_messages(); })) {
+            _processing = false;
+            LOG(WARNING) << "failed to offer the messages of tablet writer stream " << id;
+            return 0;
+        }
+    }
+    // The stream acknowledges the messages once they are returned, so hold the stream here until
+    // the queued messages are under the buffer size, the sender waits for the acknowledgement
+    // before sending more.
+    _queue_cv.wait(l, [this]() {
+        return _closed || _queued_bytes < config::tablet_writer_stream_max_buf_bytes;
+    });
+    return 0;
+}
+
+void TabletWriterStreamReceiver::on_closed(brpc::StreamId id) {
+    std::shared_ptr<TabletWriterStreamReceiver> self;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _closed = true;
+        self = std::move(_self);
+    }
+    _queue_cv.notify_all();
+}
+
+void TabletWriterStreamReceiver::_process_messages() {
+    while (true) {
+        std::unique_ptr<butil::IOBuf> message;
+        {
+            std::lock_guard<std::mutex> l(_lock);
+            if (_messages.empty() || _closed) {
+                _processing = false;
+                return;
+            }
+            message = std::move(_messages.front());
+            _messages.pop_front();
+            _queued_bytes -= message->size();
+        }
+        _queue_cv.notify_all();
+
+        PTabletWriterAddBlockResult response;
+        int64_t execution_time_ns = 0;
+        {
+            SCOPED_RAW_TIMER(&execution_time_ns);
+            auto st = _add_block(message.get(), &response);
+            if (!st.ok()) {
+                LOG(WARNING) << "tablet writer stream add block failed, message="
+                             << st.get_error_msg() << ", stream id=" << _stream_id;
+            }
+            st.to_protobuf(response.mutable_status());
+        }
+        response.set_execution_time_us(execution_time_ns / NANOS_PER_MICRO);
+        _write_result(response);
+    }
+}
+
+Status TabletWriterStreamReceiver::_add_block(butil::IOBuf* message,
+                                              PTabletWriterAddBlockResult* response) {
+    uint32_t header_size = 0;
+    if (message->cutn(&header_size, sizeof(header_size)) != sizeof(header_size)) {
+        return Status::InternalError("invalid tablet writer stream message");
+    }
+    butil::IOBuf header;
+    if (message->cutn(&header, header_size) != header_size) {
+        return Status::InternalError("invalid tablet writer stream message");
+    }
+    PTabletWriterAddBlockRequest request;
+    butil::IOBufAsZeroCopyInputStream header_stream(header);
+    if (!request.ParseFromZeroCopyStream(&header_stream)) {
+        return Status::InternalError("failed to parse the tablet writer stream message");
+    }
+    // the rest of the message is the column values of the block
+    if (request.has_block()) {
+        message->copy_to(request.mutable_block()->mutable_column_values());
+    }
+    return _load_channel_mgr->add_batch(request, response);
+}
+
+void TabletWriterStreamReceiver::_write_result(const PTabletWriterAddBlockResult& response) {
+    butil::IOBuf result;
+    {
+        butil::IOBufAsZeroCopyOutputStream result_stream(&result);
+        response.SerializeToZeroCopyStream(&result_stream);
+    }
+    timespec deadline = butil::milliseconds_from_now(config::tablet_writer_open_rpc_timeout_sec *
+                                                     1000);
+    int ret = 0;
+    while ((ret = brpc::StreamWrite(_stream_id, result)) == EAGAIN) {
+        if ((ret = brpc::StreamWait(_stream_id, &deadline)) != 0) {
+            break;
+        }
+    }
+    if (ret != 0) {
+        LOG(WARNING) << "failed to write the result of tablet writer stream " << _stream_id
+                     << ", error=" << ret;
+    }
+}
+
+} // namespace doris
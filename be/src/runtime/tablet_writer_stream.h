@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+#include "common/status.h"
+#include "service/brpc.h"
+
+namespace doris {
+
+class LoadChannelMgr;
+class PTabletWriterAddBlockResult;
+class PriorityThreadPool;
+
+// The receiver of a tablet writer stream opened by a VNodeChannel. The messages of the stream are
+// the add block requests of the sender in order (see PTabletWriterOpenStreamRequest). They are
+// applied to the load channels one at a time by a task of the tablet worker pool, so the packet
+// sequence checked by the tablets channels stays in order, and the result of each of them is
+// written back through the stream.
+// A receiver deletes itself when the stream is closed.
+class TabletWriterStreamReceiver : public brpc::StreamInputHandler,
+                                   public std::enable_shared_from_this<TabletWriterStreamReceiver> {
+public:
+    // Accept the stream of the open_stream rpc `cntl`.
+    static Status accept(brpc::Controller* cntl, LoadChannelMgr* load_channel_mgr,
+                         PriorityThreadPool* worker_pool);
+
+    TabletWriterStreamReceiver(LoadChannelMgr* load_channel_mgr, PriorityThreadPool* worker_pool)
+            : _load_channel_mgr(load_channel_mgr), _worker_pool(worker_pool) {}
+
+    int on_received_messages(brpc::StreamId id, butil::IOBuf* const messages[],
+                             size_t size) override;
+
+    void on_idle_timeout(brpc::StreamId id) override {}
+
+    void on_closed(brpc::StreamId id) override;
+
+private:
+    // Apply the queued messages until the queue is empty.
+    void _process_messages();
+
+    Status _add_block(butil::IOBuf* message, PTabletWriterAddBlockResult* response);
+
+    void _write_result(const PTabletWriterAddBlockResult& response);
+
+    LoadChannelMgr* _load_channel_mgr;
+    PriorityThreadPool* _worker_pool;
+    brpc::StreamId _stream_id = brpc::INVALID_STREAM_ID;
+
+    std::mutex _lock;
+    std::condition_variable _queue_cv;
+    std::deque<std::unique_ptr<butil::IOBuf>> _messages;
+    size_t _queued_bytes = 0;
+    // whether a task of the worker pool is applying the queued messages
+    bool _processing = false;
+    bool _closed = false;
+
+    // keeps the receiver alive until the stream is closed
+    std::shared_ptr<TabletWriterStreamReceiver> _self;
+};
+
+} // namespace doris
@@ -19,9 +19,15 @@
 
 #include "exec/tablet_info.h"
 #include "olap/memtable.h"
+#include "runtime/exec_env.h"
+#include "runtime/load_channel_mgr.h"
+#include "runtime/memtable_memory_manager.h"
 #include "runtime/row_batch.h"
 #include "runtime/tuple_row.h"
 #include "runtime/thread_context.h"
+#include "service/backend_options.h"
+#include "service/brpc.h"
+#include "util/brpc_client_cache.h"
 #include "util/doris_metrics.h"
 
 namespace doris {
@@ -46,6 +52,9 @@ TabletsChannel::TabletsChannel(const TabletsChannelKey& key, bool is_high_priori
 TabletsChannel::~TabletsChannel() {
     _s_tablet_writer_count -= _tablet_writers.size();
     for (auto& it : _tablet_writers) {
+        if (_memtable_memory_manager != nullptr) {
+            _memtable_memory_manager->deregister_writer(it.second);
+        }
         delete it.second;
     }
     delete _row_desc;
@@ -72,7 +81,21 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& request) {
     _next_seqs.resize(_num_remaining_senders, 0);
     _closed_senders.Reset(_num_remaining_senders);
 
+    if (ExecEnv::GetInstance()->load_channel_mgr() != nullptr) {
+        _memtable_memory_manager =
+                ExecEnv::GetInstance()->load_channel_mgr()->memtable_memory_manager();
+    }
     RETURN_IF_ERROR(_open_all_writers(request));
+    ThreadPool* write_pool = ExecEnv::GetInstance()->tablet_write_thread_pool();
+    if (write_pool != nullptr && config::tablet_writer_write_parallelism > 1) {
+        _write_token = write_pool->new_token(ThreadPool::ExecutionMode::CONCURRENT,
+                                             config::tablet_writer_write_parallelism);
+    }
+    for (auto& slave_tablet_nodes : request.slave_tablet_nodes()) {
+        auto& nodes = _slave_tablet_nodes[slave_tablet_nodes.tablet_id()];
+        nodes.assign(slave_tablet_nodes.slave_nodes().begin(),
+                     slave_tablet_nodes.slave_nodes().end());
+    }
 
     _state = kOpened;
     return Status::OK();
@@ -80,7 +103,9 @@ Status TabletsChannel::open(const PTabletWriterOpenRequest& request) {
 
 Status TabletsChannel::close(int sender_id, int64_t backend_id, bool* finished,
                              const google::protobuf::RepeatedField<int64_t>& partition_ids,
-                             google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec) {
+                             google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
+                             google::protobuf::RepeatedPtrField<PSuccessSlaveTabletNodeIds>*
+                                     success_slave_tablet_node_ids) {
     std::lock_guard<std::mutex> l(_lock);
     if (_state == kFinished) {
         return _close_status;
@@ -125,16 +150,95 @@ Status TabletsChannel::close(int sender_id, int64_t backend_id, bool* finished,
         }
 
         // 2. wait delta writers and build the tablet vector
+        std::vector<DeltaWriter*> committed_writers;
         for (auto writer : need_wait_writers) {
             // close may return failed, but no need to handle it here.
             // tablet_vec will only contains success tablet, and then let FE judge it.
-            writer->close_wait(tablet_vec, (_broken_tablets.find(writer->tablet_id()) !=
-                                            _broken_tablets.end()));
+            bool is_broken = _broken_tablets.find(writer->tablet_id()) != _broken_tablets.end();
+            auto st = writer->close_wait(tablet_vec, is_broken);
+            if (st.ok() && !is_broken && _slave_tablet_nodes.count(writer->tablet_id()) > 0) {
+                committed_writers.push_back(writer);
+            }
+        }
+
+        // 3. the slave replicas pull the committed rowsets in the single replica load
+        if (!committed_writers.empty()) {
+            _request_slave_tablets_pull_rowset(committed_writers, success_slave_tablet_node_ids);
         }
     }
     return Status::OK();
 }
 
+namespace {
+
+// the rpc to ask a slave replica to pull the rowset of a tablet
+struct SlavePullRowsetRpc {
+    int64_t tablet_id;
+    int64_t node_id;
+    std::shared_ptr<PBackendService_Stub> stub;
+    brpc::Controller cntl;
+    PTabletWriteSlaveResult result;
+};
+
+} // namespace
+
+void TabletsChannel::_request_slave_tablets_pull_rowset(
+        const std::vector<DeltaWriter*>& writers,
+        google::protobuf::RepeatedPtrField<PSuccessSlaveTabletNodeIds>*
+                success_slave_tablet_node_ids) {
+    auto client_cache = ExecEnv::GetInstance()->brpc_internal_client_cache();
+    std::vector<PTabletWriteSlaveRequest> requests(writers.size());
+    std::vector<std::unique_ptr<SlavePullRowsetRpc>> rpcs;
+    for (size_t i = 0; i < writers.size(); ++i) {
+        auto writer = writers[i];
+        auto st = writer->build_slave_pull_request(&requests[i]);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to build the request to pull rowset, tablet_id="
+                         << writer->tablet_id() << ", txn_id=" << _txn_id << ", err=" << st;
+            continue;
+        }
+        requests[i].set_host(BackendOptions::get_localhost());
+        requests[i].set_http_port(config::webserver_port);
+        requests[i].set_token(ExecEnv::GetInstance()->token());
+        for (auto& node : _slave_tablet_nodes[writer->tablet_id()]) {
+            auto rpc = std::make_unique<SlavePullRowsetRpc>();
+            rpc->tablet_id = writer->tablet_id();
+            rpc->node_id = node.id();
+            rpc->stub = client_cache->get_client(node.host(), node.async_internal_port());
+            if (rpc->stub == nullptr) {
+                LOG(WARNING) << "failed to get the brpc stub of " << node.host() << ":"
+                             << node.async_internal_port() << ", tablet_id=" << rpc->tablet_id;
+                continue;
+            }
+            rpc->cntl.set_timeout_ms(config::slave_replica_pull_rowset_rpc_timeout_sec * 1000);
+            rpc->stub->request_slave_tablet_pull_rowset(&rpc->cntl, &requests[i], &rpc->result,
+                                                        brpc::DoNothing());
+            rpcs.push_back(std::move(rpc));
+        }
+    }
+
+    // the slave replicas pulling the rowsets in parallel, wait for all of them
+    std::unordered_map<int64_t, PSuccessSlaveTabletNodeIds*> success_nodes;
+    for (auto& rpc : rpcs) {
+        brpc::Join(rpc->cntl.call_id());
+        Status st = rpc->cntl.Failed() ? Status::InternalError(rpc->cntl.ErrorText())
+                                       : Status(rpc->result.status());
+        if (!st.ok()) {
+            // the replica is not committed, FE judges whether the load succeeds by the quorum
+            LOG(WARNING) << "slave replica failed to pull rowset, tablet_id=" << rpc->tablet_id
+                         << ", node_id=" << rpc->node_id << ", txn_id=" << _txn_id
+                         << ", err=" << st;
+            continue;
+        }
+        auto& nodes = success_nodes[rpc->tablet_id];
+        if (nodes == nullptr) {
+            nodes = success_slave_tablet_node_ids->Add();
+            nodes->set_tablet_id(rpc->tablet_id);
+        }
+        nodes->add_slave_node_ids(rpc->node_id);
+    }
+}
+
 Status TabletsChannel::reduce_mem_usage(int64_t mem_limit) {
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     std::lock_guard<std::mutex> l(_lock);
@@ -229,6 +333,9 @@ Status TabletsChannel::_open_all_writers(const PTabletWriterOpenRequest& request
             return Status::InternalError(ss.str());
         }
         _tablet_writers.emplace(tablet.tablet_id(), writer);
+        if (_memtable_memory_manager != nullptr) {
+            _memtable_memory_manager->register_writer(writer);
+        }
     }
     _s_tablet_writer_count += _tablet_writers.size();
     DCHECK_EQ(_tablet_writers.size(), request.tablets_size());
@@ -29,7 +29,9 @@
 #include "runtime/mem_tracker.h"
 #include "runtime/thread_context.h"
 #include "util/bitmap.h"
+#include "util/countdown_latch.h"
 #include "util/priority_thread_pool.hpp"
+#include "util/threadpool.h"
 #include "util/uid_util.h"
 #include "gutil/strings/substitute.h"
 
@@ -56,6 +58,7 @@ struct TabletsChannelKey {
 std::ostream& operator<<(std::ostream& os, const TabletsChannelKey& key);
 
 class DeltaWriter;
+class MemTableMemoryManager;
 class OlapTableSchemaParam;
 
 // Write channel for a particular (load, index).
@@ -75,9 +78,13 @@ public:
     // If all senders are closed, close this channel, set '*finished' to true, update 'tablet_vec'
     // to include all tablets written in this channel.
     // no-op when this channel has been closed or cancelled
+    // In the single replica load, the slave replicas of the tablets pull the rowsets after they
+    // are committed, and the ones succeeded are added to 'success_slave_tablet_node_ids'.
     Status close(int sender_id, int64_t backend_id, bool* finished,
                  const google::protobuf::RepeatedField<int64_t>& partition_ids,
-                 google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec);
+                 google::protobuf::RepeatedPtrField<PTabletInfo>* tablet_vec,
+                 google::protobuf::RepeatedPtrField<PSuccessSlaveTabletNodeIds>*
+                         success_slave_tablet_node_ids);
 
     // no-op when this channel has been closed or cancelled
     Status cancel();
@@ -97,6 +104,12 @@ private:
     // open all writer
     Status _open_all_writers(const PTabletWriterOpenRequest& request);
 
+    // ask the slave replicas of the tablets of the writers to pull the committed rowsets
+    void _request_slave_tablets_pull_rowset(
+            const std::vector<DeltaWriter*>& writers,
+            google::protobuf::RepeatedPtrField<PSuccessSlaveTabletNodeIds>*
+                    success_slave_tablet_node_ids);
+
     // id of this load channel
     TabletsChannelKey _key;
 
@@ -136,8 +149,17 @@ private:
 
     std::unordered_set<int64_t> _partition_ids;
 
+    // tablet_id -> the slave replicas of the tablet, only in the single replica load
+    std::unordered_map<int64_t, std::vector<PNodeInfo>> _slave_tablet_nodes;
+
     std::shared_ptr<MemTracker> _mem_tracker;
 
+    // the memtables of the writers are flushed by it when the load memory is high
+    MemTableMemoryManager* _memtable_memory_manager = nullptr;
+
+    // the token to write the tablets of a batch in parallel, null if they are written one by one
+    std::unique_ptr<ThreadPoolToken> _write_token;
+
     static std::atomic<uint64_t> _s_tablet_writer_count;
 
     bool _is_high_priority = false;
@@ -205,25 +227,63 @@ Status TabletsChannel::add_batch(const TabletWriterAddRequest& request,
     };
 
     auto send_data = get_send_data();
-    google::protobuf::RepeatedPtrField<PTabletError>* tablet_errors =
-            response->mutable_tablet_errors();
+    // the writes of the tablets in the batch
+    struct TabletWrite {
+        int64_t tablet_id;
+        DeltaWriter* writer;
+        const std::vector<int>* rows;
+        Status status;
+    };
+    std::vector<TabletWrite> writes;
+    writes.reserve(tablet_to_rowidxs.size());
     for (const auto& tablet_to_rowidxs_it : tablet_to_rowidxs) {
         auto tablet_writer_it = _tablet_writers.find(tablet_to_rowidxs_it.first);
         if (tablet_writer_it == _tablet_writers.end()) {
             return Status::InternalError(strings::Substitute(
                     "unknown tablet to append data, tablet=$0", tablet_to_rowidxs_it.first));
         }
+        writes.push_back({tablet_to_rowidxs_it.first, tablet_writer_it->second,
+                          &tablet_to_rowidxs_it.second, Status::OK()});
+    }
 
-        Status st = tablet_writer_it->second->write(&send_data, tablet_to_rowidxs_it.second);
-        if (!st.ok()) {
+    // The tablets are written in parallel by the write token, the batch is only read by
+    // the writers. The status of each write is reported after all of them are done.
+    auto write_tablet = [&send_data](TabletWrite* write) {
+        write->status = write->writer->write(&send_data, *write->rows);
+    };
+    if (_write_token == nullptr || writes.size() <= 1) {
+        for (auto& write : writes) {
+            write_tablet(&write);
+        }
+    } else {
+        CountDownLatch latch(writes.size());
+        for (auto& write : writes) {
+            auto st = _write_token->submit_func([&, write_ptr = &write]() {
+                SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+                write_tablet(write_ptr);
+                latch.count_down();
+            });
+            if (!st.ok()) {
+                // write it by this thread if the pool is shutting down
+                write_tablet(&write);
+                latch.count_down();
+            }
+        }
+        latch.wait();
+    }
+
+    google::protobuf::RepeatedPtrField<PTabletError>* tablet_errors =
+            response->mutable_tablet_errors();
+    for (const auto& write : writes) {
+        if (!write.status.ok()) {
             auto err_msg = strings::Substitute(
                     "tablet writer write failed, tablet_id=$0, txn_id=$1, err=$2",
-                    tablet_to_rowidxs_it.first, _txn_id, st.code());
+                    write.tablet_id, _txn_id, write.status.code());
             LOG(WARNING) << err_msg;
             PTabletError* error = tablet_errors->Add();
-            error->set_tablet_id(tablet_to_rowidxs_it.first);
+            error->set_tablet_id(write.tablet_id);
             error->set_msg(err_msg);
-            _broken_tablets.insert(tablet_to_rowidxs_it.first);
+            _broken_tablets.insert(write.tablet_id);
             // continue write to other tablet.
             // the error will return back to sender.
         }
@@ -28,6 +28,7 @@
 #include "gen_cpp/PaloInternalService_types.h" // for TQueryType
 #include "runtime/thread_mem_tracker_mgr.h"
 #include "runtime/threadlocal.h"
+#include "util/sampling_profiler.h"
 
 // Attach to task when thread starts
 #define SCOPED_ATTACH_TASK_THREAD(type, ...) \
@@ -118,6 +119,7 @@ public:
         _type = type;
         _task_id = task_id;
         _fragment_instance_id = fragment_instance_id;
+        tls_sampling_tag.set_task_id(task_id);
         _thread_mem_tracker_mgr->attach_task(TaskTypeStr[_type], task_id, fragment_instance_id,
                                              mem_tracker);
     }
@@ -126,6 +128,7 @@ public:
         _type = TaskType::UNKNOWN;
         _task_id = "";
         _fragment_instance_id = TUniqueId();
+        tls_sampling_tag.set_task_id("");
         _thread_mem_tracker_mgr->detach_task();
     }
 
@@ -22,6 +22,7 @@
 #include <boost/uuid/uuid_io.hpp>
 #include <filesystem>
 
+#include "common/config.h"
 #include "olap/storage_engine.h"
 #include "runtime/exec_env.h"
 #include "util/debug_util.h"
@@ -58,6 +59,9 @@ TmpFileMgr::TmpFileMgr() {
 }
 
 TmpFileMgr::~TmpFileMgr() {
+    if (_io_thread_pool != nullptr) {
+        _io_thread_pool->shutdown();
+    }
     METRIC_DEREGISTER(DorisMetrics::instance()->server_entity(), active_scratch_dirs);
 }
 
@@ -122,6 +126,13 @@ Status TmpFileMgr::init_custom(const vector<string>& tmp_dirs, bool one_dir_per_
 
     active_scratch_dirs->set_value(_tmp_dirs.size());
 
+    if (!_tmp_dirs.empty() && config::vec_spill_io_thread_num > 0) {
+        RETURN_IF_ERROR(ThreadPoolBuilder("SpillIOThreadPool")
+                                .set_min_threads(1)
+                                .set_max_threads(config::vec_spill_io_thread_num)
+                                .build(&_io_thread_pool));
+    }
+
     _initialized = true;
 
     if (_tmp_dirs.empty() && !tmp_dirs.empty()) {
@@ -18,10 +18,13 @@
 #ifndef DORIS_BE_SRC_QUERY_RUNTIME_TMP_FILE_MGR_H
 #define DORIS_BE_SRC_QUERY_RUNTIME_TMP_FILE_MGR_H
 
+#include <memory>
+
 #include "common/status.h"
 #include "gen_cpp/Types_types.h" // for TUniqueId
 #include "util/metrics.h"
 #include "util/spinlock.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
@@ -134,6 +137,10 @@ public:
     // I.e. those that haven't been blacklisted.
     std::vector<DeviceId> active_tmp_devices();
 
+    // The threads doing the spill io of the vectorized operators, nullptr if
+    // config::vec_spill_io_thread_num is 0.
+    ThreadPool* io_thread_pool() const { return _io_thread_pool.get(); }
+
 private:
     // Dir stores information about a temporary directory.
     class Dir {
@@ -176,6 +183,8 @@ private:
 
     // Metric to track active scratch directories.
     IntGauge* active_scratch_dirs;
+
+    std::unique_ptr<ThreadPool> _io_thread_pool;
 };
 
 } // end namespace doris
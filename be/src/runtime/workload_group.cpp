@@ -0,0 +1,160 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/workload_group.h"
+
+#include "agent/cgroups_mgr.h"
+#include "common/config.h"
+#include "gutil/strings/numbers.h"
+#include "gutil/strings/split.h"
+#include "gutil/strings/strip.h"
+#include "gutil/strings/substitute.h"
+#include "runtime/mem_tracker.h"
+#include "util/mem_info.h"
+#include "util/parse_util.h"
+
+namespace doris {
+
+Status WorkloadGroup::add_fragment(const TUniqueId& query_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _running_fragments.find(query_id);
+    if (it == _running_fragments.end()) {
+        if (_info.max_concurrency > 0 && _running_fragments.size() >= _info.max_concurrency) {
+            return Status::Cancelled(strings::Substitute(
+                    "the workload group $0 already runs $1 queries, the max concurrency is $2",
+                    _info.name, _running_fragments.size(), _info.max_concurrency));
+        }
+        it = _running_fragments.emplace(query_id, 0).first;
+    }
+    ++it->second;
+    return Status::OK();
+}
+
+void WorkloadGroup::remove_fragment(const TUniqueId& query_id) {
+    std::lock_guard<std::mutex> l(_lock);
+    auto it = _running_fragments.find(query_id);
+    DCHECK(it != _running_fragments.end());
+    if (it != _running_fragments.end() && --it->second == 0) {
+        _running_fragments.erase(it);
+    }
+}
+
+int WorkloadGroup::num_queries() {
+    std::lock_guard<std::mutex> l(_lock);
+    return _running_fragments.size();
+}
+
+namespace {
+// the group whose cgroup the thread is in, null means the system cgroup
+thread_local const WorkloadGroup* t_cgroup_group = nullptr;
+thread_local bool t_cgroup_bound = false;
+} // namespace
+
+void WorkloadGroup::bind_thread_cgroup(const WorkloadGroup* group) {
+    if (t_cgroup_bound && t_cgroup_group == group) {
+        return;
+    }
+    if (group != nullptr) {
+        CgroupsMgr::apply_cgroup(group->cgroup_name(), "");
+    } else {
+        CgroupsMgr::apply_system_cgroup();
+    }
+    t_cgroup_group = group;
+    t_cgroup_bound = true;
+}
+
+Status WorkloadGroupMgr::init(const std::shared_ptr<MemTracker>& parent,
+                              CgroupsMgr* cgroups_mgr) {
+    std::vector<WorkloadGroupInfo> infos;
+    RETURN_IF_ERROR(parse_groups(config::workload_groups,
+                                 MemTracker::get_process_tracker()->limit(), &infos));
+    for (auto& info : infos) {
+        auto mem_tracker = MemTracker::create_tracker(
+                info.memory_limit, "WorkloadGroup=" + info.name, parent, MemTrackerLevel::OVERVIEW);
+        auto group = std::make_shared<WorkloadGroup>(std::move(info), std::move(mem_tracker));
+        if (cgroups_mgr != nullptr && cgroups_mgr->is_cgroups_init_success()) {
+            RETURN_IF_ERROR(cgroups_mgr->modify_user_cgroups(
+                    group->cgroup_name(), {{"cpu.shares", group->info().cpu_share}}, {}));
+        }
+        LOG(INFO) << "workload group " << group->info().name
+                  << ", cpu_share: " << group->info().cpu_share
+                  << ", memory_limit: " << group->info().memory_limit
+                  << ", max_concurrency: " << group->info().max_concurrency;
+        _groups.emplace(group->info().name, std::move(group));
+    }
+    return Status::OK();
+}
+
+std::shared_ptr<WorkloadGroup> WorkloadGroupMgr::get_group(const std::string& name) const {
+    auto it = _groups.find(name);
+    return it == _groups.end() ? nullptr : it->second;
+}
+
+Status WorkloadGroupMgr::parse_groups(const std::string& groups, int64_t process_mem_limit,
+                                      std::vector<WorkloadGroupInfo>* infos) {
+    for (std::string group : strings::Split(groups, ";", strings::SkipWhitespace())) {
+        std::vector<std::string> name_and_props =
+                strings::Split(group, strings::delimiter::Limit(":", 1));
+        WorkloadGroupInfo info;
+        info.name = name_and_props[0];
+        StripWhiteSpace(&info.name);
+        if (info.name.empty()) {
+            return Status::InvalidArgument("empty workload group name in: " + groups);
+        }
+        std::vector<std::string> props;
+        if (name_and_props.size() > 1) {
+            props = strings::Split(name_and_props[1], ",", strings::SkipWhitespace());
+        }
+        for (std::string prop : props) {
+            std::vector<std::string> kv = strings::Split(prop, "=");
+            if (kv.size() != 2) {
+                return Status::InvalidArgument(strings::Substitute(
+                        "invalid property '$0' of workload group $1", prop, info.name));
+            }
+            StripWhiteSpace(&kv[0]);
+            StripWhiteSpace(&kv[1]);
+            bool valid = true;
+            if (kv[0] == "cpu_share") {
+                valid = safe_strto32(kv[1], &info.cpu_share) && info.cpu_share > 0;
+            } else if (kv[0] == "memory_limit") {
+                bool is_percent = false;
+                info.memory_limit =
+                        ParseUtil::parse_mem_spec(kv[1], process_mem_limit,
+                                                             MemInfo::physical_mem(), &is_percent);
+                valid = info.memory_limit > 0;
+            } else if (kv[0] == "max_concurrency") {
+                valid = safe_strto32(kv[1], &info.max_concurrency) && info.max_concurrency >= 0;
+            } else {
+                valid = false;
+            }
+            if (!valid) {
+                return Status::InvalidArgument(strings::Substitute(
+                        "invalid property '$0' of workload group $1", prop, info.name));
+            }
+        }
+        for (auto& other : *infos) {
+            if (other.name == info.name) {
+                return Status::InvalidArgument("duplicated workload group " + info.name);
+            }
+        }
+        infos->push_back(std::move(info));
+    }
+    return Status::OK();
+}
+
+} // namespace doris
@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "util/hash_util.hpp"
+
+namespace doris {
+
+class CgroupsMgr;
+class MemTracker;
+
+struct WorkloadGroupInfo {
+    std::string name;
+    // the cpu.shares of the cgroup of the group, and the weight of its queries in the fair scan
+    // scheduler
+    int cpu_share = 1024;
+    // the memory limit in bytes of all the queries of the group, -1 means no limit
+    int64_t memory_limit = -1;
+    // the max number of the running queries of the group, 0 means no limit
+    int max_concurrency = 0;
+};
+
+// A named group of queries isolated from the other groups on this backend. The memory of its
+// queries is tracked under the MemTracker of the group, the fragment and scanner threads of its
+// queries run in the cgroup of the group, and the new queries are rejected once the group runs
+// max_concurrency queries.
+class WorkloadGroup {
+public:
+    WorkloadGroup(WorkloadGroupInfo info, std::shared_ptr<MemTracker> mem_tracker)
+            : _info(std::move(info)), _mem_tracker(std::move(mem_tracker)) {}
+
+    const WorkloadGroupInfo& info() const { return _info; }
+    const std::shared_ptr<MemTracker>& mem_tracker() const { return _mem_tracker; }
+
+    // Admit a fragment of the query, fails if the query is a new one of the group and the group
+    // already runs max_concurrency queries.
+    Status add_fragment(const TUniqueId& query_id);
+    // Called when the fragment admitted by add_fragment() is finished.
+    void remove_fragment(const TUniqueId& query_id);
+
+    int num_queries();
+
+    // Move the calling thread into the cgroup of `group`, or into the system cgroup if `group`
+    // is null. It's skipped if the thread is already in the cgroup, and does nothing if cgroups
+    // are not used.
+    static void bind_thread_cgroup(const WorkloadGroup* group);
+
+    std::string cgroup_name() const { return "workload_group_" + _info.name; }
+
+private:
+    const WorkloadGroupInfo _info;
+    std::shared_ptr<MemTracker> _mem_tracker;
+
+    std::mutex _lock;
+    // the number of the running fragments of the running queries
+    std::unordered_map<TUniqueId, int> _running_fragments;
+};
+
+// The workload groups configured by config::workload_groups, they can't change at runtime.
+class WorkloadGroupMgr {
+public:
+    // Create the groups, their MemTrackers are the children of `parent`. The cgroups of the
+    // groups are created if `cgroups_mgr` is initialized.
+    Status init(const std::shared_ptr<MemTracker>& parent, CgroupsMgr* cgroups_mgr);
+
+    // Returns nullptr if there's no group of the name.
+    std::shared_ptr<WorkloadGroup> get_group(const std::string& name) const;
+
+    // Parse the groups in the format of "name:key=value,key=value;name:key=value", the keys
+    // are cpu_share, memory_limit and max_concurrency. memory_limit is a memory spec, the
+    // percentage is of `process_mem_limit`.
+    static Status parse_groups(const std::string& groups, int64_t process_mem_limit,
+                               std::vector<WorkloadGroupInfo>* infos);
+
+private:
+    std::unordered_map<std::string, std::shared_ptr<WorkloadGroup>> _groups;
+};
+
+} // namespace doris
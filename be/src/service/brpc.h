@@ -28,6 +28,7 @@
 #include <brpc/protocol.h>
 #include <brpc/reloadable_flags.h>
 #include <brpc/server.h>
+#include <brpc/stream.h>
 #include <bthread/bthread.h>
 #include <bthread/types.h>
 #include <butil/containers/flat_map.h>
@@ -27,9 +27,11 @@
 #include "http/action/metrics_action.h"
 #include "http/action/mini_load.h"
 #include "http/action/pprof_actions.h"
+#include "http/action/query_replay_action.h"
 #include "http/action/reload_tablet_action.h"
 #include "http/action/reset_rpc_channel_action.h"
 #include "http/action/restore_tablet_action.h"
+#include "http/action/sampling_profile_action.h"
 #include "http/action/snapshot_action.h"
 #include "http/action/stream_load.h"
 #include "http/action/stream_load_2pc.h"
@@ -112,6 +114,13 @@ Status HttpService::start() {
 
     // register pprof actions
     PprofActions::setup(_env, _ev_http_server.get(), _pool);
+    SamplingProfileAction* sampling_profile_action = _pool.add(new SamplingProfileAction());
+    _ev_http_server->register_handler(HttpMethod::GET, "/api/sampling_profile",
+                                      sampling_profile_action);
+
+    QueryReplayAction* query_replay_action = _pool.add(new QueryReplayAction(_env));
+    _ev_http_server->register_handler(HttpMethod::POST, "/api/query_replay",
+                                      query_replay_action);
 
     // register metrics
     {
@@ -17,9 +17,24 @@
 
 #include "service/internal_service.h"
 
+#include <sys/stat.h>
+
+#include <filesystem>
+#include <numeric>
+
 #include "common/config.h"
 #include "gen_cpp/BackendService.h"
 #include "gen_cpp/internal_service.pb.h"
+#include "gutil/strings/substitute.h"
+#include "http/http_client.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_meta.h"
+#include "olap/rowset/segment_v2/segment_iterator.h"
+#include "olap/segment_loader.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_manager.h"
+#include "olap/txn_manager.h"
 #include "runtime/buffer_control_block.h"
 #include "runtime/data_stream_mgr.h"
 #include "runtime/exec_env.h"
@@ -29,19 +44,26 @@
 #include "runtime/result_buffer_mgr.h"
 #include "runtime/routine_load/routine_load_task_executor.h"
 #include "runtime/runtime_state.h"
+#include "runtime/tablet_writer_stream.h"
 #include "runtime/thread_context.h"
 #include "service/brpc.h"
+#include "service/point_query_executor.h"
 #include "util/brpc_client_cache.h"
+#include "util/defer_op.h"
+#include "util/doris_metrics.h"
+#include "util/file_utils.h"
 #include "util/md5.h"
 #include "util/proto_util.h"
 #include "util/string_util.h"
 #include "util/thrift_util.h"
 #include "util/uid_util.h"
+#include "vec/core/block.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 
 namespace doris {
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(add_batch_task_queue_size, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(heavy_work_task_queue_size, MetricUnit::NOUNIT);
 
 bthread_key_t btls_key;
 
@@ -49,20 +71,42 @@ static void thread_context_deleter(void* d) {
     delete static_cast<ThreadContext*>(d);
 }
 
+static Status heavy_work_pool_full() {
+    return Status::TooManyTasks("too many tasks in the brpc heavy work pool");
+}
+
 template <typename T>
 PInternalServiceImpl<T>::PInternalServiceImpl(ExecEnv* exec_env)
-        : _exec_env(exec_env), _tablet_worker_pool(config::number_tablet_writer_threads, 10240) {
+        : _exec_env(exec_env),
+          _heavy_work_pool(config::brpc_heavy_work_pool_threads,
+                           config::brpc_heavy_work_pool_max_queue_size),
+          _tablet_worker_pool(config::number_tablet_writer_threads, 10240),
+          _slave_replica_worker_pool(config::number_slave_replica_download_threads, 10240) {
     REGISTER_HOOK_METRIC(add_batch_task_queue_size,
                          [this]() { return _tablet_worker_pool.get_queue_size(); });
+    REGISTER_HOOK_METRIC(heavy_work_task_queue_size,
+                         [this]() { return _heavy_work_pool.get_queue_size(); });
     CHECK_EQ(0, bthread_key_create(&btls_key, thread_context_deleter));
 }
 
 template <typename T>
 PInternalServiceImpl<T>::~PInternalServiceImpl() {
     DEREGISTER_HOOK_METRIC(add_batch_task_queue_size);
+    DEREGISTER_HOOK_METRIC(heavy_work_task_queue_size);
     CHECK_EQ(0, bthread_key_delete(btls_key));
 }
 
+template <typename T>
+bool PInternalServiceImpl<T>::_offer_heavy_work(std::function<void()> work) {
+    int64_t submit_task_time_ns = MonotonicNanos();
+    return _heavy_work_pool.try_offer([work = std::move(work), submit_task_time_ns]() {
+        DorisMetrics::instance()->brpc_heavy_work_tasks_total->increment(1);
+        DorisMetrics::instance()->brpc_heavy_work_queue_time_us->increment(
+                (MonotonicNanos() - submit_task_time_ns) / NANOS_PER_MICRO);
+        work();
+    });
+}
+
 template <typename T>
 void PInternalServiceImpl<T>::transmit_data(google::protobuf::RpcController* cntl_base,
                                             const PTransmitDataParams* request,
@@ -97,14 +141,20 @@ void PInternalServiceImpl<T>::tablet_writer_open(google::protobuf::RpcController
     SCOPED_SWITCH_BTHREAD();
     VLOG_RPC << "tablet writer open, id=" << request->id() << ", index_id=" << request->index_id()
              << ", txn_id=" << request->txn_id();
-    brpc::ClosureGuard closure_guard(done);
-    auto st = _exec_env->load_channel_mgr()->open(*request);
-    if (!st.ok()) {
-        LOG(WARNING) << "load channel open failed, message=" << st.get_error_msg()
-                     << ", id=" << request->id() << ", index_id=" << request->index_id()
-                     << ", txn_id=" << request->txn_id();
+    bool offered = _offer_heavy_work([this, request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        auto st = _exec_env->load_channel_mgr()->open(*request);
+        if (!st.ok()) {
+            LOG(WARNING) << "load channel open failed, message=" << st.get_error_msg()
+                         << ", id=" << request->id() << ", index_id=" << request->index_id()
+                         << ", txn_id=" << request->txn_id();
+        }
+        st.to_protobuf(response->mutable_status());
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        heavy_work_pool_full().to_protobuf(response->mutable_status());
     }
-    st.to_protobuf(response->mutable_status());
 }
 
 template <typename T>
@@ -113,14 +163,20 @@ void PInternalServiceImpl<T>::exec_plan_fragment(google::protobuf::RpcController
                                                  PExecPlanFragmentResult* response,
                                                  google::protobuf::Closure* done) {
     SCOPED_SWITCH_BTHREAD();
-    brpc::ClosureGuard closure_guard(done);
-    auto st = Status::OK();
-    bool compact = request->has_compact() ? request->compact() : false;
-    st = _exec_plan_fragment(request->request(), compact);
-    if (!st.ok()) {
-        LOG(WARNING) << "exec plan fragment failed, errmsg=" << st.get_error_msg();
+    bool offered = _offer_heavy_work([this, request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        auto st = Status::OK();
+        bool compact = request->has_compact() ? request->compact() : false;
+        st = _exec_plan_fragment(request->request(), compact);
+        if (!st.ok()) {
+            LOG(WARNING) << "exec plan fragment failed, errmsg=" << st.get_error_msg();
+        }
+        st.to_protobuf(response->mutable_status());
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        heavy_work_pool_full().to_protobuf(response->mutable_status());
     }
-    st.to_protobuf(response->mutable_status());
 }
 
 template <typename T>
@@ -134,6 +190,9 @@ void PInternalServiceImpl<T>::tablet_writer_add_block(google::protobuf::RpcContr
     int64_t submit_task_time_ns = MonotonicNanos();
     _tablet_worker_pool.offer([cntl_base, request, response, done, submit_task_time_ns, this]() {
         int64_t wait_execution_time_ns = MonotonicNanos() - submit_task_time_ns;
+        DorisMetrics::instance()->brpc_tablet_writer_tasks_total->increment(1);
+        DorisMetrics::instance()->brpc_tablet_writer_queue_time_us->increment(
+                wait_execution_time_ns / NANOS_PER_MICRO);
         brpc::ClosureGuard closure_guard(done);
         int64_t execution_time_ns = 0;
         {
@@ -154,6 +213,24 @@ void PInternalServiceImpl<T>::tablet_writer_add_block(google::protobuf::RpcContr
     });
 }
 
+template <typename T>
+void PInternalServiceImpl<T>::tablet_writer_open_stream(
+        google::protobuf::RpcController* cntl_base, const PTabletWriterOpenStreamRequest* request,
+        PTabletWriterOpenStreamResult* response, google::protobuf::Closure* done) {
+    VLOG_RPC << "tablet writer open stream, id=" << request->id()
+             << ", index_id=" << request->index_id() << ", sender_id=" << request->sender_id();
+    brpc::ClosureGuard closure_guard(done);
+    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    auto st = TabletWriterStreamReceiver::accept(cntl, _exec_env->load_channel_mgr(),
+                                                 &_tablet_worker_pool);
+    if (!st.ok()) {
+        LOG(WARNING) << "tablet writer open stream failed, message=" << st.get_error_msg()
+                     << ", id=" << request->id() << ", index_id=" << request->index_id()
+                     << ", sender_id=" << request->sender_id();
+    }
+    st.to_protobuf(response->mutable_status());
+}
+
 template <typename T>
 void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcController* cntl_base,
                                                       const PTabletWriterAddBatchRequest* request,
@@ -169,6 +246,9 @@ void PInternalServiceImpl<T>::tablet_writer_add_batch(google::protobuf::RpcContr
     int64_t submit_task_time_ns = MonotonicNanos();
     _tablet_worker_pool.offer([cntl_base, request, response, done, submit_task_time_ns, this]() {
         int64_t wait_execution_time_ns = MonotonicNanos() - submit_task_time_ns;
+        DorisMetrics::instance()->brpc_tablet_writer_tasks_total->increment(1);
+        DorisMetrics::instance()->brpc_tablet_writer_queue_time_us->increment(
+                wait_execution_time_ns / NANOS_PER_MICRO);
         brpc::ClosureGuard closure_guard(done);
         int64_t execution_time_ns = 0;
         {
@@ -258,61 +338,67 @@ void PInternalServiceImpl<T>::get_info(google::protobuf::RpcController* controll
                                        const PProxyRequest* request, PProxyResult* response,
                                        google::protobuf::Closure* done) {
     SCOPED_SWITCH_BTHREAD();
-    brpc::ClosureGuard closure_guard(done);
-    // PProxyRequest is defined in gensrc/proto/internal_service.proto
-    // Currently it supports 2 kinds of requests:
-    // 1. get all kafka partition ids for given topic
-    // 2. get all kafka partition offsets for given topic and timestamp.
-    if (request->has_kafka_meta_request()) {
-        const PKafkaMetaProxyRequest& kafka_request = request->kafka_meta_request();
-        if (!kafka_request.partition_id_for_latest_offsets().empty()) {
-            // get latest offsets for specified partition ids
-            std::vector<PIntegerPair> partition_offsets;
-            Status st = _exec_env->routine_load_task_executor()
-                                ->get_kafka_latest_offsets_for_partitions(
-                                        request->kafka_meta_request(), &partition_offsets);
-            if (st.ok()) {
-                PKafkaPartitionOffsets* part_offsets = response->mutable_partition_offsets();
-                for (const auto& entry : partition_offsets) {
-                    PIntegerPair* res = part_offsets->add_offset_times();
-                    res->set_key(entry.key());
-                    res->set_val(entry.val());
+    bool offered = _offer_heavy_work([this, request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        // PProxyRequest is defined in gensrc/proto/internal_service.proto
+        // Currently it supports 2 kinds of requests:
+        // 1. get all kafka partition ids for given topic
+        // 2. get all kafka partition offsets for given topic and timestamp.
+        if (request->has_kafka_meta_request()) {
+            const PKafkaMetaProxyRequest& kafka_request = request->kafka_meta_request();
+            if (!kafka_request.partition_id_for_latest_offsets().empty()) {
+                // get latest offsets for specified partition ids
+                std::vector<PIntegerPair> partition_offsets;
+                Status st = _exec_env->routine_load_task_executor()
+                                    ->get_kafka_latest_offsets_for_partitions(
+                                            request->kafka_meta_request(), &partition_offsets);
+                if (st.ok()) {
+                    PKafkaPartitionOffsets* part_offsets = response->mutable_partition_offsets();
+                    for (const auto& entry : partition_offsets) {
+                        PIntegerPair* res = part_offsets->add_offset_times();
+                        res->set_key(entry.key());
+                        res->set_val(entry.val());
+                    }
                 }
-            }
-            st.to_protobuf(response->mutable_status());
-            return;
-        } else if (!kafka_request.offset_times().empty()) {
-            // if offset_times() has elements, which means this request is to get offset by timestamp.
-            std::vector<PIntegerPair> partition_offsets;
-            Status st =
-                    _exec_env->routine_load_task_executor()->get_kafka_partition_offsets_for_times(
-                            request->kafka_meta_request(), &partition_offsets);
-            if (st.ok()) {
-                PKafkaPartitionOffsets* part_offsets = response->mutable_partition_offsets();
-                for (const auto& entry : partition_offsets) {
-                    PIntegerPair* res = part_offsets->add_offset_times();
-                    res->set_key(entry.key());
-                    res->set_val(entry.val());
+                st.to_protobuf(response->mutable_status());
+                return;
+            } else if (!kafka_request.offset_times().empty()) {
+                // if offset_times() has elements, which means this request is to get offset by timestamp.
+                std::vector<PIntegerPair> partition_offsets;
+                Status st = _exec_env->routine_load_task_executor()
+                                    ->get_kafka_partition_offsets_for_times(
+                                            request->kafka_meta_request(), &partition_offsets);
+                if (st.ok()) {
+                    PKafkaPartitionOffsets* part_offsets = response->mutable_partition_offsets();
+                    for (const auto& entry : partition_offsets) {
+                        PIntegerPair* res = part_offsets->add_offset_times();
+                        res->set_key(entry.key());
+                        res->set_val(entry.val());
+                    }
                 }
-            }
-            st.to_protobuf(response->mutable_status());
-            return;
-        } else {
-            // get partition ids of topic
-            std::vector<int32_t> partition_ids;
-            Status st = _exec_env->routine_load_task_executor()->get_kafka_partition_meta(
-                    request->kafka_meta_request(), &partition_ids);
-            if (st.ok()) {
-                PKafkaMetaProxyResult* kafka_result = response->mutable_kafka_meta_result();
-                for (int32_t id : partition_ids) {
-                    kafka_result->add_partition_ids(id);
+                st.to_protobuf(response->mutable_status());
+                return;
+            } else {
+                // get partition ids of topic
+                std::vector<int32_t> partition_ids;
+                Status st = _exec_env->routine_load_task_executor()->get_kafka_partition_meta(
+                        request->kafka_meta_request(), &partition_ids);
+                if (st.ok()) {
+                    PKafkaMetaProxyResult* kafka_result = response->mutable_kafka_meta_result();
+                    for (int32_t id : partition_ids) {
+                        kafka_result->add_partition_ids(id);
+                    }
                 }
+                st.to_protobuf(response->mutable_status());
+                return;
             }
-            st.to_protobuf(response->mutable_status());
-            return;
         }
+        Status::OK().to_protobuf(response->mutable_status());
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        heavy_work_pool_full().to_protobuf(response->mutable_status());
     }
-    Status::OK().to_protobuf(response->mutable_status());
 }
 
 template <typename T>
@@ -321,8 +407,14 @@ void PInternalServiceImpl<T>::update_cache(google::protobuf::RpcController* cont
                                            PCacheResponse* response,
                                            google::protobuf::Closure* done) {
     SCOPED_SWITCH_BTHREAD();
-    brpc::ClosureGuard closure_guard(done);
-    _exec_env->result_cache()->update(request, response);
+    bool offered = _offer_heavy_work([this, request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        _exec_env->result_cache()->update(request, response);
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        response->set_status(PCacheStatus::DEFAULT);
+    }
 }
 
 template <typename T>
@@ -331,8 +423,14 @@ void PInternalServiceImpl<T>::fetch_cache(google::protobuf::RpcController* contr
                                           PFetchCacheResult* result,
                                           google::protobuf::Closure* done) {
     SCOPED_SWITCH_BTHREAD();
-    brpc::ClosureGuard closure_guard(done);
-    _exec_env->result_cache()->fetch(request, result);
+    bool offered = _offer_heavy_work([this, request, result, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        _exec_env->result_cache()->fetch(request, result);
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        result->set_status(PCacheStatus::DEFAULT);
+    }
 }
 
 template <typename T>
@@ -446,20 +544,26 @@ void PInternalServiceImpl<T>::fold_constant_expr(google::protobuf::RpcController
                                                  PConstantExprResult* response,
                                                  google::protobuf::Closure* done) {
     SCOPED_SWITCH_BTHREAD();
-    brpc::ClosureGuard closure_guard(done);
-    brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
-
-    Status st = Status::OK();
-    if (request->has_request()) {
-        st = _fold_constant_expr(request->request(), response);
-    } else {
-        // TODO(yangzhengguo) this is just for compatible with old version, this should be removed in the release 0.15
-        st = _fold_constant_expr(cntl->request_attachment().to_string(), response);
-    }
-    if (!st.ok()) {
-        LOG(WARNING) << "exec fold constant expr failed, errmsg=" << st.get_error_msg();
+    bool offered = _offer_heavy_work([this, cntl_base, request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        brpc::Controller* cntl = static_cast<brpc::Controller*>(cntl_base);
+    
+        Status st = Status::OK();
+        if (request->has_request()) {
+            st = _fold_constant_expr(request->request(), response);
+        } else {
+            // TODO(yangzhengguo) this is just for compatible with old version, this should be removed in the release 0.15
+            st = _fold_constant_expr(cntl->request_attachment().to_string(), response);
+        }
+        if (!st.ok()) {
+            LOG(WARNING) << "exec fold constant expr failed, errmsg=" << st.get_error_msg();
+        }
+        st.to_protobuf(response->mutable_status());
+    });
+    if (!offered) {
+        brpc::ClosureGuard closure_guard(done);
+        heavy_work_pool_full().to_protobuf(response->mutable_status());
     }
-    st.to_protobuf(response->mutable_status());
 }
 
 template <typename T>
@@ -503,6 +607,27 @@ void PInternalServiceImpl<T>::transmit_block(google::protobuf::RpcController* cn
     }
 }
 
+template <typename T>
+void PInternalServiceImpl<T>::transmit_blocks(google::protobuf::RpcController* cntl_base,
+                                              const PTransmitBlocksParams* request,
+                                              PTransmitDataResult* response,
+                                              google::protobuf::Closure* done) {
+    SCOPED_SWITCH_BTHREAD();
+    VLOG_ROW << "transmit blocks: num=" << request->params_size();
+    // The response is accessed when done->Run is called in transmit_blocks(),
+    // give response a default value to avoid null pointers in high concurrency.
+    Status st;
+    st.to_protobuf(response->mutable_status());
+    st = _exec_env->vstream_mgr()->transmit_blocks(request, &done);
+    if (!st.ok()) {
+        LOG(WARNING) << "transmit_blocks failed, message=" << st.get_error_msg();
+    }
+    if (done != nullptr) {
+        st.to_protobuf(response->mutable_status());
+        done->Run();
+    }
+}
+
 template <typename T>
 void PInternalServiceImpl<T>::check_rpc_channel(google::protobuf::RpcController* controller,
                                                 const PCheckRPCChannelRequest* request,
@@ -579,6 +704,284 @@ void PInternalServiceImpl<T>::hand_shake(google::protobuf::RpcController* cntl_b
     response->mutable_status()->set_status_code(0);
 }
 
+template <typename T>
+void PInternalServiceImpl<T>::multiget_data(google::protobuf::RpcController* cntl_base,
+                                            const PMultiGetRequest* request,
+                                            PMultiGetResponse* response,
+                                            google::protobuf::Closure* done) {
+    // reading the segments may block, don't block the bthreads
+    _tablet_worker_pool.offer([request, response, done, this]() {
+        brpc::ClosureGuard closure_guard(done);
+        Status st = _multi_get(*request, response);
+        if (!st.ok()) {
+            LOG(WARNING) << "multiget data failed, query_id=" << print_id(request->query_id())
+                         << ", errmsg=" << st.get_error_msg();
+        }
+        st.to_protobuf(response->mutable_status());
+    });
+}
+
+template <typename T>
+void PInternalServiceImpl<T>::tablet_fetch_data(google::protobuf::RpcController* cntl_base,
+                                                const PTabletKeyLookupRequest* request,
+                                                PTabletKeyLookupResponse* response,
+                                                google::protobuf::Closure* done) {
+    // the point queries are latency sensitive, run them before the other tasks of the pool
+    PriorityThreadPool::Task task;
+    task.priority = 1;
+    task.queue_id = 0;
+    task.work_function = [request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        Status st = PointQueryExecutor::lookup(*request, response);
+        if (!st.ok()) {
+            LOG(WARNING) << "point query failed, tablet_id=" << request->tablet_id()
+                         << ", errmsg=" << st.get_error_msg();
+        }
+        st.to_protobuf(response->mutable_status());
+    };
+    _tablet_worker_pool.offer(task);
+}
+
+// read the rows `rowids` of a segment, of the columns `slots`
+static Status read_segment_rows(const PRowLocation& location,
+                                const google::protobuf::RepeatedPtrField<PSlotDescriptor>& slots,
+                                const std::vector<rowid_t>& rowids, vectorized::Block* block) {
+    TabletSharedPtr tablet =
+            StorageEngine::instance()->tablet_manager()->get_tablet(location.tablet_id());
+    if (tablet == nullptr) {
+        return Status::NotFound(
+                strings::Substitute("tablet $0 not found", location.tablet_id()));
+    }
+    RowsetId rowset_id;
+    rowset_id.init(location.rowset_id());
+    RowsetSharedPtr rowset = tablet->get_rowset(rowset_id);
+    if (rowset == nullptr || rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+        return Status::NotFound(strings::Substitute("rowset $0 of tablet $1 not found",
+                                                    location.rowset_id(), location.tablet_id()));
+    }
+
+    std::vector<uint32_t> return_columns;
+    std::unordered_set<uint32_t> columns_convert_to_null;
+    for (const auto& slot : slots) {
+        int32_t index = tablet->field_index(slot.col_name());
+        if (index < 0) {
+            return Status::InternalError(
+                    strings::Substitute("field name is invalid. field=$0", slot.col_name()));
+        }
+        return_columns.push_back(index);
+        // the slot is nullable if it has a null indicator
+        if (slot.null_indicator_bit() != -1 &&
+            !tablet->tablet_schema().column(index).is_nullable()) {
+            columns_convert_to_null.insert(index);
+        }
+    }
+
+    SegmentCacheHandle segment_cache_handle;
+    RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
+            std::static_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
+    segment_v2::SegmentSharedPtr segment;
+    for (auto& seg : segment_cache_handle.get_segments()) {
+        if (seg->id() == location.segment_id()) {
+            segment = seg;
+            break;
+        }
+    }
+    if (segment == nullptr) {
+        return Status::NotFound(strings::Substitute("segment $0 of rowset $1 not found",
+                                                    location.segment_id(), location.rowset_id()));
+    }
+
+    Schema schema(tablet->tablet_schema().columns(), return_columns);
+    OlapReaderStatistics stats;
+    StorageReadOptions opts;
+    opts.stats = &stats;
+    opts.use_page_cache = !config::disable_storage_page_cache;
+    std::unique_ptr<RowwiseIterator> iter;
+    RETURN_IF_ERROR(segment->new_iterator(schema, opts, &iter));
+    auto segment_iter = dynamic_cast<segment_v2::SegmentIterator*>(iter.get());
+    DCHECK(segment_iter != nullptr);
+    *block = tablet->tablet_schema().create_block(return_columns, &columns_convert_to_null);
+    return segment_iter->read_by_rowids(rowids.data(), rowids.size(), block);
+}
+
+// download a file of the master replica by the download action
+static Status download_file(const std::string& remote_file_url, const std::string& local_file_path,
+                            uint64_t file_size) {
+    uint64_t estimate_timeout = file_size / config::download_low_speed_limit_kbps / 1024;
+    if (estimate_timeout < config::download_low_speed_time) {
+        estimate_timeout = config::download_low_speed_time;
+    }
+    auto download_cb = [&](HttpClient* client) {
+        RETURN_IF_ERROR(client->init(remote_file_url));
+        client->set_timeout_ms(estimate_timeout * 1000);
+        RETURN_IF_ERROR(client->download(local_file_path));
+        uint64_t local_file_size = std::filesystem::file_size(local_file_path);
+        if (local_file_size != file_size) {
+            return Status::InternalError(strings::Substitute(
+                    "downloaded $0 bytes of $1, expect $2 bytes", local_file_size,
+                    remote_file_url, file_size));
+        }
+        chmod(local_file_path.c_str(), S_IRUSR | S_IWUSR);
+        return Status::OK();
+    };
+    return HttpClient::execute_with_retry(3, 1, download_cb);
+}
+
+// Download the segment files of the rowset committed by the master replica, and commit the rowset
+// with a new rowset id to the txn of this replica.
+static Status pull_rowset_from_master(const PTabletWriteSlaveRequest& request) {
+    const RowsetMetaPB& master_rowset_meta = request.rowset_meta();
+    TabletSharedPtr tablet =
+            StorageEngine::instance()->tablet_manager()->get_tablet(master_rowset_meta.tablet_id());
+    if (tablet == nullptr) {
+        return Status::NotFound(
+                strings::Substitute("tablet $0 not found", master_rowset_meta.tablet_id()));
+    }
+    if (tablet->schema_hash() != master_rowset_meta.tablet_schema_hash()) {
+        return Status::InternalError(strings::Substitute(
+                "schema hash of tablet $0 is $1, but $2 in the master replica",
+                tablet->tablet_id(), tablet->schema_hash(),
+                master_rowset_meta.tablet_schema_hash()));
+    }
+    RowsetId master_rowset_id;
+    master_rowset_id.init(master_rowset_meta.rowset_id_v2());
+
+    auto rowset_meta = std::make_shared<RowsetMeta>();
+    if (!rowset_meta->init_from_pb(master_rowset_meta)) {
+        return Status::InternalError("failed to init the rowset meta of the master replica");
+    }
+    RowsetId rowset_id = StorageEngine::instance()->next_rowset_id();
+    rowset_meta->set_rowset_id(rowset_id);
+    rowset_meta->set_tablet_uid(tablet->tablet_uid());
+
+    std::vector<std::string> downloaded_files;
+    Defer remove_downloaded_files {[&]() {
+        for (auto& file : downloaded_files) {
+            FileUtils::remove(file);
+        }
+    }};
+    for (const auto& [segment_id, file_size] : request.segments_size()) {
+        if (tablet->data_dir()->reach_capacity_limit(file_size)) {
+            return Status::InternalError("Disk reach capacity limit");
+        }
+        std::string remote_file_path =
+                BetaRowset::segment_file_path(request.rowset_path(), master_rowset_id, segment_id)
+                        .filepath;
+        std::string remote_file_url = strings::Substitute(
+                "http://$0:$1/api/_tablet/_download?token=$2&file=$3", request.host(),
+                request.http_port(), request.token(), remote_file_path);
+        std::string local_file_path =
+                BetaRowset::segment_file_path(tablet->tablet_path_desc(), rowset_id, segment_id)
+                        .filepath;
+        downloaded_files.push_back(local_file_path);
+        RETURN_IF_ERROR(download_file(remote_file_url, local_file_path, file_size));
+    }
+
+    RowsetSharedPtr rowset;
+    RETURN_IF_ERROR(RowsetFactory::create_rowset(&tablet->tablet_schema(),
+                                                 tablet->tablet_path_desc(), rowset_meta, &rowset));
+    TxnManager* txn_manager = StorageEngine::instance()->txn_manager();
+    RETURN_IF_ERROR(txn_manager->prepare_txn(master_rowset_meta.partition_id(), tablet,
+                                             master_rowset_meta.txn_id(),
+                                             master_rowset_meta.load_id()));
+    Status st = txn_manager->commit_txn(master_rowset_meta.partition_id(), tablet,
+                                        master_rowset_meta.txn_id(), master_rowset_meta.load_id(),
+                                        rowset, false);
+    if (!st.ok() && st != Status::OLAPInternalError(OLAP_ERR_PUSH_TRANSACTION_ALREADY_EXIST)) {
+        return st;
+    }
+    // the files are owned by the committed rowset now
+    downloaded_files.clear();
+    return Status::OK();
+}
+
+template <typename T>
+Status PInternalServiceImpl<T>::_multi_get(const PMultiGetRequest& request,
+                                           PMultiGetResponse* response) {
+    // read the rows of each segment at once, in the order of the row ids
+    int num_rows = request.row_locs_size();
+    std::vector<int> order(num_rows);
+    std::iota(order.begin(), order.end(), 0);
+    auto same_segment = [&request](int lhs, int rhs) {
+        const auto& l = request.row_locs(lhs);
+        const auto& r = request.row_locs(rhs);
+        return l.tablet_id() == r.tablet_id() && l.rowset_id() == r.rowset_id() &&
+               l.segment_id() == r.segment_id();
+    };
+    std::sort(order.begin(), order.end(), [&request](int lhs, int rhs) {
+        const auto& l = request.row_locs(lhs);
+        const auto& r = request.row_locs(rhs);
+        if (l.tablet_id() != r.tablet_id()) {
+            return l.tablet_id() < r.tablet_id();
+        }
+        if (l.rowset_id() != r.rowset_id()) {
+            return l.rowset_id() < r.rowset_id();
+        }
+        if (l.segment_id() != r.segment_id()) {
+            return l.segment_id() < r.segment_id();
+        }
+        return l.ordinal_id() < r.ordinal_id();
+    });
+
+    std::vector<vectorized::Block> blocks;
+    // the row i of the request is the row `positions[i].second` of `blocks[positions[i].first]`
+    std::vector<std::pair<size_t, size_t>> positions(num_rows);
+    for (int begin = 0; begin < num_rows;) {
+        int end = begin + 1;
+        while (end < num_rows && same_segment(order[begin], order[end])) {
+            ++end;
+        }
+        std::vector<rowid_t> rowids;
+        for (int i = begin; i < end; ++i) {
+            rowids.push_back(request.row_locs(order[i]).ordinal_id());
+            positions[order[i]] = {blocks.size(), i - begin};
+        }
+        vectorized::Block block;
+        RETURN_IF_ERROR(
+                read_segment_rows(request.row_locs(order[begin]), request.slots(), rowids, &block));
+        blocks.push_back(std::move(block));
+        begin = end;
+    }
+    if (blocks.empty()) {
+        return Status::OK();
+    }
+
+    // restore the order of the request
+    auto columns = blocks[0].clone_empty_columns();
+    for (int i = 0; i < num_rows; ++i) {
+        const auto& block = blocks[positions[i].first];
+        for (size_t j = 0; j < columns.size(); ++j) {
+            columns[j]->insert_from(*block.get_by_position(j).column, positions[i].second);
+        }
+    }
+    auto result = blocks[0].clone_with_columns(std::move(columns));
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    std::string column_values;
+    RETURN_IF_ERROR(result.serialize(response->mutable_block(), &uncompressed_bytes,
+                                     &compressed_bytes, &column_values));
+    response->mutable_block()->set_column_values(std::move(column_values));
+    return Status::OK();
+}
+
+template <typename T>
+void PInternalServiceImpl<T>::request_slave_tablet_pull_rowset(
+        google::protobuf::RpcController* controller, const PTabletWriteSlaveRequest* request,
+        PTabletWriteSlaveResult* response, google::protobuf::Closure* done) {
+    // downloading the segment files blocks, don't block the bthreads
+    _slave_replica_worker_pool.offer([request, response, done]() {
+        brpc::ClosureGuard closure_guard(done);
+        Status st = pull_rowset_from_master(*request);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to pull rowset from master replica, tablet_id="
+                         << request->rowset_meta().tablet_id()
+                         << ", txn_id=" << request->rowset_meta().txn_id()
+                         << ", master=" << request->host() << ", err=" << st;
+        }
+        st.to_protobuf(response->mutable_status());
+    });
+}
+
 template class PInternalServiceImpl<PBackendService>;
 
 } // namespace doris
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "common/status.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "runtime/cache/result_cache.h"
@@ -69,6 +71,11 @@ public:
                                  PTabletWriterAddBlockResult* response,
                                  google::protobuf::Closure* done) override;
 
+    void tablet_writer_open_stream(google::protobuf::RpcController* controller,
+                                   const PTabletWriterOpenStreamRequest* request,
+                                   PTabletWriterOpenStreamResult* response,
+                                   google::protobuf::Closure* done) override;
+
     void tablet_writer_cancel(google::protobuf::RpcController* controller,
                               const PTabletWriterCancelRequest* request,
                               PTabletWriterCancelResult* response,
@@ -100,6 +107,10 @@ public:
                         const ::doris::PTransmitDataParams* request,
                         ::doris::PTransmitDataResult* response,
                         ::google::protobuf::Closure* done) override;
+    void transmit_blocks(::google::protobuf::RpcController* controller,
+                         const ::doris::PTransmitBlocksParams* request,
+                         ::doris::PTransmitDataResult* response,
+                         ::google::protobuf::Closure* done) override;
 
     void send_data(google::protobuf::RpcController* controller, const PSendDataRequest* request,
                    PSendDataResult* response, google::protobuf::Closure* done) override;
@@ -121,14 +132,39 @@ public:
     void hand_shake(google::protobuf::RpcController* controller, const PHandShakeRequest* request,
                     PHandShakeResponse* response, google::protobuf::Closure* done) override;
 
+    void multiget_data(google::protobuf::RpcController* controller,
+                       const PMultiGetRequest* request, PMultiGetResponse* response,
+                       google::protobuf::Closure* done) override;
+
+    void tablet_fetch_data(google::protobuf::RpcController* controller,
+                           const PTabletKeyLookupRequest* request,
+                           PTabletKeyLookupResponse* response,
+                           google::protobuf::Closure* done) override;
+
+    void request_slave_tablet_pull_rowset(google::protobuf::RpcController* controller,
+                                          const PTabletWriteSlaveRequest* request,
+                                          PTabletWriteSlaveResult* response,
+                                          google::protobuf::Closure* done) override;
+
 private:
     Status _exec_plan_fragment(const std::string& s_request, bool compact);
 
     Status _fold_constant_expr(const std::string& ser_request, PConstantExprResult* response);
 
+    Status _multi_get(const PMultiGetRequest& request, PMultiGetResponse* response);
+
+    // Run `work` in _heavy_work_pool, `work` must run the closure of the request.
+    // Return false without waiting if the pool is full, the caller should fail the request.
+    bool _offer_heavy_work(std::function<void()> work);
+
 private:
     ExecEnv* _exec_env;
+    // the handlers which may block run in it instead of the brpc threads
+    PriorityThreadPool _heavy_work_pool;
     PriorityThreadPool _tablet_worker_pool;
+    // The slave replicas pull the rowsets in another pool, the master replicas may wait for
+    // them in the threads of _tablet_worker_pool.
+    PriorityThreadPool _slave_replica_worker_pool;
 };
 
 } // namespace doris
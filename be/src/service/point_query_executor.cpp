@@ -0,0 +1,264 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "service/point_query_executor.h"
+
+#include <algorithm>
+#include <mutex>
+#include <numeric>
+#include <shared_mutex>
+#include <unordered_set>
+
+#include "common/config.h"
+#include "gutil/strings/substitute.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/segment_v2/segment_iterator.h"
+#include "olap/segment_loader.h"
+#include "olap/short_key_index.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_manager.h"
+#include "olap/tuple.h"
+#include "util/lru_cache.hpp"
+#include "util/uid_util.h"
+#include "vec/core/block.h"
+
+namespace doris {
+
+namespace {
+
+// where the row of a key is
+struct KeyLocation {
+    int key_idx;
+    size_t rowset_idx;
+    size_t segment_idx;
+    rowid_t row_id;
+};
+
+Status read_segment_rows(const TabletSchema& schema, const segment_v2::SegmentSharedPtr& segment,
+                         const std::vector<uint32_t>& return_columns,
+                         const std::unordered_set<uint32_t>& columns_convert_to_null,
+                         const std::vector<rowid_t>& rowids, vectorized::Block* block) {
+    Schema read_schema(schema.columns(), return_columns);
+    OlapReaderStatistics stats;
+    StorageReadOptions opts;
+    opts.stats = &stats;
+    opts.use_page_cache = !config::disable_storage_page_cache;
+    std::unique_ptr<RowwiseIterator> iter;
+    RETURN_IF_ERROR(segment->new_iterator(read_schema, opts, &iter));
+    auto segment_iter = dynamic_cast<segment_v2::SegmentIterator*>(iter.get());
+    DCHECK(segment_iter != nullptr);
+    *block = schema.create_block(return_columns, &columns_convert_to_null);
+    return segment_iter->read_by_rowids(rowids.data(), rowids.size(), block);
+}
+
+} // namespace
+
+Status PointQueryExecutor::_get_slots(const PTabletKeyLookupRequest& request,
+                                      std::shared_ptr<const Slots>* slots) {
+    static std::mutex lock;
+    static LruCache<std::string, std::shared_ptr<const Slots>> prepared_slots(
+            config::point_query_prepared_statement_cache_size);
+
+    std::string uuid = request.has_uuid() ? print_id(request.uuid()) : "";
+    if (request.slots_size() > 0) {
+        auto request_slots = std::make_shared<const Slots>(request.slots());
+        if (!uuid.empty()) {
+            std::lock_guard<std::mutex> l(lock);
+            prepared_slots.put(uuid, request_slots);
+        }
+        *slots = std::move(request_slots);
+        return Status::OK();
+    }
+    if (uuid.empty()) {
+        return Status::InvalidArgument("no return columns of the point query");
+    }
+    std::lock_guard<std::mutex> l(lock);
+    if (!prepared_slots.get(uuid, slots)) {
+        return Status::NotFound(strings::Substitute("the prepared statement $0 is expired", uuid));
+    }
+    return Status::OK();
+}
+
+Status PointQueryExecutor::lookup(const PTabletKeyLookupRequest& request,
+                                  PTabletKeyLookupResponse* response) {
+    TabletSharedPtr tablet =
+            StorageEngine::instance()->tablet_manager()->get_tablet(request.tablet_id());
+    if (tablet == nullptr) {
+        return Status::NotFound(strings::Substitute("tablet $0 not found", request.tablet_id()));
+    }
+    if (!tablet->enable_unique_key_merge_on_write()) {
+        return Status::NotSupported(strings::Substitute(
+                "tablet $0 isn't a unique key tablet with merge-on-write", request.tablet_id()));
+    }
+    std::shared_ptr<const Slots> slots;
+    RETURN_IF_ERROR(_get_slots(request, &slots));
+
+    const TabletSchema& schema = tablet->tablet_schema();
+    std::vector<uint32_t> return_columns;
+    std::unordered_set<uint32_t> columns_convert_to_null;
+    for (const auto& slot : *slots) {
+        int32_t index = schema.field_index(slot.col_name());
+        if (index < 0) {
+            return Status::InternalError(
+                    strings::Substitute("field name is invalid. field=$0", slot.col_name()));
+        }
+        return_columns.push_back(index);
+        // the slot is nullable if it has a null indicator
+        if (slot.null_indicator_bit() != -1 && !schema.column(index).is_nullable()) {
+            columns_convert_to_null.insert(index);
+        }
+    }
+    size_t num_return_columns = return_columns.size();
+    // the rows deleted by the delete sign are filtered out after being read
+    if (schema.delete_sign_idx() >= 0) {
+        return_columns.push_back(schema.delete_sign_idx());
+    }
+
+    int64_t version = request.has_version() ? request.version() : -1;
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rdlock(tablet->get_header_lock());
+        if (version < 0) {
+            version = tablet->max_version().second;
+        }
+        RETURN_IF_ERROR(tablet->capture_consistent_rowsets(Version(0, version), &rowsets));
+    }
+    // a key is only alive in its latest copy, so look up the newest rowsets first
+    std::sort(rowsets.begin(), rowsets.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->end_version() > rhs->end_version();
+    });
+    std::vector<SegmentCacheHandle> segment_handles(rowsets.size());
+    for (size_t i = 0; i < rowsets.size(); ++i) {
+        if (rowsets[i]->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            return Status::NotSupported("merge-on-write only supports beta rowset");
+        }
+        RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
+                std::static_pointer_cast<BetaRowset>(rowsets[i]), &segment_handles[i], true));
+    }
+
+    auto delete_bitmap = tablet->tablet_meta()->delete_bitmap();
+    size_t num_keys = schema.num_key_columns();
+    std::vector<KeyLocation> locations;
+    for (int i = 0; i < request.keys_size(); ++i) {
+        const auto& key = request.keys(i);
+        if (static_cast<size_t>(key.values_size()) != num_keys) {
+            return Status::InvalidArgument(strings::Substitute(
+                    "the key has $0 columns, expect $1", key.values_size(), num_keys));
+        }
+        OlapTuple tuple;
+        for (const auto& value : key.values()) {
+            if (value.has_value()) {
+                tuple.add_value(value.value());
+            } else {
+                tuple.add_null();
+            }
+        }
+        RowCursor cursor;
+        RETURN_IF_ERROR(cursor.init_scan_key(schema, tuple.values()));
+        RETURN_IF_ERROR(cursor.from_tuple(tuple));
+        std::string encoded_key;
+        full_encode_key(&encoded_key, cursor, num_keys);
+
+        bool found = false;
+        for (size_t r = 0; r < rowsets.size() && !found; ++r) {
+            const auto& segments = segment_handles[r].get_segments();
+            for (size_t s = segments.size(); s > 0; --s) {
+                rowid_t row_id = 0;
+                Status st = segments[s - 1]->lookup_row_key(encoded_key, &row_id);
+                if (st.is_not_found()) {
+                    continue;
+                }
+                RETURN_IF_ERROR(st);
+                // the latest copy marked deleted means the key is deleted
+                if (!delete_bitmap->contains_agg(
+                            {rowsets[r]->rowset_id(), segments[s - 1]->id(), version}, row_id)) {
+                    locations.push_back({i, r, s - 1, row_id});
+                }
+                found = true;
+                break;
+            }
+        }
+    }
+
+    // read the rows of each segment at once, in the order of the row ids
+    std::vector<size_t> order(locations.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&locations](size_t lhs, size_t rhs) {
+        const auto& l = locations[lhs];
+        const auto& r = locations[rhs];
+        return std::tie(l.rowset_idx, l.segment_idx, l.row_id) <
+               std::tie(r.rowset_idx, r.segment_idx, r.row_id);
+    });
+    std::vector<vectorized::Block> blocks;
+    // the row of locations[i] is the row `positions[i].second` of `blocks[positions[i].first]`
+    std::vector<std::pair<size_t, size_t>> positions(locations.size());
+    for (size_t begin = 0; begin < order.size();) {
+        const auto& first = locations[order[begin]];
+        size_t end = begin + 1;
+        while (end < order.size() && locations[order[end]].rowset_idx == first.rowset_idx &&
+               locations[order[end]].segment_idx == first.segment_idx) {
+            ++end;
+        }
+        std::vector<rowid_t> rowids;
+        for (size_t i = begin; i < end; ++i) {
+            rowids.push_back(locations[order[i]].row_id);
+            positions[order[i]] = {blocks.size(), i - begin};
+        }
+        vectorized::Block block;
+        RETURN_IF_ERROR(read_segment_rows(
+                schema, segment_handles[first.rowset_idx].get_segments()[first.segment_idx],
+                return_columns, columns_convert_to_null, rowids, &block));
+        blocks.push_back(std::move(block));
+        begin = end;
+    }
+
+    // restore the order of the keys
+    std::vector<bool> found(request.keys_size(), false);
+    if (!blocks.empty()) {
+        auto columns = blocks[0].clone_empty_columns();
+        for (size_t i = 0; i < locations.size(); ++i) {
+            const auto& block = blocks[positions[i].first];
+            size_t row = positions[i].second;
+            if (return_columns.size() > num_return_columns &&
+                block.get_by_position(num_return_columns).column->get_int(row) != 0) {
+                continue;
+            }
+            for (size_t j = 0; j < columns.size(); ++j) {
+                columns[j]->insert_from(*block.get_by_position(j).column, row);
+            }
+            found[locations[i].key_idx] = true;
+        }
+        auto result = blocks[0].clone_with_columns(std::move(columns));
+        if (return_columns.size() > num_return_columns) {
+            result.erase(num_return_columns);
+        }
+        size_t uncompressed_bytes = 0;
+        size_t compressed_bytes = 0;
+        std::string column_values;
+        RETURN_IF_ERROR(result.serialize(response->mutable_block(), &uncompressed_bytes,
+                                         &compressed_bytes, &column_values));
+        response->mutable_block()->set_column_values(std::move(column_values));
+    }
+    for (bool key_found : found) {
+        response->add_found(key_found);
+    }
+    return Status::OK();
+}
+
+} // namespace doris
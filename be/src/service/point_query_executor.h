@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+
+#include "common/status.h"
+#include "gen_cpp/internal_service.pb.h"
+
+namespace doris {
+
+// Look up the rows of a UNIQUE KEY tablet with merge-on-write by their full keys, for the point
+// queries like `SELECT * FROM t WHERE pk = ?`. The keys are looked up in the primary key indexes
+// of the segments from the newest rowset to the oldest, skipping the rows marked deleted by the
+// delete bitmap, and the found rows are read by their row ids, so there is no fragment, scan
+// node or scanner involved.
+//
+// The return columns of a prepared statement are cached by its uuid, the later executions of
+// the statement only need to send the keys.
+class PointQueryExecutor {
+public:
+    static Status lookup(const PTabletKeyLookupRequest& request,
+                         PTabletKeyLookupResponse* response);
+
+private:
+    using Slots = google::protobuf::RepeatedPtrField<PSlotDescriptor>;
+
+    // The return columns of the request, or of its prepared statement if it has no slots.
+    static Status _get_slots(const PTabletKeyLookupRequest& request,
+                             std::shared_ptr<const Slots>* slots);
+};
+
+} // namespace doris
@@ -0,0 +1,413 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+// segment_bench scans a segment by SegmentIterator and reports the throughput and the time
+// of each stage, to evaluate the storage read performance (encodings, compressions, page
+// cache and so on) in isolation.
+
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/status.h"
+#include "gutil/strings/numbers.h"
+#include "gutil/strings/split.h"
+#include "gutil/strings/substitute.h"
+#include "olap/comparison_predicate.h"
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/olap_common.h"
+#include "olap/page_cache.h"
+#include "olap/row_block2.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/rowset/segment_v2/segment_writer.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "runtime/memory/chunk_allocator.h"
+#include "util/cpu_info.h"
+#include "util/logging.h"
+#include "util/mem_info.h"
+#include "util/stopwatch.hpp"
+#include "vec/core/block.h"
+
+using doris::ColumnPredicate;
+using doris::FieldType;
+using doris::FilePathDesc;
+using doris::OlapReaderStatistics;
+using doris::RowCursor;
+using doris::RowwiseIterator;
+using doris::Schema;
+using doris::Slice;
+using doris::Status;
+using doris::StorageReadOptions;
+using doris::TabletColumn;
+using doris::TabletSchema;
+using doris::segment_v2::Segment;
+using doris::segment_v2::SegmentWriter;
+using doris::segment_v2::SegmentWriterOptions;
+using strings::Substitute;
+
+DEFINE_string(file, "", "the segment file to scan, a segment is generated if it's empty");
+DEFINE_string(generate_file, "./segment_bench.dat", "the path of the generated segment");
+DEFINE_int32(num_rows, 1000000, "the rows of the generated segment");
+DEFINE_string(column_types, "int,bigint,varchar",
+              "the types of the columns of the generated segment: int, bigint or varchar, "
+              "the first column is the key and its values are increasing");
+DEFINE_int32(cardinality, 1000, "the distinct values of each generated column");
+DEFINE_int32(varchar_length, 32, "the max length of the generated varchar values");
+DEFINE_bool(adaptive_encoding, false, "choose the encodings of the generated columns adaptively");
+DEFINE_bool(zstd_dict_compression, false,
+            "compress the generated string columns by ZSTD with a trained dictionary");
+DEFINE_string(columns, "", "the ordinals of the columns to read, comma separated, all if empty");
+DEFINE_string(predicate, "",
+              "a predicate on an int or bigint column: <ordinal><op><value>, op is one of "
+              "=, !=, <, <=, >, >=, e.g. 0<1000");
+DEFINE_bool(use_page_cache, false, "read the pages through the storage page cache");
+DEFINE_int64(page_cache_mb, 4096, "the capacity of the storage page cache");
+DEFINE_string(mode, "vectorized", "vectorized or row, the block type read from the iterator");
+DEFINE_int32(batch_size, 4096, "the max rows of a block");
+DEFINE_int32(iterations, 3, "the scans of the segment");
+
+std::string get_usage(const std::string& progname) {
+    std::stringstream ss;
+    ss << progname << " scans a segment and reports the read performance.\n";
+    ss << "Usage:\n";
+    ss << "./segment_bench --num_rows=1000000 --column_types=int,bigint,varchar "
+          "--columns=0,2 --predicate=\"0<1000\" --use_page_cache=true\n";
+    ss << "./segment_bench --file=/path/to/segment/file --mode=row --iterations=5\n";
+    return ss.str();
+}
+
+// The schema of the generated segment, a DUP_KEYS table whose first column is the key.
+Status build_tablet_schema(const std::vector<std::string>& types, TabletSchema* tablet_schema) {
+    doris::TabletSchemaPB schema_pb;
+    schema_pb.set_keys_type(doris::DUP_KEYS);
+    schema_pb.set_num_short_key_columns(1);
+    schema_pb.set_num_rows_per_row_block(1024);
+    for (int i = 0; i < types.size(); ++i) {
+        doris::ColumnPB* column = schema_pb.add_column();
+        column->set_unique_id(i);
+        column->set_name(Substitute("c$0", i));
+        column->set_is_key(i == 0);
+        column->set_is_nullable(false);
+        column->set_aggregation("NONE");
+        if (types[i] == "int") {
+            column->set_type("INT");
+            column->set_length(4);
+        } else if (types[i] == "bigint") {
+            column->set_type("BIGINT");
+            column->set_length(8);
+        } else if (types[i] == "varchar") {
+            column->set_type("VARCHAR");
+            column->set_length(FLAGS_varchar_length);
+        } else {
+            return Status::InvalidArgument(Substitute("unsupported column type $0", types[i]));
+        }
+    }
+    schema_pb.set_next_column_unique_id(types.size());
+    tablet_schema->init_from_pb(schema_pb);
+    return Status::OK();
+}
+
+Status generate_segment(const std::string& path, const TabletSchema& tablet_schema) {
+    doris::config::enable_adaptive_column_encoding = FLAGS_adaptive_encoding;
+    doris::config::enable_zstd_dict_compression = FLAGS_zstd_dict_compression;
+
+    std::unique_ptr<doris::fs::WritableBlock> wblock;
+    doris::fs::CreateBlockOptions block_opts(path);
+    FilePathDesc path_desc;
+    path_desc.filepath = path;
+    RETURN_IF_ERROR(
+            doris::fs::fs_util::block_manager(path_desc)->create_block(block_opts, &wblock));
+    SegmentWriter writer(wblock.get(), 0, &tablet_schema, nullptr, INT32_MAX,
+                         SegmentWriterOptions());
+    RETURN_IF_ERROR(writer.init(0));
+
+    RowCursor row;
+    RETURN_IF_ERROR(row.init(tablet_schema));
+    std::mt19937_64 rng(0);
+    std::vector<std::string> strings(tablet_schema.num_columns());
+    for (int64_t rid = 0; rid < FLAGS_num_rows; ++rid) {
+        for (int cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+            // the key is increasing, the values are random
+            int64_t value = cid == 0 ? rid * FLAGS_cardinality / FLAGS_num_rows
+                                     : rng() % FLAGS_cardinality;
+            doris::RowCursorCell cell = row.cell(cid);
+            cell.set_not_null();
+            switch (tablet_schema.column(cid).type()) {
+            case doris::OLAP_FIELD_TYPE_INT:
+                *reinterpret_cast<int32_t*>(cell.mutable_cell_ptr()) = value;
+                break;
+            case doris::OLAP_FIELD_TYPE_BIGINT:
+                *reinterpret_cast<int64_t*>(cell.mutable_cell_ptr()) = value;
+                break;
+            default: {
+                // zero padded, so the order of the strings is the order of the values
+                std::stringstream ss;
+                ss << "value_" << std::setw(FLAGS_varchar_length - 6) << std::setfill('0')
+                   << value;
+                strings[cid] = ss.str().substr(0, FLAGS_varchar_length);
+                *reinterpret_cast<Slice*>(cell.mutable_cell_ptr()) = Slice(strings[cid]);
+                break;
+            }
+            }
+        }
+        RETURN_IF_ERROR(writer.append_row(row));
+    }
+
+    uint64_t file_size = 0;
+    uint64_t index_size = 0;
+    RETURN_IF_ERROR(writer.finalize(&file_size, &index_size));
+    RETURN_IF_ERROR(wblock->close());
+    std::cout << "generated segment " << path << ", rows: " << FLAGS_num_rows
+              << ", file size: " << file_size << ", index size: " << index_size << std::endl;
+    return Status::OK();
+}
+
+// Build the schema of an existing segment from its footer. The segment is opened with an
+// empty schema first, which only reads the footer.
+Status load_tablet_schema(const FilePathDesc& path_desc, TabletSchema* tablet_schema) {
+    TabletSchema empty_schema;
+    std::shared_ptr<Segment> segment;
+    RETURN_IF_ERROR(Segment::open(path_desc, 0, &empty_schema, &segment));
+
+    doris::TabletSchemaPB schema_pb;
+    schema_pb.set_keys_type(doris::DUP_KEYS);
+    schema_pb.set_num_short_key_columns(0);
+    uint32_t next_unique_id = 0;
+    for (const auto& meta : segment->footer().columns()) {
+        if (meta.children_columns_size() > 0) {
+            return Status::NotSupported(Substitute(
+                    "column $0 has sub columns, which is unsupported", meta.column_id()));
+        }
+        doris::ColumnPB* column = schema_pb.add_column();
+        column->set_unique_id(meta.unique_id());
+        column->set_name(Substitute("c$0", meta.column_id()));
+        column->set_type(TabletColumn::get_string_by_field_type(FieldType(meta.type())));
+        column->set_length(meta.length());
+        column->set_is_key(false);
+        column->set_is_nullable(meta.is_nullable());
+        column->set_aggregation("NONE");
+        next_unique_id = std::max(next_unique_id, meta.unique_id() + 1);
+    }
+    schema_pb.set_next_column_unique_id(next_unique_id);
+    tablet_schema->init_from_pb(schema_pb);
+    return Status::OK();
+}
+
+template <typename T>
+ColumnPredicate* new_comparison_predicate(const std::string& op, uint32_t cid, T value) {
+    if (op == "=") {
+        return new doris::EqualPredicate<T>(cid, value);
+    } else if (op == "!=") {
+        return new doris::NotEqualPredicate<T>(cid, value);
+    } else if (op == "<") {
+        return new doris::LessPredicate<T>(cid, value);
+    } else if (op == "<=") {
+        return new doris::LessEqualPredicate<T>(cid, value);
+    } else if (op == ">") {
+        return new doris::GreaterPredicate<T>(cid, value);
+    } else {
+        return new doris::GreaterEqualPredicate<T>(cid, value);
+    }
+}
+
+// Parse --predicate, like "0<1000".
+Status parse_predicate(const TabletSchema& tablet_schema,
+                       std::unique_ptr<ColumnPredicate>* predicate) {
+    const std::string& str = FLAGS_predicate;
+    size_t op_begin = str.find_first_of("=!<>");
+    if (op_begin == std::string::npos || op_begin == 0) {
+        return Status::InvalidArgument(Substitute("invalid predicate $0", str));
+    }
+    size_t op_end = str.find_first_not_of("=!<>", op_begin);
+    std::string op = str.substr(op_begin, op_end - op_begin);
+    uint32_t cid = 0;
+    int64_t value = 0;
+    if (!safe_strtou32(str.substr(0, op_begin), &cid) || cid >= tablet_schema.num_columns() ||
+        op_end == std::string::npos || !safe_strto64(str.substr(op_end), &value) ||
+        (op != "=" && op != "!=" && op != "<" && op != "<=" && op != ">" && op != ">=")) {
+        return Status::InvalidArgument(Substitute("invalid predicate $0", str));
+    }
+    switch (tablet_schema.column(cid).type()) {
+    case doris::OLAP_FIELD_TYPE_INT:
+        predicate->reset(new_comparison_predicate<int32_t>(op, cid, value));
+        break;
+    case doris::OLAP_FIELD_TYPE_BIGINT:
+        predicate->reset(new_comparison_predicate<int64_t>(op, cid, value));
+        break;
+    default:
+        return Status::NotSupported(
+                Substitute("predicate on column $0, which is not int or bigint", cid));
+    }
+    return Status::OK();
+}
+
+// Scan the segment once, return the rows read in *num_rows.
+Status scan(std::shared_ptr<Segment> segment, const TabletSchema& tablet_schema,
+            const std::vector<uint32_t>& column_ids, ColumnPredicate* predicate,
+            OlapReaderStatistics* stats, int64_t* num_rows) {
+    Schema schema(tablet_schema.columns(), column_ids);
+    StorageReadOptions read_opts;
+    read_opts.stats = stats;
+    read_opts.use_page_cache = FLAGS_use_page_cache;
+    read_opts.block_row_max = FLAGS_batch_size;
+    if (predicate != nullptr) {
+        read_opts.column_predicates.push_back(predicate);
+    }
+    std::unique_ptr<RowwiseIterator> iter;
+    RETURN_IF_ERROR(segment->new_iterator(schema, read_opts, &iter));
+
+    Status st;
+    if (FLAGS_mode == "row") {
+        doris::RowBlockV2 block(schema, FLAGS_batch_size);
+        while ((st = iter->next_batch(&block)).ok()) {
+            *num_rows += block.num_rows();
+            block.clear();
+        }
+    } else {
+        doris::vectorized::Block block = tablet_schema.create_block(column_ids);
+        while ((st = iter->next_batch(&block)).ok()) {
+            *num_rows += block.rows();
+            block.clear_column_data();
+        }
+    }
+    return st.is_end_of_file() ? Status::OK() : st;
+}
+
+void print_stats(const OlapReaderStatistics& stats, int64_t num_rows, int64_t elapsed_ns) {
+    double seconds = elapsed_ns / 1e9;
+    auto ms = [](int64_t ns) { return Substitute("$0 ms", ns / 1000000.0); };
+    std::cout << "rows: " << num_rows << ", time: " << ms(elapsed_ns)
+              << ", rows/s: " << static_cast<int64_t>(num_rows / seconds)
+              << ", bytes/s: " << static_cast<int64_t>(stats.uncompressed_bytes_read / seconds)
+              << ", compressed bytes/s: "
+              << static_cast<int64_t>(stats.compressed_bytes_read / seconds) << "\n";
+    std::cout << "  pages: " << stats.total_pages_num << ", cached pages: "
+              << stats.cached_pages_num << ", compressed bytes: " << stats.compressed_bytes_read
+              << ", uncompressed bytes: " << stats.uncompressed_bytes_read << "\n";
+    std::cout << "  rows filtered by zone maps: " << stats.rows_stats_filtered
+              << ", by bloom filters: " << stats.rows_bf_filtered
+              << ", by predicates: " << stats.rows_vec_cond_filtered << "\n";
+    std::cout << "  index load: " << ms(stats.index_load_ns) << ", io: " << ms(stats.io_ns)
+              << ", decompress: " << ms(stats.decompress_ns)
+              << ", block load: " << ms(stats.block_load_ns)
+              << ", first read: " << ms(stats.first_read_ns)
+              << ", lazy read: " << ms(stats.lazy_read_ns)
+              << ", vec cond: " << ms(stats.vec_cond_ns)
+              << ", short cond: " << ms(stats.short_cond_ns)
+              << ", output column: " << ms(stats.output_col_ns) << "\n";
+}
+
+Status run() {
+    if (FLAGS_mode != "vectorized" && FLAGS_mode != "row") {
+        return Status::InvalidArgument(Substitute("invalid mode $0", FLAGS_mode));
+    }
+    if (FLAGS_batch_size <= 0 || FLAGS_batch_size > UINT16_MAX) {
+        return Status::InvalidArgument(Substitute("invalid batch size $0", FLAGS_batch_size));
+    }
+    TabletSchema tablet_schema;
+    FilePathDesc path_desc;
+    if (FLAGS_file.empty()) {
+        if (FLAGS_num_rows <= 0 || FLAGS_cardinality <= 0 || FLAGS_varchar_length <= 6) {
+            return Status::InvalidArgument("invalid num_rows, cardinality or varchar_length");
+        }
+        std::vector<std::string> types = strings::Split(FLAGS_column_types, ",");
+        RETURN_IF_ERROR(build_tablet_schema(types, &tablet_schema));
+        RETURN_IF_ERROR(generate_segment(FLAGS_generate_file, tablet_schema));
+        path_desc.filepath = FLAGS_generate_file;
+    } else {
+        path_desc.filepath = FLAGS_file;
+        RETURN_IF_ERROR(load_tablet_schema(path_desc, &tablet_schema));
+    }
+
+    std::vector<uint32_t> column_ids;
+    if (FLAGS_columns.empty()) {
+        for (uint32_t cid = 0; cid < tablet_schema.num_columns(); ++cid) {
+            column_ids.push_back(cid);
+        }
+    } else {
+        std::vector<std::string> columns = strings::Split(FLAGS_columns, ",");
+        for (const auto& str : columns) {
+            uint32_t cid = 0;
+            if (!safe_strtou32(str, &cid) || cid >= tablet_schema.num_columns()) {
+                return Status::InvalidArgument(Substitute("invalid column $0", str));
+            }
+            column_ids.push_back(cid);
+        }
+    }
+    std::unique_ptr<ColumnPredicate> predicate;
+    if (!FLAGS_predicate.empty()) {
+        RETURN_IF_ERROR(parse_predicate(tablet_schema, &predicate));
+        // the predicate column must be read
+        if (std::find(column_ids.begin(), column_ids.end(), predicate->column_id()) ==
+            column_ids.end()) {
+            column_ids.push_back(predicate->column_id());
+        }
+    }
+
+    std::shared_ptr<Segment> segment;
+    RETURN_IF_ERROR(Segment::open(path_desc, 0, &tablet_schema, &segment));
+    std::cout << "segment " << path_desc.filepath << ", rows: " << segment->num_rows()
+              << ", columns: " << tablet_schema.num_columns() << ", mode: " << FLAGS_mode
+              << ", page cache: " << (FLAGS_use_page_cache ? "on" : "off") << std::endl;
+
+    for (int i = 0; i < FLAGS_iterations; ++i) {
+        OlapReaderStatistics stats;
+        int64_t num_rows = 0;
+        doris::MonotonicStopWatch watch;
+        watch.start();
+        RETURN_IF_ERROR(scan(segment, tablet_schema, column_ids, predicate.get(), &stats,
+                             &num_rows));
+        int64_t elapsed_ns = watch.elapsed_time();
+        std::cout << "iteration " << i << ": ";
+        print_stats(stats, num_rows, elapsed_ns);
+    }
+    return Status::OK();
+}
+
+int main(int argc, char** argv) {
+    std::string usage = get_usage(argv[0]);
+    gflags::SetUsageMessage(usage);
+    google::ParseCommandLineFlags(&argc, &argv, true);
+
+    // the default config, be.conf is not required
+    doris::config::init(nullptr, false);
+    doris::init_glog("segment_bench");
+    doris::CpuInfo::init();
+    doris::MemInfo::init();
+    doris::ChunkAllocator::init_instance(doris::config::chunk_reserved_bytes_limit);
+    doris::StoragePageCache::create_global_cache(FLAGS_page_cache_mb * 1024 * 1024, 10);
+
+    Status st = run();
+    if (!st.ok()) {
+        std::cout << "segment_bench failed: " << st.to_string() << std::endl;
+        return -1;
+    }
+    gflags::ShutDownCommandLineFlags();
+    return 0;
+}
@@ -0,0 +1,282 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/arrow/block_convertor.h"
+
+#include <arrow/array.h>
+#include <arrow/buffer.h>
+#include <arrow/builder.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+
+#include <limits>
+
+#include "gutil/strings/substitute.h"
+#include "util/arrow/utils.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type.h"
+#include "vec/data_types/data_type_nullable.h"
+
+namespace doris {
+
+namespace {
+
+// an arrow buffer over the data of a column, which keeps the column alive
+class ColumnBuffer : public arrow::Buffer {
+public:
+    ColumnBuffer(vectorized::ColumnPtr column, StringRef data)
+            : arrow::Buffer(reinterpret_cast<const uint8_t*>(data.data), data.size),
+              _column(std::move(column)) {}
+
+private:
+    vectorized::ColumnPtr _column;
+};
+
+Status allocate_buffer(int64_t size, arrow::MemoryPool* pool,
+                       std::shared_ptr<arrow::Buffer>* buffer) {
+    auto res = arrow::AllocateBuffer(size, pool);
+    if (!res.ok()) {
+        return to_status(res.status());
+    }
+    *buffer = std::move(res).ValueOrDie();
+    return Status::OK();
+}
+
+// the validity bitmap of the null map, nullptr if there are no nulls
+Status convert_null_map(const vectorized::NullMap* null_map, arrow::MemoryPool* pool,
+                        std::shared_ptr<arrow::Buffer>* bitmap, int64_t* null_count) {
+    *null_count = 0;
+    if (null_map == nullptr) {
+        return Status::OK();
+    }
+    size_t num_rows = null_map->size();
+    for (size_t i = 0; i < num_rows; ++i) {
+        *null_count += (*null_map)[i];
+    }
+    if (*null_count == 0) {
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(allocate_buffer((num_rows + 7) / 8, pool, bitmap));
+    uint8_t* bits = (*bitmap)->mutable_data();
+    memset(bits, 0, (num_rows + 7) / 8);
+    for (size_t i = 0; i < num_rows; ++i) {
+        bits[i >> 3] |= static_cast<uint8_t>(!(*null_map)[i]) << (i & 7);
+    }
+    return Status::OK();
+}
+
+// the arrow type of the same layout as the numeric or decimal data type
+arrow::Type::type same_layout_type(const vectorized::DataTypePtr& data_type) {
+    vectorized::WhichDataType which(data_type);
+    if (which.is_int8()) {
+        return arrow::Type::INT8;
+    } else if (which.is_int16()) {
+        return arrow::Type::INT16;
+    } else if (which.is_int32()) {
+        return arrow::Type::INT32;
+    } else if (which.is_int64()) {
+        return arrow::Type::INT64;
+    } else if (which.is_float32()) {
+        return arrow::Type::FLOAT;
+    } else if (which.is_float64()) {
+        return arrow::Type::DOUBLE;
+    } else if (which.is_decimal128()) {
+        return arrow::Type::DECIMAL128;
+    }
+    return arrow::Type::NA;
+}
+
+template <typename T>
+Status cast_numeric_column(const vectorized::IColumn& column, arrow::MemoryPool* pool,
+                           std::shared_ptr<arrow::Buffer>* buffer) {
+    size_t num_rows = column.size();
+    RETURN_IF_ERROR(allocate_buffer(num_rows * sizeof(T), pool, buffer));
+    auto values = reinterpret_cast<T*>((*buffer)->mutable_data());
+    for (size_t i = 0; i < num_rows; ++i) {
+        if constexpr (std::is_floating_point_v<T>) {
+            values[i] = static_cast<T>(column.get_float64(i));
+        } else {
+            values[i] = static_cast<T>(column.get_int(i));
+        }
+    }
+    return Status::OK();
+}
+
+// cast the values of a numeric column of another type, e.g. a SMALLINT column written as int32
+Status cast_numeric_column(const vectorized::IColumn& column, arrow::Type::type type,
+                           arrow::MemoryPool* pool, std::shared_ptr<arrow::Buffer>* buffer) {
+    switch (type) {
+    case arrow::Type::INT8:
+        return cast_numeric_column<int8_t>(column, pool, buffer);
+    case arrow::Type::INT16:
+        return cast_numeric_column<int16_t>(column, pool, buffer);
+    case arrow::Type::INT32:
+        return cast_numeric_column<int32_t>(column, pool, buffer);
+    case arrow::Type::INT64:
+        return cast_numeric_column<int64_t>(column, pool, buffer);
+    case arrow::Type::FLOAT:
+        return cast_numeric_column<float>(column, pool, buffer);
+    case arrow::Type::DOUBLE:
+        return cast_numeric_column<double>(column, pool, buffer);
+    default:
+        return Status::InvalidArgument("not a numeric arrow type");
+    }
+}
+
+// the chars of a ColumnString are terminated by zeros, so they are copied without them
+Status convert_string_column(const vectorized::ColumnString& column, arrow::MemoryPool* pool,
+                             std::shared_ptr<arrow::Buffer>* offsets,
+                             std::shared_ptr<arrow::Buffer>* data) {
+    size_t num_rows = column.size();
+    size_t data_size = column.get_chars().size() - num_rows;
+    if (data_size > static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        return Status::InternalError(strings::Substitute(
+                "too large string column to convert to arrow: $0 bytes", data_size));
+    }
+    RETURN_IF_ERROR(allocate_buffer((num_rows + 1) * sizeof(int32_t), pool, offsets));
+    RETURN_IF_ERROR(allocate_buffer(data_size, pool, data));
+    auto offset_data = reinterpret_cast<int32_t*>((*offsets)->mutable_data());
+    uint8_t* chars = (*data)->mutable_data();
+    int32_t offset = 0;
+    offset_data[0] = 0;
+    for (size_t i = 0; i < num_rows; ++i) {
+        StringRef value = column.get_data_at(i);
+        memcpy(chars + offset, value.data, value.size);
+        offset += value.size;
+        offset_data[i + 1] = offset;
+    }
+    return Status::OK();
+}
+
+Status convert_column(const vectorized::ColumnWithTypeAndName& entry,
+                      const std::shared_ptr<arrow::Field>& field, arrow::MemoryPool* pool,
+                      std::shared_ptr<arrow::Array>* result) {
+    vectorized::ColumnPtr column = entry.column->convert_to_full_column_if_const();
+    vectorized::ColumnPtr data_column = column;
+    const vectorized::NullMap* null_map = nullptr;
+    if (const auto* nullable = vectorized::check_and_get_column<vectorized::ColumnNullable>(
+                *column)) {
+        data_column = nullable->get_nested_column_ptr();
+        null_map = &nullable->get_null_map_data();
+    }
+    auto data_type = vectorized::remove_nullable(entry.type);
+    int64_t num_rows = column->size();
+
+    std::shared_ptr<arrow::Buffer> bitmap;
+    int64_t null_count = 0;
+    RETURN_IF_ERROR(convert_null_map(null_map, pool, &bitmap, &null_count));
+
+    const auto& type = field->type();
+    switch (type->id()) {
+    case arrow::Type::INT8:
+    case arrow::Type::INT16:
+    case arrow::Type::INT32:
+    case arrow::Type::INT64:
+    case arrow::Type::FLOAT:
+    case arrow::Type::DOUBLE:
+    case arrow::Type::DECIMAL128: {
+        std::shared_ptr<arrow::Buffer> buffer;
+        if (same_layout_type(data_type) == type->id()) {
+            // the same layout as the columns of the corresponding types, DECIMALV2 included
+            buffer = std::make_shared<ColumnBuffer>(data_column, data_column->get_raw_data());
+        } else if (type->id() != arrow::Type::DECIMAL128 && data_column->is_numeric()) {
+            RETURN_IF_ERROR(cast_numeric_column(*data_column, type->id(), pool, &buffer));
+        } else {
+            return Status::InternalError(strings::Substitute(
+                    "column $0 of type $1 can't be converted to arrow type $2", entry.name,
+                    data_type->get_name(), type->ToString()));
+        }
+        *result = arrow::MakeArray(
+                arrow::ArrayData::Make(type, num_rows, {bitmap, buffer}, null_count));
+        break;
+    }
+    case arrow::Type::STRING: {
+        std::shared_ptr<arrow::Buffer> offsets;
+        std::shared_ptr<arrow::Buffer> data;
+        if (const auto* strings =
+                    vectorized::check_and_get_column<vectorized::ColumnString>(*data_column)) {
+            RETURN_IF_ERROR(convert_string_column(*strings, pool, &offsets, &data));
+            *result = arrow::MakeArray(arrow::ArrayData::Make(
+                    type, num_rows, {bitmap, offsets, data}, null_count));
+            break;
+        }
+        // LARGEINT, DATE, DATETIME and HLL are converted to their text forms
+        arrow::StringBuilder builder(pool);
+        for (int64_t i = 0; i < num_rows; ++i) {
+            arrow::Status st;
+            if (null_map != nullptr && (*null_map)[i]) {
+                st = builder.AppendNull();
+            } else {
+                st = builder.Append(data_type->to_string(*data_column, i));
+            }
+            RETURN_IF_ERROR(to_status(st));
+        }
+        RETURN_IF_ERROR(to_status(builder.Finish(result)));
+        break;
+    }
+    case arrow::Type::BOOL: {
+        // a byte per value in the column, a bit in arrow
+        StringRef data = data_column->get_raw_data();
+        if (static_cast<int64_t>(data.size) != num_rows) {
+            return Status::InternalError(strings::Substitute(
+                    "column $0 of type $1 can't be converted to arrow type $2", entry.name,
+                    data_type->get_name(), type->ToString()));
+        }
+        arrow::BooleanBuilder builder(pool);
+        for (int64_t i = 0; i < num_rows; ++i) {
+            arrow::Status st;
+            if (null_map != nullptr && (*null_map)[i]) {
+                st = builder.AppendNull();
+            } else {
+                st = builder.Append(data.data[i] != 0);
+            }
+            RETURN_IF_ERROR(to_status(st));
+        }
+        RETURN_IF_ERROR(to_status(builder.Finish(result)));
+        break;
+    }
+    default:
+        return Status::InvalidArgument(
+                strings::Substitute("unsupported arrow type $0", type->ToString()));
+    }
+    return Status::OK();
+}
+
+} // namespace
+
+Status convert_to_arrow_batch(const vectorized::Block& block,
+                              const std::shared_ptr<arrow::Schema>& schema, arrow::MemoryPool* pool,
+                              std::shared_ptr<arrow::RecordBatch>* result) {
+    if (static_cast<int>(block.columns()) != schema->num_fields()) {
+        return Status::InvalidArgument(strings::Substitute(
+                "block of $0 columns doesn't match arrow schema of $1 fields", block.columns(),
+                schema->num_fields()));
+    }
+    std::vector<std::shared_ptr<arrow::Array>> arrays(block.columns());
+    for (size_t i = 0; i < block.columns(); ++i) {
+        RETURN_IF_ERROR(convert_column(block.get_by_position(i), schema->field(i), pool,
+                                       &arrays[i]));
+    }
+    *result = arrow::RecordBatch::Make(schema, block.rows(), std::move(arrays));
+    return Status::OK();
+}
+
+} // namespace doris
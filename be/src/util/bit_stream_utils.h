@@ -111,6 +111,10 @@ public:
     // beginning of a byte. Return false if there were not enough bytes in the buffer.
     bool GetVlqInt(int32_t* v);
 
+    // Returns the next 'num_bytes' bytes of the stream, which must be at the start of a byte,
+    // and advances the stream past them. Returns nullptr if there are not enough bytes left.
+    const uint8_t* GetAlignedBytes(int num_bytes);
+
     // Returns the number of bytes left in the stream, not including the current byte (i.e.,
     // there may be an additional fraction of a byte).
     int bytes_left() { return max_bytes_ - (byte_offset_ + BitUtil::Ceil(bit_offset_, 8)); }
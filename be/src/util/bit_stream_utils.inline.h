@@ -194,6 +194,19 @@ inline bool BitReader::GetAligned(int num_bytes, T* v) {
     return true;
 }
 
+inline const uint8_t* BitReader::GetAlignedBytes(int num_bytes) {
+    DCHECK_EQ(bit_offset_ % 8, 0);
+    int bytes_read = bit_offset_ / 8;
+    if (PREDICT_FALSE(byte_offset_ + bytes_read + num_bytes > max_bytes_)) return nullptr;
+
+    byte_offset_ += bytes_read;
+    const uint8_t* bytes = buffer_ + byte_offset_;
+    byte_offset_ += num_bytes;
+    bit_offset_ = 0;
+    BufferValues();
+    return bytes;
+}
+
 inline bool BitReader::GetVlqInt(int32_t* v) {
     *v = 0;
     int shift = 0;
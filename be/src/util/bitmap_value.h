@@ -31,6 +31,7 @@
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "common/logging.h"
 #include "udf/udf.h"
@@ -119,7 +120,8 @@ public:
 
     Roaring64Map(const Roaring64Map& r) : roarings(r.roarings), copyOnWrite(r.copyOnWrite) {}
 
-    Roaring64Map(Roaring64Map&& r) : roarings(r.roarings), copyOnWrite(r.copyOnWrite) {}
+    Roaring64Map(Roaring64Map&& r)
+            : roarings(std::move(r.roarings)), copyOnWrite(r.copyOnWrite) {}
 
     /**
      * Assignment operator.
@@ -129,6 +131,11 @@ public:
         return *this;
     }
 
+    Roaring64Map& operator=(Roaring64Map&& r) {
+        roarings = std::move(r.roarings);
+        return *this;
+    }
+
     /**
      * Construct a bitmap from a list of integer values.
      */
@@ -176,15 +183,24 @@ public:
      *
      */
     void addMany(size_t n_args, const uint32_t* vals) {
-        for (size_t lcv = 0; lcv < n_args; lcv++) {
-            roarings[0].add(vals[lcv]);
-            roarings[0].setCopyOnWrite(copyOnWrite);
-        }
+        roarings[0].addMany(n_args, vals);
+        roarings[0].setCopyOnWrite(copyOnWrite);
     }
+    // The values sharing the high 32 bits with the previous one are added to the same 32-bit
+    // bitmap in bulk, without looking up the map for each of them.
     void addMany(size_t n_args, const uint64_t* vals) {
-        for (size_t lcv = 0; lcv < n_args; lcv++) {
-            roarings[highBytes(vals[lcv])].add(lowBytes(vals[lcv]));
-            roarings[highBytes(vals[lcv])].setCopyOnWrite(copyOnWrite);
+        constexpr size_t BATCH_SIZE = 256;
+        uint32_t low_bytes[BATCH_SIZE];
+        size_t lcv = 0;
+        while (lcv < n_args) {
+            uint32_t high_bytes = highBytes(vals[lcv]);
+            size_t n = 0;
+            do {
+                low_bytes[n++] = lowBytes(vals[lcv++]);
+            } while (lcv < n_args && n < BATCH_SIZE && highBytes(vals[lcv]) == high_bytes);
+            auto& roaring = roarings[high_bytes];
+            roaring.addMany(n, low_bytes);
+            roaring.setCopyOnWrite(copyOnWrite);
         }
     }
 
@@ -894,10 +910,20 @@ public:
      * pointer).
      */
     static Roaring64Map fastunion(size_t n, const Roaring64Map** inputs) {
-        Roaring64Map ans;
-        // not particularly fast
+        // the 32-bit bitmaps of the same high 32 bits are unioned by one roaring fastunion
+        std::map<uint32_t, std::vector<const roaring::Roaring*>> groups;
         for (size_t lcv = 0; lcv < n; ++lcv) {
-            ans |= *(inputs[lcv]);
+            for (const auto& map_entry : inputs[lcv]->roarings) {
+                groups[map_entry.first].push_back(&map_entry.second);
+            }
+        }
+        Roaring64Map ans;
+        for (auto& [key, group] : groups) {
+            if (group.size() == 1) {
+                ans.roarings.emplace(key, *group[0]);
+            } else {
+                ans.roarings.emplace(key, roaring::Roaring::fastunion(group.size(), group.data()));
+            }
         }
         return ans;
     }
@@ -1159,6 +1185,32 @@ public:
         }
     }
 
+    // Add the values in bulk, the bitmap is converted at most once.
+    void add_many(const uint64_t* values, size_t n) {
+        if (n == 0) {
+            return;
+        }
+        switch (_type) {
+        case EMPTY:
+            if (n == 1) {
+                _sv = values[0];
+                _type = SINGLE;
+                return;
+            }
+            break;
+        case SINGLE:
+            _bitmap.add(_sv);
+            break;
+        case BITMAP:
+            _bitmap.addMany(n, values);
+            return;
+        }
+        _bitmap.addMany(n, values);
+        _type = BITMAP;
+        // the values may all be the same one
+        _convert_to_smaller_type();
+    }
+
     void add(uint64_t value) {
         switch (_type) {
         case EMPTY:
@@ -1253,6 +1305,44 @@ public:
         return *this;
     }
 
+    // Compute the union between the current bitmap and all the provided bitmaps. The bitmaps are
+    // unioned by one fastunion and the single values are added in bulk, so the current bitmap is
+    // converted at most once.
+    BitmapValue& fastunion(const std::vector<const BitmapValue*>& values) {
+        std::vector<const detail::Roaring64Map*> bitmaps;
+        std::vector<uint64_t> single_values;
+        auto collect = [&](const BitmapValue& value) {
+            switch (value._type) {
+            case EMPTY:
+                break;
+            case SINGLE:
+                single_values.push_back(value._sv);
+                break;
+            case BITMAP:
+                bitmaps.push_back(&value._bitmap);
+                break;
+            }
+        };
+        collect(*this);
+        for (const auto* value : values) {
+            collect(*value);
+        }
+
+        if (bitmaps.empty()) {
+            _type = EMPTY;
+        } else if (bitmaps.size() == 1) {
+            if (bitmaps[0] != &_bitmap) {
+                _bitmap = *bitmaps[0];
+            }
+            _type = BITMAP;
+        } else {
+            _bitmap = detail::Roaring64Map::fastunion(bitmaps.size(), bitmaps.data());
+            _type = BITMAP;
+        }
+        add_many(single_values.data(), single_values.size());
+        return *this;
+    }
+
     // Compute the intersection between the current bitmap and the provided bitmap.
     // Possible type transitions are:
     // SINGLE -> EMPTY
@@ -21,10 +21,14 @@
 #include <lz4/lz4frame.h>
 #include <snappy/snappy-sinksource.h>
 #include <snappy/snappy.h>
+#include <zdict.h>
 #include <zlib.h>
+#include <zstd.h>
 
 #include <limits>
+#include <memory>
 
+#include "common/logging.h"
 #include "gutil/strings/substitute.h"
 #include "util/faststring.h"
 
@@ -369,6 +373,159 @@ public:
     }
 };
 
+static constexpr int ZSTD_COMPRESSION_LEVEL = 3;
+
+// The ZSTD contexts are cached per thread, because a codec is shared by all readers of a column
+struct ZstdContextDeleter {
+    void operator()(ZSTD_CCtx* ctx) const { ZSTD_freeCCtx(ctx); }
+    void operator()(ZSTD_DCtx* ctx) const { ZSTD_freeDCtx(ctx); }
+};
+
+static ZSTD_CCtx* zstd_thread_local_cctx() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> s_cctx(ZSTD_createCCtx());
+    return s_cctx.get();
+}
+
+static ZSTD_DCtx* zstd_thread_local_dctx() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> s_dctx(ZSTD_createDCtx());
+    return s_dctx.get();
+}
+
+class ZstdBlockCompression : public BlockCompressionCodec {
+public:
+    static const ZstdBlockCompression* instance() {
+        static ZstdBlockCompression s_instance;
+        return &s_instance;
+    }
+    ~ZstdBlockCompression() override {}
+
+    Status compress(const Slice& input, Slice* output) const override {
+        auto ctx = zstd_thread_local_cctx();
+        if (ctx == nullptr) {
+            return Status::InvalidArgument("Fail to create ZSTD compress context");
+        }
+        size_t res = ZSTD_compressCCtx(ctx, output->data, output->size, input.data, input.size,
+                                       ZSTD_COMPRESSION_LEVEL);
+        if (ZSTD_isError(res)) {
+            return Status::InvalidArgument(
+                    Substitute("Fail to do ZSTD compress, error=$0", ZSTD_getErrorName(res)));
+        }
+        output->size = res;
+        return Status::OK();
+    }
+
+    Status decompress(const Slice& input, Slice* output) const override {
+        auto ctx = zstd_thread_local_dctx();
+        if (ctx == nullptr) {
+            return Status::InvalidArgument("Fail to create ZSTD decompress context");
+        }
+        size_t res = ZSTD_decompressDCtx(ctx, output->data, output->size, input.data, input.size);
+        if (ZSTD_isError(res)) {
+            return Status::InvalidArgument(
+                    Substitute("Fail to do ZSTD decompress, error=$0", ZSTD_getErrorName(res)));
+        }
+        output->size = res;
+        return Status::OK();
+    }
+
+    size_t max_compressed_len(size_t len) const override { return ZSTD_compressBound(len); }
+};
+
+// ZSTD with a dictionary trained from the data of the same column, which improves the ratio
+// of the small pages a lot. The digested dictionaries are read only, so the codec can be shared.
+class ZstdDictBlockCompression final : public ZstdBlockCompression {
+public:
+    ZstdDictBlockCompression(ZSTD_CDict* cdict, ZSTD_DDict* ddict) : _cdict(cdict), _ddict(ddict) {}
+
+    ~ZstdDictBlockCompression() override {
+        ZSTD_freeCDict(_cdict);
+        ZSTD_freeDDict(_ddict);
+    }
+
+    Status compress(const Slice& input, Slice* output) const override {
+        auto ctx = zstd_thread_local_cctx();
+        if (ctx == nullptr) {
+            return Status::InvalidArgument("Fail to create ZSTD compress context");
+        }
+        size_t res = ZSTD_compress_usingCDict(ctx, output->data, output->size, input.data,
+                                              input.size, _cdict);
+        if (ZSTD_isError(res)) {
+            return Status::InvalidArgument(Substitute(
+                    "Fail to do ZSTD compress with dictionary, error=$0", ZSTD_getErrorName(res)));
+        }
+        output->size = res;
+        return Status::OK();
+    }
+
+    Status decompress(const Slice& input, Slice* output) const override {
+        auto ctx = zstd_thread_local_dctx();
+        if (ctx == nullptr) {
+            return Status::InvalidArgument("Fail to create ZSTD decompress context");
+        }
+        size_t res = ZSTD_decompress_usingDDict(ctx, output->data, output->size, input.data,
+                                                input.size, _ddict);
+        if (ZSTD_isError(res)) {
+            return Status::InvalidArgument(
+                    Substitute("Fail to do ZSTD decompress with dictionary, error=$0",
+                               ZSTD_getErrorName(res)));
+        }
+        output->size = res;
+        return Status::OK();
+    }
+
+private:
+    ZSTD_CDict* _cdict;
+    ZSTD_DDict* _ddict;
+};
+
+Status get_block_compression_codec(segment_v2::CompressionTypePB type, const Slice& dict,
+                                   std::unique_ptr<BlockCompressionCodec>* codec) {
+    if (type != segment_v2::CompressionTypePB::ZSTD) {
+        return Status::NotSupported(
+                Substitute("compression type($0) doesn't support dictionary", type));
+    }
+    ZSTD_CDict* cdict = ZSTD_createCDict(dict.data, dict.size, ZSTD_COMPRESSION_LEVEL);
+    ZSTD_DDict* ddict = ZSTD_createDDict(dict.data, dict.size);
+    if (cdict == nullptr || ddict == nullptr) {
+        ZSTD_freeCDict(cdict);
+        ZSTD_freeDDict(ddict);
+        return Status::Corruption("Fail to load ZSTD dictionary");
+    }
+    codec->reset(new ZstdDictBlockCompression(cdict, ddict));
+    return Status::OK();
+}
+
+Status train_compression_dict(segment_v2::CompressionTypePB type,
+                              const std::vector<Slice>& samples, size_t max_dict_size,
+                              std::string* dict) {
+    dict->clear();
+    if (type != segment_v2::CompressionTypePB::ZSTD) {
+        return Status::NotSupported(
+                Substitute("compression type($0) doesn't support dictionary", type));
+    }
+    faststring samples_buffer;
+    std::vector<size_t> sample_sizes;
+    for (auto& sample : samples) {
+        if (sample.size == 0) {
+            continue;
+        }
+        samples_buffer.append(sample.data, sample.size);
+        sample_sizes.push_back(sample.size);
+    }
+    dict->resize(max_dict_size);
+    size_t res = ZDICT_trainFromBuffer(dict->data(), dict->size(), samples_buffer.data(),
+                                       sample_sizes.data(), sample_sizes.size());
+    if (ZDICT_isError(res)) {
+        // usually there are too few samples, the pages are compressed without dictionary
+        dict->clear();
+        VLOG_DEBUG << "fail to train ZSTD dictionary from " << sample_sizes.size()
+                   << " samples, error=" << ZDICT_getErrorName(res);
+        return Status::OK();
+    }
+    dict->resize(res);
+    return Status::OK();
+}
+
 Status get_block_compression_codec(segment_v2::CompressionTypePB type,
                                    const BlockCompressionCodec** codec) {
     switch (type) {
@@ -387,6 +544,9 @@ Status get_block_compression_codec(segment_v2::CompressionTypePB type,
     case segment_v2::CompressionTypePB::ZLIB:
         *codec = ZlibBlockCompression::instance();
         break;
+    case segment_v2::CompressionTypePB::ZSTD:
+        *codec = ZstdBlockCompression::instance();
+        break;
     default:
         return Status::NotFound(strings::Substitute("unknown compression type($0)", type));
     }
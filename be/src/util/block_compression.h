@@ -18,6 +18,8 @@
 #pragma once
 
 #include <cstddef>
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "common/status.h"
@@ -63,4 +65,16 @@ public:
 Status get_block_compression_codec(segment_v2::CompressionTypePB type,
                                    const BlockCompressionCodec** codec);
 
+// Create a BlockCompressionCodec of `type' which compresses with the dictionary `dict'.
+// Only ZSTD supports dictionary now. The codec is owned by the caller, and can be used by
+// multiple threads.
+Status get_block_compression_codec(segment_v2::CompressionTypePB type, const Slice& dict,
+                                   std::unique_ptr<BlockCompressionCodec>* codec);
+
+// Train a dictionary of at most `max_dict_size' bytes for `type' from `samples'.
+// `dict' is empty if the dictionary can't be trained, e.g. there are too few samples.
+Status train_compression_dict(segment_v2::CompressionTypePB type,
+                              const std::vector<Slice>& samples, size_t max_dict_size,
+                              std::string* dict);
+
 } // namespace doris
@@ -149,6 +149,19 @@ public:
         return true;
     }
 
+    // Puts an element into the queue if there is space, without waiting.
+    // If the queue is full or shut down, returns false.
+    bool try_put(const T& val) {
+        std::unique_lock<std::mutex> unique_lock(_lock);
+        if (_queue.size() >= _max_element || _shutdown) {
+            return false;
+        }
+        _queue.push(val);
+        unique_lock.unlock();
+        _get_cv.notify_one();
+        return true;
+    }
+
     // Shut down the queue. Wakes up all threads waiting on blocking_get or blocking_put.
     void shutdown() {
         {
@@ -104,6 +104,13 @@ inline uint128_t decode_fixed128_le(const uint8_t* buf) {
 #endif
 }
 
+template <typename T>
+inline void put_fixed16_le(T* dst, uint16_t val) {
+    uint8_t buf[sizeof(val)];
+    encode_fixed16_le(buf, val);
+    dst->append((char*)buf, sizeof(buf));
+}
+
 template <typename T>
 inline void put_fixed32_le(T* dst, uint32_t val) {
     uint8_t buf[sizeof(val)];
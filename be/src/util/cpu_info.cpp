@@ -37,6 +37,7 @@
 #include <spe.h>
 #endif
 
+#include <pthread.h>
 #include <sched.h>
 #include <stdlib.h>
 #include <string.h>
@@ -103,6 +104,8 @@ static struct {
 } flag_mappings[] = {
         {"ssse3", CpuInfo::SSSE3},   {"sse4_1", CpuInfo::SSE4_1}, {"sse4_2", CpuInfo::SSE4_2},
         {"popcnt", CpuInfo::POPCNT}, {"avx", CpuInfo::AVX},       {"avx2", CpuInfo::AVX2},
+        {"avx512f", CpuInfo::AVX512F}, {"avx512bw", CpuInfo::AVX512BW},
+        {"avx512vbmi", CpuInfo::AVX512VBMI},
 };
 static const long num_flags = sizeof(flag_mappings) / sizeof(flag_mappings[0]);
 
@@ -316,6 +319,20 @@ int CpuInfo::get_current_core() {
 #endif
 }
 
+Status CpuInfo::bind_current_thread_to_numa_node(int node) {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int core : get_cores_of_numa_node(node)) {
+        CPU_SET(core, &cpu_set);
+    }
+    int ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (ret != 0) {
+        return Status::InternalError(strings::Substitute(
+                "failed to bind the thread to the NUMA node $0: $1", node, strerror(ret)));
+    }
+    return Status::OK();
+}
+
 void CpuInfo::_get_cache_info(long cache_sizes[NUM_CACHE_LEVELS],
                               long cache_line_sizes[NUM_CACHE_LEVELS]) {
 #ifdef __APPLE__
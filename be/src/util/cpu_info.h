@@ -26,6 +26,7 @@
 #include <vector>
 
 #include "common/logging.h"
+#include "common/status.h"
 
 namespace doris {
 
@@ -41,6 +42,9 @@ public:
     static const int64_t POPCNT = (1 << 4);
     static const int64_t AVX = (1 << 5);
     static const int64_t AVX2 = (1 << 6);
+    static const int64_t AVX512F = (1 << 7);
+    static const int64_t AVX512BW = (1 << 8);
+    static const int64_t AVX512VBMI = (1 << 9);
 
     /// Cache enums for L1 (data), L2 and L3
     enum CacheLevel {
@@ -131,6 +135,11 @@ public:
         return get_cores_of_numa_node(get_numa_node_of_core(core));
     }
 
+    /// Restricts the calling thread to the cores of the NUMA node 'node', so the memory it
+    /// touches first is allocated on the node. 'node' must be in the range
+    /// [0, GetMaxNumNumaNodes()).
+    static Status bind_current_thread_to_numa_node(int node);
+
     /// Returns the index of the given core within the vector returned by
     /// GetCoresOfNumaNode() and GetCoresOfSameNumaNode(). 'core' must be in the range
     /// [0, GetMaxNumCores()).
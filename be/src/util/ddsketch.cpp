@@ -0,0 +1,296 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/ddsketch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "common/logging.h"
+#include "util/coding.h"
+
+namespace doris {
+
+// the max number of the buckets of a deserialized sketch, to reject corrupted data
+static constexpr uint32_t MAX_NUM_BUCKETS_LIMIT = 1 << 20;
+
+static uint32_t zigzag_encode(int32_t value) {
+    return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value) {
+    return static_cast<int32_t>(value >> 1) ^ -static_cast<int32_t>(value & 1);
+}
+
+static void encode_double(uint8_t* dst, double value) {
+    uint64_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    encode_fixed64_le(dst, bits);
+}
+
+static double decode_double(const uint8_t* src) {
+    uint64_t bits = decode_fixed64_le(src);
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+DDSketch::DDSketch(double relative_accuracy, uint32_t max_num_buckets)
+        : _relative_accuracy(relative_accuracy), _max_num_buckets(max_num_buckets) {
+    DCHECK(relative_accuracy > 0 && relative_accuracy < 1);
+    DCHECK(max_num_buckets > 0);
+    _gamma = (1 + relative_accuracy) / (1 - relative_accuracy);
+    _log_gamma = std::log(_gamma);
+    _min_indexable_value = std::numeric_limits<double>::min() * _gamma;
+}
+
+double DDSketch::relative_accuracy_of_compression(double compression) {
+    return std::clamp(20.48 / compression, 0.001, 0.05);
+}
+
+int32_t DDSketch::_index(double value) const {
+    return static_cast<int32_t>(std::ceil(std::log(value) / _log_gamma));
+}
+
+double DDSketch::_value(int32_t index) const {
+    return 2 * std::exp(index * _log_gamma) / (1 + _gamma);
+}
+
+void DDSketch::Store::extend(int32_t low, int32_t high, uint32_t max_num_buckets) {
+    if (!counts.empty()) {
+        low = std::min(low, offset);
+        high = std::max(high, offset + static_cast<int32_t>(counts.size()) - 1);
+    }
+    // collapse the lowest buckets into the lowest one kept
+    low = std::max<int64_t>(low, int64_t(high) - max_num_buckets + 1);
+    if (counts.empty()) {
+        offset = low;
+        counts.assign(high - low + 1, 0);
+        return;
+    }
+    if (low == offset) {
+        counts.resize(high - low + 1, 0);
+        return;
+    }
+    std::vector<uint64_t> new_counts(high - low + 1, 0);
+    for (size_t i = 0; i < counts.size(); ++i) {
+        new_counts[std::max(offset + static_cast<int32_t>(i), low) - low] += counts[i];
+    }
+    offset = low;
+    counts.swap(new_counts);
+}
+
+void DDSketch::Store::add(int32_t index, uint64_t count, uint32_t max_num_buckets) {
+    if (counts.empty() || index < offset || index >= offset + int32_t(counts.size())) {
+        extend(index, index, max_num_buckets);
+    }
+    // the index may be in the collapsed buckets
+    counts[std::max(index, offset) - offset] += count;
+    total += count;
+}
+
+void DDSketch::Store::clear() {
+    offset = 0;
+    std::vector<uint64_t>().swap(counts);
+    total = 0;
+}
+
+void DDSketch::add(double value, uint64_t count) {
+    if (std::isnan(value) || count == 0) {
+        return;
+    }
+    value = std::clamp(value, std::numeric_limits<double>::lowest(),
+                       std::numeric_limits<double>::max());
+    if (value >= _min_indexable_value) {
+        _positive.add(_index(value), count, _max_num_buckets);
+    } else if (value <= -_min_indexable_value) {
+        _negative.add(_index(-value), count, _max_num_buckets);
+    } else {
+        _zero_count += count;
+    }
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+void DDSketch::_add_store(const DDSketch& other, const Store& store, bool negative) {
+    if (store.counts.empty()) {
+        return;
+    }
+    if (other._gamma != _gamma) {
+        for (size_t i = 0; i < store.counts.size(); ++i) {
+            double value = other._value(store.offset + static_cast<int32_t>(i));
+            add(negative ? -value : value, store.counts[i]);
+        }
+        return;
+    }
+    Store& dst = negative ? _negative : _positive;
+    int32_t num_buckets = store.counts.size();
+    dst.extend(store.offset, store.offset + num_buckets - 1, _max_num_buckets);
+    for (int32_t i = 0; i < num_buckets; ++i) {
+        dst.counts[std::max(store.offset + i, dst.offset) - dst.offset] += store.counts[i];
+    }
+    dst.total += store.total;
+}
+
+void DDSketch::merge(const DDSketch& other) {
+    if (other.empty()) {
+        return;
+    }
+    _add_store(other, other._negative, true);
+    _add_store(other, other._positive, false);
+    _zero_count += other._zero_count;
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+double DDSketch::quantile(double q) const {
+    uint64_t total = count();
+    if (total == 0 || std::isnan(q)) {
+        return std::nan("");
+    }
+    if (q <= 0) {
+        return _min;
+    }
+    if (q >= 1) {
+        return _max;
+    }
+    // the value of the rank q * (count - 1) in the ascending order
+    double rank = q * (total - 1);
+    uint64_t num_values = 0;
+    // the negative values from the largest absolute values
+    for (int32_t i = _negative.counts.size() - 1; i >= 0; --i) {
+        num_values += _negative.counts[i];
+        if (num_values > rank) {
+            return std::clamp(-_value(_negative.offset + i), _min, _max);
+        }
+    }
+    num_values += _zero_count;
+    if (num_values > rank) {
+        return std::clamp(0.0, _min, _max);
+    }
+    for (int32_t i = 0; i < int32_t(_positive.counts.size()); ++i) {
+        num_values += _positive.counts[i];
+        if (num_values > rank) {
+            return std::clamp(_value(_positive.offset + i), _min, _max);
+        }
+    }
+    return _max;
+}
+
+void DDSketch::clear() {
+    _negative.clear();
+    _positive.clear();
+    _zero_count = 0;
+    _min = std::numeric_limits<double>::infinity();
+    _max = -std::numeric_limits<double>::infinity();
+}
+
+// The serialized sketch:
+//   relative accuracy(double) | max number of buckets(uint32) | min(double) | max(double) |
+//   zero count(varint64) | negative buckets | positive buckets
+// and the buckets of each sign:
+//   zigzag offset(varint32) | number of buckets(varint32) | count of each bucket(varint64)
+size_t DDSketch::serialized_size() const {
+    size_t size = sizeof(double) * 3 + sizeof(uint32_t) + varint_length(_zero_count);
+    for (const Store* store : {&_negative, &_positive}) {
+        size += varint_length(zigzag_encode(store->offset)) + varint_length(store->counts.size());
+        for (uint64_t count : store->counts) {
+            size += varint_length(count);
+        }
+    }
+    return size;
+}
+
+size_t DDSketch::serialize(uint8_t* dst) const {
+    uint8_t* ptr = dst;
+    encode_double(ptr, _relative_accuracy);
+    ptr += sizeof(double);
+    encode_fixed32_le(ptr, _max_num_buckets);
+    ptr += sizeof(uint32_t);
+    encode_double(ptr, _min);
+    ptr += sizeof(double);
+    encode_double(ptr, _max);
+    ptr += sizeof(double);
+    ptr = encode_varint64(ptr, _zero_count);
+    for (const Store* store : {&_negative, &_positive}) {
+        ptr = encode_varint32(ptr, zigzag_encode(store->offset));
+        ptr = encode_varint32(ptr, store->counts.size());
+        for (uint64_t count : store->counts) {
+            ptr = encode_varint64(ptr, count);
+        }
+    }
+    return ptr - dst;
+}
+
+bool DDSketch::deserialize(const uint8_t* data, size_t size) {
+    clear();
+    const uint8_t* ptr = data;
+    const uint8_t* end = data + size;
+    if (size < sizeof(double) * 3 + sizeof(uint32_t)) {
+        return false;
+    }
+    double relative_accuracy = decode_double(ptr);
+    ptr += sizeof(double);
+    uint32_t max_num_buckets = decode_fixed32_le(ptr);
+    ptr += sizeof(uint32_t);
+    if (!(relative_accuracy > 0 && relative_accuracy < 1) || max_num_buckets == 0 ||
+        max_num_buckets > MAX_NUM_BUCKETS_LIMIT) {
+        return false;
+    }
+    *this = DDSketch(relative_accuracy, max_num_buckets);
+    double min = decode_double(ptr);
+    ptr += sizeof(double);
+    double max = decode_double(ptr);
+    ptr += sizeof(double);
+    uint64_t zero_count = 0;
+    ptr = decode_varint64_ptr(ptr, end, &zero_count);
+    for (Store* store : {&_negative, &_positive}) {
+        uint32_t offset = 0;
+        uint32_t num_buckets = 0;
+        if (ptr != nullptr) {
+            ptr = decode_varint32_ptr(ptr, end, &offset);
+        }
+        if (ptr != nullptr) {
+            ptr = decode_varint32_ptr(ptr, end, &num_buckets);
+        }
+        if (ptr == nullptr || num_buckets > max_num_buckets ||
+            int64_t(zigzag_decode(offset)) + num_buckets > std::numeric_limits<int32_t>::max()) {
+            clear();
+            return false;
+        }
+        store->offset = zigzag_decode(offset);
+        store->counts.resize(num_buckets);
+        for (uint32_t i = 0; i < num_buckets && ptr != nullptr; ++i) {
+            ptr = decode_varint64_ptr(ptr, end, &store->counts[i]);
+            store->total += store->counts[i];
+        }
+    }
+    if (ptr != end) {
+        clear();
+        return false;
+    }
+    _zero_count = zero_count;
+    if (!empty()) {
+        _min = min;
+        _max = max;
+    }
+    return true;
+}
+
+} // namespace doris
@@ -0,0 +1,115 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace doris {
+
+// DDSketch: a fast and fully-mergeable quantile sketch with relative-error guarantees.
+// See "DDSketch: A Fast and Fully-Mergeable Quantile Sketch with Relative-Error Guarantees"
+// (Masson, Rim and Lee, VLDB 2019) for more details.
+//
+// A positive value x is counted in the bucket ceil(log_gamma(x)), gamma = (1 + a) / (1 - a),
+// so every quantile is estimated within the relative accuracy `a` of its true value. The
+// negative values are counted by their absolute values in another set of buckets, and the
+// values too close to zero are counted as zero. Two sketches of the same accuracy are merged by
+// adding their bucket counts, which is the same as adding all the values into one sketch.
+//
+// The buckets of each sign are kept in a dense array from the lowest to the highest index. At
+// most `max_num_buckets` of them are kept, the buckets of the smallest absolute values are
+// collapsed into one when exceeded, which only loses the accuracy of the lowest quantiles of
+// the values spanning more than gamma^max_num_buckets.
+class DDSketch {
+public:
+    static constexpr double DEFAULT_RELATIVE_ACCURACY = 0.01;
+    static constexpr uint32_t DEFAULT_MAX_NUM_BUCKETS = 4096;
+
+    explicit DDSketch(double relative_accuracy = DEFAULT_RELATIVE_ACCURACY,
+                      uint32_t max_num_buckets = DEFAULT_MAX_NUM_BUCKETS);
+
+    // The relative accuracy of a sketch replacing a TDigest of `compression`, the accuracy is
+    // 1% for the compression 2048 and 0.2% for the compression 10000.
+    static double relative_accuracy_of_compression(double compression);
+
+    // NaN is ignored, the infinities are counted as the max finite values.
+    void add(double value, uint64_t count = 1);
+
+    // Add the counts of another sketch, the buckets of the sketch of another accuracy are added
+    // by their values, which loses the accuracy of both.
+    void merge(const DDSketch& other);
+
+    // Return the estimated value of the quantile q in [0, 1], NaN if the sketch is empty.
+    double quantile(double q) const;
+
+    uint64_t count() const { return _negative.total + _zero_count + _positive.total; }
+    bool empty() const { return count() == 0; }
+    double relative_accuracy() const { return _relative_accuracy; }
+    double min() const { return _min; }
+    double max() const { return _max; }
+
+    void clear();
+
+    size_t serialized_size() const;
+    // `dst` should have serialized_size() bytes, return the bytes written.
+    size_t serialize(uint8_t* dst) const;
+    // Return false if `data` isn't a serialized sketch, the sketch is cleared then.
+    bool deserialize(const uint8_t* data, size_t size);
+
+    size_t memory_consumed() const {
+        return sizeof(*this) +
+               (_negative.counts.capacity() + _positive.counts.capacity()) * sizeof(uint64_t);
+    }
+
+private:
+    // The counts of the consecutive buckets of one sign from the bucket `offset`.
+    struct Store {
+        int32_t offset = 0;
+        std::vector<uint64_t> counts;
+        uint64_t total = 0;
+
+        void add(int32_t index, uint64_t count, uint32_t max_num_buckets);
+        // Make the buckets cover [low, high], or the highest max_num_buckets of them.
+        void extend(int32_t low, int32_t high, uint32_t max_num_buckets);
+        void clear();
+    };
+
+    // the bucket index of a value not less than _min_indexable_value
+    int32_t _index(double value) const;
+    // the value of a bucket, which is within the relative accuracy of all the values of it
+    double _value(int32_t index) const;
+    void _add_store(const DDSketch& other, const Store& store, bool negative);
+
+    double _relative_accuracy;
+    uint32_t _max_num_buckets;
+    double _gamma;
+    double _log_gamma;
+    double _min_indexable_value;
+
+    Store _negative;
+    Store _positive;
+    uint64_t _zero_count = 0;
+    double _min = std::numeric_limits<double>::infinity();
+    double _max = -std::numeric_limits<double>::infinity();
+};
+
+} // namespace doris
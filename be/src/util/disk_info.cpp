@@ -67,8 +67,7 @@ void DiskInfo::get_device_names() {
             continue;
         }
 
-        // Remove the partition# from the name.  e.g. sda2 --> sda
-        boost::trim_right_if(name, boost::is_any_of("0123456789"));
+        name = disk_name_of_partition(name);
 
         // Create a mapping of all device ids (one per partition) to the disk id.
         int major_dev_id = atoi(fields[0].c_str());
@@ -119,6 +118,17 @@ void DiskInfo::get_device_names() {
         if (rotational.is_open()) {
             rotational.close();
         }
+
+        // The NUMA node of the device is in /sys/block/<device>/device/numa_node, or in the
+        // parent device of it, e.g. the pci device of a nvme controller.
+        for (const char* numa_node_file : {"/device/numa_node", "/device/device/numa_node"}) {
+            std::ifstream numa_node("/sys/block/" + _s_disks[i].name + numa_node_file);
+            int node = -1;
+            if (numa_node >> node) {
+                _s_disks[i].numa_node = node;
+                break;
+            }
+        }
     }
 }
 
@@ -139,6 +149,20 @@ int DiskInfo::disk_id(const char* path) {
     return it->second;
 }
 
+std::string DiskInfo::disk_name_of_partition(const std::string& partition) {
+    std::string name = partition;
+    if (boost::starts_with(name, "nvme")) {
+        // the partitions of nvme0n1 are nvme0n1p1, nvme0n1p2...
+        size_t p = name.rfind('p');
+        if (p != std::string::npos && p > name.rfind('n')) {
+            name.resize(p);
+        }
+    } else {
+        boost::trim_right_if(name, boost::is_any_of("0123456789"));
+    }
+    return name;
+}
+
 std::string DiskInfo::debug_string() {
     DCHECK(_s_initialized);
     std::stringstream stream;
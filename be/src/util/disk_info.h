@@ -60,8 +60,18 @@ public:
         return _s_disks[disk_id].is_rotational;
     }
 
+    // Returns the NUMA node closest to the disk, or -1 if unknown
+    static int numa_node(int disk_id) {
+        DCHECK_GE(disk_id, 0);
+        DCHECK_LT(disk_id, _s_disks.size());
+        return _s_disks[disk_id].numa_node;
+    }
+
     static std::string debug_string();
 
+    // Returns the name of the disk of a partition, e.g. sda2 --> sda, nvme0n1p2 --> nvme0n1
+    static std::string disk_name_of_partition(const std::string& partition);
+
     // get disk devices of given path
     static Status get_disk_devices(const std::vector<std::string>& paths,
                                    std::set<std::string>* devices);
@@ -79,6 +89,8 @@ private:
 
         bool is_rotational;
 
+        int numa_node = -1;
+
         Disk() : name(""), id(0) {}
         Disk(const std::string& name) : name(name), id(0), is_rotational(true) {}
         Disk(const std::string& name, int id) : name(name), id(id), is_rotational(true) {}
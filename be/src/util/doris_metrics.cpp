@@ -17,6 +17,7 @@
 
 #include "util/doris_metrics.h"
 
+#include <sys/resource.h>
 #include <sys/types.h>
 #include <unistd.h>
 
@@ -40,6 +41,15 @@ DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(push_requests_success_total, MetricUnit::RE
 DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(push_requests_fail_total, MetricUnit::REQUESTS, "",
                                      push_requests_total, Labels({{"status", "FAIL"}}));
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(push_request_duration_us, MetricUnit::MICROSECONDS);
+DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(brpc_heavy_work_tasks_total, MetricUnit::REQUESTS, "",
+                                     brpc_work_tasks_total, Labels({{"pool", "heavy"}}));
+DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(brpc_tablet_writer_tasks_total, MetricUnit::REQUESTS, "",
+                                     brpc_work_tasks_total, Labels({{"pool", "tablet_writer"}}));
+DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(brpc_heavy_work_queue_time_us, MetricUnit::MICROSECONDS,
+                                     "", brpc_work_queue_time_us, Labels({{"pool", "heavy"}}));
+DEFINE_COUNTER_METRIC_PROTOTYPE_5ARG(brpc_tablet_writer_queue_time_us, MetricUnit::MICROSECONDS,
+                                     "", brpc_work_queue_time_us,
+                                     Labels({{"pool", "tablet_writer"}}));
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(push_request_write_bytes, MetricUnit::BYTES);
 DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(push_request_write_rows, MetricUnit::ROWS);
 
@@ -53,6 +63,8 @@ DEFINE_ENGINE_COUNTER_METRIC(drop_tablet_requests_total, drop_tablet, total);
 DEFINE_ENGINE_COUNTER_METRIC(report_all_tablets_requests_total, report_all_tablets, total);
 DEFINE_ENGINE_COUNTER_METRIC(report_all_tablets_requests_failed, report_all_tablets, failed);
 DEFINE_ENGINE_COUNTER_METRIC(report_all_tablets_requests_skip, report_all_tablets, skip)
+DEFINE_ENGINE_COUNTER_METRIC(report_incremental_tablets_requests_total, report_incremental_tablets,
+                             total);
 DEFINE_ENGINE_COUNTER_METRIC(report_tablet_requests_total, report_tablet, total);
 DEFINE_ENGINE_COUNTER_METRIC(report_tablet_requests_failed, report_tablet, failed);
 DEFINE_ENGINE_COUNTER_METRIC(report_disk_requests_total, report_disk, total);
@@ -144,6 +156,8 @@ DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(process_thread_num, MetricUnit::NOUNIT);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(process_fd_num_used, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(process_fd_num_limit_soft, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(process_fd_num_limit_hard, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(process_minor_page_faults, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(process_major_page_faults, MetricUnit::NOUNIT);
 
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(tablet_cumulative_max_compaction_score, MetricUnit::NOUNIT);
 DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(tablet_base_max_compaction_score, MetricUnit::NOUNIT);
@@ -173,6 +187,7 @@ DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(blocks_open_writing, MetricUnit::BLOCKS);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_memory_total_byte, MetricUnit::BYTES);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_sql_total_count, MetricUnit::NOUNIT);
 DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_partition_total_count, MetricUnit::NOUNIT);
+DEFINE_GAUGE_CORE_METRIC_PROTOTYPE_2ARG(query_cache_spill_total_byte, MetricUnit::BYTES);
 
 const std::string DorisMetrics::_s_registry_name = "doris_be";
 const std::string DorisMetrics::_s_hook_name = "doris_metrics";
@@ -193,6 +208,11 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, push_request_write_bytes);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, push_request_write_rows);
 
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, brpc_heavy_work_tasks_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, brpc_tablet_writer_tasks_total);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, brpc_heavy_work_queue_time_us);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, brpc_tablet_writer_queue_time_us);
+
     // engine_requests_total
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, create_tablet_requests_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, create_tablet_requests_failed);
@@ -200,6 +220,7 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_all_tablets_requests_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_all_tablets_requests_failed);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_all_tablets_requests_skip);
+    INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_incremental_tablets_requests_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_tablet_requests_total);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_tablet_requests_failed);
     INT_COUNTER_METRIC_REGISTER(_server_metric_entity, report_disk_requests_total);
@@ -256,6 +277,8 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_fd_num_used);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_fd_num_limit_soft);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_fd_num_limit_hard);
+    INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_minor_page_faults);
+    INT_GAUGE_METRIC_REGISTER(_server_metric_entity, process_major_page_faults);
 
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, tablet_cumulative_max_compaction_score);
     INT_GAUGE_METRIC_REGISTER(_server_metric_entity, tablet_base_max_compaction_score);
@@ -294,6 +317,7 @@ DorisMetrics::DorisMetrics() : _metric_registry(_s_registry_name) {
     INT_UGAUGE_METRIC_REGISTER(_server_metric_entity, query_cache_memory_total_byte);
     INT_UGAUGE_METRIC_REGISTER(_server_metric_entity, query_cache_sql_total_count);
     INT_UGAUGE_METRIC_REGISTER(_server_metric_entity, query_cache_partition_total_count);
+    INT_UGAUGE_METRIC_REGISTER(_server_metric_entity, query_cache_spill_total_byte);
 }
 
 void DorisMetrics::initialize(bool init_system_metrics, const std::set<std::string>& disk_devices,
@@ -308,6 +332,18 @@ void DorisMetrics::initialize(bool init_system_metrics, const std::set<std::stri
 void DorisMetrics::_update() {
     _update_process_thread_num();
     _update_process_fd_num();
+    _update_process_page_faults();
+}
+
+// get the number of page faults of doris_be process since it starts
+void DorisMetrics::_update_process_page_faults() {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        LOG(WARNING) << "failed to get the resource usage, errno=" << errno;
+        return;
+    }
+    process_minor_page_faults->set_value(usage.ru_minflt);
+    process_major_page_faults->set_value(usage.ru_majflt);
 }
 
 // get num of thread of doris_be process
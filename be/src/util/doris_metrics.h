@@ -57,6 +57,12 @@ public:
     IntCounter* push_request_duration_us;
     IntCounter* push_request_write_bytes;
     IntCounter* push_request_write_rows;
+
+    // the tasks of the brpc handlers run in the work pools, and the time they wait in the queues
+    IntCounter* brpc_heavy_work_tasks_total;
+    IntCounter* brpc_tablet_writer_tasks_total;
+    IntCounter* brpc_heavy_work_queue_time_us;
+    IntCounter* brpc_tablet_writer_queue_time_us;
     IntCounter* create_tablet_requests_total;
     IntCounter* create_tablet_requests_failed;
     IntCounter* drop_tablet_requests_total;
@@ -66,6 +72,7 @@ public:
     IntCounter* report_tablet_requests_total;
     IntCounter* report_tablet_requests_failed;
     IntCounter* report_all_tablets_requests_skip;
+    IntCounter* report_incremental_tablets_requests_total;
     IntCounter* report_disk_requests_total;
     IntCounter* report_disk_requests_failed;
     IntCounter* report_task_requests_total;
@@ -138,6 +145,8 @@ public:
     IntGauge* process_fd_num_used;
     IntGauge* process_fd_num_limit_soft;
     IntGauge* process_fd_num_limit_hard;
+    IntGauge* process_minor_page_faults;
+    IntGauge* process_major_page_faults;
 
     // the max compaction score of all tablets.
     // Record base and cumulative scores separately, because
@@ -201,6 +210,7 @@ public:
     UIntGauge* query_cache_memory_total_byte;
     UIntGauge* query_cache_sql_total_count;
     UIntGauge* query_cache_partition_total_count;
+    UIntGauge* query_cache_spill_total_byte;
 
     UIntGauge* scanner_thread_pool_queue_size;
     UIntGauge* etl_thread_pool_queue_size;
@@ -231,6 +241,7 @@ private:
     void _update();
     void _update_process_thread_num();
     void _update_process_fd_num();
+    void _update_process_page_faults();
 
 private:
     static const std::string _s_registry_name;
@@ -148,120 +148,114 @@ static void create_key(const unsigned char* origin_key, uint32_t key_length, uin
     }
 }
 
-static int do_encrypt(EVP_CIPHER_CTX* cipher_ctx, const EVP_CIPHER* cipher,
-                      const unsigned char* source, uint32_t source_length,
-                      const unsigned char* encrypt_key, const unsigned char* iv, bool padding,
-                      unsigned char* encrypt, int* length_ptr) {
-    int ret = EVP_EncryptInit(cipher_ctx, cipher, encrypt_key, iv);
-    if (ret == 0) {
-        return ret;
+CipherContext::CipherContext() : ctx(EVP_CIPHER_CTX_new()) {}
+
+CipherContext::~CipherContext() {
+    EVP_CIPHER_CTX_free(ctx);
+}
+
+// Encrypt or decrypt the source by the context, the key schedule of the context is reused if
+// the context is initialized by the same cipher, direction and key. The iv is always set again,
+// since CTR mode doesn't restore it by itself.
+static int do_cipher(CipherContext* cipher_ctx, const EVP_CIPHER* cipher, EncryptionMode mode,
+                     bool is_encrypt, const unsigned char* source, uint32_t source_length,
+                     const unsigned char* key, uint32_t key_length, const unsigned char* iv,
+                     bool padding, unsigned char* dest, int* length_ptr) {
+    EVP_CIPHER_CTX* ctx = cipher_ctx->ctx;
+    int ret = 0;
+    if (cipher_ctx->cipher == cipher && cipher_ctx->is_encrypt == is_encrypt &&
+        cipher_ctx->key.size() == key_length &&
+        std::memcmp(cipher_ctx->key.data(), key, key_length) == 0) {
+        ret = EVP_CipherInit_ex(ctx, nullptr, nullptr, nullptr, iv, is_encrypt);
+    } else {
+        /* The encrypt key to be used for encryption or decryption */
+        unsigned char encrypt_key[ENCRYPTION_MAX_KEY_LENGTH / 8];
+        create_key(key, key_length, encrypt_key, mode);
+        cipher_ctx->cipher = nullptr;
+        ret = EVP_CipherInit_ex(ctx, cipher, nullptr, encrypt_key, iv, is_encrypt);
+        if (ret != 0) {
+            cipher_ctx->cipher = cipher;
+            cipher_ctx->is_encrypt = is_encrypt;
+            cipher_ctx->key.assign(reinterpret_cast<const char*>(key), key_length);
+        }
     }
-    ret = EVP_CIPHER_CTX_set_padding(cipher_ctx, padding);
-    if (ret == 0) {
-        return ret;
+    if (ret != 0) {
+        ret = EVP_CIPHER_CTX_set_padding(ctx, padding);
     }
     int u_len = 0;
-    ret = EVP_EncryptUpdate(cipher_ctx, encrypt, &u_len, source, source_length);
-    if (ret == 0) {
-        return ret;
+    if (ret != 0) {
+        ret = EVP_CipherUpdate(ctx, dest, &u_len, source, source_length);
     }
     int f_len = 0;
-    ret = EVP_EncryptFinal(cipher_ctx, encrypt + u_len, &f_len);
+    if (ret != 0) {
+        ret = EVP_CipherFinal_ex(ctx, dest + u_len, &f_len);
+    }
+    if (ret == 0) {
+        // initialize the context again for the next row after a failure
+        cipher_ctx->cipher = nullptr;
+        ERR_clear_error();
+        return AES_BAD_DATA;
+    }
     *length_ptr = u_len + f_len;
     return ret;
 }
 
-int EncryptionUtil::encrypt(EncryptionMode mode, const unsigned char* source,
-                            uint32_t source_length, const unsigned char* key, uint32_t key_length,
-                            const char* iv_str, bool padding, unsigned char* encrypt) {
+static int do_cipher(CipherContext* cipher_ctx, EncryptionMode mode, bool is_encrypt,
+                     const unsigned char* source, uint32_t source_length, const unsigned char* key,
+                     uint32_t key_length, const char* iv_str, bool padding, unsigned char* dest) {
     const EVP_CIPHER* cipher = get_evp_type(mode);
-    /* The encrypt key to be used for encryption */
-    unsigned char encrypt_key[ENCRYPTION_MAX_KEY_LENGTH / 8];
-    create_key(key, key_length, encrypt_key, mode);
-
+    if (cipher == nullptr) {
+        return AES_BAD_DATA;
+    }
     int iv_length = EVP_CIPHER_iv_length(cipher);
-    if (cipher == nullptr || (iv_length > 0 && !iv_str)) {
+    if (iv_length > 0 && !iv_str) {
         return AES_BAD_DATA;
     }
     char* init_vec = nullptr;
-    std::string iv_default("DORISDORISDORIS_");
+    char iv_default[] = "DORISDORISDORIS_";
 
     if (iv_str) {
-        init_vec = &iv_default[0];
+        init_vec = iv_default;
         memcpy(init_vec, iv_str, strnlen(iv_str, EVP_MAX_IV_LENGTH));
         init_vec[iv_length] = '\0';
     }
-    EVP_CIPHER_CTX* cipher_ctx = EVP_CIPHER_CTX_new();
-    EVP_CIPHER_CTX_reset(cipher_ctx);
     int length = 0;
-    int ret = do_encrypt(cipher_ctx, cipher, source, source_length, encrypt_key,
-                         reinterpret_cast<unsigned char*>(init_vec), padding, encrypt, &length);
-    EVP_CIPHER_CTX_free(cipher_ctx);
-    if (ret == 0) {
-        ERR_clear_error();
-        return AES_BAD_DATA;
-    } else {
-        return length;
-    }
+    int ret = do_cipher(cipher_ctx, cipher, mode, is_encrypt, source, source_length, key,
+                        key_length, reinterpret_cast<unsigned char*>(init_vec), padding, dest,
+                        &length);
+    return ret > 0 ? length : AES_BAD_DATA;
 }
 
-static int do_decrypt(EVP_CIPHER_CTX* cipher_ctx, const EVP_CIPHER* cipher,
-                      const unsigned char* encrypt, uint32_t encrypt_length,
-                      const unsigned char* encrypt_key, const unsigned char* iv, bool padding,
-                      unsigned char* decrypt_content, int* length_ptr) {
-    int ret = EVP_DecryptInit(cipher_ctx, cipher, encrypt_key, iv);
-    if (ret == 0) {
-        return ret;
-    }
-    ret = EVP_CIPHER_CTX_set_padding(cipher_ctx, padding);
-    if (ret == 0) {
-        return ret;
-    }
-    int u_len = 0;
-    ret = EVP_DecryptUpdate(cipher_ctx, decrypt_content, &u_len, encrypt, encrypt_length);
-    if (ret == 0) {
-        return ret;
-    }
-    int f_len = 0;
-    ret = EVP_DecryptFinal_ex(cipher_ctx, decrypt_content + u_len, &f_len);
-    *length_ptr = u_len + f_len;
-    return ret;
+int EncryptionUtil::encrypt(CipherContext* cipher_ctx, EncryptionMode mode,
+                            const unsigned char* source, uint32_t source_length,
+                            const unsigned char* key, uint32_t key_length, const char* iv_str,
+                            bool padding, unsigned char* encrypt) {
+    return do_cipher(cipher_ctx, mode, true, source, source_length, key, key_length, iv_str,
+                     padding, encrypt);
+}
+
+int EncryptionUtil::decrypt(CipherContext* cipher_ctx, EncryptionMode mode,
+                            const unsigned char* encrypt, uint32_t encrypt_length,
+                            const unsigned char* key, uint32_t key_length, const char* iv_str,
+                            bool padding, unsigned char* decrypt_content) {
+    return do_cipher(cipher_ctx, mode, false, encrypt, encrypt_length, key, key_length, iv_str,
+                     padding, decrypt_content);
+}
+
+int EncryptionUtil::encrypt(EncryptionMode mode, const unsigned char* source,
+                            uint32_t source_length, const unsigned char* key, uint32_t key_length,
+                            const char* iv_str, bool padding, unsigned char* encrypt) {
+    CipherContext cipher_ctx;
+    return EncryptionUtil::encrypt(&cipher_ctx, mode, source, source_length, key, key_length,
+                                   iv_str, padding, encrypt);
 }
 
 int EncryptionUtil::decrypt(EncryptionMode mode, const unsigned char* encrypt,
                             uint32_t encrypt_length, const unsigned char* key, uint32_t key_length,
                             const char* iv_str, bool padding, unsigned char* decrypt_content) {
-    const EVP_CIPHER* cipher = get_evp_type(mode);
-
-    /* The encrypt key to be used for decryption */
-    unsigned char encrypt_key[ENCRYPTION_MAX_KEY_LENGTH / 8];
-    create_key(key, key_length, encrypt_key, mode);
-
-    int iv_length = EVP_CIPHER_iv_length(cipher);
-    if (cipher == nullptr || (iv_length > 0 && !iv_str)) {
-        return AES_BAD_DATA;
-    }
-    char* init_vec = nullptr;
-    std::string iv_default("DORISDORISDORIS_");
-
-    if (iv_str) {
-        init_vec = &iv_default[0];
-        memcpy(init_vec, iv_str, strnlen(iv_str, EVP_MAX_IV_LENGTH));
-        init_vec[iv_length] = '\0';
-    }
-    EVP_CIPHER_CTX* cipher_ctx = EVP_CIPHER_CTX_new();
-    EVP_CIPHER_CTX_reset(cipher_ctx);
-    int length = 0;
-    int ret = do_decrypt(cipher_ctx, cipher, encrypt, encrypt_length, encrypt_key,
-                         reinterpret_cast<unsigned char*>(init_vec), padding, decrypt_content,
-                         &length);
-    EVP_CIPHER_CTX_free(cipher_ctx);
-    if (ret > 0) {
-        return length;
-    } else {
-        ERR_clear_error();
-        return AES_BAD_DATA;
-    }
+    CipherContext cipher_ctx;
+    return EncryptionUtil::decrypt(&cipher_ctx, mode, encrypt, encrypt_length, key, key_length,
+                                   iv_str, padding, decrypt_content);
 }
 
 } // namespace doris
@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include <openssl/ossl_typ.h>
 #include <stdint.h>
 
+#include <string>
+
 namespace doris {
 
 enum EncryptionMode {
@@ -55,8 +58,38 @@ enum EncryptionMode {
 
 enum EncryptionState { AES_SUCCESS = 0, AES_BAD_DATA = -1 };
 
+// The openssl cipher context reused by the encryptions or the decryptions of many rows, which
+// saves allocating a context per row. The key is only expanded again if the cipher, the direction
+// or the key changes, so a column encrypted by a constant key expands the key once.
+// Not thread safe.
+struct CipherContext {
+    CipherContext();
+    ~CipherContext();
+
+    CipherContext(const CipherContext&) = delete;
+    CipherContext& operator=(const CipherContext&) = delete;
+
+    EVP_CIPHER_CTX* ctx;
+    // the cipher, the direction and the origin key the context is initialized by,
+    // cipher is nullptr if the context must be initialized again
+    const EVP_CIPHER* cipher = nullptr;
+    bool is_encrypt = false;
+    std::string key;
+};
+
 class EncryptionUtil {
 public:
+    static int encrypt(CipherContext* cipher_ctx, EncryptionMode mode,
+                       const unsigned char* source, uint32_t source_length,
+                       const unsigned char* key, uint32_t key_length, const char* iv_str,
+                       bool padding, unsigned char* encrypt);
+
+    static int decrypt(CipherContext* cipher_ctx, EncryptionMode mode,
+                       const unsigned char* encrypt, uint32_t encrypt_length,
+                       const unsigned char* key, uint32_t key_length, const char* iv_str,
+                       bool padding, unsigned char* decrypt_content);
+
+    // encrypt or decrypt by a context used only once
     static int encrypt(EncryptionMode mode, const unsigned char* source, uint32_t source_length,
                        const unsigned char* key, uint32_t key_length, const char* iv_str,
                        bool padding, unsigned char* encrypt);
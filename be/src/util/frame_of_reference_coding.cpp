@@ -19,9 +19,11 @@
 
 #include <algorithm>
 #include <cstring>
+#include <type_traits>
 
 #include "util/bit_util.h"
 #include "util/coding.h"
+#include "util/simd/bit_unpack.h"
 
 namespace doris {
 
@@ -265,7 +267,6 @@ bool ForDecoder<T>::init() {
     return true;
 }
 
-// todo(kks): improve this method by SIMD instructions
 // The reverse of bit_pack method, get original integer data list from packed bits
 // param[in] input: the packed bits need to unpack
 // param[in] in_num: the integer number in packed bits
@@ -273,6 +274,18 @@ bool ForDecoder<T>::init() {
 // param[out] output: the original integer data list
 template <typename T>
 void ForDecoder<T>::bit_unpack(const uint8_t* input, uint8_t in_num, int bit_width, T* output) {
+    if constexpr (std::is_integral_v<T> && sizeof(T) <= 8) {
+        // the values unpacked by AVX-512 end at a byte boundary, the rest are unpacked below
+        if (bit_width > 0 && simd::has_avx512_bit_unpack()) {
+            size_t num = simd::bit_unpack_msb_avx512(
+                    input, BitUtil::Ceil(in_num * bit_width, 8), in_num, bit_width,
+                    reinterpret_cast<std::make_unsigned_t<T>*>(output));
+            input += num * bit_width / 8;
+            output += num;
+            in_num -= static_cast<uint8_t>(num);
+        }
+    }
+
     unsigned char in_mask = 0x80;
     int bit_index = 0;
     while (in_num > 0) {
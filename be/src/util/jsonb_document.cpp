@@ -0,0 +1,303 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/jsonb_document.h"
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+namespace doris {
+
+namespace {
+
+template <typename T>
+void append(std::string* out, T value) {
+    out->append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+void write_at(std::string* out, size_t offset, T value) {
+    memcpy(out->data() + offset, &value, sizeof(T));
+}
+
+} // namespace
+
+JsonbValue JsonbValue::open(std::string_view jsonb) {
+    if (jsonb.empty() || static_cast<uint8_t>(jsonb[0]) != MAGIC) {
+        return JsonbValue();
+    }
+    return JsonbValue(jsonb.data() + 1, jsonb.size() - 1);
+}
+
+bool JsonbValue::encode(const char* json, size_t size, std::string* jsonb) {
+    rapidjson::Document document;
+    document.Parse(json, size);
+    if (document.HasParseError()) {
+        return false;
+    }
+    jsonb->clear();
+    jsonb->push_back(static_cast<char>(MAGIC));
+    encode(document, jsonb);
+    return true;
+}
+
+void JsonbValue::encode(const rapidjson::Value& value, std::string* jsonb) {
+    switch (value.GetType()) {
+    case rapidjson::kNullType:
+        jsonb->push_back(NULL_VALUE);
+        break;
+    case rapidjson::kFalseType:
+        jsonb->push_back(FALSE_VALUE);
+        break;
+    case rapidjson::kTrueType:
+        jsonb->push_back(TRUE_VALUE);
+        break;
+    case rapidjson::kNumberType:
+        if (value.IsInt64()) {
+            jsonb->push_back(INT64);
+            append(jsonb, value.GetInt64());
+        } else if (value.IsUint64()) {
+            jsonb->push_back(UINT64);
+            append(jsonb, value.GetUint64());
+        } else {
+            jsonb->push_back(DOUBLE);
+            append(jsonb, value.GetDouble());
+        }
+        break;
+    case rapidjson::kStringType:
+        jsonb->push_back(STRING);
+        append<uint32_t>(jsonb, value.GetStringLength());
+        jsonb->append(value.GetString(), value.GetStringLength());
+        break;
+    case rapidjson::kArrayType: {
+        uint32_t count = value.Size();
+        jsonb->push_back(ARRAY);
+        append(jsonb, count);
+        size_t header = jsonb->size();
+        jsonb->resize(header + sizeof(uint32_t) * (1 + count));
+        size_t payload = jsonb->size();
+        for (uint32_t i = 0; i < count; ++i) {
+            write_at<uint32_t>(jsonb, header + sizeof(uint32_t) * (1 + i), jsonb->size() - payload);
+            encode(value[i], jsonb);
+        }
+        write_at<uint32_t>(jsonb, header, jsonb->size() - payload);
+        break;
+    }
+    case rapidjson::kObjectType: {
+        uint32_t count = value.MemberCount();
+        jsonb->push_back(OBJECT);
+        append(jsonb, count);
+        size_t header = jsonb->size();
+        jsonb->resize(header + sizeof(uint32_t) * (1 + 2 * count));
+        size_t payload = jsonb->size();
+        std::vector<std::string_view> keys;
+        keys.reserve(count);
+        uint32_t i = 0;
+        for (auto it = value.MemberBegin(); it != value.MemberEnd(); ++it, ++i) {
+            write_at<uint32_t>(jsonb, header + sizeof(uint32_t) * (1 + i), jsonb->size() - payload);
+            keys.emplace_back(it->name.GetString(), it->name.GetStringLength());
+            append<uint32_t>(jsonb, it->name.GetStringLength());
+            jsonb->append(it->name.GetString(), it->name.GetStringLength());
+            encode(it->value, jsonb);
+        }
+        write_at<uint32_t>(jsonb, header, jsonb->size() - payload);
+        // stable, so the first member of the duplicated keys is found
+        std::vector<uint32_t> sorted(count);
+        std::iota(sorted.begin(), sorted.end(), 0);
+        std::stable_sort(sorted.begin(), sorted.end(),
+                         [&](uint32_t l, uint32_t r) { return keys[l] < keys[r]; });
+        for (uint32_t j = 0; j < count; ++j) {
+            write_at(jsonb, header + sizeof(uint32_t) * (1 + count + j), sorted[j]);
+        }
+        break;
+    }
+    }
+}
+
+JsonbValue::Type JsonbValue::type() const {
+    if (_size == 0) {
+        return INVALID;
+    }
+    auto type = static_cast<uint8_t>(_data[0]);
+    return type > OBJECT ? INVALID : static_cast<Type>(type);
+}
+
+std::string_view JsonbValue::get_string() const {
+    auto length = _read<uint32_t>(1);
+    if (type() != STRING || 1 + sizeof(uint32_t) + length > _size) {
+        return {};
+    }
+    return {_data + 1 + sizeof(uint32_t), length};
+}
+
+uint32_t JsonbValue::size() const {
+    uint32_t count = 0;
+    uint32_t payload_size = 0;
+    return _payload(&count, &payload_size) != nullptr ? count : 0;
+}
+
+const char* JsonbValue::_payload(uint32_t* count, uint32_t* payload_size) const {
+    auto type = this->type();
+    if (type != ARRAY && type != OBJECT) {
+        return nullptr;
+    }
+    *count = _read<uint32_t>(1);
+    *payload_size = _read<uint32_t>(1 + sizeof(uint32_t));
+    size_t header = 1 + sizeof(uint32_t) * (2 + (type == OBJECT ? 2 : 1) * uint64_t(*count));
+    if (header + *payload_size > _size) {
+        return nullptr;
+    }
+    return _data + header;
+}
+
+JsonbValue JsonbValue::at(uint32_t index) const {
+    uint32_t count = 0;
+    uint32_t payload_size = 0;
+    const char* payload = _payload(&count, &payload_size);
+    if (payload == nullptr || type() != ARRAY || index >= count) {
+        return JsonbValue();
+    }
+    auto offset = _read<uint32_t>(1 + sizeof(uint32_t) * (2 + index));
+    if (offset >= payload_size) {
+        return JsonbValue();
+    }
+    return JsonbValue(payload + offset, payload_size - offset);
+}
+
+bool JsonbValue::_member(uint32_t index, std::string_view* key, JsonbValue* value) const {
+    uint32_t count = 0;
+    uint32_t payload_size = 0;
+    const char* payload = _payload(&count, &payload_size);
+    if (payload == nullptr || type() != OBJECT || index >= count) {
+        return false;
+    }
+    JsonbValue member(payload, payload_size);
+    auto offset = _read<uint32_t>(1 + sizeof(uint32_t) * (2 + index));
+    auto key_length = member._read<uint32_t>(offset);
+    size_t value_offset = uint64_t(offset) + sizeof(uint32_t) + key_length;
+    if (value_offset >= payload_size) {
+        return false;
+    }
+    *key = std::string_view(payload + offset + sizeof(uint32_t), key_length);
+    *value = JsonbValue(payload + value_offset, payload_size - value_offset);
+    return true;
+}
+
+JsonbValue JsonbValue::find(std::string_view key) const {
+    uint32_t count = size();
+    if (type() != OBJECT) {
+        return JsonbValue();
+    }
+    // binary search the first member not less than key in the sorted order
+    size_t sorted_offset = 1 + sizeof(uint32_t) * (2 + uint64_t(count));
+    uint32_t low = 0;
+    uint32_t high = count;
+    std::string_view member_key;
+    JsonbValue member_value;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        if (!_member(_read<uint32_t>(sorted_offset + sizeof(uint32_t) * mid), &member_key,
+                     &member_value)) {
+            return JsonbValue();
+        }
+        if (member_key < key) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    if (low == count ||
+        !_member(_read<uint32_t>(sorted_offset + sizeof(uint32_t) * low), &member_key,
+                 &member_value) ||
+        member_key != key) {
+        return JsonbValue();
+    }
+    return member_value;
+}
+
+bool JsonbValue::to_rapidjson(rapidjson::Value* value,
+                              rapidjson::Document::AllocatorType& allocator) const {
+    uint32_t count = 0;
+    uint32_t payload_size = 0;
+    switch (type()) {
+    case NULL_VALUE:
+        value->SetNull();
+        return true;
+    case TRUE_VALUE:
+        value->SetBool(true);
+        return true;
+    case FALSE_VALUE:
+        value->SetBool(false);
+        return true;
+    case INT64:
+        value->SetInt64(get_int64());
+        return 1 + sizeof(int64_t) <= _size;
+    case UINT64:
+        value->SetUint64(get_uint64());
+        return 1 + sizeof(uint64_t) <= _size;
+    case DOUBLE:
+        value->SetDouble(get_double());
+        return 1 + sizeof(double) <= _size;
+    case STRING: {
+        auto length = _read<uint32_t>(1);
+        if (1 + sizeof(uint32_t) + length > _size) {
+            return false;
+        }
+        value->SetString(_data + 1 + sizeof(uint32_t), length, allocator);
+        return true;
+    }
+    case ARRAY: {
+        if (_payload(&count, &payload_size) == nullptr) {
+            return false;
+        }
+        value->SetArray();
+        for (uint32_t i = 0; i < count; ++i) {
+            rapidjson::Value element;
+            JsonbValue jsonb_element = at(i);
+            if (!jsonb_element.to_rapidjson(&element, allocator)) {
+                return false;
+            }
+            value->PushBack(element, allocator);
+        }
+        return true;
+    }
+    case OBJECT: {
+        if (_payload(&count, &payload_size) == nullptr) {
+            return false;
+        }
+        value->SetObject();
+        std::string_view key;
+        JsonbValue jsonb_value;
+        for (uint32_t i = 0; i < count; ++i) {
+            rapidjson::Value member_value;
+            if (!_member(i, &key, &jsonb_value) ||
+                !jsonb_value.to_rapidjson(&member_value, allocator)) {
+                return false;
+            }
+            rapidjson::Value member_key(key.data(), key.size(), allocator);
+            value->AddMember(member_key, member_value, allocator);
+        }
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+} // namespace doris
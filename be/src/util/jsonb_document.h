@@ -0,0 +1,113 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <rapidjson/document.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+namespace doris {
+
+// JSONB is a binary encoding of json documents, stored in the string columns. The containers
+// carry the offsets of their elements and the keys of an object are indexed in the sorted
+// order, so a value is found by a path in O(depth) without parsing the document.
+//
+//   document := MAGIC value
+//   value    := NULL | TRUE | FALSE | INT64 int64 | UINT64 uint64 | DOUBLE double
+//             | STRING u32 length bytes
+//             | ARRAY u32 count, u32 payload_size, u32 offsets[count], values
+//             | OBJECT u32 count, u32 payload_size, u32 offsets[count], u32 sorted[count], members
+//   member   := u32 key_length key_bytes value
+//
+// The offsets are relative to the payload, which follows the header of the container. `sorted`
+// is the indexes of the members sorted by the keys, the members keep the order of the json.
+// The numbers keep the classes of rapidjson, so the documents give the same results as the json
+// text. All the integers are little endian.
+class JsonbValue {
+public:
+    enum Type : uint8_t {
+        INVALID = 0,
+        NULL_VALUE,
+        TRUE_VALUE,
+        FALSE_VALUE,
+        INT64,
+        UINT64,
+        DOUBLE,
+        STRING,
+        ARRAY,
+        OBJECT,
+    };
+
+    static constexpr uint8_t MAGIC = 0xB1;
+
+    JsonbValue() = default;
+
+    // The root value of a document, invalid if `jsonb` is not a jsonb document. The document
+    // is checked lazily, the values of a malformed document are invalid but never read out of
+    // `jsonb`.
+    static JsonbValue open(std::string_view jsonb);
+
+    // Encode the json text parsed by rapidjson, return false if it's not a valid json.
+    static bool encode(const char* json, size_t size, std::string* jsonb);
+    static void encode(const rapidjson::Value& value, std::string* jsonb);
+
+    bool is_valid() const { return type() != INVALID; }
+    Type type() const;
+
+    int64_t get_int64() const { return _read<int64_t>(1); }
+    uint64_t get_uint64() const { return _read<uint64_t>(1); }
+    double get_double() const { return _read<double>(1); }
+    std::string_view get_string() const;
+
+    // the number of the elements of an array or the members of an object
+    uint32_t size() const;
+    // the element of an array, invalid if out of range
+    JsonbValue at(uint32_t index) const;
+    // the value of the first member with `key` of an object, invalid if not found
+    JsonbValue find(std::string_view key) const;
+
+    // Decode the value, return false if the document is malformed.
+    bool to_rapidjson(rapidjson::Value* value, rapidjson::Document::AllocatorType& allocator) const;
+
+private:
+    JsonbValue(const char* data, size_t size) : _data(data), _size(size) {}
+
+    template <typename T>
+    T _read(size_t offset) const {
+        T value {};
+        if (offset + sizeof(T) <= _size) {
+            memcpy(&value, _data + offset, sizeof(T));
+        }
+        return value;
+    }
+
+    // the payload of a container, nullptr if malformed
+    const char* _payload(uint32_t* count, uint32_t* payload_size) const;
+    // the key and the value of the index-th member of an object
+    bool _member(uint32_t index, std::string_view* key, JsonbValue* value) const;
+
+    const char* _data = nullptr;
+    // the bytes from `_data` to the end of its enclosing container
+    size_t _size = 0;
+};
+
+} // namespace doris
@@ -23,6 +23,10 @@ Md5Digest::Md5Digest() {
     MD5_Init(&_md5_ctx);
 }
 
+void Md5Digest::reset() {
+    MD5_Init(&_md5_ctx);
+}
+
 void Md5Digest::update(const void* data, size_t length) {
     MD5_Update(&_md5_ctx, data, length);
 }
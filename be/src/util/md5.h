@@ -27,6 +27,9 @@ class Md5Digest {
 public:
     Md5Digest();
 
+    // start a new digest, so one object can digest many values
+    void reset();
+
     void update(const void* data, size_t length);
     void digest();
 
@@ -88,29 +88,28 @@ std::string labels_to_string(std::initializer_list<const Labels*> multi_labels)
         return std::string();
     }
 
-    std::stringstream ss;
-    ss << "{";
+    // appended to a string instead of a stringstream, it's called for each metric of a scrape
+    std::string str = "{";
     int i = 0;
     for (auto labels : multi_labels) {
         for (const auto& label : *labels) {
             if (i++ > 0) {
-                ss << ",";
+                str.push_back(',');
             }
-            ss << label.first << "=\"" << label.second << "\"";
+            str.append(label.first).append("=\"").append(label.second).push_back('"');
         }
     }
-    ss << "}";
+    str.push_back('}');
 
-    return ss.str();
+    return str;
 }
 
 std::string Metric::to_prometheus(const std::string& display_name, const Labels& entity_labels,
                                   const Labels& metric_labels) const {
-    std::stringstream ss;
-    ss << display_name                                       // metric name
-       << labels_to_string({&entity_labels, &metric_labels}) // metric labels
-       << " " << to_string() << "\n";                        // metric value
-    return ss.str();
+    std::string str = display_name;                                 // metric name
+    str.append(labels_to_string({&entity_labels, &metric_labels})); // metric labels
+    str.append(" ").append(to_string()).push_back('\n');           // metric value
+    return str;
 }
 
 std::map<std::string, double> HistogramMetric::_s_output_percentiles = {
@@ -336,23 +335,23 @@ std::string MetricRegistry::to_prometheus(bool with_tablet_metrics) const {
     }
 
     // Output
-    std::stringstream ss;
+    std::string str;
     std::string last_group_name;
     for (const auto& entity_metrics_by_type : entity_metrics_by_types) {
         if (last_group_name.empty() ||
             last_group_name != entity_metrics_by_type.first->group_name) {
-            ss << entity_metrics_by_type.first->to_prometheus(_name); // metric TYPE line
+            str.append(entity_metrics_by_type.first->to_prometheus(_name)); // metric TYPE line
         }
         last_group_name = entity_metrics_by_type.first->group_name;
         std::string display_name = entity_metrics_by_type.first->combine_name(_name);
         for (const auto& entity_metric : entity_metrics_by_type.second) {
-            ss << entity_metric.second->to_prometheus(display_name, // metric key-value line
-                                                      entity_metric.first->_labels,
-                                                      entity_metrics_by_type.first->labels);
+            str.append(entity_metric.second->to_prometheus(display_name, // metric key-value line
+                                                           entity_metric.first->_labels,
+                                                           entity_metrics_by_type.first->labels));
         }
     }
 
-    return ss.str();
+    return str;
 }
 
 std::string MetricRegistry::to_json(bool with_tablet_metrics) const {
@@ -146,12 +146,9 @@ public:
     CoreLocalCounter() {}
     virtual ~CoreLocalCounter() {}
 
-    std::string to_string() const override {
-        std::stringstream ss;
-        ss << value();
-        return ss.str();
-    }
+    std::string to_string() const override { return std::to_string(value()); }
 
+    // the sum of the values of all the cores, only aggregated when read
     T value() const {
         T sum = 0;
         for (int i = 0; i < _value.size(); ++i) {
@@ -234,6 +231,9 @@ public:
     virtual ~LockGauge() {}
 };
 
+// The counters incremented on the hot paths are core local, the increments of the threads on
+// different cores don't contend for a cache line. IntAtomicCounter is only for the counters
+// copied from an external source by set_value(), such as /proc/stat.
 using IntCounter = CoreLocalCounter<int64_t>;
 using IntAtomicCounter = AtomicCounter<int64_t>;
 using UIntCounter = CoreLocalCounter<uint64_t>;
@@ -67,7 +67,7 @@ MysqlRowBuffer::MysqlRowBuffer()
           _buf(_default_buf),
           _buf_size(sizeof(_default_buf)),
           _dynamic_mode(0),
-          _len_pos(nullptr) {}
+          _len_pos(0) {}
 
 MysqlRowBuffer::~MysqlRowBuffer() {
     if (_buf != _default_buf) {
@@ -75,22 +75,29 @@ MysqlRowBuffer::~MysqlRowBuffer() {
     }
 }
 
-void MysqlRowBuffer::open_dynamic_mode() {
+int MysqlRowBuffer::open_dynamic_mode() {
     if (!_dynamic_mode) {
+        // the flag and the 8 bytes of the length
+        int ret = reserve(9);
+        if (0 != ret) {
+            LOG(ERROR) << "mysql row buffer reserve failed.";
+            return ret;
+        }
         *_pos++ = NEXT_EIGHT_BYTE;
-        // write length when dynamic mode close
-        _len_pos = _pos;
+        // write length when dynamic mode close, the buffer may be reallocated before it
+        _len_pos = _pos - _buf;
         _pos = _pos + 8;
     }
     _dynamic_mode++;
+    return 0;
 }
 
 void MysqlRowBuffer::close_dynamic_mode() {
     _dynamic_mode--;
 
     if (!_dynamic_mode) {
-        int8store(_len_pos, _pos - _len_pos - 8);
-        _len_pos = nullptr;
+        int8store(_buf + _len_pos, _pos - _buf - _len_pos - 8);
+        _len_pos = 0;
     }
 }
 
@@ -109,7 +109,7 @@ public:
      *
      * NOTE: The open_dynamic_mode() and close_dynamic_mode() need appear in pairs
      */
-    void open_dynamic_mode();
+    int open_dynamic_mode();
 
     /**
      * NOTE: The open_dynamic_mode() and close_dynamic_mode() need appear in pairs
@@ -125,7 +125,8 @@ private:
     char _default_buf[4096];
 
     int _dynamic_mode;
-    char* _len_pos;
+    // the offset of the length of the column in dynamic mode in the buffer
+    int64_t _len_pos;
 };
 
 } // namespace doris
@@ -514,4 +514,73 @@ void PerfCounters::pretty_print(ostream* s) const {
     stream << std::endl;
 }
 
+ThreadPerfEvents::~ThreadPerfEvents() {
+    for (int fd : _fds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+}
+
+ThreadPerfEvents* ThreadPerfEvents::current() {
+    static thread_local ThreadPerfEvents events;
+    static thread_local bool opened = false;
+    static thread_local bool available = false;
+    if (!opened) {
+        opened = true;
+        available = events.open();
+    }
+    return available ? &events : nullptr;
+}
+
+bool ThreadPerfEvents::open() {
+    static const PerfCounters::Counter counters[NUM_EVENTS] = {
+            PerfCounters::PERF_COUNTER_HW_CPU_CYCLES, PerfCounters::PERF_COUNTER_HW_INSTRUCTIONS,
+            PerfCounters::PERF_COUNTER_HW_CACHE_MISSES};
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        perf_event_attr attr;
+        init_event_attr(&attr, counters[i]);
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        // pid 0 and cpu -1 counts the calling thread on any cpu
+        _fds[i] = sys_perf_event_open(&attr, 0, -1, _group_fd, 0);
+        if (_fds[i] < 0) {
+            return false;
+        }
+        if (i == 0) {
+            _group_fd = _fds[i];
+        }
+    }
+    return true;
+}
+
+bool ThreadPerfEvents::read(int64_t* values) const {
+    // the layout of a group read without PERF_FORMAT_ID
+    struct {
+        uint64_t nr;
+        uint64_t values[NUM_EVENTS];
+    } buffer;
+    if (::read(_group_fd, &buffer, sizeof(buffer)) != sizeof(buffer) || buffer.nr != NUM_EVENTS) {
+        return false;
+    }
+    for (int i = 0; i < NUM_EVENTS; ++i) {
+        values[i] = buffer.values[i];
+    }
+    return true;
+}
+
+const char* ThreadPerfEvents::event_name(Event event) {
+    switch (event) {
+    case CPU_CYCLES:
+        return "HWCycles";
+    case INSTRUCTIONS:
+        return "HWInstructions";
+    case LLC_MISSES:
+        return "HWLLCMisses";
+    default:
+        return "";
+    }
+}
+
 } // namespace doris
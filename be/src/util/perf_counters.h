@@ -140,6 +140,37 @@ private:
     int _group_fd;
 };
 
+// The hardware events of the calling thread: cpu cycles, instructions and last level cache
+// misses, counted in the user space. They are opened in a group at the first call of current()
+// in a thread, and read by a single syscall.
+class ThreadPerfEvents {
+public:
+    enum Event {
+        CPU_CYCLES = 0,
+        INSTRUCTIONS,
+        LLC_MISSES,
+        NUM_EVENTS,
+    };
+
+    ~ThreadPerfEvents();
+
+    // The events of the current thread, nullptr if the perf events are not available, e.g. in a
+    // container or when perf_event_paranoid forbids.
+    static ThreadPerfEvents* current();
+
+    // Read the events of the current thread into `values` of NUM_EVENTS.
+    bool read(int64_t* values) const;
+
+    static const char* event_name(Event event);
+
+private:
+    ThreadPerfEvents() = default;
+    bool open();
+
+    int _group_fd = -1;
+    int _fds[NUM_EVENTS] = {-1, -1, -1};
+};
+
 } // namespace doris
 
 #endif
@@ -19,8 +19,10 @@
 
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #include "util/blocking_priority_queue.hpp"
+#include "util/cpu_info.h"
 #include "util/thread_group.h"
 
 namespace doris {
@@ -36,10 +38,14 @@ public:
     //     queue exceeds this size, subsequent calls to Offer will block until there is
     //     capacity available.
     //  -- work_function: the function to run every time an item is consumed from the queue
-    PriorityWorkStealingThreadPool(uint32_t num_threads, uint32_t num_queues, uint32_t queue_size)
-            : PriorityThreadPool(0, 0) {
+    //  -- queue_numa_nodes: the NUMA node of each queue, the threads of the queue run on the
+    //     cores of the node, or anywhere if the node is -1. Empty means no NUMA binding.
+    PriorityWorkStealingThreadPool(uint32_t num_threads, uint32_t num_queues, uint32_t queue_size,
+                                   std::vector<int> queue_numa_nodes = {})
+            : PriorityThreadPool(0, 0), _queue_numa_nodes(std::move(queue_numa_nodes)) {
         DCHECK_GT(num_queues, 0);
         DCHECK_GE(num_threads, num_queues);
+        DCHECK(_queue_numa_nodes.empty() || _queue_numa_nodes.size() == num_queues);
         // init _work_queues first because the work thread needs it
         for (int i = 0; i < num_queues; ++i) {
             _work_queues.emplace_back(std::make_shared<BlockingPriorityQueue<Task>>(queue_size));
@@ -111,6 +117,10 @@ private:
     void work_thread(int thread_id) {
         auto queue_id = thread_id % _work_queues.size();
         auto steal_queue_id = (queue_id + 1) % _work_queues.size();
+        if (!_queue_numa_nodes.empty() && _queue_numa_nodes[queue_id] >= 0) {
+            WARN_IF_ERROR(CpuInfo::bind_current_thread_to_numa_node(_queue_numa_nodes[queue_id]),
+                          "failed to bind the scan thread to NUMA node");
+        }
         while (!is_shutdown()) {
             Task task;
             // avoid blocking get
@@ -142,6 +152,8 @@ private:
     // FIFO order.
     std::vector<std::shared_ptr<BlockingPriorityQueue<Task>>> _work_queues;
 
+    const std::vector<int> _queue_numa_nodes;
+
     // Collection of worker threads that process work from the queues.
     ThreadGroup _threads;
 
@@ -20,11 +20,19 @@
 
 #include <cmath>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "util/coding.h"
 
 namespace doris {
 
+void add_tdigest_to_ddsketch(TDigest* tdigest, DDSketch* ddsketch) {
+    tdigest->compress();
+    for (const auto& centroid : tdigest->processed()) {
+        ddsketch->add(centroid.mean(), std::max<uint64_t>(1, std::llround(centroid.weight())));
+    }
+}
+
 template <typename T>
 QuantileState<T>::QuantileState() : _type(EMPTY), _compression(QUANTILE_STATE_COMPRESSION_MIN) {}
 
@@ -53,6 +61,9 @@ size_t QuantileState<T>::get_serialized_size() {
     case TDIGEST:
         size += _tdigest_ptr->serialized_size();
         break;
+    case DDSKETCH:
+        size += sizeof(uint32_t) + _ddsketch_ptr->serialized_size();
+        break;
     }
     return size;
 }
@@ -106,6 +117,14 @@ bool QuantileState<T>::is_valid(const Slice& slice) {
         ptr += tdigest_serialized_length;
         break;
     }
+    case DDSKETCH: {
+        if ((ptr + sizeof(uint32_t)) > end) {
+            return false;
+        }
+        uint32_t ddsketch_serialized_length = decode_fixed32_le(ptr);
+        ptr += sizeof(uint32_t) + ddsketch_serialized_length;
+        break;
+    }
     default:
         return false;
     }
@@ -143,6 +162,9 @@ T QuantileState<T>::get_value_by_percentile(float percentile) {
     case TDIGEST: {
         return _tdigest_ptr->quantile(percentile);
     }
+    case DDSKETCH: {
+        return _ddsketch_ptr->quantile(percentile);
+    }
     default:
         break;
     }
@@ -195,6 +217,18 @@ bool QuantileState<T>::deserialize(const Slice& slice) {
         _tdigest_ptr->unserialize(ptr);
         break;
     }
+    case DDSKETCH: {
+        // 5: length of DDSketch object value, then the value
+        uint32_t ddsketch_serialized_length = decode_fixed32_le(ptr);
+        ptr += sizeof(uint32_t);
+        _ddsketch_ptr = std::make_unique<DDSketch>();
+        if (!_ddsketch_ptr->deserialize(ptr, ddsketch_serialized_length)) {
+            _ddsketch_ptr.reset();
+            _type = EMPTY;
+            return false;
+        }
+        break;
+    }
     default:
         // revert type to EMPTY
         _type = EMPTY;
@@ -234,6 +268,13 @@ size_t QuantileState<T>::serialize(uint8_t* dst) const {
         ptr += tdigest_size;
         break;
     }
+    case DDSKETCH: {
+        *ptr++ = DDSKETCH;
+        uint32_t ddsketch_size = _ddsketch_ptr->serialize(ptr + sizeof(uint32_t));
+        encode_fixed32_le(ptr, ddsketch_size);
+        ptr += sizeof(uint32_t) + ddsketch_size;
+        break;
+    }
     default:
         break;
     }
@@ -261,23 +302,16 @@ void QuantileState<T>::merge(QuantileState<T>& other) {
             add_value(_single_data);
             break;
         case EXPLICIT:
-            if (_explicit_data.size() + other._explicit_data.size() > QUANTILE_STATE_EXPLICIT_NUM) {
-                _type = TDIGEST;
-                _tdigest_ptr = std::make_unique<TDigest>(_compression);
-                for (int i = 0; i < _explicit_data.size(); i++) {
-                    _tdigest_ptr->add(_explicit_data[i]);
-                }
-                for (int i = 0; i < other._explicit_data.size(); i++) {
-                    _tdigest_ptr->add(other._explicit_data[i]);
-                }
-            } else {
-                _explicit_data.insert(_explicit_data.end(), other._explicit_data.begin(),
-                                      other._explicit_data.end());
+            _explicit_data.insert(_explicit_data.end(), other._explicit_data.begin(),
+                                  other._explicit_data.end());
+            if (_explicit_data.size() > QUANTILE_STATE_EXPLICIT_NUM) {
+                _convert_explicit_to_sketch();
             }
             break;
         case TDIGEST:
+        case DDSKETCH:
             for (int i = 0; i < other._explicit_data.size(); i++) {
-                _tdigest_ptr->add(other._explicit_data[i]);
+                add_value(other._explicit_data[i]);
             }
             break;
         default:
@@ -306,6 +340,44 @@ void QuantileState<T>::merge(QuantileState<T>& other) {
         case TDIGEST:
             _tdigest_ptr->merge(other._tdigest_ptr.get());
             break;
+        case DDSKETCH:
+            add_tdigest_to_ddsketch(other._tdigest_ptr.get(), _ddsketch_ptr.get());
+            break;
+        default:
+            break;
+        }
+        break;
+    }
+    case DDSKETCH: {
+        switch (_type) {
+        case EMPTY:
+            _type = DDSKETCH;
+            _ddsketch_ptr = std::move(other._ddsketch_ptr);
+            break;
+        case SINGLE:
+            _type = DDSKETCH;
+            _ddsketch_ptr = std::move(other._ddsketch_ptr);
+            _ddsketch_ptr->add(_single_data);
+            break;
+        case EXPLICIT:
+            _type = DDSKETCH;
+            _ddsketch_ptr = std::move(other._ddsketch_ptr);
+            for (int i = 0; i < _explicit_data.size(); i++) {
+                _ddsketch_ptr->add(_explicit_data[i]);
+            }
+            _explicit_data.clear();
+            _explicit_data.shrink_to_fit();
+            break;
+        case TDIGEST:
+            // the merged state is a DDSketch, which can't be converted to a TDigest
+            _type = DDSKETCH;
+            _ddsketch_ptr = std::move(other._ddsketch_ptr);
+            add_tdigest_to_ddsketch(_tdigest_ptr.get(), _ddsketch_ptr.get());
+            _tdigest_ptr.reset();
+            break;
+        case DDSKETCH:
+            _ddsketch_ptr->merge(*other._ddsketch_ptr);
+            break;
         default:
             break;
         }
@@ -330,14 +402,8 @@ void QuantileState<T>::add_value(const T& value) {
         break;
     case EXPLICIT:
         if (_explicit_data.size() == QUANTILE_STATE_EXPLICIT_NUM) {
-            _tdigest_ptr = std::make_unique<TDigest>(_compression);
-            for (int i = 0; i < _explicit_data.size(); i++) {
-                _tdigest_ptr->add(_explicit_data[i]);
-            }
-            _explicit_data.clear();
-            _explicit_data.shrink_to_fit();
-            _type = TDIGEST;
-
+            _convert_explicit_to_sketch();
+            add_value(value);
         } else {
             _explicit_data.emplace_back(value);
         }
@@ -345,13 +411,38 @@ void QuantileState<T>::add_value(const T& value) {
     case TDIGEST:
         _tdigest_ptr->add(value);
         break;
+    case DDSKETCH:
+        _ddsketch_ptr->add(value);
+        break;
     }
 }
 
+template <typename T>
+void QuantileState<T>::_convert_explicit_to_sketch() {
+    DCHECK(_type == EXPLICIT);
+    if (config::enable_quantile_ddsketch) {
+        _ddsketch_ptr = std::make_unique<DDSketch>(
+                DDSketch::relative_accuracy_of_compression(_compression));
+        for (int i = 0; i < _explicit_data.size(); i++) {
+            _ddsketch_ptr->add(_explicit_data[i]);
+        }
+        _type = DDSKETCH;
+    } else {
+        _tdigest_ptr = std::make_unique<TDigest>(_compression);
+        for (int i = 0; i < _explicit_data.size(); i++) {
+            _tdigest_ptr->add(_explicit_data[i]);
+        }
+        _type = TDIGEST;
+    }
+    _explicit_data.clear();
+    _explicit_data.shrink_to_fit();
+}
+
 template <typename T>
 void QuantileState<T>::clear() {
     _type = EMPTY;
     _tdigest_ptr.reset();
+    _ddsketch_ptr.reset();
     _explicit_data.clear();
     _explicit_data.shrink_to_fit();
 }
@@ -23,6 +23,7 @@
 
 #include "slice.h"
 #include "tdigest.h"
+#include "util/ddsketch.h"
 
 namespace doris {
 
@@ -37,9 +38,13 @@ enum QuantileStateType {
     EMPTY = 0,
     SINGLE = 1,   // single element
     EXPLICIT = 2, // more than one elements,stored in vector
-    TDIGEST = 3   // TDIGEST object
+    TDIGEST = 3,  // TDIGEST object
+    DDSKETCH = 4  // DDSketch object, when config::enable_quantile_ddsketch is true
 };
 
+// Add the centroids of a TDigest into a DDSketch, to merge the states of the two sketches.
+void add_tdigest_to_ddsketch(TDigest* tdigest, DDSketch* ddsketch);
+
 template <typename T>
 class QuantileState {
 public:
@@ -59,8 +64,12 @@ public:
     ~QuantileState() = default;
 
 private:
+    // Replace the explicit values by a sketch of them, TDIGEST or DDSKETCH by the config.
+    void _convert_explicit_to_sketch();
+
     QuantileStateType _type = EMPTY;
     std::unique_ptr<TDigest> _tdigest_ptr;
+    std::unique_ptr<DDSketch> _ddsketch_ptr;
     T _single_data;
     std::vector<T> _explicit_data;
     float _compression;
@@ -0,0 +1,47 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/rate_limiter.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "util/time.h"
+
+namespace doris {
+
+void RateLimiter::acquire(int64_t bytes) {
+    int64_t bytes_per_sec = _bytes_per_sec();
+    if (bytes_per_sec <= 0 || bytes <= 0) {
+        return;
+    }
+    int64_t now = MonotonicNanos();
+    int64_t wait_until = 0;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _next_free_ns = std::max(_next_free_ns, now);
+        _next_free_ns += static_cast<int64_t>(bytes * 1e9 / bytes_per_sec);
+        wait_until = _next_free_ns;
+    }
+    if (wait_until > now) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(wait_until - now));
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,49 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+
+namespace doris {
+
+// Limit the rate of the bytes consumed by all the threads sharing the limiter, e.g. the bytes
+// written to a disk. The bytes are paced without burst, a thread acquiring bytes waits until
+// they, and the bytes acquired before them, are consumed under the rate.
+class RateLimiter {
+public:
+    // `bytes_per_sec` is called by each acquire to follow the changes of the mutable configs,
+    // there is no limit if it returns <= 0.
+    explicit RateLimiter(std::function<int64_t()> bytes_per_sec)
+            : _bytes_per_sec(std::move(bytes_per_sec)) {}
+
+    // Wait until `bytes` can be consumed under the rate.
+    void acquire(int64_t bytes);
+
+private:
+    std::function<int64_t()> _bytes_per_sec;
+
+    std::mutex _lock;
+    // the monotonic time in ns when the bytes acquired so far are consumed
+    int64_t _next_free_ns = 0;
+};
+
+} // namespace doris
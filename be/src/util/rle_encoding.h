@@ -18,9 +18,12 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #include "gutil/port.h"
 #include "util/bit_stream_utils.inline.h"
 #include "util/bit_util.h"
+#include "util/simd/bit_unpack.h"
 
 namespace doris {
 
@@ -110,6 +113,10 @@ public:
     // GetNextRun will return more from the same run.
     size_t GetNextRun(T* val, size_t max_run);
 
+    // Gets the next 'num' values. Returns the number of values got, which is less than
+    // 'num' only if there are no more.
+    size_t GetBatch(T* values, size_t num);
+
 private:
     bool ReadHeader();
 
@@ -334,6 +341,50 @@ inline size_t RleDecoder<T>::GetNextRun(T* val, size_t max_run) {
     return ret;
 }
 
+template <typename T>
+inline size_t RleDecoder<T>::GetBatch(T* values, size_t num) {
+    DCHECK(bit_reader_.is_initialized());
+    size_t ret = 0;
+    while (ret < num && ReadHeader()) {
+        if (PREDICT_TRUE(repeat_count_ > 0)) {
+            size_t n = std::min(static_cast<size_t>(repeat_count_), num - ret);
+            std::fill(values + ret, values + ret + n, static_cast<T>(current_value_));
+            repeat_count_ -= n;
+            ret += n;
+            rewind_state_ = REWIND_RUN;
+        } else {
+            DCHECK(literal_count_ > 0);
+            size_t n = std::min(static_cast<size_t>(literal_count_), num - ret);
+            literal_count_ -= n;
+            if constexpr (sizeof(T) == 1) {
+                // the literal bits of booleans are expanded a byte at a time once the stream
+                // is at the start of a byte
+                if (bit_width_ == 1) {
+                    for (; n > 0 && bit_reader_.position() % 8 != 0; --n) {
+                        bool result = bit_reader_.GetValue(bit_width_, values + ret++);
+                        DCHECK(result);
+                    }
+                    size_t num_bits = n / 8 * 8;
+                    if (num_bits > 0) {
+                        const uint8_t* bits = bit_reader_.GetAlignedBytes(num_bits / 8);
+                        DCHECK(bits != nullptr);
+                        simd::bits_to_bytes(bits, num_bits,
+                                            reinterpret_cast<uint8_t*>(values + ret));
+                        ret += num_bits;
+                        n -= num_bits;
+                    }
+                }
+            }
+            for (; n > 0; --n) {
+                bool result = bit_reader_.GetValue(bit_width_, values + ret++);
+                DCHECK(result);
+            }
+            rewind_state_ = REWIND_LITERAL;
+        }
+    }
+    return ret;
+}
+
 template <typename T>
 inline size_t RleDecoder<T>::Skip(size_t to_skip) {
     DCHECK(bit_reader_.is_initialized());
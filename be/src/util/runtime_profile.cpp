@@ -20,6 +20,7 @@
 
 #include "util/runtime_profile.h"
 
+#include <cstring>
 #include <iomanip>
 #include <iostream>
 #include <thread>
@@ -676,4 +677,59 @@ void RuntimeProfile::print_child_counters(const std::string& prefix,
     }
 }
 
+HardwareCounters::HardwareCounters(RuntimeProfile* profile, HardwareCounters* total,
+                                   const std::string& prefix)
+        : total(total) {
+    for (int i = 0; i < ThreadPerfEvents::NUM_EVENTS; ++i) {
+        counters[i] = ADD_COUNTER(
+                profile,
+                prefix + ThreadPerfEvents::event_name(static_cast<ThreadPerfEvents::Event>(i)),
+                TUnit::UNIT);
+    }
+}
+
+// the innermost hardware counters scope of the current thread
+static thread_local ScopedHardwareCounters* tls_hardware_counters_scope = nullptr;
+
+ScopedHardwareCounters::ScopedHardwareCounters(HardwareCounters* counters)
+        : _counters(counters) {
+    if (_counters == nullptr) {
+        return;
+    }
+    _events = ThreadPerfEvents::current();
+    if (_events == nullptr || !_events->read(_last_events)) {
+        _events = nullptr;
+        return;
+    }
+    // the events until now belong to the enclosing scope
+    _parent = tls_hardware_counters_scope;
+    if (_parent != nullptr) {
+        _parent->add_events(_last_events);
+    }
+    tls_hardware_counters_scope = this;
+}
+
+ScopedHardwareCounters::~ScopedHardwareCounters() {
+    if (_events == nullptr) {
+        return;
+    }
+    int64_t events[ThreadPerfEvents::NUM_EVENTS];
+    bool read = _events->read(events);
+    if (read) {
+        add_events(events);
+    }
+    tls_hardware_counters_scope = _parent;
+    if (_parent != nullptr && read) {
+        // the events of this scope are not counted by the enclosing scope
+        memcpy(_parent->_last_events, events, sizeof(events));
+    }
+}
+
+void ScopedHardwareCounters::add_events(const int64_t* events) {
+    for (int i = 0; i < ThreadPerfEvents::NUM_EVENTS; ++i) {
+        _counters->update(i, events[i] - _last_events[i]);
+        _last_events[i] = events[i];
+    }
+}
+
 } // namespace doris
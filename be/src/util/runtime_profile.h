@@ -33,6 +33,7 @@
 #include "common/logging.h"
 #include "gen_cpp/RuntimeProfile_types.h"
 #include "util/binary_cast.hpp"
+#include "util/perf_counters.h"
 #include "util/stopwatch.hpp"
 
 namespace doris {
@@ -55,6 +56,8 @@ namespace doris {
 #define SCOPED_ATOMIC_TIMER(c)                                                                 \
     ScopedRawTimer<MonotonicStopWatch, std::atomic<int64_t>> MACRO_CONCAT(SCOPED_ATOMIC_TIMER, \
                                                                           __COUNTER__)(c)
+#define SCOPED_HARDWARE_COUNTERS(c) \
+    doris::ScopedHardwareCounters MACRO_CONCAT(SCOPED_HARDWARE_COUNTERS, __COUNTER__)(c)
 #define COUNTER_UPDATE(c, v) (c)->update(v)
 #define COUNTER_SET(c, v) (c)->set(v)
 
@@ -571,6 +574,45 @@ private:
     C* _counter;
 };
 
+// The counters of the hardware events (see ThreadPerfEvents) of a profile.
+struct HardwareCounters {
+    // Add the counters named by `prefix` and the event names to `profile`. The events added to
+    // the counters are also added to `total` if it's not nullptr.
+    HardwareCounters(RuntimeProfile* profile, HardwareCounters* total = nullptr,
+                     const std::string& prefix = "");
+
+    void update(int event, int64_t delta) {
+        counters[event]->update(delta);
+        if (total != nullptr) {
+            total->update(event, delta);
+        }
+    }
+
+    RuntimeProfile::Counter* counters[ThreadPerfEvents::NUM_EVENTS];
+    HardwareCounters* total;
+};
+
+// Utility class to add the hardware events of the current thread in its scope to the counters,
+// excluding the nested scopes in the thread, so the counters of an exec node don't include the
+// ones of its children. Does nothing if the counters is nullptr or the events are not available.
+class ScopedHardwareCounters {
+public:
+    explicit ScopedHardwareCounters(HardwareCounters* counters);
+    ~ScopedHardwareCounters();
+
+    ScopedHardwareCounters(const ScopedHardwareCounters&) = delete;
+    ScopedHardwareCounters& operator=(const ScopedHardwareCounters&) = delete;
+
+private:
+    // Add the events since the last read to the counters, and update the last read.
+    void add_events(const int64_t* events);
+
+    HardwareCounters* _counters;
+    ThreadPerfEvents* _events = nullptr;
+    ScopedHardwareCounters* _parent = nullptr;
+    int64_t _last_events[ThreadPerfEvents::NUM_EVENTS];
+};
+
 } // namespace doris
 
 #endif
@@ -18,23 +18,39 @@
 #include "util/s3_storage_backend.h"
 
 #include <aws/s3/S3Client.h>
+#include <aws/s3/model/AbortMultipartUploadRequest.h>
+#include <aws/s3/model/CompleteMultipartUploadRequest.h>
+#include <aws/s3/model/CompletedMultipartUpload.h>
+#include <aws/s3/model/CompletedPart.h>
 #include <aws/s3/model/CopyObjectRequest.h>
+#include <aws/s3/model/CreateMultipartUploadRequest.h>
 #include <aws/s3/model/DeleteObjectRequest.h>
 #include <aws/s3/model/GetObjectRequest.h>
 #include <aws/s3/model/HeadObjectRequest.h>
 #include <aws/s3/model/ListObjectsRequest.h>
 #include <aws/s3/model/PutObjectRequest.h>
-#include <boost/algorithm/string.hpp>
+#include <aws/s3/model/UploadPartRequest.h>
+#include <fcntl.h>
+#include <unistd.h>
 
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "gutil/strings/strip.h"
+#include "util/error_util.h"
+#include "util/md5.h"
 #include "util/s3_uri.h"
 #include "util/s3_util.h"
+#include "util/threadpool.h"
 
 namespace doris {
 
@@ -62,6 +78,19 @@ namespace doris {
     }
 #endif
 
+static const int64_t kMinPartSize = 5 * 1024 * 1024;
+
+static uint64_t part_size() {
+    return std::max(config::s3_transfer_part_size_mb * 1024 * 1024, kMinPartSize);
+}
+
+static Status build_transfer_pool(std::unique_ptr<ThreadPool>* pool) {
+    return ThreadPoolBuilder("S3TransferPool")
+            .set_min_threads(1)
+            .set_max_threads(std::max(1, config::s3_transfer_part_parallelism))
+            .build(pool);
+}
+
 S3StorageBackend::S3StorageBackend(const std::map<std::string, std::string>& prop)
         : _properties(prop) {
     _client = ClientFactory::instance().create(_properties);
@@ -91,6 +120,91 @@ Status S3StorageBackend::download(const std::string& remote, const std::string&
     return Status::OK();
 }
 
+Status S3StorageBackend::download_with_md5(const std::string& remote, const std::string& local,
+                                           std::string* md5) {
+    uint64_t size = 0;
+    RETURN_IF_ERROR(file_size(remote, &size));
+    const uint64_t part_length = part_size();
+    const size_t num_parts = (size + part_length - 1) / part_length;
+
+    int fd = open(local.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        return Status::InternalError("failed to open file: " + local + ", " + get_str_err_msg());
+    }
+    std::unique_ptr<ThreadPool> pool;
+    Status status = build_transfer_pool(&pool);
+    if (!status.ok()) {
+        close(fd);
+        return status;
+    }
+
+    // The parts are read in parallel, and written and digested in order by this thread. At
+    // most s3_transfer_part_parallelism parts are read ahead of the part being written, to
+    // bound the memory.
+    struct Part {
+        std::string data;
+        Status status;
+        bool done = false;
+    };
+    std::vector<Part> parts(num_parts);
+    std::mutex lock;
+    std::condition_variable cv;
+    const size_t max_read_ahead = std::max(1, config::s3_transfer_part_parallelism);
+    size_t num_submitted = 0;
+    Md5Digest digest;
+    for (size_t i = 0; i < num_parts && status.ok(); ++i) {
+        while (num_submitted < num_parts && num_submitted < i + max_read_ahead) {
+            size_t part = num_submitted++;
+            status = pool->submit_func([this, &remote, &parts, &lock, &cv, part, part_length]() {
+                std::string data;
+                Status st = read_range(remote, part * part_length, part_length, &data);
+                std::lock_guard<std::mutex> l(lock);
+                parts[part].data = std::move(data);
+                parts[part].status = st;
+                parts[part].done = true;
+                cv.notify_all();
+            });
+            if (!status.ok()) {
+                break;
+            }
+        }
+        if (!status.ok()) {
+            break;
+        }
+        std::string data;
+        {
+            std::unique_lock<std::mutex> l(lock);
+            cv.wait(l, [&parts, i]() { return parts[i].done; });
+            status = parts[i].status;
+            data = std::move(parts[i].data);
+        }
+        if (!status.ok()) {
+            break;
+        }
+        uint64_t expected_length = std::min(part_length, size - i * part_length);
+        if (data.size() != expected_length) {
+            status = Status::IOError("s3 download error: the size of " + remote + " is changed");
+            break;
+        }
+        if (pwrite(fd, data.data(), data.size(), i * part_length) !=
+            static_cast<ssize_t>(data.size())) {
+            status = Status::InternalError("failed to write file: " + local + ", " +
+                                           get_str_err_msg());
+            break;
+        }
+        digest.update(data.data(), data.size());
+    }
+    pool->wait();
+    if (close(fd) != 0 && status.ok()) {
+        status = Status::InternalError("failed to close file: " + local + ", " +
+                                       get_str_err_msg());
+    }
+    RETURN_IF_ERROR(status);
+    digest.digest();
+    *md5 = digest.hex();
+    return Status::OK();
+}
+
 Status S3StorageBackend::direct_download(const std::string& remote, std::string* content) {
     CHECK_S3_CLIENT(_client);
     CHECK_S3_PATH(uri, remote);
@@ -110,6 +224,14 @@ Status S3StorageBackend::direct_download(const std::string& remote, std::string*
 Status S3StorageBackend::upload(const std::string& local, const std::string& remote) {
     CHECK_S3_CLIENT(_client);
     CHECK_S3_PATH(uri, remote);
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(local, ec);
+    if (ec) {
+        return Status::InternalError("failed to get the size of file: " + local);
+    }
+    if (size >= config::s3_multipart_threshold_mb * 1024 * 1024) {
+        return _multipart_upload(uri.get_bucket(), uri.get_key(), local, size);
+    }
     Aws::S3::Model::PutObjectRequest request;
     request.WithBucket(uri.get_bucket()).WithKey(uri.get_key());
 
@@ -126,6 +248,98 @@ Status S3StorageBackend::upload(const std::string& local, const std::string& rem
     RETRUN_S3_STATUS(response);
 }
 
+Status S3StorageBackend::_multipart_upload(const std::string& bucket, const std::string& key,
+                                           const std::string& local, uint64_t size) {
+    int fd = open(local.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return Status::InternalError("failed to read file: " + local + ", " + get_str_err_msg());
+    }
+    Aws::S3::Model::CreateMultipartUploadRequest create_request;
+    create_request.WithBucket(bucket).WithKey(key);
+    auto create_outcome = _client->CreateMultipartUpload(create_request);
+    if (!create_outcome.IsSuccess()) {
+        close(fd);
+        return Status::IOError("s3 create multipart upload error: " + error_msg(create_outcome));
+    }
+    const Aws::String upload_id = create_outcome.GetResult().GetUploadId();
+
+    const uint64_t part_length = part_size();
+    const size_t num_parts = (size + part_length - 1) / part_length;
+    Aws::Vector<Aws::S3::Model::CompletedPart> completed_parts(num_parts);
+    std::unique_ptr<ThreadPool> pool;
+    Status status = build_transfer_pool(&pool);
+    std::mutex lock;
+    for (size_t i = 0; pool != nullptr && i < num_parts; ++i) {
+        Status st = pool->submit_func([&, i]() {
+            {
+                std::lock_guard<std::mutex> l(lock);
+                if (!status.ok()) {
+                    return;
+                }
+            }
+            uint64_t offset = i * part_length;
+            size_t length = std::min(part_length, size - offset);
+            std::string data(length, '\0');
+            Status part_status;
+            if (pread(fd, data.data(), length, offset) != static_cast<ssize_t>(length)) {
+                part_status = Status::InternalError("failed to read file: " + local + ", " +
+                                                    get_str_err_msg());
+            } else {
+                auto body = Aws::MakeShared<Aws::StringStream>("S3StorageBackend");
+                body->write(data.data(), length);
+                Aws::S3::Model::UploadPartRequest request;
+                request.WithBucket(bucket)
+                        .WithKey(key)
+                        .WithUploadId(upload_id)
+                        .WithPartNumber(i + 1)
+                        .WithContentLength(length);
+                request.SetBody(body);
+                auto outcome = _client->UploadPart(request);
+                if (outcome.IsSuccess()) {
+                    completed_parts[i].WithPartNumber(i + 1).WithETag(
+                            outcome.GetResult().GetETag());
+                } else {
+                    part_status = Status::IOError("s3 upload part error: " + error_msg(outcome));
+                }
+            }
+            std::lock_guard<std::mutex> l(lock);
+            if (!part_status.ok() && status.ok()) {
+                status = part_status;
+            }
+        });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(lock);
+            status = st;
+            break;
+        }
+    }
+    if (pool != nullptr) {
+        pool->wait();
+    }
+    close(fd);
+
+    if (status.ok()) {
+        Aws::S3::Model::CompletedMultipartUpload completed_upload;
+        completed_upload.SetParts(completed_parts);
+        Aws::S3::Model::CompleteMultipartUploadRequest request;
+        request.WithBucket(bucket).WithKey(key).WithUploadId(upload_id).WithMultipartUpload(
+                completed_upload);
+        auto outcome = _client->CompleteMultipartUpload(request);
+        if (outcome.IsSuccess()) {
+            return Status::OK();
+        }
+        status = Status::IOError("s3 complete multipart upload error: " + error_msg(outcome));
+    }
+    Aws::S3::Model::AbortMultipartUploadRequest abort_request;
+    abort_request.WithBucket(bucket).WithKey(key).WithUploadId(upload_id);
+    auto abort_outcome = _client->AbortMultipartUpload(abort_request);
+    if (!abort_outcome.IsSuccess()) {
+        LOG(WARNING) << "failed to abort the multipart upload of " << key << ": "
+                     << error_msg(abort_outcome);
+    }
+    return status;
+}
+
 Status S3StorageBackend::list(const std::string& remote_path, bool contain_md5, bool recursion,
                               std::map<std::string, FileStat>* files) {
     std::string normal_str(remote_path);
@@ -291,6 +505,46 @@ Status S3StorageBackend::exist_dir(const std::string& path) {
     return Status::NotFound(path + " not exists!");
 }
 
+Status S3StorageBackend::read_range(const std::string& remote, uint64_t offset, size_t length,
+                                    std::string* content) {
+    content->clear();
+    if (length == 0) {
+        return Status::OK();
+    }
+    CHECK_S3_CLIENT(_client);
+    CHECK_S3_PATH(uri, remote);
+    Aws::S3::Model::GetObjectRequest request;
+    request.WithBucket(uri.get_bucket()).WithKey(uri.get_key());
+    request.SetRange("bytes=" + std::to_string(offset) + "-" +
+                     std::to_string(offset + length - 1));
+    Aws::S3::Model::GetObjectOutcome response = _client->GetObject(request);
+    if (response.IsSuccess()) {
+        std::stringstream ss;
+        ss << response.GetResult().GetBody().rdbuf();
+        *content = ss.str();
+    } else if (response.GetError().GetResponseCode() ==
+               Aws::Http::HttpResponseCode::REQUESTED_RANGE_NOT_SATISFIABLE) {
+        // the offset is beyond the end of the file
+        return Status::OK();
+    } else {
+        return Status::IOError("s3 read_range error: " + error_msg(response));
+    }
+    return Status::OK();
+}
+
+Status S3StorageBackend::file_size(const std::string& remote, uint64_t* size) {
+    CHECK_S3_CLIENT(_client);
+    CHECK_S3_PATH(uri, remote);
+    Aws::S3::Model::HeadObjectRequest request;
+    request.WithBucket(uri.get_bucket()).WithKey(uri.get_key());
+    Aws::S3::Model::HeadObjectOutcome response = _client->HeadObject(request);
+    if (!response.IsSuccess()) {
+        return Status::IOError("s3 file_size error: " + error_msg(response));
+    }
+    *size = response.GetResult().GetContentLength();
+    return Status::OK();
+}
+
 Status S3StorageBackend::upload_with_checksum(const std::string& local, const std::string& remote,
                                               const std::string& checksum) {
     return upload(local, remote + "." + checksum);
@@ -32,7 +32,13 @@ public:
     S3StorageBackend(const std::map<std::string, std::string>& prop);
     ~S3StorageBackend();
     Status download(const std::string& remote, const std::string& local) override;
+    // The file is downloaded by ranged reads of s3_transfer_part_size_mb in parallel, and the
+    // md5 is computed while the parts are written in order.
+    Status download_with_md5(const std::string& remote, const std::string& local,
+                             std::string* md5) override;
     Status direct_download(const std::string& remote, std::string* content) override;
+    // The files of at least s3_multipart_threshold_mb are uploaded by multipart upload, whose
+    // parts are uploaded in parallel.
     Status upload(const std::string& local, const std::string& remote) override;
     Status upload_with_checksum(const std::string& local, const std::string& remote,
                                 const std::string& checksum) override;
@@ -49,8 +55,14 @@ public:
     Status mkdirs(const std::string& path) override;
     Status exist(const std::string& path) override;
     Status exist_dir(const std::string& path) override;
+    Status read_range(const std::string& remote, uint64_t offset, size_t length,
+                      std::string* content) override;
+    Status file_size(const std::string& remote, uint64_t* size) override;
 
 private:
+    Status _multipart_upload(const std::string& bucket, const std::string& key,
+                             const std::string& local, uint64_t size);
+
     template <typename AwsOutcome>
     std::string error_msg(const AwsOutcome& outcome);
     const std::map<std::string, std::string>& _properties;
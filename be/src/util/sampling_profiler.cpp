@@ -0,0 +1,284 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/sampling_profiler.h"
+
+#include <gperftools/stacktrace.h>
+#include <sys/time.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+
+#include "gutil/strings/substitute.h"
+#include "util/countdown_latch.h"
+#include "util/error_util.h"
+#include "util/thread.h"
+
+namespace google {
+bool Symbolize(void* pc, char* out, int out_size);
+} // namespace google
+
+namespace doris {
+
+namespace {
+
+// the frames of the signal handler, skipped in the stacks
+constexpr int kSkipFrames = 2;
+
+const std::string& symbolize(void* address, std::unordered_map<void*, std::string>* symbols) {
+    auto it = symbols->find(address);
+    if (it != symbols->end()) {
+        return it->second;
+    }
+    std::string name;
+    char buf[1024];
+    // the return address points to the instruction after the call
+    if (google::Symbolize(static_cast<char*>(address) - 1, buf, sizeof(buf))) {
+        name = buf;
+        // ';' separates the frames of a folded stack
+        std::replace(name.begin(), name.end(), ';', ':');
+    } else {
+        std::stringstream ss;
+        ss << address;
+        name = ss.str();
+    }
+    return symbols->emplace(address, std::move(name)).first->second;
+}
+
+} // namespace
+
+void SamplingTag::set_task_id(const std::string& id) {
+    task_id_length = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    int32_t length = std::min<size_t>(id.size(), kMaxTaskIdLength);
+    memcpy(task_id, id.data(), length);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    task_id_length = length;
+}
+
+bool SamplingProfiler::StackKey::operator<(const StackKey& other) const {
+    return std::tie(task_id, node_id, frames) <
+           std::tie(other.task_id, other.node_id, other.frames);
+}
+
+Status SamplingProfiler::start(int32_t hz, int32_t window_sec) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_running) {
+        return Status::OK();
+    }
+    if (hz <= 0 || hz > 1000 || window_sec <= 0) {
+        return Status::InvalidArgument(strings::Substitute(
+                "invalid sampling profiler hz $0 or window $1", hz, window_sec));
+    }
+    _hz = hz;
+    _window_sec = window_sec;
+    if (_samples == nullptr) {
+        // never released, the handler may still run after stop()
+        _samples.reset(new Sample[kRingBufferSize]);
+    }
+    // GetStackTrace may allocate at the first call, which is not safe in the signal handler
+    void* frames[kMaxDepth];
+    GetStackTrace(frames, kMaxDepth, 0);
+
+    _stop_latch.reset(new CountDownLatch(1));
+    RETURN_IF_ERROR(Thread::create(
+            "SamplingProfiler", "drain_thread", [this]() { this->_drain_thread(); },
+            &_drain_thread_handle));
+    Status st = _start_timer();
+    if (!st.ok()) {
+        _stop_latch->count_down();
+        _drain_thread_handle->join();
+        return st;
+    }
+    _running = true;
+    LOG(INFO) << "sampling profiler started, hz: " << hz << ", window: " << window_sec << "s";
+    return Status::OK();
+}
+
+void SamplingProfiler::stop() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (!_running) {
+        return;
+    }
+    _stop_timer();
+    // ignore the pending signals instead of the default action, which terminates the process
+    signal(SIGPROF, SIG_IGN);
+    _stop_latch->count_down();
+    _drain_thread_handle->join();
+    drain();
+    _running = false;
+}
+
+void SamplingProfiler::suspend() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_running) {
+        _stop_timer();
+    }
+}
+
+void SamplingProfiler::resume() {
+    std::lock_guard<std::mutex> l(_lock);
+    if (_running) {
+        Status st = _start_timer();
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to resume the sampling profiler: " << st.to_string();
+        }
+    }
+}
+
+Status SamplingProfiler::_start_timer() {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = &SamplingProfiler::_signal_handler;
+    action.sa_flags = SA_RESTART | SA_SIGINFO;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return Status::InternalError(strings::Substitute(
+                "failed to install the SIGPROF handler: $0", get_str_err_msg()));
+    }
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = 1000000 / _hz;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        return Status::InternalError(
+                strings::Substitute("failed to set the ITIMER_PROF: $0", get_str_err_msg()));
+    }
+    return Status::OK();
+}
+
+void SamplingProfiler::_stop_timer() {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void SamplingProfiler::_signal_handler(int signo, siginfo_t* info, void* context) {
+    int saved_errno = errno;
+    instance()->_record_sample();
+    errno = saved_errno;
+}
+
+// Only the async-signal-safe functions can be called here.
+void SamplingProfiler::_record_sample() {
+    uint64_t index = _write_index.fetch_add(1, std::memory_order_relaxed);
+    Sample& sample = _samples[index % kRingBufferSize];
+    sample.seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    sample.time_sec = now.tv_sec;
+    int32_t task_id_length = tls_sampling_tag.task_id_length;
+    memcpy(sample.tag.task_id, tls_sampling_tag.task_id, task_id_length);
+    sample.tag.task_id_length = task_id_length;
+    sample.tag.node_id = tls_sampling_tag.node_id;
+    sample.depth = GetStackTrace(sample.frames, kMaxDepth, kSkipFrames);
+
+    sample.seq.store(index + 1, std::memory_order_release);
+}
+
+void SamplingProfiler::_drain_thread() {
+    while (!_stop_latch->wait_for(std::chrono::seconds(1))) {
+        drain();
+    }
+}
+
+void SamplingProfiler::drain() {
+    std::lock_guard<std::mutex> l(_window_lock);
+    uint64_t write_index = _write_index.load(std::memory_order_acquire);
+    if (write_index - _read_index > kRingBufferSize) {
+        // overwritten before being drained
+        _num_dropped += write_index - kRingBufferSize - _read_index;
+        _read_index = write_index - kRingBufferSize;
+    }
+
+    std::vector<std::pair<int64_t, StackKey>> drained;
+    drained.reserve(write_index - _read_index);
+    for (; _read_index < write_index; ++_read_index) {
+        Sample& sample = _samples[_read_index % kRingBufferSize];
+        uint64_t seq = sample.seq.load(std::memory_order_acquire);
+        if (seq < _read_index + 1) {
+            // still being written, try again in the next drain
+            break;
+        }
+        if (seq > _read_index + 1) {
+            _num_dropped++;
+            continue;
+        }
+        int64_t time_sec = sample.time_sec;
+        StackKey key;
+        key.task_id.assign(sample.tag.task_id,
+                           std::clamp(sample.tag.task_id_length, 0,
+                                      static_cast<int32_t>(SamplingTag::kMaxTaskIdLength)));
+        key.node_id = sample.tag.node_id;
+        key.frames.assign(sample.frames, sample.frames + std::clamp(sample.depth, 0, kMaxDepth));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (sample.seq.load(std::memory_order_relaxed) != seq) {
+            // overwritten during the copy
+            _num_dropped++;
+            continue;
+        }
+        drained.emplace_back(time_sec, std::move(key));
+    }
+
+    for (auto& [time_sec, key] : drained) {
+        _window[time_sec][std::move(key)]++;
+    }
+    int64_t expire_sec = time(nullptr) - _window_sec;
+    while (!_window.empty() && _window.begin()->first < expire_sec) {
+        _window.erase(_window.begin());
+    }
+}
+
+void SamplingProfiler::get_folded_stacks(int64_t start_sec, int64_t end_sec,
+                                         const std::string& task_id, std::string* out) {
+    std::map<StackKey, int64_t> merged;
+    {
+        std::lock_guard<std::mutex> l(_window_lock);
+        for (auto it = _window.lower_bound(start_sec); it != _window.end() && it->first <= end_sec;
+             ++it) {
+            for (auto& [key, count] : it->second) {
+                if (task_id.empty() || key.task_id == task_id) {
+                    merged[key] += count;
+                }
+            }
+        }
+    }
+
+    std::unordered_map<void*, std::string> symbols;
+    for (auto& [key, count] : merged) {
+        out->append(key.task_id.empty() ? "no_task" : key.task_id);
+        out->append(key.node_id < 0 ? ";no_node" : ";node_" + std::to_string(key.node_id));
+        for (auto it = key.frames.rbegin(); it != key.frames.rend(); ++it) {
+            out->push_back(';');
+            out->append(symbolize(*it, &symbols));
+        }
+        out->push_back(' ');
+        out->append(std::to_string(count));
+        out->push_back('\n');
+    }
+}
+
+} // namespace doris
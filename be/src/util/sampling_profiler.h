@@ -0,0 +1,167 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <signal.h>
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/macros.h"
+#include "gutil/ref_counted.h"
+
+namespace doris {
+
+class CountDownLatch;
+class Thread;
+
+// The tags of the samples taken on the current thread. The task id is set by ThreadContext
+// when the thread attaches to a task (the query id for a query), and the node id is set by
+// the exec nodes during their work. Written by the thread itself, and read by the signal
+// handler of the sampling profiler interrupting it.
+struct SamplingTag {
+    static constexpr int kMaxTaskIdLength = 64;
+
+    char task_id[kMaxTaskIdLength] = {};
+    // the handler only reads the first `task_id_length` bytes of `task_id`, so the length
+    // is cleared during the update of the task id
+    int32_t task_id_length = 0;
+    int32_t node_id = -1;
+
+    void set_task_id(const std::string& id);
+};
+
+inline thread_local SamplingTag tls_sampling_tag;
+
+// Tag the samples taken in the scope with the exec node id.
+class ScopedSamplingNodeTag {
+public:
+    explicit ScopedSamplingNodeTag(int32_t node_id) : _prev_node_id(tls_sampling_tag.node_id) {
+        tls_sampling_tag.node_id = node_id;
+    }
+
+    ~ScopedSamplingNodeTag() { tls_sampling_tag.node_id = _prev_node_id; }
+
+private:
+    int32_t _prev_node_id;
+};
+
+#define SCOPED_SAMPLING_NODE_TAG(node_id) \
+    ScopedSamplingNodeTag VARNAME_LINENUM(sampling_node_tag)(node_id)
+
+// An always-on profiler sampling the cpu stacks of the process at a low rate.
+// The ITIMER_PROF timer sends a SIGPROF every 1/hz second of the cpu time consumed by the
+// process, and the handler records the stack and the tags of the interrupted thread into a
+// ring buffer. A background thread drains the ring buffer every second into the per-second
+// counts of the distinct stacks, and the counts of the recent window are kept, so the stacks
+// of a past time range can be exported as the folded stacks of a flame graph.
+//
+// gperftools' cpu profiler also uses SIGPROF, so the sampling must be suspended while it runs.
+class SamplingProfiler {
+public:
+    static constexpr int kMaxDepth = 48;
+
+    static SamplingProfiler* instance() {
+        static SamplingProfiler profiler;
+        return &profiler;
+    }
+
+    // Start sampling at `hz` samples per second of cpu time, and keep the samples of
+    // the last `window_sec` seconds.
+    Status start(int32_t hz, int32_t window_sec);
+    void stop();
+
+    bool is_running() const { return _running; }
+
+    // Stop and restart the timer, around the other users of SIGPROF.
+    void suspend();
+    void resume();
+
+    // Move the samples of the ring buffer to the window. Called every second by the
+    // background thread.
+    void drain();
+
+    // Append the folded stacks ("frame;frame;... count" lines, the root first) of the samples
+    // in the seconds [start_sec, end_sec] of the unix time to `out`. The first two frames of
+    // each stack are the task id and the exec node id of the sample. Only the samples of the
+    // task `task_id` are exported if it's not empty.
+    void get_folded_stacks(int64_t start_sec, int64_t end_sec, const std::string& task_id,
+                           std::string* out);
+
+    int64_t num_samples() const { return _write_index.load(std::memory_order_relaxed); }
+    int64_t num_dropped_samples() const { return _num_dropped.load(std::memory_order_relaxed); }
+
+private:
+    // A slot of the ring buffer. `seq` is the index of the sample + 1 once written, and 0
+    // during the write, so the reader can detect the slots overwritten during its copy.
+    struct Sample {
+        std::atomic<uint64_t> seq {0};
+        int64_t time_sec;
+        SamplingTag tag;
+        int32_t depth;
+        void* frames[kMaxDepth];
+    };
+
+    struct StackKey {
+        std::string task_id;
+        int32_t node_id;
+        std::vector<void*> frames;
+
+        bool operator<(const StackKey& other) const;
+    };
+
+    SamplingProfiler() = default;
+    ~SamplingProfiler() = default;
+
+    static void _signal_handler(int signo, siginfo_t* info, void* context);
+    void _record_sample();
+    Status _start_timer();
+    void _stop_timer();
+    void _drain_thread();
+
+    static constexpr size_t kRingBufferSize = 8192;
+
+    // protect the start, stop, suspend and resume
+    std::mutex _lock;
+    std::atomic<bool> _running {false};
+    int32_t _hz = 0;
+    int32_t _window_sec = 0;
+
+    std::unique_ptr<Sample[]> _samples;
+    std::atomic<uint64_t> _write_index {0};
+    std::mutex _window_lock;
+    // protected by _window_lock
+    uint64_t _read_index = 0;
+    // the counts of the distinct stacks of each second
+    std::map<int64_t, std::map<StackKey, int64_t>> _window;
+    std::atomic<int64_t> _num_dropped {0};
+
+    std::unique_ptr<CountDownLatch> _stop_latch;
+    scoped_refptr<Thread> _drain_thread_handle;
+
+    DISALLOW_COPY_AND_ASSIGN(SamplingProfiler);
+};
+
+} // namespace doris
@@ -0,0 +1,193 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/simd/bit_unpack.h"
+
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "util/cpu_info.h"
+
+namespace doris::simd {
+
+bool has_avx512_bit_unpack() {
+#if defined(__x86_64__)
+    return CpuInfo::is_supported(CpuInfo::AVX512BW) &&
+           CpuInfo::is_supported(CpuInfo::AVX512VBMI);
+#else
+    return false;
+#endif
+}
+
+#if defined(__x86_64__)
+
+#define AVX512BW_TARGET __attribute__((target("avx512f,avx512bw")))
+#define AVX512VBMI_TARGET __attribute__((target("avx512f,avx512bw,avx512vbmi")))
+
+// the _mm512_undefined_*() in the intrinsics are false positives of gcc 12
+#pragma GCC diagnostic push
+#if !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace {
+
+// The mask of the first `len` bytes of a 64 bytes register.
+inline uint64_t first_bytes_mask(size_t len) {
+    return len >= 64 ? ~0ULL : (1ULL << len) - 1;
+}
+
+// Each 32-bit (or 64-bit) lane takes the 4 (or 8) bytes from the byte of the first bit of its
+// value, in big endian, so the bits of the value are contiguous. Then they're shifted to the
+// top of the lane and down to the bottom.
+template <typename Lane>
+void unpack_shuffle(int bit_width, uint8_t* index, Lane* shifts) {
+    constexpr int LANES = 64 / sizeof(Lane);
+    for (int i = 0; i < LANES; ++i) {
+        int bit = i * bit_width;
+        for (int k = 0; k < static_cast<int>(sizeof(Lane)); ++k) {
+            index[i * sizeof(Lane) + k] = (bit >> 3) + sizeof(Lane) - 1 - k;
+        }
+        shifts[i] = bit & 7;
+    }
+}
+
+// 16 values of at most 25 bits, so a value and its shift fit in a 32-bit lane.
+template <typename T>
+AVX512VBMI_TARGET size_t unpack_epi32(const uint8_t* input, size_t input_len, size_t num,
+                                      int bit_width, T* output) {
+    alignas(64) uint8_t index[64];
+    alignas(64) uint32_t shifts[16];
+    unpack_shuffle(bit_width, index, shifts);
+    const __m512i shuffle = _mm512_load_si512(index);
+    const __m512i left = _mm512_load_si512(shifts);
+    const __m512i right = _mm512_set1_epi32(32 - bit_width);
+    const size_t chunk_bytes = 2 * bit_width;
+
+    size_t n = 0;
+    for (; n + 16 <= num; n += 16, input += chunk_bytes, input_len -= chunk_bytes) {
+        // the bytes after the input are zeros instead of being read
+        __m512i bytes = _mm512_maskz_loadu_epi8(first_bytes_mask(input_len), input);
+        __m512i values = _mm512_permutexvar_epi8(shuffle, bytes);
+        values = _mm512_srlv_epi32(_mm512_sllv_epi32(values, left), right);
+        if constexpr (sizeof(T) == 1) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(output + n),
+                             _mm512_cvtepi32_epi8(values));
+        } else if constexpr (sizeof(T) == 2) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + n),
+                                _mm512_cvtepi32_epi16(values));
+        } else if constexpr (sizeof(T) == 4) {
+            _mm512_storeu_si512(output + n, values);
+        } else {
+            _mm512_storeu_si512(output + n, _mm512_cvtepu32_epi64(_mm512_castsi512_si256(values)));
+            _mm512_storeu_si512(output + n + 8,
+                                _mm512_cvtepu32_epi64(_mm512_extracti64x4_epi64(values, 1)));
+        }
+    }
+    return n;
+}
+
+// 8 values of at most 56 bits, in 64-bit lanes.
+template <typename T>
+AVX512VBMI_TARGET size_t unpack_epi64(const uint8_t* input, size_t input_len, size_t num,
+                                      int bit_width, T* output) {
+    static_assert(sizeof(T) >= 4);
+    alignas(64) uint8_t index[64];
+    alignas(64) uint64_t shifts[8];
+    unpack_shuffle(bit_width, index, shifts);
+    const __m512i shuffle = _mm512_load_si512(index);
+    const __m512i left = _mm512_load_si512(shifts);
+    const __m512i right = _mm512_set1_epi64(64 - bit_width);
+    const size_t chunk_bytes = bit_width;
+
+    size_t n = 0;
+    for (; n + 8 <= num; n += 8, input += chunk_bytes, input_len -= chunk_bytes) {
+        __m512i bytes = _mm512_maskz_loadu_epi8(first_bytes_mask(input_len), input);
+        __m512i values = _mm512_permutexvar_epi8(shuffle, bytes);
+        values = _mm512_srlv_epi64(_mm512_sllv_epi64(values, left), right);
+        if constexpr (sizeof(T) == 4) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(output + n),
+                                _mm512_cvtepi64_epi32(values));
+        } else {
+            _mm512_storeu_si512(output + n, values);
+        }
+    }
+    return n;
+}
+
+AVX512BW_TARGET void bits_to_bytes_avx512(const uint8_t* input, size_t num, uint8_t* output) {
+    const __m512i ones = _mm512_set1_epi8(1);
+    size_t i = 0;
+    for (; i + 64 <= num; i += 64) {
+        uint64_t bits;
+        memcpy(&bits, input + i / 8, sizeof(bits));
+        _mm512_storeu_si512(output + i, _mm512_maskz_mov_epi8(bits, ones));
+    }
+    if (i < num) {
+        uint64_t bits = 0;
+        memcpy(&bits, input + i / 8, (num - i) / 8);
+        _mm512_mask_storeu_epi8(output + i, first_bytes_mask(num - i),
+                                _mm512_maskz_mov_epi8(bits, ones));
+    }
+}
+
+} // namespace
+
+#pragma GCC diagnostic pop
+
+#endif
+
+template <typename T>
+size_t bit_unpack_msb_avx512(const uint8_t* input, size_t input_len, size_t num, int bit_width,
+                             T* output) {
+#if defined(__x86_64__)
+    if (bit_width >= 1 && bit_width <= 25) {
+        return unpack_epi32(input, input_len, num, bit_width, output);
+    }
+    if constexpr (sizeof(T) >= 4) {
+        if (bit_width > 25 && bit_width <= 56) {
+            return unpack_epi64(input, input_len, num, bit_width, output);
+        }
+    }
+#endif
+    return 0;
+}
+
+template size_t bit_unpack_msb_avx512<uint8_t>(const uint8_t*, size_t, size_t, int, uint8_t*);
+template size_t bit_unpack_msb_avx512<uint16_t>(const uint8_t*, size_t, size_t, int, uint16_t*);
+template size_t bit_unpack_msb_avx512<uint32_t>(const uint8_t*, size_t, size_t, int, uint32_t*);
+template size_t bit_unpack_msb_avx512<uint64_t>(const uint8_t*, size_t, size_t, int, uint64_t*);
+
+void bits_to_bytes(const uint8_t* input, size_t num, uint8_t* output) {
+#if defined(__x86_64__)
+    if (CpuInfo::is_supported(CpuInfo::AVX512BW)) {
+        bits_to_bytes_avx512(input, num, output);
+        return;
+    }
+#endif
+    for (size_t i = 0; i < num; i += 8) {
+        // spread the 8 bits to the 8 bytes, then turn the nonzero bytes to 1
+        uint64_t bytes = (input[i / 8] * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+        bytes = ((bytes + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+        memcpy(output + i, &bytes, sizeof(bytes));
+    }
+}
+
+} // namespace doris::simd
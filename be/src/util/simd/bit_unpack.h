@@ -0,0 +1,47 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace doris::simd {
+
+// The AVX-512 kernels of the decoding of the bit-packed storage encodings. The binary is built
+// for the CPUs without AVX-512, so they are compiled for the AVX-512 targets alone and chosen
+// at runtime by CpuInfo.
+
+// Whether bit_unpack_msb_avx512() can be used, it needs the byte permutes of AVX-512 VBMI.
+bool has_avx512_bit_unpack();
+
+// Unpack the `num` values of `bit_width` bits packed from the most significant bit of each
+// byte (the layout of ForEncoder) at the `input_len` bytes of `input` into `output`, 16 values
+// (or 8 values when `bit_width` is greater than 25) at a time. Returns the number of values
+// unpacked, the rest (at most 15) are left to the caller. They start at a byte boundary of
+// `input`. The width of the values up to 56 bits are supported, nothing is unpacked otherwise.
+// Only call it when has_avx512_bit_unpack() returns true.
+template <typename T>
+size_t bit_unpack_msb_avx512(const uint8_t* input, size_t input_len, size_t num, int bit_width,
+                             T* output);
+
+// Expand the `num` bits packed from the least significant bit of each byte (the layout of
+// BitWriter) at `input` into the bytes of 0 or 1 at `output`, `num` must be a multiple of 8.
+// Uses AVX-512BW when it's supported.
+void bits_to_bytes(const uint8_t* input, size_t num, uint8_t* output);
+
+} // namespace doris::simd
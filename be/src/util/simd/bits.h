@@ -23,6 +23,12 @@
 #include <emmintrin.h>
 #endif
 
+#if defined(__SSSE3__) && !defined(__AVX2__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include "util/sse2neon.h"
+#endif
+
 namespace doris {
 namespace simd {
 
@@ -55,5 +61,92 @@ inline uint32_t bytes32_mask_to_bits32_mask(const bool* data) {
     return bytes32_mask_to_bits32_mask(reinterpret_cast<const uint8_t*>(data));
 }
 
+/// Transform the bytes equal to `c` of the 16 bytes at `data` to a 16-bit mask
+inline uint32_t bytes16_equal_mask(const char* data, char c) {
+#if defined(__SSE2__) || defined(__aarch64__)
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_set1_epi8(c))));
+#else
+    uint32_t mask = 0;
+    for (size_t i = 0; i < 16; ++i) {
+        mask |= static_cast<uint32_t>(data[i] == c) << i;
+    }
+    return mask;
+#endif
+}
+
+/// Call `callback(pos)` for each position of `c` in data[0, size) in order. The bytes are
+/// compared 16 at a time, so the short values between the positions, e.g. the fields of a csv
+/// line, don't cost a call of memchr each.
+template <typename Callback>
+inline void for_each_char_position(const char* data, size_t size, char c, Callback callback) {
+    size_t pos = 0;
+    for (; pos + 16 <= size; pos += 16) {
+        uint32_t mask = bytes16_equal_mask(data + pos, c);
+        while (mask != 0) {
+            callback(pos + __builtin_ctz(mask));
+            mask &= mask - 1;
+        }
+    }
+    for (; pos < size; ++pos) {
+        if (data[pos] == c) {
+            callback(pos);
+        }
+    }
+}
+
+// The pshufb masks to move the 16-bit lanes selected by a 8-bit mask to the front of 8 lanes,
+// the lane i of the entry m is selected if the bit i of m is set.
+struct SelectionShuffleTable {
+    uint8_t masks[256][16];
+};
+
+constexpr SelectionShuffleTable make_selection_shuffle_table() {
+    SelectionShuffleTable table {};
+    for (int m = 0; m < 256; ++m) {
+        int k = 0;
+        for (int i = 0; i < 8; ++i) {
+            if (m & (1 << i)) {
+                table.masks[m][2 * k] = 2 * i;
+                table.masks[m][2 * k + 1] = 2 * i + 1;
+                ++k;
+            }
+        }
+        for (; k < 8; ++k) {
+            table.masks[m][2 * k] = 0x80;
+            table.masks[m][2 * k + 1] = 0x80;
+        }
+    }
+    return table;
+}
+
+inline constexpr SelectionShuffleTable selection_shuffle_table = make_selection_shuffle_table();
+
+/// Copy the entries of src[0, 32) whose bits are set in `mask` to the front of dst, and return
+/// the number of the copied entries. dst may alias src as long as dst <= src, which makes it
+/// usable to compact a selection vector in place. The entries of dst[0, 32) after the copied
+/// ones may be overwritten.
+inline uint16_t compact_selection_by_bits32_mask(uint32_t mask, const uint16_t* src,
+                                                 uint16_t* dst) {
+    uint16_t size = 0;
+#if defined(__SSSE3__) || defined(__aarch64__)
+    for (int i = 0; i < 4; ++i) {
+        uint8_t byte_mask = (mask >> (i * 8)) & 0xff;
+        __m128i lanes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 8));
+        __m128i shuffle = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(selection_shuffle_table.masks[byte_mask]));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + size),
+                         _mm_shuffle_epi8(lanes, shuffle));
+        size += __builtin_popcount(byte_mask);
+    }
+#else
+    for (int i = 0; i < 32; ++i) {
+        dst[size] = src[i];
+        size += (mask >> i) & 1;
+    }
+#endif
+    return size;
+}
+
 } // namespace simd
 } // namespace doris
\ No newline at end of file
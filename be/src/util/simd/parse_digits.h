@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__aarch64__)
+#include "util/sse2neon.h"
+#endif
+
+namespace doris::simd {
+
+// Parse the 8 decimal digits at `s` into `*val` by SWAR (8 digits in one uint64), return false
+// if any of them is not a digit. The bytes are in little endian.
+inline bool parse_eight_digits(const char* s, uint64_t* val) {
+    uint64_t chunk;
+    memcpy(&chunk, s, sizeof(chunk));
+    // the high bit of a byte is set if it's greater than '9' or less than '0'
+    if ((((chunk + 0x4646464646464646) | (chunk - 0x3030303030303030)) & 0x8080808080808080) !=
+        0) {
+        return false;
+    }
+    chunk -= 0x3030303030303030;
+    // the pairs, the quads and the whole 8 digits
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FF) * 0x000F424000000064) +
+             (((chunk >> 16) & 0x000000FF000000FF) * 0x0000271000000001)) >>
+            32;
+    *val = chunk;
+    return true;
+}
+
+// Parse the 16 decimal digits at `s` into `*val`, return false if any of them is not a digit.
+inline bool parse_sixteen_digits(const char* s, uint64_t* val) {
+#if defined(__SSSE3__) || defined(__aarch64__)
+    const __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s)),
+                                        _mm_set1_epi8('0'));
+    const __m128i nine = _mm_set1_epi8(9);
+    if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(digits, nine), nine)) != 0xFFFF) {
+        return false;
+    }
+    // 8 numbers of 2 digits, 4 numbers of 4 digits, and then 2 numbers of 8 digits
+    const __m128i pairs = _mm_maddubs_epi16(digits, _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10,
+                                                                  1, 10, 1, 10, 1, 10, 1));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1));
+    const __m128i octets = _mm_madd_epi16(_mm_packs_epi32(quads, quads),
+                                          _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1));
+    const uint64_t high = static_cast<uint32_t>(_mm_cvtsi128_si32(octets));
+    const uint64_t low = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(octets, 4)));
+    *val = high * 100000000 + low;
+    return true;
+#else
+    uint64_t high = 0;
+    uint64_t low = 0;
+    if (!parse_eight_digits(s, &high) || !parse_eight_digits(s + 8, &low)) {
+        return false;
+    }
+    *val = high * 100000000 + low;
+    return true;
+#endif
+}
+
+} // namespace doris::simd
@@ -31,6 +31,10 @@ SM3Digest::~SM3Digest() {
     EVP_MD_CTX_free(_ctx);
 }
 
+void SM3Digest::reset() {
+    EVP_DigestInit_ex(_ctx, _md, NULL);
+}
+
 void SM3Digest::update(const void* data, size_t length) {
     EVP_DigestUpdate(_ctx, data, length);
 }
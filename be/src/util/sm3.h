@@ -29,6 +29,8 @@ class SM3Digest {
 public:
     SM3Digest();
     ~SM3Digest();
+    // start a new digest, so one object can digest many values without a new context
+    void reset();
     void update(const void* data, size_t length);
     void digest();
 
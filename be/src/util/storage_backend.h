@@ -17,7 +17,12 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <string>
+
 #include "common/status.h"
+#include "util/file_utils.h"
 
 namespace doris {
 
@@ -30,6 +35,15 @@ struct FileStat {
 class StorageBackend {
 public:
     virtual Status download(const std::string& remote, const std::string& local) = 0;
+
+    // Download the remote file, and output the md5 of its content to `md5`.
+    // The default implementation reads the downloaded file again to compute the md5.
+    virtual Status download_with_md5(const std::string& remote, const std::string& local,
+                                     std::string* md5) {
+        RETURN_IF_ERROR(download(remote, local));
+        return FileUtils::md5sum(local, md5);
+    }
+
     virtual Status direct_download(const std::string& remote, std::string* content) = 0;
     virtual Status upload(const std::string& local, const std::string& remote) = 0;
     virtual Status upload_with_checksum(const std::string& local, const std::string& remote,
@@ -48,6 +62,29 @@ public:
     virtual Status exist(const std::string& path) = 0;
     virtual Status exist_dir(const std::string& path) = 0;
 
+    // Read at most `length` bytes at `offset` of the remote file into `content`,
+    // fewer bytes are read if it reaches the end of the file.
+    // The default implementation downloads the whole file.
+    virtual Status read_range(const std::string& remote, uint64_t offset, size_t length,
+                              std::string* content) {
+        std::string whole;
+        RETURN_IF_ERROR(direct_download(remote, &whole));
+        content->clear();
+        if (offset < whole.size()) {
+            content->assign(whole, offset, length);
+        }
+        return Status::OK();
+    }
+
+    // Get the size of the remote file.
+    // The default implementation downloads the whole file.
+    virtual Status file_size(const std::string& remote, uint64_t* size) {
+        std::string whole;
+        RETURN_IF_ERROR(direct_download(remote, &whole));
+        *size = whole.size();
+        return Status::OK();
+    }
+
     virtual ~StorageBackend() = default;
 };
 } // end namespace doris
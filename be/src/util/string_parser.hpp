@@ -32,6 +32,7 @@
 #include "common/compiler_util.h"
 #include "common/status.h"
 #include "runtime/primitive_type.h"
+#include "util/simd/parse_digits.h"
 
 namespace doris {
 
@@ -399,14 +400,32 @@ inline T StringParser::string_to_int_no_overflow(const char* s, int len, ParseRe
         *result = PARSE_SUCCESS;
         return val;
     }
-    // Factor out the first char for error handling speeds up the loop.
-    if (LIKELY(s[0] >= '0' && s[0] <= '9')) {
-        val = s[0] - '0';
-    } else {
-        *result = PARSE_FAILURE;
-        return 0;
+    // Parse 16 or 8 digits a step first, the remaining digits are parsed one by one.
+    int i = 0;
+    uint64_t digits = 0;
+    if constexpr (sizeof(T) >= sizeof(uint64_t)) {
+        while (i + 16 <= len && simd::parse_sixteen_digits(s + i, &digits)) {
+            val = val * 10000000000000000ULL + digits;
+            i += 16;
+        }
+    }
+    if constexpr (sizeof(T) >= sizeof(uint32_t)) {
+        while (i + 8 <= len && simd::parse_eight_digits(s + i, &digits)) {
+            val = val * 100000000 + digits;
+            i += 8;
+        }
+    }
+    if (i == 0) {
+        // Factor out the first char for error handling speeds up the loop.
+        if (LIKELY(s[0] >= '0' && s[0] <= '9')) {
+            val = s[0] - '0';
+        } else {
+            *result = PARSE_FAILURE;
+            return 0;
+        }
+        i = 1;
     }
-    for (int i = 1; i < len; ++i) {
+    for (; i < len; ++i) {
         if (LIKELY(s[i] >= '0' && s[i] <= '9')) {
             T digit = s[i] - '0';
             val = val * 10 + digit;
@@ -680,6 +680,14 @@ void SystemMetrics::get_disks_io_time(std::map<std::string, int64_t>* map) {
     }
 }
 
+int64_t SystemMetrics::get_disk_io_time_ms(const std::string& device) {
+    auto it = _disk_metrics.find(device);
+    if (it == _disk_metrics.end()) {
+        return -1;
+    }
+    return it->second->disk_io_time_ms->value();
+}
+
 void SystemMetrics::get_network_traffic(std::map<std::string, int64_t>* send_map,
                                         std::map<std::string, int64_t>* rcv_map) {
     send_map->clear();
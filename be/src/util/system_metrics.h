@@ -41,6 +41,8 @@ public:
     void update();
 
     void get_disks_io_time(std::map<std::string, int64_t>* map);
+    // io time of the disk device in ms, -1 if the device is not monitored
+    int64_t get_disk_io_time_ms(const std::string& device);
     int64_t get_max_io_util(const std::map<std::string, int64_t>& lst_value, int64_t interval_sec);
 
     void get_network_traffic(std::map<std::string, int64_t>* send_map,
@@ -23,6 +23,7 @@
 #include <cstdint>
 #include <limits>
 #include <ostream>
+#include <random>
 
 #include "common/logging.h"
 #include "gutil/macros.h"
@@ -38,6 +39,15 @@ namespace doris {
 using std::string;
 using strings::Substitute;
 
+namespace {
+
+// The pool and the home worker queue of the current worker thread, for the tasks
+// submitted by the tasks of a work stealing pool.
+thread_local ThreadPool* tls_current_pool = nullptr;
+thread_local size_t tls_home_queue = 0;
+
+} // namespace
+
 class FunctionRunnable : public Runnable {
 public:
     explicit FunctionRunnable(std::function<void()> func) : _func(std::move(func)) {}
@@ -53,7 +63,8 @@ ThreadPoolBuilder::ThreadPoolBuilder(string name)
           _min_threads(0),
           _max_threads(base::NumCPUs()),
           _max_queue_size(std::numeric_limits<int>::max()),
-          _idle_timeout(std::chrono::milliseconds(500)) {}
+          _idle_timeout(std::chrono::milliseconds(500)),
+          _work_stealing(false) {}
 
 ThreadPoolBuilder& ThreadPoolBuilder::set_min_threads(int min_threads) {
     CHECK_GE(min_threads, 0);
@@ -72,6 +83,11 @@ ThreadPoolBuilder& ThreadPoolBuilder::set_max_queue_size(int max_queue_size) {
     return *this;
 }
 
+ThreadPoolBuilder& ThreadPoolBuilder::set_work_stealing(bool work_stealing) {
+    _work_stealing = work_stealing;
+    return *this;
+}
+
 Status ThreadPoolBuilder::build(std::unique_ptr<ThreadPool>* pool) const {
     pool->reset(new ThreadPool(*this));
     RETURN_IF_ERROR((*pool)->init());
@@ -242,12 +258,23 @@ ThreadPool::ThreadPool(const ThreadPoolBuilder& builder)
           _max_threads(builder._max_threads),
           _max_queue_size(builder._max_queue_size),
           _idle_timeout(builder._idle_timeout),
+          _work_stealing(builder._work_stealing),
           _pool_status(Status::Uninitialized("The pool was not initialized.")),
           _num_threads(0),
           _num_threads_pending_start(0),
           _active_threads(0),
           _total_queued_tasks(0),
-          _tokenless(new_token(ExecutionMode::CONCURRENT)) {}
+          _next_submit_queue(0),
+          _next_home_queue(0),
+          _num_stealable_queued(0),
+          _num_stealable_running(0),
+          _tokenless(new_token(ExecutionMode::CONCURRENT)) {
+    if (_work_stealing) {
+        for (int i = 0; i < std::max(1, _max_threads); ++i) {
+            _worker_queues.emplace_back(new WorkerQueue());
+        }
+    }
+}
 
 ThreadPool::~ThreadPool() {
     // There should only be one live token: the one used in tokenless submission.
@@ -312,6 +339,17 @@ void ThreadPool::shutdown() {
         }
     }
 
+    size_t num_released_stealable = 0;
+    for (auto& queue : _worker_queues) {
+        std::lock_guard<SpinLock> ql(queue->lock);
+        num_released_stealable += queue->tasks.size();
+        if (!queue->tasks.empty()) {
+            to_release.emplace_back(std::move(queue->tasks));
+            queue->tasks.clear();
+        }
+    }
+    _num_stealable_queued -= num_released_stealable;
+
     // The queues are empty. Wake any sleeping worker threads and wait for all
     // of them to exit. Some worker threads will exit immediately upon waking,
     // while others will exit after they finish executing an outstanding task.
@@ -367,9 +405,15 @@ Status ThreadPool::do_submit(std::shared_ptr<Runnable> r, ThreadPoolToken* token
         return Status::ServiceUnavailable("Thread pool token was shut down");
     }
 
+    // The tokenless tasks of a work stealing pool go to the worker queues.
+    bool stealable = _work_stealing && token == _tokenless.get();
+    int num_stealable_queued = _num_stealable_queued;
+    int num_stealable_running = _num_stealable_running;
+
     // Size limit check.
-    int64_t capacity_remaining = static_cast<int64_t>(_max_threads) - _active_threads +
-                                 static_cast<int64_t>(_max_queue_size) - _total_queued_tasks;
+    int64_t capacity_remaining =
+            static_cast<int64_t>(_max_threads) - _active_threads - num_stealable_running +
+            static_cast<int64_t>(_max_queue_size) - _total_queued_tasks - num_stealable_queued;
     if (capacity_remaining < 1) {
         return Status::ServiceUnavailable(strings::Substitute(
                 "Thread pool is at capacity ($0/$1 tasks running, $2/$3 tasks queued)",
@@ -395,9 +439,10 @@ Status ThreadPool::do_submit(std::shared_ptr<Runnable> r, ThreadPoolToken* token
     // Of course, we never create more than _max_threads threads no matter what.
     int threads_from_this_submit =
             token->is_active() && token->mode() == ExecutionMode::SERIAL ? 0 : 1;
-    int inactive_threads = _num_threads + _num_threads_pending_start - _active_threads;
-    int additional_threads =
-            static_cast<int>(_queue.size()) + threads_from_this_submit - inactive_threads;
+    int inactive_threads = _num_threads + _num_threads_pending_start - _active_threads -
+                           num_stealable_running;
+    int additional_threads = static_cast<int>(_queue.size()) + num_stealable_queued +
+                             threads_from_this_submit - inactive_threads;
     bool need_a_thread = false;
     if (additional_threads > 0 && _num_threads + _num_threads_pending_start < _max_threads) {
         need_a_thread = true;
@@ -408,28 +453,41 @@ Status ThreadPool::do_submit(std::shared_ptr<Runnable> r, ThreadPoolToken* token
     task.runnable = std::move(r);
     task.submit_time = submit_time;
 
-    // Add the task to the token's queue.
-    ThreadPoolToken::State state = token->state();
-    DCHECK(state == ThreadPoolToken::State::IDLE || state == ThreadPoolToken::State::RUNNING);
-    token->_entries.emplace_back(std::move(task));
-    // When we need to execute the task in the token, we submit the token object to the queue.
-    // There are currently two places where tokens will be submitted to the queue:
-    // 1. When submitting a new task, if the token is still in the IDLE state,
-    //    or the concurrency of the token has not reached the online level, it will be added to the queue.
-    // 2. When the dispatch thread finishes executing a task:
-    //    1. If it is a SERIAL token, and there are unsubmitted tasks, submit them to the queue.
-    //    2. If it is a CONCURRENT token, and there are still unsubmitted tasks, and the upper limit of concurrency is not reached,
-    //       then submitted to the queue.
-    if (token->need_dispatch()) {
-        _queue.emplace_back(token);
-        ++token->_num_submitted_tasks;
-        if (state == ThreadPoolToken::State::IDLE) {
-            token->transition(ThreadPoolToken::State::RUNNING);
-        }
+    if (stealable) {
+        // Push to the home queue of the submitting worker thread, so the task is
+        // likely to be run by it, otherwise spread the tasks over the worker queues.
+        size_t idx = tls_current_pool == this ? tls_home_queue
+                                              : _next_submit_queue++ % _worker_queues.size();
+        _num_stealable_queued++;
+        std::lock_guard<SpinLock> ql(_worker_queues[idx]->lock);
+        _worker_queues[idx]->tasks.emplace_back(std::move(task));
     } else {
-        ++token->_num_unsubmitted_tasks;
+        // Add the task to the token's queue.
+        ThreadPoolToken::State state = token->state();
+        DCHECK(state == ThreadPoolToken::State::IDLE ||
+               state == ThreadPoolToken::State::RUNNING);
+        token->_entries.emplace_back(std::move(task));
+        // When we need to execute the task in the token, we submit the token object to the queue.
+        // There are currently two places where tokens will be submitted to the queue:
+        // 1. When submitting a new task, if the token is still in the IDLE state,
+        //    or the concurrency of the token has not reached the online level, it will be added
+        //    to the queue.
+        // 2. When the dispatch thread finishes executing a task:
+        //    1. If it is a SERIAL token, and there are unsubmitted tasks, submit them to the
+        //       queue.
+        //    2. If it is a CONCURRENT token, and there are still unsubmitted tasks, and the
+        //       upper limit of concurrency is not reached, then submitted to the queue.
+        if (token->need_dispatch()) {
+            _queue.emplace_back(token);
+            ++token->_num_submitted_tasks;
+            if (state == ThreadPoolToken::State::IDLE) {
+                token->transition(ThreadPoolToken::State::RUNNING);
+            }
+        } else {
+            ++token->_num_unsubmitted_tasks;
+        }
+        _total_queued_tasks++;
     }
-    _total_queued_tasks++;
 
     // Wake up an idle thread for this task. Choosing the thread at the front of
     // the list ensures LIFO semantics as idling threads are also added to the front.
@@ -464,7 +522,8 @@ Status ThreadPool::do_submit(std::shared_ptr<Runnable> r, ThreadPoolToken* token
 void ThreadPool::wait() {
     std::unique_lock<std::mutex> l(_lock);
     check_not_pool_thread_unlocked();
-    while (_total_queued_tasks > 0 || _active_threads > 0) {
+    while (_total_queued_tasks > 0 || _active_threads > 0 || _num_stealable_queued > 0 ||
+           _num_stealable_running > 0) {
         _idle_cond.wait(l);
     }
 }
@@ -480,6 +539,13 @@ void ThreadPool::dispatch_thread() {
     // Owned by this worker thread and added/removed from _idle_threads as needed.
     IdleThread me;
 
+    size_t home = 0;
+    if (_work_stealing) {
+        home = _next_home_queue++ % _worker_queues.size();
+        tls_current_pool = this;
+        tls_home_queue = home;
+    }
+
     while (true) {
         // Note: Status::Aborted() is used to indicate normal shutdown.
         if (!_pool_status.ok()) {
@@ -491,6 +557,13 @@ void ThreadPool::dispatch_thread() {
             break;
         }
 
+        if (_num_stealable_queued > 0) {
+            l.unlock();
+            run_stealable_tasks(home);
+            l.lock();
+            continue;
+        }
+
         if (_queue.empty()) {
             // There's no work to do, let's go idle.
             //
@@ -511,7 +584,8 @@ void ThreadPool::dispatch_thread() {
                 // brief period during which another thread may actually grab the internal mutex
                 // protecting the state, signal, and release again before we get the mutex. So,
                 // we'll recheck the empty queue case regardless.
-                if (_queue.empty() && _num_threads + _num_threads_pending_start > _min_threads) {
+                if (_queue.empty() && _num_stealable_queued == 0 &&
+                    _num_threads + _num_threads_pending_start > _min_threads) {
                     VLOG_NOTICE << "Releasing worker thread from pool " << _name << " after "
                                 << std::chrono::duration_cast<std::chrono::milliseconds>(
                                            _idle_timeout)
@@ -595,6 +669,61 @@ void ThreadPool::dispatch_thread() {
         // empty. Otherwise it will never get processed.
         CHECK(_queue.empty());
         DCHECK_EQ(0, _total_queued_tasks);
+        DCHECK_EQ(0, _num_stealable_queued);
+    }
+}
+
+bool ThreadPool::pop_stealable_task(size_t home, Task* task) {
+    {
+        WorkerQueue* queue = _worker_queues[home].get();
+        std::lock_guard<SpinLock> ql(queue->lock);
+        if (!queue->tasks.empty()) {
+            *task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            return true;
+        }
+    }
+    // Steal from the other queues, starting from a random one so that the thieves
+    // don't contend on the same victim.
+    static thread_local std::minstd_rand rng(home + 1);
+    size_t num_queues = _worker_queues.size();
+    size_t start = rng() % num_queues;
+    for (size_t i = 0; i < num_queues; ++i) {
+        size_t victim = (start + i) % num_queues;
+        if (victim == home) {
+            continue;
+        }
+        WorkerQueue* queue = _worker_queues[victim].get();
+        std::lock_guard<SpinLock> ql(queue->lock);
+        if (!queue->tasks.empty()) {
+            *task = std::move(queue->tasks.front());
+            queue->tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::run_stealable_tasks(size_t home) {
+    while (true) {
+        // Count the thread as running before popping the task, otherwise wait() may see
+        // neither the queued task nor the running one.
+        _num_stealable_running++;
+        Task task;
+        bool popped = pop_stealable_task(home, &task);
+        if (popped) {
+            _num_stealable_queued--;
+            task.runnable->run();
+            // Destruct the task before the thread is counted as idle, see dispatch_thread().
+            task.runnable.reset();
+        }
+        if (--_num_stealable_running == 0 && _num_stealable_queued == 0) {
+            std::lock_guard<std::mutex> l(_lock);
+            _idle_cond.notify_all();
+        }
+        if (!popped) {
+            break;
+        }
     }
 }
 
@@ -645,7 +774,8 @@ Status ThreadPool::set_max_threads(int max_threads) {
     _max_threads = max_threads;
     if (_max_threads > _num_threads + _num_threads_pending_start) {
         int addition_threads = _max_threads - _num_threads - _num_threads_pending_start;
-        addition_threads = std::min(addition_threads, _total_queued_tasks);
+        addition_threads =
+                std::min(addition_threads, _total_queued_tasks + _num_stealable_queued);
         _num_threads_pending_start += addition_threads;
         for (int i = 0; i < addition_threads; i++) {
             Status status = create_thread();
@@ -23,6 +23,7 @@
 
 #include <boost/intrusive/list.hpp>
 #include <boost/intrusive/list_hook.hpp>
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <functional>
@@ -30,9 +31,11 @@
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "common/status.h"
 #include "gutil/ref_counted.h"
+#include "util/spinlock.h"
 
 namespace doris {
 
@@ -91,6 +94,13 @@ public:
 // metrics: Histograms, counters, etc. to update on various threadpool events.
 //    Default: not set.
 //
+// work_stealing: Whether the tokenless tasks are queued to per-worker queues
+//    instead of the shared queue. A worker runs the tasks of its own queue
+//    first and steals from a random other queue when its own is empty, so the
+//    workers don't take the pool lock for each tokenless task. The tasks
+//    submitted via tokens are not affected.
+//    Default: false.
+//
 class ThreadPoolBuilder {
 public:
     explicit ThreadPoolBuilder(std::string name);
@@ -100,6 +110,7 @@ public:
     ThreadPoolBuilder& set_min_threads(int min_threads);
     ThreadPoolBuilder& set_max_threads(int max_threads);
     ThreadPoolBuilder& set_max_queue_size(int max_queue_size);
+    ThreadPoolBuilder& set_work_stealing(bool work_stealing);
     template <class Rep, class Period>
     ThreadPoolBuilder& set_idle_timeout(const std::chrono::duration<Rep, Period>& idle_timeout) {
         _idle_timeout = std::chrono::duration_cast<std::chrono::milliseconds>(idle_timeout);
@@ -115,6 +126,7 @@ private:
     int _max_threads;
     int _max_queue_size;
     std::chrono::milliseconds _idle_timeout;
+    bool _work_stealing;
 
     ThreadPoolBuilder(const ThreadPoolBuilder&) = delete;
     void operator=(const ThreadPoolBuilder&) = delete;
@@ -225,12 +237,12 @@ public:
 
     int num_active_threads() const {
         std::lock_guard<std::mutex> l(_lock);
-        return _active_threads;
+        return _active_threads + _num_stealable_running;
     }
 
     int get_queue_size() const {
         std::lock_guard<std::mutex> l(_lock);
-        return _total_queued_tasks;
+        return _total_queued_tasks + _num_stealable_queued;
     }
 
 private:
@@ -245,6 +257,12 @@ private:
         std::chrono::time_point<std::chrono::system_clock> submit_time;
     };
 
+    // The tokenless tasks queued to a worker thread in the work stealing mode.
+    struct WorkerQueue {
+        SpinLock lock;
+        std::deque<Task> tasks;
+    };
+
     // Creates a new thread pool using a builder.
     explicit ThreadPool(const ThreadPoolBuilder& builder);
 
@@ -269,11 +287,21 @@ private:
     // Releases token 't' and invalidates it.
     void release_token(ThreadPoolToken* t);
 
+    // Pops a tokenless task from the worker queue 'home', or steals one from
+    // the other worker queues if it's empty. Returns false if all of them are empty.
+    bool pop_stealable_task(size_t home, Task* task);
+
+    // Runs the tokenless tasks of the worker queues until all of them are empty.
+    //
+    // NOTE: _lock should not be held.
+    void run_stealable_tasks(size_t home);
+
     const std::string _name;
     int _min_threads;
     int _max_threads;
     const int _max_queue_size;
     const std::chrono::milliseconds _idle_timeout;
+    const bool _work_stealing;
 
     // Overall status of the pool. Set to an error when the pool is shut down.
     //
@@ -326,6 +354,27 @@ private:
     // Protected by _lock.
     std::deque<ThreadPoolToken*> _queue;
 
+    // Queues of the tokenless tasks in the work stealing mode, one per max thread.
+    // Each worker thread owns one of them, and the tasks submitted by a worker
+    // thread are pushed to its own queue.
+    //
+    // Each queue is protected by its own lock, which is acquired after _lock.
+    std::vector<std::unique_ptr<WorkerQueue>> _worker_queues;
+
+    // Round robin cursors of the worker queues, for the tasks submitted by the
+    // threads out of the pool and for the home queues of the worker threads.
+    //
+    // Protected by _lock.
+    size_t _next_submit_queue;
+    size_t _next_home_queue;
+
+    // Number of the tokenless tasks queued in the worker queues, and number of
+    // the worker threads running (or looking for) such tasks. They are updated
+    // by the worker threads without _lock, but increased only under _lock by
+    // do_submit(), so that a worker thread doesn't miss a task when going idle.
+    std::atomic<int> _num_stealable_queued;
+    std::atomic<int> _num_stealable_running;
+
     // Pointers to all running threads. Raw pointers are safe because a Thread
     // may only go out of scope after being removed from _threads.
     //
@@ -18,6 +18,8 @@
 
 #include "util/timezone_utils.h"
 
+#include <limits>
+
 namespace doris {
 
 RE2 TimezoneUtils::time_zone_offset_format_reg("^[+-]{1}\\d{2}\\:\\d{2}$");
@@ -53,4 +55,27 @@ bool TimezoneUtils::find_cctz_time_zone(const std::string& timezone, cctz::time_
     }
 }
 
+void TimezoneOffsetCache::_lookup(int64_t timestamp) {
+    static const cctz::civil_second epoch(1970, 1, 1, 0, 0, 0);
+    const auto tp = cctz::time_point<cctz::seconds>() + cctz::seconds(timestamp);
+    _offset = _ctz.lookup(tp).offset;
+    _begin = std::numeric_limits<int64_t>::min();
+    _end = std::numeric_limits<int64_t>::max();
+
+    // `from` of a transition is the civil time in the offset before it, and `to` is the civil
+    // time in the offset after it.
+    cctz::time_zone::civil_transition trans;
+    if (_ctz.prev_transition(tp + cctz::seconds(1), &trans)) {
+        _begin = (trans.to - epoch) - _offset;
+    }
+    if (_ctz.next_transition(tp, &trans)) {
+        _end = (trans.from - epoch) - _offset;
+    }
+    // the transitions of a very distant timestamp are unspecified, only cache the timestamp itself
+    if (timestamp < _begin || timestamp >= _end) {
+        _begin = timestamp;
+        _end = timestamp + 1;
+    }
+}
+
 } // namespace doris
@@ -20,6 +20,8 @@
 
 #include <re2/re2.h>
 
+#include <cstdint>
+
 #include "cctz/time_zone.h"
 
 namespace doris {
@@ -35,4 +37,28 @@ private:
     // RE2 obj is thread safe
     static RE2 time_zone_offset_format_reg;
 };
+
+// The utc offsets of a time zone at the timestamps (seconds since the epoch) of a block. The
+// offset doesn't change between two transitions of the time zone, so the time zone is only
+// looked up again for a timestamp out of the transitions around the last looked up one.
+class TimezoneOffsetCache {
+public:
+    explicit TimezoneOffsetCache(const cctz::time_zone& ctz) : _ctz(ctz) {}
+
+    int64_t offset(int64_t timestamp) {
+        if (timestamp < _begin || timestamp >= _end) {
+            _lookup(timestamp);
+        }
+        return _offset;
+    }
+
+private:
+    void _lookup(int64_t timestamp);
+
+    cctz::time_zone _ctz;
+    int64_t _offset = 0;
+    // the offset of the timestamps in [_begin, _end) is _offset
+    int64_t _begin = 0;
+    int64_t _end = 0;
+};
 } // namespace doris
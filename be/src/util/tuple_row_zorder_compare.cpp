@@ -229,4 +229,12 @@ int TupleRowZOrderComparator::get_type_byte_size(FieldType type) const {
     return -1;
 }
 
+// used by the vectorized z-order comparator of blocks
+template uint32_t TupleRowZOrderComparator::get_shared_representation<uint32_t>(
+        const void* val, FieldType type) const;
+template uint64_t TupleRowZOrderComparator::get_shared_representation<uint64_t>(
+        const void* val, FieldType type) const;
+template __uint128_t TupleRowZOrderComparator::get_shared_representation<__uint128_t>(
+        const void* val, FieldType type) const;
+
 } // namespace doris
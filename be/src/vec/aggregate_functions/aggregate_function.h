@@ -101,6 +101,10 @@ public:
     /// Returns true if a function requires Arena to handle own states (see add(), merge(), deserialize()).
     virtual bool allocates_memory_in_arena() const { return false; }
 
+    /// Returns true if the state of a window frame could be computed by merging the states of
+    /// its sub-ranges in order, false for the window functions which depend on the frame position.
+    virtual bool support_merge_in_window() const { return true; }
+
     /// Inserts results into a column.
     virtual void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const = 0;
 
@@ -115,11 +119,24 @@ public:
     virtual void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
                            const IColumn** columns, Arena* arena) const = 0;
 
+    /** The same as add_batch, but the rows whose places are nullptr are skipped.
+      */
+    virtual void add_batch_selected(size_t batch_size, AggregateDataPtr* places,
+                                    size_t place_offset, const IColumn** columns,
+                                    Arena* arena) const = 0;
+
     /** The same for single place.
       */
     virtual void add_batch_single_place(size_t batch_size, AggregateDataPtr place,
                                         const IColumn** columns, Arena* arena) const = 0;
 
+    /** The same for single place, but the rows whose null_map is not 0 are skipped. It's used by
+      *  the nullable combinator for the nested function, without the places of the rows.
+      */
+    virtual void add_batch_single_place_not_null(size_t batch_size, AggregateDataPtr place,
+                                                 const IColumn** columns, const UInt8* null_map,
+                                                 Arena* arena) const = 0;
+
     // only used at agg reader
     virtual void add_batch_range(size_t batch_begin, size_t batch_end, AggregateDataPtr place,
                                  const IColumn** columns, Arena* arena, bool has_null = false) = 0;
@@ -152,12 +169,32 @@ public:
         }
     }
 
+    void add_batch_selected(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                            const IColumn** columns, Arena* arena) const override {
+        for (size_t i = 0; i < batch_size; ++i) {
+            if (places[i] != nullptr) {
+                static_cast<const Derived*>(this)->add(places[i] + place_offset, columns, i, arena);
+            }
+        }
+    }
+
     void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
                                 Arena* arena) const override {
         for (size_t i = 0; i < batch_size; ++i) {
             static_cast<const Derived*>(this)->add(place, columns, i, arena);
         }
     }
+
+    void add_batch_single_place_not_null(size_t batch_size, AggregateDataPtr place,
+                                         const IColumn** columns, const UInt8* null_map,
+                                         Arena* arena) const override {
+        for (size_t i = 0; i < batch_size; ++i) {
+            if (!null_map[i]) {
+                static_cast<const Derived*>(this)->add(place, columns, i, arena);
+            }
+        }
+    }
+
     //now this is use for sum/count/avg/min/max win function, other win function should override this function in class
     //stddev_pop/stddev_samp/variance_pop/variance_samp
     void add_range_single_place(int64_t partition_start, int64_t partition_end, int64_t frame_start,
@@ -17,11 +17,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "exprs/anyval_util.h"
 #include "olap/hll.h"
 #include "udf/udf.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_complex.h"
+#include "vec/columns/column_string.h"
 #include "vec/common/string_ref.h"
 #include "vec/io/io_helper.h"
 
@@ -33,6 +37,10 @@ struct AggregateFunctionApproxCountDistinctData {
     void add(StringRef value) {
         StringVal sv = value.to_string_val();
         uint64_t hash_value = AnyValUtil::hash64_murmur(sv, HashUtil::MURMUR_SEED);
+        add_hash(hash_value);
+    }
+
+    void add_hash(uint64_t hash_value) {
         if (hash_value != 0) {
             hll_data.update(hash_value);
         }
@@ -82,6 +90,36 @@ public:
         this->data(place).add(static_cast<const ColumnDataType*>(columns[0])->get_data_at(row_num));
     }
 
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena*) const override {
+        std::vector<uint64_t> hashes(batch_size);
+        hash_batch(*static_cast<const ColumnDataType*>(columns[0]), batch_size, hashes.data());
+        for (size_t i = 0; i < batch_size; ++i) {
+            this->data(places[i] + place_offset).add_hash(hashes[i]);
+        }
+    }
+
+    void add_batch_selected(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                            const IColumn** columns, Arena*) const override {
+        std::vector<uint64_t> hashes(batch_size);
+        hash_batch(*static_cast<const ColumnDataType*>(columns[0]), batch_size, hashes.data());
+        for (size_t i = 0; i < batch_size; ++i) {
+            if (places[i] != nullptr) {
+                this->data(places[i] + place_offset).add_hash(hashes[i]);
+            }
+        }
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        std::vector<uint64_t> hashes(batch_size);
+        hash_batch(*static_cast<const ColumnDataType*>(columns[0]), batch_size, hashes.data());
+        auto& data = this->data(place);
+        for (size_t i = 0; i < batch_size; ++i) {
+            data.add_hash(hashes[i]);
+        }
+    }
+
     void reset(AggregateDataPtr place) const override { this->data(place).reset(); }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
@@ -102,6 +140,36 @@ public:
         auto& column = static_cast<ColumnInt64&>(to);
         column.get_data().push_back(this->data(place).get());
     }
+
+private:
+    // Hash the first `batch_size` rows of a column in one pass, the hash of each row is the same
+    // as hashing `get_data_at` of the row.
+    static void hash_batch(const ColumnDataType& column, size_t batch_size, uint64_t* hashes) {
+        if constexpr (std::is_same_v<ColumnDataType, ColumnString>) {
+            const auto& offsets = column.get_offsets();
+            const auto* chars = column.get_chars().data();
+            for (size_t i = 0; i < batch_size; ++i) {
+                // without the terminating zero
+                hashes[i] = HashUtil::murmur_hash64A(chars + offsets[i - 1],
+                                                     offsets[i] - offsets[i - 1] - 1,
+                                                     HashUtil::MURMUR_SEED);
+            }
+        } else if constexpr (std::is_same_v<ColumnDataType, ColumnBitmap> ||
+                             std::is_same_v<ColumnDataType, ColumnHLL>) {
+            for (size_t i = 0; i < batch_size; ++i) {
+                StringRef value = column.get_data_at(i);
+                hashes[i] = HashUtil::murmur_hash64A(value.data, value.size,
+                                                     HashUtil::MURMUR_SEED);
+            }
+        } else {
+            // the numbers and the decimals
+            const auto* data = column.get_data().data();
+            for (size_t i = 0; i < batch_size; ++i) {
+                hashes[i] = HashUtil::murmur_hash64A(&data[i], sizeof(data[i]),
+                                                     HashUtil::MURMUR_SEED);
+            }
+        }
+    }
 };
 
 } // namespace doris::vectorized
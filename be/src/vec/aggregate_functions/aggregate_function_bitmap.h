@@ -38,6 +38,38 @@ struct AggregateFunctionBitmapUnionOp {
 
     static void add(BitmapValue& res, const BitmapValue& data, bool& is_first) { res |= data; }
 
+    // the integers are added in bulk by chunks
+    template <typename T>
+    static void add_batch(BitmapValue& res, const T* data, const UInt8* null_map, size_t n,
+                          bool& is_first) {
+        constexpr size_t BATCH_SIZE = 1024;
+        uint64_t values[BATCH_SIZE];
+        size_t num_values = 0;
+        for (size_t i = 0; i < n; ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                values[num_values++] = data[i];
+            }
+            if (num_values == BATCH_SIZE) {
+                res.add_many(values, num_values);
+                num_values = 0;
+            }
+        }
+        res.add_many(values, num_values);
+    }
+
+    // the bitmaps are unioned by one fastunion
+    static void add_batch(BitmapValue& res, const BitmapValue* data, const UInt8* null_map,
+                          size_t n, bool& is_first) {
+        std::vector<const BitmapValue*> values;
+        values.reserve(n);
+        for (size_t i = 0; i < n; ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                values.push_back(&data[i]);
+            }
+        }
+        res.fastunion(values);
+    }
+
     static void merge(BitmapValue& res, const BitmapValue& data) { res |= data; }
 };
 
@@ -53,6 +85,15 @@ struct AggregateFunctionBitmapIntersectOp {
         }
     }
 
+    static void add_batch(BitmapValue& res, const BitmapValue* data, const UInt8* null_map,
+                          size_t n, bool& is_first) {
+        for (size_t i = 0; i < n; ++i) {
+            if (null_map == nullptr || !null_map[i]) {
+                add(res, data[i], is_first);
+            }
+        }
+    }
+
     static void merge(BitmapValue& res, const BitmapValue& data) { res &= data; }
 };
 
@@ -66,6 +107,18 @@ struct AggregateFunctionBitmapData {
         Op::add(value, data, is_first);
     }
 
+    // add the rows whose null_map is 0, or all the rows if null_map is nullptr
+    template <typename T>
+    void add_batch(const T* data, const UInt8* null_map, size_t n) {
+        if (n == 1) {
+            if (null_map == nullptr || !null_map[0]) {
+                Op::add(value, data[0], is_first);
+            }
+            return;
+        }
+        Op::add_batch(value, data, null_map, n, is_first);
+    }
+
     void merge(const BitmapValue& data) { Op::merge(value, data); }
 
     void write(BufferWritable& buf) const { DataTypeBitMap::serialize_as_stream(value, buf); }
@@ -75,6 +128,20 @@ struct AggregateFunctionBitmapData {
     BitmapValue& get() { return value; }
 };
 
+/// Call `add(place, begin, end)` for each run of the rows of the same place in a batch, so that
+/// the rows of a run are added in bulk.
+template <typename F>
+void for_each_place_run(size_t batch_size, AggregateDataPtr* places, F&& add) {
+    for (size_t begin = 0; begin < batch_size;) {
+        size_t end = begin + 1;
+        while (end < batch_size && places[end] == places[begin]) {
+            ++end;
+        }
+        add(places[begin], begin, end);
+        begin = end;
+    }
+}
+
 template <typename Op>
 class AggregateFunctionBitmapOp final
         : public IAggregateFunctionDataHelper<AggregateFunctionBitmapData<Op>,
@@ -98,6 +165,21 @@ public:
         this->data(place).add(column.get_data()[row_num]);
     }
 
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena*) const override {
+        const auto* data = static_cast<const ColVecType&>(*columns[0]).get_data().data();
+        for_each_place_run(batch_size, places, [&](AggregateDataPtr place, size_t begin,
+                                                   size_t end) {
+            this->data(place + place_offset).add_batch(data + begin, nullptr, end - begin);
+        });
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        const auto& column = static_cast<const ColVecType&>(*columns[0]);
+        this->data(place).add_batch(column.get_data().data(), nullptr, batch_size);
+    }
+
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
                Arena*) const override {
         this->data(place).merge(
@@ -153,6 +235,24 @@ public:
         }
     }
 
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena*) const override {
+        const UInt8* null_map = nullptr;
+        const auto* data = get_batch_data(columns, &null_map);
+        for_each_place_run(batch_size, places, [&](AggregateDataPtr place, size_t begin,
+                                                   size_t end) {
+            this->data(place + place_offset)
+                    .add_batch(data + begin, null_map ? null_map + begin : nullptr, end - begin);
+        });
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        const UInt8* null_map = nullptr;
+        const auto* data = get_batch_data(columns, &null_map);
+        this->data(place).add_batch(data, null_map, batch_size);
+    }
+
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
                Arena*) const override {
         this->data(place).merge(const_cast<AggFunctionData&>(this->data(rhs)).get());
@@ -172,6 +272,19 @@ public:
         auto& column = static_cast<ColVecResult&>(to);
         column.get_data().push_back(value_data.cardinality());
     }
+
+private:
+    static const auto* get_batch_data(const IColumn** columns, const UInt8** null_map) {
+        if constexpr (nullable) {
+            auto& nullable_column = assert_cast<const ColumnNullable&>(*columns[0]);
+            *null_map = nullable_column.get_null_map_data().data();
+            return static_cast<const ColVecType&>(nullable_column.get_nested_column())
+                    .get_data()
+                    .data();
+        } else {
+            return static_cast<const ColVecType&>(*columns[0]).get_data().data();
+        }
+    }
 };
 
 AggregateFunctionPtr create_aggregate_function_bitmap_union(const std::string& name,
@@ -0,0 +1,41 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/aggregate_functions/aggregate_function_collect.h"
+
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+
+namespace doris::vectorized {
+
+AggregateFunctionPtr create_aggregate_function_collect_list(const std::string& name,
+                                                            const DataTypes& argument_types,
+                                                            const Array& parameters,
+                                                            const bool result_is_nullable) {
+    if (argument_types.size() != 1) {
+        LOG(WARNING) << fmt::format("Illegal number {} of argument for aggregate function {}",
+                                    argument_types.size(), name);
+        return nullptr;
+    }
+    return std::make_shared<AggregateFunctionCollectList>(argument_types);
+}
+
+void register_aggregate_function_collect_list(AggregateFunctionSimpleFactory& factory) {
+    factory.register_function("collect_list", create_aggregate_function_collect_list);
+    factory.register_alias("collect_list", "array_agg");
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/columns/column_array.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/data_types/data_type_array.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/io/io_helper.h"
+
+namespace doris::vectorized {
+
+// The values are kept in a column of the argument type, so the values of a batch are appended
+// by one insert_range_from, and the result is appended to the nested column of the arrays as a
+// range too.
+struct AggregateFunctionCollectListData {
+    MutableColumnPtr data;
+
+    explicit AggregateFunctionCollectListData(const DataTypePtr& type)
+            : data(type->create_column()) {}
+
+    void merge(const AggregateFunctionCollectListData& rhs) {
+        data->insert_range_from(*rhs.data, 0, rhs.data->size());
+    }
+
+    void write(const IDataType& type, BufferWritable& buf) const {
+        std::string bytes(type.get_uncompressed_serialized_bytes(*data), '\0');
+        type.serialize(*data, bytes.data());
+        write_binary(bytes, buf);
+    }
+
+    void read(const IDataType& type, BufferReadable& buf) {
+        std::string bytes;
+        read_binary(bytes, buf);
+        data->clear();
+        type.deserialize(bytes.data(), data.get());
+    }
+
+    void insert_result_into(IColumn& to) const {
+        auto& to_array = assert_cast<ColumnArray&>(to);
+        auto& to_nested = to_array.get_data();
+        if (to_nested.is_nullable()) {
+            auto& to_nullable = assert_cast<ColumnNullable&>(to_nested);
+            to_nullable.get_nested_column().insert_range_from(*data, 0, data->size());
+            auto& null_map = to_nullable.get_null_map_data();
+            null_map.resize_fill(null_map.size() + data->size(), 0);
+        } else {
+            to_nested.insert_range_from(*data, 0, data->size());
+        }
+        to_array.get_offsets().push_back(to_nested.size());
+    }
+};
+
+// collect_list(expr), alias array_agg: the array of the not null values of a group.
+class AggregateFunctionCollectList final
+        : public IAggregateFunctionDataHelper<AggregateFunctionCollectListData,
+                                              AggregateFunctionCollectList> {
+public:
+    AggregateFunctionCollectList(const DataTypes& argument_types_)
+            : IAggregateFunctionDataHelper<AggregateFunctionCollectListData,
+                                           AggregateFunctionCollectList>(argument_types_, {}),
+              _argument_type(argument_types_[0]) {}
+
+    String get_name() const override { return "collect_list"; }
+
+    DataTypePtr get_return_type() const override {
+        return std::make_shared<DataTypeArray>(make_nullable(_argument_type));
+    }
+
+    void create(AggregateDataPtr __restrict place) const override {
+        new (place) AggregateFunctionCollectListData(_argument_type);
+    }
+
+    void add(AggregateDataPtr __restrict place, const IColumn** columns, size_t row_num,
+             Arena*) const override {
+        this->data(place).data->insert_from(*columns[0], row_num);
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place,
+                                const IColumn** columns, Arena*) const override {
+        this->data(place).data->insert_range_from(*columns[0], 0, batch_size);
+    }
+
+    void reset(AggregateDataPtr place) const override { this->data(place).data->clear(); }
+
+    void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
+               Arena*) const override {
+        this->data(place).merge(this->data(rhs));
+    }
+
+    void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
+        this->data(place).write(*_argument_type, buf);
+    }
+
+    void deserialize(AggregateDataPtr __restrict place, BufferReadable& buf,
+                     Arena*) const override {
+        this->data(place).read(*_argument_type, buf);
+    }
+
+    void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
+        this->data(place).insert_result_into(to);
+    }
+
+private:
+    DataTypePtr _argument_type;
+};
+
+} // namespace doris::vectorized
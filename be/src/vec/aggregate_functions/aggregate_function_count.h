@@ -35,6 +35,15 @@ struct AggregateFunctionCountData {
     UInt64 count = 0;
 };
 
+// the number of the zeros of the null map, the loop is vectorized
+inline size_t count_not_null(const UInt8* __restrict null_map, size_t size) {
+    size_t count = 0;
+    for (size_t i = 0; i < size; ++i) {
+        count += null_map[i] == 0;
+    }
+    return count;
+}
+
 /// Simply count number of calls.
 class AggregateFunctionCount final
         : public IAggregateFunctionDataHelper<AggregateFunctionCountData, AggregateFunctionCount> {
@@ -50,6 +59,17 @@ public:
         ++data(place).count;
     }
 
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn**,
+                                Arena*) const override {
+        data(place).count += batch_size;
+    }
+
+    void add_batch_single_place_not_null(size_t batch_size, AggregateDataPtr place,
+                                         const IColumn**, const UInt8* null_map,
+                                         Arena*) const override {
+        data(place).count += count_not_null(null_map, batch_size);
+    }
+
     void reset(AggregateDataPtr place) const override {
         AggregateFunctionCount::data(place).count = 0;
     }
@@ -90,6 +110,12 @@ public:
         data(place).count += !assert_cast<const ColumnNullable&>(*columns[0]).is_null_at(row_num);
     }
 
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        const auto& column = assert_cast<const ColumnNullable&>(*columns[0]);
+        data(place).count += count_not_null(column.get_null_map_data().data(), batch_size);
+    }
+
     void reset(AggregateDataPtr place) const override { data(place).count = 0; }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
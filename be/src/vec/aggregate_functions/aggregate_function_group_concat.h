@@ -20,30 +20,31 @@
 #include "common/status.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/common/chunked_arena_buffer.h"
 #include "vec/common/string_ref.h"
 #include "vec/data_types/data_type_string.h"
 #include "vec/io/io_helper.h"
 
 namespace doris::vectorized {
 
+// The concatenated values are kept in the chunks of the arena, see ChunkedArenaBuffer.
 struct AggregateFunctionGroupConcatData {
-    std::string data;
+    ChunkedArenaBuffer data;
     std::string separator;
     bool inited = false;
 
-    void add(StringRef ref, StringRef sep) {
+    void add(StringRef ref, StringRef sep, Arena* arena) {
         if (!inited) {
             inited = true;
             separator.assign(sep.data, sep.data + sep.size);
         } else {
-            data += separator;
+            data.append(separator.data(), separator.size(), arena);
         }
 
-        data.resize(data.length() + ref.size);
-        memcpy(data.data() + data.length() - ref.size, ref.data, ref.size);
+        data.append(ref.data, ref.size, arena);
     }
 
-    void merge(const AggregateFunctionGroupConcatData& rhs) {
+    void merge(const AggregateFunctionGroupConcatData& rhs, Arena* arena) {
         if (!rhs.inited) {
             return;
         }
@@ -51,29 +52,48 @@ struct AggregateFunctionGroupConcatData {
         if (!inited) {
             inited = true;
             separator = rhs.separator;
-            data = rhs.data;
         } else {
-            data += separator;
-            data += rhs.data;
+            data.append(separator.data(), separator.size(), arena);
         }
+        rhs.data.for_each_chunk(
+                [&](const char* chunk, size_t size) { data.append(chunk, size, arena); });
     }
 
-    std::string get() const { return data; }
+    void insert_result_into(ColumnString& to) const {
+        auto& chars = to.get_chars();
+        size_t old_size = chars.size();
+        chars.resize(old_size + data.size() + 1);
+        data.copy_to(reinterpret_cast<char*>(chars.data() + old_size));
+        chars.back() = 0;
+        to.get_offsets().push_back(chars.size());
+    }
 
+    // the same format as the string written by write_binary
     void write(BufferWritable& buf) const {
-        write_binary(data, buf);
+        write_var_uint(data.size(), buf);
+        data.for_each_chunk([&buf](const char* chunk, size_t size) { buf.write(chunk, size); });
         write_binary(separator, buf);
         write_binary(inited, buf);
     }
 
+    // The deserialized states are merged and destroyed at once, so their data isn't allocated in
+    // the arena.
     void read(BufferReadable& buf) {
-        read_binary(data, buf);
+        data.clear();
+        size_t size = 0;
+        read_var_uint(size, buf);
+        if (size > DEFAULT_MAX_STRING_SIZE) {
+            throw Exception("Too large string size.", TStatusCode::VEC_EXCEPTION);
+        }
+        if (size > 0) {
+            buf.read(data.alloc(size, nullptr), size);
+        }
         read_binary(separator, buf);
         read_binary(inited, buf);
     }
 
     void reset() {
-        data = "";
+        data.clear();
         separator = "";
         inited = false;
     }
@@ -82,17 +102,17 @@ struct AggregateFunctionGroupConcatData {
 struct AggregateFunctionGroupConcatImplStr {
     static const std::string separator;
     static void add(AggregateFunctionGroupConcatData& __restrict place, const IColumn** columns,
-                    size_t row_num) {
+                    size_t row_num, Arena* arena) {
         place.add(static_cast<const ColumnString&>(*columns[0]).get_data_at(row_num),
-                  StringRef(separator.data(), separator.length()));
+                  StringRef(separator.data(), separator.length()), arena);
     }
 };
 
 struct AggregateFunctionGroupConcatImplStrStr {
     static void add(AggregateFunctionGroupConcatData& __restrict place, const IColumn** columns,
-                    size_t row_num) {
+                    size_t row_num, Arena* arena) {
         place.add(static_cast<const ColumnString&>(*columns[0]).get_data_at(row_num),
-                  static_cast<const ColumnString&>(*columns[1]).get_data_at(row_num));
+                  static_cast<const ColumnString&>(*columns[1]).get_data_at(row_num), arena);
     }
 };
 
@@ -111,15 +131,15 @@ public:
     DataTypePtr get_return_type() const override { return std::make_shared<DataTypeString>(); }
 
     void add(AggregateDataPtr __restrict place, const IColumn** columns, size_t row_num,
-             Arena*) const override {
-        Impl::add(this->data(place), columns, row_num);
+             Arena* arena) const override {
+        Impl::add(this->data(place), columns, row_num, arena);
     }
 
     void reset(AggregateDataPtr place) const override { this->data(place).reset(); }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
-               Arena*) const override {
-        this->data(place).merge(this->data(rhs));
+               Arena* arena) const override {
+        this->data(place).merge(this->data(rhs), arena);
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
@@ -132,9 +152,10 @@ public:
     }
 
     void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
-        std::string result = this->data(place).get();
-        static_cast<ColumnString&>(to).insert_data(result.c_str(), result.length());
+        this->data(place).insert_result_into(static_cast<ColumnString&>(to));
     }
+
+    bool allocates_memory_in_arena() const override { return true; }
 };
 
 } // namespace doris::vectorized
@@ -44,7 +44,7 @@ static IAggregateFunction* create_aggregate_function_single_value(const String&
     FOR_NUMERIC_TYPES(DISPATCH)
 #undef DISPATCH
     if (which.idx == TypeIndex::String) {
-        return new AggregateFunctionTemplate<Data<SingleValueDataString>, false>(argument_type);
+        return new AggregateFunctionTemplate<Data<SingleValueDataString>, true>(argument_type);
     }
     if (which.idx == TypeIndex::DateTime || which.idx == TypeIndex::Date) {
         return new AggregateFunctionTemplate<Data<SingleValueDataFixed<Int64>>, false>(
@@ -24,6 +24,7 @@
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column_decimal.h"
 #include "vec/columns/column_vector.h"
+#include "vec/common/arena.h"
 #include "vec/common/assert_cast.h"
 #include "vec/io/io_helper.h"
 
@@ -122,6 +123,49 @@ public:
     bool is_equal_to(const IColumn& column, size_t row_num) const {
         return has() && assert_cast<const ColumnVector<T>&>(column).get_data()[row_num] == value;
     }
+
+    /// Change to the min of the rows whose null_map is 0, or all the rows if null_map is nullptr.
+    void change_if_less_batch(const IColumn& column, size_t num_rows, const UInt8* null_map) {
+        change_batch<true>(assert_cast<const ColumnVector<T>&>(column).get_data().data(),
+                           num_rows, null_map);
+    }
+
+    void change_if_greater_batch(const IColumn& column, size_t num_rows, const UInt8* null_map) {
+        change_batch<false>(assert_cast<const ColumnVector<T>&>(column).get_data().data(),
+                            num_rows, null_map);
+    }
+
+    static constexpr bool SUPPORT_BATCH = true;
+
+private:
+    /// The same as change_if_less or change_if_greater row by row, but the loop is branchless to
+    /// be vectorized.
+    template <bool is_less>
+    void change_batch(const T* __restrict data, size_t num_rows, const UInt8* __restrict null_map) {
+        size_t i = 0;
+        if (!has()) {
+            while (i < num_rows && null_map != nullptr && null_map[i]) {
+                ++i;
+            }
+            if (i == num_rows) {
+                return;
+            }
+            has_value = true;
+            value = data[i++];
+        }
+        T best = value;
+        if (null_map == nullptr) {
+            for (; i < num_rows; ++i) {
+                best = (is_less ? data[i] < best : data[i] > best) ? data[i] : best;
+            }
+        } else {
+            for (; i < num_rows; ++i) {
+                best = (!null_map[i] && (is_less ? data[i] < best : data[i] > best)) ? data[i]
+                                                                                     : best;
+            }
+        }
+        value = best;
+    }
 };
 
 /// For numeric values.
@@ -221,6 +265,8 @@ public:
         return has() &&
                assert_cast<const ColumnDecimal<Decimal128>&>(column).get_data()[row_num] == value;
     }
+
+    static constexpr bool SUPPORT_BATCH = false;
 };
 
 /** For strings. Short strings are stored in the object itself, and long strings are allocated separately.
@@ -233,17 +279,36 @@ private:
     Int32 size = -1;    /// -1 indicates that there is no value.
     Int32 capacity = 0; /// power of two or zero
     char* large_data = nullptr;
+    /// large_data is allocated in the arena of the aggregation, and freed with the arena.
+    bool large_data_in_arena = false;
 
 public:
     static constexpr Int32 AUTOMATIC_STORAGE_SIZE = 64;
-    static constexpr Int32 MAX_SMALL_STRING_SIZE =
-            AUTOMATIC_STORAGE_SIZE - sizeof(size) - sizeof(capacity) - sizeof(large_data);
+    static constexpr Int32 MAX_SMALL_STRING_SIZE = AUTOMATIC_STORAGE_SIZE - sizeof(size) -
+                                                   sizeof(capacity) - sizeof(large_data) -
+                                                   sizeof(large_data_in_arena);
 
 private:
     char small_data[MAX_SMALL_STRING_SIZE]; /// Including the terminating zero.
 
+    /// The callers without arena (e.g. the window functions) allocate large_data from the heap.
+    void alloc_large_data(Int32 new_capacity, Arena* arena) {
+        free_large_data();
+        capacity = new_capacity;
+        large_data_in_arena = arena != nullptr;
+        large_data = large_data_in_arena ? arena->alloc(capacity) : new char[capacity];
+    }
+
+    void free_large_data() {
+        if (!large_data_in_arena) {
+            delete[] large_data;
+        }
+        large_data = nullptr;
+        large_data_in_arena = false;
+    }
+
 public:
-    ~SingleValueDataString() { delete[] large_data; }
+    ~SingleValueDataString() { free_large_data(); }
 
     bool has() const { return size >= 0; }
 
@@ -261,8 +326,7 @@ public:
         if (size != -1) {
             size = -1;
             capacity = 0;
-            delete[] large_data;
-            large_data = nullptr;
+            free_large_data();
         }
     }
 
@@ -288,9 +352,11 @@ public:
                 }
             } else {
                 if (capacity < rhs_size) {
-                    capacity = static_cast<UInt32>(round_up_to_power_of_two_or_zero(rhs_size));
-                    delete[] large_data;
-                    large_data = new char[capacity];
+                    // the deserialized states are merged and destroyed at once, so they are
+                    // allocated from the heap instead of the arena
+                    alloc_large_data(
+                            static_cast<UInt32>(round_up_to_power_of_two_or_zero(rhs_size)),
+                            nullptr);
                 }
 
                 size = rhs_size;
@@ -317,10 +383,7 @@ public:
             }
         } else {
             if (capacity < value_size) {
-                /// Don't free large_data here.
-                capacity = round_up_to_power_of_two_or_zero(value_size);
-                delete[] large_data;
-                large_data = new char[capacity];
+                alloc_large_data(round_up_to_power_of_two_or_zero(value_size), arena);
             }
 
             size = value_size;
@@ -377,6 +440,8 @@ public:
     }
 
     bool is_equal_to(const IColumn& column, size_t row_num) const { return false; }
+
+    static constexpr bool SUPPORT_BATCH = false;
 };
 
 template <typename Data>
@@ -389,6 +454,9 @@ struct AggregateFunctionMaxData : Data {
     bool change_if_better(const Self& to, Arena* arena) {
         return this->change_if_greater(to, arena);
     }
+    void change_if_better_batch(const IColumn& column, size_t num_rows, const UInt8* null_map) {
+        this->change_if_greater_batch(column, num_rows, null_map);
+    }
 
     static const char* name() { return "max"; }
 };
@@ -401,6 +469,9 @@ struct AggregateFunctionMinData : Data {
         return this->change_if_less(column, row_num, arena);
     }
     bool change_if_better(const Self& to, Arena* arena) { return this->change_if_less(to, arena); }
+    void change_if_better_batch(const IColumn& column, size_t num_rows, const UInt8* null_map) {
+        this->change_if_less_batch(column, num_rows, null_map);
+    }
 
     static const char* name() { return "min"; }
 };
@@ -438,6 +509,27 @@ public:
         this->data(place).change_if_better(*columns[0], row_num, arena);
     }
 
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena* arena) const override {
+        if constexpr (Data::SUPPORT_BATCH) {
+            this->data(place).change_if_better_batch(*columns[0], batch_size, nullptr);
+        } else {
+            IAggregateFunctionDataHelper<Data, AggregateFunctionsSingleValue>::
+                    add_batch_single_place(batch_size, place, columns, arena);
+        }
+    }
+
+    void add_batch_single_place_not_null(size_t batch_size, AggregateDataPtr place,
+                                         const IColumn** columns, const UInt8* null_map,
+                                         Arena* arena) const override {
+        if constexpr (Data::SUPPORT_BATCH) {
+            this->data(place).change_if_better_batch(*columns[0], batch_size, null_map);
+        } else {
+            IAggregateFunctionDataHelper<Data, AggregateFunctionsSingleValue>::
+                    add_batch_single_place_not_null(batch_size, place, columns, null_map, arena);
+        }
+    }
+
     void reset(AggregateDataPtr place) const override { this->data(place).reset(); }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
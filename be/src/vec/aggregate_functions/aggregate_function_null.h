@@ -21,6 +21,7 @@
 #pragma once
 
 #include <array>
+#include <vector>
 
 #include "common/logging.h"
 #include "common/status.h"
@@ -120,6 +121,10 @@ public:
 
     size_t align_of_data() const override { return nested_function->align_of_data(); }
 
+    bool support_merge_in_window() const override {
+        return nested_function->support_merge_in_window();
+    }
+
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
                Arena* arena) const override {
         if (result_is_nullable && get_flag(rhs)) {
@@ -197,18 +202,54 @@ public:
         }
     }
 
+    // The rows of null are skipped by add_batch_selected of the nested function with the
+    // nullptr places, instead of calling add of the nested function for each row.
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena* arena) const override {
+        const ColumnNullable* column = assert_cast<const ColumnNullable*>(columns[0]);
+        const IColumn* nested_column = &column->get_nested_column();
+
+        if (column->has_null()) {
+            const auto& null_map = column->get_null_map_data();
+            std::vector<AggregateDataPtr> selected_places(batch_size);
+            for (size_t i = 0; i < batch_size; ++i) {
+                selected_places[i] = null_map[i] ? nullptr : places[i];
+            }
+            for (size_t i = 0; i < batch_size; ++i) {
+                if (selected_places[i] != nullptr) {
+                    this->set_flag(selected_places[i] + place_offset);
+                }
+            }
+            this->nested_function->add_batch_selected(batch_size, selected_places.data(),
+                                                      place_offset + this->prefix_size,
+                                                      &nested_column, arena);
+        } else {
+            for (size_t i = 0; i < batch_size; ++i) {
+                this->set_flag(places[i] + place_offset);
+            }
+            this->nested_function->add_batch(batch_size, places, place_offset + this->prefix_size,
+                                             &nested_column, arena);
+        }
+    }
+
     void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
                                 Arena* arena) const override {
         const ColumnNullable* column = assert_cast<const ColumnNullable*>(columns[0]);
         bool has_null = column->has_null();
 
         if (has_null) {
+            const UInt8* null_map = column->get_null_map_data().data();
+            size_t num_nulls = 0;
             for (size_t i = 0; i < batch_size; ++i) {
-                if (!column->is_null_at(i)) {
-                    this->set_flag(place);
-                    this->add(place, columns, i, arena);
-                }
+                num_nulls += null_map[i] != 0;
+            }
+            if (num_nulls == batch_size) {
+                return;
             }
+            this->set_flag(place);
+            const IColumn* nested_column = &column->get_nested_column();
+            this->nested_function->add_batch_single_place_not_null(
+                    batch_size, this->nested_place(place), &nested_column, null_map, arena);
         } else {
             this->set_flag(place);
             const IColumn* nested_column = &column->get_nested_column();
@@ -17,8 +17,11 @@
 
 #pragma once
 
+#include "common/config.h"
 #include "common/status.h"
 #include "util/counts.h"
+#include "util/ddsketch.h"
+#include "util/quantile_state.h"
 #include "util/tdigest.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/columns_number.h"
@@ -30,11 +33,15 @@ namespace doris::vectorized {
 
 struct PercentileApproxState {
     static constexpr double INIT_QUANTILE = -1.0;
+    // The kind of the sketch, it's serialized in the place of the old init flag, so the states of
+    // TDigest are the same as the ones of the older versions.
+    enum SketchKind : uint8_t { UNINIT = 0, TDIGEST = 1, DDSKETCH = 2 };
+
     PercentileApproxState() = default;
     ~PercentileApproxState() = default;
 
     void init(double compression = 10000) {
-        if (!init_flag) {
+        if (kind == UNINIT) {
             //https://doris.apache.org/zh-CN/sql-reference/sql-functions/aggregate-functions/percentile_approx.html#description
             //The compression parameter setting range is [2048, 10000].
             //If the value of compression parameter is not specified set, or is outside the range of [2048, 10000],
@@ -42,31 +49,37 @@ struct PercentileApproxState {
             if (compression < 2048 || compression > 10000) {
                 compression = 10000;
             }
-            digest.reset(new TDigest(compression));
             compressions = compression;
-            init_flag = true;
+            _init_sketch(config::enable_quantile_ddsketch ? DDSKETCH : TDIGEST);
         }
     }
 
     void write(BufferWritable& buf) const {
-        write_binary(init_flag, buf);
-        if (!init_flag) {
+        write_binary(kind, buf);
+        if (kind == UNINIT) {
             return;
         }
 
         write_binary(target_quantile, buf);
         write_binary(compressions, buf);
-        uint32_t serialize_size = digest->serialized_size();
-        std::string result(serialize_size, '0');
-        DCHECK(digest.get() != nullptr);
-        digest->serialize((uint8_t*)result.c_str());
+        std::string result;
+        if (kind == DDSKETCH) {
+            DCHECK(ddsketch != nullptr);
+            result.resize(ddsketch->serialized_size());
+            ddsketch->serialize((uint8_t*)result.data());
+        } else {
+            DCHECK(digest.get() != nullptr);
+            uint32_t serialize_size = digest->serialized_size();
+            result.resize(serialize_size, '0');
+            digest->serialize((uint8_t*)result.c_str());
+        }
 
         write_binary(result, buf);
     }
 
     void read(BufferReadable& buf) {
-        read_binary(init_flag, buf);
-        if (!init_flag) {
+        read_binary(kind, buf);
+        if (kind == UNINIT) {
             return;
         }
 
@@ -74,29 +87,50 @@ struct PercentileApproxState {
         read_binary(compressions, buf);
         std::string str;
         read_binary(str, buf);
-        digest.reset(new TDigest(compressions));
-        digest->unserialize((uint8_t*)str.c_str());
+        if (kind == DDSKETCH) {
+            ddsketch = std::make_unique<DDSketch>();
+            if (!ddsketch->deserialize((const uint8_t*)str.data(), str.size())) {
+                LOG(WARNING) << "invalid DDSketch state of percentile_approx, size=" << str.size();
+                ddsketch->clear();
+            }
+        } else {
+            DCHECK_EQ(kind, TDIGEST);
+            digest.reset(new TDigest(compressions));
+            digest->unserialize((uint8_t*)str.c_str());
+        }
     }
 
     double get() const {
-        if (init_flag) {
+        switch (kind) {
+        case TDIGEST:
             return digest->quantile(target_quantile);
-        } else {
+        case DDSKETCH:
+            return ddsketch->quantile(target_quantile);
+        default:
             return std::nan("");
         }
     }
 
     void merge(const PercentileApproxState& rhs) {
-        if (!rhs.init_flag) {
+        if (rhs.kind == UNINIT) {
             return;
         }
-        if (init_flag) {
+        if (kind == UNINIT) {
+            _init_sketch(rhs.kind);
+        }
+        if (kind == TDIGEST && rhs.kind == DDSKETCH) {
+            // A DDSketch can't be added to a TDigest, convert this state to DDSketch
+            _init_sketch(DDSKETCH);
+            add_tdigest_to_ddsketch(digest.get(), ddsketch.get());
+            digest.reset();
+        }
+        if (kind == TDIGEST) {
             DCHECK(digest.get() != nullptr);
             digest->merge(rhs.digest.get());
+        } else if (rhs.kind == DDSKETCH) {
+            ddsketch->merge(*rhs.ddsketch);
         } else {
-            digest.reset(new TDigest(compressions));
-            digest->merge(rhs.digest.get());
-            init_flag = true;
+            add_tdigest_to_ddsketch(rhs.digest.get(), ddsketch.get());
         }
         if (target_quantile == PercentileApproxState::INIT_QUANTILE) {
             target_quantile = rhs.target_quantile;
@@ -104,20 +138,37 @@ struct PercentileApproxState {
     }
 
     void add(double source, double quantile) {
-        digest->add(source);
+        if (kind == DDSKETCH) {
+            ddsketch->add(source);
+        } else {
+            digest->add(source);
+        }
         target_quantile = quantile;
     }
 
     void reset() {
         target_quantile = INIT_QUANTILE;
-        init_flag = false;
+        kind = UNINIT;
         digest.reset(new TDigest(compressions));
+        ddsketch.reset();
     }
 
-    bool init_flag = false;
+    SketchKind kind = UNINIT;
     std::unique_ptr<TDigest> digest = nullptr;
+    std::unique_ptr<DDSketch> ddsketch = nullptr;
     double target_quantile = INIT_QUANTILE;
     double compressions = 10000;
+
+private:
+    void _init_sketch(SketchKind sketch_kind) {
+        if (sketch_kind == DDSKETCH) {
+            ddsketch = std::make_unique<DDSketch>(
+                    DDSketch::relative_accuracy_of_compression(compressions));
+        } else {
+            digest.reset(new TDigest(compressions));
+        }
+        kind = sketch_kind;
+    }
 };
 
 class AggregateFunctionPercentileApprox
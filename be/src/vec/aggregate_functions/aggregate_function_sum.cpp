@@ -37,6 +37,23 @@ struct SumSimple {
     using Function = AggregateFunctionSum<T, ResultType, AggregateDataType>;
 };
 
+/// Decimal32 and Decimal64 are at their declared scales rather than the scale 9 of DecimalV2
+/// (Decimal128), so they are summed in Int128 and the result is Decimal64 at the same scale,
+/// which is checked for overflow when the result is inserted.
+template <>
+struct SumSimple<Decimal32> {
+    using ResultType = Decimal64;
+    using AggregateDataType = AggregateFunctionSumData<Decimal128>;
+    using Function = AggregateFunctionSum<Decimal32, ResultType, AggregateDataType>;
+};
+
+template <>
+struct SumSimple<Decimal64> {
+    using ResultType = Decimal64;
+    using AggregateDataType = AggregateFunctionSumData<Decimal128>;
+    using Function = AggregateFunctionSum<Decimal64, ResultType, AggregateDataType>;
+};
+
 template <typename T>
 using AggregateFunctionSumSimple = typename SumSimple<T>::Function;
 
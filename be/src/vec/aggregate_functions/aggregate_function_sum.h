@@ -80,6 +80,35 @@ public:
         this->data(place).add(column.get_data()[row_num]);
     }
 
+    // The consecutive rows of the same place, e.g. the rows of the same keys sorted or clustered
+    // by the keys, are summed before being added to the place.
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena*) const override {
+        const auto* data = static_cast<const ColVecType&>(*columns[0]).get_data().data();
+        for (size_t i = 0; i < batch_size;) {
+            size_t end = i + 1;
+            while (end < batch_size && places[end] == places[i]) {
+                ++end;
+            }
+            this->data(places[i] + place_offset)
+                    .merge(sum_batch<false>(data + i, nullptr, end - i));
+            i = end;
+        }
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        const auto* data = static_cast<const ColVecType&>(*columns[0]).get_data().data();
+        this->data(place).merge(sum_batch<false>(data, nullptr, batch_size));
+    }
+
+    void add_batch_single_place_not_null(size_t batch_size, AggregateDataPtr place,
+                                         const IColumn** columns, const UInt8* null_map,
+                                         Arena*) const override {
+        const auto* data = static_cast<const ColVecType&>(*columns[0]).get_data().data();
+        this->data(place).merge(sum_batch<true>(data, null_map, batch_size));
+    }
+
     void reset(AggregateDataPtr place) const override { this->data(place).sum = {}; }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
@@ -98,10 +127,47 @@ public:
 
     void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
         auto& column = static_cast<ColVecResult&>(to);
-        column.get_data().push_back(this->data(place).get());
+        if constexpr (IsDecimalNumber<T> && !std::is_same_v<TResult, Decimal128>) {
+            // the sum of Decimal32 and Decimal64 is accumulated in Int128
+            Int128 sum = this->data(place).get().value;
+            Int128 max = ResultDataType::get_scale_multiplier(ResultDataType::max_precision());
+            if (UNLIKELY(sum >= max || sum <= -max)) {
+                LOG(FATAL) << "Decimal math overflow";
+            }
+            column.get_data().push_back(TResult(static_cast<typename TResult::NativeType>(sum)));
+        } else {
+            column.get_data().push_back(this->data(place).get());
+        }
     }
 
 private:
+    // Sum the values whose null_map is 0 (all the values if not has_null) into a local state, so
+    // the loop is vectorized without reading and writing the place for each value. The floating
+    // values are summed by several partial sums, because the compiler can't reorder the floating
+    // additions to vectorize the loop.
+    template <bool has_null>
+    static Data sum_batch(const T* __restrict data, const UInt8* __restrict null_map,
+                          size_t size) {
+        Data sum;
+        size_t i = 0;
+        if constexpr (std::is_floating_point_v<TResult>) {
+            constexpr size_t NUM_PARTIAL_SUMS = 16;
+            TResult partial_sums[NUM_PARTIAL_SUMS] {};
+            for (; i + NUM_PARTIAL_SUMS <= size; i += NUM_PARTIAL_SUMS) {
+                for (size_t j = 0; j < NUM_PARTIAL_SUMS; ++j) {
+                    partial_sums[j] += has_null && null_map[i + j] ? T() : data[i + j];
+                }
+            }
+            for (auto partial_sum : partial_sums) {
+                sum.add(partial_sum);
+            }
+        }
+        for (; i < size; ++i) {
+            sum.add(has_null && null_map[i] ? T() : data[i]);
+        }
+        return sum;
+    }
+
     UInt32 scale;
 };
 
@@ -42,16 +42,16 @@ struct AggregateFunctionTopNData {
         capacity = (uint64_t)top_num * space_expand_rate;
     }
 
-    void add(const std::string& value) {
+    void add(const StringRef& value, Arena* arena) {
         auto it = counter_map.find(value);
         if (it != counter_map.end()) {
             it->second++;
         } else {
-            counter_map.insert({value, 1});
+            counter_map.insert({copy_key(value, arena), 1});
         }
     }
 
-    void merge(const AggregateFunctionTopNData& rhs) {
+    void merge(const AggregateFunctionTopNData& rhs, Arena* arena) {
         if (!rhs.top_num) {
             return;
         }
@@ -88,18 +88,18 @@ struct AggregateFunctionTopNData {
             if (lhs_it != counter_map.end()) {
                 lhs_it->second += rhs_it.second - rhs_min;
             } else {
-                counter_map.insert({rhs_it.first, rhs_it.second + lhs_min});
+                counter_map.insert({copy_key(rhs_it.first, arena), rhs_it.second + lhs_min});
             }
         }
     }
 
-    std::vector<std::pair<uint64_t, std::string>> get_remain_vector() const {
-        std::vector<std::pair<uint64_t, std::string>> counter_vector;
+    std::vector<std::pair<uint64_t, StringRef>> get_remain_vector() const {
+        std::vector<std::pair<uint64_t, StringRef>> counter_vector;
         for (auto it : counter_map) {
             counter_vector.emplace_back(it.second, it.first);
         }
         std::sort(counter_vector.begin(), counter_vector.end(),
-                  std::greater<std::pair<uint64_t, std::string>>());
+                  std::greater<std::pair<uint64_t, StringRef>>());
         return counter_vector;
     }
 
@@ -119,6 +119,8 @@ struct AggregateFunctionTopNData {
         }
     }
 
+    // The deserialized states are merged and destroyed at once, so their keys aren't allocated
+    // in the arena.
     void read(BufferReadable& buf) {
         read_binary(top_num, buf);
         read_binary(capacity, buf);
@@ -126,12 +128,13 @@ struct AggregateFunctionTopNData {
         uint64_t element_number = 0;
         read_binary(element_number, buf);
 
-        counter_map.clear();
-        std::pair<std::string, uint64_t> element;
+        reset();
+        StringRef key;
+        uint64_t count = 0;
         for (auto i = 0; i < element_number; i++) {
-            read_binary(element.first, buf);
-            read_binary(element.second, buf);
-            counter_map.insert(element);
+            read_binary(key, buf);
+            read_binary(count, buf);
+            counter_map.insert({copy_key(key, nullptr), count});
         }
     }
 
@@ -144,7 +147,7 @@ struct AggregateFunctionTopNData {
         writer.StartObject();
         for (int i = 0; i < std::min((int)counter_vector.size(), top_num); i++) {
             const auto& element = counter_vector[i];
-            writer.Key(element.second.c_str());
+            writer.Key(element.second.data, element.second.size);
             writer.Uint64(element.first);
         }
         writer.EndObject();
@@ -152,26 +155,35 @@ struct AggregateFunctionTopNData {
         return buffer.GetString();
     }
 
-    void reset() { counter_map.clear(); }
+    void reset() {
+        counter_map.clear();
+        keys.clear();
+    }
+
+    // the keys of the map are allocated in the arena, see ChunkedArenaBuffer
+    StringRef copy_key(const StringRef& key, Arena* arena) {
+        char* data = keys.alloc(key.size, arena);
+        memcpy(data, key.data, key.size);
+        return StringRef(data, key.size);
+    }
 
     int top_num = 0;
     uint64_t capacity = 0;
-    phmap::flat_hash_map<std::string, uint64_t> counter_map;
+    phmap::flat_hash_map<StringRef, uint64_t, StringRefHash> counter_map;
+    ChunkedArenaBuffer keys;
 };
 
 struct StringDataImplTopN {
     using DataType = DataTypeString;
-    static std::string to_string(const IColumn& column, size_t row_num) {
-        StringRef ref =
-                static_cast<const typename DataType::ColumnType&>(column).get_data_at(row_num);
-        return std::string(ref.data, ref.size);
+    static StringRef to_string_ref(const IColumn& column, size_t row_num) {
+        return static_cast<const typename DataType::ColumnType&>(column).get_data_at(row_num);
     }
 };
 
 struct AggregateFunctionTopNImplEmpty {
     // only used at AGGREGATE (merge finalize)
     static void add(AggregateFunctionTopNData& __restrict place, const IColumn** columns,
-                    size_t row_num) {
+                    size_t row_num, Arena* arena) {
         LOG(FATAL) << "AggregateFunctionTopNImplEmpty do not support add()";
     }
 };
@@ -179,19 +191,19 @@ struct AggregateFunctionTopNImplEmpty {
 template <typename DataHelper>
 struct AggregateFunctionTopNImplInt {
     static void add(AggregateFunctionTopNData& __restrict place, const IColumn** columns,
-                    size_t row_num) {
+                    size_t row_num, Arena* arena) {
         place.set_paramenters(static_cast<const ColumnInt32*>(columns[1])->get_element(row_num));
-        place.add(DataHelper::to_string(*columns[0], row_num));
+        place.add(DataHelper::to_string_ref(*columns[0], row_num), arena);
     }
 };
 
 template <typename DataHelper>
 struct AggregateFunctionTopNImplIntInt {
     static void add(AggregateFunctionTopNData& __restrict place, const IColumn** columns,
-                    size_t row_num) {
+                    size_t row_num, Arena* arena) {
         place.set_paramenters(static_cast<const ColumnInt32*>(columns[1])->get_element(row_num),
                               static_cast<const ColumnInt32*>(columns[2])->get_element(row_num));
-        place.add(DataHelper::to_string(*columns[0], row_num));
+        place.add(DataHelper::to_string_ref(*columns[0], row_num), arena);
     }
 };
 
@@ -210,15 +222,15 @@ public:
     DataTypePtr get_return_type() const override { return std::make_shared<DataTypeString>(); }
 
     void add(AggregateDataPtr __restrict place, const IColumn** columns, size_t row_num,
-             Arena*) const override {
-        Impl::add(this->data(place), columns, row_num);
+             Arena* arena) const override {
+        Impl::add(this->data(place), columns, row_num, arena);
     }
 
     void reset(AggregateDataPtr __restrict place) const override { this->data(place).reset(); }
 
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
-               Arena*) const override {
-        this->data(place).merge(this->data(rhs));
+               Arena* arena) const override {
+        this->data(place).merge(this->data(rhs), arena);
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
@@ -234,6 +246,8 @@ public:
         std::string result = this->data(place).get();
         static_cast<ColumnString&>(to).insert_data(result.c_str(), result.length());
     }
+
+    bool allocates_memory_in_arena() const override { return true; }
 };
 
 } // namespace doris::vectorized
@@ -20,6 +20,7 @@
 
 #include "vec/aggregate_functions/aggregate_function_uniq.h"
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/aggregate_functions/factory_helpers.h"
@@ -28,6 +29,10 @@
 
 namespace doris::vectorized {
 
+template <typename T>
+using AggregateFunctionUniqExactBitmap =
+        AggregateFunctionUniq<T, AggregateFunctionUniqExactBitmapData<T>>;
+
 template <template <typename> class Data, typename DataForVariadic>
 AggregateFunctionPtr create_aggregate_function_uniq(const std::string& name,
                                                     const DataTypes& argument_types,
@@ -43,6 +48,22 @@ AggregateFunctionPtr create_aggregate_function_uniq(const std::string& name,
     if (argument_types.size() == 1) {
         const IDataType& argument_type = *argument_types[0];
 
+        if (config::enable_multi_distinct_count_bitmap) {
+            WhichDataType which(argument_type);
+#define DISPATCH(TYPE)                \
+    if (which.idx == TypeIndex::TYPE) \
+        return std::make_shared<AggregateFunctionUniqExactBitmap<TYPE>>(argument_types);
+            DISPATCH(UInt8)
+            DISPATCH(UInt16)
+            DISPATCH(UInt32)
+            DISPATCH(UInt64)
+            DISPATCH(Int8)
+            DISPATCH(Int16)
+            DISPATCH(Int32)
+            DISPATCH(Int64)
+#undef DISPATCH
+        }
+
         AggregateFunctionPtr res(create_with_numeric_type<AggregateFunctionUniq, Data>(
                 *argument_types[0], argument_types));
 
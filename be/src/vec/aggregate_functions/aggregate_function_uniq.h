@@ -21,16 +21,20 @@
 #pragma once
 
 #include <type_traits>
+#include <vector>
 
 #include "gutil/hash/city.h"
+#include "util/bitmap_value.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/columns/column_decimal.h"
+#include "vec/columns/column_string.h"
 #include "vec/common/aggregation_common.h"
 #include "vec/common/assert_cast.h"
 #include "vec/common/bit_cast.h"
 #include "vec/common/hash_table/hash_set.h"
 #include "vec/common/typeid_cast.h"
 #include "vec/data_types/data_type_number.h"
+#include "vec/io/io_helper.h"
 
 namespace doris::vectorized {
 
@@ -46,6 +50,12 @@ struct AggregateFunctionUniqExactData {
 
     Set set;
 
+    void add(const Key& key) { set.insert(key); }
+    void merge(const AggregateFunctionUniqExactData& rhs) { set.merge(rhs.set); }
+    void write(BufferWritable& buf) const { set.write(buf); }
+    void read(BufferReadable& buf) { set.read(buf); }
+    size_t size() const { return set.size(); }
+
     static String get_name() { return "uniqExact"; }
 };
 
@@ -60,6 +70,49 @@ struct AggregateFunctionUniqExactData<String> {
 
     Set set;
 
+    void add(const Key& key) { set.insert(key); }
+    void merge(const AggregateFunctionUniqExactData& rhs) { set.merge(rhs.set); }
+    void write(BufferWritable& buf) const { set.write(buf); }
+    void read(BufferReadable& buf) { set.read(buf); }
+    size_t size() const { return set.size(); }
+
+    static String get_name() { return "uniqExact"; }
+};
+
+/** For the integers if enable_multi_distinct_count_bitmap, the values are put into a roaring
+  * bitmap, which is much smaller than the hash set for the dense values (e.g. the ids), and is
+  * merged and serialized by its containers instead of by the values. The signed values are
+  * mapped to the unsigned values of the same size.
+  */
+template <typename T>
+struct AggregateFunctionUniqExactBitmapData {
+    static_assert(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t));
+    using Key = T;
+
+    // getSizeInBytes() optimizes the bitmap before serializing
+    mutable BitmapValue bitmap;
+
+    void add(const Key& key) { bitmap.add(to_bitmap_value(key)); }
+    void merge(const AggregateFunctionUniqExactBitmapData& rhs) { bitmap |= rhs.bitmap; }
+
+    void write(BufferWritable& buf) const {
+        std::string result(bitmap.getSizeInBytes(), '\0');
+        bitmap.write(result.data());
+        write_binary(result, buf);
+    }
+
+    void read(BufferReadable& buf) {
+        StringRef ref;
+        read_binary(ref, buf);
+        bitmap.deserialize(ref.data);
+    }
+
+    size_t size() const { return bitmap.cardinality(); }
+
+    static uint64_t to_bitmap_value(Key key) {
+        return static_cast<std::make_unsigned_t<Key>>(key);
+    }
+
     static String get_name() { return "uniqExact"; }
 };
 
@@ -79,16 +132,41 @@ struct OneAdder {
             hash.update(value.data, value.size);
             hash.get128(key.low, key.high);
 
-            data.set.insert(key);
+            data.add(key);
         } else if constexpr (std::is_same_v<T, Decimal128>) {
-            data.set.insert(
-                    assert_cast<const ColumnDecimal<Decimal128>&>(column).get_data()[row_num]);
+            data.add(assert_cast<const ColumnDecimal<Decimal128>&>(column).get_data()[row_num]);
         } else {
-            data.set.insert(assert_cast<const ColumnVector<T>&>(column).get_data()[row_num]);
+            data.add(assert_cast<const ColumnVector<T>&>(column).get_data()[row_num]);
         }
     }
 };
 
+/** Get the keys of the first `batch_size` rows of a column in one pass, the strings are hashed
+  * into `hashes` over the offsets of the column, as OneAdder does for each row.
+  */
+template <typename T>
+const auto* get_batch_keys(const IColumn& column, size_t batch_size,
+                           std::vector<UInt128>& hashes) {
+    if constexpr (std::is_same_v<T, String>) {
+        const auto& column_string = assert_cast<const ColumnString&>(column);
+        const auto& offsets = column_string.get_offsets();
+        const auto* chars = column_string.get_chars().data();
+        hashes.resize(batch_size);
+        for (size_t i = 0; i < batch_size; ++i) {
+            SipHash hash;
+            // without the terminating zero
+            hash.update(reinterpret_cast<const char*>(chars + offsets[i - 1]),
+                        offsets[i] - offsets[i - 1] - 1);
+            hash.get128(hashes[i].low, hashes[i].high);
+        }
+        return hashes.data();
+    } else if constexpr (std::is_same_v<T, Decimal128>) {
+        return assert_cast<const ColumnDecimal<Decimal128>&>(column).get_data().data();
+    } else {
+        return assert_cast<const ColumnVector<T>&>(column).get_data().data();
+    }
+}
+
 } // namespace detail
 
 /// Calculates the number of different values approximately or exactly.
@@ -109,22 +187,52 @@ public:
         detail::OneAdder<T, Data>::add(this->data(place), *columns[0], row_num);
     }
 
+    void add_batch(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                   const IColumn** columns, Arena*) const override {
+        std::vector<UInt128> hashes;
+        const auto* keys = detail::get_batch_keys<T>(*columns[0], batch_size, hashes);
+        for (size_t i = 0; i < batch_size; ++i) {
+            this->data(places[i] + place_offset).add(keys[i]);
+        }
+    }
+
+    void add_batch_selected(size_t batch_size, AggregateDataPtr* places, size_t place_offset,
+                            const IColumn** columns, Arena*) const override {
+        std::vector<UInt128> hashes;
+        const auto* keys = detail::get_batch_keys<T>(*columns[0], batch_size, hashes);
+        for (size_t i = 0; i < batch_size; ++i) {
+            if (places[i] != nullptr) {
+                this->data(places[i] + place_offset).add(keys[i]);
+            }
+        }
+    }
+
+    void add_batch_single_place(size_t batch_size, AggregateDataPtr place, const IColumn** columns,
+                                Arena*) const override {
+        std::vector<UInt128> hashes;
+        const auto* keys = detail::get_batch_keys<T>(*columns[0], batch_size, hashes);
+        auto& data = this->data(place);
+        for (size_t i = 0; i < batch_size; ++i) {
+            data.add(keys[i]);
+        }
+    }
+
     void merge(AggregateDataPtr __restrict place, ConstAggregateDataPtr rhs,
                Arena*) const override {
-        this->data(place).set.merge(this->data(rhs).set);
+        this->data(place).merge(this->data(rhs));
     }
 
     void serialize(ConstAggregateDataPtr __restrict place, BufferWritable& buf) const override {
-        this->data(place).set.write(buf);
+        this->data(place).write(buf);
     }
 
     void deserialize(AggregateDataPtr __restrict place, BufferReadable& buf,
                      Arena*) const override {
-        this->data(place).set.read(buf);
+        this->data(place).read(buf);
     }
 
     void insert_result_into(ConstAggregateDataPtr __restrict place, IColumn& to) const override {
-        assert_cast<ColumnInt64&>(to).get_data().push_back(this->data(place).set.size());
+        assert_cast<ColumnInt64&>(to).get_data().push_back(this->data(place).size());
     }
 };
 
@@ -63,6 +63,8 @@ public:
         assert_cast<ColumnInt64&>(to).get_data().push_back(data(place).count);
     }
 
+    bool support_merge_in_window() const override { return false; }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {}
     void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {}
     void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {}
@@ -108,6 +110,8 @@ public:
         assert_cast<ColumnInt64&>(to).get_data().push_back(data(place).rank);
     }
 
+    bool support_merge_in_window() const override { return false; }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {}
     void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {}
     void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {}
@@ -149,6 +153,8 @@ public:
         assert_cast<ColumnInt64&>(to).get_data().push_back(data(place).rank);
     }
 
+    bool support_merge_in_window() const override { return false; }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {}
     void serialize(ConstAggregateDataPtr place, BufferWritable& buf) const override {}
     void deserialize(AggregateDataPtr place, BufferReadable& buf, Arena*) const override {}
@@ -393,6 +399,8 @@ public:
              Arena* arena) const override {
         this->data(place).add(row_num, columns);
     }
+    bool support_merge_in_window() const override { return false; }
+
     void merge(AggregateDataPtr place, ConstAggregateDataPtr rhs, Arena*) const override {
         LOG(FATAL) << "WindowFunctionData do not support merge";
     }
@@ -29,36 +29,60 @@
 
 namespace doris::vectorized {
 
+// The events of a group are buffered and evaluated in the order of time at the end. While they
+// arrive in the order of time, they are also evaluated incrementally into the chain of the
+// funnel, which keeps the latest start of the chains reaching each level. Once a chain reaches
+// the last level the result can't change whatever events are added or merged, so the events are
+// replaced by a chain of one event per level at the same time, which keeps the state and its
+// serialization O(levels) for the rest of the group.
 struct WindowFunnelState {
     std::vector<std::pair<VecDateTimeValue, int>> events;
     int max_event_level;
     bool sorted;
     int64_t window;
+    // the latest start of the chains reaching each level by the events, only valid if sorted
+    std::vector<std::optional<VecDateTimeValue>> events_timestamp;
+    // a chain has reached the last level, the events are the shortest chain reaching it
+    bool completed;
 
     WindowFunnelState() {
         sorted = true;
         max_event_level = 0;
         window = 0;
+        completed = false;
     }
 
     void reset() {
         sorted = true;
         max_event_level = 0;
         window = 0;
+        completed = false;
+        events.clear();
         events.shrink_to_fit();
+        events_timestamp.clear();
     }
 
     void add(const VecDateTimeValue& timestamp, int event_idx, int event_num, int64_t win) {
         window = win;
         max_event_level = event_num;
+        if (completed) {
+            return;
+        }
         if (sorted && events.size() > 0) {
             if (events.back().first == timestamp) {
+                // the same event again can't extend any chain
+                if (events.back().second == event_idx) {
+                    return;
+                }
                 sorted = events.back().second <= event_idx;
             } else {
                 sorted = events.back().first < timestamp;
             }
         }
         events.emplace_back(timestamp, event_idx);
+        if (sorted) {
+            _advance(timestamp, event_idx);
+        }
     }
 
     void sort() {
@@ -66,33 +90,15 @@ struct WindowFunnelState {
             return;
         }
         std::stable_sort(events.begin(), events.end());
+        sorted = true;
+        _replay();
     }
 
     int get() const {
-        std::vector<std::optional<VecDateTimeValue>> events_timestamp(max_event_level);
-        for (int64_t i = 0; i < events.size(); i++) {
-            const int& event_idx = events[i].second;
-            const VecDateTimeValue& timestamp = events[i].first;
-            if (event_idx == 0) {
-                events_timestamp[0] = timestamp;
-                continue;
-            }
-            if (events_timestamp[event_idx - 1].has_value()) {
-                const VecDateTimeValue& first_timestamp = events_timestamp[event_idx - 1].value();
-                VecDateTimeValue last_timestamp = first_timestamp;
-                TimeInterval interval(SECOND, window, false);
-                last_timestamp.date_add_interval(interval, SECOND);
-
-                if (timestamp <= last_timestamp) {
-                    events_timestamp[event_idx] = first_timestamp;
-                    if (event_idx + 1 == max_event_level) {
-                        // Usually, max event level is small.
-                        return max_event_level;
-                    }
-                }
-            }
+        if (completed) {
+            return max_event_level;
         }
-
+        DCHECK(sorted);
         for (int64_t i = events_timestamp.size() - 1; i >= 0; i--) {
             if (events_timestamp[i].has_value()) {
                 return i + 1;
@@ -106,6 +112,18 @@ struct WindowFunnelState {
         if (other.events.empty()) {
             return;
         }
+        max_event_level = max_event_level > 0 ? max_event_level : other.max_event_level;
+        window = window > 0 ? window : other.window;
+        if (completed) {
+            return;
+        }
+        if (other.completed) {
+            sorted = true;
+            events = other.events;
+            events_timestamp.clear();
+            completed = true;
+            return;
+        }
 
         int64_t orig_size = events.size();
         events.insert(std::end(events), std::begin(other.events), std::end(other.events));
@@ -120,10 +138,9 @@ struct WindowFunnelState {
             std::stable_sort(begin, middle);
         }
         std::inplace_merge(begin, middle, end);
-        max_event_level = max_event_level > 0 ? max_event_level : other.max_event_level;
-        window = window > 0 ? window : other.window;
 
         sorted = true;
+        _replay();
     }
 
     void write(BufferWritable& out) const {
@@ -158,6 +175,47 @@ struct WindowFunnelState {
             add(time_value, (int)event_idx, max_event_level, window);
         }
     }
+
+private:
+    // evaluate the next event in the order of time into the chain of the funnel
+    void _advance(const VecDateTimeValue& timestamp, int event_idx) {
+        if (events_timestamp.size() < max_event_level) {
+            events_timestamp.resize(max_event_level);
+        }
+        if (event_idx == 0) {
+            events_timestamp[0] = timestamp;
+        } else if (events_timestamp[event_idx - 1].has_value()) {
+            const VecDateTimeValue& first_timestamp = events_timestamp[event_idx - 1].value();
+            VecDateTimeValue last_timestamp = first_timestamp;
+            TimeInterval interval(SECOND, window, false);
+            last_timestamp.date_add_interval(interval, SECOND);
+            if (timestamp <= last_timestamp) {
+                events_timestamp[event_idx] = first_timestamp;
+            }
+        }
+        if (event_idx + 1 == max_event_level && events_timestamp[event_idx].has_value()) {
+            _complete(timestamp);
+        }
+    }
+
+    // evaluate the sorted events from the beginning
+    void _replay() {
+        events_timestamp.clear();
+        for (int64_t i = 0; i < events.size() && !completed; i++) {
+            _advance(events[i].first, events[i].second);
+        }
+    }
+
+    // `timestamp` is copied since it may be one of the events
+    void _complete(VecDateTimeValue timestamp) {
+        events.clear();
+        events.shrink_to_fit();
+        for (int i = 0; i < max_event_level; i++) {
+            events.emplace_back(timestamp, i);
+        }
+        events_timestamp.clear();
+        completed = true;
+    }
 };
 
 class AggregateFunctionWindowFunnel
@@ -22,6 +22,7 @@
 
 #include <sstream>
 
+#include "util/hash_util.hpp"
 #include "vec/columns/column_const.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/core/field.h"
@@ -42,6 +43,23 @@ std::string IColumn::dump_structure() const {
     return res.str();
 }
 
+void IColumn::update_crcs_with_value(std::vector<uint32_t>& hashes,
+                                     const uint8_t* __restrict null_data) const {
+    static constexpr int32_t NULL_VALUE = 0;
+    DCHECK(hashes.size() == size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        StringRef val;
+        if (null_data == nullptr || null_data[i] == 0) {
+            val = get_data_at(i);
+        }
+        if (val.data == nullptr) {
+            hashes[i] = HashUtil::crc_hash(&NULL_VALUE, sizeof(NULL_VALUE), hashes[i]);
+        } else {
+            hashes[i] = HashUtil::crc_hash(val.data, val.size, hashes[i]);
+        }
+    }
+}
+
 void IColumn::insert_from(const IColumn& src, size_t n) {
     insert(src[n]);
 }
@@ -238,6 +238,12 @@ public:
     ///  passed bytes to hash must identify sequence of values unambiguously.
     virtual void update_hash_with_value(size_t n, SipHash& hash) const = 0;
 
+    /// Update the crc32 hashes (HashUtil::crc_hash) of all the rows, `hashes` has one hash for
+    /// each row. The i-th row is NULL if null_data is not nullptr and null_data[i] is not 0, a NULL
+    /// is hashed as the int 0. Is used to hash the partition columns of a block at once.
+    virtual void update_crcs_with_value(std::vector<uint32_t>& hashes,
+                                        const uint8_t* __restrict null_data = nullptr) const;
+
     /** Removes elements that don't match the filter.
       * Is used in WHERE and HAVING operations.
       * If result_size_hint > 0, then makes advance reserve(result_size_hint) for the result column;
@@ -50,7 +50,9 @@ namespace doris::vectorized {
  * contents, convert the encoding column, and then compare the encoding directly.
  * If the read data page contains plain-encoded data pages, the dictionary
  * columns are converted into PredicateColumn for processing.
- * Currently ColumnDictionary is only used for storage layer.
+ * Currently ColumnDictionary is only used for storage layer, the codes are converted
+ * back into strings before the block leaves the segment iterator, so the operators above
+ * the scan, e.g. the aggregation, never group or join by the codes.
  */
 template <typename T>
 class ColumnDictionary final : public COWHelper<IColumn, ColumnDictionary<T>> {
@@ -250,6 +252,11 @@ public:
 
     int32_t find_code(const StringValue& value) const { return _dict.find_code(value); }
 
+    StringRef get_dict_value(T code) const {
+        const auto& value = _dict.get_value(code);
+        return StringRef(value.ptr, value.len);
+    }
+
     int32_t find_code_by_bound(const StringValue& value, bool greater, bool eq) const {
         return _dict.find_code_by_bound(value, greater, eq);
     }
@@ -306,6 +313,8 @@ public:
 
         inline StringValue& get_value(T code) { return _dict_data[code]; }
 
+        inline const StringValue& get_value(T code) const { return _dict_data[code]; }
+
         inline void generate_hash_values() {
             if (_hash_values.size() == 0) {
                 _hash_values.resize(_dict_data.size());
@@ -50,6 +50,12 @@ void ColumnNullable::update_hash_with_value(size_t n, SipHash& hash) const {
         get_nested_column().update_hash_with_value(n, hash);
 }
 
+void ColumnNullable::update_crcs_with_value(std::vector<uint32_t>& hashes,
+                                            const uint8_t* __restrict null_data) const {
+    DCHECK(null_data == nullptr);
+    get_nested_column().update_crcs_with_value(hashes, get_null_map_data().data());
+}
+
 MutableColumnPtr ColumnNullable::clone_resized(size_t new_size) const {
     MutableColumnPtr new_nested_col = get_nested_column().clone_resized(new_size);
     auto new_null_map = ColumnUInt8::create();
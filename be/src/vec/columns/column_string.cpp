@@ -20,15 +20,32 @@
 
 #include "vec/columns/column_string.h"
 
+#include "common/config.h"
+#include "util/hash_util.hpp"
 #include "vec/columns/collator.h"
 #include "vec/columns/columns_common.h"
 #include "vec/common/arena.h"
 #include "vec/common/assert_cast.h"
+#include "vec/common/inline_string_ref.h"
 #include "vec/common/memcmp_small.h"
 #include "vec/common/unaligned.h"
 
 namespace doris::vectorized {
 
+void ColumnString::update_crcs_with_value(std::vector<uint32_t>& hashes,
+                                          const uint8_t* __restrict null_data) const {
+    static constexpr int32_t NULL_VALUE = 0;
+    DCHECK(hashes.size() == offsets.size());
+    for (size_t i = 0; i < hashes.size(); ++i) {
+        if (null_data != nullptr && null_data[i]) {
+            hashes[i] = HashUtil::crc_hash(&NULL_VALUE, sizeof(NULL_VALUE), hashes[i]);
+        } else {
+            // the terminating zero is not hashed
+            hashes[i] = HashUtil::crc_hash(&chars[offset_at(i)], size_at(i) - 1, hashes[i]);
+        }
+    }
+}
+
 MutableColumnPtr ColumnString::clone_resized(size_t to_size) const {
     auto res = ColumnString::create();
     if (to_size == 0) return res;
@@ -243,6 +260,27 @@ void ColumnString::get_permutation(bool reverse, size_t limit, int /*nan_directi
 
     if (limit >= s) limit = 0;
 
+    if (config::enable_vec_inline_string_sort) {
+        // most comparisons are decided by the inline refs without touching the chars
+        std::vector<InlineStringRef> refs(s);
+        for (size_t i = 0; i < s; ++i) {
+            refs[i] = InlineStringRef(get_data_at(i));
+        }
+        auto sort = [&](auto less) {
+            if (limit) {
+                std::partial_sort(res.begin(), res.begin() + limit, res.end(), less);
+            } else {
+                std::sort(res.begin(), res.end(), less);
+            }
+        };
+        if (reverse) {
+            sort([&refs](size_t lhs, size_t rhs) { return refs[rhs] < refs[lhs]; });
+        } else {
+            sort([&refs](size_t lhs, size_t rhs) { return refs[lhs] < refs[rhs]; });
+        }
+        return;
+    }
+
     if (limit) {
         if (reverse)
             std::partial_sort(res.begin(), res.begin() + limit, res.end(), less<false>(*this));
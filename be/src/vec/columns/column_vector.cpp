@@ -27,6 +27,7 @@
 #include <cstring>
 
 #include "runtime/datetime_value.h"
+#include "util/hash_util.hpp"
 #include "vec/common/arena.h"
 #include "vec/common/assert_cast.h"
 #include "vec/common/bit_cast.h"
@@ -57,6 +58,26 @@ void ColumnVector<T>::update_hash_with_value(size_t n, SipHash& hash) const {
     hash.update(data[n]);
 }
 
+template <typename T>
+void ColumnVector<T>::update_crcs_with_value(std::vector<uint32_t>& hashes,
+                                             const uint8_t* __restrict null_data) const {
+    static constexpr int32_t NULL_VALUE = 0;
+    DCHECK(hashes.size() == data.size());
+    if (null_data == nullptr) {
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            hashes[i] = HashUtil::crc_hash(&data[i], sizeof(T), hashes[i]);
+        }
+    } else {
+        for (size_t i = 0; i < hashes.size(); ++i) {
+            if (null_data[i]) {
+                hashes[i] = HashUtil::crc_hash(&NULL_VALUE, sizeof(NULL_VALUE), hashes[i]);
+            } else {
+                hashes[i] = HashUtil::crc_hash(&data[i], sizeof(T), hashes[i]);
+            }
+        }
+    }
+}
+
 template <typename T>
 struct ColumnVector<T>::less {
     const Self& parent;
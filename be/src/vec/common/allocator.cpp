@@ -0,0 +1,152 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/common/allocator.h"
+
+#include <sanitizer/asan_interface.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "common/config.h"
+#include "util/doris_metrics.h"
+
+namespace doris::vectorized {
+
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_mmap_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_munmap_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_mremap_count, MetricUnit::NOUNIT);
+DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(vec_allocator_chunk_cache_hit_count, MetricUnit::NOUNIT);
+DEFINE_GAUGE_METRIC_PROTOTYPE_2ARG(vec_allocator_chunk_cache_bytes, MetricUnit::BYTES);
+
+static IntCounter* vec_allocator_mmap_count;
+static IntCounter* vec_allocator_munmap_count;
+static IntCounter* vec_allocator_mremap_count;
+static IntCounter* vec_allocator_chunk_cache_hit_count;
+static IntGauge* vec_allocator_chunk_cache_bytes;
+
+static constexpr size_t HUGE_PAGE_SIZE = 2UL * 1024 * 1024;
+
+MmapChunkCache* MmapChunkCache::instance() {
+    // never destructed, the allocators may free their chunks during the static destruction
+    static MmapChunkCache* cache = new MmapChunkCache();
+    return cache;
+}
+
+MmapChunkCache::MmapChunkCache() {
+    auto entity = DorisMetrics::instance()->metric_registry()->register_entity("vec_allocator");
+    INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_mmap_count);
+    INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_munmap_count);
+    INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_mremap_count);
+    INT_COUNTER_METRIC_REGISTER(entity, vec_allocator_chunk_cache_hit_count);
+    INT_GAUGE_METRIC_REGISTER(entity, vec_allocator_chunk_cache_bytes);
+}
+
+void* MmapChunkCache::mmap(void* hint, size_t size, int mmap_flags, bool clear_memory) {
+    void* buf = nullptr;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        auto it = _chunks.find(size);
+        if (it != _chunks.end()) {
+            buf = it->second.back();
+            it->second.pop_back();
+            if (it->second.empty()) {
+                _chunks.erase(it);
+            }
+            _cached_bytes -= size;
+            vec_allocator_chunk_cache_bytes->set_value(_cached_bytes);
+        }
+    }
+    if (buf != nullptr) {
+        vec_allocator_chunk_cache_hit_count->increment(1);
+        ASAN_UNPOISON_MEMORY_REGION(buf, size);
+        if (clear_memory) {
+            memset(buf, 0, size);
+        }
+        return buf;
+    }
+
+    vec_allocator_mmap_count->increment(1);
+    buf = ::mmap(hint, size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    if (buf != MAP_FAILED) {
+        advise_huge_pages(buf, size);
+    }
+    return buf;
+}
+
+int MmapChunkCache::munmap(void* buf, size_t size) {
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_cached_bytes + size <= config::vec_allocator_chunk_cache_bytes) {
+            // Poison the chunk to make asan can detect invalid access
+            ASAN_POISON_MEMORY_REGION(buf, size);
+            _chunks[size].push_back(buf);
+            _cached_bytes += size;
+            vec_allocator_chunk_cache_bytes->set_value(_cached_bytes);
+            return 0;
+        }
+    }
+    vec_allocator_munmap_count->increment(1);
+    return ::munmap(buf, size);
+}
+
+void* MmapChunkCache::mremap(void* buf, size_t old_size, size_t new_size, int mmap_flags) {
+    vec_allocator_mremap_count->increment(1);
+    void* new_buf = clickhouse_mremap(buf, old_size, new_size, MREMAP_MAYMOVE,
+                                      PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+    if (new_buf != MAP_FAILED && new_size > old_size) {
+        advise_huge_pages(new_buf, new_size);
+    }
+    return new_buf;
+}
+
+size_t MmapChunkCache::cached_bytes() {
+    std::lock_guard<std::mutex> l(_lock);
+    return _cached_bytes;
+}
+
+void MmapChunkCache::purge() {
+    std::unordered_map<size_t, std::vector<void*>> chunks;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        chunks.swap(_chunks);
+        _cached_bytes = 0;
+        vec_allocator_chunk_cache_bytes->set_value(0);
+    }
+    for (auto& [size, bufs] : chunks) {
+        for (void* buf : bufs) {
+            ASAN_UNPOISON_MEMORY_REGION(buf, size);
+            vec_allocator_munmap_count->increment(1);
+            ::munmap(buf, size);
+        }
+    }
+}
+
+void MmapChunkCache::advise_huge_pages(void* buf, size_t size) {
+#ifdef MADV_HUGEPAGE
+    if (config::madvise_huge_pages && size >= HUGE_PAGE_SIZE) {
+        // Only a hint, the chunk is still usable if the kernel doesn't support it.
+        int rc;
+        do {
+            rc = madvise(buf, size, MADV_HUGEPAGE);
+        } while (rc == -1 && errno == EAGAIN);
+    }
+#endif
+}
+
+} // namespace doris::vectorized
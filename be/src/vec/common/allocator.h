@@ -45,6 +45,9 @@
 
 #include <algorithm>
 #include <cstdlib>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #include "common/compiler_util.h"
 #ifdef THREAD_SANITIZER
@@ -87,6 +90,46 @@ static constexpr size_t MMAP_THRESHOLD = 4096;
 static constexpr size_t MMAP_MIN_ALIGNMENT = 4096;
 static constexpr size_t MALLOC_MIN_ALIGNMENT = 8;
 
+namespace doris::vectorized {
+
+/** The mmap/munmap/mremap of Allocator go through this cache, which keeps the recently freed
+  * mmapped chunks by their sizes, within config::vec_allocator_chunk_cache_bytes. The sizes of
+  * PODArray and the hash tables are powers of two, so an allocation of a size seen before reuses
+  * the mapped and already faulted pages of a freed chunk instead of mmap and munmap again.
+  * The chunks larger than 2MB are advised to be backed by transparent huge pages if
+  * config::madvise_huge_pages is set.
+  * The calls are counted by the metrics of the "vec_allocator" entity.
+  */
+class MmapChunkCache {
+public:
+    static MmapChunkCache* instance();
+
+    /// Return MAP_FAILED if fails to mmap. A reused chunk is zeroed if `clear_memory`.
+    void* mmap(void* hint, size_t size, int mmap_flags, bool clear_memory);
+
+    /// Return the result of munmap if the chunk isn't cached, 0 otherwise.
+    int munmap(void* buf, size_t size);
+
+    /// Return MAP_FAILED if fails to mremap.
+    void* mremap(void* buf, size_t old_size, size_t new_size, int mmap_flags);
+
+    size_t cached_bytes();
+
+    /// Unmap all the cached chunks.
+    void purge();
+
+private:
+    MmapChunkCache();
+
+    static void advise_huge_pages(void* buf, size_t size);
+
+    std::mutex _lock;
+    std::unordered_map<size_t, std::vector<void*>> _chunks;
+    size_t _cached_bytes = 0;
+};
+
+} // namespace doris::vectorized
+
 /** Responsible for allocating / freeing memory. Used, for example, in PODArray, Arena.
   * Also used in hash tables.
   * The interface is different from std::allocator
@@ -139,8 +182,8 @@ public:
             CONSUME_THREAD_LOCAL_MEM_TRACKER(new_size - old_size);
 
             // On apple and freebsd self-implemented mremap used (common/mremap.h)
-            buf = clickhouse_mremap(buf, old_size, new_size, MREMAP_MAYMOVE, PROT_READ | PROT_WRITE,
-                                    mmap_flags, -1, 0);
+            buf = doris::vectorized::MmapChunkCache::instance()->mremap(buf, old_size, new_size,
+                                                                        mmap_flags);
             if (MAP_FAILED == buf) {
                 RELEASE_THREAD_LOCAL_MEM_TRACKER(new_size - old_size);
                 doris::vectorized::throwFromErrno("Allocator: Cannot mremap memory chunk from " +
@@ -207,14 +250,15 @@ private:
                         doris::TStatusCode::VEC_BAD_ARGUMENTS);
 
             CONSUME_THREAD_LOCAL_MEM_TRACKER(size);
-            buf = mmap(get_mmap_hint(), size, PROT_READ | PROT_WRITE, mmap_flags, -1, 0);
+            buf = doris::vectorized::MmapChunkCache::instance()->mmap(get_mmap_hint(), size,
+                                                                      mmap_flags, clear_memory);
             if (MAP_FAILED == buf) {
                 RELEASE_THREAD_LOCAL_MEM_TRACKER(size);
                 doris::vectorized::throwFromErrno(fmt::format("Allocator: Cannot mmap {}.", size),
                                                   doris::TStatusCode::VEC_CANNOT_ALLOCATE_MEMORY);
             }
 
-            /// No need for zero-fill, because mmap guarantees it.
+            /// No need for zero-fill, because mmap (or the cache) guarantees it.
         } else {
             if (alignment <= MALLOC_MIN_ALIGNMENT) {
                 if constexpr (clear_memory)
@@ -243,7 +287,7 @@ private:
 
     void free_no_track(void* buf, size_t size) {
         if (size >= MMAP_THRESHOLD) {
-            if (0 != munmap(buf, size)) {
+            if (0 != doris::vectorized::MmapChunkCache::instance()->munmap(buf, size)) {
                 doris::vectorized::throwFromErrno(fmt::format("Allocator: Cannot munmap {}.", size),
                                                   doris::TStatusCode::VEC_CANNOT_MUNMAP);
             } else {
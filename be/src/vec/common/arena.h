@@ -275,6 +275,25 @@ public:
     /// Size of chunks in bytes.
     size_t size() const { return size_in_bytes; }
 
+    /// Free all chunks except the first one and rewind it. All memory previously
+    /// allocated from the arena becomes invalid.
+    void clear() {
+        Chunk* first = head;
+        Chunk* second = nullptr;
+        while (first->prev != nullptr) {
+            second = first;
+            first = first->prev;
+        }
+        if (second != nullptr) {
+            second->prev = nullptr;
+            delete head;
+            head = first;
+        }
+        ASAN_POISON_MEMORY_REGION(head->begin, head->size());
+        head->pos = head->begin;
+        size_in_bytes = head->size();
+    }
+
     size_t remaining_space_in_current_chunk() const { return head->remaining(); }
 };
 
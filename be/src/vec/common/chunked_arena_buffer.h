@@ -0,0 +1,148 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#include "vec/common/arena.h"
+
+namespace doris::vectorized {
+
+/** The memory of a variable-size aggregate state, e.g. the string of group_concat, as a list of
+  * chunks. Appending never copies the data appended before, and the chunks grow by the size of
+  * the buffer, so a state appended by many rows only allocates a few chunks.
+  *
+  * The chunks are allocated in the arena of the aggregation if there is one, so the states of
+  * the groups don't allocate from the heap for each group, and their chunks are freed with the
+  * arena at once. The callers without arena (e.g. the window functions and the aggregations of
+  * the storage) pass nullptr, then the chunks are allocated from the heap and freed by the
+  * buffer. So the buffer must be destroyed or cleared before the arena.
+  */
+class ChunkedArenaBuffer : private boost::noncopyable {
+public:
+    static constexpr size_t MIN_CHUNK_SIZE = 64;
+    static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+
+    ChunkedArenaBuffer() = default;
+    ~ChunkedArenaBuffer() { clear(); }
+
+    /// Get `size` contiguous bytes.
+    char* alloc(size_t size, Arena* arena) {
+        if (_tail == nullptr || _tail->capacity - _tail->size < size) {
+            _add_chunk(size, arena);
+        }
+        char* res = _tail->data() + _tail->size;
+        _tail->size += size;
+        _size += size;
+        return res;
+    }
+
+    /// Append the bytes, they may be split into the last chunk and a new chunk.
+    void append(const char* data, size_t size, Arena* arena) {
+        if (_tail != nullptr) {
+            size_t copied = std::min(size, _tail->capacity - _tail->size);
+            memcpy(_tail->data() + _tail->size, data, copied);
+            _tail->size += copied;
+            _size += copied;
+            data += copied;
+            size -= copied;
+        }
+        if (size > 0) {
+            memcpy(alloc(size, arena), data, size);
+        }
+    }
+
+    /// The total bytes allocated or appended.
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+    /// Call f(data, size) for the bytes of each chunk in the order of appending.
+    template <typename F>
+    void for_each_chunk(F&& f) const {
+        for (const Chunk* chunk = _head; chunk != nullptr; chunk = chunk->next) {
+            if (chunk->size > 0) {
+                f(chunk->data(), chunk->size);
+            }
+        }
+    }
+
+    /// Copy all the bytes to `dst` of size() bytes.
+    void copy_to(char* dst) const {
+        for_each_chunk([&dst](const char* data, size_t size) {
+            memcpy(dst, data, size);
+            dst += size;
+        });
+    }
+
+    /// Free the chunks of the heap, the chunks of the arena are freed with the arena.
+    void clear() {
+        Chunk* chunk = _head;
+        while (chunk != nullptr) {
+            Chunk* next = chunk->next;
+            if (!chunk->in_arena) {
+                delete[] reinterpret_cast<char*>(chunk);
+            }
+            chunk = next;
+        }
+        _head = _tail = nullptr;
+        _size = 0;
+        _capacity = 0;
+    }
+
+private:
+    struct Chunk {
+        Chunk* next = nullptr;
+        size_t size = 0;
+        size_t capacity = 0;
+        bool in_arena = false;
+
+        char* data() { return reinterpret_cast<char*>(this + 1); }
+        const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+    };
+
+    void _add_chunk(size_t min_size, Arena* arena) {
+        size_t capacity =
+                std::max(min_size, std::clamp(_capacity, MIN_CHUNK_SIZE, MAX_CHUNK_SIZE));
+        size_t bytes = sizeof(Chunk) + capacity;
+        char* memory = arena != nullptr ? arena->aligned_alloc(bytes, alignof(Chunk))
+                                        : new char[bytes];
+        Chunk* chunk = new (memory) Chunk();
+        chunk->capacity = capacity;
+        chunk->in_arena = arena != nullptr;
+        if (_tail == nullptr) {
+            _head = chunk;
+        } else {
+            _tail->next = chunk;
+        }
+        _tail = chunk;
+        _capacity += capacity;
+    }
+
+    Chunk* _head = nullptr;
+    Chunk* _tail = nullptr;
+    // the bytes used and the total capacity of the chunks
+    size_t _size = 0;
+    size_t _capacity = 0;
+};
+
+} // namespace doris::vectorized
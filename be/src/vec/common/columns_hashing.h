@@ -20,7 +20,10 @@
 
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <type_traits>
+#include <vector>
 
 #include "vec/columns/column_string.h"
 #include "vec/common/arena.h"
@@ -238,5 +241,87 @@ struct HashMethodSingleLowNullableColumn : public SingleColumnMethod {
     }
 };
 
+/// The key getters whose keys are cheap to get again, so the keys of a batch of rows can be
+/// hashed before being looked up.
+template <typename KeyGetter>
+struct IsCheapKeyGetter : std::false_type {};
+
+template <typename Value, typename Mapped, typename FieldType, bool use_cache>
+struct IsCheapKeyGetter<HashMethodOneNumber<Value, Mapped, FieldType, use_cache>>
+        : std::true_type {};
+
+template <typename Value, typename Key, typename Mapped, bool has_nullable_keys, bool use_cache>
+struct IsCheapKeyGetter<HashMethodKeysFixed<Value, Key, Mapped, has_nullable_keys, use_cache>>
+        : std::true_type {};
+
+template <typename Data, typename = void>
+struct HasPrefetchByHash : std::false_type {};
+
+template <typename Data>
+struct HasPrefetchByHash<
+        Data, std::void_t<decltype(std::declval<Data&>().prefetch_by_hash(size_t()))>>
+        : std::true_type {};
+
+template <typename KeyGetter, typename Data>
+inline constexpr bool is_batch_prefetchable_v =
+        IsCheapKeyGetter<KeyGetter>::value && HasPrefetchByHash<Data>::value;
+
+/// Hashes the keys of the rows by batch, and prefetches the bucket of the row `distance` rows
+/// ahead of the row being looked up, so that the cache misses of the lookups in a hash table
+/// larger than the cache overlap. The rows must be visited in ascending order, skipping rows is
+/// allowed. Only for the key getters and the hash tables of is_batch_prefetchable_v.
+template <typename KeyGetter, typename Data>
+class BatchHashPrefetcher {
+public:
+    static constexpr size_t BATCH_SIZE = 256;
+
+    BatchHashPrefetcher(KeyGetter& key_getter, Data& data, Arena& pool, size_t rows,
+                        size_t distance)
+            : _key_getter(key_getter), _data(data), _pool(pool), _rows(rows), _distance(distance) {
+        _hash_values.reserve(BATCH_SIZE + distance);
+    }
+
+    /// The hash value of the key of the row, to look up by the hash value.
+    ALWAYS_INLINE size_t get_hash(size_t row) {
+        if (UNLIKELY(row + _distance >= _end && _end < _rows)) {
+            _hash_next_batch(row);
+        }
+        if (row + _distance < _end) {
+            _data.prefetch_by_hash(_hash_values[row + _distance - _begin]);
+        }
+        return _hash_values[row - _begin];
+    }
+
+private:
+    /// Keep the hash values of the rows from `row`, and hash the next rows.
+    void _hash_next_batch(size_t row) {
+        size_t hashed_end = std::max(row, _end);
+        if (row < _end) {
+            _hash_values.erase(_hash_values.begin(), _hash_values.begin() + (row - _begin));
+        } else {
+            _hash_values.clear();
+        }
+        _begin = row;
+        _end = std::min(_rows, row + _distance + BATCH_SIZE);
+        for (size_t i = hashed_end; i < _end; ++i) {
+            _hash_values.push_back(_key_getter.get_hash(_data, i, _pool));
+            // the rows less than `distance` rows ahead are not prefetched by get_hash()
+            if (i < row + _distance) {
+                _data.prefetch_by_hash(_hash_values.back());
+            }
+        }
+    }
+
+    KeyGetter& _key_getter;
+    Data& _data;
+    Arena& _pool;
+    const size_t _rows;
+    const size_t _distance;
+    /// the hash values of the rows [_begin, _end)
+    size_t _begin = 0;
+    size_t _end = 0;
+    std::vector<size_t> _hash_values;
+};
+
 } // namespace ColumnsHashing
 } // namespace doris::vectorized
@@ -150,6 +150,22 @@ public:
         data.prefetch(key_holder);
     }
 
+    /// The lookups by the hash value of the key of the row computed in advance by get_hash(),
+    /// only for the hash tables which can be looked up by hash value.
+    template <typename Data>
+    ALWAYS_INLINE EmplaceResult emplace_key(Data& data, size_t hash_value, size_t row,
+                                            Arena& pool) {
+        auto key_holder = static_cast<Derived&>(*this).get_key_holder(row, pool);
+        return emplaceImpl<true>(key_holder, data, hash_value);
+    }
+
+    template <typename Data>
+    ALWAYS_INLINE FindResult find_key_with_hash(Data& data, size_t hash_value, size_t row,
+                                                Arena& pool) {
+        auto key_holder = static_cast<Derived&>(*this).get_key_holder(row, pool);
+        return find_key_impl<true>(key_holder_get_key(key_holder), data, hash_value);
+    }
+
 protected:
     Cache cache;
 
@@ -164,8 +180,9 @@ protected:
         }
     }
 
-    template <typename Data, typename KeyHolder>
-    ALWAYS_INLINE EmplaceResult emplaceImpl(KeyHolder& key_holder, Data& data) {
+    template <bool with_hash = false, typename Data, typename KeyHolder>
+    ALWAYS_INLINE EmplaceResult emplaceImpl(KeyHolder& key_holder, Data& data,
+                                            size_t hash_value = 0) {
         if constexpr (Cache::consecutive_keys_optimization) {
             if (cache.found && cache.check(key_holder_get_key(key_holder))) {
                 if constexpr (has_mapped)
@@ -177,7 +194,11 @@ protected:
 
         typename Data::LookupResult it;
         bool inserted = false;
-        data.emplace(key_holder, it, inserted);
+        if constexpr (with_hash) {
+            data.emplace(key_holder, it, inserted, hash_value);
+        } else {
+            data.emplace(key_holder, it, inserted);
+        }
 
         [[maybe_unused]] Mapped* cached = nullptr;
         if constexpr (has_mapped) cached = lookup_result_get_mapped(it);
@@ -207,8 +228,8 @@ protected:
             return EmplaceResult(inserted);
     }
 
-    template <typename Data, typename Key>
-    ALWAYS_INLINE FindResult find_key_impl(Key key, Data& data) {
+    template <bool with_hash = false, typename Data, typename Key>
+    ALWAYS_INLINE FindResult find_key_impl(Key key, Data& data, size_t hash_value = 0) {
         if constexpr (Cache::consecutive_keys_optimization) {
             if (cache.check(key)) {
                 if constexpr (has_mapped)
@@ -218,7 +239,13 @@ protected:
             }
         }
 
-        auto it = data.find(key);
+        auto it = [&]() {
+            if constexpr (with_hash) {
+                return data.find(key, hash_value);
+            } else {
+                return data.find(key);
+            }
+        }();
 
         if constexpr (consecutive_keys_optimization) {
             cache.found = it != nullptr;
@@ -754,6 +754,11 @@ public:
         __builtin_prefetch(&buf[place_value]);
     }
 
+    /// Prefetch the first cell probed for the key of the hash value.
+    void ALWAYS_INLINE prefetch_by_hash(size_t hash_value) {
+        __builtin_prefetch(&buf[grower.place(hash_value)]);
+    }
+
     /// Reinsert node pointed to by iterator
     void ALWAYS_INLINE reinsert(iterator& it, size_t hash_value) {
         reinsert(*it.get_ptr(), hash_value);
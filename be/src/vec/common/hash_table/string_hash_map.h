@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// This file is copied from
+// https://github.com/ClickHouse/ClickHouse/blob/master/src/Common/HashTable/StringHashMap.h
+// and modified by Doris
+
+#pragma once
+
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/hash_table/string_hash_table.h"
+
+template <typename Key, typename TMapped>
+struct StringHashMapCell : public HashMapCell<Key, TMapped, StringHashTableHash, HashTableNoState> {
+    using Base = HashMapCell<Key, TMapped, StringHashTableHash, HashTableNoState>;
+    using value_type = typename Base::value_type;
+    using Base::Base;
+    static constexpr bool need_zero_value_storage = false;
+};
+
+template <typename TMapped>
+struct StringHashMapCell<StringKey16, TMapped>
+        : public HashMapCell<StringKey16, TMapped, StringHashTableHash, HashTableNoState> {
+    using Base = HashMapCell<StringKey16, TMapped, StringHashTableHash, HashTableNoState>;
+    using value_type = typename Base::value_type;
+    using Base::Base;
+    static constexpr bool need_zero_value_storage = false;
+    bool is_zero(const HashTableNoState& state) const { return is_zero(this->value.first, state); }
+
+    // Zero means unoccupied cells in hash table. Use key with last word = 0 as
+    // zero keys, because such keys are unrepresentable (no way to encode length).
+    static bool is_zero(const StringKey16& key, const HashTableNoState&) { return key.high == 0; }
+    void set_zero() { this->value.first.high = 0; }
+};
+
+template <typename TMapped>
+struct StringHashMapCell<StringKey24, TMapped>
+        : public HashMapCell<StringKey24, TMapped, StringHashTableHash, HashTableNoState> {
+    using Base = HashMapCell<StringKey24, TMapped, StringHashTableHash, HashTableNoState>;
+    using value_type = typename Base::value_type;
+    using Base::Base;
+    static constexpr bool need_zero_value_storage = false;
+    bool is_zero(const HashTableNoState& state) const { return is_zero(this->value.first, state); }
+
+    // Zero means unoccupied cells in hash table. Use key with last word = 0 as
+    // zero keys, because such keys are unrepresentable (no way to encode length).
+    static bool is_zero(const StringKey24& key, const HashTableNoState&) { return key.c == 0; }
+    void set_zero() { this->value.first.c = 0; }
+};
+
+template <typename TMapped>
+struct StringHashMapCell<StringRef, TMapped>
+        : public HashMapCellWithSavedHash<StringRef, TMapped, StringHashTableHash,
+                                          HashTableNoState> {
+    using Base =
+            HashMapCellWithSavedHash<StringRef, TMapped, StringHashTableHash, HashTableNoState>;
+    using value_type = typename Base::value_type;
+    using Base::Base;
+    static constexpr bool need_zero_value_storage = false;
+};
+
+template <typename Key, typename Mapped>
+ALWAYS_INLINE inline auto lookup_result_get_mapped(StringHashMapCell<Key, Mapped>* cell) {
+    return &cell->get_second();
+}
+
+template <typename TMapped, typename Allocator>
+struct StringHashMapSubMaps {
+    using T0 = StringHashTableEmpty<StringHashMapCell<StringRef, TMapped>>;
+    using T1 = HashMapTable<StringKey8, StringHashMapCell<StringKey8, TMapped>, StringHashTableHash,
+                            StringHashTableGrower<>, Allocator>;
+    using T2 = HashMapTable<StringKey16, StringHashMapCell<StringKey16, TMapped>,
+                            StringHashTableHash, StringHashTableGrower<>, Allocator>;
+    using T3 = HashMapTable<StringKey24, StringHashMapCell<StringKey24, TMapped>,
+                            StringHashTableHash, StringHashTableGrower<>, Allocator>;
+    using Ts = HashMapTable<StringRef, StringHashMapCell<StringRef, TMapped>, StringHashTableHash,
+                            StringHashTableGrower<>, Allocator>;
+};
+
+template <typename TMapped, typename Allocator = HashTableAllocator>
+class StringHashMap : public StringHashTable<StringHashMapSubMaps<TMapped, Allocator>> {
+public:
+    using Key = StringRef;
+    using Base = StringHashTable<StringHashMapSubMaps<TMapped, Allocator>>;
+    using Self = StringHashMap;
+    using LookupResult = typename Base::LookupResult;
+
+    using Base::Base;
+
+    /// Call func(const Key &, Mapped &) for each hash map element.
+    template <typename Func>
+    void ALWAYS_INLINE for_each_value(Func&& func) {
+        for (auto it = this->begin(); it != this->end(); ++it) {
+            func(it->get_first(), it->get_second());
+        }
+    }
+
+    /// Call func(Mapped &) for each hash map element.
+    template <typename Func>
+    void ALWAYS_INLINE for_each_mapped(Func&& func) {
+        if (this->m0.size()) func(this->m0.zero_value()->get_second());
+        for (auto& v : this->m1) func(v.get_second());
+        for (auto& v : this->m2) func(v.get_second());
+        for (auto& v : this->m3) func(v.get_second());
+        for (auto& v : this->ms) func(v.get_second());
+    }
+
+    /// The total number of rows of all the RowRefLists, used by the hash join.
+    size_t get_size() {
+        size_t count = 0;
+        for_each_mapped([&](auto& mapped) { count += mapped.get_row_count(); });
+        return count;
+    }
+
+    TMapped& ALWAYS_INLINE operator[](const Key& x) {
+        LookupResult it;
+        bool inserted;
+        this->emplace(x, it, inserted);
+        if (inserted) new (it) TMapped();
+
+        return *it;
+    }
+
+    char* get_null_key_data() { return nullptr; }
+    bool has_null_key_data() const { return false; }
+};
@@ -0,0 +1,571 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+// This file is copied from
+// https://github.com/ClickHouse/ClickHouse/blob/master/src/Common/HashTable/StringHashTable.h
+// and modified by Doris
+
+#pragma once
+
+#include <cstring>
+#include <new>
+
+#include "vec/common/hash_table/hash.h"
+#include "vec/common/hash_table/hash_table.h"
+
+using StringKey8 = doris::vectorized::UInt64;
+using StringKey16 = doris::vectorized::UInt128;
+struct StringKey24 {
+    doris::vectorized::UInt64 a;
+    doris::vectorized::UInt64 b;
+    doris::vectorized::UInt64 c;
+
+    bool operator==(const StringKey24 rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c; }
+};
+
+inline StringRef ALWAYS_INLINE to_string_ref(const StringKey8& n) {
+    assert(n != 0);
+    return {reinterpret_cast<const char*>(&n), 8ul - (__builtin_clzll(n) >> 3)};
+}
+inline StringRef ALWAYS_INLINE to_string_ref(const StringKey16& n) {
+    assert(n.high != 0);
+    return {reinterpret_cast<const char*>(&n), 16ul - (__builtin_clzll(n.high) >> 3)};
+}
+inline StringRef ALWAYS_INLINE to_string_ref(const StringKey24& n) {
+    assert(n.c != 0);
+    return {reinterpret_cast<const char*>(&n), 24ul - (__builtin_clzll(n.c) >> 3)};
+}
+
+struct StringHashTableHash {
+#if defined(__SSE4_2__)
+    size_t ALWAYS_INLINE operator()(StringKey8 key) const {
+        size_t res = -1ULL;
+        res = _mm_crc32_u64(res, key);
+        return res;
+    }
+    size_t ALWAYS_INLINE operator()(StringKey16 key) const {
+        size_t res = -1ULL;
+        res = _mm_crc32_u64(res, key.low);
+        res = _mm_crc32_u64(res, key.high);
+        return res;
+    }
+    size_t ALWAYS_INLINE operator()(StringKey24 key) const {
+        size_t res = -1ULL;
+        res = _mm_crc32_u64(res, key.a);
+        res = _mm_crc32_u64(res, key.b);
+        res = _mm_crc32_u64(res, key.c);
+        return res;
+    }
+#else
+    size_t ALWAYS_INLINE operator()(StringKey8 key) const {
+        return util_hash::CityHash64(reinterpret_cast<const char*>(&key), 8);
+    }
+    size_t ALWAYS_INLINE operator()(StringKey16 key) const {
+        return util_hash::CityHash64(reinterpret_cast<const char*>(&key), 16);
+    }
+    size_t ALWAYS_INLINE operator()(StringKey24 key) const {
+        return util_hash::CityHash64(reinterpret_cast<const char*>(&key), 24);
+    }
+#endif
+    size_t ALWAYS_INLINE operator()(StringRef key) const { return StringRefHash()(key); }
+};
+
+/// The sub table of the empty string, which holds at most one cell.
+template <typename Cell>
+struct StringHashTableEmpty {
+    using Self = StringHashTableEmpty;
+
+    bool _has_zero = false;
+    std::aligned_storage_t<sizeof(Cell), alignof(Cell)>
+            zero_value_storage; /// Storage of element with zero key.
+
+public:
+    bool has_zero() const { return _has_zero; }
+
+    void set_has_zero() {
+        _has_zero = true;
+        new (zero_value()) Cell();
+    }
+
+    void set_has_zero(const Cell& other) {
+        _has_zero = true;
+        new (zero_value()) Cell(other);
+    }
+
+    void clear_has_zero() {
+        _has_zero = false;
+        if (!std::is_trivially_destructible_v<Cell>) zero_value()->~Cell();
+    }
+
+    Cell* zero_value() { return std::launder(reinterpret_cast<Cell*>(&zero_value_storage)); }
+    const Cell* zero_value() const {
+        return std::launder(reinterpret_cast<const Cell*>(&zero_value_storage));
+    }
+
+    using LookupResult = Cell*;
+    using ConstLookupResult = const Cell*;
+
+    template <typename KeyHolder>
+    void ALWAYS_INLINE emplace(KeyHolder&&, LookupResult& it, bool& inserted, size_t = 0) {
+        if (!has_zero()) {
+            set_has_zero();
+            inserted = true;
+        } else {
+            inserted = false;
+        }
+        it = zero_value();
+    }
+
+    template <typename Key>
+    LookupResult ALWAYS_INLINE find(const Key&, size_t = 0) {
+        return has_zero() ? zero_value() : nullptr;
+    }
+
+    template <typename Key>
+    ConstLookupResult ALWAYS_INLINE find(const Key&, size_t = 0) const {
+        return has_zero() ? zero_value() : nullptr;
+    }
+
+    template <typename KeyHolder>
+    void ALWAYS_INLINE prefetch(KeyHolder&) {}
+
+    size_t size() const { return has_zero() ? 1 : 0; }
+    bool empty() const { return !has_zero(); }
+    size_t get_buffer_size_in_bytes() const { return sizeof(Cell); }
+    size_t get_buffer_size_in_cells() const { return 1; }
+    bool add_elem_size_overflow(size_t) const { return false; }
+};
+
+template <size_t initial_size_degree = 8>
+struct StringHashTableGrower : public HashTableGrower<initial_size_degree> {
+    // Smooth growing for string maps
+    void increase_size() { this->size_degree += 1; }
+};
+
+/** A hash table for StringRef keys, which is composed of 5 sub tables, the key is sent
+  * to one of them by its length:
+  * - m0 holds the empty string;
+  * - m1, m2 and m3 hold the keys of 1..8, 9..16 and 17..24 bytes, the keys are stored
+  *   inline as fixed size integers, so they do not need to be copied to the arena, and
+  *   are compared and hashed as integers;
+  * - ms holds the longer keys as StringRef along with the saved hash.
+  *
+  * Keys with trailing zero bytes can not be represented as fixed size integers, they are
+  * always put to ms.
+  *
+  * The lookup result is the pointer to the mapped value, the key can only be got back
+  * through the iterators.
+  */
+template <typename SubMaps>
+class StringHashTable : private boost::noncopyable {
+protected:
+    static constexpr size_t NUM_MAPS = 5;
+    // Map for storing empty string
+    using T0 = typename SubMaps::T0;
+
+    // Short strings are stored as numbers
+    using T1 = typename SubMaps::T1;
+    using T2 = typename SubMaps::T2;
+    using T3 = typename SubMaps::T3;
+
+    // Long strings are stored as StringRef along with saved hash
+    using Ts = typename SubMaps::Ts;
+    using Self = StringHashTable;
+
+    T0 m0;
+    T1 m1;
+    T2 m2;
+    T3 m3;
+    Ts ms;
+
+public:
+    using Key = StringRef;
+    using key_type = Key;
+    using mapped_type = typename Ts::mapped_type;
+    using value_type = typename Ts::value_type;
+    using cell_type = typename Ts::cell_type;
+
+    using LookupResult = mapped_type*;
+    using ConstLookupResult = const mapped_type*;
+
+    StringHashTable() = default;
+
+    StringHashTable(size_t reserve_for_num_elements)
+            : m1 {reserve_for_num_elements / 4},
+              m2 {reserve_for_num_elements / 4},
+              m3 {reserve_for_num_elements / 4},
+              ms {reserve_for_num_elements / 4} {}
+
+    StringHashTable(StringHashTable&& rhs) { *this = std::move(rhs); }
+
+    StringHashTable& operator=(StringHashTable&& rhs) {
+        if (m0.has_zero()) {
+            m0.clear_has_zero();
+        }
+        if (rhs.m0.has_zero()) {
+            m0.set_has_zero(*rhs.m0.zero_value());
+            rhs.m0.clear_has_zero();
+        }
+        m1 = std::move(rhs.m1);
+        m2 = std::move(rhs.m2);
+        m3 = std::move(rhs.m3);
+        ms = std::move(rhs.ms);
+        return *this;
+    }
+
+    ~StringHashTable() {
+        if (m0.has_zero()) {
+            m0.clear_has_zero();
+        }
+    }
+
+    /// Iterate over the sub tables one by one. The key of the cell is converted back
+    /// to StringRef by get_first(), which points into the hash table.
+    template <typename Derived, bool is_const>
+    class iterator_base {
+        using Container = std::conditional_t<is_const, const Self, Self>;
+        using Mapped = std::conditional_t<is_const, const mapped_type, mapped_type>;
+        template <typename Table>
+        using SubIterator = std::conditional_t<is_const, typename Table::const_iterator,
+                                               typename Table::iterator>;
+
+        Container* container = nullptr;
+        size_t sub_table_index = NUM_MAPS;
+        SubIterator<T1> iterator1;
+        SubIterator<T2> iterator2;
+        SubIterator<T3> iterator3;
+        SubIterator<Ts> iterator_s;
+
+        friend class StringHashTable;
+
+        // Move to the first element from the current position, or to the end.
+        void skip_empty_sub_tables() {
+            while (true) {
+                switch (sub_table_index) {
+                case 0:
+                    if (container->m0.has_zero()) return;
+                    iterator1 = container->m1.begin();
+                    break;
+                case 1:
+                    if (iterator1 != container->m1.end()) return;
+                    iterator2 = container->m2.begin();
+                    break;
+                case 2:
+                    if (iterator2 != container->m2.end()) return;
+                    iterator3 = container->m3.begin();
+                    break;
+                case 3:
+                    if (iterator3 != container->m3.end()) return;
+                    iterator_s = container->ms.begin();
+                    break;
+                case 4:
+                    if (iterator_s != container->ms.end()) return;
+                    break;
+                default:
+                    return;
+                }
+                ++sub_table_index;
+            }
+        }
+
+    public:
+        iterator_base() = default;
+        iterator_base(Container* container_, size_t sub_table_index_)
+                : container(container_), sub_table_index(sub_table_index_) {
+            skip_empty_sub_tables();
+        }
+
+        bool operator==(const iterator_base& rhs) const {
+            if (sub_table_index != rhs.sub_table_index) return false;
+            switch (sub_table_index) {
+            case 1:
+                return iterator1 == rhs.iterator1;
+            case 2:
+                return iterator2 == rhs.iterator2;
+            case 3:
+                return iterator3 == rhs.iterator3;
+            case 4:
+                return iterator_s == rhs.iterator_s;
+            default:
+                return true;
+            }
+        }
+
+        bool operator!=(const iterator_base& rhs) const { return !(*this == rhs); }
+
+        Derived& operator++() {
+            switch (sub_table_index) {
+            case 0:
+                ++sub_table_index;
+                iterator1 = container->m1.begin();
+                break;
+            case 1:
+                ++iterator1;
+                break;
+            case 2:
+                ++iterator2;
+                break;
+            case 3:
+                ++iterator3;
+                break;
+            case 4:
+                ++iterator_s;
+                break;
+            default:
+                return static_cast<Derived&>(*this);
+            }
+            skip_empty_sub_tables();
+            return static_cast<Derived&>(*this);
+        }
+
+        // The cells of the sub tables are of different types, so the iterator itself is
+        // returned to access the key and the mapped value.
+        const iterator_base* operator->() const { return this; }
+
+        StringRef get_first() const {
+            switch (sub_table_index) {
+            case 0:
+                return StringRef();
+            case 1:
+                return to_string_ref(iterator1->get_first());
+            case 2:
+                return to_string_ref(iterator2->get_first());
+            case 3:
+                return to_string_ref(iterator3->get_first());
+            default:
+                return iterator_s->get_first();
+            }
+        }
+
+        Mapped& get_second() const {
+            switch (sub_table_index) {
+            case 0:
+                return container->m0.zero_value()->get_second();
+            case 1:
+                return iterator1->get_second();
+            case 2:
+                return iterator2->get_second();
+            case 3:
+                return iterator3->get_second();
+            default:
+                return iterator_s->get_second();
+            }
+        }
+    };
+
+    class iterator : public iterator_base<iterator, false> {
+    public:
+        using iterator_base<iterator, false>::iterator_base;
+    };
+
+    class const_iterator : public iterator_base<const_iterator, true> {
+    public:
+        using iterator_base<const_iterator, true>::iterator_base;
+    };
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator begin() { return iterator(this, 0); }
+
+    const_iterator end() const { return const_iterator(this, NUM_MAPS); }
+    const_iterator cend() const { return end(); }
+    iterator end() { return iterator(this, NUM_MAPS); }
+
+    // Dispatch is written in a way that maximizes the performance:
+    // 1. Always memcpy 8 times bytes
+    // 2. Use switch case extension to generate fast dispatching table
+    // 3. Funcs are named callables that can be force_inlined
+    //
+    // NOTE: It relies on Little Endianness
+    //
+    // NOTE: It requires padded to 8 bytes keys (IOW you cannot pass
+    // std::string here, but you can pass i.e. ColumnString::get_data_at()),
+    // since it copies 8 bytes at a time.
+    template <typename SelfType, typename KeyHolder, typename Func>
+    static auto ALWAYS_INLINE dispatch(SelfType& self, KeyHolder&& key_holder, Func&& func) {
+        StringHashTableHash hash;
+        const StringRef& x = key_holder_get_key(key_holder);
+        const size_t sz = x.size;
+        if (sz == 0) {
+            key_holder_discard_key(key_holder);
+            return func(self.m0, VoidKey {}, 0);
+        }
+
+        if (x.data[sz - 1] == 0) {
+            // Strings with trailing zeros are not representable as fixed-size
+            // string keys. Put them to the generic table.
+            return func(self.ms, std::forward<KeyHolder>(key_holder), hash(x));
+        }
+
+        const char* p = x.data;
+        // pending bits that needs to be shifted out
+        const char s = (-sz & 7) * 8;
+        union {
+            StringKey8 k8;
+            StringKey16 k16;
+            StringKey24 k24;
+            doris::vectorized::UInt64 n[3];
+        };
+        switch ((sz - 1) >> 3) {
+        case 0: // 1..8 bytes
+        {
+            // first half page
+            if ((reinterpret_cast<uintptr_t>(p) & 2048) == 0) {
+                memcpy(&n[0], p, 8);
+                n[0] &= -1ULL >> s;
+            } else {
+                const char* lp = x.data + x.size - 8;
+                memcpy(&n[0], lp, 8);
+                n[0] >>= s;
+            }
+            key_holder_discard_key(key_holder);
+            return func(self.m1, k8, hash(k8));
+        }
+        case 1: // 9..16 bytes
+        {
+            memcpy(&n[0], p, 8);
+            const char* lp = x.data + x.size - 8;
+            memcpy(&n[1], lp, 8);
+            n[1] >>= s;
+            key_holder_discard_key(key_holder);
+            return func(self.m2, k16, hash(k16));
+        }
+        case 2: // 17..24 bytes
+        {
+            memcpy(&n[0], p, 16);
+            const char* lp = x.data + x.size - 8;
+            memcpy(&n[2], lp, 8);
+            n[2] >>= s;
+            key_holder_discard_key(key_holder);
+            return func(self.m3, k24, hash(k24));
+        }
+        default: // >= 25 bytes
+        {
+            return func(self.ms, std::forward<KeyHolder>(key_holder), hash(x));
+        }
+        }
+    }
+
+    struct EmplaceCallable {
+        LookupResult& mapped;
+        bool& inserted;
+
+        EmplaceCallable(LookupResult& mapped_, bool& inserted_)
+                : mapped(mapped_), inserted(inserted_) {}
+
+        template <typename Map, typename KeyHolder>
+        void ALWAYS_INLINE operator()(Map& map, KeyHolder&& key_holder, size_t hash) {
+            typename Map::LookupResult result;
+            map.emplace(key_holder, result, inserted, hash);
+            mapped = &result->get_second();
+        }
+    };
+
+    template <typename KeyHolder>
+    void ALWAYS_INLINE emplace(KeyHolder&& key_holder, LookupResult& it, bool& inserted) {
+        this->dispatch(*this, key_holder, EmplaceCallable(it, inserted));
+    }
+
+    struct FindCallable {
+        // find() doesn't need any key memory management, so we don't work with
+        // any key holders here, only with normal keys. The key type is still
+        // different for every subtable, this is why it is a template parameter.
+        template <typename Submap, typename SubmapKey>
+        auto ALWAYS_INLINE operator()(Submap& map, const SubmapKey& key, size_t hash) {
+            auto it = map.find(key, hash);
+            if (!it) {
+                return decltype(&it->get_second()) {};
+            } else {
+                return &it->get_second();
+            }
+        }
+    };
+
+    LookupResult ALWAYS_INLINE find(const Key& x) { return dispatch(*this, x, FindCallable {}); }
+
+    struct PrefetchCallable {
+        template <typename Submap, typename SubmapKey>
+        void ALWAYS_INLINE operator()(Submap& map, const SubmapKey& key, size_t) {
+            map.prefetch(key);
+        }
+    };
+
+    template <typename KeyHolder>
+    void ALWAYS_INLINE prefetch(KeyHolder& key_holder) {
+        const auto& key = key_holder_get_key(key_holder);
+        dispatch(*this, key, PrefetchCallable {});
+    }
+
+    size_t hash(const Key& x) const { return StringHashTableHash()(x); }
+
+    size_t size() const { return m0.size() + m1.size() + m2.size() + m3.size() + ms.size(); }
+
+    bool empty() const {
+        return m0.empty() && m1.empty() && m2.empty() && m3.empty() && ms.empty();
+    }
+
+    size_t get_buffer_size_in_bytes() const {
+        return m0.get_buffer_size_in_bytes() + m1.get_buffer_size_in_bytes() +
+               m2.get_buffer_size_in_bytes() + m3.get_buffer_size_in_bytes() +
+               ms.get_buffer_size_in_bytes();
+    }
+
+    size_t get_buffer_size_in_cells() const {
+        return m0.get_buffer_size_in_cells() + m1.get_buffer_size_in_cells() +
+               m2.get_buffer_size_in_cells() + m3.get_buffer_size_in_cells() +
+               ms.get_buffer_size_in_cells();
+    }
+
+    // The keys may go to any of the sub tables, so it has to assume that all of them
+    // are added to every sub table.
+    bool add_elem_size_overflow(size_t add_size) const {
+        return m1.add_elem_size_overflow(add_size) || m2.add_elem_size_overflow(add_size) ||
+               m3.add_elem_size_overflow(add_size) || ms.add_elem_size_overflow(add_size);
+    }
+
+    void reset_resize_timer() {
+        m1.reset_resize_timer();
+        m2.reset_resize_timer();
+        m3.reset_resize_timer();
+        ms.reset_resize_timer();
+    }
+
+    int64_t get_resize_timer_value() const {
+        return m1.get_resize_timer_value() + m2.get_resize_timer_value() +
+               m3.get_resize_timer_value() + ms.get_resize_timer_value();
+    }
+
+    void clear() {
+        if (m0.has_zero()) {
+            m0.clear_has_zero();
+        }
+        m1.clear();
+        m2.clear();
+        m3.clear();
+        ms.clear();
+    }
+
+    void clear_and_shrink() {
+        if (m0.has_zero()) {
+            m0.clear_has_zero();
+        }
+        m1.clear_and_shrink();
+        m2.clear_and_shrink();
+        m3.clear_and_shrink();
+        ms.clear_and_shrink();
+    }
+};
@@ -0,0 +1,107 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "vec/common/string_ref.h"
+
+namespace doris::vectorized {
+
+// A 16 bytes reference of a string in the layout of the "German strings": the size, the first 4
+// bytes of the string and then either the other 8 bytes of a string of at most 12 bytes, inlined
+// and padded by zeros, or the pointer to the whole string.
+// The equality and the order of two refs are mostly decided by the first 8 bytes, without
+// touching the strings, and the short strings are never touched, so they pay off when a string
+// is compared several times, e.g. sorting or probing a hash table, at the cost of making the refs.
+// The refs of the long strings are only valid while the strings are.
+class InlineStringRef {
+public:
+    static constexpr size_t PREFIX_SIZE = 4;
+    static constexpr size_t INLINE_SIZE = 12;
+
+    InlineStringRef() : _size(0), _prefix {}, _ptr(nullptr) {}
+
+    InlineStringRef(const char* data, size_t size) : _size(size), _prefix {} {
+        if (size <= INLINE_SIZE) {
+            _ptr = nullptr;
+            memcpy(_inlined(), data, size);
+        } else {
+            memcpy(_prefix, data, PREFIX_SIZE);
+            _ptr = data;
+        }
+    }
+
+    explicit InlineStringRef(const StringRef& ref) : InlineStringRef(ref.data, ref.size) {}
+
+    size_t size() const { return _size; }
+    bool is_inlined() const { return _size <= INLINE_SIZE; }
+    const char* data() const { return is_inlined() ? _inlined() : _ptr; }
+    StringRef to_string_ref() const { return {data(), _size}; }
+
+    bool operator==(const InlineStringRef& other) const {
+        // the size and the prefix
+        if (unaligned_load<uint64_t>(this) != unaligned_load<uint64_t>(&other)) {
+            return false;
+        }
+        if (is_inlined()) {
+            return unaligned_load<uint64_t>(_inlined() + PREFIX_SIZE) ==
+                   unaligned_load<uint64_t>(other._inlined() + PREFIX_SIZE);
+        }
+        return memcmp(_ptr + PREFIX_SIZE, other._ptr + PREFIX_SIZE, _size - PREFIX_SIZE) == 0;
+    }
+
+    bool operator!=(const InlineStringRef& other) const { return !(*this == other); }
+
+    // the same order as memcmp on the strings, then the sizes
+    int compare(const InlineStringRef& other) const {
+        // the prefixes padded by zeros are ordered as big endian integers
+        uint32_t prefix = __builtin_bswap32(unaligned_load<uint32_t>(_prefix));
+        uint32_t other_prefix = __builtin_bswap32(unaligned_load<uint32_t>(other._prefix));
+        if (prefix != other_prefix) {
+            return prefix < other_prefix ? -1 : 1;
+        }
+        size_t min_size = std::min(_size, other._size);
+        if (min_size > PREFIX_SIZE) {
+            int res = memcmp(data() + PREFIX_SIZE, other.data() + PREFIX_SIZE,
+                             min_size - PREFIX_SIZE);
+            if (res != 0) {
+                return res;
+            }
+        }
+        return _size == other._size ? 0 : (_size < other._size ? -1 : 1);
+    }
+
+    bool operator<(const InlineStringRef& other) const { return compare(other) < 0; }
+
+private:
+    // the inlined string starts at the prefix and goes on over the pointer
+    char* _inlined() { return reinterpret_cast<char*>(this) + sizeof(_size); }
+    const char* _inlined() const { return reinterpret_cast<const char*>(this) + sizeof(_size); }
+
+    uint32_t _size;
+    char _prefix[PREFIX_SIZE];
+    const char* _ptr;
+};
+
+static_assert(sizeof(InlineStringRef) == 16);
+
+} // namespace doris::vectorized
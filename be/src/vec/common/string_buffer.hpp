@@ -16,9 +16,11 @@
 // under the License.
 
 #pragma once
-#include <cstring>
 #include <fmt/format.h>
 
+#include <cstring>
+#include <type_traits>
+
 #include "vec/columns/column_string.h"
 
 #include "vec/common/string_ref.h"
@@ -32,9 +34,20 @@ public:
 
     template <typename T>
     void write_number(T data) {
-        fmt::memory_buffer buffer;
-        fmt::format_to(buffer, "{}", data);
-        write(buffer.data(), buffer.size());
+        if constexpr (std::is_integral_v<T> && !std::is_same_v<T, bool> &&
+                      !std::is_same_v<T, char> && sizeof(T) <= sizeof(int64_t)) {
+            auto fi = fmt::format_int(data);
+            write(fi.data(), fi.size());
+        } else if constexpr (std::is_floating_point_v<T>) {
+            // the shortest round-trip digits by the Dragonbox algorithm of fmt
+            char buffer[32];
+            char* end = fmt::format_to(buffer, "{}", data);
+            write(buffer, end - buffer);
+        } else {
+            fmt::memory_buffer buffer;
+            fmt::format_to(buffer, "{}", data);
+            write(buffer.data(), buffer.size());
+        }
     }
 };
 
@@ -0,0 +1,138 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#elif __SSE2__
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include "util/sse2neon.h"
+#endif
+
+namespace doris::vectorized {
+
+// Searches a constant needle in the strings. The positions whose bytes match the first and the
+// last bytes of the needle are found 32 (AVX2) or 16 (SSE2/NEON) positions at a time, and only
+// they are compared with the needle, so most of the bytes are skipped by a few instructions.
+class StringSearcher {
+public:
+    StringSearcher() = default;
+    explicit StringSearcher(std::string_view needle) : _needle(needle) {}
+
+    size_t needle_size() const { return _needle.size(); }
+
+    // Return the first occurrence of the needle in [begin, end), or end if there is none.
+    const uint8_t* search(const uint8_t* begin, const uint8_t* end) const {
+        const size_t n = _needle.size();
+        if (n == 0) {
+            return begin;
+        }
+        if (static_cast<size_t>(end - begin) < n) {
+            return end;
+        }
+        const auto* needle = reinterpret_cast<const uint8_t*>(_needle.data());
+        // a match can start at [begin, last]
+        const uint8_t* last = end - n;
+        const uint8_t* pos = begin;
+#if defined(__AVX2__)
+        const __m256i first_bytes = _mm256_set1_epi8(needle[0]);
+        const __m256i last_bytes = _mm256_set1_epi8(needle[n - 1]);
+        for (; pos + 32 <= last + 1; pos += 32) {
+            const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos));
+            const __m256i block_last =
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pos + n - 1));
+            uint32_t mask = _mm256_movemask_epi8(_mm256_and_si256(
+                    _mm256_cmpeq_epi8(first_bytes, block_first),
+                    _mm256_cmpeq_epi8(last_bytes, block_last)));
+            for (; mask != 0; mask &= mask - 1) {
+                const uint8_t* candidate = pos + __builtin_ctz(mask);
+                if (n <= 2 || memcmp(candidate + 1, needle + 1, n - 2) == 0) {
+                    return candidate;
+                }
+            }
+        }
+#elif defined(__SSE2__) || defined(__aarch64__)
+        const __m128i first_bytes = _mm_set1_epi8(needle[0]);
+        const __m128i last_bytes = _mm_set1_epi8(needle[n - 1]);
+        for (; pos + 16 <= last + 1; pos += 16) {
+            const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+            const __m128i block_last =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + n - 1));
+            uint32_t mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first_bytes, block_first),
+                                                            _mm_cmpeq_epi8(last_bytes, block_last)));
+            for (; mask != 0; mask &= mask - 1) {
+                const uint8_t* candidate = pos + __builtin_ctz(mask);
+                if (n <= 2 || memcmp(candidate + 1, needle + 1, n - 2) == 0) {
+                    return candidate;
+                }
+            }
+        }
+#endif
+        for (; pos <= last; ++pos) {
+            if (pos[0] == needle[0] && memcmp(pos + 1, needle + 1, n - 1) == 0) {
+                return pos;
+            }
+        }
+        return end;
+    }
+
+    // Call `on_match(row, pos)` for the rows of a string column containing the needle, `pos` is
+    // the offset of the first occurrence in the row. The chars of all the rows are scanned at
+    // once, and the occurrences are mapped back to the rows by the offsets. The needle must not
+    // be empty.
+    template <typename Chars, typename Offsets, typename OnMatch>
+    void search_in_rows(const Chars& chars, const Offsets& offsets, OnMatch&& on_match) const {
+        const size_t n = _needle.size();
+        const size_t rows = offsets.size();
+        if (rows == 0) {
+            return;
+        }
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(chars.data());
+        const uint8_t* end = begin + offsets[rows - 1];
+        const uint8_t* pos = begin;
+        for (size_t row = 0; row < rows; ++row) {
+            const uint8_t* match = search(pos, end);
+            if (match == end) {
+                return;
+            }
+            size_t match_offset = match - begin;
+            // the row of the match is the first one ending after it
+            row = std::upper_bound(offsets.begin() + row, offsets.end(), match_offset) -
+                  offsets.begin();
+            size_t row_begin = offsets[row - 1];
+            // the string of a row is followed by a terminating zero. A match crossing the end of
+            // the row means the rest of the row doesn't contain the needle either.
+            if (match_offset + n <= offsets[row] - 1) {
+                on_match(row, match_offset - row_begin);
+            }
+            pos = begin + offsets[row];
+        }
+    }
+
+private:
+    std::string_view _needle;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,70 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// Computes the rows of the blocks of an operator by the average width of the rows observed so
+// far, to get close to a preferred block size in bytes: narrow rows get blocks of up to
+// `max_rows` rows, and wide rows get blocks of fewer rows than the batch size, which keeps a block
+// in the caches.
+class AdaptiveBlockSize {
+public:
+    // `preferred_bytes` <= 0 disables the tuning, rows() is always `batch_size`.
+    AdaptiveBlockSize(size_t batch_size, int64_t preferred_bytes, size_t max_rows)
+            : _preferred_bytes(std::max<int64_t>(preferred_bytes, 0)),
+              _max_rows(std::max(max_rows, batch_size)),
+              _rows(std::max<size_t>(batch_size, 1)) {}
+
+    bool enabled() const { return _preferred_bytes > 0; }
+
+    void observe(size_t rows, size_t bytes) {
+        if (!enabled() || rows == 0) {
+            return;
+        }
+        _observed_rows += rows;
+        _observed_bytes += bytes;
+        size_t row_bytes = std::max<size_t>(_observed_bytes / _observed_rows, 1);
+        _rows = std::clamp<size_t>(_preferred_bytes / row_bytes, 1, _max_rows);
+        // halve the history to follow the width of the later rows
+        if (_observed_rows > _max_rows * 16) {
+            _observed_rows /= 2;
+            _observed_bytes /= 2;
+        }
+    }
+
+    void observe(const Block& block) { observe(block.rows(), block.bytes()); }
+
+    // the target rows of the next block
+    size_t rows() const { return _rows; }
+
+private:
+    const size_t _preferred_bytes;
+    const size_t _max_rows;
+    size_t _rows;
+    size_t _observed_rows = 0;
+    size_t _observed_bytes = 0;
+};
+
+} // namespace doris::vectorized
@@ -28,7 +28,9 @@
 #include <iterator>
 #include <memory>
 
+#include "common/config.h"
 #include "common/status.h"
+#include "olap/rowset/segment_v2/bitshuffle_wrapper.h"
 #include "runtime/descriptors.h"
 #include "runtime/row_batch.h"
 #include "runtime/tuple.h"
@@ -45,6 +47,7 @@
 #include "vec/common/exception.h"
 #include "vec/common/string_ref.h"
 #include "vec/common/typeid_cast.h"
+#include "vec/common/unaligned.h"
 #include "vec/data_types/data_type_bitmap.h"
 #include "vec/data_types/data_type_date.h"
 #include "vec/data_types/data_type_date_time.h"
@@ -74,7 +77,43 @@ Block::Block(const std::vector<SlotDescriptor*>& slots, size_t block_size) {
     }
 }
 
+namespace {
+
+// Whether the values of the column can be encoded by a codec of PColumnMeta. They are the tail
+// of the serialized column: row num | values of a number or a decimal column, and
+// row num | null map | row num | values of a nullable one.
+bool is_fixed_width_values(const DataTypePtr& type) {
+    return remove_nullable(type)->is_value_represented_by_number();
+}
+
+size_t values_header_bytes(const DataTypePtr& type, uint32_t row_num) {
+    return type->is_nullable() ? sizeof(uint32_t) * 2 + row_num * sizeof(bool) : sizeof(uint32_t);
+}
+
+// Deserializes a column whose values are encoded by bitshuffle + lz4 into `column`, returns the
+// position after its data.
+const char* deserialize_bitshuffle_column(const DataTypePtr& type, const char* buf,
+                                          IColumn* column) {
+    uint32_t row_num = unaligned_load<uint32_t>(buf);
+    size_t header_bytes = values_header_bytes(type, row_num);
+    size_t value_width = remove_nullable(type)->get_size_of_value_in_memory();
+    std::string plain(header_bytes + row_num * value_width, '\0');
+    memcpy(plain.data(), buf, header_bytes);
+    int64_t encoded_bytes = bitshuffle::decompress_lz4(
+            const_cast<char*>(buf + header_bytes), plain.data() + header_bytes, row_num,
+            value_width, 0);
+    DCHECK(encoded_bytes >= 0) << "bitshuffle::decompress_lz4 failed: " << encoded_bytes;
+    type->deserialize(plain.data(), column);
+    return buf + header_bytes + encoded_bytes;
+}
+
+} // namespace
+
 Block::Block(const PBlock& pblock) {
+    deserialize(pblock);
+}
+
+void Block::deserialize(const PBlock& pblock) {
     const char* buf = nullptr;
     std::string compression_scratch;
     if (pblock.compressed()) {
@@ -94,10 +133,27 @@ Block::Block(const PBlock& pblock) {
         buf = pblock.column_values().data();
     }
 
-    for (const auto& pcol_meta : pblock.column_metas()) {
+    // the columns of the same types are reused with their capacity, unless they are shared
+    ColumnsWithTypeAndName old_data;
+    old_data.swap(data);
+    index_by_name.clear();
+    row_selection.clear();
+    for (int i = 0; i < pblock.column_metas_size(); ++i) {
+        const auto& pcol_meta = pblock.column_metas(i);
         DataTypePtr type = DataTypeFactory::instance().create_data_type(pcol_meta);
-        MutableColumnPtr data_column = type->create_column();
-        buf = type->deserialize(buf, data_column.get());
+        MutableColumnPtr data_column;
+        if (i < old_data.size() && old_data[i].column->use_count() == 1 &&
+            !is_column_const(*old_data[i].column) && old_data[i].type->equals(*type)) {
+            data_column = (*std::move(old_data[i].column)).assume_mutable();
+            data_column->clear();
+        } else {
+            data_column = type->create_column();
+        }
+        if (pcol_meta.codec() == PColumnMeta::BITSHUFFLE_LZ4) {
+            buf = deserialize_bitshuffle_column(type, buf, data_column.get());
+        } else {
+            buf = type->deserialize(buf, data_column.get());
+        }
         data.emplace_back(data_column->get_ptr(), type, pcol_meta.name());
     }
     initialize_index_by_name();
@@ -547,6 +603,7 @@ void Block::clear() {
     info = BlockInfo();
     data.clear();
     index_by_name.clear();
+    row_selection.clear();
 }
 
 void Block::clear_column_data(int column_size) noexcept {
@@ -558,20 +615,27 @@ void Block::clear_column_data(int column_size) noexcept {
         }
     }
     for (auto& d : data) {
-        DCHECK(d.column->use_count() == 1);
-        (*std::move(d.column)).assume_mutable()->clear();
+        // a column passed through by pointer is still referred by the node producing it
+        if (d.column->use_count() == 1) {
+            (*std::move(d.column)).assume_mutable()->clear();
+        } else {
+            d.column = d.column->clone_empty();
+        }
     }
+    row_selection.clear();
 }
 
 void Block::swap(Block& other) noexcept {
     std::swap(info, other.info);
     data.swap(other.data);
     index_by_name.swap(other.index_by_name);
+    row_selection.swap(other.row_selection);
 }
 
 void Block::swap(Block&& other) noexcept {
     clear();
     data = std::move(other.data);
+    row_selection = std::move(other.row_selection);
     initialize_index_by_name();
 }
 
@@ -583,23 +647,41 @@ void Block::update_hash(SipHash& hash) const {
     }
 }
 
-void filter_block_internal(Block* block, const IColumn::Filter& filter, uint32_t column_to_keep) {
-    auto count = count_bytes_in_filter(filter);
+void filter_block_internal(Block* block, const IColumn::Filter& filter, uint32_t column_to_keep,
+                           bool defer_materialize) {
+    const IColumn::Filter* selected = &filter;
+    IColumn::Filter combined;
+    if (block->has_selection()) {
+        combined = block->selection();
+        auto* __restrict combined_data = combined.data();
+        const auto* __restrict filter_data = filter.data();
+        for (size_t i = 0; i < combined.size(); ++i) {
+            combined_data[i] &= filter_data[i];
+        }
+        selected = &combined;
+        block->clear_selection();
+    }
+
+    auto count = count_bytes_in_filter(*selected);
     if (count == 0) {
         for (size_t i = 0; i < column_to_keep; ++i) {
             std::move(*block->get_by_position(i).column).mutate()->clear();
         }
-    } else {
-        if (count != block->rows()) {
-            for (size_t i = 0; i < column_to_keep; ++i) {
-                block->get_by_position(i).column =
-                        block->get_by_position(i).column->filter(filter, 0);
-            }
+    } else if (count != block->rows()) {
+        if (defer_materialize && count >= block->rows() * config::block_selection_min_density) {
+            block->set_selection(selected == &combined ? std::move(combined)
+                                                       : IColumn::Filter(filter));
+            return;
+        }
+        for (size_t i = 0; i < column_to_keep; ++i) {
+            block->get_by_position(i).column =
+                    block->get_by_position(i).column->filter(*selected, 0);
         }
     }
 }
 
-Status Block::filter_block(Block* block, int filter_column_id, int column_to_keep) {
+Status Block::filter_block(Block* block, int filter_column_id, int column_to_keep,
+                           bool defer_materialize) {
     ColumnPtr filter_column = block->get_by_position(filter_column_id).column;
     if (auto* nullable_column = check_and_get_column<ColumnNullable>(*filter_column)) {
         ColumnPtr nested_column = nullable_column->get_nested_column_ptr();
@@ -623,27 +705,44 @@ Status Block::filter_block(Block* block, int filter_column_id, int column_to_kee
         for (size_t i = 0; i < size; ++i) {
             filter_data[i] &= !null_map[i];
         }
-        filter_block_internal(block, filter, column_to_keep);
+        filter_block_internal(block, filter, column_to_keep, defer_materialize);
     } else if (auto* const_column = check_and_get_column<ColumnConst>(*filter_column)) {
         bool ret = const_column->get_bool(0);
         if (!ret) {
             for (size_t i = 0; i < column_to_keep; ++i) {
                 std::move(*block->get_by_position(i).column).mutate()->clear();
             }
+            block->clear_selection();
+        } else if (!defer_materialize) {
+            block->materialize_selection();
         }
     } else {
         const IColumn::Filter& filter =
                 assert_cast<const doris::vectorized::ColumnVector<UInt8>&>(*filter_column)
                         .get_data();
-        filter_block_internal(block, filter, column_to_keep);
+        filter_block_internal(block, filter, column_to_keep, defer_materialize);
     }
 
     erase_useless_column(block, column_to_keep);
     return Status::OK();
 }
 
+size_t Block::selected_rows() const {
+    return has_selection() ? count_bytes_in_filter(row_selection) : rows();
+}
+
+void Block::materialize_selection() {
+    if (!has_selection()) {
+        return;
+    }
+    IColumn::Filter filter;
+    filter.swap(row_selection);
+    filter_block_internal(this, filter, columns(), false);
+}
+
 Status Block::serialize(PBlock* pblock, size_t* uncompressed_bytes, size_t* compressed_bytes,
-                        std::string* allocated_buf) const {
+                        std::string* allocated_buf, bool allow_compress,
+                        PColumnMeta::Codec codec) const {
     // calc uncompressed size for allocation
     size_t content_uncompressed_size = 0;
     for (const auto& c : *this) {
@@ -657,13 +756,35 @@ Status Block::serialize(PBlock* pblock, size_t* uncompressed_bytes, size_t* comp
     // when data type is HLL, content_uncompressed_size maybe larger than real size.
     allocated_buf->resize(content_uncompressed_size);
     char* buf = allocated_buf->data();
-    for (const auto& c : *this) {
+    std::string encode_scratch;
+    for (size_t i = 0; i < data.size(); ++i) {
+        const auto& c = data[i];
         buf = c.type->serialize(*(c.column), buf);
+        if (codec != PColumnMeta::BITSHUFFLE_LZ4 || !is_fixed_width_values(c.type)) {
+            continue;
+        }
+        // the values are replaced by their encoding if it's smaller
+        size_t row_num = c.column->size();
+        size_t value_width = remove_nullable(c.type)->get_size_of_value_in_memory();
+        char* values = buf - row_num * value_width;
+        encode_scratch.resize(bitshuffle::compress_lz4_bound(row_num, value_width, 0));
+        int64_t encoded_bytes = bitshuffle::compress_lz4(values, encode_scratch.data(), row_num,
+                                                         value_width, 0);
+        if (encoded_bytes >= 0 && static_cast<size_t>(encoded_bytes) < row_num * value_width) {
+            memcpy(values, encode_scratch.data(), encoded_bytes);
+            buf = values + encoded_bytes;
+            pblock->mutable_column_metas(i)->set_codec(PColumnMeta::BITSHUFFLE_LZ4);
+        }
+    }
+    if (codec != PColumnMeta::PLAIN) {
+        content_uncompressed_size = buf - allocated_buf->data();
+        allocated_buf->resize(content_uncompressed_size);
     }
     *uncompressed_bytes = content_uncompressed_size;
+    *compressed_bytes = content_uncompressed_size;
 
     // compress
-    if (config::compress_rowbatches && content_uncompressed_size > 0) {
+    if (allow_compress && config::compress_rowbatches && content_uncompressed_size > 0) {
         // Try compressing the content to compression_scratch,
         // swap if compressed data is smaller
         std::string compression_scratch;
@@ -680,8 +801,6 @@ Status Block::serialize(PBlock* pblock, size_t* uncompressed_bytes, size_t* comp
             allocated_buf->swap(compression_scratch);
             pblock->set_compressed(true);
             *compressed_bytes = compressed_size;
-        } else {
-            *compressed_bytes = content_uncompressed_size;
         }
 
         VLOG_ROW << "uncompressed size: " << content_uncompressed_size
@@ -64,6 +64,8 @@ private:
 
     Container data;
     IndexByName index_by_name;
+    // the rows selected by the deferred filters, empty if all the rows are selected
+    IColumn::Filter row_selection;
 
 public:
     BlockInfo info;
@@ -72,6 +74,10 @@ public:
     Block(std::initializer_list<ColumnWithTypeAndName> il);
     Block(const ColumnsWithTypeAndName& data_);
     Block(const PBlock& pblock);
+
+    // Replace the content of the block by the deserialized pblock, the columns of the same types
+    // are reused with their capacity.
+    void deserialize(const PBlock& pblock);
     Block(const std::vector<SlotDescriptor*>& slots, size_t block_size);
 
     /// insert the column at the specified position
@@ -227,6 +233,7 @@ public:
 
     // Default column size = -1 means clear all column in block
     // Else clear column [0, column_size) delete column [column_size, data.size)
+    // The columns shared with other blocks are replaced by empty columns instead of cleared.
     void clear_column_data(int column_size = -1) noexcept;
 
     bool mem_reuse() { return !data.empty(); }
@@ -242,7 +249,24 @@ public:
     /** Get block data in string. */
     std::string dump_data(size_t begin = 0, size_t row_limit = 100) const;
 
-    static Status filter_block(Block* block, int filter_conlumn_id, int column_to_keep);
+    // Filter the rows of `block` by the column `filter_conlumn_id` and the selection of the
+    // block. If `defer_materialize` is true and the filter keeps at least
+    // block_selection_min_density of the rows, the columns are not filtered, the block keeps
+    // the selected rows in its selection instead, so the filters applied back to back and the
+    // consumers which skip the rows not selected only pay for one copy of the rows, or none.
+    static Status filter_block(Block* block, int filter_conlumn_id, int column_to_keep,
+                               bool defer_materialize = false);
+
+    // The deferred selection of the block, the columns still hold all the rows. A consumer
+    // either skips the rows not selected by it or calls materialize_selection() first.
+    bool has_selection() const { return !row_selection.empty(); }
+    const IColumn::Filter& selection() const { return row_selection; }
+    void set_selection(IColumn::Filter&& selection) { row_selection = std::move(selection); }
+    void clear_selection() { row_selection.clear(); }
+    // the rows of the block after the selection is materialized
+    size_t selected_rows() const;
+    // Filter the columns by the selection and clear the selection.
+    void materialize_selection();
 
     static void erase_useless_column(Block* block, int column_to_keep) {
         for (int i = block->columns() - 1; i >= column_to_keep; --i) {
@@ -250,9 +274,12 @@ public:
         }
     }
 
-    // serialize block to PBlock
+    // serialize block to PBlock, the column values are compressed by snappy if
+    // `allow_compress` and config::compress_rowbatches are both true. The values of the
+    // fixed-width columns are encoded by `codec` first.
     Status serialize(PBlock* pblock, size_t* uncompressed_bytes, size_t* compressed_bytes,
-                     std::string* allocated_buf) const;
+                     std::string* allocated_buf, bool allow_compress = true,
+                     PColumnMeta::Codec codec = PColumnMeta::PLAIN) const;
 
     // serialize block to PRowbatch
     void serialize(RowBatch*, const RowDescriptor&);
@@ -0,0 +1,282 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/normalized_sort_keys.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "gutil/endian.h"
+#include "vec/columns/column_const.h"
+#include "vec/columns/column_decimal.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+template <size_t size>
+struct UnsignedOfSize;
+template <>
+struct UnsignedOfSize<1> {
+    using type = uint8_t;
+};
+template <>
+struct UnsignedOfSize<2> {
+    using type = uint16_t;
+};
+template <>
+struct UnsignedOfSize<4> {
+    using type = uint32_t;
+};
+template <>
+struct UnsignedOfSize<8> {
+    using type = uint64_t;
+};
+template <>
+struct UnsignedOfSize<16> {
+    using type = unsigned __int128;
+};
+
+inline uint8_t to_big_endian(uint8_t value) {
+    return value;
+}
+inline uint16_t to_big_endian(uint16_t value) {
+    return BigEndian::FromHost16(value);
+}
+inline uint32_t to_big_endian(uint32_t value) {
+    return BigEndian::FromHost32(value);
+}
+inline uint64_t to_big_endian(uint64_t value) {
+    return BigEndian::FromHost64(value);
+}
+inline unsigned __int128 to_big_endian(unsigned __int128 value) {
+    return BigEndian::FromHost128(value);
+}
+
+// Call `func` with the data of the column if it's a column of numbers, and return true.
+template <typename Func>
+bool with_fixed_column_data(const IColumn& column, Func&& func) {
+#define DISPATCH_VECTOR(TYPE)                                                       \
+    if (const auto* typed = check_and_get_column<ColumnVector<TYPE>>(column)) {     \
+        func(typed->get_data().data());                                             \
+        return true;                                                                \
+    }
+#define DISPATCH_DECIMAL(TYPE)                                                       \
+    if (const auto* typed = check_and_get_column<ColumnDecimal<TYPE>>(column)) {     \
+        func(reinterpret_cast<const TYPE::NativeType*>(typed->get_data().data()));   \
+        return true;                                                                 \
+    }
+    DISPATCH_VECTOR(UInt8)
+    DISPATCH_VECTOR(UInt16)
+    DISPATCH_VECTOR(UInt32)
+    DISPATCH_VECTOR(UInt64)
+    DISPATCH_VECTOR(Int8)
+    DISPATCH_VECTOR(Int16)
+    DISPATCH_VECTOR(Int32)
+    DISPATCH_VECTOR(Int64)
+    DISPATCH_VECTOR(Int128)
+    DISPATCH_VECTOR(Float32)
+    DISPATCH_VECTOR(Float64)
+    DISPATCH_DECIMAL(Decimal32)
+    DISPATCH_DECIMAL(Decimal64)
+    DISPATCH_DECIMAL(Decimal128)
+#undef DISPATCH_VECTOR
+#undef DISPATCH_DECIMAL
+    return false;
+}
+
+} // namespace
+
+int64_t NormalizedSortKeys::column_key_size(const IColumn& column, size_t string_prefix) {
+    if (check_and_get_column<ColumnConst>(column)) {
+        return 0;
+    }
+    if (const auto* nullable = check_and_get_column<ColumnNullable>(column)) {
+        int64_t nested_size = column_key_size(nullable->get_nested_column(), string_prefix);
+        return nested_size < 0 ? -1 : nested_size + 1;
+    }
+    if (check_and_get_column<ColumnString>(column)) {
+        return string_prefix + 1;
+    }
+    int64_t size = -1;
+    with_fixed_column_data(column, [&](const auto* data) { size = sizeof(*data); });
+    return size;
+}
+
+int64_t NormalizedSortKeys::key_size(const ColumnsWithSortDescriptions& columns,
+                                     size_t string_prefix) {
+    int64_t size = 0;
+    for (const auto& [column, desc] : columns) {
+        int64_t column_size = column_key_size(*column, string_prefix);
+        if (column_size < 0) {
+            return -1;
+        }
+        size += column_size;
+    }
+    return size;
+}
+
+NormalizedSortKeys::NormalizedSortKeys(const ColumnsWithSortDescriptions& columns,
+                                       size_t string_prefix)
+        : _rows(columns.empty() ? 0 : columns[0].first->size()), _string_prefix(string_prefix) {
+    DCHECK_GE(key_size(columns, string_prefix), 0);
+    _key_size = key_size(columns, string_prefix);
+    _keys.resize_fill(_rows * _key_size, 0);
+
+    size_t offset = 0;
+    for (const auto& [column, desc] : columns) {
+        size_t column_size = column_key_size(*column, string_prefix);
+        if (column_size == 0) {
+            continue;
+        }
+        encode_column(*column, desc.nulls_direction, offset);
+        if (desc.direction < 0) {
+            for (size_t row = 0; row < _rows; ++row) {
+                UInt8* key = _keys.data() + row * _key_size + offset;
+                for (size_t i = 0; i < column_size; ++i) {
+                    key[i] = ~key[i];
+                }
+            }
+        }
+        offset += column_size;
+    }
+}
+
+void NormalizedSortKeys::radix_sort(IColumn::Permutation& perm) const {
+    DCHECK(all_exact());
+    perm.resize(_rows);
+    for (size_t i = 0; i < _rows; ++i) {
+        perm[i] = i;
+    }
+    if (_rows < 2) {
+        return;
+    }
+
+    // the bytes equal in all the keys, e.g. the high bytes of small integers, keep the order
+    std::vector<UInt8> varying(_key_size, 0);
+    const UInt8* first_key = key(0);
+    for (size_t row = 1; row < _rows; ++row) {
+        const UInt8* row_key = key(row);
+        for (size_t i = 0; i < _key_size; ++i) {
+            varying[i] |= row_key[i] ^ first_key[i];
+        }
+    }
+
+    IColumn::Permutation sorted(_rows);
+    PaddedPODArray<UInt8> bytes(_rows);
+    for (size_t i = _key_size; i-- > 0;) {
+        if (varying[i] == 0) {
+            continue;
+        }
+        size_t offsets[257] = {0};
+        for (size_t j = 0; j < _rows; ++j) {
+            bytes[j] = key(perm[j])[i];
+            ++offsets[bytes[j] + 1];
+        }
+        for (size_t byte = 1; byte < 257; ++byte) {
+            offsets[byte] += offsets[byte - 1];
+        }
+        for (size_t j = 0; j < _rows; ++j) {
+            sorted[offsets[bytes[j]]++] = perm[j];
+        }
+        perm.swap(sorted);
+    }
+}
+
+void NormalizedSortKeys::encode_column(const IColumn& column, int nulls_direction,
+                                       size_t offset) {
+    if (const auto* nullable = check_and_get_column<ColumnNullable>(column)) {
+        encode_column(nullable->get_nested_column(), nulls_direction, offset + 1);
+        const size_t column_size = column_key_size(column, _string_prefix);
+        const auto& null_map = nullable->get_null_map_data();
+        const UInt8 null_byte = nulls_direction > 0 ? 1 : 0;
+        for (size_t row = 0; row < _rows; ++row) {
+            UInt8* key = _keys.data() + row * _key_size + offset;
+            if (null_map[row]) {
+                key[0] = null_byte;
+                memset(key + 1, 0, column_size - 1);
+                if (!_exact.empty()) {
+                    _exact[row] = 1;
+                }
+            } else {
+                key[0] = 1 - null_byte;
+            }
+        }
+        return;
+    }
+
+    if (const auto* string_column = check_and_get_column<ColumnString>(column)) {
+        if (_exact.empty()) {
+            _exact.resize(_rows, 1);
+        }
+        for (size_t row = 0; row < _rows; ++row) {
+            UInt8* key = _keys.data() + row * _key_size + offset;
+            StringRef value = string_column->get_data_at(row);
+            memcpy(key, value.data, std::min(value.size, _string_prefix));
+            key[_string_prefix] = std::min(value.size, _string_prefix + 1);
+            _exact[row] &= value.size <= _string_prefix;
+        }
+        return;
+    }
+
+    bool encoded = with_fixed_column_data(column, [&](const auto* data) {
+        using T = std::decay_t<decltype(*data)>;
+        if constexpr (std::is_floating_point_v<T>) {
+            encode_floats(data, nulls_direction, offset);
+        } else {
+            encode_integers(data, offset);
+        }
+    });
+    DCHECK(encoded) << column.get_name();
+}
+
+template <typename T>
+void NormalizedSortKeys::encode_integers(const T* data, size_t offset) {
+    using Unsigned = typename UnsignedOfSize<sizeof(T)>::type;
+    for (size_t row = 0; row < _rows; ++row) {
+        Unsigned value = static_cast<Unsigned>(data[row]);
+        if constexpr (std::is_signed_v<T> || std::is_same_v<T, Int128>) {
+            value ^= static_cast<Unsigned>(1) << (sizeof(T) * CHAR_BIT - 1);
+        }
+        value = to_big_endian(value);
+        memcpy(_keys.data() + row * _key_size + offset, &value, sizeof(value));
+    }
+}
+
+template <typename T>
+void NormalizedSortKeys::encode_floats(const T* data, int nan_direction, size_t offset) {
+    using Unsigned = typename UnsignedOfSize<sizeof(T)>::type;
+    constexpr Unsigned sign_bit = static_cast<Unsigned>(1) << (sizeof(T) * CHAR_BIT - 1);
+    for (size_t row = 0; row < _rows; ++row) {
+        Unsigned value;
+        if (std::isnan(data[row])) {
+            value = nan_direction > 0 ? ~static_cast<Unsigned>(0) : 0;
+        } else {
+            // -0.0 is equal to 0.0
+            T number = data[row] == 0 ? 0 : data[row];
+            memcpy(&value, &number, sizeof(value));
+            value = (value & sign_bit) ? ~value : value ^ sign_bit;
+        }
+        value = to_big_endian(value);
+        memcpy(_keys.data() + row * _key_size + offset, &value, sizeof(value));
+    }
+}
+
+} // namespace doris::vectorized
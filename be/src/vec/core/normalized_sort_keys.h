@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "vec/common/pod_array.h"
+#include "vec/core/sort_block.h"
+
+namespace doris::vectorized {
+
+/** The sort columns of the rows of a block encoded into fixed-size byte strings, which compare
+  * by memcmp in the same order as the rows compare by compare_at under the sort description,
+  * so that sorting on several columns doesn't call a virtual compare_at for each column.
+  * The values are encoded like the short keys of KeyCoder:
+  *  - an integer in big endian with the sign bit flipped;
+  *  - a float as the integer of its bits, with all the bits flipped if it's negative, otherwise
+  *    the sign bit flipped. NaN is the greatest or the least by the nan direction;
+  *  - a string as its first `string_prefix` bytes padded by zeros followed by its length, up to
+  *    `string_prefix + 1`, so two strings no longer than the prefix have equal keys only if
+  *    they are equal;
+  *  - a nullable value with a leading byte ordering NULL by the nulls direction, and all zeros
+  *    as the value of NULL.
+  * All the bytes of a column in descending order are flipped. A const column is not encoded.
+  */
+class NormalizedSortKeys {
+public:
+    /// The size of the key of a row, -1 if some sort column can't be encoded.
+    static int64_t key_size(const ColumnsWithSortDescriptions& columns, size_t string_prefix);
+
+    NormalizedSortKeys(const ColumnsWithSortDescriptions& columns, size_t string_prefix);
+
+    /// Less than zero, zero or greater than zero if the key of row a is less than, equal to or
+    /// greater than the key of row b.
+    int compare(size_t a, size_t b) const { return memcmp(key(a), key(b), _key_size); }
+
+    /// Whether the key of the row is equal to another key only if the rows are equal on the
+    /// sort columns, false if a string of the row is longer than the prefix.
+    bool is_exact(size_t row) const { return _exact.empty() || _exact[row]; }
+
+    /// Whether the keys of all the rows are exact, so the rows can be sorted by the keys alone.
+    bool all_exact() const {
+        return std::all_of(_exact.begin(), _exact.end(), [](UInt8 exact) { return exact; });
+    }
+
+    /// Sort the rows by the keys with a LSD radix sort, one stable counting sort for each byte
+    /// from the last one, skipping the bytes equal in all the keys. Only if all_exact().
+    void radix_sort(IColumn::Permutation& perm) const;
+
+    const UInt8* key(size_t row) const { return _keys.data() + row * _key_size; }
+
+private:
+    static int64_t column_key_size(const IColumn& column, size_t string_prefix);
+
+    // Encode the column into the bytes of the keys from `offset`, in ascending order.
+    void encode_column(const IColumn& column, int nulls_direction, size_t offset);
+
+    template <typename T>
+    void encode_integers(const T* data, size_t offset);
+
+    template <typename T>
+    void encode_floats(const T* data, int nan_direction, size_t offset);
+
+    size_t _rows;
+    size_t _string_prefix;
+    size_t _key_size = 0;
+    PaddedPODArray<UInt8> _keys;
+    // empty if there is no string sort column
+    std::vector<UInt8> _exact;
+};
+
+} // namespace doris::vectorized
@@ -22,8 +22,10 @@
 
 #include <pdqsort.h>
 
+#include "common/config.h"
 #include "vec/columns/column_string.h"
 #include "vec/common/typeid_cast.h"
+#include "vec/core/normalized_sort_keys.h"
 
 namespace doris::vectorized {
 
@@ -74,6 +76,25 @@ struct PartialSortingLess {
     }
 };
 
+/// Compare the normalized keys of the rows, and the sort columns only if the keys are equal but
+/// some string is longer than the prefix in the keys.
+struct NormalizedSortingLess {
+    const NormalizedSortKeys& keys;
+    PartialSortingLess less;
+
+    NormalizedSortingLess(const NormalizedSortKeys& keys_,
+                          const ColumnsWithSortDescriptions& columns_)
+            : keys(keys_), less(columns_) {}
+
+    bool operator()(size_t a, size_t b) const {
+        int res = keys.compare(a, b);
+        if (res != 0) {
+            return res < 0;
+        }
+        return !(keys.is_exact(a) && keys.is_exact(b)) && less(a, b);
+    }
+};
+
 struct PartialSortingLessWithCollation {
     const ColumnsWithSortDescriptions& columns;
 
@@ -101,6 +122,17 @@ struct PartialSortingLessWithCollation {
     }
 };
 
+// the fewer rows are sorted by comparisons, the same threshold as ColumnVector::get_permutation()
+static constexpr size_t RADIX_SORT_MIN_ROWS = 256;
+
+template <typename Less>
+static void sort_permutation(IColumn::Permutation& perm, UInt64 limit, const Less& less) {
+    if (limit)
+        std::partial_sort(perm.begin(), perm.begin() + limit, perm.end(), less);
+    else
+        pdqsort(perm.begin(), perm.end(), less);
+}
+
 void sort_block(Block& block, const SortDescription& description, UInt64 limit) {
     if (!block) return;
 
@@ -128,13 +160,19 @@ void sort_block(Block& block, const SortDescription& description, UInt64 limit)
 
         ColumnsWithSortDescriptions columns_with_sort_desc =
                 get_columns_with_sort_description(block, description);
-        {
-            PartialSortingLess less(columns_with_sort_desc);
-
-            if (limit)
-                std::partial_sort(perm.begin(), perm.begin() + limit, perm.end(), less);
-            else
-                pdqsort(perm.begin(), perm.end(), less);
+        const size_t string_prefix = config::vec_normalized_sort_key_string_prefix;
+        if (config::enable_vec_normalized_sort_keys &&
+            NormalizedSortKeys::key_size(columns_with_sort_desc, string_prefix) >= 0) {
+            NormalizedSortKeys keys(columns_with_sort_desc, string_prefix);
+            if (config::enable_vec_radix_sort && limit == 0 && size >= RADIX_SORT_MIN_ROWS &&
+                keys.all_exact()) {
+                keys.radix_sort(perm);
+            } else {
+                sort_permutation(perm, limit,
+                                 NormalizedSortingLess(keys, columns_with_sort_desc));
+            }
+        } else {
+            sort_permutation(perm, limit, PartialSortingLess(columns_with_sort_desc));
         }
 
         size_t columns = block.columns();
@@ -225,4 +225,98 @@ struct SortBlockCursor {
     bool operator<(const SortBlockCursor& rhs) const { return less_at(rhs, impl->rows - 1) == 1; }
 };
 
+/** Loser tree of the cursors of K sorted runs, the winner is the cursor with the least current
+  * row. Replaying the winner after it moves costs log K comparisons, about half of a binary
+  * heap. The exhausted cursors lose to all the others.
+  */
+class SortCursorLoserTree {
+public:
+    SortCursorLoserTree() = default;
+
+    /// The cursors without rows are exhausted.
+    void init(std::vector<SortCursorImpl*> cursors) {
+        _cursors = std::move(cursors);
+        _exhausted.resize(_cursors.size());
+        _num_live = 0;
+        for (size_t i = 0; i < _cursors.size(); ++i) {
+            _exhausted[i] = _cursors[i]->empty();
+            _num_live += !_exhausted[i];
+        }
+
+        const size_t k = _cursors.size();
+        _tree.assign(std::max<size_t>(k, 1), 0);
+        if (k <= 1) {
+            return;
+        }
+        // winners[n] is the winner of the subtree of node n, the leaf of cursor i is node k + i
+        std::vector<size_t> winners(2 * k);
+        for (size_t i = 0; i < k; ++i) {
+            winners[k + i] = i;
+        }
+        for (size_t node = k - 1; node > 0; --node) {
+            size_t lhs = winners[2 * node];
+            size_t rhs = winners[2 * node + 1];
+            bool lhs_wins = less(lhs, rhs);
+            winners[node] = lhs_wins ? lhs : rhs;
+            _tree[node] = lhs_wins ? rhs : lhs;
+        }
+        _tree[0] = winners[1];
+    }
+
+    /// The number of the cursors not exhausted.
+    size_t num_live() const { return _num_live; }
+
+    bool empty() const { return _num_live == 0; }
+
+    SortCursorImpl* winner() const { return _cursors[_tree[0]]; }
+
+    /// The cursor with the least current row except the winner, nullptr if all the others are
+    /// exhausted. The rows of the winner not greater than its current row could be taken without
+    /// replaying the tree.
+    SortCursorImpl* runner_up() const {
+        const size_t k = _cursors.size();
+        size_t best = k;
+        for (size_t node = (k + _tree[0]) / 2; node > 0; node /= 2) {
+            size_t loser = _tree[node];
+            if (!_exhausted[loser] && (best == k || less(loser, best))) {
+                best = loser;
+            }
+        }
+        return best == k ? nullptr : _cursors[best];
+    }
+
+    /// Replay the winner after its position is moved, or after it's exhausted.
+    void update_winner(bool exhausted) {
+        const size_t k = _cursors.size();
+        size_t winner = _tree[0];
+        if (exhausted) {
+            _exhausted[winner] = true;
+            --_num_live;
+        }
+        for (size_t node = (k + winner) / 2; node > 0; node /= 2) {
+            if (less(_tree[node], winner)) {
+                std::swap(_tree[node], winner);
+            }
+        }
+        _tree[0] = winner;
+    }
+
+private:
+    /// The current row of cursor a is less than the one of cursor b, the lower index wins a tie.
+    bool less(size_t a, size_t b) const {
+        if (_exhausted[a] || _exhausted[b]) {
+            return !_exhausted[a] || (_exhausted[b] && a < b);
+        }
+        int res = SortCursor(_cursors[a]).greater_at(SortCursor(_cursors[b]), _cursors[a]->pos,
+                                                     _cursors[b]->pos);
+        return res < 0 || (res == 0 && a < b);
+    }
+
+    std::vector<SortCursorImpl*> _cursors;
+    std::vector<UInt8> _exhausted;
+    // _tree[0] is the winner, _tree[n] is the loser of node n
+    std::vector<size_t> _tree;
+    size_t _num_live = 0;
+};
+
 } // namespace doris::vectorized
@@ -54,6 +54,11 @@ std::string DataTypeDecimal<T>::to_string(const IColumn& column, size_t row_num)
 template <typename T>
 void DataTypeDecimal<T>::to_string(const IColumn& column, size_t row_num,
                                    BufferWritable& ostr) const {
+    if constexpr (!std::is_same_v<T, Decimal128>) {
+        auto str = to_string(column, row_num);
+        ostr.write(str.data(), str.size());
+        return;
+    }
     // TODO: Reduce the copy in std::string mem to ostr, like DataTypeNumber
     DecimalV2Value value = (DecimalV2Value)assert_cast<const ColumnType&>(
                                    *column.convert_to_full_column_if_const().get())
@@ -19,6 +19,7 @@
 // and modified by Doris
 
 #pragma once
+#include <algorithm>
 #include <cmath>
 
 #include "vec/columns/column_decimal.h"
@@ -105,9 +106,12 @@ public:
             LOG(FATAL) << fmt::format("Scale {} is out of bounds", scale);
         }
 
-        // Now, Doris only support precision:27, scale: 9
-        DCHECK(precision_ == 27);
-        DCHECK(scale_ == 9);
+        // Decimal128 is DecimalV2, its precision and scale are always 27 and 9. Decimal32 and
+        // Decimal64 are stored at their declared precisions and scales.
+        if constexpr (std::is_same_v<T, Decimal128>) {
+            DCHECK(precision_ == 27);
+            DCHECK(scale_ == 9);
+        }
     }
 
     const char* get_family_name() const override { return "Decimal"; }
@@ -193,30 +197,43 @@ private:
     const UInt32 scale;
 };
 
+/// The result of DecimalV2 (Decimal128) is always Decimal(27, 9). The result of Decimal32 and
+/// Decimal64 has the maximum precision of the result type, and the sum of the scales of the
+/// operands for multiply, or the maximum scale of them otherwise.
+template <typename T>
+const DataTypeDecimal<T> decimal_result_type(UInt32 scale_x, UInt32 scale_y, bool is_multiply) {
+    if constexpr (std::is_same_v<T, Decimal128>) {
+        return DataTypeDecimal<T>(max_decimal_precision<T>(), 9);
+    } else {
+        UInt32 scale = is_multiply ? scale_x + scale_y : std::max(scale_x, scale_y);
+        return DataTypeDecimal<T>(max_decimal_precision<T>(), scale);
+    }
+}
+
 template <typename T, typename U>
 typename std::enable_if_t<(sizeof(T) >= sizeof(U)), const DataTypeDecimal<T>> decimal_result_type(
         const DataTypeDecimal<T>& tx, const DataTypeDecimal<U>& ty, bool is_multiply,
         bool is_divide) {
-    return DataTypeDecimal<T>(max_decimal_precision<T>(), 9);
+    return decimal_result_type<T>(tx.get_scale(), ty.get_scale(), is_multiply);
 }
 
 template <typename T, typename U>
 typename std::enable_if_t<(sizeof(T) < sizeof(U)), const DataTypeDecimal<U>> decimal_result_type(
         const DataTypeDecimal<T>& tx, const DataTypeDecimal<U>& ty, bool is_multiply,
         bool is_divide) {
-    return DataTypeDecimal<U>(max_decimal_precision<U>(), 9);
+    return decimal_result_type<U>(tx.get_scale(), ty.get_scale(), is_multiply);
 }
 
 template <typename T, typename U>
 const DataTypeDecimal<T> decimal_result_type(const DataTypeDecimal<T>& tx, const DataTypeNumber<U>&,
                                              bool, bool) {
-    return DataTypeDecimal<T>(max_decimal_precision<T>(), 9);
+    return decimal_result_type<T>(tx.get_scale(), 0, false);
 }
 
 template <typename T, typename U>
 const DataTypeDecimal<U> decimal_result_type(const DataTypeNumber<T>&, const DataTypeDecimal<U>& ty,
                                              bool, bool) {
-    return DataTypeDecimal<U>(max_decimal_precision<U>(), 9);
+    return decimal_result_type<U>(0, ty.get_scale(), false);
 }
 
 template <typename T>
@@ -243,6 +260,15 @@ inline constexpr bool IsDataTypeDecimal<DataTypeDecimal<Decimal64>> = true;
 template <>
 inline constexpr bool IsDataTypeDecimal<DataTypeDecimal<Decimal128>> = true;
 
+/// Decimal32 and Decimal64 are computed on their native integers at their declared scales,
+/// unlike DecimalV2 (Decimal128) which is computed by DecimalV2Value.
+template <typename DataType>
+constexpr bool IsDataTypeDecimalNative = false;
+template <>
+inline constexpr bool IsDataTypeDecimalNative<DataTypeDecimal<Decimal32>> = true;
+template <>
+inline constexpr bool IsDataTypeDecimalNative<DataTypeDecimal<Decimal64>> = true;
+
 template <typename DataType>
 constexpr bool IsDataTypeDecimalOrNumber =
         IsDataTypeDecimal<DataType> || IsDataTypeNumber<DataType>;
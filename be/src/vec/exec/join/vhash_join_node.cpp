@@ -17,10 +17,16 @@
 
 #include "vec/exec/join/vhash_join_node.h"
 
+#include <numeric>
+
+#include "common/config.h"
+#include "fmt/format.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/exec_env.h"
 #include "runtime/mem_tracker.h"
 #include "runtime/runtime_filter_mgr.h"
 #include "util/defer_op.h"
+#include "vec/common/sip_hash.h"
 #include "vec/core/materialize_block.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/exprs/vexpr_context.h"
@@ -37,11 +43,18 @@ std::variant<std::false_type, std::true_type> static inline make_bool_variant(bo
 }
 
 using ProfileCounter = RuntimeProfile::Counter;
+
+// the rows inserted into the hash table between the checks of the cancellation, a build block
+// may have billions of rows
+static constexpr size_t BUILD_CANCEL_CHECK_ROWS = 65536;
+
 template <class HashTableContext, bool ignore_null, bool build_unique>
 struct ProcessHashTableBuild {
-    ProcessHashTableBuild(int rows, Block& acquired_block, ColumnRawPtrs& build_raw_ptrs,
-                          HashJoinNode* join_node, int batch_size, uint8_t offset)
-            : _rows(rows),
+    ProcessHashTableBuild(RuntimeState* state, int rows, Block& acquired_block,
+                          ColumnRawPtrs& build_raw_ptrs, HashJoinNode* join_node, int batch_size,
+                          uint8_t offset)
+            : _state(state),
+              _rows(rows),
               _skip_rows(0),
               _acquired_block(acquired_block),
               _build_raw_ptrs(build_raw_ptrs),
@@ -68,22 +81,43 @@ struct ProcessHashTableBuild {
         SCOPED_TIMER(_join_node->_build_table_insert_timer);
         hash_table_ctx.hash_table.reset_resize_timer();
 
-        vector<int>& inserted_rows = _join_node->_inserted_rows[&_acquired_block];
+        vector<int>& inserted_rows = _join_node->_shared_ctx->inserted_rows[&_acquired_block];
         if (has_runtime_filter) {
             inserted_rows.reserve(_batch_size);
         }
 
+        constexpr bool prefetchable =
+                ColumnsHashing::is_batch_prefetchable_v<KeyGetter,
+                                                        typename HashTableContext::HashTable>;
+        ColumnsHashing::BatchHashPrefetcher prefetcher(key_getter, hash_table_ctx.hash_table,
+                                                       _join_node->_shared_ctx->arena, _rows,
+                                                       config::vec_hash_table_prefetch_distance);
+
         for (size_t k = 0; k < _rows; ++k) {
+            if (UNLIKELY(k % BUILD_CANCEL_CHECK_ROWS == 0) && _state->is_cancelled()) {
+                return Status::Cancelled("Cancelled");
+            }
             if constexpr (ignore_null) {
                 if ((*null_map)[k]) {
                     continue;
                 }
             }
 
-            auto emplace_result =
-                    key_getter.emplace_key(hash_table_ctx.hash_table, k, _join_node->_arena);
-            if (k + 1 < _rows) {
-                key_getter.prefetch(hash_table_ctx.hash_table, k + 1, _join_node->_arena);
+            auto emplace_result = [&]() {
+                if constexpr (prefetchable) {
+                    return key_getter.emplace_key(hash_table_ctx.hash_table,
+                                                  prefetcher.get_hash(k), k,
+                                                  _join_node->_shared_ctx->arena);
+                } else {
+                    return key_getter.emplace_key(hash_table_ctx.hash_table, k,
+                                                  _join_node->_shared_ctx->arena);
+                }
+            }();
+            if constexpr (!prefetchable) {
+                if (k + 1 < _rows) {
+                    key_getter.prefetch(hash_table_ctx.hash_table, k + 1,
+                                        _join_node->_shared_ctx->arena);
+                }
             }
 
             if (emplace_result.is_inserted()) {
@@ -94,7 +128,8 @@ struct ProcessHashTableBuild {
             } else {
                 if constexpr (!build_unique) {
                     /// The first element of the list is stored in the value of the hash table, the rest in the pool.
-                    emplace_result.get_mapped().insert({k, _offset}, _join_node->_arena);
+                    emplace_result.get_mapped().insert({k, _offset},
+                                                       _join_node->_shared_ctx->arena);
                     if (has_runtime_filter) {
                         inserted_rows.push_back(k);
                     }
@@ -111,6 +146,7 @@ struct ProcessHashTableBuild {
     }
 
 private:
+    RuntimeState* _state;
     const int _rows;
     int _skip_rows;
     Block& _acquired_block;
@@ -134,10 +170,10 @@ struct ProcessRuntimeFilterBuild {
 
         RETURN_IF_ERROR(runtime_filter_slots->init(state, hash_table_ctx.hash_table.get_size()));
 
-        if (!runtime_filter_slots->empty() && !_join_node->_inserted_rows.empty()) {
+        if (!runtime_filter_slots->empty() && !_join_node->_shared_ctx->inserted_rows.empty()) {
             {
                 SCOPED_TIMER(_join_node->_push_compute_timer);
-                runtime_filter_slots->insert(_join_node->_inserted_rows);
+                runtime_filter_slots->insert(_join_node->_shared_ctx->inserted_rows);
             }
         }
         {
@@ -158,7 +194,7 @@ struct ProcessHashTableProbe {
             : _join_node(join_node),
               _batch_size(batch_size),
               _probe_rows(probe_rows),
-              _build_blocks(join_node->_build_blocks),
+              _build_blocks(join_node->_shared_ctx->blocks),
               _probe_block(join_node->_probe_block),
               _probe_index(join_node->_probe_index),
               _probe_raw_ptrs(join_node->_probe_columns),
@@ -269,6 +305,13 @@ struct ProcessHashTableProbe {
         constexpr auto probe_all = JoinOpType::value == TJoinOp::LEFT_OUTER_JOIN ||
                                    JoinOpType::value == TJoinOp::FULL_OUTER_JOIN;
 
+        constexpr bool prefetchable =
+                ColumnsHashing::is_batch_prefetchable_v<KeyGetter,
+                                                        typename HashTableContext::HashTable>;
+        ColumnsHashing::BatchHashPrefetcher prefetcher(key_getter, hash_table_ctx.hash_table,
+                                                       _arena, _probe_rows,
+                                                       config::vec_hash_table_prefetch_distance);
+
         {
             SCOPED_TIMER(_search_hashtable_timer);
             for (; _probe_index < _probe_rows;) {
@@ -283,8 +326,8 @@ struct ProcessHashTableProbe {
                                            ? decltype(key_getter.find_key(hash_table_ctx.hash_table,
                                                                           _probe_index,
                                                                           _arena)) {nullptr, false}
-                                           : key_getter.find_key(hash_table_ctx.hash_table,
-                                                                 _probe_index, _arena);
+                                           : _find_key<prefetchable>(key_getter, prefetcher,
+                                                                     hash_table_ctx.hash_table);
 
                 if constexpr (JoinOpType::value == TJoinOp::LEFT_ANTI_JOIN) {
                     if (!find_result.is_found()) {
@@ -309,9 +352,11 @@ struct ProcessHashTableProbe {
                             }
                         } else {
                             // prefetch is more useful while matching to multiple rows
-                            if (_probe_index + 2 < _probe_rows)
-                                key_getter.prefetch(hash_table_ctx.hash_table, _probe_index + 2,
-                                                    _arena);
+                            if constexpr (!prefetchable) {
+                                if (_probe_index + 2 < _probe_rows)
+                                    key_getter.prefetch(hash_table_ctx.hash_table,
+                                                        _probe_index + 2, _arena);
+                            }
 
                             for (auto it = mapped.begin(); it.ok(); ++it) {
                                 if constexpr (!is_right_semi_anti_join) {
@@ -390,6 +435,13 @@ struct ProcessHashTableProbe {
 
         int current_offset = 0;
 
+        constexpr bool prefetchable =
+                ColumnsHashing::is_batch_prefetchable_v<KeyGetter,
+                                                        typename HashTableContext::HashTable>;
+        ColumnsHashing::BatchHashPrefetcher prefetcher(key_getter, hash_table_ctx.hash_table,
+                                                       _arena, _probe_rows,
+                                                       config::vec_hash_table_prefetch_distance);
+
         for (; _probe_index < _probe_rows;) {
             // ignore null rows
             if constexpr (ignore_null) {
@@ -400,11 +452,12 @@ struct ProcessHashTableProbe {
             }
 
             auto last_offset = current_offset;
-            auto find_result =
-                    (*null_map)[_probe_index]
-                            ? decltype(key_getter.find_key(hash_table_ctx.hash_table, _probe_index,
-                                                           _arena)) {nullptr, false}
-                            : key_getter.find_key(hash_table_ctx.hash_table, _probe_index, _arena);
+            auto find_result = (*null_map)[_probe_index]
+                                       ? decltype(key_getter.find_key(hash_table_ctx.hash_table,
+                                                                      _probe_index,
+                                                                      _arena)) {nullptr, false}
+                                       : _find_key<prefetchable>(key_getter, prefetcher,
+                                                                 hash_table_ctx.hash_table);
 
             if (find_result.is_found()) {
                 auto& mapped = find_result.get_mapped();
@@ -492,7 +545,11 @@ struct ProcessHashTableProbe {
                     }
 
                     if (join_hit) {
-                        *visited_map[i] |= other_hit;
+                        // the visited flags are only read by full outer join, keep the hash
+                        // table of left outer join read-only as it may be shared
+                        if constexpr (JoinOpType::value == TJoinOp::FULL_OUTER_JOIN) {
+                            *visited_map[i] |= other_hit;
+                        }
                         filter_map.push_back(other_hit || !same_to_prev[i] ||
                                              (!column->get_bool(i - 1) && filter_map.back()));
                         // Here to keep only hit join conjunt and other join conjunt is true need to be output.
@@ -625,6 +682,18 @@ struct ProcessHashTableProbe {
     }
 
 private:
+    // look up the key of the row `_probe_index`, by its hash value hashed by batch if possible
+    template <bool prefetchable, typename KeyGetter, typename Prefetcher, typename HashTable>
+    ALWAYS_INLINE auto _find_key(KeyGetter& key_getter, Prefetcher& prefetcher,
+                                 HashTable& hash_table) {
+        if constexpr (prefetchable) {
+            return key_getter.find_key_with_hash(hash_table, prefetcher.get_hash(_probe_index),
+                                                 _probe_index, _arena);
+        } else {
+            return key_getter.find_key(hash_table, _probe_index, _arena);
+        }
+    }
+
     HashJoinNode* _join_node;
     const int _batch_size;
     const size_t _probe_rows;
@@ -660,14 +729,12 @@ HashJoinNode::HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const Descr
           _is_outer_join(_match_all_build || _match_all_probe),
           _hash_output_slot_ids(tnode.hash_join_node.__isset.hash_output_slot_ids
                                         ? tnode.hash_join_node.hash_output_slot_ids
-                                        : std::vector<SlotId> {}) {
+                                        : std::vector<SlotId> {}),
+          _shared_ctx(std::make_shared<SharedHashTableContext>()),
+          _is_broadcast_join(tnode.hash_join_node.__isset.is_broadcast_join &&
+                             tnode.hash_join_node.is_broadcast_join) {
     _runtime_filter_descs = tnode.runtime_filters;
     init_join_op();
-
-    // avoid vector expand change block address.
-    // one block can store 4g data, _build_blocks can store 128*4g data.
-    // if probe data bigger than 512g, runtime filter maybe will core dump when insert data.
-    _build_blocks.reserve(128);
 }
 
 HashJoinNode::~HashJoinNode() = default;
@@ -788,6 +855,23 @@ Status HashJoinNode::prepare(RuntimeState* state) {
     _push_compute_timer = ADD_TIMER(runtime_profile(), "PushDownComputeTime");
     _build_buckets_counter = ADD_COUNTER(runtime_profile(), "BuildBuckets", TUnit::UNIT);
 
+    // Only the joins which never change the hash table while probing can share it.
+    if (_is_broadcast_join && state->enable_share_hash_table_for_broadcast_join() &&
+        state->get_query_fragments_ctx() != nullptr && !_match_all_build && !_is_right_semi_anti) {
+        _shared_hash_table_controller =
+                state->get_query_fragments_ctx()->get_shared_hash_table_controller();
+    }
+
+    // A shared hash table never spills.
+    _spill_enabled = _shared_hash_table_controller == nullptr && BlockSpillStream::can_spill(state);
+    if (_spill_enabled) {
+        _spill_timer = ADD_TIMER(runtime_profile(), "SpillTime");
+        _spill_io_timer = ADD_TIMER(runtime_profile(), "SpillIOTime");
+        _spill_build_rows_counter = ADD_COUNTER(runtime_profile(), "SpilledBuildRows", TUnit::UNIT);
+        _spill_probe_rows_counter = ADD_COUNTER(runtime_profile(), "SpilledProbeRows", TUnit::UNIT);
+        _spill_bytes_counter = ADD_COUNTER(runtime_profile(), "SpilledBytes", TUnit::BYTES);
+    }
+
     RETURN_IF_ERROR(
             VExpr::prepare(_build_expr_ctxs, state, child(1)->row_desc(), expr_mem_tracker()));
     RETURN_IF_ERROR(
@@ -818,7 +902,18 @@ Status HashJoinNode::close(RuntimeState* state) {
 
     if (_vother_join_conjunct_ptr) (*_vother_join_conjunct_ptr)->close(state);
 
+    if (_need_publish_hash_table) {
+        // wake up the instances waiting for the hash table which will never be built
+        _need_publish_hash_table = false;
+        _shared_hash_table_controller->put_hash_table(
+                id(), Status::Cancelled("the builder of the shared hash table is closed"),
+                nullptr);
+    }
+
     _hash_table_mem_tracker->release(_mem_used);
+    _build_spill_partitions.clear();
+    _probe_spill_partitions.clear();
+    _spill_partition_depths.clear();
 
     return ExecNode::close(state);
 }
@@ -829,58 +924,76 @@ Status HashJoinNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eo
 
 Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_TIMER(_probe_timer);
 
-    size_t probe_rows = _probe_block.rows();
-    if ((probe_rows == 0 || _probe_index == probe_rows) && !_probe_eos) {
-        _probe_index = 0;
-        // clear_column_data of _probe_block
-        {
-            if (!_probe_column_disguise_null.empty()) {
-                for (int i = 0; i < _probe_column_disguise_null.size(); ++i) {
-                    auto column_to_erase = _probe_column_disguise_null[i];
-                    _probe_block.erase(column_to_erase - i);
-                }
-                _probe_column_disguise_null.clear();
-            }
-            release_block_memory(_probe_block);
-        }
+    if (_is_build_spilled() && !_probe_spilled) {
+        RETURN_IF_ERROR(_spill_probe_side(state));
+    }
 
+    if (need_more_input_data()) {
+        prepare_for_next();
         do {
             SCOPED_TIMER(_probe_next_timer);
-            RETURN_IF_ERROR(child(0)->get_next(state, &_probe_block, &_probe_eos));
+            RETURN_IF_ERROR(_get_next_probe_block(state));
         } while (_probe_block.rows() == 0 && !_probe_eos);
+        RETURN_IF_ERROR(push(state, &_probe_block, _probe_eos));
+    }
 
-        probe_rows = _probe_block.rows();
-        if (probe_rows != 0) {
-            COUNTER_UPDATE(_probe_rows_counter, probe_rows);
+    return pull(state, output_block, eos);
+}
 
-            int probe_expr_ctxs_sz = _probe_expr_ctxs.size();
-            _probe_columns.resize(probe_expr_ctxs_sz);
-            if (_null_map_column == nullptr) {
-                _null_map_column = ColumnUInt8::create();
-            }
-            _null_map_column->get_data().assign(probe_rows, (uint8_t)0);
+void HashJoinNode::prepare_for_next() {
+    // clear_column_data of _probe_block
+    if (!_probe_column_disguise_null.empty()) {
+        for (int i = 0; i < _probe_column_disguise_null.size(); ++i) {
+            auto column_to_erase = _probe_column_disguise_null[i];
+            _probe_block.erase(column_to_erase - i);
+        }
+        _probe_column_disguise_null.clear();
+    }
+    release_block_memory(_probe_block);
+}
 
-            Status st = std::visit(
-                    [&](auto&& arg) -> Status {
-                        using HashTableCtxType = std::decay_t<decltype(arg)>;
-                        if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
-                            auto& null_map_val = _null_map_column->get_data();
-                            return extract_probe_join_column(_probe_block, null_map_val,
-                                                             _probe_columns, _probe_ignore_null,
-                                                             *_probe_expr_call_timer);
-                        } else {
-                            LOG(FATAL) << "FATAL: uninited hash table";
-                        }
-                        __builtin_unreachable();
-                    },
-                    _hash_table_variants);
+Status HashJoinNode::push(RuntimeState* state, Block* input_block, bool eos) {
+    DCHECK(need_more_input_data());
+    if (input_block != &_probe_block) {
+        _probe_block.swap(*input_block);
+    }
+    _probe_index = 0;
+    _probe_eos = eos;
 
-            RETURN_IF_ERROR(st);
-        }
+    size_t probe_rows = _probe_block.rows();
+    if (probe_rows == 0) {
+        return Status::OK();
     }
+    COUNTER_UPDATE(_probe_rows_counter, probe_rows);
 
+    int probe_expr_ctxs_sz = _probe_expr_ctxs.size();
+    _probe_columns.resize(probe_expr_ctxs_sz);
+    if (_null_map_column == nullptr) {
+        _null_map_column = ColumnUInt8::create();
+    }
+    _null_map_column->get_data().assign(probe_rows, (uint8_t)0);
+
+    return std::visit(
+            [&](auto&& arg) -> Status {
+                using HashTableCtxType = std::decay_t<decltype(arg)>;
+                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                    auto& null_map_val = _null_map_column->get_data();
+                    return extract_probe_join_column(_probe_block, null_map_val, _probe_columns,
+                                                     _probe_ignore_null, *_probe_expr_call_timer);
+                } else {
+                    LOG(FATAL) << "FATAL: uninited hash table";
+                }
+                __builtin_unreachable();
+            },
+            _shared_ctx->hash_table_variants);
+}
+
+Status HashJoinNode::pull(RuntimeState* state, Block* output_block, bool* eos) {
+    size_t probe_rows = _probe_block.rows();
     Status st;
 
     if (_probe_index < _probe_block.rows()) {
@@ -922,11 +1035,13 @@ Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eo
                         }
                     }
                 },
-                _hash_table_variants, _join_op_variants,
+                _shared_ctx->hash_table_variants, _join_op_variants,
                 make_bool_variant(_have_other_join_conjunct),
                 make_bool_variant(_probe_ignore_null));
     } else if (_probe_eos) {
-        if (_is_right_semi_anti || (_is_outer_join && _join_op != TJoinOp::LEFT_OUTER_JOIN)) {
+        bool output_build_rows =
+                _is_right_semi_anti || (_is_outer_join && _join_op != TJoinOp::LEFT_OUTER_JOIN);
+        if (output_build_rows) {
             MutableBlock mutable_block(
                     VectorizedUtils::create_empty_columnswithtypename(row_desc()));
             std::visit(
@@ -942,17 +1057,28 @@ Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eo
                             LOG(FATAL) << "FATAL: uninited hash table";
                         }
                     },
-                    _hash_table_variants, _join_op_variants);
+                    _shared_ctx->hash_table_variants, _join_op_variants);
         } else {
             *eos = true;
+        }
+
+        RETURN_IF_ERROR(st);
+        // the current spilled partition is done, go on with the next one
+        if (*eos && _is_build_spilled() &&
+            _cur_spill_partition + 1 < _build_spill_partitions.size()) {
+            *eos = false;
+            ++_cur_spill_partition;
+            RETURN_IF_ERROR(_load_spill_partition(state));
+        }
+        if (!output_build_rows) {
             return Status::OK();
         }
     } else {
         return Status::OK();
     }
 
-    RETURN_IF_ERROR(
-            VExprContext::filter_block(_vconjunct_ctx_ptr, output_block, output_block->columns()));
+    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, output_block,
+                                               output_block->columns(), _accept_block_selection));
     reached_limit(output_block, eos);
 
     return st;
@@ -960,7 +1086,18 @@ Status HashJoinNode::get_next(RuntimeState* state, Block* output_block, bool* eo
 
 Status HashJoinNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
+    RETURN_IF_ERROR(alloc_resource(state));
+
+    RETURN_IF_ERROR(_hash_table_build(state));
+    RETURN_IF_ERROR(child(0)->open(state));
+
+    return Status::OK();
+}
+
+Status HashJoinNode::alloc_resource(RuntimeState* state) {
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     RETURN_IF_CANCELLED(state);
@@ -970,52 +1107,141 @@ Status HashJoinNode::open(RuntimeState* state) {
     if (_vother_join_conjunct_ptr) {
         RETURN_IF_ERROR((*_vother_join_conjunct_ptr)->open(state));
     }
+    _build_side_mutable_block = MutableBlock(child(1)->row_desc().tuple_descriptors());
 
-    RETURN_IF_ERROR(_hash_table_build(state));
-    RETURN_IF_ERROR(child(0)->open(state));
-
+    if (_shared_hash_table_controller != nullptr) {
+        _should_build_hash_table = _shared_hash_table_controller->should_build_hash_table(
+                state->fragment_instance_id(), id());
+        _need_publish_hash_table = _should_build_hash_table;
+    }
     return Status::OK();
 }
 
+// make one block for each 4 gigabytes
+static constexpr auto BUILD_BLOCK_MAX_SIZE = 4 * 1024UL * 1024UL * 1024UL;
+
 Status HashJoinNode::_hash_table_build(RuntimeState* state) {
+    if (!_should_build_hash_table) {
+        return _acquire_shared_hash_table(state);
+    }
+
     RETURN_IF_ERROR(child(1)->open(state));
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_ERR_CB("Hash join, while constructing the hash table.");
     SCOPED_TIMER(_build_timer);
-    MutableBlock mutable_block(child(1)->row_desc().tuple_descriptors());
 
-    uint8_t index = 0;
-    int64_t last_mem_used = 0;
     bool eos = false;
-
     Block block;
     while (!eos) {
         block.clear_column_data();
         RETURN_IF_CANCELLED(state);
 
         RETURN_IF_ERROR(child(1)->get_next(state, &block, &eos));
-        _hash_table_mem_tracker->consume(block.allocated_bytes());
-        _mem_used += block.allocated_bytes();
+        RETURN_IF_ERROR(sink_build(state, &block, eos));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::sink_build(RuntimeState* state, Block* in_block, bool eos) {
+    if (_is_build_spilled()) {
+        SCOPED_TIMER(_spill_timer);
+        COUNTER_UPDATE(_spill_build_rows_counter, in_block->rows());
+        RETURN_IF_ERROR(_spill_block_to_partitions(
+                *in_block, _build_expr_ctxs, _right_table_data_types.size(),
+                _build_spill_partitions, 0, 0, _spill_runtime_filter_slots.get()));
+    } else {
+        _hash_table_mem_tracker->consume(in_block->allocated_bytes());
+        _mem_used += in_block->allocated_bytes();
 
-        if (block.rows() != 0) {
-            mutable_block.merge(block);
+        if (in_block->rows() != 0) {
+            _build_side_mutable_block.merge(*in_block);
         }
 
-        // make one block for each 4 gigabytes
-        constexpr static auto BUILD_BLOCK_MAX_SIZE = 4 * 1024UL * 1024UL * 1024UL;
-        if (_mem_used - last_mem_used > BUILD_BLOCK_MAX_SIZE) {
-            _build_blocks.emplace_back(mutable_block.to_block());
+        if (_spill_enabled && BlockSpillStream::should_spill(state, _mem_used)) {
+            RETURN_IF_ERROR(_spill_build_side(state, _build_side_mutable_block));
+        } else if (_mem_used - _build_side_last_mem_used > BUILD_BLOCK_MAX_SIZE) {
+            _shared_ctx->blocks.emplace_back(_build_side_mutable_block.to_block());
             // TODO:: Rethink may we should do the proess after we recevie all build blocks ?
             // which is better.
-            RETURN_IF_ERROR(_process_build_block(state, _build_blocks[index], index));
+            RETURN_IF_ERROR(_process_build_block(state, _shared_ctx->blocks[_build_block_idx],
+                                                 _build_block_idx));
 
-            mutable_block = MutableBlock();
-            ++index;
-            last_mem_used = _mem_used;
+            _build_side_mutable_block = MutableBlock();
+            ++_build_block_idx;
+            _build_side_last_mem_used = _mem_used;
+        }
+    }
+
+    if (!eos) {
+        return Status::OK();
+    }
+
+    if (_is_build_spilled()) {
+        SCOPED_TIMER(_spill_timer);
+        int64_t spilled_bytes = 0;
+        for (auto& partition : _build_spill_partitions) {
+            RETURN_IF_ERROR(partition->done_write());
+            spilled_bytes += partition->bytes();
         }
+        COUNTER_UPDATE(_spill_bytes_counter, spilled_bytes);
+        if (_spill_runtime_filter_slots != nullptr) {
+            SCOPED_TIMER(_push_down_timer);
+            _spill_runtime_filter_slots->publish();
+        }
+        return Status::OK();
+    }
+
+    _shared_ctx->blocks.emplace_back(_build_side_mutable_block.to_block());
+    RETURN_IF_ERROR(
+            _process_build_block(state, _shared_ctx->blocks[_build_block_idx], _build_block_idx));
+
+    Status st = std::visit(
+            [&](auto&& arg) -> Status {
+                using HashTableCtxType = std::decay_t<decltype(arg)>;
+                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                    ProcessRuntimeFilterBuild<HashTableCtxType> runtime_filter_build_process(this);
+                    return runtime_filter_build_process(state, arg);
+                } else {
+                    LOG(FATAL) << "FATAL: uninited hash table";
+                }
+            },
+            _shared_ctx->hash_table_variants);
+
+    if (_need_publish_hash_table) {
+        _need_publish_hash_table = false;
+        _shared_hash_table_controller->put_hash_table(id(), st, _shared_ctx);
     }
+    return st;
+}
+
+Status HashJoinNode::_acquire_shared_hash_table(RuntimeState* state) {
+    SCOPED_TIMER(_build_timer);
+    RETURN_IF_ERROR(
+            _shared_hash_table_controller->wait_for_hash_table(state, id(), &_shared_ctx));
+    // The build side of this instance is useless, close it to stop receiving the
+    // broadcast data as soon as possible.
+    RETURN_IF_ERROR(child(1)->close(state));
 
-    _build_blocks.emplace_back(mutable_block.to_block());
-    RETURN_IF_ERROR(_process_build_block(state, _build_blocks[index], index));
+    if (_runtime_filter_descs.empty()) {
+        return Status::OK();
+    }
+    // The runtime filters find the build keys by the result column ids of the build exprs,
+    // which this instance never executed. Execute them on a copy of a build block, whose
+    // result columns are appended the same way as they were by the builder, and the
+    // shared block is kept untouched.
+    for (const auto& build_block : _shared_ctx->blocks) {
+        if (build_block.rows() == 0) {
+            continue;
+        }
+        Block block;
+        for (size_t i = 0; i < _right_table_data_types.size(); ++i) {
+            block.insert(build_block.get_by_position(i));
+        }
+        for (auto expr_ctx : _build_expr_ctxs) {
+            int result_col_id = -1;
+            RETURN_IF_ERROR(expr_ctx->execute(&block, &result_col_id));
+        }
+        break;
+    }
 
     return std::visit(
             [&](auto&& arg) -> Status {
@@ -1026,8 +1252,9 @@ Status HashJoinNode::_hash_table_build(RuntimeState* state) {
                 } else {
                     LOG(FATAL) << "FATAL: uninited hash table";
                 }
+                __builtin_unreachable();
             },
-            _hash_table_variants);
+            _shared_ctx->hash_table_variants);
 }
 
 // TODO:: unify the code of extract probe join column
@@ -1141,9 +1368,10 @@ Status HashJoinNode::_process_build_block(RuntimeState* state, Block& block, uin
                 }
                 __builtin_unreachable();
             },
-            _hash_table_variants);
+            _shared_ctx->hash_table_variants);
 
-    bool has_runtime_filter = !_runtime_filter_descs.empty();
+    // the runtime filters of a spilled join are built while spilling
+    bool has_runtime_filter = !_runtime_filter_descs.empty() && !_is_build_spilled();
 
     std::visit(
             [&](auto&& arg) {
@@ -1151,7 +1379,7 @@ Status HashJoinNode::_process_build_block(RuntimeState* state, Block& block, uin
                 if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
 #define CALL_BUILD_FUNCTION(HAS_NULL, BUILD_UNIQUE)                                           \
     ProcessHashTableBuild<HashTableCtxType, HAS_NULL, BUILD_UNIQUE> hash_table_build_process( \
-            rows, block, raw_ptrs, this, state->batch_size(), offset);                        \
+            state, rows, block, raw_ptrs, this, state->batch_size(), offset);                 \
     st = hash_table_build_process(arg, &null_map_val, has_runtime_filter);
                     if (std::pair {has_null, _build_unique} == std::pair {true, true}) {
                         CALL_BUILD_FUNCTION(true, true);
@@ -1166,7 +1394,7 @@ Status HashJoinNode::_process_build_block(RuntimeState* state, Block& block, uin
                     LOG(FATAL) << "FATAL: uninited hash table";
                 }
             },
-            _hash_table_variants);
+            _shared_ctx->hash_table_variants);
 
     return st;
 }
@@ -1177,27 +1405,32 @@ void HashJoinNode::_hash_table_init() {
         switch (_build_expr_ctxs[0]->root()->result_type()) {
         case TYPE_BOOLEAN:
         case TYPE_TINYINT:
-            _hash_table_variants.emplace<I8HashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<I8HashTableContext>();
             break;
         case TYPE_SMALLINT:
-            _hash_table_variants.emplace<I16HashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<I16HashTableContext>();
             break;
         case TYPE_INT:
         case TYPE_FLOAT:
-            _hash_table_variants.emplace<I32HashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<I32HashTableContext>();
             break;
         case TYPE_BIGINT:
         case TYPE_DOUBLE:
         case TYPE_DATETIME:
         case TYPE_DATE:
-            _hash_table_variants.emplace<I64HashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<I64HashTableContext>();
             break;
         case TYPE_LARGEINT:
         case TYPE_DECIMALV2:
-            _hash_table_variants.emplace<I128HashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<I128HashTableContext>();
+            break;
+        case TYPE_CHAR:
+        case TYPE_VARCHAR:
+        case TYPE_STRING:
+            _shared_ctx->hash_table_variants.emplace<StringHashTableContext>();
             break;
         default:
-            _hash_table_variants.emplace<SerializedHashTableContext>();
+            _shared_ctx->hash_table_variants.emplace<SerializedHashTableContext>();
         }
         return;
     }
@@ -1233,25 +1466,284 @@ void HashJoinNode::_hash_table_init() {
         // TODO: may we should support uint256 in the future
         if (has_null) {
             if (std::tuple_size<KeysNullMap<UInt64>>::value + key_byte_size <= sizeof(UInt64)) {
-                _hash_table_variants.emplace<I64FixedKeyHashTableContext<true>>();
+                _shared_ctx->hash_table_variants.emplace<I64FixedKeyHashTableContext<true>>();
             } else if (std::tuple_size<KeysNullMap<UInt128>>::value + key_byte_size <=
                        sizeof(UInt128)) {
-                _hash_table_variants.emplace<I128FixedKeyHashTableContext<true>>();
+                _shared_ctx->hash_table_variants.emplace<I128FixedKeyHashTableContext<true>>();
             } else {
-                _hash_table_variants.emplace<I256FixedKeyHashTableContext<true>>();
+                _shared_ctx->hash_table_variants.emplace<I256FixedKeyHashTableContext<true>>();
             }
         } else {
             if (key_byte_size <= sizeof(UInt64)) {
-                _hash_table_variants.emplace<I64FixedKeyHashTableContext<false>>();
+                _shared_ctx->hash_table_variants.emplace<I64FixedKeyHashTableContext<false>>();
             } else if (key_byte_size <= sizeof(UInt128)) {
-                _hash_table_variants.emplace<I128FixedKeyHashTableContext<false>>();
+                _shared_ctx->hash_table_variants.emplace<I128FixedKeyHashTableContext<false>>();
             } else {
-                _hash_table_variants.emplace<I256FixedKeyHashTableContext<false>>();
+                _shared_ctx->hash_table_variants.emplace<I256FixedKeyHashTableContext<false>>();
             }
         }
     } else {
-        _hash_table_variants.emplace<SerializedHashTableContext>();
+        _shared_ctx->hash_table_variants.emplace<SerializedHashTableContext>();
+    }
+}
+
+void HashJoinNode::_reset_hash_table() {
+    _hash_table_init();
+    _shared_ctx->blocks.clear();
+    _shared_ctx->inserted_rows.clear();
+    _shared_ctx->arena.clear();
+    _hash_table_mem_tracker->release(_mem_used);
+    _mem_used = 0;
+}
+
+Status HashJoinNode::_create_spill_partitions(RuntimeState* state,
+                                              std::vector<BlockSpillStreamPtr>* partitions) {
+    auto tmp_file_mgr = state->exec_env()->tmp_file_mgr();
+    for (int i = 0; i < config::vec_spill_partition_count; ++i) {
+        auto partition = std::make_unique<BlockSpillStream>(tmp_file_mgr, state->query_id());
+        partition->set_io_timer(_spill_io_timer);
+        RETURN_IF_ERROR(partition->prepare());
+        partitions->emplace_back(std::move(partition));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_spill_build_side(RuntimeState* state, MutableBlock& mutable_block) {
+    SCOPED_TIMER(_spill_timer);
+    DCHECK(!_is_build_spilled());
+    RETURN_IF_ERROR(_create_spill_partitions(state, &_build_spill_partitions));
+    _spill_partition_depths.assign(_build_spill_partitions.size(), 0);
+
+    if (!_runtime_filter_descs.empty()) {
+        // The number of the distinct build keys isn't known before the whole build side is
+        // seen, and a build side too large for the memory is taken as too large for the in
+        // filters, which are ignored or turned into the bloom filters then.
+        _spill_runtime_filter_slots.reset(new VRuntimeFilterSlots(
+                _probe_expr_ctxs, _build_expr_ctxs, _runtime_filter_descs));
+        RETURN_IF_ERROR(
+                _spill_runtime_filter_slots->init(state, state->runtime_filter_max_in_num()));
+    }
+
+    size_t num_columns = _right_table_data_types.size();
+    _shared_ctx->blocks.emplace_back(mutable_block.to_block());
+    mutable_block = MutableBlock();
+    for (auto& block : _shared_ctx->blocks) {
+        COUNTER_UPDATE(_spill_build_rows_counter, block.rows());
+        RETURN_IF_ERROR(_spill_block_to_partitions(block, _build_expr_ctxs, num_columns,
+                                                   _build_spill_partitions, 0, 0,
+                                                   _spill_runtime_filter_slots.get()));
+    }
+    _reset_hash_table();
+    return Status::OK();
+}
+
+Status HashJoinNode::_spill_probe_side(RuntimeState* state) {
+    SCOPED_TIMER(_spill_timer);
+    RETURN_IF_ERROR(_create_spill_partitions(state, &_probe_spill_partitions));
+    _probe_spilled = true;
+
+    size_t num_columns = _left_table_data_types.size();
+    Block block;
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_CANCELLED(state);
+        block.clear_column_data(num_columns);
+        RETURN_IF_ERROR(child(0)->get_next(state, &block, &eos));
+        COUNTER_UPDATE(_spill_probe_rows_counter, block.rows());
+        RETURN_IF_ERROR(_spill_block_to_partitions(block, _probe_expr_ctxs, num_columns,
+                                                   _probe_spill_partitions));
+    }
+
+    int64_t spilled_bytes = 0;
+    for (auto& partition : _probe_spill_partitions) {
+        RETURN_IF_ERROR(partition->done_write());
+        spilled_bytes += partition->bytes();
+    }
+    COUNTER_UPDATE(_spill_bytes_counter, spilled_bytes);
+
+    _cur_spill_partition = 0;
+    return _load_spill_partition(state);
+}
+
+Status HashJoinNode::_spill_block_to_partitions(Block& block, const VExprContexts& expr_ctxs,
+                                                size_t num_columns,
+                                                std::vector<BlockSpillStreamPtr>& partitions,
+                                                size_t first_partition, int depth,
+                                                VRuntimeFilterSlots* runtime_filter_slots) {
+    size_t rows = block.rows();
+    if (rows == 0) {
+        return Status::OK();
+    }
+
+    // The probe rows must go to the same partition as the build rows they match, so a
+    // null value and a nullable column hash the same as in the plain column, see
+    // ColumnNullable::update_hash_with_value. The hash is seeded by the depth so that the
+    // rows of a partition split again don't fall into the same new partition.
+    std::vector<SipHash> siphashs(rows, SipHash(depth, 0));
+    for (auto expr_ctx : expr_ctxs) {
+        int result_col_id = -1;
+        RETURN_IF_ERROR(expr_ctx->execute(&block, &result_col_id));
+        auto column =
+                block.get_by_position(result_col_id).column->convert_to_full_column_if_const();
+        for (size_t j = 0; j < rows; ++j) {
+            column->update_hash_with_value(j, siphashs[j]);
+        }
+    }
+    if (runtime_filter_slots != nullptr && !runtime_filter_slots->empty()) {
+        SCOPED_TIMER(_push_compute_timer);
+        // the filters find the keys by the result columns of the build exprs just executed
+        std::unordered_map<const Block*, std::vector<int>> rows_of_block;
+        auto& block_rows = rows_of_block[&block];
+        block_rows.resize(rows);
+        std::iota(block_rows.begin(), block_rows.end(), 0);
+        runtime_filter_slots->insert(rows_of_block);
     }
+
+    size_t num_partitions = config::vec_spill_partition_count;
+    DCHECK_LE(first_partition + num_partitions, partitions.size());
+    IColumn::Selector selector(rows);
+    for (size_t j = 0; j < rows; ++j) {
+        selector[j] = siphashs[j].get64() % num_partitions;
+    }
+
+    std::vector<ColumnsWithTypeAndName> partition_columns(num_partitions);
+    for (size_t i = 0; i < num_columns; ++i) {
+        const auto& column_with_type = block.get_by_position(i);
+        auto scattered_columns = column_with_type.column->scatter(num_partitions, selector);
+        for (size_t p = 0; p < num_partitions; ++p) {
+            partition_columns[p].emplace_back(std::move(scattered_columns[p]),
+                                              column_with_type.type, column_with_type.name);
+        }
+    }
+    block.clear_column_data(num_columns);
+
+    for (size_t p = 0; p < num_partitions; ++p) {
+        RETURN_IF_ERROR(partitions[first_partition + p]->add_block(Block(partition_columns[p])));
+    }
+    return Status::OK();
+}
+
+Status HashJoinNode::_load_spill_partition(RuntimeState* state) {
+    SCOPED_TIMER(_build_timer);
+    while (true) {
+        DCHECK_LT(_cur_spill_partition, _build_spill_partitions.size());
+        _reset_hash_table();
+        bool split = false;
+        RETURN_IF_ERROR(_build_spill_partition(state, &split));
+        if (!split) {
+            break;
+        }
+        // the rows of the partition are moved into the new partitions at the end
+        ++_cur_spill_partition;
+    }
+
+    // start probing the probe rows of the same partition
+    _probe_eos = false;
+    return Status::OK();
+}
+
+Status HashJoinNode::_build_spill_partition(RuntimeState* state, bool* split) {
+    auto& partition = _build_spill_partitions[_cur_spill_partition];
+    MutableBlock mutable_block(child(1)->row_desc().tuple_descriptors());
+    uint8_t index = 0;
+    int64_t last_mem_used = 0;
+    bool eos = false;
+    while (true) {
+        RETURN_IF_CANCELLED(state);
+        Block block;
+        RETURN_IF_ERROR(partition->get_next(&block, &eos));
+        if (eos) {
+            break;
+        }
+        _hash_table_mem_tracker->consume(block.allocated_bytes());
+        _mem_used += block.allocated_bytes();
+        mutable_block.merge(block);
+
+        if (BlockSpillStream::should_spill(state, _mem_used)) {
+            *split = true;
+            return _split_spill_partition(state, mutable_block);
+        }
+        if (_mem_used - last_mem_used > BUILD_BLOCK_MAX_SIZE) {
+            _shared_ctx->blocks.emplace_back(mutable_block.to_block());
+            RETURN_IF_ERROR(_process_build_block(state, _shared_ctx->blocks[index], index));
+            mutable_block = MutableBlock();
+            ++index;
+            last_mem_used = _mem_used;
+        }
+    }
+    _shared_ctx->blocks.emplace_back(mutable_block.to_block());
+    RETURN_IF_ERROR(_process_build_block(state, _shared_ctx->blocks[index], index));
+    // the rows are in the hash table now, the file is useless
+    partition.reset();
+    return Status::OK();
+}
+
+Status HashJoinNode::_split_spill_partition(RuntimeState* state, MutableBlock& mutable_block) {
+    SCOPED_TIMER(_spill_timer);
+    int depth = _spill_partition_depths[_cur_spill_partition];
+    if (depth >= config::vec_spill_max_repartition_depth) {
+        return Status::MemoryLimitExceeded(fmt::format(
+                "the build side of the spilled partition of hash join node {} still exceeds "
+                "the memory limit after being split {} times",
+                id(), depth));
+    }
+    size_t first_partition = _build_spill_partitions.size();
+    RETURN_IF_ERROR(_create_spill_partitions(state, &_build_spill_partitions));
+    RETURN_IF_ERROR(_create_spill_partitions(state, &_probe_spill_partitions));
+    _spill_partition_depths.resize(_build_spill_partitions.size(), depth + 1);
+
+    size_t num_columns = _right_table_data_types.size();
+    _shared_ctx->blocks.emplace_back(mutable_block.to_block());
+    mutable_block = MutableBlock();
+    for (auto& block : _shared_ctx->blocks) {
+        RETURN_IF_ERROR(_spill_block_to_partitions(block, _build_expr_ctxs, num_columns,
+                                                   _build_spill_partitions, first_partition,
+                                                   depth + 1));
+    }
+    _reset_hash_table();
+    RETURN_IF_ERROR(_split_spill_stream(state, _build_spill_partitions, _build_expr_ctxs,
+                                        num_columns, first_partition, depth + 1));
+    return _split_spill_stream(state, _probe_spill_partitions, _probe_expr_ctxs,
+                               _left_table_data_types.size(), first_partition, depth + 1);
+}
+
+Status HashJoinNode::_split_spill_stream(RuntimeState* state,
+                                         std::vector<BlockSpillStreamPtr>& partitions,
+                                         const VExprContexts& expr_ctxs, size_t num_columns,
+                                         size_t first_partition, int depth) {
+    // the file is removed once the stream is destroyed at the end of the split
+    BlockSpillStreamPtr partition = std::move(partitions[_cur_spill_partition]);
+    bool eos = false;
+    while (true) {
+        RETURN_IF_CANCELLED(state);
+        Block block;
+        RETURN_IF_ERROR(partition->get_next(&block, &eos));
+        if (eos) {
+            break;
+        }
+        RETURN_IF_ERROR(_spill_block_to_partitions(block, expr_ctxs, num_columns, partitions,
+                                                   first_partition, depth));
+    }
+
+    int64_t spilled_bytes = 0;
+    for (size_t p = first_partition; p < partitions.size(); ++p) {
+        RETURN_IF_ERROR(partitions[p]->done_write());
+        spilled_bytes += partitions[p]->bytes();
+    }
+    COUNTER_UPDATE(_spill_bytes_counter, spilled_bytes);
+    return Status::OK();
+}
+
+Status HashJoinNode::_get_next_probe_block(RuntimeState* state) {
+    if (!_probe_spilled) {
+        return child(0)->get_next(state, &_probe_block, &_probe_eos);
+    }
+    auto& partition = _probe_spill_partitions[_cur_spill_partition];
+    RETURN_IF_ERROR(partition->get_next(&_probe_block, &_probe_eos));
+    if (_probe_eos) {
+        partition.reset();
+    }
+    return Status::OK();
 }
 
 } // namespace doris::vectorized
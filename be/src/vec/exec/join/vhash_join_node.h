@@ -24,9 +24,12 @@
 #include "vec/common/columns_hashing.h"
 #include "vec/common/hash_table/hash_map.h"
 #include "vec/common/hash_table/hash_table.h"
+#include "vec/common/hash_table/string_hash_map.h"
 #include "vec/exec/join/join_op.h"
 #include "vec/exec/join/vacquire_list.hpp"
 #include "vec/functions/function.h"
+#include "vec/runtime/vshared_hash_table_controller.h"
+#include "vec/runtime/vspill_stream.h"
 
 namespace doris {
 namespace vectorized {
@@ -49,6 +52,26 @@ struct SerializedHashTableContext {
     }
 };
 
+// For the single string key, the short keys are stored inline by the StringHashMap.
+struct StringHashTableContext {
+    using Mapped = RowRefList;
+    using HashTable = StringHashMap<Mapped>;
+    using State = ColumnsHashing::HashMethodString<typename HashTable::value_type, Mapped, true,
+                                                   false>;
+    using Iter = typename HashTable::iterator;
+
+    HashTable hash_table;
+    Iter iter;
+    bool inited = false;
+
+    void init_once() {
+        if (!inited) {
+            inited = true;
+            iter = hash_table.begin();
+        }
+    }
+};
+
 // T should be UInt32 UInt64 UInt128
 template <class T>
 struct PrimaryTypeHashTableContext {
@@ -113,7 +136,24 @@ using HashTableVariants =
                      I128HashTableContext, I256HashTableContext, I64FixedKeyHashTableContext<true>,
                      I64FixedKeyHashTableContext<false>, I128FixedKeyHashTableContext<true>,
                      I128FixedKeyHashTableContext<false>, I256FixedKeyHashTableContext<true>,
-                     I256FixedKeyHashTableContext<false>>;
+                     I256FixedKeyHashTableContext<false>, StringHashTableContext>;
+
+// The hash table and the build blocks referred by it. The instances of a broadcast join
+// on one BE may share one of it, see SharedHashTableController.
+struct SharedHashTableContext {
+    SharedHashTableContext() {
+        // avoid vector expand change block address.
+        // one block can store 4g data, blocks can store 128*4g data.
+        // if probe data bigger than 512g, runtime filter maybe will core dump when insert data.
+        blocks.reserve(128);
+    }
+
+    Arena arena;
+    HashTableVariants hash_table_variants;
+    std::vector<Block> blocks;
+    // the rows of each block inserted into the hash table, used to build runtime filters
+    std::unordered_map<const Block*, std::vector<int>> inserted_rows;
+};
 
 using JoinOpVariants =
         std::variant<std::integral_constant<TJoinOp::type, TJoinOp::INNER_JOIN>,
@@ -143,6 +183,20 @@ using JoinOpVariants =
 
 class VExprContext;
 
+// When spilling is enabled for the query and the query memory goes beyond
+// config::vec_spill_mem_limit_percent of its limit while building the hash table, the
+// join turns into a grace hash join: both the build and the probe input are hash
+// partitioned by the join keys and written to BlockSpillStreams, then the partitions
+// are joined one by one, each of them with a hash table of only its own build rows. A
+// partition of which the build rows still can't fit in memory is split again, both sides
+// by another hash of the keys, into new partitions joined after the others. The runtime
+// filters of a spilled join are built from all the build rows as they are spilled, and are
+// published when the build side is done.
+//
+// When enable_share_hash_table_for_broadcast_join is set, the instances of a broadcast
+// join on one BE share one hash table: the first instance builds it from its build side,
+// and the others drop their build side and probe the shared hash table read-only. Only
+// the joins which do not mark the visited build rows while probing can share.
 class HashJoinNode : public ::doris::ExecNode {
 public:
     HashJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -154,9 +208,31 @@ public:
     virtual Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override;
     virtual Status get_next(RuntimeState* state, Block* block, bool* eos) override;
     virtual Status close(RuntimeState* state) override;
-    HashTableVariants& get_hash_table_variants() { return _hash_table_variants; }
+    HashTableVariants& get_hash_table_variants() { return _shared_ctx->hash_table_variants; }
     void init_join_op();
 
+    // Interfaces of the pipeline engine, which pushes the input blocks of both sides
+    // instead of pulling them from the children.
+    // Open the node itself without opening its children.
+    Status alloc_resource(RuntimeState* state);
+    // Insert one block of the build side into the hash table, 'eos' means it is the last one.
+    Status sink_build(RuntimeState* state, Block* in_block, bool eos);
+    // Return true if the current probe block is used up and a new one can be pushed.
+    bool need_more_input_data() const {
+        return (_probe_block.rows() == 0 || _probe_index == _probe_block.rows()) && !_probe_eos;
+    }
+    // Release the current probe block before pushing the next one.
+    void prepare_for_next();
+    // Take over the block of the probe side, 'eos' means it is the last one.
+    Status push(RuntimeState* state, Block* input_block, bool eos);
+    // Probe the hash table with the current probe block and output the join result.
+    Status pull(RuntimeState* state, Block* output_block, bool* eos);
+    // Spilling needs to read the whole probe side by itself, which is not possible
+    // when it is pushed.
+    void disable_spill() { _spill_enabled = false; }
+    // Every instance has to consume its own build side when it is pushed.
+    void disable_share_hash_table() { _shared_hash_table_controller = nullptr; }
+
 private:
     using VExprContexts = std::vector<VExprContext*>;
 
@@ -203,10 +279,10 @@ private:
     int64_t _hash_table_rows;
     int64_t _mem_used;
 
-    Arena _arena;
-    HashTableVariants _hash_table_variants;
-
-    std::vector<Block> _build_blocks;
+    // the build rows which are not in the build blocks yet
+    MutableBlock _build_side_mutable_block;
+    uint8_t _build_block_idx = 0;
+    int64_t _build_side_last_mem_used = 0;
     Block _probe_block;
     ColumnRawPtrs _probe_columns;
     ColumnUInt8::MutablePtr _null_map_column;
@@ -238,6 +314,34 @@ private:
     std::vector<bool> _left_output_slot_flags;
     std::vector<bool> _right_output_slot_flags;
 
+    bool _spill_enabled = false;
+    std::vector<BlockSpillStreamPtr> _build_spill_partitions;
+    std::vector<BlockSpillStreamPtr> _probe_spill_partitions;
+    bool _probe_spilled = false;
+    // the times each pair of the build and the probe partitions has been split
+    std::vector<int> _spill_partition_depths;
+    // the index of the spilled partition being joined now
+    size_t _cur_spill_partition = 0;
+    // the runtime filters of a spilled build side, built from the build rows while they are
+    // spilled and published once the build side is done, before the partitions are joined
+    std::unique_ptr<VRuntimeFilterSlots> _spill_runtime_filter_slots;
+
+    RuntimeProfile::Counter* _spill_timer = nullptr;
+    // the time of the spill file io, which may run on the spill io threads
+    RuntimeProfile::Counter* _spill_io_timer = nullptr;
+    RuntimeProfile::Counter* _spill_build_rows_counter = nullptr;
+    RuntimeProfile::Counter* _spill_probe_rows_counter = nullptr;
+    RuntimeProfile::Counter* _spill_bytes_counter = nullptr;
+
+    std::shared_ptr<SharedHashTableContext> _shared_ctx;
+    const bool _is_broadcast_join;
+    // not null if the hash table is shared by the instances of the broadcast join
+    SharedHashTableController* _shared_hash_table_controller = nullptr;
+    // false if this instance probes the hash table built by another instance
+    bool _should_build_hash_table = true;
+    // true if this instance builds the shared hash table and has not published it yet
+    bool _need_publish_hash_table = false;
+
 private:
     Status _hash_table_build(RuntimeState* state);
     Status _process_build_block(RuntimeState* state, Block& block, uint8_t offset);
@@ -249,6 +353,42 @@ private:
                                      bool& ignore_null, RuntimeProfile::Counter& expr_call_timer);
 
     void _hash_table_init();
+    // Drop the hash table and all the build blocks, release their memory.
+    void _reset_hash_table();
+
+    bool _is_build_spilled() const { return !_build_spill_partitions.empty(); }
+    Status _create_spill_partitions(RuntimeState* state,
+                                    std::vector<BlockSpillStreamPtr>* partitions);
+    // Move all the build rows received so far into the spill partitions.
+    Status _spill_build_side(RuntimeState* state, MutableBlock& mutable_block);
+    // Read all the probe input and write it to the spill partitions.
+    Status _spill_probe_side(RuntimeState* state);
+    // Hash partition the first 'num_columns' columns of the block by the keys of 'expr_ctxs'
+    // into the config::vec_spill_partition_count partitions from 'first_partition', the
+    // extra columns of the evaluated keys are removed from the block afterwards. The keys
+    // are hashed with the split depth of the partitions, and inserted into the runtime
+    // filters of 'runtime_filter_slots' if it's not null.
+    Status _spill_block_to_partitions(Block& block, const VExprContexts& expr_ctxs,
+                                      size_t num_columns,
+                                      std::vector<BlockSpillStreamPtr>& partitions,
+                                      size_t first_partition = 0, int depth = 0,
+                                      VRuntimeFilterSlots* runtime_filter_slots = nullptr);
+    // Build the hash table of the spilled partition '_cur_spill_partition', or of the next
+    // ones if it is split again.
+    Status _load_spill_partition(RuntimeState* state);
+    Status _build_spill_partition(RuntimeState* state, bool* split);
+    // Split both sides of the partition '_cur_spill_partition' into new partitions, the
+    // build rows loaded so far are in 'mutable_block' and the shared blocks.
+    Status _split_spill_partition(RuntimeState* state, MutableBlock& mutable_block);
+    // Move the rest of the partition '_cur_spill_partition' of 'partitions' into the new
+    // partitions from 'first_partition'.
+    Status _split_spill_stream(RuntimeState* state, std::vector<BlockSpillStreamPtr>& partitions,
+                               const VExprContexts& expr_ctxs, size_t num_columns,
+                               size_t first_partition, int depth);
+    Status _get_next_probe_block(RuntimeState* state);
+    // Wait for the shared hash table built by another instance and publish the runtime
+    // filters of this instance from it.
+    Status _acquire_shared_hash_table(RuntimeState* state);
 
     template <class HashTableContext, bool ignore_null, bool build_unique>
     friend struct ProcessHashTableBuild;
@@ -260,7 +400,6 @@ private:
     friend struct ProcessRuntimeFilterBuild;
 
     std::vector<TRuntimeFilterDesc> _runtime_filter_descs;
-    std::unordered_map<const Block*, std::vector<int>> _inserted_rows;
 };
 } // namespace vectorized
 } // namespace doris
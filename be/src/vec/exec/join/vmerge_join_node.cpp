@@ -0,0 +1,358 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/vmerge_join_node.h"
+
+#include "gutil/strings/substitute.h"
+#include "runtime/runtime_state.h"
+#include "util/runtime_profile.h"
+#include "vec/common/assert_cast.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vslot_ref.h"
+#include "vec/utils/util.hpp"
+
+namespace doris::vectorized {
+
+VMergeJoinNode::VMergeJoinNode(ObjectPool* pool, const TPlanNode& tnode,
+                               const DescriptorTbl& descs)
+        : ExecNode(pool, tnode, descs),
+          _join_op(tnode.merge_join_node.__isset.join_op ? tnode.merge_join_node.join_op
+                                                         : TJoinOp::INNER_JOIN) {}
+
+Status VMergeJoinNode::init(const TPlanNode& tnode, RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::init(tnode, state));
+    DCHECK(tnode.__isset.merge_join_node);
+    if (_join_op != TJoinOp::INNER_JOIN && _join_op != TJoinOp::LEFT_OUTER_JOIN &&
+        _join_op != TJoinOp::LEFT_SEMI_JOIN && _join_op != TJoinOp::LEFT_ANTI_JOIN) {
+        return Status::InternalError(strings::Substitute(
+                "VMergeJoinNode does not support the join op $0", _join_op));
+    }
+    if (!tnode.merge_join_node.other_join_conjuncts.empty()) {
+        return Status::InternalError("VMergeJoinNode does not support the other join conjuncts");
+    }
+    for (const auto& eq_join_conjunct : tnode.merge_join_node.cmp_conjuncts) {
+        if (eq_join_conjunct.__isset.opcode &&
+            eq_join_conjunct.opcode == TExprOpcode::EQ_FOR_NULL) {
+            return Status::InternalError("VMergeJoinNode does not support the null safe equal");
+        }
+        VExprContext* ctx = nullptr;
+        RETURN_IF_ERROR(VExpr::create_expr_tree(_pool, eq_join_conjunct.left, &ctx));
+        _left_expr_ctxs.push_back(ctx);
+        RETURN_IF_ERROR(VExpr::create_expr_tree(_pool, eq_join_conjunct.right, &ctx));
+        _right_expr_ctxs.push_back(ctx);
+    }
+    if (_left_expr_ctxs.empty()) {
+        return Status::InternalError("VMergeJoinNode requires at least one eq join conjunct");
+    }
+    return Status::OK();
+}
+
+Status VMergeJoinNode::prepare(RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::prepare(state));
+    _left_rows_counter = ADD_COUNTER(runtime_profile(), "LeftRows", TUnit::UNIT);
+    _right_rows_counter = ADD_COUNTER(runtime_profile(), "RightRows", TUnit::UNIT);
+    _max_group_rows_counter = ADD_COUNTER(runtime_profile(), "MaxGroupRows", TUnit::UNIT);
+
+    RETURN_IF_ERROR(
+            VExpr::prepare(_left_expr_ctxs, state, child(0)->row_desc(), expr_mem_tracker()));
+    RETURN_IF_ERROR(
+            VExpr::prepare(_right_expr_ctxs, state, child(1)->row_desc(), expr_mem_tracker()));
+    // the keys are compared column-wise, so both sides must have the same key types
+    for (size_t i = 0; i < _left_expr_ctxs.size(); ++i) {
+        auto left_type = remove_nullable(_left_expr_ctxs[i]->root()->data_type());
+        auto right_type = remove_nullable(_right_expr_ctxs[i]->root()->data_type());
+        if (!left_type->equals(*right_type)) {
+            return Status::InternalError(strings::Substitute(
+                    "VMergeJoinNode requires the same types of the join keys, got $0 and $1",
+                    left_type->get_name(), right_type->get_name()));
+        }
+    }
+    RETURN_IF_ERROR(_check_child_order(0, _left_expr_ctxs));
+    RETURN_IF_ERROR(_check_child_order(1, _right_expr_ctxs));
+
+    auto left_types = VectorizedUtils::get_data_types(child(0)->row_desc());
+    auto right_types = VectorizedUtils::get_data_types(child(1)->row_desc());
+    auto output_types = VectorizedUtils::get_data_types(row_desc());
+    _left_column_count = left_types.size();
+    bool output_right = _join_op == TJoinOp::INNER_JOIN || _join_op == TJoinOp::LEFT_OUTER_JOIN;
+    _right_column_count = output_right ? right_types.size() : 0;
+    if (output_types.size() != _left_column_count + _right_column_count) {
+        return Status::InternalError(strings::Substitute(
+                "VMergeJoinNode outputs $0 columns, expect $1", output_types.size(),
+                _left_column_count + _right_column_count));
+    }
+    for (size_t i = 0; i < _left_column_count; ++i) {
+        if (output_types[i]->is_nullable() != left_types[i]->is_nullable()) {
+            return Status::InternalError("VMergeJoinNode can't change the nullability of the "
+                                         "left columns");
+        }
+    }
+    for (size_t i = 0; i < _right_column_count; ++i) {
+        _right_column_to_nullable.push_back(output_types[_left_column_count + i]->is_nullable() &&
+                                            !right_types[i]->is_nullable());
+        _group_columns.push_back(output_types[_left_column_count + i]->create_column());
+    }
+    for (const auto& ctx : _right_expr_ctxs) {
+        _group_keys.push_back(remove_nullable(ctx->root()->data_type())->create_column());
+    }
+    return Status::OK();
+}
+
+Status VMergeJoinNode::open(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    RETURN_IF_ERROR(ExecNode::open(state));
+    RETURN_IF_ERROR(VExpr::open(_left_expr_ctxs, state));
+    RETURN_IF_ERROR(VExpr::open(_right_expr_ctxs, state));
+    RETURN_IF_ERROR(child(0)->open(state));
+    RETURN_IF_ERROR(child(1)->open(state));
+    return Status::OK();
+}
+
+Status VMergeJoinNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    return Status::NotSupported("Not Implemented VMergeJoinNode::get_next.");
+}
+
+Status VMergeJoinNode::get_next(RuntimeState* state, Block* block, bool* eos) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    RETURN_IF_CANCELLED(state);
+    *eos = false;
+    if (reached_limit()) {
+        *eos = true;
+        return Status::OK();
+    }
+
+    MutableBlock mutable_block =
+            block->mem_reuse()
+                    ? MutableBlock(block)
+                    : MutableBlock(VectorizedUtils::create_empty_columnswithtypename(row_desc()));
+    auto& dst_columns = mutable_block.mutable_columns();
+    // only the left outer and anti joins output the left rows which match nothing
+    const bool output_unmatched =
+            _join_op == TJoinOp::LEFT_OUTER_JOIN || _join_op == TJoinOp::LEFT_ANTI_JOIN;
+
+    while (mutable_block.rows() < state->batch_size()) {
+        if (!_left.has_row()) {
+            RETURN_IF_ERROR(_next_block(state, 0, &_left));
+            if (!_left.has_row()) {
+                *eos = true;
+                break;
+            }
+        }
+        // no left row can match once the right rows are exhausted
+        if (!output_unmatched && _group_rows == 0 && _right.eos && !_right.has_row()) {
+            *eos = true;
+            break;
+        }
+
+        size_t row = _left.pos++;
+        bool matched = false;
+        if (!_left.is_null_key(row)) {
+            if (_group_rows == 0 || _compare_with_group(row) > 0) {
+                RETURN_IF_ERROR(_advance_right_group(state, row));
+                if (_max_group_rows_counter->value() < static_cast<int64_t>(_group_rows)) {
+                    COUNTER_SET(_max_group_rows_counter, static_cast<int64_t>(_group_rows));
+                }
+            }
+            matched = _group_rows > 0 && _compare_with_group(row) == 0;
+        }
+
+        if (matched && _join_op == TJoinOp::LEFT_ANTI_JOIN) {
+            continue;
+        }
+        if (!matched && !output_unmatched) {
+            continue;
+        }
+        if (matched && _right_column_count > 0) {
+            for (size_t i = 0; i < _left_column_count; ++i) {
+                dst_columns[i]->insert_many_from(*_left.block.get_by_position(i).column, row,
+                                                 _group_rows);
+            }
+            for (size_t i = 0; i < _right_column_count; ++i) {
+                dst_columns[_left_column_count + i]->insert_range_from(*_group_columns[i], 0,
+                                                                       _group_rows);
+            }
+        } else {
+            for (size_t i = 0; i < _left_column_count; ++i) {
+                dst_columns[i]->insert_from(*_left.block.get_by_position(i).column, row);
+            }
+            // the right columns of an unmatched row of the left outer join are NULL
+            for (size_t i = 0; i < _right_column_count; ++i) {
+                dst_columns[_left_column_count + i]->insert_default();
+            }
+        }
+    }
+
+    block->swap(mutable_block.to_block());
+    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns()));
+    reached_limit(block, eos);
+    return Status::OK();
+}
+
+Status VMergeJoinNode::_next_block(RuntimeState* state, int child_idx, ChildCursor* cursor) {
+    cursor->pos = 0;
+    cursor->block.clear();
+    while (!cursor->eos && cursor->block.rows() == 0) {
+        RETURN_IF_CANCELLED(state);
+        cursor->block.clear();
+        RETURN_IF_ERROR(child(child_idx)->get_next(state, &cursor->block, &cursor->eos));
+    }
+    if (cursor->block.rows() == 0) {
+        return Status::OK();
+    }
+    COUNTER_UPDATE(child_idx == 0 ? _left_rows_counter : _right_rows_counter,
+                   cursor->block.rows());
+    return _evaluate_keys(child_idx == 0 ? _left_expr_ctxs : _right_expr_ctxs, cursor);
+}
+
+Status VMergeJoinNode::_check_child_order(int child_idx, const VExprContexts& ctxs) const {
+    std::vector<SlotId> slots = child(child_idx)->ordered_by_slots();
+    if (slots.empty()) {
+        return Status::OK();
+    }
+    std::vector<bool> is_asc_order = child(child_idx)->ordered_by_asc_order();
+    std::vector<bool> nulls_first = child(child_idx)->ordered_by_nulls_first();
+    DCHECK(is_asc_order.size() >= slots.size() && nulls_first.size() >= slots.size());
+    for (size_t i = 0; i < ctxs.size(); ++i) {
+        VExpr* root = ctxs[i]->root();
+        if (i >= slots.size() || !root->is_slot_ref() ||
+            static_cast<VSlotRef*>(root)->slot_id() != slots[i]) {
+            return Status::InternalError(strings::Substitute(
+                    "VMergeJoinNode requires the child $0 ordered by the join key $1", child_idx,
+                    root->debug_string()));
+        }
+        // the nested key columns are compared with the NaNs last, as the NULLs
+        if (!is_asc_order[i] || nulls_first[i]) {
+            return Status::InternalError(strings::Substitute(
+                    "VMergeJoinNode requires the child $0 ordered by the join key $1 in "
+                    "ascending order with the nulls last",
+                    child_idx, root->debug_string()));
+        }
+    }
+    return Status::OK();
+}
+
+Status VMergeJoinNode::_evaluate_keys(const VExprContexts& ctxs, ChildCursor* cursor) {
+    cursor->key_holders.clear();
+    cursor->keys.clear();
+    cursor->null_map.clear();
+    for (auto ctx : ctxs) {
+        int result_column_id = -1;
+        RETURN_IF_ERROR(ctx->execute(&cursor->block, &result_column_id));
+        ColumnPtr column = cursor->block.get_by_position(result_column_id)
+                                   .column->convert_to_full_column_if_const();
+        if (auto* nullable = check_and_get_column<ColumnNullable>(*column)) {
+            if (cursor->null_map.empty()) {
+                cursor->null_map.resize_fill(column->size(), 0);
+            }
+            VectorizedUtils::update_null_map(cursor->null_map,
+                                             nullable->get_null_map_column().get_data());
+            cursor->keys.push_back(&nullable->get_nested_column());
+        } else {
+            cursor->keys.push_back(column.get());
+        }
+        cursor->key_holders.push_back(std::move(column));
+    }
+    return Status::OK();
+}
+
+// 1 as the nan direction hint puts the NaNs last, as the ascending order with the NULLs last
+int VMergeJoinNode::_compare_with_group(size_t left_row) const {
+    for (size_t i = 0; i < _group_keys.size(); ++i) {
+        int res = _left.keys[i]->compare_at(left_row, 0, *_group_keys[i], 1);
+        if (res != 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+Status VMergeJoinNode::_advance_right_group(RuntimeState* state, size_t left_row) {
+    for (auto& column : _group_columns) {
+        column->clear();
+    }
+    for (auto& column : _group_keys) {
+        column->clear();
+    }
+    _group_rows = 0;
+
+    while (true) {
+        if (!_right.has_row()) {
+            RETURN_IF_ERROR(_next_block(state, 1, &_right));
+            if (!_right.has_row()) {
+                return Status::OK();
+            }
+        }
+        size_t row = _right.pos;
+        if (_right.is_null_key(row)) {
+            ++_right.pos;
+            continue;
+        }
+        if (_group_rows == 0) {
+            int res = 0;
+            for (size_t i = 0; i < _right.keys.size() && res == 0; ++i) {
+                res = _right.keys[i]->compare_at(row, left_row, *_left.keys[i], 1);
+            }
+            if (res > 0) {
+                // the right rows greater than the left row are kept for the next left rows
+                return Status::OK();
+            }
+            if (res < 0) {
+                ++_right.pos;
+                continue;
+            }
+        } else {
+            for (size_t i = 0; i < _right.keys.size(); ++i) {
+                if (_right.keys[i]->compare_at(row, 0, *_group_keys[i], 1) != 0) {
+                    return Status::OK();
+                }
+            }
+        }
+        _append_group_row();
+        ++_right.pos;
+    }
+}
+
+void VMergeJoinNode::_append_group_row() {
+    size_t row = _right.pos;
+    for (size_t i = 0; i < _right_column_count; ++i) {
+        const auto& src = *_right.block.get_by_position(i).column;
+        if (_right_column_to_nullable[i]) {
+            assert_cast<ColumnNullable&>(*_group_columns[i]).insert_from_not_nullable(src, row);
+        } else {
+            _group_columns[i]->insert_from(src, row);
+        }
+    }
+    for (size_t i = 0; i < _group_keys.size(); ++i) {
+        _group_keys[i]->insert_from(*_right.keys[i], row);
+    }
+    ++_group_rows;
+}
+
+Status VMergeJoinNode::close(RuntimeState* state) {
+    if (is_closed()) {
+        return Status::OK();
+    }
+    VExpr::close(_left_expr_ctxs, state);
+    VExpr::close(_right_expr_ctxs, state);
+    return ExecNode::close(state);
+}
+
+} // namespace doris::vectorized
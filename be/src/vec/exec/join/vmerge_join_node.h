@@ -0,0 +1,108 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <vector>
+
+#include "exec/exec_node.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/core/block.h"
+#include "vec/exprs/vexpr_context.h"
+
+namespace doris::vectorized {
+
+// Node for the merge joins of two inputs sorted in ascending order on the join keys, in the
+// order of the eq join conjuncts, e.g. the colocated tables bucketed and sorted by the join keys.
+// Both inputs are streamed, only the right rows with the join key of the current left row are
+// kept in memory. The rows with a NULL join key never match.
+// The keys are compared as the ascending order with the NULLs and NaNs last does, a child which
+// declares its order by ordered_by_slots() must be ordered so by the join keys. The order of a
+// child declaring none, e.g. the scan of the tablets sorted by the join keys, is up to the plan.
+// Supports the inner, left outer, left semi and left anti joins without other join conjuncts.
+class VMergeJoinNode final : public ExecNode {
+public:
+    VMergeJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
+    ~VMergeJoinNode() override = default;
+
+    Status init(const TPlanNode& tnode, RuntimeState* state = nullptr) override;
+    Status prepare(RuntimeState* state) override;
+    Status open(RuntimeState* state) override;
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override;
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override;
+    Status close(RuntimeState* state) override;
+
+private:
+    using VExprContexts = std::vector<VExprContext*>;
+
+    // the block being read from a child, and the join keys of its rows
+    struct ChildCursor {
+        Block block;
+        size_t pos = 0;
+        bool eos = false;
+        // the evaluated join key columns, and their nested columns if nullable
+        Columns key_holders;
+        ColumnRawPtrs keys;
+        // whether any join key of the row is NULL, empty if no key is nullable
+        NullMap null_map;
+
+        bool has_row() const { return pos < block.rows(); }
+        bool is_null_key(size_t row) const { return !null_map.empty() && null_map[row]; }
+    };
+
+    // read the next non-empty block of the child, keep `cursor->block` empty at eos
+    Status _next_block(RuntimeState* state, int child_idx, ChildCursor* cursor);
+
+    // collect the right rows equal to the join key of the left row `left_row` into the group,
+    // skipping the right rows less than it
+    Status _advance_right_group(RuntimeState* state, size_t left_row);
+
+    // check the child is ordered by the join keys in ascending order with the NULLs last
+    Status _check_child_order(int child_idx, const VExprContexts& ctxs) const;
+
+    // evaluate the join keys of the block read by the cursor
+    Status _evaluate_keys(const VExprContexts& ctxs, ChildCursor* cursor);
+
+    int _compare_with_group(size_t left_row) const;
+
+    void _append_group_row();
+
+    VExprContexts _left_expr_ctxs;
+    VExprContexts _right_expr_ctxs;
+    TJoinOp::type _join_op;
+
+    // the number of the columns of each child in the output
+    size_t _left_column_count = 0;
+    size_t _right_column_count = 0;
+    // whether the right column i is nullable in the output but not in the right child
+    std::vector<bool> _right_column_to_nullable;
+
+    ChildCursor _left;
+    ChildCursor _right;
+
+    // the right rows of the same join key, and their join keys
+    MutableColumns _group_columns;
+    MutableColumns _group_keys;
+    size_t _group_rows = 0;
+
+    RuntimeProfile::Counter* _left_rows_counter = nullptr;
+    RuntimeProfile::Counter* _right_rows_counter = nullptr;
+    RuntimeProfile::Counter* _max_group_rows_counter = nullptr;
+};
+
+} // namespace doris::vectorized
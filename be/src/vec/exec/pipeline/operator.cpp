@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline/operator.h"
+
+#include "exec/data_sink.h"
+#include "exec/exec_node.h"
+#include "runtime/thread_context.h"
+#include "vec/core/block.h"
+#include "vec/exec/join/vhash_join_node.h"
+#include "vec/exec/vaggregation_node.h"
+#include "vec/exec/vexchange_node.h"
+#include "vec/exec/volap_scan_node.h"
+
+namespace doris::vectorized {
+
+const RowDescriptor& Operator::row_desc() const {
+    DCHECK(_node != nullptr);
+    return _node->row_desc();
+}
+
+Status ExecNodeSourceOperator::open(RuntimeState* state) {
+    return _node->open(state);
+}
+
+Status ExecNodeSourceOperator::pull(RuntimeState* state, Block* block, bool* eos) {
+    return _node->get_next(state, block, eos);
+}
+
+ExchangeSourceOperator::ExchangeSourceOperator(VExchangeNode* node)
+        : Operator(node), _exchange_node(node) {}
+
+Status ExchangeSourceOperator::open(RuntimeState* state) {
+    return _exchange_node->open(state);
+}
+
+bool ExchangeSourceOperator::can_read() {
+    return _exchange_node->can_read();
+}
+
+Status ExchangeSourceOperator::pull(RuntimeState* state, Block* block, bool* eos) {
+    return _exchange_node->get_next(state, block, eos);
+}
+
+OlapScanSourceOperator::OlapScanSourceOperator(VOlapScanNode* node)
+        : Operator(node), _scan_node(node) {}
+
+Status OlapScanSourceOperator::open(RuntimeState* state) {
+    return _scan_node->open(state);
+}
+
+bool OlapScanSourceOperator::can_read() {
+    return _scan_node->can_read();
+}
+
+Status OlapScanSourceOperator::pull(RuntimeState* state, Block* block, bool* eos) {
+    return _scan_node->get_next(state, block, eos);
+}
+
+AggSinkOperator::AggSinkOperator(AggregationNode* node) : Operator(node), _agg_node(node) {}
+
+Status AggSinkOperator::open(RuntimeState* state) {
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_agg_node->mem_tracker());
+    return _agg_node->alloc_resource(state);
+}
+
+Status AggSinkOperator::push(RuntimeState* state, Block* block, bool eos) {
+    SCOPED_TIMER(_agg_node->runtime_profile()->total_time_counter());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_agg_node->mem_tracker());
+    return _agg_node->sink(state, block, eos);
+}
+
+AggSourceOperator::AggSourceOperator(AggregationNode* node) : Operator(node), _agg_node(node) {}
+
+Status AggSourceOperator::pull(RuntimeState* state, Block* block, bool* eos) {
+    SCOPED_TIMER(_agg_node->runtime_profile()->total_time_counter());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_agg_node->mem_tracker());
+    return _agg_node->pull(state, block, eos);
+}
+
+HashJoinBuildSinkOperator::HashJoinBuildSinkOperator(HashJoinNode* node)
+        : Operator(node), _join_node(node) {}
+
+Status HashJoinBuildSinkOperator::open(RuntimeState* state) {
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_join_node->mem_tracker());
+    return _join_node->alloc_resource(state);
+}
+
+Status HashJoinBuildSinkOperator::push(RuntimeState* state, Block* block, bool eos) {
+    SCOPED_TIMER(_join_node->runtime_profile()->total_time_counter());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_join_node->mem_tracker());
+    return _join_node->sink_build(state, block, eos);
+}
+
+HashJoinProbeOperator::HashJoinProbeOperator(HashJoinNode* node)
+        : Operator(node), _join_node(node) {}
+
+bool HashJoinProbeOperator::need_more_input_data() const {
+    return _join_node->need_more_input_data();
+}
+
+Status HashJoinProbeOperator::push(RuntimeState* state, Block* block, bool eos) {
+    SCOPED_TIMER(_join_node->runtime_profile()->total_time_counter());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_join_node->mem_tracker());
+    _join_node->prepare_for_next();
+    return _join_node->push(state, block, eos);
+}
+
+Status HashJoinProbeOperator::pull(RuntimeState* state, Block* block, bool* eos) {
+    SCOPED_TIMER(_join_node->runtime_profile()->total_time_counter());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_join_node->mem_tracker());
+    return _join_node->pull(state, block, eos);
+}
+
+Status DataSinkOperator::open(RuntimeState* state) {
+    return _sink->open(state);
+}
+
+Status DataSinkOperator::push(RuntimeState* state, Block* block, bool eos) {
+    if (block->rows() == 0) {
+        return Status::OK();
+    }
+    return _sink->send(state, block);
+}
+
+} // namespace doris::vectorized
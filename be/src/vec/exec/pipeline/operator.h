@@ -0,0 +1,184 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <string>
+
+#include "common/status.h"
+
+namespace doris {
+
+class DataSink;
+class ExecNode;
+class RowDescriptor;
+class RuntimeState;
+
+namespace vectorized {
+
+class AggregationNode;
+class Block;
+class HashJoinNode;
+class VExchangeNode;
+class VOlapScanNode;
+
+// Operator is the processing unit of the pipeline engine. The operators of a pipeline
+// are chained from a source to a sink, PipelineTask pulls the blocks out of an operator
+// and pushes them into the next one, an operator never calls its neighbours itself.
+//
+// Operators must not block the worker thread: a source tells by can_read() whether
+// pull() has to wait for its data, an operator which still has output for its last
+// input returns false from need_more_input_data() so that it is pulled again before
+// the next push().
+//
+// Most operators are thin adapters of the ExecNodes, the node is not owned and lives
+// in the object pool of the fragment. The nodes and the sink are closed by the
+// PlanFragmentExecutor as before.
+class Operator {
+public:
+    explicit Operator(ExecNode* node) : _node(node) {}
+    virtual ~Operator() = default;
+
+    virtual std::string name() const = 0;
+
+    // Called by the task before the first block flows through the pipeline.
+    virtual Status open(RuntimeState* state) = 0;
+
+    // Only for the source: return false if pull() would wait for data.
+    virtual bool can_read() { return true; }
+
+    // Return false if the operator has to be pulled before pushing more input.
+    virtual bool need_more_input_data() const { return true; }
+
+    // Push the input block, 'eos' means there is no more input after it.
+    virtual Status push(RuntimeState* state, Block* block, bool eos) {
+        return Status::NotSupported(name() + " can not be pushed");
+    }
+
+    // Pull an output block, '*eos' is set once the operator will never output more.
+    virtual Status pull(RuntimeState* state, Block* block, bool* eos) {
+        return Status::NotSupported(name() + " can not be pulled");
+    }
+
+    // The schema of the blocks pulled out of this operator.
+    virtual const RowDescriptor& row_desc() const;
+
+protected:
+    ExecNode* _node;
+};
+
+using OperatorPtr = std::unique_ptr<Operator>;
+
+// Runs a whole subtree of the plan in the pull model of ExecNode, it is the fallback
+// for the nodes which are not operators of the pipeline engine yet. It may block.
+class ExecNodeSourceOperator final : public Operator {
+public:
+    explicit ExecNodeSourceOperator(ExecNode* node) : Operator(node) {}
+    std::string name() const override { return "ExecNodeSourceOperator"; }
+    Status open(RuntimeState* state) override;
+    Status pull(RuntimeState* state, Block* block, bool* eos) override;
+};
+
+class ExchangeSourceOperator final : public Operator {
+public:
+    explicit ExchangeSourceOperator(VExchangeNode* node);
+    std::string name() const override { return "ExchangeSourceOperator"; }
+    Status open(RuntimeState* state) override;
+    bool can_read() override;
+    Status pull(RuntimeState* state, Block* block, bool* eos) override;
+
+private:
+    VExchangeNode* _exchange_node;
+};
+
+class OlapScanSourceOperator final : public Operator {
+public:
+    explicit OlapScanSourceOperator(VOlapScanNode* node);
+    std::string name() const override { return "OlapScanSourceOperator"; }
+    Status open(RuntimeState* state) override;
+    bool can_read() override;
+    Status pull(RuntimeState* state, Block* block, bool* eos) override;
+
+private:
+    VOlapScanNode* _scan_node;
+};
+
+// Aggregates the input of the child pipeline, the result is output by
+// AggSourceOperator in the pipeline depending on it.
+class AggSinkOperator final : public Operator {
+public:
+    explicit AggSinkOperator(AggregationNode* node);
+    std::string name() const override { return "AggSinkOperator"; }
+    Status open(RuntimeState* state) override;
+    Status push(RuntimeState* state, Block* block, bool eos) override;
+
+private:
+    AggregationNode* _agg_node;
+};
+
+class AggSourceOperator final : public Operator {
+public:
+    explicit AggSourceOperator(AggregationNode* node);
+    std::string name() const override { return "AggSourceOperator"; }
+    Status open(RuntimeState* state) override { return Status::OK(); }
+    Status pull(RuntimeState* state, Block* block, bool* eos) override;
+
+private:
+    AggregationNode* _agg_node;
+};
+
+// Builds the hash table from the build side pipeline, the probe pipeline depends on it.
+class HashJoinBuildSinkOperator final : public Operator {
+public:
+    explicit HashJoinBuildSinkOperator(HashJoinNode* node);
+    std::string name() const override { return "HashJoinBuildSinkOperator"; }
+    Status open(RuntimeState* state) override;
+    Status push(RuntimeState* state, Block* block, bool eos) override;
+
+private:
+    HashJoinNode* _join_node;
+};
+
+class HashJoinProbeOperator final : public Operator {
+public:
+    explicit HashJoinProbeOperator(HashJoinNode* node);
+    std::string name() const override { return "HashJoinProbeOperator"; }
+    Status open(RuntimeState* state) override { return Status::OK(); }
+    bool need_more_input_data() const override;
+    Status push(RuntimeState* state, Block* block, bool eos) override;
+    Status pull(RuntimeState* state, Block* block, bool* eos) override;
+
+private:
+    HashJoinNode* _join_node;
+};
+
+// Sends the output of the fragment to its DataSink. A sink which does not want any
+// more data returns END_OF_FILE from push().
+class DataSinkOperator final : public Operator {
+public:
+    explicit DataSinkOperator(DataSink* sink) : Operator(nullptr), _sink(sink) {}
+    std::string name() const override { return "DataSinkOperator"; }
+    Status open(RuntimeState* state) override;
+    Status push(RuntimeState* state, Block* block, bool eos) override;
+
+private:
+    DataSink* _sink;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -0,0 +1,127 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline/pipeline.h"
+
+#include <algorithm>
+
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "util/stopwatch.hpp"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// The time a task can run before it yields the worker to the other tasks.
+static constexpr int64_t TASK_TIME_SLICE_NS = 100L * 1000 * 1000;
+
+Status Pipeline::finalize() {
+    if (_operators.size() < 2) {
+        return Status::InternalError("a pipeline needs at least a source and a sink");
+    }
+    std::reverse(_operators.begin(), _operators.end());
+    return Status::OK();
+}
+
+bool Pipeline::dependencies_finished() const {
+    return std::all_of(_dependencies.begin(), _dependencies.end(),
+                       [](const Pipeline* pipeline) { return pipeline->is_finished(); });
+}
+
+PipelineTask::PipelineTask(Pipeline* pipeline, PipelineFragmentContext* fragment_context,
+                           RuntimeState* state)
+        : _pipeline(pipeline), _fragment_context(fragment_context), _state(state) {}
+
+Status PipelineTask::_open() {
+    auto& operators = _pipeline->operators();
+    for (auto& op : operators) {
+        RETURN_IF_ERROR(op->open(_state));
+    }
+    for (size_t i = 0; i < operators.size(); ++i) {
+        _blocks.emplace_back(std::make_unique<Block>());
+    }
+    return Status::OK();
+}
+
+bool PipelineTask::can_run() {
+    // a cancelled task has to run to find out it is cancelled
+    if (_state->is_cancelled()) {
+        return true;
+    }
+    return _pipeline->dependencies_finished() && _pipeline->operators()[0]->can_read();
+}
+
+Status PipelineTask::execute() {
+    _task_state = PipelineTaskState::RUNNABLE;
+    if (!_opened) {
+        RETURN_IF_ERROR(_open());
+        _opened = true;
+    }
+
+    auto& operators = _pipeline->operators();
+    const size_t sink_idx = operators.size() - 1;
+    MonotonicStopWatch watch;
+    watch.start();
+    while (watch.elapsed_time() < TASK_TIME_SLICE_NS) {
+        RETURN_IF_CANCELLED(_state);
+
+        // Drain the operator nearest to the sink which still has output first, only
+        // read the source when all the operators want more input.
+        size_t idx = sink_idx - 1;
+        while (idx > 0 && operators[idx]->need_more_input_data()) {
+            --idx;
+        }
+        if (idx == 0 && !operators[0]->can_read()) {
+            _task_state = PipelineTaskState::BLOCKED;
+            return Status::OK();
+        }
+
+        Block* block = _blocks[idx].get();
+        block->clear_column_data(operators[idx]->row_desc().num_materialized_slots());
+        bool eos = false;
+        RETURN_IF_ERROR(operators[idx]->pull(_state, block, &eos));
+
+        for (size_t i = idx + 1; i <= sink_idx; ++i) {
+            if (block->rows() == 0 && !eos) {
+                break;
+            }
+            Status st = operators[i]->push(_state, block, eos);
+            if (i == sink_idx) {
+                // the sink does not want more data
+                if (st.is_end_of_file()) {
+                    _task_state = PipelineTaskState::FINISHED;
+                    return Status::OK();
+                }
+                RETURN_IF_ERROR(st);
+                if (eos) {
+                    _task_state = PipelineTaskState::FINISHED;
+                    return Status::OK();
+                }
+                break;
+            }
+            RETURN_IF_ERROR(st);
+
+            block = _blocks[i].get();
+            block->clear_column_data(operators[i]->row_desc().num_materialized_slots());
+            eos = false;
+            RETURN_IF_ERROR(operators[i]->pull(_state, block, &eos));
+        }
+    }
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
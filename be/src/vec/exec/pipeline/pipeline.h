@@ -0,0 +1,107 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "common/status.h"
+#include "vec/exec/pipeline/operator.h"
+
+namespace doris {
+
+class RuntimeState;
+
+namespace vectorized {
+
+class Block;
+class PipelineFragmentContext;
+
+// Pipeline is a chain of operators from a source to a sink, none of the operators in
+// between blocks the data. The plan of a fragment is split into pipelines at the
+// blocking operators, e.g. the hash table of an aggregation is filled by one pipeline
+// and read by another one which depends on it.
+class Pipeline {
+public:
+    explicit Pipeline(int id) : _id(id) {}
+
+    int id() const { return _id; }
+
+    // The plan is visited from its root, so the operators are added from the sink to
+    // the source, finalize() restores the order of the data flow.
+    void add_operator(OperatorPtr op) { _operators.emplace_back(std::move(op)); }
+    Status finalize();
+
+    // This pipeline can only run after 'pipeline' is finished.
+    void add_dependency(Pipeline* pipeline) { _dependencies.push_back(pipeline); }
+    bool dependencies_finished() const;
+
+    void set_finished() { _finished = true; }
+    bool is_finished() const { return _finished; }
+
+    // The source is the first one and the sink is the last one.
+    std::vector<OperatorPtr>& operators() { return _operators; }
+
+private:
+    const int _id;
+    std::vector<OperatorPtr> _operators;
+    std::vector<Pipeline*> _dependencies;
+    std::atomic<bool> _finished {false};
+};
+
+enum class PipelineTaskState {
+    RUNNABLE, // can run again immediately
+    BLOCKED,  // waiting for the source to be readable
+    FINISHED,
+};
+
+// PipelineTask drives the data through the operators of a pipeline, it is the unit
+// which the TaskScheduler runs on its worker threads. A task runs until it is
+// finished, its source has no data to read or its time slice is used up, so that
+// the workers are shared fairly among the running fragments.
+class PipelineTask {
+public:
+    PipelineTask(Pipeline* pipeline, PipelineFragmentContext* fragment_context,
+                 RuntimeState* state);
+
+    Status execute();
+
+    // Return true if execute() can make progress now.
+    bool can_run();
+
+    PipelineTaskState state() const { return _task_state; }
+    Pipeline* pipeline() const { return _pipeline; }
+    PipelineFragmentContext* fragment_context() const { return _fragment_context; }
+    RuntimeState* runtime_state() const { return _state; }
+
+private:
+    Status _open();
+
+    Pipeline* _pipeline;
+    PipelineFragmentContext* _fragment_context;
+    RuntimeState* _state;
+
+    bool _opened = false;
+    PipelineTaskState _task_state = PipelineTaskState::RUNNABLE;
+    // _blocks[i] holds the output of the i-th operator
+    std::vector<std::unique_ptr<Block>> _blocks;
+};
+
+} // namespace vectorized
+} // namespace doris
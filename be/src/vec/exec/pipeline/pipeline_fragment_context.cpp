@@ -0,0 +1,117 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline/pipeline_fragment_context.h"
+
+#include "exec/exec_node.h"
+#include "runtime/runtime_state.h"
+#include "util/uid_util.h"
+#include "vec/exec/join/vhash_join_node.h"
+#include "vec/exec/pipeline/task_scheduler.h"
+#include "vec/exec/vaggregation_node.h"
+#include "vec/exec/vexchange_node.h"
+#include "vec/exec/volap_scan_node.h"
+
+namespace doris::vectorized {
+
+PipelineFragmentContext::PipelineFragmentContext(RuntimeState* state, ExecNode* plan,
+                                                 DataSink* sink)
+        : _state(state), _plan(plan), _sink(sink) {}
+
+Pipeline* PipelineFragmentContext::_add_pipeline() {
+    _pipelines.emplace_back(std::make_unique<Pipeline>(_pipelines.size()));
+    return _pipelines.back().get();
+}
+
+Status PipelineFragmentContext::prepare() {
+    DCHECK(_sink != nullptr);
+    Pipeline* root = _add_pipeline();
+    root->add_operator(std::make_unique<DataSinkOperator>(_sink));
+    RETURN_IF_ERROR(_build_pipelines(_plan, root));
+
+    for (auto& pipeline : _pipelines) {
+        RETURN_IF_ERROR(pipeline->finalize());
+        _tasks.emplace_back(std::make_unique<PipelineTask>(pipeline.get(), this, _state));
+    }
+    VLOG_CRITICAL << "fragment " << print_id(_state->fragment_instance_id()) << " is split into "
+                  << _pipelines.size() << " pipelines";
+    return Status::OK();
+}
+
+Status PipelineFragmentContext::_build_pipelines(ExecNode* node, Pipeline* pipeline) {
+    if (auto exchange_node = dynamic_cast<VExchangeNode*>(node)) {
+        pipeline->add_operator(std::make_unique<ExchangeSourceOperator>(exchange_node));
+        return Status::OK();
+    }
+    if (auto scan_node = dynamic_cast<VOlapScanNode*>(node)) {
+        pipeline->add_operator(std::make_unique<OlapScanSourceOperator>(scan_node));
+        return Status::OK();
+    }
+    if (auto agg_node = dynamic_cast<AggregationNode*>(node);
+        agg_node != nullptr && !agg_node->is_streaming_preagg()) {
+        pipeline->add_operator(std::make_unique<AggSourceOperator>(agg_node));
+        Pipeline* sink_pipeline = _add_pipeline();
+        sink_pipeline->add_operator(std::make_unique<AggSinkOperator>(agg_node));
+        pipeline->add_dependency(sink_pipeline);
+        return _build_pipelines(node->child(0), sink_pipeline);
+    }
+    if (auto join_node = dynamic_cast<HashJoinNode*>(node)) {
+        join_node->disable_spill();
+        join_node->disable_share_hash_table();
+        pipeline->add_operator(std::make_unique<HashJoinProbeOperator>(join_node));
+        Pipeline* build_pipeline = _add_pipeline();
+        build_pipeline->add_operator(std::make_unique<HashJoinBuildSinkOperator>(join_node));
+        pipeline->add_dependency(build_pipeline);
+        RETURN_IF_ERROR(_build_pipelines(node->child(1), build_pipeline));
+        return _build_pipelines(node->child(0), pipeline);
+    }
+    pipeline->add_operator(std::make_unique<ExecNodeSourceOperator>(node));
+    return Status::OK();
+}
+
+Status PipelineFragmentContext::execute(TaskScheduler* scheduler) {
+    if (scheduler == nullptr) {
+        return Status::InternalError("pipeline task scheduler is not started");
+    }
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _num_unfinished_tasks = _tasks.size();
+    }
+    for (auto& task : _tasks) {
+        scheduler->schedule(task.get());
+    }
+
+    std::unique_lock<std::mutex> l(_lock);
+    _finish_cv.wait(l, [this] { return _num_unfinished_tasks == 0; });
+    return _status;
+}
+
+void PipelineFragmentContext::on_task_finished(PipelineTask* task, const Status& status) {
+    std::lock_guard<std::mutex> l(_lock);
+    if (status.ok()) {
+        task->pipeline()->set_finished();
+    } else if (_status.ok()) {
+        _status = status;
+        // let the other tasks quit
+        _state->set_is_cancelled(true);
+    }
+    if (--_num_unfinished_tasks == 0) {
+        _finish_cv.notify_all();
+    }
+}
+
+} // namespace doris::vectorized
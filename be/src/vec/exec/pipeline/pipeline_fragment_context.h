@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/status.h"
+#include "vec/exec/pipeline/pipeline.h"
+
+namespace doris {
+
+class DataSink;
+class ExecNode;
+class RuntimeState;
+
+namespace vectorized {
+
+class TaskScheduler;
+
+// PipelineFragmentContext runs the vectorized plan of a fragment instance by the
+// pipeline engine. The plan is split into pipelines at its blocking operators: the
+// build side of a hash join and the input of an aggregation get pipelines of their
+// own which the pipeline of their output depends on. A subtree whose root is not an
+// operator of the pipeline engine yet is run as a whole in the pull model.
+//
+// Every pipeline is run by one PipelineTask on the TaskScheduler, the calling thread
+// only waits for all of them to finish.
+class PipelineFragmentContext {
+public:
+    PipelineFragmentContext(RuntimeState* state, ExecNode* plan, DataSink* sink);
+
+    // Build the pipelines and their tasks.
+    Status prepare();
+
+    // Run all the tasks and wait for them. The first error of the tasks is returned
+    // and cancels the others.
+    Status execute(TaskScheduler* scheduler);
+
+    // Called by the scheduler when a task is finished or failed.
+    void on_task_finished(PipelineTask* task, const Status& status);
+
+private:
+    Pipeline* _add_pipeline();
+    Status _build_pipelines(ExecNode* node, Pipeline* pipeline);
+
+    RuntimeState* _state;
+    ExecNode* _plan;
+    DataSink* _sink;
+
+    std::vector<std::unique_ptr<Pipeline>> _pipelines;
+    std::vector<std::unique_ptr<PipelineTask>> _tasks;
+
+    std::mutex _lock;
+    std::condition_variable _finish_cv;
+    size_t _num_unfinished_tasks = 0;
+    Status _status;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -0,0 +1,123 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline/task_scheduler.h"
+
+#include <limits>
+
+#include "runtime/runtime_state.h"
+#include "runtime/thread_context.h"
+#include "vec/exec/pipeline/pipeline.h"
+#include "vec/exec/pipeline/pipeline_fragment_context.h"
+
+namespace doris::vectorized {
+
+// How often the blocked tasks are checked.
+static constexpr auto BLOCKED_TASK_POLL_INTERVAL = std::chrono::milliseconds(1);
+
+TaskScheduler::TaskScheduler(int num_workers)
+        : _num_workers(num_workers), _runnable_queue(std::numeric_limits<size_t>::max()) {}
+
+TaskScheduler::~TaskScheduler() {
+    shutdown();
+}
+
+Status TaskScheduler::start() {
+    for (int i = 0; i < _num_workers; ++i) {
+        scoped_refptr<Thread> worker;
+        RETURN_IF_ERROR(Thread::create(
+                "TaskScheduler", "pipeline_worker", [this]() { _work(); }, &worker));
+        _workers.emplace_back(std::move(worker));
+    }
+    RETURN_IF_ERROR(Thread::create(
+            "TaskScheduler", "pipeline_poller", [this]() { _poll_blocked_tasks(); }, &_poller));
+    LOG(INFO) << "pipeline task scheduler started with " << _num_workers << " workers";
+    return Status::OK();
+}
+
+void TaskScheduler::shutdown() {
+    if (_shutdown.exchange(true)) {
+        return;
+    }
+    _runnable_queue.shutdown();
+    _blocked_cv.notify_all();
+    for (auto& worker : _workers) {
+        worker->join();
+    }
+    if (_poller != nullptr) {
+        _poller->join();
+    }
+}
+
+void TaskScheduler::schedule(PipelineTask* task) {
+    if (task->can_run()) {
+        _runnable_queue.blocking_put(task);
+    } else {
+        _add_blocked_task(task);
+    }
+}
+
+void TaskScheduler::_add_blocked_task(PipelineTask* task) {
+    std::lock_guard<std::mutex> l(_blocked_lock);
+    _blocked_tasks.push_back(task);
+    _blocked_cv.notify_one();
+}
+
+void TaskScheduler::_work() {
+    PipelineTask* task = nullptr;
+    while (_runnable_queue.blocking_get(&task)) {
+        Status st;
+        {
+#ifndef BE_TEST
+            SCOPED_ATTACH_TASK_THREAD(task->runtime_state(),
+                                      task->runtime_state()->instance_mem_tracker());
+#endif
+            st = task->execute();
+        }
+
+        if (!st.ok() || task->state() == PipelineTaskState::FINISHED) {
+            // the task may be destroyed with its fragment once it is reported
+            task->fragment_context()->on_task_finished(task, st);
+        } else if (task->state() == PipelineTaskState::BLOCKED) {
+            _add_blocked_task(task);
+        } else {
+            // the time slice is used up, let the other tasks run
+            _runnable_queue.blocking_put(task);
+        }
+    }
+}
+
+void TaskScheduler::_poll_blocked_tasks() {
+    std::unique_lock<std::mutex> l(_blocked_lock);
+    while (!_shutdown) {
+        if (_blocked_tasks.empty()) {
+            _blocked_cv.wait(l, [this] { return _shutdown || !_blocked_tasks.empty(); });
+            continue;
+        }
+        for (auto it = _blocked_tasks.begin(); it != _blocked_tasks.end();) {
+            if ((*it)->can_run()) {
+                _runnable_queue.blocking_put(*it);
+                it = _blocked_tasks.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _blocked_cv.wait_for(l, BLOCKED_TASK_POLL_INTERVAL);
+    }
+}
+
+} // namespace doris::vectorized
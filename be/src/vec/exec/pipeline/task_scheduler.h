@@ -0,0 +1,67 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <mutex>
+#include <vector>
+
+#include "common/status.h"
+#include "gutil/ref_counted.h"
+#include "util/blocking_queue.hpp"
+#include "util/thread.h"
+
+namespace doris::vectorized {
+
+class PipelineTask;
+
+// TaskScheduler runs the PipelineTasks of all the fragments on a fixed number of
+// worker threads, normally one per core. A task which can not make progress is moved
+// to the blocked list instead of occupying a worker, a poller thread moves it back to
+// the runnable queue once its source becomes readable.
+class TaskScheduler {
+public:
+    explicit TaskScheduler(int num_workers);
+    ~TaskScheduler();
+
+    Status start();
+    void shutdown();
+
+    // Run the task as soon as it can make progress.
+    void schedule(PipelineTask* task);
+
+private:
+    void _work();
+    void _poll_blocked_tasks();
+    void _add_blocked_task(PipelineTask* task);
+
+    const int _num_workers;
+    BlockingQueue<PipelineTask*> _runnable_queue;
+
+    std::mutex _blocked_lock;
+    std::condition_variable _blocked_cv;
+    std::list<PipelineTask*> _blocked_tasks;
+
+    std::vector<scoped_refptr<Thread>> _workers;
+    scoped_refptr<Thread> _poller;
+    std::atomic<bool> _shutdown {false};
+};
+
+} // namespace doris::vectorized
@@ -18,13 +18,19 @@
 #include "vec/exec/vaggregation_node.h"
 
 #include <memory>
+#include <set>
 
+#include "common/config.h"
 #include "exec/exec_node.h"
+#include "gutil/strings/substitute.h"
+#include "runtime/exec_env.h"
 #include "runtime/mem_pool.h"
 #include "runtime/row_batch.h"
 #include "util/defer_op.h"
+#include "vec/common/sip_hash.h"
 #include "vec/core/block.h"
 #include "vec/data_types/data_type_nullable.h"
+#include "vec/exec/volap_scan_node.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/exprs/vexpr_context.h"
 #include "vec/exprs/vslot_ref.h"
@@ -86,7 +92,11 @@ AggregationNode::AggregationNode(ObjectPool* pool, const TPlanNode& tnode,
           _agg_data(),
           _build_timer(nullptr),
           _exec_timer(nullptr),
-          _merge_timer(nullptr) {
+          _merge_timer(nullptr),
+          _spill_timer(nullptr),
+          _spill_io_timer(nullptr),
+          _spill_rows_counter(nullptr),
+          _spill_bytes_counter(nullptr) {
     if (tnode.agg_node.__isset.use_streaming_preaggregation) {
         _is_streaming_preagg = tnode.agg_node.use_streaming_preaggregation;
         if (_is_streaming_preagg) {
@@ -148,6 +158,11 @@ void AggregationNode::_init_hash_method(std::vector<VExprContext*>& probe_exprs)
         case TYPE_DECIMALV2:
             _agg_data.init(AggregatedDataVariants::Type::int128_key, is_nullable);
             return;
+        case TYPE_CHAR:
+        case TYPE_VARCHAR:
+        case TYPE_STRING:
+            _agg_data.init(AggregatedDataVariants::Type::string_key, is_nullable);
+            return;
         default:
             _agg_data.init(AggregatedDataVariants::Type::serialized);
         }
@@ -203,13 +218,26 @@ void AggregationNode::_init_hash_method(std::vector<VExprContext*>& probe_exprs)
 
 Status AggregationNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(ExecNode::prepare(state));
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
+    _is_sorted_agg = config::enable_sorted_aggregation && !_is_merge &&
+                     !_probe_expr_ctxs.empty() && _is_input_ordered_by_keys();
+    if (_is_sorted_agg) {
+        // the groups are returned once they are closed, there is nothing to pass through
+        _is_streaming_preagg = false;
+    }
+    if (!_is_merge && !_is_streaming_preagg && !_is_sorted_agg) {
+        // the input rows are skipped by the selection of the blocks instead of being copied
+        _children[0]->set_accept_block_selection(true);
+    }
     _build_timer = ADD_TIMER(runtime_profile(), "BuildTime");
     _exec_timer = ADD_TIMER(runtime_profile(), "ExecTime");
     _merge_timer = ADD_TIMER(runtime_profile(), "MergeTime");
     _expr_timer = ADD_TIMER(runtime_profile(), "ExprTime");
     _get_results_timer = ADD_TIMER(runtime_profile(), "GetResultsTime");
+    _convert_to_two_level_timer = ADD_TIMER(runtime_profile(), "ConvertToTwoLevelTime");
     _data_mem_tracker =
             MemTracker::create_virtual_tracker(-1, "AggregationNode:Data", mem_tracker());
     _intermediate_tuple_desc = state->desc_tbl().get_tuple_descriptor(_intermediate_tuple_id);
@@ -242,6 +270,15 @@ Status AggregationNode::prepare(RuntimeState* state) {
         evaluator->set_timer(_exec_timer, _merge_timer, _expr_timer);
     }
 
+    if (config::enable_common_subexpr_elimination) {
+        std::vector<VExprContext*> ctxs(_probe_expr_ctxs);
+        for (auto evaluator : _aggregate_evaluators) {
+            const auto& input_ctxs = evaluator->input_exprs_ctxs();
+            ctxs.insert(ctxs.end(), input_ctxs.begin(), input_ctxs.end());
+        }
+        _common_exprs.init(_pool, ctxs);
+    }
+
     _offsets_of_aggregate_states.resize(_aggregate_evaluators.size());
 
     for (size_t i = 0; i < _aggregate_evaluators.size(); ++i) {
@@ -297,6 +334,32 @@ Status AggregationNode::prepare(RuntimeState* state) {
         _executor.update_memusage =
                 std::bind<void>(&AggregationNode::_update_memusage_without_key, this);
         _executor.close = std::bind<void>(&AggregationNode::_close_without_key, this);
+    } else if (_is_sorted_agg) {
+        runtime_profile()->append_exec_option("Sorted Aggregation");
+        _sorted_places.push_back(reinterpret_cast<AggregateDataPtr>(
+                _mem_pool->allocate(_total_size_of_aggregate_states)));
+        _create_agg_status(_sorted_places[0]);
+
+        for (auto ctx : _probe_expr_ctxs) {
+            _sorted_result_schema.push_back(
+                    {nullptr, ctx->root()->data_type(), ctx->root()->expr_name()});
+        }
+        auto output_schema = VectorizedUtils::create_columns_with_type_and_name(row_desc());
+        for (size_t i = 0; i < _aggregate_evaluators.size(); ++i) {
+            // the states are serialized to strings for the merging aggregation
+            DataTypePtr type = _needs_finalize ? output_schema[_probe_expr_ctxs.size() + i].type
+                                               : std::make_shared<DataTypeString>();
+            _sorted_result_schema.push_back({nullptr, type, ""});
+        }
+
+        _executor.execute = std::bind<Status>(&AggregationNode::_execute_sorted, this,
+                                              std::placeholders::_1);
+        _executor.get_result = std::bind<Status>(&AggregationNode::_get_sorted_result, this,
+                                                 std::placeholders::_1, std::placeholders::_2,
+                                                 std::placeholders::_3);
+        _executor.update_memusage =
+                std::bind<void>(&AggregationNode::_update_memusage_without_key, this);
+        _executor.close = std::bind<void>(&AggregationNode::_close_sorted, this);
     } else {
         _init_hash_method(_probe_expr_ctxs);
         if (_is_merge) {
@@ -305,10 +368,17 @@ Status AggregationNode::prepare(RuntimeState* state) {
         } else {
             _executor.execute = std::bind<Status>(&AggregationNode::_execute_with_serialized_key,
                                                   this, std::placeholders::_1);
+            _push_pre_aggregation_to_scan();
         }
 
         if (_is_streaming_preagg) {
             runtime_profile()->append_exec_option("Streaming Preaggregation");
+            _passthrough_rows_counter =
+                    ADD_COUNTER(runtime_profile(), "RowsPassedThrough", TUnit::UNIT);
+            _preagg_estimated_reduction_counter = ADD_COUNTER(
+                    runtime_profile(), "ReductionFactorEstimate", TUnit::DOUBLE_VALUE);
+            _preagg_streaming_ht_min_reduction_counter = ADD_COUNTER(
+                    runtime_profile(), "ReductionFactorThresholdToExpand", TUnit::DOUBLE_VALUE);
             _executor.pre_agg =
                     std::bind<Status>(&AggregationNode::_pre_agg_with_serialized_key, this,
                                       std::placeholders::_1, std::placeholders::_2);
@@ -326,27 +396,206 @@ Status AggregationNode::prepare(RuntimeState* state) {
         _executor.update_memusage =
                 std::bind<void>(&AggregationNode::_update_memusage_with_serialized_key, this);
         _executor.close = std::bind<void>(&AggregationNode::_close_with_serialized_key, this);
+
+        // streaming preaggregation passes through the rows instead of spilling them
+        _spill_enabled = !_is_streaming_preagg && BlockSpillStream::can_spill(state);
+        if (_spill_enabled) {
+            _spill_timer = ADD_TIMER(runtime_profile(), "SpillTime");
+            _spill_io_timer = ADD_TIMER(runtime_profile(), "SpillIOTime");
+            _spill_rows_counter = ADD_COUNTER(runtime_profile(), "SpilledRows", TUnit::UNIT);
+            _spill_bytes_counter = ADD_COUNTER(runtime_profile(), "SpilledBytes", TUnit::BYTES);
+        }
     }
 
     return Status::OK();
 }
 
-Status AggregationNode::open(RuntimeState* state) {
-    SCOPED_TIMER(_runtime_profile->total_time_counter());
-    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
-    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_ERR_CB("aggregator, while execute open.");
-    RETURN_IF_ERROR(ExecNode::open(state));
+bool AggregationNode::_is_input_ordered_by_keys() const {
+    std::set<SlotId> key_slots;
+    for (auto ctx : _probe_expr_ctxs) {
+        if (!ctx->root()->is_slot_ref()) {
+            return false;
+        }
+        key_slots.insert(static_cast<VSlotRef*>(ctx->root())->slot_id());
+    }
+    std::vector<SlotId> ordered_by_slots = child(0)->ordered_by_slots();
+    if (ordered_by_slots.size() < key_slots.size()) {
+        return false;
+    }
+    // the keys may be ordered in any order of priority
+    return std::set<SlotId>(ordered_by_slots.begin(),
+                            ordered_by_slots.begin() + key_slots.size()) == key_slots;
+}
 
-    RETURN_IF_ERROR(VExpr::open(_probe_expr_ctxs, state));
+Status AggregationNode::_execute_sorted(Block* block) {
+    SCOPED_TIMER(_build_timer);
+    DCHECK(!block->has_selection());
 
+    size_t key_size = _probe_expr_ctxs.size();
+    ColumnRawPtrs key_columns(key_size);
+    {
+        SCOPED_TIMER(_expr_timer);
+        for (size_t i = 0; i < key_size; ++i) {
+            int result_column_id = -1;
+            RETURN_IF_ERROR(_probe_expr_ctxs[i]->execute(block, &result_column_id));
+            block->get_by_position(result_column_id).column =
+                    block->get_by_position(result_column_id)
+                            .column->convert_to_full_column_if_const();
+            key_columns[i] = block->get_by_position(result_column_id).column.get();
+        }
+    }
+
+    // a group starts at each row of which any key differs from the previous row
+    size_t rows = block->rows();
+    std::vector<uint8_t> is_group_start(rows, 0);
+    for (auto key_column : key_columns) {
+        for (size_t i = 1; i < rows; ++i) {
+            if (!is_group_start[i]) {
+                is_group_start[i] = key_column->compare_at(i, i - 1, *key_column, 1) != 0;
+            }
+        }
+    }
+    if (!_sorted_open_key.empty()) {
+        for (size_t i = 0; i < key_size; ++i) {
+            if (key_columns[i]->compare_at(0, 0, *_sorted_open_key[i], 1) != 0) {
+                ColumnRawPtrs open_key_columns;
+                for (const auto& column : _sorted_open_key) {
+                    open_key_columns.push_back(column.get());
+                }
+                _close_sorted_group(open_key_columns, 0, _sorted_places[0]);
+                break;
+            }
+        }
+    }
+
+    // the first group of the block uses the state of the open group
+    PODArray<AggregateDataPtr> places(rows);
+    std::vector<size_t> group_start_rows {0};
+    for (size_t i = 0; i < rows; ++i) {
+        if (is_group_start[i]) {
+            group_start_rows.push_back(i);
+            if (group_start_rows.size() > _sorted_places.size()) {
+                _sorted_places.push_back(reinterpret_cast<AggregateDataPtr>(
+                        _mem_pool->allocate(_total_size_of_aggregate_states)));
+                _create_agg_status(_sorted_places.back());
+            }
+        }
+        places[i] = _sorted_places[group_start_rows.size() - 1];
+    }
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
-        RETURN_IF_ERROR(_aggregate_evaluators[i]->open(state));
+        _aggregate_evaluators[i]->execute_batch_add(block, _offsets_of_aggregate_states[i],
+                                                    places.data(), &_agg_arena_pool);
+    }
+
+    // all the groups but the last one are closed by the block
+    size_t num_groups = group_start_rows.size();
+    for (size_t i = 0; i + 1 < num_groups; ++i) {
+        _close_sorted_group(key_columns, group_start_rows[i], _sorted_places[i]);
+    }
+    std::swap(_sorted_places[0], _sorted_places[num_groups - 1]);
+    _sorted_open_key.clear();
+    for (auto key_column : key_columns) {
+        auto column = key_column->clone_empty();
+        column->insert_from(*key_column, group_start_rows.back());
+        _sorted_open_key.push_back(std::move(column));
+    }
+    return Status::OK();
+}
+
+void AggregationNode::_close_sorted_group(const ColumnRawPtrs& key_columns, size_t row,
+                                          AggregateDataPtr place) {
+    if (_sorted_result_columns.empty()) {
+        for (const auto& column : _sorted_result_schema) {
+            _sorted_result_columns.push_back(column.type->create_column());
+        }
+    }
+    size_t key_size = key_columns.size();
+    for (size_t i = 0; i < key_size; ++i) {
+        _sorted_result_columns[i]->insert_from(*key_columns[i], row);
+    }
+    for (size_t i = 0; i < _aggregate_evaluators.size(); ++i) {
+        auto column = _sorted_result_columns[key_size + i].get();
+        if (_needs_finalize) {
+            _aggregate_evaluators[i]->insert_result_info(place + _offsets_of_aggregate_states[i],
+                                                         column);
+        } else {
+            VectorBufferWriter writer(assert_cast<ColumnString&>(*column));
+            _aggregate_evaluators[i]->function()->serialize(
+                    place + _offsets_of_aggregate_states[i], writer);
+            writer.commit();
+        }
+    }
+    // the state is reused by a later group
+    _destory_agg_status(place);
+    _create_agg_status(place);
+}
+
+Status AggregationNode::_get_sorted_result(RuntimeState* state, Block* block, bool* eos) {
+    block->clear();
+    if (!_sorted_result_columns.empty()) {
+        *block = Block(_sorted_result_schema);
+        block->set_columns(std::move(_sorted_result_columns));
+        _sorted_result_columns.clear();
+    }
+    *eos = _sorted_input_eos;
+    return Status::OK();
+}
+
+void AggregationNode::_close_sorted() {
+    for (auto place : _sorted_places) {
+        _destory_agg_status(place);
     }
+    release_tracker();
+}
+
+void AggregationNode::_push_pre_aggregation_to_scan() {
+    if (!config::enable_scan_pre_aggregation ||
+        child(0)->type() != TPlanNodeType::OLAP_SCAN_NODE) {
+        return;
+    }
+    ScanPreAggregation pre_aggregation;
+    for (auto ctx : _probe_expr_ctxs) {
+        if (!ctx->root()->is_slot_ref()) {
+            return;
+        }
+        pre_aggregation.group_by_columns.push_back(
+                static_cast<VSlotRef*>(ctx->root())->column_id());
+    }
+    for (auto evaluator : _aggregate_evaluators) {
+        const auto& input_ctxs = evaluator->input_exprs_ctxs();
+        if (input_ctxs.size() != 1 || !input_ctxs[0]->root()->is_slot_ref()) {
+            return;
+        }
+        // the partial sums are of the type of the column, they must not overflow before the
+        // sum of the rows does
+        if (evaluator->fn_name() == "sum" &&
+            !remove_nullable(evaluator->function()->get_return_type())
+                     ->equals(*remove_nullable(input_ctxs[0]->root()->data_type()))) {
+            return;
+        }
+        // the partial result of a column can only be aggregated by one function
+        int column_id = static_cast<VSlotRef*>(input_ctxs[0]->root())->column_id();
+        auto [it, inserted] =
+                pre_aggregation.agg_functions.emplace(column_id, evaluator->fn_name());
+        if (!inserted && it->second != evaluator->fn_name()) {
+            return;
+        }
+    }
+    static_cast<VOlapScanNode*>(child(0))->set_pre_aggregation(std::move(pre_aggregation));
+}
+
+Status AggregationNode::open(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
+    SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_ERR_CB("aggregator, while execute open.");
+    RETURN_IF_ERROR(alloc_resource(state));
 
     RETURN_IF_ERROR(_children[0]->open(state));
 
-    // Streaming preaggregations do all processing in GetNext().
-    if (_is_streaming_preagg) return Status::OK();
+    // Streaming preaggregations and sorted aggregations do all processing in GetNext().
+    if (_is_streaming_preagg || _is_sorted_agg) return Status::OK();
 
     bool eos = false;
     Block block;
@@ -354,11 +603,55 @@ Status AggregationNode::open(RuntimeState* state) {
         RETURN_IF_CANCELLED(state);
         release_block_memory(block);
         RETURN_IF_ERROR(_children[0]->get_next(state, &block, &eos));
-        if (block.rows() == 0) {
-            continue;
-        }
-        RETURN_IF_ERROR(_executor.execute(&block));
+        RETURN_IF_ERROR(sink(state, &block, eos));
+    }
+
+    return Status::OK();
+}
+
+Status AggregationNode::alloc_resource(RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::open(state));
+
+    RETURN_IF_ERROR(VExpr::open(_probe_expr_ctxs, state));
+
+    for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+        RETURN_IF_ERROR(_aggregate_evaluators[i]->open(state));
+    }
+    return Status::OK();
+}
+
+Status AggregationNode::sink(RuntimeState* state, Block* in_block, bool eos) {
+    DCHECK(!_is_streaming_preagg);
+    if (in_block->rows() > 0) {
+        _common_exprs.reset(in_block);
+        RETURN_IF_ERROR(_executor.execute(in_block));
         _executor.update_memusage();
+        if (_should_spill(state)) {
+            RETURN_IF_ERROR(_spill_hash_table(state));
+        }
+    }
+
+    if (eos && _is_sorted_agg) {
+        // the last group is closed by the end of the input
+        if (!_sorted_open_key.empty()) {
+            ColumnRawPtrs key_columns;
+            for (const auto& column : _sorted_open_key) {
+                key_columns.push_back(column.get());
+            }
+            _close_sorted_group(key_columns, 0, _sorted_places[0]);
+            _sorted_open_key.clear();
+        }
+        _sorted_input_eos = true;
+    }
+
+    if (eos && !_spill_partitions.empty()) {
+        // the keys left in the hash table may also exist in the spilled partitions,
+        // so spill them too and then merge the partitions one by one.
+        RETURN_IF_ERROR(_spill_hash_table(state));
+        for (auto& partition : _spill_partitions) {
+            RETURN_IF_ERROR(partition->done_write());
+        }
+        RETURN_IF_ERROR(_merge_next_spill_partition(state));
     }
 
     return Status::OK();
@@ -370,6 +663,8 @@ Status AggregationNode::get_next(RuntimeState* state, RowBatch* row_batch, bool*
 
 Status AggregationNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(mem_tracker());
     SCOPED_SWITCH_THREAD_LOCAL_MEM_TRACKER_ERR_CB("aggregator, while execute get_next.");
 
@@ -383,26 +678,50 @@ Status AggregationNode::get_next(RuntimeState* state, Block* block, bool* eos) {
         } while (_preagg_block.rows() == 0 && !child_eos);
 
         if (_preagg_block.rows() != 0) {
+            _common_exprs.reset(&_preagg_block);
             RETURN_IF_ERROR(_executor.pre_agg(&_preagg_block, block));
         } else {
             RETURN_IF_ERROR(_executor.get_result(state, block, eos));
         }
-        // pre stream agg need use _num_row_return to decide whether to do pre stream agg
         _num_rows_returned += block->rows();
         _make_nullable_output_key(block);
         COUNTER_SET(_rows_returned_counter, _num_rows_returned);
+    } else if (_is_sorted_agg) {
+        // read the input until a batch of groups is closed
+        while (!_sorted_input_eos && (_sorted_result_columns.empty() ||
+                                      _sorted_result_columns[0]->size() < state->batch_size())) {
+            RETURN_IF_CANCELLED(state);
+            bool child_eos = false;
+            release_block_memory(_preagg_block);
+            RETURN_IF_ERROR(_children[0]->get_next(state, &_preagg_block, &child_eos));
+            RETURN_IF_ERROR(sink(state, &_preagg_block, child_eos));
+        }
+        RETURN_IF_ERROR(pull(state, block, eos));
     } else {
-        RETURN_IF_ERROR(_executor.get_result(state, block, eos));
-        _make_nullable_output_key(block);
-        // dispose the having clause, should not be execute in prestreaming agg
-        RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns()));
-        reached_limit(block, eos);
+        RETURN_IF_ERROR(pull(state, block, eos));
     }
 
     _executor.update_memusage();
     return Status::OK();
 }
 
+Status AggregationNode::pull(RuntimeState* state, Block* block, bool* eos) {
+    DCHECK(!_is_streaming_preagg);
+    do {
+        RETURN_IF_ERROR(_executor.get_result(state, block, eos));
+        // the hash table only holds one spilled partition, continue with the next one
+        if (*eos && _next_spill_partition < _spill_partitions.size()) {
+            RETURN_IF_ERROR(_merge_next_spill_partition(state));
+            *eos = false;
+        }
+    } while (block->rows() == 0 && !*eos);
+    _make_nullable_output_key(block);
+    // dispose the having clause, should not be execute in prestreaming agg
+    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns()));
+    reached_limit(block, eos);
+    return Status::OK();
+}
+
 Status AggregationNode::close(RuntimeState* state) {
     if (is_closed()) return Status::OK();
 
@@ -516,6 +835,19 @@ Status AggregationNode::_serialize_without_key(RuntimeState* state, Block* block
 Status AggregationNode::_execute_without_key(Block* block) {
     DCHECK(_agg_data.without_key != nullptr);
     SCOPED_TIMER(_build_timer);
+    if (block->has_selection()) {
+        // the rows not selected have no place to add to
+        const auto& selection = block->selection();
+        PODArray<AggregateDataPtr> places(selection.size());
+        for (size_t i = 0; i < selection.size(); ++i) {
+            places[i] = selection[i] ? _agg_data.without_key : nullptr;
+        }
+        for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
+            _aggregate_evaluators[i]->execute_batch_add(block, _offsets_of_aggregate_states[i],
+                                                        places.data(), &_agg_arena_pool);
+        }
+        return Status::OK();
+    }
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
         _aggregate_evaluators[i]->execute_single_add(
                 block, _agg_data.without_key + _offsets_of_aggregate_states[i], &_agg_arena_pool);
@@ -579,8 +911,6 @@ void AggregationNode::_make_nullable_output_key(Block* block) {
 }
 
 bool AggregationNode::_should_expand_preagg_hash_tables() {
-    if (!_should_expand_hash_table) return false;
-
     return std::visit(
             [&](auto&& agg_method) -> bool {
                 auto& hash_tbl = agg_method.data;
@@ -599,34 +929,70 @@ bool AggregationNode::_should_expand_preagg_hash_tables() {
 
                 // Compare the number of rows in the hash table with the number of input rows that
                 // were aggregated into it. Exclude passed through rows from this calculation since
-                // they were not in hash tables.
-                const int64_t input_rows = _children[0]->rows_returned();
-                const int64_t aggregated_input_rows = input_rows - _num_rows_returned;
-                // TODO chenhao
-                //  const int64_t expected_input_rows = estimated_input_cardinality_ - num_rows_returned_;
-                double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
-
-                // TODO: workaround for IMPALA-2490: subplan node rows_returned counter may be
-                // inaccurate, which could lead to a divide by zero below.
+                // they were not in hash tables. The input rows are counted by the node itself, the
+                // rows_returned() of the child is not maintained by every vectorized node.
+                const int64_t aggregated_input_rows =
+                        _num_preagg_input_rows - _num_passthrough_rows;
                 if (aggregated_input_rows <= 0) return true;
 
-                // Extrapolate the current reduction factor (r) using the formula
-                // R = 1 + (N / n) * (r - 1), where R is the reduction factor over the full input data
-                // set, N is the number of input rows, excluding passed-through rows, and n is the
-                // number of rows inserted or merged into the hash tables. This is a very rough
-                // approximation but is good enough to be useful.
-                // TODO: consider collecting more statistics to better estimate reduction.
-                //  double estimated_reduction = aggregated_input_rows >= expected_input_rows
-                //      ? current_reduction
-                //      : 1 + (expected_input_rows / aggregated_input_rows) * (current_reduction - 1);
+                double current_reduction = static_cast<double>(aggregated_input_rows) / ht_rows;
                 double min_reduction =
                         STREAMING_HT_MIN_REDUCTION[cache_level].streaming_ht_min_reduction;
 
-                //  COUNTER_SET(preagg_estimated_reduction_, estimated_reduction);
-                //    COUNTER_SET(preagg_streaming_ht_min_reduction_, min_reduction);
-                //  return estimated_reduction > min_reduction;
-                _should_expand_hash_table = current_reduction > min_reduction;
-                return _should_expand_hash_table;
+                COUNTER_SET(_preagg_estimated_reduction_counter, current_reduction);
+                COUNTER_SET(_preagg_streaming_ht_min_reduction_counter, min_reduction);
+                return current_reduction > min_reduction;
+            },
+            _agg_data._aggregated_method_variant);
+}
+
+void AggregationNode::_emplace_into_hash_table(AggregateDataPtr* places,
+                                               ColumnRawPtrs& key_columns, size_t rows,
+                                               const IColumn::Filter* selection) {
+    std::visit(
+            [&](auto&& agg_method) -> void {
+                using HashMethodType = std::decay_t<decltype(agg_method)>;
+                using AggState = typename HashMethodType::State;
+                AggState state(key_columns, _probe_key_sz, nullptr);
+                constexpr bool prefetchable =
+                        ColumnsHashing::is_batch_prefetchable_v<AggState,
+                                                                typename HashMethodType::Data>;
+                ColumnsHashing::BatchHashPrefetcher prefetcher(
+                        state, agg_method.data, _agg_arena_pool, rows,
+                        config::vec_hash_table_prefetch_distance);
+                /// For all rows.
+                for (size_t i = 0; i < rows; ++i) {
+                    if (selection != nullptr && !(*selection)[i]) {
+                        places[i] = nullptr;
+                        continue;
+                    }
+                    AggregateDataPtr aggregate_data = nullptr;
+
+                    auto emplace_result = [&]() {
+                        if constexpr (prefetchable) {
+                            return state.emplace_key(agg_method.data, prefetcher.get_hash(i), i,
+                                                     _agg_arena_pool);
+                        } else {
+                            return state.emplace_key(agg_method.data, i, _agg_arena_pool);
+                        }
+                    }();
+
+                    /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
+                    if (emplace_result.is_inserted()) {
+                        /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
+                        emplace_result.set_mapped(nullptr);
+
+                        aggregate_data = _agg_arena_pool.aligned_alloc(
+                                _total_size_of_aggregate_states, _align_aggregate_states);
+                        _create_agg_status(aggregate_data);
+
+                        emplace_result.set_mapped(aggregate_data);
+                    } else
+                        aggregate_data = emplace_result.get_mapped();
+
+                    places[i] = aggregate_data;
+                    assert(places[i] != nullptr);
+                }
             },
             _agg_data._aggregated_method_variant);
 }
@@ -709,6 +1075,8 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
                                         value_buffer_writers[i]);
                                 value_buffer_writers[i].commit();
                             }
+                            // the places are reused by the next passed through block
+                            _destory_agg_status(_streaming_pre_places[j]);
                         }
 
                         if (!mem_reuse) {
@@ -736,37 +1104,12 @@ Status AggregationNode::_pre_agg_with_serialized_key(doris::vectorized::Block* i
             },
             _agg_data._aggregated_method_variant);
 
-    if (!ret_flag) {
-        std::visit(
-                [&](auto&& agg_method) -> void {
-                    using HashMethodType = std::decay_t<decltype(agg_method)>;
-                    using AggState = typename HashMethodType::State;
-                    AggState state(key_columns, _probe_key_sz, nullptr);
-                    /// For all rows.
-                    for (size_t i = 0; i < rows; ++i) {
-                        AggregateDataPtr aggregate_data = nullptr;
-
-                        auto emplace_result =
-                                state.emplace_key(agg_method.data, i, _agg_arena_pool);
-
-                        /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
-                        if (emplace_result.is_inserted()) {
-                            /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
-                            emplace_result.set_mapped(nullptr);
-
-                            aggregate_data = _agg_arena_pool.aligned_alloc(
-                                    _total_size_of_aggregate_states, _align_aggregate_states);
-                            _create_agg_status(aggregate_data);
-
-                            emplace_result.set_mapped(aggregate_data);
-                        } else
-                            aggregate_data = emplace_result.get_mapped();
-
-                        places[i] = aggregate_data;
-                        assert(places[i] != nullptr);
-                    }
-                },
-                _agg_data._aggregated_method_variant);
+    _num_preagg_input_rows += rows;
+    if (ret_flag) {
+        _num_passthrough_rows += rows;
+        COUNTER_SET(_passthrough_rows_counter, _num_passthrough_rows);
+    } else {
+        _emplace_into_hash_table(places.data(), key_columns, rows);
 
         for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
             _aggregate_evaluators[i]->execute_batch_add(in_block, _offsets_of_aggregate_states[i],
@@ -798,35 +1141,10 @@ Status AggregationNode::_execute_with_serialized_key(Block* block) {
     int rows = block->rows();
     PODArray<AggregateDataPtr> places(rows);
 
-    std::visit(
-            [&](auto&& agg_method) -> void {
-                using HashMethodType = std::decay_t<decltype(agg_method)>;
-                using AggState = typename HashMethodType::State;
-                AggState state(key_columns, _probe_key_sz, nullptr);
-                /// For all rows.
-                for (size_t i = 0; i < rows; ++i) {
-                    AggregateDataPtr aggregate_data = nullptr;
-
-                    auto emplace_result = state.emplace_key(agg_method.data, i, _agg_arena_pool);
-
-                    /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
-                    if (emplace_result.is_inserted()) {
-                        /// exception-safety - if you can not allocate memory or create states, then destructors will not be called.
-                        emplace_result.set_mapped(nullptr);
-
-                        aggregate_data = _agg_arena_pool.aligned_alloc(
-                                _total_size_of_aggregate_states, _align_aggregate_states);
-                        _create_agg_status(aggregate_data);
-
-                        emplace_result.set_mapped(aggregate_data);
-                    } else
-                        aggregate_data = emplace_result.get_mapped();
-
-                    places[i] = aggregate_data;
-                    assert(places[i] != nullptr);
-                }
-            },
-            _agg_data._aggregated_method_variant);
+    _emplace_into_hash_table(places.data(), key_columns, rows,
+                             block->has_selection() ? &block->selection() : nullptr);
+    // the places point to the arena, they are still valid after the conversion
+    _convert_to_two_level_if_needed();
 
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
         _aggregate_evaluators[i]->execute_batch_add(block, _offsets_of_aggregate_states[i],
@@ -1003,15 +1321,29 @@ Status AggregationNode::_serialize_with_serialized_key_result(RuntimeState* stat
 }
 
 Status AggregationNode::_merge_with_serialized_key(Block* block) {
+    return _merge_with_serialized_key_helper<false>(block);
+}
+
+Status AggregationNode::_merge_spilled_block(Block* block) {
+    return _merge_with_serialized_key_helper<true>(block);
+}
+
+template <bool is_spilled_block>
+Status AggregationNode::_merge_with_serialized_key_helper(Block* block) {
     SCOPED_TIMER(_merge_timer);
 
     size_t key_size = _probe_expr_ctxs.size();
     ColumnRawPtrs key_columns(key_size);
 
     for (size_t i = 0; i < key_size; ++i) {
-        int result_column_id = -1;
-        RETURN_IF_ERROR(_probe_expr_ctxs[i]->execute(block, &result_column_id));
-        key_columns[i] = block->get_by_position(result_column_id).column.get();
+        if constexpr (is_spilled_block) {
+            // spilled block is already in the layout of [keys..., serialized values...]
+            key_columns[i] = block->get_by_position(i).column.get();
+        } else {
+            int result_column_id = -1;
+            RETURN_IF_ERROR(_probe_expr_ctxs[i]->execute(block, &result_column_id));
+            key_columns[i] = block->get_by_position(result_column_id).column.get();
+        }
     }
 
     int rows = block->rows();
@@ -1022,11 +1354,24 @@ Status AggregationNode::_merge_with_serialized_key(Block* block) {
                 using HashMethodType = std::decay_t<decltype(agg_method)>;
                 using AggState = typename HashMethodType::State;
                 AggState state(key_columns, _probe_key_sz, nullptr);
+                constexpr bool prefetchable =
+                        ColumnsHashing::is_batch_prefetchable_v<AggState,
+                                                                typename HashMethodType::Data>;
+                ColumnsHashing::BatchHashPrefetcher prefetcher(
+                        state, agg_method.data, _agg_arena_pool, rows,
+                        config::vec_hash_table_prefetch_distance);
                 /// For all rows.
                 for (size_t i = 0; i < rows; ++i) {
                     AggregateDataPtr aggregate_data = nullptr;
 
-                    auto emplace_result = state.emplace_key(agg_method.data, i, _agg_arena_pool);
+                    auto emplace_result = [&]() {
+                        if constexpr (prefetchable) {
+                            return state.emplace_key(agg_method.data, prefetcher.get_hash(i), i,
+                                                     _agg_arena_pool);
+                        } else {
+                            return state.emplace_key(agg_method.data, i, _agg_arena_pool);
+                        }
+                    }();
 
                     /// If a new key is inserted, initialize the states of the aggregate functions, and possibly something related to the key.
                     if (emplace_result.is_inserted()) {
@@ -1046,11 +1391,13 @@ Status AggregationNode::_merge_with_serialized_key(Block* block) {
                 }
             },
             _agg_data._aggregated_method_variant);
+    // the places point to the arena, they are still valid after the conversion
+    _convert_to_two_level_if_needed();
 
     std::unique_ptr<char[]> deserialize_buffer(new char[_total_size_of_aggregate_states]);
 
     for (int i = 0; i < _aggregate_evaluators.size(); ++i) {
-        if (_aggregate_evaluators[i]->is_merge()) {
+        if (is_spilled_block || _aggregate_evaluators[i]->is_merge()) {
             auto column = block->get_by_position(i + key_size).column;
             if (column->is_nullable()) {
                 column = ((ColumnNullable*)column.get())->get_nested_column_ptr();
@@ -1108,6 +1455,181 @@ void AggregationNode::_close_with_serialized_key() {
     release_tracker();
 }
 
+void AggregationNode::_convert_to_two_level_if_needed() {
+    if (!_agg_data.is_convertible_to_two_level()) {
+        return;
+    }
+    bool need_convert = std::visit(
+            [&](auto&& agg_method) -> bool {
+                auto& data = agg_method.data;
+                return (config::vec_agg_two_level_hash_table_threshold_rows > 0 &&
+                        data.size() >= config::vec_agg_two_level_hash_table_threshold_rows) ||
+                       (config::vec_agg_two_level_hash_table_threshold_bytes > 0 &&
+                        data.get_buffer_size_in_bytes() >=
+                                config::vec_agg_two_level_hash_table_threshold_bytes);
+            },
+            _agg_data._aggregated_method_variant);
+    if (need_convert) {
+        SCOPED_TIMER(_convert_to_two_level_timer);
+        _agg_data.convert_to_two_level();
+    }
+}
+
+bool AggregationNode::_should_spill(RuntimeState* state) {
+    return _spill_enabled &&
+           BlockSpillStream::should_spill(state, _data_mem_tracker->consumption());
+}
+
+Status AggregationNode::_spill_hash_table(RuntimeState* state, size_t first_partition,
+                                          int depth) {
+    SCOPED_TIMER(_spill_timer);
+    size_t num_partitions = config::vec_spill_partition_count;
+    if (first_partition == _spill_partitions.size()) {
+        auto tmp_file_mgr = state->exec_env()->tmp_file_mgr();
+        for (size_t i = 0; i < num_partitions; ++i) {
+            auto partition = std::make_unique<BlockSpillStream>(tmp_file_mgr, state->query_id());
+            partition->set_io_timer(_spill_io_timer);
+            RETURN_IF_ERROR(partition->prepare());
+            _spill_partitions.emplace_back(std::move(partition));
+            _spill_partition_depths.push_back(depth);
+        }
+    }
+    DCHECK_LE(first_partition + num_partitions, _spill_partitions.size());
+
+    int64_t spilled_bytes = 0;
+    for (size_t p = first_partition; p < first_partition + num_partitions; ++p) {
+        spilled_bytes -= _spill_partitions[p]->bytes();
+    }
+
+    Block block;
+    bool eos = false;
+    while (!eos) {
+        RETURN_IF_CANCELLED(state);
+        block.clear();
+        RETURN_IF_ERROR(_serialize_with_serialized_key_result(state, &block, &eos));
+        COUNTER_UPDATE(_spill_rows_counter, block.rows());
+        RETURN_IF_ERROR(_spill_block_to_partitions(block, first_partition, depth));
+    }
+
+    for (size_t p = first_partition; p < first_partition + num_partitions; ++p) {
+        spilled_bytes += _spill_partitions[p]->bytes();
+    }
+    COUNTER_UPDATE(_spill_bytes_counter, spilled_bytes);
+
+    _reset_hash_table();
+    _executor.update_memusage();
+    return Status::OK();
+}
+
+Status AggregationNode::_spill_block_to_partitions(const Block& block, size_t first_partition,
+                                                   int depth) {
+    size_t rows = block.rows();
+    if (rows == 0) {
+        return Status::OK();
+    }
+
+    // the same key must always be spilled into the same partition, so the partition
+    // is decided by the hash value of the keys, seeded by the depth so that the keys of a
+    // partition split again don't fall into the same sub-partition.
+    size_t key_size = _probe_expr_ctxs.size();
+    std::vector<SipHash> siphashs(rows, SipHash(depth, 0));
+    for (size_t i = 0; i < key_size; ++i) {
+        const auto& column = block.get_by_position(i).column;
+        for (size_t j = 0; j < rows; ++j) {
+            column->update_hash_with_value(j, siphashs[j]);
+        }
+    }
+
+    size_t num_partitions = config::vec_spill_partition_count;
+    IColumn::Selector selector(rows);
+    for (size_t j = 0; j < rows; ++j) {
+        selector[j] = siphashs[j].get64() % num_partitions;
+    }
+
+    std::vector<MutableColumns> partition_columns(num_partitions);
+    for (size_t i = 0; i < block.columns(); ++i) {
+        auto scattered_columns = block.get_by_position(i).column->scatter(num_partitions, selector);
+        for (size_t p = 0; p < num_partitions; ++p) {
+            partition_columns[p].emplace_back(std::move(scattered_columns[p]));
+        }
+    }
+
+    for (size_t p = 0; p < num_partitions; ++p) {
+        Block partition_block = block.clone_with_columns(std::move(partition_columns[p]));
+        RETURN_IF_ERROR(_spill_partitions[first_partition + p]->add_block(partition_block));
+    }
+    return Status::OK();
+}
+
+Status AggregationNode::_merge_next_spill_partition(RuntimeState* state) {
+    DCHECK_LT(_next_spill_partition, _spill_partitions.size());
+    SCOPED_TIMER(_spill_timer);
+    _reset_hash_table();
+
+    size_t index = _next_spill_partition++;
+    int depth = _spill_partition_depths[index];
+    // moved out since the sub-partitions are appended to _spill_partitions
+    BlockSpillStreamPtr partition = std::move(_spill_partitions[index]);
+    // the index of the first sub-partition if the partition is split again
+    size_t sub_partitions = 0;
+    Block block;
+    bool eos = false;
+    while (true) {
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(partition->get_next(&block, &eos));
+        if (eos) {
+            break;
+        }
+        RETURN_IF_ERROR(_merge_spilled_block(&block));
+        _executor.update_memusage();
+        if (_should_spill(state)) {
+            if (depth >= config::vec_spill_max_repartition_depth) {
+                return Status::MemoryLimitExceeded(strings::Substitute(
+                        "the spilled partition of aggregation node $0 still exceeds the memory "
+                        "limit after being split $1 times",
+                        id(), depth));
+            }
+            if (sub_partitions == 0) {
+                sub_partitions = _spill_partitions.size();
+            }
+            RETURN_IF_ERROR(_spill_hash_table(state, sub_partitions, depth + 1));
+        }
+    }
+    // remove the tmp file as soon as the partition is merged
+    partition.reset();
+    if (sub_partitions != 0) {
+        // the keys left in the hash table may also exist in the sub-partitions, which are
+        // merged after the other partitions
+        RETURN_IF_ERROR(_spill_hash_table(state, sub_partitions, depth + 1));
+        for (size_t p = sub_partitions; p < _spill_partitions.size(); ++p) {
+            RETURN_IF_ERROR(_spill_partitions[p]->done_write());
+        }
+    }
+    return Status::OK();
+}
+
+void AggregationNode::_reset_hash_table() {
+    std::visit(
+            [&](auto&& agg_method) -> void {
+                auto& data = agg_method.data;
+                data.for_each_mapped([&](auto& mapped) {
+                    if (mapped) {
+                        _destory_agg_status(mapped);
+                        mapped = nullptr;
+                    }
+                });
+                if (data.has_null_key_data()) {
+                    _destory_agg_status(data.get_null_key_data());
+                }
+            },
+            _agg_data._aggregated_method_variant);
+    // re-create the hash method, which also resets the iterator of the result
+    _init_hash_method(_probe_expr_ctxs);
+    _agg_arena_pool.clear();
+    release_tracker();
+    _mem_usage_record = MemoryRecord();
+}
+
 void AggregationNode::release_tracker() {
     _data_mem_tracker->release(_mem_usage_record.used_in_state + _mem_usage_record.used_in_arena);
 }
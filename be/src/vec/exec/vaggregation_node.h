@@ -25,7 +25,11 @@
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/common/columns_hashing.h"
 #include "vec/common/hash_table/fixed_hash_map.h"
+#include "vec/common/hash_table/string_hash_map.h"
+#include "vec/common/hash_table/two_level_hash_map.h"
+#include "vec/exprs/vcommon_exprs.h"
 #include "vec/exprs/vectorized_agg_fn.h"
+#include "vec/runtime/vspill_stream.h"
 
 namespace doris {
 class TPlanNode;
@@ -74,6 +78,39 @@ struct AggregationMethodSerialized {
 
 using AggregatedDataWithoutKey = AggregateDataPtr;
 using AggregatedDataWithStringKey = HashMapWithSavedHash<StringRef, AggregateDataPtr>;
+using AggregatedDataWithStringKeyTwoLevel =
+        TwoLevelHashMapWithSavedHash<StringRef, AggregateDataPtr>;
+using AggregatedDataWithShortStringKey = StringHashMap<AggregateDataPtr>;
+
+/// For the case where there is one string key, the key is not serialized but used as it
+/// is, and the short keys are stored inline by the StringHashMap.
+template <typename TData>
+struct AggregationMethodStringNoCache {
+    using Data = TData;
+    using Key = typename Data::key_type;
+    using Mapped = typename Data::mapped_type;
+    using Iterator = typename Data::iterator;
+
+    Data data;
+    Iterator iterator;
+    bool inited = false;
+
+    AggregationMethodStringNoCache() = default;
+
+    using State = ColumnsHashing::HashMethodString<typename Data::value_type, Mapped, true, false>;
+
+    static void insert_key_into_columns(const StringRef& key, MutableColumns& key_columns,
+                                        const Sizes&) {
+        key_columns[0]->insert_data(key.data, key.size);
+    }
+
+    void init_once() {
+        if (!inited) {
+            inited = true;
+            iterator = data.begin();
+        }
+    }
+};
 
 /// For the case where there is one numeric key.
 /// FieldType is UInt8/16/32/64 for any type with corresponding bit width.
@@ -117,6 +154,15 @@ template <typename Base>
 struct AggregationDataWithNullKey : public Base {
     using Base::Base;
 
+    AggregationDataWithNullKey() = default;
+
+    // Used to convert a single level hash table to a two level one.
+    template <typename Other>
+    explicit AggregationDataWithNullKey(const Other& other) : Base(other) {
+        has_null_key = other.has_null_key_data();
+        null_key_data = other.get_null_key_data();
+    }
+
     bool& has_null_key_data() { return has_null_key; }
     AggregateDataPtr& get_null_key_data() { return null_key_data; }
     bool has_null_key_data() const { return has_null_key; }
@@ -259,6 +305,24 @@ using AggregatedDataWithNullableUInt32Key = AggregationDataWithNullKey<Aggregate
 using AggregatedDataWithNullableUInt64Key = AggregationDataWithNullKey<AggregatedDataWithUInt64Key>;
 using AggregatedDataWithNullableUInt128Key =
         AggregationDataWithNullKey<AggregatedDataWithUInt128Key>;
+using AggregatedDataWithNullableShortStringKey =
+        AggregationDataWithNullKey<AggregatedDataWithShortStringKey>;
+
+using AggregatedDataWithUInt32KeyTwoLevel =
+        TwoLevelHashMap<UInt32, AggregateDataPtr, HashCRC32<UInt32>>;
+using AggregatedDataWithUInt64KeyTwoLevel =
+        TwoLevelHashMap<UInt64, AggregateDataPtr, HashCRC32<UInt64>>;
+using AggregatedDataWithUInt128KeyTwoLevel =
+        TwoLevelHashMap<UInt128, AggregateDataPtr, HashCRC32<UInt128>>;
+using AggregatedDataWithUInt256KeyTwoLevel =
+        TwoLevelHashMap<UInt256, AggregateDataPtr, HashCRC32<UInt256>>;
+
+using AggregatedDataWithNullableUInt32KeyTwoLevel =
+        AggregationDataWithNullKey<AggregatedDataWithUInt32KeyTwoLevel>;
+using AggregatedDataWithNullableUInt64KeyTwoLevel =
+        AggregationDataWithNullKey<AggregatedDataWithUInt64KeyTwoLevel>;
+using AggregatedDataWithNullableUInt128KeyTwoLevel =
+        AggregationDataWithNullKey<AggregatedDataWithUInt128KeyTwoLevel>;
 
 using AggregatedMethodVariants = std::variant<
         AggregationMethodSerialized<AggregatedDataWithStringKey>,
@@ -282,7 +346,26 @@ using AggregatedMethodVariants = std::variant<
         AggregationMethodKeysFixed<AggregatedDataWithUInt128Key, false>,
         AggregationMethodKeysFixed<AggregatedDataWithUInt128Key, true>,
         AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, false>,
-        AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, true>>;
+        AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, true>,
+        AggregationMethodSerialized<AggregatedDataWithStringKeyTwoLevel>,
+        AggregationMethodOneNumber<UInt32, AggregatedDataWithUInt32KeyTwoLevel>,
+        AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64KeyTwoLevel>,
+        AggregationMethodOneNumber<UInt128, AggregatedDataWithUInt128KeyTwoLevel>,
+        AggregationMethodSingleNullableColumn<
+                AggregationMethodOneNumber<UInt32, AggregatedDataWithNullableUInt32KeyTwoLevel>>,
+        AggregationMethodSingleNullableColumn<
+                AggregationMethodOneNumber<UInt64, AggregatedDataWithNullableUInt64KeyTwoLevel>>,
+        AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                UInt128, AggregatedDataWithNullableUInt128KeyTwoLevel>>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt64KeyTwoLevel, false>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt64KeyTwoLevel, true>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt128KeyTwoLevel, false>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt128KeyTwoLevel, true>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt256KeyTwoLevel, false>,
+        AggregationMethodKeysFixed<AggregatedDataWithUInt256KeyTwoLevel, true>,
+        AggregationMethodStringNoCache<AggregatedDataWithShortStringKey>,
+        AggregationMethodSingleNullableColumn<
+                AggregationMethodStringNoCache<AggregatedDataWithNullableShortStringKey>>>;
 
 struct AggregatedDataVariants {
     AggregatedDataVariants() = default;
@@ -303,13 +386,18 @@ struct AggregatedDataVariants {
         int128_key,
         int64_keys,
         int128_keys,
-        int256_keys
+        int256_keys,
+        string_key
     };
 
     Type _type = Type::EMPTY;
+    bool _is_nullable = false;
+    bool _is_two_level = false;
 
     void init(Type type, bool is_nullable = false) {
         _type = type;
+        _is_nullable = is_nullable;
+        _is_two_level = false;
         switch (_type) {
         case Type::without_key:
             break;
@@ -392,15 +480,130 @@ struct AggregatedDataVariants {
                         .emplace<AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, false>>();
             }
             break;
+        case Type::string_key:
+            if (is_nullable) {
+                _aggregated_method_variant.emplace<
+                        AggregationMethodSingleNullableColumn<AggregationMethodStringNoCache<
+                                AggregatedDataWithNullableShortStringKey>>>();
+            } else {
+                _aggregated_method_variant.emplace<
+                        AggregationMethodStringNoCache<AggregatedDataWithShortStringKey>>();
+            }
+            break;
         default:
             DCHECK(false) << "Do not have a rigth agg data type";
         }
     }
+
+    // The int8 and int16 keys use fixed hash maps, which never grow. The string key uses
+    // a StringHashMap, whose sub tables already grow separately.
+    bool is_convertible_to_two_level() const {
+        return !_is_two_level && _type != Type::EMPTY && _type != Type::without_key &&
+               _type != Type::int8_key && _type != Type::int16_key && _type != Type::string_key;
+    }
+
+    // Move all the data into the two level hash table of the same key type. The aggregate
+    // states are moved as they are, and the iterator of the result is invalidated.
+    void convert_to_two_level() {
+        DCHECK(is_convertible_to_two_level());
+        switch (_type) {
+        case Type::serialized:
+            _convert<AggregationMethodSerialized<AggregatedDataWithStringKey>,
+                     AggregationMethodSerialized<AggregatedDataWithStringKeyTwoLevel>>();
+            break;
+        case Type::int32_key:
+            if (_is_nullable) {
+                _convert<AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt32, AggregatedDataWithNullableUInt32Key>>,
+                         AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt32, AggregatedDataWithNullableUInt32KeyTwoLevel>>>();
+            } else {
+                _convert<AggregationMethodOneNumber<UInt32, AggregatedDataWithUInt32Key>,
+                         AggregationMethodOneNumber<UInt32, AggregatedDataWithUInt32KeyTwoLevel>>();
+            }
+            break;
+        case Type::int64_key:
+            if (_is_nullable) {
+                _convert<AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt64, AggregatedDataWithNullableUInt64Key>>,
+                         AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt64, AggregatedDataWithNullableUInt64KeyTwoLevel>>>();
+            } else {
+                _convert<AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64Key>,
+                         AggregationMethodOneNumber<UInt64, AggregatedDataWithUInt64KeyTwoLevel>>();
+            }
+            break;
+        case Type::int128_key:
+            if (_is_nullable) {
+                _convert<AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt128, AggregatedDataWithNullableUInt128Key>>,
+                         AggregationMethodSingleNullableColumn<AggregationMethodOneNumber<
+                                 UInt128, AggregatedDataWithNullableUInt128KeyTwoLevel>>>();
+            } else {
+                _convert<
+                        AggregationMethodOneNumber<UInt128, AggregatedDataWithUInt128Key>,
+                        AggregationMethodOneNumber<UInt128, AggregatedDataWithUInt128KeyTwoLevel>>();
+            }
+            break;
+        case Type::int64_keys:
+            if (_is_nullable) {
+                _convert<AggregationMethodKeysFixed<AggregatedDataWithUInt64Key, true>,
+                         AggregationMethodKeysFixed<AggregatedDataWithUInt64KeyTwoLevel, true>>();
+            } else {
+                _convert<AggregationMethodKeysFixed<AggregatedDataWithUInt64Key, false>,
+                         AggregationMethodKeysFixed<AggregatedDataWithUInt64KeyTwoLevel, false>>();
+            }
+            break;
+        case Type::int128_keys:
+            if (_is_nullable) {
+                _convert<AggregationMethodKeysFixed<AggregatedDataWithUInt128Key, true>,
+                         AggregationMethodKeysFixed<AggregatedDataWithUInt128KeyTwoLevel, true>>();
+            } else {
+                _convert<
+                        AggregationMethodKeysFixed<AggregatedDataWithUInt128Key, false>,
+                        AggregationMethodKeysFixed<AggregatedDataWithUInt128KeyTwoLevel, false>>();
+            }
+            break;
+        case Type::int256_keys:
+            if (_is_nullable) {
+                _convert<AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, true>,
+                         AggregationMethodKeysFixed<AggregatedDataWithUInt256KeyTwoLevel, true>>();
+            } else {
+                _convert<
+                        AggregationMethodKeysFixed<AggregatedDataWithUInt256Key, false>,
+                        AggregationMethodKeysFixed<AggregatedDataWithUInt256KeyTwoLevel, false>>();
+            }
+            break;
+        default:
+            DCHECK(false) << "Do not have a two level hash table for agg data type";
+            return;
+        }
+        _is_two_level = true;
+    }
+
+private:
+    template <typename Method, typename TwoLevelMethod>
+    void _convert() {
+        // The variant is replaced in place, so move the old hash table out first.
+        Method method(std::move(std::get<Method>(_aggregated_method_variant)));
+        _aggregated_method_variant.emplace<TwoLevelMethod>(method);
+    }
 };
 
 using AggregatedDataVariantsPtr = std::shared_ptr<AggregatedDataVariants>;
 
-// not support spill
+// When spilling is enabled for the query and the query memory goes beyond
+// config::vec_spill_mem_limit_percent of its limit, the hash table with keys is
+// serialized, hash partitioned by the group by keys and written to BlockSpillStreams.
+// After all the input is consumed, the partitions are merged back and output one by one.
+//
+// The hash table starts as a single level one, and is converted to a two level one of
+// 256 buckets when it grows beyond config::vec_agg_two_level_hash_table_threshold_rows
+// rows or config::vec_agg_two_level_hash_table_threshold_bytes bytes.
+//
+// If the input is ordered by the keys grouped by, e.g. it's returned by a sort or a merging
+// exchange, the rows of a group are consecutive. The groups are then aggregated one by one
+// without hash table, and each group is returned once a row of the next group is read.
 class AggregationNode : public ::doris::ExecNode {
 public:
     using Sizes = std::vector<size_t>;
@@ -414,6 +617,16 @@ public:
     virtual Status get_next(RuntimeState* state, Block* block, bool* eos);
     virtual Status close(RuntimeState* state);
 
+    // Interfaces of the pipeline engine, which pushes the input blocks instead of
+    // pulling them from the child. Not used by streaming preaggregation.
+    // Open the node itself without opening its child.
+    Status alloc_resource(RuntimeState* state);
+    // Aggregate one input block, 'eos' means it is the last one.
+    Status sink(RuntimeState* state, Block* in_block, bool eos);
+    // Get the aggregation result after all input was sunk.
+    Status pull(RuntimeState* state, Block* block, bool* eos);
+    bool is_streaming_preagg() const { return _is_streaming_preagg; }
+
 private:
     // group by k1,k2
     std::vector<VExprContext*> _probe_expr_ctxs;
@@ -423,6 +636,8 @@ private:
     std::vector<size_t> _probe_key_sz;
 
     std::vector<AggFnEvaluator*> _aggregate_evaluators;
+    // the subexpressions shared by the grouping exprs and the inputs of the aggregate functions
+    VCommonExprs _common_exprs;
 
     // may be we don't have to know the tuple id
     TupleId _intermediate_tuple_id;
@@ -452,11 +667,44 @@ private:
     RuntimeProfile::Counter* _merge_timer;
     RuntimeProfile::Counter* _expr_timer;
     RuntimeProfile::Counter* _get_results_timer;
+    RuntimeProfile::Counter* _convert_to_two_level_timer;
 
     bool _is_streaming_preagg;
     Block _preagg_block = Block();
-    bool _should_expand_hash_table = true;
     std::vector<char*> _streaming_pre_places;
+    // the statistics to decide whether the preaggregation should keep expanding the hash
+    // table or pass the input blocks through
+    int64_t _num_preagg_input_rows = 0;
+    int64_t _num_passthrough_rows = 0;
+    RuntimeProfile::Counter* _passthrough_rows_counter = nullptr;
+    RuntimeProfile::Counter* _preagg_estimated_reduction_counter = nullptr;
+    RuntimeProfile::Counter* _preagg_streaming_ht_min_reduction_counter = nullptr;
+
+    bool _spill_enabled = false;
+    std::vector<BlockSpillStreamPtr> _spill_partitions;
+    // the times each partition has been split, a partition still too big to be merged back is
+    // split again into partitions appended to _spill_partitions
+    std::vector<int> _spill_partition_depths;
+    // the index of the next spilled partition to be merged back
+    size_t _next_spill_partition = 0;
+
+    RuntimeProfile::Counter* _spill_timer;
+    RuntimeProfile::Counter* _spill_io_timer;
+    RuntimeProfile::Counter* _spill_rows_counter;
+    RuntimeProfile::Counter* _spill_bytes_counter;
+
+    // the input is ordered by the keys grouped by, see _execute_sorted()
+    bool _is_sorted_agg = false;
+    bool _sorted_input_eos = false;
+    // the key of the open group, which is the group of the last row of the input so far,
+    // empty if no row is read yet
+    MutableColumns _sorted_open_key;
+    // the aggregate states of the groups of the current input block, the first one is of
+    // the open group between the blocks
+    std::vector<AggregateDataPtr> _sorted_places;
+    // the groups closed and not returned yet, in the layout of `_sorted_result_schema`
+    MutableColumns _sorted_result_columns;
+    ColumnsWithTypeAndName _sorted_result_schema;
 
 private:
     /// Return true if we should keep expanding hash tables in the preagg. If false,
@@ -480,9 +728,46 @@ private:
     Status _pre_agg_with_serialized_key(Block* in_block, Block* out_block);
     Status _execute_with_serialized_key(Block* block);
     Status _merge_with_serialized_key(Block* block);
+    // Merge the block in the layout of `_serialize_with_serialized_key_result`, which
+    // is how the hash table is spilled.
+    Status _merge_spilled_block(Block* block);
+    template <bool is_spilled_block>
+    Status _merge_with_serialized_key_helper(Block* block);
     void _update_memusage_with_serialized_key();
     void _close_with_serialized_key();
     void _init_hash_method(std::vector<VExprContext*>& probe_exprs);
+    // Return true if the rows of the child are ordered by all the keys grouped by first.
+    bool _is_input_ordered_by_keys() const;
+    // Aggregate the groups of the rows ordered by the keys, the groups closed by the block are
+    // appended to `_sorted_result_columns`.
+    Status _execute_sorted(Block* block);
+    void _close_sorted_group(const ColumnRawPtrs& key_columns, size_t row,
+                             AggregateDataPtr place);
+    Status _get_sorted_result(RuntimeState* state, Block* block, bool* eos);
+    void _close_sorted();
+    // Let the olap scan below partially aggregate the rows, if the keys grouped by and the
+    // arguments of the aggregate functions are all its slots.
+    void _push_pre_aggregation_to_scan();
+    // Find or create the aggregate states of the keys, `places[i]` is set to the state of
+    // the i-th row, or nullptr if the row isn't selected by `selection`.
+    void _emplace_into_hash_table(AggregateDataPtr* places, ColumnRawPtrs& key_columns,
+                                  size_t rows, const IColumn::Filter* selection = nullptr);
+    // Convert the hash table to a two level one once it grows big enough, so that it
+    // is resized one bucket at a time.
+    void _convert_to_two_level_if_needed();
+
+    bool _should_spill(RuntimeState* state);
+    // Write all the data of the hash table to the config::vec_spill_partition_count spill
+    // partitions from `first_partition` and reset it, the partitions are created by the first
+    // spill into them. The keys are hashed with the split depth of the partitions, so the keys
+    // of a partition split again are spread over its sub-partitions.
+    Status _spill_hash_table(RuntimeState* state, size_t first_partition = 0, int depth = 0);
+    Status _spill_block_to_partitions(const Block& block, size_t first_partition, int depth);
+    // Load the next spilled partition into the (empty) hash table. If the memory still goes
+    // beyond the limit, the partition is split again into new partitions.
+    Status _merge_next_spill_partition(RuntimeState* state);
+    // Destroy all the aggregate states and release the memory of the hash table.
+    void _reset_hash_table();
 
     void release_tracker();
 
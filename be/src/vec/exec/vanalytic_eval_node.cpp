@@ -17,6 +17,7 @@
 
 #include "vec/exec/vanalytic_eval_node.h"
 
+#include "common/config.h"
 #include "exprs/agg_fn_evaluator.h"
 #include "exprs/anyval_util.h"
 #include "runtime/descriptors.h"
@@ -146,11 +147,14 @@ Status VAnalyticEvalNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status VAnalyticEvalNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(ExecNode::prepare(state));
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
     DCHECK(child(0)->row_desc().is_prefix_of(row_desc()));
     _mem_pool.reset(new MemPool(mem_tracker().get()));
     _evaluation_timer = ADD_TIMER(runtime_profile(), "EvaluationTime");
+    _segment_tree_build_timer = ADD_TIMER(runtime_profile(), "SegmentTreeBuildTime");
     SCOPED_TIMER(_evaluation_timer);
 
     _intermediate_tuple_desc = state->desc_tbl().get_tuple_descriptor(_intermediate_tuple_id);
@@ -186,6 +190,7 @@ Status VAnalyticEvalNode::prepare(RuntimeState* state) {
     _fn_place_ptr =
             _agg_arena_pool.aligned_alloc(_total_size_of_aggregate_states, _align_aggregate_states);
     _create_agg_status();
+    _init_segment_tree();
     _executor.insert_result =
             std::bind<void>(&VAnalyticEvalNode::_insert_result_info, this, std::placeholders::_1);
     _executor.execute =
@@ -214,6 +219,8 @@ Status VAnalyticEvalNode::prepare(RuntimeState* state) {
 
 Status VAnalyticEvalNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(mem_tracker());
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_CANCELLED(state);
@@ -231,6 +238,7 @@ Status VAnalyticEvalNode::close(RuntimeState* state) {
         return Status::OK();
     }
     ExecNode::close(state);
+    _destroy_segment_tree();
     _destory_agg_status();
     return Status::OK();
 }
@@ -241,6 +249,8 @@ Status VAnalyticEvalNode::get_next(RuntimeState* state, RowBatch* row_batch, boo
 
 Status VAnalyticEvalNode::get_next(RuntimeState* state, vectorized::Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(mem_tracker());
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
@@ -308,6 +318,9 @@ Status VAnalyticEvalNode::_get_next_for_rows(RuntimeState* state, Block* block,
         if (*eos) {
             break;
         }
+        if (next_partition && _has_segment_tree) {
+            _build_segment_tree();
+        }
 
         size_t current_block_rows = _input_blocks[_output_block_index].rows();
         while (_current_row_position < _partition_by_end.pos &&
@@ -330,7 +343,12 @@ Status VAnalyticEvalNode::_get_next_for_rows(RuntimeState* state, Block* block,
                 }
                 range_end.pos = _current_row_position + _rows_end_offset + 1;
             }
-            _executor.execute(_partition_by_start, _partition_by_end, range_start, range_end);
+            if (_has_segment_tree) {
+                _execute_for_win_func_by_segment_tree(_partition_by_start, _partition_by_end,
+                                                      range_start, range_end);
+            } else {
+                _executor.execute(_partition_by_start, _partition_by_end, range_start, range_end);
+            }
             _executor.insert_result(current_block_rows);
         }
         if (_window_end_position == current_block_rows) {
@@ -578,13 +596,149 @@ void VAnalyticEvalNode::_execute_for_win_func(BlockRowPos partition_start,
                                               BlockRowPos partition_end, BlockRowPos frame_start,
                                               BlockRowPos frame_end) {
     for (size_t i = 0; i < _agg_functions_size; ++i) {
-        std::vector<const IColumn*> _agg_columns;
-        for (int j = 0; j < _agg_intput_columns[i].size(); ++j) {
-            _agg_columns.push_back(_agg_intput_columns[i][j].get());
-        }
+        auto agg_columns = _get_agg_columns(i);
         _agg_functions[i]->function()->add_range_single_place(
                 partition_start.pos, partition_end.pos, frame_start.pos, frame_end.pos,
-                _fn_place_ptr + _offsets_of_aggregate_states[i], _agg_columns.data(), nullptr);
+                _fn_place_ptr + _offsets_of_aggregate_states[i], agg_columns.data(), nullptr);
+    }
+}
+
+std::vector<const IColumn*> VAnalyticEvalNode::_get_agg_columns(size_t fn_idx) {
+    std::vector<const IColumn*> agg_columns;
+    for (const auto& column : _agg_intput_columns[fn_idx]) {
+        agg_columns.push_back(column.get());
+    }
+    return agg_columns;
+}
+
+// The ROWS frames except [unbounded preceding, current row] are aggregated from scratch for each
+// row, which costs O(frame) per row. The functions whose states could be merged take the states
+// of the whole leaves in the frame from the segment tree instead, in O(log(partition)) merges.
+void VAnalyticEvalNode::_init_segment_tree() {
+    _use_segment_tree.assign(_agg_functions_size, false);
+    if (_fn_scope != AnalyticFnScope::ROWS ||
+        (!_window.__isset.window_start &&
+         _window.window_end.type == TAnalyticWindowBoundaryType::CURRENT_ROW)) {
+        return;
+    }
+    int64_t min_frame_rows = config::vec_analytic_segment_tree_min_frame_rows;
+    if (min_frame_rows < 0 || (_window.__isset.window_start &&
+                               _rows_end_offset - _rows_start_offset + 1 < min_frame_rows)) {
+        return;
+    }
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
+        _use_segment_tree[i] = _agg_functions[i]->function()->support_merge_in_window();
+        _has_segment_tree |= _use_segment_tree[i];
+    }
+}
+
+void VAnalyticEvalNode::_build_segment_tree() {
+    SCOPED_TIMER(_segment_tree_build_timer);
+    _destroy_segment_tree();
+    int64_t partition_rows = _partition_by_end.pos - _partition_by_start.pos;
+    _segment_tree_leaves = (partition_rows + SEGMENT_TREE_LEAF_ROWS - 1) / SEGMENT_TREE_LEAF_ROWS;
+    _segment_tree_nodes.resize(2 * _segment_tree_leaves, nullptr);
+    for (int64_t node = 1; node < 2 * _segment_tree_leaves; ++node) {
+        auto place = _segment_tree_arena.aligned_alloc(_total_size_of_aggregate_states,
+                                                       _align_aggregate_states);
+        for (size_t i = 0; i < _agg_functions_size; ++i) {
+            if (_use_segment_tree[i]) {
+                _agg_functions[i]->create(place + _offsets_of_aggregate_states[i]);
+            }
+        }
+        _segment_tree_nodes[node] = place;
+    }
+
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
+        if (!_use_segment_tree[i]) {
+            continue;
+        }
+        const auto& function = _agg_functions[i]->function();
+        size_t offset = _offsets_of_aggregate_states[i];
+        auto agg_columns = _get_agg_columns(i);
+        for (int64_t leaf = 0; leaf < _segment_tree_leaves; ++leaf) {
+            int64_t leaf_start = _partition_by_start.pos + leaf * SEGMENT_TREE_LEAF_ROWS;
+            function->add_range_single_place(
+                    _partition_by_start.pos, _partition_by_end.pos, leaf_start,
+                    leaf_start + SEGMENT_TREE_LEAF_ROWS,
+                    _segment_tree_nodes[_segment_tree_leaves + leaf] + offset, agg_columns.data(),
+                    nullptr);
+        }
+        for (int64_t node = _segment_tree_leaves - 1; node > 0; --node) {
+            function->merge(_segment_tree_nodes[node] + offset,
+                            _segment_tree_nodes[2 * node] + offset, nullptr);
+            function->merge(_segment_tree_nodes[node] + offset,
+                            _segment_tree_nodes[2 * node + 1] + offset, nullptr);
+        }
+    }
+}
+
+void VAnalyticEvalNode::_destroy_segment_tree() {
+    for (size_t node = 1; node < _segment_tree_nodes.size(); ++node) {
+        for (size_t i = 0; i < _agg_functions_size; ++i) {
+            if (_use_segment_tree[i]) {
+                _agg_functions[i]->destroy(_segment_tree_nodes[node] +
+                                           _offsets_of_aggregate_states[i]);
+            }
+        }
+    }
+    _segment_tree_nodes.clear();
+    _segment_tree_leaves = 0;
+    _segment_tree_arena.clear();
+}
+
+void VAnalyticEvalNode::_execute_for_win_func_by_segment_tree(BlockRowPos partition_start,
+                                                              BlockRowPos partition_end,
+                                                              BlockRowPos frame_start,
+                                                              BlockRowPos frame_end) {
+    int64_t start = std::max<int64_t>(frame_start.pos, partition_start.pos) - partition_start.pos;
+    int64_t end = std::min<int64_t>(frame_end.pos, partition_end.pos) - partition_start.pos;
+    if (start >= end) {
+        return;
+    }
+    // the whole leaves in the frame are [leaf_begin, leaf_end), the other rows are added by rows
+    int64_t leaf_begin = (start + SEGMENT_TREE_LEAF_ROWS - 1) / SEGMENT_TREE_LEAF_ROWS;
+    int64_t leaf_end = end / SEGMENT_TREE_LEAF_ROWS;
+    // the partition end is not aligned to a leaf, but the last leaf is whole if it's in the frame
+    if (end == partition_end.pos - partition_start.pos) {
+        leaf_end = _segment_tree_leaves;
+    }
+    _frame_nodes.clear();
+    _frame_right_nodes.clear();
+    for (int64_t l = leaf_begin + _segment_tree_leaves, r = leaf_end + _segment_tree_leaves; l < r;
+         l >>= 1, r >>= 1) {
+        if (l & 1) {
+            _frame_nodes.push_back(l++);
+        }
+        if (r & 1) {
+            _frame_right_nodes.push_back(--r);
+        }
+    }
+    _frame_nodes.insert(_frame_nodes.end(), _frame_right_nodes.rbegin(),
+                        _frame_right_nodes.rend());
+
+    for (size_t i = 0; i < _agg_functions_size; ++i) {
+        const auto& function = _agg_functions[i]->function();
+        size_t offset = _offsets_of_aggregate_states[i];
+        auto place = _fn_place_ptr + offset;
+        auto agg_columns = _get_agg_columns(i);
+        if (!_use_segment_tree[i] || leaf_begin >= leaf_end) {
+            function->add_range_single_place(partition_start.pos, partition_end.pos,
+                                             frame_start.pos, frame_end.pos, place,
+                                             agg_columns.data(), nullptr);
+            continue;
+        }
+        function->add_range_single_place(
+                partition_start.pos, partition_end.pos, partition_start.pos + start,
+                partition_start.pos + leaf_begin * SEGMENT_TREE_LEAF_ROWS, place,
+                agg_columns.data(), nullptr);
+        for (auto node : _frame_nodes) {
+            function->merge(place, _segment_tree_nodes[node] + offset, nullptr);
+        }
+        function->add_range_single_place(
+                partition_start.pos, partition_end.pos,
+                partition_start.pos + leaf_end * SEGMENT_TREE_LEAF_ROWS,
+                partition_start.pos + end, place, agg_columns.data(), nullptr);
     }
 }
 
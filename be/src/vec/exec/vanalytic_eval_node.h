@@ -59,6 +59,15 @@ private:
 
     void _execute_for_win_func(BlockRowPos partition_start, BlockRowPos partition_end,
                                BlockRowPos frame_start, BlockRowPos frame_end);
+    // the same as _execute_for_win_func, but the functions in _use_segment_tree merge the states
+    // of the whole leaves in the frame from the segment tree, and only add the other rows
+    void _execute_for_win_func_by_segment_tree(BlockRowPos partition_start,
+                                               BlockRowPos partition_end, BlockRowPos frame_start,
+                                               BlockRowPos frame_end);
+    void _init_segment_tree();
+    void _build_segment_tree();
+    void _destroy_segment_tree();
+    std::vector<const IColumn*> _get_agg_columns(size_t fn_idx);
 
     Status _reset_agg_status();
     Status _init_result_columns();
@@ -133,6 +142,20 @@ private:
     Arena _agg_arena_pool;
     AggregateDataPtr _fn_place_ptr;
 
+    static constexpr int64_t SEGMENT_TREE_LEAF_ROWS = 16;
+    // whether the function i evaluates the ROWS frames by the segment tree
+    std::vector<bool> _use_segment_tree;
+    bool _has_segment_tree = false;
+    // The segment tree of the states of the current partition. The leaf i is the node
+    // `_segment_tree_leaves + i`, with the states of the SEGMENT_TREE_LEAF_ROWS rows from the row
+    // `i * SEGMENT_TREE_LEAF_ROWS` of the partition, and the node i merges the nodes 2i and 2i+1.
+    std::vector<AggregateDataPtr> _segment_tree_nodes;
+    int64_t _segment_tree_leaves = 0;
+    Arena _segment_tree_arena;
+    // the nodes in a frame, in the order of the rows
+    std::vector<int64_t> _frame_nodes;
+    std::vector<int64_t> _frame_right_nodes;
+
     TTupleId _buffered_tuple_id = 0;
     TupleId _intermediate_tuple_id;
     TupleId _output_tuple_id;
@@ -143,5 +166,6 @@ private:
     std::vector<int64_t> _origin_cols;
 
     RuntimeProfile::Counter* _evaluation_timer;
+    RuntimeProfile::Counter* _segment_tree_build_timer = nullptr;
 };
 } // namespace doris::vectorized
\ No newline at end of file
@@ -17,14 +17,23 @@
 
 #include "vec/exec/vbroker_scan_node.h"
 
+#include <deque>
+#include <future>
+
+#include "common/config.h"
 #include "gen_cpp/PlanNodes_types.h"
+#include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
 #include "runtime/string_value.h"
 #include "runtime/tuple.h"
 #include "runtime/tuple_row.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_pipe.h"
+#include "util/defer_op.h"
 #include "util/runtime_profile.h"
 #include "util/thread.h"
+#include "util/threadpool.h"
 #include "util/types.h"
 #include "vec/exprs/vexpr_context.h"
 
@@ -47,6 +56,8 @@ Status VBrokerScanNode::start_scanners() {
 
 Status VBrokerScanNode::get_next(RuntimeState* state, vectorized::Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     // check if CANCELLED.
     if (state->is_cancelled()) {
         std::unique_lock<std::mutex> l(_batch_queue_lock);
@@ -116,79 +127,324 @@ Status VBrokerScanNode::close(RuntimeState* state) {
 }
 
 Status VBrokerScanNode::scanner_scan(const TBrokerScanRange& scan_range, ScannerCounter* counter) {
+    if (_can_parse_in_parallel(scan_range)) {
+        return _split_and_parse_stream(scan_range, counter);
+    }
+
     //create scanner object and open
     std::unique_ptr<BaseScanner> scanner = create_scanner(scan_range, counter);
     RETURN_IF_ERROR(scanner->open());
+    VExprContext* vconjunct_ctx = _vconjunct_ctx_ptr == nullptr ? nullptr : *_vconjunct_ctx_ptr;
     bool scanner_eof = false;
+    while (!scanner_eof) {
+        std::shared_ptr<vectorized::Block> block;
+        RETURN_IF_ERROR(_read_block(scanner.get(), vconjunct_ctx, counter, &block, &scanner_eof));
+        if (block != nullptr) {
+            bool stop = false;
+            RETURN_IF_ERROR(_push_block(block, &stop));
+            if (stop) {
+                return Status::OK();
+            }
+        }
+    }
+
+    return Status::OK();
+}
 
+Status VBrokerScanNode::_read_block(BaseScanner* scanner, VExprContext* vconjunct_ctx,
+                                    ScannerCounter* counter,
+                                    std::shared_ptr<vectorized::Block>* block, bool* eof) {
     const int batch_size = _runtime_state->batch_size();
     size_t slot_num = _tuple_desc->slots().size();
 
-    while (!scanner_eof) {
-        std::shared_ptr<vectorized::Block> block(new vectorized::Block());
-        std::vector<vectorized::MutableColumnPtr> columns(slot_num);
-        for (int i = 0; i < slot_num; i++) {
-            columns[i] = _tuple_desc->slots()[i]->get_empty_mutable_column();
+    std::vector<vectorized::MutableColumnPtr> columns(slot_num);
+    for (int i = 0; i < slot_num; i++) {
+        columns[i] = _tuple_desc->slots()[i]->get_empty_mutable_column();
+    }
+
+    while (columns[0]->size() < batch_size && !*eof) {
+        RETURN_IF_CANCELLED(_runtime_state);
+        // If we have finished all works
+        if (_scan_finished.load()) {
+            *eof = true;
+            return Status::OK();
         }
 
-        while (columns[0]->size() < batch_size && !scanner_eof) {
-            RETURN_IF_CANCELLED(_runtime_state);
-            // If we have finished all works
-            if (_scan_finished.load()) {
-                return Status::OK();
-            }
+        RETURN_IF_ERROR(scanner->get_next(columns, eof));
+    }
 
-            RETURN_IF_ERROR(scanner->get_next(columns, &scanner_eof));
-            if (scanner_eof) {
-                break;
-            }
+    if (!columns[0]->empty()) {
+        *block = std::make_shared<vectorized::Block>();
+        auto n_columns = 0;
+        for (const auto slot_desc : _tuple_desc->slots()) {
+            (*block)->insert(ColumnWithTypeAndName(std::move(columns[n_columns++]),
+                                                   slot_desc->get_data_type_ptr(),
+                                                   slot_desc->col_name()));
         }
 
-        if (!columns[0]->empty()) {
-            auto n_columns = 0;
-            for (const auto slot_desc : _tuple_desc->slots()) {
-                block->insert(ColumnWithTypeAndName(std::move(columns[n_columns++]),
-                                                    slot_desc->get_data_type_ptr(),
-                                                    slot_desc->col_name()));
-            }
+        auto old_rows = (*block)->rows();
 
-            auto old_rows = block->rows();
+        RETURN_IF_ERROR(VExprContext::filter_block(vconjunct_ctx, block->get(),
+                                                   _tuple_desc->slots().size()));
 
-            RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block.get(),
-                                                       _tuple_desc->slots().size()));
+        counter->num_rows_unselected += old_rows - (*block)->rows();
+    }
+    return Status::OK();
+}
 
-            counter->num_rows_unselected += old_rows - block->rows();
+Status VBrokerScanNode::_push_block(const std::shared_ptr<vectorized::Block>& block, bool* stop) {
+    *stop = true;
+    std::unique_lock<std::mutex> l(_batch_queue_lock);
+    while (_process_status.ok() && !_scan_finished.load() && !_runtime_state->is_cancelled() &&
+           // stop pushing more batch if
+           // 1. too many batches in queue, or
+           // 2. at least one batch in queue and memory exceed limit.
+           (_block_queue.size() >= _max_buffered_batches ||
+            (mem_tracker()->any_limit_exceeded() && !_block_queue.empty()))) {
+        _queue_writer_cond.wait_for(l, std::chrono::seconds(1));
+    }
+    // Process already set failed, so we just return OK
+    if (!_process_status.ok()) {
+        return Status::OK();
+    }
+    // Scan already finished, just return
+    if (_scan_finished.load()) {
+        return Status::OK();
+    }
+    // Runtime state is canceled, just return cancel
+    if (_runtime_state->is_cancelled()) {
+        return Status::Cancelled("Cancelled");
+    }
+    // Queue size Must be smaller than _max_buffered_batches
+    _block_queue.push_back(block);
 
-            std::unique_lock<std::mutex> l(_batch_queue_lock);
-            while (_process_status.ok() && !_scan_finished.load() &&
-                   !_runtime_state->is_cancelled() &&
-                   // stop pushing more batch if
-                   // 1. too many batches in queue, or
-                   // 2. at least one batch in queue and memory exceed limit.
-                   (_block_queue.size() >= _max_buffered_batches ||
-                    (mem_tracker()->any_limit_exceeded() && !_block_queue.empty()))) {
-                _queue_writer_cond.wait_for(l, std::chrono::seconds(1));
+    // Notify reader to
+    _queue_reader_cond.notify_one();
+    *stop = false;
+    return Status::OK();
+}
+
+bool VBrokerScanNode::_can_parse_in_parallel(const TBrokerScanRange& scan_range) const {
+    if (config::stream_load_parse_parallelism <= 1 || scan_range.ranges.size() != 1 ||
+        scan_range.ranges[0].file_type != TFileType::FILE_STREAM) {
+        return false;
+    }
+    // The compressed bodies can't be split, and the lines of the other formats aren't rows.
+    // The json bodies are split by the messages, such as the kafka messages of a routine load,
+    // unless the json objects are read by lines.
+    const TBrokerRangeDesc& range = scan_range.ranges[0];
+    return range.format_type == TFileFormatType::FORMAT_CSV_PLAIN ||
+           (range.format_type == TFileFormatType::FORMAT_JSON &&
+            !(range.__isset.read_json_by_line && range.read_json_by_line));
+}
+
+namespace {
+
+// The end of the last line delimiter in data[0, size), 0 if there is none.
+size_t find_last_line_end(const char* data, size_t size, const std::string& line_delimiter) {
+    if (line_delimiter.size() == 1) {
+        const void* pos = memrchr(data, line_delimiter[0], size);
+        return pos == nullptr ? 0 : static_cast<const char*>(pos) - data + 1;
+    }
+    for (size_t end = size; end >= line_delimiter.size(); --end) {
+        if (memcmp(data + end - line_delimiter.size(), line_delimiter.data(),
+                   line_delimiter.size()) == 0) {
+            return end;
+        }
+    }
+    return 0;
+}
+
+// Read the whole messages of the pipe into a chunk of at least `chunk_bytes` bytes, or of the
+// messages left. The messages are moved into the chunk without copying. `chunk` is null if
+// there is no message left.
+Status read_message_chunk(StreamLoadPipe* pipe, size_t chunk_bytes,
+                          std::shared_ptr<StreamLoadPipe>* chunk, bool* finished) {
+    std::vector<ByteBufferPtr> messages;
+    size_t bytes = 0;
+    while (bytes < chunk_bytes) {
+        std::unique_ptr<uint8_t[]> data;
+        int64_t length = 0;
+        RETURN_IF_ERROR(pipe->read_one_message(&data, &length));
+        if (length == 0) {
+            *finished = true;
+            break;
+        }
+        std::shared_ptr<uint8_t[]> owner(data.release());
+        messages.push_back(ByteBuffer::wrap(reinterpret_cast<char*>(owner.get()), length, owner));
+        bytes += length;
+    }
+    chunk->reset();
+    if (messages.empty()) {
+        return Status::OK();
+    }
+    // all the messages are buffered before the chunk is parsed, each one is read as a message
+    *chunk = std::make_shared<StreamLoadPipe>(bytes);
+    for (auto& message : messages) {
+        RETURN_IF_ERROR((*chunk)->append(message));
+    }
+    return (*chunk)->finish();
+}
+
+// A chunk of the body of a stream load, which is parsed into the blocks by the parse pool.
+struct StreamChunk {
+    TBrokerScanRange scan_range;
+    UniqueId load_id;
+    std::vector<std::shared_ptr<vectorized::Block>> blocks;
+    ScannerCounter counter;
+    std::promise<Status> promise;
+};
+
+} // namespace
+
+Status VBrokerScanNode::_split_and_parse_stream(const TBrokerScanRange& scan_range,
+                                                ScannerCounter* counter) {
+    const TBrokerRangeDesc& range = scan_range.ranges[0];
+    LoadStreamMgr* load_stream_mgr = _runtime_state->exec_env()->load_stream_mgr();
+    std::shared_ptr<StreamLoadPipe> pipe = load_stream_mgr->get(range.load_id);
+    if (pipe == nullptr) {
+        VLOG_NOTICE << "unknown stream load id: " << UniqueId(range.load_id);
+        return Status::InternalError("unknown stream load id");
+    }
+    // the json bodies are split by the messages, the csv bodies by the lines
+    const bool split_messages = range.format_type == TFileFormatType::FORMAT_JSON;
+    std::string line_delimiter;
+    if (scan_range.params.__isset.line_delimiter_length &&
+        scan_range.params.line_delimiter_length > 1) {
+        line_delimiter = scan_range.params.line_delimiter_str;
+    } else {
+        line_delimiter.push_back(static_cast<char>(scan_range.params.line_delimiter));
+    }
+
+    const int parallelism = config::stream_load_parse_parallelism;
+    const size_t chunk_bytes = std::max<int64_t>(config::stream_load_parse_chunk_bytes, 1);
+    std::unique_ptr<ThreadPool> parse_pool;
+    RETURN_IF_ERROR(ThreadPoolBuilder("StreamLoadParseThreadPool")
+                            .set_min_threads(0)
+                            .set_max_threads(parallelism)
+                            .build(&parse_pool));
+
+    // The chunks being parsed, at most `parallelism` ones. The chunk i is filtered by the
+    // conjuncts i % parallelism, which are not used by the other chunks being parsed.
+    std::deque<std::shared_ptr<StreamChunk>> chunks;
+    std::vector<VExprContext*> vconjunct_ctxs(parallelism, nullptr);
+    Defer defer {[&]() {
+        for (auto& chunk : chunks) {
+            chunk->promise.get_future().wait();
+        }
+        for (auto ctx : vconjunct_ctxs) {
+            if (ctx != nullptr) {
+                ctx->close(_runtime_state);
             }
-            // Process already set failed, so we just return OK
-            if (!_process_status.ok()) {
-                return Status::OK();
+        }
+    }};
+    if (_vconjunct_ctx_ptr != nullptr) {
+        for (auto& ctx : vconjunct_ctxs) {
+            RETURN_IF_ERROR((*_vconjunct_ctx_ptr)->clone(_runtime_state, &ctx));
+        }
+    }
+
+    // Wait for the first chunk, and push its blocks into the block queue in order.
+    auto pop_chunk = [&](bool* stop) -> Status {
+        std::shared_ptr<StreamChunk> chunk = chunks.front();
+        chunks.pop_front();
+        Status status = chunk->promise.get_future().get();
+        counter->num_rows_filtered += chunk->counter.num_rows_filtered;
+        counter->num_rows_unselected += chunk->counter.num_rows_unselected;
+        RETURN_IF_ERROR(status);
+        for (auto& block : chunk->blocks) {
+            RETURN_IF_ERROR(_push_block(block, stop));
+            if (*stop) {
+                break;
             }
-            // Scan already finished, just return
-            if (_scan_finished.load()) {
-                return Status::OK();
+        }
+        return Status::OK();
+    };
+
+    std::string buffer;
+    size_t buffered = 0;
+    int64_t num_chunks = 0;
+    bool finished = false;
+    bool stop = false;
+    while (!finished && !stop) {
+        RETURN_IF_CANCELLED(_runtime_state);
+        if (_scan_finished.load()) {
+            break;
+        }
+        std::shared_ptr<StreamLoadPipe> chunk_pipe;
+        if (split_messages) {
+            RETURN_IF_ERROR(read_message_chunk(pipe.get(), chunk_bytes, &chunk_pipe, &finished));
+            if (chunk_pipe == nullptr) {
+                break;
             }
-            // Runtime state is canceled, just return cancel
-            if (_runtime_state->is_cancelled()) {
-                return Status::Cancelled("Cancelled");
+        } else {
+            buffer.resize(buffered + chunk_bytes);
+            int64_t bytes_read = 0;
+            bool eof = false;
+            RETURN_IF_ERROR(pipe->read(reinterpret_cast<uint8_t*>(buffer.data()) + buffered,
+                                       chunk_bytes, &bytes_read, &eof));
+            // the pipe only returns less bytes than required when the body is finished
+            finished = eof || bytes_read < chunk_bytes;
+            buffered += bytes_read;
+            size_t chunk_size = finished ? buffered
+                                         : find_last_line_end(buffer.data(), buffered,
+                                                              line_delimiter);
+            if (chunk_size == 0) {
+                // the line is larger than the chunk, read more
+                continue;
             }
-            // Queue size Must be smaller than _max_buffered_batches
-            _block_queue.push_back(block);
+            chunk_pipe = std::make_shared<StreamLoadPipe>();
+            RETURN_IF_ERROR(chunk_pipe->append_and_flush(buffer.data(), chunk_size));
+            RETURN_IF_ERROR(chunk_pipe->finish());
+            buffer.erase(0, chunk_size);
+            buffered -= chunk_size;
+        }
+
+        auto chunk = std::make_shared<StreamChunk>();
+        chunk->scan_range = scan_range;
+        chunk->load_id = UniqueId::gen_uid();
+        TBrokerRangeDesc& chunk_range = chunk->scan_range.ranges[0];
+        chunk_range.__set_load_id(chunk->load_id.to_thrift());
+        if (num_chunks > 0) {
+            // the header lines are only in the first chunk
+            chunk_range.__set_header_type("");
+        }
+        RETURN_IF_ERROR(load_stream_mgr->put(chunk->load_id, chunk_pipe));
 
-            // Notify reader to
-            _queue_reader_cond.notify_one();
+        if (chunks.size() >= parallelism) {
+            RETURN_IF_ERROR(pop_chunk(&stop));
         }
+        VExprContext* vconjunct_ctx = vconjunct_ctxs[num_chunks++ % parallelism];
+        Status status = parse_pool->submit_func([this, chunk, vconjunct_ctx, load_stream_mgr]() {
+            Status st = [&]() -> Status {
+                std::unique_ptr<BaseScanner> scanner =
+                        create_scanner(chunk->scan_range, &chunk->counter);
+                RETURN_IF_ERROR(scanner->open());
+                bool eof = false;
+                while (!eof) {
+                    std::shared_ptr<vectorized::Block> block;
+                    RETURN_IF_ERROR(_read_block(scanner.get(), vconjunct_ctx, &chunk->counter,
+                                                &block, &eof));
+                    if (block != nullptr) {
+                        chunk->blocks.push_back(std::move(block));
+                    }
+                }
+                return Status::OK();
+            }();
+            // the pipe is left if the scanner fails before opening it
+            load_stream_mgr->remove(chunk->load_id);
+            chunk->promise.set_value(st);
+        });
+        if (!status.ok()) {
+            load_stream_mgr->remove(chunk->load_id);
+            return status;
+        }
+        chunks.push_back(chunk);
     }
 
+    while (!chunks.empty() && !stop) {
+        RETURN_IF_ERROR(pop_chunk(&stop));
+    }
     return Status::OK();
 }
 
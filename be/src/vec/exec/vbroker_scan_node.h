@@ -18,6 +18,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "exec/broker_scan_node.h"
 #include "exec/scan_node.h"
@@ -50,6 +51,20 @@ private:
     // Scan one range
     Status scanner_scan(const TBrokerScanRange& scan_range, ScannerCounter* counter);
 
+    // Read the next block of the scanner filtered by `vconjunct_ctx`, `block` is nullptr if no
+    // row is read.
+    Status _read_block(BaseScanner* scanner, VExprContext* vconjunct_ctx,
+                       ScannerCounter* counter, std::shared_ptr<vectorized::Block>* block,
+                       bool* eof);
+    // Push the block into the block queue, `stop` is set if the scan should be stopped.
+    Status _push_block(const std::shared_ptr<vectorized::Block>& block, bool* stop);
+
+    // Whether the range is the body of a csv stream load which can be parsed in parallel.
+    bool _can_parse_in_parallel(const TBrokerScanRange& scan_range) const;
+    // Split the body of the stream load into chunks of whole lines, which are parsed by a thread
+    // pool in parallel. The blocks are pushed into the block queue in the order of the chunks.
+    Status _split_and_parse_stream(const TBrokerScanRange& scan_range, ScannerCounter* counter);
+
     std::deque<std::shared_ptr<vectorized::Block>> _block_queue;
 };
 } // namespace vectorized
@@ -38,6 +38,5 @@ public:
 
 private:
     Status _convert_one_row(const Slice& line, std::vector<MutableColumnPtr>& columns);
-    Status _fill_dest_columns(std::vector<MutableColumnPtr>& columns);
 };
 } // namespace doris::vectorized
@@ -19,14 +19,30 @@
 
 #include <sstream>
 
+#include "common/config.h"
 #include "exprs/expr.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/core/sort_block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/exprs/vexpr_context.h"
+#include "vec/exprs/vslot_ref.h"
 
 namespace doris::vectorized {
 
+namespace {
+
+const IColumn* nested_column(const IColumn* column) {
+    return column->is_nullable() ? &assert_cast<const ColumnNullable*>(column)->get_nested_column()
+                                 : column;
+}
+
+} // namespace
+
 VCrossJoinNode::VCrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
         : VBlockingJoinNode("VCrossJoinNode", TJoinOp::CROSS_JOIN, pool, tnode, descs) {}
 
@@ -39,9 +55,90 @@ Status VCrossJoinNode::prepare(RuntimeState* state) {
 
     _num_existing_columns = child(0)->row_desc().num_materialized_slots();
     _num_columns_to_add = child(1)->row_desc().num_materialized_slots();
+
+    init_range_conjuncts();
+    if (!_range_conjuncts.empty()) {
+        add_runtime_exec_option("Range Search On Sorted Build Side");
+    }
     return Status::OK();
 }
 
+void VCrossJoinNode::init_range_conjuncts() {
+    if (!config::enable_vec_cross_join_range_search || _vconjunct_ctx_ptr == nullptr) {
+        return;
+    }
+    std::vector<VExpr*> exprs {(*_vconjunct_ctx_ptr)->root()};
+    while (!exprs.empty()) {
+        VExpr* expr = exprs.back();
+        exprs.pop_back();
+        if (expr->node_type() == TExprNodeType::COMPOUND_PRED &&
+            expr->fn().name.function_name == "and") {
+            exprs.insert(exprs.end(), expr->children().begin(), expr->children().end());
+            continue;
+        }
+        // only the conjuncts on the same build column narrow the same sorted range
+        size_t build_column = 0;
+        RangeConjunct range;
+        if (to_range_conjunct(expr, &build_column, &range) &&
+            (_range_conjuncts.empty() || build_column == _range_build_column)) {
+            _range_build_column = build_column;
+            _range_conjuncts.push_back(range);
+        }
+    }
+}
+
+bool VCrossJoinNode::to_range_conjunct(VExpr* conjunct, size_t* build_column,
+                                       RangeConjunct* range) {
+    if (conjunct->node_type() != TExprNodeType::BINARY_PRED || conjunct->children().size() != 2) {
+        return false;
+    }
+    // the op of `build column op probe expr`, and of `probe expr op build column`
+    RangeOp op;
+    RangeOp reversed_op;
+    const std::string& fn_name = conjunct->fn().name.function_name;
+    if (fn_name == "lt") {
+        op = RangeOp::LT;
+        reversed_op = RangeOp::GT;
+    } else if (fn_name == "le") {
+        op = RangeOp::LE;
+        reversed_op = RangeOp::GE;
+    } else if (fn_name == "gt") {
+        op = RangeOp::GT;
+        reversed_op = RangeOp::LT;
+    } else if (fn_name == "ge") {
+        op = RangeOp::GE;
+        reversed_op = RangeOp::LE;
+    } else {
+        return false;
+    }
+
+    const int num_left_columns = _num_existing_columns;
+    for (int i = 0; i < 2; ++i) {
+        VExpr* build_expr = conjunct->children()[i];
+        VExpr* probe_expr = conjunct->children()[1 - i];
+        if (!build_expr->is_slot_ref()) {
+            continue;
+        }
+        int column_id = static_cast<VSlotRef*>(build_expr)->column_id();
+        std::set<int> probe_columns;
+        probe_expr->collect_column_ids(&probe_columns);
+        if (column_id < num_left_columns || probe_columns.empty() ||
+            *probe_columns.rbegin() >= num_left_columns) {
+            continue;
+        }
+        // the build and probe keys are compared by the columns of the same type
+        if (!remove_nullable(build_expr->data_type())
+                     ->equals(*remove_nullable(probe_expr->data_type()))) {
+            continue;
+        }
+        *build_column = column_id - num_left_columns;
+        range->op = i == 0 ? op : reversed_op;
+        range->probe_expr = probe_expr;
+        return true;
+    }
+    return false;
+}
+
 Status VCrossJoinNode::close(RuntimeState* state) {
     // avoid double close
     if (is_closed()) {
@@ -80,19 +177,164 @@ Status VCrossJoinNode::construct_build_side(RuntimeState* state) {
         }
     }
 
+    if (!_range_conjuncts.empty() && _build_rows != 0) {
+        sort_build_side();
+    }
+
     COUNTER_UPDATE(_build_row_counter, _build_rows);
     // If right table in join is empty, the node is eos
     _eos = _build_rows == 0;
     return Status::OK();
 }
 
+void VCrossJoinNode::sort_build_side() {
+    MutableBlock merged_block;
+    for (auto& block : _build_blocks) {
+        merged_block.merge(std::move(block));
+    }
+    Block sorted_block = merged_block.to_block();
+    SortDescription description {SortColumnDescription(_range_build_column, 1, 1)};
+    sort_block(sorted_block, description);
+
+    // the comparisons with the null build keys are never true
+    const auto& column = sorted_block.get_by_position(_range_build_column).column;
+    _range_build_rows = column->size();
+    if (column->is_nullable()) {
+        const auto& null_map =
+                assert_cast<const ColumnNullable*>(column.get())->get_null_map_data();
+        while (_range_build_rows > 0 && null_map[_range_build_rows - 1]) {
+            --_range_build_rows;
+        }
+    }
+
+    _block_mem_tracker->release(_total_mem_usage);
+    _total_mem_usage = sorted_block.allocated_bytes();
+    _block_mem_tracker->consume(_total_mem_usage);
+    _build_blocks.clear();
+    _build_blocks.emplace_back(std::move(sorted_block));
+}
+
 void VCrossJoinNode::init_get_next(int left_batch_row) {
     _current_build_pos = 0;
+    _current_build_row = 0;
+    _current_build_end = 0;
+    _need_init_build_range = true;
+    _probe_key_columns.clear();
+}
+
+Status VCrossJoinNode::init_build_range() {
+    _need_init_build_range = false;
+    _current_build_pos = 0;
+    _current_build_row = 0;
+    if (_range_conjuncts.empty()) {
+        _current_build_end = _build_blocks[0].rows();
+        return Status::OK();
+    }
+
+    _current_build_end = _range_build_rows;
+    if (_probe_key_columns.empty()) {
+        // the probe exprs only read the left columns, the first columns of the joined rows
+        Block probe_block(_left_block.get_columns_with_type_and_name());
+        for (const auto& range : _range_conjuncts) {
+            int result_column_id = -1;
+            RETURN_IF_ERROR(range.probe_expr->execute(*_vconjunct_ctx_ptr, &probe_block,
+                                                      &result_column_id));
+            _probe_key_columns.push_back(probe_block.get_by_position(result_column_id)
+                                                 .column->convert_to_full_column_if_const());
+        }
+    }
+
+    const IColumn* build_key = nested_column(
+            _build_blocks[0].get_by_position(_range_build_column).column.get());
+    for (size_t i = 0; i < _range_conjuncts.size(); ++i) {
+        const IColumn* probe_key = _probe_key_columns[i].get();
+        if (probe_key->is_null_at(_left_block_pos)) {
+            _current_build_end = _current_build_row;
+            return Status::OK();
+        }
+        probe_key = nested_column(probe_key);
+        // the first build row greater than the probe key if `upper`, else not less than it
+        auto bound = [&](bool upper) {
+            size_t begin = 0;
+            size_t end = _range_build_rows;
+            while (begin < end) {
+                size_t mid = begin + (end - begin) / 2;
+                int res = build_key->compare_at(mid, _left_block_pos, *probe_key, 1);
+                if (res < 0 || (upper && res == 0)) {
+                    begin = mid + 1;
+                } else {
+                    end = mid;
+                }
+            }
+            return begin;
+        };
+        switch (_range_conjuncts[i].op) {
+        case RangeOp::LT:
+            _current_build_end = std::min(_current_build_end, bound(false));
+            break;
+        case RangeOp::LE:
+            _current_build_end = std::min(_current_build_end, bound(true));
+            break;
+        case RangeOp::GT:
+            _current_build_row = std::max(_current_build_row, bound(true));
+            break;
+        case RangeOp::GE:
+            _current_build_row = std::max(_current_build_row, bound(false));
+            break;
+        }
+    }
+    _current_build_end = std::max(_current_build_end, _current_build_row);
+    return Status::OK();
+}
+
+Status VCrossJoinNode::join_rows(RuntimeState* state, MutableColumns& dst_columns,
+                                 size_t max_rows,
+                                 ScopedTimer<MonotonicStopWatch>* left_child_timer) {
+    size_t joined_rows = 0;
+    while (joined_rows < max_rows && !_eos) {
+        if (_need_init_build_range) {
+            RETURN_IF_ERROR(init_build_range());
+        }
+        if (_current_build_row < _current_build_end) {
+            size_t rows = std::min(_current_build_end - _current_build_row, max_rows - joined_rows);
+            process_left_child_block(dst_columns, _build_blocks[_current_build_pos],
+                                     _current_build_row, rows);
+            _current_build_row += rows;
+            joined_rows += rows;
+        } else if (_current_build_pos + 1 < _build_blocks.size()) {
+            // the next build block of the current left row
+            ++_current_build_pos;
+            _current_build_row = 0;
+            _current_build_end = _build_blocks[_current_build_pos].rows();
+        } else if (static_cast<size_t>(++_left_block_pos) < _left_block.rows()) {
+            _need_init_build_range = true;
+        } else if (_left_side_eos) {
+            _left_block_pos = 0;
+            _eos = true;
+        } else {
+            _left_block_pos = 0;
+            do {
+                release_block_memory(_left_block);
+                left_child_timer->stop();
+                RETURN_IF_ERROR(child(0)->get_next(state, &_left_block, &_left_side_eos));
+                left_child_timer->start();
+            } while (_left_block.rows() == 0 && !_left_side_eos);
+            COUNTER_UPDATE(_left_child_row_counter, _left_block.rows());
+            _probe_key_columns.clear();
+            _need_init_build_range = true;
+            if (_left_block.rows() == 0) {
+                _eos = true;
+            }
+        }
+    }
+    return Status::OK();
 }
 
 Status VCrossJoinNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     RETURN_IF_CANCELLED(state);
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(mem_tracker());
     *eos = false;
 
@@ -104,42 +346,26 @@ Status VCrossJoinNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     auto dst_columns = get_mutable_columns(block);
     ScopedTimer<MonotonicStopWatch> timer(_left_child_timer);
 
-    while (block->rows() < state->batch_size() && !_eos) {
-        // Check to see if we're done processing the current left child batch
-        if (_current_build_pos == _build_blocks.size()) {
-            _current_build_pos = 0;
-            _left_block_pos++;
-
-            if (_left_block_pos == _left_block.rows()) {
-                _left_block_pos = 0;
-
-                if (_left_side_eos) {
-                    *eos = _eos = true;
-                } else {
-                    do {
-                        release_block_memory(_left_block);
-                        timer.stop();
-                        RETURN_IF_ERROR(child(0)->get_next(state, &_left_block, &_left_side_eos));
-                        timer.start();
-                    } while (_left_block.rows() == 0 && !_left_side_eos);
-                    COUNTER_UPDATE(_left_child_row_counter, _left_block.rows());
-                    if (_left_block.rows() == 0) {
-                        *eos = _eos = _left_side_eos;
-                    }
-                }
+    if (_vconjunct_ctx_ptr == nullptr) {
+        RETURN_IF_ERROR(join_rows(state, dst_columns, state->batch_size(), &timer));
+    } else {
+        // the rows are joined by chunks of batch size rows filtered by the conjuncts, so the
+        // rows not passing them are never accumulated
+        while (block->rows() < state->batch_size() && !_eos) {
+            Block chunk = block->clone_empty();
+            auto chunk_columns = chunk.mutate_columns();
+            RETURN_IF_ERROR(join_rows(state, chunk_columns, state->batch_size(), &timer));
+            chunk.set_columns(std::move(chunk_columns));
+            RETURN_IF_ERROR(
+                    VExprContext::filter_block(_vconjunct_ctx_ptr, &chunk, chunk.columns()));
+            for (size_t i = 0; i < dst_columns.size(); ++i) {
+                dst_columns[i]->insert_range_from(*chunk.get_by_position(i).column, 0,
+                                                  chunk.rows());
             }
         }
-
-        if (!_eos) {
-            do {
-                const auto& now_process_build_block = _build_blocks[_current_build_pos++];
-                process_left_child_block(dst_columns, now_process_build_block);
-            } while (block->rows() < state->batch_size() &&
-                     _current_build_pos < _build_blocks.size());
-        }
     }
     dst_columns.clear();
-    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns()));
+    *eos = _eos;
 
     reached_limit(block, eos);
     return Status::OK();
@@ -172,16 +398,16 @@ MutableColumns VCrossJoinNode::get_mutable_columns(Block* block) {
 }
 
 void VCrossJoinNode::process_left_child_block(MutableColumns& dst_columns,
-                                              const Block& now_process_build_block) {
-    const int max_added_rows = now_process_build_block.rows();
+                                              const Block& now_process_build_block, size_t begin,
+                                              size_t length) {
     for (size_t i = 0; i < _num_existing_columns; ++i) {
         const ColumnWithTypeAndName& src_column = _left_block.get_by_position(i);
-        dst_columns[i]->insert_many_from(*src_column.column, _left_block_pos, max_added_rows);
+        dst_columns[i]->insert_many_from(*src_column.column, _left_block_pos, length);
     }
     for (size_t i = 0; i < _num_columns_to_add; ++i) {
         const ColumnWithTypeAndName& src_column = now_process_build_block.get_by_position(i);
-        dst_columns[_num_existing_columns + i]->insert_range_from(*src_column.column.get(), 0,
-                                                                  max_added_rows);
+        dst_columns[_num_existing_columns + i]->insert_range_from(*src_column.column.get(), begin,
+                                                                  length);
     }
 }
 
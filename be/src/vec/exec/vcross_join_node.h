@@ -27,8 +27,10 @@
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/descriptors.h"
 #include "runtime/mem_pool.h"
+#include "util/runtime_profile.h"
 #include "vec/core/block.h"
 #include "vec/exec/vblocking_join_node.h"
+#include "vec/exprs/vexpr.h"
 
 namespace doris::vectorized {
 // Node for cross joins.
@@ -37,6 +39,10 @@ namespace doris::vectorized {
 // build batches are kept in a list that is fully constructed from the right child in
 // construct_build_side() (called by BlockingJoinNode::open()) while rows are fetched from
 // the left child as necessary in get_next().
+// The joined rows are evaluated by the conjuncts in chunks of at most batch size rows. If some
+// conjuncts compare a build column with the left rows by <, <=, > or >=, e.g. a range join on
+// timestamps, the build side is sorted on the column and each left row is only joined with the
+// build rows in the range found by binary search.
 class VCrossJoinNode final : public VBlockingJoinNode {
 public:
     VCrossJoinNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -54,9 +60,32 @@ protected:
     Status construct_build_side(RuntimeState* state) override;
 
 private:
-    // List of build blocks, constructed in prepare()
+    enum class RangeOp { LT, LE, GT, GE };
+
+    // A conjunct `build column op probe expr`, where the probe expr only reads the left columns.
+    struct RangeConjunct {
+        RangeOp op;
+        VExpr* probe_expr;
+    };
+
+    // List of build blocks, constructed in prepare(), a single block sorted on
+    // `_range_build_column` with range search
     Blocks _build_blocks;
+    // the build rows [_current_build_row, _current_build_end) of the block _current_build_pos
+    // are not joined with the current left row yet
     size_t _current_build_pos = 0;
+    size_t _current_build_row = 0;
+    size_t _current_build_end = 0;
+    bool _need_init_build_range = true;
+
+    // the range conjuncts on the build column `_range_build_column`, the position of the
+    // column in the build blocks, empty without range search
+    std::vector<RangeConjunct> _range_conjuncts;
+    size_t _range_build_column = 0;
+    // the non-null rows of the build column, the first rows of the sorted build block
+    size_t _range_build_rows = 0;
+    // the results of the probe exprs of the range conjuncts on `_left_block`
+    Columns _probe_key_columns;
 
     size_t _num_existing_columns = 0;
     size_t _num_columns_to_add = 0;
@@ -73,9 +102,24 @@ private:
 
     // Processes a block from the left child.
     //  dst_columns: left_child_row and now_process_build_block to construct a bundle column of new block
-    //  now_process_build_block: right child block now to process
+    //  now_process_build_block: right child block now to process, from the row `begin`
     void process_left_child_block(MutableColumns& dst_columns,
-                                  const Block& now_process_build_block);
+                                  const Block& now_process_build_block, size_t begin,
+                                  size_t length);
+
+    // Join at most `max_rows` rows into `dst_columns`, moving to the next left rows as needed.
+    Status join_rows(RuntimeState* state, MutableColumns& dst_columns, size_t max_rows,
+                     ScopedTimer<MonotonicStopWatch>* left_child_timer);
+
+    // Set the build rows to join with the current left row, by binary search with range search.
+    Status init_build_range();
+
+    // Find the range conjuncts among the conjuncts ANDed together.
+    void init_range_conjuncts();
+    bool to_range_conjunct(VExpr* conjunct, size_t* build_column, RangeConjunct* range);
+
+    // Sort the build blocks into one block on the range build column, the nulls last.
+    void sort_build_side();
 
     // Returns a debug string for _build_rows. This is used for debugging during the
     // build list construction and before doing the join.
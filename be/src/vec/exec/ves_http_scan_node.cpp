@@ -38,6 +38,8 @@ VEsHttpScanNode::~VEsHttpScanNode() {}
 
 Status VEsHttpScanNode::get_next(RuntimeState* state, vectorized::Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     if (state->is_cancelled()) {
         std::unique_lock<std::mutex> l(_block_queue_lock);
         if (update_status(Status::Cancelled("Cancelled"))) {
@@ -49,13 +49,17 @@ Status VExceptNode::open(RuntimeState* state) {
         if (i > 1) {
             refresh_hash_table<false>();
         }
+        // all the keys are excepted, the other children need not be read
+        if (_valid_element_in_hash_tbl == 0) {
+            break;
+        }
 
         RETURN_IF_ERROR(child(i)->open(state));
         eos = false;
         int probe_expr_ctxs_sz = _child_expr_lists[i].size();
         _probe_columns.resize(probe_expr_ctxs_sz);
 
-        while (!eos) {
+        while (!eos && _valid_element_in_hash_tbl > 0) {
             RETURN_IF_ERROR(process_probe_block(state, i, &eos));
             if (_probe_rows == 0) continue;
 
@@ -41,6 +41,20 @@ public:
     // Status collect_query_statistics(QueryStatistics* statistics) override;
     void set_num_senders(int num_senders) { _num_senders = num_senders; }
 
+    // Return true if get_next() will not block waiting for the senders.
+    bool can_read() const { return _stream_recvr->ready_to_read(); }
+
+    // the blocks of the senders are merged in order if merging
+    std::vector<SlotId> ordered_by_slots() const override {
+        return _is_merging ? _vsort_exec_exprs.ordering_slots() : std::vector<SlotId> {};
+    }
+    std::vector<bool> ordered_by_asc_order() const override {
+        return _is_merging ? _is_asc_order : std::vector<bool> {};
+    }
+    std::vector<bool> ordered_by_nulls_first() const override {
+        return _is_merging ? _nulls_first : std::vector<bool> {};
+    }
+
 private:
     int _num_senders;
     bool _is_merging;
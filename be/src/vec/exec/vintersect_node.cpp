@@ -50,13 +50,19 @@ Status VIntersectNode::open(RuntimeState* state) {
         if (i > 1) {
             refresh_hash_table<true>();
         }
+        // the intersection is empty, the other children need not be read
+        if (_valid_element_in_hash_tbl == 0) {
+            break;
+        }
 
+        int64_t num_valid_elements = _valid_element_in_hash_tbl;
         _valid_element_in_hash_tbl = 0;
         RETURN_IF_ERROR(child(i)->open(state));
         eos = false;
         _probe_columns.resize(_child_expr_lists[i].size());
 
-        while (!eos) {
+        // once all the keys are hit, the rest of the child can't change the intersection
+        while (!eos && _valid_element_in_hash_tbl < num_valid_elements) {
             RETURN_IF_ERROR(process_probe_block(state, i, &eos));
             if (_probe_rows == 0) continue;
 
@@ -0,0 +1,599 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vjson_scanner.h"
+
+#include <fmt/format.h>
+
+#include "exec/line_reader.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/common/assert_cast.h"
+
+namespace doris::vectorized {
+
+VJsonScanner::VJsonScanner(RuntimeState* state, RuntimeProfile* profile,
+                           const TBrokerScanRangeParams& params,
+                           const std::vector<TBrokerRangeDesc>& ranges,
+                           const std::vector<TNetworkAddress>& broker_addresses,
+                           const std::vector<TExpr>& pre_filter_texprs, ScannerCounter* counter)
+        : JsonScanner(state, profile, params, ranges, broker_addresses, pre_filter_texprs,
+                      counter) {}
+
+VJsonScanner::~VJsonScanner() = default;
+
+Status VJsonScanner::open() {
+    RETURN_IF_ERROR(JsonScanner::open());
+    _tuple_pool = std::make_unique<MemPool>(_mem_tracker.get());
+    return Status::OK();
+}
+
+Status VJsonScanner::get_next(std::vector<MutableColumnPtr>& columns, bool* eof) {
+    SCOPED_TIMER(_read_timer);
+    // the values read by the rapidjson JsonReader are copied into the dest columns
+    _tuple_pool->clear();
+    const size_t batch_size = _state->batch_size();
+    while (columns[0]->size() < batch_size && !_scanner_eof) {
+        if (_cur_file_reader == nullptr || _cur_reader_eof) {
+            RETURN_IF_ERROR(open_next_reader());
+            // If there isn't any more reader, break this
+            if (_scanner_eof) {
+                break;
+            }
+        }
+
+        if (_read_json_by_line && _skip_next_line) {
+            size_t size = 0;
+            const uint8_t* line_ptr = nullptr;
+            RETURN_IF_ERROR(_cur_line_reader->read_line(&line_ptr, &size, &_cur_reader_eof));
+            _skip_next_line = false;
+            continue;
+        }
+
+        if (_cur_vjson_reader == nullptr) {
+            RETURN_IF_ERROR(_read_row_by_json_reader(columns));
+            continue;
+        }
+
+        for (auto& column : _src_columns) {
+            column->clear();
+        }
+        size_t rows = 0;
+        RETURN_IF_ERROR(_cur_vjson_reader->read_json_rows(_src_slot_descs, _src_columns,
+                                                          batch_size - columns[0]->size(),
+                                                          &rows, &_cur_reader_eof));
+        COUNTER_UPDATE(_rows_read_counter, rows);
+        SCOPED_TIMER(_materialize_timer);
+        for (size_t i = 0; i < rows; ++i) {
+            _set_src_slots(i);
+            RETURN_IF_ERROR(fill_dest_columns(columns));
+            if (_success) {
+                free_expr_local_allocations();
+            }
+            if (_scanner_eof) {
+                break;
+            }
+        }
+    }
+    *eof = _scanner_eof;
+    return Status::OK();
+}
+
+Status VJsonScanner::_read_row_by_json_reader(std::vector<MutableColumnPtr>& columns) {
+    bool is_empty_row = false;
+    RETURN_IF_ERROR(_cur_json_reader->read_json_row(_src_tuple, _src_slot_descs, _tuple_pool.get(),
+                                                    &is_empty_row, &_cur_reader_eof));
+    if (is_empty_row) {
+        // Read empty row, just continue
+        return Status::OK();
+    }
+    COUNTER_UPDATE(_rows_read_counter, 1);
+    SCOPED_TIMER(_materialize_timer);
+    RETURN_IF_ERROR(fill_dest_columns(columns));
+    if (_success) {
+        free_expr_local_allocations();
+    }
+    return Status::OK();
+}
+
+void VJsonScanner::_set_src_slots(size_t pos) {
+    for (size_t i = 0; i < _src_slot_descs.size(); ++i) {
+        auto slot_desc = _src_slot_descs[i];
+        const auto& column = _src_columns[i];
+        if (column->is_null_at(pos)) {
+            _src_tuple->set_null(slot_desc->null_indicator_offset());
+            continue;
+        }
+        _src_tuple->set_not_null(slot_desc->null_indicator_offset());
+        StringRef value = column->get_data_at(pos);
+        auto* str_slot =
+                reinterpret_cast<StringValue*>(_src_tuple->get_slot(slot_desc->tuple_offset()));
+        str_slot->ptr = const_cast<char*>(value.data);
+        str_slot->len = value.size;
+    }
+}
+
+Status VJsonScanner::open_json_reader() {
+    _cur_vjson_reader.reset();
+
+    std::string json_root = "";
+    std::string jsonpath = "";
+    bool strip_outer_array = false;
+    bool num_as_string = false;
+
+    const TBrokerRangeDesc& range = _ranges[_next_range];
+
+    if (range.__isset.jsonpaths) {
+        jsonpath = range.jsonpaths;
+    }
+    if (range.__isset.json_root) {
+        json_root = range.json_root;
+    }
+    if (range.__isset.strip_outer_array) {
+        strip_outer_array = range.strip_outer_array;
+    }
+    if (range.__isset.num_as_string) {
+        num_as_string = range.num_as_string;
+    }
+
+    // simdjson can't read the numbers as strings
+    if (!num_as_string) {
+        std::unique_ptr<VJsonReader> reader;
+        if (_read_json_by_line) {
+            reader = std::make_unique<VJsonReader>(_state, _counter, _profile, strip_outer_array,
+                                                   &_scanner_eof, nullptr, _cur_line_reader);
+        } else {
+            reader = std::make_unique<VJsonReader>(_state, _counter, _profile, strip_outer_array,
+                                                   &_scanner_eof, _cur_file_reader);
+        }
+        bool supported = false;
+        RETURN_IF_ERROR(reader->init(jsonpath, json_root, &supported));
+        if (supported) {
+            _cur_vjson_reader = std::move(reader);
+            if (_cur_json_reader != nullptr) {
+                delete _cur_json_reader;
+                _cur_json_reader = nullptr;
+            }
+            _src_columns.clear();
+            for (auto slot_desc : _src_slot_descs) {
+                _src_columns.emplace_back(slot_desc->get_empty_mutable_column());
+            }
+            return Status::OK();
+        }
+    }
+    return JsonScanner::open_json_reader();
+}
+
+void VJsonScanner::close() {
+    _cur_vjson_reader.reset();
+    JsonScanner::close();
+}
+
+////// class VJsonReader
+VJsonReader::VJsonReader(RuntimeState* state, ScannerCounter* counter, RuntimeProfile* profile,
+                         bool strip_outer_array, bool* scanner_eof, FileReader* file_reader,
+                         LineReader* line_reader)
+        : _state(state),
+          _counter(counter),
+          _profile(profile),
+          _file_reader(file_reader),
+          _line_reader(line_reader),
+          _strip_outer_array(strip_outer_array),
+          _scanner_eof(scanner_eof) {
+    _bytes_read_counter = ADD_COUNTER(_profile, "BytesRead", TUnit::BYTES);
+    _read_timer = ADD_TIMER(_profile, "ReadTime");
+    _file_read_timer = ADD_TIMER(_profile, "FileReadTime");
+}
+
+Status VJsonReader::init(const std::string& jsonpath, const std::string& json_root,
+                         bool* supported) {
+    *supported = true;
+    if (!jsonpath.empty()) {
+        simdjson::dom::parser parser;
+        simdjson::dom::array paths;
+        if (parser.parse(jsonpath).get_array().get(paths) != simdjson::SUCCESS) {
+            return Status::InvalidArgument("Invalid json path: " + jsonpath);
+        }
+        for (auto element : paths) {
+            std::string_view path;
+            if (element.get_string().get(path) != simdjson::SUCCESS) {
+                return Status::InvalidArgument("Invalid json path: " + jsonpath);
+            }
+            std::vector<JsonPath> parsed_paths;
+            JsonFunctions::parse_json_paths(std::string(path), &parsed_paths);
+            _simd_jsonpaths.emplace_back();
+            _is_simd_jsonpath.push_back(_simd_jsonpaths.back().init(parsed_paths));
+            _parsed_jsonpaths.push_back(std::move(parsed_paths));
+        }
+    }
+    if (!json_root.empty()) {
+        JsonFunctions::parse_json_paths(json_root, &_parsed_json_root);
+        if (_parsed_json_root.size() == 1 && _parsed_json_root[0].is_valid) {
+            // the json root is "$", which is the entire document
+            _parsed_json_root.clear();
+        } else if (!_simd_json_root.init(_parsed_json_root)) {
+            *supported = false;
+        }
+    }
+    return Status::OK();
+}
+
+Status VJsonReader::read_json_rows(const std::vector<SlotDescriptor*>& slot_descs,
+                                   std::vector<MutableColumnPtr>& columns, size_t max_rows,
+                                   size_t* rows, bool* eof) {
+    SCOPED_TIMER(_read_timer);
+    _values.resize(slot_descs.size());
+    _is_null.resize(slot_descs.size());
+    _buffers.resize(slot_descs.size());
+
+    *rows = 0;
+    while (*rows < max_rows) {
+        simdjson::dom::element row;
+        if (_has_single_row) {
+            row = _json_doc;
+            _has_single_row = false;
+        } else if (_next_row != _rows_end) {
+            row = *_next_row;
+            ++_next_row;
+        } else {
+            Status st = _parse_json_doc(eof);
+            if (st.is_data_quality_error()) {
+                continue; // continue to read next
+            }
+            RETURN_IF_ERROR(st); // terminate if encounter other errors
+            if (*eof) {
+                break;
+            }
+            if (_parsed_jsonpaths.empty() && _strip_outer_array && _next_row == _rows_end) {
+                // may be passing an empty json, such as "[]"
+                RETURN_IF_ERROR(_append_error_msg(_json_doc, "Empty json line"));
+                if (*_scanner_eof) {
+                    break;
+                }
+            }
+            continue;
+        }
+
+        bool valid = false;
+        if (_parsed_jsonpaths.empty()) {
+            RETURN_IF_ERROR(_set_values(row, slot_descs, &valid));
+        } else {
+            RETURN_IF_ERROR(_set_values_by_jsonpath(row, slot_descs, &valid));
+        }
+        if (valid) {
+            _append_values(columns);
+            (*rows)++;
+        } else if (*_scanner_eof) {
+            // When _scanner_eof is true and valid is false, it means that we have encountered
+            // unqualified data and decided to stop the scan.
+            break;
+        }
+    }
+    return Status::OK();
+}
+
+Status VJsonReader::_parse_json_doc(bool* eof) {
+    // read a whole message
+    SCOPED_TIMER(_file_read_timer);
+    const uint8_t* json_str = nullptr;
+    size_t size = 0;
+    std::unique_ptr<uint8_t[]> json_str_ptr;
+    if (_line_reader != nullptr) {
+        RETURN_IF_ERROR(_line_reader->read_line(&json_str, &size, eof));
+    } else {
+        int64_t length = 0;
+        RETURN_IF_ERROR(_file_reader->read_one_message(&json_str_ptr, &length));
+        json_str = json_str_ptr.get();
+        size = length;
+        if (length == 0) {
+            *eof = true;
+        }
+    }
+
+    COUNTER_UPDATE(_bytes_read_counter, size);
+    if (*eof) {
+        return Status::OK();
+    }
+
+    std::string_view json(reinterpret_cast<const char*>(json_str), size);
+    simdjson::dom::element doc;
+    if (_parser.parse(json.data(), json.size()).get(doc) != simdjson::SUCCESS) {
+        RETURN_IF_ERROR(_parse_json_doc_by_rapidjson(json, &doc, eof));
+        if (*eof) {
+            return Status::OK();
+        }
+    }
+
+    // set json root
+    if (!_parsed_json_root.empty()) {
+        simdjson::dom::element root;
+        bool found = false;
+        auto result = _simd_json_root.find(doc, &root);
+        if (result == SimdJsonPath::UNSUPPORTED) {
+            RETURN_IF_ERROR(
+                    _find_by_rapidjson(_parsed_json_root, doc, &_root_parser, &root, &found));
+        } else {
+            found = result == SimdJsonPath::FOUND;
+        }
+        if (!found) {
+            return _doc_error([&]() -> std::string { return simdjson::minify(doc); },
+                              "JSON Root not found.", eof);
+        }
+        doc = root;
+    }
+
+    if (doc.is_array() && !_strip_outer_array) {
+        return _doc_error([&]() -> std::string { return simdjson::minify(doc); },
+                          "JSON data is array-object, `strip_outer_array` must be TRUE.", eof);
+    }
+    if (!doc.is_array() && _strip_outer_array) {
+        return _doc_error([&]() -> std::string { return simdjson::minify(doc); },
+                          "JSON data is not an array-object, `strip_outer_array` must be FALSE.",
+                          eof);
+    }
+
+    _json_doc = doc;
+    if (_strip_outer_array) {
+        simdjson::dom::array rows = doc.get_array();
+        _next_row = rows.begin();
+        _rows_end = rows.end();
+    } else {
+        _has_single_row = true;
+    }
+    return Status::OK();
+}
+
+Status VJsonReader::_parse_json_doc_by_rapidjson(const std::string_view& json,
+                                                 simdjson::dom::element* doc, bool* eof) {
+    rapidjson::Document document;
+    if (document.Parse(json.data(), json.size()).HasParseError()) {
+        fmt::memory_buffer error_msg;
+        fmt::format_to(error_msg, "Parse json data for JsonDoc failed. code: {}, error info: {}",
+                       document.GetParseError(),
+                       rapidjson::GetParseError_En(document.GetParseError()));
+        return _doc_error([&]() -> std::string { return std::string(json); },
+                          fmt::to_string(error_msg), eof);
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    document.Accept(writer);
+    auto error = _parser.parse(buffer.GetString(), buffer.GetSize()).get(*doc);
+    if (error != simdjson::SUCCESS) {
+        return _doc_error([&]() -> std::string { return std::string(json); },
+                          fmt::format("Parse json data failed: {}", simdjson::error_message(error)),
+                          eof);
+    }
+    return Status::OK();
+}
+
+Status VJsonReader::_doc_error(std::function<std::string()> json, const std::string& error_msg,
+                               bool* eof) {
+    RETURN_IF_ERROR(_state->append_error_msg_to_file(
+            json, [&]() -> std::string { return error_msg; }, _scanner_eof));
+    _counter->num_rows_filtered++;
+    if (*_scanner_eof) {
+        // _scanner_eof is set to true in "append_error_msg_to_file", which means we meet enough
+        // invalid rows and the scanner should be stopped, as if we meet the end of file.
+        *eof = true;
+        return Status::OK();
+    }
+    return Status::DataQualityError(error_msg);
+}
+
+Status VJsonReader::_append_error_msg(simdjson::dom::element value,
+                                      const std::string& error_msg) {
+    RETURN_IF_ERROR(_state->append_error_msg_to_file(
+            [&]() -> std::string { return simdjson::minify(value); },
+            [&]() -> std::string { return error_msg; }, _scanner_eof));
+    _counter->num_rows_filtered++;
+    return Status::OK();
+}
+
+// for simple format json
+// set valid to true and return OK if succeed.
+// set valid to false and return OK if we met an invalid row.
+// return other status if encounter other problmes.
+Status VJsonReader::_set_values(simdjson::dom::element row,
+                                const std::vector<SlotDescriptor*>& slot_descs, bool* valid) {
+    *valid = false;
+    if (!row.is_object()) {
+        // Here we expect the incoming row to be a Json Object, such as {"key" : "value"},
+        // not other type of Json format.
+        return _append_error_msg(row, "Expect json object value");
+    }
+
+    size_t null_count = 0;
+    for (size_t i = 0; i < slot_descs.size(); ++i) {
+        auto slot_desc = slot_descs[i];
+        simdjson::dom::element value;
+        if (row.at_key(slot_desc->col_name()).get(value) == simdjson::SUCCESS) {
+            RETURN_IF_ERROR(_set_value(value, slot_desc, i, true, valid));
+            if (!(*valid)) {
+                return Status::OK();
+            }
+        } else if (slot_desc->is_nullable()) { // not found
+            _is_null[i] = 1;
+            null_count++;
+        } else {
+            *valid = false;
+            return _append_error_msg(
+                    row, fmt::format("The column `{}` is not nullable, but it's not found in "
+                                     "jsondata.",
+                                     slot_desc->col_name()));
+        }
+    }
+
+    if (null_count == slot_descs.size()) {
+        *valid = false;
+        return _append_error_msg(row, "All fields is null, this is a invalid row.");
+    }
+    *valid = true;
+    return Status::OK();
+}
+
+Status VJsonReader::_set_values_by_jsonpath(simdjson::dom::element row,
+                                            const std::vector<SlotDescriptor*>& slot_descs,
+                                            bool* valid) {
+    *valid = false;
+    size_t null_count = 0;
+    for (size_t i = 0; i < slot_descs.size(); ++i) {
+        auto slot_desc = slot_descs[i];
+        simdjson::dom::element value;
+        bool found = false;
+        bool in_document = true;
+        if (LIKELY(i < _parsed_jsonpaths.size()) && _parsed_jsonpaths[i][0].is_valid) {
+            const auto& path = _parsed_jsonpaths[i];
+            if (path.size() == 1) {
+                // the json path is "$", the entire row is wrapped by an array as JsonReader does
+                _buffers[i] = "[" + simdjson::minify(row) + "]";
+                _values[i] = StringRef(_buffers[i].data(), _buffers[i].size());
+                _is_null[i] = 0;
+                continue;
+            }
+            auto result = _is_simd_jsonpath[i] ? _simd_jsonpaths[i].find(row, &value)
+                                               : SimdJsonPath::UNSUPPORTED;
+            if (result == SimdJsonPath::UNSUPPORTED) {
+                RETURN_IF_ERROR(_find_by_rapidjson(path, row, &_value_parser, &value, &found));
+                in_document = false;
+            } else {
+                found = result == SimdJsonPath::FOUND;
+            }
+        }
+
+        if (found) {
+            RETURN_IF_ERROR(_set_value(value, slot_desc, i, in_document, valid));
+            if (!(*valid)) {
+                return Status::OK();
+            }
+        } else if (slot_desc->is_nullable()) { // not match in jsondata.
+            _is_null[i] = 1;
+            null_count++;
+        } else {
+            *valid = false;
+            return _append_error_msg(
+                    row, fmt::format("The column `{}` is not nullable, but it's not found in "
+                                     "jsondata.",
+                                     slot_desc->col_name()));
+        }
+    }
+
+    if (null_count == slot_descs.size()) {
+        *valid = false;
+        return _append_error_msg(row, "All fields is null or not matched, this is a invalid row.");
+    }
+    *valid = true;
+    return Status::OK();
+}
+
+Status VJsonReader::_find_by_rapidjson(const std::vector<JsonPath>& path,
+                                       simdjson::dom::element root,
+                                       simdjson::dom::parser* parser,
+                                       simdjson::dom::element* value, bool* found) {
+    *found = false;
+    std::string json = simdjson::minify(root);
+    rapidjson::Document document;
+    if (document.Parse(json.data(), json.size()).HasParseError()) {
+        return Status::InternalError("failed to parse the json by rapidjson: " + json);
+    }
+    rapidjson::Value* result = JsonFunctions::get_json_object_from_parsed_json(
+            path, &document, document.GetAllocator());
+    if (result == nullptr) {
+        return Status::OK();
+    }
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    result->Accept(writer);
+    if (parser->parse(buffer.GetString(), buffer.GetSize()).get(*value) != simdjson::SUCCESS) {
+        return Status::InternalError(
+                std::string("failed to parse the json by simdjson: ") + buffer.GetString());
+    }
+    *found = true;
+    return Status::OK();
+}
+
+Status VJsonReader::_set_value(simdjson::dom::element value, SlotDescriptor* slot_desc,
+                               size_t idx, bool in_document, bool* valid) {
+    std::string& buffer = _buffers[idx];
+    _is_null[idx] = 0;
+    switch (value.type()) {
+    case simdjson::dom::element_type::STRING: {
+        std::string_view str = value.get_string().value_unsafe();
+        if (in_document) {
+            _values[idx] = StringRef(str.data(), str.size());
+            *valid = true;
+            return Status::OK();
+        }
+        buffer.assign(str.data(), str.size());
+        break;
+    }
+    case simdjson::dom::element_type::INT64: {
+        fmt::format_int str(value.get_int64().value_unsafe());
+        buffer.assign(str.data(), str.size());
+        break;
+    }
+    case simdjson::dom::element_type::UINT64: {
+        fmt::format_int str(value.get_uint64().value_unsafe());
+        buffer.assign(str.data(), str.size());
+        break;
+    }
+    case simdjson::dom::element_type::DOUBLE:
+        // the same as the "%f" of JsonReader
+        buffer = fmt::format("{:f}", value.get_double().value_unsafe());
+        break;
+    case simdjson::dom::element_type::BOOL:
+        buffer = value.get_bool().value_unsafe() ? "1" : "0";
+        break;
+    case simdjson::dom::element_type::NULL_VALUE:
+        if (slot_desc->is_nullable()) {
+            _is_null[idx] = 1;
+            *valid = true;
+            return Status::OK();
+        }
+        *valid = false;
+        return _append_error_msg(
+                value, fmt::format("Json value is null, but the column `{}` is not nullable.",
+                                   slot_desc->col_name()));
+    default:
+        // for other type like array or object. we convert it to string to save
+        buffer = simdjson::minify(value);
+        break;
+    }
+    _values[idx] = StringRef(buffer.data(), buffer.size());
+    *valid = true;
+    return Status::OK();
+}
+
+void VJsonReader::_append_values(std::vector<MutableColumnPtr>& columns) {
+    for (size_t i = 0; i < columns.size(); ++i) {
+        IColumn* column = columns[i].get();
+        if (column->is_nullable()) {
+            auto* nullable_column = assert_cast<ColumnNullable*>(column);
+            nullable_column->get_null_map_data().push_back(_is_null[i]);
+            column = &nullable_column->get_nested_column();
+        }
+        if (_is_null[i]) {
+            column->insert_default();
+        } else {
+            column->insert_data(_values[i].data, _values[i].size);
+        }
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,165 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <simdjson.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "exec/json_scanner.h"
+#include "exprs/json_functions.h"
+#include "vec/functions/simd_json_path.h"
+
+namespace doris::vectorized {
+
+class VJsonReader;
+
+// Vectorized scanner of json files. The documents are parsed by simdjson, and the values of the
+// src slots of a batch of rows are appended to the src columns before being converted to the
+// dest columns. The rapidjson JsonReader is still used if the numbers must be read as strings
+// (num_as_string), or the json root can't be found by simdjson.
+class VJsonScanner final : public JsonScanner {
+public:
+    VJsonScanner(RuntimeState* state, RuntimeProfile* profile, const TBrokerScanRangeParams& params,
+                 const std::vector<TBrokerRangeDesc>& ranges,
+                 const std::vector<TNetworkAddress>& broker_addresses,
+                 const std::vector<TExpr>& pre_filter_texprs, ScannerCounter* counter);
+    ~VJsonScanner() override;
+
+    Status open() override;
+
+    Status get_next(doris::Tuple* tuple, MemPool* tuple_pool, bool* eof,
+                    bool* fill_tuple) override {
+        return Status::NotSupported("Not Implemented get next");
+    }
+
+    Status get_next(std::vector<MutableColumnPtr>& columns, bool* eof) override;
+
+    void close() override;
+
+protected:
+    Status open_json_reader() override;
+
+private:
+    // Read one row by the rapidjson JsonReader into the src tuple.
+    Status _read_row_by_json_reader(std::vector<MutableColumnPtr>& columns);
+    // Point the src slots to the values at `pos` of the src columns.
+    void _set_src_slots(size_t pos);
+
+    std::unique_ptr<VJsonReader> _cur_vjson_reader;
+    // the values of the src slots of the rows read by _cur_vjson_reader
+    std::vector<MutableColumnPtr> _src_columns;
+    // the values of the src tuple read by the rapidjson JsonReader
+    std::unique_ptr<MemPool> _tuple_pool;
+};
+
+// Reader to parse the json by simdjson, the same as JsonReader except that the numbers can't be
+// read as strings. The json paths are compiled once, the ones simdjson can't handle, e.g. [*],
+// are matched by rapidjson on the rows they are applied to.
+// For most of its methods which return type is Status,
+// return Status::OK() if process succeed or encounter data quality error.
+// return other error Status if encounter other errors.
+class VJsonReader {
+public:
+    VJsonReader(RuntimeState* state, ScannerCounter* counter, RuntimeProfile* profile,
+                bool strip_outer_array, bool* scanner_eof, FileReader* file_reader = nullptr,
+                LineReader* line_reader = nullptr);
+
+    // Must call before use. `supported` is set to false if the json root isn't supported.
+    Status init(const std::string& jsonpath, const std::string& json_root, bool* supported);
+
+    // Append the values of the src slots of at most `max_rows` valid rows to `columns`, one for
+    // each src slot. `rows` is the number of the rows appended.
+    Status read_json_rows(const std::vector<SlotDescriptor*>& slot_descs,
+                          std::vector<MutableColumnPtr>& columns, size_t max_rows, size_t* rows,
+                          bool* eof);
+
+private:
+    // Parse the next json string of the line reader or the file reader, and set the rows of it.
+    // return Status::DataQualityError() if data has quality error.
+    Status _parse_json_doc(bool* eof);
+    // Parse the json string which simdjson fails to parse by rapidjson, which reads the numbers
+    // out of the range of int64 and uint64 as doubles.
+    Status _parse_json_doc_by_rapidjson(const std::string_view& json, simdjson::dom::element* doc,
+                                        bool* eof);
+    // Record the error of the document, return Status::DataQualityError() unless the scanner is
+    // stopped because of too many errors.
+    Status _doc_error(std::function<std::string()> json, const std::string& error_msg, bool* eof);
+
+    // Set the values of the src slots from the row, `valid` is false if the row is invalid.
+    Status _set_values(simdjson::dom::element row, const std::vector<SlotDescriptor*>& slot_descs,
+                       bool* valid);
+    Status _set_values_by_jsonpath(simdjson::dom::element row,
+                                   const std::vector<SlotDescriptor*>& slot_descs, bool* valid);
+    // Set the value of the src slot `idx`, which is copied into the buffer of the slot if it's
+    // not in the document.
+    Status _set_value(simdjson::dom::element value, SlotDescriptor* slot_desc, size_t idx,
+                      bool in_document, bool* valid);
+    // Find the value of the path by rapidjson for the paths simdjson doesn't handle, the value
+    // found is parsed by `parser`.
+    Status _find_by_rapidjson(const std::vector<JsonPath>& path, simdjson::dom::element root,
+                              simdjson::dom::parser* parser, simdjson::dom::element* value,
+                              bool* found);
+    void _append_values(std::vector<MutableColumnPtr>& columns);
+    // Record the error of the row and count it as filtered.
+    Status _append_error_msg(simdjson::dom::element value, const std::string& error_msg);
+
+    RuntimeState* _state;
+    ScannerCounter* _counter;
+    RuntimeProfile* _profile;
+    FileReader* _file_reader;
+    LineReader* _line_reader;
+    bool _strip_outer_array;
+    RuntimeProfile::Counter* _bytes_read_counter;
+    RuntimeProfile::Counter* _read_timer;
+    RuntimeProfile::Counter* _file_read_timer;
+
+    std::vector<std::vector<JsonPath>> _parsed_jsonpaths;
+    // `_simd_jsonpaths[i]` is only valid if `_is_simd_jsonpath[i]` is true
+    std::vector<SimdJsonPath> _simd_jsonpaths;
+    std::vector<uint8_t> _is_simd_jsonpath;
+    std::vector<JsonPath> _parsed_json_root;
+    SimdJsonPath _simd_json_root;
+
+    simdjson::dom::parser _parser;
+    // the document after the json root is found
+    simdjson::dom::element _json_doc;
+    // the rows of the document, which is an array if strip_outer_array is true
+    simdjson::dom::array::iterator _next_row;
+    simdjson::dom::array::iterator _rows_end;
+    bool _has_single_row = false;
+    // the parsers of the json roots and the values found by rapidjson
+    simdjson::dom::parser _root_parser;
+    simdjson::dom::parser _value_parser;
+
+    // the values of the src slots of the row being read, a value either points into the
+    // document or the buffer of the slot
+    std::vector<StringRef> _values;
+    std::vector<uint8_t> _is_null;
+    std::vector<std::string> _buffers;
+
+    // point to the _scanner_eof of JsonScanner
+    bool* _scanner_eof;
+};
+
+} // namespace doris::vectorized
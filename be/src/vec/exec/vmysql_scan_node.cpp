@@ -53,46 +53,18 @@ Status VMysqlScanNode::get_next(RuntimeState* state, vectorized::Block* block, b
                 columns[i] = _tuple_desc->slots()[i]->get_empty_mutable_column();
             }
         }
-        while (true) {
-            RETURN_IF_CANCELLED(state);
-            int batch_size = state->batch_size();
-            if (columns[0]->size() == batch_size) {
-                break;
-            }
-
-            char** data = NULL;
-            unsigned long* length = NULL;
-            RETURN_IF_ERROR(_mysql_scanner->get_next_row(&data, &length, &mysql_eos));
-
-            if (mysql_eos) {
-                *eos = true;
-                break;
-            }
-            int j = 0;
-            for (int i = 0; i < _slot_num; ++i) {
-                auto slot_desc = _tuple_desc->slots()[i];
-                if (!slot_desc->is_materialized()) {
-                    continue;
-                }
-
-                if (data[j] == nullptr) {
-                    if (slot_desc->is_nullable()) {
-                        auto* nullable_column =
-                                reinterpret_cast<vectorized::ColumnNullable*>(columns[i].get());
-                        nullable_column->insert_data(nullptr, 0);
-                    } else {
-                        std::stringstream ss;
-                        ss << "nonnull column contains NULL. table=" << _table_name
-                           << ", column=" << slot_desc->col_name();
-                        return Status::InternalError(ss.str());
-                    }
-                } else {
-                    RETURN_IF_ERROR(
-                            write_text_column(data[j], length[j], slot_desc, &columns[i], state));
-                }
-                j++;
-            }
+        RETURN_IF_CANCELLED(state);
+        // fetch the rows of a block at once, then convert them column by column
+        std::vector<char**> rows;
+        std::vector<unsigned long> lengths;
+        rows.reserve(state->batch_size());
+        lengths.reserve(state->batch_size() * _mysql_scanner->field_num());
+        RETURN_IF_ERROR(
+                _mysql_scanner->get_next_rows(state->batch_size(), &rows, &lengths, &mysql_eos));
+        if (mysql_eos) {
+            *eos = true;
         }
+        RETURN_IF_ERROR(write_text_columns(rows, lengths, columns, state));
         auto n_columns = 0;
         if (!mem_reuse) {
             for (const auto slot_desc : _tuple_desc->slots()) {
@@ -110,6 +82,41 @@ Status VMysqlScanNode::get_next(RuntimeState* state, vectorized::Block* block, b
     return Status::OK();
 }
 
+Status VMysqlScanNode::write_text_columns(const std::vector<char**>& rows,
+                                          const std::vector<unsigned long>& lengths,
+                                          std::vector<vectorized::MutableColumnPtr>& columns,
+                                          RuntimeState* state) {
+    const int field_num = _mysql_scanner->field_num();
+    int j = 0;
+    for (int i = 0; i < _slot_num; ++i) {
+        auto slot_desc = _tuple_desc->slots()[i];
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        columns[i]->reserve(columns[i]->size() + rows.size());
+        for (size_t row = 0; row < rows.size(); ++row) {
+            char* data = rows[row][j];
+            if (data == nullptr) {
+                if (slot_desc->is_nullable()) {
+                    auto* nullable_column =
+                            reinterpret_cast<vectorized::ColumnNullable*>(columns[i].get());
+                    nullable_column->insert_data(nullptr, 0);
+                } else {
+                    std::stringstream ss;
+                    ss << "nonnull column contains NULL. table=" << _table_name
+                       << ", column=" << slot_desc->col_name();
+                    return Status::InternalError(ss.str());
+                }
+            } else {
+                RETURN_IF_ERROR(write_text_column(data, lengths[row * field_num + j], slot_desc,
+                                                  &columns[i], state));
+            }
+        }
+        j++;
+    }
+    return Status::OK();
+}
+
 Status VMysqlScanNode::write_text_column(char* value, int value_length, SlotDescriptor* slot,
                                          vectorized::MutableColumnPtr* column_ptr,
                                          RuntimeState* state) {
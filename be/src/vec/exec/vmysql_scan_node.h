@@ -43,6 +43,11 @@ public:
     virtual Status get_next(RuntimeState* state, vectorized::Block* block, bool* eos);
 
 private:
+    // convert the fetched rows column by column
+    Status write_text_columns(const std::vector<char**>& rows,
+                              const std::vector<unsigned long>& lengths,
+                              std::vector<vectorized::MutableColumnPtr>& columns,
+                              RuntimeState* state);
     Status write_text_column(char* value, int value_length, SlotDescriptor* slot,
                              vectorized::MutableColumnPtr* column_ptr, RuntimeState* state);
 };
@@ -17,6 +17,8 @@
 
 #include "vec/exec/vodbc_scan_node.h"
 
+#include <algorithm>
+
 #include "exec/text_converter.h"
 #include "exec/text_converter.hpp"
 
@@ -24,7 +26,9 @@ namespace doris {
 namespace vectorized {
 
 VOdbcScanNode::VOdbcScanNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
-        : OdbcScanNode(pool, tnode, descs, "VOdbcScanNode") {}
+        : OdbcScanNode(pool, tnode, descs, "VOdbcScanNode") {
+    _fetch_batch = true;
+}
 VOdbcScanNode::~VOdbcScanNode() {}
 
 Status VOdbcScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
@@ -43,7 +47,6 @@ Status VOdbcScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
 
     auto odbc_scanner = get_odbc_scanner();
     auto tuple_desc = get_tuple_desc();
-    auto text_converter = get_text_converter();
 
     auto column_size = tuple_desc->slots().size();
     std::vector<MutableColumnPtr> columns(column_size);
@@ -54,6 +57,7 @@ Status VOdbcScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
 
     // Indicates whether there are more rows to process. Set in _odbc_scanner.next().
     bool odbc_eos = false;
+    const size_t batch_size = state->batch_size();
 
     do {
         RETURN_IF_CANCELLED(state);
@@ -66,42 +70,21 @@ Status VOdbcScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
             }
         }
 
-        for (int row_index = 0; true; row_index++) {
-            // block is full, break
-            if (state->batch_size() <= columns[0]->size()) {
-                break;
-            }
-
-            RETURN_IF_ERROR(odbc_scanner->get_next_row(&odbc_eos));
-
-            if (odbc_eos) {
-                *eos = true;
-                break;
-            }
-
-            // Read one row from reader
-
-            for (int column_index = 0, materialized_column_index = 0; column_index < column_size;
-                 ++column_index) {
-                auto slot_desc = tuple_desc->slots()[column_index];
-                // because the fe planner filter the non_materialize column
-                if (!slot_desc->is_materialized()) {
-                    continue;
-                }
-                const auto& column_data = odbc_scanner->get_column_data(materialized_column_index);
-
-                char* value_data = static_cast<char*>(column_data.target_value_ptr);
-                int value_len = column_data.strlen_or_ind;
-
-                if (!text_converter->write_column(slot_desc, &columns[column_index], value_data,
-                                                  value_len, true, false)) {
-                    std::stringstream ss;
-                    ss << "Fail to convert odbc value:'" << value_data << "' to "
-                       << slot_desc->type() << " on column:`" << slot_desc->col_name() + "`";
-                    return Status::InternalError(ss.str());
+        // block is full, break
+        while (columns[0]->size() < batch_size) {
+            if (_next_fetched_row >= _num_fetched_rows) {
+                // fetch the next rows at once
+                _next_fetched_row = 0;
+                RETURN_IF_ERROR(odbc_scanner->get_next_batch(&_num_fetched_rows, &odbc_eos));
+                if (odbc_eos) {
+                    *eos = true;
+                    break;
                 }
-                materialized_column_index++;
             }
+            size_t num_rows = std::min(_num_fetched_rows - _next_fetched_row,
+                                       batch_size - columns[0]->size());
+            RETURN_IF_ERROR(_write_columns(columns, _next_fetched_row, num_rows));
+            _next_fetched_row += num_rows;
         }
 
         // Before really use the Block, muse clear other ptr of column in block
@@ -125,5 +108,44 @@ Status VOdbcScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     return Status::OK();
 }
 
+Status VOdbcScanNode::_write_columns(std::vector<MutableColumnPtr>& columns, size_t start_row,
+                                     size_t num_rows) {
+    auto odbc_scanner = get_odbc_scanner();
+    auto tuple_desc = get_tuple_desc();
+    auto text_converter = get_text_converter();
+    for (int column_index = 0, materialized_column_index = 0;
+         column_index < tuple_desc->slots().size(); ++column_index) {
+        auto slot_desc = tuple_desc->slots()[column_index];
+        // because the fe planner filter the non_materialize column
+        if (!slot_desc->is_materialized()) {
+            continue;
+        }
+        const auto& column_data = odbc_scanner->get_column_data(materialized_column_index++);
+        columns[column_index]->reserve(columns[column_index]->size() + num_rows);
+        for (size_t row = start_row; row < start_row + num_rows; ++row) {
+            char* value_data = column_data.value(row);
+            SQLLEN value_len = column_data.length(row);
+            if (value_len == SQL_NULL_DATA && !slot_desc->is_nullable()) {
+                return Status::InternalError(
+                        fmt::format("nonnull column contains NULL. column=`{}`",
+                                    slot_desc->col_name()));
+            }
+            if (value_len > column_data.buffer_length) {
+                return Status::InternalError(
+                        fmt::format("the odbc value of column `{}` is truncated, length={}",
+                                    slot_desc->col_name(), value_len));
+            }
+            if (!text_converter->write_column(slot_desc, &columns[column_index], value_data,
+                                              value_len, true, false)) {
+                std::stringstream ss;
+                ss << "Fail to convert odbc value:'" << value_data << "' to " << slot_desc->type()
+                   << " on column:`" << slot_desc->col_name() + "`";
+                return Status::InternalError(ss.str());
+            }
+        }
+    }
+    return Status::OK();
+}
+
 } // namespace vectorized
 } // namespace doris
@@ -29,6 +29,15 @@ public:
 
     using OdbcScanNode::get_next;
     Status get_next(RuntimeState* state, Block* block, bool* eos);
+
+private:
+    // convert the fetched rows [start_row, start_row + num_rows) column by column
+    Status _write_columns(std::vector<MutableColumnPtr>& columns, size_t start_row,
+                          size_t num_rows);
+
+    // the rows fetched by the last ODBCConnector::get_next_batch, and the next one to convert
+    size_t _num_fetched_rows = 0;
+    size_t _next_fetched_row = 0;
 };
 } // namespace vectorized
 } // namespace doris
@@ -18,10 +18,18 @@
 #include "vec/exec/volap_scan_node.h"
 
 #include "gen_cpp/PlanNodes_types.h"
+#include "olap/merger.h"
+#include "olap/rowset/beta_rowset_reader.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/segment_loader.h"
 #include "runtime/descriptors.h"
 #include "runtime/exec_env.h"
+#include "runtime/fair_scan_scheduler.h"
 #include "runtime/runtime_filter_mgr.h"
+#include "runtime/workload_group.h"
+#include "service/backend_options.h"
 #include "util/priority_thread_pool.hpp"
+#include "vec/core/adaptive_block_size.h"
 #include "vec/core/block.h"
 #include "vec/exec/volap_scanner.h"
 #include "vec/exprs/vexpr.h"
@@ -143,10 +151,14 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
     SCOPED_ATTACH_TASK_THREAD(_runtime_state, mem_tracker());
     ADD_THREAD_LOCAL_MEM_TRACKER(scanner->mem_tracker());
     int64_t wait_time = scanner->update_wait_worker_timer();
+    WorkloadGroup::bind_thread_cgroup(_runtime_state->workload_group().get());
     // Do not use ScopedTimer. There is no guarantee that, the counter
     // (_scan_cpu_timer, the class member) is not destroyed after `_running_thread==0`.
     ThreadCpuStopWatch cpu_watch;
     cpu_watch.start();
+    // released with the timers before `_running_thread` is decreased, for the same reason
+    auto hardware_counters = std::make_unique<ScopedHardwareCounters>(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     Status status = Status::OK();
     bool eos = false;
     RuntimeState* state = scanner->runtime_state();
@@ -172,7 +184,10 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
             DCHECK(runtime_filter != nullptr);
             bool ready = runtime_filter->is_ready();
             if (ready) {
+                size_t begin = contexts.size();
                 runtime_filter->get_prepared_context(&contexts, row_desc(), _expr_mem_tracker);
+                publish_late_runtime_filter(
+                        i, std::vector<ExprContext*>(contexts.begin() + begin, contexts.end()));
                 _runtime_filter_ctxs[i].apply_mark = true;
             }
         }
@@ -199,10 +214,18 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
     int64_t raw_rows_threshold = raw_rows_read + config::doris_scanner_row_num;
     int64_t raw_bytes_read = 0;
     int64_t raw_bytes_threshold = config::doris_scanner_row_bytes;
+    // also yield after the time slice, to let the fair scan scheduler switch to the other queries
+    int64_t time_slice_ns = config::doris_scanner_time_slice_ms * NANOS_PER_MILLIS;
+    MonotonicStopWatch slice_watch;
+    slice_watch.start();
     bool get_free_block = true;
+    // the small blocks left by the conjuncts are merged up to the rows of the preferred block size
+    AdaptiveBlockSize merged_block_size(_runtime_state->batch_size(),
+                                        _runtime_state->preferred_block_size_bytes(),
+                                        config::adaptive_block_max_rows);
 
     while (!eos && raw_rows_read < raw_rows_threshold && raw_bytes_read < raw_bytes_threshold &&
-           get_free_block) {
+           get_free_block && (time_slice_ns <= 0 || slice_watch.elapsed_time() < time_slice_ns)) {
         if (UNLIKELY(_transfer_done)) {
             eos = true;
             status = Status::Cancelled("Cancelled");
@@ -228,8 +251,9 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
             std::lock_guard<std::mutex> l(_free_blocks_lock);
             _free_blocks.emplace_back(block);
         } else {
+            merged_block_size.observe(*block);
             if (!blocks.empty() &&
-                blocks.back()->rows() + block->rows() <= _runtime_state->batch_size()) {
+                blocks.back()->rows() + block->rows() <= merged_block_size.rows()) {
                 MutableBlock(blocks.back()).merge(*block);
                 block->clear_column_data();
                 std::lock_guard<std::mutex> l(_free_blocks_lock);
@@ -281,8 +305,10 @@ void VOlapScanNode::scanner_thread(VOlapScanner* scanner) {
             _scanner_done = true;
         }
     }
+    hardware_counters.reset();
     _scan_cpu_timer->update(cpu_watch.elapsed_time());
     _scanner_wait_worker_timer->update(wait_time);
+    _instance_scanner_wait_worker_timer->update(wait_time);
 
     std::unique_lock<std::mutex> l(_scan_blocks_lock);
     _running_thread--;
@@ -321,10 +347,25 @@ Status VOlapScanNode::start_scan_thread(RuntimeState* state) {
         return Status::OK();
     }
     _block_mem_tracker = MemTracker::create_virtual_tracker(-1, "VOlapScanNode:Block");
+    // the rows must be read if they are filtered by the conjuncts left in the scan node or
+    // by the runtime filters arriving later
+    if (_vconjunct_ctx_ptr || !_runtime_filter_descs.empty()) {
+        _push_down_agg_type_opt = TPushAggOp::NONE;
+    }
+    // the rows of a group are filtered before being aggregated, and the limit is of the rows
+    if (_pre_aggregation != nullptr &&
+        (_vconjunct_ctx_ptr || !_runtime_filter_descs.empty() || _limit != -1)) {
+        _pre_aggregation.reset();
+    }
+    if (_pre_aggregation != nullptr) {
+        _pre_agg_merged_rows_counter =
+                ADD_COUNTER(runtime_profile(), "PreAggMergedRows", TUnit::UNIT);
+    }
 
     // ranges constructed from scan keys
     std::vector<std::unique_ptr<OlapScanRange>> cond_ranges;
     RETURN_IF_ERROR(_scan_keys.get_key_range(&cond_ranges));
+    bool has_key_conditions = !cond_ranges.empty();
     // if we can't get ranges from conditions, we give it a total range
     if (cond_ranges.empty()) {
         cond_ranges.emplace_back(new OlapScanRange());
@@ -344,41 +385,91 @@ Status VOlapScanNode::start_scan_thread(RuntimeState* state) {
             return Status::InternalError(ss.str());
         }
 
-        int size_based_scanners_per_tablet = 1;
-
-        if (config::doris_scan_range_max_mb > 0) {
-            size_based_scanners_per_tablet = std::max(
-                    1, (int)tablet->tablet_footprint() / config::doris_scan_range_max_mb << 20);
+        // the tablets read without merge are split by the segments, and each split is read
+        // by its own scanners
+        std::vector<std::vector<RowsetSplit>> splits;
+        int64_t version = strtoul(scan_range->version.c_str(), nullptr, 10);
+        RETURN_IF_ERROR(_split_tablet_scan(tablet, version, &splits));
+        if (config::enable_scan_ndv_estimate) {
+            RETURN_IF_ERROR(_merge_ndv_sketches(tablet, version));
         }
 
-        int ranges_per_scanner =
-                std::max(1, (int)cond_ranges.size() /
-                                    std::min(scanners_per_tablet, size_based_scanners_per_tablet));
-        int num_ranges = cond_ranges.size();
-        for (int i = 0; i < num_ranges;) {
-            std::vector<OlapScanRange*> scanner_ranges;
-            scanner_ranges.push_back(cond_ranges[i].get());
-            ++i;
-            for (int j = 1; i < num_ranges && j < ranges_per_scanner &&
-                            cond_ranges[i]->end_include == cond_ranges[i - 1]->end_include;
-                 ++j, ++i) {
-                scanner_ranges.push_back(cond_ranges[i].get());
+        // the tablets read by merge are split by the keys instead
+        std::vector<std::unique_ptr<OlapScanRange>> key_split_ranges;
+        if (splits.empty() && !has_key_conditions) {
+            RETURN_IF_ERROR(_split_tablet_key_ranges(tablet, version, scanners_per_tablet,
+                                                     &key_split_ranges));
+        }
+        const auto& tablet_ranges = key_split_ranges.empty() ? cond_ranges : key_split_ranges;
+
+        int ranges_per_scanner = tablet_ranges.size();
+        if (!key_split_ranges.empty()) {
+            ranges_per_scanner = 1;
+        } else if (splits.size() <= 1) {
+            splits.clear();
+            int size_based_scanners_per_tablet = 1;
+
+            if (config::doris_scan_range_max_mb > 0) {
+                size_based_scanners_per_tablet = std::max(
+                        1, (int)tablet->tablet_footprint() / config::doris_scan_range_max_mb << 20);
             }
-            VOlapScanner* scanner =
-                    new VOlapScanner(state, this, _olap_scan_node.is_preaggregation,
-                                     _need_agg_finalize, *scan_range, _scanner_mem_tracker);
-            // add scanner to pool before doing prepare.
-            // so that scanner can be automatically deconstructed if prepare failed.
-            _scanner_pool.add(scanner);
-            RETURN_IF_ERROR(scanner->prepare(*scan_range, scanner_ranges, _olap_filter,
-                                             _bloom_filters_push_down));
 
-            _volap_scanners.push_back(scanner);
-            disk_set.insert(scanner->scan_disk());
+            ranges_per_scanner = std::max(
+                    1, (int)cond_ranges.size() /
+                               std::min(scanners_per_tablet, size_based_scanners_per_tablet));
+        }
+        int num_ranges = tablet_ranges.size();
+        size_t num_splits = std::max<size_t>(1, splits.size());
+        for (size_t split = 0; split < num_splits; ++split) {
+            for (int i = 0; i < num_ranges;) {
+                std::vector<OlapScanRange*> scanner_ranges;
+                scanner_ranges.push_back(tablet_ranges[i].get());
+                ++i;
+                for (int j = 1; i < num_ranges && j < ranges_per_scanner &&
+                                tablet_ranges[i]->end_include == tablet_ranges[i - 1]->end_include;
+                     ++j, ++i) {
+                    scanner_ranges.push_back(tablet_ranges[i].get());
+                }
+                VOlapScanner* scanner =
+                        new VOlapScanner(state, this, _olap_scan_node.is_preaggregation,
+                                         _need_agg_finalize, *scan_range, _scanner_mem_tracker);
+                // add scanner to pool before doing prepare.
+                // so that scanner can be automatically deconstructed if prepare failed.
+                _scanner_pool.add(scanner);
+                if (splits.empty()) {
+                    RETURN_IF_ERROR(scanner->prepare(*scan_range, scanner_ranges, _olap_filter,
+                                                     _bloom_filters_push_down));
+                } else {
+                    std::vector<RowsetReaderSharedPtr> rs_readers;
+                    RETURN_IF_ERROR(_create_split_readers(splits[split], &rs_readers));
+                    RETURN_IF_ERROR(scanner->prepare(*scan_range, scanner_ranges, _olap_filter,
+                                                     _bloom_filters_push_down, &rs_readers));
+                }
+                if (_pre_aggregation != nullptr) {
+                    scanner->init_pre_aggregation(*_pre_aggregation);
+                }
+
+                _volap_scanners.push_back(scanner);
+                disk_set.insert(scanner->scan_disk());
+            }
         }
     }
     COUNTER_SET(_num_disks_accessed_counter, static_cast<int64_t>(disk_set.size()));
     COUNTER_SET(_num_scanners, static_cast<int64_t>(_volap_scanners.size()));
+    if (!_ndv_sketches.empty()) {
+        std::stringstream ndvs;
+        const auto& slots = _tuple_desc->slots();
+        for (size_t i = 0; i < slots.size(); ++i) {
+            if (!_has_ndv_sketches[i]) {
+                continue;
+            }
+            int64_t ndv = _ndv_sketches[i].estimate_cardinality();
+            _estimated_ndvs[slots[i]->id()] = ndv;
+            ndvs << (_estimated_ndvs.size() > 1 ? ", " : "") << slots[i]->col_name() << "=" << ndv;
+        }
+        _ndv_sketches.clear();
+        _runtime_profile->add_info_string("EstimatedNdvs", ndvs.str());
+    }
 
     // init progress
     std::stringstream ss;
@@ -390,6 +481,180 @@ Status VOlapScanNode::start_scan_thread(RuntimeState* state) {
     return Status::OK();
 }
 
+int64_t VOlapScanNode::estimated_ndv(SlotId slot_id) const {
+    auto it = _estimated_ndvs.find(slot_id);
+    return it == _estimated_ndvs.end() ? -1 : it->second;
+}
+
+Status VOlapScanNode::_merge_ndv_sketches(const TabletSharedPtr& tablet, int64_t version) {
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rdlock(tablet->get_header_lock());
+        RETURN_IF_ERROR(tablet->capture_consistent_rowsets(Version(0, version), &rowsets));
+    }
+    const auto& slots = _tuple_desc->slots();
+    if (_ndv_sketches.empty()) {
+        _ndv_sketches.resize(slots.size());
+        _has_ndv_sketches.assign(slots.size(), true);
+    }
+    // the copies of a value in the different versions are counted once by the union of the
+    // sketches, so the sketches of all the rowsets are merged regardless of the keys type
+    for (auto& rowset : rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            _has_ndv_sketches.assign(slots.size(), false);
+            return Status::OK();
+        }
+        SegmentCacheHandle segment_cache_handle;
+        RETURN_IF_ERROR(SegmentLoader::instance()->load_segments(
+                std::static_pointer_cast<BetaRowset>(rowset), &segment_cache_handle, true));
+        for (auto& segment : segment_cache_handle.get_segments()) {
+            for (size_t i = 0; i < slots.size(); ++i) {
+                int32_t cid = tablet->field_index(slots[i]->col_name());
+                bool has_sketch = false;
+                if (_has_ndv_sketches[i] && cid >= 0) {
+                    RETURN_IF_ERROR(
+                            segment->merge_ndv_sketch(cid, &_ndv_sketches[i], &has_sketch));
+                }
+                _has_ndv_sketches[i] = has_sketch;
+            }
+        }
+    }
+    return Status::OK();
+}
+
+Status VOlapScanNode::_split_tablet_scan(const TabletSharedPtr& tablet, int64_t version,
+                                         std::vector<std::vector<RowsetSplit>>* splits) {
+    if (tablet->keys_type() != DUP_KEYS && !tablet->enable_unique_key_merge_on_write()) {
+        return Status::OK();
+    }
+    int64_t split_rows = config::doris_scan_range_row_count;
+    if (split_rows <= 0) {
+        return Status::OK();
+    }
+
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rdlock(tablet->get_header_lock());
+        Status st = tablet->capture_consistent_rowsets(Version(0, version), &rowsets);
+        if (!st.ok()) {
+            std::stringstream ss;
+            ss << "failed to capture rowsets. tablet=" << tablet->full_name() << ", res=" << st
+               << ", backend=" << BackendOptions::get_localhost();
+            LOG(WARNING) << ss.str();
+            return Status::InternalError(ss.str());
+        }
+    }
+
+    // the rows of the segments of a rowset are not recorded in the rowset meta,
+    // so they are estimated by the average rows of the segments
+    std::vector<RowsetSplit> split;
+    int64_t rows_in_split = 0;
+    for (auto& rowset : rowsets) {
+        int64_t num_rows = rowset->num_rows();
+        if (num_rows <= 0) {
+            continue;
+        }
+        int64_t num_segments = 1;
+        if (rowset->rowset_meta()->rowset_type() == BETA_ROWSET) {
+            num_segments = std::max<int64_t>(1, rowset->num_segments());
+        }
+        int64_t rows_per_segment = std::max<int64_t>(1, num_rows / num_segments);
+        int64_t begin = 0;
+        for (int64_t seg = 0; seg < num_segments; ++seg) {
+            rows_in_split += rows_per_segment;
+            if (rows_in_split >= split_rows) {
+                split.push_back({rowset, begin, seg + 1});
+                splits->push_back(std::move(split));
+                split.clear();
+                rows_in_split = 0;
+                begin = seg + 1;
+            }
+        }
+        if (begin < num_segments) {
+            split.push_back({rowset, begin, num_segments});
+        }
+    }
+    if (!split.empty()) {
+        splits->push_back(std::move(split));
+    }
+    return Status::OK();
+}
+
+Status VOlapScanNode::_split_tablet_key_ranges(
+        const TabletSharedPtr& tablet, int64_t version, int max_ranges,
+        std::vector<std::unique_ptr<OlapScanRange>>* ranges) {
+    if (tablet->keys_type() != UNIQUE_KEYS || tablet->enable_unique_key_merge_on_write() ||
+        max_ranges <= 1) {
+        return Status::OK();
+    }
+    int64_t split_rows = config::doris_scan_range_row_count;
+    if (split_rows <= 0) {
+        return Status::OK();
+    }
+
+    std::vector<RowsetSharedPtr> rowsets;
+    {
+        std::shared_lock rdlock(tablet->get_header_lock());
+        Status st = tablet->capture_consistent_rowsets(Version(0, version), &rowsets);
+        if (!st.ok()) {
+            std::stringstream ss;
+            ss << "failed to capture rowsets. tablet=" << tablet->full_name() << ", res=" << st
+               << ", backend=" << BackendOptions::get_localhost();
+            LOG(WARNING) << ss.str();
+            return Status::InternalError(ss.str());
+        }
+    }
+    // the short key index only exists in the segments of the beta rowsets
+    int64_t num_rows = 0;
+    for (auto& rowset : rowsets) {
+        if (rowset->rowset_meta()->rowset_type() != BETA_ROWSET) {
+            return Status::OK();
+        }
+        num_rows += rowset->num_rows();
+    }
+    int num_ranges = std::min<int64_t>(max_ranges, num_rows / split_rows);
+    if (num_ranges <= 1) {
+        return Status::OK();
+    }
+
+    std::vector<Merger::KeyRange> key_ranges;
+    RETURN_IF_ERROR(Merger::split_key_ranges(
+            tablet->tablet_schema(), rowsets, num_ranges, &key_ranges,
+            std::max(1, config::doris_scan_range_split_keys_per_segment)));
+    if (key_ranges.size() <= 1) {
+        return Status::OK();
+    }
+    // the end of the last range is empty, which has no upper bound
+    for (auto& key_range : key_ranges) {
+        auto range = std::make_unique<OlapScanRange>();
+        range->begin_include = true;
+        range->end_include = false;
+        range->begin_scan_range = std::move(key_range.start);
+        range->end_scan_range = std::move(key_range.end);
+        ranges->push_back(std::move(range));
+    }
+    return Status::OK();
+}
+
+Status VOlapScanNode::_create_split_readers(const std::vector<RowsetSplit>& split,
+                                            std::vector<RowsetReaderSharedPtr>* rs_readers) {
+    for (auto& rowset_split : split) {
+        RowsetReaderSharedPtr rs_reader;
+        Status st = rowset_split.rowset->create_reader(&rs_reader);
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to create reader for rowset:"
+                         << rowset_split.rowset->rowset_id();
+            return Status::InternalError("failed to create rowset reader");
+        }
+        if (rs_reader->type() == BETA_ROWSET) {
+            std::static_pointer_cast<BetaRowsetReader>(rs_reader)->set_segment_range(
+                    rowset_split.segment_begin, rowset_split.segment_end);
+        }
+        rs_readers->push_back(std::move(rs_reader));
+    }
+    return Status::OK();
+}
+
 Status VOlapScanNode::close(RuntimeState* state) {
     if (is_closed()) {
         return Status::OK();
@@ -439,9 +704,20 @@ Status VOlapScanNode::close(RuntimeState* state) {
     return ScanNode::close(state);
 }
 
+bool VOlapScanNode::can_read() {
+    // the scan is started by get_next()
+    if (!_start || _eos) {
+        return true;
+    }
+    std::lock_guard<std::mutex> l(_blocks_lock);
+    return !_materialized_blocks.empty() || _transfer_done;
+}
+
 Status VOlapScanNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(mem_tracker());
 
     // check if Canceled.
@@ -602,6 +878,15 @@ int VOlapScanNode::_start_scanner_thread_task(RuntimeState* state, int block_per
 
     // post volap scanners to thread-pool
     PriorityThreadPool* thread_pool = state->exec_env()->scan_thread_pool();
+    FairScanScheduler* fair_scheduler = state->exec_env()->fair_scan_scheduler();
+    // the weight of the queries out of the workload groups is the default cpu share
+    int weight = WorkloadGroupInfo().cpu_share;
+    if (state->workload_group() != nullptr) {
+        weight = state->workload_group()->info().cpu_share;
+    } else if (state->query_options().__isset.resource_limit &&
+               state->query_options().resource_limit.__isset.cpu_limit) {
+        weight *= std::max(state->query_options().resource_limit.cpu_limit, 1);
+    }
     auto iter = olap_scanners.begin();
     while (iter != olap_scanners.end()) {
         PriorityThreadPool::Task task;
@@ -609,7 +894,10 @@ int VOlapScanNode::_start_scanner_thread_task(RuntimeState* state, int block_per
         task.priority = _nice;
         task.queue_id = state->exec_env()->store_path_to_index((*iter)->scan_disk());
         (*iter)->start_wait_worker_timer();
-        if (thread_pool->offer(task)) {
+        bool offered = config::enable_fair_scan_scheduler
+                               ? fair_scheduler->offer(state->query_id(), weight, task)
+                               : thread_pool->offer(task);
+        if (offered) {
             olap_scanners.erase(iter++);
         } else {
             LOG(FATAL) << "Failed to assign scanner task to thread pool!";
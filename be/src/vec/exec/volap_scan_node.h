@@ -17,8 +17,14 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "exec/olap_scan_node.h"
 #include "exprs/runtime_filter.h"
+#include "olap/hll.h"
 
 namespace doris {
 class ObjectPool;
@@ -29,6 +35,15 @@ namespace vectorized {
 
 class VOlapScanner;
 
+// The aggregation of the aggregation node above the scan, which the scanners of the aggregate
+// key tablets grouped by a prefix of the keys partially aggregate, see BlockPreAggregator.
+struct ScanPreAggregation {
+    // the positions in the scan tuple of the slots grouped by
+    std::vector<int> group_by_columns;
+    // the name of the aggregate function on each slot aggregated, by its position
+    std::map<int, std::string> agg_functions;
+};
+
 class VOlapScanNode final : public OlapScanNode {
 public:
     VOlapScanNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -40,6 +55,19 @@ public:
     Status get_next(RuntimeState* state, Block* block, bool* eos) override;
     Status close(RuntimeState* state) override;
 
+    // Return true if get_next() will not block waiting for the scanners.
+    bool can_read();
+
+    // The number of distinct values of the slot in the tablets scanned, estimated by the ndv
+    // sketches of the segments, -1 if unknown. Valid after the scanners are started.
+    int64_t estimated_ndv(SlotId slot_id) const;
+
+    // Let the scanners partially aggregate the rows for the aggregation node above, where they
+    // can. Must be called before open().
+    void set_pre_aggregation(ScanPreAggregation pre_aggregation) {
+        _pre_aggregation = std::make_unique<ScanPreAggregation>(std::move(pre_aggregation));
+    }
+
 private:
     void transfer_thread(RuntimeState* state);
     void scanner_thread(VOlapScanner* scanner);
@@ -49,6 +77,31 @@ private:
     int _start_scanner_thread_task(RuntimeState* state, int block_per_scanner);
     Block* _alloc_block(bool& get_free_block);
 
+    // the segments [segment_begin, segment_end) of a rowset
+    struct RowsetSplit {
+        RowsetSharedPtr rowset;
+        int64_t segment_begin;
+        int64_t segment_end;
+    };
+    // Split the rowsets of `version` of the tablet by the segments, so that a tablet is scanned
+    // in parallel regardless of how many tablets the query reads. Each split has about
+    // doris_scan_range_row_count rows. Only the tablets read without merge are split, i.e. the
+    // duplicate key and the merge-on-write unique key tablets.
+    Status _split_tablet_scan(const TabletSharedPtr& tablet, int64_t version,
+                              std::vector<std::vector<RowsetSplit>>* splits);
+    static Status _create_split_readers(const std::vector<RowsetSplit>& split,
+                                        std::vector<RowsetReaderSharedPtr>* rs_readers);
+    // Split the keys of the rowsets of `version` of a merge-on-read unique key tablet into at
+    // most `max_ranges` ranges of about doris_scan_range_row_count rows by the short key index,
+    // so that the ranges are merged in parallel by their own scanners. The rows of a key are
+    // always in the same range. Only doris_scan_range_split_keys_per_segment short keys of a
+    // segment are sampled, and the end of the last range is empty.
+    static Status _split_tablet_key_ranges(const TabletSharedPtr& tablet, int64_t version,
+                                           int max_ranges,
+                                           std::vector<std::unique_ptr<OlapScanRange>>* ranges);
+    // merge the ndv sketches of the columns of the slots in the rowsets of `version`
+    Status _merge_ndv_sketches(const TabletSharedPtr& tablet, int64_t version);
+
     std::vector<Block*> _scan_blocks;
     std::vector<Block*> _materialized_blocks;
     std::mutex _blocks_lock;
@@ -69,6 +122,14 @@ private:
     int _max_materialized_blocks;
 
     size_t _block_size = 0;
+
+    // the merged ndv sketches of the slots, a slot has no estimate if any segment has no sketch
+    std::vector<HyperLogLog> _ndv_sketches;
+    std::vector<bool> _has_ndv_sketches;
+    std::unordered_map<SlotId, int64_t> _estimated_ndvs;
+
+    std::unique_ptr<ScanPreAggregation> _pre_aggregation;
+    RuntimeProfile::Counter* _pre_agg_merged_rows_counter = nullptr;
 };
 } // namespace vectorized
 } // namespace doris
@@ -17,9 +17,12 @@
 
 #include "vec/exec/volap_scanner.h"
 
+#include <algorithm>
 #include <memory>
 
+#include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
+#include "vec/aggregate_functions/aggregate_function_reader.h"
 #include "vec/columns/column_complex.h"
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/column_string.h"
@@ -35,7 +38,9 @@ namespace doris::vectorized {
 VOlapScanner::VOlapScanner(RuntimeState* runtime_state, VOlapScanNode* parent, bool aggregation,
                            bool need_agg_finalize, const TPaloScanRange& scan_range,
                            std::shared_ptr<MemTracker> tracker)
-        : OlapScanner(runtime_state, parent, aggregation, need_agg_finalize, scan_range, tracker) {}
+        : OlapScanner(runtime_state, parent, aggregation, need_agg_finalize, scan_range, tracker),
+          _block_size(runtime_state->batch_size(), runtime_state->preferred_block_size_bytes(),
+                      runtime_state->batch_size()) {}
 
 Status VOlapScanner::get_block(RuntimeState* state, vectorized::Block* block, bool* eof) {
     // only empty block should be here
@@ -52,9 +57,12 @@ Status VOlapScanner::get_block(RuntimeState* state, vectorized::Block* block, bo
         }
     }
 
+    auto parent = static_cast<VOlapScanNode*>(_parent);
     {
         SCOPED_TIMER(_parent->_scan_timer);
         do {
+            // all the blocks read may be filtered out, so check the cancellation in between
+            RETURN_IF_CANCELLED(_runtime_state);
             // Read one block from block reader
             auto res = _tablet_reader->next_block_with_aggregation(block, nullptr, nullptr, eof);
             if (!res) {
@@ -66,6 +74,20 @@ Status VOlapScanner::get_block(RuntimeState* state, vectorized::Block* block, bo
             }
             _num_rows_read += block->rows();
             _update_realtime_counter();
+            if (_block_size.enabled()) {
+                _block_size.observe(*block);
+                _tablet_reader->set_block_row_limit(_block_size.rows());
+            }
+
+            if (_row_locator_pos >= 0) {
+                RETURN_IF_ERROR(_fill_row_locators(block));
+            }
+            if (_pre_aggregator != nullptr) {
+                int64_t merged_rows = _pre_aggregator->merged_rows();
+                _pre_aggregator->aggregate(block, *eof);
+                COUNTER_UPDATE(parent->_pre_agg_merged_rows_counter,
+                               _pre_aggregator->merged_rows() - merged_rows);
+            }
 
             RETURN_IF_ERROR(
                     VExprContext::filter_block(_vconjunct_ctx, block, _tuple_desc->slots().size()));
@@ -80,6 +102,107 @@ Status VOlapScanner::get_block(RuntimeState* state, vectorized::Block* block, bo
     return Status::OK();
 }
 
+Status VOlapScanner::_fill_row_locators(vectorized::Block* block) {
+    std::vector<RowLocation> locations;
+    if (block->rows() > 0) {
+        RETURN_IF_ERROR(_tablet_reader->current_block_row_locations(&locations));
+        DCHECK_EQ(locations.size(), block->rows());
+    }
+    int64_t backend_id = _runtime_state->exec_env()->master_info()->backend_id;
+    auto column = ColumnString::create();
+    for (const auto& location : locations) {
+        GlobalRowLocation global_location(backend_id, _tablet->tablet_id(), location);
+        column->insert_data(reinterpret_cast<const char*>(&global_location),
+                            sizeof(global_location));
+    }
+
+    auto slot_desc = _tuple_desc->slots()[_row_locator_pos];
+    ColumnPtr locator_column = std::move(column);
+    if (slot_desc->is_nullable()) {
+        locator_column = make_nullable(locator_column);
+    }
+    // the reader may swap in a block of only the return columns
+    if (block->columns() > _row_locator_pos) {
+        block->replace_by_position(_row_locator_pos, std::move(locator_column));
+    } else {
+        DCHECK_EQ(block->columns(), _row_locator_pos);
+        block->insert({std::move(locator_column), slot_desc->get_data_type_ptr(),
+                       slot_desc->col_name()});
+    }
+    return Status::OK();
+}
+
+// Whether `fn_name` over the rows merged by `aggregation` returns what it returns over the rows.
+static bool is_consistent_aggregation(const std::string& fn_name,
+                                      FieldAggregationMethod aggregation) {
+    switch (aggregation) {
+    case OLAP_FIELD_AGGREGATION_SUM:
+        // the aggregation node checks the type of the sum is the type of the column
+        return fn_name == "sum";
+    case OLAP_FIELD_AGGREGATION_MIN:
+        return fn_name == "min";
+    case OLAP_FIELD_AGGREGATION_MAX:
+        return fn_name == "max";
+    case OLAP_FIELD_AGGREGATION_BITMAP_UNION:
+        return fn_name == "bitmap_union" || fn_name == "bitmap_union_count";
+    case OLAP_FIELD_AGGREGATION_HLL_UNION:
+        return fn_name == "hll_union" || fn_name == "hll_union_agg" || fn_name == "hll_raw_agg";
+    default:
+        return false;
+    }
+}
+
+void VOlapScanner::init_pre_aggregation(const ScanPreAggregation& pre_aggregation) {
+    if (_tablet->keys_type() != AGG_KEYS || _row_locator_pos >= 0) {
+        return;
+    }
+    const auto& slots = _tuple_desc->slots();
+    const auto& tablet_schema = _tablet->tablet_schema();
+    int32_t num_key_columns = _tablet->num_key_columns();
+
+    // the rows of a group are consecutive only if the keys grouped by are a prefix of the keys
+    std::vector<bool> is_grouped_by(num_key_columns, false);
+    for (int column : pre_aggregation.group_by_columns) {
+        int32_t index = _tablet->field_index(slots[column]->col_name());
+        if (index < 0 || index >= num_key_columns) {
+            return;
+        }
+        is_grouped_by[index] = true;
+    }
+    int32_t prefix_length = std::find(is_grouped_by.begin(), is_grouped_by.end(), false) -
+                            is_grouped_by.begin();
+    // the rows are merged by all the keys by the reader already
+    if (prefix_length == num_key_columns ||
+        std::find(is_grouped_by.begin() + prefix_length, is_grouped_by.end(), true) !=
+                is_grouped_by.end()) {
+        return;
+    }
+
+    std::vector<AggregateFunctionPtr> agg_functions(slots.size());
+    for (const auto& [column, fn_name] : pre_aggregation.agg_functions) {
+        int32_t index = _tablet->field_index(slots[column]->col_name());
+        if (index < num_key_columns) {
+            return;
+        }
+        FieldAggregationMethod aggregation = tablet_schema.column(index).aggregation();
+        if (!is_consistent_aggregation(fn_name, aggregation)) {
+            return;
+        }
+        std::string agg_name =
+                TabletColumn::get_string_by_aggregation_type(aggregation) + AGG_READER_SUFFIX;
+        std::transform(agg_name.begin(), agg_name.end(), agg_name.begin(),
+                       [](unsigned char c) { return std::tolower(c); });
+        DataTypePtr type = slots[column]->get_data_type_ptr();
+        agg_functions[column] = AggregateFunctionSimpleFactory::instance().get(
+                agg_name, {type}, {}, type->is_nullable());
+        if (agg_functions[column] == nullptr) {
+            return;
+        }
+    }
+    _pre_aggregator = std::make_unique<BlockPreAggregator>(pre_aggregation.group_by_columns,
+                                                           std::move(agg_functions));
+}
+
 void VOlapScanner::set_tablet_reader() {
     _tablet_reader = std::make_unique<BlockReader>();
 }
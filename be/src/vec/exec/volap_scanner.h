@@ -19,6 +19,8 @@
 
 #include "exec/olap_scanner.h"
 
+#include "vec/core/adaptive_block_size.h"
+#include "vec/olap/block_pre_aggregator.h"
 #include "vec/olap/block_reader.h"
 
 namespace doris {
@@ -29,6 +31,7 @@ class RowBatch;
 
 namespace vectorized {
 class VOlapScanNode;
+struct ScanPreAggregation;
 
 class VOlapScanner : public OlapScanner {
 public:
@@ -48,12 +51,26 @@ public:
 
     bool need_to_close() { return _need_to_close; }
 
+    // Partially aggregate the rows read if the tablet is of aggregate keys, `pre_aggregation`
+    // groups by a prefix of the keys and aggregates each value column by a function consistent
+    // with the aggregation of the column. Otherwise the rows are returned as they are.
+    // Must be called after prepare().
+    void init_pre_aggregation(const ScanPreAggregation& pre_aggregation);
+
 protected:
     virtual void set_tablet_reader() override;
 
 private:
+    // fill the column of the row locators of the rows read into `block`
+    Status _fill_row_locators(vectorized::Block* block);
+
     VExprContext* _vconjunct_ctx = nullptr;
     bool _need_to_close = false;
+    // bounds the rows read from the segments by the width of the rows read so far, it only
+    // lowers the rows of the blocks of wide rows below the batch size
+    AdaptiveBlockSize _block_size;
+
+    std::unique_ptr<BlockPreAggregator> _pre_aggregator;
 };
 
 } // namespace vectorized
@@ -0,0 +1,438 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vorc_scanner.h"
+
+#include <fmt/format.h>
+
+#include <orc/sargs/SearchArgument.hh>
+
+#include "exec/exec_node.h"
+#include "exprs/expr_context.h"
+#include "runtime/datetime_value.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+// `unscaled` is the string of the unscaled integer of the decimal
+void append_decimal(const std::string& unscaled, int scale, ColumnString* column) {
+    int negative = unscaled[0] == '-' ? 1 : 0;
+    int decimal_scale_length = unscaled.size() - negative;
+
+    std::string v;
+    if (decimal_scale_length <= scale) {
+        // decimal(5,2) : the integer of 0.01 is 1, so we should fill 0 befor integer
+        v = std::string(negative ? "-0." : "0.");
+        v.append(scale - decimal_scale_length, '0');
+        v.append(unscaled, negative, std::string::npos);
+    } else {
+        //Orc api will fill in 0 at the end, so size must greater than scale
+        v = unscaled.substr(0, unscaled.size() - scale) + "." +
+            unscaled.substr(unscaled.size() - scale);
+    }
+    column->insert_data(v.data(), v.size());
+}
+
+Status append_datetime(int64_t timestamp, bool is_date, ColumnString* column) {
+    DateTimeValue dtv;
+    if (!dtv.from_unixtime(timestamp, cctz::utc_time_zone())) {
+        std::stringstream str_error;
+        str_error << "Parse timestamp (" + std::to_string(timestamp) + ") error";
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+    if (is_date) {
+        dtv.cast_to_date();
+    }
+    char buf[64];
+    char* buf_end = dtv.to_string(buf);
+    column->insert_data(buf, buf_end - buf - 1);
+    return Status::OK();
+}
+
+} // namespace
+
+VORCScanner::VORCScanner(RuntimeState* state, RuntimeProfile* profile,
+                         const TBrokerScanRangeParams& params,
+                         const std::vector<TBrokerRangeDesc>& ranges,
+                         const std::vector<TNetworkAddress>& broker_addresses,
+                         const std::vector<TExpr>& pre_filter_texprs, ScannerCounter* counter)
+        : ORCScanner(state, profile, params, ranges, broker_addresses, pre_filter_texprs,
+                     counter) {}
+
+Status VORCScanner::open() {
+    RETURN_IF_ERROR(ORCScanner::open());
+    std::vector<SlotId> slot_ids;
+    for (auto ctx : _pre_filter_ctxs) {
+        ctx->root()->get_slot_ids(&slot_ids);
+    }
+    _pre_filter_slot_ids.insert(slot_ids.begin(), slot_ids.end());
+    get_pre_filter_predicates(&_predicates);
+    return Status::OK();
+}
+
+void VORCScanner::init_row_reader_options() {
+    std::map<std::string, orc::TypeKind> column_kinds;
+    const orc::Type& type = _reader->getType();
+    for (uint64_t i = 0; i < type.getSubtypeCount(); ++i) {
+        column_kinds.emplace(type.getFieldName(i), type.getSubtype(i)->getKind());
+    }
+
+    std::unique_ptr<orc::SearchArgumentBuilder> builder = orc::SearchArgumentFactory::newBuilder();
+    builder->startAnd();
+    int num_predicates = 0;
+    for (const auto& predicate : _predicates) {
+        if (predicate.slot_idx >= static_cast<size_t>(_num_of_columns_from_file)) {
+            continue;
+        }
+        const std::string& name = _src_slot_descs[predicate.slot_idx]->col_name();
+        auto it = column_kinds.find(name);
+        if (it == column_kinds.end()) {
+            continue;
+        }
+        // the values of the columns must be compared in the same way as the src strings
+        orc::PredicateDataType data_type;
+        orc::Literal literal(false);
+        if (predicate.is_string &&
+            (it->second == orc::STRING || it->second == orc::VARCHAR)) {
+            data_type = orc::PredicateDataType::STRING;
+            literal = orc::Literal(predicate.string_value.data(), predicate.string_value.size());
+        } else if (!predicate.is_string &&
+                   (it->second == orc::BYTE || it->second == orc::SHORT ||
+                    it->second == orc::INT || it->second == orc::LONG)) {
+            data_type = orc::PredicateDataType::LONG;
+            literal = orc::Literal(predicate.int_value);
+        } else {
+            continue;
+        }
+        switch (predicate.op) {
+        case TExprOpcode::EQ:
+            builder->equals(name, data_type, literal);
+            break;
+        case TExprOpcode::NE:
+            builder->startNot().equals(name, data_type, literal).end();
+            break;
+        case TExprOpcode::LT:
+            builder->lessThan(name, data_type, literal);
+            break;
+        case TExprOpcode::LE:
+            builder->lessThanEquals(name, data_type, literal);
+            break;
+        case TExprOpcode::GT:
+            builder->startNot().lessThanEquals(name, data_type, literal).end();
+            break;
+        case TExprOpcode::GE:
+            builder->startNot().lessThan(name, data_type, literal).end();
+            break;
+        default:
+            continue;
+        }
+        num_predicates++;
+    }
+    builder->end();
+    _row_reader_options.searchArgument(num_predicates > 0 ? builder->build() : nullptr);
+}
+
+Status VORCScanner::get_next(std::vector<MutableColumnPtr>& columns, bool* eof) {
+    try {
+        SCOPED_TIMER(_read_timer);
+        const size_t batch_size = _state->batch_size();
+        while (columns[0]->size() < batch_size && !_scanner_eof) {
+            if (_cur_file_eof) {
+                RETURN_IF_ERROR(_open_next_reader());
+                // If there isn't any more reader, break this
+                if (_scanner_eof) {
+                    continue;
+                }
+            }
+            if (_current_line_of_group >= _rows_of_group) {
+                if (!_row_reader->next(*_batch)) {
+                    _cur_file_eof = true;
+                    continue;
+                }
+                _rows_of_group = _batch->numElements;
+                _current_line_of_group = 0;
+                continue;
+            }
+
+            size_t start = _current_line_of_group;
+            size_t rows = std::min<int64_t>(batch_size - columns[0]->size(),
+                                            _rows_of_group - _current_line_of_group);
+            _current_line_of_group += rows;
+            COUNTER_UPDATE(_rows_read_counter, rows);
+            RETURN_IF_ERROR(_read_src_columns(start, rows));
+
+            SCOPED_TIMER(_materialize_timer);
+            for (size_t i = 0; i < _selected_rows.size(); ++i) {
+                _set_src_slots(_pre_filter_slot_idxs, _selected_rows[i] - start);
+                _set_src_slots(_other_slot_idxs, i);
+                RETURN_IF_ERROR(fill_dest_columns(columns));
+                if (_success) {
+                    free_expr_local_allocations();
+                }
+                if (_scanner_eof) {
+                    break;
+                }
+            }
+        }
+        *eof = _scanner_eof;
+        return Status::OK();
+    } catch (orc::ParseError& e) {
+        std::stringstream str_error;
+        str_error << "ParseError : " << e.what();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    } catch (orc::InvalidArgument& e) {
+        std::stringstream str_error;
+        str_error << "ParseError : " << e.what();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    } catch (std::exception& e) {
+        std::stringstream str_error;
+        str_error << "Error : " << e.what();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+}
+
+Status VORCScanner::_open_next_reader() {
+    RETURN_IF_ERROR(open_next_reader());
+    if (_scanner_eof) {
+        return Status::OK();
+    }
+    _cur_file_eof = false;
+    _batch = _row_reader->createRowBatch(_state->batch_size());
+
+    _src_columns.clear();
+    _pre_filter_slot_idxs.clear();
+    _other_slot_idxs.clear();
+    for (int i = 0; i < _num_of_columns_from_file; ++i) {
+        auto slot_desc = _src_slot_descs[i];
+        _src_columns.emplace_back(slot_desc->get_empty_mutable_column());
+        if (_pre_filter_slot_ids.count(slot_desc->id()) > 0) {
+            _pre_filter_slot_idxs.push_back(i);
+        } else {
+            _other_slot_idxs.push_back(i);
+        }
+    }
+    // the values of the columns from path are the same for all the rows of the file
+    const TBrokerRangeDesc& range = _ranges.at(_next_range - 1);
+    if (range.__isset.num_of_columns_from_file) {
+        fill_slots_of_columns_from_path(range.num_of_columns_from_file, range.columns_from_path);
+    }
+    return Status::OK();
+}
+
+Status VORCScanner::_read_src_columns(size_t start, size_t rows) {
+    for (auto& column : _src_columns) {
+        column->clear();
+    }
+    _batch_rows.clear();
+    for (size_t row = start; row < start + rows; ++row) {
+        _batch_rows.push_back(row);
+    }
+
+    if (_pre_filter_slot_idxs.empty()) {
+        _selected_rows = _batch_rows;
+    } else {
+        for (size_t idx : _pre_filter_slot_idxs) {
+            RETURN_IF_ERROR(_append_values(idx, _batch_rows, _src_columns[idx].get()));
+        }
+        _selected_rows.clear();
+        for (size_t i = 0; i < rows; ++i) {
+            _set_src_slots(_pre_filter_slot_idxs, i);
+            if (ExecNode::eval_conjuncts(&_pre_filter_ctxs[0], _pre_filter_ctxs.size(),
+                                         _src_tuple_row)) {
+                _selected_rows.push_back(start + i);
+            } else {
+                _counter->num_rows_unselected++;
+            }
+        }
+    }
+
+    // the other columns are only converted for the selected rows
+    for (size_t idx : _other_slot_idxs) {
+        RETURN_IF_ERROR(_append_values(idx, _selected_rows, _src_columns[idx].get()));
+    }
+    return Status::OK();
+}
+
+template <typename Converter>
+Status VORCScanner::_append_values(size_t slot_idx, const orc::ColumnVectorBatch* cvb,
+                                   const std::vector<size_t>& rows, ColumnString* column,
+                                   NullMap* null_map, Converter convert) {
+    for (size_t row : rows) {
+        if (cvb->hasNulls && !cvb->notNull[row]) {
+            if (null_map == nullptr) {
+                std::stringstream str_error;
+                str_error << "The field name(" << _src_slot_descs[slot_idx]->col_name()
+                          << ") is not nullable ";
+                LOG(WARNING) << str_error.str();
+                return Status::InternalError(str_error.str());
+            }
+            null_map->push_back(1);
+            column->insert_default();
+            continue;
+        }
+        if (null_map != nullptr) {
+            null_map->push_back(0);
+        }
+        RETURN_IF_ERROR(convert(row, column));
+    }
+    return Status::OK();
+}
+
+Status VORCScanner::_append_values(size_t slot_idx, const std::vector<size_t>& rows,
+                                   IColumn* column) {
+    NullMap* null_map = nullptr;
+    if (column->is_nullable()) {
+        auto* nullable_column = assert_cast<ColumnNullable*>(column);
+        null_map = &nullable_column->get_null_map_data();
+        column = &nullable_column->get_nested_column();
+    }
+    auto* string_column = typeid_cast<ColumnString*>(column);
+    if (string_column == nullptr) {
+        return Status::InternalError(fmt::format("the source column {} must be a string column",
+                                                 _src_slot_descs[slot_idx]->col_name()));
+    }
+
+    const int position = _position_in_orc_original[slot_idx];
+    const orc::ColumnVectorBatch* cvb = ((orc::StructVectorBatch*)_batch.get())->fields[position];
+    const orc::Type* type = _row_reader->getSelectedType().getSubtype(position);
+    switch (type->getKind()) {
+    case orc::BOOLEAN: {
+        const auto* data = ((const orc::LongVectorBatch*)cvb)->data.data();
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [data](size_t row, ColumnString* column) {
+                                  if (data[row] == 0) {
+                                      column->insert_data("false", 5);
+                                  } else {
+                                      column->insert_data("true", 4);
+                                  }
+                                  return Status::OK();
+                              });
+    }
+    case orc::BYTE:
+    case orc::INT:
+    case orc::SHORT:
+    case orc::LONG: {
+        const auto* data = ((const orc::LongVectorBatch*)cvb)->data.data();
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [data](size_t row, ColumnString* column) {
+                                  fmt::format_int value(data[row]);
+                                  column->insert_data(value.data(), value.size());
+                                  return Status::OK();
+                              });
+    }
+    case orc::FLOAT:
+    case orc::DOUBLE: {
+        const auto* data = ((const orc::DoubleVectorBatch*)cvb)->data.data();
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [data](size_t row, ColumnString* column) {
+                                  fmt::memory_buffer buf;
+                                  fmt::format_to(buf, "{:.9f}", data[row]);
+                                  column->insert_data(buf.data(), buf.size());
+                                  return Status::OK();
+                              });
+    }
+    case orc::BINARY:
+    case orc::CHAR:
+    case orc::VARCHAR:
+    case orc::STRING: {
+        const auto* string_cvb = (const orc::StringVectorBatch*)cvb;
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [string_cvb](size_t row, ColumnString* column) {
+                                  column->insert_data(string_cvb->data[row],
+                                                      string_cvb->length[row]);
+                                  return Status::OK();
+                              });
+    }
+    case orc::DECIMAL: {
+        //Decimal64VectorBatch handles decimal columns with precision no greater than 18.
+        //Decimal128VectorBatch handles the others.
+        const int scale = type->getScale();
+        if (type->getPrecision() == 0 || type->getPrecision() > 18) {
+            const auto* decimal_cvb = (const orc::Decimal128VectorBatch*)cvb;
+            return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                                  [decimal_cvb, scale](size_t row, ColumnString* column) {
+                                      append_decimal(decimal_cvb->values[row].toString(), scale,
+                                                     column);
+                                      return Status::OK();
+                                  });
+        }
+        const auto* decimal_cvb = (const orc::Decimal64VectorBatch*)cvb;
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [decimal_cvb, scale](size_t row, ColumnString* column) {
+                                  append_decimal(std::to_string(decimal_cvb->values[row]), scale,
+                                                 column);
+                                  return Status::OK();
+                              });
+    }
+    case orc::DATE: {
+        //Date columns record the number of days since the UNIX epoch (1/1/1970 in UTC).
+        const auto* data = ((const orc::LongVectorBatch*)cvb)->data.data();
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [data](size_t row, ColumnString* column) {
+                                  return append_datetime(data[row] * 24 * 60 * 60, true, column);
+                              });
+    }
+    case orc::TIMESTAMP: {
+        //The time zone of orc's timestamp is stored inside orc's stripe information,
+        //so the timestamp obtained here is an offset timestamp, so parse timestamp with UTC is
+        //actual datetime literal.
+        const auto* data = ((const orc::TimestampVectorBatch*)cvb)->data.data();
+        return _append_values(slot_idx, cvb, rows, string_column, null_map,
+                              [data](size_t row, ColumnString* column) {
+                                  return append_datetime(data[row], false, column);
+                              });
+    }
+    default: {
+        std::stringstream str_error;
+        str_error << "The field name(" << _src_slot_descs[slot_idx]->col_name()
+                  << ") type not support. ";
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+    }
+}
+
+void VORCScanner::_set_src_slots(const std::vector<size_t>& slot_idxs, size_t pos) {
+    for (size_t idx : slot_idxs) {
+        auto slot_desc = _src_slot_descs[idx];
+        const auto& column = _src_columns[idx];
+        if (column->is_null_at(pos)) {
+            _src_tuple->set_null(slot_desc->null_indicator_offset());
+            continue;
+        }
+        _src_tuple->set_not_null(slot_desc->null_indicator_offset());
+        StringRef value = column->get_data_at(pos);
+        auto* str_slot =
+                reinterpret_cast<StringValue*>(_src_tuple->get_slot(slot_desc->tuple_offset()));
+        str_slot->ptr = const_cast<char*>(value.data);
+        str_slot->len = value.size;
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <set>
+#include <vector>
+
+#include "exec/orc_scanner.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+
+namespace doris::vectorized {
+
+// Vectorized scanner of orc files. The stripes and the row groups are skipped by the search
+// argument built from the preceding filters, so the orc reader never reads them. For each batch,
+// the columns referred by the preceding filters are converted into the src columns first, and
+// the other columns are only converted for the rows passing the filters.
+class VORCScanner final : public ORCScanner {
+public:
+    VORCScanner(RuntimeState* state, RuntimeProfile* profile, const TBrokerScanRangeParams& params,
+                const std::vector<TBrokerRangeDesc>& ranges,
+                const std::vector<TNetworkAddress>& broker_addresses,
+                const std::vector<TExpr>& pre_filter_texprs, ScannerCounter* counter);
+    ~VORCScanner() override = default;
+
+    Status open() override;
+
+    Status get_next(doris::Tuple* tuple, MemPool* tuple_pool, bool* eof,
+                    bool* fill_tuple) override {
+        return Status::NotSupported("Not Implemented get next");
+    }
+
+    Status get_next(std::vector<MutableColumnPtr>& columns, bool* eof) override;
+
+protected:
+    void init_row_reader_options() override;
+
+private:
+    Status _open_next_reader();
+    Status _read_src_columns(size_t start, size_t rows);
+    // Append the values of the rows `rows` of the current batch of slot `slot_idx` to `column`.
+    Status _append_values(size_t slot_idx, const std::vector<size_t>& rows, IColumn* column);
+    template <typename Converter>
+    Status _append_values(size_t slot_idx, const orc::ColumnVectorBatch* cvb,
+                          const std::vector<size_t>& rows, ColumnString* column,
+                          NullMap* null_map, Converter convert);
+    // Point the slots `slot_idxs` of the src tuple to the values at `pos` of the src columns.
+    void _set_src_slots(const std::vector<size_t>& slot_idxs, size_t pos);
+
+    std::vector<PreFilterPredicate> _predicates;
+
+    // the columns of the src slots read from the file
+    std::vector<MutableColumnPtr> _src_columns;
+    // the slots referred by the preceding filters
+    std::set<SlotId> _pre_filter_slot_ids;
+    // the indexes of the src slots read from the file, referred by the preceding filters or not
+    std::vector<size_t> _pre_filter_slot_idxs;
+    std::vector<size_t> _other_slot_idxs;
+    // the rows of the current batch being read, and the ones passing the preceding filters
+    std::vector<size_t> _batch_rows;
+    std::vector<size_t> _selected_rows;
+};
+
+} // namespace doris::vectorized
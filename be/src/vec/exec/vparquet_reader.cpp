@@ -0,0 +1,565 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vparquet_reader.h"
+
+#include <fmt/format.h>
+
+#include <string_view>
+
+#include "common/logging.h"
+#include "exec/parquet_reader.h"
+#include "runtime/datetime_value.h"
+#include "runtime/descriptors.h"
+#include "util/timezone_utils.h"
+#include "vec/common/assert_cast.h"
+#include "vec/common/typeid_cast.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+// Append the decimal of the unscaled `value` and `scale` as a string, like 12.340
+void append_decimal(__int128 value, int scale, ColumnString* column) {
+    char buf[64];
+    char* end = buf + sizeof(buf);
+    char* p = end;
+    bool negative = value < 0;
+    unsigned __int128 abs_value = negative ? -static_cast<unsigned __int128>(value) : value;
+    int digits = 0;
+    do {
+        *--p = '0' + static_cast<int>(abs_value % 10);
+        abs_value /= 10;
+        if (++digits == scale) {
+            *--p = '.';
+        }
+    } while (abs_value != 0 || digits <= scale);
+    if (negative) {
+        *--p = '-';
+    }
+    column->insert_data(p, end - p);
+}
+
+// The unscaled value of a decimal stored as a big-endian two's complement binary.
+Status read_big_endian_decimal(const uint8_t* data, int len, __int128* value) {
+    if (static_cast<size_t>(len) > sizeof(__int128)) {
+        return Status::NotSupported(fmt::format("decimal of {} bytes is not supported", len));
+    }
+    unsigned __int128 unscaled = (len > 0 && (data[0] & 0x80)) ? ~static_cast<unsigned __int128>(0)
+                                                               : 0;
+    for (int i = 0; i < len; ++i) {
+        unscaled = (unscaled << 8) | data[i];
+    }
+    *value = static_cast<__int128>(unscaled);
+    return Status::OK();
+}
+
+// Whether some value in [min, max] may satisfy `value_in_range op value`.
+template <typename T>
+bool range_may_match(TExprOpcode::type op, const T& min, const T& max, const T& value) {
+    switch (op) {
+    case TExprOpcode::EQ:
+        return !(value < min) && !(max < value);
+    case TExprOpcode::NE:
+        return !(min == value && max == value);
+    case TExprOpcode::LT:
+        return min < value;
+    case TExprOpcode::LE:
+        return !(value < min);
+    case TExprOpcode::GT:
+        return value < max;
+    case TExprOpcode::GE:
+        return !(max < value);
+    default:
+        return true;
+    }
+}
+
+// Whether some value of the column chunk of `statistics` may satisfy `predicate`.
+bool statistics_may_match(const PreFilterPredicate& predicate,
+                          const parquet::Statistics& statistics) {
+    const parquet::ColumnDescriptor* descr = statistics.descr();
+    const auto& logical_type = descr->logical_type();
+    if (predicate.is_string) {
+        // the string columns whose min/max are ordered by the bytes
+        if (descr->physical_type() != parquet::Type::BYTE_ARRAY ||
+            !(logical_type->is_none() || logical_type->is_string()) ||
+            descr->sort_order() != parquet::SortOrder::UNSIGNED) {
+            return true;
+        }
+        const auto& typed = static_cast<const parquet::ByteArrayStatistics&>(statistics);
+        auto to_string_view = [](const parquet::ByteArray& value) {
+            return std::string_view(reinterpret_cast<const char*>(value.ptr), value.len);
+        };
+        return range_may_match<std::string_view>(predicate.op, to_string_view(typed.min()),
+                                                 to_string_view(typed.max()),
+                                                 predicate.string_value);
+    }
+
+    // the integers whose string values are the same as the values cast to the integers
+    if (!(logical_type->is_none() || logical_type->is_int())) {
+        return true;
+    }
+    const bool is_unsigned =
+            logical_type->is_int() &&
+            !static_cast<const parquet::IntLogicalType&>(*logical_type).is_signed();
+    if (descr->physical_type() == parquet::Type::INT32) {
+        const auto& typed = static_cast<const parquet::Int32Statistics&>(statistics);
+        int64_t min = is_unsigned ? static_cast<uint32_t>(typed.min()) : typed.min();
+        int64_t max = is_unsigned ? static_cast<uint32_t>(typed.max()) : typed.max();
+        return range_may_match(predicate.op, min, max, predicate.int_value);
+    }
+    if (descr->physical_type() == parquet::Type::INT64 && !is_unsigned) {
+        const auto& typed = static_cast<const parquet::Int64Statistics&>(statistics);
+        return range_may_match(predicate.op, typed.min(), typed.max(), predicate.int_value);
+    }
+    return true;
+}
+
+template <typename T>
+void append_integer(T value, ColumnString* column) {
+    fmt::format_int str(value);
+    column->insert_data(str.data(), str.size());
+}
+
+template <typename T>
+void append_floating_point(T value, ColumnString* column) {
+    // Because the decimal type currently only supports (27, 9).
+    // Therefore, we use %.9f to give priority to the progress of the decimal type.
+    fmt::memory_buffer buf;
+    fmt::format_to(buf, "{:.9f}", value);
+    column->insert_data(buf.data(), buf.size());
+}
+
+} // namespace
+
+VParquetReader::VParquetReader(FileReader* file_reader, int32_t num_of_columns_from_file)
+        : _num_of_columns_from_file(num_of_columns_from_file) {
+    _parquet = std::make_shared<ParquetFile>(file_reader);
+    _properties = parquet::ReaderProperties();
+    _properties.enable_buffered_stream();
+    _properties.set_buffer_size(65535);
+}
+
+VParquetReader::~VParquetReader() {
+    close();
+}
+
+Status VParquetReader::init_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs,
+                                   const std::string& timezone) {
+    try {
+        _reader = parquet::ParquetFileReader::Open(_parquet, _properties);
+        _file_metadata = _reader->metadata();
+        _total_groups = _file_metadata->num_row_groups();
+        if (_total_groups == 0) {
+            return Status::EndOfFile("Empty Parquet File");
+        }
+
+        auto* schema = _file_metadata->schema();
+        for (int i = 0; i < _file_metadata->num_columns(); ++i) {
+            if (schema->Column(i)->max_definition_level() > 1) {
+                _map_column.emplace(schema->Column(i)->path()->ToDotVector()[0], i);
+            } else {
+                _map_column.emplace(schema->Column(i)->name(), i);
+            }
+        }
+        RETURN_IF_ERROR(_column_indices(tuple_slot_descs));
+        for (int column_id : _parquet_column_ids) {
+            const parquet::ColumnDescriptor* descr = schema->Column(column_id);
+            if (descr->max_repetition_level() > 0) {
+                return Status::NotSupported(
+                        fmt::format("repeated parquet column {} is not supported",
+                                    descr->path()->ToDotString()));
+            }
+        }
+    } catch (parquet::ParquetException& e) {
+        std::stringstream str_error;
+        str_error << "Init parquet reader fail. " << e.what();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+
+    _timezone = timezone;
+    if (!TimezoneUtils::find_cctz_time_zone(_timezone, _ctz)) {
+        return Status::InternalError(fmt::format("unknown time zone {}", _timezone));
+    }
+    return Status::OK();
+}
+
+Status VParquetReader::_column_indices(const std::vector<SlotDescriptor*>& tuple_slot_descs) {
+    _parquet_column_ids.clear();
+    _slot_descs.clear();
+    for (int i = 0; i < _num_of_columns_from_file; i++) {
+        auto slot_desc = tuple_slot_descs.at(i);
+        auto iter = _map_column.find(slot_desc->col_name());
+        if (iter == _map_column.end()) {
+            std::stringstream str_error;
+            str_error << "Invalid Column Name:" << slot_desc->col_name();
+            LOG(WARNING) << str_error.str();
+            return Status::InvalidArgument(str_error.str());
+        }
+        _parquet_column_ids.emplace_back(iter->second);
+        _slot_descs.emplace_back(slot_desc);
+    }
+    return Status::OK();
+}
+
+Status VParquetReader::_init_row_group() {
+    _row_group_reader = _reader->RowGroup(_current_group);
+    _rows_of_group = _row_group_reader->metadata()->num_rows();
+    _current_line_of_group = 0;
+    _column_readers.clear();
+    for (int column_id : _parquet_column_ids) {
+        _column_readers.emplace_back(_row_group_reader->Column(column_id));
+    }
+    return Status::OK();
+}
+
+bool VParquetReader::_filter_row_group(int group) {
+    if (_predicates.empty()) {
+        return false;
+    }
+    auto row_group = _file_metadata->RowGroup(group);
+    for (const auto& predicate : _predicates) {
+        // the slots from path
+        if (predicate.slot_idx >= _parquet_column_ids.size()) {
+            continue;
+        }
+        auto column_chunk = row_group->ColumnChunk(_parquet_column_ids[predicate.slot_idx]);
+        if (!column_chunk->is_stats_set()) {
+            continue;
+        }
+        std::shared_ptr<parquet::Statistics> statistics = column_chunk->statistics();
+        // the predicates are never true on null
+        if (statistics->HasNullCount() && statistics->null_count() == row_group->num_rows()) {
+            return true;
+        }
+        if (statistics->HasMinMax() && !statistics_may_match(predicate, *statistics)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+Status VParquetReader::next_batch(size_t max_rows, size_t* rows, bool* eof) {
+    *rows = 0;
+    try {
+        while (_current_line_of_group >= _rows_of_group) {
+            if (++_current_group >= _total_groups) {
+                _batch_rows = 0;
+                *eof = true;
+                return Status::OK();
+            }
+            if (_filter_row_group(_current_group)) {
+                _filtered_row_groups++;
+                continue;
+            }
+            RETURN_IF_ERROR(_init_row_group());
+        }
+    } catch (parquet::ParquetException& e) {
+        std::stringstream str_error;
+        str_error << e.what() << " RowGroup:" << _current_group;
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+    _batch_rows = std::min<int64_t>(max_rows, _rows_of_group - _current_line_of_group);
+    _current_line_of_group += _batch_rows;
+    *rows = _batch_rows;
+    *eof = false;
+    return Status::OK();
+}
+
+template <typename ParquetType, typename Converter>
+Status VParquetReader::_read_values(size_t slot_idx, ColumnString* column, NullMap* null_map,
+                                    Converter convert) {
+    using T = typename ParquetType::c_type;
+    auto* reader =
+            static_cast<parquet::TypedColumnReader<ParquetType>*>(_column_readers[slot_idx].get());
+    const int16_t max_def_level = reader->descr()->max_definition_level();
+    _def_levels.resize(_batch_rows);
+    _values.resize(_batch_rows * sizeof(T));
+    T* values = reinterpret_cast<T*>(_values.data());
+
+    // The values of BYTE_ARRAY point to the current page, so they are converted before the
+    // next page is read.
+    size_t rows = 0;
+    while (rows < _batch_rows) {
+        int64_t values_read = 0;
+        int64_t levels_read = reader->ReadBatch(_batch_rows - rows, _def_levels.data(), nullptr,
+                                                values, &values_read);
+        if (levels_read <= 0) {
+            return Status::InternalError(fmt::format(
+                    "unexpected end of parquet column {}, RowGroup: {}",
+                    _slot_descs[slot_idx]->col_name(), _current_group));
+        }
+        int64_t value_idx = 0;
+        for (int64_t i = 0; i < levels_read; ++i) {
+            if (max_def_level > 0 && _def_levels[i] < max_def_level) {
+                if (null_map == nullptr) {
+                    std::stringstream str_error;
+                    str_error << "The field name(" << _slot_descs[slot_idx]->col_name()
+                              << ") is not allowed null, but Parquet field is null.";
+                    LOG(WARNING) << str_error.str();
+                    return Status::RuntimeError(str_error.str());
+                }
+                null_map->push_back(1);
+                column->insert_default();
+                continue;
+            }
+            if (null_map != nullptr) {
+                null_map->push_back(0);
+            }
+            RETURN_IF_ERROR(convert(values[value_idx++], column));
+        }
+        rows += levels_read;
+    }
+    return Status::OK();
+}
+
+template <typename ParquetType>
+Status VParquetReader::_skip_values(size_t slot_idx) {
+    auto* reader =
+            static_cast<parquet::TypedColumnReader<ParquetType>*>(_column_readers[slot_idx].get());
+    if (reader->Skip(_batch_rows) != _batch_rows) {
+        return Status::InternalError(
+                fmt::format("unexpected end of parquet column {}, RowGroup: {}",
+                            _slot_descs[slot_idx]->col_name(), _current_group));
+    }
+    return Status::OK();
+}
+
+Status VParquetReader::_append_timestamp(int64_t timestamp, ColumnString* column) {
+    // Doris only supports seconds
+    DateTimeValue dtv;
+    if (!dtv.from_unixtime(timestamp, _ctz)) {
+        std::stringstream str_error;
+        str_error << "Parse timestamp (" + std::to_string(timestamp) + ") error";
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+    char buf[64];
+    char* buf_end = dtv.to_string(buf);
+    column->insert_data(buf, buf_end - buf - 1);
+    return Status::OK();
+}
+
+Status VParquetReader::_append_date(int32_t days, ColumnString* column) {
+    DateTimeValue dtv;
+    if (!dtv.from_unixtime(static_cast<int64_t>(days) * 24 * 60 * 60, cctz::utc_time_zone())) {
+        std::stringstream str_error;
+        str_error << "Parse date (" + std::to_string(days) + ") error";
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+    dtv.cast_to_date();
+    char buf[64];
+    char* buf_end = dtv.to_string(buf);
+    column->insert_data(buf, buf_end - buf - 1);
+    return Status::OK();
+}
+
+Status VParquetReader::read_column(size_t slot_idx, IColumn* column) {
+    NullMap* null_map = nullptr;
+    if (column->is_nullable()) {
+        auto* nullable_column = assert_cast<ColumnNullable*>(column);
+        null_map = &nullable_column->get_null_map_data();
+        column = &nullable_column->get_nested_column();
+    }
+    auto* string_column = typeid_cast<ColumnString*>(column);
+    if (string_column == nullptr) {
+        return Status::InternalError(fmt::format("the source column {} must be a string column",
+                                                 _slot_descs[slot_idx]->col_name()));
+    }
+
+    const parquet::ColumnDescriptor* descr = _column_readers[slot_idx]->descr();
+    const auto& logical_type = descr->logical_type();
+    const int scale = logical_type->is_decimal() ? descr->type_scale() : 0;
+    const bool is_unsigned =
+            logical_type->is_int() &&
+            !static_cast<const parquet::IntLogicalType&>(*logical_type).is_signed();
+    try {
+        switch (descr->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return _read_values<parquet::BooleanType>(
+                    slot_idx, string_column, null_map, [](bool value, ColumnString* column) {
+                        if (value) {
+                            column->insert_data("true", 4);
+                        } else {
+                            column->insert_data("false", 5);
+                        }
+                        return Status::OK();
+                    });
+        case parquet::Type::INT32:
+            if (logical_type->is_date()) {
+                return _read_values<parquet::Int32Type>(
+                        slot_idx, string_column, null_map,
+                        [this](int32_t value, ColumnString* column) {
+                            return _append_date(value, column);
+                        });
+            }
+            return _read_values<parquet::Int32Type>(
+                    slot_idx, string_column, null_map,
+                    [=](int32_t value, ColumnString* column) {
+                        if (logical_type->is_decimal()) {
+                            append_decimal(value, scale, column);
+                        } else if (is_unsigned) {
+                            append_integer(static_cast<uint32_t>(value), column);
+                        } else {
+                            append_integer(value, column);
+                        }
+                        return Status::OK();
+                    });
+        case parquet::Type::INT64:
+            if (logical_type->is_timestamp()) {
+                int64_t units_per_second = 1000;
+                switch (static_cast<const parquet::TimestampLogicalType&>(*logical_type)
+                                .time_unit()) {
+                case parquet::LogicalType::TimeUnit::MICROS:
+                    units_per_second = 1000000;
+                    break;
+                case parquet::LogicalType::TimeUnit::NANOS:
+                    units_per_second = 1000000000;
+                    break;
+                default:
+                    break;
+                }
+                return _read_values<parquet::Int64Type>(
+                        slot_idx, string_column, null_map,
+                        [this, units_per_second](int64_t value, ColumnString* column) {
+                            return _append_timestamp(value / units_per_second, column);
+                        });
+            }
+            return _read_values<parquet::Int64Type>(
+                    slot_idx, string_column, null_map,
+                    [=](int64_t value, ColumnString* column) {
+                        if (logical_type->is_decimal()) {
+                            append_decimal(value, scale, column);
+                        } else if (is_unsigned) {
+                            append_integer(static_cast<uint64_t>(value), column);
+                        } else {
+                            append_integer(value, column);
+                        }
+                        return Status::OK();
+                    });
+        case parquet::Type::INT96:
+            return _read_values<parquet::Int96Type>(
+                    slot_idx, string_column, null_map,
+                    [this](const parquet::Int96& value, ColumnString* column) {
+                        return _append_timestamp(parquet::Int96GetNanoSeconds(value) / 1000000000L,
+                                                 column);
+                    });
+        case parquet::Type::FLOAT:
+            return _read_values<parquet::FloatType>(slot_idx, string_column, null_map,
+                                                    [](float value, ColumnString* column) {
+                                                        append_floating_point(value, column);
+                                                        return Status::OK();
+                                                    });
+        case parquet::Type::DOUBLE:
+            return _read_values<parquet::DoubleType>(slot_idx, string_column, null_map,
+                                                     [](double value, ColumnString* column) {
+                                                         append_floating_point(value, column);
+                                                         return Status::OK();
+                                                     });
+        case parquet::Type::BYTE_ARRAY:
+            return _read_values<parquet::ByteArrayType>(
+                    slot_idx, string_column, null_map,
+                    [=](const parquet::ByteArray& value, ColumnString* column) {
+                        if (logical_type->is_decimal()) {
+                            __int128 unscaled = 0;
+                            RETURN_IF_ERROR(read_big_endian_decimal(value.ptr, value.len,
+                                                                    &unscaled));
+                            append_decimal(unscaled, scale, column);
+                        } else {
+                            column->insert_data(reinterpret_cast<const char*>(value.ptr),
+                                                value.len);
+                        }
+                        return Status::OK();
+                    });
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY: {
+            const int len = descr->type_length();
+            return _read_values<parquet::FLBAType>(
+                    slot_idx, string_column, null_map,
+                    [=](const parquet::FixedLenByteArray& value, ColumnString* column) {
+                        if (logical_type->is_decimal()) {
+                            __int128 unscaled = 0;
+                            RETURN_IF_ERROR(read_big_endian_decimal(value.ptr, len, &unscaled));
+                            append_decimal(unscaled, scale, column);
+                        } else {
+                            column->insert_data(reinterpret_cast<const char*>(value.ptr), len);
+                        }
+                        return Status::OK();
+                    });
+        }
+        default: {
+            std::stringstream str_error;
+            str_error << "The field name(" << _slot_descs[slot_idx]->col_name() << "), type("
+                      << parquet::TypeToString(descr->physical_type())
+                      << ") not support. RowGroup: " << _current_group;
+            LOG(WARNING) << str_error.str();
+            return Status::InternalError(str_error.str());
+        }
+        }
+    } catch (parquet::ParquetException& e) {
+        std::stringstream str_error;
+        str_error << e.what() << " RowGroup:" << _current_group << ", Column "
+                  << _slot_descs[slot_idx]->col_name();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+}
+
+Status VParquetReader::skip_column(size_t slot_idx) {
+    try {
+        switch (_column_readers[slot_idx]->descr()->physical_type()) {
+        case parquet::Type::BOOLEAN:
+            return _skip_values<parquet::BooleanType>(slot_idx);
+        case parquet::Type::INT32:
+            return _skip_values<parquet::Int32Type>(slot_idx);
+        case parquet::Type::INT64:
+            return _skip_values<parquet::Int64Type>(slot_idx);
+        case parquet::Type::INT96:
+            return _skip_values<parquet::Int96Type>(slot_idx);
+        case parquet::Type::FLOAT:
+            return _skip_values<parquet::FloatType>(slot_idx);
+        case parquet::Type::DOUBLE:
+            return _skip_values<parquet::DoubleType>(slot_idx);
+        case parquet::Type::BYTE_ARRAY:
+            return _skip_values<parquet::ByteArrayType>(slot_idx);
+        case parquet::Type::FIXED_LEN_BYTE_ARRAY:
+            return _skip_values<parquet::FLBAType>(slot_idx);
+        default:
+            return Status::InternalError(fmt::format("unsupported type of parquet column {}",
+                                                     _slot_descs[slot_idx]->col_name()));
+        }
+    } catch (parquet::ParquetException& e) {
+        std::stringstream str_error;
+        str_error << e.what() << " RowGroup:" << _current_group << ", Column "
+                  << _slot_descs[slot_idx]->col_name();
+        LOG(WARNING) << str_error.str();
+        return Status::InternalError(str_error.str());
+    }
+}
+
+void VParquetReader::close() {
+    arrow::Status st = _parquet->Close();
+    if (!st.ok()) {
+        LOG(WARNING) << "close parquet file error: " << st.ToString();
+    }
+}
+
+} // namespace doris::vectorized
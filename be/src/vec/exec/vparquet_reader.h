@@ -0,0 +1,123 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <cctz/time_zone.h>
+#include <parquet/api/reader.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "exec/base_scanner.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+
+namespace doris {
+
+class FileReader;
+class ParquetFile;
+class SlotDescriptor;
+
+namespace vectorized {
+
+// Reader of the parquet file of a broker load, which decodes the column chunks of the file into
+// the string columns of the source slots directly, without arrow arrays and tuples.
+// The pages are decoded (plain, dictionary and RLE) by the column readers of parquet, and only
+// the columns of the source slots are read. The rows are read batch by batch, the columns of a
+// batch can be read in any order, and a column can be skipped if none of the rows of the batch
+// is selected.
+class VParquetReader {
+public:
+    VParquetReader(FileReader* file_reader, int32_t num_of_columns_from_file);
+    ~VParquetReader();
+
+    Status init_reader(const std::vector<SlotDescriptor*>& tuple_slot_descs,
+                       const std::string& timezone);
+
+    // The row groups which can't satisfy all of the `predicates` are skipped, and their column
+    // chunks are never read.
+    void set_predicates(std::vector<PreFilterPredicate> predicates) {
+        _predicates = std::move(predicates);
+    }
+
+    int64_t filtered_row_groups() const { return _filtered_row_groups; }
+
+    // Start the next batch of at most `max_rows` rows, which are in the same row group.
+    // `eof` is set if there are no more rows in the file.
+    Status next_batch(size_t max_rows, size_t* rows, bool* eof);
+
+    // Append the values of the column of slot `slot_idx` of the current batch to `column`.
+    Status read_column(size_t slot_idx, IColumn* column);
+
+    // Skip the values of the column of slot `slot_idx` of the current batch.
+    Status skip_column(size_t slot_idx);
+
+    void close();
+
+private:
+    Status _column_indices(const std::vector<SlotDescriptor*>& tuple_slot_descs);
+    Status _init_row_group();
+    // Whether the row group `group` can be skipped by the statistics of its column chunks.
+    bool _filter_row_group(int group);
+
+    template <typename ParquetType, typename Converter>
+    Status _read_values(size_t slot_idx, ColumnString* column, NullMap* null_map,
+                        Converter convert);
+    template <typename ParquetType>
+    Status _skip_values(size_t slot_idx);
+
+    Status _append_timestamp(int64_t timestamp, ColumnString* column);
+    Status _append_date(int32_t days, ColumnString* column);
+
+    const int32_t _num_of_columns_from_file;
+    parquet::ReaderProperties _properties;
+    std::shared_ptr<ParquetFile> _parquet;
+
+    std::unique_ptr<parquet::ParquetFileReader> _reader;
+    std::shared_ptr<parquet::FileMetaData> _file_metadata;
+    std::map<std::string, int> _map_column; // column-name <---> column-index
+    std::vector<int> _parquet_column_ids;
+    std::vector<const SlotDescriptor*> _slot_descs;
+
+    int _total_groups = 0; // groups in a parquet file
+    int _current_group = -1;
+    int64_t _rows_of_group = 0; // rows in a group.
+    int64_t _current_line_of_group = 0;
+    // the column readers of the current row group, in the order of the slots
+    std::shared_ptr<parquet::RowGroupReader> _row_group_reader;
+    std::vector<std::shared_ptr<parquet::ColumnReader>> _column_readers;
+    size_t _batch_rows = 0;
+
+    std::vector<PreFilterPredicate> _predicates;
+    int64_t _filtered_row_groups = 0;
+
+    // the buffers of the definition levels and the values of a batch
+    std::vector<int16_t> _def_levels;
+    std::vector<uint8_t> _values;
+
+    std::string _timezone;
+    cctz::time_zone _ctz;
+};
+
+} // namespace vectorized
+} // namespace doris
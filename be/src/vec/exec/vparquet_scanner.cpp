@@ -0,0 +1,216 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vparquet_scanner.h"
+
+#include "exec/exec_node.h"
+#include "exec/file_reader.h"
+#include "exprs/expr_context.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "runtime/string_value.h"
+#include "runtime/tuple.h"
+
+namespace doris::vectorized {
+
+VParquetScanner::VParquetScanner(RuntimeState* state, RuntimeProfile* profile,
+                                 const TBrokerScanRangeParams& params,
+                                 const std::vector<TBrokerRangeDesc>& ranges,
+                                 const std::vector<TNetworkAddress>& broker_addresses,
+                                 const std::vector<TExpr>& pre_filter_texprs,
+                                 ScannerCounter* counter)
+        : ParquetScanner(state, profile, params, ranges, broker_addresses, pre_filter_texprs,
+                         counter) {}
+
+VParquetScanner::~VParquetScanner() {
+    close();
+}
+
+Status VParquetScanner::open() {
+    RETURN_IF_ERROR(ParquetScanner::open());
+    std::vector<SlotId> slot_ids;
+    for (auto ctx : _pre_filter_ctxs) {
+        ctx->root()->get_slot_ids(&slot_ids);
+    }
+    _pre_filter_slot_ids.insert(slot_ids.begin(), slot_ids.end());
+    get_pre_filter_predicates(&_predicates);
+    _filtered_row_groups_counter = ADD_COUNTER(_profile, "FilteredRowGroups", TUnit::UNIT);
+    return Status::OK();
+}
+
+Status VParquetScanner::get_next(std::vector<MutableColumnPtr>& columns, bool* eof) {
+    SCOPED_TIMER(_read_timer);
+
+    const size_t batch_size = _state->batch_size();
+    while (columns[0]->size() < batch_size && !_scanner_eof) {
+        if (_cur_reader == nullptr || _cur_reader_eof) {
+            RETURN_IF_ERROR(_open_next_reader());
+            // If there isn't any more reader, break this
+            if (_scanner_eof) {
+                continue;
+            }
+        }
+        size_t rows = 0;
+        RETURN_IF_ERROR(
+                _cur_reader->next_batch(batch_size - columns[0]->size(), &rows, &_cur_reader_eof));
+        if (rows == 0) {
+            continue;
+        }
+        COUNTER_UPDATE(_rows_read_counter, rows);
+        RETURN_IF_ERROR(_read_src_columns(rows));
+
+        SCOPED_TIMER(_materialize_timer);
+        for (size_t row : _selected_rows) {
+            _set_src_slots(row, _all_slot_idxs);
+            RETURN_IF_ERROR(fill_dest_columns(columns));
+            if (_success) {
+                free_expr_local_allocations();
+            }
+            if (_scanner_eof) {
+                break;
+            }
+        }
+    }
+    *eof = _scanner_eof;
+    return Status::OK();
+}
+
+Status VParquetScanner::_read_src_columns(size_t rows) {
+    for (auto& column : _src_columns) {
+        column->clear();
+    }
+    _selected_rows.clear();
+
+    if (!_pre_filter_slot_idxs.empty()) {
+        for (size_t idx : _pre_filter_slot_idxs) {
+            RETURN_IF_ERROR(_cur_reader->read_column(idx, _src_columns[idx].get()));
+        }
+        for (size_t row = 0; row < rows; ++row) {
+            _set_src_slots(row, _pre_filter_slot_idxs);
+            if (ExecNode::eval_conjuncts(&_pre_filter_ctxs[0], _pre_filter_ctxs.size(),
+                                         _src_tuple_row)) {
+                _selected_rows.push_back(row);
+            } else {
+                _counter->num_rows_unselected++;
+            }
+        }
+        // the other columns need not be decoded if no row is selected
+        if (_selected_rows.empty()) {
+            for (size_t idx : _other_slot_idxs) {
+                RETURN_IF_ERROR(_cur_reader->skip_column(idx));
+            }
+            return Status::OK();
+        }
+    } else {
+        for (size_t row = 0; row < rows; ++row) {
+            _selected_rows.push_back(row);
+        }
+    }
+
+    for (size_t idx : _other_slot_idxs) {
+        RETURN_IF_ERROR(_cur_reader->read_column(idx, _src_columns[idx].get()));
+    }
+    return Status::OK();
+}
+
+void VParquetScanner::_set_src_slots(size_t row, const std::vector<size_t>& slot_idxs) {
+    for (size_t idx : slot_idxs) {
+        auto slot_desc = _src_slot_descs[idx];
+        const auto& column = _src_columns[idx];
+        if (column->is_null_at(row)) {
+            _src_tuple->set_null(slot_desc->null_indicator_offset());
+            continue;
+        }
+        _src_tuple->set_not_null(slot_desc->null_indicator_offset());
+        StringRef value = column->get_data_at(row);
+        auto* str_slot =
+                reinterpret_cast<StringValue*>(_src_tuple->get_slot(slot_desc->tuple_offset()));
+        str_slot->ptr = const_cast<char*>(value.data);
+        str_slot->len = value.size;
+    }
+}
+
+Status VParquetScanner::_open_next_reader() {
+    _close_reader();
+    while (true) {
+        if (_next_range >= _ranges.size()) {
+            _scanner_eof = true;
+            return Status::OK();
+        }
+        const TBrokerRangeDesc& range = _ranges[_next_range++];
+        std::unique_ptr<FileReader> file_reader;
+        RETURN_IF_ERROR(open_file_reader(range, &file_reader));
+        if (file_reader == nullptr) {
+            continue;
+        }
+        size_t num_of_columns_from_file = range.__isset.num_of_columns_from_file
+                                                  ? range.num_of_columns_from_file
+                                                  : _src_slot_descs.size();
+        _cur_reader =
+                std::make_unique<VParquetReader>(file_reader.release(), num_of_columns_from_file);
+        Status status = _cur_reader->init_reader(_src_slot_descs, _state->timezone());
+        if (status.is_end_of_file()) {
+            continue;
+        }
+        if (!status.ok()) {
+            std::stringstream ss;
+            ss << " file: " << range.path << " error:" << status.get_error_msg();
+            return Status::InternalError(ss.str());
+        }
+
+        _cur_reader->set_predicates(_predicates);
+        _cur_reader_eof = false;
+        _src_columns.clear();
+        _pre_filter_slot_idxs.clear();
+        _other_slot_idxs.clear();
+        _all_slot_idxs.clear();
+        for (size_t i = 0; i < num_of_columns_from_file; ++i) {
+            auto slot_desc = _src_slot_descs[i];
+            _src_columns.emplace_back(slot_desc->get_empty_mutable_column());
+            if (_pre_filter_slot_ids.count(slot_desc->id()) > 0) {
+                _pre_filter_slot_idxs.push_back(i);
+            } else {
+                _other_slot_idxs.push_back(i);
+            }
+            _all_slot_idxs.push_back(i);
+        }
+        // the values of the columns from path are the same for all the rows of the file
+        if (range.__isset.num_of_columns_from_file) {
+            fill_slots_of_columns_from_path(range.num_of_columns_from_file,
+                                            range.columns_from_path);
+        }
+        return Status::OK();
+    }
+}
+
+void VParquetScanner::_close_reader() {
+    if (_cur_reader == nullptr) {
+        return;
+    }
+    if (_filtered_row_groups_counter != nullptr) {
+        COUNTER_UPDATE(_filtered_row_groups_counter, _cur_reader->filtered_row_groups());
+    }
+    _cur_reader.reset();
+}
+
+void VParquetScanner::close() {
+    _close_reader();
+    ParquetScanner::close();
+}
+
+} // namespace doris::vectorized
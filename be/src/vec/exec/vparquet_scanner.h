@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "exec/parquet_scanner.h"
+#include "vec/exec/vparquet_reader.h"
+
+namespace doris::vectorized {
+
+// Vectorized scanner of parquet files. The source columns are decoded by VParquetReader batch by
+// batch, the columns referred by the preceding filters are read first, and the other columns of
+// a batch are only read if some rows of the batch pass the filters. The row groups are skipped by
+// the statistics of their columns if they can't pass the filters.
+class VParquetScanner final : public ParquetScanner {
+public:
+    VParquetScanner(RuntimeState* state, RuntimeProfile* profile,
+                    const TBrokerScanRangeParams& params,
+                    const std::vector<TBrokerRangeDesc>& ranges,
+                    const std::vector<TNetworkAddress>& broker_addresses,
+                    const std::vector<TExpr>& pre_filter_texprs, ScannerCounter* counter);
+    ~VParquetScanner() override;
+
+    Status open() override;
+
+    Status get_next(doris::Tuple* tuple, MemPool* tuple_pool, bool* eof,
+                    bool* fill_tuple) override {
+        return Status::NotSupported("Not Implemented get next");
+    }
+
+    Status get_next(std::vector<MutableColumnPtr>& columns, bool* eof) override;
+
+    void close() override;
+
+private:
+    Status _open_next_reader();
+    void _close_reader();
+    Status _read_src_columns(size_t rows);
+    // Point the slots `slot_idxs` of the src tuple to the values of row `row` of the src columns.
+    void _set_src_slots(size_t row, const std::vector<size_t>& slot_idxs);
+
+    std::unique_ptr<VParquetReader> _cur_reader;
+    bool _cur_reader_eof = false;
+    std::vector<PreFilterPredicate> _predicates;
+    RuntimeProfile::Counter* _filtered_row_groups_counter = nullptr;
+
+    // the columns of the src slots read from the file
+    std::vector<MutableColumnPtr> _src_columns;
+    // the slots referred by the preceding filters
+    std::set<SlotId> _pre_filter_slot_ids;
+    // the indexes of the src slots read from the file, referred by the preceding filters or not
+    std::vector<size_t> _pre_filter_slot_idxs;
+    std::vector<size_t> _other_slot_idxs;
+    std::vector<size_t> _all_slot_idxs;
+    // the rows of the current batch passing the preceding filters
+    std::vector<size_t> _selected_rows;
+};
+
+} // namespace doris::vectorized
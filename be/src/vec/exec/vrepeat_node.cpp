@@ -21,6 +21,9 @@
 #include "gutil/strings/join.h"
 #include "runtime/runtime_state.h"
 #include "util/runtime_profile.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
 
 namespace doris::vectorized {
 VRepeatNode::VRepeatNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
@@ -31,6 +34,8 @@ VRepeatNode::VRepeatNode(ObjectPool* pool, const TPlanNode& tnode, const Descrip
 Status VRepeatNode::prepare(RuntimeState* state) {
     VLOG_CRITICAL << "VRepeatNode::prepare";
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(RepeatNode::prepare(state));
 
     // get current all output slots
@@ -68,6 +73,8 @@ Status VRepeatNode::prepare(RuntimeState* state) {
 Status VRepeatNode::open(RuntimeState* state) {
     VLOG_CRITICAL << "VRepeatNode::open";
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(RepeatNode::open(state));
     return Status::OK();
 }
@@ -79,16 +86,11 @@ Status VRepeatNode::get_repeated_block(Block* child_block, int repeat_id_idx, Bl
 
     size_t child_column_size = child_block->columns();
     size_t column_size = _output_slots.size();
-    bool mem_reuse = output_block->mem_reuse();
+    const size_t rows = child_block->rows();
     DCHECK_EQ(child_column_size, _child_slots.size());
     DCHECK_LT(child_column_size, column_size);
-    std::vector<vectorized::MutableColumnPtr> columns(column_size);
-    for (size_t i = 0; i < column_size; i++) {
-        if (mem_reuse) {
-            columns[i] = std::move(*output_block->get_by_position(i).column).mutate();
-        } else {
-            columns[i] = _output_slots[i]->get_empty_mutable_column();
-        }
+    if (repeat_id_idx == 0) {
+        _null_columns.resize(child_column_size);
     }
 
     /* Fill all slots according to child, for example:select tc1,tc2,sum(tc3) from t1 group by grouping sets((tc1),(tc2));
@@ -97,41 +99,41 @@ Status VRepeatNode::get_repeated_block(Block* child_block, int repeat_id_idx, Bl
      * child_block 1,2,1 | 1,3,1 | 2,1,1 | 3,1,1
      * output_block 1,null,1,1 | 1,null,1,1 | 2,nul,1,1 | 3,null,1,1
      */
+    // The child columns are shared by the outputs of all the grouping sets by pointer, only the
+    // columns of the slots set null are materialized, once per child block.
+    ColumnsWithTypeAndName columns;
+    const std::set<SlotId>& repeat_ids = _slot_id_set_list[repeat_id_idx];
     size_t cur_col = 0;
     for (size_t i = 0; i < child_column_size; i++) {
         const ColumnWithTypeAndName& src_column = child_block->get_by_position(i);
+        const SlotDescriptor* slot_desc = _output_slots[cur_col];
 
-        DCHECK_EQ(_child_slots[i]->type().type, _output_slots[cur_col]->type().type);
-        DCHECK_EQ(_child_slots[i]->col_name(), _output_slots[cur_col]->col_name());
-
-        std::set<SlotId>& repeat_ids = _slot_id_set_list[repeat_id_idx];
-        bool is_repeat_slot =
-                _all_slot_ids.find(_output_slots[cur_col]->id()) != _all_slot_ids.end();
-        bool is_set_null_slot = repeat_ids.find(_output_slots[cur_col]->id()) == repeat_ids.end();
-        const auto row_size = src_column.column->size();
+        DCHECK_EQ(_child_slots[i]->type().type, slot_desc->type().type);
+        DCHECK_EQ(_child_slots[i]->col_name(), slot_desc->col_name());
 
-        if (is_repeat_slot) {
-            DCHECK(_output_slots[cur_col]->is_nullable());
-            auto* nullable_column = reinterpret_cast<ColumnNullable*>(columns[cur_col].get());
-            auto& null_map = nullable_column->get_null_map_data();
-            auto* column_ptr = columns[cur_col].get();
+        bool is_repeat_slot = _all_slot_ids.find(slot_desc->id()) != _all_slot_ids.end();
+        bool is_set_null_slot = repeat_ids.find(slot_desc->id()) == repeat_ids.end();
 
+        ColumnPtr column;
+        if (is_repeat_slot && is_set_null_slot) {
+            DCHECK(slot_desc->is_nullable());
             // set slot null not in repeat_ids
-            if (is_set_null_slot) {
-                nullable_column->resize(row_size);
-                memset(nullable_column->get_null_map_data().data(), 1, sizeof(UInt8) * row_size);
-            } else {
-                if (!src_column.type->is_nullable()) {
-                    for (size_t j = 0; j < row_size; ++j) {
-                        null_map.push_back(0);
-                    }
-                    column_ptr = &nullable_column->get_nested_column();
-                }
-                column_ptr->insert_range_from(*src_column.column, 0, row_size);
+            if (_null_columns[i] == nullptr) {
+                auto null_column = slot_desc->get_empty_mutable_column();
+                auto* nullable_column = assert_cast<ColumnNullable*>(null_column.get());
+                nullable_column->resize(rows);
+                memset(nullable_column->get_null_map_data().data(), 1, sizeof(UInt8) * rows);
+                _null_columns[i] = std::move(null_column);
             }
+            column = _null_columns[i];
         } else {
-            columns[cur_col]->insert_range_from(*src_column.column, 0, row_size);
+            column = src_column.column;
+            if (slot_desc->is_nullable() && !column->is_nullable()) {
+                column = make_nullable(column);
+            }
         }
+        columns.emplace_back(std::move(column), slot_desc->get_data_type_ptr(),
+                             slot_desc->col_name());
         cur_col++;
     }
 
@@ -141,30 +143,18 @@ Status VRepeatNode::get_repeated_block(Block* child_block, int repeat_id_idx, Bl
         const SlotDescriptor* _virtual_slot_desc = _virtual_tuple_desc->slots()[slot_idx];
         DCHECK_EQ(_virtual_slot_desc->type().type, _output_slots[cur_col]->type().type);
         DCHECK_EQ(_virtual_slot_desc->col_name(), _output_slots[cur_col]->col_name());
-        int64_t val = _grouping_list[slot_idx][repeat_id_idx];
-        auto* column_ptr = columns[cur_col].get();
         DCHECK(!_output_slots[cur_col]->is_nullable());
-
-        auto* col = assert_cast<ColumnVector<Int64>*>(column_ptr);
-        for (size_t i = 0; i < child_block->rows(); ++i) {
-            col->insert_value(val);
-        }
+        int64_t val = _grouping_list[slot_idx][repeat_id_idx];
+        columns.emplace_back(ColumnVector<Int64>::create(rows, val),
+                             _output_slots[cur_col]->get_data_type_ptr(),
+                             _output_slots[cur_col]->col_name());
         cur_col++;
     }
 
     DCHECK_EQ(cur_col, column_size);
 
-    if (!columns.empty() && !columns[0]->empty()) {
-        auto n_columns = 0;
-        if (!mem_reuse) {
-            for (const auto slot_desc : _output_slots) {
-                output_block->insert(ColumnWithTypeAndName(std::move(columns[n_columns++]),
-                                                           slot_desc->get_data_type_ptr(),
-                                                           slot_desc->col_name()));
-            }
-        } else {
-            columns.clear();
-        }
+    if (rows != 0) {
+        output_block->swap(Block(columns));
     }
     return Status::OK();
 }
@@ -172,6 +162,8 @@ Status VRepeatNode::get_repeated_block(Block* child_block, int repeat_id_idx, Bl
 Status VRepeatNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     VLOG_CRITICAL << "VRepeatNode::get_next";
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
 
     if (state == nullptr || block == nullptr || eos == nullptr) {
         return Status::InternalError("input is NULL pointer");
@@ -204,6 +196,7 @@ Status VRepeatNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     int size = _repeat_id_list.size();
     if (_repeat_id_idx >= size) {
         release_block_memory(*_child_block.get());
+        _null_columns.clear();
         _repeat_id_idx = 0;
     }
 
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "exec/repeat_node.h"
+#include "vec/columns/column.h"
 
 namespace doris {
 
@@ -46,6 +47,9 @@ private:
     Status get_repeated_block(Block* child_block, int repeat_id_idx, Block* output_block);
 
     std::unique_ptr<Block> _child_block;
+    // the all null columns of the child slots of `_child_block`, shared by the grouping sets
+    // setting the slots null
+    Columns _null_columns;
     std::vector<SlotDescriptor*> _child_slots;
     std::vector<SlotDescriptor*> _output_slots;
 
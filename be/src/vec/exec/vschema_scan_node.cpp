@@ -62,6 +62,8 @@ Status VSchemaScanNode::prepare(RuntimeState* state) {
 
 Status VSchemaScanNode::get_next(RuntimeState* state, vectorized::Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
 
     VLOG_CRITICAL << "VSchemaScanNode::GetNext";
     if (state == NULL || block == NULL || eos == NULL)
@@ -34,6 +34,9 @@ Status VSelectNode::prepare(RuntimeState* state) {
 Status VSelectNode::open(RuntimeState* state) {
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::OPEN));
     RETURN_IF_ERROR(ExecNode::open(state));
+    // the selection of the child block is combined with the conjuncts, so the rows are copied
+    // once for the filters back to back
+    child(0)->set_accept_block_selection(_accept_block_selection);
     RETURN_IF_ERROR(child(0)->open(state));
     return Status::OK();
 }
@@ -44,6 +47,8 @@ Status VSelectNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos
 
 Status VSelectNode::get_next(RuntimeState* state, vectorized::Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     do {
@@ -55,7 +60,8 @@ Status VSelectNode::get_next(RuntimeState* state, vectorized::Block* block, bool
         }
     } while (block->rows() == 0);
 
-    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns()));
+    RETURN_IF_ERROR(VExprContext::filter_block(_vconjunct_ctx_ptr, block, block->columns(),
+                                               _accept_block_selection));
     reached_limit(block, eos);
 
     return Status::OK();
@@ -114,6 +114,8 @@ Status VSetOperationNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status VSetOperationNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     RETURN_IF_ERROR(ExecNode::open(state));
     // open result expr lists.
@@ -126,6 +128,8 @@ Status VSetOperationNode::open(RuntimeState* state) {
 
 Status VSetOperationNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(ExecNode::prepare(state));
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     _hash_table_mem_tracker = MemTracker::create_virtual_tracker(-1, "VSetOperationNode:HashTable");
@@ -172,6 +176,11 @@ void VSetOperationNode::hash_table_init() {
         case TYPE_DECIMALV2:
             _hash_table_variants.emplace<I128HashTableContext>();
             break;
+        case TYPE_CHAR:
+        case TYPE_VARCHAR:
+        case TYPE_STRING:
+            _hash_table_variants.emplace<StringHashTableContext>();
+            break;
         default:
             _hash_table_variants.emplace<SerializedHashTableContext>();
         }
@@ -103,7 +103,23 @@ void VSetOperationNode::refresh_hash_table() {
     std::visit(
             [&](auto&& arg) {
                 using HashTableCtxType = std::decay_t<decltype(arg)>;
-                if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
+                if constexpr (std::is_same_v<HashTableCtxType, StringHashTableContext>) {
+                    // The keys can not be removed from a StringHashMap, so the intersected keys
+                    // are moved to a new one. The excepted keys are left as visited.
+                    if constexpr (keep_matched) {
+                        HashTableCtxType tmp_hash_table;
+                        for (auto iter = arg.hash_table.begin(); iter != arg.hash_table.end();
+                             ++iter) {
+                            auto& mapped = iter->get_second();
+                            if (mapped.visited) {
+                                mapped.visited = false;
+                                tmp_hash_table.hash_table[iter->get_first()] = mapped;
+                            }
+                        }
+                        arg.hash_table = std::move(tmp_hash_table.hash_table);
+                    }
+                    arg.inited = false;
+                } else if constexpr (!std::is_same_v<HashTableCtxType, std::monostate>) {
                     HashTableCtxType tmp_hash_table;
                     bool is_need_shrink =
                             arg.hash_table.should_be_shrink(_valid_element_in_hash_tbl);
@@ -186,12 +202,10 @@ struct HashTableProbe {
         return Status::OK();
     }
 
-    void add_result_columns(RowRefList& value, int& block_size) {
+    void add_result_columns(RowRefList& value, int& block_size,
+                            std::vector<std::vector<int>>& result_rows) {
         auto it = value.begin();
-        for (auto idx = _build_col_idx.begin(); idx != _build_col_idx.end(); ++idx) {
-            auto& column = *_build_blocks[it->block_offset].get_by_position(idx->first).column;
-            _mutable_cols[idx->second]->insert_from(column, it->row_num);
-        }
+        result_rows[it->block_offset].push_back(it->row_num);
         block_size++;
     }
 
@@ -202,20 +216,34 @@ struct HashTableProbe {
         int left_col_len = _left_table_data_types.size();
         auto& iter = hash_table_ctx.iter;
         auto block_size = 0;
+        // the rows of the result in each build block, which are copied to the result columns by
+        // one insert_indices_from for each column of each block
+        std::vector<std::vector<int>> result_rows(_build_blocks.size());
 
         for (; iter != hash_table_ctx.hash_table.end() && block_size < _batch_size; ++iter) {
             auto& value = iter->get_second();
             auto it = value.begin();
             if constexpr (is_intersected) {
                 if (it->visited) { //intersected: have done probe, so visited values it's the result
-                    add_result_columns(value, block_size);
+                    add_result_columns(value, block_size, result_rows);
                 }
             } else {
                 if (!it->visited) { //except: haven't visited values it's the needed result
-                    add_result_columns(value, block_size);
+                    add_result_columns(value, block_size, result_rows);
                 }
             }
         }
+        for (size_t i = 0; i < result_rows.size(); ++i) {
+            if (result_rows[i].empty()) {
+                continue;
+            }
+            for (auto idx = _build_col_idx.begin(); idx != _build_col_idx.end(); ++idx) {
+                auto& column = *_build_blocks[i].get_by_position(idx->first).column;
+                _mutable_cols[idx->second]->insert_indices_from(
+                        column, result_rows[i].data(),
+                        result_rows[i].data() + result_rows[i].size());
+            }
+        }
 
         *eos = iter == hash_table_ctx.hash_table.end();
         if (!output_block->mem_reuse()) {
@@ -17,6 +17,8 @@
 
 #include "vec/exec/vsort_exec_exprs.h"
 
+#include "vec/exprs/vslot_ref.h"
+
 namespace doris::vectorized {
 
 Status VSortExecExprs::init(const TSortInfo& sort_info, ObjectPool* pool) {
@@ -25,6 +27,17 @@ Status VSortExecExprs::init(const TSortInfo& sort_info, ObjectPool* pool) {
                 pool);
 }
 
+std::vector<SlotId> VSortExecExprs::ordering_slots() const {
+    std::vector<SlotId> slots;
+    for (auto ctx : _lhs_ordering_expr_ctxs) {
+        if (!ctx->root()->is_slot_ref()) {
+            break;
+        }
+        slots.push_back(static_cast<VSlotRef*>(ctx->root())->slot_id());
+    }
+    return slots;
+}
+
 Status VSortExecExprs::init(const std::vector<TExpr>& ordering_exprs,
                             const std::vector<TExpr>* sort_tuple_slot_exprs, ObjectPool* pool) {
     RETURN_IF_ERROR(VExpr::create_expr_trees(pool, ordering_exprs, &_lhs_ordering_expr_ctxs));
@@ -70,6 +70,9 @@ public:
 
     bool need_materialize_tuple() const { return _materialize_tuple; }
 
+    // The slots of the leading ordering exprs which are slot refs.
+    std::vector<SlotId> ordering_slots() const;
+
 private:
     // Create two VExprContexts for evaluating over the TupleRows.
     std::vector<VExprContext*> _lhs_ordering_expr_ctxs;
@@ -17,12 +17,18 @@
 
 #include "vec/exec/vsort_node.h"
 
+#include "common/config.h"
+#include "exec/olap_scan_node.h"
 #include "exec/sort_exec_exprs.h"
+#include "runtime/exec_env.h"
 #include "runtime/row_batch.h"
 #include "runtime/runtime_state.h"
 #include "util/debug_util.h"
 
+#include "vec/columns/column_nullable.h"
 #include "vec/core/sort_block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/exprs/vslot_ref.h"
 
 namespace doris::vectorized {
 
@@ -41,17 +47,29 @@ Status VSortNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status VSortNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     _runtime_profile->add_info_string("TOP-N", _limit == -1 ? "false" : "true");
     RETURN_IF_ERROR(ExecNode::prepare(state));
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     _block_mem_tracker = MemTracker::create_virtual_tracker(-1, "VSortNode:Block", mem_tracker());
     RETURN_IF_ERROR(_vsort_exec_exprs.prepare(state, child(0)->row_desc(), _row_descriptor,
                                               expr_mem_tracker()));
+    init_topn_predicate();
+    _spill_enabled = _limit == -1 && BlockSpillStream::can_spill(state);
+    if (_spill_enabled) {
+        _spill_timer = ADD_TIMER(runtime_profile(), "SpillTime");
+        _spill_io_timer = ADD_TIMER(runtime_profile(), "SpillIOTime");
+        _spill_runs_counter = ADD_COUNTER(runtime_profile(), "SpilledRuns", TUnit::UNIT);
+        _spill_bytes_counter = ADD_COUNTER(runtime_profile(), "SpilledBytes", TUnit::BYTES);
+    }
     return Status::OK();
 }
 
 Status VSortNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
     RETURN_IF_ERROR(ExecNode::open(state));
     RETURN_IF_ERROR(_vsort_exec_exprs.open(state));
@@ -78,10 +96,14 @@ Status VSortNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos)
 
 Status VSortNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_mem_tracker);
 
     auto status = Status::OK();
-    if (_sorted_blocks.empty()) {
+    if (_spilled_runs_merger != nullptr) {
+        RETURN_IF_ERROR(_spilled_runs_merger->get_next(block, eos));
+    } else if (_sorted_blocks.empty()) {
         *eos = true;
     } else if (_sorted_blocks.size() == 1) {
         if (_offset != 0) {
@@ -90,7 +112,7 @@ Status VSortNode::get_next(RuntimeState* state, Block* block, bool* eos) {
         block->swap(_sorted_blocks[0]);
         *eos = true;
     } else {
-        RETURN_IF_ERROR(merge_sort_read(state, block, eos));
+        RETURN_IF_ERROR(merge_sort_read(state, block, eos, &_offset));
     }
 
     reached_limit(block, eos);
@@ -107,6 +129,8 @@ Status VSortNode::close(RuntimeState* state) {
         return Status::OK();
     }
     _block_mem_tracker->release(_total_mem_usage);
+    _spilled_runs_merger.reset();
+    _spilled_runs.clear();
     _vsort_exec_exprs.close(state);
     ExecNode::close(state);
     return Status::OK();
@@ -140,7 +164,9 @@ Status VSortNode::sort_input(RuntimeState* state) {
                 // to order the block in _block_priority_queue.
                 // if one block totally greater the heap top of _block_priority_queue
                 // we can throw the block data directly.
-                if (_num_rows_in_block < _limit) {
+                // the rows of the block are truncated to `_offset + _limit` by pretreat_block
+                rows = block.rows();
+                if (_num_rows_in_block < _offset + _limit) {
                     _total_mem_usage += mem_usage;
                     _sorted_blocks.emplace_back(std::move(block));
                     _num_rows_in_block += rows;
@@ -152,11 +178,13 @@ Status VSortNode::sort_input(RuntimeState* state) {
                     if (!block_cursor.totally_greater(_block_priority_queue.top())) {
                         _sorted_blocks.emplace_back(std::move(block));
                         _block_priority_queue.push(block_cursor);
+                        _num_rows_in_block += rows;
                         _total_mem_usage += mem_usage;
                     } else {
                         continue;
                     }
                 }
+                update_topn_heap();
             } else {
                 // dispose normal sort logic
                 _total_mem_usage += mem_usage;
@@ -166,13 +194,141 @@ Status VSortNode::sort_input(RuntimeState* state) {
             _block_mem_tracker->consume(mem_usage);
             RETURN_IF_CANCELLED(state);
             RETURN_IF_ERROR(state->check_query_state("vsort, while sorting input."));
+
+            if (_spill_enabled && BlockSpillStream::should_spill(state, _total_mem_usage)) {
+                RETURN_IF_ERROR(spill_sorted_blocks(state));
+            }
         }
     } while (!eos);
 
+    if (!_spilled_runs.empty()) {
+        if (!_sorted_blocks.empty()) {
+            RETURN_IF_ERROR(spill_sorted_blocks(state));
+        }
+        return prepare_spilled_runs_merger(state);
+    }
+
     build_merge_tree();
     return Status::OK();
 }
 
+Status VSortNode::spill_sorted_blocks(RuntimeState* state) {
+    SCOPED_TIMER(_spill_timer);
+    auto run = std::make_unique<BlockSpillStream>(state->exec_env()->tmp_file_mgr(),
+                                                  state->query_id());
+    run->set_io_timer(_spill_io_timer);
+    RETURN_IF_ERROR(run->prepare());
+
+    if (_sorted_blocks.size() == 1) {
+        RETURN_IF_ERROR(run->add_block(_sorted_blocks[0]));
+    } else {
+        build_merge_tree();
+        // the offset is applied when the spilled runs are merged
+        int64_t offset = 0;
+        bool eos = false;
+        while (!eos) {
+            RETURN_IF_CANCELLED(state);
+            Block block;
+            RETURN_IF_ERROR(merge_sort_read(state, &block, &eos, &offset));
+            RETURN_IF_ERROR(run->add_block(block));
+        }
+    }
+    RETURN_IF_ERROR(run->done_write());
+
+    COUNTER_UPDATE(_spill_runs_counter, 1);
+    COUNTER_UPDATE(_spill_bytes_counter, run->bytes());
+    _spilled_runs.emplace_back(std::move(run));
+    release_sorted_blocks();
+    return Status::OK();
+}
+
+void VSortNode::release_sorted_blocks() {
+    // the cursors reference the sorted blocks, so release them first
+    _priority_queue = std::priority_queue<SortCursor>();
+    _cursors.clear();
+    _sorted_blocks.clear();
+    _block_mem_tracker->release(_total_mem_usage);
+    _total_mem_usage = 0;
+}
+
+Status VSortNode::prepare_spilled_runs_merger(RuntimeState* state) {
+    _spilled_runs_merger.reset(new VSortedRunMerger(
+            _vsort_exec_exprs.lhs_ordering_expr_ctxs(), _is_asc_order, _nulls_first,
+            state->batch_size(), -1, _offset, runtime_profile()));
+
+    std::vector<BlockSupplier> run_suppliers;
+    _spilled_run_blocks.resize(_spilled_runs.size());
+    for (size_t i = 0; i < _spilled_runs.size(); ++i) {
+        run_suppliers.emplace_back([this, i](Block** block) -> Status {
+            bool eos = false;
+            RETURN_IF_ERROR(_spilled_runs[i]->get_next(&_spilled_run_blocks[i], &eos));
+            *block = eos ? nullptr : &_spilled_run_blocks[i];
+            return Status::OK();
+        });
+    }
+    return _spilled_runs_merger->prepare(run_suppliers);
+}
+
+void VSortNode::init_topn_predicate() {
+    if (_limit == -1 || !config::enable_topn_runtime_predicate ||
+        child(0)->type() != TPlanNodeType::OLAP_SCAN_NODE ||
+        _vsort_exec_exprs.lhs_ordering_expr_ctxs().empty()) {
+        return;
+    }
+    VExpr* ordering_expr = _vsort_exec_exprs.lhs_ordering_expr_ctxs()[0]->root();
+    if (!ordering_expr->is_slot_ref()) {
+        return;
+    }
+    int slot_id = static_cast<VSlotRef*>(ordering_expr)->slot_id();
+    if (_vsort_exec_exprs.need_materialize_tuple()) {
+        // the ordering expr is on the sort tuple, find the slot of the scan it's materialized from
+        const auto& slot_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
+        int column_id = _row_descriptor.get_column_id(slot_id);
+        if (column_id < 0 || column_id >= slot_expr_ctxs.size() ||
+            !slot_expr_ctxs[column_id]->root()->is_slot_ref()) {
+            return;
+        }
+        slot_id = static_cast<VSlotRef*>(slot_expr_ctxs[column_id]->root())->slot_id();
+    }
+    auto predicate = std::make_shared<TopNRuntimePredicate>(_is_asc_order[0], _nulls_first[0]);
+    if (static_cast<OlapScanNode*>(child(0))->set_topn_predicate(slot_id, predicate)) {
+        _topn_predicate = std::move(predicate);
+        _topn_data_type = remove_nullable(ordering_expr->data_type());
+        _runtime_profile->add_info_string("TopNRuntimePredicate", "true");
+    }
+}
+
+void VSortNode::update_topn_heap() {
+    const size_t limit = _offset + _limit;
+    if (_num_rows_in_block < limit) {
+        return;
+    }
+    // the rows of the heap top are all after the first `limit` rows of the other blocks
+    while (_block_priority_queue.size() > 1 &&
+           _num_rows_in_block - _block_priority_queue.top()->rows >= limit) {
+        _num_rows_in_block -= _block_priority_queue.top()->rows;
+        _block_priority_queue.pop();
+    }
+    if (_topn_predicate == nullptr) {
+        return;
+    }
+
+    const auto& top = _block_priority_queue.top();
+    const IColumn* column = top->sort_columns[0];
+    size_t row = top->rows - 1;
+    if (column->is_null_at(row)) {
+        return;
+    }
+    if (const auto* nullable_column = check_and_get_column<ColumnNullable>(*column)) {
+        column = &nullable_column->get_nested_column();
+    }
+    std::string value = _topn_data_type->to_string(*column, row);
+    if (value != _topn_value) {
+        _topn_value = value;
+        _topn_predicate->update(std::move(value));
+    }
+}
+
 Status VSortNode::pretreat_block(doris::vectorized::Block& block) {
     if (_vsort_exec_exprs.need_materialize_tuple()) {
         auto output_tuple_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
@@ -214,7 +370,7 @@ void VSortNode::build_merge_tree() {
 }
 
 Status VSortNode::merge_sort_read(doris::RuntimeState* state, doris::vectorized::Block* block,
-                                  bool* eos) {
+                                  bool* eos, int64_t* offset) {
     size_t num_columns = _sorted_blocks[0].columns();
 
     bool mem_reuse = block->mem_reuse();
@@ -227,12 +383,12 @@ Status VSortNode::merge_sort_read(doris::RuntimeState* state, doris::vectorized:
         auto current = _priority_queue.top();
         _priority_queue.pop();
 
-        if (_offset == 0) {
+        if (*offset == 0) {
             for (size_t i = 0; i < num_columns; ++i)
                 merged_columns[i]->insert_from(*current->all_columns[i], current->pos);
             ++merged_rows;
         } else {
-            _offset--;
+            (*offset)--;
         }
 
         if (!current->isLast()) {
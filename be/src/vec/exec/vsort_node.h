@@ -20,16 +20,27 @@
 #include <queue>
 
 #include "exec/exec_node.h"
+#include "olap/topn_predicate.h"
 #include "vec/core/block.h"
 #include "vec/core/sort_cursor.h"
 #include "vec/exec/vsort_exec_exprs.h"
+#include "vec/runtime/vsorted_run_merger.h"
+#include "vec/runtime/vspill_stream.h"
 
 namespace doris::vectorized {
 // Node that implements a full sort of its input with a fixed memory budget
 // In open() the input Block to VSortNode will sort firstly, using the expressions specified in _sort_exec_exprs.
 // In get_next(), VSortNode do the merge sort to gather data to a new block
-
-// support spill to disk in the future
+//
+// When spilling is enabled for the query and the memory of the query goes beyond
+// config::vec_spill_mem_limit_percent of its limit, the sorted blocks in memory are
+// merged into one sorted run and written to a BlockSpillStream. In this case the
+// sorted runs are merged by a VSortedRunMerger streaming from disk in get_next().
+// TOP-N never spills since it only keeps limit rows.
+//
+// TOP-N on a column of the olap scan below it pushes the boundary of the rows it keeps down to
+// the scan as a TopNRuntimePredicate, which is tightened while the input is read, so that the
+// storage skips the pages and the rows which can't be in the result.
 class VSortNode : public doris::ExecNode {
 public:
     VSortNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
@@ -50,6 +61,12 @@ public:
 
     virtual Status close(RuntimeState* state) override;
 
+    std::vector<SlotId> ordered_by_slots() const override {
+        return _vsort_exec_exprs.ordering_slots();
+    }
+    std::vector<bool> ordered_by_asc_order() const override { return _is_asc_order; }
+    std::vector<bool> ordered_by_nulls_first() const override { return _nulls_first; }
+
 protected:
     virtual void debug_string(int indentation_level, std::stringstream* out) const override;
 
@@ -61,7 +78,23 @@ private:
 
     void build_merge_tree();
 
-    Status merge_sort_read(RuntimeState* state, Block* block, bool* eos);
+    // Merge the sorted blocks in memory, skip the first '*offset' rows and decrease it.
+    Status merge_sort_read(RuntimeState* state, Block* block, bool* eos, int64_t* offset);
+
+    // Merge all the sorted blocks in memory into a sorted run on disk.
+    Status spill_sorted_blocks(RuntimeState* state);
+
+    void release_sorted_blocks();
+
+    // Prepare the merger of all the spilled sorted runs.
+    Status prepare_spilled_runs_merger(RuntimeState* state);
+
+    // Push the boundary of TOP-N down to the scan if the first ordering expr is its column.
+    void init_topn_predicate();
+
+    // Pop the blocks which are after the first `_offset + _limit` rows from the heap of TOP-N,
+    // and publish the last row of the heap top as the new boundary.
+    void update_topn_heap();
 
     // Number of rows to skip.
     int64_t _offset;
@@ -81,11 +114,27 @@ private:
     int64_t _num_rows_skipped;
     uint64_t _total_mem_usage = 0;
 
-    // only valid in TOP-N node
+    // only valid in TOP-N node, the rows of the blocks in _block_priority_queue
     uint64_t _num_rows_in_block = 0;
     std::priority_queue<SortBlockCursor> _block_priority_queue;
 
+    // the boundary of TOP-N pushed down to the scan, nullptr if not pushed down
+    std::shared_ptr<TopNRuntimePredicate> _topn_predicate;
+    DataTypePtr _topn_data_type;
+    std::string _topn_value;
+
     std::shared_ptr<MemTracker> _block_mem_tracker;
+
+    bool _spill_enabled = false;
+    std::vector<BlockSpillStreamPtr> _spilled_runs;
+    // the current block read from each spilled run, which is merged by the merger
+    std::vector<Block> _spilled_run_blocks;
+    std::unique_ptr<VSortedRunMerger> _spilled_runs_merger;
+
+    RuntimeProfile::Counter* _spill_timer = nullptr;
+    RuntimeProfile::Counter* _spill_io_timer = nullptr;
+    RuntimeProfile::Counter* _spill_runs_counter = nullptr;
+    RuntimeProfile::Counter* _spill_bytes_counter = nullptr;
 };
 
 } // namespace doris::vectorized
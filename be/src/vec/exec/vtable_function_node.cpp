@@ -55,6 +55,8 @@ Status VTableFunctionNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status VTableFunctionNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(TableFunctionNode::prepare(state));
     RETURN_IF_ERROR(VExpr::prepare(_vfn_ctxs, state, _row_descriptor, expr_mem_tracker()));
 
@@ -80,6 +82,8 @@ Status VTableFunctionNode::prepare(RuntimeState* state) {
 
 Status VTableFunctionNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
 
     RETURN_IF_CANCELLED(state);
 
@@ -128,6 +132,14 @@ Status VTableFunctionNode::get_expanded_block(RuntimeState* state, Block* output
             RETURN_IF_ERROR(_process_next_child_row());
         }
 
+        if (_fn_num == 1) {
+            RETURN_IF_ERROR(_get_expanded_rows_in_batch(state, columns));
+            if (columns[_child_slots.size()]->size() >= state->batch_size()) {
+                break;
+            }
+            continue;
+        }
+
         bool skip_child_row = false;
         while (true) {
             int idx = _find_last_fn_eos_idx();
@@ -184,6 +196,9 @@ Status VTableFunctionNode::get_expanded_block(RuntimeState* state, Block* output
                 break;
             }
         }
+        if (columns[_child_slots.size()]->size() >= state->batch_size()) {
+            break;
+        }
     }
 
     if (!columns.empty() && !columns[0]->empty()) {
@@ -206,6 +221,46 @@ Status VTableFunctionNode::get_expanded_block(RuntimeState* state, Block* output
     return Status::OK();
 }
 
+// The values of the function are appended to its column by get_values, and the child rows are
+// replicated by the numbers of their values at once, instead of one insert_from per output row.
+Status VTableFunctionNode::_get_expanded_rows_in_batch(RuntimeState* state,
+                                                      MutableColumns& columns) {
+    TableFunction* fn = _fns[0];
+    auto& fn_column = columns[_child_slots.size()];
+    const size_t first_row = _cur_child_offset;
+    const size_t first_size = fn_column->size();
+    _replicate_offsets.clear();
+
+    while (fn_column->size() < state->batch_size()) {
+        if (fn->eos() || _is_inner_and_empty()) {
+            // keep the last row until the child rows are replicated
+            if (_cur_child_offset + 1 == _child_block->rows()) {
+                break;
+            }
+            _replicate_offsets.push_back(fn_column->size() - first_size);
+            RETURN_IF_ERROR(fn->process_row(++_cur_child_offset));
+            continue;
+        }
+        int64_t step = 0;
+        RETURN_IF_ERROR(fn->get_values(fn_column.get(), state->batch_size() - fn_column->size(),
+                                       &step));
+    }
+    _replicate_offsets.push_back(fn_column->size() - first_size);
+
+    size_t num_child_rows = _cur_child_offset - first_row + 1;
+    for (int i = 0; i < _child_slots.size(); i++) {
+        auto src_column = _child_block->get_by_position(i).column->cut(first_row, num_child_rows);
+        auto replicated_column = src_column->replicate(_replicate_offsets);
+        columns[i]->insert_range_from(*replicated_column, 0, replicated_column->size());
+    }
+
+    if ((fn->eos() || _is_inner_and_empty()) && _cur_child_offset + 1 == _child_block->rows()) {
+        // all the child rows are expanded, release the child block.
+        RETURN_IF_ERROR(_process_next_child_row());
+    }
+    return Status::OK();
+}
+
 Status VTableFunctionNode::_process_next_child_row() {
     _cur_child_offset++;
 
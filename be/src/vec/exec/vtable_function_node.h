@@ -37,9 +37,15 @@ private:
 
     Status get_expanded_block(RuntimeState* state, Block* output_block, bool* eos);
 
+    // Expand the child rows by the only table function in batch, until the output columns hold
+    // a batch or the child block is exhausted.
+    Status _get_expanded_rows_in_batch(RuntimeState* state, MutableColumns& columns);
+
     std::unique_ptr<Block> _child_block;
     std::vector<SlotDescriptor*> _child_slots;
     std::vector<SlotDescriptor*> _output_slots;
+    // the offsets to replicate the child rows expanded in a batch
+    IColumn::Offsets _replicate_offsets;
 };
 
 } // namespace doris::vectorized
\ No newline at end of file
@@ -0,0 +1,268 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vtopn_node.h"
+
+#include "common/config.h"
+#include "exec/olap_scan_node.h"
+#include "runtime/row_batch.h"
+#include "runtime/runtime_state.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/core/sort_block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/exprs/vslot_ref.h"
+
+namespace doris::vectorized {
+
+VTopNNode::VTopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs)
+        : ExecNode(pool, tnode, descs),
+          _offset(tnode.sort_node.__isset.offset ? tnode.sort_node.offset : 0) {}
+
+Status VTopNNode::init(const TPlanNode& tnode, RuntimeState* state) {
+    RETURN_IF_ERROR(ExecNode::init(tnode, state));
+    DCHECK_GE(_limit, 0);
+    _topn_rows = _offset + _limit;
+    RETURN_IF_ERROR(_vsort_exec_exprs.init(tnode.sort_node.sort_info, _pool));
+    _is_asc_order = tnode.sort_node.sort_info.is_asc_order;
+    _nulls_first = tnode.sort_node.sort_info.nulls_first;
+    return Status::OK();
+}
+
+Status VTopNNode::prepare(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    RETURN_IF_ERROR(ExecNode::prepare(state));
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    RETURN_IF_ERROR(_vsort_exec_exprs.prepare(state, child(0)->row_desc(), _row_descriptor,
+                                              expr_mem_tracker()));
+    _rows_filtered_counter = ADD_COUNTER(runtime_profile(), "RowsFilteredByHeapTop", TUnit::UNIT);
+    _merge_timer = ADD_TIMER(runtime_profile(), "MergeTime");
+    init_topn_predicate();
+    return Status::OK();
+}
+
+Status VTopNNode::open(RuntimeState* state) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_MEM_TRACKER(_mem_tracker);
+    RETURN_IF_ERROR(ExecNode::open(state));
+    RETURN_IF_ERROR(_vsort_exec_exprs.open(state));
+    RETURN_IF_CANCELLED(state);
+    RETURN_IF_ERROR(state->check_query_state("vtopn, while open."));
+    RETURN_IF_ERROR(child(0)->open(state));
+
+    bool eos = _topn_rows == 0;
+    while (!eos) {
+        Block block;
+        RETURN_IF_ERROR(child(0)->get_next(state, &block, &eos));
+        if (block.rows() == 0) {
+            continue;
+        }
+        RETURN_IF_ERROR(pretreat_block(block));
+        filter_by_heap_top(block);
+        if (block.rows() == 0) {
+            continue;
+        }
+        _buffered_block.merge(std::move(block));
+        if (_buffered_block.rows() >= _topn_rows) {
+            merge_buffered_rows();
+        }
+        RETURN_IF_CANCELLED(state);
+        RETURN_IF_ERROR(state->check_query_state("vtopn, while reading input."));
+    }
+    merge_buffered_rows();
+    _output_pos = _offset;
+    return Status::OK();
+}
+
+Status VTopNNode::get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) {
+    *eos = true;
+    return Status::NotSupported("Not Implemented VTopNNode::get_next scalar");
+}
+
+Status VTopNNode::get_next(RuntimeState* state, Block* block, bool* eos) {
+    SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
+    SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_mem_tracker);
+
+    const size_t rows = _topn_block.rows();
+    if (_output_pos >= rows) {
+        *eos = true;
+        return Status::OK();
+    }
+    const size_t length = std::min<size_t>(state->batch_size(), rows - _output_pos);
+    if (_output_pos == 0 && length == rows) {
+        block->swap(_topn_block);
+    } else {
+        ColumnsWithTypeAndName columns;
+        for (size_t i = 0; i < _topn_block.columns(); ++i) {
+            const auto& elem = _topn_block.get_by_position(i);
+            columns.emplace_back(elem.column->cut(_output_pos, length), elem.type, elem.name);
+        }
+        Block output(columns);
+        block->swap(output);
+    }
+    _output_pos += length;
+    *eos = _output_pos >= rows;
+
+    reached_limit(block, eos);
+    return Status::OK();
+}
+
+Status VTopNNode::close(RuntimeState* state) {
+    if (is_closed()) {
+        return Status::OK();
+    }
+    _vsort_exec_exprs.close(state);
+    return ExecNode::close(state);
+}
+
+void VTopNNode::debug_string(int indentation_level, std::stringstream* out) const {
+    *out << std::string(indentation_level * 2, ' ');
+    *out << "VTopNNode(";
+    for (int i = 0; i < _is_asc_order.size(); ++i) {
+        *out << (i > 0 ? " " : "") << (_is_asc_order[i] ? "asc" : "desc") << " nulls "
+             << (_nulls_first[i] ? "first" : "last");
+    }
+    ExecNode::debug_string(indentation_level, out);
+    *out << ")";
+}
+
+Status VTopNNode::pretreat_block(Block& block) {
+    if (_vsort_exec_exprs.need_materialize_tuple()) {
+        const auto& output_tuple_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
+        std::vector<int> valid_column_ids(output_tuple_expr_ctxs.size());
+        for (int i = 0; i < output_tuple_expr_ctxs.size(); ++i) {
+            RETURN_IF_ERROR(output_tuple_expr_ctxs[i]->execute(&block, &valid_column_ids[i]));
+        }
+
+        Block new_block;
+        for (auto column_id : valid_column_ids) {
+            new_block.insert(block.get_by_position(column_id));
+        }
+        block.swap(new_block);
+    }
+
+    _sort_description.resize(_vsort_exec_exprs.lhs_ordering_expr_ctxs().size());
+    for (int i = 0; i < _sort_description.size(); i++) {
+        const auto& ordering_expr = _vsort_exec_exprs.lhs_ordering_expr_ctxs()[i];
+        RETURN_IF_ERROR(ordering_expr->execute(&block, &_sort_description[i].column_number));
+
+        _sort_description[i].direction = _is_asc_order[i] ? 1 : -1;
+        _sort_description[i].nulls_direction =
+                _nulls_first[i] ? -_sort_description[i].direction : _sort_description[i].direction;
+    }
+    return Status::OK();
+}
+
+void VTopNNode::filter_by_heap_top(Block& block) {
+    if (_topn_block.rows() < _topn_rows) {
+        return;
+    }
+    const size_t rows = block.rows();
+    SortCursorImpl block_cursor(block, _sort_description);
+    SortCursor lhs(&block_cursor);
+    SortCursor heap_top(&_heap_top_cursor);
+    const size_t heap_top_row = _heap_top_cursor.rows - 1;
+
+    // the rows equal to the heap top are rejected too, any of them could be the last row
+    IColumn::Filter filter(rows);
+    size_t selected_rows = 0;
+    for (size_t i = 0; i < rows; ++i) {
+        filter[i] = lhs.greater_at(heap_top, i, heap_top_row) < 0;
+        selected_rows += filter[i];
+    }
+    COUNTER_UPDATE(_rows_filtered_counter, rows - selected_rows);
+    if (selected_rows == rows) {
+        return;
+    }
+    for (size_t i = 0; i < block.columns(); ++i) {
+        auto& column = block.get_by_position(i).column;
+        column = column->filter(filter, selected_rows);
+    }
+}
+
+void VTopNNode::merge_buffered_rows() {
+    if (_buffered_block.rows() == 0) {
+        return;
+    }
+    SCOPED_TIMER(_merge_timer);
+    if (_topn_block.rows() != 0) {
+        _buffered_block.merge(std::move(_topn_block));
+    }
+    _topn_block = _buffered_block.to_block();
+    _buffered_block = MutableBlock();
+    // the rows after the first `offset + limit` ones are truncated
+    sort_block(_topn_block, _sort_description, _topn_rows);
+    if (_topn_block.rows() == _topn_rows) {
+        _heap_top_cursor = SortCursorImpl(_topn_block, _sort_description);
+        update_topn_predicate();
+    }
+}
+
+void VTopNNode::init_topn_predicate() {
+    if (!config::enable_topn_runtime_predicate ||
+        child(0)->type() != TPlanNodeType::OLAP_SCAN_NODE ||
+        _vsort_exec_exprs.lhs_ordering_expr_ctxs().empty()) {
+        return;
+    }
+    VExpr* ordering_expr = _vsort_exec_exprs.lhs_ordering_expr_ctxs()[0]->root();
+    if (!ordering_expr->is_slot_ref()) {
+        return;
+    }
+    int slot_id = static_cast<VSlotRef*>(ordering_expr)->slot_id();
+    if (_vsort_exec_exprs.need_materialize_tuple()) {
+        // the ordering expr is on the sort tuple, find the slot of the scan it's materialized from
+        const auto& slot_expr_ctxs = _vsort_exec_exprs.sort_tuple_slot_expr_ctxs();
+        int column_id = _row_descriptor.get_column_id(slot_id);
+        if (column_id < 0 || column_id >= slot_expr_ctxs.size() ||
+            !slot_expr_ctxs[column_id]->root()->is_slot_ref()) {
+            return;
+        }
+        slot_id = static_cast<VSlotRef*>(slot_expr_ctxs[column_id]->root())->slot_id();
+    }
+    auto predicate = std::make_shared<TopNRuntimePredicate>(_is_asc_order[0], _nulls_first[0]);
+    if (static_cast<OlapScanNode*>(child(0))->set_topn_predicate(slot_id, predicate)) {
+        _topn_predicate = std::move(predicate);
+        _topn_data_type = remove_nullable(ordering_expr->data_type());
+        _runtime_profile->add_info_string("TopNRuntimePredicate", "true");
+    }
+}
+
+void VTopNNode::update_topn_predicate() {
+    if (_topn_predicate == nullptr) {
+        return;
+    }
+    const IColumn* column = _heap_top_cursor.sort_columns[0];
+    size_t row = _heap_top_cursor.rows - 1;
+    if (column->is_null_at(row)) {
+        return;
+    }
+    if (const auto* nullable_column = check_and_get_column<ColumnNullable>(*column)) {
+        column = &nullable_column->get_nested_column();
+    }
+    std::string value = _topn_data_type->to_string(*column, row);
+    if (value != _topn_value) {
+        _topn_value = value;
+        _topn_predicate->update(std::move(value));
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include "exec/exec_node.h"
+#include "olap/topn_predicate.h"
+#include "vec/core/block.h"
+#include "vec/core/sort_cursor.h"
+#include "vec/exec/vsort_exec_exprs.h"
+
+namespace doris::vectorized {
+
+// Node for TOP-N (ORDER BY ... LIMIT), which keeps only the first `offset + limit` rows of its
+// input in memory, the row at the end of them is the heap top. Each input block is filtered by
+// the heap top before it's kept, most rows of a long input are rejected by comparing their first
+// ordering column with the heap top. The kept rows are buffered, and selected with the current
+// TOP-N rows by a partial sort when the buffer reaches `offset + limit` rows, which tightens the
+// heap top.
+//
+// TOP-N on a column of the olap scan below it pushes the heap top down to the scan as a
+// TopNRuntimePredicate, in the same way as VSortNode.
+class VTopNNode : public doris::ExecNode {
+public:
+    VTopNNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs);
+
+    ~VTopNNode() override = default;
+
+    Status init(const TPlanNode& tnode, RuntimeState* state = nullptr) override;
+
+    Status prepare(RuntimeState* state) override;
+
+    Status open(RuntimeState* state) override;
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override;
+
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override;
+
+    Status close(RuntimeState* state) override;
+
+protected:
+    void debug_string(int indentation_level, std::stringstream* out) const override;
+
+private:
+    // Materialize the sort tuple of the block and evaluate the ordering exprs on it.
+    Status pretreat_block(Block& block);
+
+    // Remove the rows of the block which are not less than the heap top.
+    void filter_by_heap_top(Block& block);
+
+    // Select the first `offset + limit` rows from the TOP-N rows and the buffered rows.
+    void merge_buffered_rows();
+
+    // Push the heap top down to the scan if the first ordering expr is its column.
+    void init_topn_predicate();
+
+    void update_topn_predicate();
+
+    const int64_t _offset;
+    // the number of the rows kept, `offset + limit`
+    size_t _topn_rows = 0;
+
+    VSortExecExprs _vsort_exec_exprs;
+    std::vector<bool> _is_asc_order;
+    std::vector<bool> _nulls_first;
+    SortDescription _sort_description;
+
+    // the sorted first `offset + limit` rows of the input read so far
+    Block _topn_block;
+    // the cursor on _topn_block to compare with the heap top, valid if _topn_block is full
+    SortCursorImpl _heap_top_cursor;
+    // the rows less than the heap top which are not merged into _topn_block yet
+    MutableBlock _buffered_block;
+    // the next row of _topn_block to output
+    size_t _output_pos = 0;
+
+    // the heap top pushed down to the scan, nullptr if not pushed down
+    std::shared_ptr<TopNRuntimePredicate> _topn_predicate;
+    DataTypePtr _topn_data_type;
+    std::string _topn_value;
+
+    RuntimeProfile::Counter* _rows_filtered_counter = nullptr;
+    RuntimeProfile::Counter* _merge_timer = nullptr;
+};
+
+} // namespace doris::vectorized
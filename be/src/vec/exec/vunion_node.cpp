@@ -21,6 +21,7 @@
 #include "runtime/runtime_state.h"
 #include "util/runtime_profile.h"
 
+#include "vec/columns/column_nullable.h"
 #include "vec/core/block.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/exprs/vexpr_context.h"
@@ -62,6 +63,8 @@ Status VUnionNode::init(const TPlanNode& tnode, RuntimeState* state) {
 
 Status VUnionNode::prepare(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(ExecNode::prepare(state));
     _materialize_exprs_evaluate_timer =
             ADD_TIMER(_runtime_profile, "MaterializeExprsEvaluateTimer");
@@ -80,6 +83,8 @@ Status VUnionNode::prepare(RuntimeState* state) {
 
 Status VUnionNode::open(RuntimeState* state) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(ExecNode::open(state));
     // open const expr lists.
     for (const std::vector<VExprContext*>& exprs : _const_expr_lists) {
@@ -131,7 +136,8 @@ Status VUnionNode::get_next_materialized(RuntimeState* state, Block* block) {
                                 VectorizedUtils::create_columns_with_type_and_name(row_desc())));
 
     Block child_block;
-    while (has_more_materialized() && mblock.rows() <= state->batch_size()) {
+    bool moved = false;
+    while (!moved && has_more_materialized() && mblock.rows() <= state->batch_size()) {
         // The loop runs until we are either done iterating over the children that require
         // materialization, or the row batch is at capacity.
         DCHECK(!is_child_passthrough(_child_idx));
@@ -150,7 +156,15 @@ Status VUnionNode::get_next_materialized(RuntimeState* state, Block* block) {
         RETURN_IF_ERROR(child(_child_idx)->get_next(state, &child_block, &_child_eos));
         SCOPED_TIMER(_materialize_exprs_evaluate_timer);
         if (child_block.rows() > 0) {
-            mblock.merge(materialize_block(&child_block));
+            Block materialized_block = materialize_block(&child_block);
+            // a large enough block is moved to the output by its columns instead of copied,
+            // the slot refs of the child exprs result in the columns of the child block
+            if (mblock.rows() == 0 && materialized_block.rows() * 2 >= state->batch_size()) {
+                move_materialized_block(mblock, &materialized_block, block);
+                moved = true;
+            } else {
+                mblock.merge(materialized_block);
+            }
         }
         // It shouldn't be the case that we reached the limit because we shouldn't have
         // incremented '_num_rows_returned' yet.
@@ -166,7 +180,7 @@ Status VUnionNode::get_next_materialized(RuntimeState* state, Block* block) {
         }
     }
 
-    if (!mem_reuse) {
+    if (!mem_reuse && !moved) {
         block->swap(mblock.to_block());
     }
 
@@ -213,6 +227,8 @@ Status VUnionNode::get_next_const(RuntimeState* state, Block* block) {
 
 Status VUnionNode::get_next(RuntimeState* state, Block* block, bool* eos) {
     SCOPED_TIMER(_runtime_profile->total_time_counter());
+    SCOPED_HARDWARE_COUNTERS(_hardware_counters.get());
+    SCOPED_SAMPLING_NODE_TAG(id());
     RETURN_IF_ERROR(exec_debug_action(TExecNodePhase::GETNEXT));
     RETURN_IF_CANCELLED(state);
     // RETURN_IF_ERROR(QueryMaintenance(state));
@@ -279,5 +295,22 @@ Block VUnionNode::materialize_block(Block* src_block) {
     return {colunms};
 }
 
+void VUnionNode::move_materialized_block(const MutableBlock& mblock, Block* materialized_block,
+                                         Block* dst_block) {
+    ColumnsWithTypeAndName columns;
+    for (size_t i = 0; i < materialized_block->columns(); ++i) {
+        auto& src_column = materialized_block->get_by_position(i);
+        const auto& type = mblock.get_datatype_by_position(i);
+        // the same conversions as MutableBlock::merge()
+        auto column = src_column.column->convert_to_full_column_if_const();
+        if (type->is_nullable() && !column->is_nullable()) {
+            column = make_nullable(column);
+        }
+        columns.emplace_back(std::move(column), type, src_column.name);
+    }
+    materialized_block->clear();
+    dst_block->swap(Block(columns));
+}
+
 } // namespace vectorized
 } // namespace doris
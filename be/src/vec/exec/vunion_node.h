@@ -78,6 +78,10 @@ private:
     /// which is attached to 'dst_block'. Runs until 'dst_block' is at capacity, or all rows
     /// have been consumed from the current child block. Updates '_child_row_idx'.
     Block materialize_block(Block* dst_block);
+    /// Moves the columns of 'materialized_block' to 'dst_block' with the types of 'mblock',
+    /// when 'mblock' is still empty.
+    void move_materialized_block(const MutableBlock& mblock, Block* materialized_block,
+                                 Block* dst_block);
 
     Status get_error_msg(const std::vector<VExprContext*>& exprs);
 
@@ -17,6 +17,7 @@
 
 #include "vec/exprs/table_function/vexplode.h"
 
+#include "vec/common/assert_cast.h"
 #include "vec/exprs/vexpr.h"
 
 namespace doris::vectorized {
@@ -106,4 +107,26 @@ Status VExplodeTableFunction::get_value_length(int64_t* length) {
     return Status::OK();
 }
 
+Status VExplodeTableFunction::get_values(IColumn* column, int64_t max_step, int64_t* step) {
+    const IColumn& data = _array_column->get_data();
+    if (_is_current_empty || _eos || (data.is_nullable() && !column->is_nullable())) {
+        return TableFunction::get_values(column, max_step, step);
+    }
+
+    // the elements of the array are copied as a range
+    *step = std::min(max_step, _cur_size - _cur_offset);
+    size_t start = _pos + _cur_offset;
+    if (data.is_nullable() == column->is_nullable()) {
+        column->insert_range_from(data, start, *step);
+    } else {
+        auto* nullable_column = assert_cast<ColumnNullable*>(column);
+        nullable_column->get_nested_column().insert_range_from(data, start, *step);
+        auto& null_map = nullable_column->get_null_map_data();
+        null_map.resize_fill(null_map.size() + *step, 0);
+    }
+    _cur_offset += *step;
+    _eos = (_cur_offset == _cur_size);
+    return Status::OK();
+}
+
 } // namespace doris::vectorized
@@ -37,6 +37,7 @@ public:
     virtual Status reset() override;
     virtual Status get_value(void** output) override;
     virtual Status get_value_length(int64_t* length) override;
+    virtual Status get_values(IColumn* column, int64_t max_step, int64_t* step) override;
 
 private:
     const UInt8* _array_null_map;
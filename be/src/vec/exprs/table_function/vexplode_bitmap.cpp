@@ -78,4 +78,23 @@ Status VExplodeBitmapTableFunction::get_value_length(int64_t* length) {
     return Status::OK();
 }
 
+Status VExplodeBitmapTableFunction::get_values(IColumn* column, int64_t max_step,
+                                               int64_t* step) {
+    if (_is_current_empty || _eos) {
+        return TableFunction::get_values(column, max_step, step);
+    }
+
+    *step = std::min(max_step, _cur_size - _cur_offset);
+    for (int64_t i = 0; i < *step; ++i) {
+        column->insert_data(reinterpret_cast<const char*>(&_cur_value), sizeof(uint64_t));
+        // the iterator is not forwarded past the last value, as forward does
+        if (++_cur_offset < _cur_size) {
+            ++(*_cur_iter);
+            _cur_value = **_cur_iter;
+        }
+    }
+    _eos = (_cur_offset == _cur_size);
+    return Status::OK();
+}
+
 } // namespace doris::vectorized
@@ -32,6 +32,7 @@ public:
     Status process_row(size_t row_idx) override;
     Status process_close() override;
     Status get_value_length(int64_t* length) override;
+    Status get_values(IColumn* column, int64_t max_step, int64_t* step) override;
 
 private:
     ColumnPtr _value_column;
@@ -82,4 +82,27 @@ Status VExplodeJsonArrayTableFunction::get_value(void** output) {
     return Status::OK();
 }
 
+Status VExplodeJsonArrayTableFunction::get_values(IColumn* column, int64_t max_step,
+                                                  int64_t* step) {
+    if (_is_current_empty || _eos) {
+        return TableFunction::get_values(column, max_step, step);
+    }
+
+    *step = std::min(max_step, _cur_size - _cur_offset);
+    for (int64_t i = _cur_offset; i < _cur_offset + *step; ++i) {
+        void* value = nullptr;
+        int64_t length = -1;
+        _parsed_data.get_value(_type, i, &value, true);
+        _parsed_data.get_value_length(_type, i, &length);
+        if (value == nullptr) {
+            column->insert_default();
+        } else {
+            column->insert_data(reinterpret_cast<char*>(value), length);
+        }
+    }
+    _cur_offset += *step;
+    _eos = (_cur_offset == _cur_size);
+    return Status::OK();
+}
+
 } // namespace doris::vectorized
\ No newline at end of file
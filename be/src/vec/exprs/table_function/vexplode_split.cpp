@@ -96,4 +96,20 @@ Status VExplodeSplitTableFunction::get_value_length(int64_t* length) {
     return Status::OK();
 }
 
+Status VExplodeSplitTableFunction::get_values(IColumn* column, int64_t max_step,
+                                              int64_t* step) {
+    if (_is_current_empty || _eos) {
+        return TableFunction::get_values(column, max_step, step);
+    }
+
+    *step = std::min(max_step, _cur_size - _cur_offset);
+    for (int64_t i = 0; i < *step; ++i) {
+        const std::string& value = _backup[_cur_offset + i];
+        column->insert_data(value.data(), value.length());
+    }
+    _cur_offset += *step;
+    _eos = (_cur_offset == _cur_size);
+    return Status::OK();
+}
+
 } // namespace doris::vectorized
@@ -35,6 +35,7 @@ public:
     virtual Status process_close() override;
     virtual Status get_value(void** output) override;
     virtual Status get_value_length(int64_t* length) override;
+    virtual Status get_values(IColumn* column, int64_t max_step, int64_t* step) override;
 
 private:
     using ExplodeSplitTableFunction::process;
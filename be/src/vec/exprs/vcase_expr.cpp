@@ -18,9 +18,50 @@
 #include "vec/exprs/vcase_expr.h"
 
 #include "vec/columns/column_nullable.h"
+#include "vec/columns/columns_number.h"
 
 namespace doris::vectorized {
 
+namespace {
+
+// Move the undecided rows taken by a WHEN to `taken`, and return the number of them. A row is
+// taken by a searched WHEN if the WHEN is true, and by a WHEN of a simple CASE if it equals the
+// CASE value.
+size_t take_rows(const ColumnPtr& case_column, ColumnPtr when_column, IColumn::Filter& undecided,
+                 IColumn::Filter& taken) {
+    size_t rows = undecided.size();
+    size_t taken_rows = 0;
+    if (case_column != nullptr) {
+        ColumnPtr case_values = case_column;
+        if (case_values->is_nullable() != when_column->is_nullable()) {
+            case_values = make_nullable(case_values);
+            when_column = make_nullable(when_column);
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            taken[i] = undecided[i] && !case_values->is_null_at(i) &&
+                       case_values->compare_at(i, i, *when_column, -1) == 0;
+            taken_rows += taken[i];
+        }
+    } else if (const auto* when_values = check_and_get_column<ColumnUInt8>(*when_column)) {
+        const auto& values = when_values->get_data();
+        for (size_t i = 0; i < rows; ++i) {
+            taken[i] = undecided[i] & (values[i] != 0);
+            taken_rows += taken[i];
+        }
+    } else {
+        for (size_t i = 0; i < rows; ++i) {
+            taken[i] = undecided[i] && when_column->get_bool(i);
+            taken_rows += taken[i];
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        undecided[i] &= !taken[i];
+    }
+    return taken_rows;
+}
+
+} // namespace
+
 VCaseExpr::VCaseExpr(const TExprNode& node)
         : VExpr(node),
           _is_prepare(false),
@@ -87,21 +128,54 @@ void VCaseExpr::close(RuntimeState* state, VExprContext* context,
 
 Status VCaseExpr::execute(VExprContext* context, Block* block, int* result_column_id) {
     ColumnNumbers arguments(_children.size());
-
-    for (int i = 0; i < _children.size(); i++) {
+    // each WHEN is only evaluated on the rows not taken by the WHENs before it, each THEN on the
+    // rows taken by its WHEN, and ELSE on the rows left. The rows not evaluated take the default
+    // value, which the case function never picks.
+    size_t rows = block->rows();
+    IColumn::Filter undecided(rows, 1);
+    IColumn::Filter taken(rows);
+    size_t undecided_rows = rows;
+
+    ColumnPtr case_column;
+    if (_has_case_expr) {
         int column_id = -1;
-        _children[i]->execute(context, block, &column_id);
-        arguments[i] = column_id;
-
+        RETURN_IF_ERROR(_children[0]->execute(context, block, &column_id));
         block->replace_by_position_if_const(column_id);
-        auto child_column = block->get_by_position(column_id).column;
+        arguments[0] = column_id;
+        case_column = block->get_by_position(column_id).column;
+    }
+
+    int end = _children.size() - _has_else_expr;
+    for (int i = _has_case_expr; i < end; i += 2) {
+        int when_id = -1;
+        RETURN_IF_ERROR(_children[i]->execute_selected(context, block, undecided, undecided_rows,
+                                                       &when_id));
+        block->replace_by_position_if_const(when_id);
+        arguments[i] = when_id;
+        size_t taken_rows =
+                take_rows(case_column, block->get_by_position(when_id).column, undecided, taken);
+        undecided_rows -= taken_rows;
+
+        int then_id = -1;
+        RETURN_IF_ERROR(
+                _children[i + 1]->execute_selected(context, block, taken, taken_rows, &then_id));
+        block->replace_by_position_if_const(then_id);
+        arguments[i + 1] = then_id;
+    }
+
+    if (_has_else_expr) {
+        int else_id = -1;
+        RETURN_IF_ERROR(_children.back()->execute_selected(context, block, undecided,
+                                                           undecided_rows, &else_id));
+        block->replace_by_position_if_const(else_id);
+        arguments.back() = else_id;
     }
 
     size_t num_columns_without_result = block->columns();
     block->insert({nullptr, _data_type, _expr_name});
 
     RETURN_IF_ERROR(_function->execute(context->fn_context(_fn_context_index), *block, arguments,
-                                       num_columns_without_result, block->rows(), false));
+                                       num_columns_without_result, rows, false));
     *result_column_id = num_columns_without_result;
 
     return Status::OK();
@@ -111,4 +185,11 @@ const std::string& VCaseExpr::expr_name() const {
     return _expr_name;
 }
 
+std::string VCaseExpr::signature() const {
+    auto children = children_signature();
+    return children.empty() ? ""
+                            : fmt::format("{}{}->{}", _function_name, children,
+                                          _data_type->get_name());
+}
+
 } // namespace doris::vectorized
@@ -95,4 +95,9 @@ doris::Status VCastExpr::execute(VExprContext* context, doris::vectorized::Block
 const std::string& VCastExpr::expr_name() const {
     return _expr_name;
 }
+
+std::string VCastExpr::signature() const {
+    auto children = children_signature();
+    return children.empty() ? "" : fmt::format("cast{}->{}", children, _data_type->get_name());
+}
 } // namespace doris::vectorized
\ No newline at end of file
@@ -36,6 +36,7 @@ public:
         return pool->add(new VCastExpr(*this));
     }
     virtual const std::string& expr_name() const override;
+    std::string signature() const override;
 
 private:
     FunctionBasePtr _function;
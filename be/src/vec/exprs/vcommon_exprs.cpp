@@ -0,0 +1,94 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exprs/vcommon_exprs.h"
+
+namespace doris::vectorized {
+
+void VCommonExprs::init(ObjectPool* pool, const std::vector<VExprContext*>& ctxs) {
+    std::unordered_map<std::string, int> counts;
+    for (auto ctx : ctxs) {
+        _count(ctx->root(), &counts);
+    }
+    std::unordered_map<std::string, int> ids;
+    for (auto ctx : ctxs) {
+        ctx->set_root(_share(pool, ctx->root(), counts, &ids));
+    }
+    _results.resize(ids.size());
+}
+
+// the leaves, i.e. the slot refs and the literals, are cheap and never shared
+void VCommonExprs::_count(VExpr* expr, std::unordered_map<std::string, int>* counts) {
+    if (expr->children().empty()) {
+        return;
+    }
+    auto signature = expr->signature();
+    if (!signature.empty()) {
+        ++(*counts)[signature];
+    }
+    for (auto child : expr->children()) {
+        _count(child, counts);
+    }
+}
+
+VExpr* VCommonExprs::_share(ObjectPool* pool, VExpr* expr,
+                            const std::unordered_map<std::string, int>& counts,
+                            std::unordered_map<std::string, int>* ids) {
+    if (expr->children().empty()) {
+        return expr;
+    }
+    std::vector<VExpr*> children;
+    for (auto child : expr->children()) {
+        children.push_back(_share(pool, child, counts, ids));
+    }
+    expr->set_children(children);
+
+    auto signature = expr->signature();
+    auto it = counts.find(signature);
+    if (signature.empty() || it == counts.end() || it->second < 2) {
+        return expr;
+    }
+    int id = ids->emplace(signature, ids->size()).first->second;
+    return pool->add(new VSharedExpr(expr, this, id));
+}
+
+VSharedExpr::VSharedExpr(VExpr* expr, VCommonExprs* common_exprs, int id)
+        : VExpr(expr->type(), false, expr->is_nullable()), _common_exprs(common_exprs), _id(id) {
+    _node_type = expr->node_type();
+    _data_type = expr->data_type();
+    _fn = expr->fn();
+    _children.push_back(expr);
+}
+
+Status VSharedExpr::execute(VExprContext* context, Block* block, int* result_column_id) {
+    if (block != _common_exprs->_block) {
+        return _children[0]->execute(context, block, result_column_id);
+    }
+    auto& result = _common_exprs->_results[_id];
+    if (result.column_id >= 0 && result.column_id < block->columns() &&
+        block->get_by_position(result.column_id).column.get() == result.column) {
+        *result_column_id = result.column_id;
+        return Status::OK();
+    }
+    RETURN_IF_ERROR(_children[0]->execute(context, block, result_column_id));
+    result.column_id = *result_column_id;
+    result.column = block->get_by_position(*result_column_id).column.get();
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
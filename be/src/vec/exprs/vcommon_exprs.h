@@ -0,0 +1,83 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "vec/exprs/vexpr.h"
+
+namespace doris::vectorized {
+
+// The common subexpressions of the expr trees of one operator executed on the same block, e.g.
+// the grouping exprs and the inputs of the aggregate functions. The subtrees of the same
+// signature repeated in the trees are found after the trees are prepared and wrapped by
+// VSharedExpr, the first of them executed on the block inserts its result and the others reuse
+// the result column by its position in the block.
+// The contexts of the trees must not be cloned, since the clones would share the results.
+class VCommonExprs {
+public:
+    // Find the common subexpressions of `ctxs`, they must be prepared and not opened yet.
+    void init(ObjectPool* pool, const std::vector<VExprContext*>& ctxs);
+
+    // Start to execute the trees on `block`, and forget the results of the last block. The
+    // results are only shared on this block, not on the blocks derived from it.
+    void reset(const Block* block) {
+        _block = block;
+        std::fill(_results.begin(), _results.end(), Result());
+    }
+
+    size_t size() const { return _results.size(); }
+
+private:
+    friend class VSharedExpr;
+
+    struct Result {
+        int column_id = -1;
+        // to check the column is still in the block
+        const IColumn* column = nullptr;
+    };
+
+    void _count(VExpr* expr, std::unordered_map<std::string, int>* counts);
+    VExpr* _share(ObjectPool* pool, VExpr* expr, const std::unordered_map<std::string, int>& counts,
+                  std::unordered_map<std::string, int>* ids);
+
+    const Block* _block = nullptr;
+    std::vector<Result> _results;
+};
+
+// A common subexpression, see VCommonExprs.
+class VSharedExpr final : public VExpr {
+public:
+    VSharedExpr(VExpr* expr, VCommonExprs* common_exprs, int id);
+
+    Status execute(VExprContext* context, Block* block, int* result_column_id) override;
+    VExpr* clone(ObjectPool* pool) const override { return pool->add(new VSharedExpr(*this)); }
+    const std::string& expr_name() const override { return _children[0]->expr_name(); }
+    std::string signature() const override { return _children[0]->signature(); }
+    std::string debug_string() const override { return _children[0]->debug_string(); }
+
+private:
+    VCommonExprs* _common_exprs;
+    int _id;
+};
+
+} // namespace doris::vectorized
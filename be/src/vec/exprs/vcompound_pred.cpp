@@ -0,0 +1,159 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exprs/vcompound_pred.h"
+
+#include "common/config.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/columns/columns_common.h"
+#include "vec/columns/columns_number.h"
+#include "vec/exprs/vliteral.h"
+#include "vec/functions/like.h"
+
+namespace doris::vectorized {
+
+Status VcompoundPred::prepare(RuntimeState* state, const RowDescriptor& desc,
+                              VExprContext* context) {
+    RETURN_IF_ERROR(VectorizedFnCall::prepare(state, desc, context));
+    std::vector<std::string> regexes;
+    if (config::enable_multi_pattern_match && _fn.name.function_name == "or" &&
+        _collect_patterns(this, &regexes)) {
+        RETURN_IF_ERROR(MultiRegexMatcher::create(regexes, &_pattern_matcher));
+    } else {
+        _pattern_input = nullptr;
+    }
+    return Status::OK();
+}
+
+bool VcompoundPred::_collect_patterns(const VExpr* expr, std::vector<std::string>* regexes) {
+    const auto& children = expr->children();
+    if (expr->fn().name.function_name == "or" && children.size() == 2 &&
+        dynamic_cast<const VcompoundPred*>(expr) != nullptr) {
+        return _collect_patterns(children[0], regexes) && _collect_patterns(children[1], regexes);
+    }
+
+    const auto& name = expr->fn().name.function_name;
+    if ((name != FunctionLike::name && name != FunctionRegexp::name) || children.size() != 2 ||
+        children[1]->node_type() != TExprNodeType::STRING_LITERAL) {
+        return false;
+    }
+    const auto* literal = dynamic_cast<const VLiteral*>(children[1]);
+    if (literal == nullptr || literal->get_column_ptr()->is_null_at(0)) {
+        return false;
+    }
+    // the string must not be nullable if the result is not
+    const VExpr* input = children[0];
+    std::string signature = input->signature();
+    if (signature.empty() || (input->is_nullable() && !is_nullable())) {
+        return false;
+    }
+    if (_pattern_input == nullptr) {
+        _pattern_input = input;
+    } else if (_pattern_input->signature() != signature) {
+        return false;
+    }
+
+    std::string pattern = literal->get_column_ptr()->get_data_at(0).to_string();
+    regexes->push_back(name == FunctionLike::name ? FunctionLike::like_pattern_to_regex(pattern)
+                                                  : pattern);
+    return true;
+}
+
+Status VcompoundPred::_execute_multi_pattern(VExprContext* context, Block* block,
+                                             int* result_column_id) {
+    int input_id = -1;
+    RETURN_IF_ERROR(const_cast<VExpr*>(_pattern_input)->execute(context, block, &input_id));
+    auto input = block->get_by_position(input_id).column->convert_to_full_column_if_const();
+    const IColumn* values = input.get();
+    ColumnPtr null_map;
+    if (input->is_nullable()) {
+        const auto& nullable = assert_cast<const ColumnNullable&>(*input);
+        values = &nullable.get_nested_column();
+        null_map = nullable.get_null_map_column_ptr();
+    }
+    const auto* strings = check_and_get_column<ColumnString>(values);
+    if (strings == nullptr) {
+        return Status::InternalError(
+                fmt::format("Not supported input arguments types of {}", _expr_name));
+    }
+
+    // a row is null if the string is null, since all the predicates are null for it
+    auto res = ColumnUInt8::create(strings->size());
+    RETURN_IF_ERROR(_pattern_matcher->match_rows(*strings, res->get_data()));
+    ColumnPtr result = std::move(res);
+    if (is_nullable()) {
+        if (null_map == nullptr) {
+            null_map = ColumnUInt8::create(strings->size(), 0);
+        }
+        result = ColumnNullable::create(result, null_map);
+    }
+    *result_column_id = block->columns();
+    block->insert({result, _data_type, _expr_name});
+    return Status::OK();
+}
+
+Status VcompoundPred::execute(VExprContext* context, Block* block, int* result_column_id) {
+    if (_pattern_matcher != nullptr) {
+        return _execute_multi_pattern(context, block, result_column_id);
+    }
+    if (_children.size() != 2) {
+        return VectorizedFnCall::execute(context, block, result_column_id);
+    }
+
+    ColumnNumbers arguments(2);
+    int left_id = -1;
+    RETURN_IF_ERROR(_children[0]->execute(context, block, &left_id));
+    arguments[0] = left_id;
+
+    size_t rows = block->rows();
+    auto left = block->get_by_position(left_id).column->convert_to_full_column_if_const();
+    const NullMap* null_map = nullptr;
+    const IColumn* left_data = left.get();
+    if (left->is_nullable()) {
+        const auto& nullable = assert_cast<const ColumnNullable&>(*left);
+        null_map = &nullable.get_null_map_data();
+        left_data = &nullable.get_nested_column();
+    }
+
+    int right_id = -1;
+    if (const auto* left_values = check_and_get_column<ColumnUInt8>(left_data)) {
+        // a row is decided by a false left side for AND, and by a true one for OR
+        const auto& values = left_values->get_data();
+        const bool is_and = is_and_expr();
+        IColumn::Filter undecided(rows);
+        for (size_t i = 0; i < rows; ++i) {
+            undecided[i] = (null_map != nullptr && (*null_map)[i]) || (values[i] != 0) == is_and;
+        }
+        RETURN_IF_ERROR(_children[1]->execute_selected(
+                context, block, undecided, count_bytes_in_filter(undecided), &right_id));
+    } else {
+        RETURN_IF_ERROR(_children[1]->execute(context, block, &right_id));
+    }
+    arguments[1] = right_id;
+
+    // the rows not evaluated by the right side take its default value, they don't change the
+    // result since false AND x is false and true OR x is true
+    size_t num_columns_without_result = block->columns();
+    block->insert({nullptr, _data_type, _expr_name});
+    RETURN_IF_ERROR(_function->execute(context->fn_context(_fn_context_index), *block, arguments,
+                                       num_columns_without_result, rows, false));
+    *result_column_id = num_columns_without_result;
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
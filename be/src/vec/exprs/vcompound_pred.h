@@ -20,6 +20,7 @@
 #include "vec/exprs/vectorized_fn_call.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/functions/function.h"
+#include "vec/functions/multi_regex_matcher.h"
 
 namespace doris::vectorized {
 
@@ -38,5 +39,26 @@ public:
             break;
         }
     }
+
+    VExpr* clone(ObjectPool* pool) const override { return pool->add(new VcompoundPred(*this)); }
+
+    Status prepare(RuntimeState* state, const RowDescriptor& desc,
+                   VExprContext* context) override;
+
+    // The right side of AND/OR is only evaluated on the rows not decided by the left side,
+    // i.e. the rows not false for AND and the rows not true for OR.
+    Status execute(VExprContext* context, Block* block, int* result_column_id) override;
+
+private:
+    // Collect the regexes of an OR of LIKE and REGEXP predicates with constant patterns on the
+    // same string, return false if the expr is not such a predicate.
+    bool _collect_patterns(const VExpr* expr, std::vector<std::string>* regexes);
+
+    Status _execute_multi_pattern(VExprContext* context, Block* block, int* result_column_id);
+
+    // Set if this is an OR of LIKE and REGEXP predicates on the same string with constant
+    // patterns, all the patterns are matched in one pass of the string.
+    const VExpr* _pattern_input = nullptr;
+    std::shared_ptr<const MultiRegexMatcher> _pattern_matcher;
 };
 } // namespace doris::vectorized
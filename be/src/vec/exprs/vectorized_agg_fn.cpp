@@ -122,7 +122,12 @@ void AggFnEvaluator::execute_batch_add(Block* block, size_t offset, AggregateDat
                                        Arena* arena) {
     _calc_argment_columns(block);
     SCOPED_TIMER(_exec_timer);
-    _function->add_batch(block->rows(), places, offset, _agg_columns.data(), arena);
+    if (block->has_selection()) {
+        // the places of the rows not selected are nullptr
+        _function->add_batch_selected(block->rows(), places, offset, _agg_columns.data(), arena);
+    } else {
+        _function->add_batch(block->rows(), places, offset, _agg_columns.data(), arena);
+    }
 }
 
 void AggFnEvaluator::insert_result_info(AggregateDataPtr place, IColumn* column) {
@@ -17,6 +17,7 @@
 
 #include "vec/exprs/vectorized_fn_call.h"
 
+#include <set>
 #include <string_view>
 
 #include "exprs/anyval_util.h"
@@ -103,6 +104,22 @@ const std::string& VectorizedFnCall::expr_name() const {
     return _expr_name;
 }
 
+std::string VectorizedFnCall::signature() const {
+    // the results of the non-deterministic functions and the user defined functions are not
+    // shared
+    static const std::set<std::string> non_deterministic_functions = {"rand", "random", "uuid",
+                                                                      "sleep"};
+    if (_fn.binary_type == TFunctionBinaryType::RPC ||
+        _fn.binary_type == TFunctionBinaryType::JAVA_UDF ||
+        non_deterministic_functions.count(_fn.name.function_name)) {
+        return "";
+    }
+    auto children = children_signature();
+    return children.empty() ? ""
+                            : fmt::format("{}{}->{}", _fn.name.function_name, children,
+                                          _data_type->get_name());
+}
+
 std::string VectorizedFnCall::debug_string() const {
     std::stringstream out;
     out << "VectorizedFn[";
@@ -37,9 +37,10 @@ public:
     }
     virtual const std::string& expr_name() const override;
     virtual std::string debug_string() const override;
+    std::string signature() const override;
     static std::string debug_string(const std::vector<VectorizedFnCall*>& exprs);
 
-private:
+protected:
     FunctionBasePtr _function;
     std::string _expr_name;
 };
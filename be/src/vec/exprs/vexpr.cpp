@@ -21,6 +21,7 @@
 
 #include <memory>
 
+#include "common/config.h"
 #include "exprs/anyval_util.h"
 #include "gen_cpp/Exprs_types.h"
 #include "vec/data_types/data_type_factory.hpp"
@@ -285,6 +286,85 @@ std::string VExpr::debug_string(const std::vector<VExprContext*>& ctxs) {
     return debug_string(exprs);
 }
 
+Status VExpr::execute_selected(VExprContext* context, Block* block, const IColumn::Filter& selector,
+                               size_t selected_rows, int* result_column_id) {
+    size_t rows = block->rows();
+    DCHECK_EQ(selector.size(), rows);
+    if (selected_rows == rows || selected_rows > rows * config::selective_eval_max_density) {
+        return execute(context, block, result_column_id);
+    }
+
+    ColumnPtr result;
+    if (selected_rows == 0) {
+        auto column = _data_type->create_column();
+        column->insert_many_defaults(rows);
+        result = std::move(column);
+    } else {
+        // only the columns read by the expr are filtered, the others keep their positions by
+        // cheap const columns
+        std::set<int> column_ids;
+        collect_column_ids(&column_ids);
+        Block selected_block;
+        for (int i = 0; i < block->columns(); ++i) {
+            const auto& elem = block->get_by_position(i);
+            if (elem.column == nullptr) {
+                selected_block.insert(elem);
+            } else if (column_ids.count(i)) {
+                selected_block.insert(
+                        {elem.column->filter(selector, selected_rows), elem.type, elem.name});
+            } else {
+                selected_block.insert({elem.type->create_column_const_with_default_value(
+                                               selected_rows),
+                                       elem.type, elem.name});
+            }
+        }
+        int selected_result = -1;
+        RETURN_IF_ERROR(execute(context, &selected_block, &selected_result));
+        auto selected_column = selected_block.get_by_position(selected_result)
+                                       .column->convert_to_full_column_if_const();
+
+        // scatter the result back by the runs of the selected rows
+        auto column = selected_column->clone_empty();
+        column->reserve(rows);
+        size_t selected_pos = 0;
+        for (size_t begin = 0; begin < rows;) {
+            size_t end = begin + 1;
+            while (end < rows && selector[end] == selector[begin]) {
+                ++end;
+            }
+            if (selector[begin]) {
+                column->insert_range_from(*selected_column, selected_pos, end - begin);
+                selected_pos += end - begin;
+            } else {
+                column->insert_many_defaults(end - begin);
+            }
+            begin = end;
+        }
+        result = std::move(column);
+    }
+    *result_column_id = block->columns();
+    block->insert({std::move(result), _data_type, expr_name()});
+    return Status::OK();
+}
+
+void VExpr::collect_column_ids(std::set<int>* column_ids) const {
+    for (auto child : _children) {
+        child->collect_column_ids(column_ids);
+    }
+}
+
+std::string VExpr::children_signature() const {
+    std::string signature = "(";
+    for (int i = 0; i < _children.size(); ++i) {
+        auto child_signature = _children[i]->signature();
+        if (child_signature.empty()) {
+            return "";
+        }
+        signature += (i == 0 ? "" : ",") + child_signature;
+    }
+    return signature + ")";
+}
+
 bool VExpr::is_constant() const {
     for (int i = 0; i < _children.size(); ++i) {
         if (!_children[i]->is_constant()) {
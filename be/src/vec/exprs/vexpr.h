@@ -18,6 +18,7 @@
 #pragma once
 
 #include <memory>
+#include <set>
 #include <vector>
 
 #include "common/status.h"
@@ -64,6 +65,21 @@ public:
     virtual Status execute(VExprContext* context, vectorized::Block* block,
                            int* result_column_id) = 0;
 
+    /// Execute this expr only on the rows selected by `selector`, `selected_rows` of them, and
+    /// insert the result scattered back to all the rows of the block, the rows not selected
+    /// take the default value. The whole block is evaluated if the selected rows are dense.
+    Status execute_selected(VExprContext* context, vectorized::Block* block,
+                            const IColumn::Filter& selector, size_t selected_rows,
+                            int* result_column_id);
+
+    /// Collect the positions of the block columns read by this expr tree.
+    virtual void collect_column_ids(std::set<int>* column_ids) const;
+
+    /// Identify the result of this expr tree, the trees of the same signature always give the
+    /// same result for a block. Empty if the result can't be shared, e.g. the non-deterministic
+    /// functions, see VCommonExprs.
+    virtual std::string signature() const { return ""; }
+
     /// Subclasses overriding this function should call VExpr::Close().
     //
     /// If scope if FRAGMENT_LOCAL, both fragment- and thread-local state should be torn
@@ -129,6 +145,9 @@ public:
     virtual ColumnPtrWrapper* get_const_col(VExprContext* context);
 
 protected:
+    /// The signatures of the children enclosed in parentheses, empty if any of them is empty.
+    std::string children_signature() const;
+
     /// Simple debug string that provides no expr subclass-specific information
     std::string debug_string(const std::string& expr_name) const {
         std::stringstream out;
@@ -19,6 +19,7 @@
 
 #include "runtime/thread_context.h"
 #include "udf/udf_internal.h"
+#include "vec/exprs/vcommon_exprs.h"
 #include "vec/exprs/vexpr.h"
 
 namespace doris::vectorized {
@@ -115,20 +116,27 @@ Status VExprContext::filter_block(VExprContext* vexpr_ctx, Block* block, int col
 }
 
 Status VExprContext::filter_block(const std::unique_ptr<VExprContext*>& vexpr_ctx_ptr, Block* block,
-                                  int column_to_keep) {
+                                  int column_to_keep, bool defer_materialize) {
     if (vexpr_ctx_ptr == nullptr || block->rows() == 0) {
+        if (!defer_materialize) {
+            block->materialize_selection();
+        }
         return Status::OK();
     }
     DCHECK((*vexpr_ctx_ptr) != nullptr);
+    // the conjuncts are evaluated on all the rows, the rows not selected are dropped by the filter
     int result_column_id = -1;
     (*vexpr_ctx_ptr)->execute(block, &result_column_id);
-    return Block::filter_block(block, result_column_id, column_to_keep);
+    return Block::filter_block(block, result_column_id, column_to_keep, defer_materialize);
 }
 
 Block VExprContext::get_output_block_after_execute_exprs(
         const std::vector<vectorized::VExprContext*>& output_vexpr_ctxs, const Block& input_block,
-        Status& status) {
+        Status& status, VCommonExprs* common_exprs) {
     vectorized::Block tmp_block(input_block.get_columns_with_type_and_name());
+    if (common_exprs != nullptr) {
+        common_exprs->reset(&tmp_block);
+    }
     vectorized::ColumnsWithTypeAndName result_columns;
     for (auto vexpr_ctx : output_vexpr_ctxs) {
         int result_column_id = -1;
@@ -22,6 +22,7 @@
 #include "vec/core/block.h"
 
 namespace doris::vectorized {
+class VCommonExprs;
 class VExpr;
 
 class VExprContext {
@@ -54,11 +55,14 @@ public:
     }
 
     static Status filter_block(VExprContext* vexpr_ctx, Block* block, int column_to_keep);
+    // see Block::filter_block() for `defer_materialize`
     static Status filter_block(const std::unique_ptr<VExprContext*>& vexpr_ctx_ptr, Block* block,
-                               int column_to_keep);
+                               int column_to_keep, bool defer_materialize = false);
 
+    // the common subexpressions of the exprs are executed once if `common_exprs` is given
     static Block get_output_block_after_execute_exprs(const std::vector<vectorized::VExprContext*>&,
-                                                      const Block&, Status&);
+                                                      const Block&, Status&,
+                                                      VCommonExprs* common_exprs = nullptr);
 
     int get_last_result_column_id() {
         DCHECK(_last_result_column_id != -1);
@@ -104,4 +104,9 @@ const std::string& VInPredicate::expr_name() const {
     return _expr_name;
 }
 
+std::string VInPredicate::signature() const {
+    auto children = children_signature();
+    return children.empty() ? "" : (_is_not_in ? "not_in" : "in") + children;
+}
+
 } // namespace doris::vectorized
\ No newline at end of file
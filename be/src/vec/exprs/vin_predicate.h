@@ -38,6 +38,7 @@ public:
         return pool->add(new VInPredicate(*this));
     }
     virtual const std::string& expr_name() const override;
+    std::string signature() const override;
 
 private:
     FunctionBasePtr _function;
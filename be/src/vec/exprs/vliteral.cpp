@@ -132,4 +132,12 @@ Status VLiteral::execute(VExprContext* context, vectorized::Block* block, int* r
     *result_column_id = res;
     return Status::OK();
 }
+
+std::string VLiteral::signature() const {
+    if (_column_ptr->is_null_at(0)) {
+        return fmt::format("null:{}", _data_type->get_name());
+    }
+    auto data = _column_ptr->get_data_at(0);
+    return fmt::format("literal:{}:{}:{}", _data_type->get_name(), data.size, data.to_string());
+}
 } // namespace doris::vectorized
@@ -37,6 +37,9 @@ public:
     virtual Status execute(VExprContext* context, vectorized::Block* block,
                            int* result_column_id) override;
     virtual const std::string& expr_name() const override { return _expr_name; }
+    std::string signature() const override;
+    // a const column of one row
+    const ColumnPtr& get_column_ptr() const { return _column_ptr; }
     virtual VExpr* clone(doris::ObjectPool* pool) const override {
         return pool->add(new VLiteral(*this));
     }
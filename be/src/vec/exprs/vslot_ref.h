@@ -38,6 +38,14 @@ public:
     virtual const std::string& expr_name() const override;
     virtual std::string debug_string() const override;
     virtual bool is_constant() const override { return false; }
+    void collect_column_ids(std::set<int>* column_ids) const override {
+        column_ids->insert(_column_id);
+    }
+    std::string signature() const override { return "slot#" + std::to_string(_slot_id); }
+
+    int slot_id() const { return _slot_id; }
+    // the position of the slot in the block, only valid after prepare()
+    int column_id() const { return _column_id; }
 
 private:
     FunctionPtr _function;
@@ -17,6 +17,9 @@
 
 #include "vec/exprs/vtuple_is_null_predicate.h"
 
+#include <fmt/format.h>
+#include <fmt/ranges.h>
+
 #include <string_view>
 
 #include "exprs/create_predicate_function.h"
@@ -56,6 +59,10 @@ Status VTupleIsNullPredicate::prepare(RuntimeState* state, const RowDescriptor&
     return Status::OK();
 }
 
+std::string VTupleIsNullPredicate::signature() const {
+    return fmt::format("{}({})", function_name, fmt::join(_tuple_ids, ","));
+}
+
 Status VTupleIsNullPredicate::execute(VExprContext* context, Block* block, int* result_column_id) {
     size_t num_columns_without_result = block->columns();
     auto target_rows = block->rows();
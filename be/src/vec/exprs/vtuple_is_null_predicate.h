@@ -35,8 +35,14 @@ public:
 
     [[nodiscard]] bool is_constant() const override { return false; }
 
+    void collect_column_ids(std::set<int>* column_ids) const override {
+        column_ids->insert(_column_to_check.begin(), _column_to_check.end());
+    }
+
     [[nodiscard]] const std::string& expr_name() const override;
 
+    std::string signature() const override;
+
 private:
     std::string _expr_name;
     std::vector<TupleId> _tuple_ids;
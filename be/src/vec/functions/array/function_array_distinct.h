@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+
+#include "vec/data_types/data_type_array.h"
+#include "vec/functions/array/function_array_utils.h"
+#include "vec/functions/function.h"
+
+namespace doris::vectorized {
+
+// array_distinct(array): the array without the duplicated elements, the elements are kept in
+// the order of their first occurrences, and the null elements are kept as one null.
+class FunctionArrayDistinct : public IFunction {
+public:
+    static constexpr auto name = "array_distinct";
+    static FunctionPtr create() { return std::make_shared<FunctionArrayDistinct>(); }
+
+    /// Get function name.
+    String get_name() const override { return name; }
+
+    bool is_variadic() const override { return false; }
+
+    size_t get_number_of_arguments() const override { return 1; }
+
+    DataTypePtr get_return_type_impl(const DataTypes& arguments) const override {
+        DCHECK(is_array(arguments[0]))
+                << "first argument for function: " << name << " should be DataTypeArray";
+        return arguments[0];
+    }
+
+    Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
+                        size_t result, size_t input_rows_count) override {
+        ColumnPtr src_column =
+                block.get_by_position(arguments[0]).column->convert_to_full_column_if_const();
+        ColumnArrayExecutionData src;
+        if (!extract_column_array_info(*src_column, src)) {
+            return _unsupported(block, arguments);
+        }
+
+        auto dst_column = ColumnArray::create(src.array_col->get_data().clone_empty());
+        auto& dst_offsets = dst_column->get_offsets();
+        dst_offsets.reserve(input_rows_count);
+        std::vector<int> indices;
+        indices.reserve(src.array_col->get_data().size());
+        if (!dispatch_array_nested_column(*src.nested_col, [&](const auto& nested_col) {
+                _execute(src, nested_col, indices, dst_offsets);
+            })) {
+            return _unsupported(block, arguments);
+        }
+        dst_column->get_data().insert_indices_from(src.array_col->get_data(), indices.data(),
+                                                   indices.data() + indices.size());
+        block.replace_by_position(result, std::move(dst_column));
+        return Status::OK();
+    }
+
+private:
+    template <typename ColumnType>
+    static void _execute(const ColumnArrayExecutionData& src, const ColumnType& nested_col,
+                         std::vector<int>& indices, ColumnArray::Offsets& dst_offsets) {
+        using Key = decltype(array_element_key(nested_col, 0));
+        const auto& offsets = *src.offsets_ptr;
+        phmap::flat_hash_set<Key> keys;
+        for (size_t row = 0; row < offsets.size(); ++row) {
+            keys.clear();
+            bool has_null = false;
+            for (size_t i = offsets[row - 1]; i < offsets[row]; ++i) {
+                if (src.is_null_element(i)) {
+                    if (!has_null) {
+                        has_null = true;
+                        indices.push_back(i);
+                    }
+                } else if (keys.insert(array_element_key(nested_col, i)).second) {
+                    indices.push_back(i);
+                }
+            }
+            dst_offsets.push_back(indices.size());
+        }
+    }
+
+    Status _unsupported(const Block& block, const ColumnNumbers& arguments) const {
+        return Status::RuntimeError(
+                fmt::format("unsupported types for function {}({})", get_name(),
+                            block.get_by_position(arguments[0]).type->get_name()));
+    }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,108 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <algorithm>
+
+#include "vec/data_types/data_type_array.h"
+#include "vec/functions/array/function_array_utils.h"
+#include "vec/functions/function.h"
+
+namespace doris::vectorized {
+
+// array_sort(array): the array sorted in the ascending order, with the null elements first.
+class FunctionArraySort : public IFunction {
+public:
+    static constexpr auto name = "array_sort";
+    static FunctionPtr create() { return std::make_shared<FunctionArraySort>(); }
+
+    /// Get function name.
+    String get_name() const override { return name; }
+
+    bool is_variadic() const override { return false; }
+
+    size_t get_number_of_arguments() const override { return 1; }
+
+    DataTypePtr get_return_type_impl(const DataTypes& arguments) const override {
+        DCHECK(is_array(arguments[0]))
+                << "first argument for function: " << name << " should be DataTypeArray";
+        return arguments[0];
+    }
+
+    Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
+                        size_t result, size_t input_rows_count) override {
+        ColumnPtr src_column =
+                block.get_by_position(arguments[0]).column->convert_to_full_column_if_const();
+        ColumnArrayExecutionData src;
+        if (!extract_column_array_info(*src_column, src)) {
+            return _unsupported(block, arguments);
+        }
+
+        // the elements are sorted in place of their indices, so the offsets are not changed
+        std::vector<int> indices(src.array_col->get_data().size());
+        for (size_t i = 0; i < indices.size(); ++i) {
+            indices[i] = i;
+        }
+        if (!dispatch_array_nested_column(*src.nested_col, [&](const auto& nested_col) {
+                _execute(src, nested_col, indices);
+            })) {
+            return _unsupported(block, arguments);
+        }
+
+        auto dst_nested_column = src.array_col->get_data().clone_empty();
+        dst_nested_column->insert_indices_from(src.array_col->get_data(), indices.data(),
+                                               indices.data() + indices.size());
+        block.replace_by_position(result, ColumnArray::create(std::move(dst_nested_column),
+                                                              src.array_col->get_offsets_ptr()));
+        return Status::OK();
+    }
+
+private:
+    template <typename ColumnType>
+    static void _execute(const ColumnArrayExecutionData& src, const ColumnType& nested_col,
+                         std::vector<int>& indices) {
+        auto less = [&](int a, int b) {
+            // the null elements go first
+            if (src.is_null_element(a) || src.is_null_element(b)) {
+                return src.is_null_element(a) && !src.is_null_element(b);
+            }
+            if constexpr (std::is_same_v<ColumnType, IColumn>) {
+                return nested_col.compare_at(a, b, nested_col, 1) < 0;
+            } else if constexpr (std::is_same_v<ColumnType, ColumnString>) {
+                return array_element_key(nested_col, a) < array_element_key(nested_col, b);
+            } else if constexpr (std::is_floating_point_v<typename ColumnType::value_type>) {
+                // compare_at orders the NaNs, which break the strict weak ordering of '<'
+                return nested_col.compare_at(a, b, nested_col, 1) < 0;
+            } else {
+                return array_element_key(nested_col, a) < array_element_key(nested_col, b);
+            }
+        };
+        const auto& offsets = *src.offsets_ptr;
+        for (size_t row = 0; row < offsets.size(); ++row) {
+            std::sort(indices.begin() + offsets[row - 1], indices.begin() + offsets[row], less);
+        }
+    }
+
+    Status _unsupported(const Block& block, const ColumnNumbers& arguments) const {
+        return Status::RuntimeError(
+                fmt::format("unsupported types for function {}({})", get_name(),
+                            block.get_by_position(arguments[0]).type->get_name()));
+    }
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <type_traits>
+
+#include "vec/columns/column_array.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+
+namespace doris::vectorized {
+
+// The parts of an array column, the elements of the row i are in [offsets[i - 1], offsets[i])
+// of the nested column. The kernels over the arrays run over these parts directly, and pick the
+// elements of the result by their indices in the nested column, which are copied to the result
+// by one insert_indices_from.
+struct ColumnArrayExecutionData {
+    const ColumnArray* array_col = nullptr;
+    const ColumnArray::Offsets* offsets_ptr = nullptr;
+    // the nested column without the null map
+    const IColumn* nested_col = nullptr;
+    // nullptr if the elements are not nullable
+    const UInt8* nested_nullmap_data = nullptr;
+
+    bool is_null_element(size_t i) const {
+        return nested_nullmap_data != nullptr && nested_nullmap_data[i];
+    }
+};
+
+// Return false if `src` is not an array column.
+bool extract_column_array_info(const IColumn& src, ColumnArrayExecutionData& data);
+
+// Call `f` with the nested column of the arrays cast to its concrete type, the columns other than
+// the number and string columns are passed as IColumn, and their elements are compared by their
+// bytes. Return false if the elements can't be compared, eg. the nested column is an array.
+template <typename F>
+bool dispatch_array_nested_column(const IColumn& nested_col, F&& f) {
+    auto dispatch = [&](auto* typed_col) {
+        using ColumnType = std::remove_const_t<std::remove_pointer_t<decltype(typed_col)>>;
+        if (check_and_get_column<ColumnType>(nested_col) == nullptr) {
+            return false;
+        }
+        f(assert_cast<const ColumnType&>(nested_col));
+        return true;
+    };
+    if (dispatch((const ColumnUInt8*)nullptr) || dispatch((const ColumnInt8*)nullptr) ||
+        dispatch((const ColumnInt16*)nullptr) || dispatch((const ColumnInt32*)nullptr) ||
+        dispatch((const ColumnInt64*)nullptr) || dispatch((const ColumnFloat32*)nullptr) ||
+        dispatch((const ColumnFloat64*)nullptr) || dispatch((const ColumnString*)nullptr)) {
+        return true;
+    }
+    if (!nested_col.is_fixed_and_contiguous()) {
+        return false;
+    }
+    f(nested_col);
+    return true;
+}
+
+// The key to hash and compare the element i of a nested column passed by
+// dispatch_array_nested_column.
+template <typename ColumnType>
+auto array_element_key(const ColumnType& nested_col, size_t i) {
+    if constexpr (std::is_same_v<ColumnType, IColumn> ||
+                  std::is_same_v<ColumnType, ColumnString>) {
+        return nested_col.get_data_at(i);
+    } else {
+        return nested_col.get_data()[i];
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,116 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <parallel_hashmap/phmap.h>
+
+#include <typeinfo>
+
+#include "vec/data_types/data_type_array.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/functions/array/function_array_utils.h"
+#include "vec/functions/function.h"
+
+namespace doris::vectorized {
+
+// arrays_overlap(array1, array2): whether the arrays have a common element, the null elements
+// are never common. The arrays should have the same element type.
+class FunctionArraysOverlap : public IFunction {
+public:
+    static constexpr auto name = "arrays_overlap";
+    static FunctionPtr create() { return std::make_shared<FunctionArraysOverlap>(); }
+
+    /// Get function name.
+    String get_name() const override { return name; }
+
+    bool is_variadic() const override { return false; }
+
+    size_t get_number_of_arguments() const override { return 2; }
+
+    DataTypePtr get_return_type_impl(const DataTypes& arguments) const override {
+        DCHECK(is_array(arguments[0]) && is_array(arguments[1]))
+                << "arguments for function: " << name << " should be DataTypeArray";
+        return std::make_shared<DataTypeUInt8>();
+    }
+
+    Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
+                        size_t result, size_t input_rows_count) override {
+        ColumnPtr left_column =
+                block.get_by_position(arguments[0]).column->convert_to_full_column_if_const();
+        ColumnPtr right_column =
+                block.get_by_position(arguments[1]).column->convert_to_full_column_if_const();
+        ColumnArrayExecutionData left;
+        ColumnArrayExecutionData right;
+        if (!extract_column_array_info(*left_column, left) ||
+            !extract_column_array_info(*right_column, right) ||
+            typeid(*left.nested_col) != typeid(*right.nested_col)) {
+            return _unsupported(block, arguments);
+        }
+
+        auto dst_column = ColumnUInt8::create(input_rows_count, 0);
+        auto& dst_data = dst_column->get_data();
+        if (!dispatch_array_nested_column(*left.nested_col, [&](const auto& left_nested_col) {
+                using ColumnType = std::decay_t<decltype(left_nested_col)>;
+                _execute(left, left_nested_col,
+                         right, assert_cast<const ColumnType&>(*right.nested_col), dst_data);
+            })) {
+            return _unsupported(block, arguments);
+        }
+        block.replace_by_position(result, std::move(dst_column));
+        return Status::OK();
+    }
+
+private:
+    template <typename ColumnType>
+    static void _execute(const ColumnArrayExecutionData& left, const ColumnType& left_nested_col,
+                         const ColumnArrayExecutionData& right,
+                         const ColumnType& right_nested_col, ColumnUInt8::Container& dst_data) {
+        using Key = decltype(array_element_key(left_nested_col, 0));
+        const auto& left_offsets = *left.offsets_ptr;
+        const auto& right_offsets = *right.offsets_ptr;
+        phmap::flat_hash_set<Key> keys;
+        for (size_t row = 0; row < dst_data.size(); ++row) {
+            // the elements of the left row are hashed, and the right row probes them
+            keys.clear();
+            for (size_t i = left_offsets[row - 1]; i < left_offsets[row]; ++i) {
+                if (!left.is_null_element(i)) {
+                    keys.insert(array_element_key(left_nested_col, i));
+                }
+            }
+            if (keys.empty()) {
+                continue;
+            }
+            for (size_t i = right_offsets[row - 1]; i < right_offsets[row]; ++i) {
+                if (!right.is_null_element(i) &&
+                    keys.find(array_element_key(right_nested_col, i)) != keys.end()) {
+                    dst_data[row] = 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    Status _unsupported(const Block& block, const ColumnNumbers& arguments) const {
+        return Status::RuntimeError(
+                fmt::format("unsupported types for function {}({}, {})", get_name(),
+                            block.get_by_position(arguments[0]).type->get_name(),
+                            block.get_by_position(arguments[1]).type->get_name()));
+    }
+};
+
+} // namespace doris::vectorized
@@ -22,7 +22,10 @@
 
 #include "common/status.h"
 #include "runtime/datetime_value.h"
+#include "runtime/runtime_state.h"
+#include "udf/udf_internal.h"
 #include "util/binary_cast.hpp"
+#include "util/timezone_utils.h"
 #include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
 #include "vec/common/exception.h"
@@ -145,26 +148,15 @@ struct DateFormatImpl {
 
     static constexpr auto name = "date_format";
 
-    static inline auto execute(const Int64& t, StringRef format, ColumnString::Chars& res_data,
-                               size_t& offset) {
-        const auto& dt = (VecDateTimeValue&)t;
-        if (format.size > 128) {
-            offset += 1;
-            res_data.emplace_back(0);
-            return std::pair {offset, true};
-        }
-        char buf[128];
-        if (!dt.to_format_string(format.data, format.size, buf)) {
-            offset += 1;
-            res_data.emplace_back(0);
-            return std::pair {offset, true};
-        }
+    // convert the values of a block to datetimes
+    struct Converter {
+        explicit Converter(FunctionContext* context) {}
 
-        auto len = strlen(buf) + 1;
-        res_data.insert(buf, buf + len);
-        offset += len;
-        return std::pair {offset, false};
-    }
+        bool to_datetime(Int64 t, VecDateTimeValue& dt) {
+            dt = binary_cast<Int64, VecDateTimeValue>(t);
+            return true;
+        }
+    };
 };
 
 // TODO: This function should be depend on argments not always nullable
@@ -173,30 +165,29 @@ struct FromUnixTimeImpl {
 
     static constexpr auto name = "from_unixtime";
 
-    static inline auto execute(FromType val, StringRef format, ColumnString::Chars& res_data,
-                               size_t& offset) {
-        // TODO: use default time zone, slowly and incorrect, just for test use
-        static cctz::time_zone time_zone = cctz::fixed_time_zone(cctz::seconds(8 * 60 * 60));
+    struct Converter {
+        explicit Converter(FunctionContext* context) : _offsets(_time_zone(context)) {}
 
-        VecDateTimeValue dt;
-        if (format.size > 128 || val < 0 || val > INT_MAX || !dt.from_unixtime(val, time_zone)) {
-            offset += 1;
-            res_data.emplace_back(0);
-            return std::pair {offset, true};
+        bool to_datetime(FromType val, VecDateTimeValue& dt) {
+            if (val < 0) {
+                return false;
+            }
+            dt.from_unixtime_with_offset(val, _offsets.offset(val));
+            return true;
         }
 
-        char buf[128];
-        if (!dt.to_format_string(format.data, format.size, buf)) {
-            offset += 1;
-            res_data.emplace_back(0);
-            return std::pair {offset, true};
+    private:
+        static cctz::time_zone _time_zone(FunctionContext* context) {
+            if (context->impl()->state() != nullptr) {
+                return context->impl()->state()->timezone_obj();
+            }
+            cctz::time_zone ctz;
+            TimezoneUtils::find_cctz_time_zone(TimezoneUtils::default_time_zone, ctz);
+            return ctz;
         }
 
-        auto len = strlen(buf) + 1;
-        res_data.insert(buf, buf + len);
-        offset += len;
-        return std::pair {offset, false};
-    }
+        TimezoneOffsetCache _offsets;
+    };
 };
 
 template <typename Transform>
@@ -220,23 +211,43 @@ struct TransformerToStringOneArgument {
 
 template <typename Transform>
 struct TransformerToStringTwoArgument {
-    static void vector_constant(const PaddedPODArray<typename Transform::FromType>& ts,
-                                const std::string& format, ColumnString::Chars& res_data,
+    // `format` is nullptr if the format string is too long, and all the results are null
+    static void vector_constant(FunctionContext* context,
+                                const PaddedPODArray<typename Transform::FromType>& ts,
+                                const VecDateTimeFormat* format, ColumnString::Chars& res_data,
                                 ColumnString::Offsets& res_offsets,
                                 PaddedPODArray<UInt8>& null_map) {
         auto len = ts.size();
         res_offsets.resize(len);
-        null_map.resize_fill(len, false);
-
-        size_t offset = 0;
-        for (int i = 0; i < len; ++i) {
-            const auto& t = ts[i];
-            const auto [new_offset, is_null] = Transform::execute(
-                    t, StringRef(format.c_str(), format.size()), res_data, offset);
+        null_map.resize_fill(len, format == nullptr);
+        if (format == nullptr) {
+            res_data.resize_fill(len, 0);
+            for (size_t i = 0; i < len; ++i) {
+                res_offsets[i] = i + 1;
+            }
+            return;
+        }
 
-            res_offsets[i] = new_offset;
-            null_map[i] = is_null;
+        // every row is formatted into the chars directly, with the room for its max length
+        res_data.resize(len * (format->max_size() + 1));
+        typename Transform::Converter converter(context);
+        VecDateTimeValue dt;
+        char* const begin = reinterpret_cast<char*>(res_data.data());
+        char* pos = begin;
+        for (size_t i = 0; i < len; ++i) {
+            char* end = nullptr;
+            if (converter.to_datetime(ts[i], dt)) {
+                end = format->format(dt, pos);
+            }
+            if (end == nullptr) {
+                end = pos;
+                null_map[i] = true;
+            }
+            *end++ = '\0';
+            pos = end;
+            res_offsets[i] = pos - begin;
         }
+        res_data.resize(pos - begin);
     }
 };
 
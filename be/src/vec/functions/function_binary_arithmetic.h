@@ -125,6 +125,9 @@ struct DecimalBinaryOperation {
     static constexpr bool can_overflow = is_plus_minus || is_multiply;
 
     using ResultType = ResultType_;
+    /// Decimal128 is DecimalV2 computed by DecimalV2Value, Decimal32 and Decimal64 are computed
+    /// on their native integers
+    static constexpr bool is_decimal_v2 = std::is_same_v<ResultType, Decimal128>;
     using NativeResultType = typename NativeType<ResultType>::Type;
     using Op = Operation<NativeResultType, NativeResultType>;
 
@@ -195,8 +198,17 @@ struct DecimalBinaryOperation {
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i) {
-            c[i] = apply(a[i], b[i]);
+        if constexpr (!is_decimal_v2) {
+            // The overflow is checked once after the loop, so that the loop can be vectorized.
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i) {
+                c[i] = apply_native(a[i], b[i], overflow);
+            }
+            check_overflow(overflow);
+        } else {
+            for (size_t i = 0; i < size; ++i) {
+                c[i] = apply(a[i], b[i]);
+            }
         }
     }
 
@@ -230,7 +242,13 @@ struct DecimalBinaryOperation {
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i) c[i] = apply(a[i], b);
+        if constexpr (!is_decimal_v2) {
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i) c[i] = apply_native(a[i], b, overflow);
+            check_overflow(overflow);
+        } else {
+            for (size_t i = 0; i < size; ++i) c[i] = apply(a[i], b);
+        }
     }
 
     static void NO_INLINE constant_vector(A a, const ArrayB& b, ArrayC& c,
@@ -251,7 +269,13 @@ struct DecimalBinaryOperation {
         }
 
         /// default: use it if no return before
-        for (size_t i = 0; i < size; ++i) c[i] = apply(a, b[i]);
+        if constexpr (!is_decimal_v2) {
+            bool overflow = false;
+            for (size_t i = 0; i < size; ++i) c[i] = apply_native(a, b[i], overflow);
+            check_overflow(overflow);
+        } else {
+            for (size_t i = 0; i < size; ++i) c[i] = apply(a, b[i]);
+        }
     }
 
     static ResultType constant_constant(A a, B b, ResultType scale_a [[maybe_unused]],
@@ -269,6 +293,12 @@ struct DecimalBinaryOperation {
 private:
     /// there's implicit type convertion here
     static NativeResultType apply(NativeResultType a, NativeResultType b) {
+        if constexpr (!is_decimal_v2) {
+            bool overflow = false;
+            auto res = apply_native(a, b, overflow);
+            check_overflow(overflow);
+            return res;
+        }
         // Now, Doris only support decimal +-*/ decimal.
         // overflow in consider in operator
         DecimalV2Value l(a);
@@ -279,6 +309,24 @@ private:
         return result;
     }
 
+    /// Decimal32 and Decimal64 are at the scale of the result (or multiplied without scaling),
+    /// so they are computed on the native integers. `overflow` is set if it overflows.
+    static NativeResultType apply_native(NativeResultType a, NativeResultType b, bool& overflow) {
+        if constexpr (can_overflow && _check_overflow) {
+            NativeResultType res;
+            overflow |= Op::template apply<NativeResultType>(a, b, res);
+            return res;
+        } else {
+            return Op::template apply<NativeResultType>(a, b);
+        }
+    }
+
+    static void check_overflow(bool overflow) {
+        if (UNLIKELY(overflow)) {
+            LOG(FATAL) << "Decimal math overflow";
+        }
+    }
+
     /// null_map for divide and mod
     static NativeResultType apply(NativeResultType a, NativeResultType b, NullMap& null_map,
                                   size_t index) {
@@ -421,6 +469,17 @@ public:
             std::is_same_v<Operation<T0, T0>, LeastBaseImpl<T0, T0>> ||
             std::is_same_v<Operation<T0, T0>, GreatestBaseImpl<T0, T0>>;
 
+    /// Decimal32 and Decimal64 only support +, - and *. And as DecimalV2 (Decimal128) is always
+    /// at scale 9, it can't be multiplied with them.
+    static constexpr bool has_decimal_native =
+            IsDataTypeDecimalNative<LeftDataType> || IsDataTypeDecimalNative<RightDataType>;
+    static constexpr bool is_multiply = std::is_same_v<Operation<T0, T0>, MultiplyImpl<T0, T0>>;
+    static constexpr bool allow_decimal_native =
+            !has_decimal_native || std::is_same_v<Operation<T0, T0>, PlusImpl<T0, T0>> ||
+            std::is_same_v<Operation<T0, T0>, MinusImpl<T0, T0>> ||
+            (is_multiply && !std::is_same_v<LeftDataType, DataTypeDecimal<Decimal128>> &&
+             !std::is_same_v<RightDataType, DataTypeDecimal<Decimal128>>);
+
     /// Appropriate result type for binary operator on numeric types. "Date" can also mean
     /// DateTime, but if both operands are Dates, their type must be the same (e.g. Date - DateTime is invalid).
     using ResultDataType = Switch<
@@ -428,6 +487,7 @@ public:
             Case<!allow_decimal &&
                          (IsDataTypeDecimal<LeftDataType> || IsDataTypeDecimal<RightDataType>),
                  InvalidType>,
+            Case<!allow_decimal_native, InvalidType>,
             Case<IsDataTypeDecimal<LeftDataType> && IsDataTypeDecimal<RightDataType> &&
                          UseLeftDecimal<LeftDataType, RightDataType>,
                  LeftDataType>,
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <memory>
+#include <string_view>
+
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/columns_number.h"
 #include "vec/data_types/data_type_date.h"
@@ -47,6 +50,23 @@ public:
     bool use_default_implementation_for_constants() const override { return true; }
     ColumnNumbers get_arguments_that_are_always_constant() const override { return {1}; }
 
+    Status prepare(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope != FunctionContext::FRAGMENT_LOCAL) {
+            return Status::OK();
+        }
+        // compile the constant format once for all the blocks
+        if (context->get_num_args() == 1) {
+            context->set_function_state(scope, new FormatState(default_format));
+        } else if (context->is_col_constant(1)) {
+            const auto format_col = context->get_constant_col(1)->column_ptr;
+            if (!format_col->is_null_at(0)) {
+                context->set_function_state(
+                        scope, new FormatState(format_col->get_data_at(0).to_string_view()));
+            }
+        }
+        return Status::OK();
+    }
+
     Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
                         size_t result, size_t input_rows_count) override {
         const ColumnPtr source_col = block.get_by_position(arguments[0]).column;
@@ -62,24 +82,30 @@ public:
             col_null_map_to = ColumnUInt8::create();
             auto& vec_null_map_to = col_null_map_to->get_data();
 
-            if (arguments.size() == 2) {
-                const IColumn& source_col1 = *block.get_by_position(arguments[1]).column;
-                if (const auto* delta_const_column =
-                            typeid_cast<const ColumnConst*>(&source_col1)) {
-                    TransformerToStringTwoArgument<Transform>::vector_constant(
-                            sources->get_data(), delta_const_column->get_field().get<String>(),
-                            col_res->get_chars(), col_res->get_offsets(), vec_null_map_to);
+            const auto* state = reinterpret_cast<FormatState*>(
+                    context->get_function_state(FunctionContext::FRAGMENT_LOCAL));
+            std::unique_ptr<FormatState> block_state;
+            if (state == nullptr) {
+                if (arguments.size() == 2) {
+                    const IColumn& source_col1 = *block.get_by_position(arguments[1]).column;
+                    if (const auto* delta_const_column =
+                                typeid_cast<const ColumnConst*>(&source_col1)) {
+                        block_state = std::make_unique<FormatState>(
+                                delta_const_column->get_field().get<String>());
+                    } else {
+                        return Status::InternalError(
+                                "Illegal column " +
+                                block.get_by_position(arguments[1]).column->get_name() +
+                                " is not const" + name);
+                    }
                 } else {
-                    return Status::InternalError(
-                            "Illegal column " +
-                            block.get_by_position(arguments[1]).column->get_name() +
-                            " is not const" + name);
+                    block_state = std::make_unique<FormatState>(default_format);
                 }
-            } else {
-                TransformerToStringTwoArgument<Transform>::vector_constant(
-                        sources->get_data(), "%Y-%m-%d %H:%i:%s", col_res->get_chars(),
-                        col_res->get_offsets(), vec_null_map_to);
+                state = block_state.get();
             }
+            TransformerToStringTwoArgument<Transform>::vector_constant(
+                    context, sources->get_data(), state->format.get(), col_res->get_chars(),
+                    col_res->get_offsets(), vec_null_map_to);
 
             if (nullable_column) {
                 const auto& origin_null_map = nullable_column->get_null_map_column().get_data();
@@ -96,6 +122,27 @@ public:
         }
         return Status::OK();
     }
+
+    Status close(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope == FunctionContext::FRAGMENT_LOCAL) {
+            delete reinterpret_cast<FormatState*>(context->get_function_state(scope));
+        }
+        return Status::OK();
+    }
+
+private:
+    static constexpr auto default_format = "%Y-%m-%d %H:%i:%s";
+
+    struct FormatState {
+        explicit FormatState(std::string_view format_str) {
+            // the same limit as the format of to_format_string(), the longer formats return null
+            if (format_str.size() <= 128) {
+                format = std::make_unique<VecDateTimeFormat>(format_str);
+            }
+        }
+
+        std::unique_ptr<VecDateTimeFormat> format;
+    };
 };
 
 } // namespace doris::vectorized
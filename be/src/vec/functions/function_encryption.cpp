@@ -15,6 +15,9 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <optional>
+#include <string_view>
+
 #include "exprs/encryption_functions.h"
 #include "runtime/string_search.hpp"
 #include "util/encryption_util.h"
@@ -27,6 +30,16 @@
 
 namespace doris::vectorized {
 
+static constexpr size_t MAX_CIPHER_BLOCK_SIZE = 16;
+
+// write the null row i at `result_size` of the chars sized for the results of all the rows
+static void write_null_result(size_t i, ColumnString::Chars& result_data, size_t& result_size,
+                              ColumnString::Offsets& result_offset, NullMap& null_map) {
+    null_map[i] = 1;
+    result_data[result_size++] = '\0';
+    result_offset[i] = result_size;
+}
+
 template <typename Impl, typename FunctionName>
 class FunctionEncryptionAndDecrypt : public IFunction {
 public:
@@ -52,6 +65,22 @@ public:
 
     bool use_default_implementation_for_constants() const override { return true; }
 
+    // the cipher context is reused by the rows of all the blocks of the thread
+    Status prepare(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope == FunctionContext::THREAD_LOCAL) {
+            context->set_function_state(scope, new CipherContext());
+        }
+        return Status::OK();
+    }
+
+    Status close(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope == FunctionContext::THREAD_LOCAL) {
+            delete reinterpret_cast<CipherContext*>(context->get_function_state(scope));
+            context->set_function_state(scope, nullptr);
+        }
+        return Status::OK();
+    }
+
     Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
                         size_t result, size_t input_rows_count) override {
         size_t argument_size = arguments.size();
@@ -82,20 +111,29 @@ public:
             chars_list[i] = &col_str->get_chars();
         }
 
-        Impl::vector_vector(offsets_list, chars_list, input_rows_count, result_data, result_offset,
-                            result_null_map->get_data());
+        auto cipher_ctx = reinterpret_cast<CipherContext*>(
+                context->get_function_state(FunctionContext::THREAD_LOCAL));
+        DCHECK(cipher_ctx != nullptr);
+        // the results of all the rows are written into the chars resized once by the longest
+        // results, the cipher text of a row is at most a block longer than the source
+        result_data.resize(chars_list[0]->size() + input_rows_count * MAX_CIPHER_BLOCK_SIZE);
+        size_t result_size = 0;
+        Impl::vector_vector(cipher_ctx, offsets_list, chars_list, input_rows_count, result_data,
+                            result_size, result_offset, result_null_map->get_data());
+        result_data.resize(result_size);
         block.get_by_position(result).column =
                 ColumnNullable::create(std::move(result_data_column), std::move(result_null_map));
         return Status::OK();
     }
 };
 
-template <typename Impl, bool is_encrypt>
-static void exectue_result(std::vector<const ColumnString::Offsets*>& offsets_list,
+template <typename Impl>
+static void exectue_result(CipherContext* cipher_ctx,
+                           std::vector<const ColumnString::Offsets*>& offsets_list,
                            std::vector<const ColumnString::Chars*>& chars_list, size_t i,
                            EncryptionMode& encryption_mode, const char* iv_raw,
-                           ColumnString::Chars& result_data, ColumnString::Offsets& result_offset,
-                           NullMap& null_map) {
+                           ColumnString::Chars& result_data, size_t& result_size,
+                           ColumnString::Offsets& result_offset, NullMap& null_map) {
     int src_size = (*offsets_list[0])[i] - (*offsets_list[0])[i - 1] - 1;
     const auto src_raw =
             reinterpret_cast<const char*>(&(*chars_list[0])[(*offsets_list[0])[i - 1]]);
@@ -103,66 +141,69 @@ static void exectue_result(std::vector<const ColumnString::Offsets*>& offsets_li
     const auto key_raw =
             reinterpret_cast<const char*>(&(*chars_list[1])[(*offsets_list[1])[i - 1]]);
     if (*src_raw == '\0' && src_size == 0) {
-        StringOP::push_null_string(i, result_data, result_offset, null_map);
+        write_null_result(i, result_data, result_size, result_offset, null_map);
         return;
     }
-    int cipher_len = src_size;
-    if constexpr (is_encrypt) {
-        cipher_len += 16;
-    }
-    std::unique_ptr<char[]> p;
-    p.reset(new char[cipher_len]);
-    int ret_code = 0;
-
-    ret_code = Impl::exectue_impl(encryption_mode, (unsigned char*)src_raw, src_size,
-                                  (unsigned char*)key_raw, key_size, iv_raw, true,
-                                  (unsigned char*)p.get());
+    // the result is written in place, followed by its terminating zero
+    auto result = reinterpret_cast<unsigned char*>(&result_data[result_size]);
+    int ret_code = Impl::exectue_impl(cipher_ctx, encryption_mode, (unsigned char*)src_raw,
+                                      src_size, (unsigned char*)key_raw, key_size, iv_raw, true,
+                                      result);
 
     if (ret_code < 0) {
-        StringOP::push_null_string(i, result_data, result_offset, null_map);
+        write_null_result(i, result_data, result_size, result_offset, null_map);
     } else {
-        StringOP::push_value_string(std::string_view(p.get(), ret_code), i, result_data,
-                                    result_offset);
+        result_size += ret_code;
+        result_data[result_size++] = '\0';
+        result_offset[i] = result_size;
     }
 }
 
-template <typename Impl, EncryptionMode mode, bool is_encrypt>
+template <typename Impl, EncryptionMode mode>
 struct EncryptionAndDecryptTwoImpl {
     static DataTypes get_variadic_argument_types_impl() {
         return {std::make_shared<DataTypeString>(), std::make_shared<DataTypeString>()};
     }
 
-    static Status vector_vector(std::vector<const ColumnString::Offsets*>& offsets_list,
+    static Status vector_vector(CipherContext* cipher_ctx,
+                                std::vector<const ColumnString::Offsets*>& offsets_list,
                                 std::vector<const ColumnString::Chars*>& chars_list,
                                 size_t input_rows_count, ColumnString::Chars& result_data,
-                                ColumnString::Offsets& result_offset, NullMap& null_map) {
+                                size_t& result_size, ColumnString::Offsets& result_offset,
+                                NullMap& null_map) {
         for (int i = 0; i < input_rows_count; ++i) {
             if (null_map[i]) {
-                StringOP::push_null_string(i, result_data, result_offset, null_map);
+                write_null_result(i, result_data, result_size, result_offset, null_map);
                 continue;
             }
             EncryptionMode encryption_mode = mode;
-            exectue_result<Impl, is_encrypt>(offsets_list, chars_list, i, encryption_mode, nullptr,
-                                             result_data, result_offset, null_map);
+            exectue_result<Impl>(cipher_ctx, offsets_list, chars_list, i, encryption_mode, nullptr,
+                                 result_data, result_size, result_offset, null_map);
         }
         return Status::OK();
     }
 };
 
-template <typename Impl, EncryptionMode mode, bool is_encrypt, bool is_sm_mode>
+template <typename Impl, EncryptionMode mode, bool is_sm_mode>
 struct EncryptionAndDecryptFourImpl {
     static DataTypes get_variadic_argument_types_impl() {
         return {std::make_shared<DataTypeString>(), std::make_shared<DataTypeString>(),
                 std::make_shared<DataTypeString>(), std::make_shared<DataTypeString>()};
     }
 
-    static Status vector_vector(std::vector<const ColumnString::Offsets*>& offsets_list,
+    static Status vector_vector(CipherContext* cipher_ctx,
+                                std::vector<const ColumnString::Offsets*>& offsets_list,
                                 std::vector<const ColumnString::Chars*>& chars_list,
                                 size_t input_rows_count, ColumnString::Chars& result_data,
-                                ColumnString::Offsets& result_offset, NullMap& null_map) {
+                                size_t& result_size, ColumnString::Offsets& result_offset,
+                                NullMap& null_map) {
+        // the mode is usually the same for all the rows, so it's only looked up if it changes
+        bool mode_found = false;
+        std::string_view last_mode_str;
+        std::optional<EncryptionMode> last_mode;
         for (int i = 0; i < input_rows_count; ++i) {
             if (null_map[i]) {
-                StringOP::push_null_string(i, result_data, result_offset, null_map);
+                write_null_result(i, result_data, result_size, result_offset, null_map);
                 continue;
             }
 
@@ -173,44 +214,52 @@ struct EncryptionAndDecryptFourImpl {
             const auto iv_raw =
                     reinterpret_cast<const char*>(&(*chars_list[2])[(*offsets_list[2])[i - 1]]);
             if (*mode_raw != '\0' || mode_size != 0) {
-                std::string mode_str(mode_raw, mode_size);
-                if constexpr (is_sm_mode) {
-                    if (sm4_mode_map.count(mode_str) == 0) {
-                        StringOP::push_null_string(i, result_data, result_offset, null_map);
-                        continue;
-                    }
-                    encryption_mode = sm4_mode_map.at(mode_str);
-                } else {
-                    if (aes_mode_map.count(mode_str) == 0) {
-                        StringOP::push_null_string(i, result_data, result_offset, null_map);
-                        continue;
-                    }
-                    encryption_mode = aes_mode_map.at(mode_str);
+                std::string_view mode_str(mode_raw, mode_size);
+                if (!mode_found || mode_str != last_mode_str) {
+                    mode_found = true;
+                    last_mode_str = mode_str;
+                    last_mode = find_mode(std::string(mode_str));
                 }
+                if (!last_mode.has_value()) {
+                    write_null_result(i, result_data, result_size, result_offset, null_map);
+                    continue;
+                }
+                encryption_mode = *last_mode;
             }
 
-            exectue_result<Impl, is_encrypt>(offsets_list, chars_list, i, encryption_mode, iv_raw,
-                                             result_data, result_offset, null_map);
+            exectue_result<Impl>(cipher_ctx, offsets_list, chars_list, i, encryption_mode, iv_raw,
+                                 result_data, result_size, result_offset, null_map);
         }
         return Status::OK();
     }
+
+    static std::optional<EncryptionMode> find_mode(const std::string& mode_str) {
+        const auto& mode_map = is_sm_mode ? sm4_mode_map : aes_mode_map;
+        auto it = mode_map.find(mode_str);
+        if (it == mode_map.end()) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
 };
 
 struct EncryptImpl {
-    static int exectue_impl(EncryptionMode mode, const unsigned char* source,
-                            uint32_t source_length, const unsigned char* key, uint32_t key_length,
-                            const char* iv, bool padding, unsigned char* encrypt) {
-        return EncryptionUtil::encrypt(mode, source, source_length, key, key_length, iv, true,
-                                       encrypt);
+    static int exectue_impl(CipherContext* cipher_ctx, EncryptionMode mode,
+                            const unsigned char* source, uint32_t source_length,
+                            const unsigned char* key, uint32_t key_length, const char* iv,
+                            bool padding, unsigned char* encrypt) {
+        return EncryptionUtil::encrypt(cipher_ctx, mode, source, source_length, key, key_length,
+                                       iv, true, encrypt);
     }
 };
 
 struct DecryptImpl {
-    static int exectue_impl(EncryptionMode mode, const unsigned char* source,
-                            uint32_t source_length, const unsigned char* key, uint32_t key_length,
-                            const char* iv, bool padding, unsigned char* encrypt) {
-        return EncryptionUtil::decrypt(mode, source, source_length, key, key_length, iv, true,
-                                       encrypt);
+    static int exectue_impl(CipherContext* cipher_ctx, EncryptionMode mode,
+                            const unsigned char* source, uint32_t source_length,
+                            const unsigned char* key, uint32_t key_length, const char* iv,
+                            bool padding, unsigned char* encrypt) {
+        return EncryptionUtil::decrypt(cipher_ctx, mode, source, source_length, key, key_length,
+                                       iv, true, encrypt);
     }
 };
 
@@ -232,23 +281,22 @@ struct AESDecryptName {
 
 void register_function_encryption(SimpleFunctionFactory& factory) {
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptTwoImpl<EncryptImpl, SM4_128_ECB, true>, SM4EncryptName>>();
+            EncryptionAndDecryptTwoImpl<EncryptImpl, SM4_128_ECB>, SM4EncryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptTwoImpl<DecryptImpl, SM4_128_ECB, false>, SM4DecryptName>>();
+            EncryptionAndDecryptTwoImpl<DecryptImpl, SM4_128_ECB>, SM4DecryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptTwoImpl<EncryptImpl, AES_128_ECB, true>, AESEncryptName>>();
+            EncryptionAndDecryptTwoImpl<EncryptImpl, AES_128_ECB>, AESEncryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptTwoImpl<DecryptImpl, AES_128_ECB, false>, AESDecryptName>>();
+            EncryptionAndDecryptTwoImpl<DecryptImpl, AES_128_ECB>, AESDecryptName>>();
 
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptFourImpl<EncryptImpl, SM4_128_ECB, true, true>, SM4EncryptName>>();
+            EncryptionAndDecryptFourImpl<EncryptImpl, SM4_128_ECB, true>, SM4EncryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptFourImpl<DecryptImpl, SM4_128_ECB, false, true>, SM4DecryptName>>();
+            EncryptionAndDecryptFourImpl<DecryptImpl, SM4_128_ECB, true>, SM4DecryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptFourImpl<EncryptImpl, AES_128_ECB, true, false>, AESEncryptName>>();
+            EncryptionAndDecryptFourImpl<EncryptImpl, AES_128_ECB, false>, AESEncryptName>>();
     factory.register_function<FunctionEncryptionAndDecrypt<
-            EncryptionAndDecryptFourImpl<DecryptImpl, AES_128_ECB, false, false>,
-            AESDecryptName>>();
+            EncryptionAndDecryptFourImpl<DecryptImpl, AES_128_ECB, false>, AESDecryptName>>();
 }
 
 } // namespace doris::vectorized
@@ -155,11 +155,8 @@ Status JavaFunctionCall::execute(FunctionContext* context, Block& block,
         ColumnString::Chars& chars = const_cast<ColumnString::Chars&>(str_col->get_chars());       \
         ColumnString::Offsets& offsets =                                                           \
                 const_cast<ColumnString::Offsets&>(str_col->get_offsets());                        \
-        int increase_buffer_size = 0;                                                              \
-        int32_t buffer_size = JavaFunctionCall::IncreaseReservedBufferSize(increase_buffer_size);  \
-        chars.reserve(buffer_size);                                                                \
+        size_t buffer_size = jni_ctx->initial_reserved_buffer_size(num_rows);                      \
         chars.resize(buffer_size);                                                                 \
-        offsets.reserve(num_rows);                                                                 \
         offsets.resize(num_rows);                                                                  \
         *(jni_ctx->output_value_buffer) = reinterpret_cast<int64_t>(chars.data());                 \
         *(jni_ctx->output_offsets_ptr) = reinterpret_cast<int64_t>(offsets.data());                \
@@ -168,15 +165,18 @@ Status JavaFunctionCall::execute(FunctionContext* context, Block& block,
         env->CallNonvirtualVoidMethodA(jni_ctx->executor, executor_cl_, executor_evaluate_id_,     \
                                        nullptr);                                                   \
         while (jni_ctx->output_intermediate_state_ptr->row_idx < num_rows) {                       \
-            increase_buffer_size++;                                                                \
-            int32_t buffer_size =                                                                  \
-                    JavaFunctionCall::IncreaseReservedBufferSize(increase_buffer_size);            \
+            size_t rows = jni_ctx->output_intermediate_state_ptr->row_idx;                         \
+            buffer_size = JavaFunctionCall::next_reserved_buffer_size(                             \
+                    buffer_size, rows == 0 ? 0 : offsets[rows - 1], rows, num_rows);               \
             chars.resize(buffer_size);                                                             \
             *(jni_ctx->output_value_buffer) = reinterpret_cast<int64_t>(chars.data());             \
             jni_ctx->output_intermediate_state_ptr->buffer_size = buffer_size;                     \
             env->CallNonvirtualVoidMethodA(jni_ctx->executor, executor_cl_, executor_evaluate_id_, \
                                            nullptr);                                               \
         }                                                                                          \
+        RETURN_IF_ERROR(JniUtil::GetJniExceptionMsg(env));                                         \
+        chars.resize(num_rows == 0 ? 0 : offsets[num_rows - 1]);                                   \
+        jni_ctx->update_output_bytes_per_row(chars.size(), num_rows);                              \
     } else if (data_col->is_numeric()) {                                                           \
         data_col->reserve(num_rows);                                                               \
         data_col->resize(num_rows);                                                                \
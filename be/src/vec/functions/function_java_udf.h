@@ -20,6 +20,8 @@
 #ifdef LIBJVM
 #include <jni.h>
 
+#include <algorithm>
+
 #include "gen_cpp/Exprs_types.h"
 #include "util/jni-util.h"
 #include "vec/functions/function.h"
@@ -94,6 +96,9 @@ private:
         std::unique_ptr<int32_t> batch_size_ptr;
         // intermediate_state includes two parts: reserved / used buffer size and rows
         std::unique_ptr<IntermediateState> output_intermediate_state_ptr;
+        // the average bytes per row of the last string output, to reserve the output buffer of
+        // the next batch, so that the evaluation rarely needs to be resumed with a larger buffer
+        size_t output_bytes_per_row = 0;
 
         JniContext(int64_t num_args, JavaFunctionCall* parent) : parent(parent) {
             input_values_buffer_ptr.reset(new int64_t[num_args]);
@@ -119,15 +124,39 @@ private:
             env->DeleteGlobalRef(executor);
         }
 
+        size_t initial_reserved_buffer_size(size_t num_rows) const {
+            return JavaFunctionCall::initial_reserved_buffer_size(output_bytes_per_row, num_rows);
+        }
+
+        void update_output_bytes_per_row(size_t bytes, size_t num_rows) {
+            output_bytes_per_row =
+                    JavaFunctionCall::bytes_per_row(output_bytes_per_row, bytes, num_rows);
+        }
+
         /// These functions are cross-compiled to IR and used by codegen.
         static void SetInputNullsBufferElement(JniContext* jni_ctx, int index, uint8_t value);
         static uint8_t* GetInputValuesBufferAtOffset(JniContext* jni_ctx, int offset);
     };
 
     static const int32_t INITIAL_RESERVED_BUFFER_SIZE = 1024;
-    // TODO: we need a heuristic strategy to increase buffer size for variable-size output.
-    static inline int32_t IncreaseReservedBufferSize(int n) {
-        return INITIAL_RESERVED_BUFFER_SIZE << n;
+    static inline size_t initial_reserved_buffer_size(size_t bytes_per_row, size_t num_rows) {
+        return std::max<size_t>(INITIAL_RESERVED_BUFFER_SIZE, bytes_per_row * num_rows);
+    }
+    // The bytes per row of a batch of `bytes`, rounded up and 1/8 more for the variance between
+    // batches, or `last` if the batch is empty.
+    static inline size_t bytes_per_row(size_t last, size_t bytes, size_t num_rows) {
+        if (num_rows == 0) {
+            return last;
+        }
+        size_t result = (bytes + num_rows - 1) / num_rows;
+        return result + result / 8;
+    }
+    // The output buffer of `used` bytes is not enough for the rows after `rows`, estimate the
+    // buffer of all the rows by the average size of the rows written, and at least double it.
+    static inline size_t next_reserved_buffer_size(size_t buffer_size, size_t used, size_t rows,
+                                                   size_t num_rows) {
+        size_t estimated = rows == 0 ? 0 : used * num_rows / rows;
+        return std::max(buffer_size * 2, estimated + estimated / 8);
     }
 };
 
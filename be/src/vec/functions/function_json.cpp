@@ -20,9 +20,11 @@
 #include <rapidjson/writer.h>
 
 #include <boost/token_functions.hpp>
+#include <limits>
 #include <vector>
 
 #include "exprs/json_functions.h"
+#include "util/jsonb_document.h"
 #include "util/string_parser.hpp"
 #include "util/string_util.h"
 #include "vec/columns/column.h"
@@ -34,6 +36,7 @@
 #include "vec/data_types/data_type_string.h"
 #include "vec/functions/function_string.h"
 #include "vec/functions/function_totype.h"
+#include "vec/functions/simd_json_path.h"
 #include "vec/functions/simple_function_factory.h"
 #include "vec/utils/template_helpers.hpp"
 
@@ -186,23 +189,21 @@ rapidjson::Value* match_value(const std::vector<JsonPath>& parsed_paths, rapidjs
     return root;
 }
 
-template <JsonFunctionType fntype>
-rapidjson::Value* get_json_object(const std::string_view& json_string,
-                                  const std::string_view& path_string,
-                                  rapidjson::Document* document) {
-    std::vector<JsonPath>* parsed_paths;
-    std::vector<JsonPath> tmp_parsed_paths;
-
+void parse_json_path(const std::string_view& path_string, std::vector<JsonPath>* parsed_paths) {
     auto tok = get_json_token(path_string);
     std::vector<std::string> paths(tok.begin(), tok.end());
-    get_parsed_paths(paths, &tmp_parsed_paths);
-    parsed_paths = &tmp_parsed_paths;
+    get_parsed_paths(paths, parsed_paths);
+}
 
-    if (!(*parsed_paths)[0].is_valid) {
+template <JsonFunctionType fntype>
+rapidjson::Value* get_json_object(const std::string_view& json_string,
+                                  const std::vector<JsonPath>& parsed_paths,
+                                  rapidjson::Document* document) {
+    if (!parsed_paths[0].is_valid) {
         return document;
     }
 
-    if (UNLIKELY((*parsed_paths).size() == 1)) {
+    if (UNLIKELY(parsed_paths.size() == 1)) {
         if (fntype == JSON_FUN_STRING) {
             document->SetString(json_string.data(), document->GetAllocator());
         } else {
@@ -218,7 +219,58 @@ rapidjson::Value* get_json_object(const std::string_view& json_string,
         return document;
     }
 
-    return match_value(*parsed_paths, document, document->GetAllocator());
+    return match_value(parsed_paths, document, document->GetAllocator());
+}
+
+template <JsonFunctionType fntype>
+rapidjson::Value* get_json_object(const std::string_view& json_string,
+                                  const std::string_view& path_string,
+                                  rapidjson::Document* document) {
+    std::vector<JsonPath> parsed_paths;
+    parse_json_path(path_string, &parsed_paths);
+    return get_json_object<fntype>(json_string, parsed_paths, document);
+}
+
+// The state of a json function with a constant path, which is parsed once.
+struct JsonPathState {
+    std::vector<JsonPath> parsed_paths;
+    // set if the path is supported by simdjson
+    bool is_simd_path = false;
+    SimdJsonPath simd_path;
+};
+
+// Find the value of the constant path in each row by simdjson, and by rapidjson for the rows
+// and the paths simdjson doesn't handle. `on_simd(i, value)` takes the value found by simdjson
+// or returns false to leave it to rapidjson; `on_rapidjson(i, root)` takes the value found by
+// rapidjson, which is nullptr for the not found values and the null rows.
+template <JsonFunctionType fntype, typename OnSimd, typename OnRapidJson>
+void for_each_json_value(const ColumnString& jsons, const JsonPathState& state,
+                         const NullMap& null_map, OnSimd on_simd, OnRapidJson on_rapidjson) {
+    SimdJsonColumnParser* parser =
+            state.is_simd_path ? &SimdJsonColumnParser::parse(jsons) : nullptr;
+    for (size_t i = 0; i < jsons.size(); ++i) {
+        if (null_map[i]) {
+            on_rapidjson(i, nullptr);
+            continue;
+        }
+        if (parser != nullptr) {
+            if (const auto* root = parser->row(i)) {
+                simdjson::dom::element value;
+                auto result = state.simd_path.find(*root, &value);
+                if (result == SimdJsonPath::NOT_FOUND) {
+                    on_rapidjson(i, nullptr);
+                    continue;
+                }
+                if (result == SimdJsonPath::FOUND && on_simd(i, value)) {
+                    continue;
+                }
+            }
+        }
+        rapidjson::Document document;
+        auto json = jsons.get_data_at(i);
+        on_rapidjson(i, get_json_object<fntype>(std::string_view(json.data, json.size),
+                                                state.parsed_paths, &document));
+    }
 }
 
 template <typename NumberType>
@@ -261,6 +313,43 @@ struct GetJsonNumberType {
         }
     }
 
+    static void constant_path(const ColumnString& jsons, const JsonPathState& state,
+                              Container& res, NullMap& null_map) {
+        res.resize(jsons.size());
+        using T = typename NumberType::T;
+        for_each_json_value<JSON_FUN_DOUBLE>(
+                jsons, state, null_map,
+                [&](size_t i, simdjson::dom::element value) {
+                    handle_simd_result<T>(value, res[i], null_map[i]);
+                    return true;
+                },
+                [&](size_t i, rapidjson::Value* root) {
+                    handle_result<T>(root, res[i], null_map[i]);
+                });
+    }
+
+    // the same as handle_result(), rapidjson takes only the integers of int32 as int
+    template <typename T>
+    static void handle_simd_result(simdjson::dom::element value, T& res, uint8_t& res_null) {
+        using simdjson::dom::element_type;
+        int64_t int_value;
+        if ((value.type() == element_type::INT64 || value.type() == element_type::UINT64) &&
+            value.get_int64().get(int_value) == simdjson::SUCCESS &&
+            int_value >= std::numeric_limits<int32_t>::min() &&
+            int_value <= std::numeric_limits<int32_t>::max()) {
+            res = int_value;
+            return;
+        }
+        if constexpr (std::is_same_v<double, T>) {
+            if (value.type() == element_type::DOUBLE) {
+                res = value.get_double().value_unsafe();
+                return;
+            }
+        }
+        res = 0;
+        res_null = 1;
+    }
+
     template <typename T, std::enable_if_t<std::is_same_v<double, T>, T>* = nullptr>
     static void handle_result(rapidjson::Value* root, T& res, uint8_t& res_null) {
         if (root == nullptr || root->IsNull()) {
@@ -316,6 +405,74 @@ struct GetJsonString {
     using ColumnType = ColumnString;
     using Chars = ColumnString::Chars;
     using Offsets = ColumnString::Offsets;
+    static constexpr size_t max_string_len = 65535;
+
+    static void constant_path(const ColumnString& jsons, const JsonPathState& state,
+                              ColumnString& res, NullMap& null_map) {
+        auto& res_data = res.get_chars();
+        auto& res_offsets = res.get_offsets();
+        res_offsets.resize(jsons.size());
+        for_each_json_value<JSON_FUN_STRING>(
+                jsons, state, null_map,
+                [&](size_t i, simdjson::dom::element value) {
+                    return handle_simd_result(value, i, res_data, res_offsets, null_map);
+                },
+                [&](size_t i, rapidjson::Value* root) {
+                    handle_result(root, i, res_data, res_offsets, null_map);
+                });
+    }
+
+    // The same as handle_result(), the doubles, arrays and objects are left to rapidjson to
+    // keep the format of its writer.
+    static bool handle_simd_result(simdjson::dom::element value, size_t i, Chars& res_data,
+                                   Offsets& res_offsets, NullMap& null_map) {
+        using simdjson::dom::element_type;
+        switch (value.type()) {
+        case element_type::NULL_VALUE:
+            StringOP::push_null_string(i, res_data, res_offsets, null_map);
+            return true;
+        case element_type::STRING: {
+            std::string_view str = value.get_string().value_unsafe();
+            size_t len = strnlen(str.data(), std::min(str.size(), max_string_len));
+            StringOP::push_value_string(str.substr(0, len), i, res_data, res_offsets);
+            return true;
+        }
+        case element_type::BOOL:
+            StringOP::push_value_string(value.get_bool().value_unsafe() ? "true" : "false", i,
+                                        res_data, res_offsets);
+            return true;
+        case element_type::INT64:
+            StringOP::push_value_string(std::to_string(value.get_int64().value_unsafe()), i,
+                                        res_data, res_offsets);
+            return true;
+        case element_type::UINT64:
+            StringOP::push_value_string(std::to_string(value.get_uint64().value_unsafe()), i,
+                                        res_data, res_offsets);
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static void handle_result(rapidjson::Value* root, size_t i, Chars& res_data,
+                              Offsets& res_offsets, NullMap& null_map) {
+        if (root == nullptr || root->IsNull()) {
+            StringOP::push_null_string(i, res_data, res_offsets, null_map);
+        } else if (root->IsString()) {
+            const auto ptr = root->GetString();
+            size_t len = strnlen(ptr, max_string_len);
+            StringOP::push_value_string(std::string_view(ptr, len), i, res_data, res_offsets);
+        } else {
+            rapidjson::StringBuffer buf;
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+            root->Accept(writer);
+
+            const auto ptr = buf.GetString();
+            size_t len = strnlen(ptr, max_string_len);
+            StringOP::push_value_string(std::string_view(ptr, len), i, res_data, res_offsets);
+        }
+    }
+
     static void vector_vector(FunctionContext* context, const Chars& ldata, const Offsets& loffsets,
                               const Chars& rdata, const Offsets& roffsets, Chars& res_data,
                               Offsets& res_offsets, NullMap& null_map) {
@@ -341,23 +498,292 @@ struct GetJsonString {
             rapidjson::Value* root = nullptr;
 
             root = get_json_object<JSON_FUN_STRING>(json_string, path_string, &document);
-            const int max_string_len = 65535;
+            handle_result(root, i, res_data, res_offsets, null_map);
+        }
+    }
+};
+
+// Find the value of the path in a jsonb document in O(depth) by the keys and the indexes of the
+// path. The other paths, e.g. [*] and the keys on arrays, are evaluated by rapidjson on the
+// decoded document, as get_json_object() on the json text. `on_jsonb(value)` takes the value
+// found or returns false to leave it to rapidjson, `on_rapidjson(root)` takes the value found by
+// rapidjson, which is nullptr if not found.
+template <typename OnJsonb, typename OnRapidJson>
+void get_jsonb_value(const std::string_view& jsonb, const std::vector<JsonPath>& parsed_paths,
+                     OnJsonb on_jsonb, OnRapidJson on_rapidjson) {
+    JsonbValue root = JsonbValue::open(jsonb);
+    if (!root.is_valid() || parsed_paths.empty()) {
+        on_rapidjson(nullptr);
+        return;
+    }
+
+    JsonbValue value = root;
+    bool is_simple_path = parsed_paths.size() > 1 && parsed_paths[0].is_valid;
+    for (size_t i = 1; is_simple_path && i < parsed_paths.size(); ++i) {
+        const auto& path = parsed_paths[i];
+        if (!path.is_valid || path.idx == -2 ||
+            (!path.key.empty() && value.type() == JsonbValue::ARRAY)) {
+            is_simple_path = false;
+            break;
+        }
+        if (value.type() == JsonbValue::NULL_VALUE) {
+            on_rapidjson(nullptr);
+            return;
+        }
+        if (!path.key.empty()) {
+            value = value.find(path.key);
+        }
+        if (path.idx != -1) {
+            value = value.at(path.idx);
+        }
+        if (!value.is_valid()) {
+            on_rapidjson(nullptr);
+            return;
+        }
+    }
+
+    rapidjson::Document document;
+    if (is_simple_path) {
+        if (!on_jsonb(value)) {
+            on_rapidjson(value.to_rapidjson(&document, document.GetAllocator()) ? &document
+                                                                                 : nullptr);
+        }
+        return;
+    }
+    if (!root.to_rapidjson(&document, document.GetAllocator())) {
+        on_rapidjson(nullptr);
+    } else if (!parsed_paths[0].is_valid || parsed_paths.size() == 1) {
+        on_rapidjson(&document);
+    } else {
+        on_rapidjson(match_value(parsed_paths, &document, document.GetAllocator()));
+    }
+}
+
+template <typename NumberType>
+struct GetJsonbNumberType {
+    using T = typename NumberType::T;
+    using ColumnType = typename NumberType::ColumnType;
+    using Container = typename ColumnType::Container;
+
+    static void vector_vector(FunctionContext* context, const ColumnString::Chars& ldata,
+                              const ColumnString::Offsets& loffsets,
+                              const ColumnString::Chars& rdata,
+                              const ColumnString::Offsets& roffsets, Container& res,
+                              NullMap& null_map) {
+        size_t size = loffsets.size();
+        res.resize(size);
+        std::vector<JsonPath> parsed_paths;
+        for (size_t i = 0; i < size; ++i) {
+            if (null_map[i]) {
+                res[i] = 0;
+                continue;
+            }
+            std::string_view jsonb(reinterpret_cast<const char*>(&ldata[loffsets[i - 1]]),
+                                   loffsets[i] - loffsets[i - 1] - 1);
+            std::string_view path(reinterpret_cast<const char*>(&rdata[roffsets[i - 1]]),
+                                  roffsets[i] - roffsets[i - 1] - 1);
+            parsed_paths.clear();
+            parse_json_path(path, &parsed_paths);
+            get_row(jsonb, parsed_paths, res[i], null_map[i]);
+        }
+    }
+
+    static void constant_path(const ColumnString& jsonbs, const JsonPathState& state,
+                              Container& res, NullMap& null_map) {
+        res.resize(jsonbs.size());
+        for (size_t i = 0; i < jsonbs.size(); ++i) {
+            if (null_map[i]) {
+                res[i] = 0;
+                continue;
+            }
+            get_row(jsonbs.get_data_at(i).to_string_view(), state.parsed_paths, res[i],
+                    null_map[i]);
+        }
+    }
+
+    static void get_row(const std::string_view& jsonb, const std::vector<JsonPath>& parsed_paths,
+                        T& res, uint8_t& res_null) {
+        get_jsonb_value(
+                jsonb, parsed_paths,
+                [&](JsonbValue value) {
+                    handle_jsonb_result(value, res, res_null);
+                    return true;
+                },
+                [&](rapidjson::Value* root) {
+                    GetJsonNumberType<NumberType>::template handle_result<T>(root, res, res_null);
+                });
+    }
+
+    // the same as GetJsonNumberType::handle_result()
+    static void handle_jsonb_result(JsonbValue value, T& res, uint8_t& res_null) {
+        if (value.type() == JsonbValue::INT64 &&
+            value.get_int64() >= std::numeric_limits<int32_t>::min() &&
+            value.get_int64() <= std::numeric_limits<int32_t>::max()) {
+            res = value.get_int64();
+            return;
+        }
+        if constexpr (std::is_same_v<double, T>) {
+            if (value.type() == JsonbValue::DOUBLE) {
+                res = value.get_double();
+                return;
+            }
+        }
+        res = 0;
+        res_null = 1;
+    }
+};
+
+struct GetJsonbDouble : public GetJsonbNumberType<JsonNumberTypeDouble> {
+    static constexpr auto name = "get_jsonb_double";
+    using ReturnType = typename JsonNumberTypeDouble::ReturnType;
+    using ColumnType = typename JsonNumberTypeDouble::ColumnType;
+};
+
+struct GetJsonbInt : public GetJsonbNumberType<JsonNumberTypeInt> {
+    static constexpr auto name = "get_jsonb_int";
+    using ReturnType = typename JsonNumberTypeInt::ReturnType;
+    using ColumnType = typename JsonNumberTypeInt::ColumnType;
+};
+
+struct GetJsonbString {
+    static constexpr auto name = "get_jsonb_string";
+    using ReturnType = DataTypeString;
+    using ColumnType = ColumnString;
+    using Chars = ColumnString::Chars;
+    using Offsets = ColumnString::Offsets;
 
-            if (root == nullptr || root->IsNull()) {
+    static void vector_vector(FunctionContext* context, const Chars& ldata, const Offsets& loffsets,
+                              const Chars& rdata, const Offsets& roffsets, Chars& res_data,
+                              Offsets& res_offsets, NullMap& null_map) {
+        size_t size = loffsets.size();
+        res_offsets.resize(size);
+        std::vector<JsonPath> parsed_paths;
+        for (size_t i = 0; i < size; ++i) {
+            if (null_map[i]) {
+                StringOP::push_null_string(i, res_data, res_offsets, null_map);
+                continue;
+            }
+            std::string_view jsonb(reinterpret_cast<const char*>(&ldata[loffsets[i - 1]]),
+                                   loffsets[i] - loffsets[i - 1] - 1);
+            std::string_view path(reinterpret_cast<const char*>(&rdata[roffsets[i - 1]]),
+                                  roffsets[i] - roffsets[i - 1] - 1);
+            parsed_paths.clear();
+            parse_json_path(path, &parsed_paths);
+            get_row(jsonb, parsed_paths, i, res_data, res_offsets, null_map);
+        }
+    }
+
+    static void constant_path(const ColumnString& jsonbs, const JsonPathState& state,
+                              ColumnString& res, NullMap& null_map) {
+        auto& res_data = res.get_chars();
+        auto& res_offsets = res.get_offsets();
+        res_offsets.resize(jsonbs.size());
+        for (size_t i = 0; i < jsonbs.size(); ++i) {
+            if (null_map[i]) {
                 StringOP::push_null_string(i, res_data, res_offsets, null_map);
-            } else if (root->IsString()) {
-                const auto ptr = root->GetString();
-                size_t len = strnlen(ptr, max_string_len);
-                StringOP::push_value_string(std::string_view(ptr, len), i, res_data, res_offsets);
+                continue;
+            }
+            get_row(jsonbs.get_data_at(i).to_string_view(), state.parsed_paths, i, res_data,
+                    res_offsets, null_map);
+        }
+    }
+
+    static void get_row(const std::string_view& jsonb, const std::vector<JsonPath>& parsed_paths,
+                        size_t i, Chars& res_data, Offsets& res_offsets, NullMap& null_map) {
+        get_jsonb_value(
+                jsonb, parsed_paths,
+                [&](JsonbValue value) {
+                    return handle_jsonb_result(value, i, res_data, res_offsets, null_map);
+                },
+                [&](rapidjson::Value* root) {
+                    GetJsonString::handle_result(root, i, res_data, res_offsets, null_map);
+                });
+    }
+
+    // The same as GetJsonString::handle_result(), the doubles, arrays and objects are left to
+    // rapidjson to keep the format of its writer.
+    static bool handle_jsonb_result(JsonbValue value, size_t i, Chars& res_data,
+                                    Offsets& res_offsets, NullMap& null_map) {
+        switch (value.type()) {
+        case JsonbValue::NULL_VALUE:
+            StringOP::push_null_string(i, res_data, res_offsets, null_map);
+            return true;
+        case JsonbValue::STRING: {
+            std::string_view str = value.get_string();
+            size_t len = strnlen(str.data(), std::min(str.size(), GetJsonString::max_string_len));
+            StringOP::push_value_string(str.substr(0, len), i, res_data, res_offsets);
+            return true;
+        }
+        case JsonbValue::TRUE_VALUE:
+        case JsonbValue::FALSE_VALUE:
+            StringOP::push_value_string(value.type() == JsonbValue::TRUE_VALUE ? "true" : "false",
+                                        i, res_data, res_offsets);
+            return true;
+        case JsonbValue::INT64:
+            StringOP::push_value_string(std::to_string(value.get_int64()), i, res_data,
+                                        res_offsets);
+            return true;
+        case JsonbValue::UINT64:
+            StringOP::push_value_string(std::to_string(value.get_uint64()), i, res_data,
+                                        res_offsets);
+            return true;
+        default:
+            return false;
+        }
+    }
+};
+
+// jsonb_parse(json), NULL if the json is invalid
+struct JsonbParseImpl {
+    static constexpr auto name = "jsonb_parse";
+    using ReturnType = DataTypeString;
+    using ColumnType = ColumnString;
+
+    static void vector(const ColumnString::Chars& data, const ColumnString::Offsets& offsets,
+                       ColumnString::Chars& res_data, ColumnString::Offsets& res_offsets,
+                       NullMap& null_map) {
+        size_t size = offsets.size();
+        res_offsets.resize(size);
+        std::string jsonb;
+        for (size_t i = 0; i < size; ++i) {
+            const auto* json = reinterpret_cast<const char*>(&data[offsets[i - 1]]);
+            // the same as rapidjson parses the json text in get_json_xxx
+            size_t json_size = strnlen(json, offsets[i] - offsets[i - 1] - 1);
+            if (JsonbValue::encode(json, json_size, &jsonb)) {
+                StringOP::push_value_string(jsonb, i, res_data, res_offsets);
             } else {
-                rapidjson::StringBuffer buf;
-                rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
-                root->Accept(writer);
+                StringOP::push_null_string(i, res_data, res_offsets, null_map);
+            }
+        }
+    }
+};
 
-                const auto ptr = buf.GetString();
-                size_t len = strnlen(ptr, max_string_len);
-                StringOP::push_value_string(std::string_view(ptr, len), i, res_data, res_offsets);
+// jsonb_to_json(jsonb), NULL if it's not a jsonb document
+struct JsonbToJsonImpl {
+    static constexpr auto name = "jsonb_to_json";
+    using ReturnType = DataTypeString;
+    using ColumnType = ColumnString;
+
+    static void vector(const ColumnString::Chars& data, const ColumnString::Offsets& offsets,
+                       ColumnString::Chars& res_data, ColumnString::Offsets& res_offsets,
+                       NullMap& null_map) {
+        size_t size = offsets.size();
+        res_offsets.resize(size);
+        rapidjson::StringBuffer buf;
+        for (size_t i = 0; i < size; ++i) {
+            JsonbValue root = JsonbValue::open(
+                    std::string_view(reinterpret_cast<const char*>(&data[offsets[i - 1]]),
+                                     offsets[i] - offsets[i - 1] - 1));
+            rapidjson::Document document;
+            if (!root.is_valid() || !root.to_rapidjson(&document, document.GetAllocator())) {
+                StringOP::push_null_string(i, res_data, res_offsets, null_map);
+                continue;
             }
+            buf.Clear();
+            rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+            document.Accept(writer);
+            StringOP::push_value_string(std::string_view(buf.GetString(), buf.GetSize()), i,
+                                        res_data, res_offsets);
         }
     }
 };
@@ -563,14 +989,81 @@ public:
     }
 };
 
-using FunctionGetJsonDouble = FunctionBinaryStringOperateToNullType<GetJsonDouble>;
-using FunctionGetJsonInt = FunctionBinaryStringOperateToNullType<GetJsonInt>;
-using FunctionGetJsonString = FunctionBinaryStringOperateToNullType<GetJsonString>;
+// get_json_xxx(json, path), the constant path is parsed once in prepare.
+template <typename Impl>
+class FunctionGetJsonPath : public FunctionBinaryStringOperateToNullType<Impl> {
+public:
+    static FunctionPtr create() { return std::make_shared<FunctionGetJsonPath>(); }
+
+    Status prepare(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope != FunctionContext::THREAD_LOCAL || !context->is_col_constant(1)) {
+            return Status::OK();
+        }
+        const auto& path_column = context->get_constant_col(1)->column_ptr;
+        if (path_column->is_null_at(0)) {
+            return Status::OK();
+        }
+        auto* state = new JsonPathState();
+        context->set_function_state(scope, state);
+        parse_json_path(path_column->get_data_at(0).to_string_view(), &state->parsed_paths);
+        state->is_simd_path = state->simd_path.init(state->parsed_paths);
+        return Status::OK();
+    }
+
+    Status execute_impl(FunctionContext* context, Block& block, const ColumnNumbers& arguments,
+                        size_t result, size_t input_rows_count) override {
+        auto* state = reinterpret_cast<JsonPathState*>(
+                context->get_function_state(FunctionContext::THREAD_LOCAL));
+        if (state == nullptr || state->parsed_paths.empty()) {
+            return FunctionBinaryStringOperateToNullType<Impl>::execute_impl(
+                    context, block, arguments, result, input_rows_count);
+        }
+
+        auto null_map = ColumnUInt8::create(input_rows_count, 0);
+        ColumnPtr json_column =
+                block.get_by_position(arguments[0]).column->convert_to_full_column_if_const();
+        if (auto* nullable = check_and_get_column<ColumnNullable>(*json_column)) {
+            VectorizedUtils::update_null_map(null_map->get_data(), nullable->get_null_map_data());
+            json_column = nullable->get_nested_column_ptr();
+        }
+
+        auto res = Impl::ColumnType::create();
+        const auto& jsons = assert_cast<const ColumnString&>(*json_column);
+        if constexpr (std::is_same_v<typename Impl::ReturnType, DataTypeString>) {
+            Impl::constant_path(jsons, *state, *res, null_map->get_data());
+        } else {
+            Impl::constant_path(jsons, *state, res->get_data(), null_map->get_data());
+        }
+        block.get_by_position(result).column =
+                ColumnNullable::create(std::move(res), std::move(null_map));
+        return Status::OK();
+    }
+
+    Status close(FunctionContext* context, FunctionContext::FunctionStateScope scope) override {
+        if (scope == FunctionContext::THREAD_LOCAL) {
+            delete reinterpret_cast<JsonPathState*>(
+                    context->get_function_state(FunctionContext::THREAD_LOCAL));
+        }
+        return Status::OK();
+    }
+};
+
+using FunctionGetJsonDouble = FunctionGetJsonPath<GetJsonDouble>;
+using FunctionGetJsonInt = FunctionGetJsonPath<GetJsonInt>;
+using FunctionGetJsonString = FunctionGetJsonPath<GetJsonString>;
+using FunctionGetJsonbDouble = FunctionGetJsonPath<GetJsonbDouble>;
+using FunctionGetJsonbInt = FunctionGetJsonPath<GetJsonbInt>;
+using FunctionGetJsonbString = FunctionGetJsonPath<GetJsonbString>;
 
 void register_function_json(SimpleFunctionFactory& factory) {
     factory.register_function<FunctionGetJsonInt>();
     factory.register_function<FunctionGetJsonDouble>();
     factory.register_function<FunctionGetJsonString>();
+    factory.register_function<FunctionGetJsonbInt>();
+    factory.register_function<FunctionGetJsonbDouble>();
+    factory.register_function<FunctionGetJsonbString>();
+    factory.register_function<FunctionStringOperateToNullType<JsonbParseImpl>>();
+    factory.register_function<FunctionStringOperateToNullType<JsonbToJsonImpl>>();
 
     factory.register_function<FunctionJson<FunctionJsonImpl<FunctionJsonArrayImpl>>>();
     factory.register_function<FunctionJson<FunctionJsonImpl<FunctionJsonObjectImpl>>>();
@@ -28,6 +28,7 @@
 #include "util/simd/vstring_function.h"
 #include "util/url_coding.h"
 #include "vec/common/pod_array_fwd.h"
+#include "vec/common/string_searcher.h"
 #include "vec/functions/function_string_to_string.h"
 #include "vec/functions/function_totype.h"
 #include "vec/functions/simple_function_factory.h"
@@ -208,6 +209,26 @@ struct LocateOP {
     }
 };
 
+// instr(str, substr) of a constant substr, which is searched in all the rows at once
+static Status instr_constant_substr(const ColumnString::Chars& data,
+                                    const ColumnString::Offsets& offsets, const StringRef& substr,
+                                    PaddedPODArray<Int32>& res) {
+    res.resize(offsets.size());
+    if (substr.size == 0) {
+        std::fill(res.begin(), res.end(), 1);
+        return Status::OK();
+    }
+    std::fill(res.begin(), res.end(), 0);
+    StringSearcher searcher(std::string_view(substr.data, substr.size));
+    searcher.search_in_rows(data, offsets, [&](size_t row, size_t pos) {
+        // Hive returns the position of the chars starting from 1.
+        StringValue str_sv(reinterpret_cast<char*>(const_cast<uint8_t*>(&data[offsets[row - 1]])),
+                           offsets[row] - offsets[row - 1] - 1);
+        res[row] = (pos > 0 ? get_char_len(str_sv, pos) : 0) + 1;
+    });
+    return Status::OK();
+}
+
 // LeftDataType and RightDataType are DataTypeString
 template <typename LeftDataType, typename RightDataType, typename OP>
 struct StringFunctionImpl {
@@ -581,10 +602,21 @@ template <typename LeftDataType, typename RightDataType>
 using StringEndsWithImpl = StringFunctionImpl<LeftDataType, RightDataType, EndsWithOp>;
 
 template <typename LeftDataType, typename RightDataType>
-using StringInstrImpl = StringFunctionImpl<LeftDataType, RightDataType, InStrOP>;
+struct StringInstrImpl : public StringFunctionImpl<LeftDataType, RightDataType, InStrOP> {
+    static Status vector_scalar(const ColumnString::Chars& ldata,
+                                const ColumnString::Offsets& loffsets, const StringRef& rdata,
+                                PaddedPODArray<Int32>& res) {
+        return instr_constant_substr(ldata, loffsets, rdata, res);
+    }
+};
 
 template <typename LeftDataType, typename RightDataType>
-using StringLocateImpl = StringFunctionImpl<LeftDataType, RightDataType, LocateOP>;
+struct StringLocateImpl : public StringFunctionImpl<LeftDataType, RightDataType, LocateOP> {
+    static Status scalar_vector(const StringRef& ldata, const ColumnString::Chars& rdata,
+                                const ColumnString::Offsets& roffsets, PaddedPODArray<Int32>& res) {
+        return instr_constant_substr(rdata, roffsets, ldata, res);
+    }
+};
 
 template <typename LeftDataType, typename RightDataType>
 using StringFindInSetImpl = StringFunctionImpl<LeftDataType, RightDataType, FindInSetOp>;
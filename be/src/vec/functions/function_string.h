@@ -926,11 +926,13 @@ public:
 
 struct SM3Sum {
     static constexpr auto name = "sm3sum";
+    static constexpr size_t hex_length = 2 * SM3_DIGEST_LENGTH;
     using ObjectData = SM3Digest;
 };
 
 struct MD5Sum {
     static constexpr auto name = "md5sum";
+    static constexpr size_t hex_length = 2 * MD5_DIGEST_LENGTH;
     using ObjectData = Md5Digest;
 };
 
@@ -975,10 +977,15 @@ public:
         auto& res_data = res->get_chars();
         auto& res_offset = res->get_offsets();
 
+        // the digests have the same length, so the chars are sized once, and one digest object
+        // is reset for each row
         res_offset.resize(input_rows_count);
+        res_data.resize(input_rows_count * (Impl::hex_length + 1));
+        typename Impl::ObjectData digest;
         for (size_t i = 0; i < input_rows_count; ++i) {
-            using ObjectData = typename Impl::ObjectData;
-            ObjectData digest;
+            if (i > 0) {
+                digest.reset();
+            }
             for (size_t j = 0; j < offsets_list.size(); ++j) {
                 auto& current_offsets = *offsets_list[j];
                 auto& current_chars = *chars_list[j];
@@ -991,8 +998,11 @@ public:
             }
             digest.digest();
 
-            StringOP::push_value_string(std::string_view(digest.hex().c_str(), digest.hex().size()),
-                                        i, res_data, res_offset);
+            DCHECK_EQ(digest.hex().size(), Impl::hex_length);
+            size_t offset = i * (Impl::hex_length + 1);
+            memcpy(&res_data[offset], digest.hex().data(), Impl::hex_length);
+            res_data[offset + Impl::hex_length] = '\0';
+            res_offset[i] = offset + Impl::hex_length + 1;
         }
 
         block.replace_by_position(result, std::move(res));
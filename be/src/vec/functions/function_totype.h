@@ -125,6 +125,20 @@ private:
     }
 };
 
+// Whether a string Impl of FunctionBinaryToType handles a constant right argument by
+// vector_scalar(), or a constant left argument by scalar_vector().
+template <typename Impl, typename = void>
+struct HasStringVectorScalar : std::false_type {};
+template <typename Impl>
+struct HasStringVectorScalar<Impl, std::void_t<decltype(&Impl::vector_scalar)>>
+        : std::true_type {};
+
+template <typename Impl, typename = void>
+struct HasStringScalarVector : std::false_type {};
+template <typename Impl>
+struct HasStringScalarVector<Impl, std::void_t<decltype(&Impl::scalar_vector)>>
+        : std::true_type {};
+
 template <typename LeftDataType, typename RightDataType,
           template <typename, typename> typename Impl, typename Name>
 class FunctionBinaryToType : public IFunction {
@@ -221,9 +235,6 @@ private:
                       nullptr>
     Status execute_inner_impl(const ColumnWithTypeAndName& left, const ColumnWithTypeAndName& right,
                               Block& block, const ColumnNumbers& arguments, size_t result) {
-        auto lcol = left.column->convert_to_full_column_if_const();
-        auto rcol = right.column->convert_to_full_column_if_const();
-
         using ResultType = typename ResultDataType::FieldType;
         using ColVecResult = ColumnVector<ResultType>;
         typename ColVecResult::MutablePtr col_res = ColVecResult::create();
@@ -231,6 +242,34 @@ private:
         auto& vec_res = col_res->get_data();
         vec_res.resize(block.rows());
 
+        // a constant argument of the Impls handling it is not expanded to all the rows
+        using ImplType = Impl<LeftDataType, RightDataType>;
+        if constexpr (HasStringVectorScalar<ImplType>::value) {
+            if (is_column_const(*right.column) && !is_column_const(*left.column)) {
+                if (auto col_left = check_and_get_column<ColVecLeft>(left.column.get())) {
+                    RETURN_IF_ERROR(ImplType::vector_scalar(col_left->get_chars(),
+                                                            col_left->get_offsets(),
+                                                            right.column->get_data_at(0), vec_res));
+                    block.replace_by_position(result, std::move(col_res));
+                    return Status::OK();
+                }
+            }
+        }
+        if constexpr (HasStringScalarVector<ImplType>::value) {
+            if (is_column_const(*left.column) && !is_column_const(*right.column)) {
+                if (auto col_right = check_and_get_column<ColVecRight>(right.column.get())) {
+                    RETURN_IF_ERROR(ImplType::scalar_vector(left.column->get_data_at(0),
+                                                            col_right->get_chars(),
+                                                            col_right->get_offsets(), vec_res));
+                    block.replace_by_position(result, std::move(col_res));
+                    return Status::OK();
+                }
+            }
+        }
+
+        auto lcol = left.column->convert_to_full_column_if_const();
+        auto rcol = right.column->convert_to_full_column_if_const();
+
         if (auto col_left = check_and_get_column<ColVecLeft>(lcol.get())) {
             if (auto col_right = check_and_get_column<ColVecRight>(rcol.get())) {
                 Impl<LeftDataType, RightDataType>::vector_vector(
@@ -21,6 +21,8 @@
 #include "geo/geo_types.h"
 #include "gutil/strings/substitute.h"
 #include "vec/columns/column_const.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
 #include "vec/functions/simple_function_factory.h"
 
 namespace doris::vectorized {
@@ -195,12 +197,16 @@ struct StDistanceSphere {
         auto null_type = std::reinterpret_pointer_cast<const DataTypeNullable>(return_type);
         res = ColumnNullable::create(return_type->create_column(), ColumnUInt8::create());
 
+        // the coordinates are read from the columns directly, not through a Field per value
+        const auto& x_lng_data = assert_cast<const ColumnFloat64&>(*x_lng).get_data();
+        const auto& x_lat_data = assert_cast<const ColumnFloat64&>(*x_lat).get_data();
+        const auto& y_lng_data = assert_cast<const ColumnFloat64&>(*y_lng).get_data();
+        const auto& y_lat_data = assert_cast<const ColumnFloat64&>(*y_lat).get_data();
+        res->reserve(size);
         for (int row = 0; row < size; ++row) {
             double distance = 0;
-            if (!GeoPoint::ComputeDistance(x_lng->operator[](row).get<Float64>(),
-                                           x_lat->operator[](row).get<Float64>(),
-                                           y_lng->operator[](row).get<Float64>(),
-                                           y_lat->operator[](row).get<Float64>(), &distance)) {
+            if (!GeoPoint::ComputeDistance(x_lng_data[row], x_lat_data[row], y_lng_data[row],
+                                           y_lat_data[row], &distance)) {
                 res->insert_data(nullptr, 0);
                 continue;
             }
@@ -377,6 +383,9 @@ struct StContains {
                             std::shared_ptr<GeoShape>(GeoShape::from_encoded(str->ptr, str->len));
                     if (contains_ctx->shapes[i] == nullptr) {
                         contains_ctx->is_null = true;
+                    } else if (i == 0 && contains_ctx->shapes[i]->type() == GEO_SHAPE_POLYGON) {
+                        // the constant polygon is tested against the points of all the rows
+                        static_cast<GeoPolygon*>(contains_ctx->shapes[i].get())->build_covering();
                     }
                 }
             }
@@ -109,11 +109,16 @@ public:
         auto materialized_column = left_arg.column->convert_to_full_column_if_const();
 
         if (in_state->use_set) {
+            const IColumn* column = materialized_column.get();
+            const uint8_t* null_map = nullptr;
+            if (auto* nullable = check_and_get_column<ColumnNullable>(*column)) {
+                column = &nullable->get_nested_column();
+                null_map = nullable->get_null_map_data().data();
+            }
+            in_state->hybrid_set->find_batch(*column, null_map, vec_res.data());
             for (size_t i = 0; i < input_rows_count; ++i) {
-                const auto& ref_data = materialized_column->get_data_at(i);
-                if (ref_data.data) {
-                    vec_res[i] = negative ^
-                                 in_state->hybrid_set->find((void*)ref_data.data, ref_data.size);
+                if (null_map == nullptr || !null_map[i]) {
+                    vec_res[i] = negative ^ vec_res[i];
                     if (in_state->null_in_set) {
                         vec_null_map_to[i] = negative == vec_res[i];
                     } else {
@@ -82,6 +82,33 @@ Status FunctionLikeBase::constant_substring_fn(LikeSearchState* state, const Str
     return Status::OK();
 }
 
+Status FunctionLikeBase::constant_substring_vector_fn(LikeSearchState* state,
+                                                      const ColumnString& values,
+                                                      ColumnUInt8::Container& result) {
+    if (state->search_string_sv.len == 0) {
+        std::fill(result.begin(), result.end(), 1);
+        return Status::OK();
+    }
+    std::fill(result.begin(), result.end(), 0);
+    state->substring_searcher.search_in_rows(values.get_chars(), values.get_offsets(),
+                                             [&](size_t row, size_t /*pos*/) { result[row] = 1; });
+    return Status::OK();
+}
+
+Status FunctionLikeBase::constant_regex_vector_fn(LikeSearchState* state,
+                                                  const ColumnString& values,
+                                                  ColumnUInt8::Container& result) {
+    return state->regex_matcher->match_rows(values, result);
+}
+
+Status FunctionLikeBase::prepare_regex_matcher(LikeState* state, const std::string& regex) {
+#ifdef DORIS_WITH_HYPERSCAN
+    RETURN_IF_ERROR(MultiRegexMatcher::create({regex}, &state->search_state.regex_matcher));
+    state->vector_function = constant_regex_vector_fn;
+#endif
+    return Status::OK();
+}
+
 Status FunctionLikeBase::execute_impl(FunctionContext* context, Block& block,
                                       const ColumnNumbers& arguments, size_t result,
                                       size_t /*input_rows_count*/) {
@@ -106,6 +133,12 @@ Status FunctionLikeBase::execute_impl(FunctionContext* context, Block& block,
     auto* state = reinterpret_cast<LikeState*>(
             context->get_function_state(FunctionContext::THREAD_LOCAL));
 
+    if (state->vector_function != nullptr) {
+        RETURN_IF_ERROR(state->vector_function(&state->search_state, *values, vec_res));
+        block.replace_by_position(result, std::move(res));
+        return Status::OK();
+    }
+
     vector_vector(values->get_chars(), values->get_offsets(), patterns->get_chars(),
                   patterns->get_offsets(), vec_res, state->function, &state->search_state);
 
@@ -194,6 +227,13 @@ void FunctionLike::convert_like_pattern(LikeSearchState* state, const std::strin
     }
 }
 
+std::string FunctionLike::like_pattern_to_regex(const std::string& pattern) {
+    LikeSearchState state;
+    std::string re_pattern;
+    convert_like_pattern(&state, pattern, &re_pattern);
+    return "\\A(?:" + re_pattern + ")\\z";
+}
+
 void FunctionLike::remove_escape_character(std::string* search_string) {
     std::string tmp_search_string;
     tmp_search_string.swap(*search_string);
@@ -239,6 +279,7 @@ Status FunctionLike::prepare(FunctionContext* context, FunctionContext::Function
             remove_escape_character(&search_string);
             state->search_state.set_search_string(search_string);
             state->function = constant_substring_fn;
+            state->vector_function = constant_substring_vector_fn;
         } else {
             std::string re_pattern;
             convert_like_pattern(&state->search_state, pattern_str, &re_pattern);
@@ -251,6 +292,7 @@ Status FunctionLike::prepare(FunctionContext* context, FunctionContext::Function
                         fmt::format("Invalid regex expression: {}", pattern_str));
             }
             state->function = constant_regex_full_fn;
+            RETURN_IF_ERROR(prepare_regex_matcher(state, like_pattern_to_regex(pattern_str)));
         }
     }
     return Status::OK();
@@ -282,6 +324,7 @@ Status FunctionRegexp::prepare(FunctionContext* context,
         } else if (RE2::FullMatch(pattern_str, SUBSTRING_RE, &search_string)) {
             state->search_state.set_search_string(search_string);
             state->function = constant_substring_fn;
+            state->vector_function = constant_substring_vector_fn;
         } else {
             RE2::Options opts;
             opts.set_never_nl(false);
@@ -292,6 +335,7 @@ Status FunctionRegexp::prepare(FunctionContext* context,
                         fmt::format("Invalid regex expression: {}", pattern_str));
             }
             state->function = constant_regex_partial_fn;
+            RETURN_IF_ERROR(prepare_regex_matcher(state, pattern_str));
         }
     }
     return Status::OK();
@@ -319,4 +363,12 @@ Status FunctionRegexp::regexp_fn(LikeSearchState* state, const StringValue& val,
     }
 }
 
+void register_function_like(SimpleFunctionFactory& factory) {
+    factory.register_function<FunctionLike>();
+}
+
+void register_function_regexp(SimpleFunctionFactory& factory) {
+    factory.register_function<FunctionRegexp>();
+}
+
 } // namespace doris::vectorized
@@ -23,12 +23,15 @@
 #include "runtime/string_search.hpp"
 #include "runtime/string_value.h"
 #include "vec/columns/column_const.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_set.h"
 #include "vec/columns/columns_number.h"
+#include "vec/common/string_searcher.h"
 #include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_number.h"
 #include "vec/exprs/vexpr.h"
 #include "vec/functions/function.h"
+#include "vec/functions/multi_regex_matcher.h"
 #include "vec/functions/simple_function_factory.h"
 
 namespace doris::vectorized {
@@ -53,24 +56,37 @@ struct LikeSearchState {
     /// in the value.
     doris::StringSearch substring_pattern;
 
+    /// The same as substring_pattern, to search all the rows of a block at once.
+    StringSearcher substring_searcher;
+
     /// Used for RLIKE and REGEXP predicates if the pattern is a constant argument.
     std::unique_ptr<re2::RE2> regex;
 
+    /// The same as regex, to match all the rows of a block by hyperscan.
+    std::shared_ptr<const MultiRegexMatcher> regex_matcher;
+
     LikeSearchState() : escape_char('\\') {}
 
     void set_search_string(const std::string& search_string_arg) {
         search_string = search_string_arg;
         search_string_sv = StringValue(search_string);
         substring_pattern = StringSearch(&search_string_sv);
+        substring_searcher = StringSearcher(search_string);
     }
 };
 
 using LikeFn = std::function<doris::Status(LikeSearchState* state, const StringValue&,
                                            const StringValue&, unsigned char*)>;
 
+// Evaluate a constant pattern on all the rows of a block at once.
+using LikeVectorFn = doris::Status (*)(LikeSearchState* state, const ColumnString& values,
+                                       ColumnUInt8::Container& result);
+
 struct LikeState {
     LikeSearchState search_state;
     LikeFn function;
+    // used instead of `function` if it's not null
+    LikeVectorFn vector_function = nullptr;
 };
 
 class FunctionLikeBase : public IFunction {
@@ -105,6 +121,16 @@ protected:
 
     static Status constant_substring_fn(LikeSearchState* state, const StringValue& val,
                                         const StringValue& pattern, unsigned char* result);
+
+    static Status constant_substring_vector_fn(LikeSearchState* state, const ColumnString& values,
+                                               ColumnUInt8::Container& result);
+
+    static Status constant_regex_vector_fn(LikeSearchState* state, const ColumnString& values,
+                                           ColumnUInt8::Container& result);
+
+    // Match the rows by `regex_matcher` instead of `regex` if Doris is built with hyperscan,
+    // RE2 is as fast for a single regex.
+    static Status prepare_regex_matcher(LikeState* state, const std::string& regex);
 };
 
 class FunctionLike : public FunctionLikeBase {
@@ -117,6 +143,9 @@ public:
 
     Status prepare(FunctionContext* context, FunctionContext::FunctionStateScope scope) override;
 
+    // The regex to match the whole string by the like pattern, anchored by \A and \z.
+    static std::string like_pattern_to_regex(const std::string& pattern);
+
 private:
     static Status like_fn(LikeSearchState* state, const StringValue& val,
                           const StringValue& pattern, unsigned char* result);
@@ -148,11 +177,4 @@ private:
                                             const StringValue& pattern, unsigned char* result);
 };
 
-void register_function_like(SimpleFunctionFactory& factory) {
-    factory.register_function<FunctionLike>();
-}
-
-void register_function_regexp(SimpleFunctionFactory& factory) {
-    factory.register_function<FunctionRegexp>();
-}
 } // namespace doris::vectorized
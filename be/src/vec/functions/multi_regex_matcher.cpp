@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/functions/multi_regex_matcher.h"
+
+#include <fmt/format.h>
+
+#include "common/logging.h"
+
+namespace doris::vectorized {
+
+#ifdef DORIS_WITH_HYPERSCAN
+namespace {
+
+// The scratch space of hyperscan is per thread, it grows to fit all the databases scanned by
+// the thread.
+struct ThreadScratch {
+    ~ThreadScratch() {
+        if (scratch != nullptr) {
+            hs_free_scratch(scratch);
+        }
+    }
+    hs_scratch_t* scratch = nullptr;
+};
+
+thread_local ThreadScratch tls_scratch;
+
+int on_match(unsigned int /*id*/, unsigned long long /*from*/, unsigned long long /*to*/,
+             unsigned int /*flags*/, void* context) {
+    *static_cast<bool*>(context) = true;
+    // stop the scan on the first match
+    return 1;
+}
+
+} // namespace
+#endif
+
+MultiRegexMatcher::~MultiRegexMatcher() {
+#ifdef DORIS_WITH_HYPERSCAN
+    if (_database != nullptr) {
+        hs_free_database(_database);
+    }
+#endif
+}
+
+Status MultiRegexMatcher::create(const std::vector<std::string>& regexes,
+                                 std::shared_ptr<const MultiRegexMatcher>* matcher) {
+    std::shared_ptr<MultiRegexMatcher> res(new MultiRegexMatcher());
+
+#ifdef DORIS_WITH_HYPERSCAN
+    std::vector<const char*> expressions;
+    std::vector<unsigned int> flags;
+    std::vector<unsigned int> ids;
+    for (size_t i = 0; i < regexes.size(); ++i) {
+        expressions.push_back(regexes[i].c_str());
+        // the same as the RE2 options of like and regexp: UTF-8, and '.' matches new lines
+        flags.push_back(HS_FLAG_DOTALL | HS_FLAG_SINGLEMATCH | HS_FLAG_ALLOWEMPTY | HS_FLAG_UTF8);
+        ids.push_back(i);
+    }
+    hs_compile_error_t* compile_error = nullptr;
+    if (hs_compile_multi(expressions.data(), flags.data(), ids.data(), expressions.size(),
+                         HS_MODE_BLOCK, nullptr, &res->_database, &compile_error) == HS_SUCCESS) {
+        *matcher = std::move(res);
+        return Status::OK();
+    }
+    // fall back to RE2 for the syntax not supported by hyperscan, e.g. the \C and \pN of RE2
+    if (compile_error != nullptr) {
+        LOG(INFO) << "hyperscan failed to compile the regexes: " << compile_error->message;
+        hs_free_compile_error(compile_error);
+    }
+    res->_database = nullptr;
+#endif
+
+    RE2::Options opts;
+    opts.set_never_nl(false);
+    opts.set_dot_nl(true);
+    opts.set_log_errors(false);
+    res->_set = std::make_unique<re2::RE2::Set>(opts, RE2::UNANCHORED);
+    for (const auto& regex : regexes) {
+        std::string error;
+        if (res->_set->Add(regex, &error) < 0) {
+            return Status::InternalError(
+                    fmt::format("Invalid regex expression: {}, {}", regex, error));
+        }
+    }
+    if (!res->_set->Compile()) {
+        return Status::InternalError("Failed to compile the regex expressions, out of memory");
+    }
+    *matcher = std::move(res);
+    return Status::OK();
+}
+
+Status MultiRegexMatcher::match_rows(const ColumnString& values,
+                                     ColumnUInt8::Container& result) const {
+    const auto& chars = values.get_chars();
+    const auto& offsets = values.get_offsets();
+    const size_t rows = offsets.size();
+
+#ifdef DORIS_WITH_HYPERSCAN
+    if (_database != nullptr) {
+        if (hs_alloc_scratch(_database, &tls_scratch.scratch) != HS_SUCCESS) {
+            return Status::InternalError("Failed to allocate the hyperscan scratch");
+        }
+        for (size_t i = 0; i < rows; ++i) {
+            bool matched = false;
+            auto err = hs_scan(_database,
+                               reinterpret_cast<const char*>(chars.data() + offsets[i - 1]),
+                               offsets[i] - offsets[i - 1] - 1, 0, tls_scratch.scratch, on_match,
+                               &matched);
+            if (err != HS_SUCCESS && err != HS_SCAN_TERMINATED) {
+                return Status::InternalError(fmt::format("hyperscan failed to scan: {}", err));
+            }
+            result[i] = matched;
+        }
+        return Status::OK();
+    }
+#endif
+
+    for (size_t i = 0; i < rows; ++i) {
+        re2::StringPiece value(reinterpret_cast<const char*>(chars.data() + offsets[i - 1]),
+                               offsets[i] - offsets[i - 1] - 1);
+        result[i] = _set->Match(value, nullptr);
+    }
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,60 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <re2/set.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+
+#ifdef DORIS_WITH_HYPERSCAN
+#include <hs/hs.h>
+#endif
+
+namespace doris::vectorized {
+
+// Match the strings against a set of regexes in one pass, a string matches if any of the regexes
+// is found in it, so a regex to match the whole string should be anchored by \A and \z.
+// Hyperscan is used if Doris is built with WITH_HYPERSCAN and the regexes are supported by it,
+// otherwise RE2::Set. The matcher is immutable once created, so it can be shared by the threads.
+class MultiRegexMatcher {
+public:
+    ~MultiRegexMatcher();
+
+    static Status create(const std::vector<std::string>& regexes,
+                         std::shared_ptr<const MultiRegexMatcher>* matcher);
+
+    // result[i] is whether the row i of values matches
+    Status match_rows(const ColumnString& values, ColumnUInt8::Container& result) const;
+
+private:
+    MultiRegexMatcher() = default;
+
+#ifdef DORIS_WITH_HYPERSCAN
+    hs_database_t* _database = nullptr;
+#endif
+    std::unique_ptr<re2::RE2::Set> _set;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,122 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/functions/simd_json_path.h"
+
+#include <cstring>
+
+#include "common/config.h"
+#include "util/hash_util.hpp"
+
+namespace doris::vectorized {
+
+bool SimdJsonPath::init(const std::vector<JsonPath>& parsed_paths) {
+    if (parsed_paths.size() < 2 || !parsed_paths[0].is_valid || parsed_paths[0].key != "$") {
+        return false;
+    }
+    for (size_t i = 1; i < parsed_paths.size(); ++i) {
+        if (!parsed_paths[i].is_valid || parsed_paths[i].idx == -2) {
+            return false;
+        }
+    }
+    _legs.assign(parsed_paths.begin() + 1, parsed_paths.end());
+    return true;
+}
+
+// the same as match_value() of rapidjson in function_json.cpp
+SimdJsonPath::Result SimdJsonPath::find(simdjson::dom::element root,
+                                        simdjson::dom::element* value) const {
+    for (const auto& leg : _legs) {
+        if (root.is_null()) {
+            return NOT_FOUND;
+        }
+        if (!leg.key.empty()) {
+            if (root.is_array()) {
+                return UNSUPPORTED;
+            }
+            if (!root.is_object() || root.at_key(leg.key).get(root) != simdjson::SUCCESS) {
+                return NOT_FOUND;
+            }
+        }
+        if (leg.idx != -1) {
+            simdjson::dom::array array;
+            if (root.get_array().get(array) != simdjson::SUCCESS ||
+                array.at(leg.idx).get(root) != simdjson::SUCCESS) {
+                return NOT_FOUND;
+            }
+        }
+    }
+    *value = root;
+    return FOUND;
+}
+
+SimdJsonColumnParser& SimdJsonColumnParser::parse(const ColumnString& column) {
+    static thread_local SimdJsonColumnParser parser;
+    const auto& chars = column.get_chars();
+    const auto& offsets = column.get_offsets();
+    const size_t rows = column.size();
+
+    if (chars.size() > config::json_parse_cache_max_bytes) {
+        parser._column = &column;
+        parser._is_kept = false;
+        parser._documents.resize(1);
+        parser._roots.resize(1);
+        parser._valid.resize(1);
+        return parser;
+    }
+
+    uint64_t hash = HashUtil::hash64(chars.data(), chars.size(), 0);
+    hash = HashUtil::hash64(offsets.data(), offsets.size() * sizeof(offsets[0]), hash);
+    if (parser._is_kept && parser._column == &column && parser._rows == rows &&
+        parser._bytes == chars.size() && parser._hash == hash) {
+        return parser;
+    }
+
+    parser._column = &column;
+    parser._is_kept = true;
+    parser._rows = rows;
+    parser._bytes = chars.size();
+    parser._hash = hash;
+    parser._documents.resize(rows);
+    parser._roots.resize(rows);
+    parser._valid.resize(rows);
+    for (size_t i = 0; i < rows; ++i) {
+        parser._valid[i] = parser._parse_row(i, &parser._documents[i], &parser._roots[i]);
+    }
+    return parser;
+}
+
+const simdjson::dom::element* SimdJsonColumnParser::row(size_t i) {
+    if (_is_kept) {
+        return _valid[i] ? &_roots[i] : nullptr;
+    }
+    return _parse_row(i, &_documents[0], &_roots[0]) ? &_roots[0] : nullptr;
+}
+
+bool SimdJsonColumnParser::_parse_row(size_t i, simdjson::dom::document* document,
+                                      simdjson::dom::element* root) {
+    const auto& offsets = _column->get_offsets();
+    const char* data = reinterpret_cast<const char*>(_column->get_chars().data()) + offsets[i - 1];
+    // rapidjson parses the json as a c string, which ends at the first '\0'
+    size_t size = strnlen(data, offsets[i] - offsets[i - 1] - 1);
+    // the row is copied to a padded buffer by simdjson
+    return _parser.parse_into_document(*document, reinterpret_cast<const uint8_t*>(data), size)
+                   .get(*root) == simdjson::SUCCESS;
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <simdjson.h>
+
+#include <string>
+#include <vector>
+
+#include "exprs/json_functions.h"
+#include "vec/columns/column_string.h"
+
+namespace doris::vectorized {
+
+// A constant json path compiled once for the documents parsed by simdjson. Only the paths of
+// object keys and array indexes are supported, the others, e.g. [*] and the keys on arrays which
+// collect the values of all the elements, are left to rapidjson.
+class SimdJsonPath {
+public:
+    enum Result { FOUND, NOT_FOUND, UNSUPPORTED };
+
+    // Return false if the path is not supported.
+    bool init(const std::vector<JsonPath>& parsed_paths);
+
+    // Find the value of the path in the document, UNSUPPORTED if it's left to rapidjson.
+    Result find(simdjson::dom::element root, simdjson::dom::element* value) const;
+
+private:
+    // the parsed paths after the root "$"
+    std::vector<JsonPath> _legs;
+};
+
+// The rows of a json column parsed by simdjson. The last column parsed by a thread is kept, so
+// the json functions on the same column, e.g. to extract several paths, parse it only once.
+// The columns larger than json_parse_cache_max_bytes are parsed row by row and not kept.
+class SimdJsonColumnParser {
+public:
+    // The parser of the thread for `column`, valid until the next call of the thread.
+    static SimdJsonColumnParser& parse(const ColumnString& column);
+
+    // The root of the row, nullptr if it's not parsed by simdjson, e.g. an invalid json, which
+    // is left to rapidjson. The rows must be visited in order if the column is not kept.
+    const simdjson::dom::element* row(size_t i);
+
+private:
+    bool _parse_row(size_t i, simdjson::dom::document* document, simdjson::dom::element* root);
+
+    const ColumnString* _column = nullptr;
+    // the column kept is identified by its address, size and the hash of its data
+    bool _is_kept = false;
+    size_t _rows = 0;
+    size_t _bytes = 0;
+    uint64_t _hash = 0;
+
+    simdjson::dom::parser _parser;
+    std::vector<simdjson::dom::document> _documents;
+    std::vector<simdjson::dom::element> _roots;
+    std::vector<uint8_t> _valid;
+};
+
+} // namespace doris::vectorized
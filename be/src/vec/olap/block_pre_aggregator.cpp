@@ -0,0 +1,138 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/olap/block_pre_aggregator.h"
+
+namespace doris::vectorized {
+
+BlockPreAggregator::BlockPreAggregator(std::vector<int> group_by_columns,
+                                       std::vector<AggregateFunctionPtr> agg_functions)
+        : _group_by_columns(std::move(group_by_columns)),
+          _agg_functions(std::move(agg_functions)),
+          _agg_places(_agg_functions.size(), nullptr) {
+    for (size_t i = 0; i < _agg_functions.size(); ++i) {
+        if (_agg_functions[i] != nullptr) {
+            _agg_places[i] = new char[_agg_functions[i]->size_of_data()];
+            _agg_functions[i]->create(_agg_places[i]);
+        }
+    }
+}
+
+BlockPreAggregator::~BlockPreAggregator() {
+    for (size_t i = 0; i < _agg_functions.size(); ++i) {
+        if (_agg_places[i] != nullptr) {
+            _agg_functions[i]->destroy(_agg_places[i]);
+            delete[] _agg_places[i];
+        }
+    }
+}
+
+void BlockPreAggregator::aggregate(Block* block, bool eos) {
+    DCHECK_EQ(block->columns(), _agg_functions.size());
+    size_t rows = block->rows();
+    Columns columns = block->get_columns();
+    MutableColumns result_columns = block->clone_empty_columns();
+
+    if (rows > 0) {
+        if (!_open_row.empty() && !_is_open_group(columns, 0)) {
+            _close_group(result_columns);
+        }
+        if (_open_row.empty()) {
+            _open_group(columns, 0);
+        } else {
+            ++_merged_rows;
+        }
+        // the rows [begin, row) of the block are in the open group
+        size_t begin = 0;
+        for (size_t row = 1; row < rows; ++row) {
+            if (_is_same_group(columns, row - 1, row)) {
+                ++_merged_rows;
+                continue;
+            }
+            _add_rows(columns, begin, row);
+            _close_group(result_columns);
+            _open_group(columns, row);
+            begin = row;
+        }
+        _add_rows(columns, begin, rows);
+    }
+    if (eos && !_open_row.empty()) {
+        _close_group(result_columns);
+    }
+    block->set_columns(std::move(result_columns));
+}
+
+bool BlockPreAggregator::_is_same_group(const Columns& columns, size_t lhs_row,
+                                        size_t rhs_row) const {
+    for (int column : _group_by_columns) {
+        if (columns[column]->compare_at(lhs_row, rhs_row, *columns[column], -1) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BlockPreAggregator::_is_open_group(const Columns& columns, size_t row) const {
+    for (int column : _group_by_columns) {
+        if (columns[column]->compare_at(row, 0, *_open_row[column], -1) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BlockPreAggregator::_open_group(const Columns& columns, size_t row) {
+    DCHECK(_open_row.empty());
+    _open_row.reserve(columns.size());
+    for (size_t i = 0; i < columns.size(); ++i) {
+        auto column = columns[i]->clone_empty();
+        // the aggregated columns use the aggregate data instead
+        if (_agg_functions[i] == nullptr) {
+            column->insert_from(*columns[i], row);
+        }
+        _open_row.push_back(std::move(column));
+    }
+}
+
+void BlockPreAggregator::_add_rows(const Columns& columns, size_t begin, size_t end) {
+    DCHECK_LT(begin, end);
+    for (size_t i = 0; i < _agg_functions.size(); ++i) {
+        if (_agg_functions[i] == nullptr) {
+            continue;
+        }
+        const IColumn* column = columns[i].get();
+        _agg_functions[i]->add_batch_range(begin, end - 1, _agg_places[i], &column, &_arena,
+                                           column->has_null(end));
+    }
+}
+
+void BlockPreAggregator::_close_group(MutableColumns& result_columns) {
+    for (size_t i = 0; i < _agg_functions.size(); ++i) {
+        if (_agg_functions[i] == nullptr) {
+            result_columns[i]->insert_from(*_open_row[i], 0);
+        } else {
+            _agg_functions[i]->insert_result_into(_agg_places[i], *result_columns[i]);
+            // not every function implements reset()
+            _agg_functions[i]->destroy(_agg_places[i]);
+            _agg_functions[i]->create(_agg_places[i]);
+        }
+    }
+    _open_row.clear();
+}
+
+} // namespace doris::vectorized
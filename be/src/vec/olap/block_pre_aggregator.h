@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <vector>
+
+#include "vec/aggregate_functions/aggregate_function.h"
+#include "vec/common/arena.h"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// Aggregate the consecutive rows of a stream of blocks which have the same values of the
+// columns grouped by into one row, without any hash table. It's the partial aggregation of
+// the scan of an aggregate key table grouped by a prefix of its keys: the merged rows are
+// in the order of the keys, so the rows of a group are consecutive, and each group is
+// aggregated once by the aggregation node above instead of once per key.
+//
+// The aggregated blocks have the same schema as the input blocks. The value of each column
+// of a group is merged by its aggregate function, which must return the type of the column,
+// e.g. the reader function of the aggregation of the column. The columns without aggregate
+// function keep the value of the first row of the group.
+class BlockPreAggregator {
+public:
+    // `agg_functions[i]` aggregates the column i, nullptr for the columns grouped by and the
+    // columns not aggregated.
+    BlockPreAggregator(std::vector<int> group_by_columns,
+                       std::vector<AggregateFunctionPtr> agg_functions);
+    ~BlockPreAggregator();
+
+    // Replace the rows of `block` by the groups closed by them. The last group is kept open
+    // for the rows of the next block, unless `eos` is true.
+    void aggregate(Block* block, bool eos);
+
+    // The number of the rows merged into the first rows of their groups so far.
+    int64_t merged_rows() const { return _merged_rows; }
+
+private:
+    bool _is_same_group(const Columns& columns, size_t lhs_row, size_t rhs_row) const;
+    bool _is_open_group(const Columns& columns, size_t row) const;
+    void _open_group(const Columns& columns, size_t row);
+    void _add_rows(const Columns& columns, size_t begin, size_t end);
+    void _close_group(MutableColumns& result_columns);
+
+    std::vector<int> _group_by_columns;
+    std::vector<AggregateFunctionPtr> _agg_functions;
+    // the aggregate data of the open group of each column with aggregate function
+    std::vector<AggregateDataPtr> _agg_places;
+    Arena _arena;
+
+    // the first row of the open group, empty if there is no open group
+    MutableColumns _open_row;
+    int64_t _merged_rows = 0;
+};
+
+} // namespace doris::vectorized
@@ -155,7 +155,12 @@ Status BlockReader::init(const ReaderParams& read_params) {
         _next_block_func = &BlockReader::_direct_next_block;
         break;
     case KeysType::UNIQUE_KEYS:
-        _next_block_func = &BlockReader::_unique_key_next_block;
+        if (tablet()->enable_unique_key_merge_on_write() &&
+            read_params.reader_type == READER_QUERY) {
+            _next_block_func = &BlockReader::_direct_next_block;
+        } else {
+            _next_block_func = &BlockReader::_unique_key_next_block;
+        }
         break;
     case KeysType::AGG_KEYS:
         _next_block_func = &BlockReader::_agg_key_next_block;
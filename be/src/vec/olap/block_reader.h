@@ -49,6 +49,13 @@ public:
         return (this->*_next_block_func)(block, mem_pool, agg_pool, eof);
     }
 
+    Status current_block_row_locations(std::vector<RowLocation>* locations) override {
+        if (_next_block_func != &BlockReader::_direct_next_block) {
+            return Status::NotSupported("the rows of the blocks are merged");
+        }
+        return _vcollect_iter.current_block_row_locations(locations);
+    }
+
 private:
     friend class VCollectIterator;
     friend class DeleteHandler;
@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#include "vec/olap/block_zorder_compare.h"
+
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "runtime/string_value.h"
+#include "util/binary_cast.hpp"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/runtime/vdatetime_value.h"
+
+namespace doris::vectorized {
+
+// the vectorized columns of STRING have the same layout as VARCHAR
+static FieldType zorder_type(FieldType type) {
+    return type == OLAP_FIELD_TYPE_STRING ? OLAP_FIELD_TYPE_VARCHAR : type;
+}
+
+BlockZOrderComparator::BlockZOrderComparator(const TabletSchema& tablet_schema) {
+    for (size_t i = 0; i < tablet_schema.sort_col_num(); ++i) {
+        _types.push_back(zorder_type(tablet_schema.column(i).type()));
+    }
+    _init_max_col_size();
+}
+
+BlockZOrderComparator::BlockZOrderComparator(const Schema& schema, size_t sort_col_num) {
+    const auto& column_ids = schema.column_ids();
+    for (size_t i = 0; i < sort_col_num && i < column_ids.size(); ++i) {
+        _types.push_back(zorder_type(schema.column(column_ids[i])->type()));
+    }
+    _init_max_col_size();
+}
+
+void BlockZOrderComparator::_init_max_col_size() {
+    DCHECK(!_types.empty());
+    for (auto type : _types) {
+        _max_col_size = std::max(_max_col_size, _row_comparator.get_type_byte_size(type));
+    }
+}
+
+int BlockZOrderComparator::compare_at(size_t n, size_t m, const Block& lhs,
+                                      const Block& rhs) const {
+    return _compare_based_on_size(
+            n, m, [&lhs](size_t i) -> const IColumn& { return *lhs.get_by_position(i).column; },
+            [&rhs](size_t i) -> const IColumn& { return *rhs.get_by_position(i).column; });
+}
+
+int BlockZOrderComparator::compare_at(size_t n, size_t m, const MutableBlock& block) const {
+    auto get_column = [&block](size_t i) -> const IColumn& {
+        return *block.get_column_by_position(i);
+    };
+    return _compare_based_on_size(n, m, get_column, get_column);
+}
+
+template <typename GetColumn>
+int BlockZOrderComparator::_compare_based_on_size(size_t n, size_t m, GetColumn lhs_column,
+                                                  GetColumn rhs_column) const {
+    if (_max_col_size <= 4) {
+        return _compare<uint32_t>(n, m, lhs_column, rhs_column);
+    } else if (_max_col_size <= 8) {
+        return _compare<uint64_t>(n, m, lhs_column, rhs_column);
+    } else {
+        return _compare<__uint128_t>(n, m, lhs_column, rhs_column);
+    }
+}
+
+template <typename U, typename GetColumn>
+int BlockZOrderComparator::_compare(size_t n, size_t m, GetColumn lhs_column,
+                                    GetColumn rhs_column) const {
+    // the column whose values differ in the most significant bit decides the order
+    auto less_msb = [](U x, U y) { return x < y && x < (x ^ y); };
+    U msd_lhs = _get_shared_representation<U>(lhs_column(0), n, _types[0]);
+    U msd_rhs = _get_shared_representation<U>(rhs_column(0), m, _types[0]);
+    for (size_t i = 1; i < _types.size(); ++i) {
+        U lhsi = _get_shared_representation<U>(lhs_column(i), n, _types[i]);
+        U rhsi = _get_shared_representation<U>(rhs_column(i), m, _types[i]);
+        if (less_msb(msd_lhs ^ msd_rhs, lhsi ^ rhsi)) {
+            msd_lhs = lhsi;
+            msd_rhs = rhsi;
+        }
+    }
+    return msd_lhs < msd_rhs ? -1 : (msd_lhs > msd_rhs ? 1 : 0);
+}
+
+template <typename U>
+U BlockZOrderComparator::_get_shared_representation(const IColumn& column, size_t row,
+                                                    FieldType type) const {
+    const IColumn* data_column = &column;
+    if (column.is_nullable()) {
+        const auto& nullable_column = assert_cast<const ColumnNullable&>(column);
+        if (nullable_column.is_null_at(row)) {
+            return _row_comparator.get_shared_representation<U>(nullptr, type);
+        }
+        data_column = &nullable_column.get_nested_column();
+    }
+    StringRef data = data_column->get_data_at(row);
+    switch (type) {
+    case OLAP_FIELD_TYPE_CHAR:
+    case OLAP_FIELD_TYPE_VARCHAR: {
+        StringValue string_value(const_cast<char*>(data.data), data.size);
+        return _row_comparator.get_shared_representation<U>(&string_value, type);
+    }
+    // convert to the storage format, whose integer value keeps the order of date and time
+    case OLAP_FIELD_TYPE_DATE: {
+        int64_t value =
+                binary_cast<int64_t, VecDateTimeValue>(*reinterpret_cast<const int64_t*>(data.data))
+                        .to_olap_date();
+        return _row_comparator.get_shared_representation<U>(&value, type);
+    }
+    case OLAP_FIELD_TYPE_DATETIME: {
+        int64_t value =
+                binary_cast<int64_t, VecDateTimeValue>(*reinterpret_cast<const int64_t*>(data.data))
+                        .to_olap_datetime();
+        return _row_comparator.get_shared_representation<U>(&value, type);
+    }
+    // DecimalV2Value is the integer of the value times 10^9, the same as decimal12_t
+    case OLAP_FIELD_TYPE_DECIMAL:
+        return _row_comparator.get_shared_representation<U>(data.data,
+                                                            OLAP_FIELD_TYPE_LARGEINT);
+    default:
+        return _row_comparator.get_shared_representation<U>(data.data, type);
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,64 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+#pragma once
+
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "util/tuple_row_zorder_compare.h"
+#include "vec/core/block.h"
+
+namespace doris {
+
+class Schema;
+class TabletSchema;
+
+namespace vectorized {
+
+// Compare the rows of blocks in Z-order of the first `sort_col_num` columns, which are the
+// leading key columns of a tablet with SortType::ZORDER. It's the vectorized version of
+// TupleRowZOrderComparator, so the rows are ordered in the same way as the row path.
+class BlockZOrderComparator {
+public:
+    BlockZOrderComparator(const TabletSchema& tablet_schema);
+    BlockZOrderComparator(const Schema& schema, size_t sort_col_num);
+
+    int compare_at(size_t n, size_t m, const Block& lhs, const Block& rhs) const;
+
+    int compare_at(size_t n, size_t m, const MutableBlock& block) const;
+
+private:
+    void _init_max_col_size();
+
+    // `GetColumn` returns the column at the position of the block
+    template <typename U, typename GetColumn>
+    int _compare(size_t n, size_t m, GetColumn lhs_column, GetColumn rhs_column) const;
+
+    template <typename GetColumn>
+    int _compare_based_on_size(size_t n, size_t m, GetColumn lhs_column,
+                               GetColumn rhs_column) const;
+
+    template <typename U>
+    U _get_shared_representation(const IColumn& column, size_t row, FieldType type) const;
+
+    std::vector<FieldType> _types;
+    int _max_col_size = 0;
+    TupleRowZOrderComparator _row_comparator;
+};
+
+} // namespace vectorized
+} // namespace doris
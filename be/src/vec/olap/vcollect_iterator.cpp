@@ -28,9 +28,12 @@ VCollectIterator::~VCollectIterator() {}
 void VCollectIterator::init(TabletReader* reader) {
     _reader = reader;
     // when aggregate is enabled or key_type is DUP_KEYS, we don't merge
-    // multiple data to aggregate for better performance
+    // multiple data to aggregate for better performance.
+    // merge-on-write unique key tablet has no duplicated keys after the delete bitmap
+    // is applied, so it's read like DUP_KEYS.
     if (_reader->_reader_type == READER_QUERY &&
-        (_reader->_direct_mode || _reader->_tablet->keys_type() == KeysType::DUP_KEYS)) {
+        (_reader->_direct_mode || _reader->_tablet->keys_type() == KeysType::DUP_KEYS ||
+         _reader->_tablet->enable_unique_key_merge_on_write())) {
         _merge = false;
     }
 }
@@ -111,9 +114,17 @@ bool VCollectIterator::LevelIteratorComparator::operator()(LevelIterator* lhs, L
     const IteratorRowRef& lhs_ref = *lhs->current_row_ref();
     const IteratorRowRef& rhs_ref = *rhs->current_row_ref();
 
-    int cmp_res =
-            lhs_ref.block->compare_at(lhs_ref.row_pos, rhs_ref.row_pos,
-                                      lhs->tablet_schema().num_key_columns(), *rhs_ref.block, -1);
+    int cmp_res = 0;
+    if (_zorder_comparator != nullptr) {
+        cmp_res = _zorder_comparator->compare_at(lhs_ref.row_pos, rhs_ref.row_pos, *lhs_ref.block,
+                                                 *rhs_ref.block);
+    }
+    // the rows of the same Z-order value are ordered by keys, so the same keys are adjacent
+    if (cmp_res == 0) {
+        cmp_res = lhs_ref.block->compare_at(lhs_ref.row_pos, rhs_ref.row_pos,
+                                            lhs->tablet_schema().num_key_columns(),
+                                            *rhs_ref.block, -1);
+    }
     if (cmp_res != 0) {
         return cmp_res > 0;
     }
@@ -168,6 +179,14 @@ Status VCollectIterator::next(Block* block) {
     }
 }
 
+Status VCollectIterator::current_block_row_locations(std::vector<RowLocation>* locations) {
+    if (LIKELY(_inner_iter)) {
+        return _inner_iter->current_block_row_locations(locations);
+    } else {
+        return Status::OLAPInternalError(OLAP_ERR_DATA_EOF);
+    }
+}
+
 VCollectIterator::Level0Iterator::Level0Iterator(RowsetReaderSharedPtr rs_reader,
                                                  TabletReader* reader)
         : LevelIterator(reader), _rs_reader(rs_reader), _reader(reader) {
@@ -298,7 +317,12 @@ Status VCollectIterator::Level1Iterator::init() {
                 break;
             }
         }
-        _heap.reset(new MergeHeap {LevelIteratorComparator(sequence_loc)});
+        const auto& tablet_schema = _reader->_tablet->tablet_schema();
+        if (tablet_schema.sort_type() == SortType::ZORDER) {
+            _zorder_comparator.reset(new BlockZOrderComparator(tablet_schema));
+        }
+        _heap.reset(new MergeHeap {
+                LevelIteratorComparator(sequence_loc, _zorder_comparator.get())});
         for (auto child : _children) {
             DCHECK(child != nullptr);
             //DCHECK(child->current_row().ok());
@@ -406,6 +430,17 @@ Status VCollectIterator::Level1Iterator::_merge_next(Block* block) {
     return Status::OK();
 }
 
+Status VCollectIterator::Level1Iterator::current_block_row_locations(
+        std::vector<RowLocation>* locations) {
+    if (_merge) {
+        return Status::NotSupported("the rows of the blocks are merged");
+    }
+    if (UNLIKELY(_cur_child == nullptr)) {
+        return Status::OLAPInternalError(OLAP_ERR_DATA_EOF);
+    }
+    return _cur_child->current_block_row_locations(locations);
+}
+
 Status VCollectIterator::Level1Iterator::_normal_next(Block* block) {
     auto res = _cur_child->next(block);
     if (LIKELY(res.ok())) {
@@ -27,6 +27,7 @@
 #include "olap/reader.h"
 #include "olap/rowset/rowset_reader.h"
 #include "vec/core/block.h"
+#include "vec/olap/block_zorder_compare.h"
 
 namespace doris {
 
@@ -62,6 +63,10 @@ public:
 
     Status next(Block* block);
 
+    // The locations of the rows of the last block read by next(Block*), only supported if the
+    // rows are not merged.
+    Status current_block_row_locations(std::vector<RowLocation>* locations);
+
     bool is_merge() const { return _merge; }
 
 private:
@@ -85,6 +90,8 @@ private:
 
         virtual Status next(Block* block) = 0;
 
+        virtual Status current_block_row_locations(std::vector<RowLocation>* locations) = 0;
+
         void set_same(bool same) { _ref.is_same = same; }
 
         bool is_same() { return _ref.is_same; }
@@ -100,14 +107,18 @@ private:
 
     // Compare row cursors between multiple merge elements,
     // if row cursors equal, compare data version.
+    // The rows of tablets with SortType::ZORDER are compared in Z-order first.
     class LevelIteratorComparator {
     public:
-        LevelIteratorComparator(int sequence = -1) : _sequence(sequence) {}
+        LevelIteratorComparator(int sequence = -1,
+                                const BlockZOrderComparator* zorder_comparator = nullptr)
+                : _sequence(sequence), _zorder_comparator(zorder_comparator) {}
 
         bool operator()(LevelIterator* lhs, LevelIterator* rhs);
 
     private:
         int _sequence;
+        const BlockZOrderComparator* _zorder_comparator;
     };
 
 #ifdef USE_LIBCPP
@@ -132,6 +143,10 @@ private:
 
         Status next(Block* block) override;
 
+        Status current_block_row_locations(std::vector<RowLocation>* locations) override {
+            return _rs_reader->current_block_row_locations(locations);
+        }
+
     private:
         Status _refresh_current_row();
 
@@ -154,6 +169,8 @@ private:
 
         Status next(Block* block) override;
 
+        Status current_block_row_locations(std::vector<RowLocation>* locations) override;
+
         ~Level1Iterator();
 
     private:
@@ -181,6 +198,8 @@ private:
         bool _merge = true;
 
         bool _skip_same;
+        // used by `_heap` for tablets with SortType::ZORDER
+        std::unique_ptr<BlockZOrderComparator> _zorder_comparator;
         // used when `_merge == true`
         std::unique_ptr<MergeHeap> _heap;
 
@@ -0,0 +1,119 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/olap/vertical_block_reader.h"
+
+#include <set>
+
+#include "olap/rowset/beta_rowset_reader.h"
+#include "olap/tablet.h"
+
+namespace doris::vectorized {
+
+VerticalBlockReader::~VerticalBlockReader() {
+    // the segment iterators must be released before the rowset readers
+    _vcollect_iter.reset();
+}
+
+Status VerticalBlockReader::init(const ReaderParams& read_params) {
+    DCHECK(read_params.tablet->keys_type() != AGG_KEYS);
+    RETURN_NOT_OK(TabletReader::init(read_params));
+    _is_key_column_group = read_params.is_key_column_group;
+
+    // the rows filtered by delete conditions must be the same in all column groups
+    std::set<uint32_t> column_set(_return_columns.begin(), _return_columns.end());
+    for (const auto& conds : _delete_handler.get_delete_conditions()) {
+        for (const auto& cond_column : conds.del_cond->columns()) {
+            if (column_set.insert(cond_column.first).second) {
+                _return_columns.push_back(cond_column.first);
+            }
+        }
+    }
+    return _init_collect_iter(read_params);
+}
+
+Status VerticalBlockReader::_init_collect_iter(const ReaderParams& read_params) {
+    std::vector<RowsetReaderSharedPtr> rs_readers;
+    auto res = _capture_rs_readers(read_params, &rs_readers);
+    if (!res.ok()) {
+        LOG(WARNING) << "fail to init reader when _capture_rs_readers. res:" << res
+                     << ", tablet_id:" << read_params.tablet->tablet_id()
+                     << ", schema_hash:" << read_params.tablet->schema_hash()
+                     << ", reader_type:" << read_params.reader_type
+                     << ", version:" << read_params.version;
+        return res;
+    }
+
+    _reader_context.batch_size = _batch_size;
+    _reader_context.is_vec = true;
+    std::vector<RowwiseIterator*> segment_iters;
+    for (auto& rs_reader : rs_readers) {
+        DCHECK_EQ(RowsetTypePB::BETA_ROWSET, rs_reader->type());
+        res = std::static_pointer_cast<BetaRowsetReader>(rs_reader)->get_segment_iterators(
+                &_reader_context, &segment_iters);
+        _rs_readers.push_back(rs_reader);
+        if (!res.ok()) {
+            break;
+        }
+    }
+    if (res.ok() && segment_iters.size() > RowSource::MAX_SOURCE_NUM + 1) {
+        res = Status::NotSupported(fmt::format(
+                "vertical compaction supports at most {} segments, but there are {}",
+                RowSource::MAX_SOURCE_NUM + 1, segment_iters.size()));
+    }
+    if (!res.ok()) {
+        for (auto iter : segment_iters) {
+            delete iter;
+        }
+        return res;
+    }
+
+    StorageReadOptions opts;
+    opts.block_row_max = _batch_size;
+    if (_is_key_column_group) {
+        int sequence_loc = -1;
+        for (int loc = 0; loc < _return_columns.size(); ++loc) {
+            if (_return_columns[loc] == _sequence_col_idx) {
+                sequence_loc = loc;
+                break;
+            }
+        }
+        _heap_iter = new VerticalHeapMergeIterator(
+                std::move(segment_iters), _tablet->num_key_columns(), sequence_loc,
+                _tablet->keys_type() == UNIQUE_KEYS, _row_sources_buffer);
+        _vcollect_iter.reset(_heap_iter);
+    } else {
+        _vcollect_iter.reset(
+                new VerticalMaskMergeIterator(std::move(segment_iters), _row_sources_buffer));
+    }
+    return _vcollect_iter->init(opts);
+}
+
+Status VerticalBlockReader::next_block_with_aggregation(Block* block, MemPool* mem_pool,
+                                                        ObjectPool* agg_pool, bool* eof) {
+    auto res = _vcollect_iter->next_batch(block);
+    if (_heap_iter != nullptr) {
+        _merged_rows = _heap_iter->merged_rows();
+    }
+    if (UNLIKELY(!res.ok() && !res.is_end_of_file())) {
+        return res;
+    }
+    *eof = res.is_end_of_file();
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "olap/reader.h"
+#include "olap/rowset/rowset_reader.h"
+#include "vec/olap/vertical_merge_iterator.h"
+
+namespace doris {
+
+namespace vectorized {
+
+// Reader of one column group of vertical compaction for DUP_KEYS and UNIQUE_KEYS tablets.
+//
+// Unlike BlockReader, which merges the rows of the input rowsets, it merges the segments of all
+// input rowsets directly. For the key column group, the rows are merged by keys and the source
+// of each row is recorded into `row_sources_buffer`. For a value column group, the rows are
+// read in the order of the recorded row sources.
+//
+// The columns of the delete conditions are read in every group to filter the same rows, they're
+// put after the columns of `return_columns` in the block.
+class VerticalBlockReader final : public TabletReader {
+public:
+    explicit VerticalBlockReader(RowSourcesBuffer* row_sources_buffer)
+            : _row_sources_buffer(row_sources_buffer) {}
+
+    ~VerticalBlockReader() override;
+
+    Status init(const ReaderParams& read_params) override;
+
+    Status next_row_with_aggregation(RowCursor* row_cursor, MemPool* mem_pool, ObjectPool* agg_pool,
+                                     bool* eof) override {
+        return Status::OLAPInternalError(OLAP_ERR_READER_INITIALIZE_ERROR);
+    }
+
+    Status next_block_with_aggregation(Block* block, MemPool* mem_pool, ObjectPool* agg_pool,
+                                       bool* eof) override;
+
+    // columns of the block returned by `next_block_with_aggregation`
+    const std::vector<uint32_t>& return_columns() const { return _return_columns; }
+
+private:
+    Status _init_collect_iter(const ReaderParams& read_params);
+
+    RowSourcesBuffer* _row_sources_buffer;
+    bool _is_key_column_group = false;
+
+    // hold the rowset readers, the segment iterators refer to their schema
+    std::vector<RowsetReaderSharedPtr> _rs_readers;
+    std::unique_ptr<RowwiseIterator> _vcollect_iter;
+    // not owned, points to `_vcollect_iter` of the key column group
+    VerticalHeapMergeIterator* _heap_iter = nullptr;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -0,0 +1,245 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/olap/vertical_merge_iterator.h"
+
+#include <fmt/format.h>
+
+namespace doris {
+namespace vectorized {
+
+// RowSourcesBuffer
+size_t RowSourcesBuffer::same_source_count(size_t limit) const {
+    size_t count = 0;
+    uint16_t data = _row_sources[_pos];
+    for (size_t i = _pos; i < _row_sources.size() && count < limit; ++i) {
+        if (_row_sources[i] != data) {
+            break;
+        }
+        ++count;
+    }
+    return count;
+}
+
+// VerticalMergeIteratorContext
+Status VerticalMergeIteratorContext::init(int block_row_max) {
+    _block_row_max = block_row_max;
+    RETURN_IF_ERROR(_block_reset());
+    return _load_next_block();
+}
+
+bool VerticalMergeIteratorContext::compare(const VerticalMergeIteratorContext& rhs) const {
+    int cmp_res = _block.compare_at(_index_in_block, rhs._index_in_block, _num_key_columns,
+                                    rhs._block, -1);
+    if (cmp_res != 0) {
+        return cmp_res > 0;
+    }
+    if (_sequence_loc != -1) {
+        cmp_res = _block.compare_column_at(_index_in_block, rhs._index_in_block, _sequence_loc,
+                                           rhs._block, -1);
+        if (cmp_res != 0) {
+            return cmp_res < 0;
+        }
+    }
+    return _order < rhs._order;
+}
+
+bool VerticalMergeIteratorContext::is_same_key(const VerticalMergeIteratorContext& rhs) const {
+    return _block.compare_at(_index_in_block, rhs._index_in_block, _num_key_columns, rhs._block,
+                             -1) == 0;
+}
+
+void VerticalMergeIteratorContext::copy_rows(Block* block, size_t count) {
+    DCHECK_LE(_index_in_block + count, _block.rows());
+    for (size_t i = 0; i < block->columns(); ++i) {
+        auto& s_col = _block.get_by_position(i);
+        auto& d_col = block->get_by_position(i);
+        ((IColumn&)(*d_col.column)).insert_range_from(*s_col.column, _index_in_block, count);
+    }
+}
+
+Status VerticalMergeIteratorContext::advance(size_t count) {
+    DCHECK(_valid);
+    _index_in_block += count;
+    if (LIKELY(_index_in_block < _block.rows())) {
+        return Status::OK();
+    }
+    DCHECK_EQ(_index_in_block, _block.rows());
+    return _load_next_block();
+}
+
+Status VerticalMergeIteratorContext::_block_reset() {
+    if (_block.columns() > 0) {
+        _block.clear_column_data();
+        return Status::OK();
+    }
+    const Schema& schema = _iter->schema();
+    for (auto cid : schema.column_ids()) {
+        auto column_desc = schema.column(cid);
+        auto data_type = Schema::get_data_type_ptr(*column_desc);
+        if (data_type == nullptr) {
+            return Status::RuntimeError("invalid data type");
+        }
+        auto column = data_type->create_column();
+        column->reserve(_block_row_max);
+        _block.insert(ColumnWithTypeAndName(std::move(column), data_type, column_desc->name()));
+    }
+    return Status::OK();
+}
+
+Status VerticalMergeIteratorContext::_load_next_block() {
+    do {
+        RETURN_IF_ERROR(_block_reset());
+        Status st = _iter->next_batch(&_block);
+        if (!st.ok()) {
+            _valid = false;
+            return st.is_end_of_file() ? Status::OK() : st;
+        }
+    } while (_block.rows() == 0);
+    _index_in_block = 0;
+    _valid = true;
+    return Status::OK();
+}
+
+// VerticalHeapMergeIterator
+VerticalHeapMergeIterator::~VerticalHeapMergeIterator() {
+    for (auto iter : _origin_iters) {
+        delete iter;
+    }
+    while (!_merge_heap.empty()) {
+        delete _merge_heap.top();
+        _merge_heap.pop();
+    }
+}
+
+Status VerticalHeapMergeIterator::init(const StorageReadOptions& opts) {
+    if (_origin_iters.empty()) {
+        return Status::OK();
+    }
+    DCHECK_LE(_origin_iters.size(), RowSource::MAX_SOURCE_NUM + 1);
+    _schema = &_origin_iters[0]->schema();
+    _block_row_max = opts.block_row_max;
+
+    auto iters = std::move(_origin_iters);
+    _origin_iters.clear();
+    Status st;
+    for (size_t order = 0; order < iters.size(); ++order) {
+        auto ctx = std::make_unique<VerticalMergeIteratorContext>(iters[order], order,
+                                                                  _num_key_columns, _sequence_loc);
+        iters[order] = nullptr;
+        if (st.ok()) {
+            st = ctx->init(_block_row_max);
+        }
+        if (st.ok() && ctx->valid()) {
+            _merge_heap.push(ctx.release());
+        }
+    }
+    return st;
+}
+
+Status VerticalHeapMergeIterator::next_batch(Block* block) {
+    while (block->rows() < _block_row_max && !_merge_heap.empty()) {
+        auto ctx = _merge_heap.top();
+        _merge_heap.pop();
+        if (ctx->is_same()) {
+            // an older version of the output key
+            _row_sources_buf->append(RowSource(ctx->order(), true));
+            ctx->set_is_same(false);
+            ++_merged_rows;
+        } else {
+            ctx->copy_rows(block, 1);
+            _row_sources_buf->append(RowSource(ctx->order(), false));
+        }
+        // the keys are unique in a segment, so the rows with the same key are in other segments,
+        // and they are at the top of the heap one by one in order
+        if (_is_unique && !_merge_heap.empty() && ctx->is_same_key(*_merge_heap.top())) {
+            _merge_heap.top()->set_is_same(true);
+        }
+        RETURN_IF_ERROR(ctx->advance());
+        if (ctx->valid()) {
+            _merge_heap.push(ctx);
+        } else {
+            // release the context earlier to reduce resource consumed
+            delete ctx;
+        }
+    }
+    if (block->rows() == 0) {
+        return Status::EndOfFile("no more data in segments");
+    }
+    return Status::OK();
+}
+
+// VerticalMaskMergeIterator
+VerticalMaskMergeIterator::~VerticalMaskMergeIterator() {
+    for (auto iter : _origin_iters) {
+        delete iter;
+    }
+    for (auto ctx : _ctxs) {
+        delete ctx;
+    }
+}
+
+Status VerticalMaskMergeIterator::init(const StorageReadOptions& opts) {
+    if (_origin_iters.empty()) {
+        return Status::OK();
+    }
+    _schema = &_origin_iters[0]->schema();
+    _block_row_max = opts.block_row_max;
+
+    auto iters = std::move(_origin_iters);
+    _origin_iters.clear();
+    Status st;
+    for (size_t order = 0; order < iters.size(); ++order) {
+        // the key columns are not used to merge
+        _ctxs.push_back(new VerticalMergeIteratorContext(iters[order], order, 0, -1));
+        if (st.ok()) {
+            st = _ctxs.back()->init(_block_row_max);
+        }
+    }
+    return st;
+}
+
+Status VerticalMaskMergeIterator::next_batch(Block* block) {
+    while (block->rows() < _block_row_max && _row_sources_buf->has_remaining()) {
+        auto row_source = _row_sources_buf->current();
+        uint16_t order = row_source.get_source_num();
+        if (UNLIKELY(order >= _ctxs.size() || !_ctxs[order]->valid())) {
+            return Status::InternalError(
+                    fmt::format("invalid row source {}, there are {} input segments", order,
+                                _ctxs.size()));
+        }
+        auto ctx = _ctxs[order];
+        // copy the continuous rows of the same source at once
+        size_t limit = ctx->remaining_rows_in_block();
+        if (!row_source.agg_flag()) {
+            limit = std::min(limit, size_t(_block_row_max - block->rows()));
+        }
+        size_t count = _row_sources_buf->same_source_count(limit);
+        if (!row_source.agg_flag()) {
+            ctx->copy_rows(block, count);
+        }
+        RETURN_IF_ERROR(ctx->advance(count));
+        _row_sources_buf->advance(count);
+    }
+    if (block->rows() == 0) {
+        return Status::EndOfFile("no more data in segments");
+    }
+    return Status::OK();
+}
+
+} // namespace vectorized
+} // namespace doris
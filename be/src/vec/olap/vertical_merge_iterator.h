@@ -0,0 +1,219 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "olap/iterators.h"
+#include "olap/schema.h"
+#include "vec/core/block.h"
+
+namespace doris {
+namespace vectorized {
+
+// The source of a row merged by vertical compaction. The low 15 bits are the ordinal of the
+// input segment, and the highest bit is set when the row is merged into another row
+// (e.g. an older version of a unique key), so it's not output.
+class RowSource {
+public:
+    static constexpr uint16_t MAX_SOURCE_NUM = 0x7FFF;
+
+    RowSource(uint16_t source_num, bool agg_flag)
+            : _data(agg_flag ? (source_num | AGG_FLAG) : source_num) {}
+    explicit RowSource(uint16_t data) : _data(data) {}
+
+    uint16_t get_source_num() const { return _data & MAX_SOURCE_NUM; }
+    bool agg_flag() const { return (_data & AGG_FLAG) != 0; }
+    uint16_t data() const { return _data; }
+
+private:
+    static constexpr uint16_t AGG_FLAG = 0x8000;
+
+    uint16_t _data;
+};
+
+// The sequence of the row sources of the key columns merge, in the merged order, used to
+// merge the value columns in the same order. It takes 2 bytes for each input row.
+class RowSourcesBuffer {
+public:
+    RowSourcesBuffer() = default;
+
+    void append(const RowSource& row_source) { _row_sources.push_back(row_source.data()); }
+
+    // read the row sources from the beginning
+    void seek_to_begin() { _pos = 0; }
+
+    bool has_remaining() const { return _pos < _row_sources.size(); }
+
+    RowSource current() const {
+        DCHECK(has_remaining());
+        return RowSource(_row_sources[_pos]);
+    }
+
+    void advance(size_t count = 1) { _pos += count; }
+
+    // number of the continuous rows from the current position, which have the same source and
+    // agg flag, at most `limit`
+    size_t same_source_count(size_t limit) const;
+
+    size_t total_size() const { return _row_sources.size(); }
+
+private:
+    std::vector<uint16_t> _row_sources;
+    size_t _pos = 0;
+};
+
+// Merge state of an input segment iterator of vertical compaction.
+class VerticalMergeIteratorContext {
+public:
+    VerticalMergeIteratorContext(RowwiseIterator* iter, uint16_t order, size_t num_key_columns,
+                                 int sequence_loc)
+            : _iter(iter),
+              _order(order),
+              _num_key_columns(num_key_columns),
+              _sequence_loc(sequence_loc) {}
+    VerticalMergeIteratorContext(const VerticalMergeIteratorContext&) = delete;
+    VerticalMergeIteratorContext& operator=(const VerticalMergeIteratorContext&) = delete;
+
+    ~VerticalMergeIteratorContext() { delete _iter; }
+
+    // Load the first row. The iterator has been inited by its rowset reader.
+    Status init(int block_row_max);
+
+    // Whether this row is behind `rhs` in the merged order. Rows are ordered by keys, and then
+    // by the sequence column and the order of the input segment descendingly, so the newest
+    // version of a unique key comes first.
+    bool compare(const VerticalMergeIteratorContext& rhs) const;
+
+    bool is_same_key(const VerticalMergeIteratorContext& rhs) const;
+
+    void copy_rows(Block* block, size_t count);
+
+    // Advance `count` rows, the rows must be in the current block
+    Status advance(size_t count = 1);
+
+    bool valid() const { return _valid; }
+
+    // number of rows remaining in the current block, including the current row
+    size_t remaining_rows_in_block() const { return _block.rows() - _index_in_block; }
+
+    uint16_t order() const { return _order; }
+
+    bool is_same() const { return _is_same; }
+    void set_is_same(bool is_same) { _is_same = is_same; }
+
+private:
+    Status _block_reset();
+    Status _load_next_block();
+
+    RowwiseIterator* _iter;
+    uint16_t _order;
+    size_t _num_key_columns;
+    int _sequence_loc;
+
+    Block _block;
+    bool _valid = false;
+    size_t _index_in_block = 0;
+    int _block_row_max = 4096;
+    // the current row has the same key as an output row of a newer version
+    bool _is_same = false;
+};
+
+// Merge the key columns of the input segments of vertical compaction, and record the source
+// of each row into a RowSourcesBuffer. For UNIQUE_KEYS, only the newest version of a key is
+// output, others are recorded with the agg flag.
+//
+// The input iterators are owned by this iterator.
+class VerticalHeapMergeIterator : public RowwiseIterator {
+public:
+    VerticalHeapMergeIterator(std::vector<RowwiseIterator*> iters, size_t num_key_columns,
+                              int sequence_loc, bool is_unique, RowSourcesBuffer* row_sources_buf)
+            : _origin_iters(std::move(iters)),
+              _num_key_columns(num_key_columns),
+              _sequence_loc(sequence_loc),
+              _is_unique(is_unique),
+              _row_sources_buf(row_sources_buf) {}
+
+    ~VerticalHeapMergeIterator() override;
+
+    Status init(const StorageReadOptions& opts) override;
+
+    Status next_batch(Block* block) override;
+
+    const Schema& schema() const override { return *_schema; }
+
+    uint64_t merged_rows() const { return _merged_rows; }
+
+private:
+    struct ContextComparator {
+        bool operator()(const VerticalMergeIteratorContext* lhs,
+                        const VerticalMergeIteratorContext* rhs) const {
+            return lhs->compare(*rhs);
+        }
+    };
+
+    using MergeHeap =
+            std::priority_queue<VerticalMergeIteratorContext*,
+                                std::vector<VerticalMergeIteratorContext*>, ContextComparator>;
+
+    // released after the heap is built
+    std::vector<RowwiseIterator*> _origin_iters;
+    size_t _num_key_columns;
+    int _sequence_loc;
+    bool _is_unique;
+    RowSourcesBuffer* _row_sources_buf;
+
+    const Schema* _schema = nullptr;
+    MergeHeap _merge_heap;
+    int _block_row_max = 4096;
+    uint64_t _merged_rows = 0;
+};
+
+// Merge the value columns of the input segments of vertical compaction in the order of the
+// row sources recorded by merging the key columns.
+//
+// The input iterators are owned by this iterator.
+class VerticalMaskMergeIterator : public RowwiseIterator {
+public:
+    VerticalMaskMergeIterator(std::vector<RowwiseIterator*> iters,
+                              RowSourcesBuffer* row_sources_buf)
+            : _origin_iters(std::move(iters)), _row_sources_buf(row_sources_buf) {}
+
+    ~VerticalMaskMergeIterator() override;
+
+    Status init(const StorageReadOptions& opts) override;
+
+    Status next_batch(Block* block) override;
+
+    const Schema& schema() const override { return *_schema; }
+
+private:
+    // released after the contexts are built
+    std::vector<RowwiseIterator*> _origin_iters;
+    RowSourcesBuffer* _row_sources_buf;
+
+    const Schema* _schema = nullptr;
+    // indexed by the ordinal of input segment
+    std::vector<VerticalMergeIteratorContext*> _ctxs;
+    int _block_row_max = 4096;
+};
+
+} // namespace vectorized
+} // namespace doris
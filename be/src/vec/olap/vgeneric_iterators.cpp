@@ -15,12 +15,17 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include "vec/olap/vgeneric_iterators.h"
+
 #include <queue>
 #include <utility>
 
 #include "olap/iterators.h"
 #include "olap/row.h"
 #include "olap/row_block2.h"
+#include "olap/rowset/segment_v2/segment.h"
+#include "olap/wrapper_field.h"
+#include "vec/olap/block_zorder_compare.h"
 
 namespace doris {
 
@@ -119,8 +124,11 @@ Status VAutoIncrementIterator::init(const StorageReadOptions& opts) {
 //      }
 class VMergeIteratorContext {
 public:
-    VMergeIteratorContext(RowwiseIterator* iter, int sequence_id_idx)
-            : _iter(iter), _sequence_id_idx(sequence_id_idx) {}
+    VMergeIteratorContext(RowwiseIterator* iter, int sequence_id_idx,
+                          const BlockZOrderComparator* zorder_comparator = nullptr)
+            : _iter(iter),
+              _sequence_id_idx(sequence_id_idx),
+              _zorder_comparator(zorder_comparator) {}
     VMergeIteratorContext(const VMergeIteratorContext&) = delete;
     VMergeIteratorContext(VMergeIteratorContext&&) = delete;
     VMergeIteratorContext& operator=(const VMergeIteratorContext&) = delete;
@@ -158,8 +166,16 @@ public:
     bool compare(const VMergeIteratorContext& rhs) const {
         const Schema& schema = _iter->schema();
         int num = schema.num_key_columns();
-        int cmp_res =
-                this->_block.compare_at(_index_in_block, rhs._index_in_block, num, rhs._block, -1);
+        int cmp_res = 0;
+        if (_zorder_comparator != nullptr) {
+            cmp_res = _zorder_comparator->compare_at(_index_in_block, rhs._index_in_block,
+                                                     this->_block, rhs._block);
+        }
+        // the rows of the same Z-order value are ordered by keys
+        if (cmp_res == 0) {
+            cmp_res = this->_block.compare_at(_index_in_block, rhs._index_in_block, num,
+                                              rhs._block, -1);
+        }
         if (cmp_res != 0) {
             return cmp_res > 0;
         }
@@ -217,6 +233,8 @@ private:
     size_t _index_in_block = -1;
     int _block_row_max = 4096;
     int _sequence_id_idx = -1;
+    // not owned, set for tablets with SortType::ZORDER
+    const BlockZOrderComparator* _zorder_comparator;
 };
 
 Status VMergeIteratorContext::init(const StorageReadOptions& opts) {
@@ -264,8 +282,12 @@ Status VMergeIteratorContext::_load_next_block() {
 class VMergeIterator : public RowwiseIterator {
 public:
     // VMergeIterator takes the ownership of input iterators
-    VMergeIterator(std::vector<RowwiseIterator*>& iters, int sequence_id_idx)
-            : _origin_iters(iters), _sequence_id_idx(sequence_id_idx) {}
+    VMergeIterator(std::vector<RowwiseIterator*>& iters, int sequence_id_idx, SortType sort_type,
+                   int sort_col_num)
+            : _origin_iters(iters),
+              _sequence_id_idx(sequence_id_idx),
+              _sort_type(sort_type),
+              _sort_col_num(sort_col_num) {}
 
     ~VMergeIterator() override {
         while (!_merge_heap.empty()) {
@@ -301,6 +323,9 @@ private:
 
     int block_row_max = 0;
     int _sequence_id_idx = -1;
+    SortType _sort_type = SortType::LEXICAL;
+    int _sort_col_num = 0;
+    std::unique_ptr<BlockZOrderComparator> _zorder_comparator;
 };
 
 Status VMergeIterator::init(const StorageReadOptions& opts) {
@@ -308,9 +333,13 @@ Status VMergeIterator::init(const StorageReadOptions& opts) {
         return Status::OK();
     }
     _schema = &(*_origin_iters.begin())->schema();
+    if (_sort_type == SortType::ZORDER) {
+        _zorder_comparator.reset(new BlockZOrderComparator(*_schema, _sort_col_num));
+    }
 
     for (auto iter : _origin_iters) {
-        auto ctx = std::make_unique<VMergeIteratorContext>(iter, _sequence_id_idx);
+        auto ctx = std::make_unique<VMergeIteratorContext>(iter, _sequence_id_idx,
+                                                           _zorder_comparator.get());
         RETURN_IF_ERROR(ctx->init(opts));
         if (!ctx->valid()) {
             continue;
@@ -366,6 +395,13 @@ public:
 
     const Schema& schema() const override { return *_schema; }
 
+    Status current_block_row_locations(std::vector<RowLocation>* locations) override {
+        if (_cur_iter == nullptr) {
+            return Status::EndOfFile("End of VUnionIterator");
+        }
+        return _cur_iter->current_block_row_locations(locations);
+    }
+
 private:
     const Schema* _schema = nullptr;
     RowwiseIterator* _cur_iter = nullptr;
@@ -403,11 +439,128 @@ Status VUnionIterator::next_batch(vectorized::Block* block) {
     return Status::EndOfFile("End of VUnionIterator");
 }
 
-RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*>& inputs, int sequence_id_idx) {
+// Answer the aggregate pushed down by the scan node from the metadata of a segment:
+// - COUNT: as many rows of the default values as the segment has, enough for count(*)
+// - MINMAX: two rows, the minimums and the maximums of the columns in the segment zone maps
+class VStatisticsIterator : public RowwiseIterator {
+public:
+    VStatisticsIterator(std::shared_ptr<segment_v2::Segment> segment, const Schema& schema,
+                        TPushAggOp::type push_down_agg_type)
+            : _segment(std::move(segment)),
+              _schema(schema),
+              _push_down_agg_type(push_down_agg_type) {}
+
+    ~VStatisticsIterator() override {}
+
+    Status init(const StorageReadOptions& opts) override;
+
+    Status next_batch(vectorized::Block* block) override;
+
+    const Schema& schema() const override { return _schema; }
+
+    uint64_t data_id() const override { return _segment->id(); }
+
+    static bool is_min_max_supported(FieldType type);
+
+private:
+    Status _insert_min_max(const doris::Field* field, const segment_v2::ZoneMapPB& zone_map,
+                           IColumn* column);
+
+    std::shared_ptr<segment_v2::Segment> _segment;
+    const Schema& _schema;
+    TPushAggOp::type _push_down_agg_type;
+    size_t _block_row_max = 0;
+    size_t _target_rows = 0;
+    size_t _output_rows = 0;
+};
+
+// the zone map values of the types are in the same format as the data pages
+bool VStatisticsIterator::is_min_max_supported(FieldType type) {
+    switch (type) {
+    case OLAP_FIELD_TYPE_BOOL:
+    case OLAP_FIELD_TYPE_TINYINT:
+    case OLAP_FIELD_TYPE_SMALLINT:
+    case OLAP_FIELD_TYPE_INT:
+    case OLAP_FIELD_TYPE_BIGINT:
+    case OLAP_FIELD_TYPE_LARGEINT:
+    case OLAP_FIELD_TYPE_DATE:
+    case OLAP_FIELD_TYPE_DATETIME:
+    case OLAP_FIELD_TYPE_DECIMAL:
+    case OLAP_FIELD_TYPE_VARCHAR:
+    case OLAP_FIELD_TYPE_STRING:
+        return true;
+    default:
+        return false;
+    }
+}
+
+Status VStatisticsIterator::init(const StorageReadOptions& opts) {
+    _block_row_max = opts.block_row_max;
+    if (_push_down_agg_type == TPushAggOp::COUNT) {
+        _target_rows = _segment->num_rows();
+    } else {
+        _target_rows = _segment->num_rows() > 0 ? 2 : 0;
+    }
+    return Status::OK();
+}
+
+Status VStatisticsIterator::next_batch(vectorized::Block* block) {
+    if (_output_rows >= _target_rows) {
+        return Status::EndOfFile("End of VStatisticsIterator");
+    }
+    size_t size = std::min(_target_rows - _output_rows, _block_row_max);
+    block->clear_column_data(_schema.num_column_ids());
+    for (size_t i = 0; i < _schema.num_column_ids(); ++i) {
+        auto cid = _schema.column_id(i);
+        auto column = std::move(*block->get_by_position(i).column).mutate();
+        if (_push_down_agg_type == TPushAggOp::COUNT) {
+            column->insert_many_defaults(size);
+        } else {
+            RETURN_IF_ERROR(_insert_min_max(_schema.column(cid), *_segment->segment_zone_map(cid),
+                                            column.get()));
+        }
+        block->replace_by_position(i, std::move(column));
+    }
+    _output_rows += size;
+    return Status::OK();
+}
+
+Status VStatisticsIterator::_insert_min_max(const doris::Field* field,
+                                            const segment_v2::ZoneMapPB& zone_map,
+                                            IColumn* column) {
+    if (!zone_map.has_not_null()) {
+        // all the values are null
+        column->insert_many_defaults(2);
+        return Status::OK();
+    }
+    if (field->type() == OLAP_FIELD_TYPE_DATE) {
+        column->set_date_type();
+    } else if (field->type() == OLAP_FIELD_TYPE_DATETIME) {
+        column->set_datetime_type();
+    }
+    std::unique_ptr<WrapperField> min_value(
+            WrapperField::create_by_type(field->type(), field->length()));
+    std::unique_ptr<WrapperField> max_value(
+            WrapperField::create_by_type(field->type(), field->length()));
+    RETURN_IF_ERROR(min_value->from_string(zone_map.min()));
+    RETURN_IF_ERROR(max_value->from_string(zone_map.max()));
+    for (auto* value : {min_value.get(), max_value.get()}) {
+        if (value->is_string_type()) {
+            const Slice* slice = reinterpret_cast<const Slice*>(value->cell_ptr());
+            column->insert_data(slice->data, slice->size);
+        } else {
+            column->insert_many_fix_len_data(reinterpret_cast<const char*>(value->cell_ptr()), 1);
+        }
+    }
+    return Status::OK();
+}
+
+RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*>& inputs, int sequence_id_idx,
+                                    SortType sort_type, int sort_col_num) {
     if (inputs.size() == 1) {
         return *(inputs.begin());
     }
-    return new VMergeIterator(inputs, sequence_id_idx);
+    return new VMergeIterator(inputs, sequence_id_idx, sort_type, sort_col_num);
 }
 
 RowwiseIterator* new_union_iterator(std::vector<RowwiseIterator*>& inputs) {
@@ -421,6 +574,25 @@ RowwiseIterator* new_auto_increment_iterator(const Schema& schema, size_t num_ro
     return new VAutoIncrementIterator(schema, num_rows);
 }
 
+RowwiseIterator* new_statistics_iterator(std::shared_ptr<segment_v2::Segment> segment,
+                                         const Schema& schema,
+                                         TPushAggOp::type push_down_agg_type) {
+    if (!segment->is_open()) {
+        return nullptr;
+    }
+    if (push_down_agg_type == TPushAggOp::MINMAX) {
+        for (auto cid : schema.column_ids()) {
+            if (!VStatisticsIterator::is_min_max_supported(schema.column(cid)->type()) ||
+                segment->segment_zone_map(cid) == nullptr) {
+                return nullptr;
+            }
+        }
+    } else if (push_down_agg_type != TPushAggOp::COUNT) {
+        return nullptr;
+    }
+    return new VStatisticsIterator(std::move(segment), schema, push_down_agg_type);
+}
+
 } // namespace vectorized
 
 } // namespace doris
@@ -15,10 +15,18 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <memory>
+
+#include "gen_cpp/PlanNodes_types.h"
 #include "olap/iterators.h"
+#include "olap/tablet_schema.h"
 
 namespace doris {
 
+namespace segment_v2 {
+class Segment;
+} // namespace segment_v2
+
 namespace vectorized {
 
 // Create a merge iterator for input iterators. Merge iterator will merge
@@ -27,7 +35,11 @@ namespace vectorized {
 //
 // Inputs iterators' ownership is taken by created merge iterator. And client
 // should delete returned iterator after usage.
-RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*>& inputs, int sequence_id_idx);
+//
+// The inputs of tablets with SortType::ZORDER are merged in Z-order of the first
+// `sort_col_num` columns.
+RowwiseIterator* new_merge_iterator(std::vector<RowwiseIterator*>& inputs, int sequence_id_idx,
+                                    SortType sort_type = SortType::LEXICAL, int sort_col_num = 0);
 
 // Create a union iterator for input iterators. Union iterator will read
 // input iterators one by one.
@@ -42,6 +54,16 @@ RowwiseIterator* new_union_iterator(std::vector<RowwiseIterator*>& inputs);
 // Client should delete returned iterator.
 RowwiseIterator* new_auto_increment_iterator(const Schema& schema, size_t num_rows);
 
+// Create an iterator answering the aggregate pushed down by the scan node from the metadata
+// of the segment, without reading the data pages. It must only be used if no rows of the
+// segment are filtered.
+// Return nullptr if the segment can't answer it, e.g. a column of `schema` has no zone map.
+//
+// Client should delete returned iterator.
+RowwiseIterator* new_statistics_iterator(std::shared_ptr<segment_v2::Segment> segment,
+                                         const Schema& schema,
+                                         TPushAggOp::type push_down_agg_type);
+
 } // namespace vectorized
 
 } // namespace doris
@@ -17,6 +17,10 @@
 
 #include "vec/runtime/vdata_stream_mgr.h"
 
+#include <fmt/format.h>
+
+#include <atomic>
+
 #include "gen_cpp/internal_service.pb.h"
 #include "runtime/descriptors.h"
 #include "runtime/primitive_type.h"
@@ -25,10 +29,38 @@
 #include "util/doris_metrics.h"
 #include "util/runtime_profile.h"
 #include "vec/runtime/vdata_stream_recvr.h"
+#include "vec/runtime/vexchange_mux.h"
 
 namespace doris {
 namespace vectorized {
 
+namespace {
+
+// The closure of a transmit_blocks rpc shared by its blocks, which runs the `done` of the rpc
+// once all the blocks delayed by their receivers are consumed.
+class TransmitBlocksClosure : public google::protobuf::Closure {
+public:
+    explicit TransmitBlocksClosure(google::protobuf::Closure* done) : _done(done) {}
+
+    void ref() { _refs.fetch_add(1); }
+
+    // If unref() returns true, this object should be deleted
+    bool unref() { return _refs.fetch_sub(1) == 1; }
+
+    void Run() override {
+        if (unref()) {
+            _done->Run();
+            delete this;
+        }
+    }
+
+private:
+    google::protobuf::Closure* _done;
+    std::atomic<int> _refs {1};
+};
+
+} // namespace
+
 VDataStreamMgr::VDataStreamMgr() {
     // TODO: metric
 }
@@ -53,7 +85,7 @@ std::shared_ptr<VDataStreamRecvr> VDataStreamMgr::create_recvr(
     VLOG_FILE << "creating receiver for fragment=" << fragment_instance_id
               << ", node=" << dest_node_id;
     std::shared_ptr<VDataStreamRecvr> recvr(new VDataStreamRecvr(
-            this, row_desc, fragment_instance_id, dest_node_id, num_senders, is_merging,
+            this, state, row_desc, fragment_instance_id, dest_node_id, num_senders, is_merging,
             buffer_size, profile, sub_plan_query_statistics_recvr));
     uint32_t hash_value = get_hash_value(fragment_instance_id, dest_node_id);
     std::lock_guard<std::mutex> l(_lock);
@@ -126,6 +158,56 @@ Status VDataStreamMgr::transmit_block(const PTransmitDataParams* request,
     return Status::OK();
 }
 
+Status VDataStreamMgr::transmit_blocks(const PTransmitBlocksParams* request,
+                                       ::google::protobuf::Closure** done) {
+    auto closure = new TransmitBlocksClosure(*done);
+    Status status;
+    for (const auto& params : request->params()) {
+        closure->ref();
+        google::protobuf::Closure* params_done = closure;
+        Status st = transmit_block(&params, &params_done);
+        if (params_done != nullptr) {
+            // not delayed by the receiver
+            params_done->Run();
+        }
+        if (!st.ok() && status.ok()) {
+            status = st;
+        }
+    }
+    if (closure->unref()) {
+        // nothing is delayed, the caller runs `done`
+        delete closure;
+    } else {
+        *done = nullptr;
+    }
+    return status;
+}
+
+std::shared_ptr<VExchangeMux> VDataStreamMgr::get_exchange_mux(
+        const TUniqueId& query_id, const TNetworkAddress& address,
+        std::shared_ptr<PBackendService_Stub> stub, int32_t timeout_ms) {
+    MuxKey key(query_id.hi, query_id.lo, fmt::format("{}:{}", address.hostname, address.port));
+    std::lock_guard<std::mutex> l(_mux_lock);
+    auto& mux = _exchange_muxes[key];
+    std::shared_ptr<VExchangeMux> res = mux.lock();
+    if (res != nullptr) {
+        return res;
+    }
+    res = std::make_shared<VExchangeMux>(std::move(stub), timeout_ms);
+    mux = res;
+    if (_exchange_muxes.size() >= _exchange_mux_sweep_size) {
+        for (auto it = _exchange_muxes.begin(); it != _exchange_muxes.end();) {
+            if (it->second.expired()) {
+                it = _exchange_muxes.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _exchange_mux_sweep_size = std::max<size_t>(64, _exchange_muxes.size() * 2);
+    }
+    return res;
+}
+
 Status VDataStreamMgr::deregister_recvr(const TUniqueId& fragment_instance_id, PlanNodeId node_id) {
     std::shared_ptr<VDataStreamRecvr> targert_recvr;
     VLOG_QUERY << "deregister_recvr(): fragment_instance_id=" << fragment_instance_id
@@ -19,7 +19,10 @@
 
 #include <memory>
 #include <mutex>
+#include <map>
 #include <set>
+#include <string>
+#include <tuple>
 #include <unordered_map>
 
 #include "common/global_types.h"
@@ -39,9 +42,12 @@ class TUniqueId;
 class RuntimeProfile;
 class QueryStatisticsRecvr;
 class PTransmitDataParams;
+class PTransmitBlocksParams;
+class PBackendService_Stub;
 
 namespace vectorized {
 class VDataStreamRecvr;
+class VExchangeMux;
 
 class VDataStreamMgr {
 public:
@@ -61,6 +67,18 @@ public:
 
     Status transmit_block(const PTransmitDataParams* request, ::google::protobuf::Closure** done);
 
+    // Demultiplexes the blocks of a transmit_blocks rpc to their receivers. `done` is run once
+    // all the blocks delayed by their receivers are consumed, it's set to nullptr in that case.
+    Status transmit_blocks(const PTransmitBlocksParams* request,
+                           ::google::protobuf::Closure** done);
+
+    // Returns the exchange multiplexer of the senders of the query to the host, which is shared
+    // by the channels while any of them holds it.
+    std::shared_ptr<VExchangeMux> get_exchange_mux(const TUniqueId& query_id,
+                                                   const TNetworkAddress& address,
+                                                   std::shared_ptr<PBackendService_Stub> stub,
+                                                   int32_t timeout_ms);
+
     void cancel(const TUniqueId& fragment_instance_id);
 
 private:
@@ -87,6 +105,13 @@ private:
     FragmentStreamSet _fragment_stream_set;
 
     uint32_t get_hash_value(const TUniqueId& fragment_instance_id, PlanNodeId node_id);
+
+    std::mutex _mux_lock;
+    // (query id hi, query id lo, host:port) -> the multiplexer of the host
+    using MuxKey = std::tuple<int64_t, int64_t, std::string>;
+    std::map<MuxKey, std::weak_ptr<VExchangeMux>> _exchange_muxes;
+    // the expired multiplexers are removed once the map grows to this size
+    size_t _exchange_mux_sweep_size = 64;
 };
 } // namespace vectorized
 } // namespace doris
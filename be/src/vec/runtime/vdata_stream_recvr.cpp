@@ -17,8 +17,11 @@
 
 #include "vec/runtime/vdata_stream_recvr.h"
 
+#include <algorithm>
+
 #include "gen_cpp/data.pb.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
 #include "util/uid_util.h"
 
@@ -30,6 +33,8 @@
 
 namespace doris::vectorized {
 
+static constexpr int64_t CANCEL_CHECK_INTERVAL_MS = 100;
+
 VDataStreamRecvr::SenderQueue::SenderQueue(VDataStreamRecvr* parent_recvr, int num_senders,
                                            RuntimeProfile* profile)
         : _recvr(parent_recvr),
@@ -39,10 +44,17 @@ VDataStreamRecvr::SenderQueue::SenderQueue(VDataStreamRecvr* parent_recvr, int n
 
 VDataStreamRecvr::SenderQueue::~SenderQueue() = default;
 
+bool VDataStreamRecvr::SenderQueue::should_wait() {
+    std::lock_guard<std::mutex> l(_lock);
+    return !_is_cancelled && _block_queue.empty() && _num_remaining_senders > 0;
+}
+
 Status VDataStreamRecvr::SenderQueue::get_batch(Block** next_block) {
     std::unique_lock<std::mutex> l(_lock);
+    bool state_cancelled = false;
     // wait until something shows up or we know we're done
-    while (!_is_cancelled && _block_queue.empty() && _num_remaining_senders > 0) {
+    while (!_is_cancelled && !state_cancelled && _block_queue.empty() &&
+           _num_remaining_senders > 0) {
         VLOG_ROW << "wait arrival fragment_instance_id=" << _recvr->fragment_instance_id()
                  << " node=" << _recvr->dest_node_id();
         // Don't count time spent waiting on the sender as active time.
@@ -50,13 +62,20 @@ Status VDataStreamRecvr::SenderQueue::get_batch(Block** next_block) {
         CANCEL_SAFE_SCOPED_TIMER(
                 _received_first_batch ? NULL : _recvr->_first_batch_wait_total_timer,
                 &_is_cancelled);
-        _data_arrival_cv.wait(l);
+        // The stream is cancelled when its fragment instance is cancelled, but the instance
+        // may also stop without that, e.g. another task of its pipelines fails, so the wait is
+        // bounded to check the state.
+        _data_arrival_cv.wait_for(l, std::chrono::milliseconds(CANCEL_CHECK_INTERVAL_MS));
+        state_cancelled = _recvr->_state != nullptr && _recvr->_state->is_cancelled();
     }
 
-    // _cur_batch must be replaced with the returned batch.
-    _current_block.reset();
+    // _cur_batch must be replaced with the returned batch. It's swapped with the block of the
+    // consumer, which is recycled.
+    if (_current_block != nullptr) {
+        _recycle_block(std::move(_current_block));
+    }
     *next_block = nullptr;
-    if (_is_cancelled) {
+    if (_is_cancelled || state_cancelled) {
         return Status::Cancelled("Cancelled");
     }
 
@@ -68,15 +87,19 @@ Status VDataStreamRecvr::SenderQueue::get_batch(Block** next_block) {
     _received_first_batch = true;
 
     DCHECK(!_block_queue.empty());
-    Block* result = _block_queue.front().second;
-    _recvr->_num_buffered_bytes -= _block_queue.front().first;
+    QueuedBlock queued = _block_queue.front();
+    Block* result = queued.block;
+    _recvr->_num_buffered_bytes -= queued.bytes;
     VLOG_ROW << "fetched #rows=" << result->rows();
     _block_queue.pop_front();
 
     _current_block.reset(result);
     *next_block = _current_block.get();
 
-    if (!_pending_closures.empty()) {
+    if (queued.be_number >= 0) {
+        _sender_credits[queued.be_number].buffered_bytes -= queued.bytes;
+        _grant_credits(queued.be_number);
+    } else if (!_pending_closures.empty()) {
         auto closure_pair = _pending_closures.front();
         closure_pair.first->Run();
         _pending_closures.pop_front();
@@ -88,6 +111,48 @@ Status VDataStreamRecvr::SenderQueue::get_batch(Block** next_block) {
     return Status::OK();
 }
 
+void VDataStreamRecvr::SenderQueue::_recycle_block(std::unique_ptr<Block> block) {
+    if (_free_blocks.size() >= MAX_FREE_BLOCKS || block->columns() == 0) {
+        return;
+    }
+    for (const auto& column : block->get_columns_with_type_and_name()) {
+        if (column.column->use_count() > 1) {
+            return;
+        }
+    }
+    block->clear_column_data();
+    _free_blocks.push_back(std::move(block));
+}
+
+void VDataStreamRecvr::SenderQueue::_run_pending_closures(SenderCredit* credit) {
+    for (auto& closure_pair : credit->pending_closures) {
+        closure_pair.first->Run();
+        closure_pair.second.stop();
+        credit->blocked_ns += closure_pair.second.elapsed_time();
+        _recvr->_buffer_full_total_timer->update(closure_pair.second.elapsed_time());
+    }
+    credit->pending_closures.clear();
+    if (credit->blocked_ns > _recvr->_max_sender_blocked_timer->value()) {
+        _recvr->_max_sender_blocked_timer->set(credit->blocked_ns);
+    }
+}
+
+void VDataStreamRecvr::SenderQueue::_grant_credits(int be_number) {
+    // the sender whose block is consumed may be within its credits again
+    auto& consumed = _sender_credits[be_number];
+    if (!consumed.pending_closures.empty() &&
+        consumed.buffered_bytes <= _recvr->_sender_credit_bytes) {
+        _run_pending_closures(&consumed);
+        _blocked_senders.erase(
+                std::find(_blocked_senders.begin(), _blocked_senders.end(), be_number));
+    }
+    // the others beyond their credits may go on while the buffer isn't full
+    while (!_blocked_senders.empty() && !_recvr->exceeds_limit(0)) {
+        _run_pending_closures(&_sender_credits[_blocked_senders.front()]);
+        _blocked_senders.pop_front();
+    }
+}
+
 void VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_number,
                                               int64_t packet_seq,
                                               ::google::protobuf::Closure** done) {
@@ -122,19 +187,32 @@ void VDataStreamRecvr::SenderQueue::add_block(const PBlock& pblock, int be_numbe
     Block* block = nullptr;
     {
         SCOPED_TIMER(_recvr->_deserialize_row_batch_timer);
-        block = new Block(pblock);
+        if (_free_blocks.empty()) {
+            block = new Block(pblock);
+        } else {
+            block = _free_blocks.back().release();
+            _free_blocks.pop_back();
+            block->deserialize(pblock);
+        }
     }
     _recvr->_block_mem_tracker->consume(block->bytes());
 
     VLOG_ROW << "added #rows=" << block->rows() << " batch_size=" << block_byte_size << "\n";
-    _block_queue.emplace_back(block_byte_size, block);
+    _block_queue.push_back({static_cast<int64_t>(block_byte_size), block, be_number});
+    auto& credit = _sender_credits[be_number];
+    credit.buffered_bytes += block_byte_size;
     // if done is nullptr, this function can't delay this response
-    if (done != nullptr && _recvr->exceeds_limit(block_byte_size)) {
+    if (done != nullptr && credit.buffered_bytes > _recvr->_sender_credit_bytes &&
+        _recvr->exceeds_limit(block_byte_size)) {
         MonotonicStopWatch monotonicStopWatch;
         monotonicStopWatch.start();
         DCHECK(*done != nullptr);
-        _pending_closures.emplace_back(*done, monotonicStopWatch);
+        if (credit.pending_closures.empty()) {
+            _blocked_senders.push_back(be_number);
+        }
+        credit.pending_closures.emplace_back(*done, monotonicStopWatch);
         *done = nullptr;
+        COUNTER_UPDATE(_recvr->_sender_out_of_credit_counter, 1);
     }
     _recvr->_num_buffered_bytes += block_byte_size;
     _data_arrival_cv.notify_one();
@@ -149,19 +227,22 @@ void VDataStreamRecvr::SenderQueue::add_block(Block* block, bool use_move) {
     nblock->info = block->info;
 
     // local exchange should copy the block contented if use move == false
+    auto rows = block->rows();
     if (use_move) {
         block->clear();
-    } else {
-        auto rows = block->rows();
-        for (int i = 0; i < nblock->columns(); ++i) {
-            nblock->get_by_position(i).column =
-                    nblock->get_by_position(i).column->clone_resized(rows);
+    }
+    for (int i = 0; i < nblock->columns(); ++i) {
+        auto& column = nblock->get_by_position(i).column;
+        // a moved column is taken without copying unless someone else still refers to it,
+        // since the consumers of the queue may change the columns in place
+        if (!use_move || column->use_count() > 1) {
+            column = column->clone_resized(rows);
         }
     }
     materialize_block_inplace(*nblock);
 
     size_t block_size = nblock->bytes();
-    _block_queue.emplace_back(block_size, nblock);
+    _block_queue.push_back({static_cast<int64_t>(block_size), nblock, -1});
     _recvr->_block_mem_tracker->consume(nblock->bytes());
     _data_arrival_cv.notify_one();
 
@@ -219,6 +300,10 @@ void VDataStreamRecvr::SenderQueue::cancel() {
             closure_pair.first->Run();
         }
         _pending_closures.clear();
+        for (auto& [be_number, credit] : _sender_credits) {
+            _run_pending_closures(&credit);
+        }
+        _blocked_senders.clear();
     }
 }
 
@@ -234,22 +319,27 @@ void VDataStreamRecvr::SenderQueue::close() {
             closure_pair.first->Run();
         }
         _pending_closures.clear();
+        for (auto& [be_number, credit] : _sender_credits) {
+            _run_pending_closures(&credit);
+        }
+        _blocked_senders.clear();
     }
 
     // Delete any batches queued in _block_queue
     for (auto it = _block_queue.begin(); it != _block_queue.end(); ++it) {
-        delete it->second;
+        delete it->block;
     }
 
     _current_block.reset();
 }
 
 VDataStreamRecvr::VDataStreamRecvr(
-        VDataStreamMgr* stream_mgr, const RowDescriptor& row_desc,
+        VDataStreamMgr* stream_mgr, RuntimeState* state, const RowDescriptor& row_desc,
         const TUniqueId& fragment_instance_id, PlanNodeId dest_node_id, int num_senders,
         bool is_merging, int total_buffer_limit, RuntimeProfile* profile,
         std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr)
         : _mgr(stream_mgr),
+          _state(state),
           _fragment_instance_id(fragment_instance_id),
           _dest_node_id(dest_node_id),
           _total_buffer_limit(total_buffer_limit),
@@ -258,6 +348,7 @@ VDataStreamRecvr::VDataStreamRecvr(
           _is_closed(false),
           _num_buffered_bytes(0),
           _profile(profile),
+          _sender_credit_bytes(total_buffer_limit / std::max(num_senders, 1)),
           _sub_plan_query_statistics_recvr(sub_plan_query_statistics_recvr) {
     _mem_tracker =
             MemTracker::create_tracker(-1, "VDataStreamRecvr:" + print_id(_fragment_instance_id),
@@ -283,6 +374,8 @@ VDataStreamRecvr::VDataStreamRecvr(
     _data_arrival_timer = ADD_TIMER(_profile, "DataArrivalWaitTime");
     _buffer_full_total_timer = ADD_TIMER(_profile, "SendersBlockedTotalTimer(*)");
     _first_batch_wait_total_timer = ADD_TIMER(_profile, "FirstBatchArrivalWaitTime");
+    _sender_out_of_credit_counter = ADD_COUNTER(_profile, "SendersOutOfCredit", TUnit::UNIT);
+    _max_sender_blocked_timer = ADD_TIMER(_profile, "MaxSenderBlockedTime");
 }
 
 VDataStreamRecvr::~VDataStreamRecvr() {
@@ -345,6 +438,15 @@ Status VDataStreamRecvr::get_next(Block* block, bool* eos) {
     return Status::OK();
 }
 
+bool VDataStreamRecvr::ready_to_read() {
+    // Which sender queue the merger reads next depends on the data, waiting for all of
+    // them may never end because the senders share the buffer limit, so let it block.
+    if (_is_merging) {
+        return true;
+    }
+    return !_sender_queues[0]->should_wait();
+}
+
 void VDataStreamRecvr::remove_sender(int sender_id, int be_number) {
     int use_sender_id = _is_merging ? sender_id : 0;
     _sender_queues[use_sender_id]->decrement_senders(be_number);
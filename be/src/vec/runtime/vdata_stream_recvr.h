@@ -40,6 +40,7 @@ class Closure;
 namespace doris {
 class MemTracker;
 class RuntimeProfile;
+class RuntimeState;
 class PBlock;
 
 namespace vectorized {
@@ -50,10 +51,10 @@ class VExprContext;
 
 class VDataStreamRecvr {
 public:
-    VDataStreamRecvr(VDataStreamMgr* stream_mgr, const RowDescriptor& row_desc,
-                     const TUniqueId& fragment_instance_id, PlanNodeId dest_node_id,
-                     int num_senders, bool is_merging, int total_buffer_limit,
-                     RuntimeProfile* profile,
+    VDataStreamRecvr(VDataStreamMgr* stream_mgr, RuntimeState* state,
+                     const RowDescriptor& row_desc, const TUniqueId& fragment_instance_id,
+                     PlanNodeId dest_node_id, int num_senders, bool is_merging,
+                     int total_buffer_limit, RuntimeProfile* profile,
                      std::shared_ptr<QueryStatisticsRecvr> sub_plan_query_statistics_recvr);
 
     ~VDataStreamRecvr();
@@ -70,6 +71,9 @@ public:
 
     Status get_next(Block* block, bool* eos);
 
+    // Return true if get_next() can return without waiting for the senders.
+    bool ready_to_read();
+
     const TUniqueId& fragment_instance_id() const { return _fragment_instance_id; }
     PlanNodeId dest_node_id() const { return _dest_node_id; }
     const RowDescriptor& row_desc() const { return _row_desc; }
@@ -97,6 +101,9 @@ private:
 
     // DataStreamMgr instance used to create this recvr. (Not owned)
     VDataStreamMgr* _mgr;
+    // the state of the fragment instance of the exchange node, the receiver stops waiting for
+    // the blocks once it's cancelled
+    RuntimeState* _state;
 
     // Fragment and node id of the destination exchange node this receiver is used by.
     TUniqueId _fragment_instance_id;
@@ -130,6 +137,14 @@ private:
     RuntimeProfile::Counter* _first_batch_wait_total_timer;
     RuntimeProfile::Counter* _buffer_full_total_timer;
     RuntimeProfile::Counter* _data_arrival_timer;
+    // the times a sender runs out of its credits, and the longest time a sender is blocked
+    RuntimeProfile::Counter* _sender_out_of_credit_counter;
+    RuntimeProfile::Counter* _max_sender_blocked_timer;
+
+    // The byte credits granted to each remote sender, its buffered blocks within them never
+    // block it. A sender beyond its credits is blocked only while the buffer of the stream is
+    // also full, so a sender flooding the stream doesn't block the others.
+    int64_t _sender_credit_bytes;
 
     std::shared_ptr<QueryStatisticsRecvr> _sub_plan_query_statistics_recvr;
 };
@@ -151,6 +166,9 @@ public:
 
     Status get_batch(Block** next_block);
 
+    // Return true if get_batch() has to wait for the senders.
+    bool should_wait();
+
     void add_block(const PBlock& pblock, int be_number, int64_t packet_seq,
                    ::google::protobuf::Closure** done);
 
@@ -172,16 +190,45 @@ private:
     std::condition_variable _data_arrival_cv;
     std::condition_variable _data_removal_cv;
 
-    using VecBlockQueue = std::list<std::pair<int, Block*>>;
+    struct QueuedBlock {
+        int64_t bytes;
+        Block* block;
+        // the be_number of the remote sender, -1 if its sender is local
+        int be_number;
+    };
+    using VecBlockQueue = std::list<QueuedBlock>;
     VecBlockQueue _block_queue;
 
+    struct SenderCredit {
+        // the bytes of the blocks of the sender in _block_queue
+        int64_t buffered_bytes = 0;
+        // the closures of the rpcs delayed since the sender is out of its credits
+        std::deque<std::pair<google::protobuf::Closure*, MonotonicStopWatch>> pending_closures;
+        int64_t blocked_ns = 0;
+    };
+    // Runs the delayed closures of the senders which may send again, with _lock held.
+    void _grant_credits(int be_number);
+    void _run_pending_closures(SenderCredit* credit);
+
+    // be_number => the credits of the remote sender
+    std::unordered_map<int, SenderCredit> _sender_credits;
+    // the be_numbers of the senders out of their credits, in the order they were blocked
+    std::deque<int> _blocked_senders;
+
     std::unique_ptr<Block> _current_block;
+    // The blocks handed back by the consumer, the received blocks are deserialized into them to
+    // reuse their columns with the capacity.
+    static constexpr size_t MAX_FREE_BLOCKS = 4;
+    std::vector<std::unique_ptr<Block>> _free_blocks;
+    // Keep the block for the next received block if its columns are not shared, with _lock held.
+    void _recycle_block(std::unique_ptr<Block> block);
 
     bool _received_first_batch;
     // sender_id
     std::unordered_set<int> _sender_eos_set;
     // be_number => packet_seq
     std::unordered_map<int, int64_t> _packet_seq_map;
+    // the closures of the blocked local senders
     std::deque<std::pair<google::protobuf::Closure*, MonotonicStopWatch>> _pending_closures;
     std::unordered_map<std::thread::id, std::unique_ptr<ThreadClosure>> _local_closure;
 };
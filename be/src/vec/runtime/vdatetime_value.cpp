@@ -24,6 +24,7 @@
 #include <limits>
 #include <sstream>
 
+#include "common/compiler_util.h"
 #include "util/timezone_utils.h"
 #include "runtime/datetime_value.h"
 
@@ -612,11 +613,8 @@ int VecDateTimeValue::compute_format_len(const char* format, int len) {
 }
 
 bool VecDateTimeValue::to_format_string(const char* format, int len, char* to) const {
-    char buf[64];
-    char* pos = NULL;
     const char* ptr = format;
     const char* end = format + len;
-    char ch = '\0';
 
     while (ptr < end) {
         if (*ptr != '%' || (ptr + 1) == end) {
@@ -625,241 +623,393 @@ bool VecDateTimeValue::to_format_string(const char* format, int len, char* to) c
         }
         // Skip '%'
         ptr++;
-        switch (ch = *ptr++) {
-        case 'a':
-            // Abbreviated weekday name
-            if (_type == TIME_TIME || (_year == 0 && _month == 0)) {
-                return false;
+        to = append_format_spec(*ptr++, to);
+        if (to == nullptr) {
+            return false;
+        }
+    }
+    *to++ = '\0';
+    return true;
+}
+
+char* VecDateTimeValue::append_format_spec(char spec, char* to) const {
+    char buf[64];
+    char* pos = nullptr;
+    switch (spec) {
+    case 'a':
+        // Abbreviated weekday name
+        if (_type == TIME_TIME || (_year == 0 && _month == 0)) {
+            return nullptr;
+        }
+        to = append_string(s_ab_day_name[weekday()], to);
+        break;
+    case 'b':
+        // Abbreviated month name
+        if (_month == 0) {
+            return nullptr;
+        }
+        to = append_string(s_ab_month_name[_month], to);
+        break;
+    case 'c':
+        // Month, numeric (0...12)
+        pos = int_to_str(_month, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        break;
+    case 'd':
+        // Day of month (00...31)
+        pos = int_to_str(_day, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'D':
+        // Day of the month with English suffix (0th, 1st, ...)
+        pos = int_to_str(_day, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        if (_day >= 10 && _day <= 19) {
+            to = append_string("th", to);
+        } else {
+            switch (_day % 10) {
+            case 1:
+                to = append_string("st", to);
+                break;
+            case 2:
+                to = append_string("nd", to);
+                break;
+            case 3:
+                to = append_string("rd", to);
+                break;
+            default:
+                to = append_string("th", to);
+                break;
             }
-            to = append_string(s_ab_day_name[weekday()], to);
-            break;
-        case 'b':
-            // Abbreviated month name
-            if (_month == 0) {
-                return false;
+        }
+        break;
+    case 'e':
+        // Day of the month, numeric (0..31)
+        pos = int_to_str(_day, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        break;
+    case 'f':
+        // Microseconds (000000..999999)
+        pos = int_to_str(0, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 6, to);
+        break;
+    case 'h':
+    case 'I':
+        // Hour (01..12)
+        pos = int_to_str((_hour % 24 + 11) % 12 + 1, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'H':
+        // Hour (00..23)
+        pos = int_to_str(_hour, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'i':
+        // Minutes, numeric (00..59)
+        pos = int_to_str(_minute, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'j':
+        // Day of year (001..366)
+        pos = int_to_str(daynr() - calc_daynr(_year, 1, 1) + 1, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 3, to);
+        break;
+    case 'k':
+        // Hour (0..23)
+        pos = int_to_str(_hour, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        break;
+    case 'l':
+        // Hour (1..12)
+        pos = int_to_str((_hour % 24 + 11) % 12 + 1, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        break;
+    case 'm':
+        // Month, numeric (00..12)
+        pos = int_to_str(_month, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'M':
+        // Month name (January..December)
+        if (_month == 0) {
+            return nullptr;
+        }
+        to = append_string(s_month_name[_month], to);
+        break;
+    case 'p':
+        // AM or PM
+        if ((_hour % 24) >= 12) {
+            to = append_string("PM", to);
+        } else {
+            to = append_string("AM", to);
+        }
+        break;
+    case 'r':
+        // Time, 12-hour (hh:mm:ss followed by AM or PM)
+        *to++ = (char)('0' + (((_hour + 11) % 12 + 1) / 10));
+        *to++ = (char)('0' + (((_hour + 11) % 12 + 1) % 10));
+        *to++ = ':';
+        // Minute
+        *to++ = (char)('0' + (_minute / 10));
+        *to++ = (char)('0' + (_minute % 10));
+        *to++ = ':';
+        /* Second */
+        *to++ = (char)('0' + (_second / 10));
+        *to++ = (char)('0' + (_second % 10));
+        if ((_hour % 24) >= 12) {
+            to = append_string(" PM", to);
+        } else {
+            to = append_string(" AM", to);
+        }
+        break;
+    case 's':
+    case 'S':
+        // Seconds (00..59)
+        pos = int_to_str(_second, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'T':
+        // Time, 24-hour (hh:mm:ss)
+        *to++ = (char)('0' + ((_hour % 24) / 10));
+        *to++ = (char)('0' + ((_hour % 24) % 10));
+        *to++ = ':';
+        // Minute
+        *to++ = (char)('0' + (_minute / 10));
+        *to++ = (char)('0' + (_minute % 10));
+        *to++ = ':';
+        /* Second */
+        *to++ = (char)('0' + (_second / 10));
+        *to++ = (char)('0' + (_second % 10));
+        break;
+    case 'u':
+        // Week (00..53), where Monday is the first day of the week;
+        // WEEK() mode 1
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        pos = int_to_str(week(mysql_week_mode(1)), buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'U':
+        // Week (00..53), where Sunday is the first day of the week;
+        // WEEK() mode 0
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        pos = int_to_str(week(mysql_week_mode(0)), buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'v':
+        // Week (01..53), where Monday is the first day of the week;
+        // WEEK() mode 3; used with %x
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        pos = int_to_str(week(mysql_week_mode(3)), buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'V':
+        // Week (01..53), where Sunday is the first day of the week;
+        // WEEK() mode 2; used with %X
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        pos = int_to_str(week(mysql_week_mode(2)), buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'w':
+        // Day of the week (0=Sunday..6=Saturday)
+        if (_type == TIME_TIME || (_month == 0 && _year == 0)) {
+            return nullptr;
+        }
+        pos = int_to_str(calc_weekday(daynr(), true), buf);
+        to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        break;
+    case 'W':
+        // Weekday name (Sunday..Saturday)
+        to = append_string(s_day_name[weekday()], to);
+        break;
+    case 'x': {
+        // Year for the week, where Monday is the first day of the week,
+        // numeric, four digits; used with %v
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        uint32_t year = 0;
+        calc_week(*this, mysql_week_mode(3), &year);
+        pos = int_to_str(year, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 4, to);
+        break;
+    }
+    case 'X': {
+        // Year for the week where Sunday is the first day of the week,
+        // numeric, four digits; used with %V
+        if (_type == TIME_TIME) {
+            return nullptr;
+        }
+        uint32_t year = 0;
+        calc_week(*this, mysql_week_mode(2), &year);
+        pos = int_to_str(year, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 4, to);
+        break;
+    }
+    case 'y':
+        // Year, numeric (two digits)
+        pos = int_to_str(_year % 100, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 2, to);
+        break;
+    case 'Y':
+        // Year, numeric, four digits
+        pos = int_to_str(_year, buf);
+        to = append_with_prefix(buf, pos - buf, '0', 4, to);
+        break;
+    default:
+        *to++ = spec;
+        break;
+    }
+    return to;
+}
+
+// The max length of the output of a format specifier of append_format_spec()
+static size_t max_format_spec_size(char spec) {
+    switch (spec) {
+    case 'a':
+    case 'b':
+    case 'c':
+    case 'd':
+    case 'e':
+    case 'H':
+    case 'i':
+    case 'k':
+    case 'm':
+    case 'u':
+    case 'U':
+    case 'v':
+    case 'V':
+        return 3;
+    case 'h':
+    case 'I':
+    case 'l':
+    case 'p':
+    case 'y':
+        return 2;
+    case 's':
+    case 'S':
+        return 4;
+    case 'D':
+    case 'x':
+    case 'X':
+    case 'Y':
+        return 5;
+    case 'f':
+        return 6;
+    case 'T':
+        return 8;
+    case 'M':
+    case 'W':
+        return 9;
+    case 'r':
+        return 11;
+    case 'j':
+        return 20;
+    case 'w':
+    default:
+        return 1;
+    }
+}
+
+VecDateTimeFormat::VecDateTimeFormat(std::string_view format) {
+    auto append_literal = [this](char ch) {
+        // merge the adjacent literals into one item
+        if (_items.empty() || _items.back().spec != 0) {
+            _items.push_back({0, static_cast<uint32_t>(_literals.size()), 0});
+        }
+        _literals.push_back(ch);
+        _items.back().len++;
+        _max_size++;
+    };
+
+    const char* ptr = format.data();
+    const char* end = format.data() + format.size();
+    while (ptr < end) {
+        if (*ptr != '%' || (ptr + 1) == end) {
+            append_literal(*ptr++);
+            continue;
+        }
+        const char spec = *(ptr + 1);
+        ptr += 2;
+        if (spec == 0) {
+            // "%\0" outputs '\0' itself
+            append_literal(spec);
+            continue;
+        }
+        _items.push_back({spec, 0, 0});
+        _max_size += max_format_spec_size(spec);
+    }
+}
+
+static inline char* append_two_digits(uint32_t value, char* to) {
+    *to++ = '0' + value / 10;
+    *to++ = '0' + value % 10;
+    return to;
+}
+
+char* VecDateTimeFormat::format(const VecDateTimeValue& value, char* to) const {
+    for (const auto& item : _items) {
+        // the most common specifiers, whose output has a fixed width for a valid value, are
+        // written directly, and the others fall back to the same code as to_format_string
+        switch (item.spec) {
+        case 0:
+            memcpy(to, _literals.data() + item.offset, item.len);
+            to += item.len;
+            continue;
+        case 'Y':
+            if (LIKELY(value._year < 10000)) {
+                to = append_two_digits(value._year / 100, to);
+                to = append_two_digits(value._year % 100, to);
+                continue;
             }
-            to = append_string(s_ab_month_name[_month], to);
             break;
-        case 'c':
-            // Month, numeric (0...12)
-            pos = int_to_str(_month, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
+        case 'm':
+            if (LIKELY(value._month < 100)) {
+                to = append_two_digits(value._month, to);
+                continue;
+            }
             break;
         case 'd':
-            // Day of month (00...31)
-            pos = int_to_str(_day, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'D':
-            // Day of the month with English suffix (0th, 1st, ...)
-            pos = int_to_str(_day, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
-            if (_day >= 10 && _day <= 19) {
-                to = append_string("th", to);
-            } else {
-                switch (_day % 10) {
-                case 1:
-                    to = append_string("st", to);
-                    break;
-                case 2:
-                    to = append_string("nd", to);
-                    break;
-                case 3:
-                    to = append_string("rd", to);
-                    break;
-                default:
-                    to = append_string("th", to);
-                    break;
-                }
+            if (LIKELY(value._day < 100)) {
+                to = append_two_digits(value._day, to);
+                continue;
             }
             break;
-        case 'e':
-            // Day of the month, numeric (0..31)
-            pos = int_to_str(_day, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
-            break;
-        case 'f':
-            // Microseconds (000000..999999)
-            pos = int_to_str(0, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 6, to);
-            break;
-        case 'h':
-        case 'I':
-            // Hour (01..12)
-            pos = int_to_str((_hour % 24 + 11) % 12 + 1, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
         case 'H':
-            // Hour (00..23)
-            pos = int_to_str(_hour, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'i':
-            // Minutes, numeric (00..59)
-            pos = int_to_str(_minute, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'j':
-            // Day of year (001..366)
-            pos = int_to_str(daynr() - calc_daynr(_year, 1, 1) + 1, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 3, to);
-            break;
-        case 'k':
-            // Hour (0..23)
-            pos = int_to_str(_hour, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
-            break;
-        case 'l':
-            // Hour (1..12)
-            pos = int_to_str((_hour % 24 + 11) % 12 + 1, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
-            break;
-        case 'm':
-            // Month, numeric (00..12)
-            pos = int_to_str(_month, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'M':
-            // Month name (January..December)
-            if (_month == 0) {
-                return false;
-            }
-            to = append_string(s_month_name[_month], to);
-            break;
-        case 'p':
-            // AM or PM
-            if ((_hour % 24) >= 12) {
-                to = append_string("PM", to);
-            } else {
-                to = append_string("AM", to);
+            if (LIKELY(value._hour < 100)) {
+                to = append_two_digits(value._hour, to);
+                continue;
             }
             break;
-        case 'r':
-            // Time, 12-hour (hh:mm:ss followed by AM or PM)
-            *to++ = (char)('0' + (((_hour + 11) % 12 + 1) / 10));
-            *to++ = (char)('0' + (((_hour + 11) % 12 + 1) % 10));
-            *to++ = ':';
-            // Minute
-            *to++ = (char)('0' + (_minute / 10));
-            *to++ = (char)('0' + (_minute % 10));
-            *to++ = ':';
-            /* Second */
-            *to++ = (char)('0' + (_second / 10));
-            *to++ = (char)('0' + (_second % 10));
-            if ((_hour % 24) >= 12) {
-                to = append_string(" PM", to);
-            } else {
-                to = append_string(" AM", to);
+        case 'i':
+            if (LIKELY(value._minute < 100)) {
+                to = append_two_digits(value._minute, to);
+                continue;
             }
             break;
         case 's':
         case 'S':
-            // Seconds (00..59)
-            pos = int_to_str(_second, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'T':
-            // Time, 24-hour (hh:mm:ss)
-            *to++ = (char)('0' + ((_hour % 24) / 10));
-            *to++ = (char)('0' + ((_hour % 24) % 10));
-            *to++ = ':';
-            // Minute
-            *to++ = (char)('0' + (_minute / 10));
-            *to++ = (char)('0' + (_minute % 10));
-            *to++ = ':';
-            /* Second */
-            *to++ = (char)('0' + (_second / 10));
-            *to++ = (char)('0' + (_second % 10));
-            break;
-        case 'u':
-            // Week (00..53), where Monday is the first day of the week;
-            // WEEK() mode 1
-            if (_type == TIME_TIME) {
-                return false;
-            }
-            pos = int_to_str(week(mysql_week_mode(1)), buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'U':
-            // Week (00..53), where Sunday is the first day of the week;
-            // WEEK() mode 0
-            if (_type == TIME_TIME) {
-                return false;
-            }
-            pos = int_to_str(week(mysql_week_mode(0)), buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'v':
-            // Week (01..53), where Monday is the first day of the week;
-            // WEEK() mode 3; used with %x
-            if (_type == TIME_TIME) {
-                return false;
-            }
-            pos = int_to_str(week(mysql_week_mode(3)), buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'V':
-            // Week (01..53), where Sunday is the first day of the week;
-            // WEEK() mode 2; used with %X
-            if (_type == TIME_TIME) {
-                return false;
+            if (LIKELY(value._second < 100)) {
+                to = append_two_digits(value._second, to);
+                continue;
             }
-            pos = int_to_str(week(mysql_week_mode(2)), buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'w':
-            // Day of the week (0=Sunday..6=Saturday)
-            if (_type == TIME_TIME || (_month == 0 && _year == 0)) {
-                return false;
-            }
-            pos = int_to_str(calc_weekday(daynr(), true), buf);
-            to = append_with_prefix(buf, pos - buf, '0', 1, to);
-            break;
-        case 'W':
-            // Weekday name (Sunday..Saturday)
-            to = append_string(s_day_name[weekday()], to);
-            break;
-        case 'x': {
-            // Year for the week, where Monday is the first day of the week,
-            // numeric, four digits; used with %v
-            if (_type == TIME_TIME) {
-                return false;
-            }
-            uint32_t year = 0;
-            calc_week(*this, mysql_week_mode(3), &year);
-            pos = int_to_str(year, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 4, to);
-            break;
-        }
-        case 'X': {
-            // Year for the week where Sunday is the first day of the week,
-            // numeric, four digits; used with %V
-            if (_type == TIME_TIME) {
-                return false;
-            }
-            uint32_t year = 0;
-            calc_week(*this, mysql_week_mode(2), &year);
-            pos = int_to_str(year, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 4, to);
-            break;
-        }
-        case 'y':
-            // Year, numeric (two digits)
-            pos = int_to_str(_year % 100, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 2, to);
-            break;
-        case 'Y':
-            // Year, numeric, four digits
-            pos = int_to_str(_year, buf);
-            to = append_with_prefix(buf, pos - buf, '0', 4, to);
             break;
         default:
-            *to++ = ch;
             break;
         }
+        to = value.append_format_spec(item.spec, to);
+        if (to == nullptr) {
+            return nullptr;
+        }
     }
-    *to++ = '\0';
-    return true;
+    return to;
 }
 
 uint8_t VecDateTimeValue::calc_week(const VecDateTimeValue& value, uint8_t mode, uint32_t* year) {
@@ -1554,6 +1704,20 @@ bool VecDateTimeValue::from_unixtime(int64_t timestamp, const cctz::time_zone& c
     return true;
 }
 
+void VecDateTimeValue::from_unixtime_with_offset(int64_t timestamp, int64_t utc_offset) {
+    static const cctz::civil_second epoch(1970, 1, 1, 0, 0, 0);
+    const cctz::civil_second cs = epoch + (timestamp + utc_offset);
+
+    _neg = 0;
+    _type = TIME_DATETIME;
+    _year = cs.year();
+    _month = cs.month();
+    _day = cs.day();
+    _hour = cs.hour();
+    _minute = cs.minute();
+    _second = cs.second();
+}
+
 const char* VecDateTimeValue::month_name() const {
     if (_month < 1 || _month > 12) {
         return NULL;
@@ -24,6 +24,9 @@
 #include <chrono>
 #include <cstddef>
 #include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "cctz/civil_time.h"
 #include "cctz/time_zone.h"
@@ -449,6 +452,8 @@ public:
     //timestamp is an internal timestamp value representing seconds since '1970-01-01 00:00:00' UTC
     bool from_unixtime(int64_t, const std::string& timezone);
     bool from_unixtime(int64_t, const cctz::time_zone& ctz);
+    // same as from_unixtime(), with the utc offset in seconds of the timezone at the timestamp
+    void from_unixtime_with_offset(int64_t timestamp, int64_t utc_offset);
 
     bool operator==(const VecDateTimeValue& other) const {
         // NOTE: This is not same with MySQL.
@@ -568,6 +573,7 @@ public:
 private:
     // Used to make sure sizeof VecDateTimeValue
     friend class UnusedClass;
+    friend class VecDateTimeFormat;
 
     void from_packed_time(int64_t packed_time) {
         int64_t ymdhms = packed_time >> 24;
@@ -631,6 +637,10 @@ private:
     bool from_date_format_str(const char* format, int format_len, const char* value, int value_len,
                               const char** sub_val_end);
 
+    // Append the output of the format specifier `spec` (the char after '%') to `to`, return the
+    // end of the output, or nullptr if this value can't be formatted by the specifier.
+    char* append_format_spec(char spec, char* to) const;
+
     // 1 bits for neg. 3 bits for type. 12bit for second
     uint16_t _neg : 1;  // Used for time value.
     uint16_t _type : 3; // Which type of this value.
@@ -659,6 +669,33 @@ private:
 // only support DATE - DATE (no support DATETIME - DATETIME)
 std::size_t operator-(const VecDateTimeValue& v1, const VecDateTimeValue& v2);
 
+// A format string of to_format_string() compiled once into a sequence of literals and
+// specifiers, to format many values without parsing the format string again.
+class VecDateTimeFormat {
+public:
+    explicit VecDateTimeFormat(std::string_view format);
+
+    // Format `value` into `to`, which must have at least max_size() bytes. Return the end of
+    // the output (not terminated by '\0'), or nullptr if `value` can't be formatted, the same
+    // as to_format_string() returns false.
+    char* format(const VecDateTimeValue& value, char* to) const;
+
+    // the max length of the output of any value
+    size_t max_size() const { return _max_size; }
+
+private:
+    struct Item {
+        // the char after '%', or 0 for the literal chars _literals[offset, offset + len)
+        char spec;
+        uint32_t offset;
+        uint32_t len;
+    };
+
+    std::string _literals;
+    std::vector<Item> _items;
+    size_t _max_size = 0;
+};
+
 std::ostream& operator<<(std::ostream& os, const VecDateTimeValue& value);
 
 std::size_t hash_value(VecDateTimeValue const& value);
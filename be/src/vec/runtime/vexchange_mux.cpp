@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/runtime/vexchange_mux.h"
+
+#include <fmt/format.h>
+
+#include "service/backend_options.h"
+#include "service/brpc.h"
+
+namespace doris {
+namespace vectorized {
+
+Status VExchangeMux::Request::wait() {
+    std::unique_lock<std::mutex> l(_lock);
+    _cv.wait(l, [this] { return !_in_flight; });
+    return _status;
+}
+
+void VExchangeMux::Request::_finish(const Status& status) {
+    std::lock_guard<std::mutex> l(_lock);
+    _status = status;
+    _in_flight = false;
+    _cv.notify_all();
+}
+
+class VExchangeMux::BatchClosure : public google::protobuf::Closure {
+public:
+    BatchClosure(std::shared_ptr<VExchangeMux> mux, std::vector<Request*> requests)
+            : _mux(std::move(mux)), _requests(std::move(requests)) {}
+
+    void Run() override {
+        // the blocks are still owned by the channels
+        for (auto& params : *request.mutable_params()) {
+            if (params.has_block()) {
+                params.release_block();
+            }
+        }
+        Status status;
+        if (cntl.Failed()) {
+            std::string err = fmt::format(
+                    "failed to send brpc batch, error={}, error_text={}, client: {}",
+                    berror(cntl.ErrorCode()), cntl.ErrorText(), BackendOptions::get_localhost());
+            LOG(WARNING) << err;
+            status = Status::ThriftRpcError(err);
+        }
+        for (auto r : _requests) {
+            r->_finish(status);
+        }
+        _mux->_batch_done();
+        delete this;
+    }
+
+    brpc::Controller cntl;
+    PTransmitBlocksParams request;
+    PTransmitDataResult result;
+
+private:
+    std::shared_ptr<VExchangeMux> _mux;
+    std::vector<Request*> _requests;
+};
+
+void VExchangeMux::transmit(PTransmitDataParams* params, Request* request) {
+    {
+        std::lock_guard<std::mutex> l(request->_lock);
+        DCHECK(!request->_in_flight);
+        request->_params = params;
+        request->_in_flight = true;
+        request->_status = Status::OK();
+    }
+    std::vector<Request*> requests;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        _pending.push_back(request);
+        if (_in_flight) {
+            return;
+        }
+        _in_flight = true;
+        requests.swap(_pending);
+    }
+    _send_batch(std::move(requests));
+}
+
+void VExchangeMux::_send_batch(std::vector<Request*> requests) {
+    auto closure = new BatchClosure(shared_from_this(), requests);
+    for (auto r : requests) {
+        auto params = closure->request.add_params();
+        // share the block of the channel instead of copying it
+        PBlock* block = r->_params->has_block() ? r->_params->release_block() : nullptr;
+        params->CopyFrom(*r->_params);
+        if (block != nullptr) {
+            r->_params->set_allocated_block(block);
+            params->set_allocated_block(block);
+        }
+    }
+    closure->cntl.set_timeout_ms(_timeout_ms);
+    _stub->transmit_blocks(&closure->cntl, &closure->request, &closure->result, closure);
+}
+
+void VExchangeMux::_batch_done() {
+    std::vector<Request*> requests;
+    {
+        std::lock_guard<std::mutex> l(_lock);
+        if (_pending.empty()) {
+            _in_flight = false;
+            return;
+        }
+        requests.swap(_pending);
+    }
+    _send_batch(std::move(requests));
+}
+
+} // namespace vectorized
+} // namespace doris
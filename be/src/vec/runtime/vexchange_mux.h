@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/internal_service.pb.h"
+
+namespace doris {
+namespace vectorized {
+
+// Merges the blocks sent by the channels of all the local senders of a query to the same host
+// into one transmit_blocks rpc, which is demultiplexed by VDataStreamMgr::transmit_blocks. At
+// most one rpc is in flight for a host, the blocks transmitted meanwhile are sent together by
+// the next rpc once it finishes, so the small packets of the busy channels are batched without
+// delaying an idle channel by a timer.
+class VExchangeMux : public std::enable_shared_from_this<VExchangeMux> {
+public:
+    // The rpc state of a channel, a channel has at most one request in flight.
+    class Request {
+    public:
+        // Waits until the rpc carrying the last transmitted params finishes, and returns its
+        // status. Returns OK at once if nothing is in flight.
+        Status wait();
+
+    private:
+        friend class VExchangeMux;
+
+        void _finish(const Status& status);
+
+        PTransmitDataParams* _params = nullptr;
+        std::mutex _lock;
+        std::condition_variable _cv;
+        bool _in_flight = false;
+        Status _status;
+    };
+
+    VExchangeMux(std::shared_ptr<PBackendService_Stub> stub, int32_t timeout_ms)
+            : _stub(std::move(stub)), _timeout_ms(timeout_ms) {}
+
+    // Sends `params` with the ones of the other channels. `params` (and its block, which must
+    // hold its column values) can't be changed or released until request->wait() returns.
+    void transmit(PTransmitDataParams* params, Request* request);
+
+private:
+    class BatchClosure;
+
+    void _send_batch(std::vector<Request*> requests);
+    void _batch_done();
+
+    std::shared_ptr<PBackendService_Stub> _stub;
+    int32_t _timeout_ms;
+
+    std::mutex _lock;
+    bool _in_flight = false;
+    // the requests transmitted while an rpc is in flight
+    std::vector<Request*> _pending;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -0,0 +1,427 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/runtime/vfile_result_writer.h"
+
+#include "common/consts.h"
+#include "exec/broker_writer.h"
+#include "exec/hdfs_reader_writer.h"
+#include "exec/local_file_writer.h"
+#include "exec/s3_writer.h"
+#include "gen_cpp/PaloInternalService_types.h"
+#include "gutil/strings/substitute.h"
+#include "runtime/buffer_control_block.h"
+#include "runtime/primitive_type.h"
+#include "service/backend_options.h"
+#include "util/file_utils.h"
+#include "util/mysql_row_buffer.h"
+#include "util/uid_util.h"
+#include "util/url_coding.h"
+#include "vec/columns/column_complex.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/common/assert_cast.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vexpr_context.h"
+#include "vec/runtime/vparquet_writer.h"
+
+namespace doris::vectorized {
+
+const size_t VFileResultWriter::OUTSTREAM_BUFFER_SIZE_BYTES = 1024 * 1024;
+
+VFileResultWriter::VFileResultWriter(const ResultFileOptions* file_opts,
+                                     const TStorageBackendType::type storage_type,
+                                     const TUniqueId fragment_instance_id,
+                                     const std::vector<VExprContext*>& output_vexpr_ctxs,
+                                     RuntimeProfile* parent_profile, BufferControlBlock* sinker,
+                                     bool output_object_data)
+        : _file_opts(file_opts),
+          _storage_type(storage_type),
+          _fragment_instance_id(fragment_instance_id),
+          _output_vexpr_ctxs(output_vexpr_ctxs),
+          _parent_profile(parent_profile),
+          _sinker(sinker) {
+    _output_object_data = output_object_data;
+}
+
+VFileResultWriter::~VFileResultWriter() {
+    _close_file_writer(true, true);
+}
+
+Status VFileResultWriter::init(RuntimeState* state) {
+    _state = state;
+    _init_profile();
+    return _create_next_file_writer();
+}
+
+void VFileResultWriter::_init_profile() {
+    RuntimeProfile* profile = _parent_profile->create_child("VFileResultWriter", true, true);
+    _append_row_batch_timer = ADD_TIMER(profile, "AppendBatchTime");
+    _convert_tuple_timer = ADD_CHILD_TIMER(profile, "TupleConvertTime", "AppendBatchTime");
+    _file_write_timer = ADD_CHILD_TIMER(profile, "FileWriteTime", "AppendBatchTime");
+    _writer_close_timer = ADD_TIMER(profile, "FileWriterCloseTime");
+    _written_rows_counter = ADD_COUNTER(profile, "NumWrittenRows", TUnit::UNIT);
+    _written_data_bytes = ADD_COUNTER(profile, "WrittenDataBytes", TUnit::BYTES);
+}
+
+Status VFileResultWriter::_create_success_file() {
+    std::string file_name;
+    RETURN_IF_ERROR(_get_success_file_name(&file_name));
+    RETURN_IF_ERROR(_create_file_writer(file_name));
+    return _close_file_writer(true, true);
+}
+
+Status VFileResultWriter::_get_success_file_name(std::string* file_name) {
+    std::stringstream ss;
+    ss << _file_opts->file_path << _file_opts->success_file_name;
+    *file_name = ss.str();
+    if (_storage_type == TStorageBackendType::LOCAL) {
+        // For local file writer, the file_path is a local dir.
+        // Here we do a simple security verification by checking whether the file exists.
+        // This is just to prevent overwriting the existing file.
+        if (FileUtils::check_exist(*file_name)) {
+            return Status::InternalError("File already exists: " + *file_name +
+                                         ". Host: " + BackendOptions::get_localhost());
+        }
+    }
+    return Status::OK();
+}
+
+Status VFileResultWriter::_create_next_file_writer() {
+    std::string file_name;
+    RETURN_IF_ERROR(_get_next_file_name(&file_name));
+    return _create_file_writer(file_name);
+}
+
+Status VFileResultWriter::_create_file_writer(const std::string& file_name) {
+    if (_storage_type == TStorageBackendType::LOCAL) {
+        _file_writer = new LocalFileWriter(file_name, 0 /* start offset */);
+    } else if (_storage_type == TStorageBackendType::BROKER) {
+        _file_writer =
+                new BrokerWriter(_state->exec_env(), _file_opts->broker_addresses,
+                                 _file_opts->broker_properties, file_name, 0 /*start offset*/);
+    } else if (_storage_type == TStorageBackendType::S3) {
+        _file_writer = new S3Writer(_file_opts->broker_properties, file_name, 0 /* offset */);
+    } else if (_storage_type == TStorageBackendType::HDFS) {
+        RETURN_IF_ERROR(HdfsReaderWriter::create_writer(
+                const_cast<std::map<std::string, std::string>&>(_file_opts->broker_properties),
+                file_name, &_file_writer));
+    }
+    RETURN_IF_ERROR(_file_writer->open());
+    switch (_file_opts->file_format) {
+    case TFileFormatType::FORMAT_CSV_PLAIN:
+        // just use file writer is enough
+        break;
+    case TFileFormatType::FORMAT_PARQUET:
+        _parquet_writer.reset(new VParquetWriterWrapper(_file_writer, _output_vexpr_ctxs,
+                                                        _file_opts->file_properties,
+                                                        _file_opts->schema));
+        RETURN_IF_ERROR(_parquet_writer->init());
+        break;
+    default:
+        return Status::InternalError(
+                strings::Substitute("unsupported file format: $0", _file_opts->file_format));
+    }
+    LOG(INFO) << "create file for exporting query result. file name: " << file_name
+              << ". query id: " << print_id(_state->query_id())
+              << " format:" << _file_opts->file_format;
+    return Status::OK();
+}
+
+// file name format as: my_prefix_{fragment_instance_id}_0.csv
+Status VFileResultWriter::_get_next_file_name(std::string* file_name) {
+    std::stringstream ss;
+    ss << _file_opts->file_path << print_id(_fragment_instance_id) << "_" << (_file_idx++) << "."
+       << _file_format_to_name();
+    *file_name = ss.str();
+    _header_sent = false;
+    if (_storage_type == TStorageBackendType::LOCAL) {
+        // This is just to prevent overwriting the existing file.
+        if (FileUtils::check_exist(*file_name)) {
+            return Status::InternalError("File already exists: " + *file_name +
+                                         ". Host: " + BackendOptions::get_localhost());
+        }
+    }
+    return Status::OK();
+}
+
+Status VFileResultWriter::_get_file_url(std::string* file_url) {
+    std::stringstream ss;
+    if (_storage_type == TStorageBackendType::LOCAL) {
+        ss << "file:///" << BackendOptions::get_localhost();
+    }
+    ss << _file_opts->file_path;
+    ss << print_id(_fragment_instance_id) << "_";
+    *file_url = ss.str();
+    return Status::OK();
+}
+
+std::string VFileResultWriter::_file_format_to_name() {
+    switch (_file_opts->file_format) {
+    case TFileFormatType::FORMAT_CSV_PLAIN:
+        return "csv";
+    case TFileFormatType::FORMAT_PARQUET:
+        return "parquet";
+    default:
+        return "unknown";
+    }
+}
+
+std::string VFileResultWriter::_gen_csv_types() {
+    std::string types;
+    int num_columns = _output_vexpr_ctxs.size();
+    for (int i = 0; i < num_columns; ++i) {
+        types += type_to_string(_output_vexpr_ctxs[i]->root()->type().type);
+        if (i < num_columns - 1) {
+            types += _file_opts->column_separator;
+        }
+    }
+    types += _file_opts->line_delimiter;
+    return types;
+}
+
+Status VFileResultWriter::_write_csv_header() {
+    if (!_header_sent && _header.size() > 0) {
+        std::string tmp_header = _header;
+        if (_header_type == BeConsts::CSV_WITH_NAMES_AND_TYPES) {
+            tmp_header += _gen_csv_types();
+        }
+        size_t written_len = 0;
+        RETURN_IF_ERROR(_file_writer->write(reinterpret_cast<const uint8_t*>(tmp_header.c_str()),
+                                            tmp_header.size(), &written_len));
+        _header_sent = true;
+    }
+    return Status::OK();
+}
+
+Status VFileResultWriter::append_row_batch(const RowBatch* batch) {
+    return Status::NotSupported("Not Implemented VFileResultWriter::append_row_batch scalar");
+}
+
+Status VFileResultWriter::append_block(Block& input_block) {
+    if (input_block.rows() == 0) {
+        return Status::OK();
+    }
+    SCOPED_TIMER(_append_row_batch_timer);
+    Status status = Status::OK();
+    // block.rows() == 0 means expr exec failed, just return the error status
+    auto block = VExprContext::get_output_block_after_execute_exprs(_output_vexpr_ctxs,
+                                                                    input_block, status);
+    RETURN_IF_ERROR(status);
+    if (block.rows() == 0) {
+        return Status::OK();
+    }
+    if (_parquet_writer != nullptr) {
+        {
+            SCOPED_TIMER(_file_write_timer);
+            RETURN_IF_ERROR(_parquet_writer->write(block));
+            _current_written_bytes = _parquet_writer->written_len();
+        }
+        // split file if exceed limit
+        RETURN_IF_ERROR(_create_new_file_if_exceed_size());
+    } else {
+        RETURN_IF_ERROR(_write_csv_header());
+        RETURN_IF_ERROR(_write_csv_file(block));
+    }
+    _written_rows += block.rows();
+    return Status::OK();
+}
+
+Status VFileResultWriter::_write_csv_file(const Block& block) {
+    const size_t num_columns = block.columns();
+    std::vector<ColumnPtr> columns(num_columns);
+    for (size_t i = 0; i < num_columns; ++i) {
+        columns[i] = block.get_by_position(i).column->convert_to_full_column_if_const();
+    }
+    for (size_t row = 0; row < block.rows(); ++row) {
+        {
+            SCOPED_TIMER(_convert_tuple_timer);
+            for (size_t i = 0; i < num_columns; ++i) {
+                const auto& column = columns[i];
+                if (column->is_null_at(row)) {
+                    _plain_text_outstream << NULL_IN_CSV;
+                } else {
+                    _write_csv_cell(i, column, row);
+                }
+                if (i < num_columns - 1) {
+                    _plain_text_outstream << _file_opts->column_separator;
+                }
+            }
+            _plain_text_outstream << _file_opts->line_delimiter;
+        }
+        RETURN_IF_ERROR(_flush_plain_text_outstream(false));
+    }
+    return _flush_plain_text_outstream(true);
+}
+
+void VFileResultWriter::_write_csv_cell(size_t column_id, const ColumnPtr& column_ptr,
+                                        size_t row) {
+    const auto& type = _output_vexpr_ctxs[column_id]->root()->type();
+    const IColumn* column = column_ptr.get();
+    if (column->is_nullable()) {
+        column = &assert_cast<const ColumnNullable&>(*column).get_nested_column();
+    }
+    switch (type.type) {
+    case TYPE_CHAR:
+    case TYPE_VARCHAR:
+    case TYPE_STRING: {
+        StringRef value = column->get_data_at(row);
+        _plain_text_outstream.write(value.data, value.size);
+        break;
+    }
+    case TYPE_OBJECT: {
+        if (!_output_object_data) {
+            _plain_text_outstream << NULL_IN_CSV;
+            break;
+        }
+        auto& bitmap = const_cast<BitmapValue&>(
+                assert_cast<const ColumnBitmap&>(*column).get_data()[row]);
+        std::string value(bitmap.getSizeInBytes(), '\0');
+        bitmap.write(value.data());
+        std::string base64_str;
+        base64_encode(value, &base64_str);
+        _plain_text_outstream << base64_str;
+        break;
+    }
+    case TYPE_HLL: {
+        if (!_output_object_data) {
+            _plain_text_outstream << NULL_IN_CSV;
+            break;
+        }
+        const auto& hll = assert_cast<const ColumnHLL&>(*column).get_data()[row];
+        std::string value(hll.max_serialized_size(), '\0');
+        value.resize(hll.serialize(reinterpret_cast<uint8_t*>(value.data())));
+        std::string base64_str;
+        base64_encode(value, &base64_str);
+        _plain_text_outstream << base64_str;
+        break;
+    }
+    default: {
+        auto data_type = remove_nullable(_output_vexpr_ctxs[column_id]->root()->data_type());
+        _plain_text_outstream << data_type->to_string(*column, row);
+        break;
+    }
+    }
+}
+
+Status VFileResultWriter::_flush_plain_text_outstream(bool eos) {
+    SCOPED_TIMER(_file_write_timer);
+    size_t pos = _plain_text_outstream.tellp();
+    if (pos == 0 || (pos < OUTSTREAM_BUFFER_SIZE_BYTES && !eos)) {
+        return Status::OK();
+    }
+
+    const std::string& buf = _plain_text_outstream.str();
+    size_t written_len = 0;
+    RETURN_IF_ERROR(_file_writer->write(reinterpret_cast<const uint8_t*>(buf.c_str()), buf.size(),
+                                        &written_len));
+    COUNTER_UPDATE(_written_data_bytes, written_len);
+    _current_written_bytes += written_len;
+
+    // clear the stream
+    _plain_text_outstream.str("");
+    _plain_text_outstream.clear();
+
+    // split file if exceed limit
+    return _create_new_file_if_exceed_size();
+}
+
+Status VFileResultWriter::_create_new_file_if_exceed_size() {
+    if (_current_written_bytes < _file_opts->max_file_size_bytes) {
+        return Status::OK();
+    }
+    // current file size exceed the max file size. close this file
+    // and create new one
+    {
+        SCOPED_TIMER(_writer_close_timer);
+        RETURN_IF_ERROR(_close_file_writer(false));
+    }
+    _current_written_bytes = 0;
+    return Status::OK();
+}
+
+Status VFileResultWriter::_close_file_writer(bool done, bool only_close) {
+    if (_parquet_writer != nullptr) {
+        // the file writer is closed by the parquet writer
+        Status st = _parquet_writer->close();
+        _current_written_bytes = _parquet_writer->written_len();
+        COUNTER_UPDATE(_written_data_bytes, _current_written_bytes);
+        _parquet_writer.reset();
+        delete _file_writer;
+        _file_writer = nullptr;
+        RETURN_IF_ERROR(st);
+    } else if (_file_writer != nullptr) {
+        _file_writer->close();
+        delete _file_writer;
+        _file_writer = nullptr;
+    }
+
+    if (only_close) {
+        return Status::OK();
+    }
+
+    if (!done) {
+        // not finished, create new file writer for next file
+        RETURN_IF_ERROR(_create_next_file_writer());
+    } else {
+        // All data is written to file, send statistic result
+        if (_file_opts->success_file_name != "") {
+            // write success file, just need to touch an empty file
+            RETURN_IF_ERROR(_create_success_file());
+        }
+        RETURN_IF_ERROR(_send_result());
+    }
+    return Status::OK();
+}
+
+Status VFileResultWriter::_send_result() {
+    if (_is_result_sent) {
+        return Status::OK();
+    }
+    _is_result_sent = true;
+
+    // The final stat result include:
+    // FileNumber, TotalRows, FileSize and URL
+    // The type of these field should be conssitent with types defined
+    // in OutFileClause.java of FE.
+    MysqlRowBuffer row_buffer;
+    row_buffer.push_int(_file_idx);                         // file number
+    row_buffer.push_bigint(_written_rows_counter->value()); // total rows
+    row_buffer.push_bigint(_written_data_bytes->value());   // file size
+    std::string file_url;
+    _get_file_url(&file_url);
+    row_buffer.push_string(file_url.c_str(), file_url.length()); // url
+
+    std::unique_ptr<TFetchDataResult> result = std::make_unique<TFetchDataResult>();
+    result->result_batch.rows.resize(1);
+    result->result_batch.rows[0].assign(row_buffer.buf(), row_buffer.length());
+    RETURN_NOT_OK_STATUS_WITH_WARN(_sinker->add_batch(result), "failed to send outfile result");
+    return Status::OK();
+}
+
+Status VFileResultWriter::close() {
+    // the following 2 profile "_written_rows_counter" and "_writer_close_timer"
+    // must be outside the `_close_file_writer()`.
+    // because `_close_file_writer()` may be called in deconstructor,
+    // at that time, the RuntimeState may already been deconstructed,
+    // so does the profile in RuntimeState.
+    COUNTER_SET(_written_rows_counter, _written_rows);
+    SCOPED_TIMER(_writer_close_timer);
+    return _close_file_writer(true, false);
+}
+
+} // namespace doris::vectorized
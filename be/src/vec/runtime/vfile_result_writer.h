@@ -0,0 +1,128 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <sstream>
+
+#include "gen_cpp/DataSinks_types.h"
+#include "gen_cpp/Types_types.h"
+#include "runtime/file_result_writer.h"
+#include "runtime/runtime_state.h"
+#include "vec/sink/result_writer.h"
+
+namespace doris {
+
+class BufferControlBlock;
+class FileWriter;
+class RuntimeProfile;
+
+namespace vectorized {
+class VExprContext;
+class VParquetWriterWrapper;
+
+// The vectorized FileResultWriter, write the blocks to the csv or parquet files, split by
+// max_file_size_bytes, and send the statistic result in one row at last.
+class VFileResultWriter final : public VResultWriter {
+public:
+    VFileResultWriter(const ResultFileOptions* file_option,
+                      const TStorageBackendType::type storage_type,
+                      const TUniqueId fragment_instance_id,
+                      const std::vector<VExprContext*>& output_vexpr_ctxs,
+                      RuntimeProfile* parent_profile, BufferControlBlock* sinker,
+                      bool output_object_data);
+    ~VFileResultWriter() override;
+
+    Status init(RuntimeState* state) override;
+    Status append_row_batch(const RowBatch* batch) override;
+    Status append_block(Block& block) override;
+    Status close() override;
+
+    // file result writer always return statistic result in one row
+    int64_t get_written_rows() const override { return 1; }
+
+private:
+    Status _write_csv_file(const Block& block);
+    void _write_csv_cell(size_t column_id, const ColumnPtr& column, size_t row);
+    Status _write_csv_header();
+    std::string _gen_csv_types();
+
+    // if buffer exceed the limit, write the data buffered in _plain_text_outstream via file_writer
+    // if eos, write the data even if buffer is not full.
+    Status _flush_plain_text_outstream(bool eos);
+    void _init_profile();
+
+    Status _create_file_writer(const std::string& file_name);
+    Status _create_next_file_writer();
+    Status _create_success_file();
+    // get next export file name
+    Status _get_next_file_name(std::string* file_name);
+    Status _get_success_file_name(std::string* file_name);
+    Status _get_file_url(std::string* file_url);
+    std::string _file_format_to_name();
+    // close file writer, and if !done, it will create new writer for next file.
+    // if only_close is true, this method will just close the file writer and return.
+    Status _close_file_writer(bool done, bool only_close = false);
+    // create a new file if current file size exceed limit
+    Status _create_new_file_if_exceed_size();
+    // send the final statistic result
+    Status _send_result();
+
+private:
+    RuntimeState* _state; // not owned, set when init
+    const ResultFileOptions* _file_opts;
+    TStorageBackendType::type _storage_type;
+    TUniqueId _fragment_instance_id;
+    const std::vector<VExprContext*>& _output_vexpr_ctxs;
+
+    // If the result file format is plain text, like CSV, this _file_writer is owned by this writer.
+    // If the result file format is Parquet, it's closed by _parquet_writer.
+    FileWriter* _file_writer = nullptr;
+    std::unique_ptr<VParquetWriterWrapper> _parquet_writer;
+    // Used to buffer the export data of plain text
+    std::stringstream _plain_text_outstream;
+    static const size_t OUTSTREAM_BUFFER_SIZE_BYTES;
+
+    // current written bytes, used for split data
+    int64_t _current_written_bytes = 0;
+    // the suffix idx of export file name, start at 0
+    int _file_idx = 0;
+
+    RuntimeProfile* _parent_profile; // profile from result sink, not owned
+    // total time cost on append batch operation
+    RuntimeProfile::Counter* _append_row_batch_timer = nullptr;
+    // tuple convert timer, child timer of _append_row_batch_timer
+    RuntimeProfile::Counter* _convert_tuple_timer = nullptr;
+    // file write timer, child timer of _append_row_batch_timer
+    RuntimeProfile::Counter* _file_write_timer = nullptr;
+    // time of closing the file writer
+    RuntimeProfile::Counter* _writer_close_timer = nullptr;
+    // number of written rows
+    RuntimeProfile::Counter* _written_rows_counter = nullptr;
+    // bytes of written data
+    RuntimeProfile::Counter* _written_data_bytes = nullptr;
+
+    // not owned
+    BufferControlBlock* _sinker = nullptr;
+    // set to true if the final statistic result is sent
+    bool _is_result_sent = false;
+    bool _header_sent = false;
+};
+
+} // namespace vectorized
+} // namespace doris
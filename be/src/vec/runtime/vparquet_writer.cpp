@@ -0,0 +1,152 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/runtime/vparquet_writer.h"
+
+#include <arrow/memory_pool.h>
+#include <arrow/table.h>
+
+#include "common/config.h"
+#include "exec/file_writer.h"
+#include "gutil/strings/substitute.h"
+#include "util/arrow/block_convertor.h"
+#include "util/arrow/row_batch.h"
+#include "util/arrow/utils.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/exprs/vexpr_context.h"
+
+namespace doris::vectorized {
+
+VParquetWriterWrapper::VParquetWriterWrapper(
+        FileWriter* file_writer, const std::vector<VExprContext*>& output_vexpr_ctxs,
+        const std::map<std::string, std::string>& properties,
+        const std::vector<std::vector<std::string>>& schema)
+        : _outstream(new ParquetOutputStream(file_writer)),
+          _output_vexpr_ctxs(output_vexpr_ctxs),
+          _file_properties(properties),
+          _str_schema(schema) {}
+
+Status VParquetWriterWrapper::_parse_schema(const std::vector<std::vector<std::string>>& schema) {
+    std::vector<std::shared_ptr<arrow::Field>> fields;
+    if (schema.empty()) {
+        for (auto ctx : _output_vexpr_ctxs) {
+            std::shared_ptr<arrow::DataType> type;
+            RETURN_IF_ERROR(convert_to_arrow_type(ctx->root()->type(), &type));
+            fields.push_back(
+                    arrow::field(ctx->root()->expr_name(), type, ctx->root()->is_nullable()));
+        }
+        _arrow_schema = arrow::schema(std::move(fields));
+        return Status::OK();
+    }
+    if (schema.size() != _output_vexpr_ctxs.size()) {
+        return Status::InternalError("project field size is not equal to schema column size");
+    }
+    // the physical types of the columns given by the user, with the arrow types mapped to them
+    for (const auto& column : schema) {
+        if (column.size() < 3) {
+            return Status::InvalidArgument("invalid parquet schema");
+        }
+        const std::string& data_type = column[1];
+        std::shared_ptr<arrow::DataType> type;
+        if (data_type == "boolean") {
+            type = arrow::boolean();
+        } else if (data_type.find("int32") != std::string::npos) {
+            type = arrow::int32();
+        } else if (data_type.find("int64") != std::string::npos) {
+            type = arrow::int64();
+        } else if (data_type.find("float") != std::string::npos) {
+            type = arrow::float32();
+        } else if (data_type.find("double") != std::string::npos) {
+            type = arrow::float64();
+        } else if (data_type.find("byte_array") != std::string::npos &&
+                   data_type.find("fixed_len_byte_array") == std::string::npos) {
+            type = arrow::utf8();
+        } else {
+            return Status::NotSupported(strings::Substitute(
+                    "unsupported parquet type $0 of the vectorized writer", data_type));
+        }
+        bool nullable = column[0].find("required") == std::string::npos;
+        fields.push_back(arrow::field(column[2], type, nullable));
+    }
+    _arrow_schema = arrow::schema(std::move(fields));
+    return Status::OK();
+}
+
+Status VParquetWriterWrapper::init() {
+    RETURN_IF_ERROR(_parse_schema(_str_schema));
+    auto properties = ParquetWriterWrapper::build_properties(_file_properties);
+    auto arrow_properties = parquet::ArrowWriterProperties::Builder().build();
+    return to_status(parquet::arrow::FileWriter::Open(*_arrow_schema, arrow::default_memory_pool(),
+                                                      _outstream, properties, arrow_properties,
+                                                      &_writer));
+}
+
+Status VParquetWriterWrapper::write(const Block& block) {
+    if (block.rows() == 0) {
+        return Status::OK();
+    }
+    std::shared_ptr<arrow::RecordBatch> batch;
+    RETURN_IF_ERROR(
+            convert_to_arrow_batch(block, _arrow_schema, arrow::default_memory_pool(), &batch));
+    _buffered_rows += batch->num_rows();
+    _batches.push_back(std::move(batch));
+    if (_buffered_rows >= config::parquet_writer_row_group_rows) {
+        RETURN_IF_ERROR(_flush_row_group());
+    }
+    return Status::OK();
+}
+
+Status VParquetWriterWrapper::_flush_row_group() {
+    if (_batches.empty()) {
+        return Status::OK();
+    }
+    auto table = arrow::Table::FromRecordBatches(_arrow_schema, _batches);
+    if (!table.ok()) {
+        return to_status(table.status());
+    }
+    // one row group of all the buffered rows
+    RETURN_IF_ERROR(to_status(_writer->WriteTable(*table.ValueOrDie(), _buffered_rows)));
+    _batches.clear();
+    _buffered_rows = 0;
+    return Status::OK();
+}
+
+Status VParquetWriterWrapper::close() {
+    if (_closed) {
+        return Status::OK();
+    }
+    _closed = true;
+    Status st = _flush_row_group();
+    if (_writer != nullptr) {
+        Status close_st = to_status(_writer->Close());
+        if (st.ok()) {
+            st = close_st;
+        }
+    }
+    Status stream_st = to_status(_outstream->Close());
+    if (st.ok()) {
+        st = stream_st;
+    }
+    return st;
+}
+
+int64_t VParquetWriterWrapper::written_len() {
+    return _outstream->get_written_len();
+}
+
+} // namespace doris::vectorized
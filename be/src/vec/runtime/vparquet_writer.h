@@ -0,0 +1,81 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include <arrow/api.h>
+#include <parquet/arrow/writer.h>
+#include <stdint.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "exec/parquet_writer.h"
+#include "vec/core/block.h"
+
+namespace doris {
+class FileWriter;
+
+namespace vectorized {
+class VExprContext;
+
+// Write the blocks to a parquet file. The blocks are converted to arrow record batches column
+// by column, and buffered until there are parquet_writer_row_group_rows rows to write a row
+// group.
+class VParquetWriterWrapper {
+public:
+    // `schema` is the [repetition, type, name] of the columns given by the user, the schema of
+    // the file follows the output exprs if it's empty.
+    VParquetWriterWrapper(FileWriter* file_writer,
+                          const std::vector<VExprContext*>& output_vexpr_ctxs,
+                          const std::map<std::string, std::string>& properties,
+                          const std::vector<std::vector<std::string>>& schema);
+    ~VParquetWriterWrapper() = default;
+
+    Status init();
+
+    // `block` is the result of the output exprs
+    Status write(const Block& block);
+
+    Status close();
+
+    // the bytes written to the file, the buffered rows excluded
+    int64_t written_len();
+
+private:
+    Status _parse_schema(const std::vector<std::vector<std::string>>& schema);
+    Status _flush_row_group();
+
+    std::shared_ptr<ParquetOutputStream> _outstream;
+    const std::vector<VExprContext*>& _output_vexpr_ctxs;
+    std::map<std::string, std::string> _file_properties;
+    std::vector<std::vector<std::string>> _str_schema;
+
+    std::shared_ptr<arrow::Schema> _arrow_schema;
+    std::unique_ptr<parquet::arrow::FileWriter> _writer;
+    // the batches of the next row group
+    std::vector<std::shared_ptr<arrow::RecordBatch>> _batches;
+    int64_t _buffered_rows = 0;
+    bool _closed = false;
+};
+
+} // namespace vectorized
+} // namespace doris
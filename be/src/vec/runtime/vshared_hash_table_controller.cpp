@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/runtime/vshared_hash_table_controller.h"
+
+#include <chrono>
+
+#include "common/logging.h"
+#include "runtime/runtime_state.h"
+
+namespace doris::vectorized {
+
+bool SharedHashTableController::should_build_hash_table(const TUniqueId& fragment_instance_id,
+                                                        int node_id) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _builder_fragment_ids.find(node_id);
+    if (it == _builder_fragment_ids.end()) {
+        _builder_fragment_ids.emplace(node_id, fragment_instance_id);
+        return true;
+    }
+    return it->second == fragment_instance_id;
+}
+
+void SharedHashTableController::put_hash_table(int node_id, const Status& status,
+                                               std::shared_ptr<SharedHashTableContext> context) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        DCHECK(_build_status.find(node_id) == _build_status.end());
+        _build_status.emplace(node_id, status);
+        if (status.ok()) {
+            _contexts.emplace(node_id, std::move(context));
+        }
+    }
+    _cv.notify_all();
+}
+
+Status SharedHashTableController::wait_for_hash_table(
+        RuntimeState* state, int node_id, std::shared_ptr<SharedHashTableContext>* context) {
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        auto it = _build_status.find(node_id);
+        if (it != _build_status.end()) {
+            RETURN_IF_ERROR(it->second);
+            *context = _contexts[node_id];
+            return Status::OK();
+        }
+        if (state->is_cancelled()) {
+            return Status::Cancelled("Cancelled");
+        }
+        // wake up periodically to check whether the query was cancelled
+        _cv.wait_for(lock, std::chrono::milliseconds(100));
+    }
+}
+
+} // namespace doris::vectorized
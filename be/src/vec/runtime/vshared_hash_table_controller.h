@@ -0,0 +1,65 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+
+namespace doris {
+
+class RuntimeState;
+
+namespace vectorized {
+
+struct SharedHashTableContext;
+
+// SharedHashTableController lets the instances of a broadcast hash join on one BE share
+// one hash table. All of them receive the same build rows, so the first instance to come
+// builds the hash table and the others wait for it, then probe it concurrently and
+// read-only. It is owned by the QueryFragmentsCtx of the query, the hash tables are
+// identified by the id of their join node.
+class SharedHashTableController {
+public:
+    // Return true if the instance 'fragment_instance_id' should build the hash table of
+    // join node 'node_id', which is true only for the first instance calling it.
+    bool should_build_hash_table(const TUniqueId& fragment_instance_id, int node_id);
+
+    // Called by the builder to publish the built hash table, or the error which makes
+    // building it fail. The waiting instances are woken up.
+    void put_hash_table(int node_id, const Status& status,
+                        std::shared_ptr<SharedHashTableContext> context);
+
+    // Wait until the builder of the hash table of join node 'node_id' publishes it.
+    Status wait_for_hash_table(RuntimeState* state, int node_id,
+                               std::shared_ptr<SharedHashTableContext>* context);
+
+private:
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    std::map<int, TUniqueId> _builder_fragment_ids;
+    std::map<int, Status> _build_status;
+    std::map<int, std::shared_ptr<SharedHashTableContext>> _contexts;
+};
+
+} // namespace vectorized
+} // namespace doris
@@ -42,6 +42,7 @@ VSortedRunMerger::VSortedRunMerger(const std::vector<VExprContext*>& ordering_ex
           _offset(offset) {
     _get_next_timer = ADD_TIMER(profile, "MergeGetNext");
     _get_next_block_timer = ADD_TIMER(profile, "MergeGetNextBlock");
+    _merged_ranges_counter = ADD_COUNTER(profile, "MergedRanges", TUnit::UNIT);
 }
 
 Status VSortedRunMerger::prepare(const vector<BlockSupplier>& input_runs, bool parallel) {
@@ -49,9 +50,11 @@ Status VSortedRunMerger::prepare(const vector<BlockSupplier>& input_runs, bool p
         _cursors.emplace_back(supplier, _ordering_expr, _is_asc_order, _nulls_first);
     }
 
-    for (auto& _cursor : _cursors) {
-        if (!_cursor._is_eof) _priority_queue.push(SortCursor(&_cursor));
+    std::vector<SortCursorImpl*> cursors;
+    for (auto& cursor : _cursors) {
+        cursors.push_back(&cursor);
     }
+    _loser_tree.init(std::move(cursors));
 
     for (const auto& cursor : _cursors) {
         if (!cursor._is_eof) {
@@ -68,8 +71,8 @@ Status VSortedRunMerger::get_next(Block* output_block, bool* eos) {
     // Only have one receive data queue of data, no need to do merge and
     // copy the data of block.
     // return the data in receive data directly
-    if (_priority_queue.size() == 1) {
-        auto current = _priority_queue.top();
+    if (_loser_tree.num_live() == 1) {
+        SortCursor current(_loser_tree.winner());
         while (_offset != 0 && current->block_ptr() != nullptr) {
             if (_offset >= current->rows - current->pos) {
                 _offset -= (current->rows - current->pos);
@@ -106,21 +109,32 @@ Status VSortedRunMerger::get_next(Block* output_block, bool* eos) {
         MutableColumns merged_columns =
                 mem_reuse ? output_block->mutate_columns() : _empty_block.clone_empty_columns();
 
-        /// Take rows from queue in right order and push to 'merged'.
+        /// Take the ranges of rows from the winner of the loser tree and push to 'merged'.
         size_t merged_rows = 0;
-        while (!_priority_queue.empty()) {
-            auto current = _priority_queue.top();
-            _priority_queue.pop();
+        while (!_loser_tree.empty() && merged_rows < _batch_size) {
+            SortCursor current(_loser_tree.winner());
+            size_t max_end = std::min(current->rows,
+                                      current->pos + _offset + (_batch_size - merged_rows));
+            size_t end = find_range_end(current, _loser_tree.runner_up(), max_end);
+
+            size_t skipped = std::min(_offset, end - current->pos);
+            _offset -= skipped;
+            size_t start = current->pos + skipped;
+            if (start < end) {
+                for (size_t i = 0; i < num_columns; ++i) {
+                    merged_columns[i]->insert_range_from(*current->all_columns[i], start,
+                                                         end - start);
+                }
+                merged_rows += end - start;
+                COUNTER_UPDATE(_merged_ranges_counter, 1);
+            }
 
-            if (_offset > 0) {
-                _offset--;
-            } else {
-                for (size_t i = 0; i < num_columns; ++i)
-                    merged_columns[i]->insert_from(*current->all_columns[i], current->pos);
-                ++merged_rows;
+            current->pos = end;
+            bool exhausted = false;
+            if (current->pos == current->rows) {
+                exhausted = !has_next_block(current);
             }
-            next_heap(current);
-            if (merged_rows == _batch_size) break;
+            _loser_tree.update_winner(exhausted);
         }
 
         if (merged_rows == 0) {
@@ -142,13 +156,38 @@ Status VSortedRunMerger::get_next(Block* output_block, bool* eos) {
     return Status::OK();
 }
 
-void VSortedRunMerger::next_heap(SortCursor& current) {
-    if (!current->isLast()) {
-        current->next();
-        _priority_queue.push(current);
-    } else if (has_next_block(current)) {
-        _priority_queue.push(current);
+size_t VSortedRunMerger::find_range_end(const SortCursor& current,
+                                        const SortCursorImpl* runner_up, size_t max_end) const {
+    if (runner_up == nullptr) {
+        return max_end;
+    }
+    SortCursor other(const_cast<SortCursorImpl*>(runner_up));
+    auto not_greater = [&](size_t row) {
+        return current.greater_at(other, row, runner_up->pos) <= 0;
+    };
+    // the current row of the winner is never greater than the runner up
+    size_t begin = current->pos + 1;
+    if (begin >= max_end || not_greater(max_end - 1)) {
+        return max_end;
+    }
+    // gallop to find a row greater than the runner up, the rows before `begin` are not greater
+    size_t step = 1;
+    size_t end = begin;
+    while (end < max_end - 1 && not_greater(end)) {
+        begin = end + 1;
+        end = std::min(end + step, max_end - 1);
+        step *= 2;
+    }
+    // the first greater row is in [begin, end]
+    while (begin < end) {
+        size_t mid = begin + (end - begin) / 2;
+        if (not_greater(mid)) {
+            begin = mid + 1;
+        } else {
+            end = mid;
+        }
     }
+    return begin;
 }
 
 inline bool VSortedRunMerger::has_next_block(doris::vectorized::SortCursor& current) {
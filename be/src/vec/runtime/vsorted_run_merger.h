@@ -17,8 +17,6 @@
 
 #pragma once
 
-#include <queue>
-
 #include "common/object_pool.h"
 #include "util/tuple_row_compare.h"
 
@@ -33,8 +31,9 @@ namespace vectorized {
 class Block;
 // VSortedRunMerger is used to merge multiple sorted runs of blocks. A run is a sorted
 // sequence of blocks, which are fetched from a BlockSupplier function object.
-// Merging is implemented using a binary min-heap that maintains the run with the next
-// rows in sorted order at the top of the heap.
+// Merging is implemented using a loser tree whose winner is the run with the next row in
+// sorted order. The rows of the winner not greater than the next row of the other runs are
+// copied as a range, so that runs with long non-overlapping ranges aren't merged row by row.
 //
 // Merged block of rows are retrieved from VSortedRunMerger via calls to get_next().
 class VSortedRunMerger {
@@ -50,8 +49,7 @@ public:
     virtual ~VSortedRunMerger() = default;
 
     // Prepare this merger to merge and return rows from the sorted runs in 'input_runs'.
-    // Retrieves the first batch from each run and sets up the binary heap implementing
-    // the priority queue.
+    // Retrieves the first batch from each run and sets up the loser tree.
     Status prepare(const std::vector<BlockSupplier>& input_runs, bool parallel = false);
 
     // Return the next block of sorted rows from this merger.
@@ -73,7 +71,7 @@ protected:
     size_t _offset = 0;
 
     std::vector<ReceiveQueueSortCursorImpl> _cursors;
-    std::priority_queue<SortCursor> _priority_queue;
+    SortCursorLoserTree _loser_tree;
 
     Block _empty_block;
 
@@ -83,8 +81,14 @@ protected:
     // Times calls to get the next batch of rows from the input run.
     RuntimeProfile::Counter* _get_next_block_timer;
 
+    // The number of the ranges of rows copied from the runs.
+    RuntimeProfile::Counter* _merged_ranges_counter;
+
 private:
-    void next_heap(SortCursor& current);
+    // The end of the rows of `current` from its position which are not greater than the current
+    // row of `runner_up`, searching no further than `max_end`.
+    size_t find_range_end(const SortCursor& current, const SortCursorImpl* runner_up,
+                          size_t max_end) const;
     bool has_next_block(SortCursor& current);
 };
 
@@ -0,0 +1,310 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/runtime/vspill_stream.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "common/config.h"
+#include "env/env.h"
+#include "gen_cpp/data.pb.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
+#include "util/block_compression.h"
+#include "util/coding.h"
+#include "util/threadpool.h"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// Used to spread the spill streams over all the tmp devices.
+static std::atomic<uint32_t> s_next_device_idx {0};
+
+// The header of every block: the length of serialized PBlock and the length of
+// its column values before compression.
+static constexpr size_t BLOCK_HEADER_SIZE = 2 * sizeof(uint32_t);
+
+BlockSpillStream::BlockSpillStream(TmpFileMgr* tmp_file_mgr, const TUniqueId& query_id,
+                                   segment_v2::CompressionTypePB compression_type)
+        : _tmp_file_mgr(tmp_file_mgr), _query_id(query_id), _compression_type(compression_type) {}
+
+BlockSpillStream::~BlockSpillStream() {
+    // the io in flight refers to the stream, the queued io is dropped
+    if (_io_token != nullptr) {
+        _io_token->shutdown();
+    }
+    _writer.reset();
+    _reader.reset();
+    if (_tmp_file != nullptr) {
+        Status st = Env::Default()->delete_file(_tmp_file->path());
+        if (!st.ok()) {
+            LOG(WARNING) << "failed to remove spill file " << _tmp_file->path() << ", "
+                         << st.get_error_msg();
+        }
+    }
+}
+
+segment_v2::CompressionTypePB BlockSpillStream::default_compression_type() {
+    return config::vec_spill_compression == "ZSTD" ? segment_v2::ZSTD : segment_v2::LZ4;
+}
+
+bool BlockSpillStream::can_spill(RuntimeState* state) {
+    if (!state->enable_spill() || state->exec_env() == nullptr) {
+        return false;
+    }
+    auto tmp_file_mgr = state->exec_env()->tmp_file_mgr();
+    return tmp_file_mgr != nullptr && tmp_file_mgr->num_active_tmp_devices() > 0;
+}
+
+bool BlockSpillStream::should_spill(RuntimeState* state, int64_t mem_bytes) {
+    if (mem_bytes < config::vec_spill_min_mem_bytes) {
+        return false;
+    }
+    if (state->is_spill_requested()) {
+        return true;
+    }
+    auto query_mem_tracker = state->query_mem_tracker();
+    if (query_mem_tracker == nullptr || !query_mem_tracker->has_limit()) {
+        return false;
+    }
+    return query_mem_tracker->consumption() >=
+           query_mem_tracker->limit() / 100 * config::vec_spill_mem_limit_percent;
+}
+
+Status BlockSpillStream::prepare() {
+    DCHECK(_tmp_file == nullptr);
+    RETURN_IF_ERROR(get_block_compression_codec(_compression_type, &_codec));
+    if (_tmp_file_mgr == nullptr) {
+        return Status::InternalError("no available tmp dir to spill data");
+    }
+    std::vector<TmpFileMgr::DeviceId> devices = _tmp_file_mgr->active_tmp_devices();
+    if (devices.empty()) {
+        return Status::InternalError("no available tmp dir to spill data");
+    }
+
+    // Try every device once, a device which fails to create file will be blacklisted.
+    Status st;
+    for (size_t i = 0; i < devices.size(); ++i) {
+        TmpFileMgr::DeviceId device_id = devices[s_next_device_idx++ % devices.size()];
+        TmpFileMgr::File* tmp_file = nullptr;
+        st = _tmp_file_mgr->get_file(device_id, _query_id, &tmp_file);
+        if (!st.ok()) {
+            continue;
+        }
+        _tmp_file.reset(tmp_file);
+        st = Env::Default()->new_writable_file(_tmp_file->path(), &_writer);
+        if (st.ok()) {
+            ThreadPool* io_thread_pool = _tmp_file_mgr->io_thread_pool();
+            if (io_thread_pool != nullptr) {
+                _io_token = io_thread_pool->new_token(ThreadPool::ExecutionMode::SERIAL);
+            }
+            return Status::OK();
+        }
+        _tmp_file->report_io_error(st.get_error_msg());
+        _tmp_file.reset();
+    }
+    return st;
+}
+
+Status BlockSpillStream::add_block(const Block& block) {
+    DCHECK(_writer != nullptr) << "add block to a not prepared or finished spill stream";
+    if (block.rows() == 0) {
+        return Status::OK();
+    }
+
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    // the column values are compressed by our own codec
+    RETURN_IF_ERROR(block.serialize(&pblock, &uncompressed_bytes, &compressed_bytes,
+                                    &_column_values_buf, false));
+    if (_codec != nullptr && uncompressed_bytes > 0) {
+        _compression_buf.resize(_codec->max_compressed_len(uncompressed_bytes));
+        Slice compressed_slice(_compression_buf);
+        RETURN_IF_ERROR(_codec->compress(Slice(_column_values_buf.data(), uncompressed_bytes),
+                                         &compressed_slice));
+        pblock.set_column_values(_compression_buf.data(), compressed_slice.size);
+    } else {
+        pblock.set_column_values(std::move(_column_values_buf));
+    }
+    auto write = std::make_shared<BlockWrite>();
+    if (!pblock.SerializeToString(&write->data)) {
+        return Status::InternalError("failed to serialize spilled block");
+    }
+    encode_fixed32_le(write->header, write->data.size());
+    encode_fixed32_le(write->header + sizeof(uint32_t), uncompressed_bytes);
+    size_t block_bytes = BLOCK_HEADER_SIZE + write->data.size();
+
+    if (_io_token == nullptr) {
+        RETURN_IF_ERROR(_write_block(*write));
+    } else {
+        // bound the memory of the blocks queued to write
+        int max_inflight_writes = std::max(1, config::vec_spill_max_inflight_writes);
+        {
+            std::unique_lock<std::mutex> l(_io_lock);
+            _io_cv.wait(l, [&] {
+                return _inflight_writes < max_inflight_writes || !_write_status.ok();
+            });
+            RETURN_IF_ERROR(_write_status);
+            ++_inflight_writes;
+        }
+        Status st = _io_token->submit_func([this, write] {
+            Status write_st = _write_block(*write);
+            std::lock_guard<std::mutex> l(_io_lock);
+            if (!write_st.ok() && _write_status.ok()) {
+                _write_status = write_st;
+            }
+            --_inflight_writes;
+            _io_cv.notify_all();
+        });
+        if (!st.ok()) {
+            std::lock_guard<std::mutex> l(_io_lock);
+            --_inflight_writes;
+            return st;
+        }
+    }
+
+    _block_sizes.push_back(block_bytes);
+    _write_offset += block_bytes;
+    _num_rows += block.rows();
+    ++_num_blocks;
+    return Status::OK();
+}
+
+Status BlockSpillStream::_write_block(const BlockWrite& write) {
+    static_assert(sizeof(write.header) == BLOCK_HEADER_SIZE);
+    SCOPED_TIMER(_io_timer);
+    Slice slices[2] = {Slice(write.header, BLOCK_HEADER_SIZE), Slice(write.data)};
+    Status st = _writer->appendv(slices, 2);
+    if (!st.ok()) {
+        _tmp_file->report_io_error(st.get_error_msg());
+    }
+    return st;
+}
+
+Status BlockSpillStream::_read_block(uint64_t offset, size_t size, std::string* data) {
+    SCOPED_TIMER(_io_timer);
+    data->resize(size);
+    Slice slice(*data);
+    Status st = _reader->read_at(offset, &slice);
+    if (!st.ok()) {
+        _tmp_file->report_io_error(st.get_error_msg());
+    }
+    return st;
+}
+
+void BlockSpillStream::_read_ahead() {
+    size_t max_read_ahead_blocks = std::max(1, config::vec_spill_read_ahead_blocks);
+    while (_read_ahead_blocks.size() < max_read_ahead_blocks &&
+           _num_blocks_read_ahead < _num_blocks) {
+        auto read = std::make_shared<BlockRead>();
+        uint64_t offset = _read_ahead_offset;
+        size_t size = _block_sizes[_num_blocks_read_ahead];
+        Status st = _io_token->submit_func([this, read, offset, size] {
+            Status read_st = _read_block(offset, size, &read->data);
+            std::lock_guard<std::mutex> l(_io_lock);
+            read->status = read_st;
+            read->done = true;
+            _io_cv.notify_all();
+        });
+        if (!st.ok()) {
+            // not shared with the io threads, get_next() returns the error
+            read->status = st;
+            read->done = true;
+        }
+        _read_ahead_blocks.push_back(std::move(read));
+        _read_ahead_offset += size;
+        ++_num_blocks_read_ahead;
+    }
+}
+
+Status BlockSpillStream::done_write() {
+    DCHECK(_writer != nullptr);
+    if (_io_token != nullptr) {
+        _io_token->wait();
+        std::lock_guard<std::mutex> l(_io_lock);
+        RETURN_IF_ERROR(_write_status);
+    }
+    Status st = _writer->close();
+    _writer.reset();
+    if (!st.ok()) {
+        _tmp_file->report_io_error(st.get_error_msg());
+        return st;
+    }
+    // the buffers are useless for reading, release them as soon as possible
+    std::string().swap(_column_values_buf);
+    std::string().swap(_compression_buf);
+    return Env::Default()->new_random_access_file(_tmp_file->path(), &_reader);
+}
+
+Status BlockSpillStream::get_next(Block* block, bool* eos) {
+    DCHECK(_reader != nullptr) << "read a spill stream before done_write()";
+    if (_num_blocks_read == _num_blocks) {
+        *eos = true;
+        return Status::OK();
+    }
+
+    // the header and the block are read by one io
+    if (_io_token == nullptr) {
+        RETURN_IF_ERROR(_read_block(_read_ahead_offset, _block_sizes[_num_blocks_read],
+                                    &_read_buf));
+        _read_ahead_offset += _block_sizes[_num_blocks_read];
+    } else {
+        _read_ahead();
+        std::shared_ptr<BlockRead> read = std::move(_read_ahead_blocks.front());
+        _read_ahead_blocks.pop_front();
+        {
+            std::unique_lock<std::mutex> l(_io_lock);
+            _io_cv.wait(l, [&] { return read->done; });
+        }
+        RETURN_IF_ERROR(read->status);
+        _read_buf.swap(read->data);
+        // read the next blocks while decoding this one
+        _read_ahead();
+    }
+
+    uint32_t length = decode_fixed32_le(reinterpret_cast<const uint8_t*>(_read_buf.data()));
+    uint32_t uncompressed_bytes = decode_fixed32_le(
+            reinterpret_cast<const uint8_t*>(_read_buf.data()) + sizeof(uint32_t));
+    if (BLOCK_HEADER_SIZE + length != _read_buf.size()) {
+        return Status::Corruption("spilled block is corrupted in " + _tmp_file->path());
+    }
+
+    PBlock pblock;
+    if (!pblock.ParseFromArray(_read_buf.data() + BLOCK_HEADER_SIZE, length)) {
+        return Status::InternalError("failed to parse spilled block from " + _tmp_file->path());
+    }
+    if (_codec != nullptr && uncompressed_bytes > 0) {
+        _column_values_buf.resize(uncompressed_bytes);
+        Slice uncompressed_slice(_column_values_buf);
+        RETURN_IF_ERROR(_codec->decompress(Slice(pblock.column_values()), &uncompressed_slice));
+        if (uncompressed_slice.size != uncompressed_bytes) {
+            return Status::Corruption("spilled block is corrupted in " + _tmp_file->path());
+        }
+        pblock.set_column_values(std::move(_column_values_buf));
+    }
+    Block new_block(pblock);
+    block->swap(new_block);
+
+    ++_num_blocks_read;
+    *eos = false;
+    return Status::OK();
+}
+
+} // namespace doris::vectorized
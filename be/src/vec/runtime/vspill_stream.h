@@ -0,0 +1,160 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/status.h"
+#include "gen_cpp/Types_types.h"
+#include "gen_cpp/segment_v2.pb.h"
+#include "runtime/tmp_file_mgr.h"
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+class BlockCompressionCodec;
+class RandomAccessFile;
+class RuntimeState;
+class WritableFile;
+
+namespace vectorized {
+class Block;
+
+// BlockSpillStream is an append-only sequence of blocks backed by one temporary file
+// of TmpFileMgr. It is the spill unit of the vectorized operators: blocks are appended
+// by add_block() until done_write() is called, after which they can be read back in
+// insertion order by get_next().
+//
+// Each block is stored as a serialized PBlock prefixed with a small header, so the
+// stream is self-describing and does not need to keep any schema in memory. The
+// column values of the PBlock are compressed by the codec of `compression_type`.
+// The temporary file is removed when the stream is destroyed.
+//
+// The blocks are serialized and compressed by the caller, while the file io runs on the io
+// threads of TmpFileMgr if there are: add_block() returns once the write is queued, unless
+// the stream already has config::vec_spill_max_inflight_writes writes in flight, and
+// get_next() reads config::vec_spill_read_ahead_blocks blocks ahead.
+//
+// Not thread safe.
+class BlockSpillStream {
+public:
+    BlockSpillStream(TmpFileMgr* tmp_file_mgr, const TUniqueId& query_id,
+                     segment_v2::CompressionTypePB compression_type = default_compression_type());
+    ~BlockSpillStream();
+
+    // The codec of config::vec_spill_compression.
+    static segment_v2::CompressionTypePB default_compression_type();
+
+    // Account the time of the file io of the stream to `io_timer`, which must outlive the
+    // stream, e.g. a counter of the profile of the spilling operator.
+    void set_io_timer(RuntimeProfile::Counter* io_timer) { _io_timer = io_timer; }
+
+    // Choose a tmp device and create the backing file. Must be called before add_block().
+    Status prepare();
+
+    // Append the block to the end of the stream. Empty blocks are ignored.
+    Status add_block(const Block& block);
+
+    // Wait for the writes in flight and finish writing, after this the stream can only be read.
+    Status done_write();
+
+    // Read the next block of the stream, '*eos' is set once all blocks were returned.
+    Status get_next(Block* block, bool* eos);
+
+    size_t num_blocks() const { return _num_blocks; }
+    size_t num_rows() const { return _num_rows; }
+    // The bytes written to disk.
+    size_t bytes() const { return _write_offset; }
+
+    // Return true if spilling is enabled for the query and there is some tmp device
+    // available to spill to.
+    static bool can_spill(RuntimeState* state);
+
+    // Return true if an operator holding 'mem_bytes' memory should spill, that is the
+    // memory consumption of the query goes beyond config::vec_spill_mem_limit_percent
+    // of its limit, or the query is asked to spill by the memory arbitrator because the
+    // process memory is under pressure. Operator which consumes very little memory never
+    // spills, because spilling it can not release enough memory but has to pay the IO.
+    static bool should_spill(RuntimeState* state, int64_t mem_bytes);
+
+private:
+    // a serialized block to write, with its header
+    struct BlockWrite {
+        uint8_t header[2 * sizeof(uint32_t)];
+        std::string data;
+    };
+
+    // a block being read ahead, with its header
+    struct BlockRead {
+        std::string data;
+        Status status;
+        bool done = false;
+    };
+
+    Status _write_block(const BlockWrite& write);
+    Status _read_block(uint64_t offset, size_t size, std::string* data);
+    // Queue the reads of the next blocks, so there are up to
+    // config::vec_spill_read_ahead_blocks blocks being read ahead.
+    void _read_ahead();
+
+    TmpFileMgr* _tmp_file_mgr;
+    TUniqueId _query_id;
+    segment_v2::CompressionTypePB _compression_type;
+    const BlockCompressionCodec* _codec = nullptr;
+    RuntimeProfile::Counter* _io_timer = nullptr;
+
+    std::unique_ptr<TmpFileMgr::File> _tmp_file;
+    std::unique_ptr<WritableFile> _writer;
+    std::unique_ptr<RandomAccessFile> _reader;
+
+    // The file io runs on the io threads in the order of submission, so the blocks are
+    // written and read in the order of the stream. nullptr to do the io in the caller.
+    std::unique_ptr<ThreadPoolToken> _io_token;
+    // protects the states below which are shared with the io threads
+    std::mutex _io_lock;
+    std::condition_variable _io_cv;
+    int _inflight_writes = 0;
+    // the first error of the writes on the io threads
+    Status _write_status;
+
+    std::deque<std::shared_ptr<BlockRead>> _read_ahead_blocks;
+    size_t _num_blocks_read_ahead = 0;
+    uint64_t _read_ahead_offset = 0;
+
+    // the bytes of each block in the file, including its header
+    std::vector<uint32_t> _block_sizes;
+
+    std::string _read_buf;
+    std::string _column_values_buf;
+    std::string _compression_buf;
+
+    size_t _num_blocks = 0;
+    size_t _num_rows = 0;
+    size_t _num_blocks_read = 0;
+    uint64_t _write_offset = 0;
+};
+
+using BlockSpillStreamPtr = std::unique_ptr<BlockSpillStream>;
+
+} // namespace vectorized
+} // namespace doris
@@ -30,10 +30,12 @@ namespace doris {
 namespace vectorized {
 VMysqlResultWriter::VMysqlResultWriter(BufferControlBlock* sinker,
                                        const std::vector<VExprContext*>& output_vexpr_ctxs,
-                                       RuntimeProfile* parent_profile)
+                                       RuntimeProfile* parent_profile,
+                                       VCommonExprs* common_exprs)
         : VResultWriter(),
           _sinker(sinker),
           _output_vexpr_ctxs(output_vexpr_ctxs),
+          _common_exprs(common_exprs),
           _parent_profile(parent_profile) {}
 
 Status VMysqlResultWriter::init(RuntimeState* state) {
@@ -53,12 +55,14 @@ void VMysqlResultWriter::_init_profile() {
 }
 
 template <PrimitiveType type, bool is_nullable>
-Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
-                                           std::unique_ptr<TFetchDataResult>& result,
+Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr, MysqlColumnBuffer& buf,
                                            const DataTypePtr& nested_type_ptr) {
     SCOPED_TIMER(_convert_tuple_timer);
 
     const auto row_size = column_ptr->size();
+    auto& buffer = buf.buffer;
+    auto& cell_ends = buf.cell_ends;
+    cell_ends.resize(row_size);
 
     doris::vectorized::ColumnPtr column;
     if constexpr (is_nullable) {
@@ -67,7 +71,6 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
         column = column_ptr;
     }
 
-    MysqlRowBuffer _buffer;
     int buf_ret = 0;
 
     if constexpr (type == TYPE_OBJECT || type == TYPE_VARCHAR) {
@@ -75,18 +78,16 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
             if (0 != buf_ret) {
                 return Status::InternalError("pack mysql buffer failed.");
             }
-            _buffer.reset();
-
             if constexpr (is_nullable) {
                 if (column_ptr->is_null_at(i)) {
-                    buf_ret = _buffer.push_null();
-                    result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+                    buf_ret = buffer.push_null();
+                    cell_ends[i] = buffer.length();
                     continue;
                 }
             }
 
             if constexpr (type == TYPE_OBJECT) {
-                buf_ret = _buffer.push_null();
+                buf_ret = buffer.push_null();
             }
             if constexpr (type == TYPE_VARCHAR) {
                 const auto string_val = column->get_data_at(i);
@@ -95,16 +96,16 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
                     if (string_val.size == 0) {
                         // 0x01 is a magic num, not useful actually, just for present ""
                         char* tmp_val = reinterpret_cast<char*>(0x01);
-                        buf_ret = _buffer.push_string(tmp_val, string_val.size);
+                        buf_ret = buffer.push_string(tmp_val, string_val.size);
                     } else {
-                        buf_ret = _buffer.push_null();
+                        buf_ret = buffer.push_null();
                     }
                 } else {
-                    buf_ret = _buffer.push_string(string_val.data, string_val.size);
+                    buf_ret = buffer.push_string(string_val.data, string_val.size);
                 }
             }
 
-            result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+            cell_ends[i] = buffer.length();
         }
     } else if constexpr (type == TYPE_ARRAY) {
         auto& column_array = assert_cast<const ColumnArray&>(*column);
@@ -113,34 +114,34 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
             if (0 != buf_ret) {
                 return Status::InternalError("pack mysql buffer failed.");
             }
-            _buffer.reset();
-
             if constexpr (is_nullable) {
                 if (column_ptr->is_null_at(i)) {
-                    buf_ret = _buffer.push_null();
-                    result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+                    buf_ret = buffer.push_null();
+                    cell_ends[i] = buffer.length();
                     continue;
                 }
             }
 
-            _buffer.open_dynamic_mode();
-            buf_ret = _buffer.push_string("[", 1);
+            if (0 != buffer.open_dynamic_mode()) {
+                return Status::InternalError("pack mysql buffer failed.");
+            }
+            buf_ret = buffer.push_string("[", 1);
             bool begin = true;
             for (int j = offsets[i - 1]; j < offsets[i]; ++j) {
                 if (!begin) {
-                    buf_ret = _buffer.push_string(", ", 2);
+                    buf_ret = buffer.push_string(", ", 2);
                 }
                 const auto& data = column_array.get_data_ptr();
                 if (data->is_null_at(j)) {
-                    buf_ret = _buffer.push_string("NULL", strlen("NULL"));
+                    buf_ret = buffer.push_string("NULL", strlen("NULL"));
                 } else {
-                    buf_ret = _add_one_cell(data, j, nested_type_ptr, _buffer);
+                    buf_ret = _add_one_cell(data, j, nested_type_ptr, buffer);
                 }
                 begin = false;
             }
-            buf_ret = _buffer.push_string("]", 1);
-            _buffer.close_dynamic_mode();
-            result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+            buf_ret = buffer.push_string("]", 1);
+            buffer.close_dynamic_mode();
+            cell_ends[i] = buffer.length();
         }
     } else {
         using ColumnType = typename PrimitiveTypeTraits<type>::ColumnType;
@@ -150,44 +151,41 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
             if (0 != buf_ret) {
                 return Status::InternalError("pack mysql buffer failed.");
             }
-            _buffer.reset();
-
             if constexpr (is_nullable) {
                 if (column_ptr->is_null_at(i)) {
-                    buf_ret = _buffer.push_null();
-                    result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+                    buf_ret = buffer.push_null();
+                    cell_ends[i] = buffer.length();
                     continue;
                 }
             }
 
             if constexpr (type == TYPE_BOOLEAN) {
                 //todo here need to using uint after MysqlRowBuffer support it
-                buf_ret = _buffer.push_tinyint(data[i]);
+                buf_ret = buffer.push_tinyint(data[i]);
             }
             if constexpr (type == TYPE_TINYINT) {
-                buf_ret = _buffer.push_tinyint(data[i]);
+                buf_ret = buffer.push_tinyint(data[i]);
             }
             if constexpr (type == TYPE_SMALLINT) {
-                buf_ret = _buffer.push_smallint(data[i]);
+                buf_ret = buffer.push_smallint(data[i]);
             }
             if constexpr (type == TYPE_INT) {
-                buf_ret = _buffer.push_int(data[i]);
+                buf_ret = buffer.push_int(data[i]);
             }
             if constexpr (type == TYPE_BIGINT) {
-                buf_ret = _buffer.push_bigint(data[i]);
+                buf_ret = buffer.push_bigint(data[i]);
             }
             if constexpr (type == TYPE_LARGEINT) {
-                auto v = LargeIntValue::to_string(data[i]);
-                buf_ret = _buffer.push_string(v.c_str(), v.size());
+                buf_ret = buffer.push_largeint(data[i]);
             }
             if constexpr (type == TYPE_FLOAT) {
-                buf_ret = _buffer.push_float(data[i]);
+                buf_ret = buffer.push_float(data[i]);
             }
             if constexpr (type == TYPE_DOUBLE) {
-                buf_ret = _buffer.push_double(data[i]);
+                buf_ret = buffer.push_double(data[i]);
             }
             if constexpr (type == TYPE_TIME) {
-                buf_ret = _buffer.push_time(data[i]);
+                buf_ret = buffer.push_time(data[i]);
             }
             if constexpr (type == TYPE_DATETIME) {
                 char buf[64];
@@ -196,16 +194,14 @@ Status VMysqlResultWriter::_add_one_column(const ColumnPtr& column_ptr,
                 memcpy(static_cast<void*>(&time_val), &time_num, sizeof(Int64));
                 // TODO(zhaochun), this function has core risk
                 char* pos = time_val.to_string(buf);
-                buf_ret = _buffer.push_string(buf, pos - buf - 1);
+                buf_ret = buffer.push_string(buf, pos - buf - 1);
             }
 
             if constexpr (type == TYPE_DECIMALV2) {
-                DecimalV2Value decimal_val(data[i]);
-                auto decimal_str = decimal_val.to_string();
-                buf_ret = _buffer.push_string(decimal_str.c_str(), decimal_str.length());
+                buf_ret = buffer.push_decimal(DecimalV2Value(data[i]), -1);
             }
 
-            result->result_batch.rows[i].append(_buffer.buf(), _buffer.length());
+            cell_ends[i] = buffer.length();
         }
     }
     if (0 != buf_ret) {
@@ -322,88 +318,91 @@ Status VMysqlResultWriter::append_block(Block& input_block) {
     // Exec vectorized expr here to speed up, block.rows() == 0 means expr exec
     // failed, just return the error status
     auto block = VExprContext::get_output_block_after_execute_exprs(_output_vexpr_ctxs, input_block,
-                                                                    status);
+                                                                    status, _common_exprs);
     auto num_rows = block.rows();
     if (UNLIKELY(num_rows == 0)) {
         return status;
     }
 
-    // convert one batch
+    // convert one batch, the cells are packed column by column first, then copied to the rows
     auto result = std::make_unique<TFetchDataResult>();
     result->result_batch.rows.resize(num_rows);
-    for (int i = 0; status.ok() && i < _output_vexpr_ctxs.size(); ++i) {
+    const size_t num_columns = _output_vexpr_ctxs.size();
+    std::unique_ptr<MysqlColumnBuffer[]> column_bufs(new MysqlColumnBuffer[num_columns]);
+    for (int i = 0; status.ok() && i < num_columns; ++i) {
         auto column_ptr = block.get_by_position(i).column->convert_to_full_column_if_const();
         auto type_ptr = block.get_by_position(i).type;
+        auto& buf = column_bufs[i];
 
         switch (_output_vexpr_ctxs[i]->root()->result_type()) {
         case TYPE_BOOLEAN:
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_BOOLEAN, false>(column_ptr, buf);
             }
             break;
         case TYPE_TINYINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_TINYINT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_TINYINT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_TINYINT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_TINYINT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_SMALLINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_SMALLINT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_INT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_INT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_INT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_INT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_INT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_BIGINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_BIGINT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_BIGINT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_BIGINT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_BIGINT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_LARGEINT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_LARGEINT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_FLOAT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_FLOAT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_FLOAT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_FLOAT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_FLOAT, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_DOUBLE: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DOUBLE, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_TIME: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_TIME, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_TIME, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_TIME, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_TIME, false>(column_ptr, buf);
             }
             break;
         }
@@ -411,35 +410,35 @@ Status VMysqlResultWriter::append_block(Block& input_block) {
         case TYPE_CHAR:
         case TYPE_VARCHAR: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_VARCHAR, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_DECIMALV2: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DECIMALV2, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_DATE:
         case TYPE_DATETIME: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_DATETIME, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DATETIME, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_DATETIME, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_DATETIME, false>(column_ptr, buf);
             }
             break;
         }
         case TYPE_HLL:
         case TYPE_OBJECT: {
             if (type_ptr->is_nullable()) {
-                status = _add_one_column<PrimitiveType::TYPE_OBJECT, true>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_OBJECT, true>(column_ptr, buf);
             } else {
-                status = _add_one_column<PrimitiveType::TYPE_OBJECT, false>(column_ptr, result);
+                status = _add_one_column<PrimitiveType::TYPE_OBJECT, false>(column_ptr, buf);
             }
             break;
         }
@@ -448,11 +447,11 @@ Status VMysqlResultWriter::append_block(Block& input_block) {
                 auto& nested_type =
                         assert_cast<const DataTypeNullable&>(*type_ptr).get_nested_type();
                 auto& sub_type = assert_cast<const DataTypeArray&>(*nested_type).get_nested_type();
-                status = _add_one_column<PrimitiveType::TYPE_ARRAY, true>(column_ptr, result,
+                status = _add_one_column<PrimitiveType::TYPE_ARRAY, true>(column_ptr, buf,
                                                                           sub_type);
             } else {
                 auto& sub_type = assert_cast<const DataTypeArray&>(*type_ptr).get_nested_type();
-                status = _add_one_column<PrimitiveType::TYPE_ARRAY, false>(column_ptr, result,
+                status = _add_one_column<PrimitiveType::TYPE_ARRAY, false>(column_ptr, buf,
                                                                            sub_type);
             }
             break;
@@ -469,6 +468,23 @@ Status VMysqlResultWriter::append_block(Block& input_block) {
             break;
         }
     }
+    if (status) {
+        SCOPED_TIMER(_convert_tuple_timer);
+        for (size_t row = 0; row < num_rows; ++row) {
+            int64_t row_size = 0;
+            for (size_t i = 0; i < num_columns; ++i) {
+                const auto& cell_ends = column_bufs[i].cell_ends;
+                row_size += cell_ends[row] - (row == 0 ? 0 : cell_ends[row - 1]);
+            }
+            auto& packet = result->result_batch.rows[row];
+            packet.reserve(row_size);
+            for (size_t i = 0; i < num_columns; ++i) {
+                const auto& cell_ends = column_bufs[i].cell_ends;
+                int64_t start = row == 0 ? 0 : cell_ends[row - 1];
+                packet.append(column_bufs[i].buffer.buf() + start, cell_ends[row] - start);
+            }
+        }
+    }
     if (status) {
         SCOPED_TIMER(_result_send_timer);
         // push this batch to back
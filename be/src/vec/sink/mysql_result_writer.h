@@ -29,13 +29,21 @@ class MysqlRowBuffer;
 class TFetchDataResult;
 
 namespace vectorized {
+class VCommonExprs;
 class VExprContext;
 
+// the packed cells of a column, one after another in the buffer
+struct MysqlColumnBuffer {
+    MysqlRowBuffer buffer;
+    // the end offsets of the cells of the rows in the buffer
+    std::vector<int64_t> cell_ends;
+};
+
 class VMysqlResultWriter final : public VResultWriter {
 public:
     VMysqlResultWriter(BufferControlBlock* sinker,
                        const std::vector<vectorized::VExprContext*>& output_vexpr_ctxs,
-                       RuntimeProfile* parent_profile);
+                       RuntimeProfile* parent_profile, VCommonExprs* common_exprs = nullptr);
 
     virtual Status init(RuntimeState* state) override;
 
@@ -49,7 +57,7 @@ private:
     void _init_profile();
 
     template <PrimitiveType type, bool is_nullable>
-    Status _add_one_column(const ColumnPtr& column_ptr, std::unique_ptr<TFetchDataResult>& result,
+    Status _add_one_column(const ColumnPtr& column_ptr, MysqlColumnBuffer& buf,
                            const DataTypePtr& nested_type_ptr = nullptr);
     int _add_one_cell(const ColumnPtr& column_ptr, size_t row_idx, const DataTypePtr& type,
                       MysqlRowBuffer& buffer);
@@ -58,6 +66,8 @@ private:
     BufferControlBlock* _sinker;
 
     const std::vector<vectorized::VExprContext*>& _output_vexpr_ctxs;
+    // the subexpressions shared by the output exprs, owned by the result sink
+    VCommonExprs* _common_exprs;
 
     RuntimeProfile* _parent_profile; // parent profile from result sink. not owned
     // total time cost on append batch operation
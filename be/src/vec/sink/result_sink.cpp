@@ -17,6 +17,7 @@
 
 #include "vec/sink/result_sink.h"
 
+#include "exec/rowid_fetcher.h"
 #include "runtime/buffer_control_block.h"
 #include "runtime/exec_env.h"
 #include "runtime/file_result_writer.h"
@@ -36,6 +37,9 @@ VResultSink::VResultSink(const RowDescriptor& row_desc, const std::vector<TExpr>
     } else {
         _sink_type = sink.type;
     }
+    if (sink.__isset.fetch_option) {
+        _fetch_option.reset(new TFetchOption(sink.fetch_option));
+    }
 
     _name = "ResultSink";
 }
@@ -47,7 +51,12 @@ Status VResultSink::prepare_exprs(RuntimeState* state) {
     RETURN_IF_ERROR(
             VExpr::create_expr_trees(state->obj_pool(), _t_output_expr, &_output_vexpr_ctxs));
     // Prepare the exprs to run.
-    RETURN_IF_ERROR(VExpr::prepare(_output_vexpr_ctxs, state, _row_desc, _expr_mem_tracker));
+    RETURN_IF_ERROR(VExpr::prepare(_output_vexpr_ctxs, state,
+                                   _fetch_row_desc != nullptr ? *_fetch_row_desc : _row_desc,
+                                   _expr_mem_tracker));
+    if (config::enable_common_subexpr_elimination) {
+        _common_exprs.init(state->obj_pool(), _output_vexpr_ctxs);
+    }
     return Status::OK();
 }
 Status VResultSink::prepare(RuntimeState* state) {
@@ -57,6 +66,15 @@ Status VResultSink::prepare(RuntimeState* state) {
                              fragment_instance_id.hi, fragment_instance_id.lo);
     // create profile
     _profile = state->obj_pool()->add(new RuntimeProfile(title));
+    if (_fetch_option != nullptr) {
+        auto fetch_tuple = state->desc_tbl().get_tuple_descriptor(_fetch_option->fetch_tuple_id);
+        _row_locator_pos = _row_desc.get_column_id(_fetch_option->row_locator_slot_id);
+        if (fetch_tuple == nullptr || _row_locator_pos < 0) {
+            return Status::InternalError("invalid fetch option of the result sink");
+        }
+        _fetch_row_desc.reset(new RowDescriptor(_row_desc, RowDescriptor(fetch_tuple, false)));
+        _row_id_fetcher.reset(new RowIdFetcher(fetch_tuple, _fetch_option->nodes_info));
+    }
     // prepare output_expr
     RETURN_IF_ERROR(prepare_exprs(state));
 
@@ -68,7 +86,8 @@ Status VResultSink::prepare(RuntimeState* state) {
     switch (_sink_type) {
     case TResultSinkType::MYSQL_PROTOCAL:
         _writer.reset(new (std::nothrow)
-                              VMysqlResultWriter(_sender.get(), _output_vexpr_ctxs, _profile));
+                              VMysqlResultWriter(_sender.get(), _output_vexpr_ctxs, _profile,
+                                                 &_common_exprs));
         break;
     default:
         return Status::InternalError("Unknown result sink type");
@@ -87,6 +106,10 @@ Status VResultSink::send(RuntimeState* state, RowBatch* batch) {
 }
 
 Status VResultSink::send(RuntimeState* state, Block* block) {
+    if (_row_id_fetcher != nullptr && block->rows() > 0) {
+        RETURN_IF_ERROR(_row_id_fetcher->fetch(
+                state, block->get_by_position(_row_locator_pos).column, block));
+    }
     return _writer->append_block(*block);
 }
 
@@ -17,6 +17,7 @@
 
 #pragma once
 #include "exec/data_sink.h"
+#include "vec/exprs/vcommon_exprs.h"
 #include "vec/sink/result_writer.h"
 
 namespace doris {
@@ -28,6 +29,7 @@ class BufferControlBlock;
 class ExprContext;
 class ResultWriter;
 class MemTracker;
+class RowIdFetcher;
 struct ResultFileOptions;
 namespace vectorized {
 class VExprContext;
@@ -61,9 +63,19 @@ private:
     // Owned by the RuntimeState.
     const RowDescriptor& _row_desc;
 
+    // the second phase of a two-phase Top-N query, the columns of the fetch tuple are fetched
+    // by the row locators and appended to the blocks before the output exprs are evaluated
+    std::unique_ptr<TFetchOption> _fetch_option;
+    std::unique_ptr<RowIdFetcher> _row_id_fetcher;
+    // `_row_desc` and the fetch tuple, the output exprs are prepared with it
+    std::unique_ptr<RowDescriptor> _fetch_row_desc;
+    int _row_locator_pos = -1;
+
     // Owned by the RuntimeState.
     const std::vector<TExpr>& _t_output_expr;
     std::vector<vectorized::VExprContext*> _output_vexpr_ctxs;
+    // the subexpressions shared by the output exprs
+    VCommonExprs _common_exprs;
 
     std::shared_ptr<BufferControlBlock> _sender;
     std::shared_ptr<VResultWriter> _writer;
@@ -29,7 +29,6 @@
 #include "runtime/runtime_state.h"
 #include "runtime/thread_context.h"
 #include "util/proto_util.h"
-#include "vec/common/sip_hash.h"
 #include "vec/runtime/vdata_stream_mgr.h"
 #include "vec/runtime/vdata_stream_recvr.h"
 #include "vec/runtime/vpartition_info.h"
@@ -68,15 +67,19 @@ Status VDataStreamSender::Channel::init(RuntimeState* state) {
     // to build a camouflaged empty channel. the ip and port is '0.0.0.0:0"
     // so the empty channel not need call function close_internal()
     _need_close = (_fragment_instance_id.hi != -1 && _fragment_instance_id.lo != -1);
+    if (_parent->_use_exchange_mux && _need_close && !_is_local) {
+        _mux = state->exec_env()->vstream_mgr()->get_exchange_mux(
+                state->query_id(), _brpc_dest_addr, _brpc_stub, _brpc_timeout_ms);
+    }
     return Status::OK();
 }
 
 Status VDataStreamSender::Channel::send_current_block(bool eos) {
-    // TODO: Now, local exchange will cause the performance problem is in a multi-threaded scenario
-    //  so this feature is turned off here. We need to re-examine this logic
-    //    if (is_local()) {
-    //        return send_local_block(eos);
-    //    }
+    // the buffered columns are scattered for this channel only, so they are moved to the local
+    // receiver as they are
+    if (is_local() && config::enable_vec_partitioned_local_exchange) {
+        return send_local_block(eos);
+    }
     auto block = _mutable_block->to_block();
     RETURN_IF_ERROR(_parent->serialize_block(&block, _ch_cur_pb_block));
     block.clear_column_data();
@@ -91,30 +94,36 @@ Status VDataStreamSender::Channel::send_local_block(bool eos) {
             _parent->state()->exec_env()->vstream_mgr()->find_recvr(_fragment_instance_id,
                                                                     _dest_node_id);
     if (recvr != nullptr) {
-        Block block = _mutable_block->to_block();
-        COUNTER_UPDATE(_parent->_local_bytes_send_counter, block.bytes());
-        recvr->add_block(&block, _parent->_sender_id, true);
+        if (_mutable_block != nullptr && _mutable_block->rows() > 0) {
+            Block block = _mutable_block->to_block();
+            COUNTER_UPDATE(_parent->_local_bytes_send_counter, block.bytes());
+            recvr->add_block(&block, _parent->_sender_id, true);
+        }
         if (eos) {
             recvr->remove_sender(_parent->_sender_id, _be_number);
         }
     }
-    _mutable_block->clear();
+    if (_mutable_block != nullptr) {
+        _mutable_block->clear();
+    }
     return Status::OK();
 }
 
-Status VDataStreamSender::Channel::send_local_block(Block* block) {
+Status VDataStreamSender::Channel::send_local_block(Block* block, bool use_move) {
     std::shared_ptr<VDataStreamRecvr> recvr =
             _parent->state()->exec_env()->vstream_mgr()->find_recvr(_fragment_instance_id,
                                                                     _dest_node_id);
     if (recvr != nullptr) {
         COUNTER_UPDATE(_parent->_local_bytes_send_counter, block->bytes());
-        recvr->add_block(block, _parent->_sender_id, false);
+        recvr->add_block(block, _parent->_sender_id, use_move);
     }
     return Status::OK();
 }
 
 Status VDataStreamSender::Channel::send_block(PBlock* block, bool eos) {
-    if (_closure == nullptr) {
+    if (_mux != nullptr) {
+        RETURN_IF_ERROR(_wait_last_brpc());
+    } else if (_closure == nullptr) {
         _closure = new RefCountClosure<PTransmitDataResult>();
         _closure->ref();
     } else {
@@ -135,6 +144,12 @@ Status VDataStreamSender::Channel::send_block(PBlock* block, bool eos) {
     }
     _brpc_request.set_packet_seq(_packet_seq++);
 
+    if (_mux != nullptr) {
+        // the block is released once the rpc carrying it finishes
+        _mux->transmit(&_brpc_request, &_mux_request);
+        return Status::OK();
+    }
+
     _closure->ref();
     _closure->cntl.set_timeout_ms(_brpc_timeout_ms);
 
@@ -161,44 +176,28 @@ Status VDataStreamSender::Channel::add_row(Block* block, int row) {
     }
     _mutable_block->add_row(block, row);
 
-    if (_mutable_block->rows() == _parent->state()->batch_size()) {
+    if (_mutable_block->rows() >= _parent->block_rows()) {
         RETURN_IF_ERROR(send_current_block());
     }
     return Status::OK();
 }
 
-Status VDataStreamSender::Channel::add_rows(Block* block, const std::vector<int>& rows) {
+Status VDataStreamSender::Channel::add_columns(const Block* block, MutableColumns&& columns) {
     if (_fragment_instance_id.lo == -1) {
         return Status::OK();
     }
 
-    if (_mutable_block.get() == nullptr) {
-        _mutable_block.reset(new MutableBlock(block->clone_empty()));
+    Block rows = block->clone_with_columns(std::move(columns));
+    if (_mutable_block == nullptr || _mutable_block->rows() == 0) {
+        // take the scattered columns as they are instead of copying them
+        _mutable_block.reset(new MutableBlock(std::move(rows)));
+    } else {
+        _mutable_block->merge(std::move(rows));
     }
 
-    int row_wait_add = rows.size();
-    int batch_size = _parent->state()->batch_size();
-    const int* begin = &rows[0];
-
-    while (row_wait_add > 0) {
-        int row_add = 0;
-        int max_add = batch_size - _mutable_block->rows();
-        if (row_wait_add >= max_add) {
-            row_add = max_add;
-        } else {
-            row_add = row_wait_add;
-        }
-
-        _mutable_block->add_rows(block, begin, begin + row_add);
-
-        row_wait_add -= row_add;
-        begin += row_add;
-
-        if (row_add == max_add) {
-            RETURN_IF_ERROR(send_current_block());
-        }
+    if (_mutable_block->rows() >= _parent->block_rows()) {
+        RETURN_IF_ERROR(send_current_block());
     }
-
     return Status::OK();
 }
 
@@ -222,7 +221,10 @@ Status VDataStreamSender::Channel::close_internal() {
     VLOG_RPC << "Channel::close() instance_id=" << _fragment_instance_id
              << " dest_node=" << _dest_node_id
              << " #rows= " << ((_mutable_block == nullptr) ? 0 : _mutable_block->rows());
-    if (_mutable_block != nullptr && _mutable_block->rows() > 0) {
+    if (is_local()) {
+        // the receiver is in this backend, no rpc is needed even for the eos
+        RETURN_IF_ERROR(send_local_block(true));
+    } else if (_mutable_block != nullptr && _mutable_block->rows() > 0) {
         RETURN_IF_ERROR(send_current_block(true));
     } else {
         RETURN_IF_ERROR(send_block(nullptr, true));
@@ -254,6 +256,7 @@ VDataStreamSender::VDataStreamSender(ObjectPool* pool, int sender_id, const RowD
           _current_channel_idx(0),
           _part_type(sink.output_partition.type),
           _ignore_not_found(sink.__isset.ignore_not_found ? sink.ignore_not_found : true),
+          _use_exchange_mux(config::enable_vec_exchange_multiplex),
           _cur_pb_block(&_pb_block1),
           _profile(nullptr),
           _serialize_batch_timer(nullptr),
@@ -331,6 +334,13 @@ Status VDataStreamSender::init(const TDataSink& tsink) {
 Status VDataStreamSender::prepare(RuntimeState* state) {
     RETURN_IF_ERROR(DataSink::prepare(state));
     _state = state;
+    if (state->query_options().__isset.exchange_column_codec &&
+        state->query_options().exchange_column_codec == TExchangeColumnCodec::BITSHUFFLE_LZ4) {
+        _column_codec = PColumnMeta::BITSHUFFLE_LZ4;
+    }
+    _block_size = std::make_unique<AdaptiveBlockSize>(state->batch_size(),
+                                                      state->preferred_block_size_bytes(),
+                                                      config::adaptive_block_max_rows);
 
     std::vector<std::string> instances;
     for (const auto& channel : _channels) {
@@ -392,6 +402,9 @@ Status VDataStreamSender::send(RuntimeState* state, RowBatch* batch) {
 Status VDataStreamSender::send(RuntimeState* state, Block* block) {
     SCOPED_TIMER(_profile->total_time_counter());
     SCOPED_SWITCH_TASK_THREAD_LOCAL_EXISTED_MEM_TRACKER(_mem_tracker);
+    // the block leaves the fragment
+    block->materialize_selection();
+    _block_size->observe(*block);
     if (_part_type == TPartitionType::UNPARTITIONED || _channels.size() == 1) {
         // 1. serialize depends on it is not local exchange
         // 2. send block
@@ -400,15 +413,16 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block) {
         for (auto channel : _channels) {
             if (channel->is_local()) local_size++;
         }
+        // the last local channel takes the columns of the block, the others copy them
         if (local_size == _channels.size()) {
             for (auto channel : _channels) {
-                RETURN_IF_ERROR(channel->send_local_block(block));
+                RETURN_IF_ERROR(channel->send_local_block(block, --local_size == 0));
             }
         } else {
             RETURN_IF_ERROR(serialize_block(block, _cur_pb_block, _channels.size()));
             for (auto channel : _channels) {
                 if (channel->is_local()) {
-                    RETURN_IF_ERROR(channel->send_local_block(block));
+                    RETURN_IF_ERROR(channel->send_local_block(block, --local_size == 0));
                 } else {
                     RETURN_IF_ERROR(channel->send_block(_cur_pb_block));
                 }
@@ -421,7 +435,7 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block) {
         Channel* current_channel = _channels[_current_channel_idx];
         // 2. serialize, send and rollover block
         if (current_channel->is_local()) {
-            RETURN_IF_ERROR(current_channel->send_local_block(block));
+            RETURN_IF_ERROR(current_channel->send_local_block(block, true));
         } else {
             RETURN_IF_ERROR(serialize_block(block, current_channel->ch_cur_pb_block()));
             RETURN_IF_ERROR(current_channel->send_block(current_channel->ch_cur_pb_block()));
@@ -437,22 +451,12 @@ Status VDataStreamSender::send(RuntimeState* state, Block* block) {
         int result[result_size];
         RETURN_IF_ERROR(get_partition_column_result(block, result));
 
-        // vectorized calculate hash
+        // vectorized calculate hash, the whole partition columns are hashed by crc32 at once
         int rows = block->rows();
-        // for each row, we have a siphash val
-        std::vector<SipHash> siphashs(rows);
-        // result[j] means column index, i means rows index
+        std::vector<uint32_t> hash_vals(rows);
+        // result[j] means column index
         for (int j = 0; j < result_size; ++j) {
-            auto column = block->get_by_position(result[j]).column;
-            for (int i = 0; i < rows; ++i) {
-                column->update_hash_with_value(i, siphashs[i]);
-            }
-        }
-
-        // channel2rows' subscript means channel id
-        std::vector<vectorized::UInt64> hash_vals(rows);
-        for (int i = 0; i < rows; i++) {
-            hash_vals[i] = siphashs[i].get64();
+            block->get_by_position(result[j]).column->update_crcs_with_value(hash_vals);
         }
 
         Block::erase_useless_column(block, column_to_keep);
@@ -532,7 +536,11 @@ Status VDataStreamSender::serialize_block(Block* src, PBlock* dest, int num_rece
         dest->Clear();
         size_t uncompressed_bytes = 0, compressed_bytes = 0;
         RETURN_IF_ERROR(src->serialize(dest, &uncompressed_bytes, &compressed_bytes,
-                                       &_column_values_buffer));
+                                       &_column_values_buffer, true, _column_codec));
+        if (_use_exchange_mux) {
+            // the block may be sent after the next one is serialized
+            dest->mutable_column_values()->swap(_column_values_buffer);
+        }
         COUNTER_UPDATE(_bytes_sent_counter, compressed_bytes * num_receivers);
         COUNTER_UPDATE(_uncompressed_bytes_counter, uncompressed_bytes * num_receivers);
     }
@@ -29,7 +29,9 @@
 #include "util/network_util.h"
 #include "util/ref_count_closure.h"
 #include "util/uid_util.h"
+#include "vec/core/adaptive_block_size.h"
 #include "vec/exprs/vexpr.h"
+#include "vec/runtime/vexchange_mux.h"
 
 namespace doris {
 class ObjectPool;
@@ -67,6 +69,9 @@ public:
 
     RuntimeState* state() { return _state; }
 
+    // the rows a channel buffers before sending them, by the width of the rows sent so far
+    size_t block_rows() const { return _block_size->rows(); }
+
     Status serialize_block(Block* src, PBlock* dest, int num_receivers = 1);
 
 private:
@@ -107,6 +112,12 @@ private:
 
     TPartitionType::type _part_type;
     bool _ignore_not_found;
+    // whether the channels send the blocks by the exchange multiplexers of their hosts, the
+    // column values of a serialized block are in the PBlock instead of _column_values_buffer
+    bool _use_exchange_mux;
+    // the codec of the fixed-width columns of the serialized blocks
+    PColumnMeta::Codec _column_codec = PColumnMeta::PLAIN;
+    std::unique_ptr<AdaptiveBlockSize> _block_size;
 
     // serialized batches for broadcasting; we need two so we can write
     // one while the other one is still being sent
@@ -181,6 +192,10 @@ public:
         if (_closure != nullptr && _closure->unref()) {
             delete _closure;
         }
+        if (_mux != nullptr) {
+            // the rpc may still refer to the request
+            _wait_last_brpc();
+        }
         // release this before request desctruct
         _brpc_request.release_finst_id();
     }
@@ -201,13 +216,17 @@ public:
     Status send_block(PBlock* block, bool eos = false);
 
     Status add_row(Block* block, int row);
-    Status add_rows(Block* block, const std::vector<int>& row);
+    // Append the rows of `block` scattered to this channel, `columns` are the columns of `block`
+    // keeping only these rows. Sends the buffered rows once there are at least block_rows() rows.
+    Status add_columns(const Block* block, MutableColumns&& columns);
 
     Status send_current_block(bool eos = false);
 
     Status send_local_block(bool eos = false);
 
-    Status send_local_block(Block* block);
+    // Hands `block` to the local receiver, its columns are moved instead of copied if
+    // `use_move` is true, and `block` is cleared.
+    Status send_local_block(Block* block, bool use_move = false);
     // Flush buffered rows and close channel. This function don't wait the response
     // of close operation, client should call close_wait() to finish channel's close.
     // We split one close operation into two phases in order to make multiple channels
@@ -234,6 +253,14 @@ public:
 
 private:
     Status _wait_last_brpc() {
+        if (_mux != nullptr) {
+            Status st = _mux_request.wait();
+            // the block is owned by the channel
+            if (_brpc_request.has_block()) {
+                _brpc_request.release_block();
+            }
+            return st;
+        }
         if (_closure == nullptr) return Status::OK();
         auto cntl = &_closure->cntl;
         auto call_id = _closure->cntl.call_id();
@@ -278,6 +305,9 @@ private:
     PTransmitDataParams _brpc_request;
     std::shared_ptr<PBackendService_Stub> _brpc_stub = nullptr;
     RefCountClosure<PTransmitDataResult>* _closure = nullptr;
+    // not nullptr if the blocks are sent by the exchange multiplexer of the host
+    std::shared_ptr<VExchangeMux> _mux;
+    VExchangeMux::Request _mux_request;
     int32_t _brpc_timeout_ms = 500;
     // whether the dest can be treated as query statistics transfer chain.
     bool _is_transfer_chain;
@@ -298,16 +328,24 @@ private:
 template <typename Channels, typename HashVals>
 Status VDataStreamSender::channel_add_rows(Channels& channels, int num_channels,
                                            const HashVals& hash_vals, int rows, Block* block) {
-    std::vector<int> channel2rows[num_channels];
-
+    IColumn::Selector selector(rows);
     for (int i = 0; i < rows; i++) {
-        auto cid = hash_vals[i] % num_channels;
-        channel2rows[cid].emplace_back(i);
+        selector[i] = hash_vals[i] % num_channels;
+    }
+
+    // split each column into the columns of all the channels at once
+    std::vector<MutableColumns> channel_columns(num_channels);
+    for (size_t j = 0; j < block->columns(); ++j) {
+        auto column = block->get_by_position(j).column->convert_to_full_column_if_const();
+        auto columns = column->scatter(num_channels, selector);
+        for (int i = 0; i < num_channels; ++i) {
+            channel_columns[i].emplace_back(std::move(columns[i]));
+        }
     }
 
     for (int i = 0; i < num_channels; ++i) {
-        if (!channel2rows[i].empty()) {
-            RETURN_IF_ERROR(channels[i]->add_rows(block, channel2rows[i]));
+        if (!channel_columns[i].empty() && !channel_columns[i][0]->empty()) {
+            RETURN_IF_ERROR(channels[i]->add_columns(block, std::move(channel_columns[i])));
         }
     }
 
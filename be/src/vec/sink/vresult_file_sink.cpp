@@ -0,0 +1,123 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/sink/vresult_file_sink.h"
+
+#include "runtime/buffer_control_block.h"
+#include "runtime/exec_env.h"
+#include "runtime/file_result_writer.h"
+#include "runtime/result_buffer_mgr.h"
+#include "runtime/runtime_state.h"
+#include "util/uid_util.h"
+#include "vec/exprs/vexpr.h"
+#include "vec/runtime/vfile_result_writer.h"
+
+namespace doris::vectorized {
+
+VResultFileSink::VResultFileSink(const RowDescriptor& row_desc,
+                                 const std::vector<TExpr>& t_output_expr,
+                                 const TResultFileSink& sink)
+        : _row_desc(row_desc), _t_output_expr(t_output_expr) {
+    CHECK(sink.__isset.file_options);
+    _file_opts.reset(new ResultFileOptions(sink.file_options));
+    CHECK(sink.__isset.storage_backend_type);
+    _storage_type = sink.storage_backend_type;
+
+    _name = "VResultFileSink";
+    //for impl csv_with_name and csv_with_names_and_types
+    _header_type = sink.header_type;
+    _header = sink.header;
+}
+
+VResultFileSink::~VResultFileSink() = default;
+
+Status VResultFileSink::prepare_exprs(RuntimeState* state) {
+    // From the thrift expressions create the real exprs.
+    RETURN_IF_ERROR(
+            VExpr::create_expr_trees(state->obj_pool(), _t_output_expr, &_output_vexpr_ctxs));
+    // Prepare the exprs to run.
+    RETURN_IF_ERROR(VExpr::prepare(_output_vexpr_ctxs, state, _row_desc, _expr_mem_tracker));
+    return Status::OK();
+}
+
+Status VResultFileSink::prepare(RuntimeState* state) {
+    RETURN_IF_ERROR(DataSink::prepare(state));
+    std::stringstream title;
+    title << "VDataBufferSender (dst_fragment_instance_id="
+          << print_id(state->fragment_instance_id()) << ")";
+    // create profile
+    _profile = state->obj_pool()->add(new RuntimeProfile(title.str()));
+    // prepare output_expr
+    RETURN_IF_ERROR(prepare_exprs(state));
+
+    // create sender
+    RETURN_IF_ERROR(state->exec_env()->result_mgr()->create_sender(state->fragment_instance_id(),
+                                                                   _buf_size, &_sender));
+    // create writer
+    _writer.reset(new (std::nothrow) VFileResultWriter(
+            _file_opts.get(), _storage_type, state->fragment_instance_id(), _output_vexpr_ctxs,
+            _profile, _sender.get(), state->return_object_data_as_binary()));
+    _writer->set_header_info(_header_type, _header);
+    return _writer->init(state);
+}
+
+Status VResultFileSink::open(RuntimeState* state) {
+    return VExpr::open(_output_vexpr_ctxs, state);
+}
+
+Status VResultFileSink::send(RuntimeState* state, RowBatch* batch) {
+    return Status::NotSupported("Not Implemented VResultFileSink::send scalar");
+}
+
+Status VResultFileSink::send(RuntimeState* state, Block* block) {
+    return _writer->append_block(*block);
+}
+
+Status VResultFileSink::close(RuntimeState* state, Status exec_status) {
+    if (_closed) {
+        return Status::OK();
+    }
+
+    Status final_status = exec_status;
+    // close the writer
+    if (_writer != nullptr) {
+        Status st = _writer->close();
+        if (!st.ok() && exec_status.ok()) {
+            // close file writer failed, should return this error to client
+            final_status = st;
+        }
+    }
+
+    // close sender, this is normal path end
+    if (_sender != nullptr) {
+        _sender->update_num_written_rows(_writer == nullptr ? 0 : _writer->get_written_rows());
+        _sender->close(final_status);
+    }
+    state->exec_env()->result_mgr()->cancel_at_time(
+            time(nullptr) + config::result_buffer_cancelled_interval_time,
+            state->fragment_instance_id());
+
+    VExpr::close(_output_vexpr_ctxs, state);
+    return DataSink::close(state, exec_status);
+}
+
+void VResultFileSink::set_query_statistics(std::shared_ptr<QueryStatistics> statistics) {
+    _sender->set_query_statistics(statistics);
+}
+
+} // namespace doris::vectorized
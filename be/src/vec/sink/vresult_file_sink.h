@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#pragma once
+
+#include "exec/data_sink.h"
+#include "gen_cpp/DataSinks_types.h"
+#include "gen_cpp/Types_types.h"
+#include "vec/sink/result_writer.h"
+
+namespace doris {
+class BufferControlBlock;
+class RuntimeProfile;
+class RuntimeState;
+struct ResultFileOptions;
+
+namespace vectorized {
+class VExprContext;
+
+// The vectorized ResultFileSink of the top fragment, writes the blocks to the export files by
+// VFileResultWriter and sends the statistic result to the client.
+// The result file sink which sends its result to another fragment is still the row based
+// ResultFileSink.
+class VResultFileSink : public DataSink {
+public:
+    VResultFileSink(const RowDescriptor& row_desc, const std::vector<TExpr>& select_exprs,
+                    const TResultFileSink& sink);
+    ~VResultFileSink() override;
+
+    Status prepare(RuntimeState* state) override;
+    Status open(RuntimeState* state) override;
+    // not implement
+    Status send(RuntimeState* state, RowBatch* batch) override;
+    Status send(RuntimeState* state, Block* block) override;
+    // Flush all buffered data and close the writer.
+    // Further send() calls are illegal after calling close().
+    Status close(RuntimeState* state, Status exec_status) override;
+    RuntimeProfile* profile() override { return _profile; }
+
+    void set_query_statistics(std::shared_ptr<QueryStatistics> statistics) override;
+
+private:
+    Status prepare_exprs(RuntimeState* state);
+
+    std::unique_ptr<ResultFileOptions> _file_opts;
+    TStorageBackendType::type _storage_type;
+
+    // Owned by the RuntimeState.
+    const RowDescriptor& _row_desc;
+    const std::vector<TExpr>& _t_output_expr;
+    std::vector<VExprContext*> _output_vexpr_ctxs;
+
+    std::shared_ptr<BufferControlBlock> _sender;
+    std::shared_ptr<VResultWriter> _writer;
+    RuntimeProfile* _profile = nullptr; // Allocated from _pool
+    int _buf_size = 1024;
+    std::string _header;
+    std::string _header_type;
+};
+
+} // namespace vectorized
+} // namespace doris
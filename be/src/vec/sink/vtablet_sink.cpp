@@ -29,12 +29,62 @@
 namespace doris {
 namespace stream_load {
 
+// Passes the results of the tablet writer stream to its channel. It's alive until the stream is
+// closed, and the channel detaches itself from the handler when it's destroyed.
+class VNodeChannel::StreamResultHandler : public brpc::StreamInputHandler {
+public:
+    explicit StreamResultHandler(VNodeChannel* channel) : _channel(channel) {}
+
+    int on_received_messages(brpc::StreamId id, butil::IOBuf* const messages[],
+                             size_t size) override {
+        std::lock_guard<std::mutex> l(_lock);
+        for (size_t i = 0; i < size && _channel != nullptr; ++i) {
+            PTabletWriterAddBlockResult result;
+            butil::IOBufAsZeroCopyInputStream result_stream(*messages[i]);
+            if (!result.ParseFromZeroCopyStream(&result_stream)) {
+                Status::InternalError("failed to parse the result of the tablet writer stream")
+                        .to_protobuf(result.mutable_status());
+            }
+            _channel->_on_stream_result(result);
+        }
+        return 0;
+    }
+
+    void on_idle_timeout(brpc::StreamId id) override {}
+
+    void on_closed(brpc::StreamId id) override {
+        std::shared_ptr<StreamResultHandler> self;
+        std::lock_guard<std::mutex> l(_lock);
+        if (_channel != nullptr) {
+            _channel->_on_stream_closed();
+        }
+        self = std::move(_self);
+    }
+
+    // keep the handler alive until the stream is closed
+    void keep_alive(std::shared_ptr<StreamResultHandler> self) { _self = std::move(self); }
+
+    void detach() {
+        std::lock_guard<std::mutex> l(_lock);
+        _channel = nullptr;
+    }
+
+private:
+    std::mutex _lock;
+    VNodeChannel* _channel;
+    std::shared_ptr<StreamResultHandler> _self;
+};
+
 VNodeChannel::VNodeChannel(OlapTableSink* parent, IndexChannel* index_channel, int64_t node_id)
         : NodeChannel(parent, index_channel, node_id) {
     _is_vectorized = true;
 }
 
 VNodeChannel::~VNodeChannel() {
+    if (_stream_handler != nullptr) {
+        _stream_handler->detach();
+        brpc::StreamClose(_stream_id);
+    }
     _cur_add_block_request.release_id();
 }
 
@@ -74,68 +124,184 @@ Status VNodeChannel::open_wait() {
     // add block closure
     _add_block_closure = ReusableClosure<PTabletWriterAddBlockResult>::create();
     _add_block_closure->addFailedHandler([this](bool is_last_rpc) {
-        std::lock_guard<std::mutex> l(this->_closed_lock);
-        if (this->_is_closed) {
-            // if the node channel is closed, no need to call `mark_as_failed`,
-            // and notice that _index_channel may already be destroyed.
-            return;
+        _on_add_block_failed(_add_block_closure->cntl.ErrorText(), is_last_rpc);
+    });
+    _add_block_closure->addSuccessHandler(
+            [this](const PTabletWriterAddBlockResult& result, bool is_last_rpc) {
+                _on_add_block_result(result, is_last_rpc);
+            });
+
+    if (config::enable_tablet_writer_stream) {
+        _open_stream();
+    }
+    return status;
+}
+
+void VNodeChannel::_on_add_block_failed(const std::string& error_text, bool is_last_rpc) {
+    std::lock_guard<std::mutex> l(this->_closed_lock);
+    if (this->_is_closed) {
+        // if the node channel is closed, no need to call `mark_as_failed`,
+        // and notice that _index_channel may already be destroyed.
+        return;
+    }
+    // If rpc failed, mark all tablets on this node channel as failed
+    _index_channel->mark_as_failed(this->node_id(), this->host(), error_text, -1);
+    Status st = _index_channel->check_intolerable_failure();
+    if (!st.ok()) {
+        _cancel_with_msg(fmt::format("{}, err: {}", channel_info(), st.get_error_msg()));
+    } else if (is_last_rpc) {
+        // if this is last rpc, will must set _add_batches_finished. otherwise, node channel's close_wait
+        // will be blocked.
+        _add_batches_finished = true;
+    }
+}
+
+void VNodeChannel::_on_add_block_result(const PTabletWriterAddBlockResult& result,
+                                        bool is_last_rpc) {
+    std::lock_guard<std::mutex> l(this->_closed_lock);
+    if (this->_is_closed) {
+        // if the node channel is closed, no need to call the following logic,
+        // and notice that _index_channel may already be destroyed.
+        return;
+    }
+    Status status(result.status());
+    if (status.ok()) {
+        // if has error tablet, handle them first
+        for (auto& error : result.tablet_errors()) {
+            _index_channel->mark_as_failed(this->node_id(), this->host(), error.msg(),
+                                           error.tablet_id());
         }
-        // If rpc failed, mark all tablets on this node channel as failed
-        _index_channel->mark_as_failed(this->node_id(), this->host(),
-                                       _add_block_closure->cntl.ErrorText(), -1);
+
         Status st = _index_channel->check_intolerable_failure();
         if (!st.ok()) {
-            _cancel_with_msg(fmt::format("{}, err: {}", channel_info(), st.get_error_msg()));
+            _cancel_with_msg(st.get_error_msg());
         } else if (is_last_rpc) {
-            // if this is last rpc, will must set _add_batches_finished. otherwise, node channel's close_wait
-            // will be blocked.
+            _add_tablet_commit_infos(result);
             _add_batches_finished = true;
         }
-    });
+    } else {
+        _cancel_with_msg(fmt::format("{}, add batch req success but status isn't ok, err: {}",
+                                     channel_info(), status.get_error_msg()));
+    }
 
-    _add_block_closure->addSuccessHandler([this](const PTabletWriterAddBlockResult& result,
-                                                 bool is_last_rpc) {
-        std::lock_guard<std::mutex> l(this->_closed_lock);
-        if (this->_is_closed) {
-            // if the node channel is closed, no need to call the following logic,
-            // and notice that _index_channel may already be destroyed.
-            return;
-        }
-        Status status(result.status());
-        if (status.ok()) {
-            // if has error tablet, handle them first
-            for (auto& error : result.tablet_errors()) {
-                _index_channel->mark_as_failed(this->node_id(), this->host(), error.msg(),
-                                               error.tablet_id());
-            }
+    if (result.has_execution_time_us()) {
+        _add_batch_counter.add_batch_execution_time_us += result.execution_time_us();
+        _add_batch_counter.add_batch_wait_execution_time_us += result.wait_execution_time_us();
+        _add_batch_counter.add_batch_num++;
+    }
+}
 
-            Status st = _index_channel->check_intolerable_failure();
-            if (!st.ok()) {
-                _cancel_with_msg(st.get_error_msg());
-            } else if (is_last_rpc) {
-                for (auto& tablet : result.tablet_vec()) {
-                    TTabletCommitInfo commit_info;
-                    commit_info.tabletId = tablet.tablet_id();
-                    commit_info.backendId = _node_id;
-                    _tablet_commit_infos.emplace_back(std::move(commit_info));
-                }
-                _add_batches_finished = true;
-            }
-        } else {
-            _cancel_with_msg(fmt::format("{}, add batch req success but status isn't ok, err: {}",
-                                         channel_info(), status.get_error_msg()));
-        }
+void VNodeChannel::_open_stream() {
+    auto handler = std::make_shared<StreamResultHandler>(this);
+    brpc::Controller cntl;
+    cntl.set_timeout_ms(config::tablet_writer_open_rpc_timeout_sec * 1000);
+    brpc::StreamOptions options;
+    options.handler = handler.get();
+    options.max_buf_size = config::tablet_writer_stream_max_buf_bytes;
+    if (brpc::StreamCreate(&_stream_id, cntl, &options) != 0) {
+        LOG(WARNING) << channel_info() << " failed to create the tablet writer stream, "
+                     << "send the blocks by the add_block rpcs";
+        _stream_id = brpc::INVALID_STREAM_ID;
+        return;
+    }
+    handler->keep_alive(handler);
+    _stream_handler = std::move(handler);
+
+    PTabletWriterOpenStreamRequest request;
+    request.set_allocated_id(&_parent->_load_id);
+    request.set_index_id(_index_channel->_index_id);
+    request.set_sender_id(_parent->_sender_id);
+    PTabletWriterOpenStreamResult result;
+    _stub->tablet_writer_open_stream(&cntl, &request, &result, nullptr);
+    request.release_id();
+    if (cntl.Failed() || !Status(result.status()).ok()) {
+        // the receiver may not support the stream
+        LOG(WARNING) << channel_info() << " failed to open the tablet writer stream, err: "
+                     << (cntl.Failed() ? cntl.ErrorText() : Status(result.status()).to_string())
+                     << ", send the blocks by the add_block rpcs";
+        _stream_handler->detach();
+        brpc::StreamClose(_stream_id);
+        _stream_handler.reset();
+        _stream_id = brpc::INVALID_STREAM_ID;
+    }
+}
+
+Status VNodeChannel::_write_stream(PTabletWriterAddBlockRequest* request, int64_t timeout_ms) {
+    butil::IOBuf header;
+    {
+        butil::IOBufAsZeroCopyOutputStream header_stream(&header);
+        request->SerializeToZeroCopyStream(&header_stream);
+    }
+    uint32_t header_size = header.size();
+    butil::IOBuf message;
+    message.append(&header_size, sizeof(header_size));
+    message.append(header);
+    if (request->has_block()) {
+        // the column values follow the request as raw bytes, like the attachment of the rpc
+        message.append(_column_values_buffer);
+    }
 
-        if (result.has_execution_time_us()) {
-            _add_batch_counter.add_batch_execution_time_us += result.execution_time_us();
-            _add_batch_counter.add_batch_wait_execution_time_us += result.wait_execution_time_us();
-            _add_batch_counter.add_batch_num++;
+    timespec deadline = butil::milliseconds_from_now(timeout_ms);
+    int ret = 0;
+    while ((ret = brpc::StreamWrite(_stream_id, message)) == EAGAIN) {
+        // too many packets in flight, wait for the receiver to consume them
+        if ((ret = brpc::StreamWait(_stream_id, &deadline)) != 0) {
+            break;
         }
-    });
-    return status;
+    }
+    if (ret != 0) {
+        return Status::InternalError(
+                fmt::format("failed to write the tablet writer stream, error code: {}", ret));
+    }
+    return Status::OK();
+}
+
+void VNodeChannel::_on_stream_result(const PTabletWriterAddBlockResult& result) {
+    bool is_last_rpc = _next_result_seq++ == _stream_eos_seq;
+    _on_add_block_result(result, is_last_rpc);
+    if (is_last_rpc) {
+        brpc::StreamClose(_stream_id);
+    }
+}
+
+void VNodeChannel::_on_stream_closed() {
+    int64_t eos_seq = _stream_eos_seq;
+    if (eos_seq >= 0 && _next_result_seq > eos_seq) {
+        // the results of all the packets are received
+        return;
+    }
+    // the channel is finished if the eos is sent, otherwise the blocks left fail to be written to
+    // the stream and cancel the channel
+    _on_add_block_failed(fmt::format("the tablet writer stream to {} is closed", host()),
+                         eos_seq >= 0);
 }
 
 Status VNodeChannel::add_row(const BlockRow& block_row, int64_t tablet_id) {
+    RETURN_IF_ERROR(_check_before_add());
+    _cur_mutable_block->add_row(block_row.first, block_row.second);
+    _cur_add_block_request.add_tablet_ids(tablet_id);
+    _pend_cur_block_if_full();
+    return Status::OK();
+}
+
+Status VNodeChannel::add_rows(const vectorized::Block* block, const std::vector<int>& rows,
+                              const std::vector<int64_t>& tablet_ids) {
+    RETURN_IF_ERROR(_check_before_add());
+    size_t pos = 0;
+    while (pos < rows.size()) {
+        size_t num_rows = std::min<size_t>(rows.size() - pos,
+                                           _batch_size - _cur_mutable_block->rows());
+        _cur_mutable_block->add_rows(block, rows.data() + pos, rows.data() + pos + num_rows);
+        for (size_t i = pos; i < pos + num_rows; ++i) {
+            _cur_add_block_request.add_tablet_ids(tablet_ids[i]);
+        }
+        pos += num_rows;
+        _pend_cur_block_if_full();
+    }
+    return Status::OK();
+}
+
+Status VNodeChannel::_check_before_add() {
     // If add_row() when _eos_is_produced==true, there must be sth wrong, we can only mark this channel as failed.
     auto st = none_of({_cancelled, _eos_is_produced});
     if (!st.ok()) {
@@ -156,10 +322,10 @@ Status VNodeChannel::add_row(const BlockRow& block_row, int64_t tablet_id) {
         SCOPED_ATOMIC_TIMER(&_mem_exceeded_block_ns);
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
+    return Status::OK();
+}
 
-    _cur_mutable_block->add_row(block_row.first, block_row.second);
-    _cur_add_block_request.add_tablet_ids(tablet_id);
-
+void VNodeChannel::_pend_cur_block_if_full() {
     if (_cur_mutable_block->rows() == _batch_size) {
         {
             SCOPED_ATOMIC_TIMER(&_queue_push_lock_ns);
@@ -172,8 +338,6 @@ Status VNodeChannel::add_row(const BlockRow& block_row, int64_t tablet_id) {
         _cur_mutable_block.reset(new vectorized::MutableBlock({_tuple_desc}));
         _cur_add_block_request.clear_tablet_ids();
     }
-
-    return Status::OK();
 }
 
 int VNodeChannel::try_send_and_fetch_status(RuntimeState* state,
@@ -265,10 +429,23 @@ void VNodeChannel::try_send_block(RuntimeState* state) {
 
         // eos request must be the last request
         _add_block_closure->end_mark();
+        _stream_eos_seq = _next_packet_seq;
         _send_finished = true;
         CHECK(_pending_batches_num == 0) << _pending_batches_num;
     }
 
+    if (_stream_id != brpc::INVALID_STREAM_ID) {
+        // the stream keeps several packets in flight, so the next block can be sent once this
+        // one is written to the stream
+        Status st = _write_stream(&request, remain_ms);
+        _next_packet_seq++;
+        if (!st.ok()) {
+            cancel(fmt::format("{}, err: {}", channel_info(), st.get_error_msg()));
+        }
+        _add_block_closure->clear_in_flight();
+        return;
+    }
+
     if (request.has_block()) {
         request_block_transfer_attachment<PTabletWriterAddBlockRequest,
                                           ReusableClosure<PTabletWriterAddBlockResult>>(
@@ -391,21 +568,32 @@ Status VOlapTableSink::send(RuntimeState* state, vectorized::Block* input_block)
         }
     }
 
-    BlockRow block_row;
     SCOPED_RAW_TIMER(&_send_data_ns);
     // This is just for passing compilation.
     bool stop_processing = false;
     if (findTabletMode == FindTabletMode::FIND_TABLET_EVERY_BATCH) {
         _partition_to_tablet_map.clear();
     }
+    // route the whole block first, then add the rows of each index at once
+    std::vector<const VOlapTablePartition*> partitions;
+    _vpartition->find_partitions(&block, &partitions);
+    std::vector<uint32_t> tablet_indexes;
+    if (findTabletMode == FindTabletMode::FIND_TABLET_EVERY_ROW) {
+        _vpartition->find_tablets(&block, partitions, &tablet_indexes);
+    }
+    std::vector<int> rows;
+    std::vector<std::vector<int64_t>> tablet_ids(_channels.size());
+    rows.reserve(num_rows);
+    for (auto& index_tablet_ids : tablet_ids) {
+        index_tablet_ids.reserve(num_rows);
+    }
     for (int i = 0; i < num_rows; ++i) {
         if (filtered_rows > 0 && _filter_bitmap.Get(i)) {
             continue;
         }
-        const VOlapTablePartition* partition = nullptr;
+        const VOlapTablePartition* partition = partitions[i];
         uint32_t tablet_index = 0;
-        block_row = {&block, i};
-        if (!_vpartition->find_partition(&block_row, &partition)) {
+        if (partition == nullptr) {
             RETURN_IF_ERROR(state->append_error_msg_to_file(
                     []() -> std::string { return ""; },
                     [&]() -> std::string {
@@ -423,20 +611,24 @@ Status VOlapTableSink::send(RuntimeState* state, vectorized::Block* input_block)
         _partition_ids.emplace(partition->id);
         if (findTabletMode != FindTabletMode::FIND_TABLET_EVERY_ROW) {
             if (_partition_to_tablet_map.find(partition->id) == _partition_to_tablet_map.end()) {
+                BlockRow block_row {&block, i};
                 tablet_index = _vpartition->find_tablet(&block_row, *partition);
                 _partition_to_tablet_map.emplace(partition->id, tablet_index);
             } else {
                 tablet_index = _partition_to_tablet_map[partition->id];
             }
         } else {
-            tablet_index = _vpartition->find_tablet(&block_row, *partition);
+            tablet_index = tablet_indexes[i];
         }
+        rows.push_back(i);
         for (int j = 0; j < partition->indexes.size(); ++j) {
-            int64_t tablet_id = partition->indexes[j].tablets[tablet_index];
-            _channels[j]->add_row(block_row, tablet_id);
-            _number_output_rows++;
+            tablet_ids[j].push_back(partition->indexes[j].tablets[tablet_index]);
         }
     }
+    for (int j = 0; j < _channels.size(); ++j) {
+        _channels[j]->add_rows(&block, rows, tablet_ids[j]);
+        _number_output_rows += rows.size();
+    }
 
     // check intolerable failure
     for (const auto& index_channel : _channels) {
@@ -40,6 +40,9 @@ public:
 
     Status add_row(const BlockRow& block_row, int64_t tablet_id) override;
 
+    Status add_rows(const vectorized::Block* block, const std::vector<int>& rows,
+                    const std::vector<int64_t>& tablet_ids) override;
+
     int try_send_and_fetch_status(RuntimeState* state,
                                   std::unique_ptr<ThreadPoolToken>& thread_pool_token) override;
 
@@ -56,6 +59,25 @@ protected:
     void _close_check() override;
 
 private:
+    class StreamResultHandler;
+
+    // Check if the rows can be added, and wait if the memory exceeds limit.
+    Status _check_before_add();
+    // Move the current block into the pending blocks if it's full.
+    void _pend_cur_block_if_full();
+
+    void _on_add_block_failed(const std::string& error_text, bool is_last_rpc);
+    void _on_add_block_result(const PTabletWriterAddBlockResult& result, bool is_last_rpc);
+
+    // Open the stream to send the blocks if enable_tablet_writer_stream is set, the blocks are
+    // sent by the add_block rpcs if the stream can't be opened.
+    void _open_stream();
+    // Write the request and the serialized block in _column_values_buffer to the stream, it waits
+    // if the packets in flight are over tablet_writer_stream_max_buf_bytes.
+    Status _write_stream(PTabletWriterAddBlockRequest* request, int64_t timeout_ms);
+    void _on_stream_result(const PTabletWriterAddBlockResult& result);
+    void _on_stream_closed();
+
     std::unique_ptr<vectorized::MutableBlock> _cur_mutable_block;
     PTabletWriterAddBlockRequest _cur_add_block_request;
 
@@ -68,6 +90,13 @@ private:
     // The data in the buffer is copied to the attachment of the brpc when it is sent,
     // to avoid an extra pb serialization in the brpc.
     std::string _column_values_buffer;
+
+    brpc::StreamId _stream_id = brpc::INVALID_STREAM_ID;
+    std::shared_ptr<StreamResultHandler> _stream_handler;
+    // the results of the stream are in the order of the packets
+    int64_t _next_result_seq = 0;
+    // the packet seq of the eos request, -1 before it's sent
+    std::atomic<int64_t> _stream_eos_seq {-1};
 };
 
 class OlapTableSink;
@@ -0,0 +1,147 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "agent/task_worker_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include "common/config.h"
+#include "gen_cpp/HeartbeatService_types.h"
+#include "util/threadpool.h"
+
+namespace doris {
+
+// The create and drop tablet workers take the queued tasks in batches, and run a batch by the
+// batch thread pool.
+class TaskWorkerPoolTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _batch_size = config::tablet_task_batch_size;
+        _pool.reset(new TaskWorkerPool(TaskWorkerPool::TaskWorkerType::CREATE_TABLE, nullptr,
+                                       TMasterInfo(), TaskWorkerPool::ThreadModel::MULTI_THREADS));
+        // the workers aren't started, the test runs them
+        EXPECT_TRUE(ThreadPoolBuilder("TaskWorkerPoolTest").build(&_pool->_thread_pool).ok());
+        EXPECT_TRUE(ThreadPoolBuilder("TaskWorkerPoolTest_BATCH")
+                            .set_min_threads(1)
+                            .set_max_threads(4)
+                            .build(&_pool->_batch_thread_pool)
+                            .ok());
+        _pool->_is_work = true;
+    }
+
+    void TearDown() override {
+        _pool.reset();
+        config::tablet_task_batch_size = _batch_size;
+    }
+
+    static std::vector<TAgentTaskRequest> tasks(int num_tasks) {
+        std::vector<TAgentTaskRequest> result(num_tasks);
+        for (int i = 0; i < num_tasks; ++i) {
+            result[i].signature = i;
+        }
+        return result;
+    }
+
+    static std::vector<int64_t> signatures(const std::vector<TAgentTaskRequest>& batch) {
+        std::vector<int64_t> result;
+        for (const auto& task : batch) {
+            result.push_back(task.signature);
+        }
+        return result;
+    }
+
+    std::unique_ptr<TaskWorkerPool> _pool;
+    int32_t _batch_size;
+};
+
+TEST_F(TaskWorkerPoolTest, pop_task_batch) {
+    config::tablet_task_batch_size = 4;
+    for (auto& task : tasks(10)) {
+        _pool->_tasks.push_back(task);
+    }
+    // the batches are taken in the order of the queue
+    std::vector<std::vector<int64_t>> expected = {{0, 1, 2, 3}, {4, 5, 6, 7}, {8, 9}};
+    for (const auto& expected_signatures : expected) {
+        std::vector<TAgentTaskRequest> batch;
+        EXPECT_TRUE(_pool->_pop_task_batch(&batch));
+        EXPECT_EQ(expected_signatures, signatures(batch));
+    }
+    EXPECT_TRUE(_pool->_tasks.empty());
+
+    // a batch size of 0 takes a task at a time
+    config::tablet_task_batch_size = 0;
+    for (auto& task : tasks(2)) {
+        _pool->_tasks.push_back(task);
+    }
+    std::vector<TAgentTaskRequest> batch;
+    EXPECT_TRUE(_pool->_pop_task_batch(&batch));
+    EXPECT_EQ(std::vector<int64_t>({0}), signatures(batch));
+
+    // and no batch is taken once the pool is stopped
+    _pool->stop();
+    batch.clear();
+    EXPECT_FALSE(_pool->_pop_task_batch(&batch));
+    EXPECT_TRUE(batch.empty());
+}
+
+TEST_F(TaskWorkerPoolTest, run_task_batch) {
+    std::atomic<int> inflight {0};
+    std::atomic<int> max_inflight {0};
+    std::mutex lock;
+    std::vector<int64_t> finished;
+    std::vector<std::thread::id> threads;
+    auto run_task = [&](const TAgentTaskRequest& task) {
+        int n = ++inflight;
+        int max = max_inflight;
+        while (n > max && !max_inflight.compare_exchange_weak(max, n)) {
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        --inflight;
+        std::lock_guard<std::mutex> l(lock);
+        finished.push_back(task.signature);
+        threads.push_back(std::this_thread::get_id());
+    };
+
+    // the tasks of a batch run in parallel, and the batch is waited for
+    _pool->_run_task_batch(tasks(8), run_task);
+    EXPECT_EQ(8, finished.size());
+    EXPECT_GT(max_inflight, 1);
+    EXPECT_LE(max_inflight, 4);
+
+    // a single task runs in the worker thread
+    threads.clear();
+    _pool->_run_task_batch(tasks(1), run_task);
+    ASSERT_EQ(1, threads.size());
+    EXPECT_EQ(std::this_thread::get_id(), threads[0]);
+
+    // so do the tasks without the batch thread pool, one by one
+    finished.clear();
+    threads.clear();
+    _pool->_batch_thread_pool.reset();
+    _pool->_run_task_batch(tasks(3), run_task);
+    EXPECT_EQ(std::vector<int64_t>({0, 1, 2}), finished);
+    for (auto thread : threads) {
+        EXPECT_EQ(std::this_thread::get_id(), thread);
+    }
+}
+
+} // namespace doris
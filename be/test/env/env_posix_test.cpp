@@ -18,7 +18,10 @@
 #include <gtest/gtest.h>
 
 #include <algorithm>
+#include <string>
+#include <vector>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "env/env.h"
 #include "util/file_utils.h"
@@ -112,6 +115,93 @@ TEST_F(EnvPosixTest, random_access) {
     }
 }
 
+TEST_F(EnvPosixTest, read_batch) {
+    std::string fname = "./ut_dir/env_posix/read_batch";
+    auto env = Env::Default();
+    std::string content;
+    for (int i = 0; i < 100000; ++i) {
+        content.push_back((char)(i * 7));
+    }
+    {
+        std::unique_ptr<WritableFile> wfile;
+        EXPECT_TRUE(env->new_writable_file(fname, &wfile).ok());
+        EXPECT_TRUE(wfile->append(content).ok());
+        EXPECT_TRUE(wfile->close().ok());
+    }
+
+    std::unique_ptr<RandomAccessFile> rfile;
+    EXPECT_TRUE(env->new_random_access_file(fname, &rfile).ok());
+    for (bool io_uring : {false, true}) {
+        config::enable_io_uring_read = io_uring;
+        // more ranges than the queue depth, in random order
+        const int num_reqs = 200;
+        std::vector<std::string> bufs(num_reqs);
+        std::vector<ReadRequest> reqs(num_reqs);
+        for (int i = 0; i < num_reqs; ++i) {
+            uint64_t offset = (i * 7919) % (content.size() - 1000);
+            bufs[i].resize(1 + i * 3);
+            reqs[i].offset = offset;
+            reqs[i].result = Slice(bufs[i].data(), bufs[i].size());
+        }
+        EXPECT_TRUE(rfile->read_batch_at(reqs.data(), num_reqs).ok());
+        for (int i = 0; i < num_reqs; ++i) {
+            EXPECT_EQ(content.substr(reqs[i].offset, bufs[i].size()), bufs[i]) << i;
+        }
+
+        // end of file
+        char mem[15];
+        ReadRequest eof_reqs[2];
+        eof_reqs[0] = {0, Slice(mem, 5)};
+        eof_reqs[1] = {content.size() - 5, Slice(mem + 5, 10)};
+        Status st = rfile->read_batch_at(eof_reqs, 2);
+        EXPECT_EQ(TStatusCode::END_OF_FILE, st.code());
+    }
+    config::enable_io_uring_read = false;
+}
+
+TEST_F(EnvPosixTest, direct_io_read) {
+    std::string fname = "./ut_dir/env_posix/direct_io_read";
+    auto env = Env::Default();
+    std::string content;
+    for (int i = 0; i < 10000; ++i) {
+        content.push_back((char)(i * 13));
+    }
+    {
+        std::unique_ptr<WritableFile> wfile;
+        EXPECT_TRUE(env->new_writable_file(fname, &wfile).ok());
+        EXPECT_TRUE(wfile->append(content).ok());
+        EXPECT_TRUE(wfile->close().ok());
+    }
+
+    RandomAccessFileOptions opts;
+    opts.use_direct_io = true;
+    std::unique_ptr<RandomAccessFile> rfile;
+    EXPECT_TRUE(env->new_random_access_file(opts, fname, &rfile).ok());
+
+    // unaligned offsets and sizes, across the aligned blocks and up to the end of file
+    for (uint64_t offset : {0, 1, 4095, 4096, 5000, 9000}) {
+        std::string buf1(100, 0);
+        std::string buf2(content.size() - offset - 100, 0);
+        Slice slices[2] {Slice(buf1.data(), buf1.size()), Slice(buf2.data(), buf2.size())};
+        EXPECT_TRUE(rfile->readv_at(offset, slices, 2).ok());
+        EXPECT_EQ(content.substr(offset), buf1 + buf2);
+    }
+
+    ReadRequest reqs[2];
+    std::string buf1(10, 0);
+    std::string buf2(3000, 0);
+    reqs[0] = {7000, Slice(buf1.data(), buf1.size())};
+    reqs[1] = {123, Slice(buf2.data(), buf2.size())};
+    EXPECT_TRUE(rfile->read_batch_at(reqs, 2).ok());
+    EXPECT_EQ(content.substr(7000, 10), buf1);
+    EXPECT_EQ(content.substr(123, 3000), buf2);
+
+    // end of file
+    Slice slice(buf2.data(), 100);
+    Status st = rfile->read_at(content.size() - 99, &slice);
+    EXPECT_EQ(TStatusCode::END_OF_FILE, st.code());
+}
+
 TEST_F(EnvPosixTest, random_rw) {
     std::string fname = "./ut_dir/env_posix/random_rw";
     std::unique_ptr<RandomRWFile> wfile;
@@ -21,6 +21,7 @@
 
 #include "exec/local_file_reader.h"
 #include "util/stopwatch.hpp"
+#include "util/threadpool.h"
 
 namespace doris {
 class BufferedReaderTest : public testing::Test {
@@ -179,4 +180,50 @@ TEST_F(BufferedReaderTest, test_miss) {
     EXPECT_EQ(45, bytes_read);
 }
 
+TEST_F(BufferedReaderTest, test_prefetch) {
+    std::unique_ptr<ThreadPool> pool;
+    ThreadPoolBuilder("BufferedReaderTest").set_max_threads(2).build(&pool);
+    // buffered_reader_test_file 950 bytes
+    LocalFileReader expected_reader(
+            "./be/test/exec/test_data/buffered_reader/buffered_reader_test_file", 0);
+    EXPECT_TRUE(expected_reader.open().ok());
+    uint8_t expected[1024];
+    int64_t expected_length = 0;
+    EXPECT_TRUE(expected_reader.readat(0, 1024, &expected_length, expected).ok());
+    EXPECT_EQ(950, expected_length);
+
+    RuntimeProfile profile("test");
+    auto file_reader = new LocalFileReader(
+            "./be/test/exec/test_data/buffered_reader/buffered_reader_test_file", 0);
+    BufferedReader reader(&profile, file_reader, 64, pool.get());
+    EXPECT_TRUE(reader.open().ok());
+    uint8_t buf[1024];
+    int64_t offset = 0;
+    // the reads after the first one are filled by the prefetched buffers
+    while (true) {
+        int64_t bytes_read = 0;
+        EXPECT_TRUE(reader.readat(offset, 10, &bytes_read, buf + offset).ok());
+        if (bytes_read == 0) {
+            break;
+        }
+        offset += bytes_read;
+    }
+    EXPECT_EQ(950, offset);
+    EXPECT_EQ(0, memcmp(expected, buf, 950));
+
+    // skip some bytes, which are read together with the next buffer
+    int64_t bytes_read = 0;
+    EXPECT_TRUE(reader.readat(100, 10, &bytes_read, buf).ok());
+    EXPECT_TRUE(reader.readat(180, 10, &bytes_read, buf).ok());
+    EXPECT_EQ(10, bytes_read);
+    EXPECT_EQ(0, memcmp(expected + 180, buf, 10));
+    // a random read
+    EXPECT_TRUE(reader.readat(20, 80, &bytes_read, buf).ok());
+    EXPECT_EQ(80, bytes_read);
+    EXPECT_EQ(0, memcmp(expected + 20, buf, 80));
+
+    reader.close();
+    EXPECT_GT(profile.get_counter("FilePrefetchHits")->value(), 0);
+}
+
 } // end namespace doris
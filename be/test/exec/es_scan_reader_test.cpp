@@ -244,4 +244,29 @@ TEST_F(MockESServerTest, workflow) {
     auto cst = reader.close();
     EXPECT_TRUE(cst.ok());
 }
+
+TEST(ESScrollQueryBuilderTest, sliced_scroll) {
+    std::vector<std::string> fields = {"id", "value"};
+    std::map<std::string, std::string> props;
+    props[ESScanReader::KEY_BATCH_SIZE] = "1024";
+    props[ESScanReader::KEY_SLICE_ID] = "1";
+    props[ESScanReader::KEY_SLICE_MAX] = "4";
+    std::vector<EsPredicate*> predicates;
+    std::map<std::string, std::string> docvalue_context;
+    bool doc_value_mode = false;
+    rapidjson::Document query;
+    query.Parse(ESScrollQueryBuilder::build(props, fields, predicates, docvalue_context,
+                                            &doc_value_mode)
+                        .c_str());
+    ASSERT_TRUE(query.HasMember("slice"));
+    EXPECT_EQ(1, query["slice"]["id"].GetInt());
+    EXPECT_EQ(4, query["slice"]["max"].GetInt());
+
+    // the limit is pushed down without slice
+    props[ESScanReader::KEY_TERMINATE_AFTER] = "10";
+    query.Parse(ESScrollQueryBuilder::build(props, fields, predicates, docvalue_context,
+                                            &doc_value_mode)
+                        .c_str());
+    EXPECT_FALSE(query.HasMember("slice"));
+}
 } // namespace doris
@@ -219,6 +219,102 @@ TEST_F(OlapTablePartitionParamTest, normal) {
     }
 }
 
+TEST_F(OlapTablePartitionParamTest, vectorized_find_partitions) {
+    TDescriptorTable t_desc_tbl;
+    auto t_schema = get_schema(&t_desc_tbl);
+    std::shared_ptr<OlapTableSchemaParam> schema(new OlapTableSchemaParam());
+    auto st = schema->init(t_schema);
+    EXPECT_TRUE(st.ok());
+
+    auto int_key = [&](int64_t value) {
+        TExprNode key;
+        key.node_type = TExprNodeType::INT_LITERAL;
+        key.type = t_desc_tbl.slotDescriptors[1].slotType;
+        key.num_children = 0;
+        key.__isset.int_literal = true;
+        key.int_literal.value = value;
+        return key;
+    };
+    // (-oo, 10) | [10, 50) | [60, +oo)
+    TOlapTablePartitionParam t_partition_param;
+    t_partition_param.db_id = 1;
+    t_partition_param.table_id = 2;
+    t_partition_param.version = 0;
+    t_partition_param.__set_partition_columns({"c2"});
+    t_partition_param.__set_distributed_columns({"c1", "c3"});
+    t_partition_param.partitions.resize(3);
+    std::vector<std::pair<int64_t, int64_t>> ranges = {{-1, 10}, {10, 50}, {60, -1}};
+    for (int i = 0; i < 3; ++i) {
+        auto& partition = t_partition_param.partitions[i];
+        partition.id = 10 + i;
+        if (ranges[i].first != -1) {
+            partition.__set_start_keys({int_key(ranges[i].first)});
+        }
+        if (ranges[i].second != -1) {
+            partition.__set_end_keys({int_key(ranges[i].second)});
+        }
+        partition.num_buckets = 1 << i;
+        partition.indexes.resize(2);
+        partition.indexes[0].index_id = 4;
+        partition.indexes[1].index_id = 5;
+        for (int j = 0; j < partition.num_buckets; ++j) {
+            partition.indexes[0].tablets.push_back(100 * i + j);
+            partition.indexes[1].tablets.push_back(100 * i + 50 + j);
+        }
+    }
+
+    VOlapTablePartitionParam part(schema, t_partition_param);
+    st = part.init();
+    EXPECT_TRUE(st.ok());
+
+    ObjectPool pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    st = DescriptorTbl::create(&pool, t_desc_tbl, &desc_tbl);
+    EXPECT_TRUE(st.ok());
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    std::vector<int32_t> c1 = {12, 13, 14, 15, 16, 17, 18, 19};
+    std::vector<int64_t> c2 = {9, 25, 50, 60, 30, 5, 70, 61};
+    std::vector<std::string> c3 = {"abc", "abcd", "abcde", "abcdef", "a", "", "xyz", "abc"};
+    vectorized::Block block;
+    for (int i = 0; i < tuple_desc->slots().size(); ++i) {
+        auto slot = tuple_desc->slots()[i];
+        auto column = slot->get_empty_mutable_column();
+        for (int row = 0; row < c1.size(); ++row) {
+            if (i == 0) {
+                column->insert_data(reinterpret_cast<const char*>(&c1[row]), 0);
+            } else if (i == 1) {
+                column->insert_data(reinterpret_cast<const char*>(&c2[row]), 0);
+            } else {
+                column->insert_data(c3[row].data(), c3[row].size());
+            }
+        }
+        block.insert({std::move(column), slot->get_data_type_ptr(), slot->col_name()});
+    }
+
+    std::vector<const VOlapTablePartition*> partitions;
+    part.find_partitions(&block, &partitions);
+    std::vector<uint32_t> tablet_indexes;
+    part.find_tablets(&block, partitions, &tablet_indexes);
+    ASSERT_EQ(c1.size(), partitions.size());
+    ASSERT_EQ(c1.size(), tablet_indexes.size());
+    std::vector<int64_t> expected_ids = {10, 11, -1, 12, 11, 10, 12, 12};
+    for (int row = 0; row < c1.size(); ++row) {
+        BlockRow block_row {&block, row};
+        const VOlapTablePartition* partition = nullptr;
+        bool found = part.find_partition(&block_row, &partition);
+        if (expected_ids[row] == -1) {
+            EXPECT_FALSE(found);
+            EXPECT_EQ(nullptr, partitions[row]);
+            continue;
+        }
+        EXPECT_TRUE(found);
+        EXPECT_EQ(partition, partitions[row]);
+        EXPECT_EQ(expected_ids[row], partitions[row]->id);
+        // the same tablets as the rows are routed one by one
+        EXPECT_EQ(part.find_tablet(&block_row, *partition), tablet_indexes[row]);
+    }
+}
+
 /*
  *PARTITION BY LIST(`k1`)
  * (
@@ -19,11 +19,14 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
 #include <string>
 
 #include "common/configbase.h"
 #include "exprs/create_predicate_function.h"
 #include "util/logging.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
 
 namespace doris {
 
@@ -376,4 +379,48 @@ TEST_F(HybridSetTest, timestamp) {
     EXPECT_FALSE(set->find(&v23));
 }
 
+TEST_F(HybridSetTest, find_batch) {
+    auto column = vectorized::ColumnInt32::create();
+    for (int32_t i = 0; i < 100; ++i) {
+        column->insert_value(i);
+    }
+    uint8_t null_map[100] = {0};
+    null_map[7] = 1;
+    uint8_t results[100];
+
+    // a small set probed by the linear compare, and a large one probed by hashing
+    for (int32_t step : {10, 2}) {
+        std::unique_ptr<HybridSetBase> set(create_set(TYPE_INT));
+        for (int32_t i = 0; i < 100; i += step) {
+            set->insert(&i);
+        }
+        set->find_batch(*column, null_map, results);
+        for (int32_t i = 0; i < 100; ++i) {
+            if (i != 7) {
+                EXPECT_EQ(results[i], i % step == 0) << i;
+            }
+        }
+    }
+
+    std::unique_ptr<HybridSetBase> empty_set(create_set(TYPE_INT));
+    empty_set->find_batch(*column, nullptr, results);
+    for (int32_t i = 0; i < 100; ++i) {
+        EXPECT_FALSE(results[i]);
+    }
+
+    auto str_column = vectorized::ColumnString::create();
+    std::unique_ptr<HybridSetBase> str_set(create_set(TYPE_VARCHAR));
+    for (int32_t i = 0; i < 100; ++i) {
+        std::string value = std::to_string(i);
+        str_column->insert_data(value.data(), value.size());
+        if (i % 3 == 0) {
+            str_set->insert(value.data(), value.size());
+        }
+    }
+    str_set->find_batch(*str_column, nullptr, results);
+    for (int32_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(results[i], i % 3 == 0) << i;
+    }
+}
+
 } // namespace doris
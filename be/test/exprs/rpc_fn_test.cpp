@@ -0,0 +1,184 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "exprs/rpc_fn.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+
+#include "common/config.h"
+#include "runtime/exec_env.h"
+#include "service/brpc.h"
+#include "util/brpc_client_cache.h"
+#include "util/debug/leakcheck_disabler.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+static const int k_port = 4366;
+
+// a + b of the INT arguments, with a call failed if its first a is `k_failed_value`
+class TestFunctionService : public PFunctionService {
+public:
+    static constexpr int32_t k_failed_value = -1;
+
+    void fn_call(google::protobuf::RpcController* controller,
+                 const PFunctionCallRequest* request, PFunctionCallResponse* response,
+                 google::protobuf::Closure* done) override {
+        brpc::ClosureGuard done_guard(done);
+        int inflight = ++_inflight;
+        ++_num_calls;
+        int max_inflight = _max_inflight;
+        while (inflight > max_inflight &&
+               !_max_inflight.compare_exchange_weak(max_inflight, inflight)) {
+        }
+        // so that the calls in flight overlap
+        bthread_usleep(20 * 1000);
+
+        const auto& a = request->args(0);
+        const auto& b = request->args(1);
+        bool failed = a.int32_value_size() > 0 && a.int32_value(0) == k_failed_value;
+        response->mutable_status()->set_status_code(failed ? 1 : 0);
+        PValues* result = response->add_result();
+        result->mutable_type()->set_id(PGenericType::INT32);
+        for (int i = 0; i < a.int32_value_size(); ++i) {
+            result->add_int32_value(a.int32_value(i) + b.int32_value(i));
+        }
+        --_inflight;
+    }
+
+    std::atomic<int> _inflight {0};
+    std::atomic<int> _max_inflight {0};
+    std::atomic<int> _num_calls {0};
+};
+
+class RPCFnTest : public testing::Test {
+protected:
+    void SetUp() override {
+        config::function_service_protocol = "baidu_std";
+        _env = ExecEnv::GetInstance();
+        _env->_function_client_cache = new BrpcClientCache<PFunctionService_Stub>();
+
+        _server = new brpc::Server();
+        _service = new TestFunctionService();
+        EXPECT_EQ(_server->AddService(_service, brpc::SERVER_OWNS_SERVICE), 0);
+        brpc::ServerOptions options;
+        {
+            debug::ScopedLeakCheckDisabler disable_lsan;
+            _server->Start(k_port, &options);
+        }
+
+        _fn.name.function_name = "add";
+        _fn.hdfs_location = "127.0.0.1:" + std::to_string(k_port);
+        _fn.scalar_fn.symbol = "add";
+    }
+
+    void TearDown() override {
+        config::function_service_protocol = _protocol;
+        config::function_service_batch_rows = _batch_rows;
+        config::function_service_max_inflight_calls = _max_inflight_calls;
+        SAFE_DELETE(_env->_function_client_cache);
+        _server->Stop(100);
+        _server->Join();
+        SAFE_DELETE(_server);
+    }
+
+    // calls the function on the rows of a = i and b = i * 10, the first a of the rows in
+    // `failed_rows` is k_failed_value, and returns the results
+    Status call(size_t rows, std::vector<int32_t>* results, size_t failed_rows = SIZE_MAX) {
+        auto a = vectorized::ColumnInt32::create();
+        auto b = vectorized::ColumnInt32::create();
+        for (size_t i = 0; i < rows; ++i) {
+            int32_t value = static_cast<int32_t>(i);
+            a->insert_value(i == failed_rows ? TestFunctionService::k_failed_value : value);
+            b->insert_value(value * 10);
+        }
+        auto type = std::make_shared<vectorized::DataTypeInt32>();
+        vectorized::Block block({vectorized::ColumnWithTypeAndName(std::move(a), type, "a"),
+                                 vectorized::ColumnWithTypeAndName(std::move(b), type, "b"),
+                                 vectorized::ColumnWithTypeAndName(nullptr, type, "result")});
+        RPCFn fn(_fn, false);
+        EXPECT_TRUE(fn.avliable());
+        RETURN_IF_ERROR(fn.vec_call(nullptr, block, {0, 1}, 2, rows));
+        const auto& result = assert_cast<const vectorized::ColumnInt32&>(
+                *block.get_by_position(2).column);
+        results->assign(result.get_data().begin(), result.get_data().end());
+        return Status::OK();
+    }
+
+    static std::vector<int32_t> expected(size_t rows) {
+        std::vector<int32_t> results;
+        for (size_t i = 0; i < rows; ++i) {
+            results.push_back(i * 11);
+        }
+        return results;
+    }
+
+    ExecEnv* _env = nullptr;
+    brpc::Server* _server = nullptr;
+    TestFunctionService* _service = nullptr;
+    TFunction _fn;
+    std::string _protocol = config::function_service_protocol;
+    int32_t _batch_rows = config::function_service_batch_rows;
+    int32_t _max_inflight_calls = config::function_service_max_inflight_calls;
+};
+
+TEST_F(RPCFnTest, sub_batches) {
+    config::function_service_batch_rows = 100;
+    config::function_service_max_inflight_calls = 3;
+    std::vector<int32_t> results;
+    Status st = call(1050, &results);
+    ASSERT_TRUE(st.ok()) << st.to_string();
+    // the results of the 11 calls are appended in order
+    EXPECT_EQ(expected(1050), results);
+    EXPECT_EQ(11, _service->_num_calls);
+    EXPECT_GT(_service->_max_inflight, 1);
+    EXPECT_LE(_service->_max_inflight, 3);
+}
+
+TEST_F(RPCFnTest, one_call) {
+    // a block not larger than a sub-batch is sent in one call
+    config::function_service_batch_rows = 100;
+    std::vector<int32_t> results;
+    EXPECT_TRUE(call(100, &results).ok());
+    EXPECT_EQ(expected(100), results);
+    EXPECT_EQ(1, _service->_num_calls);
+
+    // and so is any block without sub-batches
+    config::function_service_batch_rows = 0;
+    EXPECT_TRUE(call(1050, &results).ok());
+    EXPECT_EQ(expected(1050), results);
+    EXPECT_EQ(2, _service->_num_calls);
+}
+
+TEST_F(RPCFnTest, failed_sub_batch) {
+    config::function_service_batch_rows = 100;
+    config::function_service_max_inflight_calls = 4;
+    std::vector<int32_t> results;
+    // the calls after the failed one are not sent, those in flight are waited for
+    EXPECT_FALSE(call(1050, &results, 200).ok());
+    EXPECT_EQ(0, _service->_inflight);
+    EXPECT_LE(_service->_num_calls, 6);
+    EXPECT_TRUE(results.empty());
+}
+
+} // namespace doris
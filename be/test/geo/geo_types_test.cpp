@@ -129,6 +129,30 @@ TEST_F(GeoTypesTest, polygon_contains) {
     }
 }
 
+TEST_F(GeoTypesTest, polygon_contains_by_covering) {
+    const char* wkt = "POLYGON ((10 10, 50 10, 50 50, 10 50, 10 10), (20 20, 30 20, 30 30, 20 30, "
+                      "20 20))";
+    GeoParseStatus status;
+    std::unique_ptr<GeoShape> exact(GeoShape::from_wkt(wkt, strlen(wkt), &status));
+    std::unique_ptr<GeoShape> covered(GeoShape::from_wkt(wkt, strlen(wkt), &status));
+    ASSERT_NE(nullptr, exact.get());
+    ASSERT_NE(nullptr, covered.get());
+    static_cast<GeoPolygon*>(covered.get())->build_covering();
+
+    // the points around the boundaries and the hole get the same results as the exact test
+    int num_contained = 0;
+    for (double x = 0; x <= 60; x += 0.37) {
+        for (double y = 0; y <= 60; y += 0.41) {
+            GeoPoint point;
+            ASSERT_EQ(GEO_PARSE_OK, point.from_coord(x, y));
+            bool res = exact->contains(&point);
+            EXPECT_EQ(res, covered->contains(&point)) << x << ", " << y;
+            num_contained += res;
+        }
+    }
+    EXPECT_GT(num_contained, 0);
+}
+
 TEST_F(GeoTypesTest, polygon_parse_fail) {
     {
         const char* wkt = "POLYGON ((10 10, 50 10, 50 50, 10 50), (10 10 01))";
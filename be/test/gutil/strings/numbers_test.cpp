@@ -19,6 +19,9 @@
 
 #include <gtest/gtest.h>
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <limits>
 
 #include "util/mysql_global.h"
@@ -131,4 +134,39 @@ TEST_F(NumbersTest, test_double_to_buffer) {
     EXPECT_EQ(std::string("-1.7976931348623157e+308"), std::string(buffer2, len2));
 }
 
+TEST_F(NumbersTest, test_shortest_to_buffer) {
+    // the same as the output of "%.15g" if it round-trips, otherwise "%.17g"
+    auto expected_double = [](double value) {
+        char buffer[100];
+        snprintf(buffer, sizeof(buffer), "%.15g", value);
+        if (strtod(buffer, nullptr) != value) {
+            snprintf(buffer, sizeof(buffer), "%.17g", value);
+        }
+        return std::string(buffer);
+    };
+    auto expected_float = [](float value) {
+        char buffer[100];
+        snprintf(buffer, sizeof(buffer), "%.6g", value);
+        if (strtof(buffer, nullptr) != value) {
+            snprintf(buffer, sizeof(buffer), "%.8g", value);
+        }
+        return std::string(buffer);
+    };
+    char buffer[100];
+    for (double value : {0.1, 0.1 + 0.2, 0.7999999999999999, 1e15, 1e16, 123456789012345.0,
+                         1e-4, 1e-5, 0.000123, -99.5, 1e100, 5e-324, 2.5e-310}) {
+        int len = FastDoubleToBuffer(value, buffer);
+        EXPECT_EQ(expected_double(value), std::string(buffer, len));
+        len = FastFloatToBuffer(static_cast<float>(value), buffer);
+        EXPECT_EQ(expected_float(static_cast<float>(value)), std::string(buffer, len));
+    }
+    for (int i = -30; i <= 30; ++i) {
+        double value = 1.2345 * pow(10, i);
+        int len = FastDoubleToBuffer(value, buffer);
+        EXPECT_EQ(expected_double(value), std::string(buffer, len));
+        len = FastFloatToBuffer(static_cast<float>(value), buffer);
+        EXPECT_EQ(expected_float(static_cast<float>(value)), std::string(buffer, len));
+    }
+}
+
 } // namespace doris
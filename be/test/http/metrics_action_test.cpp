@@ -19,6 +19,7 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
 #include "http/http_channel.h"
 #include "http/http_request.h"
 #include "http/http_response.h"
@@ -94,4 +95,35 @@ TEST_F(MetricsActionTest, prometheus_no_prefix) {
     action.handle(&request);
 }
 
+TEST_F(MetricsActionTest, render_cache) {
+    MetricRegistry metric_registry("test");
+    std::shared_ptr<MetricEntity> entity =
+            metric_registry.register_entity("metrics_action_test.render_cache");
+
+    IntCounter* put_requests_total = nullptr;
+    DEFINE_COUNTER_METRIC_PROTOTYPE_2ARG(put_requests_total, MetricUnit::NOUNIT);
+    INT_COUNTER_METRIC_REGISTER(entity, put_requests_total);
+    put_requests_total->increment(1);
+
+    int32_t old_cache_ms = config::metrics_render_cache_ms;
+    config::metrics_render_cache_ms = 60 * 1000;
+    HttpRequest request(_evhttp_req);
+    MetricsAction action(&metric_registry);
+    s_expect_response =
+            "# TYPE test_put_requests_total counter\n"
+            "test_put_requests_total 1\n";
+    action.handle(&request);
+
+    // reuse the rendering of the last scrape
+    put_requests_total->increment(1);
+    action.handle(&request);
+
+    config::metrics_render_cache_ms = 0;
+    s_expect_response =
+            "# TYPE test_put_requests_total counter\n"
+            "test_put_requests_total 2\n";
+    action.handle(&request);
+    config::metrics_render_cache_ms = old_cache_ms;
+}
+
 } // namespace doris
@@ -0,0 +1,134 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "http/action/stream_load.h"
+
+#include <event2/buffer.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "runtime/stream_load/stream_load_pipe.h"
+
+namespace doris {
+
+// the sink keeping the buffers appended to it, which fails the append of the `fail_at`th one
+class ByteBufferSink : public MessageBodySink {
+public:
+    Status append(const char* data, size_t size) override {
+        return Status::InternalError("the body is copied");
+    }
+
+    Status append(const ByteBufferPtr& buf) override {
+        if (buffers.size() == fail_at) {
+            return Status::InternalError("failed to append");
+        }
+        buffers.push_back(buf);
+        return Status::OK();
+    }
+
+    std::vector<ByteBufferPtr> buffers;
+    size_t fail_at = std::numeric_limits<size_t>::max();
+};
+
+static void count_freed_segment(const void* data, size_t size, void* num_freed) {
+    ++*static_cast<int*>(num_freed);
+}
+
+// The chains of the received body are handed to the sink as they are, and are freed once the
+// sink releases the last of their segments.
+TEST(StreamLoadActionTest, append_body_without_copy) {
+    std::vector<std::string> segments = {"1,a\n", "2,b\n3,", "c\n"};
+    int num_freed = 0;
+    evbuffer* evbuf = evbuffer_new();
+    for (const auto& segment : segments) {
+        evbuffer_add_reference(evbuf, segment.data(), segment.size(), count_freed_segment,
+                               &num_freed);
+    }
+    ByteBufferSink sink;
+    size_t receive_bytes = 0;
+    ASSERT_TRUE(StreamLoadAction::_append_body(evbuf, &sink, &receive_bytes).ok());
+    EXPECT_EQ(0, evbuffer_get_length(evbuf));
+    EXPECT_EQ(12, receive_bytes);
+    ASSERT_EQ(segments.size(), sink.buffers.size());
+    for (size_t i = 0; i < segments.size(); ++i) {
+        EXPECT_EQ(segments[i].data(), sink.buffers[i]->ptr);
+        EXPECT_EQ(segments[i].size(), sink.buffers[i]->remaining());
+    }
+
+    // the chains are moved out of the input buffer
+    evbuffer_free(evbuf);
+    EXPECT_EQ(0, num_freed);
+    sink.buffers.pop_back();
+    EXPECT_EQ(0, num_freed);
+    sink.buffers.clear();
+    EXPECT_EQ(3, num_freed);
+}
+
+TEST(StreamLoadActionTest, append_body_failed) {
+    std::vector<std::string> segments = {"1,a\n", "2,b\n"};
+    int num_freed = 0;
+    evbuffer* evbuf = evbuffer_new();
+    for (const auto& segment : segments) {
+        evbuffer_add_reference(evbuf, segment.data(), segment.size(), count_freed_segment,
+                               &num_freed);
+    }
+    ByteBufferSink sink;
+    sink.fail_at = 1;
+    size_t receive_bytes = 0;
+    EXPECT_FALSE(StreamLoadAction::_append_body(evbuf, &sink, &receive_bytes).ok());
+    EXPECT_EQ(4, receive_bytes);
+    EXPECT_EQ(1, sink.buffers.size());
+
+    evbuffer_free(evbuf);
+    sink.buffers.clear();
+    EXPECT_EQ(2, num_freed);
+}
+
+// The body received in several chunks is read back from the pipe as it's sent.
+TEST(StreamLoadActionTest, append_body_to_pipe) {
+    std::string body;
+    for (int i = 0; i < 20000; ++i) {
+        body += std::to_string(i) + ",abc\n";
+    }
+    StreamLoadPipe pipe(1024 * 1024, 64 * 1024, body.size());
+    evbuffer* evbuf = evbuffer_new();
+    size_t receive_bytes = 0;
+    for (size_t offset = 0; offset < body.size(); offset += 10000) {
+        evbuffer_add(evbuf, body.data() + offset, std::min<size_t>(10000, body.size() - offset));
+        ASSERT_TRUE(StreamLoadAction::_append_body(evbuf, &pipe, &receive_bytes).ok());
+    }
+    evbuffer_free(evbuf);
+    EXPECT_EQ(body.size(), receive_bytes);
+    ASSERT_TRUE(pipe.finish().ok());
+
+    std::string read_body;
+    bool eof = false;
+    while (!eof) {
+        char buf[4096];
+        int64_t read_bytes = 0;
+        ASSERT_TRUE(pipe.read(reinterpret_cast<uint8_t*>(buf), sizeof(buf), &read_bytes, &eof)
+                            .ok());
+        read_body.append(buf, read_bytes);
+    }
+    EXPECT_EQ(body, read_body);
+}
+
+} // namespace doris
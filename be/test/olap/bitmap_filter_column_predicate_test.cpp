@@ -0,0 +1,109 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+#include "exprs/bitmapfilter_predicate.h"
+#include "olap/bitmap_filter_predicate.h"
+#include "olap/column_predicate.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/predicate_column.h"
+
+using namespace doris::vectorized;
+
+namespace doris {
+
+TEST(TestBitmapFilterColumnPredicate, FILTER_FUNC) {
+    BitmapFilterFunc filter(TYPE_INT);
+    for (int32_t i = -10; i < 10; i += 2) {
+        filter.insert(&i);
+    }
+    BitmapFilterFunc other(TYPE_INT);
+    int32_t value = 1001;
+    other.insert(&value);
+    filter.merge(&other);
+
+    // serialize and deserialize as the merge of the runtime filters does
+    char* data = nullptr;
+    int len = 0;
+    ASSERT_TRUE(filter.get_data(&data, &len).ok());
+    BitmapFilterFunc assigned(TYPE_INT);
+    ASSERT_TRUE(assigned.assign(data, len).ok());
+    EXPECT_EQ(assigned.bitmap().cardinality(), 11U);
+    for (int32_t i = -10; i < 10; ++i) {
+        EXPECT_EQ(assigned.find(&i), i % 2 == 0) << i;
+    }
+    EXPECT_TRUE(assigned.find(&value));
+}
+
+TEST(TestBitmapFilterColumnPredicate, BIGINT_COLUMN) {
+    std::shared_ptr<BitmapFilterFunc> filter(new BitmapFilterFunc(TYPE_BIGINT));
+    const int size = 100;
+    for (int64_t i = -size; i < size; i += 3) {
+        filter->insert(&i);
+    }
+    std::unique_ptr<ColumnPredicate> pred(
+            BitmapFilterColumnPredicateFactory::create_column_predicate(0, filter,
+                                                                        OLAP_FIELD_TYPE_BIGINT));
+    ASSERT_NE(pred, nullptr);
+    EXPECT_TRUE(pred->can_do_bitmap_index_filter());
+
+    auto pred_col = PredicateColumnType<int64_t>::create();
+    auto null_map = ColumnUInt8::create(size, 0);
+    uint16_t sel[size];
+    for (int i = 0; i < size; ++i) {
+        int64_t v = i - size / 2;
+        pred_col->insert_data(reinterpret_cast<const char*>(&v), 0);
+        null_map->get_data()[i] = (i % 2 == 0);
+        sel[i] = i;
+    }
+    std::vector<uint16_t> expected;
+    for (int i = 0; i < size; ++i) {
+        int64_t v = i - size / 2;
+        if (filter->find(&v)) {
+            expected.push_back(i);
+        }
+    }
+    uint16_t select_size = size;
+    pred->evaluate(*pred_col, sel, &select_size);
+    EXPECT_EQ(std::vector<uint16_t>(sel, sel + select_size), expected);
+
+    // the null rows are filtered, the even rows are null
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    select_size = size;
+    auto nullable_col = ColumnNullable::create(std::move(pred_col), std::move(null_map));
+    pred->evaluate(*nullable_col, sel, &select_size);
+    std::vector<uint16_t> expected_not_null;
+    for (auto idx : expected) {
+        if (idx % 2 != 0) {
+            expected_not_null.push_back(idx);
+        }
+    }
+    EXPECT_EQ(std::vector<uint16_t>(sel, sel + select_size), expected_not_null);
+
+    // a string column is not supported
+    EXPECT_EQ(BitmapFilterColumnPredicateFactory::create_column_predicate(0, filter,
+                                                                          OLAP_FIELD_TYPE_VARCHAR),
+              nullptr);
+}
+
+} // namespace doris
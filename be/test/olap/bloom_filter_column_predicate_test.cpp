@@ -19,11 +19,16 @@
 #include <gtest/gtest.h>
 #include <time.h>
 
+#include <algorithm>
+
+#include "common/config.h"
 #include "exprs/create_predicate_function.h"
 #include "olap/bloom_filter_predicate.h"
 #include "olap/column_predicate.h"
+#include "olap/comparison_predicate.h"
 #include "olap/field.h"
 #include "olap/row_block2.h"
+#include "olap/rowset/segment_v2/segment_iterator.h"
 #include "runtime/mem_pool.h"
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
@@ -210,4 +215,112 @@ TEST_F(TestBloomFilterColumnPredicate, FLOAT_COLUMN) {
     delete pred;
 }
 
+TEST_F(TestBloomFilterColumnPredicate, INT_COLUMN_BATCH) {
+    std::shared_ptr<IBloomFilterFuncBase> bloom_filter(
+            create_bloom_filter(PrimitiveType::TYPE_INT));
+    bloom_filter->init(4096, 0.05);
+    // more rows than the prefetch distance of the batch probe
+    const int size = 1000;
+    for (int32_t i = 0; i < size; i += 10) {
+        bloom_filter->insert(reinterpret_cast<void*>(&i));
+    }
+    std::unique_ptr<ColumnPredicate> pred(
+            BloomFilterColumnPredicateFactory::create_column_predicate(0, bloom_filter,
+                                                                       OLAP_FIELD_TYPE_INT));
+
+    auto pred_col = PredicateColumnType<int32_t>::create();
+    auto null_map = ColumnUInt8::create(size, 0);
+    uint16_t sel[size];
+    for (int32_t i = 0; i < size; ++i) {
+        pred_col->insert_data(reinterpret_cast<const char*>(&i), 0);
+        null_map->get_data()[i] = (i % 20 == 0);
+        sel[i] = i;
+    }
+    // the batch probe must match the probe of each row
+    std::vector<uint16_t> expected;
+    for (int32_t i = 0; i < size; ++i) {
+        if (bloom_filter->find_olap_engine(&i)) {
+            expected.push_back(i);
+        }
+    }
+    uint16_t select_size = size;
+    pred->evaluate(*pred_col, sel, &select_size);
+    EXPECT_EQ(std::vector<uint16_t>(sel, sel + select_size), expected);
+    for (int32_t i = 0; i < size; i += 10) {
+        EXPECT_TRUE(std::binary_search(sel, sel + select_size, i));
+    }
+
+    // the null rows are filtered, the rows multiple of 20 are null
+    for (int32_t i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    select_size = size;
+    auto nullable_col =
+            vectorized::ColumnNullable::create(std::move(pred_col), std::move(null_map));
+    pred->evaluate(*nullable_col, sel, &select_size);
+    for (int i = 0; i < select_size; ++i) {
+        EXPECT_NE(sel[i] % 20, 0);
+    }
+    for (int32_t i = 10; i < size; i += 20) {
+        EXPECT_TRUE(std::binary_search(sel, sel + select_size, i));
+    }
+}
+
+// The runtime bloom filters filtering too few of the sampled rows of a segment are dropped, the
+// other predicates and the filters never reached are kept in their order.
+TEST_F(TestBloomFilterColumnPredicate, drop_ineffective_runtime_filters) {
+    using segment_v2::SegmentIterator;
+    int32_t min_filtered_percent = config::runtime_filter_min_filtered_percent;
+    config::runtime_filter_min_filtered_percent = 5;
+    std::vector<std::unique_ptr<ColumnPredicate>> owners;
+    for (int column_id = 0; column_id < 4; ++column_id) {
+        if (column_id == 1) {
+            owners.emplace_back(new EqualPredicate<int32_t>(column_id, 7));
+            continue;
+        }
+        std::shared_ptr<IBloomFilterFuncBase> bloom_filter(
+                create_bloom_filter(PrimitiveType::TYPE_INT));
+        bloom_filter->init(4096, 0.05);
+        owners.emplace_back(BloomFilterColumnPredicateFactory::create_column_predicate(
+                column_id, bloom_filter, OLAP_FIELD_TYPE_INT));
+    }
+    auto column_ids = [](const std::vector<ColumnPredicate*>& predicates) {
+        std::vector<uint32_t> result;
+        for (auto predicate : predicates) {
+            result.push_back(predicate->column_id());
+        }
+        return result;
+    };
+
+    std::vector<ColumnPredicate*> predicates;
+    for (auto& predicate : owners) {
+        predicates.push_back(predicate.get());
+    }
+    // input rows, output rows, cost
+    std::vector<SegmentIterator::PredicateEvalStats> stats = {
+            {1000, 990, 10}, {990, 10, 10}, {10, 5, 10}, {0, 0, 0}};
+    OlapReaderStatistics reader_stats;
+    SegmentIterator::_drop_ineffective_runtime_filters(&predicates, &stats, &reader_stats);
+    EXPECT_EQ(std::vector<uint32_t>({1, 2, 3}), column_ids(predicates));
+    ASSERT_EQ(3, stats.size());
+    EXPECT_EQ(990, stats[0].input_rows);
+    EXPECT_EQ(10, stats[1].input_rows);
+    EXPECT_EQ(0, stats[2].input_rows);
+    EXPECT_EQ(1, reader_stats.runtime_filters_dropped);
+
+    // a filter of exactly the min percent is kept
+    predicates = {owners[0].get()};
+    stats = {{1000, 950, 10}};
+    SegmentIterator::_drop_ineffective_runtime_filters(&predicates, &stats, &reader_stats);
+    EXPECT_EQ(std::vector<uint32_t>({0}), column_ids(predicates));
+
+    // and none is dropped if disabled
+    config::runtime_filter_min_filtered_percent = 0;
+    stats = {{1000, 1000, 10}};
+    SegmentIterator::_drop_ineffective_runtime_filters(&predicates, &stats, &reader_stats);
+    EXPECT_EQ(1, predicates.size());
+    EXPECT_EQ(1, reader_stats.runtime_filters_dropped);
+    config::runtime_filter_min_filtered_percent = min_filtered_percent;
+}
+
 } // namespace doris
@@ -0,0 +1,188 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/clock_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace doris {
+
+static int s_deleted_count = 0;
+
+static void deleter(const CacheKey& key, void* value) {
+    ++s_deleted_count;
+}
+
+class ClockCacheTest : public testing::Test {
+public:
+    void SetUp() override {
+        s_deleted_count = 0;
+        _cache = std::make_unique<ClockCache>(LRUCacheType::NUMBER);
+        _cache->set_capacity(3);
+    }
+
+    void insert(int key, CachePriority priority = CachePriority::NORMAL) {
+        _cache->release(_insert(key, priority));
+    }
+
+    bool lookup(int key) {
+        std::string str = std::to_string(key);
+        CacheKey cache_key(str);
+        Cache::Handle* handle = _cache->lookup(cache_key, _hash(cache_key));
+        _cache->release(handle);
+        return handle != nullptr;
+    }
+
+protected:
+    Cache::Handle* _insert(int key, CachePriority priority = CachePriority::NORMAL) {
+        std::string str = std::to_string(key);
+        CacheKey cache_key(str);
+        return _cache->insert(cache_key, _hash(cache_key), reinterpret_cast<void*>(intptr_t(key)),
+                              1, &deleter, priority);
+    }
+
+    static uint32_t _hash(const CacheKey& key) { return key.hash(key.data(), key.size(), 0); }
+
+    std::unique_ptr<ClockCache> _cache;
+};
+
+TEST_F(ClockCacheTest, SecondChance) {
+    insert(1);
+    insert(2);
+    insert(3);
+    EXPECT_EQ(3, _cache->get_usage());
+
+    // 1 is visited, so 2 is evicted
+    EXPECT_TRUE(lookup(1));
+    insert(4);
+    EXPECT_EQ(3, _cache->get_usage());
+    EXPECT_EQ(1, s_deleted_count);
+    EXPECT_FALSE(lookup(2));
+    EXPECT_TRUE(lookup(1));
+    EXPECT_TRUE(lookup(3));
+    EXPECT_TRUE(lookup(4));
+    EXPECT_EQ(5, _cache->get_lookup_count());
+    EXPECT_EQ(4, _cache->get_hit_count());
+}
+
+TEST_F(ClockCacheTest, PinnedEntryNotEvicted) {
+    Cache::Handle* handle = _insert(1);
+    insert(2);
+    insert(3);
+    insert(4);
+    EXPECT_TRUE(lookup(1));
+    EXPECT_FALSE(lookup(2));
+    _cache->release(handle);
+    EXPECT_TRUE(lookup(1));
+
+    // all entries are in use, the cache goes beyond its capacity
+    std::vector<Cache::Handle*> handles;
+    for (int i = 10; i < 15; ++i) {
+        handles.push_back(_insert(i));
+    }
+    EXPECT_EQ(5, _cache->get_usage());
+    for (auto h : handles) {
+        _cache->release(h);
+    }
+}
+
+TEST_F(ClockCacheTest, DurableEvictedLast) {
+    _cache->set_capacity(2);
+    insert(1, CachePriority::DURABLE);
+    insert(2);
+    insert(3);
+    EXPECT_TRUE(lookup(1));
+    EXPECT_FALSE(lookup(2));
+    EXPECT_TRUE(lookup(3));
+
+    insert(4, CachePriority::DURABLE);
+    insert(5, CachePriority::DURABLE);
+    EXPECT_EQ(2, _cache->get_usage());
+    EXPECT_FALSE(lookup(3));
+}
+
+TEST_F(ClockCacheTest, EraseAndPrune) {
+    Cache::Handle* handle = _insert(1);
+    insert(2);
+    insert(3);
+
+    // the erased entry is freed when the last handle is released
+    std::string key = "1";
+    _cache->erase(CacheKey(key), _hash(CacheKey(key)));
+    EXPECT_FALSE(lookup(1));
+    EXPECT_EQ(2, _cache->get_usage());
+    EXPECT_EQ(0, s_deleted_count);
+    _cache->release(handle);
+    EXPECT_EQ(1, s_deleted_count);
+
+    // the replaced entry is freed too
+    insert(2);
+    EXPECT_EQ(2, s_deleted_count);
+    EXPECT_EQ(2, _cache->get_usage());
+
+    EXPECT_EQ(1, _cache->prune_if(
+                         [](const void* value) { return reinterpret_cast<intptr_t>(value) == 2; }));
+    EXPECT_EQ(1, _cache->prune());
+    EXPECT_EQ(0, _cache->get_usage());
+    EXPECT_EQ(4, s_deleted_count);
+}
+
+TEST(ShardedClockCacheTest, ConcurrentLookup) {
+    std::unique_ptr<Cache> cache(
+            new_cache_by_policy("ConcurrentLookup", 1000, LRUCacheType::NUMBER, "CLOCK"));
+    EXPECT_NE(nullptr, dynamic_cast<ShardedClockCache*>(cache.get()));
+    auto insert = [&](int key) {
+        std::string str = std::to_string(key);
+        cache->release(cache->insert(CacheKey(str), reinterpret_cast<void*>(intptr_t(key)), 1,
+                                     [](const CacheKey& key, void* value) {}));
+    };
+    for (int i = 0; i < 500; ++i) {
+        insert(i);
+    }
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&cache]() {
+            for (int i = 0; i < 10000; ++i) {
+                int key = i % 500;
+                std::string str = std::to_string(key);
+                // the key may be evicted by the concurrent inserts
+                Cache::Handle* handle = cache->lookup(CacheKey(str));
+                if (handle != nullptr) {
+                    ASSERT_EQ(key, reinterpret_cast<intptr_t>(cache->value(handle)));
+                    cache->release(handle);
+                }
+            }
+        });
+    }
+    // evict and insert concurrently
+    threads.emplace_back([&insert]() {
+        for (int i = 1000; i < 3000; ++i) {
+            insert(i);
+        }
+    });
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+} // namespace doris
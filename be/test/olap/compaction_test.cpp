@@ -0,0 +1,319 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/compaction.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gen_cpp/AgentService_types.h"
+#include "olap/row_block.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_reader_context.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+
+static StorageEngine* k_engine = nullptr;
+static std::string k_storage_root_path;
+
+// Compact the given rowsets of the tablet as a cumulative compaction
+class TestCompaction : public Compaction {
+public:
+    TestCompaction(TabletSharedPtr tablet, std::vector<RowsetSharedPtr> input_rowsets)
+            : Compaction(tablet, "TestCompaction") {
+        _input_rowsets = std::move(input_rowsets);
+    }
+
+    Status prepare_compact() override { return Status::OK(); }
+
+    Status execute_compact_impl() override { return do_compaction_impl(1); }
+
+    RowsetSharedPtr output_rowset() const { return _output_rowset; }
+
+protected:
+    Status pick_rowsets_to_compact() override { return Status::OK(); }
+
+    std::string compaction_name() const override { return "test compaction"; }
+
+    ReaderType compaction_type() const override { return ReaderType::READER_CUMULATIVE_COMPACTION; }
+};
+
+class CompactionTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        config::min_file_descriptor_number = 1000;
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        k_storage_root_path = std::string(buffer) + "/data_compaction_test";
+        config::storage_root_path = k_storage_root_path;
+        EXPECT_TRUE(FileUtils::remove_all(k_storage_root_path).ok());
+        EXPECT_TRUE(FileUtils::create_dir(k_storage_root_path).ok());
+
+        std::vector<StorePath> paths;
+        paths.emplace_back(k_storage_root_path, -1);
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &k_engine);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        ExecEnv::GetInstance()->set_storage_engine(k_engine);
+    }
+
+    static void TearDownTestSuite() {
+        if (k_engine != nullptr) {
+            k_engine->stop();
+            delete k_engine;
+            k_engine = nullptr;
+        }
+        EXPECT_TRUE(FileUtils::remove_all(k_storage_root_path).ok());
+    }
+
+protected:
+    // (k1 int, v1 int), duplicate key or merge-on-write unique key (k1)
+    TabletSharedPtr create_tablet(int64_t tablet_id, bool merge_on_write) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.tablet_schema.schema_hash = 1111;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type =
+                merge_on_write ? TKeysType::UNIQUE_KEYS : TKeysType::DUP_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        request.__set_enable_unique_key_merge_on_write(merge_on_write);
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::INT;
+        k1.__set_is_allow_null(true);
+        request.tablet_schema.columns.push_back(k1);
+
+        TColumn v1;
+        v1.column_name = "v1";
+        v1.__set_is_key(false);
+        v1.column_type.type = TPrimitiveType::INT;
+        v1.__set_is_allow_null(true);
+        v1.__set_aggregation_type(merge_on_write ? TAggregationType::REPLACE
+                                                 : TAggregationType::NONE);
+        request.tablet_schema.columns.push_back(v1);
+
+        Status s = k_engine->create_tablet(request);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        return k_engine->tablet_manager()->get_tablet(tablet_id, 1111);
+    }
+
+    // write a rowset of the version `version` with a segment for each range [begin, end) of
+    // k1, v1 = k1 * 10, and add it to the tablet
+    RowsetSharedPtr write_rowset(const TabletSharedPtr& tablet, int64_t version,
+                                 const std::vector<std::pair<int32_t, int32_t>>& segments) {
+        RowsetWriterContext context;
+        context.rowset_id = k_engine->next_rowset_id();
+        context.tablet_uid = tablet->tablet_uid();
+        context.tablet_id = tablet->tablet_id();
+        context.partition_id = tablet->partition_id();
+        context.tablet_schema_hash = tablet->schema_hash();
+        context.data_dir = tablet->data_dir();
+        context.rowset_type = BETA_ROWSET;
+        context.path_desc = tablet->tablet_path_desc();
+        context.tablet_schema = &tablet->tablet_schema();
+        context.rowset_state = VISIBLE;
+        context.version = Version(version, version);
+        context.segments_overlap = NONOVERLAPPING;
+
+        std::unique_ptr<RowsetWriter> writer;
+        EXPECT_TRUE(RowsetFactory::create_rowset_writer(context, &writer).ok());
+        RowCursor row;
+        EXPECT_TRUE(row.init(tablet->tablet_schema()).ok());
+        MemPool pool("CompactionTest");
+        for (auto [begin, end] : segments) {
+            for (int32_t k1 = begin; k1 < end; ++k1) {
+                int32_t v1 = k1 * 10;
+                row.set_field_content(0, reinterpret_cast<char*>(&k1), &pool);
+                row.set_field_content(1, reinterpret_cast<char*>(&v1), &pool);
+                EXPECT_TRUE(writer->add_row(row).ok());
+            }
+            EXPECT_TRUE(writer->flush().ok());
+        }
+        RowsetSharedPtr rowset = writer->build();
+        EXPECT_NE(nullptr, rowset);
+        EXPECT_TRUE(tablet->add_rowset(rowset).ok());
+        return rowset;
+    }
+
+    static void set_delete_predicate(const RowsetSharedPtr& rowset) {
+        DeletePredicatePB delete_predicate;
+        delete_predicate.set_version(rowset->end_version());
+        delete_predicate.add_sub_predicates("k1=-1");
+        rowset->rowset_meta()->set_delete_predicate(delete_predicate);
+    }
+
+    // compact the rowsets, and check the rows of the output rowset are those of the inputs, and
+    // its segments and sizes are those of the inputs if they are moved, or merged into one
+    RowsetSharedPtr compact(const TabletSharedPtr& tablet,
+                            const std::vector<RowsetSharedPtr>& input_rowsets,
+                            bool trivial_move) {
+        int64_t num_segments = 0;
+        int64_t num_rows = 0;
+        int64_t data_disk_size = 0;
+        int64_t index_disk_size = 0;
+        std::vector<int32_t> keys;
+        for (auto& rowset : input_rowsets) {
+            num_segments += rowset->num_segments();
+            num_rows += rowset->num_rows();
+            data_disk_size += rowset->rowset_meta()->data_disk_size();
+            index_disk_size += rowset->rowset_meta()->index_disk_size();
+            auto rowset_keys = read_keys(tablet, rowset);
+            keys.insert(keys.end(), rowset_keys.begin(), rowset_keys.end());
+        }
+        std::sort(keys.begin(), keys.end());
+
+        TestCompaction compaction(tablet, input_rowsets);
+        Status s = compaction.compact();
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        RowsetSharedPtr output = compaction.output_rowset();
+        EXPECT_NE(nullptr, output);
+        EXPECT_EQ(Version(input_rowsets.front()->start_version(),
+                          input_rowsets.back()->end_version()),
+                  output->version());
+        EXPECT_EQ(num_rows, output->num_rows());
+        EXPECT_EQ(keys, read_keys(tablet, output));
+        if (!trivial_move) {
+            EXPECT_EQ(1, output->num_segments());
+        } else {
+            EXPECT_EQ(num_segments, output->num_segments());
+            EXPECT_EQ(data_disk_size, output->rowset_meta()->data_disk_size());
+            EXPECT_EQ(index_disk_size, output->rowset_meta()->index_disk_size());
+            EXPECT_EQ(data_disk_size + index_disk_size,
+                      output->rowset_meta()->total_disk_size());
+        }
+        return output;
+    }
+
+    // the k1 of the rows of the rowset in the order of the keys
+    std::vector<int32_t> read_keys(const TabletSharedPtr& tablet, const RowsetSharedPtr& rowset) {
+        RowsetReaderContext reader_context;
+        reader_context.tablet_schema = &tablet->tablet_schema();
+        reader_context.need_ordered_result = true;
+        std::vector<uint32_t> return_columns = {0, 1};
+        reader_context.return_columns = &return_columns;
+        reader_context.seek_columns = &return_columns;
+        OlapReaderStatistics stats;
+        reader_context.stats = &stats;
+
+        RowsetReaderSharedPtr reader;
+        EXPECT_TRUE(rowset->create_reader(&reader).ok());
+        EXPECT_TRUE(reader->init(&reader_context).ok());
+        std::vector<int32_t> keys;
+        RowBlock* block = nullptr;
+        while (reader->next_block(&block).ok()) {
+            for (int i = 0; i < block->row_num(); ++i) {
+                int32_t k1 = *reinterpret_cast<int32_t*>(block->field_ptr(i, 0) + 1);
+                int32_t v1 = *reinterpret_cast<int32_t*>(block->field_ptr(i, 1) + 1);
+                EXPECT_EQ(k1 * 10, v1);
+                keys.push_back(k1);
+            }
+        }
+        return keys;
+    }
+};
+
+TEST_F(CompactionTest, TrivialMove) {
+    TabletSharedPtr tablet = create_tablet(20001, false);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> input_rowsets = {
+            write_rowset(tablet, 2, {{0, 100}, {100, 200}}),
+            write_rowset(tablet, 3, {{200, 300}}),
+            write_rowset(tablet, 4, {{300, 350}, {400, 450}}),
+    };
+
+    RowsetSharedPtr output = compact(tablet, input_rowsets, true);
+    ASSERT_NE(nullptr, output);
+    // the key bounds of the segments are those of the inputs in order
+    std::vector<std::string> key_bounds;
+    for (auto& rowset : input_rowsets) {
+        for (const auto& bounds : rowset->rowset_meta()->segments_key_bounds()) {
+            key_bounds.push_back(bounds.min_key());
+            key_bounds.push_back(bounds.max_key());
+        }
+    }
+    ASSERT_TRUE(output->rowset_meta()->has_segments_key_bounds());
+    std::vector<std::string> output_key_bounds;
+    for (const auto& bounds : output->rowset_meta()->segments_key_bounds()) {
+        output_key_bounds.push_back(bounds.min_key());
+        output_key_bounds.push_back(bounds.max_key());
+    }
+    EXPECT_EQ(key_bounds, output_key_bounds);
+}
+
+TEST_F(CompactionTest, MergeOverlappingSegments) {
+    TabletSharedPtr tablet = create_tablet(20002, false);
+    ASSERT_NE(nullptr, tablet);
+    // the segments of the same rowset overlap
+    {
+        std::vector<RowsetSharedPtr> input_rowsets = {
+                write_rowset(tablet, 2, {{0, 100}, {50, 150}}),
+                write_rowset(tablet, 3, {{200, 300}}),
+        };
+        EXPECT_NE(nullptr, compact(tablet, input_rowsets, false));
+    }
+    // the rowsets overlap on one key
+    {
+        std::vector<RowsetSharedPtr> input_rowsets = {
+                write_rowset(tablet, 4, {{300, 400}}),
+                write_rowset(tablet, 5, {{399, 500}}),
+        };
+        EXPECT_NE(nullptr, compact(tablet, input_rowsets, false));
+    }
+}
+
+TEST_F(CompactionTest, MergeDeletePredicate) {
+    TabletSharedPtr tablet = create_tablet(20003, false);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> input_rowsets = {
+            write_rowset(tablet, 2, {{0, 100}}),
+            write_rowset(tablet, 3, {{100, 200}}),
+            write_rowset(tablet, 4, {{200, 300}}),
+    };
+    set_delete_predicate(input_rowsets[1]);
+    EXPECT_NE(nullptr, compact(tablet, input_rowsets, false));
+}
+
+TEST_F(CompactionTest, MergeMergeOnWrite) {
+    TabletSharedPtr tablet = create_tablet(20004, true);
+    ASSERT_NE(nullptr, tablet);
+    ASSERT_TRUE(tablet->enable_unique_key_merge_on_write());
+    std::vector<RowsetSharedPtr> input_rowsets = {
+            write_rowset(tablet, 2, {{0, 100}}),
+            write_rowset(tablet, 3, {{100, 200}}),
+    };
+    EXPECT_NE(nullptr, compact(tablet, input_rowsets, false));
+}
+
+} // namespace doris
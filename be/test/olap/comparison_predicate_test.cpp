@@ -29,6 +29,9 @@
 #include "runtime/string_value.hpp"
 #include "runtime/vectorized_row_batch.h"
 #include "util/logging.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/columns/predicate_column.h"
 
 namespace doris {
 
@@ -1390,4 +1393,62 @@ TEST_F(TestLessPredicate, DATETIME_COLUMN) {
     delete pred;
 }
 
+TEST_F(TestLessPredicate, VEC_COLUMN) {
+    // more rows than a simd batch, with a tail
+    int size = 100;
+    auto pred_col = vectorized::PredicateColumnType<int32_t>::create();
+    for (int32_t i = 0; i < size; ++i) {
+        pred_col->insert_data(reinterpret_cast<const char*>(&i), 0);
+    }
+    std::unique_ptr<ColumnPredicate> pred(new LessPredicate<int32_t>(0, 70));
+    std::unique_ptr<ColumnPredicate> opposite_pred(new LessPredicate<int32_t>(0, 70, true));
+
+    // contiguous selection
+    uint16_t sel[size];
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    uint16_t select_size = size;
+    pred->evaluate(*pred_col, sel, &select_size);
+    EXPECT_EQ(select_size, 70);
+    for (int i = 0; i < select_size; ++i) {
+        EXPECT_EQ(sel[i], i);
+    }
+
+    // selection with holes, the odd rows
+    for (int i = 0; i < size / 2; ++i) {
+        sel[i] = i * 2 + 1;
+    }
+    select_size = size / 2;
+    opposite_pred->evaluate(*pred_col, sel, &select_size);
+    EXPECT_EQ(select_size, 15);
+    for (int i = 0; i < select_size; ++i) {
+        EXPECT_EQ(sel[i], 71 + i * 2);
+    }
+
+    // the rows which are multiples of 3 are null
+    auto null_map = vectorized::ColumnUInt8::create();
+    for (int i = 0; i < size; ++i) {
+        null_map->insert_value(i % 3 == 0);
+    }
+    auto nullable_col =
+            vectorized::ColumnNullable::create(std::move(pred_col), std::move(null_map));
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    select_size = size;
+    pred->evaluate(*nullable_col, sel, &select_size);
+    EXPECT_EQ(select_size, 46);
+    for (int i = 0; i < select_size; ++i) {
+        EXPECT_NE(sel[i] % 3, 0);
+        EXPECT_LT(sel[i], 70);
+    }
+    select_size = size;
+    for (int i = 0; i < size; ++i) {
+        sel[i] = i;
+    }
+    opposite_pred->evaluate(*nullable_col, sel, &select_size);
+    EXPECT_EQ(select_size, 54);
+}
+
 } // namespace doris
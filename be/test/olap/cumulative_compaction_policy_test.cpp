@@ -24,6 +24,7 @@
 #include "olap/cumulative_compaction.h"
 #include "olap/rowset/rowset_meta.h"
 #include "olap/tablet_meta.h"
+#include "util/time.h"
 
 namespace doris {
 
@@ -326,6 +327,103 @@ TEST_F(TestNumBasedCumulativeCompactionPolicy, pick_input_rowsets_delete) {
     EXPECT_EQ(5, last_delete_version.second);
 }
 
+class TestTimeSeriesCumulativeCompactionPolicy : public TestNumBasedCumulativeCompactionPolicy {
+protected:
+    TabletSharedPtr create_tablet(const std::vector<RowsetMetaSharedPtr>& rs_metas) {
+        for (auto& rowset : rs_metas) {
+            _tablet_meta->add_rs_meta(rowset);
+        }
+        StorageParamPB storage_param;
+        storage_param.set_storage_medium(StorageMediumPB::HDD);
+        TabletSharedPtr tablet(
+                new Tablet(_tablet_meta, storage_param, nullptr, CUMULATIVE_TIME_SERIES_POLICY));
+        tablet->init();
+        tablet->calculate_cumulative_point();
+        return tablet;
+    }
+};
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, calculate_cumulative_point) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_all_rs_meta_cal_point(&rs_metas);
+    TabletSharedPtr tablet = create_tablet(rs_metas);
+
+    // the rowset [2-3] is smaller than the goal size
+    EXPECT_EQ(2, tablet->cumulative_layer_point());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, calc_cumulative_compaction_score) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_all_rs_meta_cal_point(&rs_metas);
+    for (auto& rs_meta : rs_metas) {
+        rs_meta->set_creation_time(UnixSeconds());
+    }
+
+    // wait for more rowsets
+    TimeSeriesCumulativeCompactionPolicy waiting_policy(1L << 30, 100, 3600);
+    uint32_t score = 0;
+    waiting_policy.calc_cumulative_compaction_score(TABLET_RUNNING, rs_metas, 2, &score);
+    EXPECT_EQ(0, score);
+
+    // reach the file count threshold
+    TimeSeriesCumulativeCompactionPolicy policy(1L << 30, 3, 3600);
+    policy.calc_cumulative_compaction_score(TABLET_RUNNING, rs_metas, 2, &score);
+    EXPECT_LT(0, score);
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_goal_size) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_all_rs_meta_cal_point(&rs_metas);
+    TabletSharedPtr tablet = create_tablet(rs_metas);
+
+    std::vector<RowsetSharedPtr> candidate_rowsets;
+    tablet->pick_candidate_rowsets_to_cumulative_compaction(1000, &candidate_rowsets);
+    EXPECT_EQ(3, candidate_rowsets.size());
+
+    TimeSeriesCumulativeCompactionPolicy policy(2 * 84699, 100, 3600);
+    std::vector<RowsetSharedPtr> input_rowsets;
+    Version last_delete_version {-1, -1};
+    size_t compaction_score = 0;
+    policy.pick_input_rowsets(tablet.get(), candidate_rowsets, 1000, 5, &input_rowsets,
+                              &last_delete_version, &compaction_score);
+
+    EXPECT_EQ(2, input_rowsets.size());
+    EXPECT_EQ(2, input_rowsets[0]->start_version());
+    EXPECT_EQ(4, input_rowsets[1]->end_version());
+}
+
+TEST_F(TestTimeSeriesCumulativeCompactionPolicy, pick_input_rowsets_wait) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    init_all_rs_meta_cal_point(&rs_metas);
+    for (auto& rs_meta : rs_metas) {
+        rs_meta->set_creation_time(UnixSeconds());
+    }
+    TabletSharedPtr tablet = create_tablet(rs_metas);
+
+    std::vector<RowsetSharedPtr> candidate_rowsets;
+    candidate_rowsets.push_back(tablet->get_rowset_by_version({2, 3}));
+    candidate_rowsets.push_back(tablet->get_rowset_by_version({4, 4}));
+    candidate_rowsets.push_back(tablet->get_rowset_by_version({5, 5}));
+
+    TimeSeriesCumulativeCompactionPolicy policy(1L << 30, 100, 3600);
+    std::vector<RowsetSharedPtr> input_rowsets;
+    Version last_delete_version {-1, -1};
+    size_t compaction_score = 0;
+    int transient_size =
+            policy.pick_input_rowsets(tablet.get(), candidate_rowsets, 1000, 5, &input_rowsets,
+                                      &last_delete_version, &compaction_score);
+
+    EXPECT_EQ(3, transient_size);
+    EXPECT_EQ(0, input_rowsets.size());
+    EXPECT_EQ(2, tablet->cumulative_layer_point());
+
+    // the rowsets are compacted after waiting for the time threshold
+    TimeSeriesCumulativeCompactionPolicy expired_policy(1L << 30, 100, 0);
+    expired_policy.pick_input_rowsets(tablet.get(), candidate_rowsets, 1000, 5, &input_rowsets,
+                                      &last_delete_version, &compaction_score);
+    EXPECT_EQ(3, input_rowsets.size());
+}
+
 class TestSizeBasedCumulativeCompactionPolicy : public testing::Test {
 public:
     TestSizeBasedCumulativeCompactionPolicy() {}
@@ -0,0 +1,205 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "olap/data_dir.h"
+#include "olap/options.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tablet_manager.h"
+#include "olap/txn_manager.h"
+#include "runtime/mem_pool.h"
+#include "util/file_utils.h"
+#include "util/threadpool.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+
+static constexpr int64_t FIRST_TABLET_ID = 40101;
+static constexpr int NUM_TABLETS = 37;
+static constexpr int32_t SCHEMA_HASH = 270068380;
+static constexpr int64_t PARTITION_ID = 1;
+
+// The tablet and rowset metas of a data dir are loaded by a thread pool when the storage engine
+// is opened again.
+class DataDirLoadTest : public testing::Test {
+protected:
+    void SetUp() override {
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        config::storage_root_path = std::string(buffer) + "/data_test";
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::create_dir(config::storage_root_path);
+        open_engine();
+    }
+
+    void TearDown() override {
+        if (_engine != nullptr) {
+            for (int i = 0; i < NUM_TABLETS; ++i) {
+                _engine->tablet_manager()->drop_tablet(FIRST_TABLET_ID + i);
+            }
+        }
+        close_engine();
+        config::load_data_dir_thread_num_per_disk = _load_threads;
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::remove_all(std::string(getenv("DORIS_HOME")) + UNUSED_PREFIX);
+    }
+
+    void open_engine() {
+        std::vector<StorePath> paths;
+        paths.emplace_back(config::storage_root_path, -1);
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &_engine);
+        ASSERT_TRUE(s.ok()) << s.to_string();
+    }
+
+    void close_engine() {
+        if (_engine != nullptr) {
+            _engine->stop();
+            delete _engine;
+            _engine = nullptr;
+        }
+    }
+
+    TabletSharedPtr create_tablet(int64_t tablet_id) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.tablet_schema.schema_hash = SCHEMA_HASH;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::DUP_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        request.__set_storage_format(TStorageFormat::V2);
+        TColumn column;
+        column.column_name = "k1";
+        column.__set_is_key(true);
+        column.column_type.type = TPrimitiveType::INT;
+        request.tablet_schema.columns.push_back(column);
+        EXPECT_TRUE(_engine->create_tablet(request).ok());
+        return _engine->tablet_manager()->get_tablet(tablet_id);
+    }
+
+    // a rowset of `num_rows` rows of the version, or committed in the txn if txn_id > 0
+    RowsetSharedPtr write_rowset(const TabletSharedPtr& tablet, int64_t version, int num_rows,
+                                 int64_t txn_id = 0) {
+        RowsetWriterContext context;
+        context.rowset_id = _engine->next_rowset_id();
+        context.tablet_uid = tablet->tablet_uid();
+        context.tablet_id = tablet->tablet_id();
+        context.partition_id = PARTITION_ID;
+        context.tablet_schema_hash = tablet->schema_hash();
+        context.data_dir = tablet->data_dir();
+        context.rowset_type = BETA_ROWSET;
+        context.path_desc = tablet->tablet_path_desc();
+        context.tablet_schema = &tablet->tablet_schema();
+        if (txn_id > 0) {
+            context.rowset_state = COMMITTED;
+            context.txn_id = txn_id;
+            context.load_id.set_lo(txn_id);
+        } else {
+            context.rowset_state = VISIBLE;
+            context.version = Version(version, version);
+        }
+        context.segments_overlap = NONOVERLAPPING;
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        EXPECT_TRUE(RowsetFactory::create_rowset_writer(context, &rowset_writer).ok());
+        RowCursor row;
+        EXPECT_TRUE(row.init(tablet->tablet_schema()).ok());
+        MemPool mem_pool("DataDirLoadTest");
+        for (int32_t k1 = 0; k1 < num_rows; ++k1) {
+            row.set_field_content(0, reinterpret_cast<char*>(&k1), &mem_pool);
+            EXPECT_TRUE(rowset_writer->add_row(row).ok());
+        }
+        EXPECT_TRUE(rowset_writer->flush().ok());
+        return rowset_writer->build();
+    }
+
+    static int64_t txn_id_of(int64_t tablet_id) { return tablet_id + 1000; }
+
+    StorageEngine* _engine = nullptr;
+    int32_t _load_threads = config::load_data_dir_thread_num_per_disk;
+};
+
+TEST_F(DataDirLoadTest, parallel_load) {
+    // the items are sliced into the tasks, each one is loaded once
+    std::unique_ptr<ThreadPool> pool;
+    ASSERT_TRUE(ThreadPoolBuilder("DataDirLoadTest").set_max_threads(4).build(&pool).ok());
+    for (int load_threads : {1, 3, 8}) {
+        config::load_data_dir_thread_num_per_disk = load_threads;
+        for (size_t num_items : {0, 1, 5, 31, 32, 33, 1000}) {
+            std::vector<std::atomic<int>> loads(num_items);
+            DataDir::_parallel_load(pool.get(), num_items, [&](size_t i) { ++loads[i]; });
+            for (size_t i = 0; i < num_items; ++i) {
+                EXPECT_EQ(1, loads[i]) << "item " << i << " of " << num_items;
+            }
+        }
+    }
+}
+
+TEST_F(DataDirLoadTest, reload) {
+    for (int i = 0; i < NUM_TABLETS; ++i) {
+        auto tablet = create_tablet(FIRST_TABLET_ID + i);
+        ASSERT_NE(nullptr, tablet);
+        // the visible rowsets are in the tablet meta, the committed ones in the rowset metas
+        for (int64_t version = 2; version <= 2 + i % 3; ++version) {
+            auto rowset = write_rowset(tablet, version, 10 * version);
+            ASSERT_NE(nullptr, rowset);
+            ASSERT_TRUE(tablet->add_rowset(rowset).ok());
+        }
+        tablet->save_meta();
+        int64_t txn_id = txn_id_of(tablet->tablet_id());
+        auto rowset = write_rowset(tablet, 0, 7, txn_id);
+        ASSERT_NE(nullptr, rowset);
+        PUniqueId load_id;
+        load_id.set_lo(txn_id);
+        TxnManager* txn_manager = _engine->txn_manager();
+        ASSERT_TRUE(txn_manager->prepare_txn(PARTITION_ID, tablet, txn_id, load_id).ok());
+        ASSERT_TRUE(
+                txn_manager->commit_txn(PARTITION_ID, tablet, txn_id, load_id, rowset, false).ok());
+    }
+    close_engine();
+
+    config::load_data_dir_thread_num_per_disk = 4;
+    open_engine();
+    for (int i = 0; i < NUM_TABLETS; ++i) {
+        int64_t tablet_id = FIRST_TABLET_ID + i;
+        auto tablet = _engine->tablet_manager()->get_tablet(tablet_id);
+        ASSERT_NE(nullptr, tablet) << tablet_id;
+        EXPECT_EQ(2 + i % 3, tablet->max_version().second) << tablet_id;
+        for (int64_t version = 2; version <= 2 + i % 3; ++version) {
+            auto rowset = tablet->get_rowset_by_version(Version(version, version));
+            ASSERT_NE(nullptr, rowset) << tablet_id << ", version " << version;
+            EXPECT_EQ(10 * version, rowset->num_rows());
+        }
+        EXPECT_TRUE(_engine->txn_manager()->has_txn(PARTITION_ID, txn_id_of(tablet_id), tablet_id,
+                                                    SCHEMA_HASH, tablet->tablet_uid()))
+                << tablet_id;
+    }
+}
+
+} // namespace doris
@@ -810,4 +810,46 @@ TEST_F(TestDeltaWriter, vec_sequence_col) {
     delete delta_writer;
 }
 
+TEST_F(TestDeltaWriter, build_slave_pull_request) {
+    TCreateTabletReq request;
+    create_tablet_request(10006, 270068378, &request);
+    Status res = k_engine->create_tablet(request);
+    EXPECT_EQ(Status::OK(), res);
+
+    TDescriptorTable tdesc_tbl = create_descriptor_tablet();
+    ObjectPool obj_pool;
+    DescriptorTbl* desc_tbl = nullptr;
+    DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+
+    PUniqueId load_id;
+    load_id.set_hi(0);
+    load_id.set_lo(0);
+    WriteRequest write_req = {10006, 270068378, WriteType::LOAD, 20004, 30004, load_id, tuple_desc};
+    DeltaWriter* delta_writer = nullptr;
+    DeltaWriter::open(&write_req, &delta_writer, true);
+    EXPECT_NE(delta_writer, nullptr);
+
+    // the rowset can't be pulled before it's committed
+    PTabletWriteSlaveRequest pull_request;
+    res = delta_writer->build_slave_pull_request(&pull_request);
+    EXPECT_FALSE(res.ok());
+
+    res = delta_writer->close();
+    EXPECT_EQ(Status::OK(), res);
+    res = delta_writer->close_wait(nullptr, false);
+    EXPECT_EQ(Status::OK(), res);
+    res = delta_writer->build_slave_pull_request(&pull_request);
+    EXPECT_EQ(Status::OK(), res);
+    EXPECT_EQ(10006, pull_request.rowset_meta().tablet_id());
+    EXPECT_EQ(20004, pull_request.rowset_meta().txn_id());
+    EXPECT_EQ(30004, pull_request.rowset_meta().partition_id());
+    EXPECT_EQ(pull_request.rowset_meta().num_segments(), pull_request.segments_size().size());
+    EXPECT_FALSE(pull_request.rowset_path().empty());
+    SAFE_DELETE(delta_writer);
+
+    res = k_engine->tablet_manager()->drop_tablet(10006, 270068378);
+    EXPECT_EQ(Status::OK(), res);
+}
+
 } // namespace doris
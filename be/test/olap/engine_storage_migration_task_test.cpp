@@ -269,4 +269,32 @@ TEST_F(TestEngineStorageMigrationTask, write_and_migration) {
     delete delta_writer;
 }
 
+// The hottest tablets which fit in the SSD budget are promoted in the order of heat, and the
+// others on SSD are demoted, coldest first.
+TEST(StorageEngineTieringTest, plan_tablet_tiering) {
+    using TabletHeat = StorageEngine::TabletHeat;
+    // heat, size, on ssd
+    std::vector<TabletHeat> tablets = {{nullptr, 100, 40, false}, {nullptr, 50, 30, true},
+                                       {nullptr, 80, 50, false},  {nullptr, 0, 10, true},
+                                       {nullptr, 20, 5, true},    {nullptr, 30, 20, false}};
+    std::vector<size_t> promotions;
+    std::vector<size_t> demotions;
+    EXPECT_EQ(95, StorageEngine::_plan_tablet_tiering(&tablets, 100, &promotions, &demotions));
+    std::vector<double> heats;
+    for (const auto& tablet : tablets) {
+        heats.push_back(tablet.heat);
+    }
+    EXPECT_EQ(std::vector<double>({100, 80, 50, 30, 20, 0}), heats);
+    // the tablet of heat 50 doesn't fit, nor does the one of 30, but the one of 20 does
+    EXPECT_EQ(std::vector<size_t>({0, 1}), promotions);
+    EXPECT_EQ(std::vector<size_t>({5, 2}), demotions);
+
+    // all the tablets on SSD are demoted without a budget
+    promotions.clear();
+    demotions.clear();
+    EXPECT_EQ(0, StorageEngine::_plan_tablet_tiering(&tablets, 0, &promotions, &demotions));
+    EXPECT_TRUE(promotions.empty());
+    EXPECT_EQ(std::vector<size_t>({5, 4, 2}), demotions);
+}
+
 } // namespace doris
@@ -0,0 +1,229 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/fs/remote_file_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "env/env.h"
+#include "util/file_utils.h"
+#include "util/slice.h"
+#include "util/storage_backend.h"
+
+namespace doris {
+namespace fs {
+
+// serve a single remote file from the memory, and count the reads
+class MemStorageBackend : public StorageBackend {
+public:
+    explicit MemStorageBackend(std::string content) : _content(std::move(content)) {}
+
+    Status download(const std::string& remote, const std::string& local) override {
+        return Status::NotSupported("download");
+    }
+    Status direct_download(const std::string& remote, std::string* content) override {
+        *content = _content;
+        return Status::OK();
+    }
+    Status upload(const std::string& local, const std::string& remote) override {
+        return Status::NotSupported("upload");
+    }
+    Status upload_with_checksum(const std::string& local, const std::string& remote,
+                                const std::string& checksum) override {
+        return Status::NotSupported("upload_with_checksum");
+    }
+    Status list(const std::string& remote_path, bool contain_md5, bool recursion,
+                std::map<std::string, FileStat>* files) override {
+        return Status::NotSupported("list");
+    }
+    Status rename(const std::string& orig_name, const std::string& new_name) override {
+        return Status::NotSupported("rename");
+    }
+    Status rename_dir(const std::string& orig_name, const std::string& new_name) override {
+        return Status::NotSupported("rename_dir");
+    }
+    Status direct_upload(const std::string& remote, const std::string& content) override {
+        return Status::NotSupported("direct_upload");
+    }
+    Status copy(const std::string& src, const std::string& dst) override {
+        return Status::NotSupported("copy");
+    }
+    Status copy_dir(const std::string& src, const std::string& dst) override {
+        return Status::NotSupported("copy_dir");
+    }
+    Status rm(const std::string& remote) override { return Status::NotSupported("rm"); }
+    Status rmdir(const std::string& remote) override { return Status::NotSupported("rmdir"); }
+    Status mkdir(const std::string& path) override { return Status::NotSupported("mkdir"); }
+    Status mkdirs(const std::string& path) override { return Status::NotSupported("mkdirs"); }
+    Status exist(const std::string& path) override { return Status::OK(); }
+    Status exist_dir(const std::string& path) override { return Status::OK(); }
+
+    Status read_range(const std::string& remote, uint64_t offset, size_t length,
+                      std::string* content) override {
+        ++range_reads;
+        content->clear();
+        if (offset < _content.size()) {
+            content->assign(_content, offset, length);
+        }
+        return Status::OK();
+    }
+
+    std::atomic<int> range_reads {0};
+
+private:
+    std::string _content;
+};
+
+static const std::string CACHE_DIR = "./ut_dir/remote_file_cache_test";
+static const std::string REMOTE_PATH = "s3://bucket/tablet/0.dat";
+static const int64_t BLOCK_SIZE = 100;
+
+class RemoteFileCacheTest : public testing::Test {
+protected:
+    void SetUp() override {
+        if (FileUtils::check_exist(CACHE_DIR)) {
+            EXPECT_TRUE(FileUtils::remove_all(CACHE_DIR).ok());
+        }
+        for (int i = 0; i < 1050; ++i) {
+            _content.push_back('a' + i % 26);
+        }
+    }
+
+    void TearDown() override {
+        if (FileUtils::check_exist(CACHE_DIR)) {
+            EXPECT_TRUE(FileUtils::remove_all(CACHE_DIR).ok());
+        }
+    }
+
+    // the blocks are written to the local disk in background
+    static void wait_cached_bytes(RemoteFileCache* cache, int64_t bytes) {
+        for (int i = 0; i < 1000 && cache->cached_bytes() != bytes; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        EXPECT_EQ(bytes, cache->cached_bytes());
+    }
+
+    std::string _content;
+};
+
+TEST_F(RemoteFileCacheTest, read_through_cache) {
+    MemStorageBackend backend(_content);
+    RemoteFileCache cache(CACHE_DIR, 10000, BLOCK_SIZE);
+    EXPECT_TRUE(cache.init().ok());
+
+    // across the blocks 0, 1 and 2
+    std::string buf1(60, '\0');
+    std::string buf2(90, '\0');
+    Slice results[2] = {Slice(buf1), Slice(buf2)};
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 80, results, 2).ok());
+    EXPECT_EQ(_content.substr(80, 60), buf1);
+    EXPECT_EQ(_content.substr(140, 90), buf2);
+    EXPECT_EQ(3, backend.range_reads);
+    wait_cached_bytes(&cache, 3 * BLOCK_SIZE);
+
+    // served from the local disk
+    std::string buf3(150, '\0');
+    Slice result(buf3);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 50, &result, 1).ok());
+    EXPECT_EQ(_content.substr(50, 150), buf3);
+    EXPECT_EQ(3, backend.range_reads);
+
+    // the last block is shorter than the block size
+    std::string buf4(50, '\0');
+    result = Slice(buf4);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 1000, &result, 1).ok());
+    EXPECT_EQ(_content.substr(1000, 50), buf4);
+    wait_cached_bytes(&cache, 3 * BLOCK_SIZE + 50);
+
+    // read past the end of the file, from the remote storage and from the cache
+    std::string buf5(60, '\0');
+    result = Slice(buf5);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 1000, &result, 1).is_end_of_file());
+    result = Slice(buf5);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 2000, &result, 1).is_end_of_file());
+}
+
+TEST_F(RemoteFileCacheTest, reload_after_restart) {
+    MemStorageBackend backend(_content);
+    {
+        RemoteFileCache cache(CACHE_DIR, 10000, BLOCK_SIZE);
+        EXPECT_TRUE(cache.init().ok());
+        std::string buf(200, '\0');
+        Slice result(buf);
+        EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 0, &result, 1).ok());
+        wait_cached_bytes(&cache, 2 * BLOCK_SIZE);
+    }
+    EXPECT_EQ(2, backend.range_reads);
+
+    RemoteFileCache cache(CACHE_DIR, 10000, BLOCK_SIZE);
+    EXPECT_TRUE(cache.init().ok());
+    EXPECT_EQ(2 * BLOCK_SIZE, cache.cached_bytes());
+    std::string buf(200, '\0');
+    Slice result(buf);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 0, &result, 1).ok());
+    EXPECT_EQ(_content.substr(0, 200), buf);
+    EXPECT_EQ(2, backend.range_reads);
+}
+
+TEST_F(RemoteFileCacheTest, evict) {
+    MemStorageBackend backend(_content);
+    // at most 3 blocks are cached
+    RemoteFileCache cache(CACHE_DIR, 3 * BLOCK_SIZE, BLOCK_SIZE);
+    EXPECT_TRUE(cache.init().ok());
+
+    std::string buf(10, '\0');
+    Slice result(buf);
+    for (int i = 0; i < 3; ++i) {
+        EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, i * BLOCK_SIZE, &result, 1).ok());
+        wait_cached_bytes(&cache, (i + 1) * BLOCK_SIZE);
+    }
+    std::vector<std::string> files_before;
+    EXPECT_TRUE(Env::Default()->get_children(CACHE_DIR, &files_before).ok());
+    std::sort(files_before.begin(), files_before.end());
+
+    // touch the block 0, and the block 1 is evicted by the block 3
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 0, &result, 1).ok());
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 3 * BLOCK_SIZE, &result, 1).ok());
+    EXPECT_EQ(4, backend.range_reads);
+    std::vector<std::string> files_after;
+    for (int i = 0; i < 1000; ++i) {
+        files_after.clear();
+        EXPECT_TRUE(Env::Default()->get_children(CACHE_DIR, &files_after).ok());
+        std::sort(files_after.begin(), files_after.end());
+        if (files_after.size() == files_before.size() && files_after != files_before) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    EXPECT_EQ(3 * BLOCK_SIZE, cache.cached_bytes());
+
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, 0, &result, 1).ok());
+    EXPECT_EQ(4, backend.range_reads);
+    EXPECT_TRUE(cache.read(&backend, REMOTE_PATH, BLOCK_SIZE, &result, 1).ok());
+    EXPECT_EQ(5, backend.range_reads);
+    EXPECT_EQ(_content.substr(BLOCK_SIZE, 10), buf);
+}
+
+} // namespace fs
+} // namespace doris
@@ -192,6 +192,65 @@ TEST_F(TestHll, Normal) {
     }
 }
 
+TEST_F(TestHll, SparseInMemory) {
+    uint8_t buf[HLL_REGISTERS_COUNT + 1];
+    uint8_t other_buf[HLL_REGISTERS_COUNT + 1];
+
+    // the non-zero registers of 500 distinct values are kept sparse in memory
+    HyperLogLog small_hll;
+    for (int i = 0; i < 500; ++i) {
+        small_hll.update(hash(i));
+    }
+    EXPECT_LT(small_hll.memory_consumed(), HLL_REGISTERS_COUNT / 2);
+    auto cardinality = small_hll.estimate_cardinality();
+    EXPECT_TRUE(cardinality > 490 && cardinality < 510);
+
+    // merge the sparse registers, the result is same as updating all the values
+    HyperLogLog merged_hll;
+    for (int i = 250; i < 750; ++i) {
+        merged_hll.update(hash(i));
+    }
+    merged_hll.merge(small_hll);
+    HyperLogLog expected_hll;
+    for (int i = 0; i < 750; ++i) {
+        expected_hll.update(hash(i));
+    }
+    EXPECT_LT(merged_hll.memory_consumed(), HLL_REGISTERS_COUNT);
+    EXPECT_EQ(expected_hll.estimate_cardinality(), merged_hll.estimate_cardinality());
+    int len = merged_hll.serialize(buf);
+    EXPECT_EQ(len, expected_hll.serialize(other_buf));
+    EXPECT_EQ(0, memcmp(buf, other_buf, len));
+
+    // deserialized and copied sparse registers
+    HyperLogLog deserialized_hll(Slice((char*)buf, len));
+    HyperLogLog copied_hll(deserialized_hll);
+    EXPECT_LT(copied_hll.memory_consumed(), HLL_REGISTERS_COUNT);
+    EXPECT_EQ(len, copied_hll.serialize(other_buf));
+    EXPECT_EQ(0, memcmp(buf, other_buf, len));
+
+    // converted to full registers when there are too many non-zero registers, which is
+    // still serialized as sparse
+    for (int i = 750; i < 4000; ++i) {
+        merged_hll.update(hash(i));
+        expected_hll.update(hash(i));
+    }
+    EXPECT_GE(merged_hll.memory_consumed(), HLL_REGISTERS_COUNT);
+    EXPECT_EQ(expected_hll.estimate_cardinality(), merged_hll.estimate_cardinality());
+    len = merged_hll.serialize(buf);
+    EXPECT_EQ(HLL_DATA_SPARSE, buf[0]);
+    EXPECT_EQ(len, expected_hll.serialize(other_buf));
+    EXPECT_EQ(0, memcmp(buf, other_buf, len));
+
+    // merge sparse into full
+    HyperLogLog full_hll;
+    for (int i = 0; i < 64 * 1024; ++i) {
+        full_hll.update(hash(i));
+    }
+    auto full_cardinality = full_hll.estimate_cardinality();
+    full_hll.merge(small_hll);
+    EXPECT_EQ(full_cardinality, full_hll.estimate_cardinality());
+}
+
 TEST_F(TestHll, InvalidPtr) {
     {
         HyperLogLog hll(Slice((char*)nullptr, 0));
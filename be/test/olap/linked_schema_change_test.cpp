@@ -0,0 +1,258 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include "olap/delete_handler.h"
+#include "olap/olap_define.h"
+#include "olap/options.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/beta_rowset.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/schema_change.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "olap/tuple_reader.h"
+#include "runtime/mem_pool.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static StorageEngine* k_engine = nullptr;
+
+// The rowsets of a tablet with a delete predicate are linked into the new tablet by the schema
+// change as long as the predicate is still valid on the new schema, and the rows deleted by it
+// are still filtered when reading the new tablet.
+class LinkedSchemaChangeTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        config::storage_root_path = std::string(buffer) + "/data_test";
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::create_dir(config::storage_root_path);
+        std::vector<StorePath> paths;
+        paths.emplace_back(config::storage_root_path, -1);
+
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &k_engine);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+    }
+
+    static void TearDownTestSuite() {
+        if (k_engine != nullptr) {
+            k_engine->stop();
+            delete k_engine;
+            k_engine = nullptr;
+        }
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::remove_all(std::string(getenv("DORIS_HOME")) + UNUSED_PREFIX);
+    }
+
+    void TearDown() override {
+        for (auto tablet_id : _tablet_ids) {
+            k_engine->tablet_manager()->drop_tablet(tablet_id);
+        }
+    }
+
+    // the INT columns of a DUP_KEYS tablet keyed by the first one, the columns of a new tablet
+    // altered from `base_tablet` keep their unique ids by their names
+    TabletSharedPtr create_tablet(int64_t tablet_id, const std::vector<std::string>& columns,
+                                  const TabletSharedPtr& base_tablet = nullptr) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.tablet_schema.schema_hash = 270068375;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = TKeysType::DUP_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        request.__set_storage_format(TStorageFormat::V2);
+        for (size_t i = 0; i < columns.size(); ++i) {
+            TColumn column;
+            column.column_name = columns[i];
+            column.__set_is_key(i == 0);
+            column.column_type.type = TPrimitiveType::INT;
+            column.__set_default_value("7");
+            request.tablet_schema.columns.push_back(column);
+        }
+        if (base_tablet != nullptr) {
+            request.__set_base_tablet_id(base_tablet->tablet_id());
+            request.__set_base_schema_hash(base_tablet->schema_hash());
+        }
+        EXPECT_TRUE(k_engine->create_tablet(request).ok());
+        _tablet_ids.push_back(tablet_id);
+        return k_engine->tablet_manager()->get_tablet(tablet_id);
+    }
+
+    // the rows of k1 in [0, 100) and the other columns of k1 * 10, or no rows but the delete
+    // predicate of the conditions
+    void add_rowset(const TabletSharedPtr& tablet, int64_t version,
+                    const std::vector<TCondition>& delete_conditions = {}) {
+        RowsetWriterContext context;
+        context.rowset_id = k_engine->next_rowset_id();
+        context.tablet_uid = tablet->tablet_uid();
+        context.tablet_id = tablet->tablet_id();
+        context.partition_id = tablet->partition_id();
+        context.tablet_schema_hash = tablet->schema_hash();
+        context.data_dir = tablet->data_dir();
+        context.rowset_type = BETA_ROWSET;
+        context.path_desc = tablet->tablet_path_desc();
+        context.tablet_schema = &tablet->tablet_schema();
+        context.rowset_state = VISIBLE;
+        context.version = Version(version, version);
+        context.segments_overlap = NONOVERLAPPING;
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        EXPECT_TRUE(RowsetFactory::create_rowset_writer(context, &rowset_writer).ok());
+
+        if (delete_conditions.empty()) {
+            RowCursor row;
+            EXPECT_TRUE(row.init(tablet->tablet_schema()).ok());
+            MemPool mem_pool("LinkedSchemaChangeTest");
+            for (int32_t k1 = 0; k1 < 100; ++k1) {
+                int32_t value = k1 * 10;
+                row.set_field_content(0, reinterpret_cast<char*>(&k1), &mem_pool);
+                for (size_t i = 1; i < tablet->num_columns(); ++i) {
+                    row.set_field_content(i, reinterpret_cast<char*>(&value), &mem_pool);
+                }
+                EXPECT_TRUE(rowset_writer->add_row(row).ok());
+            }
+            EXPECT_TRUE(rowset_writer->flush().ok());
+        }
+        RowsetSharedPtr rowset = rowset_writer->build();
+        ASSERT_NE(nullptr, rowset);
+        if (!delete_conditions.empty()) {
+            DeletePredicatePB delete_predicate;
+            DeleteConditionHandler handler;
+            EXPECT_TRUE(handler.generate_delete_predicate(tablet->tablet_schema(),
+                                                          delete_conditions, &delete_predicate)
+                                .ok());
+            rowset->rowset_meta()->set_delete_predicate(delete_predicate);
+        }
+        EXPECT_TRUE(tablet->add_rowset(rowset).ok());
+    }
+
+    static std::vector<TCondition> less_than(const std::string& column, const std::string& value) {
+        TCondition condition;
+        condition.column_name = column;
+        condition.condition_op = "<";
+        condition.condition_values.push_back(value);
+        return {condition};
+    }
+
+    Status alter_tablet(const TabletSharedPtr& base_tablet, const TabletSharedPtr& new_tablet) {
+        TAlterTabletReqV2 request;
+        request.base_tablet_id = base_tablet->tablet_id();
+        request.new_tablet_id = new_tablet->tablet_id();
+        request.base_schema_hash = base_tablet->schema_hash();
+        request.new_schema_hash = new_tablet->schema_hash();
+        request.__set_alter_version(3);
+        return SchemaChangeHandler::instance()->process_alter_tablet_v2(request);
+    }
+
+    // the rows of the versions [0, 3] as the queries read them, as "k1|v1|..."
+    static std::vector<std::string> read_rows(const TabletSharedPtr& tablet) {
+        TabletReader::ReaderParams params;
+        params.tablet = tablet;
+        params.reader_type = READER_QUERY;
+        params.version = Version(0, 3);
+        EXPECT_TRUE(tablet->capture_rs_readers(params.version, &params.rs_readers).ok());
+        for (uint32_t i = 0; i < tablet->num_columns(); ++i) {
+            params.return_columns.push_back(i);
+        }
+        TupleReader reader;
+        EXPECT_TRUE(reader.init(params).ok());
+
+        RowCursor row;
+        EXPECT_TRUE(row.init(tablet->tablet_schema(), params.return_columns).ok());
+        MemPool mem_pool("LinkedSchemaChangeTest");
+        ObjectPool agg_pool;
+        std::vector<std::string> rows;
+        bool eof = false;
+        while (reader.next_row_with_aggregation(&row, &mem_pool, &agg_pool, &eof).ok() && !eof) {
+            std::string str;
+            for (uint32_t i = 0; i < tablet->num_columns(); ++i) {
+                str += (i == 0 ? "" : "|") +
+                       std::to_string(*reinterpret_cast<const int32_t*>(row.cell_ptr(i)));
+            }
+            rows.push_back(std::move(str));
+        }
+        EXPECT_TRUE(eof);
+        return rows;
+    }
+
+    // the inode of the segment of the version, which is shared by the linked rowsets
+    static ino_t segment_inode(const TabletSharedPtr& tablet, int64_t version) {
+        RowsetSharedPtr rowset = tablet->get_rowset_by_version(Version(version, version));
+        EXPECT_NE(nullptr, rowset);
+        EXPECT_EQ(1, rowset->num_segments());
+        std::string path = BetaRowset::segment_file_path(rowset->rowset_path_desc(),
+                                                         rowset->rowset_id(), 0)
+                                   .filepath;
+        struct stat st;
+        EXPECT_EQ(0, stat(path.c_str(), &st)) << path;
+        return st.st_ino;
+    }
+
+    std::vector<int64_t> _tablet_ids;
+};
+
+TEST_F(LinkedSchemaChangeTest, add_column) {
+    auto base_tablet = create_tablet(10005, {"k1", "v1"});
+    add_rowset(base_tablet, 2);
+    add_rowset(base_tablet, 3, less_than("k1", "30"));
+
+    auto new_tablet = create_tablet(10006, {"k1", "v1", "v2"}, base_tablet);
+    EXPECT_TRUE(alter_tablet(base_tablet, new_tablet).ok());
+    // the segment is linked, and the delete predicate is kept at its version
+    EXPECT_EQ(segment_inode(base_tablet, 2), segment_inode(new_tablet, 2));
+    ASSERT_EQ(1, new_tablet->delete_predicates().size());
+    EXPECT_EQ(3, new_tablet->delete_predicates()[0].version());
+
+    std::vector<std::string> expected;
+    for (int k1 = 30; k1 < 100; ++k1) {
+        expected.push_back(std::to_string(k1) + "|" + std::to_string(k1 * 10) + "|7");
+    }
+    EXPECT_EQ(expected, read_rows(new_tablet));
+}
+
+TEST_F(LinkedSchemaChangeTest, drop_deleted_column) {
+    auto base_tablet = create_tablet(10007, {"k1", "v1", "v2"});
+    add_rowset(base_tablet, 2);
+    add_rowset(base_tablet, 3, less_than("v1", "300"));
+
+    // the delete predicate on the dropped column is invalid on the new schema, so the rows are
+    // rewritten without the deleted ones
+    auto new_tablet = create_tablet(10008, {"k1", "v2"}, base_tablet);
+    EXPECT_TRUE(alter_tablet(base_tablet, new_tablet).ok());
+    EXPECT_NE(segment_inode(base_tablet, 2), segment_inode(new_tablet, 2));
+    EXPECT_EQ(0, new_tablet->delete_predicates().size());
+
+    std::vector<std::string> expected;
+    for (int k1 = 30; k1 < 100; ++k1) {
+        expected.push_back(std::to_string(k1) + "|" + std::to_string(k1 * 10));
+    }
+    EXPECT_EQ(expected, read_rows(new_tablet));
+}
+
+} // namespace doris
@@ -259,6 +259,79 @@ TEST_F(CacheTest, Usage) {
     EXPECT_EQ(1048, cache.get_usage()); // 996 + 950 + 95 +3 - (200 + 600 + (95 + 3) * 2)
 }
 
+static bool lookup_LRUCache(LRUCache& cache, const CacheKey& key) {
+    uint32_t hash = key.hash(key.data(), key.size(), 0);
+    Cache::Handle* handle = cache.lookup(key, hash);
+    cache.release(handle);
+    return handle != nullptr;
+}
+
+TEST_F(CacheTest, SLRUScanResistance) {
+    for (auto policy : {LRUCachePolicy::LRU, LRUCachePolicy::SLRU}) {
+        LRUCache cache(LRUCacheType::SIZE, policy);
+        cache.set_capacity(1000);
+        cache.set_protected_capacity(600);
+
+        // the hot entries are read twice
+        CacheKey hot1("h1");
+        CacheKey hot2("h2");
+        insert_LRUCache(cache, hot1, 100, CachePriority::NORMAL);
+        insert_LRUCache(cache, hot2, 100, CachePriority::NORMAL);
+        EXPECT_TRUE(lookup_LRUCache(cache, hot1));
+        EXPECT_TRUE(lookup_LRUCache(cache, hot2));
+
+        // a scan reads many entries only once
+        for (int i = 0; i < 20; ++i) {
+            insert_LRUCache(cache, CacheKey("s" + std::to_string(i)), 100, CachePriority::NORMAL);
+        }
+        EXPECT_LE(cache.get_usage(), 1000);
+
+        bool is_slru = policy == LRUCachePolicy::SLRU;
+        EXPECT_EQ(is_slru, lookup_LRUCache(cache, hot1));
+        EXPECT_EQ(is_slru, lookup_LRUCache(cache, hot2));
+        EXPECT_EQ(is_slru ? 2 : 0, cache.get_protected_hit_count());
+        EXPECT_EQ(is_slru ? 394 : 0, cache.get_protected_usage()); // (100 + 95 + 2) * 2
+    }
+}
+
+TEST_F(CacheTest, SLRUDemote) {
+    LRUCache cache(LRUCacheType::SIZE, LRUCachePolicy::SLRU);
+    cache.set_capacity(1000);
+    // only one entry fits in the protected segment
+    cache.set_protected_capacity(200);
+
+    CacheKey key1("1");
+    CacheKey key2("2");
+    CacheKey key3("3");
+    insert_LRUCache(cache, key1, 100, CachePriority::NORMAL);
+    insert_LRUCache(cache, key2, 100, CachePriority::NORMAL);
+    EXPECT_EQ(0, cache.get_protected_usage());
+
+    EXPECT_TRUE(lookup_LRUCache(cache, key1));
+    EXPECT_EQ(196, cache.get_protected_usage());
+
+    // key1 is demoted to the head of probationary segment
+    EXPECT_TRUE(lookup_LRUCache(cache, key2));
+    EXPECT_EQ(196, cache.get_protected_usage());
+
+    // the probationary segment is evicted first: key3 evicts nothing, key4 evicts key1,
+    // key5 evicts key3, key2 is kept in the protected segment
+    insert_LRUCache(cache, key3, 300, CachePriority::NORMAL);
+    insert_LRUCache(cache, CacheKey("4"), 300, CachePriority::NORMAL);
+    EXPECT_FALSE(lookup_LRUCache(cache, key1));
+    insert_LRUCache(cache, CacheKey("5"), 300, CachePriority::NORMAL);
+    EXPECT_FALSE(lookup_LRUCache(cache, key3));
+    EXPECT_TRUE(lookup_LRUCache(cache, key2));
+    EXPECT_EQ(1, cache.get_protected_hit_count());
+
+    // the protected entry leaves the segment when erased
+    uint32_t hash = key2.hash(key2.data(), key2.size(), 0);
+    cache.erase(key2, hash);
+    EXPECT_EQ(0, cache.get_protected_usage());
+    EXPECT_EQ(2, cache.prune());
+    EXPECT_EQ(0, cache.get_usage());
+}
+
 TEST_F(CacheTest, Prune) {
     LRUCache cache(LRUCacheType::NUMBER);
     cache.set_capacity(5);
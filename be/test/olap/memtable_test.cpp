@@ -0,0 +1,264 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/memtable.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+
+#include "common/config.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/schema.h"
+#include "olap/tablet_schema.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris {
+
+// keeps the rows of the blocks flushed by the memtable, as "k1|k2|v1|v2"
+class FlushedRowsWriter : public RowsetWriter {
+public:
+    Status init(const RowsetWriterContext& rowset_writer_context) override { return Status::OK(); }
+    Status add_row(const RowCursor& row) override { return Status::OK(); }
+    Status add_row(const ContiguousRow& row) override { return Status::OK(); }
+    Status add_rowset(RowsetSharedPtr rowset) override { return Status::OK(); }
+    Status add_rowset_for_linked_schema_change(RowsetSharedPtr rowset,
+                                               const SchemaMapping& schema_mapping) override {
+        return Status::OK();
+    }
+    Status add_rowset_for_migration(RowsetSharedPtr rowset) override { return Status::OK(); }
+    Status flush() override { return Status::OK(); }
+
+    Status flush_single_block(const vectorized::Block* block, int64_t* flush_size) override {
+        for (size_t i = 0; i < block->rows(); ++i) {
+            std::string row;
+            for (size_t j = 0; j < block->columns(); ++j) {
+                const auto& column = block->get_by_position(j);
+                row += (j == 0 ? "" : "|") + column.type->to_string(*column.column, i);
+            }
+            rows.push_back(std::move(row));
+        }
+        *flush_size = block->allocated_bytes();
+        return Status::OK();
+    }
+
+    RowsetSharedPtr build() override { return nullptr; }
+    Version version() override { return Version(); }
+    int64_t num_rows() override { return rows.size(); }
+    RowsetId rowset_id() override { return RowsetId(); }
+    RowsetTypePB type() const override { return BETA_ROWSET; }
+
+    std::vector<std::string> rows;
+};
+
+// (k1 int null, k2 varchar(20) null, v1 bigint [sum], v2 int null [replace]) of the keys type
+class MemTableTest : public testing::Test {
+protected:
+    void TearDown() override {
+        config::enable_memtable_batch_sort = _batch_sort;
+        config::enable_memtable_hash_aggregation = _hash_aggregation;
+        config::enable_memtable_ordered_append = _ordered_append;
+    }
+
+    void create_tablet_schema(KeysType keys_type) {
+        TabletSchemaPB tablet_schema_pb;
+        tablet_schema_pb.set_keys_type(keys_type);
+        tablet_schema_pb.set_num_short_key_columns(2);
+        tablet_schema_pb.set_num_rows_per_row_block(1024);
+        tablet_schema_pb.set_compress_kind(COMPRESS_NONE);
+        tablet_schema_pb.set_next_column_unique_id(5);
+        auto add_column = [&](const std::string& name, const std::string& type, int length,
+                              bool is_key, bool is_nullable, const std::string& aggregation) {
+            ColumnPB* column = tablet_schema_pb.add_column();
+            column->set_unique_id(tablet_schema_pb.column_size());
+            column->set_name(name);
+            column->set_type(type);
+            column->set_is_key(is_key);
+            column->set_length(length);
+            column->set_index_length(length);
+            column->set_is_nullable(is_nullable);
+            column->set_is_bf_column(false);
+            if (keys_type == AGG_KEYS && !is_key) {
+                column->set_aggregation(aggregation);
+            }
+        };
+        add_column("k1", "INT", 4, true, true, "");
+        add_column("k2", "VARCHAR", 20, true, true, "");
+        add_column("v1", "BIGINT", 8, false, false, "SUM");
+        add_column("v2", "INT", 4, false, true, "REPLACE");
+        _tablet_schema.init_from_pb(tablet_schema_pb);
+        _schema = std::make_unique<Schema>(_tablet_schema);
+    }
+
+    // The keys of the rows from `disorder_from` on are scattered, the rows before it are in the
+    // order of the keys, with the nulls first. Several rows share a key in both parts.
+    static vectorized::Block input_block(int rows, int disorder_from) {
+        auto k1 = vectorized::ColumnInt32::create();
+        auto k1_null_map = vectorized::ColumnUInt8::create();
+        auto k2 = vectorized::ColumnString::create();
+        auto k2_null_map = vectorized::ColumnUInt8::create();
+        auto v1 = vectorized::ColumnInt64::create();
+        auto v2 = vectorized::ColumnInt32::create();
+        auto v2_null_map = vectorized::ColumnUInt8::create();
+        for (int i = 0; i < rows; ++i) {
+            std::optional<int32_t> key1;
+            std::optional<std::string> key2;
+            if (i < disorder_from) {
+                key1 = i < 5 ? std::nullopt : std::optional<int32_t>(i / 6);
+                key2 = i % 6 < 2 ? std::nullopt : std::optional<std::string>(i % 6 < 4 ? "a" : "b");
+            } else {
+                key1 = i % 13 == 0 ? std::nullopt : std::optional<int32_t>(i * 7 % 37);
+                key2 = i % 5 == 0 ? std::nullopt
+                                  : std::optional<std::string>("s" + std::to_string(i * 3 % 4));
+            }
+            k1->insert_value(key1.value_or(0));
+            k1_null_map->insert_value(!key1.has_value());
+            std::string str = key2.value_or("");
+            k2->insert_data(str.data(), str.size());
+            k2_null_map->insert_value(!key2.has_value());
+            v1->insert_value(i);
+            v2->insert_value(i % 100);
+            v2_null_map->insert_value(i % 9 == 0);
+        }
+
+        auto int_type = vectorized::make_nullable(std::make_shared<vectorized::DataTypeInt32>());
+        auto string_type =
+                vectorized::make_nullable(std::make_shared<vectorized::DataTypeString>());
+        return vectorized::Block(
+                {{vectorized::ColumnNullable::create(std::move(k1), std::move(k1_null_map)),
+                  int_type, "k1"},
+                 {vectorized::ColumnNullable::create(std::move(k2), std::move(k2_null_map)),
+                  string_type, "k2"},
+                 {std::move(v1), std::make_shared<vectorized::DataTypeInt64>(), "v1"},
+                 {vectorized::ColumnNullable::create(std::move(v2), std::move(v2_null_map)),
+                  int_type, "v2"}});
+    }
+
+    std::unique_ptr<MemTable> create_memtable() {
+        return std::make_unique<MemTable>(10, _schema.get(), &_tablet_schema, nullptr, nullptr,
+                                          _tablet_schema.keys_type(), &_writer, nullptr, true);
+    }
+
+    // insert the rows by the ranges of 100 rows, and flush them
+    std::vector<std::string> insert_and_flush(MemTable* memtable, const vectorized::Block& block) {
+        for (size_t row = 0; row < block.rows(); row += 100) {
+            memtable->insert(&block, row, std::min<size_t>(100, block.rows() - row));
+        }
+        _writer.rows.clear();
+        EXPECT_TRUE(memtable->flush().ok());
+        return _writer.rows;
+    }
+
+    // the rows flushed by the skiplist
+    std::vector<std::string> skiplist_rows(const vectorized::Block& block) {
+        config::enable_memtable_batch_sort = false;
+        config::enable_memtable_hash_aggregation = false;
+        config::enable_memtable_ordered_append = false;
+        auto memtable = create_memtable();
+        EXPECT_NE(nullptr, memtable->_vec_skip_list);
+        return insert_and_flush(memtable.get(), block);
+    }
+
+    // "k1|k2" of the row "k1|k2|v1|v2"
+    static std::string sort_key(const std::string& row) {
+        return row.substr(0, row.find('|', row.find('|') + 1));
+    }
+
+    // The rows of DUP_KEYS with the same key may be in any order, so only their keys are
+    // compared in order.
+    static void expect_same_rows(const std::vector<std::string>& expected,
+                                 std::vector<std::string> rows, KeysType keys_type) {
+        ASSERT_EQ(expected.size(), rows.size());
+        if (keys_type != DUP_KEYS) {
+            EXPECT_EQ(expected, rows);
+            return;
+        }
+        for (size_t i = 0; i < rows.size(); ++i) {
+            EXPECT_EQ(sort_key(expected[i]), sort_key(rows[i])) << "row " << i;
+        }
+        auto sorted_expected = expected;
+        std::sort(sorted_expected.begin(), sorted_expected.end());
+        std::sort(rows.begin(), rows.end());
+        EXPECT_EQ(sorted_expected, rows);
+    }
+
+    TabletSchema _tablet_schema;
+    std::unique_ptr<Schema> _schema;
+    FlushedRowsWriter _writer;
+    bool _batch_sort = config::enable_memtable_batch_sort;
+    bool _hash_aggregation = config::enable_memtable_hash_aggregation;
+    bool _ordered_append = config::enable_memtable_ordered_append;
+};
+
+TEST_F(MemTableTest, batch_sort) {
+    create_tablet_schema(DUP_KEYS);
+    for (int disorder_from : {0, 700, 1000}) {
+        auto block = input_block(1000, disorder_from);
+        auto expected = skiplist_rows(block);
+
+        config::enable_memtable_batch_sort = true;
+        auto memtable = create_memtable();
+        EXPECT_TRUE(memtable->_is_batch_sort);
+        EXPECT_EQ(nullptr, memtable->_vec_skip_list);
+        expect_same_rows(expected, insert_and_flush(memtable.get(), block), DUP_KEYS);
+    }
+}
+
+TEST_F(MemTableTest, hash_aggregation) {
+    create_tablet_schema(AGG_KEYS);
+    for (int disorder_from : {0, 700, 1000}) {
+        auto block = input_block(1000, disorder_from);
+        auto expected = skiplist_rows(block);
+        // the rows of the same key are aggregated
+        EXPECT_LT(expected.size(), block.rows() * 2 / 3);
+
+        config::enable_memtable_hash_aggregation = true;
+        auto memtable = create_memtable();
+        EXPECT_TRUE(memtable->_is_hash_agg);
+        EXPECT_EQ(nullptr, memtable->_vec_skip_list);
+        expect_same_rows(expected, insert_and_flush(memtable.get(), block), AGG_KEYS);
+    }
+}
+
+TEST_F(MemTableTest, ordered_append) {
+    // the ordered rows are moved into the skiplist or the hash table once a row is out of order
+    for (auto [keys_type, hash_aggregation] :
+         std::vector<std::pair<KeysType, bool>> {{DUP_KEYS, false}, {AGG_KEYS, false},
+                                                 {AGG_KEYS, true}}) {
+        create_tablet_schema(keys_type);
+        for (int disorder_from : {0, 700, 1000}) {
+            auto block = input_block(1000, disorder_from);
+            auto expected = skiplist_rows(block);
+
+            config::enable_memtable_hash_aggregation = hash_aggregation;
+            config::enable_memtable_ordered_append = true;
+            auto memtable = create_memtable();
+            auto rows = insert_and_flush(memtable.get(), block);
+            EXPECT_EQ(disorder_from == 1000, memtable->_in_order);
+            EXPECT_EQ(hash_aggregation, memtable->_is_hash_agg);
+            expect_same_rows(expected, rows, keys_type);
+        }
+    }
+}
+
+} // namespace doris
@@ -0,0 +1,372 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/merger.h"
+
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "gen_cpp/AgentService_types.h"
+#include "olap/compaction.h"
+#include "olap/row_cursor.h"
+#include "olap/rowset/rowset_factory.h"
+#include "olap/rowset/rowset_writer.h"
+#include "olap/rowset/rowset_writer_context.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet.h"
+#include "runtime/exec_env.h"
+#include "runtime/mem_pool.h"
+#include "util/file_utils.h"
+#include "vec/core/block.h"
+#include "vec/exec/volap_scan_node.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+
+static StorageEngine* k_engine = nullptr;
+static std::string k_storage_root_path;
+
+// keeps the rows of the blocks merged into it, as "k1|v1"
+class MergedRowsWriter : public RowsetWriter {
+public:
+    explicit MergedRowsWriter(Version version) : _version(version) {}
+
+    Status init(const RowsetWriterContext& rowset_writer_context) override { return Status::OK(); }
+    Status add_row(const RowCursor& row) override { return Status::OK(); }
+    Status add_row(const ContiguousRow& row) override { return Status::OK(); }
+    Status add_rowset(RowsetSharedPtr rowset) override { return Status::OK(); }
+    Status add_rowset_for_linked_schema_change(RowsetSharedPtr rowset,
+                                               const SchemaMapping& schema_mapping) override {
+        return Status::OK();
+    }
+    Status add_rowset_for_migration(RowsetSharedPtr rowset) override { return Status::OK(); }
+    Status flush() override { return Status::OK(); }
+
+    Status add_block(const vectorized::Block* block) override {
+        for (size_t i = 0; i < block->rows(); ++i) {
+            std::string row;
+            for (size_t j = 0; j < block->columns(); ++j) {
+                const auto& column = block->get_by_position(j);
+                row += (j == 0 ? "" : "|") + column.type->to_string(*column.column, i);
+            }
+            rows.push_back(std::move(row));
+        }
+        return Status::OK();
+    }
+
+    RowsetSharedPtr build() override { return nullptr; }
+    Version version() override { return _version; }
+    int64_t num_rows() override { return rows.size(); }
+    RowsetId rowset_id() override { return RowsetId(); }
+    RowsetTypePB type() const override { return BETA_ROWSET; }
+
+    std::vector<std::string> rows;
+
+private:
+    Version _version;
+};
+
+// Compact the given rowsets of the tablet as a cumulative compaction
+class TestCompaction : public Compaction {
+public:
+    TestCompaction(TabletSharedPtr tablet, std::vector<RowsetSharedPtr> input_rowsets)
+            : Compaction(tablet, "TestCompaction") {
+        _input_rowsets = std::move(input_rowsets);
+    }
+
+    Status prepare_compact() override { return Status::OK(); }
+
+    Status execute_compact_impl() override { return do_compaction_impl(1); }
+
+    RowsetSharedPtr output_rowset() const { return _output_rowset; }
+
+protected:
+    Status pick_rowsets_to_compact() override { return Status::OK(); }
+
+    std::string compaction_name() const override { return "test compaction"; }
+
+    ReaderType compaction_type() const override { return ReaderType::READER_CUMULATIVE_COMPACTION; }
+};
+
+// The rows merged by the key ranges split from the short keys are those merged at once, even
+// the string keys larger than any bound of a string type.
+class MergerTest : public testing::Test {
+public:
+    static void SetUpTestSuite() {
+        config::min_file_descriptor_number = 1000;
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        k_storage_root_path = std::string(buffer) + "/data_merger_test";
+        config::storage_root_path = k_storage_root_path;
+        EXPECT_TRUE(FileUtils::remove_all(k_storage_root_path).ok());
+        EXPECT_TRUE(FileUtils::create_dir(k_storage_root_path).ok());
+
+        std::vector<StorePath> paths;
+        paths.emplace_back(k_storage_root_path, -1);
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &k_engine);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        ExecEnv::GetInstance()->set_storage_engine(k_engine);
+    }
+
+    static void TearDownTestSuite() {
+        if (k_engine != nullptr) {
+            k_engine->stop();
+            delete k_engine;
+            k_engine = nullptr;
+        }
+        EXPECT_TRUE(FileUtils::remove_all(k_storage_root_path).ok());
+    }
+
+protected:
+    void TearDown() override {
+        config::enable_vectorized_compaction = _vectorized_compaction;
+        config::compaction_key_range_parallelism = _key_range_parallelism;
+        config::compaction_key_range_bytes = _key_range_bytes;
+        config::doris_scan_range_row_count = _scan_range_row_count;
+        config::doris_scan_range_split_keys_per_segment = _split_keys_per_segment;
+    }
+
+    // (k1 varchar(20) null, v1 int sum), aggregate key (k1), or (k1 varchar(20) null, v1 int)
+    // unique key (k1) of merge-on-read
+    TabletSharedPtr create_tablet(int64_t tablet_id, bool unique_key = false) {
+        TCreateTabletReq request;
+        request.tablet_id = tablet_id;
+        request.__set_version(1);
+        request.tablet_schema.schema_hash = 1111;
+        request.tablet_schema.short_key_column_count = 1;
+        request.tablet_schema.keys_type = unique_key ? TKeysType::UNIQUE_KEYS : TKeysType::AGG_KEYS;
+        request.tablet_schema.storage_type = TStorageType::COLUMN;
+        request.__set_storage_format(TStorageFormat::V2);
+
+        TColumn k1;
+        k1.column_name = "k1";
+        k1.__set_is_key(true);
+        k1.column_type.type = TPrimitiveType::VARCHAR;
+        k1.column_type.__set_len(20);
+        k1.__set_is_allow_null(true);
+        request.tablet_schema.columns.push_back(k1);
+
+        TColumn v1;
+        v1.column_name = "v1";
+        v1.__set_is_key(false);
+        v1.column_type.type = TPrimitiveType::INT;
+        v1.__set_aggregation_type(unique_key ? TAggregationType::REPLACE : TAggregationType::SUM);
+        request.tablet_schema.columns.push_back(v1);
+
+        Status s = k_engine->create_tablet(request);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        return k_engine->tablet_manager()->get_tablet(tablet_id, 1111);
+    }
+
+    // Write a rowset of the version with the keys in order and v1 = 1, the keys of the rowsets
+    // overlap. The keys starting with 0xFF are larger than "\xFF", which is not the max string.
+    RowsetSharedPtr write_rowset(const TabletSharedPtr& tablet, int64_t version) {
+        std::vector<std::optional<std::string>> keys(5, std::nullopt);
+        for (int i = 0; i < 5000; ++i) {
+            char key[16];
+            snprintf(key, sizeof(key), "k%05d", i * 3 + static_cast<int>(version));
+            keys.emplace_back(key);
+        }
+        for (const char* key : {"\xFF", "\xFF\x01", "\xFF\xFF", "\xFF\xFFz"}) {
+            for (int i = 0; i < 300; ++i) {
+                keys.emplace_back(key);
+            }
+        }
+
+        RowsetWriterContext context;
+        context.rowset_id = k_engine->next_rowset_id();
+        context.tablet_uid = tablet->tablet_uid();
+        context.tablet_id = tablet->tablet_id();
+        context.partition_id = tablet->partition_id();
+        context.tablet_schema_hash = tablet->schema_hash();
+        context.data_dir = tablet->data_dir();
+        context.rowset_type = BETA_ROWSET;
+        context.path_desc = tablet->tablet_path_desc();
+        context.tablet_schema = &tablet->tablet_schema();
+        context.rowset_state = VISIBLE;
+        context.version = Version(version, version);
+        context.segments_overlap = NONOVERLAPPING;
+
+        std::unique_ptr<RowsetWriter> writer;
+        EXPECT_TRUE(RowsetFactory::create_rowset_writer(context, &writer).ok());
+        RowCursor row;
+        EXPECT_TRUE(row.init(tablet->tablet_schema()).ok());
+        MemPool pool("MergerTest");
+        for (auto& key : keys) {
+            if (key.has_value()) {
+                Slice slice(*key);
+                row.set_not_null(0);
+                row.set_field_content(0, reinterpret_cast<char*>(&slice), &pool);
+            } else {
+                row.set_null(0);
+            }
+            int32_t v1 = 1;
+            row.set_field_content(1, reinterpret_cast<char*>(&v1), &pool);
+            EXPECT_TRUE(writer->add_row(row).ok());
+        }
+        EXPECT_TRUE(writer->flush().ok());
+        RowsetSharedPtr rowset = writer->build();
+        EXPECT_NE(nullptr, rowset);
+        EXPECT_TRUE(tablet->add_rowset(rowset).ok());
+        return rowset;
+    }
+
+    // the rows of the rowsets merged in the key range, or all the rows if it's nullptr
+    static std::vector<std::string> merge_rows(const TabletSharedPtr& tablet,
+                                               const std::vector<RowsetSharedPtr>& rowsets,
+                                               const Merger::KeyRange* key_range = nullptr) {
+        std::vector<RowsetReaderSharedPtr> rs_readers;
+        for (auto& rowset : rowsets) {
+            RowsetReaderSharedPtr rs_reader;
+            EXPECT_TRUE(rowset->create_reader(&rs_reader).ok());
+            rs_readers.push_back(std::move(rs_reader));
+        }
+        MergedRowsWriter writer(
+                Version(rowsets.front()->start_version(), rowsets.back()->end_version()));
+        Merger::Statistics stats;
+        Status s = Merger::vmerge_rowsets(tablet, ReaderType::READER_CUMULATIVE_COMPACTION,
+                                          rs_readers, &writer, &stats, key_range);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        EXPECT_EQ(writer.rows.size(), stats.output_rows);
+        return writer.rows;
+    }
+
+    bool _vectorized_compaction = config::enable_vectorized_compaction;
+    int32_t _key_range_parallelism = config::compaction_key_range_parallelism;
+    int64_t _key_range_bytes = config::compaction_key_range_bytes;
+    int32_t _scan_range_row_count = config::doris_scan_range_row_count;
+    int32_t _split_keys_per_segment = config::doris_scan_range_split_keys_per_segment;
+};
+
+TEST_F(MergerTest, split_key_ranges) {
+    TabletSharedPtr tablet = create_tablet(30001);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> rowsets = {write_rowset(tablet, 2), write_rowset(tablet, 3),
+                                            write_rowset(tablet, 4)};
+    auto expected = merge_rows(tablet, rowsets);
+    // the null key, the "k" keys of [2, 15002) and the 4 keys of 0xFF
+    ASSERT_EQ(1 + 15000 + 4, expected.size());
+    EXPECT_EQ("\xFF\xFFz|900", expected.back());
+
+    for (int num_ranges : {1, 2, 4, 8}) {
+        std::vector<Merger::KeyRange> key_ranges;
+        ASSERT_TRUE(Merger::split_key_ranges(tablet->tablet_schema(), rowsets, num_ranges,
+                                             &key_ranges)
+                            .ok());
+        ASSERT_GE(key_ranges.size(), 1);
+        EXPECT_LE(key_ranges.size(), num_ranges);
+        if (num_ranges > 1) {
+            EXPECT_GT(key_ranges.size(), 1);
+        }
+        // only the last range has no upper bound
+        for (size_t i = 0; i + 1 < key_ranges.size(); ++i) {
+            EXPECT_EQ(1, key_ranges[i].end.size());
+        }
+        EXPECT_EQ(0, key_ranges.back().end.size());
+
+        std::vector<std::string> rows;
+        for (auto& key_range : key_ranges) {
+            auto range_rows = merge_rows(tablet, rowsets, &key_range);
+            rows.insert(rows.end(), range_rows.begin(), range_rows.end());
+        }
+        EXPECT_EQ(expected, rows) << "num_ranges=" << num_ranges;
+    }
+}
+
+TEST_F(MergerTest, split_key_ranges_sampled) {
+    TabletSharedPtr tablet = create_tablet(30003);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> rowsets = {write_rowset(tablet, 2), write_rowset(tablet, 3),
+                                            write_rowset(tablet, 4)};
+    auto expected = merge_rows(tablet, rowsets);
+
+    // the segments have 7 short keys each
+    for (size_t max_keys_per_segment : {1, 2, 3, 100}) {
+        std::vector<Merger::KeyRange> key_ranges;
+        ASSERT_TRUE(Merger::split_key_ranges(tablet->tablet_schema(), rowsets, 8, &key_ranges,
+                                             max_keys_per_segment)
+                            .ok());
+        ASSERT_GE(key_ranges.size(), 1);
+        EXPECT_LE(key_ranges.size(), std::min<size_t>(8, max_keys_per_segment * 3 + 1));
+        EXPECT_EQ(0, key_ranges.back().end.size());
+
+        std::vector<std::string> rows;
+        for (auto& key_range : key_ranges) {
+            auto range_rows = merge_rows(tablet, rowsets, &key_range);
+            rows.insert(rows.end(), range_rows.begin(), range_rows.end());
+        }
+        EXPECT_EQ(expected, rows) << "max_keys_per_segment=" << max_keys_per_segment;
+    }
+}
+
+TEST_F(MergerTest, split_tablet_scan_key_ranges) {
+    TabletSharedPtr tablet = create_tablet(30004, true);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> rowsets = {write_rowset(tablet, 2), write_rowset(tablet, 3),
+                                            write_rowset(tablet, 4)};
+    auto expected = merge_rows(tablet, rowsets);
+
+    config::doris_scan_range_row_count = 1000;
+    config::doris_scan_range_split_keys_per_segment = 2;
+    std::vector<std::unique_ptr<OlapScanRange>> ranges;
+    ASSERT_TRUE(vectorized::VOlapScanNode::_split_tablet_key_ranges(tablet, 4, 8, &ranges).ok());
+    ASSERT_GT(ranges.size(), 1);
+    EXPECT_LE(ranges.size(), 2 * 3 + 1);
+
+    // the ranges are [start, end) but the last one, which has no end
+    std::vector<std::string> rows;
+    for (size_t i = 0; i < ranges.size(); ++i) {
+        EXPECT_TRUE(ranges[i]->begin_include);
+        EXPECT_FALSE(ranges[i]->end_include);
+        EXPECT_EQ(i + 1 < ranges.size() ? 1 : 0, ranges[i]->end_scan_range.size());
+        Merger::KeyRange key_range {ranges[i]->begin_scan_range, ranges[i]->end_scan_range};
+        auto range_rows = merge_rows(tablet, rowsets, &key_range);
+        rows.insert(rows.end(), range_rows.begin(), range_rows.end());
+    }
+    EXPECT_EQ(expected, rows);
+}
+
+TEST_F(MergerTest, parallel_merge) {
+    TabletSharedPtr tablet = create_tablet(30002);
+    ASSERT_NE(nullptr, tablet);
+    std::vector<RowsetSharedPtr> rowsets = {write_rowset(tablet, 2), write_rowset(tablet, 3),
+                                            write_rowset(tablet, 4)};
+    auto expected = merge_rows(tablet, rowsets);
+
+    config::enable_vectorized_compaction = true;
+    config::compaction_key_range_parallelism = 4;
+    config::compaction_key_range_bytes = 1;
+    TestCompaction compaction(tablet, rowsets);
+    Status s = compaction.compact();
+    ASSERT_TRUE(s.ok()) << s.to_string();
+    RowsetSharedPtr output = compaction.output_rowset();
+    ASSERT_NE(nullptr, output);
+    EXPECT_EQ(Version(2, 4), output->version());
+    // a segment for each key range, and the rows of the ranges in order
+    EXPECT_GT(output->num_segments(), 1);
+    EXPECT_EQ(expected.size(), output->num_rows());
+    EXPECT_EQ(expected, merge_rows(tablet, {output}));
+}
+
+} // namespace doris
@@ -22,6 +22,9 @@
 #include <filesystem>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "olap/olap_define.h"
 #include "util/file_utils.h"
@@ -78,6 +81,53 @@ TEST_F(OlapMetaTest, TestPutAndGet) {
     EXPECT_EQ(Status::OLAPInternalError(OLAP_ERR_META_KEY_NOT_FOUND), s);
 }
 
+TEST_F(OlapMetaTest, TestBatchPut) {
+    std::vector<std::pair<std::string, std::string>> entries;
+    for (int i = 0; i < 10; i++) {
+        entries.emplace_back("batch_key_" + std::to_string(i), "value_" + std::to_string(i));
+    }
+    Status s = _meta->put(META_COLUMN_FAMILY_INDEX, entries);
+    EXPECT_EQ(Status::OK(), s);
+    for (const auto& [key, value] : entries) {
+        std::string value_get;
+        s = _meta->get(META_COLUMN_FAMILY_INDEX, key, &value_get);
+        EXPECT_EQ(Status::OK(), s);
+        EXPECT_EQ(value, value_get);
+    }
+}
+
+TEST_F(OlapMetaTest, TestConcurrentPutAndRemove) {
+    // the concurrent writes are committed by the groups
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 8; i++) {
+        threads.emplace_back([this, i]() {
+            for (int j = 0; j < 100; j++) {
+                std::string key = "group_key_" + std::to_string(i) + "_" + std::to_string(j);
+                EXPECT_EQ(Status::OK(), _meta->put(META_COLUMN_FAMILY_INDEX, key, key));
+                if (j % 2 == 1) {
+                    EXPECT_EQ(Status::OK(), _meta->remove(META_COLUMN_FAMILY_INDEX, key));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (int i = 0; i < 8; i++) {
+        for (int j = 0; j < 100; j++) {
+            std::string key = "group_key_" + std::to_string(i) + "_" + std::to_string(j);
+            std::string value_get;
+            Status s = _meta->get(META_COLUMN_FAMILY_INDEX, key, &value_get);
+            if (j % 2 == 1) {
+                EXPECT_EQ(Status::OLAPInternalError(OLAP_ERR_META_KEY_NOT_FOUND), s);
+            } else {
+                EXPECT_EQ(Status::OK(), s);
+                EXPECT_EQ(key, value_get);
+            }
+        }
+    }
+}
+
 TEST_F(OlapMetaTest, TestRemove) {
     // normal cases
     std::string key = "key";
@@ -243,4 +243,28 @@ TEST(StoragePageCacheTest, mixed_pages) {
     }
 }
 
+// A part of the data page cache is allocated to the decoded pages
+TEST(StoragePageCacheTest, decoded_page) {
+    StoragePageCache cache(kNumShards * 4096, 0, 50);
+    EXPECT_TRUE(cache.is_decoded_cache_available());
+
+    StoragePageCache::CacheKey key("abc", 0);
+    {
+        char* buf = new char[1024];
+        PageCacheHandle handle;
+        cache.insert_decoded(key, Slice(buf, 1024), &handle);
+        EXPECT_EQ(buf, handle.data().data);
+    }
+    {
+        // the decoded page doesn't share the entries with the page
+        PageCacheHandle handle;
+        EXPECT_FALSE(cache.lookup(key, &handle, segment_v2::DATA_PAGE));
+        EXPECT_TRUE(cache.lookup_decoded(key, &handle));
+        EXPECT_EQ(1024, handle.data().size);
+    }
+
+    StoragePageCache no_decoded_cache(kNumShards * 2048, 10);
+    EXPECT_FALSE(no_decoded_cache.is_decoded_cache_available());
+}
+
 } // namespace doris
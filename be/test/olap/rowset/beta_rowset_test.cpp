@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "gen_cpp/olap_file.pb.h"
 #include "gtest/gtest.h"
 #include "olap/comparison_predicate.h"
@@ -28,6 +29,7 @@
 #include "olap/rowset/rowset_reader_context.h"
 #include "olap/rowset/rowset_writer.h"
 #include "olap/rowset/rowset_writer_context.h"
+#include "olap/schema.h"
 #include "olap/storage_engine.h"
 #include "olap/tablet_schema.h"
 #include "olap/utils.h"
@@ -36,6 +38,7 @@
 #include "runtime/mem_tracker.h"
 #include "util/file_utils.h"
 #include "util/slice.h"
+#include "vec/core/block.h"
 
 using std::string;
 
@@ -204,6 +207,14 @@ TEST_F(BetaRowsetTest, BasicFunctionTest) {
         EXPECT_TRUE(rowset != nullptr);
         EXPECT_EQ(num_segments, rowset->rowset_meta()->num_segments());
         EXPECT_EQ(num_segments * rows_per_segment, rowset->rowset_meta()->num_rows());
+
+        // the key ranges of the segments overlap
+        EXPECT_TRUE(rowset->rowset_meta()->has_segments_key_bounds());
+        const auto& key_bounds = rowset->rowset_meta()->segments_key_bounds();
+        for (int i = 0; i < num_segments; ++i) {
+            EXPECT_LT(key_bounds[i].min_key(), key_bounds[i].max_key());
+        }
+        EXPECT_LT(key_bounds[1].min_key(), key_bounds[0].max_key());
     }
 
     { // test return ordered results and return k1 and k2
@@ -357,6 +368,152 @@ TEST_F(BetaRowsetTest, BasicFunctionTest) {
             delete predicate;
         }
     }
+
+    { // test reading only the segments [1, 3)
+        RowsetReaderContext reader_context;
+        reader_context.tablet_schema = &tablet_schema;
+        reader_context.need_ordered_result = false;
+        std::vector<uint32_t> return_columns = {2};
+        reader_context.return_columns = &return_columns;
+        reader_context.seek_columns = &return_columns;
+        reader_context.stats = &_stats;
+
+        RowsetReaderSharedPtr rowset_reader;
+        s = rowset->create_reader(&rowset_reader);
+        EXPECT_EQ(Status::OK(), s);
+        std::static_pointer_cast<BetaRowsetReader>(rowset_reader)->set_segment_range(1, 3);
+        s = rowset_reader->init(&reader_context);
+        EXPECT_EQ(Status::OK(), s);
+
+        RowBlock* output_block;
+        uint32_t num_rows_read = 0;
+        while ((s = rowset_reader->next_block(&output_block)) == Status::OK()) {
+            // k3 will be 4096, 4097, ..., 4096*3-1
+            for (int i = 0; i < output_block->row_num(); ++i) {
+                char* field3 = output_block->field_ptr(i, 2);
+                uint32_t k3 = *reinterpret_cast<uint32_t*>(field3 + 1);
+                EXPECT_EQ(rows_per_segment + num_rows_read, k3);
+                num_rows_read++;
+            }
+        }
+        EXPECT_EQ(Status::OLAPInternalError(OLAP_ERR_DATA_EOF), s);
+        EXPECT_EQ(2 * rows_per_segment, num_rows_read);
+    }
+
+    { // test answering min(v1), max(v1) and count(*) from the segment metadata
+        bool enable_storage_vectorization = config::enable_storage_vectorization;
+        config::enable_storage_vectorization = true;
+        for (auto push_down_agg_type : {TPushAggOp::MINMAX, TPushAggOp::COUNT}) {
+            RowsetReaderContext reader_context;
+            reader_context.tablet_schema = &tablet_schema;
+            reader_context.need_ordered_result = false;
+            reader_context.is_vec = true;
+            reader_context.push_down_agg_type_opt = push_down_agg_type;
+            std::vector<uint32_t> return_columns = {2};
+            reader_context.return_columns = &return_columns;
+            reader_context.seek_columns = &return_columns;
+            reader_context.stats = &_stats;
+
+            RowsetReaderSharedPtr rowset_reader;
+            s = rowset->create_reader(&rowset_reader);
+            EXPECT_EQ(Status::OK(), s);
+            s = rowset_reader->init(&reader_context);
+            EXPECT_EQ(Status::OK(), s);
+
+            vectorized::Block block = tablet_schema.create_block(return_columns);
+            std::vector<int64_t> values;
+            while ((s = rowset_reader->next_block(&block)) == Status::OK()) {
+                for (size_t i = 0; i < block.rows(); ++i) {
+                    values.push_back(block.get_by_position(0).column->get_int(i));
+                }
+            }
+            EXPECT_EQ(Status::OLAPInternalError(OLAP_ERR_DATA_EOF), s);
+            if (push_down_agg_type == TPushAggOp::MINMAX) {
+                // the minimum and the maximum of v1 in each segment
+                EXPECT_EQ(2 * num_segments, values.size());
+                for (int i = 0; i < num_segments && 2 * i + 1 < values.size(); ++i) {
+                    EXPECT_EQ(rows_per_segment * i, values[2 * i]);
+                    EXPECT_EQ(rows_per_segment * (i + 1) - 1, values[2 * i + 1]);
+                }
+            } else {
+                EXPECT_EQ(num_segments * rows_per_segment, values.size());
+            }
+        }
+        config::enable_storage_vectorization = enable_storage_vectorization;
+    }
+}
+
+TEST_F(BetaRowsetTest, ParallelSegmentWriteTest) {
+    TabletSchema tablet_schema;
+    create_tablet_schema(&tablet_schema);
+    Schema schema(tablet_schema);
+
+    // k1 := rid, k2 := k1 * 10, v1 := rid
+    auto create_block = [&](int32_t first_rid, int32_t num_rows) {
+        vectorized::Block block;
+        for (auto& column_desc : schema.columns()) {
+            auto data_type = Schema::get_data_type_ptr(*column_desc);
+            auto column = data_type->create_column();
+            for (int32_t rid = first_rid; rid < first_rid + num_rows; ++rid) {
+                int32_t value = column_desc->name() == "k2" ? rid * 10 : rid;
+                column->insert_data(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+            block.insert(vectorized::ColumnWithTypeAndName(std::move(column), data_type,
+                                                           column_desc->name()));
+        }
+        return block;
+    };
+    auto check_segments_ordered = [](const RowsetSharedPtr& rowset) {
+        EXPECT_TRUE(rowset->rowset_meta()->has_segments_key_bounds());
+        const auto& key_bounds = rowset->rowset_meta()->segments_key_bounds();
+        for (int i = 1; i < key_bounds.size(); ++i) {
+            EXPECT_LT(key_bounds[i - 1].max_key(), key_bounds[i].min_key());
+        }
+    };
+
+    config::enable_parallel_segment_write = true;
+    config::parallel_segment_write_rows_per_segment = 1000;
+
+    { // a flush of memtable is split into segments
+        RowsetWriterContext writer_context;
+        create_rowset_writer_context(&tablet_schema, &writer_context);
+        writer_context.rowset_id.init(10001);
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        EXPECT_EQ(Status::OK(), RowsetFactory::create_rowset_writer(writer_context, &rowset_writer));
+
+        auto block = create_block(0, 4500);
+        int64_t flush_size = 0;
+        EXPECT_EQ(Status::OK(), rowset_writer->flush_single_block(&block, &flush_size));
+        EXPECT_GT(flush_size, 0);
+
+        RowsetSharedPtr rowset = rowset_writer->build();
+        EXPECT_TRUE(rowset != nullptr);
+        EXPECT_EQ(5, rowset->rowset_meta()->num_segments());
+        EXPECT_EQ(4500, rowset->rowset_meta()->num_rows());
+        check_segments_ordered(rowset);
+    }
+
+    { // the blocks of compaction are buffered into segments
+        RowsetWriterContext writer_context;
+        create_rowset_writer_context(&tablet_schema, &writer_context);
+        writer_context.rowset_id.init(10002);
+        std::unique_ptr<RowsetWriter> rowset_writer;
+        EXPECT_EQ(Status::OK(), RowsetFactory::create_rowset_writer(writer_context, &rowset_writer));
+
+        for (int32_t i = 0; i < 10; ++i) {
+            auto block = create_block(i * 700, 700);
+            EXPECT_EQ(Status::OK(), rowset_writer->add_block(&block));
+        }
+        EXPECT_EQ(Status::OK(), rowset_writer->flush());
+
+        RowsetSharedPtr rowset = rowset_writer->build();
+        EXPECT_TRUE(rowset != nullptr);
+        EXPECT_EQ(7, rowset->rowset_meta()->num_segments());
+        EXPECT_EQ(7000, rowset->rowset_meta()->num_rows());
+        check_segments_ordered(rowset);
+    }
+
+    config::enable_parallel_segment_write = false;
 }
 
 } // namespace doris
@@ -0,0 +1,145 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/alp_page.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/logging.h"
+#include "vec/columns/column_vector.h"
+
+using doris::segment_v2::PageBuilderOptions;
+using doris::segment_v2::PageDecoderOptions;
+
+namespace doris {
+class AlpPageTest : public testing::Test {
+public:
+    template <FieldType Type>
+    size_t test_encode_decode_page_template(typename TypeTraits<Type>::CppType* src, size_t size) {
+        typedef typename TypeTraits<Type>::CppType CppType;
+        PageBuilderOptions builder_options;
+        builder_options.data_page_size = 256 * 1024;
+        segment_v2::AlpPageBuilder<Type> page_builder(builder_options);
+        page_builder.add(reinterpret_cast<const uint8_t*>(src), &size);
+        OwnedSlice s = page_builder.finish();
+        EXPECT_EQ(size, page_builder.count());
+        LOG(INFO) << "Alp Encoded size for " << size << " values: " << s.slice().size
+                  << ", original size:" << size * sizeof(CppType);
+
+        PageDecoderOptions decoder_options;
+        segment_v2::AlpPageDecoder<Type> page_decoder(s.slice(), decoder_options);
+        EXPECT_TRUE(page_decoder.init().ok());
+        EXPECT_EQ(size, page_decoder.count());
+
+        auto tracker = std::make_shared<MemTracker>();
+        MemPool pool(tracker.get());
+        std::unique_ptr<ColumnVectorBatch> cvb;
+        ColumnVectorBatch::create(size, true, get_scalar_type_info(Type), nullptr, &cvb);
+        ColumnBlock block(cvb.get(), &pool);
+        ColumnBlockView column_block_view(&block);
+        size_t size_to_fetch = size;
+        EXPECT_TRUE(page_decoder.next_batch(&size_to_fetch, &column_block_view).ok());
+        EXPECT_EQ(size, size_to_fetch);
+
+        // the values are compared bitwise, to check NaN and -0.0
+        CppType* values = reinterpret_cast<CppType*>(column_block_view.data());
+        EXPECT_EQ(0, memcmp(src, values, size * sizeof(CppType)));
+
+        // read by the vectorized decoder from a random position
+        size_t seek_off = random() % size;
+        EXPECT_TRUE(page_decoder.seek_to_position_in_page(seek_off).ok());
+        auto column = vectorized::ColumnVector<CppType>::create();
+        vectorized::MutableColumnPtr dst = std::move(column);
+        size_to_fetch = size;
+        EXPECT_TRUE(page_decoder.next_batch(&size_to_fetch, dst).ok());
+        EXPECT_EQ(size - seek_off, size_to_fetch);
+        EXPECT_EQ(0, memcmp(src + seek_off, dst->get_raw_data().data,
+                            size_to_fetch * sizeof(CppType)));
+        return s.slice().size;
+    }
+};
+
+TEST_F(AlpPageTest, TestDecimalDoubles) {
+    const uint32_t size = 10000;
+    std::unique_ptr<double[]> doubles(new double[size]);
+    for (int i = 0; i < size; i++) {
+        // metrics with 2 decimal digits
+        doubles.get()[i] = (random() % 100000) / 100.0;
+    }
+    size_t encoded_size = test_encode_decode_page_template<OLAP_FIELD_TYPE_DOUBLE>(doubles.get(),
+                                                                                   size);
+    // 17 bits for each value
+    EXPECT_LT(encoded_size, size * sizeof(double) / 3);
+}
+
+TEST_F(AlpPageTest, TestDecimalFloats) {
+    const uint32_t size = 10000;
+    std::unique_ptr<float[]> floats(new float[size]);
+    for (int i = 0; i < size; i++) {
+        floats.get()[i] = (random() % 1000) / 10.0f;
+    }
+    size_t encoded_size =
+            test_encode_decode_page_template<OLAP_FIELD_TYPE_FLOAT>(floats.get(), size);
+    EXPECT_LT(encoded_size, size * sizeof(float) / 2);
+}
+
+TEST_F(AlpPageTest, TestExceptions) {
+    const uint32_t size = 3000;
+    std::unique_ptr<double[]> doubles(new double[size]);
+    for (int i = 0; i < size; i++) {
+        switch (i % 7) {
+        case 0:
+            doubles.get()[i] = std::nan("");
+            break;
+        case 1:
+            doubles.get()[i] = -0.0;
+            break;
+        case 2:
+            doubles.get()[i] = std::numeric_limits<double>::infinity();
+            break;
+        case 3:
+            doubles.get()[i] = std::numeric_limits<double>::max();
+            break;
+        case 4:
+            doubles.get()[i] = 1.0 / 3;
+            break;
+        default:
+            doubles.get()[i] = i * 0.5;
+            break;
+        }
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_DOUBLE>(doubles.get(), size);
+}
+
+TEST_F(AlpPageTest, TestRandomDoubles) {
+    const uint32_t size = 2049;
+    std::unique_ptr<double[]> doubles(new double[size]);
+    for (int i = 0; i < size; i++) {
+        doubles.get()[i] = (double)random() / random();
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_DOUBLE>(doubles.get(), size);
+}
+
+} // namespace doris
@@ -127,6 +127,13 @@ TEST_F(BitmapIndexTest, test_invert) {
         iter->read_union_bitmap(0, iter->current_ordinal(), &bitmap2);
         EXPECT_EQ(1024, bitmap2.cardinality());
 
+        // the union of several batches of bitmaps
+        Roaring bitmap3;
+        iter->read_union_bitmap(1000, 4500, &bitmap3);
+        EXPECT_EQ(3500, bitmap3.cardinality());
+        EXPECT_EQ(1000, bitmap3.minimum());
+        EXPECT_EQ(4499, bitmap3.maximum());
+
         delete reader;
         delete iter;
     }
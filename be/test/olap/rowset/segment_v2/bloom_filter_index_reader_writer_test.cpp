@@ -288,5 +288,74 @@ TEST_F(BloomFilterIndexReaderWriterTest, test_decimal) {
     delete[] val;
 }
 
+TEST_F(BloomFilterIndexReaderWriterTest, test_like_pattern_ngrams) {
+    std::vector<std::string> grams;
+    get_like_pattern_ngrams("%hello%", 3, &grams);
+    EXPECT_EQ(std::vector<std::string>({"hel", "ell", "llo"}), grams);
+
+    // wildcards split the literals, literals shorter than gram size have no gram
+    grams.clear();
+    get_like_pattern_ngrams("ab_cdef%gh", 3, &grams);
+    EXPECT_EQ(std::vector<std::string>({"cde", "def"}), grams);
+
+    // escaped wildcard is a normal char
+    grams.clear();
+    get_like_pattern_ngrams("%a\\%b%", 3, &grams);
+    EXPECT_EQ(std::vector<std::string>({"a%b"}), grams);
+
+    grams.clear();
+    get_like_pattern_ngrams("%", 3, &grams);
+    EXPECT_TRUE(grams.empty());
+}
+
+TEST_F(BloomFilterIndexReaderWriterTest, test_ngram_bloom_filter) {
+    const auto* type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+    std::unique_ptr<BloomFilterIndexWriter> writer;
+    EXPECT_FALSE(BloomFilterIndexWriter::create_ngram(3, 256,
+                                                      get_scalar_type_info<OLAP_FIELD_TYPE_INT>(),
+                                                      &writer)
+                         .ok());
+    EXPECT_TRUE(BloomFilterIndexWriter::create_ngram(3, 256, type_info, &writer).ok());
+
+    FileUtils::create_dir(dname);
+    std::string fname = dname + "/ngram_bloom_filter";
+    ColumnIndexMetaPB meta;
+    std::vector<std::string> pages[2] = {{"doris", "apache"}, {"segment", "bloom"}};
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(fname);
+        std::string storage_name;
+        Status st = fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock);
+        EXPECT_TRUE(st.ok()) << st.to_string();
+        for (auto& page : pages) {
+            std::vector<Slice> values(page.begin(), page.end());
+            writer->add_values(values.data(), values.size());
+            writer->add_nulls(1);
+            EXPECT_TRUE(writer->flush().ok());
+        }
+        st = writer->finish(wblock.get(), &meta);
+        EXPECT_TRUE(st.ok()) << st.to_string();
+        EXPECT_TRUE(wblock->close().ok());
+        EXPECT_EQ(NGRAM_BLOOM_FILTER_INDEX, meta.type());
+        EXPECT_EQ(3, meta.ngram_bloom_filter_index().gram_size());
+    }
+
+    BloomFilterIndexReader reader(fname, &meta.ngram_bloom_filter_index());
+    EXPECT_TRUE(reader.load(true, false).ok());
+    std::unique_ptr<BloomFilterIndexIterator> iter;
+    EXPECT_TRUE(reader.new_iterator(&iter).ok());
+    for (int i = 0; i < 2; ++i) {
+        std::unique_ptr<BloomFilter> bf;
+        EXPECT_TRUE(iter->read_bloom_filter(i, &bf).ok());
+        for (auto& value : pages[i]) {
+            std::vector<std::string> grams;
+            get_like_pattern_ngrams("%" + value + "%", 3, &grams);
+            for (auto& gram : grams) {
+                EXPECT_TRUE(bf->test_bytes(gram.data(), gram.size()));
+            }
+        }
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -24,15 +24,20 @@
 #include "olap/column_block.h"
 #include "olap/decimal12.h"
 #include "olap/fs/fs_util.h"
+#include "olap/hll.h"
 #include "olap/olap_common.h"
 #include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/rowset/segment_v2/decoded_column_cache.h"
 #include "olap/tablet_schema_helper.h"
 #include "olap/types.h"
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
 #include "testutil/test_util.h"
 #include "util/file_utils.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/columns_number.h"
 #include "vec/core/types.h"
 #include "vec/data_types/data_type_nothing.h"
 #include "vec/data_types/data_type_number.h"
@@ -71,7 +76,7 @@ private:
 
 template <FieldType type, EncodingTypePB encoding>
 void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows,
-                        std::string test_name) {
+                        std::string test_name, bool adaptive_encoding = false) {
     using Type = typename TypeTraits<type>::CppType;
     Type* src = (Type*)src_data;
 
@@ -100,6 +105,7 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows,
         writer_opts.meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
         writer_opts.meta->set_is_nullable(true);
         writer_opts.need_zone_map = true;
+        writer_opts.adaptive_encoding = adaptive_encoding;
 
         TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, type);
         if (type == OLAP_FIELD_TYPE_VARCHAR) {
@@ -121,6 +127,8 @@ void test_nullable_data(uint8_t* src_data, uint8_t* src_is_null, int num_rows,
         EXPECT_TRUE(writer->write_data().ok());
         EXPECT_TRUE(writer->write_ordinal_index().ok());
         EXPECT_TRUE(writer->write_zone_map().ok());
+        // the chosen encoding is recorded in the column meta
+        EXPECT_NE(DEFAULT_ENCODING, meta.encoding());
 
         // close the file
         EXPECT_TRUE(wblock->close().ok());
@@ -741,6 +749,152 @@ TEST_F(ColumnReaderWriterTest, test_types) {
     delete[] decimal_vals;
 }
 
+TEST_F(ColumnReaderWriterTest, test_adaptive_encoding) {
+    size_t num_rows = LOOP_LESS_OR_MORE(1024, 1024 * 1024);
+    uint8_t* is_null = new uint8_t[num_rows];
+    int64_t* bigint_vals = new int64_t[num_rows];
+    Slice* varchar_vals = new Slice[num_rows];
+    for (int i = 0; i < num_rows; ++i) {
+        // sorted values with small deltas
+        bigint_vals[i] = 1000000 + i;
+        set_column_value_by_type(OLAP_FIELD_TYPE_VARCHAR, i, (char*)&varchar_vals[i], &_pool);
+        BitmapChange(is_null, i, (i % 8) == 0);
+    }
+    test_nullable_data<OLAP_FIELD_TYPE_BIGINT, DEFAULT_ENCODING>(
+            (uint8_t*)bigint_vals, is_null, num_rows, "adaptive_bigint", true);
+    test_nullable_data<OLAP_FIELD_TYPE_VARCHAR, DEFAULT_ENCODING>(
+            (uint8_t*)varchar_vals, is_null, num_rows, "adaptive_varchar", true);
+
+    delete[] is_null;
+    delete[] bigint_vals;
+    delete[] varchar_vals;
+}
+
+TEST_F(ColumnReaderWriterTest, test_ndv_sketch) {
+    ColumnMetaPB meta;
+    std::string fname = TEST_DIR + "/ndv_sketch";
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(fname);
+        std::string storage_name;
+        EXPECT_TRUE(fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock).ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = &meta;
+        writer_opts.meta->set_column_id(0);
+        writer_opts.meta->set_unique_id(0);
+        writer_opts.meta->set_type(OLAP_FIELD_TYPE_INT);
+        writer_opts.meta->set_length(0);
+        writer_opts.meta->set_encoding(DEFAULT_ENCODING);
+        writer_opts.meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
+        writer_opts.meta->set_is_nullable(true);
+        writer_opts.need_zone_map = true;
+        writer_opts.need_ndv_sketch = true;
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT);
+        std::unique_ptr<ColumnWriter> writer;
+        ColumnWriter::create(writer_opts, &column, wblock.get(), &writer);
+        EXPECT_TRUE(writer->init().ok());
+        // 10000 distinct values and nulls
+        for (int i = 0; i < 100000; ++i) {
+            int32_t value = i % 10000;
+            EXPECT_TRUE(writer->append(i % 7 == 0, &value).ok());
+        }
+        EXPECT_TRUE(writer->finish().ok());
+        EXPECT_TRUE(writer->write_data().ok());
+        EXPECT_TRUE(writer->write_ordinal_index().ok());
+        EXPECT_TRUE(writer->write_zone_map().ok());
+        EXPECT_TRUE(wblock->close().ok());
+    }
+    EXPECT_TRUE(meta.has_ndv_sketch());
+
+    ColumnReaderOptions reader_opts;
+    FilePathDesc path_desc;
+    path_desc.filepath = fname;
+    std::unique_ptr<ColumnReader> reader;
+    EXPECT_TRUE(ColumnReader::create(reader_opts, meta, 100000, path_desc, &reader).ok());
+    HyperLogLog sketch;
+    bool has_sketch = false;
+    EXPECT_TRUE(reader->merge_ndv_sketch(&sketch, &has_sketch).ok());
+    EXPECT_TRUE(has_sketch);
+    EXPECT_NEAR(10000, sketch.estimate_cardinality(), 10000 * 0.05);
+
+    // merging the same sketch again doesn't change the estimate
+    EXPECT_TRUE(reader->merge_ndv_sketch(&sketch, &has_sketch).ok());
+    EXPECT_NEAR(10000, sketch.estimate_cardinality(), 10000 * 0.05);
+}
+
+TEST_F(ColumnReaderWriterTest, test_decoded_column) {
+    ColumnMetaPB meta;
+    std::string fname = TEST_DIR + "/decoded_column";
+    const int num_rows = 10000;
+    std::vector<std::string> values;
+    for (int i = 0; i < 10; ++i) {
+        values.push_back("value_" + std::to_string(i));
+    }
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(fname);
+        std::string storage_name;
+        EXPECT_TRUE(fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock).ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = &meta;
+        writer_opts.meta->set_column_id(0);
+        writer_opts.meta->set_unique_id(0);
+        writer_opts.meta->set_type(OLAP_FIELD_TYPE_VARCHAR);
+        writer_opts.meta->set_length(0);
+        writer_opts.meta->set_encoding(DEFAULT_ENCODING);
+        writer_opts.meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
+        writer_opts.meta->set_is_nullable(true);
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_VARCHAR);
+        std::unique_ptr<ColumnWriter> writer;
+        ColumnWriter::create(writer_opts, &column, wblock.get(), &writer);
+        EXPECT_TRUE(writer->init().ok());
+        for (int i = 0; i < num_rows; ++i) {
+            Slice value(values[i % values.size()]);
+            EXPECT_TRUE(writer->append(i % 7 == 0, &value).ok());
+        }
+        EXPECT_TRUE(writer->finish().ok());
+        EXPECT_TRUE(writer->write_data().ok());
+        EXPECT_TRUE(writer->write_ordinal_index().ok());
+        EXPECT_TRUE(wblock->close().ok());
+    }
+
+    ColumnReaderOptions reader_opts;
+    FilePathDesc path_desc;
+    path_desc.filepath = fname;
+    std::unique_ptr<ColumnReader> reader;
+    EXPECT_TRUE(ColumnReader::create(reader_opts, meta, num_rows, path_desc, &reader).ok());
+    DecodedColumnSharedPtr decoded;
+    EXPECT_TRUE(DecodedColumn::load(reader.get(), path_desc, OLAP_FIELD_TYPE_VARCHAR, num_rows,
+                                    &decoded)
+                        .ok());
+    EXPECT_EQ(num_rows, decoded->num_rows);
+    EXPECT_TRUE(decoded->is_dict_encoded());
+    EXPECT_EQ(values.size(), decoded->dict.size());
+
+    DecodedColumnIterator iter(reader.get(), decoded);
+    EXPECT_TRUE(iter.seek_to_ordinal(100).ok());
+    vectorized::MutableColumnPtr dst = vectorized::ColumnNullable::create(
+            vectorized::ColumnString::create(), vectorized::ColumnUInt8::create());
+    size_t n = 1024;
+    bool has_null = false;
+    EXPECT_TRUE(iter.next_batch(&n, dst, &has_null).ok());
+    EXPECT_EQ(1024, n);
+    EXPECT_TRUE(has_null);
+    EXPECT_EQ(1124, iter.get_current_ordinal());
+    for (size_t i = 0; i < n; ++i) {
+        size_t row = 100 + i;
+        if (row % 7 == 0) {
+            EXPECT_TRUE(dst->is_null_at(i));
+        } else {
+            EXPECT_EQ(values[row % values.size()], dst->get_data_at(i).to_string());
+        }
+    }
+}
+
 TEST_F(ColumnReaderWriterTest, test_default_value) {
     std::string v_int("1");
     int32_t result = 1;
@@ -0,0 +1,211 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/delta_page.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include "olap/rowset/segment_v2/options.h"
+#include "olap/rowset/segment_v2/page_builder.h"
+#include "olap/rowset/segment_v2/page_decoder.h"
+#include "runtime/mem_pool.h"
+#include "runtime/mem_tracker.h"
+#include "util/logging.h"
+
+using doris::segment_v2::PageBuilderOptions;
+using doris::segment_v2::PageDecoderOptions;
+
+namespace doris {
+class DeltaPageTest : public testing::Test {
+public:
+    template <FieldType type, class PageDecoderType>
+    void copy_one(PageDecoderType* decoder, typename TypeTraits<type>::CppType* ret) {
+        auto tracker = std::make_shared<MemTracker>();
+        MemPool pool(tracker.get());
+        std::unique_ptr<ColumnVectorBatch> cvb;
+        ColumnVectorBatch::create(1, true, get_scalar_type_info(type), nullptr, &cvb);
+        ColumnBlock block(cvb.get(), &pool);
+        ColumnBlockView column_block_view(&block);
+
+        size_t n = 1;
+        decoder->next_batch(&n, &column_block_view);
+        EXPECT_EQ(1, n);
+        *ret = *reinterpret_cast<const typename TypeTraits<type>::CppType*>(block.cell_ptr(0));
+    }
+
+    template <FieldType Type, bool delta_of_delta>
+    size_t test_encode_decode_page_template(typename TypeTraits<Type>::CppType* src, size_t size) {
+        typedef typename TypeTraits<Type>::CppType CppType;
+        PageBuilderOptions builder_options;
+        builder_options.data_page_size = 256 * 1024;
+        segment_v2::DeltaPageBuilder<Type, delta_of_delta> page_builder(builder_options);
+        page_builder.add(reinterpret_cast<const uint8_t*>(src), &size);
+        OwnedSlice s = page_builder.finish();
+        EXPECT_EQ(size, page_builder.count());
+        LOG(INFO) << "Delta Encoded size for " << size << " values: " << s.slice().size
+                  << ", original size:" << size * sizeof(CppType);
+
+        PageDecoderOptions decoder_options;
+        segment_v2::DeltaPageDecoder<Type, delta_of_delta> page_decoder(s.slice(),
+                                                                        decoder_options);
+        Status status = page_decoder.init();
+        EXPECT_TRUE(status.ok());
+        EXPECT_EQ(0, page_decoder.current_index());
+        EXPECT_EQ(size, page_decoder.count());
+
+        auto tracker = std::make_shared<MemTracker>();
+        MemPool pool(tracker.get());
+        std::unique_ptr<ColumnVectorBatch> cvb;
+        ColumnVectorBatch::create(size, true, get_scalar_type_info(Type), nullptr, &cvb);
+        ColumnBlock block(cvb.get(), &pool);
+        ColumnBlockView column_block_view(&block);
+        size_t size_to_fetch = size;
+        status = page_decoder.next_batch(&size_to_fetch, &column_block_view);
+        EXPECT_TRUE(status.ok());
+        EXPECT_EQ(size, size_to_fetch);
+
+        CppType* values = reinterpret_cast<CppType*>(column_block_view.data());
+        for (uint i = 0; i < size; i++) {
+            if (src[i] != values[i]) {
+                ADD_FAILURE() << "Fail at index " << i << " inserted=" << src[i]
+                              << " got=" << values[i];
+                return s.slice().size;
+            }
+        }
+
+        // Test Seek within block by ordinal
+        for (int i = 0; i < 100; i++) {
+            int seek_off = random() % size;
+            page_decoder.seek_to_position_in_page(seek_off);
+            EXPECT_EQ((int32_t)(seek_off), page_decoder.current_index());
+            CppType ret;
+            copy_one<Type>(&page_decoder, &ret);
+            EXPECT_EQ(values[seek_off], ret);
+        }
+        return s.slice().size;
+    }
+};
+
+TEST_F(DeltaPageTest, TestInt32Random) {
+    const uint32_t size = 10000;
+    std::unique_ptr<int32_t[]> ints(new int32_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = random() - (RAND_MAX / 2);
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_INT, false>(ints.get(), size);
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_INT, true>(ints.get(), size);
+}
+
+TEST_F(DeltaPageTest, TestInt64MinMax) {
+    const uint32_t size = 1000;
+    std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+    for (int i = 0; i < size; i++) {
+        ints.get()[i] = i % 2 == 0 ? std::numeric_limits<int64_t>::min()
+                                   : std::numeric_limits<int64_t>::max();
+    }
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT, false>(ints.get(), size);
+    test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT, true>(ints.get(), size);
+}
+
+TEST_F(DeltaPageTest, TestTimestampSequence) {
+    const uint32_t size = 10000;
+    std::unique_ptr<uint64_t[]> ints(new uint64_t[size]);
+    for (int i = 0; i < size; i++) {
+        // 20220101000000 with a step of one second, in the format of DATETIME
+        ints.get()[i] = 20220101000000L + (i / 60) * 100 + i % 60;
+    }
+    size_t delta_size =
+            test_encode_decode_page_template<OLAP_FIELD_TYPE_DATETIME, false>(ints.get(), size);
+    EXPECT_LT(delta_size, size * sizeof(uint64_t) / 8);
+
+    for (int i = 0; i < size; i++) {
+        // in milliseconds, with a fixed interval
+        ints.get()[i] = 1640995200000L + i * 1000;
+    }
+    size_t dod_size = test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT, true>(
+            (int64_t*)ints.get(), size);
+    // only the block headers remain
+    EXPECT_LT(dod_size, size * sizeof(uint64_t) / 16);
+}
+
+TEST_F(DeltaPageTest, TestBlockBoundary) {
+    for (size_t size : {1, 2, 3, 127, 128, 129, 256, 257}) {
+        std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+        for (int i = 0; i < size; i++) {
+            ints.get()[i] = 1000 + i * i;
+        }
+        test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT, false>(ints.get(), size);
+        test_encode_decode_page_template<OLAP_FIELD_TYPE_BIGINT, true>(ints.get(), size);
+    }
+}
+
+TEST_F(DeltaPageTest, TestSeekAtOrAfterValue) {
+    const uint32_t size = 1000;
+    std::unique_ptr<int64_t[]> ints(new int64_t[size]);
+    for (int i = 0; i < size; i++) {
+        // each value appears twice
+        ints.get()[i] = 100 + (i / 2) * 10;
+    }
+    PageBuilderOptions builder_options;
+    builder_options.data_page_size = 256 * 1024;
+    segment_v2::DeltaPageBuilder<OLAP_FIELD_TYPE_BIGINT, true> page_builder(builder_options);
+    size_t count = size;
+    page_builder.add(reinterpret_cast<const uint8_t*>(ints.get()), &count);
+    OwnedSlice s = page_builder.finish();
+
+    int64_t first_value = 0;
+    EXPECT_TRUE(page_builder.get_first_value(&first_value).ok());
+    EXPECT_EQ(100, first_value);
+    int64_t last_value = 0;
+    EXPECT_TRUE(page_builder.get_last_value(&last_value).ok());
+    EXPECT_EQ(100 + (size - 1) / 2 * 10, last_value);
+
+    PageDecoderOptions decoder_options;
+    segment_v2::DeltaPageDecoder<OLAP_FIELD_TYPE_BIGINT, true> page_decoder(s.slice(),
+                                                                            decoder_options);
+    EXPECT_TRUE(page_decoder.init().ok());
+
+    bool exact_match = false;
+    // value 740 is at 128 and 129, the first row of the second block
+    int64_t value = 740;
+    EXPECT_TRUE(page_decoder.seek_at_or_after_value(&value, &exact_match).ok());
+    EXPECT_TRUE(exact_match);
+    EXPECT_EQ(128, page_decoder.current_index());
+
+    // value 730 is at 126 and 127, the end of the first block
+    value = 730;
+    EXPECT_TRUE(page_decoder.seek_at_or_after_value(&value, &exact_match).ok());
+    EXPECT_TRUE(exact_match);
+    EXPECT_EQ(126, page_decoder.current_index());
+
+    value = 735;
+    EXPECT_TRUE(page_decoder.seek_at_or_after_value(&value, &exact_match).ok());
+    EXPECT_FALSE(exact_match);
+    EXPECT_EQ(128, page_decoder.current_index());
+
+    value = 0;
+    EXPECT_TRUE(page_decoder.seek_at_or_after_value(&value, &exact_match).ok());
+    EXPECT_FALSE(exact_match);
+    EXPECT_EQ(0, page_decoder.current_index());
+
+    value = last_value + 1;
+    EXPECT_TRUE(page_decoder.seek_at_or_after_value(&value, &exact_match).is_not_found());
+}
+
+} // namespace doris
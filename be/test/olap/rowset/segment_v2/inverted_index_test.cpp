@@ -0,0 +1,140 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/match_predicate.h"
+#include "olap/rowset/segment_v2/bitmap_index_reader.h"
+#include "olap/rowset/segment_v2/inverted_index_parser.h"
+#include "olap/rowset/segment_v2/inverted_index_writer.h"
+#include "olap/types.h"
+#include "util/file_utils.h"
+#include "vec/columns/predicate_column.h"
+
+namespace doris {
+namespace segment_v2 {
+using roaring::Roaring;
+
+class InvertedIndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/inverted_index_test";
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            EXPECT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        EXPECT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            EXPECT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+};
+
+static std::vector<std::string> tokenize(InvertedIndexParserType type, const std::string& value) {
+    std::vector<std::string> terms;
+    tokenize_by_parser(type, Slice(value), &terms);
+    return terms;
+}
+
+TEST_F(InvertedIndexTest, test_parser) {
+    InvertedIndexParserType type;
+    EXPECT_TRUE(parse_inverted_index_parser("english", &type).ok());
+    EXPECT_EQ(InvertedIndexParserType::PARSER_ENGLISH, type);
+    EXPECT_FALSE(parse_inverted_index_parser("chinese", &type).ok());
+
+    EXPECT_EQ(std::vector<std::string>({"get", "index", "html", "http", "1", "1"}),
+              tokenize(InvertedIndexParserType::PARSER_ENGLISH, "GET /index.html HTTP/1.1"));
+    EXPECT_EQ(std::vector<std::string>({"GET", "/index.html", "HTTP/1.1"}),
+              tokenize(InvertedIndexParserType::PARSER_WHITESPACE, " GET  /index.html HTTP/1.1"));
+    // padding zeros of CHAR are skipped
+    std::string char_value("GET /index.html\0\0", 17);
+    EXPECT_EQ(std::vector<std::string>({"GET /index.html"}),
+              tokenize(InvertedIndexParserType::PARSER_NONE, char_value));
+    EXPECT_TRUE(tokenize(InvertedIndexParserType::PARSER_ENGLISH, " ,. ").empty());
+}
+
+TEST_F(InvertedIndexTest, test_match) {
+    std::vector<std::string> values = {"Error: disk is full", "warn: Disk is slow",
+                                       "error: network unreachable", "info: all good"};
+    std::vector<Slice> slices(values.begin(), values.end());
+
+    std::string file_name = kTestDir + "/english";
+    ColumnIndexMetaPB meta;
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(file_name);
+        std::string storage_name;
+        EXPECT_TRUE(fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock).ok());
+
+        std::unique_ptr<InvertedIndexWriter> writer;
+        EXPECT_FALSE(InvertedIndexWriter::create(get_scalar_type_info<OLAP_FIELD_TYPE_INT>(),
+                                                 "english", &writer)
+                             .ok());
+        EXPECT_TRUE(InvertedIndexWriter::create(get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>(),
+                                                "english", &writer)
+                            .ok());
+        writer->add_values(slices.data(), slices.size());
+        writer->add_nulls(1);
+        EXPECT_TRUE(writer->finish(wblock.get(), &meta).ok());
+        EXPECT_EQ(INVERTED_INDEX, meta.type());
+        EXPECT_EQ("english", meta.inverted_index().parser());
+        EXPECT_TRUE(wblock->close().ok());
+    }
+
+    BitmapIndexReader reader(file_name, &meta.inverted_index().postings());
+    EXPECT_TRUE(reader.load(true, false).ok());
+    auto match = [&](MatchType match_type, const std::string& query) {
+        BitmapIndexIterator* iter = nullptr;
+        EXPECT_TRUE(reader.new_iterator(&iter).ok());
+        std::unique_ptr<BitmapIndexIterator> iter_ptr(iter);
+        MatchPredicate pred(0, match_type, query, "english",
+                            InvertedIndexParserType::PARSER_ENGLISH);
+        Roaring bitmap;
+        bitmap.addRange(0, values.size() + 1);
+        EXPECT_TRUE(pred.evaluate_inverted_index(iter, &bitmap).ok());
+        return bitmap;
+    };
+    EXPECT_EQ(Roaring::bitmapOf(2, 0, 2), match(MatchType::MATCH_ANY, "ERROR"));
+    EXPECT_EQ(Roaring::bitmapOf(3, 0, 1, 2), match(MatchType::MATCH_ANY, "disk network"));
+    EXPECT_EQ(Roaring::bitmapOf(1, 0), match(MatchType::MATCH_ALL, "error disk"));
+    EXPECT_TRUE(match(MatchType::MATCH_ALL, "error missing").isEmpty());
+    EXPECT_TRUE(match(MatchType::MATCH_ANY, "").isEmpty());
+
+    // rows without inverted index get the same result
+    auto column = vectorized::ColumnStringValue::create();
+    column->reserve(values.size());
+    for (auto& value : values) {
+        column->insert_string_value(value.data(), value.size());
+    }
+    MatchPredicate pred(0, MatchType::MATCH_ALL, "error disk", "english",
+                        InvertedIndexParserType::PARSER_ENGLISH);
+    uint16_t sel[] = {0, 1, 2, 3};
+    uint16_t size = 4;
+    pred.evaluate(*column, sel, &size);
+    EXPECT_EQ(1, size);
+    EXPECT_EQ(0, sel[0]);
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,196 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/page_prefetcher.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "olap/fs/fs_util.h"
+#include "olap/olap_common.h"
+#include "olap/rowset/segment_v2/column_reader.h"
+#include "olap/rowset/segment_v2/column_writer.h"
+#include "olap/tablet_schema_helper.h"
+#include "util/file_utils.h"
+#include "util/threadpool.h"
+
+namespace doris {
+namespace segment_v2 {
+
+static const std::string TEST_DIR = "./ut_dir/page_prefetcher_test";
+
+class PagePrefetcherTest : public testing::Test {
+protected:
+    void SetUp() override {
+        config::disable_storage_page_cache = true;
+        if (FileUtils::check_exist(TEST_DIR)) {
+            EXPECT_TRUE(FileUtils::remove_all(TEST_DIR).ok());
+        }
+        EXPECT_TRUE(FileUtils::create_dir(TEST_DIR).ok());
+        EXPECT_TRUE(ThreadPoolBuilder("PagePrefetcherTest").set_max_threads(4).build(&_pool).ok());
+
+        // an INT column of many pages
+        std::string fname = TEST_DIR + "/int_column";
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(fname);
+        std::string storage_name;
+        EXPECT_TRUE(fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock).ok());
+
+        ColumnWriterOptions writer_opts;
+        writer_opts.meta = &_meta;
+        writer_opts.meta->set_column_id(0);
+        writer_opts.meta->set_unique_id(0);
+        writer_opts.meta->set_type(OLAP_FIELD_TYPE_INT);
+        writer_opts.meta->set_length(0);
+        writer_opts.meta->set_encoding(BIT_SHUFFLE);
+        writer_opts.meta->set_compression(segment_v2::CompressionTypePB::LZ4F);
+        writer_opts.meta->set_is_nullable(false);
+        writer_opts.data_page_size = 4 * 1024;
+
+        TabletColumn column(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT);
+        std::unique_ptr<ColumnWriter> writer;
+        ColumnWriter::create(writer_opts, &column, wblock.get(), &writer);
+        EXPECT_TRUE(writer->init().ok());
+        for (int32_t i = 0; i < NUM_ROWS; ++i) {
+            EXPECT_TRUE(writer->append(false, &i).ok());
+        }
+        EXPECT_TRUE(writer->finish().ok());
+        EXPECT_TRUE(writer->write_data().ok());
+        EXPECT_TRUE(writer->write_ordinal_index().ok());
+        EXPECT_TRUE(wblock->close().ok());
+
+        FilePathDesc path_desc;
+        path_desc.filepath = fname;
+        ColumnReaderOptions reader_opts;
+        EXPECT_TRUE(ColumnReader::create(reader_opts, _meta, NUM_ROWS, path_desc, &_reader).ok());
+        EXPECT_TRUE(fs::fs_util::block_manager(path_desc)->open_block(path_desc, &_rblock).ok());
+    }
+
+    void TearDown() override {
+        _pool->shutdown();
+        if (FileUtils::check_exist(TEST_DIR)) {
+            EXPECT_TRUE(FileUtils::remove_all(TEST_DIR).ok());
+        }
+    }
+
+    // read all the pages, taking them from the prefetcher if they are read ahead
+    int32_t read_pages(PagePrefetcher* prefetcher, ColumnIteratorOptions* iter_opts) {
+        OrdinalPageIndexIterator iter;
+        EXPECT_TRUE(_reader->seek_to_first(&iter).ok());
+        int32_t num_pages = 0;
+        for (; iter.valid(); iter.next(), ++num_pages) {
+            Status status;
+            PageHandle handle;
+            Slice body;
+            PageFooterPB footer;
+            if (!prefetcher->take(iter.page_index(), &status, &handle, &body, &footer)) {
+                status = _reader->read_page(*iter_opts, iter.page(), &handle, &body, &footer);
+            }
+            EXPECT_TRUE(status.ok());
+            EXPECT_EQ(iter.last_ordinal() - iter.first_ordinal() + 1,
+                      footer.data_page_footer().num_values());
+            EXPECT_EQ(iter.first_ordinal(), footer.data_page_footer().first_ordinal());
+            prefetcher->prefetch_after(iter);
+        }
+        return num_pages;
+    }
+
+    static constexpr int32_t NUM_ROWS = 100000;
+
+    ColumnMetaPB _meta;
+    std::unique_ptr<ColumnReader> _reader;
+    std::unique_ptr<fs::ReadableBlock> _rblock;
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+TEST_F(PagePrefetcherTest, read_ahead) {
+    OlapReaderStatistics stats;
+    ColumnIteratorOptions iter_opts;
+    iter_opts.stats = &stats;
+    iter_opts.rblock = _rblock.get();
+    iter_opts.type = DATA_PAGE;
+
+    PagePrefetchBudget budget(16);
+    int32_t num_pages = 0;
+    {
+        PagePrefetcher prefetcher(_reader.get(), iter_opts, _pool.get(), &budget, 4);
+        num_pages = read_pages(&prefetcher, &iter_opts);
+    }
+    EXPECT_GT(num_pages, 10);
+    // all the pages but the first one are read ahead
+    EXPECT_EQ(num_pages - 1, stats.prefetched_pages_num);
+    EXPECT_EQ(num_pages, stats.total_pages_num);
+    EXPECT_EQ(0, budget.pending_pages());
+}
+
+TEST_F(PagePrefetcherTest, budget) {
+    OlapReaderStatistics stats;
+    ColumnIteratorOptions iter_opts;
+    iter_opts.stats = &stats;
+    iter_opts.rblock = _rblock.get();
+    iter_opts.type = DATA_PAGE;
+
+    // the budget is taken by others
+    PagePrefetchBudget budget(2);
+    EXPECT_TRUE(budget.try_acquire());
+    EXPECT_TRUE(budget.try_acquire());
+    EXPECT_FALSE(budget.try_acquire());
+    {
+        PagePrefetcher prefetcher(_reader.get(), iter_opts, _pool.get(), &budget, 4);
+        read_pages(&prefetcher, &iter_opts);
+    }
+    EXPECT_EQ(0, stats.prefetched_pages_num);
+    budget.release();
+    budget.release();
+    EXPECT_EQ(0, budget.pending_pages());
+}
+
+TEST_F(PagePrefetcherTest, row_bitmap) {
+    OlapReaderStatistics stats;
+    ColumnIteratorOptions iter_opts;
+    iter_opts.stats = &stats;
+    iter_opts.rblock = _rblock.get();
+    iter_opts.type = DATA_PAGE;
+    // only the first and the last rows are read
+    roaring::Roaring row_bitmap;
+    row_bitmap.add(0);
+    row_bitmap.add(NUM_ROWS - 1);
+    iter_opts.row_bitmap = &row_bitmap;
+
+    PagePrefetchBudget budget(16);
+    {
+        PagePrefetcher prefetcher(_reader.get(), iter_opts, _pool.get(), &budget, 4);
+        read_pages(&prefetcher, &iter_opts);
+
+        // seek back to the first page, and the page read ahead is left unconsumed
+        OrdinalPageIndexIterator iter;
+        EXPECT_TRUE(_reader->seek_to_first(&iter).ok());
+        Status status;
+        PageHandle handle;
+        Slice body;
+        PageFooterPB footer;
+        EXPECT_FALSE(prefetcher.take(0, &status, &handle, &body, &footer));
+        prefetcher.prefetch_after(iter);
+        EXPECT_EQ(1, budget.pending_pages());
+    }
+    // only the last page is read ahead
+    EXPECT_EQ(1, stats.prefetched_pages_num);
+    EXPECT_EQ(0, budget.pending_pages());
+}
+
+} // namespace segment_v2
+} // namespace doris
@@ -0,0 +1,132 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/rowset/segment_v2/primary_key_index.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "olap/column_block.h"
+#include "olap/column_vector.h"
+#include "olap/fs/block_manager.h"
+#include "olap/fs/fs_util.h"
+#include "olap/rowset/segment_v2/indexed_column_reader.h"
+#include "olap/types.h"
+#include "runtime/mem_pool.h"
+#include "util/file_utils.h"
+
+namespace doris {
+namespace segment_v2 {
+
+class PrimaryKeyIndexTest : public testing::Test {
+public:
+    const std::string kTestDir = "./ut_dir/primary_key_index_test";
+    void SetUp() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            EXPECT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+        EXPECT_TRUE(FileUtils::create_dir(kTestDir).ok());
+    }
+    void TearDown() override {
+        if (FileUtils::check_exist(kTestDir)) {
+            EXPECT_TRUE(FileUtils::remove_all(kTestDir).ok());
+        }
+    }
+};
+
+TEST_F(PrimaryKeyIndexTest, builder) {
+    std::string filename = kTestDir + "/builder";
+    PrimaryKeyIndexMetaPB meta;
+    {
+        std::unique_ptr<fs::WritableBlock> wblock;
+        fs::CreateBlockOptions opts(filename);
+        std::string storage_name;
+        EXPECT_TRUE(fs::fs_util::block_manager(storage_name)->create_block(opts, &wblock).ok());
+
+        PrimaryKeyIndexBuilder builder(wblock.get());
+        EXPECT_TRUE(builder.init().ok());
+        // 1000, 1002, ..., 9998
+        for (int i = 1000; i < 10000; i += 2) {
+            EXPECT_TRUE(builder.add_item(std::to_string(i)).ok());
+        }
+        EXPECT_EQ(4500, builder.num_rows());
+        EXPECT_TRUE(builder.finalize(&meta).ok());
+        EXPECT_TRUE(wblock->close().ok());
+    }
+    EXPECT_EQ("1000", meta.min_key());
+    EXPECT_EQ("9998", meta.max_key());
+
+    PrimaryKeyIndexReader index_reader;
+    EXPECT_TRUE(index_reader.parse(filename, meta).ok());
+    EXPECT_EQ(4500, index_reader.num_rows());
+    EXPECT_EQ(Slice("1000"), index_reader.min_key());
+    EXPECT_EQ(Slice("9998"), index_reader.max_key());
+    EXPECT_TRUE(meta.has_bloom_filter_index());
+    // no false negative, and few false positives
+    int num_false_positives = 0;
+    for (int i = 1000; i < 10000; ++i) {
+        bool present = index_reader.check_present(std::to_string(i));
+        if (i % 2 == 0) {
+            EXPECT_TRUE(present);
+        } else if (present) {
+            ++num_false_positives;
+        }
+    }
+    EXPECT_LT(num_false_positives, 4500 / 10);
+
+    std::unique_ptr<IndexedColumnIterator> index_iterator;
+    EXPECT_TRUE(index_reader.new_iterator(&index_iterator).ok());
+    bool exact_match = false;
+    {
+        // the row of an existing key
+        Slice key("8018");
+        EXPECT_TRUE(index_iterator->seek_at_or_after(&key, &exact_match).ok());
+        EXPECT_TRUE(exact_match);
+        EXPECT_EQ(3509, index_iterator->get_current_ordinal());
+    }
+    {
+        // points to the next key for a missing key
+        Slice key("8019");
+        EXPECT_TRUE(index_iterator->seek_at_or_after(&key, &exact_match).ok());
+        EXPECT_FALSE(exact_match);
+        EXPECT_EQ(3510, index_iterator->get_current_ordinal());
+    }
+    {
+        Slice key("9999");
+        EXPECT_TRUE(index_iterator->seek_at_or_after(&key, &exact_match).is_not_found());
+    }
+
+    // scan the keys by ordinal
+    const auto* type_info = get_scalar_type_info<OLAP_FIELD_TYPE_VARCHAR>();
+    std::unique_ptr<ColumnVectorBatch> cvb;
+    EXPECT_TRUE(ColumnVectorBatch::create(100, false, type_info, nullptr, &cvb).ok());
+    MemPool pool("PrimaryKeyIndexTest");
+    ColumnBlock block(cvb.get(), &pool);
+    ColumnBlockView column_block_view(&block);
+    EXPECT_TRUE(index_iterator->seek_to_ordinal(4450).ok());
+    size_t num_read = 100;
+    EXPECT_TRUE(index_iterator->next_batch(&num_read, &column_block_view).ok());
+    EXPECT_EQ(50, num_read);
+    const auto* keys = reinterpret_cast<const Slice*>(cvb->data());
+    for (size_t i = 0; i < num_read; ++i) {
+        EXPECT_EQ(std::to_string(1000 + (4450 + i) * 2), keys[i].to_string());
+    }
+}
+
+} // namespace segment_v2
+} // namespace doris
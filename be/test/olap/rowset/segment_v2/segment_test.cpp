@@ -23,17 +23,21 @@
 #include <functional>
 #include <iostream>
 
+#include "common/config.h"
 #include "common/logging.h"
 #include "gutil/strings/substitute.h"
+#include "exprs/create_predicate_function.h"
 #include "olap/comparison_predicate.h"
 #include "olap/data_dir.h"
 #include "olap/fs/block_manager.h"
 #include "olap/fs/fs_util.h"
 #include "olap/in_list_predicate.h"
+#include "olap/late_runtime_filter.h"
 #include "olap/olap_common.h"
 #include "olap/row_block.h"
 #include "olap/row_block2.h"
 #include "olap/row_cursor.h"
+#include "olap/rowset/segment_v2/column_reader.h"
 #include "olap/rowset/segment_v2/segment_iterator.h"
 #include "olap/rowset/segment_v2/segment_writer.h"
 #include "olap/tablet_schema.h"
@@ -41,8 +45,10 @@
 #include "olap/types.h"
 #include "runtime/mem_pool.h"
 #include "runtime/mem_tracker.h"
+#include "runtime/runtime_state.h"
 #include "testutil/test_util.h"
 #include "util/file_utils.h"
+#include "vec/core/block.h"
 namespace doris {
 namespace segment_v2 {
 
@@ -1148,6 +1154,59 @@ TEST_F(SegmentReaderWriterTest, TestBitmapPredicate) {
             } while (st.ok());
             EXPECT_EQ(read_opts.stats->raw_rows_read, 4094);
         }
+
+        // read the rows of the predicates, the bitmap index filtered rows are not counted
+        auto read_rows = [&](const std::vector<ColumnPredicate*>& column_predicates,
+                             OlapReaderStatistics* stats) {
+            StorageReadOptions read_opts;
+            read_opts.column_predicates = column_predicates;
+            read_opts.stats = stats;
+
+            std::unique_ptr<RowwiseIterator> iter;
+            EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+            RowBlockV2 block(schema, 1024);
+            int64_t num_rows = 0;
+            while (true) {
+                block.clear();
+                Status st = iter->next_batch(&block);
+                if (!st.ok()) {
+                    EXPECT_TRUE(st.is_end_of_file());
+                    break;
+                }
+                num_rows += block.selected_size();
+            }
+            return num_rows;
+        };
+
+        // test where v1 >= 100 and v1 < 500, by the bitmaps of one dictionary range
+        {
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterEqualPredicate<int32_t>(0, 100));
+            std::unique_ptr<ColumnPredicate> predicate2(new LessPredicate<int32_t>(0, 500));
+            OlapReaderStatistics stats;
+            EXPECT_EQ(40, read_rows({predicate.get(), predicate2.get()}, &stats));
+            EXPECT_EQ(4056, stats.rows_bitmap_index_filtered);
+            EXPECT_EQ(40, stats.raw_rows_read);
+        }
+
+        // test where v1 > 1000, by the fewer bitmaps out of the range
+        {
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterPredicate<int32_t>(0, 1000));
+            OlapReaderStatistics stats;
+            EXPECT_EQ(3995, read_rows({predicate.get()}, &stats));
+            EXPECT_EQ(101, stats.rows_bitmap_index_filtered);
+        }
+
+        // test where v1 >= 100 and v1 < 500 with too many bitmaps to union, by reading the column
+        {
+            int32_t max_union_bitmaps = config::bitmap_index_max_range_union_bitmaps;
+            config::bitmap_index_max_range_union_bitmaps = 10;
+            std::unique_ptr<ColumnPredicate> predicate(new GreaterEqualPredicate<int32_t>(0, 100));
+            std::unique_ptr<ColumnPredicate> predicate2(new LessPredicate<int32_t>(0, 500));
+            OlapReaderStatistics stats;
+            EXPECT_EQ(40, read_rows({predicate.get(), predicate2.get()}, &stats));
+            EXPECT_EQ(0, stats.rows_bitmap_index_filtered);
+            config::bitmap_index_max_range_union_bitmaps = max_union_bitmaps;
+        }
     }
 }
 
@@ -1169,5 +1228,338 @@ TEST_F(SegmentReaderWriterTest, TestBloomFilterIndexUniqueModel) {
     EXPECT_TRUE(column_contains_index(seg2->footer().columns(3), BLOOM_FILTER_INDEX));
 }
 
+TEST_F(SegmentReaderWriterTest, TestRowLocations) {
+    TabletSchema tablet_schema = create_schema(
+            {create_int_key(1), create_int_key(2), create_int_value(3), create_int_value(4)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    shared_ptr<Segment> segment;
+    build_segment(opts, tablet_schema, tablet_schema, 4096, DefaultIntGenerator, &segment);
+
+    Schema schema(tablet_schema);
+    std::vector<uint32_t> return_columns = {0, 1, 2, 3};
+    // the rowids of the rows selected by the predicate are recorded
+    {
+        OlapReaderStatistics stats;
+        StorageReadOptions read_opts;
+        read_opts.stats = &stats;
+        read_opts.record_rowids = true;
+        std::unique_ptr<ColumnPredicate> predicate(new GreaterEqualPredicate<int32_t>(0, 40900));
+        read_opts.column_predicates.push_back(predicate.get());
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+
+        std::vector<uint32_t> rowids;
+        auto block = tablet_schema.create_block(return_columns);
+        while (iter->next_batch(&block).ok()) {
+            std::vector<RowLocation> locations;
+            EXPECT_TRUE(iter->current_block_row_locations(&locations).ok());
+            EXPECT_EQ(block.rows(), locations.size());
+            for (int i = 0; i < locations.size(); ++i) {
+                EXPECT_EQ(0, locations[i].segment_id);
+                EXPECT_EQ(locations[i].row_id * 10,
+                          block.get_by_position(0).column->get_int(i));
+                rowids.push_back(locations[i].row_id);
+            }
+            block.clear_column_data();
+        }
+        EXPECT_EQ(std::vector<uint32_t>({4090, 4091, 4092, 4093, 4094, 4095}), rowids);
+    }
+    // read the rows by the rowids
+    {
+        OlapReaderStatistics stats;
+        StorageReadOptions read_opts;
+        read_opts.stats = &stats;
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        auto segment_iter = dynamic_cast<SegmentIterator*>(iter.get());
+        EXPECT_TRUE(segment_iter != nullptr);
+
+        std::vector<rowid_t> rowids = {1, 2, 3, 100, 4000, 4095};
+        auto block = tablet_schema.create_block(return_columns);
+        EXPECT_TRUE(segment_iter->read_by_rowids(rowids.data(), rowids.size(), &block).ok());
+        EXPECT_EQ(rowids.size(), block.rows());
+        for (int cid = 0; cid < 4; ++cid) {
+            for (int i = 0; i < rowids.size(); ++i) {
+                EXPECT_EQ(rowids[i] * 10 + cid, block.get_by_position(cid).column->get_int(i));
+            }
+        }
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, TestLateRuntimeFilter) {
+    TabletSchema tablet_schema = create_schema(
+            {create_int_key(1), create_int_key(2), create_int_value(3), create_int_value(4)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    shared_ptr<Segment> segment;
+    build_segment(opts, tablet_schema, tablet_schema, 4096, DefaultIntGenerator, &segment);
+
+    Schema schema(tablet_schema);
+    std::vector<uint32_t> return_columns = {0, 1, 2, 3};
+    auto read_rows = [&](const std::vector<std::shared_ptr<LateRuntimeFilter>>& filters,
+                         OlapReaderStatistics* stats) {
+        StorageReadOptions read_opts;
+        read_opts.stats = stats;
+        read_opts.late_runtime_filters = &filters;
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        size_t rows = 0;
+        auto block = tablet_schema.create_block(return_columns);
+        while (iter->next_batch(&block).ok()) {
+            rows += block.rows();
+            block.clear_column_data();
+        }
+        return rows;
+    };
+
+    // column "1" is in [0, 40950]
+    TCondition condition;
+    condition.__set_column_name("1");
+    condition.__set_condition_op(">=");
+    condition.__set_condition_values({"50000"});
+
+    // not published yet when the segment is read
+    {
+        auto filter = std::make_shared<LateRuntimeFilter>();
+        OlapReaderStatistics stats;
+        EXPECT_EQ(4096, read_rows({filter}, &stats));
+        EXPECT_EQ(0, stats.rows_stats_filtered);
+    }
+    // all the pages are pruned by the zone map
+    {
+        auto filter = std::make_shared<LateRuntimeFilter>();
+        filter->publish({condition}, {});
+        OlapReaderStatistics stats;
+        EXPECT_EQ(0, read_rows({filter}, &stats));
+        EXPECT_EQ(4096, stats.rows_stats_filtered);
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, TestLateRuntimeFilterInFlight) {
+    TabletSchema tablet_schema = create_schema(
+            {create_int_key(1), create_int_key(2), create_int_value(3), create_int_value(4)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    shared_ptr<Segment> segment;
+    build_segment(opts, tablet_schema, tablet_schema, 4096, DefaultIntGenerator, &segment);
+
+    // the bloom filters of the rows in [2048, 2560) on the predicate column "1", and on the
+    // column "4" not read as a predicate column
+    auto bloom_filter = [](int cid) {
+        std::shared_ptr<IBloomFilterFuncBase> bloom_filter(
+                create_bloom_filter(PrimitiveType::TYPE_INT));
+        bloom_filter->init(4096, 0.05);
+        for (int32_t rid = 2048; rid < 2560; ++rid) {
+            int32_t value = rid * 10 + cid;
+            bloom_filter->insert(&value);
+        }
+        return bloom_filter;
+    };
+    auto filter = std::make_shared<LateRuntimeFilter>();
+    std::vector<std::shared_ptr<LateRuntimeFilter>> filters = {filter};
+
+    Schema schema(tablet_schema);
+    std::unique_ptr<ColumnPredicate> predicate(new GreaterEqualPredicate<int32_t>(0, 0));
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    read_opts.block_row_max = 1024;
+    read_opts.column_predicates = {predicate.get()};
+    read_opts.late_runtime_filters = &filters;
+    std::unique_ptr<RowwiseIterator> iter;
+    EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+
+    // the filter is published after the first block is read, the next blocks are filtered by its
+    // bloom filter on the predicate column
+    std::vector<uint32_t> return_columns = {0, 1, 2, 3};
+    auto block = tablet_schema.create_block(return_columns);
+    ASSERT_TRUE(iter->next_batch(&block).ok());
+    EXPECT_EQ(1024, block.rows());
+    block.clear_column_data();
+    auto column_filter = bloom_filter(0);
+    filter->publish({}, {{"1", column_filter}, {"4", bloom_filter(3)}});
+
+    std::vector<int64_t> rids;
+    while (iter->next_batch(&block).ok()) {
+        for (size_t i = 0; i < block.rows(); ++i) {
+            rids.push_back(block.get_by_position(0).column->get_int(i) / 10);
+        }
+        block.clear_column_data();
+    }
+    std::vector<int64_t> expected;
+    for (int32_t rid = 1024; rid < 4096; ++rid) {
+        int32_t value = rid * 10;
+        if (column_filter->find_olap_engine(&value)) {
+            expected.push_back(rid);
+        }
+    }
+    EXPECT_GE(expected.size(), 512);
+    EXPECT_LT(expected.size(), 3072);
+    EXPECT_EQ(expected, rids);
+    EXPECT_EQ(1, stats.runtime_filters_applied_in_flight);
+}
+
+TEST_F(SegmentReaderWriterTest, TestCancelledRead) {
+    TabletSchema tablet_schema = create_schema({create_int_key(1), create_int_value(2)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    shared_ptr<Segment> segment;
+    build_segment(opts, tablet_schema, tablet_schema, 4096, DefaultIntGenerator, &segment);
+
+    Schema schema(tablet_schema);
+    RuntimeState state {TQueryGlobals()};
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    read_opts.runtime_state = &state;
+    read_opts.block_row_max = 1024;
+    std::vector<uint32_t> return_columns = {0, 1};
+
+    // the read stops at the next block once the query is cancelled
+    {
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        auto block = tablet_schema.create_block(return_columns);
+        ASSERT_TRUE(iter->next_batch(&block).ok());
+        EXPECT_EQ(1024, block.rows());
+        block.clear_column_data();
+        state.set_is_cancelled(true);
+        EXPECT_TRUE(iter->next_batch(&block).is_cancelled());
+    }
+    // and the segment of the cancelled query isn't read at all
+    {
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        auto block = tablet_schema.create_block(return_columns);
+        EXPECT_TRUE(iter->next_batch(&block).is_cancelled());
+        EXPECT_EQ(0, block.rows());
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, TestSecondStagePredicate) {
+    TabletSchema tablet_schema =
+            create_schema({create_int_key(1), create_varchar_key(2), create_varchar_key(3)});
+    auto tracker = std::make_shared<MemTracker>();
+    MemPool pool(tracker.get());
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    // rid, rid % 10, rid
+    shared_ptr<Segment> segment;
+    build_segment(
+            opts, tablet_schema, tablet_schema, 4096,
+            [&](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+                cell.set_not_null();
+                set_column_value_by_type(tablet_schema.column(cid).type(),
+                                         cid == 1 ? rid % 10 : rid,
+                                         (char*)cell.mutable_cell_ptr(), &pool);
+            },
+            &segment);
+
+    Schema schema(tablet_schema);
+    std::vector<uint32_t> return_columns = {0, 1, 2};
+    // the column of the string predicate is read after the int predicate is evaluated, and the
+    // other string column after both
+    std::string value = "3";
+    std::unique_ptr<ColumnPredicate> int_predicate(new LessPredicate<int32_t>(0, 2000));
+    std::unique_ptr<ColumnPredicate> string_predicate(
+            new EqualPredicate<StringValue>(1, StringValue(value.data(), value.size())));
+
+    OlapReaderStatistics stats;
+    StorageReadOptions read_opts;
+    read_opts.stats = &stats;
+    read_opts.column_predicates = {string_predicate.get(), int_predicate.get()};
+    std::unique_ptr<RowwiseIterator> iter;
+    EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+
+    std::vector<int64_t> rids;
+    auto block = tablet_schema.create_block(return_columns);
+    while (iter->next_batch(&block).ok()) {
+        for (int i = 0; i < block.rows(); ++i) {
+            int64_t rid = block.get_by_position(0).column->get_int(i);
+            EXPECT_EQ("3", block.get_by_position(1).column->get_data_at(i).to_string());
+            EXPECT_EQ(std::to_string(rid),
+                      block.get_by_position(2).column->get_data_at(i).to_string());
+            rids.push_back(rid);
+        }
+        block.clear_column_data();
+    }
+    EXPECT_EQ(200, rids.size());
+    for (int i = 0; i < rids.size(); ++i) {
+        EXPECT_EQ(i * 10 + 3, rids[i]);
+    }
+}
+
+TEST_F(SegmentReaderWriterTest, TestConstantColumn) {
+    TabletSchema tablet_schema = create_schema({create_int_key(1), create_int_value(2)});
+
+    SegmentWriterOptions opts;
+    opts.num_rows_per_block = 10;
+
+    // rid, 7
+    shared_ptr<Segment> segment;
+    build_segment(
+            opts, tablet_schema, tablet_schema, 4096,
+            [](size_t rid, int cid, int block_id, RowCursorCell& cell) {
+                cell.set_not_null();
+                *(int*)cell.mutable_cell_ptr() = cid == 0 ? rid : 7;
+            },
+            &segment);
+
+    ColumnIterator* column_iter = nullptr;
+    ASSERT_TRUE(segment->new_column_iterator(0, &column_iter).ok());
+    EXPECT_EQ(nullptr, dynamic_cast<ConstantColumnIterator*>(column_iter));
+    delete column_iter;
+    ASSERT_TRUE(segment->new_column_iterator(1, &column_iter).ok());
+    EXPECT_NE(nullptr, dynamic_cast<ConstantColumnIterator*>(column_iter));
+    delete column_iter;
+
+    Schema schema(tablet_schema);
+    std::vector<uint32_t> return_columns = {0, 1};
+    auto read_rows = [&](ColumnPredicate* predicate, OlapReaderStatistics* stats) {
+        StorageReadOptions read_opts;
+        read_opts.stats = stats;
+        read_opts.column_predicates = {predicate};
+        std::unique_ptr<RowwiseIterator> iter;
+        EXPECT_TRUE(segment->new_iterator(schema, read_opts, &iter).ok());
+        size_t rows = 0;
+        auto block = tablet_schema.create_block(return_columns);
+        while (iter->next_batch(&block).ok()) {
+            for (int i = 0; i < block.rows(); ++i) {
+                EXPECT_EQ(rows + i, block.get_by_position(0).column->get_int(i));
+                EXPECT_EQ(7, block.get_by_position(1).column->get_int(i));
+            }
+            rows += block.rows();
+            block.clear_column_data();
+        }
+        return rows;
+    };
+
+    // all the rows satisfy the predicate
+    {
+        std::unique_ptr<ColumnPredicate> predicate(new LessPredicate<int32_t>(1, 10));
+        OlapReaderStatistics stats;
+        EXPECT_EQ(4096, read_rows(predicate.get(), &stats));
+        EXPECT_EQ(0, stats.rows_stats_filtered);
+    }
+    // no row satisfies the predicate
+    {
+        std::unique_ptr<ColumnPredicate> predicate(new EqualPredicate<int32_t>(1, 8));
+        OlapReaderStatistics stats;
+        EXPECT_EQ(0, read_rows(predicate.get(), &stats));
+        EXPECT_EQ(4096, stats.rows_stats_filtered);
+    }
+}
+
 } // namespace segment_v2
 } // namespace doris
@@ -86,7 +86,10 @@ public:
         Status status = column_zone_map.load(true, false);
         EXPECT_TRUE(status.ok());
         EXPECT_EQ(3, column_zone_map.num_pages());
-        const std::vector<ZoneMapPB>& zone_maps = column_zone_map.page_zone_maps();
+        std::vector<ZoneMapPB> zone_maps(column_zone_map.num_pages());
+        for (int32_t i = 0; i < column_zone_map.num_pages(); ++i) {
+            EXPECT_TRUE(column_zone_map.page_zone_map(i, &zone_maps[i]).ok());
+        }
         EXPECT_EQ(3, zone_maps.size());
         EXPECT_EQ("aaaa", zone_maps[0].min());
         EXPECT_EQ("ffff", zone_maps[0].max());
@@ -131,7 +134,10 @@ public:
         Status status = column_zone_map.load(true, false);
         EXPECT_TRUE(status.ok());
         EXPECT_EQ(1, column_zone_map.num_pages());
-        const std::vector<ZoneMapPB>& zone_maps = column_zone_map.page_zone_maps();
+        std::vector<ZoneMapPB> zone_maps(column_zone_map.num_pages());
+        for (int32_t i = 0; i < column_zone_map.num_pages(); ++i) {
+            EXPECT_TRUE(column_zone_map.page_zone_map(i, &zone_maps[i]).ok());
+        }
         EXPECT_EQ(1, zone_maps.size());
 
         char value[512];
@@ -182,7 +188,10 @@ TEST_F(ColumnZoneMapTest, NormalTestIntPage) {
     Status status = column_zone_map.load(true, false);
     EXPECT_TRUE(status.ok());
     EXPECT_EQ(3, column_zone_map.num_pages());
-    const std::vector<ZoneMapPB>& zone_maps = column_zone_map.page_zone_maps();
+    std::vector<ZoneMapPB> zone_maps(column_zone_map.num_pages());
+    for (int32_t i = 0; i < column_zone_map.num_pages(); ++i) {
+        EXPECT_TRUE(column_zone_map.page_zone_map(i, &zone_maps[i]).ok());
+    }
     EXPECT_EQ(3, zone_maps.size());
 
     EXPECT_EQ(std::to_string(1), zone_maps[0].min());
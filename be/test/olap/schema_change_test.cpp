@@ -27,6 +27,7 @@
 #include "olap/rowset/column_reader.h"
 #include "olap/rowset/column_writer.h"
 #include "olap/stream_name.h"
+#include "olap/wrapper_field.h"
 #include "runtime/mem_pool.h"
 #include "runtime/vectorized_row_batch.h"
 #include "util/logging.h"
@@ -1179,4 +1180,73 @@ TEST_F(TestColumn, ConvertCharToCount) {
     auto dst = mv_row_cursor.cell_ptr(1);
     EXPECT_EQ(*(int64_t*)dst, 1);
 }
+
+TEST_F(TestColumn, VectorizedChangeBlock) {
+    auto add_column = [](TabletSchemaPB* schema_pb, int32_t unique_id, const std::string& name,
+                         const std::string& type, bool is_key, bool is_nullable) {
+        ColumnPB* column = schema_pb->add_column();
+        column->set_unique_id(unique_id);
+        column->set_name(name);
+        column->set_type(type);
+        column->set_is_key(is_key);
+        column->set_length(type == "BIGINT" ? 8 : 4);
+        column->set_is_nullable(is_nullable);
+        column->set_is_bf_column(false);
+        if (!is_key) {
+            column->set_aggregation("NONE");
+        }
+    };
+    TabletSchemaPB base_schema_pb;
+    base_schema_pb.set_keys_type(KeysType::DUP_KEYS);
+    add_column(&base_schema_pb, 1, "k1", "INT", true, false);
+    add_column(&base_schema_pb, 2, "v1", "INT", false, true);
+    TabletSchema base_schema;
+    base_schema.init_from_pb(base_schema_pb);
+
+    // widen k1 to BIGINT, and add the column v2 of the default value 7
+    TabletSchemaPB new_schema_pb;
+    new_schema_pb.set_keys_type(KeysType::DUP_KEYS);
+    add_column(&new_schema_pb, 1, "k1", "BIGINT", true, false);
+    add_column(&new_schema_pb, 2, "v1", "INT", false, true);
+    add_column(&new_schema_pb, 3, "v2", "INT", false, false);
+    TabletSchema new_schema;
+    new_schema.init_from_pb(new_schema_pb);
+
+    RowBlockChanger row_block_changer(new_schema);
+    row_block_changer.get_mutable_column_mapping(0)->ref_column = 0;
+    row_block_changer.get_mutable_column_mapping(1)->ref_column = 1;
+    ColumnMapping* column_mapping = row_block_changer.get_mutable_column_mapping(2);
+    column_mapping->default_value = WrapperField::create(new_schema.column(2));
+    column_mapping->default_value->from_string("7");
+    BlockChanger block_changer(base_schema, new_schema, row_block_changer.get_schema_mapping());
+    EXPECT_TRUE(block_changer.is_supported());
+
+    vectorized::Block ref_block = base_schema.create_block({0, 1});
+    {
+        auto columns = ref_block.mutate_columns();
+        for (int32_t i = 0; i < 3; ++i) {
+            columns[0]->insert_data(reinterpret_cast<const char*>(&i), sizeof(i));
+            if (i == 1) {
+                columns[1]->insert_default();
+            } else {
+                int32_t value = i * 10;
+                columns[1]->insert_data(reinterpret_cast<const char*>(&value), sizeof(value));
+            }
+        }
+        ref_block.set_columns(std::move(columns));
+    }
+
+    vectorized::Block new_block = new_schema.create_block({0, 1, 2});
+    EXPECT_EQ(Status::OK(), block_changer.change_block(ref_block, &new_block));
+    EXPECT_EQ(3, new_block.rows());
+    for (int32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(i, new_block.get_by_position(0).column->get_int(i));
+        EXPECT_EQ(i == 1, new_block.get_by_position(1).column->is_null_at(i));
+        EXPECT_EQ(7, new_block.get_by_position(2).column->get_int(i));
+    }
+
+    // the materialized view functions are converted row by row
+    row_block_changer.get_mutable_column_mapping(1)->materialized_function = "count_field";
+    EXPECT_FALSE(block_changer.is_supported());
+}
 } // namespace doris
@@ -151,6 +151,12 @@ TEST_F(ShortKeyIndexTest, encode) {
                 // should be \x02\x80\x00\xD4\x31\x01
                 EXPECT_STREQ("028000D43101", hexdump(buf.c_str(), buf.size()).c_str());
             }
+            // full encode key, the same as encode key for the fixed length types
+            {
+                std::string buf;
+                full_encode_key(&buf, row, 2);
+                EXPECT_STREQ("028000D43101", hexdump(buf.c_str(), buf.size()).c_str());
+            }
         }
     }
 }
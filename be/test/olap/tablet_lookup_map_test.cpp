@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/tablet_lookup_map.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "olap/tablet_meta.h"
+
+namespace doris {
+
+class TabletLookupMapTest : public testing::Test {
+protected:
+    static TabletSharedPtr create_tablet(TTabletId tablet_id) {
+        TabletMetaSharedPtr tablet_meta(new TabletMeta(
+                1, 2, tablet_id, 4, 5, TTabletSchema(), 6, {{7, 8}}, UniqueId(9, 10),
+                TTabletType::TABLET_TYPE_DISK, TStorageMedium::HDD, ""));
+        StorageParamPB storage_param;
+        storage_param.set_storage_medium(StorageMediumPB::HDD);
+        return std::make_shared<Tablet>(tablet_meta, storage_param, nullptr);
+    }
+
+    // the ids of a shard of the tablet manager, which share their low bits
+    static std::vector<TabletSharedPtr> create_tablets(int num_tablets) {
+        std::vector<TabletSharedPtr> tablets;
+        for (int i = 0; i < num_tablets; ++i) {
+            tablets.push_back(create_tablet(10007 + i * 1024L));
+        }
+        return tablets;
+    }
+};
+
+TEST_F(TabletLookupMapTest, insert_erase) {
+    TabletLookupMap map;
+    EXPECT_EQ(nullptr, map.find(10007));
+    map.erase(10007);
+
+    auto tablets = create_tablets(3000);
+    for (size_t i = 0; i < tablets.size(); i += 2) {
+        map.insert_or_assign(tablets[i]->tablet_id(), tablets[i]);
+    }
+    for (size_t i = 0; i < tablets.size(); ++i) {
+        EXPECT_EQ(i % 2 == 0 ? tablets[i] : nullptr, map.find(tablets[i]->tablet_id()));
+    }
+
+    // assigning another tablet to the id, and erasing the ids not in the map
+    auto other_tablet = create_tablet(1);
+    map.insert_or_assign(tablets[0]->tablet_id(), other_tablet);
+    EXPECT_EQ(other_tablet, map.find(tablets[0]->tablet_id()));
+    for (size_t i = 1; i < tablets.size(); i += 2) {
+        map.erase(tablets[i]->tablet_id());
+    }
+    for (size_t i = 2; i < tablets.size(); i += 4) {
+        map.erase(tablets[i]->tablet_id());
+    }
+    for (size_t i = 1; i < tablets.size(); ++i) {
+        EXPECT_EQ(i % 4 == 0 ? tablets[i] : nullptr, map.find(tablets[i]->tablet_id()));
+    }
+
+    TabletLookupMap moved(std::move(map));
+    EXPECT_EQ(other_tablet, moved.find(tablets[0]->tablet_id()));
+    EXPECT_EQ(tablets[4], moved.find(tablets[4]->tablet_id()));
+}
+
+TEST_F(TabletLookupMapTest, concurrent_find) {
+    TabletLookupMap map;
+    auto tablets = create_tablets(2000);
+    // the even tablets stay in the map, the odd ones are inserted and erased by the writer
+    for (size_t i = 0; i < tablets.size(); i += 2) {
+        map.insert_or_assign(tablets[i]->tablet_id(), tablets[i]);
+    }
+
+    std::atomic<bool> stop = false;
+    std::atomic<int> num_errors = 0;
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&]() {
+            while (!stop) {
+                for (size_t i = 0; i < tablets.size(); ++i) {
+                    auto tablet = map.find(tablets[i]->tablet_id());
+                    if (tablet != nullptr ? tablet != tablets[i] : i % 2 == 0) {
+                        ++num_errors;
+                    }
+                }
+            }
+        });
+    }
+
+    for (int round = 0; round < 20; ++round) {
+        for (size_t i = 1; i < tablets.size(); i += 2) {
+            map.insert_or_assign(tablets[i]->tablet_id(), tablets[i]);
+        }
+        for (size_t i = 1; i < tablets.size(); i += 2) {
+            map.erase(tablets[i]->tablet_id());
+        }
+    }
+    stop = true;
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(0, num_errors);
+    for (size_t i = 0; i < tablets.size(); ++i) {
+        EXPECT_EQ(i % 2 == 0 ? tablets[i] : nullptr, map.find(tablets[i]->tablet_id()));
+    }
+}
+
+} // namespace doris
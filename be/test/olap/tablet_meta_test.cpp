@@ -41,4 +41,49 @@ TEST(TabletMetaTest, SaveAndParse) {
     EXPECT_EQ(old_tablet_meta, new_tablet_meta);
 }
 
+TEST(TabletMetaTest, DeleteBitmap) {
+    RowsetId rowset_id;
+    rowset_id.init(10001);
+    RowsetId other_rowset_id;
+    other_rowset_id.init(10002);
+
+    DeleteBitmap delete_bitmap;
+    EXPECT_TRUE(delete_bitmap.empty());
+    delete_bitmap.add({rowset_id, 0, 2}, 1);
+    delete_bitmap.add({rowset_id, 0, 3}, 5);
+    delete_bitmap.add({rowset_id, 0, 5}, 7);
+    delete_bitmap.add({rowset_id, 1, 3}, 2);
+    delete_bitmap.add({other_rowset_id, 0, 3}, 9);
+    EXPECT_TRUE(delete_bitmap.contains({rowset_id, 0, 3}, 5));
+    EXPECT_FALSE(delete_bitmap.contains({rowset_id, 0, 3}, 1));
+
+    // only the marks of versions <= 4 of segment 0 are aggregated
+    roaring::Roaring agg;
+    delete_bitmap.get_agg({rowset_id, 0, 4}, &agg);
+    EXPECT_EQ(2, agg.cardinality());
+    EXPECT_TRUE(agg.contains(1));
+    EXPECT_TRUE(agg.contains(5));
+    EXPECT_TRUE(delete_bitmap.contains_agg({rowset_id, 0, 5}, 7));
+    EXPECT_FALSE(delete_bitmap.contains_agg({rowset_id, 0, 4}, 7));
+
+    // the latest marks of segment 0 of versions <= the given one
+    EXPECT_EQ(3, delete_bitmap.max_version({rowset_id, 0, 4}));
+    EXPECT_EQ(5, delete_bitmap.max_version({rowset_id, 0, 100}));
+    EXPECT_EQ(-1, delete_bitmap.max_version({rowset_id, 0, 1}));
+    EXPECT_EQ(-1, delete_bitmap.max_version({rowset_id, 2, 100}));
+
+    DeleteBitmapPB delete_bitmap_pb;
+    delete_bitmap.to_pb(&delete_bitmap_pb);
+    DeleteBitmap parsed_delete_bitmap;
+    parsed_delete_bitmap.init_from_pb(delete_bitmap_pb);
+    EXPECT_TRUE(parsed_delete_bitmap.contains({rowset_id, 0, 5}, 7));
+    EXPECT_TRUE(parsed_delete_bitmap.contains({rowset_id, 1, 3}, 2));
+    EXPECT_TRUE(parsed_delete_bitmap.contains({other_rowset_id, 0, 3}, 9));
+
+    parsed_delete_bitmap.remove_rowset(rowset_id);
+    EXPECT_FALSE(parsed_delete_bitmap.contains_agg({rowset_id, 0, 5}, 7));
+    EXPECT_FALSE(parsed_delete_bitmap.contains_agg({rowset_id, 1, 5}, 2));
+    EXPECT_TRUE(parsed_delete_bitmap.contains({other_rowset_id, 0, 3}, 9));
+}
+
 } // namespace doris
@@ -126,6 +126,67 @@ TEST_F(TabletMgrTest, CreateTablet) {
     EXPECT_TRUE(trash_st == Status::OK());
 }
 
+TEST_F(TabletMgrTest, IncrementalReport) {
+    TColumnType col_type;
+    col_type.__set_type(TPrimitiveType::SMALLINT);
+    TColumn col1;
+    col1.__set_column_name("col1");
+    col1.__set_column_type(col_type);
+    col1.__set_is_key(true);
+    std::vector<TColumn> cols;
+    cols.push_back(col1);
+    TTabletSchema tablet_schema;
+    tablet_schema.__set_short_key_column_count(1);
+    tablet_schema.__set_schema_hash(3333);
+    tablet_schema.__set_keys_type(TKeysType::AGG_KEYS);
+    tablet_schema.__set_storage_type(TStorageType::COLUMN);
+    tablet_schema.__set_columns(cols);
+    TCreateTabletReq create_tablet_req;
+    create_tablet_req.__set_tablet_schema(tablet_schema);
+    create_tablet_req.__set_version(2);
+    std::vector<DataDir*> data_dirs;
+    data_dirs.push_back(_data_dir);
+    create_tablet_req.__set_tablet_id(111);
+    EXPECT_TRUE(_tablet_mgr->create_tablet(create_tablet_req, data_dirs).ok());
+
+    std::map<TTabletId, TTablet> tablets_info;
+    EXPECT_TRUE(_tablet_mgr->build_all_report_tablets_info(&tablets_info).ok());
+    EXPECT_EQ(1, tablets_info.size());
+    int64_t checksum = _tablet_mgr->report_tablets_checksum();
+    EXPECT_NE(0, checksum);
+
+    // nothing changed
+    tablets_info.clear();
+    EXPECT_TRUE(_tablet_mgr->build_incremental_report_tablets_info(&tablets_info).ok());
+    EXPECT_TRUE(tablets_info.empty());
+    EXPECT_EQ(checksum, _tablet_mgr->report_tablets_checksum());
+
+    // only the new tablet is reported
+    create_tablet_req.__set_tablet_id(222);
+    EXPECT_TRUE(_tablet_mgr->create_tablet(create_tablet_req, data_dirs).ok());
+    tablets_info.clear();
+    EXPECT_TRUE(_tablet_mgr->build_incremental_report_tablets_info(&tablets_info).ok());
+    EXPECT_EQ(1, tablets_info.size());
+    EXPECT_EQ(1, tablets_info.count(222));
+    EXPECT_NE(checksum, _tablet_mgr->report_tablets_checksum());
+
+    // marked dirty but the report info is not changed
+    _tablet_mgr->mark_tablet_report_dirty(111);
+    tablets_info.clear();
+    EXPECT_TRUE(_tablet_mgr->build_incremental_report_tablets_info(&tablets_info).ok());
+    EXPECT_TRUE(tablets_info.empty());
+
+    // the checksum is the same as the full report
+    checksum = _tablet_mgr->report_tablets_checksum();
+    EXPECT_TRUE(_tablet_mgr->build_all_report_tablets_info(&tablets_info).ok());
+    EXPECT_EQ(2, tablets_info.size());
+    EXPECT_EQ(checksum, _tablet_mgr->report_tablets_checksum());
+
+    EXPECT_TRUE(_tablet_mgr->drop_tablet(111, false).ok());
+    EXPECT_TRUE(_tablet_mgr->drop_tablet(222, false).ok());
+    EXPECT_TRUE(_tablet_mgr->start_trash_sweep().ok());
+}
+
 TEST_F(TabletMgrTest, CreateTabletWithSequence) {
     std::vector<TColumn> cols;
     TColumn col1;
@@ -324,4 +385,25 @@ TEST_F(TabletMgrTest, GetRowsetId) {
     }
 }
 
+TEST_F(TabletMgrTest, CostBasedCompactionPriority) {
+    constexpr int64_t MB = 1024 * 1024;
+    // nothing to merge away
+    EXPECT_EQ(0.0, TabletManager::calc_cost_based_compaction_priority(1, 100 * MB, 10));
+    EXPECT_EQ(0.0, TabletManager::calc_cost_based_compaction_priority(0, 0, 0));
+
+    // less bytes to rewrite for the same saving
+    EXPECT_GT(TabletManager::calc_cost_based_compaction_priority(10, 10 * MB, 0),
+              TabletManager::calc_cost_based_compaction_priority(10, 100 * MB, 0));
+    // the small inputs are counted as 1MB
+    EXPECT_EQ(TabletManager::calc_cost_based_compaction_priority(10, 1024, 0),
+              TabletManager::calc_cost_based_compaction_priority(10, MB, 0));
+    // a hot tablet goes before a cold tablet with a higher score
+    EXPECT_GT(TabletManager::calc_cost_based_compaction_priority(5, 10 * MB, 100),
+              TabletManager::calc_cost_based_compaction_priority(20, 10 * MB, 0));
+    // a tablet close to the version limit goes first
+    EXPECT_GT(TabletManager::calc_cost_based_compaction_priority(
+                      config::max_tablet_version_num / 2, 1024 * MB, 0),
+              TabletManager::calc_cost_based_compaction_priority(100, MB, 1000));
+}
+
 } // namespace doris
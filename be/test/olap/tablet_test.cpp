@@ -193,4 +193,19 @@ TEST_F(TestTablet, delete_expired_stale_rowset) {
     EXPECT_EQ(0, _tablet->_timestamped_version_tracker._stale_version_path_map.size());
     _tablet.reset();
 }
+
+// The scan heat is halved in each round before the bytes scanned in the round are added.
+TEST_F(TestTablet, update_scan_heat) {
+    StorageParamPB storage_param;
+    storage_param.set_storage_medium(StorageMediumPB::HDD);
+    TabletSharedPtr tablet(new Tablet(_tablet_meta, storage_param, nullptr));
+    tablet->init();
+
+    EXPECT_EQ(0, tablet->update_scan_heat());
+    tablet->query_scan_bytes->increment(1000);
+    EXPECT_EQ(1000, tablet->update_scan_heat());
+    EXPECT_EQ(500, tablet->update_scan_heat());
+    tablet->query_scan_bytes->increment(300);
+    EXPECT_EQ(550, tablet->update_scan_heat());
+}
 } // namespace doris
@@ -597,6 +597,39 @@ TEST_F(TestTimestampedVersionTracker, capture_consistent_versions_tracker) {
     EXPECT_EQ(Version(6, 8), version_path[3]);
 }
 
+TEST_F(TestTimestampedVersionTracker, capture_consistent_versions_tracker_cached) {
+    std::vector<RowsetMetaSharedPtr> rs_metas;
+    std::vector<Version> version_path;
+
+    init_all_rs_meta(&rs_metas);
+
+    TimestampedVersionTracker tracker;
+    tracker.construct_versioned_tracker(rs_metas);
+
+    Version spec_version(0, 9);
+    EXPECT_TRUE(tracker.capture_consistent_versions(spec_version, &version_path).ok());
+    EXPECT_EQ(4, version_path.size());
+
+    // captured again from the cache
+    version_path.clear();
+    EXPECT_TRUE(tracker.capture_consistent_versions(spec_version, &version_path).ok());
+    EXPECT_EQ(4, version_path.size());
+    EXPECT_EQ(Version(0, 0), version_path[0]);
+    EXPECT_EQ(Version(6, 9), version_path[3]);
+
+    // the cached path is invalidated by the merged version
+    tracker.add_version(Version(0, 5));
+    version_path.clear();
+    EXPECT_TRUE(tracker.capture_consistent_versions(spec_version, &version_path).ok());
+    EXPECT_EQ(2, version_path.size());
+    EXPECT_EQ(Version(0, 5), version_path[0]);
+    EXPECT_EQ(Version(6, 9), version_path[1]);
+
+    // a version out of the graph is not cached
+    EXPECT_FALSE(tracker.capture_consistent_versions(Version(0, 20), &version_path).ok());
+    EXPECT_FALSE(tracker.capture_consistent_versions(Version(0, 20), &version_path).ok());
+}
+
 TEST_F(TestTimestampedVersionTracker, capture_consistent_versions_tracker_with_same_rowset) {
     std::vector<RowsetMetaSharedPtr> rs_metas;
     std::vector<RowsetMetaSharedContainerPtr> expired_rs_metas;
@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "olap/topn_predicate.h"
+
+#include <gtest/gtest.h>
+
+#include "olap/comparison_predicate.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/predicate_column.h"
+
+using namespace doris::vectorized;
+
+namespace doris {
+
+class TopNPredicateTest : public testing::Test {
+public:
+    // k1 = 0..9, the rows 3 and 7 are null
+    void SetUp() override {
+        _column = ColumnNullable::create(PredicateColumnType<int32_t>::create(),
+                                         ColumnUInt8::create());
+        for (int32_t i = 0; i < 10; ++i) {
+            if (i == 3 || i == 7) {
+                _column->insert_data(nullptr, 0);
+            } else {
+                _column->insert_data(reinterpret_cast<const char*>(&i), sizeof(i));
+            }
+        }
+    }
+
+    static TopNColumnPredicate::PredicateCreator creator(bool is_asc) {
+        return [is_asc](const std::string& value) -> ColumnPredicate* {
+            int32_t v = std::stoi(value);
+            if (is_asc) {
+                return new LessEqualPredicate<int32_t>(0, v);
+            }
+            return new GreaterEqualPredicate<int32_t>(0, v);
+        };
+    }
+
+    std::vector<uint16_t> evaluate(const TopNColumnPredicate& pred) {
+        std::vector<uint16_t> sel(_column->size());
+        for (uint16_t i = 0; i < sel.size(); ++i) {
+            sel[i] = i;
+        }
+        uint16_t size = sel.size();
+        pred.evaluate(*_column, sel.data(), &size);
+        sel.resize(size);
+        return sel;
+    }
+
+protected:
+    MutableColumnPtr _column;
+};
+
+TEST_F(TopNPredicateTest, asc_nulls_last) {
+    auto runtime_predicate = std::make_shared<TopNRuntimePredicate>(true, false);
+    TopNColumnPredicate pred(0, "k1", runtime_predicate, creator(true));
+    EXPECT_EQ(PredicateType::LE, pred.type());
+
+    // no boundary yet, all the rows pass
+    TCondition condition;
+    EXPECT_FALSE(pred.get_condition(&condition));
+    EXPECT_EQ(10, evaluate(pred).size());
+
+    runtime_predicate->update("5");
+    EXPECT_EQ(std::vector<uint16_t>({0, 1, 2, 4, 5}), evaluate(pred));
+    EXPECT_TRUE(pred.get_condition(&condition));
+    EXPECT_EQ("k1", condition.column_name);
+    EXPECT_EQ("<=", condition.condition_op);
+    EXPECT_EQ(std::vector<std::string>({"5"}), condition.condition_values);
+
+    // the boundary tightens
+    runtime_predicate->update("1");
+    EXPECT_EQ(std::vector<uint16_t>({0, 1}), evaluate(pred));
+}
+
+TEST_F(TopNPredicateTest, desc_nulls_first) {
+    auto runtime_predicate = std::make_shared<TopNRuntimePredicate>(false, true);
+    TopNColumnPredicate pred(0, "k1", runtime_predicate, creator(false));
+    EXPECT_EQ(PredicateType::GE, pred.type());
+
+    runtime_predicate->update("6");
+    EXPECT_EQ(std::vector<uint16_t>({3, 6, 7, 8, 9}), evaluate(pred));
+
+    std::unique_ptr<bool[]> flags(new bool[_column->size()]);
+    pred.evaluate_vec(*_column, _column->size(), flags.get());
+    for (uint16_t i = 0; i < _column->size(); ++i) {
+        EXPECT_EQ(i == 3 || i >= 6, flags[i]) << "row " << i;
+    }
+
+    TCondition condition;
+    EXPECT_TRUE(pred.get_condition(&condition));
+    EXPECT_EQ(">=", condition.condition_op);
+}
+
+} // namespace doris
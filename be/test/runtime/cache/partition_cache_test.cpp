@@ -42,7 +42,8 @@ private:
         LOG(WARNING) << "init test default\n";
         init(16, 4);
     }
-    void init(int max_size, int ela_size);
+    void init(int max_size, int ela_size, const std::string& spill_path = "",
+              int spill_max_size = 0);
     void clear();
     PCacheStatus init_batch_data(int sql_num, int part_begin, int part_num, CacheType cache_type);
     ResultCache* _cache;
@@ -54,9 +55,10 @@ private:
     PCacheResponse* _clear_response;
 };
 
-void PartitionCacheTest::init(int max_size, int ela_size) {
+void PartitionCacheTest::init(int max_size, int ela_size, const std::string& spill_path,
+                              int spill_max_size) {
     LOG(WARNING) << "init test\n";
-    _cache = new ResultCache(max_size, ela_size);
+    _cache = new ResultCache(max_size, ela_size, spill_path, spill_max_size);
     _update_request = new PUpdateCacheRequest();
     _update_response = new PCacheResponse();
     _fetch_request = new PFetchCacheRequest();
@@ -308,6 +310,56 @@ TEST_F(PartitionCacheTest, fetch_not_continue_partition) {
     clear();
 }
 
+TEST_F(PartitionCacheTest, compress_data) {
+    init_default();
+    set_sql_key(_update_request->mutable_sql_key(), 1, 1);
+    PCacheValue* value = _update_request->add_values();
+    value->mutable_param()->set_partition_key(1);
+    value->mutable_param()->set_last_version(1);
+    value->mutable_param()->set_last_version_time(1);
+    value->set_data_size(16 * 1024);
+    for (int i = 0; i < 1024; i++) {
+        value->add_rows("0123456789abcdef");
+    }
+    _update_request->set_cache_type(CacheType::SQL_CACHE);
+    _cache->update(_update_request, _update_response);
+    EXPECT_TRUE(_update_response->status() == PCacheStatus::CACHE_OK);
+    EXPECT_LT(_cache->get_cache_size(), 16 * 1024);
+
+    set_sql_key(_fetch_request->mutable_sql_key(), 1, 1);
+    PCacheParam* p1 = _fetch_request->add_params();
+    p1->set_partition_key(1);
+    p1->set_last_version(1);
+    p1->set_last_version_time(1);
+    _cache->fetch(_fetch_request, _fetch_result);
+    EXPECT_TRUE(_fetch_result->status() == PCacheStatus::CACHE_OK);
+    EXPECT_EQ(_fetch_result->values_size(), 1);
+    EXPECT_EQ(_fetch_result->values(0).rows_size(), 1024);
+    EXPECT_EQ(_fetch_result->values(0).rows(1023), "0123456789abcdef");
+    clear();
+}
+
+TEST_F(PartitionCacheTest, spill_data) {
+    EXPECT_EQ(system("rm -rf ./ut_dir/result_cache_spill && mkdir -p ./ut_dir/result_cache_spill"),
+              0);
+    init(1, 1, "./ut_dir/result_cache_spill", 64);
+    init_batch_data(100, 1, 1024, CacheType::PARTITION_CACHE); // about 30*1024*100=3M
+    EXPECT_LE(_cache->get_cache_size(), 1 * 1024 * 1024);
+    EXPECT_GT(_cache->get_spill_size(), 0);
+
+    // the first partitions are spilled, and read back from the spill files
+    set_sql_key(_fetch_request->mutable_sql_key(), 1, 1);
+    PCacheParam* p1 = _fetch_request->add_params();
+    p1->set_partition_key(1);
+    p1->set_last_version(1);
+    p1->set_last_version_time(1);
+    _cache->fetch(_fetch_request, _fetch_result);
+    EXPECT_TRUE(_fetch_result->status() == PCacheStatus::CACHE_OK);
+    EXPECT_EQ(_fetch_result->values_size(), 1);
+    EXPECT_EQ(_fetch_result->values(0).rows(0), "0123456789abcdef");
+    clear();
+}
+
 TEST_F(PartitionCacheTest, update_sql_cache) {
     init_default();
     init_batch_data(1, 1, 1, CacheType::SQL_CACHE);
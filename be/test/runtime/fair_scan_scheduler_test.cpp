@@ -0,0 +1,103 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/fair_scan_scheduler.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "util/countdown_latch.h"
+
+namespace doris {
+
+static TUniqueId query_id(int64_t lo) {
+    TUniqueId id;
+    id.hi = 0;
+    id.lo = lo;
+    return id;
+}
+
+class FairScanSchedulerTest : public testing::Test {
+protected:
+    // run the tasks of the queries by a single thread, after they are all queued
+    std::vector<int64_t> run(const std::vector<std::pair<int64_t, int>>& tasks) {
+        PriorityThreadPool thread_pool(1, 100);
+        FairScanScheduler scheduler(&thread_pool);
+        std::mutex lock;
+        std::vector<int64_t> order;
+
+        CountDownLatch latch(1);
+        EXPECT_TRUE(scheduler.offer(query_id(0), 1, {0, [&latch]() { latch.wait(); }, 0}));
+        for (auto [id, weight] : tasks) {
+            auto work = [&lock, &order, id = id]() {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                std::lock_guard<std::mutex> l(lock);
+                order.push_back(id);
+            };
+            EXPECT_TRUE(scheduler.offer(query_id(id), weight, {0, work, 0}));
+        }
+        latch.count_down();
+        thread_pool.drain_and_shutdown();
+        return order;
+    }
+};
+
+TEST_F(FairScanSchedulerTest, ShareBetweenQueries) {
+    // the big query queues all its tasks before the small query
+    auto order = run({{1, 1}, {1, 1}, {1, 1}, {1, 1}, {2, 1}, {2, 1}});
+    ASSERT_EQ(6, order.size());
+    auto last_small = std::find(order.rbegin(), order.rend(), 2);
+    // the small query doesn't wait for all the tasks of the big query
+    EXPECT_EQ(1, order.back());
+    EXPECT_GE(std::distance(order.rbegin(), last_small), 2);
+}
+
+TEST_F(FairScanSchedulerTest, Weight) {
+    auto order = run({{1, 1}, {1, 1}, {1, 1}, {1, 1}, {2, 8}, {2, 8}, {2, 8}, {2, 8}});
+    ASSERT_EQ(8, order.size());
+    // the query with the bigger weight runs 4 tasks while the other one runs at most 1
+    EXPECT_EQ(4, std::count(order.begin(), order.begin() + 5, 2));
+}
+
+TEST_F(FairScanSchedulerTest, PreferSameQueue) {
+    // the tasks are only queued by the scheduler, and run by the test
+    PriorityThreadPool thread_pool(1, 100);
+    thread_pool.shutdown();
+    FairScanScheduler scheduler(&thread_pool);
+    std::vector<int> order;
+    std::vector<int> queue_ids = {0, 0, 1, 0, 1};
+    for (int i = 0; i < 5; ++i) {
+        EXPECT_FALSE(scheduler.offer(query_id(1), 1,
+                                     {0, [&order, i]() { order.push_back(i); }, queue_ids[i]}));
+    }
+    // a thread of the queue 1 runs the tasks of the queue first, then the other ones in order
+    for (int i = 0; i < 3; ++i) {
+        scheduler._run_next(1);
+    }
+    EXPECT_EQ(std::vector<int>({2, 4, 0}), order);
+    scheduler._run_next(0);
+    scheduler._run_next(0);
+    EXPECT_EQ(std::vector<int>({2, 4, 0, 1, 3}), order);
+    EXPECT_TRUE(scheduler._queues.empty());
+}
+
+} // namespace doris
@@ -0,0 +1,251 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/group_commit_mgr.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+
+#include "common/config.h"
+#include "gen_cpp/FrontendService_types.h"
+#include "gen_cpp/HeartbeatService_types.h"
+#include "runtime/exec_env.h"
+#include "runtime/message_body_sink.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_context.h"
+#include "runtime/stream_load/stream_load_executor.h"
+#include "util/file_utils.h"
+
+namespace doris {
+
+extern TLoadTxnBeginResult k_stream_load_begin_result;
+extern TLoadTxnCommitResult k_stream_load_commit_result;
+extern TLoadTxnRollbackResult k_stream_load_rollback_result;
+extern TStreamLoadPutResult k_stream_load_put_result;
+extern Status k_stream_load_plan_status;
+
+static const uint32_t MAX_PATH_LEN = 1024;
+
+class GroupCommitMgrTest : public testing::Test {
+protected:
+    void SetUp() override {
+        k_stream_load_begin_result = TLoadTxnBeginResult();
+        k_stream_load_begin_result.__set_txnId(1001);
+        k_stream_load_commit_result = TLoadTxnCommitResult();
+        k_stream_load_rollback_result = TLoadTxnRollbackResult();
+        k_stream_load_put_result = TStreamLoadPutResult();
+        k_stream_load_plan_status = Status::OK();
+
+        _env._master_info = new TMasterInfo();
+        _env._master_info->network_address.hostname = "127.0.0.1";
+        _env._master_info->network_address.port = 9020;
+        _env._load_stream_mgr = new LoadStreamMgr();
+        _env._stream_load_executor = new StreamLoadExecutor(&_env);
+
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        config::group_commit_wal_path = std::string(buffer) + "/group_commit_wal_test";
+        FileUtils::remove_all(config::group_commit_wal_path);
+        // the batches are flushed and retried only when the tests let them
+        config::group_commit_interval_ms = 3600 * 1000;
+        config::group_commit_retry_interval_ms = 3600 * 1000;
+    }
+
+    void TearDown() override {
+        _mgr.reset();
+        FileUtils::remove_all(config::group_commit_wal_path);
+        config::group_commit_wal_path = _wal_path;
+        config::group_commit_interval_ms = _interval_ms;
+        config::group_commit_retry_interval_ms = _retry_interval_ms;
+
+        delete _env._stream_load_executor;
+        _env._stream_load_executor = nullptr;
+        delete _env._load_stream_mgr;
+        _env._load_stream_mgr = nullptr;
+        delete _env._master_info;
+        _env._master_info = nullptr;
+    }
+
+    void start_mgr() {
+        _mgr = std::make_unique<GroupCommitMgr>(&_env);
+        ASSERT_TRUE(_mgr->init().ok());
+    }
+
+    // a load of the table whose body is written to its wal, the wal is committed if `commit`
+    StreamLoadContext* add_load(const std::string& body, bool commit) {
+        StreamLoadContext* ctx = new StreamLoadContext(&_env);
+        ctx->ref();
+        ctx->db = "db1";
+        ctx->table = "tbl1";
+        ctx->auth.user = "root";
+        ctx->group_commit = true;
+        ctx->body_bytes = body.size();
+        _loads.emplace_back(ctx);
+
+        TStreamLoadPutRequest request;
+        request.db = ctx->db;
+        request.tbl = ctx->table;
+        request.user = ctx->auth.user;
+        request.passwd = "";
+        EXPECT_TRUE(_mgr->join(ctx, request).ok());
+        EXPECT_TRUE(ctx->body_sink->append(body.data(), body.size()).ok());
+        EXPECT_TRUE(ctx->body_sink->finish().ok());
+        ctx->body_sink.reset();
+        if (commit) {
+            EXPECT_TRUE(_mgr->commit_wal(ctx).ok());
+        }
+        return ctx;
+    }
+
+    static bool wait_for(const std::function<bool()>& done) {
+        for (int i = 0; i < 200; ++i) {
+            if (done()) {
+                return true;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        }
+        return false;
+    }
+
+    static bool exists(const std::string& path) { return FileUtils::check_exist(path); }
+
+    size_t num_failed_batches() {
+        std::lock_guard<std::mutex> l(_mgr->_lock);
+        return _mgr->_failed_batches.size();
+    }
+
+    struct LoadDeleter {
+        void operator()(StreamLoadContext* ctx) {
+            if (ctx->unref()) {
+                delete ctx;
+            }
+        }
+    };
+
+    ExecEnv _env;
+    std::unique_ptr<GroupCommitMgr> _mgr;
+    std::vector<std::unique_ptr<StreamLoadContext, LoadDeleter>> _loads;
+    std::string _wal_path = config::group_commit_wal_path;
+    int32_t _interval_ms = config::group_commit_interval_ms;
+    int32_t _retry_interval_ms = config::group_commit_retry_interval_ms;
+};
+
+TEST_F(GroupCommitMgrTest, commit) {
+    start_mgr();
+    StreamLoadContext* load1 = add_load("1,a\n2,b\n", true);
+    StreamLoadContext* load2 = add_load("3,c", true);
+    // both loads join the batch of the table
+    EXPECT_EQ(load1->group_commit_label, load2->group_commit_label);
+    EXPECT_EQ(1001, load1->txn_id);
+    EXPECT_EQ(1001, load2->txn_id);
+    std::string dir = config::group_commit_wal_path + "/" + load1->group_commit_label;
+    EXPECT_TRUE(exists(dir + "/meta"));
+    std::string wal = dir + "/" + load1->id.to_string();
+    EXPECT_TRUE(exists(wal));
+    EXPECT_FALSE(exists(wal + ".tmp"));
+
+    // the batch is flushed once it's expired, and its dir is removed after it's committed
+    config::group_commit_interval_ms = 0;
+    EXPECT_TRUE(wait_for([&]() { return !exists(dir); }));
+    EXPECT_EQ(0, num_failed_batches());
+}
+
+TEST_F(GroupCommitMgrTest, abort) {
+    start_mgr();
+    StreamLoadContext* load1 = add_load("1,a\n", true);
+    StreamLoadContext* load2 = add_load("2,b\n", false);
+    std::string dir = config::group_commit_wal_path + "/" + load1->group_commit_label;
+    std::string wal = dir + "/" + load2->id.to_string();
+    EXPECT_TRUE(exists(wal + ".tmp"));
+    _mgr->abort(load2);
+    EXPECT_FALSE(exists(wal + ".tmp"));
+    EXPECT_FALSE(exists(wal));
+    EXPECT_TRUE(load2->group_commit_wal.empty());
+    EXPECT_FALSE(_mgr->commit_wal(load2).ok());
+
+    config::group_commit_interval_ms = 0;
+    EXPECT_TRUE(wait_for([&]() { return !exists(dir); }));
+}
+
+TEST_F(GroupCommitMgrTest, retry_failed_batch) {
+    start_mgr();
+    StreamLoadContext* load = add_load("1,a\n", true);
+    std::string dir = config::group_commit_wal_path + "/" + load->group_commit_label;
+    std::string wal = dir + "/" + load->id.to_string();
+
+    // the wal is kept when the batch fails to load
+    k_stream_load_plan_status = Status::InternalError("failed to load");
+    config::group_commit_interval_ms = 0;
+    EXPECT_TRUE(wait_for([&]() { return num_failed_batches() == 1; }));
+    EXPECT_TRUE(exists(wal));
+
+    // and the batch is loaded again in a new transaction of its label
+    k_stream_load_plan_status = Status::OK();
+    k_stream_load_begin_result.__set_txnId(1002);
+    config::group_commit_retry_interval_ms = 0;
+    EXPECT_TRUE(wait_for([&]() { return !exists(dir); }));
+    EXPECT_EQ(0, num_failed_batches());
+}
+
+TEST_F(GroupCommitMgrTest, replay) {
+    start_mgr();
+    StreamLoadContext* load1 = add_load("1,a\n", true);
+    StreamLoadContext* load2 = add_load("2,b\n", false);
+    std::string dir = config::group_commit_wal_path + "/" + load1->group_commit_label;
+    std::string wal1 = dir + "/" + load1->id.to_string();
+    std::string wal2 = dir + "/" + load2->id.to_string();
+    // the be crashes before the batch is flushed
+    load2->group_commit_wal.clear();
+    _mgr.reset();
+    EXPECT_TRUE(exists(wal1));
+    EXPECT_TRUE(exists(wal2 + ".tmp"));
+
+    // the wal not acknowledged is removed, the batch is kept while it can't be loaded
+    k_stream_load_begin_result.status.__set_status_code(TStatusCode::INTERNAL_ERROR);
+    config::group_commit_retry_interval_ms = 0;
+    start_mgr();
+    EXPECT_TRUE(wait_for([&]() { return !exists(wal2 + ".tmp"); }));
+    EXPECT_TRUE(exists(wal1));
+    EXPECT_FALSE(exists(wal2));
+
+    k_stream_load_begin_result.status.__set_status_code(TStatusCode::OK);
+    EXPECT_TRUE(wait_for([&]() { return !exists(dir); }));
+    EXPECT_EQ(0, num_failed_batches());
+}
+
+TEST_F(GroupCommitMgrTest, replay_committed_batch) {
+    start_mgr();
+    StreamLoadContext* load = add_load("1,a\n", true);
+    std::string dir = config::group_commit_wal_path + "/" + load->group_commit_label;
+    _mgr.reset();
+    EXPECT_TRUE(exists(dir));
+
+    // the label is used by the committed transaction of the batch, so it's not loaded again
+    k_stream_load_begin_result.status.__set_status_code(TStatusCode::LABEL_ALREADY_EXISTS);
+    k_stream_load_begin_result.__set_job_status("COMMITTED");
+    k_stream_load_plan_status = Status::InternalError("the batch should not be loaded");
+    config::group_commit_retry_interval_ms = 0;
+    start_mgr();
+    EXPECT_TRUE(wait_for([&]() { return !exists(dir); }));
+    EXPECT_EQ(0, num_failed_batches());
+}
+
+} // namespace doris
@@ -0,0 +1,149 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/memtable_memory_manager.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "common/config.h"
+#include "runtime/mem_tracker.h"
+#include "util/time.h"
+
+namespace doris {
+
+// the writers are only compared by the flushes, they are never dereferenced
+static DeltaWriter* writer(uintptr_t i) {
+    return reinterpret_cast<DeltaWriter*>(i);
+}
+
+TEST(MemTableMemoryManagerTest, mem_to_flush) {
+    // nothing is flushed under the soft limit
+    EXPECT_LE(MemTableMemoryManager::_mem_to_flush(699, 700, 0), 0);
+    EXPECT_EQ(100, MemTableMemoryManager::_mem_to_flush(800, 700, 0));
+    // the memtables being flushed are counted as released
+    EXPECT_EQ(40, MemTableMemoryManager::_mem_to_flush(800, 700, 60));
+    EXPECT_LE(MemTableMemoryManager::_mem_to_flush(800, 700, 100), 0);
+    EXPECT_LE(MemTableMemoryManager::_mem_to_flush(800, 700, 300), 0);
+}
+
+TEST(MemTableMemoryManagerTest, flush_largest) {
+    std::vector<std::pair<int64_t, DeltaWriter*>> memtables = {
+            {10, writer(1)}, {50, writer(2)}, {30, writer(3)}, {40, writer(4)}, {20, writer(5)}};
+    std::vector<DeltaWriter*> flushed;
+    auto flush = [&](DeltaWriter* w) {
+        flushed.push_back(w);
+        return Status::OK();
+    };
+
+    // the largest memtables till the bytes to flush are reached
+    int num_flushed = 0;
+    EXPECT_EQ(90, MemTableMemoryManager::_flush_largest(memtables, 80, flush, &num_flushed));
+    EXPECT_EQ(2, num_flushed);
+    EXPECT_EQ((std::vector<DeltaWriter*> {writer(2), writer(4)}), flushed);
+
+    flushed.clear();
+    EXPECT_EQ(50, MemTableMemoryManager::_flush_largest(memtables, 50, flush, &num_flushed));
+    EXPECT_EQ(1, num_flushed);
+    EXPECT_EQ((std::vector<DeltaWriter*> {writer(2)}), flushed);
+
+    // all of them if they are not enough
+    flushed.clear();
+    EXPECT_EQ(150, MemTableMemoryManager::_flush_largest(memtables, 1000, flush, &num_flushed));
+    EXPECT_EQ(5, num_flushed);
+    EXPECT_EQ((std::vector<DeltaWriter*> {writer(2), writer(4), writer(3), writer(5), writer(1)}),
+              flushed);
+
+    flushed.clear();
+    EXPECT_EQ(0, MemTableMemoryManager::_flush_largest({}, 80, flush, &num_flushed));
+    EXPECT_EQ(0, num_flushed);
+    EXPECT_TRUE(flushed.empty());
+}
+
+TEST(MemTableMemoryManagerTest, flush_largest_with_failure) {
+    std::vector<std::pair<int64_t, DeltaWriter*>> memtables = {
+            {10, writer(1)}, {50, writer(2)}, {30, writer(3)}, {40, writer(4)}};
+    std::vector<DeltaWriter*> flushed;
+    // the failed memtable is not counted, the next largest one is flushed instead
+    auto flush = [&](DeltaWriter* w) {
+        flushed.push_back(w);
+        return w == writer(4) ? Status::InternalError("failed to flush") : Status::OK();
+    };
+    int num_flushed = 0;
+    EXPECT_EQ(80, MemTableMemoryManager::_flush_largest(memtables, 80, flush, &num_flushed));
+    EXPECT_EQ(2, num_flushed);
+    EXPECT_EQ((std::vector<DeltaWriter*> {writer(2), writer(4), writer(3)}), flushed);
+}
+
+class MemTableMemoryManagerLimitTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _load_mem_tracker = MemTracker::create_tracker(1000, "MemTableMemoryManagerLimitTest");
+        ASSERT_TRUE(_manager.init(_load_mem_tracker).ok());
+    }
+
+    void TearDown() override {
+        _load_mem_tracker->release(_load_mem_tracker->consumption());
+        config::load_memtable_mem_wait_max_ms = _wait_max_ms;
+    }
+
+    // the milliseconds waited for the memory under the limit
+    int64_t wait_ms() {
+        int64_t start_ms = MonotonicMillis();
+        _manager.wait_until_under_limit();
+        return MonotonicMillis() - start_ms;
+    }
+
+    std::shared_ptr<MemTracker> _load_mem_tracker;
+    MemTableMemoryManager _manager;
+    int32_t _wait_max_ms = config::load_memtable_mem_wait_max_ms;
+};
+
+TEST_F(MemTableMemoryManagerLimitTest, under_limit) {
+    // above the soft limit but under the hard one, the request doesn't wait
+    config::load_memtable_mem_wait_max_ms = 60 * 1000;
+    _load_mem_tracker->consume(900);
+    EXPECT_LT(wait_ms(), 1000);
+}
+
+TEST_F(MemTableMemoryManagerLimitTest, wait_max_ms) {
+    // the memory can't be reduced without any memtables, the request waits at most the max time
+    config::load_memtable_mem_wait_max_ms = 300;
+    _load_mem_tracker->consume(1200);
+    int64_t ms = wait_ms();
+    EXPECT_GE(ms, 300);
+    EXPECT_LT(ms, 300 + 1000);
+}
+
+TEST_F(MemTableMemoryManagerLimitTest, wait_until_released) {
+    // the request returns once the memory is released by the flushes
+    config::load_memtable_mem_wait_max_ms = 60 * 1000;
+    _load_mem_tracker->consume(1200);
+    std::thread flush([this]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        _load_mem_tracker->release(500);
+    });
+    int64_t ms = wait_ms();
+    flush.join();
+    EXPECT_GE(ms, 200);
+    EXPECT_LT(ms, 10 * 1000);
+    EXPECT_FALSE(_load_mem_tracker->limit_exceeded());
+}
+
+} // namespace doris
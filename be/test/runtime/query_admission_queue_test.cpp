@@ -0,0 +1,138 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_admission_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "common/config.h"
+
+namespace doris {
+
+static TUniqueId query_id(int64_t lo) {
+    TUniqueId id;
+    id.hi = 0;
+    id.lo = lo;
+    return id;
+}
+
+class QueryAdmissionQueueTest : public testing::Test {
+public:
+    void SetUp() override {
+        _max_running_queries = config::query_queue_max_running_queries;
+        _reservable_mem_percent = config::query_queue_reservable_mem_percent;
+        config::query_queue_max_running_queries = 2;
+        config::query_queue_reservable_mem_percent = 0;
+    }
+
+    void TearDown() override {
+        config::query_queue_max_running_queries = _max_running_queries;
+        config::query_queue_reservable_mem_percent = _reservable_mem_percent;
+    }
+
+protected:
+    // admit a fragment of the query, the admitted and the timed out queries are recorded
+    bool admit(int64_t id, int priority = 0, int64_t mem_reservation = 0,
+               int64_t timeout_ms = 60000) {
+        return _queue.admit(query_id(id), mem_reservation, priority, timeout_ms,
+                            [this, id](const Status& status, int64_t wait_ms) {
+                                (status.ok() ? _admitted : _timed_out).push_back(id);
+                            });
+    }
+
+    int64_t _process_mem_limit = -1;
+    QueryAdmissionQueue _queue {[this]() { return _process_mem_limit; }};
+    std::vector<int64_t> _admitted;
+    std::vector<int64_t> _timed_out;
+
+private:
+    int32_t _max_running_queries;
+    int32_t _reservable_mem_percent;
+};
+
+TEST_F(QueryAdmissionQueueTest, MaxRunningQueries) {
+    EXPECT_TRUE(admit(1));
+    EXPECT_TRUE(admit(2));
+    // the other fragments of the running queries run at once
+    EXPECT_TRUE(admit(2));
+    EXPECT_FALSE(admit(3));
+    EXPECT_FALSE(admit(3));
+    EXPECT_EQ(2, _queue.num_running_queries());
+    EXPECT_EQ(1, _queue.num_waiting_queries());
+
+    _queue.release(2);
+    EXPECT_TRUE(_admitted.empty());
+    _queue.release(2);
+    // both the fragments of the query are admitted
+    EXPECT_EQ(std::vector<int64_t>({3, 3}), _admitted);
+    EXPECT_EQ(0, _queue.num_waiting_queries());
+    EXPECT_EQ(2, _queue.num_running_queries());
+    _queue.release(3);
+    _queue.release(3);
+    _queue.release(1);
+    EXPECT_EQ(0, _queue.num_running_queries());
+}
+
+TEST_F(QueryAdmissionQueueTest, Priority) {
+    EXPECT_TRUE(admit(1));
+    EXPECT_TRUE(admit(2));
+    EXPECT_FALSE(admit(3, 0));
+    EXPECT_FALSE(admit(4, 1));
+    EXPECT_FALSE(admit(5, 0));
+    EXPECT_FALSE(admit(6, 1));
+
+    _queue.release(1);
+    _queue.release(2);
+    EXPECT_EQ(std::vector<int64_t>({4, 6}), _admitted);
+    _queue.release(4);
+    _queue.release(6);
+    EXPECT_EQ(std::vector<int64_t>({4, 6, 3, 5}), _admitted);
+}
+
+TEST_F(QueryAdmissionQueueTest, MemReservation) {
+    config::query_queue_max_running_queries = 0;
+    config::query_queue_reservable_mem_percent = 50;
+    _process_mem_limit = 1000;
+
+    EXPECT_TRUE(admit(1, 0, 300));
+    EXPECT_TRUE(admit(2, 0, 200));
+    EXPECT_FALSE(admit(3, 0, 100));
+    _queue.release(2);
+    EXPECT_EQ(std::vector<int64_t>({3}), _admitted);
+    _queue.release(1);
+    _queue.release(3);
+    // a query is always admitted when no query is running
+    EXPECT_TRUE(admit(4, 0, 2000));
+}
+
+TEST_F(QueryAdmissionQueueTest, Timeout) {
+    EXPECT_TRUE(admit(1));
+    EXPECT_TRUE(admit(2));
+    EXPECT_FALSE(admit(3, 0, 0, 0));
+    EXPECT_FALSE(admit(4, 0, 0, 60000));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    _queue.check_timeout();
+    EXPECT_EQ(std::vector<int64_t>({3}), _timed_out);
+    EXPECT_EQ(1, _queue.num_waiting_queries());
+    _queue.release(1);
+    EXPECT_EQ(std::vector<int64_t>({4}), _admitted);
+}
+
+} // namespace doris
@@ -0,0 +1,75 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/query_fragments_ctx.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+namespace doris {
+
+static TPlanFragment plan_fragment(int num_nodes) {
+    TPlanFragment fragment;
+    for (int i = 0; i < num_nodes; ++i) {
+        TPlanNode node;
+        node.node_id = i;
+        fragment.plan.nodes.push_back(node);
+    }
+    return fragment;
+}
+
+TEST(QueryFragmentsCtxTest, share_plan_fragment) {
+    QueryFragmentsCtx ctx(3, nullptr);
+    EXPECT_EQ(nullptr, ctx.get_plan_fragment(1));
+
+    // the fragment of the first instance is kept, the ones sent again don't replace it
+    ctx.set_plan_fragment(1, plan_fragment(2));
+    auto fragment = ctx.get_plan_fragment(1);
+    ASSERT_NE(nullptr, fragment);
+    EXPECT_EQ(2, fragment->plan.nodes.size());
+    ctx.set_plan_fragment(1, plan_fragment(5));
+    EXPECT_EQ(fragment, ctx.get_plan_fragment(1));
+
+    EXPECT_EQ(nullptr, ctx.get_plan_fragment(2));
+    ctx.set_plan_fragment(2, plan_fragment(5));
+    EXPECT_EQ(5, ctx.get_plan_fragment(2)->plan.nodes.size());
+    EXPECT_EQ(2, ctx.get_plan_fragment(1)->plan.nodes.size());
+}
+
+TEST(QueryFragmentsCtxTest, concurrent_instances) {
+    QueryFragmentsCtx ctx(16, nullptr);
+    // the instances of a fragment are prepared concurrently, all of them get the same fragment
+    std::vector<std::shared_ptr<const TPlanFragment>> fragments(16);
+    std::vector<std::thread> instances;
+    for (int i = 0; i < 16; ++i) {
+        instances.emplace_back([&, i]() {
+            ctx.set_plan_fragment(0, plan_fragment(i + 1));
+            fragments[i] = ctx.get_plan_fragment(0);
+        });
+    }
+    for (auto& instance : instances) {
+        instance.join();
+    }
+    for (const auto& fragment : fragments) {
+        ASSERT_NE(nullptr, fragment);
+        EXPECT_EQ(fragments[0], fragment);
+    }
+}
+
+} // namespace doris
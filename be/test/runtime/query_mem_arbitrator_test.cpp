@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_mem_arbitrator.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+
+namespace doris {
+
+static TUniqueId query_id(int64_t lo) {
+    TUniqueId id;
+    id.hi = 0;
+    id.lo = lo;
+    return id;
+}
+
+static QueryMemUsage usage(int64_t lo, int64_t mem_bytes, bool can_spill) {
+    QueryMemUsage usage;
+    usage.query_id = query_id(lo);
+    usage.mem_bytes = mem_bytes;
+    usage.can_spill = can_spill;
+    return usage;
+}
+
+class QueryMemArbitratorTest : public testing::Test {
+public:
+    void SetUp() override {
+        config::query_spill_process_mem_percent = 80;
+        config::query_cancel_process_mem_percent = 90;
+    }
+
+protected:
+    QueryMemArbitrator _arbitrator;
+    std::vector<TUniqueId> _to_spill;
+    std::vector<TUniqueId> _to_cancel;
+};
+
+TEST_F(QueryMemArbitratorTest, NoPressure) {
+    _arbitrator.arbitrate(790, 1000, {usage(1, 500, true)}, &_to_spill, &_to_cancel);
+    EXPECT_TRUE(_to_spill.empty());
+    EXPECT_TRUE(_to_cancel.empty());
+}
+
+TEST_F(QueryMemArbitratorTest, SpillBiggestQueries) {
+    std::vector<QueryMemUsage> queries = {usage(1, 10, true), usage(2, 30, true),
+                                          usage(3, 100, false), usage(4, 20, true)};
+    // 50 bytes to free, from the biggest spillable queries
+    _arbitrator.arbitrate(850, 1000, queries, &_to_spill, &_to_cancel);
+    ASSERT_EQ(2, _to_spill.size());
+    EXPECT_EQ(query_id(2), _to_spill[0]);
+    EXPECT_EQ(query_id(4), _to_spill[1]);
+    EXPECT_TRUE(_to_cancel.empty());
+
+    // the queries keep spilling while the memory is under pressure
+    _arbitrator.arbitrate(810, 1000, queries, &_to_spill, &_to_cancel);
+    ASSERT_EQ(1, _to_spill.size());
+    EXPECT_EQ(query_id(2), _to_spill[0]);
+
+    _arbitrator.arbitrate(700, 1000, queries, &_to_spill, &_to_cancel);
+    EXPECT_TRUE(_to_spill.empty());
+    EXPECT_TRUE(_to_cancel.empty());
+}
+
+TEST_F(QueryMemArbitratorTest, CancelAsLastResort) {
+    std::vector<QueryMemUsage> queries = {usage(1, 50, true), usage(2, 100, false),
+                                          usage(3, 200, false)};
+    // the spillable query is asked to spill first
+    _arbitrator.arbitrate(950, 1000, queries, &_to_spill, &_to_cancel);
+    ASSERT_EQ(1, _to_spill.size());
+    EXPECT_EQ(query_id(1), _to_spill[0]);
+    EXPECT_TRUE(_to_cancel.empty());
+
+    // still beyond the cancel limit, cancel the biggest query which can't spill
+    _arbitrator.arbitrate(950, 1000, queries, &_to_spill, &_to_cancel);
+    ASSERT_EQ(1, _to_spill.size());
+    ASSERT_EQ(1, _to_cancel.size());
+    EXPECT_EQ(query_id(3), _to_cancel[0]);
+
+    // cancel the biggest one if all of them are spilling
+    queries = {usage(1, 50, true), usage(4, 80, true)};
+    _arbitrator.arbitrate(950, 1000, queries, &_to_spill, &_to_cancel);
+    EXPECT_EQ(2, _to_spill.size());
+    EXPECT_TRUE(_to_cancel.empty());
+    _arbitrator.arbitrate(950, 1000, queries, &_to_spill, &_to_cancel);
+    ASSERT_EQ(1, _to_cancel.size());
+    EXPECT_EQ(query_id(4), _to_cancel[0]);
+}
+
+} // namespace doris
@@ -0,0 +1,141 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/query_replayer.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "common/config.h"
+#include "env/env.h"
+#include "util/file_utils.h"
+#include "util/thrift_util.h"
+#include "util/uid_util.h"
+
+namespace doris {
+
+static const std::string kCaptureDir = "./query_replayer_test";
+
+class QueryReplayerTest : public testing::Test {
+public:
+    void SetUp() override {
+        _enable_query_capture = config::enable_query_capture;
+        _query_capture_dir = config::query_capture_dir;
+        config::enable_query_capture = true;
+        config::query_capture_dir = kCaptureDir;
+        static_cast<void>(FileUtils::remove_all(kCaptureDir));
+    }
+
+    void TearDown() override {
+        config::enable_query_capture = _enable_query_capture;
+        config::query_capture_dir = _query_capture_dir;
+        static_cast<void>(FileUtils::remove_all(kCaptureDir));
+    }
+
+protected:
+    static TExecPlanFragmentParams fragment_params(int64_t instance_lo, bool simplified,
+                                                   TQueryType::type query_type) {
+        TExecPlanFragmentParams params;
+        params.params.query_id.__set_hi(1);
+        params.params.query_id.__set_lo(100);
+        params.params.fragment_instance_id.__set_hi(1);
+        params.params.fragment_instance_id.__set_lo(instance_lo);
+        params.__set_is_simplified_param(simplified);
+        if (!simplified) {
+            params.query_options.__set_query_type(query_type);
+            params.__isset.query_options = true;
+        }
+        return params;
+    }
+
+    static std::vector<std::string> captured_files(const TUniqueId& query_id) {
+        std::vector<std::string> files;
+        static_cast<void>(FileUtils::list_files(
+                Env::Default(), kCaptureDir + "/" + print_id(query_id), &files));
+        std::sort(files.begin(), files.end());
+        return files;
+    }
+
+    bool _enable_query_capture;
+    std::string _query_capture_dir;
+    QueryReplayer _replayer {nullptr};
+};
+
+TEST_F(QueryReplayerTest, capture) {
+    auto first = fragment_params(101, false, TQueryType::SELECT);
+    auto second = fragment_params(102, true, TQueryType::SELECT);
+    _replayer.capture(first);
+    _replayer.capture(second);
+    auto files = captured_files(first.params.query_id);
+    ASSERT_EQ(2, files.size());
+
+    // the fragments are kept in the order they are received
+    std::ifstream file(kCaptureDir + "/" + print_id(first.params.query_id) + "/" + files[1],
+                       std::ios::binary);
+    std::stringstream buf;
+    buf << file.rdbuf();
+    std::string data = buf.str();
+    uint32_t len = data.size();
+    TExecPlanFragmentParams params;
+    ASSERT_TRUE(deserialize_thrift_msg(reinterpret_cast<const uint8_t*>(data.data()), &len,
+                                       false, &params)
+                        .ok());
+    ASSERT_EQ(102, params.params.fragment_instance_id.lo);
+}
+
+TEST_F(QueryReplayerTest, capture_select_only) {
+    auto load = fragment_params(101, false, TQueryType::LOAD);
+    _replayer.capture(load);
+    _replayer.capture(fragment_params(102, true, TQueryType::LOAD));
+    ASSERT_TRUE(captured_files(load.params.query_id).empty());
+
+    config::enable_query_capture = false;
+    auto select = fragment_params(101, false, TQueryType::SELECT);
+    _replayer.capture(select);
+    ASSERT_TRUE(captured_files(select.params.query_id).empty());
+}
+
+TEST_F(QueryReplayerTest, replay_not_captured) {
+    std::string profile;
+    ASSERT_FALSE(_replayer.replay("1-100", &profile).ok());
+}
+
+TEST_F(QueryReplayerTest, diff_profiles) {
+    std::string baseline =
+            "Query\tTotalTimeMs\t100\n"
+            "Fragment 0/VOLAP_SCAN_NODE (id=0)\tRowsRead\t1000\n"
+            "Fragment 0/VOLAP_SCAN_NODE (id=0)\tTotalTime\t500\n"
+            "Fragment 0/VEXCHANGE_NODE (id=1)\tTotalTime\t0\n";
+    std::string current =
+            "# saved to somewhere\n"
+            "Query\tTotalTimeMs\t100\n"
+            "Fragment 0/VOLAP_SCAN_NODE (id=0)\tRowsRead\t1000\n"
+            "Fragment 0/VOLAP_SCAN_NODE (id=0)\tTotalTime\t250\n"
+            "Fragment 0/VEXCHANGE_NODE (id=1)\tTotalTime\t10\n"
+            "Fragment 0/VSORT_NODE (id=2)\tTotalTime\t10\n";
+    std::string diff;
+    QueryReplayer::diff_profiles(baseline, current, &diff);
+    ASSERT_EQ("Fragment 0/VEXCHANGE_NODE (id=1)\tTotalTime\t0\t10\tn/a\n"
+              "Fragment 0/VOLAP_SCAN_NODE (id=0)\tTotalTime\t500\t250\t-50.0%\n",
+              diff);
+}
+
+} // namespace doris
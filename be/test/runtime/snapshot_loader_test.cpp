@@ -17,8 +17,13 @@
 
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <filesystem>
+#include <thread>
 
+#include "common/config.h"
+#include "gen_cpp/HeartbeatService_types.h"
 #include "runtime/exec_env.h"
 #include "util/cpu_info.h"
 
@@ -29,6 +34,9 @@
 
 namespace doris {
 
+extern TStatus k_snapshot_loader_report_status;
+extern int k_snapshot_loader_report_count;
+
 class SnapshotLoaderTest : public testing::Test {
 public:
     SnapshotLoaderTest() {}
@@ -98,4 +106,61 @@ TEST_F(SnapshotLoaderTest, NormalCase) {
     EXPECT_EQ(10005, tablet_id);
 }
 
+TEST_F(SnapshotLoaderTest, TransferFiles) {
+    ExecEnv env;
+    env._master_info = new TMasterInfo();
+    SnapshotLoader loader(&env, 1L, 2L);
+    int32_t parallelism = config::snapshot_transfer_parallelism;
+    config::snapshot_transfer_parallelism = 4;
+    k_snapshot_loader_report_status = TStatus();
+    k_snapshot_loader_report_count = 0;
+
+    std::atomic<int> inflight {0};
+    std::atomic<int> max_inflight {0};
+    std::atomic<int> num_transferred {0};
+    auto transfer_tasks = [&](int num_tasks, int failed_task) {
+        std::vector<std::function<Status()>> tasks;
+        for (int i = 0; i < num_tasks; ++i) {
+            tasks.emplace_back([&, i, failed_task]() {
+                int n = ++inflight;
+                int max = max_inflight;
+                while (n > max && !max_inflight.compare_exchange_weak(max, n)) {
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                --inflight;
+                ++num_transferred;
+                return i == failed_task ? Status::InternalError("failed to transfer")
+                                        : Status::OK();
+            });
+        }
+        return tasks;
+    };
+
+    // the files are transferred in parallel, and the progress is reported after each one
+    EXPECT_TRUE(loader._transfer_files(transfer_tasks(20, -1), TTaskType::type::UPLOAD).ok());
+    EXPECT_EQ(20, num_transferred);
+    EXPECT_EQ(20, k_snapshot_loader_report_count);
+    EXPECT_GT(max_inflight, 1);
+    EXPECT_LE(max_inflight, 4);
+
+    // the files after a failed one are not transferred
+    config::snapshot_transfer_parallelism = 1;
+    num_transferred = 0;
+    Status st = loader._transfer_files(transfer_tasks(10, 2), TTaskType::type::DOWNLOAD);
+    EXPECT_FALSE(st.ok());
+    EXPECT_EQ(3, num_transferred);
+
+    // neither are those after the job is cancelled
+    num_transferred = 0;
+    k_snapshot_loader_report_status.__set_status_code(TStatusCode::CANCELLED);
+    st = loader._transfer_files(transfer_tasks(10, -1), TTaskType::type::DOWNLOAD);
+    EXPECT_TRUE(st.is_cancelled()) << st.to_string();
+    EXPECT_EQ(1, num_transferred);
+
+    k_snapshot_loader_report_status = TStatus();
+    config::snapshot_transfer_parallelism = parallelism;
+    delete env._master_info;
+    env._master_info = nullptr;
+}
+
 } // namespace doris
@@ -0,0 +1,276 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/tablets_channel.h"
+
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <map>
+#include <set>
+
+#include "common/config.h"
+#include "exec/tablet_info.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/internal_service.pb.h"
+#include "olap/delta_writer.h"
+#include "olap/memtable.h"
+#include "olap/options.h"
+#include "olap/storage_engine.h"
+#include "olap/tablet_manager.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/exec_env.h"
+#include "util/file_utils.h"
+#include "util/threadpool.h"
+#include "vec/columns/columns_number.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+static const uint32_t MAX_PATH_LEN = 1024;
+static StorageEngine* k_engine = nullptr;
+
+static constexpr int64_t INDEX_ID = 4;
+static constexpr int32_t SCHEMA_HASH = 270068379;
+static constexpr int64_t FIRST_TABLET_ID = 20101;
+static constexpr int NUM_TABLETS = 8;
+
+// The rows of a batch of a TabletsChannel are written into the memtables of its tablets by the
+// tablet write thread pool, and the tablets failing to write are reported after all the writes.
+class TabletsChannelTest : public testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        char buffer[MAX_PATH_LEN];
+        EXPECT_NE(getcwd(buffer, MAX_PATH_LEN), nullptr);
+        config::storage_root_path = std::string(buffer) + "/data_test";
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::create_dir(config::storage_root_path);
+        std::vector<StorePath> paths;
+        paths.emplace_back(config::storage_root_path, -1);
+
+        EngineOptions options;
+        options.store_paths = paths;
+        Status s = StorageEngine::open(options, &k_engine);
+        EXPECT_TRUE(s.ok()) << s.to_string();
+        ExecEnv* exec_env = ExecEnv::GetInstance();
+        exec_env->set_storage_engine(k_engine);
+        k_engine->start_bg_threads();
+        ThreadPoolBuilder("TabletWriteThreadPool")
+                .set_min_threads(1)
+                .set_max_threads(8)
+                .build(&exec_env->_tablet_write_thread_pool);
+
+        for (int i = 0; i < NUM_TABLETS; ++i) {
+            TCreateTabletReq request;
+            request.tablet_id = FIRST_TABLET_ID + i;
+            request.__set_version(1);
+            request.tablet_schema.schema_hash = SCHEMA_HASH;
+            request.tablet_schema.short_key_column_count = 1;
+            request.tablet_schema.keys_type = TKeysType::DUP_KEYS;
+            request.tablet_schema.storage_type = TStorageType::COLUMN;
+            for (const char* name : {"k1", "v1"}) {
+                TColumn column;
+                column.column_name = name;
+                column.__set_is_key(std::string(name) == "k1");
+                column.column_type.type = TPrimitiveType::INT;
+                request.tablet_schema.columns.push_back(column);
+            }
+            EXPECT_TRUE(k_engine->create_tablet(request).ok());
+        }
+    }
+
+    static void TearDownTestSuite() {
+        ExecEnv::GetInstance()->_tablet_write_thread_pool.reset();
+        if (k_engine != nullptr) {
+            for (int i = 0; i < NUM_TABLETS; ++i) {
+                k_engine->tablet_manager()->drop_tablet(FIRST_TABLET_ID + i);
+            }
+            k_engine->stop();
+            delete k_engine;
+            k_engine = nullptr;
+        }
+        FileUtils::remove_all(config::storage_root_path);
+        FileUtils::remove_all(std::string(getenv("DORIS_HOME")) + UNUSED_PREFIX);
+    }
+
+    void SetUp() override {
+        TDescriptorTableBuilder dtb;
+        TTupleDescriptorBuilder tuple_builder;
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("k1").column_pos(0).build());
+        tuple_builder.add_slot(
+                TSlotDescriptorBuilder().type(TYPE_INT).column_name("v1").column_pos(1).build());
+        tuple_builder.build(&dtb);
+        TDescriptorTable desc_tbl = dtb.desc_tbl();
+
+        TOlapTableSchemaParam t_schema;
+        t_schema.db_id = 1;
+        t_schema.table_id = 2;
+        t_schema.version = 0;
+        t_schema.slot_descs = desc_tbl.slotDescriptors;
+        t_schema.tuple_desc = desc_tbl.tupleDescriptors[0];
+        t_schema.indexes.resize(1);
+        t_schema.indexes[0].id = INDEX_ID;
+        t_schema.indexes[0].columns = {"k1", "v1"};
+        t_schema.indexes[0].schema_hash = SCHEMA_HASH;
+        ASSERT_TRUE(_schema.init(t_schema).ok());
+    }
+
+    void TearDown() override {
+        config::tablet_writer_write_parallelism = _write_parallelism;
+    }
+
+    // a vectorized channel of all the tablets of one sender in a new transaction
+    std::unique_ptr<TabletsChannel> open_channel() {
+        PUniqueId load_id;
+        load_id.set_hi(0);
+        load_id.set_lo(++_txn_id);
+        auto channel = std::make_unique<TabletsChannel>(TabletsChannelKey(load_id, INDEX_ID),
+                                                        false, true);
+        PTabletWriterOpenRequest request;
+        *request.mutable_id() = load_id;
+        request.set_index_id(INDEX_ID);
+        request.set_txn_id(_txn_id);
+        _schema.to_protobuf(request.mutable_schema());
+        for (int i = 0; i < NUM_TABLETS; ++i) {
+            auto tablet = request.add_tablets();
+            tablet->set_partition_id(1);
+            tablet->set_tablet_id(FIRST_TABLET_ID + i);
+        }
+        request.set_num_senders(1);
+        request.set_need_gen_rollup(false);
+        request.set_is_vectorized(true);
+        EXPECT_TRUE(channel->open(request).ok());
+        return channel;
+    }
+
+    // the tablet of the row, the tablets get different numbers of rows
+    static int64_t tablet_of(int row) { return FIRST_TABLET_ID + (row * 7 % 13) % NUM_TABLETS; }
+
+    // the rows of k1 in [begin, begin + num_rows) and v1 of k1 * 10 to their tablets
+    Status add_batch(TabletsChannel* channel, int begin, int num_rows,
+                     PTabletWriterAddBlockResult* response) {
+        auto k1 = vectorized::ColumnInt32::create();
+        auto v1 = vectorized::ColumnInt32::create();
+        PTabletWriterAddBlockRequest request;
+        request.set_index_id(INDEX_ID);
+        request.set_sender_id(0);
+        request.set_packet_seq(_packet_seq++);
+        for (int i = begin; i < begin + num_rows; ++i) {
+            k1->insert_value(i);
+            v1->insert_value(i * 10);
+            request.add_tablet_ids(tablet_of(i));
+        }
+        auto type = std::make_shared<vectorized::DataTypeInt32>();
+        vectorized::Block block({vectorized::ColumnWithTypeAndName(std::move(k1), type, "k1"),
+                                 vectorized::ColumnWithTypeAndName(std::move(v1), type, "v1")});
+        size_t uncompressed_bytes = 0;
+        size_t compressed_bytes = 0;
+        std::string allocated_buf;
+        RETURN_IF_ERROR(block.serialize(request.mutable_block(), &uncompressed_bytes,
+                                        &compressed_bytes, &allocated_buf, false));
+        return channel->add_batch(request, response);
+    }
+
+    // the rows in the memtables of the tablets, nothing is flushed by the small batches
+    static std::map<int64_t, size_t> memtable_rows(TabletsChannel* channel) {
+        std::map<int64_t, size_t> rows;
+        for (auto& [tablet_id, writer] : channel->_tablet_writers) {
+            rows[tablet_id] = writer->_mem_table == nullptr
+                                      ? 0
+                                      : writer->_mem_table->_input_mutable_block.rows();
+        }
+        return rows;
+    }
+
+    static std::map<int64_t, size_t> expected_rows(int num_rows,
+                                                   const std::set<int64_t>& skipped = {}) {
+        std::map<int64_t, size_t> rows;
+        for (int i = 0; i < NUM_TABLETS; ++i) {
+            rows[FIRST_TABLET_ID + i] = 0;
+        }
+        for (int i = 0; i < num_rows; ++i) {
+            if (skipped.count(tablet_of(i)) == 0) {
+                ++rows[tablet_of(i)];
+            }
+        }
+        return rows;
+    }
+
+    OlapTableSchemaParam _schema;
+    int64_t _txn_id = 30100;
+    int64_t _packet_seq = 0;
+    int32_t _write_parallelism = config::tablet_writer_write_parallelism;
+};
+
+TEST_F(TabletsChannelTest, parallel_write) {
+    // the tablets are written one by one by the brpc thread, or in parallel by the pool
+    for (int parallelism : {1, 4}) {
+        config::tablet_writer_write_parallelism = parallelism;
+        _packet_seq = 0;
+        auto channel = open_channel();
+        EXPECT_EQ(parallelism > 1, channel->_write_token != nullptr);
+        for (int batch = 0; batch < 5; ++batch) {
+            PTabletWriterAddBlockResult response;
+            EXPECT_TRUE(add_batch(channel.get(), batch * 1000, 1000, &response).ok());
+            EXPECT_EQ(0, response.tablet_errors_size());
+        }
+        EXPECT_EQ(expected_rows(5000), memtable_rows(channel.get())) << parallelism;
+        EXPECT_TRUE(channel->cancel().ok());
+    }
+}
+
+TEST_F(TabletsChannelTest, write_error) {
+    config::tablet_writer_write_parallelism = 4;
+    auto channel = open_channel();
+    PTabletWriterAddBlockResult response;
+    EXPECT_TRUE(add_batch(channel.get(), 0, 1000, &response).ok());
+    EXPECT_EQ(0, response.tablet_errors_size());
+
+    // the writes of the cancelled writers fail, the other tablets are still written
+    std::set<int64_t> failed_tablets = {FIRST_TABLET_ID + 2, FIRST_TABLET_ID + 5};
+    for (int64_t tablet_id : failed_tablets) {
+        EXPECT_TRUE(channel->_tablet_writers[tablet_id]->cancel().ok());
+    }
+    response.Clear();
+    EXPECT_TRUE(add_batch(channel.get(), 1000, 1000, &response).ok());
+    std::set<int64_t> error_tablets;
+    for (const auto& error : response.tablet_errors()) {
+        error_tablets.insert(error.tablet_id());
+        EXPECT_NE(std::string::npos, error.msg().find("tablet writer write failed"));
+    }
+    EXPECT_EQ(failed_tablets, error_tablets);
+    EXPECT_EQ(failed_tablets, std::set<int64_t>(channel->_broken_tablets.begin(),
+                                                channel->_broken_tablets.end()));
+
+    // the broken tablets are skipped by the next batches without errors
+    response.Clear();
+    EXPECT_TRUE(add_batch(channel.get(), 2000, 1000, &response).ok());
+    EXPECT_EQ(0, response.tablet_errors_size());
+    auto rows = memtable_rows(channel.get());
+    auto expected = expected_rows(3000, failed_tablets);
+    for (int64_t tablet_id : failed_tablets) {
+        // the rows of the first batch are dropped with the cancelled memtable
+        rows.erase(tablet_id);
+        expected.erase(tablet_id);
+    }
+    EXPECT_EQ(expected, rows);
+    EXPECT_TRUE(channel->cancel().ok());
+}
+
+} // namespace doris
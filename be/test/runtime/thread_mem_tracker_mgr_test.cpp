@@ -0,0 +1,105 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "runtime/thread_mem_tracker_mgr.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+
+static const int64_t MB = 1024 * 1024;
+
+// The untracked memory of a thread is only consumed by its tracker, and the ancestors of it, once
+// it reaches mem_tracker_consume_min_size_bytes.
+class ThreadMemTrackerMgrTest : public testing::Test {
+protected:
+    void SetUp() override {
+        _start_thread_mem_tracker = start_thread_mem_tracker;
+        _parent = MemTracker::create_tracker(-1, "ThreadMemTrackerMgrTest");
+        _t1 = MemTracker::create_tracker(-1, "t1", _parent);
+        _t2 = MemTracker::create_tracker(-1, "t2", _parent);
+    }
+
+    void TearDown() override {
+        start_thread_mem_tracker = _start_thread_mem_tracker;
+        _t1->release(_t1->consumption());
+        _t2->release(_t2->consumption());
+    }
+
+    bool _start_thread_mem_tracker;
+    std::shared_ptr<MemTracker> _parent;
+    std::shared_ptr<MemTracker> _t1;
+    std::shared_ptr<MemTracker> _t2;
+};
+
+TEST_F(ThreadMemTrackerMgrTest, consume_min_size) {
+    EXPECT_EQ(4 * MB, config::mem_tracker_consume_min_size_bytes);
+    ThreadMemTrackerMgr mgr;
+    mgr.init();
+    mgr.update_tracker<false>(_t1);
+
+    for (int i = 0; i < 3; ++i) {
+        mgr.cache_consume(MB);
+        EXPECT_EQ(0, _t1->consumption());
+    }
+    // the 4MB are consumed at once, by the parent too
+    mgr.cache_consume(MB);
+    EXPECT_EQ(4 * MB, _t1->consumption());
+    EXPECT_EQ(4 * MB, _parent->consumption());
+
+    // and so are the releases
+    mgr.cache_consume(-3 * MB);
+    EXPECT_EQ(4 * MB, _t1->consumption());
+    mgr.cache_consume(-MB);
+    EXPECT_EQ(0, _t1->consumption());
+    EXPECT_EQ(0, _parent->consumption());
+
+    // the rest is consumed when the untracked memory is cleared
+    mgr.cache_consume(MB);
+    mgr.clear_untracked_mems();
+    EXPECT_EQ(MB, _t1->consumption());
+}
+
+TEST_F(ThreadMemTrackerMgrTest, switch_tracker) {
+    ThreadMemTrackerMgr mgr;
+    mgr.init();
+    mgr.update_tracker<false>(_t1);
+    mgr.cache_consume(MB);
+
+    // the untracked memory of the tracker switched out is kept for it
+    mgr.update_tracker<false>(_t2);
+    mgr.cache_consume(4 * MB);
+    EXPECT_EQ(0, _t1->consumption());
+    EXPECT_EQ(4 * MB, _t2->consumption());
+
+    mgr.update_tracker<true>(_t1);
+    mgr.cache_consume(3 * MB);
+    EXPECT_EQ(4 * MB, _t1->consumption());
+    EXPECT_EQ(8 * MB, _parent->consumption());
+
+    // a threshold of 0 consumes every allocation
+    int32_t min_size_bytes = config::mem_tracker_consume_min_size_bytes;
+    config::mem_tracker_consume_min_size_bytes = 0;
+    mgr.cache_consume(1);
+    EXPECT_EQ(4 * MB + 1, _t1->consumption());
+    config::mem_tracker_consume_min_size_bytes = min_size_bytes;
+}
+
+} // namespace doris
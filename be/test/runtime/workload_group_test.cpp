@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "runtime/workload_group.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "runtime/mem_tracker.h"
+
+namespace doris {
+
+static TUniqueId query_id(int64_t lo) {
+    TUniqueId id;
+    id.hi = 0;
+    id.lo = lo;
+    return id;
+}
+
+TEST(WorkloadGroupTest, ParseGroups) {
+    std::vector<WorkloadGroupInfo> infos;
+    EXPECT_TRUE(WorkloadGroupMgr::parse_groups(
+                        "etl:cpu_share=256, memory_limit=50%,max_concurrency=2; dashboard", 1000,
+                        &infos)
+                        .ok());
+    ASSERT_EQ(2, infos.size());
+    EXPECT_EQ("etl", infos[0].name);
+    EXPECT_EQ(256, infos[0].cpu_share);
+    EXPECT_EQ(500, infos[0].memory_limit);
+    EXPECT_EQ(2, infos[0].max_concurrency);
+    EXPECT_EQ("dashboard", infos[1].name);
+    EXPECT_EQ(1024, infos[1].cpu_share);
+    EXPECT_EQ(-1, infos[1].memory_limit);
+    EXPECT_EQ(0, infos[1].max_concurrency);
+
+    infos.clear();
+    EXPECT_TRUE(WorkloadGroupMgr::parse_groups("", 1000, &infos).ok());
+    EXPECT_TRUE(infos.empty());
+
+    EXPECT_FALSE(WorkloadGroupMgr::parse_groups("etl:cpu_share=0", 1000, &infos).ok());
+    EXPECT_FALSE(WorkloadGroupMgr::parse_groups("etl:cpu=1", 1000, &infos).ok());
+    EXPECT_FALSE(WorkloadGroupMgr::parse_groups("etl:memory_limit=x", 1000, &infos).ok());
+    EXPECT_FALSE(WorkloadGroupMgr::parse_groups(":cpu_share=1", 1000, &infos).ok());
+    infos.clear();
+    EXPECT_FALSE(WorkloadGroupMgr::parse_groups("etl;etl", 1000, &infos).ok());
+}
+
+TEST(WorkloadGroupTest, MaxConcurrency) {
+    WorkloadGroupInfo info;
+    info.name = "etl";
+    info.max_concurrency = 2;
+    WorkloadGroup group(info, MemTracker::create_tracker(-1, "WorkloadGroup=etl"));
+
+    EXPECT_TRUE(group.add_fragment(query_id(1)).ok());
+    EXPECT_TRUE(group.add_fragment(query_id(1)).ok());
+    EXPECT_TRUE(group.add_fragment(query_id(2)).ok());
+    // the fragments of the running queries are still admitted
+    EXPECT_TRUE(group.add_fragment(query_id(2)).ok());
+    EXPECT_FALSE(group.add_fragment(query_id(3)).ok());
+    EXPECT_EQ(2, group.num_queries());
+
+    group.remove_fragment(query_id(1));
+    EXPECT_FALSE(group.add_fragment(query_id(3)).ok());
+    group.remove_fragment(query_id(1));
+    EXPECT_EQ(1, group.num_queries());
+    EXPECT_TRUE(group.add_fragment(query_id(3)).ok());
+    EXPECT_EQ(2, group.num_queries());
+}
+
+TEST(WorkloadGroupTest, GroupMemTracker) {
+    std::string groups = config::workload_groups;
+    config::workload_groups = "etl:memory_limit=1G";
+    auto parent = MemTracker::create_tracker(-1, "QueryPool");
+    WorkloadGroupMgr mgr;
+    EXPECT_TRUE(mgr.init(parent, nullptr).ok());
+    config::workload_groups = groups;
+
+    EXPECT_EQ(nullptr, mgr.get_group("dashboard"));
+    auto group = mgr.get_group("etl");
+    ASSERT_NE(nullptr, group);
+    EXPECT_EQ(1L << 30, group->mem_tracker()->limit());
+    EXPECT_EQ(parent.get(), group->mem_tracker()->parent().get());
+}
+
+} // namespace doris
@@ -0,0 +1,88 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "service/internal_service.h"
+
+#include <google/protobuf/stubs/callback.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+
+#include "common/config.h"
+#include "runtime/exec_env.h"
+#include "util/countdown_latch.h"
+
+namespace doris {
+
+class MockClosure : public google::protobuf::Closure {
+public:
+    void Run() override { ++run_count; }
+
+    std::atomic<int> run_count {0};
+};
+
+// The handlers which may block run in the heavy work pool, and fail at once when it's full
+// instead of waiting on the brpc threads.
+class InternalServiceTest : public testing::Test {
+protected:
+    void SetUp() override {
+        config::brpc_heavy_work_pool_threads = 1;
+        config::brpc_heavy_work_pool_max_queue_size = 1;
+        _service = std::make_unique<PInternalServiceImpl<PBackendService>>(&_env);
+    }
+
+    void TearDown() override {
+        _service.reset();
+        config::brpc_heavy_work_pool_threads = _pool_threads;
+        config::brpc_heavy_work_pool_max_queue_size = _pool_max_queue_size;
+    }
+
+    ExecEnv _env;
+    std::unique_ptr<PInternalServiceImpl<PBackendService>> _service;
+    int32_t _pool_threads = config::brpc_heavy_work_pool_threads;
+    int32_t _pool_max_queue_size = config::brpc_heavy_work_pool_max_queue_size;
+};
+
+TEST_F(InternalServiceTest, heavy_work_pool_full) {
+    // the thread of the pool is blocked, and its queue is full
+    CountDownLatch started(1);
+    CountDownLatch blocked(1);
+    EXPECT_TRUE(_service->_offer_heavy_work([&]() {
+        started.count_down();
+        blocked.wait();
+    }));
+    started.wait();
+    CountDownLatch queued(1);
+    EXPECT_TRUE(_service->_offer_heavy_work([&]() { queued.count_down(); }));
+    EXPECT_FALSE(_service->_offer_heavy_work([]() {}));
+
+    // the heavy handler responds at once
+    PExecPlanFragmentRequest request;
+    PExecPlanFragmentResult response;
+    MockClosure done;
+    _service->exec_plan_fragment(nullptr, &request, &response, &done);
+    EXPECT_EQ(1, done.run_count);
+    EXPECT_EQ(TStatusCode::TOO_MANY_TASKS, response.status().status_code());
+
+    // the queued work runs once the pool is unblocked
+    blocked.count_down();
+    queued.wait();
+    EXPECT_TRUE(_service->_offer_heavy_work([]() {}));
+}
+
+} // namespace doris
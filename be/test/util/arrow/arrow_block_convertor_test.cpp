@@ -0,0 +1,124 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/arrow/block_convertor.h"
+
+#include <arrow/array.h>
+#include <arrow/memory_pool.h>
+#include <arrow/record_batch.h>
+#include <arrow/type.h>
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris {
+
+TEST(ArrowBlockConvertorTest, Normal) {
+    using vectorized::ColumnVector;
+    auto nullable_column = vectorized::ColumnNullable::create(
+            ColumnVector<vectorized::Int32>::create(), vectorized::ColumnUInt8::create());
+    auto str_column = vectorized::ColumnString::create();
+    auto int_column = vectorized::ColumnVector<vectorized::Int64>::create();
+    for (int i = 0; i < 100; ++i) {
+        if (i % 3 == 0) {
+            nullable_column->insert_default();
+        } else {
+            nullable_column->insert_data((const char*)&i, sizeof(i));
+        }
+        std::string value = std::to_string(i);
+        str_column->insert_data(value.data(), value.size());
+        int_column->insert_value(i * 8);
+    }
+    vectorized::DataTypePtr nullable_type(std::make_shared<vectorized::DataTypeNullable>(
+            std::make_shared<vectorized::DataTypeInt32>()));
+    vectorized::Block block(
+            {{std::move(nullable_column), nullable_type, "k1"},
+             {std::move(str_column), std::make_shared<vectorized::DataTypeString>(), "k2"},
+             {std::move(int_column), std::make_shared<vectorized::DataTypeInt64>(), "k3"}});
+    auto schema = arrow::schema({arrow::field("k1", arrow::int32(), true),
+                                 arrow::field("k2", arrow::utf8(), false),
+                                 arrow::field("k3", arrow::int64(), false)});
+
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    auto st = convert_to_arrow_batch(block, schema, arrow::default_memory_pool(), &record_batch);
+    EXPECT_TRUE(st.ok()) << st.to_string();
+    EXPECT_EQ(100, record_batch->num_rows());
+    EXPECT_TRUE(record_batch->ValidateFull().ok());
+
+    auto k1 = std::static_pointer_cast<arrow::Int32Array>(record_batch->column(0));
+    auto k2 = std::static_pointer_cast<arrow::StringArray>(record_batch->column(1));
+    auto k3 = std::static_pointer_cast<arrow::Int64Array>(record_batch->column(2));
+    EXPECT_EQ(34, k1->null_count());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(i % 3 == 0, k1->IsNull(i));
+        if (i % 3 != 0) {
+            EXPECT_EQ(i, k1->Value(i));
+        }
+        EXPECT_EQ(std::to_string(i), k2->GetString(i));
+        EXPECT_EQ(i * 8, k3->Value(i));
+    }
+    // the data of the fixed-width columns are not copied
+    EXPECT_EQ(block.get_by_position(2).column->get_raw_data().data,
+              reinterpret_cast<const char*>(k3->raw_values()));
+}
+
+TEST(ArrowBlockConvertorTest, CastNumeric) {
+    auto int_column = vectorized::ColumnVector<vectorized::Int16>::create();
+    for (int i = 0; i < 10; ++i) {
+        int_column->insert_value(i - 5);
+    }
+    vectorized::Block block(
+            {{std::move(int_column), std::make_shared<vectorized::DataTypeInt16>(), "k1"}});
+    // the smallint column is cast to the int64 field and the double field
+    auto schema = arrow::schema({arrow::field("k1", arrow::int64(), false),
+                                 arrow::field("k2", arrow::float64(), false)});
+    block.insert(block.get_by_position(0));
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    auto st = convert_to_arrow_batch(block, schema, arrow::default_memory_pool(), &record_batch);
+    EXPECT_TRUE(st.ok()) << st.to_string();
+    EXPECT_TRUE(record_batch->ValidateFull().ok());
+    auto k1 = std::static_pointer_cast<arrow::Int64Array>(record_batch->column(0));
+    auto k2 = std::static_pointer_cast<arrow::DoubleArray>(record_batch->column(1));
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(i - 5, k1->Value(i));
+        EXPECT_EQ(i - 5, k2->Value(i));
+    }
+}
+
+TEST(ArrowBlockConvertorTest, SchemaMismatch) {
+    auto int_column = vectorized::ColumnVector<vectorized::Int64>::create();
+    int_column->insert_value(1);
+    vectorized::Block block(
+            {{std::move(int_column), std::make_shared<vectorized::DataTypeInt64>(), "k1"}});
+    auto schema = arrow::schema({arrow::field("k1", arrow::int64(), false),
+                                 arrow::field("k2", arrow::int64(), false)});
+    std::shared_ptr<arrow::RecordBatch> record_batch;
+    EXPECT_FALSE(
+            convert_to_arrow_batch(block, schema, arrow::default_memory_pool(), &record_batch)
+                    .ok());
+}
+
+} // namespace doris
@@ -19,6 +19,7 @@
 
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "util/coding.h"
 #define private public
@@ -347,6 +348,58 @@ TEST(BitmapValueTest, bitmap_single_convert) {
     EXPECT_EQ(BitmapValue::BITMAP, bitmap._type);
 }
 
+TEST(BitmapValueTest, bitmap_add_many) {
+    BitmapValue bitmap;
+    uint64_t same[] = {7, 7, 7};
+    bitmap.add_many(same, 3);
+    EXPECT_EQ(BitmapValue::SINGLE, bitmap._type);
+    EXPECT_STREQ("7", bitmap.to_string().c_str());
+
+    // the values across the high 32 bits, unsorted and duplicated
+    uint64_t values[] = {3, 4294967296, 1, 4294967297, 3, 4294967296};
+    bitmap.add_many(values, 6);
+    EXPECT_EQ(BitmapValue::BITMAP, bitmap._type);
+    EXPECT_STREQ("1,3,7,4294967296,4294967297", bitmap.to_string().c_str());
+
+    std::vector<uint64_t> many;
+    for (uint64_t i = 0; i < 1000; ++i) {
+        many.push_back(i * 3);
+    }
+    BitmapValue expected;
+    for (auto value : many) {
+        expected.add(value);
+    }
+    BitmapValue bitmap2;
+    bitmap2.add_many(many.data(), many.size());
+    EXPECT_EQ(expected.to_string(), bitmap2.to_string());
+}
+
+TEST(BitmapValueTest, bitmap_fastunion) {
+    BitmapValue empty;
+    BitmapValue single(5);
+    BitmapValue single2(4294967296);
+    BitmapValue bitmap({1, 2, 4294967297});
+    BitmapValue bitmap2({2, 3, 8589934592});
+
+    BitmapValue res;
+    res.fastunion({&empty, &single, &empty});
+    EXPECT_EQ(BitmapValue::SINGLE, res._type);
+    EXPECT_STREQ("5", res.to_string().c_str());
+
+    res.fastunion({&single, &single2});
+    EXPECT_EQ(BitmapValue::BITMAP, res._type);
+    EXPECT_STREQ("5,4294967296", res.to_string().c_str());
+
+    res.fastunion({&bitmap, &single, &bitmap2});
+    EXPECT_STREQ("1,2,3,5,4294967296,4294967297,8589934592", res.to_string().c_str());
+
+    BitmapValue res2(1);
+    res2.fastunion({&bitmap});
+    EXPECT_STREQ("1,2,4294967297", res2.to_string().c_str());
+    // the argument is not changed
+    EXPECT_STREQ("1,2,4294967297", bitmap.to_string().c_str());
+}
+
 TEST(BitmapValueTest, bitmap_value_iterator_test) {
     BitmapValue empty;
     for (auto iter = empty.begin(); iter != empty.end(); ++iter) {
@@ -101,6 +101,7 @@ TEST_F(BlockCompressionTest, single) {
     test_single_slice(segment_v2::CompressionTypePB::ZLIB);
     test_single_slice(segment_v2::CompressionTypePB::LZ4);
     test_single_slice(segment_v2::CompressionTypePB::LZ4F);
+    test_single_slice(segment_v2::CompressionTypePB::ZSTD);
 }
 
 void test_multi_slices(segment_v2::CompressionTypePB type) {
@@ -156,6 +157,69 @@ TEST_F(BlockCompressionTest, multi) {
     test_multi_slices(segment_v2::CompressionTypePB::ZLIB);
     test_multi_slices(segment_v2::CompressionTypePB::LZ4);
     test_multi_slices(segment_v2::CompressionTypePB::LZ4F);
+    test_multi_slices(segment_v2::CompressionTypePB::ZSTD);
+}
+
+static std::string generate_url_page(size_t num_urls) {
+    std::string page;
+    for (size_t i = 0; i < num_urls; ++i) {
+        page.append("https://www.example.com/products/item?id=");
+        page.append(std::to_string(rand() % 100000));
+        page.append("&ref=search&utm_source=newsletter&lang=en_US");
+    }
+    return page;
+}
+
+TEST_F(BlockCompressionTest, zstd_dict) {
+    std::vector<std::string> pages;
+    for (int i = 0; i < 200; ++i) {
+        pages.push_back(generate_url_page(4));
+    }
+    std::vector<Slice> samples(pages.begin(), pages.end());
+    std::string dict;
+    auto st = train_compression_dict(segment_v2::CompressionTypePB::ZSTD, samples, 4096, &dict);
+    EXPECT_TRUE(st.ok());
+    EXPECT_FALSE(dict.empty());
+    EXPECT_LE(dict.size(), 4096);
+
+    std::unique_ptr<BlockCompressionCodec> dict_codec;
+    st = get_block_compression_codec(segment_v2::CompressionTypePB::ZSTD, dict, &dict_codec);
+    EXPECT_TRUE(st.ok());
+    const BlockCompressionCodec* codec = nullptr;
+    st = get_block_compression_codec(segment_v2::CompressionTypePB::ZSTD, &codec);
+    EXPECT_TRUE(st.ok());
+
+    auto orig = generate_url_page(4);
+    std::string compressed;
+    compressed.resize(dict_codec->max_compressed_len(orig.size()));
+    Slice compressed_slice(compressed);
+    st = dict_codec->compress(orig, &compressed_slice);
+    EXPECT_TRUE(st.ok());
+
+    std::string compressed_without_dict;
+    compressed_without_dict.resize(codec->max_compressed_len(orig.size()));
+    Slice compressed_without_dict_slice(compressed_without_dict);
+    st = codec->compress(orig, &compressed_without_dict_slice);
+    EXPECT_TRUE(st.ok());
+    EXPECT_LT(compressed_slice.size, compressed_without_dict_slice.size);
+
+    std::string uncompressed;
+    uncompressed.resize(orig.size());
+    Slice uncompressed_slice(uncompressed);
+    st = dict_codec->decompress(compressed_slice, &uncompressed_slice);
+    EXPECT_TRUE(st.ok());
+    EXPECT_EQ(orig, uncompressed);
+
+    // the page can't be decompressed without the dictionary
+    uncompressed_slice = Slice(uncompressed);
+    st = codec->decompress(compressed_slice, &uncompressed_slice);
+    EXPECT_FALSE(st.ok());
+
+    // too few samples to train
+    std::vector<Slice> few_samples(samples.begin(), samples.begin() + 1);
+    st = train_compression_dict(segment_v2::CompressionTypePB::ZSTD, few_samples, 4096, &dict);
+    EXPECT_TRUE(st.ok());
+    EXPECT_TRUE(dict.empty());
 }
 
 } // namespace doris
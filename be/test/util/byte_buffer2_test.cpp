@@ -17,6 +17,9 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+
 #include "common/logging.h"
 #include "util/byte_buffer.h"
 
@@ -49,4 +52,24 @@ TEST_F(ByteBufferTest, normal) {
     EXPECT_EQ(3, buf->remaining());
 }
 
+TEST_F(ByteBufferTest, wrap) {
+    auto data = std::make_shared<std::string>("abc");
+    std::weak_ptr<std::string> weak_data = data;
+    {
+        auto buf = ByteBuffer::wrap(data->data(), data->size(), data);
+        data.reset();
+        EXPECT_FALSE(weak_data.expired());
+        EXPECT_EQ(0, buf->pos);
+        EXPECT_EQ(3, buf->limit);
+        EXPECT_EQ(3, buf->remaining());
+
+        char result[3];
+        buf->get_bytes(result, 3);
+        EXPECT_EQ("abc", std::string(result, 3));
+        EXPECT_FALSE(buf->has_remaining());
+    }
+    // the owner is released with the buffer
+    EXPECT_TRUE(weak_data.expired());
+}
+
 } // namespace doris
@@ -0,0 +1,155 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/ddsketch.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace doris {
+
+// the true quantile of the sorted values, by the same rank as DDSketch
+static double true_quantile(const std::vector<double>& sorted, double q) {
+    return sorted[static_cast<size_t>(q * (sorted.size() - 1))];
+}
+
+static void check_accuracy(const DDSketch& sketch, std::vector<double> values, double accuracy) {
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(values.size(), sketch.count());
+    EXPECT_EQ(values.front(), sketch.min());
+    EXPECT_EQ(values.back(), sketch.max());
+    for (double q : {0.0, 0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99, 0.999, 1.0}) {
+        double expected = true_quantile(values, q);
+        EXPECT_NEAR(expected, sketch.quantile(q), std::abs(expected) * accuracy + 1e-9)
+                << "q=" << q;
+    }
+}
+
+static std::string serialize(const DDSketch& sketch) {
+    std::string buf(sketch.serialized_size(), '\0');
+    EXPECT_EQ(buf.size(), sketch.serialize((uint8_t*)buf.data()));
+    return buf;
+}
+
+TEST(DDSketchTest, empty) {
+    DDSketch sketch;
+    EXPECT_TRUE(sketch.empty());
+    EXPECT_TRUE(std::isnan(sketch.quantile(0.5)));
+    sketch.add(std::nan(""));
+    EXPECT_TRUE(sketch.empty());
+
+    DDSketch copy;
+    std::string buf = serialize(sketch);
+    EXPECT_TRUE(copy.deserialize((const uint8_t*)buf.data(), buf.size()));
+    EXPECT_TRUE(copy.empty());
+}
+
+TEST(DDSketchTest, accuracy) {
+    std::mt19937_64 gen(1);
+    std::lognormal_distribution<double> lognormal(0, 2);
+    std::normal_distribution<double> normal(0, 1000);
+    for (auto* distribution : {"lognormal", "normal", "zero"}) {
+        DDSketch sketch;
+        std::vector<double> values;
+        for (int i = 0; i < 100000; ++i) {
+            double value = 0;
+            if (distribution == std::string("lognormal")) {
+                value = lognormal(gen);
+            } else if (distribution == std::string("normal")) {
+                value = normal(gen);
+            }
+            values.push_back(value);
+            sketch.add(value);
+        }
+        SCOPED_TRACE(distribution);
+        check_accuracy(sketch, values, DDSketch::DEFAULT_RELATIVE_ACCURACY);
+    }
+}
+
+TEST(DDSketchTest, merge) {
+    std::mt19937_64 gen(2);
+    std::exponential_distribution<double> exponential(0.01);
+    DDSketch whole;
+    DDSketch merged;
+    std::vector<double> values;
+    for (int part = 0; part < 10; ++part) {
+        DDSketch sketch;
+        for (int i = 0; i < 1000; ++i) {
+            double value = exponential(gen) - 50;
+            values.push_back(value);
+            sketch.add(value);
+            whole.add(value);
+        }
+        merged.merge(sketch);
+    }
+    check_accuracy(merged, values, DDSketch::DEFAULT_RELATIVE_ACCURACY);
+    for (double q : {0.0, 0.1, 0.5, 0.9, 1.0}) {
+        EXPECT_EQ(whole.quantile(q), merged.quantile(q));
+    }
+    EXPECT_EQ(serialize(whole), serialize(merged));
+}
+
+TEST(DDSketchTest, serialize) {
+    DDSketch sketch(0.005);
+    std::vector<double> values;
+    for (int i = -1000; i <= 10000; ++i) {
+        values.push_back(i * 0.5);
+        sketch.add(i * 0.5);
+    }
+    std::string buf = serialize(sketch);
+    DDSketch copy;
+    EXPECT_TRUE(copy.deserialize((const uint8_t*)buf.data(), buf.size()));
+    EXPECT_EQ(0.005, copy.relative_accuracy());
+    check_accuracy(copy, values, 0.005);
+    EXPECT_EQ(buf, serialize(copy));
+
+    // the truncated and the corrupted states are rejected
+    for (size_t size = 0; size < buf.size(); ++size) {
+        DDSketch invalid;
+        EXPECT_FALSE(invalid.deserialize((const uint8_t*)buf.data(), size)) << size;
+    }
+    std::string corrupted = buf;
+    memset(corrupted.data(), 0xff, sizeof(double));
+    EXPECT_FALSE(copy.deserialize((const uint8_t*)corrupted.data(), corrupted.size()));
+}
+
+TEST(DDSketchTest, collapse) {
+    DDSketch sketch(0.01, 1024);
+    std::vector<double> values;
+    for (int i = 0; i < 100; ++i) {
+        values.push_back(std::pow(10, i % 20 - 5));
+        sketch.add(values.back());
+    }
+    EXPECT_EQ(values.size(), sketch.count());
+    std::sort(values.begin(), values.end());
+    // 1024 buckets span about 9 decades, only the lowest values are collapsed, so the high
+    // quantiles keep their accuracy
+    EXPECT_GT(sketch.quantile(0.01), 1e4);
+    for (double q : {0.75, 0.9, 0.99, 1.0}) {
+        double expected = true_quantile(values, q);
+        EXPECT_NEAR(expected, sketch.quantile(q), expected * 0.01);
+    }
+    EXPECT_LE(sketch.serialized_size(), 1024 * 10 + 64);
+}
+
+} // namespace doris
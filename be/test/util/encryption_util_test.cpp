@@ -21,6 +21,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "util/url_coding.h"
 
@@ -226,4 +227,48 @@ TEST_F(EncryptionUtilTest, sm4_with_iv_test_by_case) {
     EXPECT_EQ(source_2, decrypted_content_21);
 }
 
+// the rows encrypted and decrypted by reused contexts are the same as by the contexts used once,
+// while the modes, the keys and the ivs change between the rows
+TEST_F(EncryptionUtilTest, reuse_cipher_context) {
+    std::vector<EncryptionMode> modes = {AES_128_ECB, AES_128_ECB, AES_256_CBC, AES_256_CBC,
+                                         AES_192_CTR, AES_192_CTR, SM4_128_ECB, SM4_128_CBC};
+    std::vector<std::string> keys = {_aes_key, "another key", _aes_key, _aes_key};
+    std::vector<std::string> ivs = {"doris", "another iv"};
+    CipherContext encrypt_ctx;
+    CipherContext decrypt_ctx;
+    for (size_t i = 0; i < 64; ++i) {
+        EncryptionMode mode = modes[i % modes.size()];
+        const std::string& key = keys[i % keys.size()];
+        const std::string& iv = ivs[i / 3 % ivs.size()];
+        std::string source = "row " + std::to_string(i) + " of the cipher context test";
+
+        unsigned char expected[128];
+        int expected_length = EncryptionUtil::encrypt(
+                mode, (unsigned char*)source.c_str(), source.length(),
+                (unsigned char*)key.c_str(), key.length(), iv.c_str(), true, expected);
+        ASSERT_GT(expected_length, 0);
+        unsigned char encrypted[128];
+        int length = EncryptionUtil::encrypt(&encrypt_ctx, mode, (unsigned char*)source.c_str(),
+                                             source.length(), (unsigned char*)key.c_str(),
+                                             key.length(), iv.c_str(), true, encrypted);
+        ASSERT_EQ(expected_length, length);
+        EXPECT_EQ(0, memcmp(expected, encrypted, length));
+
+        unsigned char decrypted[128];
+        length = EncryptionUtil::decrypt(&decrypt_ctx, mode, encrypted, length,
+                                         (unsigned char*)key.c_str(), key.length(), iv.c_str(),
+                                         true, decrypted);
+        ASSERT_GT(length, 0);
+        EXPECT_EQ(source, std::string((char*)decrypted, length));
+
+        // a failed decryption doesn't break the next rows
+        if (mode == AES_128_ECB) {
+            EXPECT_EQ(AES_BAD_DATA,
+                      EncryptionUtil::decrypt(&decrypt_ctx, mode, encrypted, 15,
+                                              (unsigned char*)key.c_str(), key.length(),
+                                              iv.c_str(), true, decrypted));
+        }
+    }
+}
+
 } // namespace doris
@@ -19,6 +19,10 @@
 
 #include <gtest/gtest.h>
 
+#include <memory>
+
+#include "util/cpu_info.h"
+
 namespace doris {
 class TestForCoding : public testing::Test {
 public:
@@ -65,6 +69,37 @@ public:
 
         EXPECT_EQ(expect_result, actual_result);
     }
+
+    // The unordered values of each bit width in frames of 128 values, decoded with and
+    // without AVX-512.
+    template <typename T>
+    static void test_bit_widths(int max_bit_width) {
+        for (int bit_width = 1; bit_width <= max_bit_width; ++bit_width) {
+            faststring buffer(1);
+            ForEncoder<T> encoder(&buffer);
+            std::vector<T> data;
+            for (uint64_t i = 0; i < 300; ++i) {
+                // the first value is 0 and the odd values are the max value of the bit width
+                uint64_t value = i % 2 == 0 ? i * 0x9E3779B97F4A7C15ULL : ~0ULL;
+                data.push_back(static_cast<T>(value & ((1ULL << bit_width) - 1)));
+            }
+            encoder.put_batch(data.data(), data.size());
+            encoder.flush();
+
+            for (bool avx512 : {true, false}) {
+                std::unique_ptr<CpuInfo::TempDisable> disable;
+                if (!avx512) {
+                    disable = std::make_unique<CpuInfo::TempDisable>(CpuInfo::AVX512VBMI);
+                }
+                ForDecoder<T> decoder(buffer.data(), buffer.length());
+                decoder.init();
+                std::vector<T> actual_result(data.size());
+                decoder.get_batch(actual_result.data(), data.size());
+                EXPECT_EQ(data, actual_result)
+                        << "bit width " << bit_width << ", avx512 " << avx512;
+            }
+        }
+    }
 };
 
 TEST_F(TestForCoding, TestHalfFrame) {
@@ -114,6 +149,13 @@ TEST_F(TestForCoding, TestInt64) {
     EXPECT_EQ(data, actual_result);
 }
 
+TEST_F(TestForCoding, TestBitWidths) {
+    test_bit_widths<int8_t>(7);
+    test_bit_widths<int16_t>(15);
+    test_bit_widths<int32_t>(31);
+    test_bit_widths<int64_t>(63);
+}
+
 TEST_F(TestForCoding, TestOneMinValue) {
     faststring buffer(1);
     ForEncoder<int32_t> encoder(&buffer);
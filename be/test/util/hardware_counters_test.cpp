@@ -0,0 +1,69 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "util/runtime_profile.h"
+
+namespace doris {
+
+static int64_t busy_loop(int n) {
+    volatile int64_t sum = 0;
+    for (int i = 0; i < n; ++i) {
+        sum += i;
+    }
+    return sum;
+}
+
+TEST(HardwareCountersTest, NestedScopes) {
+    if (ThreadPerfEvents::current() == nullptr) {
+        GTEST_SKIP() << "the perf events are not available";
+    }
+    RuntimeProfile profile("Fragment");
+    RuntimeProfile parent_profile("Parent");
+    RuntimeProfile child_profile("Child");
+    HardwareCounters total(&profile, nullptr, "Fragment");
+    HardwareCounters parent(&parent_profile, &total);
+    HardwareCounters child(&child_profile, &total);
+    {
+        SCOPED_HARDWARE_COUNTERS(&parent);
+        busy_loop(1000);
+        {
+            SCOPED_HARDWARE_COUNTERS(&child);
+            busy_loop(100000);
+        }
+        busy_loop(1000);
+    }
+    int64_t parent_instructions = parent.counters[ThreadPerfEvents::INSTRUCTIONS]->value();
+    int64_t child_instructions = child.counters[ThreadPerfEvents::INSTRUCTIONS]->value();
+    EXPECT_GT(parent_instructions, 0);
+    // the events of the child are not counted by the parent
+    EXPECT_GT(child_instructions, parent_instructions);
+    EXPECT_EQ(parent_instructions + child_instructions,
+              total.counters[ThreadPerfEvents::INSTRUCTIONS]->value());
+    EXPECT_NE(nullptr, parent_profile.get_counter("HWInstructions"));
+    EXPECT_NE(nullptr, profile.get_counter("FragmentHWCycles"));
+}
+
+TEST(HardwareCountersTest, Disabled) {
+    // nothing is counted without the counters
+    SCOPED_HARDWARE_COUNTERS(nullptr);
+    busy_loop(1000);
+}
+
+} // namespace doris
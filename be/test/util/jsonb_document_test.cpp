@@ -0,0 +1,94 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/jsonb_document.h"
+
+#include <gtest/gtest.h>
+#include <rapidjson/stringbuffer.h>
+#include <rapidjson/writer.h>
+
+namespace doris {
+
+static std::string encode(const std::string& json) {
+    std::string jsonb;
+    EXPECT_TRUE(JsonbValue::encode(json.data(), json.size(), &jsonb));
+    return jsonb;
+}
+
+static std::string to_json(const JsonbValue& value) {
+    rapidjson::Document document;
+    EXPECT_TRUE(value.to_rapidjson(&document, document.GetAllocator()));
+    rapidjson::StringBuffer buf;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buf);
+    document.Accept(writer);
+    return std::string(buf.GetString(), buf.GetSize());
+}
+
+TEST(JsonbDocumentTest, find) {
+    std::string jsonb = encode(
+            R"({"k2": [1, -2, 3000000000, 18446744073709551615, 1.5], "k1": {"a": "x", "b": null},)"
+            R"( "k3": true, "k1": 1})");
+    auto root = JsonbValue::open(jsonb);
+    EXPECT_EQ(JsonbValue::OBJECT, root.type());
+    EXPECT_EQ(4u, root.size());
+
+    auto k1 = root.find("k1");
+    EXPECT_EQ(JsonbValue::OBJECT, k1.type());
+    EXPECT_EQ("x", k1.find("a").get_string());
+    EXPECT_EQ(JsonbValue::NULL_VALUE, k1.find("b").type());
+    EXPECT_FALSE(k1.find("c").is_valid());
+
+    auto k2 = root.find("k2");
+    EXPECT_EQ(5u, k2.size());
+    EXPECT_EQ(1, k2.at(0).get_int64());
+    EXPECT_EQ(-2, k2.at(1).get_int64());
+    EXPECT_EQ(3000000000, k2.at(2).get_int64());
+    EXPECT_EQ(JsonbValue::UINT64, k2.at(3).type());
+    EXPECT_EQ(18446744073709551615ULL, k2.at(3).get_uint64());
+    EXPECT_EQ(1.5, k2.at(4).get_double());
+    EXPECT_FALSE(k2.at(5).is_valid());
+    EXPECT_FALSE(k2.find("a").is_valid());
+
+    EXPECT_EQ(JsonbValue::TRUE_VALUE, root.find("k3").type());
+    EXPECT_FALSE(root.find("k0").is_valid());
+    EXPECT_FALSE(root.find("k4").is_valid());
+
+    // the members keep the order of the json
+    EXPECT_EQ(R"({"k2":[1,-2,3000000000,18446744073709551615,1.5],"k1":{"a":"x","b":null},)"
+              R"("k3":true,"k1":1})",
+              to_json(root));
+}
+
+TEST(JsonbDocumentTest, invalid) {
+    std::string jsonb;
+    EXPECT_FALSE(JsonbValue::encode("{\"k1\":", 6, &jsonb));
+    EXPECT_FALSE(JsonbValue::open("{\"k1\": 1}").is_valid());
+    EXPECT_FALSE(JsonbValue::open("").is_valid());
+
+    // a truncated document is never read out of its bytes
+    jsonb = encode(R"({"k1": [1, 2, "abc"], "k2": "v2"})");
+    for (size_t size = 1; size < jsonb.size(); ++size) {
+        auto root = JsonbValue::open(std::string_view(jsonb.data(), size));
+        rapidjson::Document document;
+        EXPECT_FALSE(root.to_rapidjson(&document, document.GetAllocator()));
+        EXPECT_FALSE(root.find("k2").is_valid());
+        root.find("k1").at(2).get_string();
+    }
+}
+
+} // namespace doris
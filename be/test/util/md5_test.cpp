@@ -40,4 +40,17 @@ TEST_F(Md5Test, normal) {
     EXPECT_STREQ("7ac66c0f148de9519b8bd264312c4d64", digest.hex().c_str());
 }
 
+TEST_F(Md5Test, reset) {
+    Md5Digest digest;
+    digest.update("abcdefg", 7);
+    digest.digest();
+    digest.reset();
+    digest.digest();
+    EXPECT_STREQ("d41d8cd98f00b204e9800998ecf8427e", digest.hex().c_str());
+    digest.reset();
+    digest.update("abcdefg", 7);
+    digest.digest();
+    EXPECT_STREQ("7ac66c0f148de9519b8bd264312c4d64", digest.hex().c_str());
+}
+
 } // namespace doris
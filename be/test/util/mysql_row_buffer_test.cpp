@@ -119,4 +119,33 @@ TEST(MysqlRowBufferTest, dynamic_mode) {
     EXPECT_EQ(0, strncmp(buf + 43, "test", 4));
 }
 
+TEST(MysqlRowBufferTest, dynamic_mode_realloc) {
+    MysqlRowBuffer mrb;
+    // leave 5 bytes in the default buffer of 4096 bytes, less than the header of dynamic mode
+    std::string s(4088, 'a');
+    mrb.push_string(s.c_str(), s.size());
+    EXPECT_EQ(4091, mrb.length());
+
+    EXPECT_EQ(0, mrb.open_dynamic_mode());
+    // the buffer is reallocated several times in dynamic mode
+    std::string data;
+    for (int i = 0; i < 1000; ++i) {
+        std::string value = std::to_string(i) + std::string(i % 50, 'b');
+        EXPECT_EQ(0, mrb.push_string(value.c_str(), value.size()));
+        data += value;
+    }
+    EXPECT_EQ(0, mrb.open_dynamic_mode());
+    EXPECT_EQ(0, mrb.push_int(-30000));
+    mrb.close_dynamic_mode();
+    data += "-30000";
+    mrb.close_dynamic_mode();
+
+    const char* buf = mrb.buf();
+    EXPECT_EQ(4091 + 9 + data.size(), mrb.length());
+    EXPECT_EQ(0, strncmp(buf + 3, s.c_str(), s.size()));
+    EXPECT_EQ(254, *((uint8_t*)(buf + 4091)));
+    EXPECT_EQ(data.size(), *((int64_t*)(buf + 4092)));
+    EXPECT_EQ(data, std::string(buf + 4100, data.size()));
+}
+
 } // namespace doris
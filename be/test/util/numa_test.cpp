@@ -0,0 +1,111 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "util/cpu_info.h"
+#include "util/disk_info.h"
+#include "util/priority_work_stealing_thread_pool.hpp"
+
+namespace doris {
+
+// the cores the calling thread may run on
+static std::vector<int> current_thread_cores() {
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    EXPECT_EQ(0, pthread_getaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set));
+    std::vector<int> cores;
+    for (int core = 0; core < CPU_SETSIZE; ++core) {
+        if (CPU_ISSET(core, &cpu_set)) {
+            cores.push_back(core);
+        }
+    }
+    return cores;
+}
+
+// whether the cores are all of the NUMA node, the cores not allowed for the process are not
+// bound
+static bool on_numa_node(const std::vector<int>& cores, int node) {
+    const auto& node_cores = CpuInfo::get_cores_of_numa_node(node);
+    return !cores.empty() && std::all_of(cores.begin(), cores.end(), [&node_cores](int core) {
+        return std::find(node_cores.begin(), node_cores.end(), core) != node_cores.end();
+    });
+}
+
+TEST(NumaTest, bind_current_thread_to_numa_node) {
+    for (int node = 0; node < CpuInfo::get_max_num_numa_nodes(); ++node) {
+        if (CpuInfo::get_cores_of_numa_node(node).empty()) {
+            continue;
+        }
+        std::thread thread([node]() {
+            Status st = CpuInfo::bind_current_thread_to_numa_node(node);
+            EXPECT_TRUE(st.ok()) << st.to_string();
+            EXPECT_TRUE(on_numa_node(current_thread_cores(), node)) << node;
+        });
+        thread.join();
+    }
+}
+
+TEST(NumaTest, work_stealing_thread_pool) {
+    // the threads of both queues run on the node of the queue, so do the stolen tasks
+    int node = CpuInfo::get_max_num_numa_nodes() - 1;
+    PriorityWorkStealingThreadPool thread_pool(4, 2, 100, {node, node});
+    std::mutex lock;
+    std::vector<std::vector<int>> task_cores;
+    for (int i = 0; i < 8; ++i) {
+        PriorityThreadPool::Task task;
+        task.priority = 0;
+        task.queue_id = i % 2;
+        task.work_function = [&lock, &task_cores]() {
+            std::lock_guard<std::mutex> l(lock);
+            task_cores.push_back(current_thread_cores());
+        };
+        EXPECT_TRUE(thread_pool.offer(std::move(task)));
+    }
+    thread_pool.drain_and_shutdown();
+    ASSERT_EQ(8, task_cores.size());
+    for (const auto& cores : task_cores) {
+        EXPECT_TRUE(on_numa_node(cores, node));
+    }
+}
+
+TEST(NumaTest, disk_name_of_partition) {
+    EXPECT_EQ("sda", DiskInfo::disk_name_of_partition("sda2"));
+    EXPECT_EQ("sda", DiskInfo::disk_name_of_partition("sda"));
+    EXPECT_EQ("vdb", DiskInfo::disk_name_of_partition("vdb13"));
+    EXPECT_EQ("nvme0n1", DiskInfo::disk_name_of_partition("nvme0n1p2"));
+    EXPECT_EQ("nvme0n1", DiskInfo::disk_name_of_partition("nvme0n1"));
+    EXPECT_EQ("nvme10n12", DiskInfo::disk_name_of_partition("nvme10n12p10"));
+}
+
+TEST(NumaTest, disk_numa_node) {
+    // the NUMA node of a disk is unknown or one of the nodes
+    for (int disk_id = 0; disk_id < DiskInfo::num_disks(); ++disk_id) {
+        int node = DiskInfo::numa_node(disk_id);
+        EXPECT_GE(node, -1);
+        EXPECT_LT(node, CpuInfo::get_max_num_numa_nodes());
+    }
+}
+
+} // namespace doris
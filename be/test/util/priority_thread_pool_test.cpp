@@ -0,0 +1,63 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/priority_thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include "util/blocking_priority_queue.hpp"
+#include "util/countdown_latch.h"
+
+namespace doris {
+
+TEST(BlockingPriorityQueueTest, try_put) {
+    BlockingPriorityQueue<int> queue(2);
+    EXPECT_TRUE(queue.try_put(1));
+    EXPECT_TRUE(queue.try_put(2));
+    // the full queue isn't waited for
+    EXPECT_FALSE(queue.try_put(3));
+    int value = 0;
+    EXPECT_TRUE(queue.blocking_get(&value));
+    EXPECT_EQ(2, value);
+    EXPECT_TRUE(queue.try_put(3));
+
+    queue.shutdown();
+    EXPECT_FALSE(queue.try_put(4));
+}
+
+TEST(PriorityThreadPoolTest, try_offer) {
+    PriorityThreadPool pool(1, 1);
+    CountDownLatch started(1);
+    CountDownLatch blocked(1);
+    EXPECT_TRUE(pool.try_offer([&]() {
+        started.count_down();
+        blocked.wait();
+    }));
+    started.wait();
+    CountDownLatch done(1);
+    EXPECT_TRUE(pool.try_offer([&]() { done.count_down(); }));
+    EXPECT_FALSE(pool.try_offer([]() {}));
+    EXPECT_EQ(1, pool.get_queue_size());
+
+    blocked.count_down();
+    done.wait();
+    pool.shutdown();
+    EXPECT_FALSE(pool.try_offer([]() {}));
+    pool.join();
+}
+
+} // namespace doris
@@ -19,6 +19,8 @@
 
 #include <gtest/gtest.h>
 
+#include "common/config.h"
+
 namespace doris {
 using DoubleQuantileState = QuantileState<double>;
 
@@ -51,4 +53,39 @@ TEST(QuantileStateTest, merge) {
     EXPECT_EQ(10, another.get_value_by_percentile(1));
 }
 
+TEST(QuantileStateTest, ddsketch) {
+    bool enable_ddsketch = config::enable_quantile_ddsketch;
+    config::enable_quantile_ddsketch = true;
+    DoubleQuantileState sketch;
+    for (int i = 1; i <= 10000; ++i) {
+        sketch.add_value(i);
+    }
+    EXPECT_EQ(DDSKETCH, sketch._type);
+    EXPECT_NEAR(5000, sketch.get_value_by_percentile(0.5), 5000 * 0.01);
+    EXPECT_NEAR(9900, sketch.get_value_by_percentile(0.99), 9900 * 0.01);
+
+    std::string buf(sketch.get_serialized_size(), '\0');
+    size_t size = sketch.serialize((uint8_t*)buf.data());
+    EXPECT_EQ(buf.size(), size);
+    Slice slice(buf.data(), size);
+    EXPECT_TRUE(sketch.is_valid(slice));
+    DoubleQuantileState copy(slice);
+    EXPECT_EQ(DDSKETCH, copy._type);
+    EXPECT_EQ(sketch.get_value_by_percentile(0.5), copy.get_value_by_percentile(0.5));
+    EXPECT_FALSE(sketch.is_valid(Slice(buf.data(), size - 1)));
+
+    // a TDigest is converted to DDSketch when merged with a DDSketch
+    config::enable_quantile_ddsketch = false;
+    DoubleQuantileState tdigest;
+    for (int i = 10001; i <= 20000; ++i) {
+        tdigest.add_value(i);
+    }
+    EXPECT_EQ(TDIGEST, tdigest._type);
+    tdigest.merge(copy);
+    EXPECT_EQ(DDSKETCH, tdigest._type);
+    EXPECT_NEAR(10000, tdigest.get_value_by_percentile(0.5), 10000 * 0.02);
+    EXPECT_NEAR(19800, tdigest.get_value_by_percentile(0.99), 19800 * 0.02);
+    config::enable_quantile_ddsketch = enable_ddsketch;
+}
+
 } // namespace doris
@@ -0,0 +1,67 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/rate_limiter.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "util/stopwatch.hpp"
+
+namespace doris {
+
+TEST(RateLimiterTest, no_limit) {
+    RateLimiter limiter([]() { return 0; });
+    MonotonicStopWatch watch;
+    watch.start();
+    for (int i = 0; i < 1000; ++i) {
+        limiter.acquire(1024 * 1024);
+    }
+    ASSERT_LT(watch.elapsed_time(), 1000UL * 1000 * 1000);
+}
+
+TEST(RateLimiterTest, shared_limit) {
+    // 10MB/s shared by 4 threads, each acquiring 1MB
+    RateLimiter limiter([]() { return 10L * 1024 * 1024; });
+    MonotonicStopWatch watch;
+    watch.start();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&limiter]() { limiter.acquire(1024 * 1024); });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    // the last thread waits for the 4MB to be consumed
+    ASSERT_GE(watch.elapsed_time(), 350UL * 1000 * 1000);
+}
+
+TEST(RateLimiterTest, mutable_limit) {
+    std::atomic<int64_t> rate {1024};
+    RateLimiter limiter([&rate]() { return rate.load(); });
+    rate = 0;
+    MonotonicStopWatch watch;
+    watch.start();
+    limiter.acquire(1024 * 1024);
+    ASSERT_LT(watch.elapsed_time(), 1000UL * 1000 * 1000);
+}
+
+} // namespace doris
@@ -20,6 +20,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <limits>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -34,6 +35,7 @@
 #include "util/bit_stream_utils.h"
 #include "util/bit_stream_utils.inline.h"
 #include "util/bit_util.h"
+#include "util/cpu_info.h"
 #include "util/debug_util.h"
 #include "util/faststring.h"
 #include "util/rle_encoding.h"
@@ -361,6 +363,39 @@ TEST_F(TestRle, TestRoundTripRandomSequencesWithRuns) {
         EXPECT_EQ(string_rep, roundtrip_str);
     }
 }
+
+TEST_F(TestRle, TestGetBatch) {
+    srand(time(nullptr));
+
+    // The literal runs of the bools are expanded by AVX-512 once at the start of a byte.
+    for (bool avx512 : {true, false}) {
+        std::unique_ptr<CpuInfo::TempDisable> disable;
+        if (!avx512) {
+            disable = std::make_unique<CpuInfo::TempDisable>(CpuInfo::AVX512BW);
+        }
+        for (int rep = 0; rep < 100; rep++) {
+            faststring buf;
+            std::string string_rep;
+            int num_bits = GenerateRandomBitString(100, &buf, &string_rep);
+            RleDecoder<bool> decoder(buf.data(), buf.size(), 1);
+            int skip = random() % (num_bits + 1);
+            decoder.Skip(skip);
+            std::string roundtrip_str = string_rep.substr(0, skip);
+            for (int rem_to_read = num_bits - skip; rem_to_read > 0;) {
+                // read at most 200 values at once, across the runs
+                bool values[200];
+                size_t num = std::min<int>(rem_to_read, random() % 200 + 1);
+                EXPECT_EQ(num, decoder.GetBatch(values, num));
+                for (size_t i = 0; i < num; ++i) {
+                    roundtrip_str.push_back(values[i] ? '1' : '0');
+                }
+                rem_to_read -= num;
+            }
+            EXPECT_EQ(string_rep, roundtrip_str) << "avx512 " << avx512;
+        }
+    }
+}
+
 TEST_F(TestRle, TestSkip) {
     faststring buffer(1);
     RleEncoder<bool> encoder(&buffer, 1);
@@ -28,6 +28,7 @@
 #include <map>
 #include <string>
 
+#include "common/config.h"
 #include "util/file_utils.h"
 #include "util/storage_backend.h"
 
@@ -186,4 +187,35 @@ TEST_F(S3StorageBackendTest, s3_mkdir) {
     EXPECT_TRUE(status.code() == TStatusCode::NOT_FOUND);
 }
 
+TEST_F(S3StorageBackendTest, s3_multipart_transfer) {
+    // a file of 3 parts and a half, uploaded by multipart upload and downloaded by ranged reads
+    int64_t threshold_mb = config::s3_multipart_threshold_mb;
+    int64_t part_size_mb = config::s3_transfer_part_size_mb;
+    config::s3_multipart_threshold_mb = 5;
+    config::s3_transfer_part_size_mb = 5;
+    {
+        std::ofstream out(_test_file);
+        for (int64_t written = 0; written < 17 * 1024 * 1024; written += _content.size()) {
+            out << _content;
+        }
+    }
+    std::string orig_md5sum;
+    FileUtils::md5sum(_test_file, &orig_md5sum);
+    Status status = _s3->upload(_test_file, _s3_base_path + "/large.txt");
+    EXPECT_TRUE(status.ok()) << status.to_string();
+
+    std::string download_md5sum;
+    status = _s3->download_with_md5(_s3_base_path + "/large.txt", _test_file + ".download",
+                                    &download_md5sum);
+    EXPECT_TRUE(status.ok()) << status.to_string();
+    EXPECT_EQ(orig_md5sum, download_md5sum);
+    std::string md5sum;
+    FileUtils::md5sum(_test_file + ".download", &md5sum);
+    EXPECT_EQ(orig_md5sum, md5sum);
+    remove((_test_file + ".download").c_str());
+
+    config::s3_multipart_threshold_mb = threshold_mb;
+    config::s3_transfer_part_size_mb = part_size_mb;
+}
+
 } // end namespace doris
@@ -0,0 +1,74 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "util/sampling_profiler.h"
+
+#include <gtest/gtest.h>
+
+#include <ctime>
+
+#include "util/time.h"
+
+namespace doris {
+
+static int64_t busy_loop(int64_t millis) {
+    volatile int64_t sum = 0;
+    int64_t end = MonotonicMillis() + millis;
+    while (MonotonicMillis() < end) {
+        for (int i = 0; i < 10000; ++i) {
+            sum += i;
+        }
+    }
+    return sum;
+}
+
+TEST(SamplingProfilerTest, TaggedSamples) {
+    SamplingProfiler* profiler = SamplingProfiler::instance();
+    ASSERT_TRUE(profiler->start(1000, 60).ok());
+    int64_t start_sec = time(nullptr);
+    tls_sampling_tag.set_task_id("test_query");
+    {
+        SCOPED_SAMPLING_NODE_TAG(7);
+        busy_loop(500);
+    }
+    tls_sampling_tag.set_task_id("");
+    profiler->drain();
+    EXPECT_GT(profiler->num_samples(), 0);
+
+    std::string folded;
+    profiler->get_folded_stacks(start_sec, time(nullptr), "test_query", &folded);
+    EXPECT_NE(std::string::npos, folded.find("test_query;node_7;")) << folded;
+    // only the samples of the task are exported
+    EXPECT_EQ(std::string::npos, folded.find("no_task"));
+
+    // out of the range
+    std::string empty;
+    profiler->get_folded_stacks(0, start_sec - 1, "", &empty);
+    EXPECT_TRUE(empty.empty());
+
+    profiler->stop();
+    EXPECT_FALSE(profiler->is_running());
+}
+
+TEST(SamplingProfilerTest, InvalidArgument) {
+    EXPECT_FALSE(SamplingProfiler::instance()->start(0, 60).ok());
+    EXPECT_FALSE(SamplingProfiler::instance()->start(10, 0).ok());
+    EXPECT_FALSE(SamplingProfiler::instance()->is_running());
+}
+
+} // namespace doris
@@ -0,0 +1,106 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "util/simd/bits.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace doris {
+
+static std::vector<size_t> char_positions(const std::string& data, char c) {
+    std::vector<size_t> positions;
+    simd::for_each_char_position(data.data(), data.size(), c,
+                                 [&](size_t pos) { positions.push_back(pos); });
+    return positions;
+}
+
+static std::vector<size_t> expected_positions(const std::string& data, char c) {
+    std::vector<size_t> positions;
+    for (size_t pos = 0; pos < data.size(); ++pos) {
+        if (data[pos] == c) {
+            positions.push_back(pos);
+        }
+    }
+    return positions;
+}
+
+TEST(SimdBitsTest, for_each_char_position_boundaries) {
+    // the positions around the 16 and 32 bytes compared at a time, and in the tail
+    for (size_t size = 0; size <= 70; ++size) {
+        for (size_t pos : {0, 1, 14, 15, 16, 17, 30, 31, 32, 33, 47, 48, 63, 64, 69}) {
+            if (pos >= size) {
+                continue;
+            }
+            std::string data(size, 'a');
+            data[pos] = ',';
+            EXPECT_EQ(std::vector<size_t> {pos}, char_positions(data, ','))
+                    << "size " << size << ", pos " << pos;
+        }
+        // all of the bytes, and none of them
+        std::string data(size, ',');
+        EXPECT_EQ(expected_positions(data, ','), char_positions(data, ',')) << size;
+        EXPECT_TRUE(char_positions(data, ';').empty()) << size;
+    }
+}
+
+TEST(SimdBitsTest, for_each_char_position_in_order) {
+    // the short fields of csv lines, the positions are all in order
+    std::string data;
+    for (int i = 0; i < 300; ++i) {
+        data += std::string(i % 5, 'x') + std::to_string(i) + (i % 7 == 0 ? "\t" : ",");
+    }
+    for (size_t size : {data.size(), data.size() - 1, size_t(100), size_t(33)}) {
+        std::string prefix = data.substr(0, size);
+        EXPECT_EQ(expected_positions(prefix, ','), char_positions(prefix, ',')) << size;
+        EXPECT_EQ(expected_positions(prefix, '\t'), char_positions(prefix, '\t')) << size;
+    }
+}
+
+TEST(SimdBitsTest, for_each_char_position_of_any_byte) {
+    // the signed bytes and the zero byte are compared as the others
+    std::string data;
+    for (int i = 0; i < 1000; ++i) {
+        data.push_back(static_cast<char>(i * 37 % 256));
+    }
+    for (char c : {'\0', '\x7f', '\x80', '\xff', 'a'}) {
+        auto positions = char_positions(data, c);
+        EXPECT_FALSE(positions.empty());
+        EXPECT_EQ(expected_positions(data, c), positions) << static_cast<int>(c);
+    }
+}
+
+TEST(SimdBitsTest, bytes_mask_to_bits_mask) {
+    uint8_t bytes[32] = {};
+    EXPECT_EQ(0u, simd::bytes32_mask_to_bits32_mask(bytes));
+    for (int i : {0, 1, 15, 16, 17, 31}) {
+        bytes[i] = 1;
+    }
+    uint32_t expected = (1u << 0) | (1u << 1) | (1u << 15) | (1u << 16) | (1u << 17) | (1u << 31);
+    EXPECT_EQ(expected, simd::bytes32_mask_to_bits32_mask(bytes));
+
+    char chars[16];
+    std::fill(chars, chars + 16, 'a');
+    chars[0] = chars[9] = chars[15] = 'b';
+    EXPECT_EQ((1u << 0) | (1u << 9) | (1u << 15), simd::bytes16_equal_mask(chars, 'b'));
+    EXPECT_EQ(0u, simd::bytes16_equal_mask(chars, 'c'));
+}
+
+} // namespace doris
@@ -60,4 +60,19 @@ TEST_F(SM3Test, normal) {
     }
 }
 
+TEST_F(SM3Test, reset) {
+    SM3Digest digest;
+    digest.update("abc", 3);
+    digest.digest();
+    digest.reset();
+    digest.update("0123456789", 10);
+    digest.digest();
+    EXPECT_STREQ("09093b72553f5d9d622d6c62f5ffd916ee959679b1bd4d169c3e12aa8328e743",
+                 digest.hex().c_str());
+    digest.reset();
+    digest.digest();
+    EXPECT_STREQ("1ab21d8355cfa17f8e61194831e81a8f22bec8c728fefb747ed035eb5082aa2b",
+                 digest.hex().c_str());
+}
+
 } // namespace doris
@@ -212,6 +212,24 @@ TEST(StringToInt, InvalidLeadingTrailing) {
     test_int_value<int8_t>("   ", 0, StringParser::PARSE_FAILURE);
 }
 
+TEST(StringToInt, LongDigits) {
+    // parsed by 16 or 8 digits a step
+    test_int_value<int32_t>("123456789", 123456789, StringParser::PARSE_SUCCESS);
+    test_int_value<int32_t>("-00000001", -1, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("1234567890123456", 1234567890123456, StringParser::PARSE_SUCCESS);
+    test_int_value<int64_t>("-123456789012345678", -123456789012345678,
+                            StringParser::PARSE_SUCCESS);
+    test_unsigned_int_value<uint64_t>("12345678901234567", 12345678901234567,
+                                      StringParser::PARSE_SUCCESS);
+
+    // a non-digit in a step of 8 or 16 digits
+    test_int_value<int32_t>("1234567x", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int32_t>("1234 5678", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("123456789012345x", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("12345678901234567/", 0, StringParser::PARSE_FAILURE);
+    test_int_value<int64_t>("1234567890123:456", 0, StringParser::PARSE_FAILURE);
+}
+
 TEST(StringToInt, Limit) {
     test_int_value<int8_t>("127", 127, StringParser::PARSE_SUCCESS);
     test_int_value<int8_t>("-128", -128, StringParser::PARSE_SUCCESS);
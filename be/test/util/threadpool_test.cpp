@@ -893,4 +893,70 @@ TEST_F(ThreadPoolTest, TestThreadPoolDynamicAdjustMaximumMinimum) {
     EXPECT_EQ(0, _pool->num_threads());
 }
 
+TEST_F(ThreadPoolTest, TestWorkStealing) {
+    EXPECT_TRUE(rebuild_pool_with_builder(ThreadPoolBuilder(kDefaultPoolName)
+                                                  .set_min_threads(0)
+                                                  .set_max_threads(8)
+                                                  .set_work_stealing(true))
+                        .ok());
+
+    // The tasks submitted by the tasks go to the queues of the workers, and are stolen by the
+    // other workers.
+    std::atomic<int32_t> counter(0);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(_pool->submit_func([&]() {
+                             for (int j = 0; j < 10; j++) {
+                                 EXPECT_TRUE(_pool->submit_func(std::bind(&simple_task_method, 1,
+                                                                          &counter))
+                                                     .ok());
+                             }
+                         })
+                            .ok());
+    }
+    // The tokens are not affected by the work stealing.
+    std::unique_ptr<ThreadPoolToken> token = _pool->new_token(ThreadPool::ExecutionMode::SERIAL);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_TRUE(token->submit_func(std::bind(&simple_task_method, 1, &counter)).ok());
+    }
+    token->wait();
+    _pool->wait();
+    EXPECT_EQ(100 * 10 + 100, counter.load());
+    EXPECT_EQ(0, _pool->get_queue_size());
+    EXPECT_EQ(0, _pool->num_active_threads());
+    token.reset();
+    _pool->shutdown();
+}
+
+TEST_F(ThreadPoolTest, TestWorkStealingShutdown) {
+    EXPECT_TRUE(rebuild_pool_with_builder(ThreadPoolBuilder(kDefaultPoolName)
+                                                  .set_min_threads(2)
+                                                  .set_max_threads(2)
+                                                  .set_max_queue_size(4)
+                                                  .set_work_stealing(true))
+                        .ok());
+
+    CountDownLatch latch(1);
+    EXPECT_TRUE(_pool->submit(SlowTask::new_slow_task(&latch)).ok());
+    EXPECT_TRUE(_pool->submit(SlowTask::new_slow_task(&latch)).ok());
+    while (_pool->num_active_threads() < 2 || _pool->get_queue_size() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::atomic<int32_t> counter(0);
+    for (int i = 0; i < 4; i++) {
+        EXPECT_TRUE(_pool->submit_func(std::bind(&simple_task_method, 1, &counter)).ok());
+    }
+    // Both of the threads are running and the queues are full.
+    EXPECT_FALSE(_pool->submit_func(std::bind(&simple_task_method, 1, &counter)).ok());
+    EXPECT_EQ(4, _pool->get_queue_size());
+
+    std::thread shutdown([&]() { _pool->shutdown(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    latch.count_down();
+    shutdown.join();
+    // The queued tasks are dropped by the shutdown.
+    EXPECT_EQ(0, counter.load());
+    EXPECT_EQ(0, _pool->get_queue_size());
+    EXPECT_EQ(0, _pool->num_threads());
+}
+
 } // namespace doris
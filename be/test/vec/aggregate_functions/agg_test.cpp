@@ -17,13 +17,22 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
+#include "common/config.h"
 #include "gtest/gtest.h"
 #include "vec/aggregate_functions/aggregate_function.h"
 #include "vec/aggregate_functions/aggregate_function_simple_factory.h"
 #include "vec/aggregate_functions/aggregate_function_topn.h"
+#include "vec/common/arena.h"
+#include "vec/common/string_buffer.hpp"
+#include "vec/columns/column_array.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
 #include "vec/data_types/data_type.h"
+#include "vec/data_types/data_type_decimal.h"
+#include "vec/data_types/data_type_nullable.h"
 #include "vec/data_types/data_type_number.h"
 #include "vec/data_types/data_type_string.h"
 
@@ -61,6 +70,300 @@ TEST(AggTest, basic_test) {
     agg_function->destroy(place);
 }
 
+TEST(AggTest, decimal_sum_test) {
+    // Decimal(18, 2), the partial sums overflow Int64 but the sum fits Decimal(18, 2)
+    auto column = ColumnDecimal<Decimal64>::create(0, 2);
+    for (int i = 0; i < 11; i++) {
+        column->get_data().push_back(Int64(900000000000000000));
+    }
+    for (int i = 0; i < 10; i++) {
+        column->get_data().push_back(Int64(-900000000000000000));
+    }
+    column->get_data().push_back(Int64(-12345));
+
+    AggregateFunctionSimpleFactory factory;
+    register_aggregate_function_sum(factory);
+    DataTypes data_types = {std::make_shared<DataTypeDecimal<Decimal64>>(18, 2)};
+    Array array;
+    auto agg_function = factory.get("sum", data_types, array);
+    auto return_type = agg_function->get_return_type();
+    EXPECT_EQ("Decimal(18, 2)", return_type->get_name());
+
+    std::unique_ptr<char[]> memory(new char[agg_function->size_of_data()]);
+    AggregateDataPtr place = memory.get();
+    agg_function->create(place);
+    const IColumn* columns[1] = {column.get()};
+    for (size_t i = 0; i < column->size(); i++) {
+        agg_function->add(place, columns, i, nullptr);
+    }
+    auto result = return_type->create_column();
+    agg_function->insert_result_into(place, *result);
+    EXPECT_EQ("8999999999999876.55", return_type->to_string(*result, 0));
+    agg_function->destroy(place);
+}
+
+TEST(AggTest, batch_add_test) {
+    // every third row is null, the even and the odd rows have 500 distinct values each
+    auto nested_column = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    for (int i = 0; i < agg_test_batch_size; i++) {
+        std::string str = std::to_string(i % 1000);
+        nested_column->insert_data(str.c_str(), str.length());
+        null_map->insert_value(i % 3 == 0);
+    }
+    auto column = ColumnNullable::create(std::move(nested_column), std::move(null_map));
+    const IColumn* columns[1] = {column.get()};
+    DataTypes data_types = {make_nullable(std::make_shared<DataTypeString>())};
+    Array array;
+
+    for (const auto& name : {"approx_count_distinct", "multi_distinct_count"}) {
+        auto agg_function =
+                AggregateFunctionSimpleFactory::instance().get(name, data_types, array, true);
+        ASSERT_NE(nullptr, agg_function);
+        // the places of the even rows, the odd rows and all the rows, added row by row and in
+        // batches
+        std::vector<std::unique_ptr<char[]>> memory;
+        std::vector<AggregateDataPtr> places;
+        for (int i = 0; i < 6; i++) {
+            memory.emplace_back(new char[agg_function->size_of_data()]);
+            places.push_back(memory.back().get());
+            agg_function->create(places.back());
+        }
+        std::vector<AggregateDataPtr> batch_places;
+        for (int i = 0; i < agg_test_batch_size; i++) {
+            agg_function->add(places[i % 2], columns, i, nullptr);
+            agg_function->add(places[2], columns, i, nullptr);
+            batch_places.push_back(places[3 + i % 2]);
+        }
+        agg_function->add_batch(agg_test_batch_size, batch_places.data(), 0, columns, nullptr);
+        agg_function->add_batch_single_place(agg_test_batch_size, places[5], columns, nullptr);
+
+        auto result = agg_function->get_return_type()->create_column();
+        for (auto place : places) {
+            agg_function->insert_result_into(place, *result);
+            agg_function->destroy(place);
+        }
+        for (int i = 0; i < 3; i++) {
+            EXPECT_EQ((*result)[i].get<Int64>(), (*result)[3 + i].get<Int64>()) << name;
+        }
+        if (std::string(name) == "multi_distinct_count") {
+            EXPECT_EQ(500, (*result)[0].get<Int64>());
+            EXPECT_EQ(500, (*result)[1].get<Int64>());
+            EXPECT_EQ(1000, (*result)[2].get<Int64>());
+        }
+    }
+}
+
+TEST(AggTest, batch_add_numbers_test) {
+    // the values of Int64 and Float64 with or without nulls, the rows of a group are consecutive
+    // runs of 100 rows
+    auto int_nested = ColumnInt64::create();
+    auto float_nested = ColumnFloat64::create();
+    auto null_map = ColumnUInt8::create();
+    auto no_null_map = ColumnUInt8::create();
+    for (int i = 0; i < agg_test_batch_size; i++) {
+        int_nested->insert_value(i * 7 % 1000 - 500);
+        float_nested->insert_value((i * 7 % 1000 - 500) * 0.5);
+        null_map->insert_value(i % 5 == 0);
+        no_null_map->insert_value(0);
+    }
+    auto nullable = [](const IColumn& nested, const IColumn& nulls) -> ColumnPtr {
+        return ColumnNullable::create(nested.clone_resized(nested.size()),
+                                      nulls.clone_resized(nulls.size()));
+    };
+    std::vector<std::pair<ColumnPtr, DataTypePtr>> inputs = {
+            {nullable(*int_nested, *null_map), std::make_shared<DataTypeInt64>()},
+            {nullable(*int_nested, *no_null_map), std::make_shared<DataTypeInt64>()},
+            {nullable(*float_nested, *null_map), std::make_shared<DataTypeFloat64>()},
+            {nullable(*float_nested, *no_null_map), std::make_shared<DataTypeFloat64>()}};
+    constexpr int num_groups = 4;
+
+    for (const auto& [column, type] : inputs) {
+        const IColumn* columns[1] = {column.get()};
+        DataTypes data_types = {make_nullable(type)};
+        Array array;
+        for (const auto& name : {"sum", "min", "max", "count"}) {
+            auto agg_function =
+                    AggregateFunctionSimpleFactory::instance().get(name, data_types, array, true);
+            ASSERT_NE(nullptr, agg_function);
+            // the places of the groups and of all the rows, added row by row and in batches
+            std::vector<std::unique_ptr<char[]>> memory;
+            std::vector<AggregateDataPtr> places;
+            for (int i = 0; i < 2 * (num_groups + 1); i++) {
+                memory.emplace_back(new char[agg_function->size_of_data()]);
+                places.push_back(memory.back().get());
+                agg_function->create(places.back());
+            }
+            std::vector<AggregateDataPtr> batch_places;
+            for (int i = 0; i < agg_test_batch_size; i++) {
+                int group = i / 100 % num_groups;
+                agg_function->add(places[group], columns, i, nullptr);
+                agg_function->add(places[num_groups], columns, i, nullptr);
+                batch_places.push_back(places[num_groups + 1 + group]);
+            }
+            agg_function->add_batch(agg_test_batch_size, batch_places.data(), 0, columns,
+                                    nullptr);
+            agg_function->add_batch_single_place(agg_test_batch_size, places.back(), columns,
+                                                 nullptr);
+
+            auto result = agg_function->get_return_type()->create_column();
+            for (auto place : places) {
+                agg_function->insert_result_into(place, *result);
+                agg_function->destroy(place);
+            }
+            for (int i = 0; i <= num_groups; i++) {
+                EXPECT_TRUE((*result)[i] == (*result)[num_groups + 1 + i])
+                        << name << " " << column->get_name() << " " << i;
+            }
+        }
+    }
+}
+
+TEST(AggTest, arena_string_states_test) {
+    // the strings of the sizes from 1 to about 140, the long ones are out of the states
+    auto strings = ColumnString::create();
+    auto top_nums = ColumnInt32::create();
+    for (int i = 0; i < agg_test_batch_size; i++) {
+        std::string str = std::string(i % 7 * 20, 'a') + std::to_string(i % 100);
+        strings->insert_data(str.c_str(), str.length());
+        top_nums->insert_value(10);
+    }
+    const IColumn* columns[2] = {strings.get(), top_nums.get()};
+    DataTypes string_types = {std::make_shared<DataTypeString>()};
+    DataTypes topn_types = {std::make_shared<DataTypeString>(), std::make_shared<DataTypeInt32>()};
+    Array array;
+
+    for (const auto& [name, data_types] : std::vector<std::pair<std::string, DataTypes>> {
+                 {"group_concat", string_types}, {"max", string_types}, {"topn", topn_types}}) {
+        auto agg_function =
+                AggregateFunctionSimpleFactory::instance().get(name, data_types, array, false);
+        ASSERT_NE(nullptr, agg_function);
+        std::vector<std::unique_ptr<char[]>> memory;
+        std::vector<AggregateDataPtr> places;
+        for (int i = 0; i < 4; i++) {
+            memory.emplace_back(new char[agg_function->size_of_data()]);
+            places.push_back(memory.back().get());
+            agg_function->create(places.back());
+        }
+        // the two halves of the rows are added with the arena, and merged through serialization
+        // as the two phases of the aggregation, the same as all the rows added without arena
+        Arena arena;
+        for (int i = 0; i < agg_test_batch_size; i++) {
+            agg_function->add(places[i * 2 / agg_test_batch_size], columns, i, &arena);
+            agg_function->add(places[3], columns, i, nullptr);
+        }
+        ColumnString buf;
+        VectorBufferWriter buf_writer(buf);
+        agg_function->serialize(places[1], buf_writer);
+        buf_writer.commit();
+        VectorBufferReader buf_reader(buf.get_data_at(0));
+        agg_function->deserialize(places[2], buf_reader, &arena);
+        agg_function->merge(places[0], places[2], &arena);
+
+        auto result = agg_function->get_return_type()->create_column();
+        agg_function->insert_result_into(places[0], *result);
+        agg_function->insert_result_into(places[3], *result);
+        EXPECT_EQ(result->get_data_at(1).to_string(), result->get_data_at(0).to_string())
+                << name;
+        EXPECT_FALSE(result->get_data_at(0).to_string().empty()) << name;
+        for (auto place : places) {
+            agg_function->destroy(place);
+        }
+    }
+}
+
+TEST(AggTest, multi_distinct_count_bitmap_test) {
+    // the distinct values of each half are the 1000 odd values in -999..999 and the 1000 ids
+    // after 1 << 40
+    auto column = ColumnInt64::create();
+    for (int i = 0; i < agg_test_batch_size; i++) {
+        column->insert_value(i % 2 ? (i * 7 % 2000 - 1000) : (1L << 40) + i / 2 % 1000);
+    }
+    const IColumn* columns[1] = {column.get()};
+    DataTypes data_types = {std::make_shared<DataTypeInt64>()};
+    Array array;
+
+    bool enable_bitmap = config::enable_multi_distinct_count_bitmap;
+    for (bool bitmap : {false, true}) {
+        config::enable_multi_distinct_count_bitmap = bitmap;
+        auto agg_function = AggregateFunctionSimpleFactory::instance().get(
+                "multi_distinct_count", data_types, array, false);
+        ASSERT_NE(nullptr, agg_function);
+        std::vector<std::unique_ptr<char[]>> memory;
+        std::vector<AggregateDataPtr> places;
+        for (int i = 0; i < 3; i++) {
+            memory.emplace_back(new char[agg_function->size_of_data()]);
+            places.push_back(memory.back().get());
+            agg_function->create(places.back());
+        }
+        // the two halves of the rows are merged through serialization
+        size_t half = agg_test_batch_size / 2;
+        agg_function->add_batch_single_place(half, places[0], columns, nullptr);
+        for (size_t i = half; i < agg_test_batch_size; i++) {
+            agg_function->add(places[1], columns, i, nullptr);
+        }
+        ColumnString buf;
+        VectorBufferWriter buf_writer(buf);
+        agg_function->serialize(places[1], buf_writer);
+        buf_writer.commit();
+        VectorBufferReader buf_reader(buf.get_data_at(0));
+        agg_function->deserialize(places[2], buf_reader, nullptr);
+        agg_function->merge(places[0], places[2], nullptr);
+
+        auto result = agg_function->get_return_type()->create_column();
+        agg_function->insert_result_into(places[0], *result);
+        agg_function->insert_result_into(places[2], *result);
+        EXPECT_EQ(2000, (*result)[0].get<Int64>()) << bitmap;
+        EXPECT_EQ(2000, (*result)[1].get<Int64>()) << bitmap;
+        for (auto place : places) {
+            agg_function->destroy(place);
+        }
+    }
+    config::enable_multi_distinct_count_bitmap = enable_bitmap;
+}
+
+TEST(AggTest, collect_list_test) {
+    auto column = ColumnString::create();
+    for (int i = 0; i < 3; i++) {
+        std::string str = std::to_string(i);
+        column->insert_data(str.c_str(), str.length());
+    }
+    const IColumn* columns[1] = {column.get()};
+    DataTypes data_types = {std::make_shared<DataTypeString>()};
+    Array array;
+
+    auto agg_function =
+            AggregateFunctionSimpleFactory::instance().get("array_agg", data_types, array, false);
+    ASSERT_NE(nullptr, agg_function);
+    std::vector<std::unique_ptr<char[]>> memory;
+    std::vector<AggregateDataPtr> places;
+    for (int i = 0; i < 3; i++) {
+        memory.emplace_back(new char[agg_function->size_of_data()]);
+        places.push_back(memory.back().get());
+        agg_function->create(places.back());
+    }
+    agg_function->add_batch_single_place(2, places[0], columns, nullptr);
+    agg_function->add(places[1], columns, 2, nullptr);
+    ColumnString buf;
+    VectorBufferWriter buf_writer(buf);
+    agg_function->serialize(places[1], buf_writer);
+    buf_writer.commit();
+    VectorBufferReader buf_reader(buf.get_data_at(0));
+    agg_function->deserialize(places[2], buf_reader, nullptr);
+    agg_function->merge(places[0], places[2], nullptr);
+
+    auto result = agg_function->get_return_type()->create_column();
+    agg_function->insert_result_into(places[0], *result);
+    agg_function->insert_result_into(places[2], *result);
+    Array expect0 = {Field("0", 1), Field("1", 1), Field("2", 1)};
+    Array expect1 = {Field("2", 1)};
+    EXPECT_EQ(expect0, (*result)[0].get<Array>());
+    EXPECT_EQ(expect1, (*result)[1].get<Array>());
+    for (auto place : places) {
+        agg_function->destroy(place);
+    }
+}
+
 TEST(AggTest, topn_test) {
     MutableColumns datas(2);
     datas[0] = ColumnString::create();
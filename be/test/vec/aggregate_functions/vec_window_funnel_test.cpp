@@ -415,4 +415,67 @@ TEST_F(VWindowFunnelTest, testMax4ReverseSortedMerge) {
     }
 }
 
+TEST_F(VWindowFunnelTest, testCompletedChain) {
+    // the events of the rows are 1, 2, 3, 4, 1, 2, ... one second apart, so the first four rows
+    // reach the last level
+    const int NUM_ROWS = 1000;
+    const int NUM_CONDS = 4;
+    auto column_mode = ColumnString::create();
+    auto column_timestamp = ColumnVector<Int64>::create();
+    auto column_window = ColumnVector<Int64>::create();
+    MutableColumns column_events;
+    for (int j = 0; j < NUM_CONDS; j++) {
+        column_events.push_back(ColumnVector<UInt8>::create());
+    }
+    for (int i = 0; i < NUM_ROWS; i++) {
+        column_mode->insert("mode");
+        VecDateTimeValue time_value;
+        time_value.set_time(2022, 2, 28, 0, i / 60, i % 60);
+        column_timestamp->insert_data((char*)&time_value, 0);
+        column_window->insert(NUM_CONDS);
+        for (int j = 0; j < NUM_CONDS; j++) {
+            column_events[j]->insert(i % NUM_CONDS == j ? 1 : 0);
+        }
+    }
+    const IColumn* column[7] = {column_window.get(),    column_mode.get(),
+                                column_timestamp.get(), column_events[0].get(),
+                                column_events[1].get(), column_events[2].get(),
+                                column_events[3].get()};
+
+    std::unique_ptr<char[]> memory(new char[agg_function->size_of_data()]);
+    AggregateDataPtr place = memory.get();
+    agg_function->create(place);
+    for (int i = 0; i < NUM_ROWS; i++) {
+        agg_function->add(place, column, i, nullptr);
+    }
+
+    // only a chain of one event per level is serialized
+    ColumnString buf;
+    VectorBufferWriter buf_writer(buf);
+    agg_function->serialize(place, buf_writer);
+    buf_writer.commit();
+    EXPECT_LT(buf.get_data_at(0).size, 64);
+
+    // merged with the events in the reverse order of time
+    std::unique_ptr<char[]> memory2(new char[agg_function->size_of_data()]);
+    AggregateDataPtr place2 = memory2.get();
+    agg_function->create(place2);
+    for (int i = NUM_ROWS - 1; i >= 0; i--) {
+        agg_function->add(place2, column, i, nullptr);
+    }
+    std::unique_ptr<char[]> memory3(new char[agg_function->size_of_data()]);
+    AggregateDataPtr place3 = memory3.get();
+    agg_function->create(place3);
+    VectorBufferReader buf_reader(buf.get_data_at(0));
+    agg_function->deserialize(place3, buf_reader, nullptr);
+    agg_function->merge(place2, place3, nullptr);
+
+    ColumnVector<Int32> column_result;
+    agg_function->insert_result_into(place2, column_result);
+    EXPECT_EQ(column_result.get_data()[0], NUM_CONDS);
+    agg_function->destroy(place);
+    agg_function->destroy(place2);
+    agg_function->destroy(place3);
+}
+
 } // namespace doris::vectorized
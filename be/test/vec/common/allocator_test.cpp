@@ -0,0 +1,84 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/common/allocator.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+
+namespace doris::vectorized {
+
+TEST(AllocatorTest, ReuseCachedChunk) {
+    MmapChunkCache::instance()->purge();
+    Allocator<false> allocator;
+    size_t size = MMAP_THRESHOLD * 4;
+    char* buf = reinterpret_cast<char*>(allocator.alloc(size));
+    memset(buf, 1, size);
+    allocator.free(buf, size);
+    EXPECT_EQ(size, MmapChunkCache::instance()->cached_bytes());
+
+    // a chunk of another size is not reused
+    char* other = reinterpret_cast<char*>(allocator.alloc(size * 2));
+    EXPECT_NE(buf, other);
+    allocator.free(other, size * 2);
+    EXPECT_EQ(size * 3, MmapChunkCache::instance()->cached_bytes());
+
+    EXPECT_EQ(buf, allocator.alloc(size));
+    EXPECT_EQ(size * 2, MmapChunkCache::instance()->cached_bytes());
+    allocator.free(buf, size);
+
+    // the reused chunk is zeroed for the allocators which clear the memory
+    Allocator<true> clear_allocator;
+    char* cleared = reinterpret_cast<char*>(clear_allocator.alloc(size));
+    EXPECT_EQ(buf, cleared);
+    for (size_t i = 0; i < size; ++i) {
+        ASSERT_EQ(0, cleared[i]);
+    }
+    clear_allocator.free(cleared, size);
+    MmapChunkCache::instance()->purge();
+    EXPECT_EQ(0, MmapChunkCache::instance()->cached_bytes());
+}
+
+TEST(AllocatorTest, CacheLimit) {
+    MmapChunkCache::instance()->purge();
+    int64_t cache_bytes = config::vec_allocator_chunk_cache_bytes;
+    size_t size = MMAP_THRESHOLD * 4;
+    config::vec_allocator_chunk_cache_bytes = size;
+
+    Allocator<false> allocator;
+    void* buf1 = allocator.alloc(size);
+    void* buf2 = allocator.alloc(size);
+    allocator.free(buf1, size);
+    // the cache is full, unmap it
+    allocator.free(buf2, size);
+    EXPECT_EQ(size, MmapChunkCache::instance()->cached_bytes());
+
+    // growing by mremap keeps the content
+    char* buf = reinterpret_cast<char*>(allocator.alloc(size));
+    memset(buf, 1, size);
+    buf = reinterpret_cast<char*>(allocator.realloc(buf, size, size * 2));
+    EXPECT_EQ(1, buf[size - 1]);
+    EXPECT_EQ(0, buf[size]);
+    allocator.free(buf, size * 2);
+
+    MmapChunkCache::instance()->purge();
+    config::vec_allocator_chunk_cache_bytes = cache_bytes;
+}
+
+} // namespace doris::vectorized
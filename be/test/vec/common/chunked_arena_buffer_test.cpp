@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/common/chunked_arena_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+namespace doris::vectorized {
+
+static std::string to_string(const ChunkedArenaBuffer& buffer) {
+    std::string str(buffer.size(), '\0');
+    buffer.copy_to(str.data());
+    return str;
+}
+
+TEST(ChunkedArenaBufferTest, append) {
+    Arena arena;
+    for (Arena* buffer_arena : {&arena, static_cast<Arena*>(nullptr)}) {
+        ChunkedArenaBuffer buffer;
+        EXPECT_TRUE(buffer.empty());
+        std::string expected;
+        size_t num_chunks = 0;
+        for (int i = 0; i < 10000; ++i) {
+            std::string value = std::to_string(i) + ",";
+            buffer.append(value.data(), value.size(), buffer_arena);
+            expected += value;
+        }
+        buffer.for_each_chunk([&](const char*, size_t size) {
+            EXPECT_LE(size, ChunkedArenaBuffer::MAX_CHUNK_SIZE);
+            ++num_chunks;
+        });
+        EXPECT_EQ(expected.size(), buffer.size());
+        EXPECT_EQ(expected, to_string(buffer));
+        // the chunks grow by the size of the buffer
+        EXPECT_LT(num_chunks, 15);
+
+        // a value larger than the max chunk size is appended to a chunk of its size
+        std::string large(ChunkedArenaBuffer::MAX_CHUNK_SIZE * 3, 'x');
+        buffer.append(large.data(), large.size(), buffer_arena);
+        expected += large;
+        EXPECT_EQ(expected, to_string(buffer));
+
+        char* data = buffer.alloc(100, buffer_arena);
+        memset(data, 'y', 100);
+        expected += std::string(100, 'y');
+        EXPECT_EQ(expected, to_string(buffer));
+
+        buffer.clear();
+        EXPECT_TRUE(buffer.empty());
+        buffer.append("abc", 3, buffer_arena);
+        EXPECT_EQ("abc", to_string(buffer));
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,72 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/columns_hashing.h"
+
+#include <gtest/gtest.h>
+
+#include "vec/columns/column_vector.h"
+#include "vec/common/hash_table/hash_map.h"
+#include "vec/common/hash_table/string_hash_map.h"
+#include "vec/common/hash_table/two_level_hash_map.h"
+
+namespace doris::vectorized {
+
+using TestHashMap = HashMap<UInt64, UInt64, HashCRC32<UInt64>>;
+using TestKeyGetter =
+        ColumnsHashing::HashMethodOneNumber<TestHashMap::value_type, UInt64, UInt64, false>;
+
+static_assert(ColumnsHashing::is_batch_prefetchable_v<TestKeyGetter, TestHashMap>);
+static_assert(ColumnsHashing::is_batch_prefetchable_v<
+              TestKeyGetter, TwoLevelHashMap<UInt64, UInt64, HashCRC32<UInt64>>>);
+static_assert(!ColumnsHashing::is_batch_prefetchable_v<TestKeyGetter, StringHashMap<UInt64>>);
+
+TEST(ColumnsHashingTest, batch_hash_prefetcher) {
+    const size_t rows = 2000;
+    auto column = ColumnUInt64::create();
+    for (UInt64 i = 0; i < rows; ++i) {
+        column->insert_value(i * 7);
+    }
+    ColumnRawPtrs key_columns {column.get()};
+    Sizes key_sizes;
+    TestKeyGetter key_getter(key_columns, key_sizes, nullptr);
+    TestHashMap map;
+    Arena arena;
+
+    // emplace every other row by the hash values hashed by batch, from the row 3
+    ColumnsHashing::BatchHashPrefetcher prefetcher(key_getter, map, arena, rows, 16);
+    for (size_t i = 3; i < rows; i += 2) {
+        size_t hash_value = prefetcher.get_hash(i);
+        ASSERT_EQ(key_getter.get_hash(map, i, arena), hash_value) << i;
+        auto result = key_getter.emplace_key(map, hash_value, i, arena);
+        ASSERT_TRUE(result.is_inserted());
+        result.get_mapped() = i;
+    }
+    EXPECT_EQ((rows - 3 + 1) / 2, map.size());
+
+    ColumnsHashing::BatchHashPrefetcher no_prefetch(key_getter, map, arena, rows, 0);
+    for (size_t i = 0; i < rows; ++i) {
+        auto result = key_getter.find_key_with_hash(map, no_prefetch.get_hash(i), i, arena);
+        bool inserted = i >= 3 && i % 2 == 1;
+        ASSERT_EQ(inserted, result.is_found()) << i;
+        if (inserted) {
+            EXPECT_EQ(i, result.get_mapped());
+        }
+    }
+}
+
+} // namespace doris::vectorized
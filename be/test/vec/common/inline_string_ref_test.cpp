@@ -0,0 +1,101 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/common/inline_string_ref.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "vec/columns/column_string.h"
+
+namespace doris::vectorized {
+
+static int sign(int value) {
+    return value == 0 ? 0 : (value < 0 ? -1 : 1);
+}
+
+TEST(InlineStringRefTest, compare) {
+    // the strings around the prefix and inline sizes, with zeros and bytes over 127
+    std::vector<std::string> strs = {"",
+                                     std::string(1, '\0'),
+                                     "a",
+                                     std::string("a\0", 2),
+                                     "abcd",
+                                     "abce",
+                                     "abcde",
+                                     std::string("abcd\0", 5),
+                                     "abcdefghijkl",
+                                     "abcdefghijkm",
+                                     "abcdefghijklm",
+                                     "abcdefghijkln",
+                                     "abcdefghijkl\xff",
+                                     "\xff",
+                                     "\xff\xff\xff\xff\xff",
+                                     std::string(100, 'z')};
+    for (const auto& lhs : strs) {
+        InlineStringRef lhs_ref(lhs.data(), lhs.size());
+        EXPECT_EQ(lhs.size(), lhs_ref.size());
+        EXPECT_EQ(lhs, lhs_ref.to_string_ref().to_string());
+        EXPECT_EQ(lhs.size() <= InlineStringRef::INLINE_SIZE, lhs_ref.is_inlined());
+        for (const auto& rhs : strs) {
+            InlineStringRef rhs_ref(rhs.data(), rhs.size());
+            EXPECT_EQ(lhs == rhs, lhs_ref == rhs_ref) << lhs << " " << rhs;
+            EXPECT_EQ(sign(lhs.compare(rhs)), sign(lhs_ref.compare(rhs_ref))) << lhs << " " << rhs;
+        }
+    }
+
+    // the long strings equal on the prefix are compared by the pointed strings
+    std::string str1 = std::string(20, 'x') + "1";
+    std::string str2 = std::string(20, 'x') + "1";
+    EXPECT_TRUE(InlineStringRef(str1.data(), str1.size()) ==
+                InlineStringRef(str2.data(), str2.size()));
+}
+
+TEST(InlineStringRefTest, sort_column) {
+    std::mt19937 rng(0);
+    auto column = ColumnString::create();
+    for (size_t i = 0; i < 1000; ++i) {
+        std::string str(rng() % 20, 'a');
+        for (auto& c : str) {
+            c = 'a' + rng() % 3;
+        }
+        column->insert_data(str.data(), str.size());
+    }
+
+    for (bool reverse : {false, true}) {
+        for (size_t limit : {0, 10}) {
+            IColumn::Permutation expected;
+            config::enable_vec_inline_string_sort = false;
+            column->get_permutation(reverse, limit, 1, expected);
+            IColumn::Permutation perm;
+            config::enable_vec_inline_string_sort = true;
+            column->get_permutation(reverse, limit, 1, perm);
+            ASSERT_EQ(expected.size(), perm.size());
+            size_t rows = limit == 0 ? perm.size() : limit;
+            for (size_t i = 0; i < rows; ++i) {
+                EXPECT_EQ(column->get_data_at(expected[i]), column->get_data_at(perm[i]));
+            }
+        }
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,151 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/hash_table/string_hash_map.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <unordered_map>
+
+#include "vec/columns/column_string.h"
+#include "vec/common/arena.h"
+#include "vec/common/columns_hashing.h"
+
+namespace doris::vectorized {
+
+using TestStringHashMap = StringHashMap<UInt64>;
+
+// The keys of every sub table: the empty string, 1..8, 9..16, 17..24 and longer keys,
+// and keys with trailing zeros.
+static std::vector<std::string> create_keys() {
+    std::set<std::string> keys;
+    keys.emplace("");
+    for (int len = 1; len <= 40; ++len) {
+        for (int i = 0; i < 50; ++i) {
+            std::string key = std::to_string(i);
+            key.resize(len, 'x');
+            keys.insert(key);
+        }
+    }
+    keys.emplace(std::string("abc\0", 4));
+    keys.emplace(std::string("abcdefghijklmnop\0\0", 18));
+    return {keys.begin(), keys.end()};
+}
+
+// Put the keys into a ColumnString, the keys of a StringHashMap must be padded.
+static MutableColumnPtr create_key_column(const std::vector<std::string>& keys) {
+    auto column = ColumnString::create();
+    for (const auto& key : keys) {
+        column->insert_data(key.data(), key.size());
+    }
+    return column;
+}
+
+TEST(StringHashMapTest, emplace_and_find) {
+    auto keys = create_keys();
+    auto column = create_key_column(keys);
+    TestStringHashMap map;
+    Arena arena;
+
+    std::unordered_map<std::string, UInt64> expected;
+    for (size_t i = 0; i < column->size(); ++i) {
+        auto key = column->get_data_at(i);
+        TestStringHashMap::LookupResult it;
+        bool inserted = false;
+        map.emplace(ArenaKeyHolder {key, arena}, it, inserted);
+        bool expected_inserted = expected.emplace(key.to_string(), i).second;
+        EXPECT_EQ(expected_inserted, inserted);
+        if (inserted) {
+            *it = i;
+        }
+    }
+    EXPECT_EQ(expected.size(), map.size());
+
+    for (size_t i = 0; i < column->size(); ++i) {
+        auto key = column->get_data_at(i);
+        auto it = map.find(key);
+        ASSERT_NE(nullptr, it);
+        EXPECT_EQ(expected[key.to_string()], *it);
+    }
+    auto missing_column = create_key_column({"not_exist", "abcdefghijklmnopqrstuvwxyz0123"});
+    EXPECT_EQ(nullptr, map.find(missing_column->get_data_at(0)));
+    EXPECT_EQ(nullptr, map.find(missing_column->get_data_at(1)));
+
+    // every key is got back once by the iterator
+    size_t iterated = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ++iterated;
+        auto found = expected.find(it->get_first().to_string());
+        ASSERT_TRUE(found != expected.end());
+        EXPECT_EQ(found->second, it->get_second());
+    }
+    EXPECT_EQ(expected.size(), iterated);
+
+    size_t mapped_count = 0;
+    map.for_each_mapped([&](auto&) { ++mapped_count; });
+    EXPECT_EQ(expected.size(), mapped_count);
+}
+
+TEST(StringHashMapTest, empty_map) {
+    TestStringHashMap map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0, map.size());
+    EXPECT_TRUE(map.begin() == map.end());
+
+    // only the empty string
+    auto column = create_key_column({""});
+    map[column->get_data_at(0)] = 1;
+    EXPECT_EQ(1, map.size());
+    auto it = map.begin();
+    ASSERT_TRUE(it != map.end());
+    EXPECT_EQ(0, it->get_first().size);
+    EXPECT_EQ(1, it->get_second());
+    ++it;
+    EXPECT_TRUE(it == map.end());
+}
+
+TEST(StringHashMapTest, hash_method_string) {
+    using State = ColumnsHashing::HashMethodString<TestStringHashMap::value_type, UInt64, true,
+                                                   false>;
+    auto keys = create_keys();
+    auto column = create_key_column(keys);
+    ColumnRawPtrs key_columns {column.get()};
+    TestStringHashMap map;
+    Arena arena;
+
+    State state(key_columns, {}, nullptr);
+    for (size_t i = 0; i < column->size(); ++i) {
+        auto emplace_result = state.emplace_key(map, i, arena);
+        EXPECT_TRUE(emplace_result.is_inserted());
+        emplace_result.set_mapped(i);
+    }
+    // all the keys are found again
+    for (size_t i = 0; i < column->size(); ++i) {
+        auto emplace_result = state.emplace_key(map, i, arena);
+        EXPECT_FALSE(emplace_result.is_inserted());
+        EXPECT_EQ(i, emplace_result.get_mapped());
+
+        auto find_result = state.find_key(map, i, arena);
+        EXPECT_TRUE(find_result.is_found());
+        EXPECT_EQ(i, find_result.get_mapped());
+    }
+    EXPECT_EQ(keys.size(), map.size());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,77 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/common/string_searcher.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "vec/columns/column_string.h"
+
+namespace doris::vectorized {
+
+TEST(StringSearcherTest, search) {
+    // the needles of 1, 2 and more bytes at every position of a haystack longer than the
+    // SIMD blocks, and the partial matches before them
+    std::string haystack(100, 'a');
+    for (std::string needle : {"b", "ab", "abc", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab"}) {
+        StringSearcher searcher(needle);
+        for (size_t pos = 0; pos + needle.size() <= haystack.size(); ++pos) {
+            std::string str = haystack;
+            str.replace(pos, needle.size(), needle);
+            const auto* begin = reinterpret_cast<const uint8_t*>(str.data());
+            const auto* end = begin + str.size();
+            EXPECT_EQ(str.find(needle), static_cast<size_t>(searcher.search(begin, end) - begin));
+        }
+        const auto* begin = reinterpret_cast<const uint8_t*>(haystack.data());
+        const auto* end = begin + haystack.size();
+        EXPECT_EQ(end, searcher.search(begin, end));
+    }
+}
+
+TEST(StringSearcherTest, search_in_rows) {
+    std::vector<std::string> rows = {"",       "error",       "an error", "err",
+                                     "or",     "no",          std::string(40, 'x') + "error",
+                                     "errors", "error error", "rror"};
+    auto column = ColumnString::create();
+    for (const auto& row : rows) {
+        column->insert_data(row.data(), row.size());
+    }
+
+    StringSearcher searcher("error");
+    std::vector<int> positions(rows.size(), -1);
+    searcher.search_in_rows(column->get_chars(), column->get_offsets(),
+                            [&](size_t row, size_t pos) { positions[row] = pos; });
+    for (size_t i = 0; i < rows.size(); ++i) {
+        auto pos = rows[i].find("error");
+        EXPECT_EQ(pos == std::string::npos ? -1 : static_cast<int>(pos), positions[i]) << i;
+    }
+
+    // the prefixes of the needle at the ends of the rows are not matches
+    StringSearcher crossing("rror");
+    std::fill(positions.begin(), positions.end(), -1);
+    crossing.search_in_rows(column->get_chars(), column->get_offsets(),
+                            [&](size_t row, size_t pos) { positions[row] = pos; });
+    EXPECT_EQ(-1, positions[3]);
+    EXPECT_EQ(1, positions[1]);
+    EXPECT_EQ(0, positions[9]);
+}
+
+} // namespace doris::vectorized
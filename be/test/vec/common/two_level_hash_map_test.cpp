@@ -0,0 +1,118 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/common/hash_table/two_level_hash_map.h"
+
+#include <gtest/gtest.h>
+
+#include "vec/exec/vaggregation_node.h"
+
+namespace doris::vectorized {
+
+using TestHashMap = HashMap<UInt64, UInt64, HashCRC32<UInt64>>;
+using TestTwoLevelHashMap = TwoLevelHashMap<UInt64, UInt64, HashCRC32<UInt64>>;
+
+TEST(TwoLevelHashMapTest, insert_and_find) {
+    TestTwoLevelHashMap map;
+    const size_t num_keys = 100000;
+    // key 0 is stored in the zero value storage of its bucket
+    for (UInt64 i = 0; i < num_keys; ++i) {
+        map[i] = i * 2;
+    }
+    EXPECT_EQ(num_keys, map.size());
+    EXPECT_FALSE(map.empty());
+
+    for (UInt64 i = 0; i < num_keys; ++i) {
+        auto it = map.find(i);
+        ASSERT_NE(nullptr, it);
+        EXPECT_EQ(i * 2, *lookup_result_get_mapped(it));
+    }
+    EXPECT_EQ(nullptr, map.find(num_keys));
+
+    size_t iterated = 0;
+    UInt64 sum = 0;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        ++iterated;
+        sum += it->get_second();
+    }
+    EXPECT_EQ(num_keys, iterated);
+    EXPECT_EQ(num_keys * (num_keys - 1), sum);
+
+    size_t mapped_count = 0;
+    map.for_each_mapped([&](auto&) { ++mapped_count; });
+    EXPECT_EQ(num_keys, mapped_count);
+}
+
+TEST(TwoLevelHashMapTest, convert_from_single_level) {
+    TestHashMap map;
+    const size_t num_keys = 10000;
+    for (UInt64 i = 0; i < num_keys; ++i) {
+        map[i] = i + 1;
+    }
+
+    TestTwoLevelHashMap two_level_map(map);
+    EXPECT_EQ(num_keys, two_level_map.size());
+    for (UInt64 i = 0; i < num_keys; ++i) {
+        auto it = two_level_map.find(i);
+        ASSERT_NE(nullptr, it);
+        EXPECT_EQ(i + 1, *lookup_result_get_mapped(it));
+    }
+}
+
+TEST(TwoLevelHashMapTest, empty_map) {
+    TestTwoLevelHashMap map;
+    EXPECT_TRUE(map.empty());
+    EXPECT_EQ(0, map.size());
+    EXPECT_TRUE(map.begin() == map.end());
+    EXPECT_GT(map.get_buffer_size_in_bytes(), 0);
+}
+
+TEST(TwoLevelHashMapTest, convert_agg_data_with_null_key) {
+    using SingleLevelMethod = AggregationMethodSingleNullableColumn<
+            AggregationMethodOneNumber<UInt64, AggregatedDataWithNullableUInt64Key>>;
+    using TwoLevelMethod = AggregationMethodSingleNullableColumn<
+            AggregationMethodOneNumber<UInt64, AggregatedDataWithNullableUInt64KeyTwoLevel>>;
+
+    AggregatedDataVariants agg_data;
+    agg_data.init(AggregatedDataVariants::Type::int64_key, true);
+    EXPECT_TRUE(agg_data.is_convertible_to_two_level());
+
+    char state = 0;
+    auto& data = std::get<SingleLevelMethod>(agg_data._aggregated_method_variant).data;
+    for (UInt64 i = 0; i < 1000; ++i) {
+        data[i] = &state;
+    }
+    data.has_null_key_data() = true;
+    data.get_null_key_data() = &state;
+
+    agg_data.convert_to_two_level();
+    EXPECT_FALSE(agg_data.is_convertible_to_two_level());
+    auto& two_level_data = std::get<TwoLevelMethod>(agg_data._aggregated_method_variant).data;
+    // the null key is counted by size()
+    EXPECT_EQ(1001, two_level_data.size());
+    EXPECT_TRUE(two_level_data.has_null_key_data());
+    EXPECT_EQ(&state, two_level_data.get_null_key_data());
+    EXPECT_NE(nullptr, two_level_data.find(999));
+}
+
+TEST(TwoLevelHashMapTest, fixed_keys_not_convertible) {
+    AggregatedDataVariants agg_data;
+    agg_data.init(AggregatedDataVariants::Type::int8_key);
+    EXPECT_FALSE(agg_data.is_convertible_to_two_level());
+}
+
+} // namespace doris::vectorized
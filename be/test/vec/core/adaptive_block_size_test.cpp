@@ -0,0 +1,67 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/core/adaptive_block_size.h"
+
+#include <gtest/gtest.h>
+
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+TEST(AdaptiveBlockSizeTest, Disabled) {
+    AdaptiveBlockSize block_size(4096, 0, 65536);
+    EXPECT_FALSE(block_size.enabled());
+    block_size.observe(4096, 4096 * 1024);
+    EXPECT_EQ(4096, block_size.rows());
+}
+
+TEST(AdaptiveBlockSizeTest, ByRowWidth) {
+    AdaptiveBlockSize block_size(4096, 1 << 20, 65536);
+    // the batch size before any observation
+    EXPECT_EQ(4096, block_size.rows());
+
+    // narrow rows are bounded by the max rows
+    block_size.observe(4096, 4096 * 4);
+    EXPECT_EQ(65536, block_size.rows());
+
+    // wide rows get fewer rows than the batch size
+    AdaptiveBlockSize wide(4096, 1 << 20, 65536);
+    wide.observe(1024, 1024 * 1024);
+    EXPECT_EQ(1024, wide.rows());
+    // the width is averaged over the observed rows
+    wide.observe(1024, 1024 * 3 * 1024);
+    EXPECT_EQ(512, wide.rows());
+    // empty blocks are ignored
+    wide.observe(0, 0);
+    EXPECT_EQ(512, wide.rows());
+}
+
+TEST(AdaptiveBlockSizeTest, ObserveBlock) {
+    auto column = ColumnVector<Int64>::create();
+    for (int64_t i = 0; i < 100; ++i) {
+        column->insert_value(i);
+    }
+    Block block({{std::move(column), std::make_shared<DataTypeInt64>(), "k"}});
+    AdaptiveBlockSize block_size(1024, 8 * 512, 65536);
+    block_size.observe(block);
+    EXPECT_EQ(512, block_size.rows());
+}
+
+} // namespace doris::vectorized
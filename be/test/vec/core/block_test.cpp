@@ -31,6 +31,7 @@
 #include "vec/columns/column_nullable.h"
 #include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
+#include "vec/common/assert_cast.h"
 #include "vec/common/exception.h"
 #include "vec/data_types/data_type.h"
 #include "vec/data_types/data_type_nullable.h"
@@ -328,6 +329,272 @@ TEST(BlockTest, SerializeAndDeserializeBlock) {
     }
 }
 
+TEST(BlockTest, SerializeBitShuffleColumns) {
+    config::compress_rowbatches = false;
+    auto int_column = vectorized::ColumnVector<Int64>::create();
+    auto nullable_column = vectorized::ColumnNullable::create(
+            vectorized::ColumnVector<Int32>::create(), vectorized::ColumnUInt8::create());
+    auto str_column = vectorized::ColumnString::create();
+    for (int i = 0; i < 4096; ++i) {
+        int_column->insert_value(i * 8);
+        if (i % 3 == 0) {
+            nullable_column->insert_default();
+        } else {
+            int32_t value = i % 100;
+            nullable_column->insert_data((const char*)&value, sizeof(value));
+        }
+        std::string str = std::to_string(i);
+        str_column->insert_data(str.data(), str.size());
+    }
+    vectorized::DataTypePtr int_type(std::make_shared<vectorized::DataTypeInt64>());
+    vectorized::DataTypePtr nullable_type(
+            vectorized::make_nullable(std::make_shared<vectorized::DataTypeInt32>()));
+    vectorized::DataTypePtr str_type(std::make_shared<vectorized::DataTypeString>());
+    vectorized::Block block({{int_column->get_ptr(), int_type, "k1"},
+                             {nullable_column->get_ptr(), nullable_type, "k2"},
+                             {str_column->get_ptr(), str_type, "k3"}});
+
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    std::string column_values;
+    EXPECT_TRUE(block.serialize(&pblock, &uncompressed_bytes, &compressed_bytes, &column_values,
+                                true, PColumnMeta::BITSHUFFLE_LZ4)
+                        .ok());
+    EXPECT_EQ(pblock.column_metas(0).codec(), PColumnMeta::BITSHUFFLE_LZ4);
+    EXPECT_EQ(pblock.column_metas(1).codec(), PColumnMeta::BITSHUFFLE_LZ4);
+    EXPECT_EQ(pblock.column_metas(2).codec(), PColumnMeta::PLAIN);
+    EXPECT_LT(compressed_bytes, uncompressed_bytes);
+    EXPECT_EQ(compressed_bytes, column_values.size());
+    pblock.set_column_values(column_values);
+
+    vectorized::Block block2(pblock);
+    EXPECT_EQ(block2.rows(), block.rows());
+    for (size_t i = 0; i < block.columns(); ++i) {
+        for (size_t j = 0; j < block.rows(); ++j) {
+            EXPECT_EQ(block.get_by_position(i).column->compare_at(
+                              j, j, *block2.get_by_position(i).column, 1),
+                      0);
+        }
+    }
+    config::compress_rowbatches = true;
+}
+
+// The blocks serialized with the codec are the same after deserialized as the plain ones, with or
+// without the snappy of the whole block, and the columns whose encoding isn't smaller stay plain.
+TEST(BlockTest, SerializeBitShuffleRoundTrip) {
+    auto make_block = [](int rows) {
+        auto seq_column = vectorized::ColumnVector<Int64>::create();
+        auto random_column = vectorized::ColumnVector<UInt64>::create();
+        auto nullable_column = vectorized::ColumnNullable::create(
+                vectorized::ColumnVector<Int32>::create(), vectorized::ColumnUInt8::create());
+        vectorized::DataTypePtr decimal_type(doris::vectorized::create_decimal(27, 9));
+        auto decimal_column = decimal_type->create_column();
+        auto str_column = vectorized::ColumnString::create();
+        uint64_t seed = 7;
+        for (int i = 0; i < rows; ++i) {
+            seq_column->insert_value(1000000 + i);
+            // splitmix64, whose bits don't repeat
+            uint64_t random = (seed += 0x9E3779B97F4A7C15ULL);
+            random = (random ^ (random >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            random = (random ^ (random >> 27)) * 0x94D049BB133111EBULL;
+            random_column->insert_value(random ^ (random >> 31));
+            if (i % 5 == 0) {
+                nullable_column->insert_default();
+            } else {
+                int32_t value = -i;
+                nullable_column->insert_data((const char*)&value, sizeof(value));
+            }
+            __int128_t decimal = i * 1000000000LL + i % 10;
+            decimal_column->insert_data((const char*)&decimal, sizeof(decimal));
+            std::string str = "s" + std::to_string(i % 17);
+            str_column->insert_data(str.data(), str.size());
+        }
+        return vectorized::Block(
+                {{seq_column->get_ptr(), std::make_shared<vectorized::DataTypeInt64>(), "seq"},
+                 {random_column->get_ptr(), std::make_shared<vectorized::DataTypeUInt64>(),
+                  "random"},
+                 {nullable_column->get_ptr(),
+                  vectorized::make_nullable(std::make_shared<vectorized::DataTypeInt32>()),
+                  "nullable"},
+                 {decimal_column->get_ptr(), decimal_type, "decimal"},
+                 {str_column->get_ptr(), std::make_shared<vectorized::DataTypeString>(), "str"}});
+    };
+    auto round_trip = [](const vectorized::Block& block, PColumnMeta::Codec codec,
+                         PBlock* pblock) {
+        size_t uncompressed_bytes = 0;
+        size_t compressed_bytes = 0;
+        std::string column_values;
+        EXPECT_TRUE(block.serialize(pblock, &uncompressed_bytes, &compressed_bytes,
+                                    &column_values, true, codec)
+                            .ok());
+        EXPECT_EQ(compressed_bytes, column_values.size());
+        pblock->set_column_values(column_values);
+        return vectorized::Block(*pblock);
+    };
+
+    bool compress_rowbatches = config::compress_rowbatches;
+    for (bool compress : {false, true}) {
+        config::compress_rowbatches = compress;
+        for (int rows : {0, 1, 4096}) {
+            auto block = make_block(rows);
+            PBlock plain_pblock;
+            PBlock pblock;
+            auto plain_block = round_trip(block, PColumnMeta::PLAIN, &plain_pblock);
+            auto block2 = round_trip(block, PColumnMeta::BITSHUFFLE_LZ4, &pblock);
+            ASSERT_EQ(block.columns(), block2.columns());
+            EXPECT_EQ(block.rows(), block2.rows());
+            EXPECT_EQ(block.dump_structure(), block2.dump_structure());
+            for (size_t i = 0; i < block.columns(); ++i) {
+                EXPECT_EQ(PColumnMeta::PLAIN, plain_pblock.column_metas(i).codec());
+                for (size_t j = 0; j < block.rows(); ++j) {
+                    EXPECT_EQ(0, block.get_by_position(i).column->compare_at(
+                                         j, j, *block2.get_by_position(i).column, 1))
+                            << "column " << i << ", row " << j << ", rows " << rows;
+                    EXPECT_EQ(0, plain_block.get_by_position(i).column->compare_at(
+                                         j, j, *block2.get_by_position(i).column, 1));
+                }
+            }
+            // the sequence and the decimals shrink, the random values and the strings don't
+            auto expected_codec = rows > 1 ? PColumnMeta::BITSHUFFLE_LZ4 : PColumnMeta::PLAIN;
+            EXPECT_EQ(expected_codec, pblock.column_metas(0).codec()) << rows;
+            EXPECT_EQ(PColumnMeta::PLAIN, pblock.column_metas(1).codec()) << rows;
+            EXPECT_EQ(expected_codec, pblock.column_metas(3).codec()) << rows;
+            EXPECT_EQ(PColumnMeta::PLAIN, pblock.column_metas(4).codec()) << rows;
+        }
+    }
+    config::compress_rowbatches = compress_rowbatches;
+}
+
+TEST(BlockTest, DeserializeReuseColumns) {
+    auto int_column = vectorized::ColumnVector<Int64>::create();
+    auto str_column = vectorized::ColumnString::create();
+    for (int i = 0; i < 1024; ++i) {
+        int_column->insert_value(i);
+        std::string str = std::to_string(i);
+        str_column->insert_data(str.data(), str.size());
+    }
+    vectorized::Block block(
+            {{int_column->get_ptr(), std::make_shared<vectorized::DataTypeInt64>(), "k1"},
+             {str_column->get_ptr(), std::make_shared<vectorized::DataTypeString>(), "k2"}});
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    std::string column_values;
+    EXPECT_TRUE(block.serialize(&pblock, &uncompressed_bytes, &compressed_bytes, &column_values)
+                        .ok());
+    pblock.set_column_values(column_values);
+
+    auto int_data = [](const vectorized::Block& block) {
+        return assert_cast<const vectorized::ColumnInt64&>(*block.get_by_position(0).column)
+                .get_data()
+                .data();
+    };
+    vectorized::Block block2(pblock);
+    const vectorized::Int64* data = int_data(block2);
+    block2.clear_column_data();
+    block2.deserialize(pblock);
+    // the column is reused with its memory
+    EXPECT_EQ(data, int_data(block2));
+    EXPECT_EQ(block.rows(), block2.rows());
+    for (size_t i = 0; i < block.columns(); ++i) {
+        for (size_t j = 0; j < block.rows(); ++j) {
+            EXPECT_EQ(0, block.get_by_position(i).column->compare_at(
+                                 j, j, *block2.get_by_position(i).column, 1));
+        }
+    }
+
+    // the shared column is not changed
+    vectorized::ColumnPtr shared = block2.get_by_position(0).column;
+    block2.deserialize(pblock);
+    EXPECT_NE(data, int_data(block2));
+    EXPECT_EQ(block.rows(), shared->size());
+    EXPECT_EQ(block.rows(), block2.rows());
+}
+
+TEST(BlockTest, DeferFilterBySelection) {
+    auto make_filter = [](int rows, int mod) {
+        auto filter = vectorized::ColumnUInt8::create();
+        for (int i = 0; i < rows; ++i) {
+            filter->insert_value(i % mod != 0);
+        }
+        return filter;
+    };
+    auto int_column = vectorized::ColumnVector<Int32>::create();
+    for (int i = 0; i < 12; ++i) {
+        int_column->insert_value(i);
+    }
+    vectorized::DataTypePtr int_type(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::DataTypePtr filter_type(std::make_shared<vectorized::DataTypeUInt8>());
+    vectorized::Block block({{int_column->get_ptr(), int_type, "k1"}});
+
+    // keeps 8 of the 12 rows, the rows are not copied
+    block.insert({make_filter(12, 3)->get_ptr(), filter_type, "f"});
+    EXPECT_TRUE(vectorized::Block::filter_block(&block, 1, 1, true).ok());
+    EXPECT_EQ(1, block.columns());
+    EXPECT_EQ(12, block.rows());
+    EXPECT_TRUE(block.has_selection());
+    EXPECT_EQ(8, block.selected_rows());
+
+    // the next filter is combined with the selection, and the rows are copied once
+    block.insert({make_filter(12, 2)->get_ptr(), filter_type, "f"});
+    EXPECT_TRUE(vectorized::Block::filter_block(&block, 1, 1).ok());
+    EXPECT_FALSE(block.has_selection());
+    ASSERT_EQ(4, block.rows());
+    std::vector<int> expected {1, 5, 7, 11};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], block.get_by_position(0).column->get_int(i));
+    }
+
+    // too few rows are kept to defer the copy
+    block.insert({make_filter(4, 1)->get_ptr(), filter_type, "f"});
+    EXPECT_TRUE(vectorized::Block::filter_block(&block, 1, 1, true).ok());
+    EXPECT_FALSE(block.has_selection());
+    EXPECT_EQ(0, block.rows());
+}
+
+TEST(BlockTest, MaterializeSelection) {
+    auto int_column = vectorized::ColumnVector<Int32>::create();
+    for (int i = 0; i < 4; ++i) {
+        int_column->insert_value(i);
+    }
+    vectorized::DataTypePtr int_type(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::Block block({{int_column->get_ptr(), int_type, "k1"}});
+    block.set_selection(vectorized::IColumn::Filter {1, 0, 1, 1});
+    EXPECT_EQ(3, block.selected_rows());
+
+    vectorized::Block other;
+    other.swap(block);
+    EXPECT_FALSE(block.has_selection());
+    ASSERT_TRUE(other.has_selection());
+    other.materialize_selection();
+    EXPECT_FALSE(other.has_selection());
+    ASSERT_EQ(3, other.rows());
+    EXPECT_EQ(2, other.get_by_position(0).column->get_int(1));
+}
+
+TEST(BlockTest, ClearSharedColumnData) {
+    auto int_column = vectorized::ColumnVector<Int32>::create();
+    for (int i = 0; i < 4; ++i) {
+        int_column->insert_value(i);
+    }
+    vectorized::ColumnPtr shared = std::move(int_column);
+    vectorized::DataTypePtr int_type(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::Block block({{shared, int_type, "k1"}});
+    block.clear_column_data();
+    EXPECT_EQ(0, block.rows());
+    // the column shared with another block is replaced instead of cleared
+    EXPECT_NE(shared.get(), block.get_by_position(0).column.get());
+    EXPECT_EQ(4, shared->size());
+
+    shared = nullptr;
+    block.get_by_position(0).column->assume_mutable()->insert_default();
+    const vectorized::IColumn* column = block.get_by_position(0).column.get();
+    block.clear_column_data();
+    EXPECT_EQ(0, block.rows());
+    EXPECT_EQ(column, block.get_by_position(0).column.get());
+}
+
 TEST(BlockTest, dump_data) {
     auto vec = vectorized::ColumnVector<Int32>::create();
     auto& int32_data = vec->get_data();
@@ -23,6 +23,8 @@
 #include <memory>
 #include <string>
 
+#include "util/hash_util.hpp"
+#include "vec/columns/column_string.h"
 #include "vec/columns/column_vector.h"
 #include "vec/common/sip_hash.h"
 
@@ -50,4 +52,36 @@ TEST(ColumnNullableTest, HashTest) {
     EXPECT_NE(hashes[0].get64(), hashes[1].get64());
 }
 
+TEST(ColumnNullableTest, CrcHashTest) {
+    auto int_column = ColumnVector<int>::create();
+    auto str_column = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    std::vector<std::string> strs = {"a", "", "doris", "b"};
+    for (int i = 0; i < 4; ++i) {
+        int_column->insert_value(i);
+        str_column->insert_data(strs[i].data(), strs[i].size());
+        null_map->insert_value(i == 2);
+    }
+    ColumnPtr str_ptr = std::move(str_column);
+    auto nullable_column = ColumnNullable::create(std::move(int_column), std::move(null_map));
+
+    std::vector<uint32_t> hashes(4, 0);
+    nullable_column->update_crcs_with_value(hashes);
+    str_ptr->update_crcs_with_value(hashes);
+
+    const int null_value = 0;
+    for (int i = 0; i < 4; ++i) {
+        uint32_t expect = i == 2 ? HashUtil::crc_hash(&null_value, sizeof(int), 0)
+                                 : HashUtil::crc_hash(&i, sizeof(int), 0);
+        expect = HashUtil::crc_hash(strs[i].data(), strs[i].size(), expect);
+        EXPECT_EQ(hashes[i], expect);
+    }
+
+    // the default implementation by get_data_at hashes the same
+    std::vector<uint32_t> default_hashes(4, 0);
+    nullable_column->IColumn::update_crcs_with_value(default_hashes);
+    str_ptr->IColumn::update_crcs_with_value(default_hashes);
+    EXPECT_EQ(hashes, default_hashes);
+}
+
 } // namespace doris::vectorized
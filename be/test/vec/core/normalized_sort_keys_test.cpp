@@ -0,0 +1,169 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/normalized_sort_keys.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "common/config.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_array.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+constexpr size_t STRING_PREFIX = 4;
+
+Block make_block(size_t rows) {
+    std::mt19937 rng(42);
+    auto ints = ColumnVector<Int32>::create();
+    auto int_nulls = ColumnUInt8::create();
+    auto floats = ColumnVector<Float64>::create();
+    auto strings = ColumnString::create();
+    const Float64 float_values[] = {-1.5, -0.0, 0.0, 2.25,
+                                    std::numeric_limits<Float64>::quiet_NaN(),
+                                    -std::numeric_limits<Float64>::infinity()};
+    const std::string string_values[] = {"", "a", std::string("a\0", 2), "ab", "abcd", "abcde",
+                                         "abcdf", "b"};
+    for (size_t i = 0; i < rows; ++i) {
+        ints->insert_value(static_cast<Int32>(rng() % 5) - 2);
+        int_nulls->insert_value(rng() % 4 == 0);
+        floats->insert_value(float_values[rng() % 6]);
+        const auto& value = string_values[rng() % 8];
+        strings->insert_data(value.data(), value.size());
+    }
+    auto nullable_type = make_nullable(std::make_shared<DataTypeInt32>());
+    return {{ColumnNullable::create(std::move(ints), std::move(int_nulls)), nullable_type, "i"},
+            {std::move(floats), std::make_shared<DataTypeFloat64>(), "f"},
+            {std::move(strings), std::make_shared<DataTypeString>(), "s"}};
+}
+
+int compare_by_columns(const ColumnsWithSortDescriptions& columns, size_t a, size_t b) {
+    for (const auto& [column, desc] : columns) {
+        int res = desc.direction * column->compare_at(a, b, *column, desc.nulls_direction);
+        if (res != 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+int sign(int value) {
+    return value < 0 ? -1 : (value > 0 ? 1 : 0);
+}
+
+} // namespace
+
+TEST(NormalizedSortKeysTest, CompareAsColumns) {
+    Block block = make_block(200);
+    for (int direction : {1, -1}) {
+        for (int nulls_direction : {1, -1}) {
+            SortDescription description;
+            for (int i = 0; i < 3; ++i) {
+                description.emplace_back(i, direction, nulls_direction);
+            }
+            auto columns = get_columns_with_sort_description(block, description);
+            EXPECT_EQ(NormalizedSortKeys::key_size(columns, STRING_PREFIX),
+                      1 + sizeof(Int32) + sizeof(Float64) + STRING_PREFIX + 1);
+            NormalizedSortKeys keys(columns, STRING_PREFIX);
+            for (size_t a = 0; a < block.rows(); ++a) {
+                for (size_t b = 0; b < block.rows(); ++b) {
+                    int expected = sign(compare_by_columns(columns, a, b));
+                    int res = sign(keys.compare(a, b));
+                    if (res != 0 || (keys.is_exact(a) && keys.is_exact(b))) {
+                        EXPECT_EQ(expected, res) << a << " " << b;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(NormalizedSortKeysTest, UnsupportedColumn) {
+    auto array_type = std::make_shared<DataTypeArray>(std::make_shared<DataTypeInt32>());
+    Block block {{ColumnVector<Int32>::create(1, 0), std::make_shared<DataTypeInt32>(), "i"},
+                 {array_type->create_column_const_with_default_value(1), array_type, "a"}};
+    SortDescription description {{0, 1, 1}, {1, 1, 1}};
+    auto columns = get_columns_with_sort_description(block, description);
+    // a const column is not encoded
+    EXPECT_EQ(NormalizedSortKeys::key_size(columns, STRING_PREFIX), sizeof(Int32));
+
+    auto& array_column = block.get_by_position(1).column;
+    array_column = array_column->convert_to_full_column_if_const();
+    columns = get_columns_with_sort_description(block, description);
+    EXPECT_EQ(NormalizedSortKeys::key_size(columns, STRING_PREFIX), -1);
+}
+
+TEST(NormalizedSortKeysTest, SortBlock) {
+    for (UInt64 limit : {0, 17}) {
+        Block expected = make_block(300);
+        Block block = make_block(300);
+        SortDescription description {{2, -1, 1}, {0, 1, -1}, {1, 1, 1}};
+        config::enable_vec_normalized_sort_keys = false;
+        sort_block(expected, description, limit);
+        config::enable_vec_normalized_sort_keys = true;
+        sort_block(block, description, limit);
+        ASSERT_EQ(expected.rows(), block.rows());
+        auto expected_columns = get_columns_with_sort_description(expected, description);
+        auto columns = get_columns_with_sort_description(block, description);
+        for (size_t i = 0; i < block.rows(); ++i) {
+            for (size_t j = 0; j < columns.size(); ++j) {
+                EXPECT_EQ(0, columns[j].first->compare_at(i, i, *expected_columns[j].first, 1));
+            }
+        }
+    }
+}
+
+TEST(NormalizedSortKeysTest, RadixSort) {
+    Block block = make_block(1000);
+    for (int direction : {1, -1}) {
+        SortDescription description {{0, direction, 1}, {1, -direction, -1}};
+        auto columns = get_columns_with_sort_description(block, description);
+        NormalizedSortKeys keys(columns, STRING_PREFIX);
+        ASSERT_TRUE(keys.all_exact());
+        IColumn::Permutation perm;
+        keys.radix_sort(perm);
+        ASSERT_EQ(block.rows(), perm.size());
+        std::vector<bool> seen(block.rows(), false);
+        for (size_t i = 0; i < perm.size(); ++i) {
+            ASSERT_LT(perm[i], block.rows());
+            EXPECT_FALSE(seen[perm[i]]);
+            seen[perm[i]] = true;
+            if (i > 0) {
+                EXPECT_LE(compare_by_columns(columns, perm[i - 1], perm[i]), 0) << i;
+            }
+        }
+    }
+
+    // the strings longer than the prefix are not exact
+    SortDescription description {{2, 1, 1}};
+    NormalizedSortKeys keys(get_columns_with_sort_description(block, description), STRING_PREFIX);
+    EXPECT_FALSE(keys.all_exact());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,89 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/core/sort_cursor.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "vec/columns/columns_number.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+Block make_sorted_block(std::vector<Int32> values) {
+    std::sort(values.begin(), values.end());
+    auto column = ColumnVector<Int32>::create();
+    for (auto value : values) {
+        column->insert_value(value);
+    }
+    return {{std::move(column), std::make_shared<DataTypeInt32>(), "k"}};
+}
+
+} // namespace
+
+TEST(SortCursorLoserTreeTest, MergeRuns) {
+    std::mt19937 rng(7);
+    SortDescription description {{0, 1, 1}};
+    for (size_t num_runs : {1, 2, 3, 5, 8}) {
+        std::vector<Block> blocks;
+        std::vector<Int32> expected;
+        for (size_t i = 0; i < num_runs; ++i) {
+            // some runs are empty, and some overlap with the others
+            std::vector<Int32> values(i == 1 ? 0 : rng() % 50);
+            for (auto& value : values) {
+                value = rng() % (i == 2 ? 1000 : 20);
+                expected.push_back(value);
+            }
+            blocks.push_back(make_sorted_block(std::move(values)));
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<SortCursorImpl> impls;
+        impls.reserve(num_runs);
+        std::vector<SortCursorImpl*> cursors;
+        for (auto& block : blocks) {
+            impls.emplace_back(block, description);
+            cursors.push_back(&impls.back());
+        }
+        SortCursorLoserTree tree;
+        tree.init(cursors);
+
+        std::vector<Int32> merged;
+        while (!tree.empty()) {
+            SortCursorImpl* winner = tree.winner();
+            SortCursorImpl* runner_up = tree.runner_up();
+            Int32 value = assert_cast<const ColumnInt32*>(winner->sort_columns[0])
+                                  ->get_element(winner->pos);
+            if (runner_up != nullptr) {
+                Int32 next = assert_cast<const ColumnInt32*>(runner_up->sort_columns[0])
+                                     ->get_element(runner_up->pos);
+                EXPECT_LE(value, next);
+            }
+            merged.push_back(value);
+            winner->next();
+            tree.update_winner(winner->pos == winner->rows);
+        }
+        EXPECT_EQ(expected, merged);
+    }
+}
+
+} // namespace doris::vectorized
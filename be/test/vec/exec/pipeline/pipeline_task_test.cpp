@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/pipeline/pipeline.h"
+
+#include <gtest/gtest.h>
+
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+class FakeSourceOperator : public Operator {
+public:
+    FakeSourceOperator(int num_blocks, int rows_per_block)
+            : Operator(nullptr), _num_blocks(num_blocks), _rows_per_block(rows_per_block) {}
+
+    std::string name() const override { return "FakeSourceOperator"; }
+    Status open(RuntimeState* state) override { return Status::OK(); }
+    bool can_read() override { return _readable; }
+    const RowDescriptor& row_desc() const override { return _row_desc; }
+
+    Status pull(RuntimeState* state, Block* block, bool* eos) override {
+        auto column = ColumnInt32::create();
+        for (int i = 0; i < _rows_per_block; ++i) {
+            column->insert_value(i);
+        }
+        Block new_block({{std::move(column), std::make_shared<DataTypeInt32>(), "k1"}});
+        block->swap(new_block);
+        *eos = ++_num_pulled == _num_blocks;
+        return Status::OK();
+    }
+
+    bool _readable = true;
+
+private:
+    RowDescriptor _row_desc;
+    int _num_blocks;
+    int _rows_per_block;
+    int _num_pulled = 0;
+};
+
+// Outputs every input block twice.
+class DuplicateOperator : public Operator {
+public:
+    DuplicateOperator() : Operator(nullptr) {}
+
+    std::string name() const override { return "DuplicateOperator"; }
+    Status open(RuntimeState* state) override { return Status::OK(); }
+    const RowDescriptor& row_desc() const override { return _row_desc; }
+    bool need_more_input_data() const override { return _pending_outputs == 0 && !_input_eos; }
+
+    Status push(RuntimeState* state, Block* block, bool eos) override {
+        _input = *block;
+        _input_eos = eos;
+        _pending_outputs = 2;
+        return Status::OK();
+    }
+
+    Status pull(RuntimeState* state, Block* block, bool* eos) override {
+        *block = _input;
+        --_pending_outputs;
+        *eos = _input_eos && _pending_outputs == 0;
+        return Status::OK();
+    }
+
+private:
+    RowDescriptor _row_desc;
+    Block _input;
+    bool _input_eos = false;
+    int _pending_outputs = 0;
+};
+
+class FakeSinkOperator : public Operator {
+public:
+    explicit FakeSinkOperator(size_t row_limit = -1) : Operator(nullptr), _row_limit(row_limit) {}
+
+    std::string name() const override { return "FakeSinkOperator"; }
+    Status open(RuntimeState* state) override { return Status::OK(); }
+
+    Status push(RuntimeState* state, Block* block, bool eos) override {
+        _num_rows += block->rows();
+        _eos = eos;
+        if (_num_rows >= _row_limit) {
+            return Status::EndOfFile("reach limit");
+        }
+        return Status::OK();
+    }
+
+    size_t _num_rows = 0;
+    bool _eos = false;
+
+private:
+    size_t _row_limit;
+};
+
+class PipelineTaskTest : public ::testing::Test {
+protected:
+    PipelineTaskTest() : _state(TQueryGlobals()) {}
+
+    // the operators are added from the sink to the source as the plan is visited
+    void make_pipeline(FakeSinkOperator* sink, bool with_duplicate, FakeSourceOperator* source) {
+        _pipeline.add_operator(OperatorPtr(sink));
+        if (with_duplicate) {
+            _pipeline.add_operator(std::make_unique<DuplicateOperator>());
+        }
+        _pipeline.add_operator(OperatorPtr(source));
+        EXPECT_TRUE(_pipeline.finalize().ok());
+    }
+
+    RuntimeState _state;
+    Pipeline _pipeline {0};
+};
+
+TEST_F(PipelineTaskTest, run_to_finish) {
+    auto sink = new FakeSinkOperator();
+    make_pipeline(sink, true, new FakeSourceOperator(10, 100));
+
+    PipelineTask task(&_pipeline, nullptr, &_state);
+    EXPECT_TRUE(task.can_run());
+    while (task.state() != PipelineTaskState::FINISHED) {
+        EXPECT_TRUE(task.execute().ok());
+    }
+    EXPECT_EQ(2000, sink->_num_rows);
+    EXPECT_TRUE(sink->_eos);
+}
+
+TEST_F(PipelineTaskTest, blocked_by_source) {
+    auto sink = new FakeSinkOperator();
+    auto source = new FakeSourceOperator(2, 10);
+    make_pipeline(sink, false, source);
+
+    PipelineTask task(&_pipeline, nullptr, &_state);
+    source->_readable = false;
+    EXPECT_FALSE(task.can_run());
+    EXPECT_TRUE(task.execute().ok());
+    EXPECT_EQ(PipelineTaskState::BLOCKED, task.state());
+    EXPECT_EQ(0, sink->_num_rows);
+
+    source->_readable = true;
+    EXPECT_TRUE(task.can_run());
+    EXPECT_TRUE(task.execute().ok());
+    EXPECT_EQ(PipelineTaskState::FINISHED, task.state());
+    EXPECT_EQ(20, sink->_num_rows);
+}
+
+TEST_F(PipelineTaskTest, sink_end_of_file) {
+    auto sink = new FakeSinkOperator(150);
+    make_pipeline(sink, false, new FakeSourceOperator(10, 100));
+
+    PipelineTask task(&_pipeline, nullptr, &_state);
+    EXPECT_TRUE(task.execute().ok());
+    EXPECT_EQ(PipelineTaskState::FINISHED, task.state());
+    EXPECT_EQ(200, sink->_num_rows);
+    EXPECT_FALSE(sink->_eos);
+}
+
+TEST_F(PipelineTaskTest, dependency) {
+    Pipeline dependency(1);
+    _pipeline.add_dependency(&dependency);
+    make_pipeline(new FakeSinkOperator(), false, new FakeSourceOperator(1, 1));
+
+    PipelineTask task(&_pipeline, nullptr, &_state);
+    EXPECT_FALSE(task.can_run());
+    dependency.set_finished();
+    EXPECT_TRUE(task.can_run());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,280 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vaggregation_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <map>
+
+#include "common/config.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select k, sum(v) from t group by k
+class VAggregationNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _input_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}});
+        _intermediate_tuple = add_tuple({{TYPE_INT, true}, {TYPE_BIGINT, true}});
+        _output_tuple = add_tuple({{TYPE_INT, true}, {TYPE_BIGINT, true}});
+        init_runtime_state();
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::vec_spill_min_mem_bytes = _min_mem_bytes;
+        config::vec_spill_max_repartition_depth = _max_repartition_depth;
+    }
+
+    // `num_keys` keys and a null key over `rows` rows
+    std::vector<Block> input_blocks(int rows, int num_keys) {
+        std::vector<std::optional<int32_t>> keys;
+        std::vector<std::optional<int32_t>> values;
+        for (int i = 0; i < rows; ++i) {
+            keys.push_back(i % (num_keys + 1) == num_keys ? std::nullopt
+                                                          : std::optional<int32_t>(i % num_keys));
+            values.push_back(i % 7 == 0 ? std::nullopt : std::optional<int32_t>(i));
+        }
+        Block block({int_column(keys, true), int_column(values, true)});
+        return split_blocks(block, _state->batch_size());
+    }
+
+    // the streaming preaggregation returns the serialized sums of the intermediate tuple
+    AggregationNode* create_agg_node(VMockNode* child, bool streaming_preagg = false) {
+        TTupleId output_tuple = streaming_preagg ? _intermediate_tuple : _output_tuple;
+        TPlanNode tnode = plan_node(TPlanNodeType::AGGREGATION_NODE, {output_tuple});
+        tnode.num_children = 1;
+        tnode.__isset.agg_node = true;
+        tnode.agg_node.__set_grouping_exprs({slot_ref(_input_tuple, 0)});
+        tnode.agg_node.aggregate_functions = {
+                agg_function("sum", {slot_ref(_input_tuple, 1)}, TYPE_BIGINT, TYPE_BIGINT)};
+        tnode.agg_node.intermediate_tuple_id = _intermediate_tuple;
+        tnode.agg_node.output_tuple_id = output_tuple;
+        tnode.agg_node.need_finalize = !streaming_preagg;
+        if (streaming_preagg) {
+            tnode.agg_node.__set_use_streaming_preaggregation(true);
+        }
+        return create_node<AggregationNode>(tnode, {child});
+    }
+
+    // the number of the rows of each key returned by the streaming preaggregation, and the
+    // number of the rows passed through
+    std::map<std::string, int> preaggregate(const std::vector<std::optional<int32_t>>& keys,
+                                            int64_t* passthrough_rows) {
+        std::vector<std::optional<int32_t>> values(keys.size(), 1);
+        Block block({int_column(keys, true), int_column(values, true)});
+        auto node = create_agg_node(mock_node(_input_tuple, split_blocks(block, 4096)), true);
+        std::vector<std::string> rows;
+        EXPECT_TRUE(execute(node, &rows).ok());
+        std::map<std::string, int> key_rows;
+        for (const auto& row : rows) {
+            ++key_rows[row.substr(0, row.find('|'))];
+        }
+        *passthrough_rows = node->_passthrough_rows_counter->value();
+        return key_rows;
+    }
+
+    Status aggregate(std::vector<Block> blocks, std::vector<std::string>* rows,
+                     bool spill_input_only = false) {
+        auto child = mock_node(_input_tuple, std::move(blocks));
+        if (spill_input_only) {
+            child->_eos_callback = [this]() { _state->set_spill_requested(false); };
+        }
+        auto node = create_agg_node(child);
+        Status status = execute(node, rows);
+        std::sort(rows->begin(), rows->end());
+        if (_state->is_spill_requested() || spill_input_only) {
+            EXPECT_GT(node->_spill_rows_counter->value(), 0);
+        }
+        return status;
+    }
+
+    TTupleId _input_tuple;
+    TTupleId _intermediate_tuple;
+    TTupleId _output_tuple;
+    int64_t _min_mem_bytes = config::vec_spill_min_mem_bytes;
+    int32_t _max_repartition_depth = config::vec_spill_max_repartition_depth;
+};
+
+TEST_F(VAggregationNodeTest, spill) {
+    std::vector<std::string> expected;
+    EXPECT_TRUE(aggregate(input_blocks(50000, 2000), &expected).ok());
+    EXPECT_EQ(2001, expected.size());
+
+    // spill each input block, the partitions are merged back in memory
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    EXPECT_TRUE(aggregate(input_blocks(50000, 2000), &rows, true).ok());
+    EXPECT_EQ(expected, rows);
+}
+
+TEST_F(VAggregationNodeTest, spill_partition_again) {
+    std::vector<std::string> expected;
+    EXPECT_TRUE(aggregate(input_blocks(400000, 200000), &expected).ok());
+    EXPECT_EQ(200001, expected.size());
+
+    // a partition holds 1/16 of the keys, which is beyond the limit, and is spilled again
+    // into partitions holding 1/256 of the keys
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 128 * 1024;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    EXPECT_TRUE(aggregate(input_blocks(400000, 200000), &rows).ok());
+    EXPECT_EQ(expected, rows);
+}
+
+TEST_F(VAggregationNodeTest, spill_partition_too_many_times) {
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    config::vec_spill_max_repartition_depth = 1;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    Status status = aggregate(input_blocks(10000, 1000), &rows);
+    EXPECT_TRUE(status.is_mem_limit_exceeded()) << status.to_string();
+}
+
+TEST_F(VAggregationNodeTest, streaming_preagg_pass_through) {
+    // the distinct keys aren't reduced by the hash table, which stops expanding out of the
+    // cache and passes the rest of the rows through
+    std::vector<std::optional<int32_t>> keys;
+    for (int i = 0; i < 400000; ++i) {
+        keys.push_back(i);
+    }
+    int64_t passthrough_rows = 0;
+    auto key_rows = preaggregate(keys, &passthrough_rows);
+    EXPECT_GT(passthrough_rows, 0);
+    EXPECT_LT(passthrough_rows, static_cast<int64_t>(keys.size()));
+    EXPECT_EQ(keys.size(), key_rows.size());
+    for (const auto& [key, num_rows] : key_rows) {
+        EXPECT_EQ(1, num_rows) << key;
+    }
+}
+
+TEST_F(VAggregationNodeTest, streaming_preagg_expand) {
+    // the keys of 4 rows each are reduced enough to expand the hash table into the memory
+    std::vector<std::optional<int32_t>> keys;
+    for (int i = 0; i < 800000; ++i) {
+        keys.push_back(i % 100 == 0 ? std::nullopt : std::optional<int32_t>(i / 4));
+    }
+    int64_t passthrough_rows = 0;
+    auto key_rows = preaggregate(keys, &passthrough_rows);
+    EXPECT_EQ(0, passthrough_rows);
+    EXPECT_EQ(200001, key_rows.size());
+    for (const auto& [key, num_rows] : key_rows) {
+        EXPECT_EQ(1, num_rows) << key;
+    }
+
+    // and so are the few keys staying in the cache
+    keys.clear();
+    for (int i = 0; i < 400000; ++i) {
+        keys.push_back(i % 1000);
+    }
+    key_rows = preaggregate(keys, &passthrough_rows);
+    EXPECT_EQ(0, passthrough_rows);
+    EXPECT_EQ(1000, key_rows.size());
+}
+
+// select k1, k2, sum(v) from t group by k1, k2, of which the input is ordered by k2, k1
+class VSortedAggregationNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _input_tuple = add_tuple({{TYPE_INT, true}, {TYPE_VARCHAR, true}, {TYPE_INT, true}});
+        _intermediate_tuple =
+                add_tuple({{TYPE_INT, true}, {TYPE_VARCHAR, true}, {TYPE_BIGINT, true}});
+        _output_tuple = add_tuple({{TYPE_INT, true}, {TYPE_VARCHAR, true}, {TYPE_BIGINT, true}});
+        // the groups are returned over several batches
+        init_runtime_state(16);
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::enable_sorted_aggregation = _enable_sorted_aggregation;
+    }
+
+    // the rows ordered by k2, k1 with the nulls first, in the blocks of 7 rows, so most groups
+    // span several blocks
+    std::vector<Block> input_blocks() {
+        std::vector<std::optional<int32_t>> k1;
+        std::vector<std::optional<std::string>> k2;
+        std::vector<std::optional<int32_t>> v;
+        std::vector<std::optional<std::string>> k2_values = {std::nullopt, "a", "b", "c"};
+        for (size_t i = 0; i < k2_values.size(); ++i) {
+            for (int key = -1; key < 10; ++key) {
+                int group_rows = (key + 1) * 7 % 13 + static_cast<int>(i);
+                for (int row = 0; row < group_rows; ++row) {
+                    k1.push_back(key < 0 ? std::nullopt : std::optional<int32_t>(key));
+                    k2.push_back(k2_values[i]);
+                    v.push_back(row % 5 == 0 ? std::nullopt
+                                             : std::optional<int32_t>(row * 3 + key));
+                }
+            }
+        }
+        Block block({int_column(k1, true), string_column(k2, true), int_column(v, true)});
+        return split_blocks(block, 7);
+    }
+
+    // the hash aggregation if the input is declared in no order
+    Status aggregate(bool ordered, bool needs_finalize, std::vector<std::string>* rows) {
+        auto child = mock_node(_input_tuple, input_blocks());
+        if (ordered) {
+            child->_ordered_by_slots = {slot(_input_tuple, 1).id, slot(_input_tuple, 0).id};
+        }
+        // the states are serialized for the merging aggregation if not finalized
+        TTupleId output_tuple = needs_finalize ? _output_tuple : _intermediate_tuple;
+        TPlanNode tnode = plan_node(TPlanNodeType::AGGREGATION_NODE, {output_tuple});
+        tnode.num_children = 1;
+        tnode.__isset.agg_node = true;
+        tnode.agg_node.__set_grouping_exprs({slot_ref(_input_tuple, 0), slot_ref(_input_tuple, 1)});
+        tnode.agg_node.aggregate_functions = {
+                agg_function("sum", {slot_ref(_input_tuple, 2)}, TYPE_BIGINT, TYPE_BIGINT)};
+        tnode.agg_node.intermediate_tuple_id = _intermediate_tuple;
+        tnode.agg_node.output_tuple_id = output_tuple;
+        tnode.agg_node.need_finalize = needs_finalize;
+        auto node = create_node<AggregationNode>(tnode, {child});
+
+        Status status = execute(node, rows);
+        EXPECT_EQ(ordered, node->_is_sorted_agg);
+        std::sort(rows->begin(), rows->end());
+        return status;
+    }
+
+    TTupleId _input_tuple;
+    TTupleId _intermediate_tuple;
+    TTupleId _output_tuple;
+    bool _enable_sorted_aggregation = config::enable_sorted_aggregation;
+};
+
+TEST_F(VSortedAggregationNodeTest, sorted_input) {
+    config::enable_sorted_aggregation = true;
+    for (bool needs_finalize : {true, false}) {
+        std::vector<std::string> expected;
+        EXPECT_TRUE(aggregate(false, needs_finalize, &expected).ok());
+        // all the (k1, k2) but (NULL, NULL)
+        EXPECT_EQ(43, expected.size());
+
+        std::vector<std::string> rows;
+        EXPECT_TRUE(aggregate(true, needs_finalize, &rows).ok());
+        EXPECT_EQ(expected, rows) << "needs finalize " << needs_finalize;
+    }
+}
+
+} // namespace doris::vectorized
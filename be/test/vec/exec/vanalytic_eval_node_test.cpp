@@ -0,0 +1,142 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vanalytic_eval_node.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select p, v, s, sum(v) over w, group_concat(s) over w from t
+// window w as (partition by p rows between ... and ...)
+class VAnalyticEvalNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _input_tuple = add_tuple({{TYPE_INT, false}, {TYPE_INT, true}, {TYPE_VARCHAR, true}});
+        _buffered_tuple = add_tuple({{TYPE_INT, false}, {TYPE_INT, true}, {TYPE_VARCHAR, true}});
+        _intermediate_tuple = add_tuple({{TYPE_BIGINT, true}, {TYPE_VARCHAR, true}});
+        _output_tuple = add_tuple({{TYPE_BIGINT, true}, {TYPE_VARCHAR, true}});
+        init_runtime_state();
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::vec_analytic_segment_tree_min_frame_rows = _min_frame_rows;
+    }
+
+    // the partitions of the sizes, most of which are not a multiple of the leaf rows, in the
+    // blocks of 100 rows
+    std::vector<Block> input_blocks() {
+        std::vector<std::optional<int32_t>> p;
+        std::vector<std::optional<int32_t>> v;
+        std::vector<std::optional<std::string>> s;
+        int row = 0;
+        for (int size : {1, 16, 17, 50, 333, 64, 1000, 7}) {
+            for (int i = 0; i < size; ++i, ++row) {
+                p.push_back(size);
+                v.push_back(row % 9 == 0 ? std::nullopt : std::optional<int32_t>(row));
+                s.push_back(row % 11 == 0 ? std::nullopt
+                                          : std::optional<std::string>("s" + std::to_string(row)));
+            }
+        }
+        Block block({int_column(p, false), int_column(v, true), string_column(s, true)});
+        return split_blocks(block, 100);
+    }
+
+    static TAnalyticWindowBoundary boundary(TAnalyticWindowBoundaryType::type type,
+                                            int64_t offset = 0) {
+        TAnalyticWindowBoundary b;
+        b.type = type;
+        if (type != TAnalyticWindowBoundaryType::CURRENT_ROW) {
+            b.__set_rows_offset_value(offset);
+        }
+        return b;
+    }
+
+    // the window starts at the partition start if `start` is not set
+    VAnalyticEvalNode* create_analytic_node(std::optional<TAnalyticWindowBoundary> start,
+                                            TAnalyticWindowBoundary end) {
+        TPlanNode tnode =
+                plan_node(TPlanNodeType::ANALYTIC_EVAL_NODE, {_input_tuple, _output_tuple});
+        tnode.num_children = 1;
+        tnode.__isset.analytic_node = true;
+        auto& analytic_node = tnode.analytic_node;
+        analytic_node.partition_exprs = {slot_ref(_input_tuple, 0)};
+        analytic_node.analytic_functions = {
+                agg_function("sum", {slot_ref(_input_tuple, 1)}, TYPE_BIGINT, TYPE_BIGINT),
+                agg_function("group_concat", {slot_ref(_input_tuple, 2)}, TYPE_VARCHAR,
+                             TYPE_VARCHAR)};
+        TAnalyticWindow window;
+        window.type = TAnalyticWindowType::ROWS;
+        if (start) {
+            window.__set_window_start(*start);
+        }
+        window.__set_window_end(end);
+        analytic_node.__set_window(window);
+        analytic_node.intermediate_tuple_id = _intermediate_tuple;
+        analytic_node.output_tuple_id = _output_tuple;
+        analytic_node.__set_buffered_tuple_id(_buffered_tuple);
+        return create_node<VAnalyticEvalNode>(tnode, {mock_node(_input_tuple, input_blocks())});
+    }
+
+    // the rows of the window by the segment tree, or by adding all the rows of each frame
+    std::vector<std::string> analytic(std::optional<TAnalyticWindowBoundary> start,
+                                      TAnalyticWindowBoundary end, bool segment_tree) {
+        config::vec_analytic_segment_tree_min_frame_rows = segment_tree ? 0 : -1;
+        auto node = create_analytic_node(start, end);
+        std::vector<std::string> rows;
+        EXPECT_TRUE(execute(node, &rows).ok());
+        EXPECT_EQ(segment_tree, node->_has_segment_tree);
+        EXPECT_EQ(1488, rows.size());
+        return rows;
+    }
+
+    TTupleId _input_tuple;
+    TTupleId _buffered_tuple;
+    TTupleId _intermediate_tuple;
+    TTupleId _output_tuple;
+    int32_t _min_frame_rows = config::vec_analytic_segment_tree_min_frame_rows;
+};
+
+TEST_F(VAnalyticEvalNodeTest, segment_tree) {
+    using Type = TAnalyticWindowBoundaryType;
+    std::vector<std::pair<std::optional<TAnalyticWindowBoundary>, TAnalyticWindowBoundary>>
+            windows = {
+                    // in a leaf, or across the boundary of two leaves
+                    {boundary(Type::PRECEDING, 2), boundary(Type::FOLLOWING, 3)},
+                    // across several leaves, the first and the last ones partially
+                    {boundary(Type::PRECEDING, 40), boundary(Type::FOLLOWING, 50)},
+                    // not including the current row, empty at the partition start
+                    {boundary(Type::PRECEDING, 70), boundary(Type::PRECEDING, 1)},
+                    {boundary(Type::FOLLOWING, 5), boundary(Type::FOLLOWING, 40)},
+                    // ending at the partition end, in the partial last leaf
+                    {boundary(Type::PRECEDING, 3), boundary(Type::FOLLOWING, 1000)},
+                    {boundary(Type::CURRENT_ROW), boundary(Type::FOLLOWING, 200)},
+                    {std::nullopt, boundary(Type::FOLLOWING, 20)},
+            };
+    for (const auto& [start, end] : windows) {
+        auto expected = analytic(start, end, false);
+        EXPECT_EQ(expected, analytic(start, end, true))
+                << "start " << (start ? start->rows_offset_value : -1) << " end "
+                << end.rows_offset_value;
+    }
+}
+
+} // namespace doris::vectorized
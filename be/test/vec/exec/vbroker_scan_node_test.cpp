@@ -18,10 +18,12 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
 
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "exprs/binary_predicate.h"
 #include "runtime/primitive_type.h"
@@ -33,8 +35,12 @@
 #include "gen_cpp/Descriptors_types.h"
 #include "gen_cpp/PlanNodes_types.h"
 #include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
 #include "runtime/runtime_state.h"
+#include "runtime/stream_load/load_stream_mgr.h"
+#include "runtime/stream_load/stream_load_pipe.h"
 #include "runtime/user_function_cache.h"
+#include "util/defer_op.h"
 
 namespace doris {
 
@@ -60,6 +66,10 @@ protected:
 
 private:
     void init_desc_table();
+    // the rows "k1|k2|k3|k4" of the csv body of a stream load scanned by the node, whose
+    // pipe gets the body in small messages
+    std::vector<std::string> scan_stream(const TBrokerScanRangeParams& params,
+                                         const std::string& body, const std::string& header_type);
     RuntimeState _runtime_state;
     ObjectPool _obj_pool;
     std::map<std::string, SlotDescriptor*> _slots_map;
@@ -404,6 +414,72 @@ void VBrokerScanNodeTest::init() {
     _tnode.__isset.broker_scan_node = true;
 }
 
+std::vector<std::string> VBrokerScanNodeTest::scan_stream(const TBrokerScanRangeParams& params,
+                                                          const std::string& body,
+                                                          const std::string& header_type) {
+    ExecEnv env;
+    env._load_stream_mgr = new LoadStreamMgr();
+    _runtime_state._exec_env = &env;
+    Defer defer {[&]() {
+        _runtime_state._exec_env = nullptr;
+        delete env._load_stream_mgr;
+        env._load_stream_mgr = nullptr;
+    }};
+
+    UniqueId load_id = UniqueId::gen_uid();
+    auto pipe = std::make_shared<StreamLoadPipe>(body.size() + 1);
+    for (size_t offset = 0; offset < body.size(); offset += 7) {
+        EXPECT_TRUE(pipe->append_and_flush(body.data() + offset,
+                                           std::min<size_t>(7, body.size() - offset))
+                            .ok());
+    }
+    EXPECT_TRUE(pipe->finish().ok());
+    EXPECT_TRUE(env.load_stream_mgr()->put(load_id, pipe).ok());
+
+    VBrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
+    EXPECT_TRUE(scan_node.init(_tnode).ok());
+    EXPECT_TRUE(scan_node.prepare(&_runtime_state).ok());
+    TScanRangeParams scan_range_params;
+    TBrokerScanRange broker_scan_range;
+    broker_scan_range.params = params;
+    TBrokerRangeDesc range;
+    range.start_offset = 0;
+    range.size = -1;
+    range.file_type = TFileType::FILE_STREAM;
+    range.format_type = TFileFormatType::FORMAT_CSV_PLAIN;
+    range.__set_load_id(load_id.to_thrift());
+    range.__set_columns_from_path({"7"});
+    range.__set_num_of_columns_from_file(3);
+    if (!header_type.empty()) {
+        range.__set_header_type(header_type);
+    }
+    broker_scan_range.ranges.push_back(range);
+    scan_range_params.scan_range.__set_broker_scan_range(broker_scan_range);
+    scan_node.set_scan_ranges({scan_range_params});
+    EXPECT_TRUE(scan_node.open(&_runtime_state).ok());
+
+    std::vector<std::string> rows;
+    bool eos = false;
+    while (!eos) {
+        Block block;
+        Status status = scan_node.get_next(&_runtime_state, &block, &eos);
+        EXPECT_TRUE(status.ok()) << status.to_string();
+        if (!status.ok()) {
+            break;
+        }
+        auto columns = block.get_columns();
+        for (size_t i = 0; i < block.rows(); ++i) {
+            std::string row;
+            for (size_t j = 0; j < columns.size(); ++j) {
+                row += (j == 0 ? "" : "|") + std::to_string(columns[j]->get_int(i));
+            }
+            rows.push_back(std::move(row));
+        }
+    }
+    EXPECT_TRUE(scan_node.close(&_runtime_state).ok());
+    return rows;
+}
+
 TEST_F(VBrokerScanNodeTest, normal) {
     VBrokerScanNode scan_node(&_obj_pool, _tnode, *_desc_tbl);
     scan_node.init(_tnode);
@@ -638,5 +714,50 @@ TEST_F(VBrokerScanNodeTest, where_binary_pre) {
     }
 }
 
+TEST_F(VBrokerScanNodeTest, parallel_stream_load) {
+    int parallelism = config::stream_load_parse_parallelism;
+    int64_t chunk_bytes = config::stream_load_parse_chunk_bytes;
+    Defer defer {[&]() {
+        config::stream_load_parse_parallelism = parallelism;
+        config::stream_load_parse_chunk_bytes = chunk_bytes;
+    }};
+
+    TBrokerScanRangeParams multi_bytes_params = _params;
+    multi_bytes_params.__set_line_delimiter_length(2);
+    multi_bytes_params.__set_line_delimiter_str("\r\n");
+    for (const auto& params : {_params, multi_bytes_params}) {
+        const std::string delimiter =
+                params.__isset.line_delimiter_length ? params.line_delimiter_str : "\n";
+        for (const std::string header_type : {"", "csv_with_names"}) {
+            std::string body = header_type.empty() ? "" : "k1,k2,k3" + delimiter;
+            std::vector<std::string> expected;
+            for (int i = 0; i < 3000; ++i) {
+                // the lines of 6 to 27 bytes, many of them longer than the small chunks
+                int k1 = i;
+                int k2 = i % 10 == 0 ? 1000000000 + i : i * 2;
+                int k3 = i % 25 == 0 ? -1000000000 - i : i % 3;
+                body += std::to_string(k1) + "," + std::to_string(k2) + "," +
+                        std::to_string(k3) + delimiter;
+                expected.push_back(std::to_string(k1) + "|" + std::to_string(k2) + "|" +
+                                   std::to_string(k3) + "|7");
+            }
+            // the last line without the delimiter
+            body += "3000,1,2";
+            expected.push_back("3000|1|2|7");
+
+            config::stream_load_parse_parallelism = 1;
+            auto serial_rows = scan_stream(params, body, header_type);
+            EXPECT_EQ(expected, serial_rows) << header_type;
+            for (int64_t bytes : {8, 16, 100, 4096, 1 << 20}) {
+                config::stream_load_parse_parallelism = 4;
+                config::stream_load_parse_chunk_bytes = bytes;
+                EXPECT_EQ(serial_rows, scan_stream(params, body, header_type))
+                        << "delimiter length " << delimiter.size() << ", header " << header_type
+                        << ", chunk bytes " << bytes;
+            }
+        }
+    }
+}
+
 } // namespace vectorized
 } // namespace doris
@@ -0,0 +1,134 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vcross_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select * from probe, build where <the comparisons of probe.k, probe.v, build.k and build.v>
+class VCrossJoinNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _probe_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, false}});
+        _build_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, false}});
+        // the joined rows of a probe row are returned over several batches
+        init_runtime_state(64);
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::enable_vec_cross_join_range_search = _enable_range_search;
+    }
+
+    // the key of every `null_every` row is null, the blocks are of 64 rows
+    std::vector<Block> input_blocks(int rows, int key_begin, int num_keys, int null_every) {
+        std::vector<std::optional<int32_t>> keys;
+        std::vector<std::optional<int32_t>> values;
+        for (int i = 0; i < rows; ++i) {
+            keys.push_back(i % null_every == 0
+                                   ? std::nullopt
+                                   : std::optional<int32_t>(key_begin + i * 7 % num_keys));
+            values.push_back(key_begin + i * 11 % num_keys);
+        }
+        Block block({int_column(keys, true), int_column(values, false)});
+        return split_blocks(block, 64);
+    }
+
+    TExpr compare(const std::string& op, const TExpr& lhs, const TExpr& rhs) {
+        return function_call(TExprNodeType::BINARY_PRED, op, {lhs, rhs}, TYPE_BOOLEAN, true);
+    }
+
+    TExpr and_pred(const TExpr& lhs, const TExpr& rhs) {
+        TExpr expr =
+                function_call(TExprNodeType::COMPOUND_PRED, "and", {lhs, rhs}, TYPE_BOOLEAN, true);
+        expr.nodes[0].__set_opcode(TExprOpcode::COMPOUND_AND);
+        return expr;
+    }
+
+    TExpr probe_key() { return slot_ref(_probe_tuple, 0); }
+    TExpr probe_value() { return slot_ref(_probe_tuple, 1); }
+    TExpr build_key() { return slot_ref(_build_tuple, 0); }
+    TExpr build_value() { return slot_ref(_build_tuple, 1); }
+
+    // the build side of 300 rows is in 5 blocks without range search
+    Status join(const TExpr& conjunct, bool range_search, std::vector<std::string>* rows,
+                size_t* num_range_conjuncts) {
+        config::enable_vec_cross_join_range_search = range_search;
+        auto probe = mock_node(_probe_tuple, input_blocks(100, -3, 60, 9));
+        auto build = mock_node(_build_tuple, input_blocks(300, 0, 50, 7));
+        TPlanNode tnode = plan_node(TPlanNodeType::CROSS_JOIN_NODE, {_probe_tuple, _build_tuple});
+        tnode.num_children = 2;
+        tnode.__set_vconjunct(conjunct);
+        auto node = create_node<VCrossJoinNode>(tnode, {probe, build});
+
+        Status status = execute(node, rows);
+        std::sort(rows->begin(), rows->end());
+        *num_range_conjuncts = node->_range_conjuncts.size();
+        if (!range_search) {
+            EXPECT_EQ(5, node->_build_blocks.size());
+        }
+        return status;
+    }
+
+    TTupleId _probe_tuple;
+    TTupleId _build_tuple;
+    bool _enable_range_search = config::enable_vec_cross_join_range_search;
+};
+
+TEST_F(VCrossJoinNodeTest, range_search) {
+    // the conjuncts and the number of them found to be range conjuncts
+    std::vector<std::pair<TExpr, size_t>> conjuncts = {
+            {compare("lt", build_key(), probe_key()), 1},
+            {compare("le", build_key(), probe_key()), 1},
+            {compare("gt", build_key(), probe_key()), 1},
+            {compare("ge", build_key(), probe_key()), 1},
+            // the build column on the right side
+            {compare("gt", probe_key(), build_key()), 1},
+            {compare("le", probe_value(), build_key()), 1},
+            // two conjuncts intersecting on the same build column
+            {and_pred(compare("gt", build_key(), probe_key()),
+                      compare("le", build_key(), probe_value())),
+             2},
+            // only the conjuncts on the first build column bound the range
+            {and_pred(compare("ge", build_key(), probe_key()),
+                      compare("lt", build_value(), probe_value())),
+             1},
+            // not a range conjunct, the build side is joined as a whole
+            {compare("lt", build_key(), build_value()), 0},
+    };
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+        std::vector<std::string> expected;
+        size_t num_range_conjuncts = 0;
+        EXPECT_TRUE(join(conjuncts[i].first, false, &expected, &num_range_conjuncts).ok());
+        EXPECT_EQ(0, num_range_conjuncts);
+        EXPECT_FALSE(expected.empty());
+
+        std::vector<std::string> rows;
+        EXPECT_TRUE(join(conjuncts[i].first, true, &rows, &num_range_conjuncts).ok());
+        EXPECT_EQ(conjuncts[i].second, num_range_conjuncts) << "conjunct " << i;
+        EXPECT_EQ(expected, rows) << "conjunct " << i;
+    }
+}
+
+} // namespace doris::vectorized
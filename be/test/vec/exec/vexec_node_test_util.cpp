@@ -0,0 +1,258 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vexec_node_test_util.h"
+
+#include "runtime/exec_env.h"
+#include "runtime/mem_tracker.h"
+#include "util/filesystem_util.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+Status VMockNode::get_next(RuntimeState* state, Block* block, bool* eos) {
+    if (_next_block < _blocks.size()) {
+        block->swap(_blocks[_next_block++]);
+    }
+    *eos = _next_block == _blocks.size();
+    if (*eos && _eos_callback) {
+        _eos_callback();
+        _eos_callback = nullptr;
+    }
+    return Status::OK();
+}
+
+void VExecNodeTest::TearDown() {
+    // the nodes remove their spill files once destroyed
+    _pool.clear();
+    if (_tmp_file_mgr != nullptr) {
+        ExecEnv::GetInstance()->_tmp_file_mgr = _origin_tmp_file_mgr;
+        FileSystemUtil::remove_paths(_tmp_dirs);
+    }
+}
+
+TTupleId VExecNodeTest::add_tuple(const std::vector<std::pair<PrimitiveType, bool>>& slots) {
+    TTupleDescriptorBuilder tuple_builder;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        TSlotDescriptorBuilder slot_builder;
+        if (slots[i].first == TYPE_VARCHAR) {
+            slot_builder.string_type(65535);
+        } else {
+            slot_builder.type(slots[i].first);
+        }
+        tuple_builder.add_slot(slot_builder.nullable(slots[i].second)
+                                       .column_name("c" + std::to_string(i))
+                                       .column_pos(i)
+                                       .build());
+    }
+    tuple_builder.build(&_desc_tbl_builder);
+
+    TTupleId tuple_id = _tuple_slots.size();
+    auto desc_tbl = _desc_tbl_builder.desc_tbl();
+    _tuple_slots.emplace_back();
+    for (const auto& slot_desc : desc_tbl.slotDescriptors) {
+        if (slot_desc.parent == tuple_id) {
+            _tuple_slots.back().push_back(slot_desc);
+        }
+    }
+    return tuple_id;
+}
+
+void VExecNodeTest::init_runtime_state(int batch_size) {
+    EXPECT_TRUE(DescriptorTbl::create(&_pool, _desc_tbl_builder.desc_tbl(), &_desc_tbl).ok());
+
+    TQueryOptions query_options;
+    query_options.__set_batch_size(batch_size);
+    query_options.__set_enable_vectorized_engine(true);
+    _state = std::make_unique<RuntimeState>(TUniqueId(), query_options, TQueryGlobals(),
+                                            ExecEnv::GetInstance());
+    _state->_instance_mem_tracker.reset(new MemTracker());
+    _state->set_desc_tbl(_desc_tbl);
+}
+
+void VExecNodeTest::enable_spill() {
+    _tmp_dirs = {"/tmp/vexec_node_test_spill"};
+    FileSystemUtil::remove_paths(_tmp_dirs);
+    EXPECT_TRUE(FileSystemUtil::create_directory(_tmp_dirs[0]).ok());
+    _tmp_file_mgr = std::make_unique<TmpFileMgr>();
+    EXPECT_TRUE(_tmp_file_mgr->init_custom(_tmp_dirs, true).ok());
+    _origin_tmp_file_mgr = ExecEnv::GetInstance()->_tmp_file_mgr;
+    ExecEnv::GetInstance()->_tmp_file_mgr = _tmp_file_mgr.get();
+    _state->_query_options.__set_enable_spilling(true);
+}
+
+TExpr VExecNodeTest::slot_ref(TTupleId tuple_id, int index) {
+    const auto& slot_desc = slot(tuple_id, index);
+    TExprNode node;
+    node.node_type = TExprNodeType::SLOT_REF;
+    node.type = slot_desc.slotType;
+    node.num_children = 0;
+    node.__isset.slot_ref = true;
+    node.slot_ref.slot_id = slot_desc.id;
+    node.slot_ref.tuple_id = slot_desc.parent;
+    node.__set_is_nullable(slot_desc.nullIndicatorBit != -1);
+
+    TExpr expr;
+    expr.nodes.push_back(node);
+    return expr;
+}
+
+static TExprNode function_node(TExprNodeType::type node_type, const std::string& name,
+                               const std::vector<TExpr>& args, PrimitiveType ret_type,
+                               bool nullable) {
+    TSlotDescriptorBuilder type_builder;
+    TTypeDesc ret_type_desc = type_builder.get_common_type(to_thrift(ret_type));
+
+    TFunction fn;
+    fn.name.function_name = name;
+    fn.binary_type = TFunctionBinaryType::BUILTIN;
+    for (const auto& arg : args) {
+        fn.arg_types.push_back(arg.nodes[0].type);
+    }
+    fn.ret_type = ret_type_desc;
+    fn.has_var_args = false;
+
+    TExprNode node;
+    node.node_type = node_type;
+    node.type = ret_type_desc;
+    node.num_children = args.size();
+    node.__set_fn(fn);
+    node.__set_is_nullable(nullable);
+    return node;
+}
+
+static TExpr flatten(const TExprNode& root, const std::vector<TExpr>& args) {
+    TExpr expr;
+    expr.nodes.push_back(root);
+    for (const auto& arg : args) {
+        expr.nodes.insert(expr.nodes.end(), arg.nodes.begin(), arg.nodes.end());
+    }
+    return expr;
+}
+
+TExpr VExecNodeTest::function_call(TExprNodeType::type node_type, const std::string& name,
+                                   const std::vector<TExpr>& args, PrimitiveType ret_type,
+                                   bool nullable) {
+    return flatten(function_node(node_type, name, args, ret_type, nullable), args);
+}
+
+TExpr VExecNodeTest::agg_function(const std::string& name, const std::vector<TExpr>& args,
+                                  PrimitiveType ret_type, PrimitiveType intermediate_type) {
+    TExprNode node = function_node(TExprNodeType::AGG_EXPR, name, args, ret_type, true);
+    TSlotDescriptorBuilder type_builder;
+    node.fn.__isset.aggregate_fn = true;
+    node.fn.aggregate_fn.intermediate_type =
+            type_builder.get_common_type(to_thrift(intermediate_type));
+    node.__isset.agg_expr = true;
+    node.agg_expr.is_merge_agg = false;
+    return flatten(node, args);
+}
+
+TPlanNode VExecNodeTest::plan_node(TPlanNodeType::type type,
+                                   const std::vector<TTupleId>& row_tuples) {
+    TPlanNode tnode;
+    tnode.node_id = _next_node_id++;
+    tnode.node_type = type;
+    tnode.num_children = 0;
+    tnode.limit = -1;
+    tnode.row_tuples = row_tuples;
+    tnode.nullable_tuples = std::vector<bool>(row_tuples.size(), false);
+    tnode.compact_data = false;
+    return tnode;
+}
+
+VMockNode* VExecNodeTest::mock_node(TTupleId tuple_id, std::vector<Block> blocks) {
+    TPlanNode tnode = plan_node(TPlanNodeType::EXCHANGE_NODE, {tuple_id});
+    auto node = _pool.add(new VMockNode(&_pool, tnode, *_desc_tbl, std::move(blocks)));
+    EXPECT_TRUE(node->init(tnode, _state.get()).ok());
+    return node;
+}
+
+Status VExecNodeTest::execute(ExecNode* node, std::vector<std::string>* rows) {
+    RETURN_IF_ERROR(node->prepare(_state.get()));
+    Status status = node->open(_state.get());
+    bool eos = false;
+    while (status.ok() && !eos) {
+        Block block;
+        status = node->get_next(_state.get(), &block, &eos);
+        for (size_t i = 0; status.ok() && i < block.rows(); ++i) {
+            std::string row;
+            for (size_t j = 0; j < block.columns(); ++j) {
+                const auto& column = block.get_by_position(j);
+                row += (j == 0 ? "" : "|") + column.type->to_string(*column.column, i);
+            }
+            rows->push_back(std::move(row));
+        }
+    }
+    node->close(_state.get());
+    return status;
+}
+
+std::vector<Block> VExecNodeTest::split_blocks(const Block& block, size_t block_rows) {
+    std::vector<Block> blocks;
+    for (size_t start = 0; start < block.rows(); start += block_rows) {
+        size_t length = std::min(block_rows, block.rows() - start);
+        Columns columns;
+        for (size_t i = 0; i < block.columns(); ++i) {
+            columns.push_back(block.get_by_position(i).column->cut(start, length));
+        }
+        blocks.push_back(block.clone_with_columns(columns));
+    }
+    return blocks;
+}
+
+ColumnWithTypeAndName VExecNodeTest::int_column(
+        const std::vector<std::optional<int32_t>>& values, bool nullable) {
+    auto column = ColumnInt32::create();
+    auto null_map = ColumnUInt8::create();
+    for (const auto& value : values) {
+        DCHECK(nullable || value.has_value());
+        column->insert_value(value.value_or(0));
+        null_map->insert_value(!value.has_value());
+    }
+    DataTypePtr type = std::make_shared<DataTypeInt32>();
+    if (!nullable) {
+        return {std::move(column), type, ""};
+    }
+    return {ColumnNullable::create(std::move(column), std::move(null_map)), make_nullable(type),
+            ""};
+}
+
+ColumnWithTypeAndName VExecNodeTest::string_column(
+        const std::vector<std::optional<std::string>>& values, bool nullable) {
+    auto column = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    for (const auto& value : values) {
+        DCHECK(nullable || value.has_value());
+        std::string str = value.value_or("");
+        column->insert_data(str.data(), str.size());
+        null_map->insert_value(!value.has_value());
+    }
+    DataTypePtr type = std::make_shared<DataTypeString>();
+    if (!nullable) {
+        return {std::move(column), type, ""};
+    }
+    return {ColumnNullable::create(std::move(column), std::move(null_map)), make_nullable(type),
+            ""};
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,130 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exec/exec_node.h"
+#include "gen_cpp/Exprs_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptor_helper.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "runtime/tmp_file_mgr.h"
+#include "vec/core/block.h"
+
+namespace doris::vectorized {
+
+// A child node returning the blocks given by the test.
+class VMockNode : public ExecNode {
+public:
+    VMockNode(ObjectPool* pool, const TPlanNode& tnode, const DescriptorTbl& descs,
+              std::vector<Block> blocks)
+            : ExecNode(pool, tnode, descs), _blocks(std::move(blocks)) {}
+
+    Status get_next(RuntimeState* state, RowBatch* row_batch, bool* eos) override {
+        return Status::NotSupported("Not Implemented VMockNode::get_next scalar");
+    }
+    Status get_next(RuntimeState* state, Block* block, bool* eos) override;
+
+    std::vector<SlotId> ordered_by_slots() const override { return _ordered_by_slots; }
+    std::vector<bool> ordered_by_asc_order() const override { return _ordered_by_asc_order; }
+    std::vector<bool> ordered_by_nulls_first() const override { return _ordered_by_nulls_first; }
+
+    // the slots the blocks are declared to be ordered by, and in which directions
+    std::vector<SlotId> _ordered_by_slots;
+    std::vector<bool> _ordered_by_asc_order;
+    std::vector<bool> _ordered_by_nulls_first;
+    // called once the last block is returned
+    std::function<void()> _eos_callback;
+
+private:
+    std::vector<Block> _blocks;
+    size_t _next_block = 0;
+};
+
+// Builds the descriptor table and the runtime state for the tests of the vectorized exec
+// nodes, which run the nodes over VMockNode children and compare the rows they return.
+class VExecNodeTest : public testing::Test {
+protected:
+    void TearDown() override;
+
+    // Declare a tuple of the (type, nullable) slots and return its id.
+    TTupleId add_tuple(const std::vector<std::pair<PrimitiveType, bool>>& slots);
+
+    // Build the descriptor table and the runtime state once all the tuples are declared.
+    void init_runtime_state(int batch_size = 1024);
+    // Let the nodes spill into a tmp dir.
+    void enable_spill();
+
+    const TSlotDescriptor& slot(TTupleId tuple_id, int index) {
+        return _tuple_slots[tuple_id][index];
+    }
+    TExpr slot_ref(TTupleId tuple_id, int index);
+    // A builtin function of the args, e.g. "lt" for a BINARY_PRED.
+    static TExpr function_call(TExprNodeType::type node_type, const std::string& name,
+                               const std::vector<TExpr>& args, PrimitiveType ret_type,
+                               bool nullable);
+    static TExpr agg_function(const std::string& name, const std::vector<TExpr>& args,
+                              PrimitiveType ret_type, PrimitiveType intermediate_type);
+
+    TPlanNode plan_node(TPlanNodeType::type type, const std::vector<TTupleId>& row_tuples);
+    VMockNode* mock_node(TTupleId tuple_id, std::vector<Block> blocks);
+
+    // Create and init the node of the plan over the children.
+    template <typename Node>
+    Node* create_node(const TPlanNode& tnode, const std::vector<ExecNode*>& children) {
+        Node* node = _pool.add(new Node(&_pool, tnode, *_desc_tbl));
+        for (auto child : children) {
+            node->_children.push_back(child);
+        }
+        EXPECT_TRUE(node->init(tnode, _state.get()).ok());
+        return node;
+    }
+
+    // Run the node to the end and append its rows as strings of the column values.
+    Status execute(ExecNode* node, std::vector<std::string>* rows);
+
+    // Split the columns into blocks of `block_rows` rows of the tuple.
+    static std::vector<Block> split_blocks(const Block& block, size_t block_rows);
+
+    static ColumnWithTypeAndName int_column(const std::vector<std::optional<int32_t>>& values,
+                                            bool nullable);
+    static ColumnWithTypeAndName string_column(
+            const std::vector<std::optional<std::string>>& values, bool nullable);
+
+    ObjectPool _pool;
+    TDescriptorTableBuilder _desc_tbl_builder;
+    std::vector<std::vector<TSlotDescriptor>> _tuple_slots;
+    DescriptorTbl* _desc_tbl = nullptr;
+    std::unique_ptr<RuntimeState> _state;
+    TPlanNodeId _next_node_id = 0;
+
+    std::vector<std::string> _tmp_dirs;
+    std::unique_ptr<TmpFileMgr> _tmp_file_mgr;
+    TmpFileMgr* _origin_tmp_file_mgr = nullptr;
+};
+
+} // namespace doris::vectorized
@@ -0,0 +1,207 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/vhash_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "common/config.h"
+#include "exprs/runtime_filter.h"
+#include "gen_cpp/internal_service.pb.h"
+#include "runtime/runtime_filter_mgr.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select * from probe join build on probe.k = build.k
+class HashJoinNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _probe_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}});
+        _build_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}});
+        init_runtime_state(4096);
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::vec_spill_min_mem_bytes = _min_mem_bytes;
+        config::vec_spill_max_repartition_depth = _max_repartition_depth;
+    }
+
+    // the key of every `null_every` row is null
+    std::vector<Block> input_blocks(int rows, int key_step, int num_keys, int null_every) {
+        std::vector<std::optional<int32_t>> keys;
+        std::vector<std::optional<int32_t>> values;
+        for (int i = 0; i < rows; ++i) {
+            keys.push_back(i % null_every == 0 ? std::nullopt
+                                               : std::optional<int32_t>(i * key_step % num_keys));
+            values.push_back(i);
+        }
+        Block block({int_column(keys, true), int_column(values, true)});
+        return split_blocks(block, _state->batch_size());
+    }
+
+    Status join(TJoinOp::type join_op, int probe_rows, int build_rows,
+                std::vector<std::string>* rows, bool spill_build_input_only = false,
+                bool cancel_after_build_input = false) {
+        auto probe = mock_node(_probe_tuple, input_blocks(probe_rows, 3, build_rows, 101));
+        auto build = mock_node(_build_tuple, input_blocks(build_rows, 1, build_rows / 2, 97));
+        if (spill_build_input_only) {
+            build->_eos_callback = [this]() { _state->set_spill_requested(false); };
+        }
+        if (cancel_after_build_input) {
+            build->_eos_callback = [this]() { _state->set_is_cancelled(true); };
+        }
+
+        // a left anti join only outputs the probe rows
+        std::vector<TTupleId> row_tuples = {_probe_tuple};
+        if (join_op != TJoinOp::LEFT_ANTI_JOIN) {
+            row_tuples.push_back(_build_tuple);
+        }
+        TPlanNode tnode = plan_node(TPlanNodeType::HASH_JOIN_NODE, row_tuples);
+        tnode.num_children = 2;
+        tnode.__isset.hash_join_node = true;
+        tnode.hash_join_node.join_op = join_op;
+        TEqJoinCondition eq_cond;
+        eq_cond.left = slot_ref(_probe_tuple, 0);
+        eq_cond.right = slot_ref(_build_tuple, 0);
+        tnode.hash_join_node.eq_join_conjuncts = {eq_cond};
+        if (!_runtime_filters.empty()) {
+            tnode.__set_runtime_filters(_runtime_filters);
+        }
+        auto node = create_node<HashJoinNode>(tnode, {probe, build});
+
+        Status status = execute(node, rows);
+        std::sort(rows->begin(), rows->end());
+        if (_state->is_spill_requested() || spill_build_input_only) {
+            EXPECT_GT(node->_spill_build_rows_counter->value(), 0);
+            EXPECT_GT(node->_spill_probe_rows_counter->value(), 0);
+        }
+        return status;
+    }
+
+    // a min max filter of the build keys on the probe keys, which is consumed by the node
+    // `target_node_id` in the same fragment
+    void add_min_max_filter(int target_node_id) {
+        TRuntimeFilterDesc desc;
+        desc.filter_id = 1;
+        desc.src_expr = slot_ref(_build_tuple, 0);
+        desc.expr_order = 0;
+        desc.planId_to_target_expr[target_node_id] = slot_ref(_probe_tuple, 0);
+        desc.is_broadcast_join = false;
+        desc.has_local_targets = true;
+        desc.has_remote_targets = false;
+        desc.type = TRuntimeFilterType::MIN_MAX;
+        _runtime_filters = {desc};
+        EXPECT_TRUE(_state->runtime_filter_mgr()->init().ok());
+        EXPECT_TRUE(_state->runtime_filter_mgr()
+                            ->regist_filter(RuntimeFilterRole::CONSUMER, desc,
+                                            _state->query_options(), target_node_id)
+                            .ok());
+    }
+
+    // the min and the max of the filter published to the consumer
+    std::pair<int64_t, int64_t> consumed_min_max() {
+        IRuntimeFilter* filter = nullptr;
+        EXPECT_TRUE(_state->runtime_filter_mgr()->get_consume_filter(1, &filter).ok());
+        EXPECT_TRUE(filter->is_ready());
+        PPublishFilterRequest request;
+        EXPECT_TRUE(filter->serialize(&request).ok());
+        return {request.minmax_filter().min_val().intval(),
+                request.minmax_filter().max_val().intval()};
+    }
+
+    TTupleId _probe_tuple;
+    TTupleId _build_tuple;
+    int64_t _min_mem_bytes = config::vec_spill_min_mem_bytes;
+    int32_t _max_repartition_depth = config::vec_spill_max_repartition_depth;
+    std::vector<TRuntimeFilterDesc> _runtime_filters;
+};
+
+TEST_F(HashJoinNodeTest, cancelled_build) {
+    // the query is cancelled once the build rows are all read, the hash table build over them
+    // stops at once
+    std::vector<std::string> rows;
+    Status status = join(TJoinOp::INNER_JOIN, 20000, 100000, &rows, false, true);
+    EXPECT_TRUE(status.is_cancelled()) << status.to_string();
+    EXPECT_TRUE(rows.empty());
+}
+
+TEST_F(HashJoinNodeTest, spill) {
+    // nothing is spilled unless it is requested
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::LEFT_OUTER_JOIN, TJoinOp::LEFT_ANTI_JOIN}) {
+        std::vector<std::string> expected;
+        EXPECT_TRUE(join(join_op, 20000, 30000, &expected).ok());
+        EXPECT_FALSE(expected.empty());
+
+        // both sides are spilled, the build partitions are loaded in memory
+        _state->set_spill_requested(true);
+        std::vector<std::string> rows;
+        EXPECT_TRUE(join(join_op, 20000, 30000, &rows, true).ok());
+        EXPECT_EQ(expected, rows) << "join op " << join_op;
+    }
+}
+
+TEST_F(HashJoinNodeTest, spill_with_runtime_filter) {
+    // the build keys are in [0, 15000) with nulls
+    add_min_max_filter(100);
+    std::vector<std::string> expected;
+    EXPECT_TRUE(join(TJoinOp::INNER_JOIN, 20000, 30000, &expected).ok());
+    EXPECT_EQ(std::make_pair<int64_t, int64_t>(0, 14999), consumed_min_max());
+
+    // the filter of a spilled join is built from all the spilled build rows, and is published
+    // before the partitions are joined
+    init_runtime_state(4096);
+    add_min_max_filter(100);
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    EXPECT_TRUE(join(TJoinOp::INNER_JOIN, 20000, 30000, &rows, true).ok());
+    EXPECT_EQ(expected, rows);
+    EXPECT_EQ(std::make_pair<int64_t, int64_t>(0, 14999), consumed_min_max());
+}
+
+TEST_F(HashJoinNodeTest, spill_partition_again) {
+    std::vector<std::string> expected;
+    EXPECT_TRUE(join(TJoinOp::LEFT_OUTER_JOIN, 100000, 400000, &expected).ok());
+
+    // the build rows of a partition are beyond the limit, and it is split again into
+    // partitions of 1/256 of the build rows
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 128 * 1024;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    EXPECT_TRUE(join(TJoinOp::LEFT_OUTER_JOIN, 100000, 400000, &rows).ok());
+    EXPECT_EQ(expected, rows);
+}
+
+TEST_F(HashJoinNodeTest, spill_partition_too_many_times) {
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    config::vec_spill_max_repartition_depth = 1;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    Status status = join(TJoinOp::INNER_JOIN, 10000, 10000, &rows);
+    EXPECT_TRUE(status.is_mem_limit_exceeded()) << status.to_string();
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,210 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vjson_scanner.h"
+
+#include <gtest/gtest.h>
+#include <runtime/descriptor_helper.h>
+
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exprs/cast_functions.h"
+#include "exprs/decimalv2_operators.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/exec_env.h"
+#include "runtime/runtime_state.h"
+#include "runtime/user_function_cache.h"
+
+namespace doris::vectorized {
+
+class VJsonScannerTest : public testing::Test {
+public:
+    VJsonScannerTest() : _runtime_state(TQueryGlobals()) {
+        _profile = _runtime_state.runtime_profile();
+        _runtime_state._instance_mem_tracker.reset(new MemTracker());
+        _runtime_state._exec_env = ExecEnv::GetInstance();
+    }
+
+    static void SetUpTestCase() {
+        UserFunctionCache::instance()->init(
+                "./be/test/runtime/test_data/user_function_cache/normal");
+        CastFunctions::init();
+        DecimalV2Operators::init();
+    }
+
+protected:
+    virtual void SetUp() { init(); }
+
+    virtual void TearDown() {}
+
+    // src slots: category, author, price. dest slots: the values of author and price.
+    void init();
+    // Read all the rows of the range into the dest columns.
+    void read(const TBrokerRangeDesc& range, std::vector<MutableColumnPtr>* columns);
+
+    RuntimeState _runtime_state;
+    RuntimeProfile* _profile;
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl;
+    TBrokerScanRangeParams _params;
+    std::vector<TNetworkAddress> _addresses;
+    ScannerCounter _counter;
+    std::vector<TExpr> _pre_filter;
+};
+
+void VJsonScannerTest::init() {
+    TTypeDesc varchar_type;
+    {
+        TTypeNode node;
+        node.__set_type(TTypeNodeType::SCALAR);
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::VARCHAR);
+        scalar_type.__set_len(65535);
+        node.__set_scalar_type(scalar_type);
+        varchar_type.types.push_back(node);
+    }
+
+    for (int src_slot_id = 0; src_slot_id < 3; ++src_slot_id) {
+        _params.src_slot_ids.push_back(src_slot_id);
+    }
+    for (int src_slot_id = 1; src_slot_id < 3; ++src_slot_id) {
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = varchar_type;
+        slot_ref.num_children = 0;
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = src_slot_id;
+        slot_ref.slot_ref.tuple_id = 0;
+
+        TExpr expr;
+        expr.nodes.push_back(slot_ref);
+        _params.expr_of_dest_slot.emplace(src_slot_id + 2, expr);
+    }
+    _params.__set_src_tuple_id(0);
+    _params.__set_dest_tuple_id(1);
+
+    TDescriptorTableBuilder dtb;
+    TTupleDescriptorBuilder src_tuple_builder;
+    int column_pos = 1;
+    for (const char* name : {"category", "author", "price"}) {
+        src_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                           .string_type(65535)
+                                           .nullable(true)
+                                           .column_name(name)
+                                           .column_pos(column_pos++)
+                                           .build());
+    }
+    src_tuple_builder.build(&dtb);
+    TTupleDescriptorBuilder dest_tuple_builder;
+    column_pos = 1;
+    for (const char* name : {"author", "price"}) {
+        dest_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                            .string_type(65535)
+                                            .nullable(true)
+                                            .column_name(name)
+                                            .column_pos(column_pos++)
+                                            .build());
+    }
+    dest_tuple_builder.build(&dtb);
+
+    DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl);
+    _runtime_state.set_desc_tbl(_desc_tbl);
+}
+
+void VJsonScannerTest::read(const TBrokerRangeDesc& range,
+                            std::vector<MutableColumnPtr>* columns) {
+    std::vector<TBrokerRangeDesc> ranges {range};
+    VJsonScanner scanner(&_runtime_state, _profile, _params, ranges, _addresses, _pre_filter,
+                         &_counter);
+    ASSERT_TRUE(scanner.open().ok());
+
+    for (auto slot_desc : _desc_tbl->get_tuple_descriptor(1)->slots()) {
+        columns->emplace_back(slot_desc->get_empty_mutable_column());
+    }
+    bool eof = false;
+    while (!eof) {
+        ASSERT_TRUE(scanner.get_next(*columns, &eof).ok());
+    }
+    scanner.close();
+}
+
+TEST_F(VJsonScannerTest, simple_array_json) {
+    TBrokerRangeDesc range;
+    range.start_offset = 0;
+    range.size = -1;
+    range.format_type = TFileFormatType::FORMAT_JSON;
+    range.__set_strip_outer_array(true);
+    range.splittable = true;
+    range.path = "./be/test/exec/test_data/json_scanner/test_simple2.json";
+    range.file_type = TFileType::FILE_LOCAL;
+
+    std::vector<MutableColumnPtr> columns;
+    read(range, &columns);
+    ASSERT_EQ(2, columns[0]->size());
+    EXPECT_EQ("NigelRees", columns[0]->get_data_at(0).to_string());
+    EXPECT_EQ("EvelynWaugh", columns[0]->get_data_at(1).to_string());
+    // the same as JsonReader, the doubles are formatted by "%f"
+    EXPECT_EQ("8.950000", columns[1]->get_data_at(0).to_string());
+    EXPECT_EQ("12.990000", columns[1]->get_data_at(1).to_string());
+}
+
+TEST_F(VJsonScannerTest, jsonpaths) {
+    TBrokerRangeDesc range;
+    range.start_offset = 0;
+    range.size = -1;
+    range.format_type = TFileFormatType::FORMAT_JSON;
+    range.__set_strip_outer_array(true);
+    range.__set_jsonpaths("[\"$.category\", \"$.title\", \"$.largeint\"]");
+    range.splittable = true;
+    range.path = "./be/test/exec/test_data/json_scanner/test_simple2.json";
+    range.file_type = TFileType::FILE_LOCAL;
+
+    std::vector<MutableColumnPtr> columns;
+    read(range, &columns);
+    ASSERT_EQ(2, columns[0]->size());
+    EXPECT_EQ("SayingsoftheCentury", columns[0]->get_data_at(0).to_string());
+    EXPECT_EQ("SwordofHonour", columns[0]->get_data_at(1).to_string());
+    EXPECT_EQ("1234", columns[1]->get_data_at(0).to_string());
+    // the integer out of the range of uint64 is read as a double
+    EXPECT_EQ("1180591620717411303424.000000", columns[1]->get_data_at(1).to_string());
+}
+
+TEST_F(VJsonScannerTest, json_root_on_array) {
+    TBrokerRangeDesc range;
+    range.start_offset = 0;
+    range.size = -1;
+    range.format_type = TFileFormatType::FORMAT_JSON;
+    range.__set_strip_outer_array(true);
+    range.__set_json_root("$.data");
+    range.splittable = true;
+    range.path = "./be/test/exec/test_data/json_scanner/test_simple2.json";
+    range.file_type = TFileType::FILE_LOCAL;
+
+    std::vector<MutableColumnPtr> columns;
+    read(range, &columns);
+    // the same as JsonReader, the key on the array is matched by rapidjson, which finds a null
+    // for each element without the key, so both rows are filtered
+    EXPECT_EQ(0, columns[0]->size());
+    EXPECT_EQ(2, _counter.num_rows_filtered);
+}
+
+} // namespace doris::vectorized
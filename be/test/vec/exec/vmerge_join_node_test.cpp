@@ -0,0 +1,152 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/join/vmerge_join_node.h"
+
+#include <gtest/gtest.h>
+
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select * from l join r on l.k = r.k, both ordered by k in ascending order with the nulls last
+class VMergeJoinNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _left_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}});
+        _right_tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}});
+        init_runtime_state();
+
+        // the key k repeats k % 4 times on the left and k % 3 times on the right, the right rows
+        // begin after the left ones and end before them
+        for (int k = 0; k < 80; ++k) {
+            _left_keys.insert(_left_keys.end(), k % 4, k);
+        }
+        for (int k = 10; k < 70; ++k) {
+            _right_keys.insert(_right_keys.end(), k % 3, k);
+        }
+        _left_keys.insert(_left_keys.end(), 5, std::nullopt);
+        _right_keys.insert(_right_keys.end(), 6, std::nullopt);
+    }
+
+    // the blocks of 4 rows and an empty block, so the groups of the keys span the blocks, the
+    // value of a row is its position
+    VMockNode* sorted_child(TTupleId tuple, const std::vector<std::optional<int32_t>>& keys) {
+        std::vector<std::optional<int32_t>> values;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            values.push_back(static_cast<int32_t>(i));
+        }
+        auto blocks = split_blocks(Block({int_column(keys, true), int_column(values, true)}), 4);
+        blocks.insert(blocks.begin() + 1, blocks[0].clone_empty());
+        auto child = mock_node(tuple, std::move(blocks));
+        child->_ordered_by_slots = {slot(tuple, 0).id};
+        child->_ordered_by_asc_order = {true};
+        child->_ordered_by_nulls_first = {false};
+        return child;
+    }
+
+    VMergeJoinNode* create_join_node(TJoinOp::type join_op, VMockNode* left, VMockNode* right) {
+        // the semi and anti joins only output the left rows
+        std::vector<TTupleId> row_tuples = {_left_tuple};
+        if (join_op == TJoinOp::INNER_JOIN || join_op == TJoinOp::LEFT_OUTER_JOIN) {
+            row_tuples.push_back(_right_tuple);
+        }
+        TPlanNode tnode = plan_node(TPlanNodeType::MERGE_JOIN_NODE, row_tuples);
+        tnode.num_children = 2;
+        tnode.__isset.merge_join_node = true;
+        tnode.merge_join_node.__set_join_op(join_op);
+        TEqJoinCondition eq_cond;
+        eq_cond.left = slot_ref(_left_tuple, 0);
+        eq_cond.right = slot_ref(_right_tuple, 0);
+        tnode.merge_join_node.cmp_conjuncts = {eq_cond};
+        return create_node<VMergeJoinNode>(tnode, {left, right});
+    }
+
+    // the rows joined by comparing every pair of the rows, in the order of the left rows
+    std::vector<std::string> expected_rows(TJoinOp::type join_op) {
+        auto to_string = [](const std::optional<int32_t>& key) -> std::string {
+            return key ? std::to_string(*key) : "NULL";
+        };
+        std::vector<std::string> rows;
+        for (size_t i = 0; i < _left_keys.size(); ++i) {
+            std::string left_row = to_string(_left_keys[i]) + "|" + std::to_string(i);
+            std::vector<std::string> matched;
+            for (size_t j = 0; j < _right_keys.size(); ++j) {
+                if (_left_keys[i] && _left_keys[i] == _right_keys[j]) {
+                    matched.push_back(left_row + "|" + to_string(_right_keys[j]) + "|" +
+                                      std::to_string(j));
+                }
+            }
+            if (join_op == TJoinOp::INNER_JOIN) {
+                rows.insert(rows.end(), matched.begin(), matched.end());
+            } else if (join_op == TJoinOp::LEFT_OUTER_JOIN) {
+                if (matched.empty()) {
+                    matched.push_back(left_row + "|NULL|NULL");
+                }
+                rows.insert(rows.end(), matched.begin(), matched.end());
+            } else if (matched.empty() == (join_op == TJoinOp::LEFT_ANTI_JOIN)) {
+                rows.push_back(left_row);
+            }
+        }
+        return rows;
+    }
+
+    TTupleId _left_tuple;
+    TTupleId _right_tuple;
+    std::vector<std::optional<int32_t>> _left_keys;
+    std::vector<std::optional<int32_t>> _right_keys;
+};
+
+TEST_F(VMergeJoinNodeTest, join) {
+    for (auto join_op : {TJoinOp::INNER_JOIN, TJoinOp::LEFT_OUTER_JOIN, TJoinOp::LEFT_SEMI_JOIN,
+                         TJoinOp::LEFT_ANTI_JOIN}) {
+        auto node = create_join_node(join_op, sorted_child(_left_tuple, _left_keys),
+                                     sorted_child(_right_tuple, _right_keys));
+        std::vector<std::string> rows;
+        EXPECT_TRUE(execute(node, &rows).ok());
+        auto expected = expected_rows(join_op);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, rows) << "join op " << join_op;
+    }
+}
+
+TEST_F(VMergeJoinNodeTest, child_order) {
+    std::vector<std::string> rows;
+    // the order of a child declaring none is up to the plan
+    auto right = sorted_child(_right_tuple, _right_keys);
+    right->_ordered_by_slots.clear();
+    auto node = create_join_node(TJoinOp::INNER_JOIN, sorted_child(_left_tuple, _left_keys), right);
+    EXPECT_TRUE(execute(node, &rows).ok());
+    EXPECT_EQ(expected_rows(TJoinOp::INNER_JOIN), rows);
+
+    right = sorted_child(_right_tuple, _right_keys);
+    right->_ordered_by_slots = {slot(_right_tuple, 1).id};
+    node = create_join_node(TJoinOp::INNER_JOIN, sorted_child(_left_tuple, _left_keys), right);
+    EXPECT_FALSE(execute(node, &rows).ok());
+
+    right = sorted_child(_right_tuple, _right_keys);
+    right->_ordered_by_asc_order = {false};
+    node = create_join_node(TJoinOp::INNER_JOIN, sorted_child(_left_tuple, _left_keys), right);
+    EXPECT_FALSE(execute(node, &rows).ok());
+
+    auto left = sorted_child(_left_tuple, _left_keys);
+    left->_ordered_by_nulls_first = {true};
+    node = create_join_node(TJoinOp::INNER_JOIN, left, sorted_child(_right_tuple, _right_keys));
+    EXPECT_FALSE(execute(node, &rows).ok());
+}
+
+} // namespace doris::vectorized
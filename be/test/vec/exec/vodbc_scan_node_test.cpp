@@ -0,0 +1,134 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vodbc_scan_node.h"
+
+#include <gtest/gtest.h>
+#include <sqlext.h>
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// The rows fetched by the odbc driver at once are converted column by column from the arrays
+// the columns are bound to.
+class VOdbcScanNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _tuple = add_tuple({{TYPE_INT, false}, {TYPE_VARCHAR, true}});
+        init_runtime_state(4);
+        TPlanNode tnode = plan_node(TPlanNodeType::ODBC_SCAN_NODE, {_tuple});
+        tnode.__isset.odbc_scan_node = true;
+        tnode.odbc_scan_node.tuple_id = _tuple;
+        tnode.odbc_scan_node.table_name = "t";
+        _node = create_node<VOdbcScanNode>(tnode, {});
+        ASSERT_TRUE(_node->prepare(_state.get()).ok());
+    }
+
+    // bind a column to the values of the fetched rows as the driver fills them, a value longer
+    // than `buffer_length` is truncated
+    void bind(SQLINTEGER buffer_length, const std::vector<std::optional<std::string>>& values) {
+        auto column_data = std::make_unique<DataBinding>();
+        column_data->target_type = SQL_C_CHAR;
+        column_data->buffer_length = buffer_length;
+        column_data->target_value_ptr = calloc(values.size(), buffer_length);
+        column_data->strlen_or_ind = static_cast<SQLLEN*>(malloc(sizeof(SQLLEN) * values.size()));
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (values[i].has_value()) {
+                memcpy(column_data->value(i), values[i]->data(),
+                       std::min<size_t>(values[i]->size(), buffer_length));
+                column_data->strlen_or_ind[i] = values[i]->size();
+            } else {
+                column_data->strlen_or_ind[i] = SQL_NULL_DATA;
+            }
+        }
+        _node->get_odbc_scanner()->_columns_data.push_back(std::move(column_data));
+    }
+
+    std::vector<MutableColumnPtr> empty_columns() {
+        std::vector<MutableColumnPtr> columns;
+        for (auto slot : _node->get_tuple_desc()->slots()) {
+            columns.push_back(slot->get_empty_mutable_column());
+        }
+        return columns;
+    }
+
+    TTupleId _tuple;
+    VOdbcScanNode* _node = nullptr;
+};
+
+TEST_F(VOdbcScanNodeTest, write_columns) {
+    bind(100, {"1", "2", "3", "4"});
+    bind(100, {"a", std::nullopt, "ccc", ""});
+
+    // the rows are appended from the start row of the fetched ones
+    auto columns = empty_columns();
+    ASSERT_TRUE(_node->_write_columns(columns, 0, 1).ok());
+    ASSERT_TRUE(_node->_write_columns(columns, 2, 2).ok());
+    ASSERT_EQ(3, columns[0]->size());
+    ASSERT_EQ(3, columns[1]->size());
+    std::vector<int64_t> ints;
+    for (size_t i = 0; i < 3; ++i) {
+        ints.push_back((*columns[0])[i].get<Int64>());
+    }
+    EXPECT_EQ(std::vector<int64_t>({1, 3, 4}), ints);
+    EXPECT_EQ("a", (*columns[1])[0].get<String>());
+    EXPECT_EQ("ccc", (*columns[1])[1].get<String>());
+    EXPECT_EQ("", (*columns[1])[2].get<String>());
+
+    // and the null is kept in the nullable column
+    columns = empty_columns();
+    ASSERT_TRUE(_node->_write_columns(columns, 1, 1).ok());
+    EXPECT_TRUE((*columns[1])[0].is_null());
+}
+
+TEST_F(VOdbcScanNodeTest, write_invalid_columns) {
+    // a null in the non-nullable column
+    bind(100, {"1", std::nullopt});
+    bind(4, {"a", "bbbbbb"});
+    auto columns = empty_columns();
+    EXPECT_FALSE(_node->_write_columns(columns, 1, 1).ok());
+
+    // a truncated value
+    _node->get_odbc_scanner()->_columns_data.clear();
+    bind(100, {"1", "2"});
+    bind(4, {"a", "bbbbbb"});
+    columns = empty_columns();
+    EXPECT_TRUE(_node->_write_columns(columns, 0, 1).ok());
+    EXPECT_FALSE(_node->_write_columns(columns, 1, 1).ok());
+}
+
+TEST(ODBCConnectorTest, rows_per_fetch) {
+    int64_t fetch_buffer_bytes = config::odbc_scan_fetch_buffer_bytes;
+    config::odbc_scan_fetch_buffer_bytes = 1000;
+    EXPECT_EQ(10, ODBCConnector::_rows_per_fetch(4096, 100));
+    EXPECT_EQ(4, ODBCConnector::_rows_per_fetch(4, 100));
+    // a row is fetched even if its buffers exceed the limit
+    EXPECT_EQ(1, ODBCConnector::_rows_per_fetch(4096, 65535));
+    // the rows fetched one by one aren't limited
+    EXPECT_EQ(1, ODBCConnector::_rows_per_fetch(1, 100));
+    config::odbc_scan_fetch_buffer_bytes = fetch_buffer_bytes;
+}
+
+} // namespace doris::vectorized
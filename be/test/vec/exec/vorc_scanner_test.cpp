@@ -0,0 +1,157 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/exec/vorc_scanner.h"
+
+#include <gtest/gtest.h>
+#include <runtime/descriptor_helper.h>
+
+#include <string>
+#include <vector>
+
+#include "common/object_pool.h"
+#include "exprs/cast_functions.h"
+#include "exprs/decimalv2_operators.h"
+#include "gen_cpp/Descriptors_types.h"
+#include "gen_cpp/PlanNodes_types.h"
+#include "runtime/descriptors.h"
+#include "runtime/runtime_state.h"
+#include "runtime/user_function_cache.h"
+
+namespace doris::vectorized {
+
+class VOrcScannerTest : public testing::Test {
+public:
+    VOrcScannerTest() : _runtime_state(TQueryGlobals()) {
+        _profile = _runtime_state.runtime_profile();
+        _runtime_state._instance_mem_tracker.reset(new MemTracker());
+    }
+
+    static void SetUpTestCase() {
+        UserFunctionCache::instance()->init(
+                "./be/test/runtime/test_data/user_function_cache/normal");
+        CastFunctions::init();
+        DecimalV2Operators::init();
+    }
+
+protected:
+    virtual void SetUp() {}
+
+    virtual void TearDown() {}
+
+    RuntimeState _runtime_state;
+    RuntimeProfile* _profile;
+    ObjectPool _obj_pool;
+    DescriptorTbl* _desc_tbl;
+    std::vector<TNetworkAddress> _addresses;
+    ScannerCounter _counter;
+    std::vector<TExpr> _pre_filter;
+};
+
+TEST_F(VOrcScannerTest, normal) {
+    TBrokerScanRangeParams params;
+    TTypeDesc varchar_type;
+    {
+        TTypeNode node;
+        node.__set_type(TTypeNodeType::SCALAR);
+        TScalarType scalar_type;
+        scalar_type.__set_type(TPrimitiveType::VARCHAR);
+        scalar_type.__set_len(65535);
+        node.__set_scalar_type(scalar_type);
+        varchar_type.types.push_back(node);
+    }
+
+    {
+        TExprNode slot_ref;
+        slot_ref.node_type = TExprNodeType::SLOT_REF;
+        slot_ref.type = varchar_type;
+        slot_ref.num_children = 0;
+        slot_ref.__isset.slot_ref = true;
+        slot_ref.slot_ref.slot_id = 1;
+        slot_ref.slot_ref.tuple_id = 0;
+
+        TExpr expr;
+        expr.nodes.push_back(slot_ref);
+
+        params.expr_of_dest_slot.emplace(3, expr);
+        params.src_slot_ids.push_back(1);
+    }
+    params.__set_src_tuple_id(0);
+    params.__set_dest_tuple_id(1);
+
+    TDescriptorTableBuilder dtb;
+    TTupleDescriptorBuilder src_tuple_builder;
+    src_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .string_type(65535)
+                                       .nullable(true)
+                                       .column_name("col1")
+                                       .column_pos(1)
+                                       .build());
+    src_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .string_type(65535)
+                                       .nullable(true)
+                                       .column_name("col2")
+                                       .column_pos(2)
+                                       .build());
+    src_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                       .string_type(65535)
+                                       .nullable(true)
+                                       .column_name("col3")
+                                       .column_pos(3)
+                                       .build());
+    src_tuple_builder.build(&dtb);
+    TTupleDescriptorBuilder dest_tuple_builder;
+    dest_tuple_builder.add_slot(TSlotDescriptorBuilder()
+                                        .string_type(65535)
+                                        .nullable(true)
+                                        .column_name("value_from_col2")
+                                        .column_pos(1)
+                                        .build());
+    dest_tuple_builder.build(&dtb);
+
+    DescriptorTbl::create(&_obj_pool, dtb.desc_tbl(), &_desc_tbl);
+    _runtime_state.set_desc_tbl(_desc_tbl);
+
+    std::vector<TBrokerRangeDesc> ranges;
+    TBrokerRangeDesc range_desc;
+    range_desc.start_offset = 0;
+    range_desc.size = -1;
+    range_desc.format_type = TFileFormatType::FORMAT_ORC;
+    range_desc.splittable = false;
+    range_desc.path = "./be/test/exec/test_data/orc_scanner/my-file.orc";
+    range_desc.file_type = TFileType::FILE_LOCAL;
+    ranges.push_back(range_desc);
+
+    VORCScanner scanner(&_runtime_state, _profile, params, ranges, _addresses, _pre_filter,
+                        &_counter);
+    EXPECT_TRUE(scanner.open().ok());
+
+    std::vector<MutableColumnPtr> columns;
+    for (auto slot_desc : _desc_tbl->get_tuple_descriptor(1)->slots()) {
+        columns.emplace_back(slot_desc->get_empty_mutable_column());
+    }
+    bool eof = false;
+    EXPECT_TRUE(scanner.get_next(columns, &eof).ok());
+    ASSERT_GE(columns[0]->size(), 2);
+    EXPECT_TRUE(columns[0]->is_null_at(0));
+    EXPECT_FALSE(columns[0]->is_null_at(1));
+    EXPECT_EQ(columns[0]->get_data_at(1).to_string(), "true");
+    scanner.close();
+}
+
+} // namespace doris::vectorized
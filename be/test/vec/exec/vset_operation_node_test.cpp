@@ -0,0 +1,208 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+
+#include "vec/exec/vexcept_node.h"
+#include "vec/exec/vexec_node_test_util.h"
+#include "vec/exec/vintersect_node.h"
+
+namespace doris::vectorized {
+
+// select k from c0 intersect (or except) select k from c1 ..., of a not null string k, which is
+// hashed by the StringHashTableContext
+class VSetOperationNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _output_tuple = add_tuple({{TYPE_VARCHAR, false}});
+        for (int i = 0; i < 4; ++i) {
+            _child_tuples.push_back(add_tuple({{TYPE_VARCHAR, false}}));
+        }
+        init_runtime_state(64);
+    }
+
+    // the keys of all the lengths of the sub maps of StringHashMap, including the empty one
+    static std::string key(int i) {
+        return i == 0 ? "" : std::string(i * 7 % 40, 'a' + i % 26) + std::to_string(i);
+    }
+
+    // the rows of the keys in blocks of 64 rows
+    std::vector<Block> input_blocks(const std::vector<int>& keys) {
+        std::vector<std::optional<std::string>> values;
+        for (int k : keys) {
+            values.push_back(key(k));
+        }
+        return split_blocks(Block({string_column(values, false)}), 64);
+    }
+
+    static std::vector<int> keys(int begin, int end, int step = 1) {
+        std::vector<int> result;
+        for (int k = begin; k < end; k += step) {
+            result.push_back(k);
+        }
+        return result;
+    }
+
+    // the rows of the set operation computed by std::set
+    static std::vector<std::string> expected_rows(TPlanNodeType::type type,
+                                                  const std::vector<std::vector<int>>& children) {
+        std::set<std::string> result;
+        for (int k : children[0]) {
+            result.insert(key(k));
+        }
+        for (size_t i = 1; i < children.size(); ++i) {
+            std::set<std::string> child;
+            for (int k : children[i]) {
+                child.insert(key(k));
+            }
+            std::set<std::string> next;
+            for (const auto& k : result) {
+                if ((child.count(k) > 0) == (type == TPlanNodeType::INTERSECT_NODE)) {
+                    next.insert(k);
+                }
+            }
+            result = std::move(next);
+        }
+        return {result.begin(), result.end()};
+    }
+
+    Status run(TPlanNodeType::type type, const std::vector<std::vector<int>>& children,
+               std::vector<std::string>* rows) {
+        std::vector<ExecNode*> child_nodes;
+        std::vector<std::vector<TExpr>> result_expr_lists;
+        _mock_nodes.clear();
+        for (size_t i = 0; i < children.size(); ++i) {
+            _mock_nodes.push_back(mock_node(_child_tuples[i], input_blocks(children[i])));
+            child_nodes.push_back(_mock_nodes.back());
+            result_expr_lists.push_back({slot_ref(_child_tuples[i], 0)});
+        }
+
+        TPlanNode tnode = plan_node(type, {_output_tuple});
+        tnode.num_children = children.size();
+        Status status;
+        if (type == TPlanNodeType::INTERSECT_NODE) {
+            tnode.__isset.intersect_node = true;
+            tnode.intersect_node.tuple_id = _output_tuple;
+            tnode.intersect_node.result_expr_lists = result_expr_lists;
+            tnode.intersect_node.first_materialized_child_idx = 0;
+            auto node = create_node<VIntersectNode>(tnode, child_nodes);
+            status = execute(node, rows);
+            EXPECT_TRUE(std::holds_alternative<StringHashTableContext>(node->_hash_table_variants));
+        } else {
+            tnode.__isset.except_node = true;
+            tnode.except_node.tuple_id = _output_tuple;
+            tnode.except_node.result_expr_lists = result_expr_lists;
+            tnode.except_node.first_materialized_child_idx = 0;
+            auto node = create_node<VExceptNode>(tnode, child_nodes);
+            status = execute(node, rows);
+            EXPECT_TRUE(std::holds_alternative<StringHashTableContext>(node->_hash_table_variants));
+        }
+        std::sort(rows->begin(), rows->end());
+        return status;
+    }
+
+    // the number of the blocks read from the child
+    size_t blocks_read(int child) { return _mock_nodes[child]->_next_block; }
+
+    TTupleId _output_tuple;
+    std::vector<TTupleId> _child_tuples;
+    std::vector<VMockNode*> _mock_nodes;
+};
+
+TEST_F(VSetOperationNodeTest, intersect_string_keys) {
+    // the duplicated keys of the first child are returned once
+    std::vector<int> first = keys(0, 600);
+    std::vector<int> duplicates = keys(0, 600, 7);
+    first.insert(first.end(), duplicates.begin(), duplicates.end());
+    std::vector<std::vector<int>> children = {first, keys(0, 800, 2), keys(0, 900, 3),
+                                              keys(5, 1000, 5)};
+    children[3].push_back(0);
+    for (size_t num_children = 2; num_children <= children.size(); ++num_children) {
+        std::vector<std::vector<int>> inputs(children.begin(), children.begin() + num_children);
+        std::vector<std::string> rows;
+        EXPECT_TRUE(run(TPlanNodeType::INTERSECT_NODE, inputs, &rows).ok());
+        auto expected = expected_rows(TPlanNodeType::INTERSECT_NODE, inputs);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, rows) << num_children << " children";
+    }
+}
+
+TEST_F(VSetOperationNodeTest, except_string_keys) {
+    std::vector<std::vector<int>> children = {keys(0, 600), keys(0, 800, 2), keys(0, 900, 3),
+                                              keys(5, 1000, 5)};
+    for (size_t num_children = 2; num_children <= children.size(); ++num_children) {
+        std::vector<std::vector<int>> inputs(children.begin(), children.begin() + num_children);
+        std::vector<std::string> rows;
+        EXPECT_TRUE(run(TPlanNodeType::EXCEPT_NODE, inputs, &rows).ok());
+        auto expected = expected_rows(TPlanNodeType::EXCEPT_NODE, inputs);
+        EXPECT_FALSE(expected.empty());
+        EXPECT_EQ(expected, rows) << num_children << " children";
+    }
+}
+
+TEST_F(VSetOperationNodeTest, intersect_early_empty) {
+    // all the keys are hit by the first blocks of the second child, the rest of it isn't read
+    std::vector<int> second = keys(0, 100);
+    std::vector<int> others = keys(1000, 2000);
+    second.insert(second.end(), others.begin(), others.end());
+    std::vector<std::string> rows;
+    std::vector<std::vector<int>> children = {keys(0, 100), second, keys(50, 60), keys(50, 3000)};
+    EXPECT_TRUE(run(TPlanNodeType::INTERSECT_NODE, children, &rows).ok());
+    EXPECT_EQ(expected_rows(TPlanNodeType::INTERSECT_NODE, children), rows);
+    EXPECT_EQ(10, rows.size());
+    EXPECT_EQ(2, blocks_read(1));
+    // so are the keys left by the third child
+    EXPECT_EQ(1, blocks_read(3));
+
+    // the intersection is empty after the second child, the others aren't read
+    rows.clear();
+    EXPECT_TRUE(run(TPlanNodeType::INTERSECT_NODE,
+                    {keys(0, 100), keys(100, 200), keys(0, 100), keys(0, 100)}, &rows)
+                        .ok());
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(0, blocks_read(2));
+    EXPECT_EQ(0, blocks_read(3));
+}
+
+TEST_F(VSetOperationNodeTest, except_early_empty) {
+    // all the keys are excepted by the first blocks of the second child, the rest of it and the
+    // other children aren't read
+    std::vector<int> second = keys(0, 128);
+    std::vector<int> others = keys(1000, 2000);
+    second.insert(second.end(), others.begin(), others.end());
+    std::vector<std::string> rows;
+    EXPECT_TRUE(run(TPlanNodeType::EXCEPT_NODE, {keys(0, 128), second, keys(0, 10), keys(0, 10)},
+                    &rows)
+                        .ok());
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(2, blocks_read(1));
+    EXPECT_EQ(0, blocks_read(2));
+    EXPECT_EQ(0, blocks_read(3));
+
+    // the keys left by the second child are all excepted by the third one
+    rows.clear();
+    EXPECT_TRUE(run(TPlanNodeType::EXCEPT_NODE,
+                    {keys(0, 128), keys(0, 128, 2), keys(1, 128, 2), keys(0, 10)}, &rows)
+                        .ok());
+    EXPECT_TRUE(rows.empty());
+    EXPECT_EQ(0, blocks_read(3));
+}
+
+} // namespace doris::vectorized
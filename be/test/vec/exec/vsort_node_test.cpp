@@ -0,0 +1,125 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vsort_node.h"
+
+#include <gtest/gtest.h>
+
+#include "common/config.h"
+#include "vec/exec/vexec_node_test_util.h"
+
+namespace doris::vectorized {
+
+// select * from t order by k1 asc nulls first, k2 desc nulls last, v
+class VSortNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _tuple = add_tuple({{TYPE_INT, true}, {TYPE_INT, true}, {TYPE_INT, false}});
+        init_runtime_state(1024);
+    }
+
+    void TearDown() override {
+        VExecNodeTest::TearDown();
+        config::vec_spill_min_mem_bytes = _min_mem_bytes;
+    }
+
+    std::vector<Block> input_blocks(int rows) {
+        std::vector<std::optional<int32_t>> k1;
+        std::vector<std::optional<int32_t>> k2;
+        std::vector<std::optional<int32_t>> v;
+        for (int i = 0; i < rows; ++i) {
+            k1.push_back(i % 13 == 0 ? std::nullopt : std::optional<int32_t>(i % 37));
+            k2.push_back(i % 17 == 0 ? std::nullopt : std::optional<int32_t>(i * 7 % 101));
+            v.push_back(i);
+        }
+        Block block({int_column(k1, true), int_column(k2, true), int_column(v, false)});
+        return split_blocks(block, _state->batch_size());
+    }
+
+    VSortNode* create_sort_node(VMockNode* child, int64_t limit, int64_t offset) {
+        TPlanNode tnode = plan_node(TPlanNodeType::SORT_NODE, {_tuple});
+        tnode.num_children = 1;
+        tnode.limit = limit;
+        tnode.__isset.sort_node = true;
+        auto& sort_info = tnode.sort_node.sort_info;
+        sort_info.ordering_exprs = {slot_ref(_tuple, 0), slot_ref(_tuple, 1), slot_ref(_tuple, 2)};
+        sort_info.is_asc_order = {true, false, true};
+        sort_info.nulls_first = {true, false, false};
+        tnode.sort_node.use_top_n = limit != -1;
+        tnode.sort_node.__set_offset(offset);
+        return create_node<VSortNode>(tnode, {child});
+    }
+
+    Status sort(int rows, int64_t limit, int64_t offset, std::vector<std::string>* result) {
+        auto node = create_sort_node(mock_node(_tuple, input_blocks(rows)), limit, offset);
+        Status status = execute(node, result);
+        if (_state->is_spill_requested()) {
+            // every input block is spilled as a sorted run
+            EXPECT_EQ((rows + _state->batch_size() - 1) / _state->batch_size(),
+                      node->_spill_runs_counter->value());
+        }
+        return status;
+    }
+
+    TTupleId _tuple;
+    int64_t _min_mem_bytes = config::vec_spill_min_mem_bytes;
+};
+
+TEST_F(VSortNodeTest, spill) {
+    std::vector<std::string> expected;
+    EXPECT_TRUE(sort(20000, -1, 0, &expected).ok());
+    EXPECT_EQ(20000, expected.size());
+
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    _state->set_spill_requested(true);
+    std::vector<std::string> rows;
+    EXPECT_TRUE(sort(20000, -1, 0, &rows).ok());
+    EXPECT_EQ(expected, rows);
+
+    // the offset is applied by the merger of the spilled runs
+    for (int64_t offset : {1, 1024, 5000, 19999, 20000, 30000}) {
+        rows.clear();
+        EXPECT_TRUE(sort(20000, -1, offset, &rows).ok());
+        std::vector<std::string> expected_rows(
+                expected.begin() + std::min<int64_t>(offset, expected.size()), expected.end());
+        EXPECT_EQ(expected_rows, rows) << "offset " << offset;
+    }
+}
+
+TEST_F(VSortNodeTest, limit_offset) {
+    std::vector<std::string> expected;
+    EXPECT_TRUE(sort(20000, -1, 0, &expected).ok());
+
+    // TOP-N never spills
+    enable_spill();
+    config::vec_spill_min_mem_bytes = 0;
+    _state->set_spill_requested(true);
+    for (auto [limit, offset] : std::vector<std::pair<int64_t, int64_t>> {
+                 {1, 0}, {100, 0}, {100, 1500}, {2000, 1023}, {5000, 18000}, {10, 20000}}) {
+        std::vector<std::string> rows;
+        auto node = create_sort_node(mock_node(_tuple, input_blocks(20000)), limit, offset);
+        EXPECT_TRUE(execute(node, &rows).ok());
+        EXPECT_EQ(nullptr, node->_spill_runs_counter);
+        size_t begin = std::min<size_t>(offset, expected.size());
+        size_t end = std::min<size_t>(offset + limit, expected.size());
+        std::vector<std::string> expected_rows(expected.begin() + begin, expected.begin() + end);
+        EXPECT_EQ(expected_rows, rows) << "limit " << limit << " offset " << offset;
+    }
+}
+
+} // namespace doris::vectorized
@@ -38,6 +38,7 @@
 #include "util/brpc_client_cache.h"
 #include "util/cpu_info.h"
 #include "util/debug/leakcheck_disabler.h"
+#include "util/defer_op.h"
 #include "util/proto_util.h"
 
 namespace doris {
@@ -154,9 +155,74 @@ public:
         brpc::ClosureGuard done_guard(done);
     }
 
+    void tablet_writer_open_stream(google::protobuf::RpcController* controller,
+                                   const PTabletWriterOpenStreamRequest* request,
+                                   PTabletWriterOpenStreamResult* response,
+                                   google::protobuf::Closure* done) override {
+        brpc::ClosureGuard done_guard(done);
+        brpc::StreamOptions options;
+        options.handler = &_stream_handler;
+        brpc::StreamId stream_id;
+        Status status;
+        if (brpc::StreamAccept(&stream_id, *static_cast<brpc::Controller*>(controller),
+                               &options) != 0) {
+            status = Status::InternalError("failed to accept stream");
+        }
+        status.to_protobuf(response->mutable_status());
+    }
+
+    // counts the add block requests of the streams like tablet_writer_add_block
+    class StreamHandler : public brpc::StreamInputHandler {
+    public:
+        explicit StreamHandler(VTestInternalService* service) : _service(service) {}
+
+        int on_received_messages(brpc::StreamId id, butil::IOBuf* const messages[],
+                                 size_t size) override {
+            for (size_t i = 0; i < size; ++i) {
+                uint32_t header_size = 0;
+                messages[i]->cutn(&header_size, sizeof(header_size));
+                butil::IOBuf header;
+                messages[i]->cutn(&header, header_size);
+                butil::IOBufAsZeroCopyInputStream header_stream(header);
+                PTabletWriterAddBlockRequest request;
+                EXPECT_TRUE(request.ParseFromZeroCopyStream(&header_stream));
+
+                PTabletWriterAddBlockResult response;
+                {
+                    std::lock_guard<std::mutex> l(_service->_lock);
+                    // the packets of a stream are in order
+                    EXPECT_EQ(_service->_stream_next_seqs[id]++, request.packet_seq());
+                    _service->_stream_packets++;
+                    _service->_row_counters += request.tablet_ids_size();
+                    if (request.eos()) {
+                        _service->_eof_counters++;
+                    }
+                    k_add_batch_status.to_protobuf(response.mutable_status());
+                }
+                butil::IOBuf result;
+                {
+                    butil::IOBufAsZeroCopyOutputStream result_stream(&result);
+                    response.SerializeToZeroCopyStream(&result_stream);
+                }
+                EXPECT_EQ(0, brpc::StreamWrite(id, result));
+            }
+            return 0;
+        }
+
+        void on_idle_timeout(brpc::StreamId id) override {}
+
+        void on_closed(brpc::StreamId id) override {}
+
+    private:
+        VTestInternalService* _service;
+    };
+
     std::mutex _lock;
     int64_t _eof_counters = 0;
     int64_t _row_counters = 0;
+    int64_t _stream_packets = 0;
+    std::map<brpc::StreamId, int64_t> _stream_next_seqs;
+    StreamHandler _stream_handler {this};
     RowDescriptor* _row_desc = nullptr;
     std::set<std::string>* _output_set = nullptr;
 };
@@ -264,6 +330,82 @@ TEST_F(VOlapTableSinkTest, normal) {
     ASSERT_EQ(1, state.num_rows_load_filtered());
 }
 
+TEST_F(VOlapTableSinkTest, stream) {
+    // start brpc service first
+    _server = new brpc::Server();
+    auto service = new VTestInternalService();
+    ASSERT_EQ(_server->AddService(service, brpc::SERVER_OWNS_SERVICE), 0);
+    brpc::ServerOptions options;
+    {
+        debug::ScopedLeakCheckDisabler disable_lsan;
+        _server->Start(4356, &options);
+    }
+    config::enable_tablet_writer_stream = true;
+    Defer reset_config {[]() { config::enable_tablet_writer_stream = false; }};
+
+    TUniqueId fragment_id;
+    TQueryOptions query_options;
+    query_options.batch_size = 1;
+    RuntimeState state(fragment_id, query_options, TQueryGlobals(), _env);
+    state.init_mem_trackers(TUniqueId());
+
+    ObjectPool obj_pool;
+    TDescriptorTable tdesc_tbl;
+    auto t_data_sink = get_data_sink(&tdesc_tbl);
+
+    DescriptorTbl* desc_tbl = nullptr;
+    auto st = DescriptorTbl::create(&obj_pool, tdesc_tbl, &desc_tbl);
+    ASSERT_TRUE(st.ok());
+    state._desc_tbl = desc_tbl;
+
+    TupleDescriptor* tuple_desc = desc_tbl->get_tuple_descriptor(0);
+    RowDescriptor row_desc(*desc_tbl, {0}, {false});
+
+    VOlapTableSink sink(&obj_pool, row_desc, {}, &st);
+    ASSERT_TRUE(st.ok());
+    st = sink.init(t_data_sink);
+    ASSERT_TRUE(st.ok());
+    st = sink.prepare(&state);
+    ASSERT_TRUE(st.ok());
+    st = sink.open(&state);
+    ASSERT_TRUE(st.ok());
+
+    int slot_count = tuple_desc->slots().size();
+    std::vector<vectorized::MutableColumnPtr> columns(slot_count);
+    for (int i = 0; i < slot_count; i++) {
+        columns[i] = tuple_desc->slots()[i]->get_empty_mutable_column();
+    }
+    for (int32_t int_val : {12, 13, 14}) {
+        columns[0]->insert_data((const char*)&int_val, 0);
+    }
+    for (int64_t int64_val : {9, 25, 50}) {
+        columns[1]->insert_data((const char*)&int64_val, 0);
+    }
+    columns[2]->insert_data("abc", 3);
+    columns[2]->insert_data("abcd", 4);
+    columns[2]->insert_data("abcde1234567890", 15);
+
+    vectorized::Block block;
+    int col_idx = 0;
+    for (const auto slot_desc : tuple_desc->slots()) {
+        block.insert(vectorized::ColumnWithTypeAndName(std::move(columns[col_idx++]),
+                                                       slot_desc->get_data_type_ptr(),
+                                                       slot_desc->col_name()));
+    }
+
+    st = sink.send(&state, &block);
+    ASSERT_TRUE(st.ok());
+    st = sink.close(&state, Status::OK());
+    ASSERT_TRUE(st.ok() || st.to_string() == "Internal error: wait close failed. ")
+            << st.to_string();
+
+    // all the packets are sent through the streams, each node has a eof
+    ASSERT_EQ(2, service->_eof_counters);
+    ASSERT_EQ(2 * 2, service->_row_counters);
+    ASSERT_EQ(service->_stream_packets, service->_eof_counters + 2 * 2);
+    ASSERT_EQ(1, state.num_rows_load_filtered());
+}
+
 TEST_F(VOlapTableSinkTest, convert) {
     // start brpc service first
     _server = new brpc::Server();
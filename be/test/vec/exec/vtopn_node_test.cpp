@@ -0,0 +1,144 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/exec/vtopn_node.h"
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "vec/exec/vexec_node_test_util.h"
+#include "vec/exec/vsort_node.h"
+
+namespace doris::vectorized {
+
+// select * from t order by k1 asc nulls first, k2 desc nulls last[, v] limit offset, limit
+class VTopNNodeTest : public VExecNodeTest {
+protected:
+    void SetUp() override {
+        _tuple = add_tuple({{TYPE_INT, true}, {TYPE_VARCHAR, true}, {TYPE_INT, false}});
+        init_runtime_state(1024);
+    }
+
+    // the rows of few distinct (k1, k2), so most rows tie on them
+    std::vector<Block> input_blocks(int rows) {
+        std::vector<std::optional<int32_t>> k1;
+        std::vector<std::optional<std::string>> k2;
+        std::vector<std::optional<int32_t>> v;
+        for (int i = 0; i < rows; ++i) {
+            k1.push_back(i % 13 == 0 ? std::nullopt : std::optional<int32_t>(i * 7 % 11));
+            k2.push_back(i % 17 == 0 ? std::nullopt
+                                     : std::optional<std::string>("s" + std::to_string(i % 5)));
+            v.push_back(i * 31 % rows);
+        }
+        Block block({int_column(k1, true), string_column(k2, true), int_column(v, false)});
+        return split_blocks(block, _state->batch_size());
+    }
+
+    TPlanNode sort_plan_node(int64_t limit, int64_t offset, bool order_by_v) {
+        TPlanNode tnode = plan_node(TPlanNodeType::SORT_NODE, {_tuple});
+        tnode.num_children = 1;
+        tnode.limit = limit;
+        tnode.__isset.sort_node = true;
+        auto& sort_info = tnode.sort_node.sort_info;
+        sort_info.ordering_exprs = {slot_ref(_tuple, 0), slot_ref(_tuple, 1)};
+        sort_info.is_asc_order = {true, false};
+        sort_info.nulls_first = {true, false};
+        if (order_by_v) {
+            sort_info.ordering_exprs.push_back(slot_ref(_tuple, 2));
+            sort_info.is_asc_order.push_back(true);
+            sort_info.nulls_first.push_back(false);
+        }
+        tnode.sort_node.use_top_n = limit != -1;
+        tnode.sort_node.__set_offset(offset);
+        return tnode;
+    }
+
+    // the rows sorted by VSortNode, in the same order as TOP-N
+    std::vector<std::string> sorted_rows(int rows, bool order_by_v) {
+        auto node = create_node<VSortNode>(sort_plan_node(-1, 0, order_by_v),
+                                           {mock_node(_tuple, input_blocks(rows))});
+        std::vector<std::string> result;
+        EXPECT_TRUE(execute(node, &result).ok());
+        EXPECT_EQ(rows, result.size());
+        return result;
+    }
+
+    VTopNNode* create_topn_node(int rows, int64_t limit, int64_t offset, bool order_by_v) {
+        return create_node<VTopNNode>(sort_plan_node(limit, offset, order_by_v),
+                                      {mock_node(_tuple, input_blocks(rows))});
+    }
+
+    // "k1|k2" of the row "k1|k2|v"
+    static std::string sort_key(const std::string& row) { return row.substr(0, row.rfind('|')); }
+
+    TTupleId _tuple;
+};
+
+TEST_F(VTopNNodeTest, limit_offset) {
+    auto expected = sorted_rows(20000, true);
+    for (auto [limit, offset] : std::vector<std::pair<int64_t, int64_t>> {
+                 {1, 0},
+                 {100, 0},
+                 {100, 1500},
+                 {2000, 1023},
+                 {5000, 18000},
+                 {10, 20000},
+                 {0, 10},
+                 {30000, 0}}) {
+        std::vector<std::string> rows;
+        auto node = create_topn_node(20000, limit, offset, true);
+        EXPECT_TRUE(execute(node, &rows).ok());
+        size_t begin = std::min<size_t>(offset, expected.size());
+        size_t end = std::min<size_t>(offset + limit, expected.size());
+        std::vector<std::string> expected_rows(expected.begin() + begin, expected.begin() + end);
+        EXPECT_EQ(expected_rows, rows) << "limit " << limit << " offset " << offset;
+    }
+}
+
+TEST_F(VTopNNodeTest, filter_by_heap_top) {
+    auto expected = sorted_rows(20000, true);
+    std::vector<std::string> rows;
+    auto node = create_topn_node(20000, 100, 10, true);
+    EXPECT_TRUE(execute(node, &rows).ok());
+    EXPECT_EQ(std::vector<std::string>(expected.begin() + 10, expected.begin() + 110), rows);
+    // the blocks after the first one are filtered by the heap top, all but the rows of the
+    // first (k1, k2) are rejected
+    EXPECT_GT(node->_rows_filtered_counter->value(), 20000 - 2 * _state->batch_size());
+}
+
+TEST_F(VTopNNodeTest, ties) {
+    // the rows tied with the last row may be any of them, only their sort keys are equal
+    auto expected = sorted_rows(20000, false);
+    for (auto [limit, offset] :
+         std::vector<std::pair<int64_t, int64_t>> {{1, 0}, {150, 0}, {777, 300}, {3000, 1}}) {
+        std::vector<std::string> rows;
+        auto node = create_topn_node(20000, limit, offset, false);
+        EXPECT_TRUE(execute(node, &rows).ok());
+        ASSERT_EQ(limit, rows.size());
+        // the row at the boundary ties with the one after it
+        EXPECT_EQ(sort_key(expected[offset + limit - 1]), sort_key(expected[offset + limit]));
+        std::set<std::string> distinct_rows(rows.begin(), rows.end());
+        EXPECT_EQ(rows.size(), distinct_rows.size());
+        for (size_t i = 0; i < rows.size(); ++i) {
+            EXPECT_EQ(sort_key(expected[offset + i]), sort_key(rows[i]))
+                    << "limit " << limit << " offset " << offset << " row " << i;
+        }
+    }
+}
+
+} // namespace doris::vectorized
@@ -36,6 +36,10 @@
 #include "runtime/tuple.h"
 #include "runtime/tuple_row.h"
 #include "testutil/desc_tbl_builder.h"
+#include "vec/columns/columns_number.h"
+#include "vec/common/assert_cast.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/exprs/vcommon_exprs.h"
 #include "vec/exprs/vliteral.h"
 #include "vec/runtime/vdatetime_value.h"
 #include "vec/utils/util.hpp"
@@ -351,3 +355,136 @@ TEST(TEST_VEXPR, LITERALTEST) {
         EXPECT_FLOAT_EQ(((double)v.get_value()) / (std::pow(10, v.get_scale())), 1234.56);
     }
 }
+
+namespace doris::vectorized {
+// doubles the column 0 of the block, and records the rows it's executed on
+class DoubleExpr final : public VExpr {
+public:
+    DoubleExpr() { _data_type = std::make_shared<DataTypeInt32>(); }
+    VExpr* clone(ObjectPool* pool) const override { return pool->add(new DoubleExpr(*this)); }
+    const std::string& expr_name() const override { return _name; }
+    Status execute(VExprContext* context, Block* block, int* result_column_id) override {
+        executed_rows = block->rows();
+        const auto& input = assert_cast<const ColumnInt32&>(*block->get_by_position(0).column);
+        auto result = ColumnInt32::create();
+        for (auto v : input.get_data()) {
+            result->insert_value(v * 2);
+        }
+        *result_column_id = block->columns();
+        block->insert({std::move(result), _data_type, _name});
+        return Status::OK();
+    }
+    void collect_column_ids(std::set<int>* column_ids) const override { column_ids->insert(0); }
+
+    std::string signature() const override { return "double"; }
+
+    size_t executed_rows = 0;
+
+private:
+    std::string _name = "double";
+};
+
+// adds one to its child, and counts the times it's executed
+class AddOneExpr final : public VExpr {
+public:
+    AddOneExpr(VExpr* child) {
+        _data_type = std::make_shared<DataTypeInt32>();
+        _children.push_back(child);
+    }
+    VExpr* clone(ObjectPool* pool) const override { return pool->add(new AddOneExpr(*this)); }
+    const std::string& expr_name() const override { return _name; }
+    Status execute(VExprContext* context, Block* block, int* result_column_id) override {
+        ++executed_times;
+        int child_id = -1;
+        RETURN_IF_ERROR(_children[0]->execute(context, block, &child_id));
+        const auto& input =
+                assert_cast<const ColumnInt32&>(*block->get_by_position(child_id).column);
+        auto result = ColumnInt32::create();
+        for (auto v : input.get_data()) {
+            result->insert_value(v + 1);
+        }
+        *result_column_id = block->columns();
+        block->insert({std::move(result), _data_type, _name});
+        return Status::OK();
+    }
+    std::string signature() const override { return "add_one" + children_signature(); }
+
+    int executed_times = 0;
+
+private:
+    std::string _name = "add_one";
+};
+} // namespace doris::vectorized
+
+TEST(TEST_VEXPR, EXECUTE_SELECTED) {
+    using namespace doris::vectorized;
+    auto type = std::make_shared<DataTypeInt32>();
+    auto column = ColumnInt32::create();
+    for (int i = 0; i < 10; ++i) {
+        column->insert_value(i);
+    }
+    Block block({{std::move(column), type, "k1"},
+                 {type->create_column_const_with_default_value(10), type, "k2"}});
+
+    DoubleExpr expr;
+    // the sparse rows are evaluated alone and scattered back
+    IColumn::Filter selector(10, 0);
+    selector[2] = selector[3] = 1;
+    int result = -1;
+    EXPECT_TRUE(expr.execute_selected(nullptr, &block, selector, 2, &result).ok());
+    EXPECT_EQ(2, expr.executed_rows);
+    const auto& values = block.get_by_position(result).column;
+    ASSERT_EQ(10, values->size());
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(selector[i] ? i * 2 : 0, values->get_int(i));
+    }
+
+    // no row is evaluated if none is selected
+    expr.executed_rows = 0;
+    IColumn::Filter none(10, 0);
+    EXPECT_TRUE(expr.execute_selected(nullptr, &block, none, 0, &result).ok());
+    EXPECT_EQ(0, expr.executed_rows);
+    EXPECT_EQ(10, block.get_by_position(result).column->size());
+
+    // the dense rows are evaluated on the whole block
+    IColumn::Filter dense(10, 1);
+    dense[0] = 0;
+    EXPECT_TRUE(expr.execute_selected(nullptr, &block, dense, 9, &result).ok());
+    EXPECT_EQ(10, expr.executed_rows);
+}
+
+TEST(TEST_VEXPR, COMMON_EXPRS) {
+    using namespace doris::vectorized;
+    doris::ObjectPool pool;
+    auto type = std::make_shared<DataTypeInt32>();
+    auto column = ColumnInt32::create();
+    column->insert_value(1);
+    column->insert_value(2);
+    Block block({{std::move(column), type, "k1"}});
+
+    // add_one(double(k1)) in both trees, the leaves are not shared
+    auto expr1 = pool.add(new AddOneExpr(pool.add(new DoubleExpr())));
+    auto expr2 = pool.add(new AddOneExpr(pool.add(new DoubleExpr())));
+    VExprContext ctx1(expr1);
+    VExprContext ctx2(expr2);
+    VCommonExprs common_exprs;
+    common_exprs.init(&pool, {&ctx1, &ctx2});
+    EXPECT_EQ(1, common_exprs.size());
+
+    common_exprs.reset(&block);
+    int result1 = -1;
+    int result2 = -1;
+    EXPECT_TRUE(ctx1.execute(&block, &result1).ok());
+    EXPECT_TRUE(ctx2.execute(&block, &result2).ok());
+    EXPECT_EQ(result1, result2);
+    EXPECT_EQ(1, expr1->executed_times + expr2->executed_times);
+    EXPECT_EQ(3, block.get_by_position(result1).column->get_int(0));
+    EXPECT_EQ(5, block.get_by_position(result1).column->get_int(1));
+
+    // the results are not shared on the other blocks
+    Block other_block(block.get_columns_with_type_and_name());
+    EXPECT_TRUE(ctx1.execute(&other_block, &result1).ok());
+    EXPECT_TRUE(ctx2.execute(&other_block, &result2).ok());
+    EXPECT_NE(result1, result2);
+    EXPECT_EQ(3, expr1->executed_times + expr2->executed_times);
+}
@@ -24,6 +24,7 @@
 #include "runtime/tuple_row.h"
 #include "util/url_coding.h"
 #include "vec/core/field.h"
+#include "vec/data_types/data_type_decimal.h"
 
 namespace doris::vectorized {
 
@@ -116,4 +117,59 @@ TEST(function_arithmetic_test, bitxor_test) {
     }
 }
 
+template <typename L, typename R>
+std::vector<std::string> execute_decimal(const std::string& func_name, UInt32 left_scale,
+                                         const std::vector<typename L::NativeType>& left,
+                                         UInt32 right_scale,
+                                         const std::vector<typename R::NativeType>& right,
+                                         const DataTypePtr& return_type) {
+    auto left_col = ColumnDecimal<L>::create(0, left_scale);
+    auto right_col = ColumnDecimal<R>::create(0, right_scale);
+    for (size_t i = 0; i < left.size(); ++i) {
+        left_col->get_data().push_back(left[i]);
+        right_col->get_data().push_back(right[i]);
+    }
+    Block block;
+    block.insert({std::move(left_col),
+                  std::make_shared<DataTypeDecimal<L>>(DataTypeDecimal<L>::max_precision(),
+                                                       left_scale),
+                  "left"});
+    block.insert({std::move(right_col),
+                  std::make_shared<DataTypeDecimal<R>>(DataTypeDecimal<R>::max_precision(),
+                                                       right_scale),
+                  "right"});
+    auto func = SimpleFunctionFactory::instance().get_function(
+            func_name, block.get_columns_with_type_and_name(), return_type);
+    EXPECT_TRUE(func != nullptr);
+    block.insert({nullptr, return_type, "result"});
+
+    FunctionUtils fn_utils;
+    EXPECT_TRUE(func->execute(fn_utils.get_fn_ctx(), block, {0, 1}, 2, left.size()).ok());
+    std::vector<std::string> res;
+    for (size_t i = 0; i < left.size(); ++i) {
+        res.push_back(return_type->to_string(*block.get_by_position(2).column, i));
+    }
+    return res;
+}
+
+// Decimal32 and Decimal64 are computed at their declared scales
+TEST(function_arithmetic_test, decimal_native_test) {
+    auto decimal64_3 = std::make_shared<DataTypeDecimal<Decimal64>>(18, 3);
+
+    // 1.25 + 0.001 = 1.251, -3.00 + 2.500 = -0.500
+    auto res = execute_decimal<Decimal32, Decimal64>("add", 2, {125, -300}, 3, {1, 2500},
+                                                     decimal64_3);
+    EXPECT_EQ(std::vector<std::string>({"1.251", "-0.500"}), res);
+
+    res = execute_decimal<Decimal64, Decimal32>("subtract", 3, {1, 2500}, 2, {125, -300},
+                                                decimal64_3);
+    EXPECT_EQ(std::vector<std::string>({"-1.249", "5.500"}), res);
+
+    // the scale of the product is the sum of the scales
+    auto decimal64_5 = std::make_shared<DataTypeDecimal<Decimal64>>(18, 5);
+    res = execute_decimal<Decimal32, Decimal64>("multiply", 2, {125, -300}, 3, {2, 2500},
+                                                decimal64_5);
+    EXPECT_EQ(std::vector<std::string>({"0.00250", "-7.50000"}), res);
+}
+
 } // namespace doris::vectorized
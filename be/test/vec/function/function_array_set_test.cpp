@@ -0,0 +1,129 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "function_test_util.h"
+#include "vec/core/field.h"
+
+namespace doris::vectorized {
+
+namespace {
+
+// Execute the function `func_name` of one array argument over `inputs`, and check the results
+// against `expects`.
+void check_array_function(const std::string& func_name, const DataTypePtr& array_type,
+                          const std::vector<Field>& inputs, const std::vector<Field>& expects) {
+    auto column = array_type->create_column();
+    for (const auto& input : inputs) {
+        column->insert(input);
+    }
+    Block block;
+    block.insert({std::move(column), array_type, "k0"});
+
+    auto func = SimpleFunctionFactory::instance().get_function(
+            func_name, block.get_columns_with_type_and_name(), array_type);
+    ASSERT_TRUE(func != nullptr);
+    block.insert({nullptr, array_type, "result"});
+    ASSERT_TRUE(func->execute(nullptr, block, {0}, 1, inputs.size()).ok());
+
+    auto result = block.get_by_position(1).column;
+    ASSERT_EQ(expects.size(), result->size());
+    for (size_t i = 0; i < expects.size(); ++i) {
+        EXPECT_EQ(expects[i], (*result)[i]) << func_name << " row " << i;
+    }
+}
+
+DataTypePtr array_of(const DataTypePtr& nested_type) {
+    return std::make_shared<DataTypeArray>(make_nullable(nested_type));
+}
+
+} // namespace
+
+TEST(function_array_set_test, array_distinct) {
+    auto int_array_type = array_of(std::make_shared<DataTypeInt32>());
+    check_array_function(
+            "array_distinct", int_array_type,
+            {Array {Int32(3), Int32(1), Int32(3), Null(), Int32(1), Null()}, Array(),
+             Array {Int32(2)}},
+            {Array {Int32(3), Int32(1), Null()}, Array(), Array {Int32(2)}});
+
+    auto string_array_type = array_of(std::make_shared<DataTypeString>());
+    check_array_function("array_distinct", string_array_type,
+                         {Array {Field("b", 1), Field("a", 1), Field("b", 1), Field("", 0)}},
+                         {Array {Field("b", 1), Field("a", 1), Field("", 0)}});
+}
+
+TEST(function_array_set_test, array_sort) {
+    auto int_array_type = array_of(std::make_shared<DataTypeInt32>());
+    check_array_function("array_sort", int_array_type,
+                         {Array {Int32(3), Null(), Int32(1), Int32(2)}, Array(),
+                          Array {Int32(5), Int32(4)}},
+                         {Array {Null(), Int32(1), Int32(2), Int32(3)}, Array(),
+                          Array {Int32(4), Int32(5)}});
+
+    auto double_array_type = array_of(std::make_shared<DataTypeFloat64>());
+    check_array_function("array_sort", double_array_type,
+                         {Array {Float64(2.5), Float64(-1), Float64(0)}},
+                         {Array {Float64(-1), Float64(0), Float64(2.5)}});
+
+    auto string_array_type = array_of(std::make_shared<DataTypeString>());
+    check_array_function("array_sort", string_array_type,
+                         {Array {Field("b", 1), Field("ab", 2), Field("a", 1)}},
+                         {Array {Field("a", 1), Field("ab", 2), Field("b", 1)}});
+}
+
+TEST(function_array_set_test, arrays_overlap) {
+    std::string func_name = "arrays_overlap";
+    Array empty_arr;
+
+    // arrays_overlap(Array<Int32>, Array<Int32>)
+    {
+        InputTypeSet input_types = {TypeIndex::Array, TypeIndex::Int32, TypeIndex::Array,
+                                    TypeIndex::Int32};
+
+        Array vec1 = {Int32(1), Int32(2), Int32(3)};
+        Array vec2 = {Int32(5), Int32(3)};
+        Array vec3 = {Int32(4)};
+        DataSet data_set = {{{vec1, vec2}, UInt8(1)},
+                            {{vec1, vec3}, UInt8(0)},
+                            {{Null(), vec1}, Null()},
+                            {{empty_arr, vec1}, UInt8(0)}};
+
+        check_function<DataTypeUInt8, true>(func_name, input_types, data_set);
+    }
+
+    // arrays_overlap(Array<String>, Array<String>)
+    {
+        InputTypeSet input_types = {TypeIndex::Array, TypeIndex::String, TypeIndex::Array,
+                                    TypeIndex::String};
+
+        Array vec1 = {Field("abc", 3), Field("", 0)};
+        Array vec2 = {Field("def", 3), Field("", 0)};
+        Array vec3 = {Field("ab", 2)};
+        DataSet data_set = {{{vec1, vec2}, UInt8(1)},
+                            {{vec1, vec3}, UInt8(0)},
+                            {{vec1, Null()}, Null()}};
+
+        check_function<DataTypeUInt8, true>(func_name, input_types, data_set);
+    }
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,82 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#ifdef LIBJVM
+#include "vec/functions/function_java_udf.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+namespace doris::vectorized {
+
+// The times the evaluation of a batch of the string rows of `row_bytes` is resumed with a larger
+// buffer, which is reserved by the bytes per row of the last batch, as JavaFunctionCall::execute
+// does, and the bytes per row for the next batch.
+static int num_resumes(const std::vector<size_t>& row_bytes, size_t* bytes_per_row) {
+    size_t num_rows = row_bytes.size();
+    size_t buffer_size = JavaFunctionCall::initial_reserved_buffer_size(*bytes_per_row, num_rows);
+    size_t rows = 0;
+    size_t used = 0;
+    int resumes = 0;
+    while (true) {
+        // the executor writes the rows until the buffer is full
+        while (rows < num_rows && used + row_bytes[rows] <= buffer_size) {
+            used += row_bytes[rows++];
+        }
+        if (rows == num_rows) {
+            break;
+        }
+        size_t next =
+                JavaFunctionCall::next_reserved_buffer_size(buffer_size, used, rows, num_rows);
+        EXPECT_GE(next, buffer_size * 2);
+        buffer_size = next;
+        ++resumes;
+    }
+    *bytes_per_row = JavaFunctionCall::bytes_per_row(*bytes_per_row, used, num_rows);
+    return resumes;
+}
+
+TEST(FunctionJavaUdfTest, reserved_buffer_size) {
+    std::vector<size_t> short_rows(4096, 10);
+    size_t bytes_per_row = 0;
+    // the first batch is estimated by the rows in the initial buffer, instead of doubling it
+    // about six times
+    EXPECT_EQ(1, num_resumes(short_rows, &bytes_per_row));
+    EXPECT_EQ(11, bytes_per_row);
+    // and the next batches are reserved by it
+    EXPECT_EQ(0, num_resumes(short_rows, &bytes_per_row));
+    EXPECT_EQ(0, num_resumes(std::vector<size_t>(1024, 11), &bytes_per_row));
+
+    // the larger rows of a batch at least double the buffer each time
+    std::vector<size_t> growing_rows;
+    for (size_t i = 0; i < 4096; ++i) {
+        growing_rows.push_back(1 + i / 16);
+    }
+    EXPECT_GT(num_resumes(growing_rows, &bytes_per_row), 0);
+    EXPECT_EQ(145, bytes_per_row);
+    EXPECT_EQ(0, num_resumes(std::vector<size_t>(4096, 100), &bytes_per_row));
+
+    // an empty batch keeps the estimate
+    EXPECT_EQ(0, num_resumes({}, &bytes_per_row));
+    EXPECT_EQ(112, bytes_per_row);
+    EXPECT_EQ(JavaFunctionCall::INITIAL_RESERVED_BUFFER_SIZE,
+              JavaFunctionCall::initial_reserved_buffer_size(0, 4096));
+}
+
+} // namespace doris::vectorized
+#endif
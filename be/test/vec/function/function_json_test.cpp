@@ -18,6 +18,7 @@
 #include <gtest/gtest.h>
 
 #include "function_test_util.h"
+#include "util/jsonb_document.h"
 #include "vec/data_types/data_type_number.h"
 #include "vec/data_types/data_type_string.h"
 
@@ -66,4 +67,107 @@ TEST(FunctionJsonTEST, GetJsonStringTest) {
     check_function<DataTypeString, true>(func_name, input_types, data_set);
 }
 
+TEST(FunctionJsonTEST, GetJsonConstantPathTest) {
+    InputTypeSet input_types = {TypeIndex::String, Consted {TypeIndex::String}};
+    DataSet int_data_set = {
+            {{VARCHAR("{\"k1\":1, \"k2\":2}"), VARCHAR("$.k1")}, INT(1)},
+            {{VARCHAR("{\"k1\":{\"k2\":[1, 2]}}"), VARCHAR("$.k1.k2[1]")}, INT(2)},
+            {{VARCHAR("{\"k1\":{\"k2\":[1, 2]}}"), VARCHAR("$.k1.k2[2]")}, Null()},
+            {{VARCHAR("{\"k1\":1.5}"), VARCHAR("$.k1")}, Null()},
+            {{VARCHAR("{\"k1\":3000000000}"), VARCHAR("$.k1")}, Null()},
+            {{VARCHAR("{\"k1\":null}"), VARCHAR("$.k1")}, Null()},
+            {{VARCHAR("{\"k1\":1"), VARCHAR("$.k1")}, Null()},
+            {{Null(), VARCHAR("$.k1")}, Null()}};
+    for (const auto& line : int_data_set) {
+        check_function<DataTypeInt32, true>("get_json_int", input_types, {line});
+    }
+
+    DataSet double_data_set = {
+            {{VARCHAR("{\"k1\":1.3, \"k2\":2}"), VARCHAR("$.k1")}, DOUBLE(1.3)},
+            {{VARCHAR("{\"k1\":1.3, \"k2\":2}"), VARCHAR("$.k2")}, DOUBLE(2)},
+            {{VARCHAR("{\"k1\":\"v1\"}"), VARCHAR("$.k1")}, Null()},
+            {{VARCHAR("{\"k1\":1.3}"), VARCHAR("$.k3")}, Null()}};
+    for (const auto& line : double_data_set) {
+        check_function<DataTypeFloat64, true>("get_json_double", input_types, {line});
+    }
+
+    DataSet string_data_set = {
+            {{VARCHAR("{\"k1\":\"v1\", \"k2\":\"v2\"}"), VARCHAR("$.k1")}, VARCHAR("v1")},
+            {{VARCHAR("{\"k1\":true, \"k2\":-3}"), VARCHAR("$.k1")}, VARCHAR("true")},
+            {{VARCHAR("{\"k1\":true, \"k2\":-3}"), VARCHAR("$.k2")}, VARCHAR("-3")},
+            {{VARCHAR("{\"k1\":{\"k2\": [1, 2.5]}}"), VARCHAR("$.k1")},
+             VARCHAR("{\"k2\":[1,2.5]}")},
+            {{VARCHAR("[{\"k1\":\"v1\"}, {\"k2\":\"v2\"}, {\"k1\":\"v3\"}]"),
+              VARCHAR("$.k1")},
+             VARCHAR("[\"v1\",\"v3\"]")},
+            {{VARCHAR("{\"k1\":[\"e1\", \"e2\"]}"), VARCHAR("$.k1[*]")},
+             VARCHAR("[\"e1\",\"e2\"]")},
+            {{VARCHAR("{\"k1\":null}"), VARCHAR("$.k1")}, Null()}};
+    for (const auto& line : string_data_set) {
+        check_function<DataTypeString, true>("get_json_string", input_types, {line});
+    }
+}
+
+static std::string JSONB(const std::string& json) {
+    std::string jsonb;
+    EXPECT_TRUE(JsonbValue::encode(json.data(), json.size(), &jsonb));
+    return jsonb;
+}
+
+TEST(FunctionJsonTEST, JsonbParseTest) {
+    InputTypeSet input_types = {TypeIndex::String};
+    DataSet data_set = {{{VARCHAR("{\"k1\":1}")}, VARCHAR(JSONB("{\"k1\":1}"))},
+                        {{VARCHAR("{\"k1\":")}, Null()},
+                        {{Null()}, Null()}};
+    check_function<DataTypeString, true>("jsonb_parse", input_types, data_set);
+
+    data_set = {{{VARCHAR(JSONB("{\"k1\": [1, 2.5, \"v\"], \"k2\": null}"))},
+                 VARCHAR("{\"k1\":[1,2.5,\"v\"],\"k2\":null}")},
+                {{VARCHAR("{\"k1\":1}")}, Null()}};
+    check_function<DataTypeString, true>("jsonb_to_json", input_types, data_set);
+}
+
+TEST(FunctionJsonTEST, GetJsonbTest) {
+    std::vector<InputTypeSet> input_types_set = {
+            {TypeIndex::String, TypeIndex::String},
+            {TypeIndex::String, Consted {TypeIndex::String}}};
+    for (const auto& input_types : input_types_set) {
+        DataSet int_data_set = {
+                {{VARCHAR(JSONB("{\"k1\":1, \"k2\":2}")), VARCHAR("$.k1")}, INT(1)},
+                {{VARCHAR(JSONB("{\"k1\":{\"k2\":[1, 2]}}")), VARCHAR("$.k1.k2[1]")}, INT(2)},
+                {{VARCHAR(JSONB("{\"k1\":{\"k2\":[1, 2]}}")), VARCHAR("$.k1.k2[2]")}, Null()},
+                {{VARCHAR(JSONB("{\"k1\":1.5}")), VARCHAR("$.k1")}, Null()},
+                {{VARCHAR(JSONB("{\"k1\":3000000000}")), VARCHAR("$.k1")}, Null()},
+                {{VARCHAR("{\"k1\":1}"), VARCHAR("$.k1")}, Null()},
+                {{Null(), VARCHAR("$.k1")}, Null()}};
+        for (const auto& line : int_data_set) {
+            check_function<DataTypeInt32, true>("get_jsonb_int", input_types, {line});
+        }
+
+        DataSet double_data_set = {
+                {{VARCHAR(JSONB("{\"k1\":1.3, \"k2\":2}")), VARCHAR("$.k1")}, DOUBLE(1.3)},
+                {{VARCHAR(JSONB("{\"k1\":1.3, \"k2\":2}")), VARCHAR("$.k2")}, DOUBLE(2)},
+                {{VARCHAR(JSONB("{\"k1\":\"v1\"}")), VARCHAR("$.k1")}, Null()}};
+        for (const auto& line : double_data_set) {
+            check_function<DataTypeFloat64, true>("get_jsonb_double", input_types, {line});
+        }
+
+        DataSet string_data_set = {
+                {{VARCHAR(JSONB("{\"k1\":\"v1\", \"k2\":\"v2\"}")), VARCHAR("$.k2")},
+                 VARCHAR("v2")},
+                {{VARCHAR(JSONB("{\"k1\":true, \"k2\":-3}")), VARCHAR("$.k2")}, VARCHAR("-3")},
+                {{VARCHAR(JSONB("{\"k1\":{\"k2\": [1, 2.5]}}")), VARCHAR("$.k1")},
+                 VARCHAR("{\"k2\":[1,2.5]}")},
+                {{VARCHAR(JSONB("[{\"k1\":\"v1\"}, {\"k2\":\"v2\"}, {\"k1\":\"v3\"}]")),
+                  VARCHAR("$.k1")},
+                 VARCHAR("[\"v1\",\"v3\"]")},
+                {{VARCHAR(JSONB("{\"k1\":[\"e1\", \"e2\"]}")), VARCHAR("$.k1[*]")},
+                 VARCHAR("[\"e1\",\"e2\"]")},
+                {{VARCHAR(JSONB("{\"k1\":null}")), VARCHAR("$.k1")}, Null()}};
+        for (const auto& line : string_data_set) {
+            check_function<DataTypeString, true>("get_jsonb_string", input_types, {line});
+        }
+    }
+}
+
 } // namespace doris::vectorized
@@ -22,6 +22,8 @@
 #include "function_test_util.h"
 #include "util/cpu_info.h"
 #include "vec/core/types.h"
+#include "vec/functions/like.h"
+#include "vec/functions/multi_regex_matcher.h"
 
 namespace doris::vectorized {
 
@@ -183,4 +185,22 @@ TEST(FunctionLikeTest, regexp_replace) {
     check_function<DataTypeString, true>(func_name, input_types, data_set);
 }
 
+TEST(FunctionLikeTest, multi_regex_matcher) {
+    std::vector<std::string> regexes = {FunctionLike::like_pattern_to_regex("a_c%"),
+                                        FunctionLike::like_pattern_to_regex("%x\\%"), "[0-9]+"};
+    std::shared_ptr<const MultiRegexMatcher> matcher;
+    EXPECT_TRUE(MultiRegexMatcher::create(regexes, &matcher).ok());
+
+    auto values = ColumnString::create();
+    for (const auto& value : {"abcd", "zabc", "x%", "x", "a1", "", "a\nc"}) {
+        values->insert_data(value, strlen(value));
+    }
+    ColumnUInt8::Container result(values->size());
+    EXPECT_TRUE(matcher->match_rows(*values, result).ok());
+    EXPECT_EQ(std::vector<uint8_t>(result.begin(), result.end()),
+              std::vector<uint8_t>({1, 0, 1, 0, 1, 0, 1}));
+
+    EXPECT_FALSE(MultiRegexMatcher::create({"a(b"}, &matcher).ok());
+}
+
 } // namespace doris::vectorized
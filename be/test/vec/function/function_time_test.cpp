@@ -26,7 +26,9 @@
 #include "function_test_util.h"
 #include "runtime/row_batch.h"
 #include "runtime/tuple_row.h"
+#include "util/timezone_utils.h"
 #include "vec/functions/simple_function_factory.h"
+#include "vec/runtime/vdatetime_value.h"
 
 namespace doris::vectorized {
 using namespace ut_type;
@@ -174,9 +176,73 @@ TEST(VTimestampFunctionsTest, from_unix_test) {
 
     InputTypeSet input_types = {TypeIndex::Int32};
 
-    DataSet data_set = {{{1565080737}, std::string("2019-08-06 16:38:57")}, {{-123}, Null()}};
+    DataSet data_set = {{{1565080737}, std::string("2019-08-06 16:38:57")},
+                        {{1565080738}, std::string("2019-08-06 16:38:58")},
+                        {{0}, std::string("1970-01-01 08:00:00")},
+                        {{-123}, Null()}};
 
     check_function<DataTypeString, true>(func_name, input_types, data_set);
+
+    InputTypeSet format_types = {TypeIndex::Int32, Consted {TypeIndex::String}};
+    {
+        DataSet data_set = {{{1565080737, std::string("%Y%m%d")}, std::string("20190806")}};
+        check_function<DataTypeString, true>(func_name, format_types, data_set);
+    }
+    {
+        DataSet data_set = {
+                {{1565080737, std::string("%a %b %D %r")}, std::string("Tue Aug 6th 04:38:57 PM")}};
+        check_function<DataTypeString, true>(func_name, format_types, data_set);
+    }
+    {
+        DataSet data_set = {{{1565080737, std::string(129, 'a')}, Null()}};
+        check_function<DataTypeString, true>(func_name, format_types, data_set);
+    }
+}
+
+TEST(VTimestampFunctionsTest, compiled_date_format_test) {
+    const std::vector<std::string> formats = {
+            "%Y-%m-%d %H:%i:%s",    "%W %M %Y",          "%D %y %a %d %m %b %j",
+            "%H %k %I %r %T %S %w", "%X %V %x %v %u %U", "%c %e %f %h %l %p",
+            "%%%d%",                "abc"};
+    const std::vector<std::string> values = {"2009-10-04 22:23:00", "0001-01-01 00:00:00",
+                                             "9999-12-31 23:59:59", "2020-02-29 12:00:09"};
+    for (const auto& format : formats) {
+        VecDateTimeFormat compiled(format);
+        for (const auto& value : values) {
+            VecDateTimeValue dt;
+            ASSERT_TRUE(dt.from_date_str(value.data(), value.size()));
+            char expected[128];
+            ASSERT_TRUE(dt.to_format_string(format.data(), format.size(), expected));
+            std::vector<char> buf(compiled.max_size());
+            char* end = compiled.format(dt, buf.data());
+            ASSERT_NE(end, nullptr);
+            EXPECT_EQ(std::string(buf.data(), end), std::string(expected)) << format;
+        }
+    }
+
+    // a datetime without month can't be formatted by %M
+    VecDateTimeValue dt;
+    dt.set_time(2020, 0, 1, 0, 0, 0);
+    char buf[16];
+    EXPECT_EQ(VecDateTimeFormat("%M").format(dt, buf), nullptr);
+}
+
+TEST(VTimestampFunctionsTest, timezone_offset_cache_test) {
+    cctz::time_zone ctz;
+    ASSERT_TRUE(TimezoneUtils::find_cctz_time_zone("America/Los_Angeles", ctz));
+    TimezoneOffsetCache offsets(ctz);
+    // around the daylight saving time transitions of 2021 (03-14 and 11-07)
+    for (int64_t begin : {1615712400L - 7200, 1636275600L - 7200}) {
+        for (int64_t timestamp = begin; timestamp < begin + 14400; timestamp += 60) {
+            const auto tp = cctz::time_point<cctz::seconds>() + cctz::seconds(timestamp);
+            EXPECT_EQ(offsets.offset(timestamp), ctz.lookup(tp).offset) << timestamp;
+        }
+    }
+    // look up backwards
+    for (int64_t timestamp = 1615712400L + 7200; timestamp > 1615712400L - 7200; timestamp -= 60) {
+        const auto tp = cctz::time_point<cctz::seconds>() + cctz::seconds(timestamp);
+        EXPECT_EQ(offsets.offset(timestamp), ctz.lookup(tp).offset) << timestamp;
+    }
 }
 
 TEST(VTimestampFunctionsTest, timediff_test) {
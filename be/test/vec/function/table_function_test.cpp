@@ -41,6 +41,38 @@ protected:
         _column_ids.clear();
     }
 
+    // Expand the rows of `input_set` by get_values with at most `max_step` values per call, and
+    // check them against `output_set`.
+    void check_get_values(TableFunction* fn, const InputTypeSet& input_types,
+                          const InputDataSet& input_set, const InputTypeSet& output_types,
+                          const InputDataSet& output_set, int64_t max_step) {
+        std::unique_ptr<Block> input_block(create_block_from_inputset(input_types, input_set));
+        std::unique_ptr<Block> expect_block(create_block_from_inputset(output_types, output_set));
+        ASSERT_TRUE(input_block != nullptr && expect_block != nullptr);
+
+        auto column = expect_block->get_by_position(0).type->create_column();
+        ASSERT_TRUE(fn->process_init(input_block.get()).ok());
+        for (size_t row = 0; row < input_block->rows(); ++row) {
+            ASSERT_TRUE(fn->process_row(row).ok());
+            if (!fn->is_outer() && fn->current_empty()) {
+                continue;
+            }
+            while (!fn->eos()) {
+                int64_t step = 0;
+                ASSERT_TRUE(fn->get_values(column.get(), max_step, &step).ok());
+                EXPECT_GT(step, 0);
+                EXPECT_LE(step, max_step);
+            }
+        }
+        ASSERT_TRUE(fn->process_close().ok());
+
+        auto expect_column = expect_block->get_by_position(0).column;
+        ASSERT_EQ(expect_column->size(), column->size());
+        for (size_t row = 0; row < column->size(); ++row) {
+            EXPECT_EQ(expect_column->compare_at(row, row, *column, 0), 0);
+        }
+    }
+
     void init_expr_context(int child_num) {
         clear();
 
@@ -165,4 +197,38 @@ TEST_F(TableFunctionTest, vexplode_split) {
     }
 }
 
+TEST_F(TableFunctionTest, get_values) {
+    init_expr_context(1);
+    VExplodeTableFunction explode_outer;
+    explode_outer.set_outer();
+    explode_outer.set_vexpr_context(_ctx.get());
+    {
+        InputTypeSet input_types = {TypeIndex::Array, TypeIndex::Int32};
+        Array vec = {Int32(1), Int32(2), Int32(3), Int32(4), Int32(5)};
+        InputDataSet input_set = {{vec}, {Null()}, {Array()}, {Array {Int32(6)}}};
+
+        InputTypeSet output_types = {TypeIndex::Int32};
+        InputDataSet output_set = {{Int32(1)}, {Int32(2)}, {Int32(3)}, {Int32(4)},
+                                   {Int32(5)}, {Null()},   {Null()},   {Int32(6)}};
+
+        check_get_values(&explode_outer, input_types, input_set, output_types, output_set, 2);
+    }
+
+    init_expr_context(2);
+    VExplodeSplitTableFunction explode_split;
+    explode_split.set_vexpr_context(_ctx.get());
+    {
+        InputTypeSet input_types = {TypeIndex::String, TypeIndex::String};
+        InputDataSet input_set = {{std::string("a,b,c"), std::string(",")},
+                                  {Null(), Null()},
+                                  {std::string("d,e"), std::string(",")}};
+
+        InputTypeSet output_types = {TypeIndex::String};
+        InputDataSet output_set = {{std::string("a")}, {std::string("b")}, {std::string("c")},
+                                   {std::string("d")}, {std::string("e")}};
+
+        check_get_values(&explode_split, input_types, input_set, output_types, output_set, 2);
+    }
+}
+
 } // namespace doris::vectorized
@@ -0,0 +1,104 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/olap/block_pre_aggregator.h"
+
+#include <gtest/gtest.h>
+
+#include <tuple>
+#include <vector>
+
+#include "vec/aggregate_functions/aggregate_function_reader.h"
+#include "vec/aggregate_functions/aggregate_function_simple_factory.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris::vectorized {
+
+// the rows (k, v, s) of the block in order, grouped by k
+static Block create_block(const std::vector<std::tuple<int32_t, int64_t, int32_t>>& rows) {
+    auto k = ColumnInt32::create();
+    auto v = ColumnInt64::create();
+    auto s = ColumnInt32::create();
+    for (const auto& [k_value, v_value, s_value] : rows) {
+        k->insert_value(k_value);
+        v->insert_value(v_value);
+        s->insert_value(s_value);
+    }
+    Block block;
+    block.insert(ColumnWithTypeAndName(std::move(k), std::make_shared<DataTypeInt32>(), "k"));
+    block.insert(ColumnWithTypeAndName(std::move(v), std::make_shared<DataTypeInt64>(), "v"));
+    block.insert(ColumnWithTypeAndName(std::move(s), std::make_shared<DataTypeInt32>(), "s"));
+    return block;
+}
+
+static std::vector<std::tuple<int32_t, int64_t, int32_t>> get_rows(const Block& block) {
+    std::vector<std::tuple<int32_t, int64_t, int32_t>> rows;
+    for (size_t i = 0; i < block.rows(); ++i) {
+        rows.emplace_back(block.get_by_position(0).column->get_int(i),
+                          block.get_by_position(1).column->get_int(i),
+                          block.get_by_position(2).column->get_int(i));
+    }
+    return rows;
+}
+
+static std::unique_ptr<BlockPreAggregator> create_pre_aggregator(const std::string& v_agg_name) {
+    std::vector<AggregateFunctionPtr> agg_functions(3);
+    agg_functions[1] = AggregateFunctionSimpleFactory::instance().get(
+            v_agg_name + AGG_READER_SUFFIX, {std::make_shared<DataTypeInt64>()}, {}, false);
+    EXPECT_NE(nullptr, agg_functions[1]);
+    return std::make_unique<BlockPreAggregator>(std::vector<int> {0}, std::move(agg_functions));
+}
+
+TEST(BlockPreAggregatorTest, Sum) {
+    auto pre_aggregator = create_pre_aggregator("sum");
+
+    // the group of k = 2 is open until the next block
+    Block block = create_block({{1, 10, 100}, {1, 20, 101}, {2, 30, 102}});
+    pre_aggregator->aggregate(&block, false);
+    std::vector<std::tuple<int32_t, int64_t, int32_t>> expected = {{1, 30, 100}};
+    EXPECT_EQ(expected, get_rows(block));
+
+    block = create_block({{2, 40, 103}, {2, 50, 104}, {3, 60, 105}, {4, 70, 106}});
+    pre_aggregator->aggregate(&block, false);
+    expected = {{2, 120, 102}, {3, 60, 105}};
+    EXPECT_EQ(expected, get_rows(block));
+
+    // no row closes the group
+    block = create_block({{4, 80, 107}});
+    pre_aggregator->aggregate(&block, false);
+    EXPECT_EQ(0, block.rows());
+
+    block = create_block({});
+    pre_aggregator->aggregate(&block, true);
+    expected = {{4, 150, 106}};
+    EXPECT_EQ(expected, get_rows(block));
+    EXPECT_EQ(4, pre_aggregator->merged_rows());
+}
+
+TEST(BlockPreAggregatorTest, Max) {
+    auto pre_aggregator = create_pre_aggregator("max");
+
+    Block block = create_block({{1, 10, 100}, {1, 30, 101}, {1, 20, 102}, {2, 5, 103}});
+    pre_aggregator->aggregate(&block, true);
+    std::vector<std::tuple<int32_t, int64_t, int32_t>> expected = {{1, 30, 100}, {2, 5, 103}};
+    EXPECT_EQ(expected, get_rows(block));
+    EXPECT_EQ(2, pre_aggregator->merged_rows());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,100 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+
+#include "vec/olap/block_zorder_compare.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "olap/schema.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_number.h"
+
+namespace doris {
+
+namespace vectorized {
+
+static Schema create_schema(bool is_nullable) {
+    std::vector<TabletColumn> col_schemas;
+    col_schemas.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, is_nullable);
+    col_schemas.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, is_nullable);
+    return Schema(col_schemas, 2);
+}
+
+// the rows (x, y) of the block in order
+static Block create_block(const std::vector<std::pair<int32_t, int32_t>>& rows) {
+    auto x = ColumnInt32::create();
+    auto y = ColumnInt32::create();
+    for (const auto& [x_value, y_value] : rows) {
+        x->insert_value(x_value);
+        y->insert_value(y_value);
+    }
+    auto type = std::make_shared<DataTypeInt32>();
+    Block block;
+    block.insert(ColumnWithTypeAndName(std::move(x), type, "x"));
+    block.insert(ColumnWithTypeAndName(std::move(y), type, "y"));
+    return block;
+}
+
+TEST(BlockZOrderCompareTest, Int) {
+    Schema schema = create_schema(false);
+    BlockZOrderComparator comparator(schema, 2);
+
+    // the bits of x and y are interleaved, and the bit of x is more significant at each level
+    std::vector<std::pair<int32_t, int32_t>> rows = {{-1, 3}, {0, 0}, {0, 1}, {1, 0}, {1, 1},
+                                                     {0, 2}, {0, 3}, {2, 0}, {3, 3}};
+    Block block = create_block(rows);
+    for (size_t i = 0; i < rows.size(); ++i) {
+        EXPECT_EQ(0, comparator.compare_at(i, i, block, block));
+        for (size_t j = i + 1; j < rows.size(); ++j) {
+            EXPECT_EQ(-1, comparator.compare_at(i, j, block, block)) << i << " vs " << j;
+            EXPECT_EQ(1, comparator.compare_at(j, i, block, block)) << j << " vs " << i;
+        }
+    }
+
+    MutableBlock mutable_block = MutableBlock::build_mutable_block(&block);
+    EXPECT_EQ(-1, comparator.compare_at(1, 5, mutable_block));
+    EXPECT_EQ(1, comparator.compare_at(8, 0, mutable_block));
+}
+
+TEST(BlockZOrderCompareTest, Nullable) {
+    Schema schema = create_schema(true);
+    BlockZOrderComparator comparator(schema, 2);
+
+    auto type = make_nullable(std::make_shared<DataTypeInt32>());
+    Block block;
+    for (const char* name : {"x", "y"}) {
+        auto column = type->create_column();
+        column->insert_default();
+        column->insert(Field(Int64(-1)));
+        column->insert(Field(Int64(0)));
+        block.insert(ColumnWithTypeAndName(std::move(column), type, name));
+    }
+
+    // null is less than all values
+    EXPECT_EQ(-1, comparator.compare_at(0, 1, block, block));
+    EXPECT_EQ(-1, comparator.compare_at(1, 2, block, block));
+    EXPECT_EQ(0, comparator.compare_at(0, 0, block, block));
+}
+
+} // namespace vectorized
+
+} // namespace doris
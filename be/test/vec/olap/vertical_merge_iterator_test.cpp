@@ -0,0 +1,174 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/olap/vertical_merge_iterator.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "olap/olap_common.h"
+#include "olap/schema.h"
+#include "vec/olap/vgeneric_iterators.h"
+
+namespace doris {
+
+namespace vectorized {
+
+static Schema create_schema() {
+    std::vector<TabletColumn> col_schemas;
+    col_schemas.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_SMALLINT, true);
+    // c2: int
+    col_schemas.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_INT, true);
+    // c3: big int
+    col_schemas.emplace_back(OLAP_FIELD_AGGREGATION_NONE, OLAP_FIELD_TYPE_BIGINT, true);
+
+    Schema schema(col_schemas, 2);
+    return schema;
+}
+
+static void create_block(Schema& schema, vectorized::Block& block) {
+    for (auto& column_desc : schema.columns()) {
+        EXPECT_TRUE(column_desc);
+        auto data_type = Schema::get_data_type_ptr(*column_desc);
+        EXPECT_NE(data_type, nullptr);
+        auto column = data_type->create_column();
+        vectorized::ColumnWithTypeAndName ctn(std::move(column), data_type, column_desc->name());
+        block.insert(ctn);
+    }
+}
+
+// the input iterators are inited by the rowset readers in compaction
+static std::vector<RowwiseIterator*> create_inputs(const Schema& schema, size_t num_inputs,
+                                                   size_t num_rows) {
+    std::vector<RowwiseIterator*> inputs;
+    StorageReadOptions opts;
+    for (size_t i = 0; i < num_inputs; ++i) {
+        auto iter = vectorized::new_auto_increment_iterator(schema, num_rows);
+        EXPECT_TRUE(iter->init(opts).ok());
+        inputs.push_back(iter);
+    }
+    return inputs;
+}
+
+static size_t read_all(RowwiseIterator* iter, Block* block) {
+    Status st;
+    do {
+        st = iter->next_batch(block);
+    } while (st.ok());
+    EXPECT_TRUE(st.is_end_of_file());
+    return block->rows();
+}
+
+TEST(VerticalMergeIteratorTest, RowSourcesBuffer) {
+    RowSourcesBuffer buffer;
+    buffer.append(RowSource(1, false));
+    buffer.append(RowSource(1, false));
+    buffer.append(RowSource(1, true));
+    buffer.append(RowSource(RowSource::MAX_SOURCE_NUM, false));
+    EXPECT_EQ(4, buffer.total_size());
+
+    buffer.seek_to_begin();
+    EXPECT_EQ(2, buffer.same_source_count(10));
+    EXPECT_EQ(1, buffer.same_source_count(1));
+    buffer.advance(2);
+    EXPECT_EQ(1, buffer.current().get_source_num());
+    EXPECT_TRUE(buffer.current().agg_flag());
+    EXPECT_EQ(1, buffer.same_source_count(10));
+    buffer.advance();
+    EXPECT_EQ(RowSource::MAX_SOURCE_NUM, buffer.current().get_source_num());
+    EXPECT_FALSE(buffer.current().agg_flag());
+    buffer.advance();
+    EXPECT_FALSE(buffer.has_remaining());
+}
+
+TEST(VerticalMergeIteratorTest, DupKeys) {
+    auto schema = create_schema();
+    RowSourcesBuffer row_sources;
+    StorageReadOptions opts;
+    opts.block_row_max = 64;
+
+    VerticalHeapMergeIterator key_iter(create_inputs(schema, 3, 100), 2, -1, false,
+                                       &row_sources);
+    EXPECT_TRUE(key_iter.init(opts).ok());
+    Block key_block;
+    create_block(schema, key_block);
+    EXPECT_EQ(300, read_all(&key_iter, &key_block));
+    EXPECT_EQ(0, key_iter.merged_rows());
+    EXPECT_EQ(300, row_sources.total_size());
+
+    // the rows of the same key are ordered by the input order descendingly
+    row_sources.seek_to_begin();
+    for (size_t i = 0; i < 300; ++i) {
+        EXPECT_EQ(2 - i % 3, (size_t)row_sources.current().get_source_num());
+        EXPECT_FALSE(row_sources.current().agg_flag());
+        row_sources.advance();
+    }
+
+    row_sources.seek_to_begin();
+    VerticalMaskMergeIterator value_iter(create_inputs(schema, 3, 100), &row_sources);
+    EXPECT_TRUE(value_iter.init(opts).ok());
+    Block value_block;
+    create_block(schema, value_block);
+    EXPECT_EQ(300, read_all(&value_iter, &value_block));
+    auto c2 = value_block.get_by_position(2).column;
+    for (size_t i = 0; i < 300; ++i) {
+        EXPECT_EQ(int64_t(i / 3 + 2), (*c2)[i].get<int64_t>());
+    }
+}
+
+TEST(VerticalMergeIteratorTest, UniqueKeys) {
+    auto schema = create_schema();
+    RowSourcesBuffer row_sources;
+    StorageReadOptions opts;
+    opts.block_row_max = 64;
+
+    VerticalHeapMergeIterator key_iter(create_inputs(schema, 2, 100), 2, -1, true,
+                                       &row_sources);
+    EXPECT_TRUE(key_iter.init(opts).ok());
+    Block key_block;
+    create_block(schema, key_block);
+    EXPECT_EQ(100, read_all(&key_iter, &key_block));
+    EXPECT_EQ(100, key_iter.merged_rows());
+    EXPECT_EQ(200, row_sources.total_size());
+
+    // only the newest version of a key is output
+    row_sources.seek_to_begin();
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(1, row_sources.current().get_source_num());
+        EXPECT_FALSE(row_sources.current().agg_flag());
+        row_sources.advance();
+        EXPECT_EQ(0, row_sources.current().get_source_num());
+        EXPECT_TRUE(row_sources.current().agg_flag());
+        row_sources.advance();
+    }
+
+    row_sources.seek_to_begin();
+    VerticalMaskMergeIterator value_iter(create_inputs(schema, 2, 100), &row_sources);
+    EXPECT_TRUE(value_iter.init(opts).ok());
+    Block value_block;
+    create_block(schema, value_block);
+    EXPECT_EQ(100, read_all(&value_iter, &value_block));
+    auto c0 = value_block.get_by_position(0).column;
+    for (size_t i = 0; i < 100; ++i) {
+        EXPECT_EQ(int64_t(i), (*c0)[i].get<int64_t>());
+    }
+}
+
+} // namespace vectorized
+
+} // namespace doris
@@ -15,12 +15,17 @@
 // specific language governing permissions and limitations
 // under the License.
 
+#include <chrono>
+#include <thread>
+
+#include "common/config.h"
 #include "common/object_pool.h"
 #include "gen_cpp/internal_service.pb.h"
 #include "google/protobuf/descriptor.h"
 #include "google/protobuf/service.h"
 #include "gtest/gtest.h"
 #include "runtime/exec_env.h"
+#include "service/backend_options.h"
 #include "service/brpc.h"
 #include "testutil/desc_tbl_builder.h"
 #include "util/proto_util.h"
@@ -51,6 +56,19 @@ public:
         }
     }
 
+    void transmit_blocks(::google::protobuf::RpcController* controller,
+                         const ::doris::PTransmitBlocksParams* request,
+                         ::doris::PTransmitDataResult* response,
+                         ::google::protobuf::Closure* done) {
+        Status st;
+        st.to_protobuf(response->mutable_status());
+        st = stream_mgr->transmit_blocks(request, &done);
+        if (done != nullptr) {
+            st.to_protobuf(response->mutable_status());
+            done->Run();
+        }
+    }
+
 private:
     VDataStreamMgr* stream_mgr;
 };
@@ -66,8 +84,13 @@ public:
         auto call_id = ((brpc::Controller*)controller)->call_id();
 
         bthread_id_lock_and_reset_range(call_id, NULL, 2 + 3);
-        _service->transmit_block(controller, (PTransmitDataParams*)request,
-                                 (PTransmitDataResult*)response, done);
+        if (method->name() == "transmit_blocks") {
+            _service->transmit_blocks(controller, (PTransmitBlocksParams*)request,
+                                      (PTransmitDataResult*)response, done);
+        } else {
+            _service->transmit_block(controller, (PTransmitDataParams*)request,
+                                     (PTransmitDataResult*)response, done);
+        }
         // brpc::StartCancel(call_id);
         // LOG(INFO) << bthread_id_cancel(call_id);
         // void * data = nullptr;
@@ -183,4 +206,309 @@ TEST_F(VDataStreamTest, BasicTest) {
     sender.close(&runtime_stat, exec_status);
     recv->close();
 }
+
+TEST_F(VDataStreamTest, MultiplexTest) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    auto tuple_desc = const_cast<doris::TupleDescriptor*>(desc_tbl->get_tuple_descriptor(0));
+    doris::RowDescriptor row_desc(tuple_desc, false);
+
+    doris::RuntimeState runtime_stat(doris::TUniqueId(), doris::TQueryOptions(),
+                                     doris::TQueryGlobals(), nullptr);
+    runtime_stat.init_instance_mem_tracker();
+    runtime_stat.set_desc_tbl(desc_tbl);
+    runtime_stat.set_be_number(1);
+    runtime_stat._exec_env = _object_pool.add(new ExecEnv);
+
+    LocalMockBackendService* mock_service = new LocalMockBackendService;
+    mock_service->stream_mgr = &_instance;
+    MockChannel* channel = new MockChannel(std::move(mock_service));
+    runtime_stat._exec_env->_internal_client_cache =
+            _object_pool.add(new MockBrpcClientCache<PBackendService_Stub>(std::move(channel)));
+    runtime_stat._exec_env->_vstream_mgr = &_instance;
+
+    TUniqueId uid;
+    PlanNodeId nid = 1;
+    int num_senders = 2;
+    RuntimeProfile profile("profile");
+    std::shared_ptr<QueryStatisticsRecvr> statistics = std::make_shared<QueryStatisticsRecvr>();
+    auto recv = _instance.create_recvr(&runtime_stat, row_desc, uid, nid, num_senders,
+                                       1024 * 1024, &profile, false, statistics);
+
+    TDataSink tsink;
+    tsink.stream_sink.output_partition.type = TPartitionType::UNPARTITIONED;
+    tsink.stream_sink.dest_node_id = 1;
+    std::vector<TPlanFragmentDestination> dests;
+    {
+        TPlanFragmentDestination dest;
+        TNetworkAddress addr;
+        addr.__set_hostname("127.0.0.1");
+        addr.__set_port(8888);
+        dest.__set_brpc_server(addr);
+        dest.__set_fragment_instance_id(uid);
+        dest.__set_server(addr);
+        dests.push_back(dest);
+    }
+
+    // the two senders share the multiplexer of the host
+    config::enable_vec_exchange_multiplex = true;
+    std::vector<std::unique_ptr<VDataStreamSender>> senders;
+    for (int sender_id = 0; sender_id < num_senders; ++sender_id) {
+        senders.emplace_back(new VDataStreamSender(&_object_pool, sender_id, row_desc,
+                                                   tsink.stream_sink, dests, 1024 * 1024, false));
+        senders.back()->set_query_statistics(std::make_shared<QueryStatistics>());
+        senders.back()->init(tsink);
+        senders.back()->prepare(&runtime_stat);
+        senders.back()->open(&runtime_stat);
+    }
+    config::enable_vec_exchange_multiplex = false;
+
+    for (auto& sender : senders) {
+        auto vec = vectorized::ColumnVector<Int32>::create();
+        for (int i = 0; i < 1024; ++i) {
+            vec->get_data().push_back(i);
+        }
+        vectorized::DataTypePtr data_type(std::make_shared<vectorized::DataTypeInt32>());
+        vectorized::Block block({{vec->get_ptr(), data_type, "test_int"}});
+        EXPECT_TRUE(sender->send(&runtime_stat, &block).ok());
+    }
+
+    size_t rows = 0;
+    for (int i = 0; i < num_senders; ++i) {
+        Block block;
+        bool eos = false;
+        recv->get_next(&block, &eos);
+        rows += block.rows();
+    }
+    EXPECT_EQ(rows, 2048);
+
+    Status exec_status;
+    for (auto& sender : senders) {
+        sender->close(&runtime_stat, exec_status);
+    }
+    recv->close();
+    runtime_stat._exec_env->_vstream_mgr = nullptr;
+}
+
+static ColumnPtr int_column(int rows) {
+    auto vec = vectorized::ColumnVector<Int32>::create();
+    for (int i = 0; i < rows; ++i) {
+        vec->get_data().push_back(i);
+    }
+    return vec;
+}
+
+TEST_F(VDataStreamTest, LocalMoveTest) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    auto tuple_desc = const_cast<doris::TupleDescriptor*>(desc_tbl->get_tuple_descriptor(0));
+    doris::RowDescriptor row_desc(tuple_desc, false);
+
+    doris::RuntimeState runtime_stat(doris::TUniqueId(), doris::TQueryOptions(),
+                                     doris::TQueryGlobals(), nullptr);
+    runtime_stat.init_instance_mem_tracker();
+    runtime_stat.set_desc_tbl(desc_tbl);
+    runtime_stat.set_be_number(1);
+    runtime_stat._exec_env = _object_pool.add(new ExecEnv);
+
+    LocalMockBackendService* mock_service = new LocalMockBackendService;
+    mock_service->stream_mgr = &_instance;
+    MockChannel* channel = new MockChannel(std::move(mock_service));
+    runtime_stat._exec_env->_internal_client_cache =
+            _object_pool.add(new MockBrpcClientCache<PBackendService_Stub>(std::move(channel)));
+    runtime_stat._exec_env->_vstream_mgr = &_instance;
+
+    PlanNodeId nid = 1;
+    RuntimeProfile profile("profile");
+    std::shared_ptr<QueryStatisticsRecvr> statistics = std::make_shared<QueryStatisticsRecvr>();
+    std::vector<TUniqueId> uids(2);
+    std::vector<std::shared_ptr<VDataStreamRecvr>> recvrs;
+    for (size_t i = 0; i < uids.size(); ++i) {
+        uids[i].lo = i + 1;
+        recvrs.push_back(_instance.create_recvr(&runtime_stat, row_desc, uids[i], nid, 1,
+                                                1024 * 1024, &profile, false, statistics));
+    }
+    vectorized::DataTypePtr data_type(std::make_shared<vectorized::DataTypeInt32>());
+
+    // a moved column is taken as it is
+    ColumnPtr column = int_column(1024);
+    const IColumn* moved = column.get();
+    {
+        vectorized::Block block({{std::move(column), data_type, "test_int"}});
+        recvrs[0]->add_block(&block, 0, true);
+        EXPECT_EQ(0, block.columns());
+        Block received;
+        bool eos = false;
+        EXPECT_TRUE(recvrs[0]->get_next(&received, &eos).ok());
+        EXPECT_EQ(1024, received.rows());
+        EXPECT_EQ(moved, received.get_by_position(0).column.get());
+    }
+
+    // but a moved column still referred to elsewhere, or a column not moved, is copied
+    ColumnPtr shared = int_column(1024);
+    for (bool use_move : {true, false}) {
+        vectorized::Block block({{shared, data_type, "test_int"}});
+        recvrs[0]->add_block(&block, 0, use_move);
+        EXPECT_EQ(use_move ? 0 : 1, block.columns());
+        Block received;
+        bool eos = false;
+        EXPECT_TRUE(recvrs[0]->get_next(&received, &eos).ok());
+        ASSERT_EQ(1024, received.rows());
+        const IColumn* copied = received.get_by_position(0).column.get();
+        EXPECT_NE(shared.get(), copied);
+        EXPECT_EQ(1023, copied->get_int(1023));
+    }
+
+    // the sender broadcasting to the local instances copies the block for the first one and
+    // moves it to the last one
+    TDataSink tsink;
+    tsink.stream_sink.output_partition.type = TPartitionType::UNPARTITIONED;
+    tsink.stream_sink.dest_node_id = nid;
+    std::vector<TPlanFragmentDestination> dests;
+    for (const auto& uid : uids) {
+        TPlanFragmentDestination dest;
+        TNetworkAddress addr;
+        addr.__set_hostname(BackendOptions::get_localhost());
+        addr.__set_port(config::brpc_port);
+        dest.__set_brpc_server(addr);
+        dest.__set_fragment_instance_id(uid);
+        dest.__set_server(addr);
+        dests.push_back(dest);
+    }
+    VDataStreamSender sender(&_object_pool, 0, row_desc, tsink.stream_sink, dests, 1024 * 1024,
+                             false);
+    sender.set_query_statistics(std::make_shared<QueryStatistics>());
+    EXPECT_TRUE(sender.init(tsink).ok());
+    EXPECT_TRUE(sender.prepare(&runtime_stat).ok());
+    EXPECT_TRUE(sender.open(&runtime_stat).ok());
+    for (auto* sender_channel : sender._channels) {
+        EXPECT_TRUE(sender_channel->is_local());
+    }
+
+    column = int_column(1024);
+    moved = column.get();
+    vectorized::Block block({{std::move(column), data_type, "test_int"}});
+    EXPECT_TRUE(sender.send(&runtime_stat, &block).ok());
+    EXPECT_EQ(0, block.columns());
+    for (size_t i = 0; i < recvrs.size(); ++i) {
+        Block received;
+        bool eos = false;
+        EXPECT_TRUE(recvrs[i]->get_next(&received, &eos).ok());
+        ASSERT_EQ(1024, received.rows());
+        EXPECT_EQ(i == recvrs.size() - 1, moved == received.get_by_position(0).column.get());
+    }
+
+    // and the eos is sent locally too
+    Status exec_status;
+    EXPECT_TRUE(sender.close(&runtime_stat, exec_status).ok());
+    for (auto& recvr : recvrs) {
+        Block received;
+        bool eos = false;
+        EXPECT_TRUE(recvr->get_next(&received, &eos).ok());
+        EXPECT_TRUE(eos);
+        recvr->close();
+    }
+    runtime_stat._exec_env->_vstream_mgr = nullptr;
+}
+
+class MockClosure : public google::protobuf::Closure {
+public:
+    void Run() override { ran = true; }
+    bool ran = false;
+};
+
+TEST_F(VDataStreamTest, SenderCreditTest) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    auto tuple_desc = const_cast<doris::TupleDescriptor*>(desc_tbl->get_tuple_descriptor(0));
+    doris::RowDescriptor row_desc(tuple_desc, false);
+
+    doris::RuntimeState runtime_stat(doris::TUniqueId(), doris::TQueryOptions(),
+                                     doris::TQueryGlobals(), nullptr);
+    runtime_stat.init_instance_mem_tracker();
+    runtime_stat.set_desc_tbl(desc_tbl);
+    runtime_stat.set_be_number(1);
+
+    vectorized::DataTypePtr data_type(std::make_shared<vectorized::DataTypeInt32>());
+    vectorized::Block block({{int_column(1024), data_type, "test_int"}});
+    PBlock pblock;
+    size_t uncompressed_bytes = 0;
+    size_t compressed_bytes = 0;
+    std::string column_values;
+    EXPECT_TRUE(block.serialize(&pblock, &uncompressed_bytes, &compressed_bytes, &column_values,
+                                false)
+                        .ok());
+    pblock.mutable_column_values()->swap(column_values);
+    int64_t bytes = pblock.ByteSizeLong();
+
+    // a buffer of 4 blocks, so each of the 2 senders has the credits of 2 blocks
+    TUniqueId uid;
+    RuntimeProfile profile("profile");
+    std::shared_ptr<QueryStatisticsRecvr> statistics = std::make_shared<QueryStatisticsRecvr>();
+    auto recv = _instance.create_recvr(&runtime_stat, row_desc, uid, 1, 2, 4 * bytes, &profile,
+                                       false, statistics);
+
+    // the first sender goes on beyond its credits until the buffer is full
+    std::vector<MockClosure> closures(6);
+    for (int i = 0; i < 5; ++i) {
+        google::protobuf::Closure* done = &closures[i];
+        recv->add_block(pblock, 0, 1, i, &done);
+        EXPECT_EQ(i == 4, done == nullptr) << i;
+    }
+    // while the second one within its credits isn't blocked by the full buffer
+    google::protobuf::Closure* done = &closures[5];
+    recv->add_block(pblock, 0, 2, 0, &done);
+    EXPECT_NE(nullptr, done);
+
+    // the blocked sender is released once the buffer has room again
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FALSE(closures[4].ran);
+        Block received;
+        bool eos = false;
+        EXPECT_TRUE(recv->get_next(&received, &eos).ok());
+        EXPECT_EQ(1024, received.rows());
+    }
+    EXPECT_TRUE(closures[4].ran);
+    for (int i = 0; i < 6; ++i) {
+        EXPECT_EQ(i == 4, closures[i].ran) << i;
+    }
+    recv->close();
+}
+
+// The receiver stops waiting for the blocks once the state of its fragment instance is
+// cancelled, even if its stream isn't.
+TEST_F(VDataStreamTest, CancelledStateTest) {
+    doris::DescriptorTblBuilder builder(&_object_pool);
+    builder.declare_tuple() << doris::TYPE_INT;
+    doris::DescriptorTbl* desc_tbl = builder.build();
+    auto tuple_desc = const_cast<doris::TupleDescriptor*>(desc_tbl->get_tuple_descriptor(0));
+    doris::RowDescriptor row_desc(tuple_desc, false);
+
+    doris::RuntimeState runtime_stat(doris::TUniqueId(), doris::TQueryOptions(),
+                                     doris::TQueryGlobals(), nullptr);
+    runtime_stat.init_instance_mem_tracker();
+    runtime_stat.set_desc_tbl(desc_tbl);
+    runtime_stat.set_be_number(1);
+
+    TUniqueId uid;
+    RuntimeProfile profile("profile");
+    std::shared_ptr<QueryStatisticsRecvr> statistics = std::make_shared<QueryStatisticsRecvr>();
+    auto recv = _instance.create_recvr(&runtime_stat, row_desc, uid, 1, 1, 1024 * 1024, &profile,
+                                       false, statistics);
+
+    std::thread canceller([&runtime_stat]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        runtime_stat.set_is_cancelled(true);
+    });
+    Block received;
+    bool eos = false;
+    Status st = recv->get_next(&received, &eos);
+    canceller.join();
+    EXPECT_TRUE(st.is_cancelled()) << st.to_string();
+    EXPECT_FALSE(eos);
+    recv->close();
+}
 } // namespace doris::vectorized
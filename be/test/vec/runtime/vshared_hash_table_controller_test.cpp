@@ -0,0 +1,78 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/runtime/vshared_hash_table_controller.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+#include "runtime/runtime_state.h"
+#include "vec/exec/join/vhash_join_node.h"
+
+namespace doris::vectorized {
+
+TEST(SharedHashTableControllerTest, first_instance_builds) {
+    SharedHashTableController controller;
+    TUniqueId instance1;
+    instance1.lo = 1;
+    TUniqueId instance2;
+    instance2.lo = 2;
+
+    EXPECT_TRUE(controller.should_build_hash_table(instance1, 1));
+    EXPECT_FALSE(controller.should_build_hash_table(instance2, 1));
+    // the builder is chosen for every join node separately
+    EXPECT_TRUE(controller.should_build_hash_table(instance2, 2));
+    EXPECT_TRUE(controller.should_build_hash_table(instance1, 1));
+}
+
+TEST(SharedHashTableControllerTest, wait_for_hash_table) {
+    SharedHashTableController controller;
+    RuntimeState state {TQueryGlobals()};
+    auto context = std::make_shared<SharedHashTableContext>();
+    context->blocks.emplace_back();
+
+    std::thread builder([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        controller.put_hash_table(1, Status::OK(), context);
+    });
+    std::shared_ptr<SharedHashTableContext> shared;
+    EXPECT_TRUE(controller.wait_for_hash_table(&state, 1, &shared).ok());
+    builder.join();
+    EXPECT_EQ(context, shared);
+    EXPECT_EQ(1, shared->blocks.size());
+}
+
+TEST(SharedHashTableControllerTest, build_failed) {
+    SharedHashTableController controller;
+    RuntimeState state {TQueryGlobals()};
+    controller.put_hash_table(1, Status::InternalError("build failed"), nullptr);
+    std::shared_ptr<SharedHashTableContext> shared;
+    EXPECT_FALSE(controller.wait_for_hash_table(&state, 1, &shared).ok());
+    EXPECT_EQ(nullptr, shared);
+}
+
+TEST(SharedHashTableControllerTest, cancelled) {
+    SharedHashTableController controller;
+    RuntimeState state {TQueryGlobals()};
+    state.set_is_cancelled(true);
+    std::shared_ptr<SharedHashTableContext> shared;
+    EXPECT_TRUE(controller.wait_for_hash_table(&state, 1, &shared).is_cancelled());
+}
+
+} // namespace doris::vectorized
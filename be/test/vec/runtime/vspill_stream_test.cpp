@@ -0,0 +1,186 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/runtime/vspill_stream.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "env/env.h"
+#include "runtime/tmp_file_mgr.h"
+#include "util/filesystem_util.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/core/block.h"
+#include "vec/data_types/data_type_number.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+class BlockSpillStreamTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        _tmp_dirs.push_back("/tmp/vspill_stream_test");
+        FileSystemUtil::remove_paths(_tmp_dirs);
+        EXPECT_TRUE(FileSystemUtil::create_directory(_tmp_dirs[0]).ok());
+        EXPECT_TRUE(_tmp_file_mgr.init_custom(_tmp_dirs, true).ok());
+    }
+
+    void TearDown() override { FileSystemUtil::remove_paths(_tmp_dirs); }
+
+    static Block create_block(int start, int rows) {
+        auto int_column = ColumnInt32::create();
+        auto str_column = ColumnString::create();
+        for (int i = start; i < start + rows; ++i) {
+            int_column->insert_value(i);
+            std::string str = "spill_" + std::to_string(i);
+            str_column->insert_data(str.data(), str.size());
+        }
+        return Block({{std::move(int_column), std::make_shared<DataTypeInt32>(), "k1"},
+                      {std::move(str_column), std::make_shared<DataTypeString>(), "k2"}});
+    }
+
+    int count_spill_files() {
+        std::vector<std::string> files;
+        EXPECT_TRUE(Env::Default()->get_children(_tmp_file_mgr.get_tmp_dir_path(0), &files).ok());
+        return std::count_if(files.begin(), files.end(),
+                             [](const std::string& name) { return name != "." && name != ".."; });
+    }
+
+    static void write_and_read(BlockSpillStream& stream, int num_blocks) {
+        EXPECT_TRUE(stream.prepare().ok());
+        const int rows_per_block = 100;
+        for (int i = 0; i < num_blocks; ++i) {
+            EXPECT_TRUE(stream.add_block(create_block(i * rows_per_block, rows_per_block)).ok());
+        }
+        EXPECT_TRUE(stream.done_write().ok());
+        EXPECT_EQ(num_blocks, stream.num_blocks());
+
+        int read_rows = 0;
+        bool eos = false;
+        while (true) {
+            Block block;
+            EXPECT_TRUE(stream.get_next(&block, &eos).ok());
+            if (eos) {
+                break;
+            }
+            const auto& int_column = block.get_by_position(0).column;
+            for (int i = 0; i < block.rows(); ++i, ++read_rows) {
+                EXPECT_EQ(read_rows, int_column->get_int(i));
+            }
+        }
+        EXPECT_EQ(num_blocks * rows_per_block, read_rows);
+    }
+
+    std::vector<std::string> _tmp_dirs;
+    TmpFileMgr _tmp_file_mgr;
+};
+
+TEST_F(BlockSpillStreamTest, write_and_read) {
+    TUniqueId query_id;
+    BlockSpillStream stream(&_tmp_file_mgr, query_id);
+    EXPECT_TRUE(stream.prepare().ok());
+
+    const int rows_per_block = 1000;
+    const int num_blocks = 5;
+    for (int i = 0; i < num_blocks; ++i) {
+        EXPECT_TRUE(stream.add_block(create_block(i * rows_per_block, rows_per_block)).ok());
+    }
+    // empty block is ignored
+    EXPECT_TRUE(stream.add_block(Block()).ok());
+    EXPECT_TRUE(stream.done_write().ok());
+
+    EXPECT_EQ(num_blocks, stream.num_blocks());
+    EXPECT_EQ(num_blocks * rows_per_block, stream.num_rows());
+    EXPECT_GT(stream.bytes(), 0);
+
+    int read_rows = 0;
+    bool eos = false;
+    while (true) {
+        Block block;
+        EXPECT_TRUE(stream.get_next(&block, &eos).ok());
+        if (eos) {
+            break;
+        }
+        EXPECT_EQ(2, block.columns());
+        EXPECT_EQ("k1", block.get_by_position(0).name);
+        const auto& int_column = block.get_by_position(0).column;
+        const auto& str_column = block.get_by_position(1).column;
+        for (int i = 0; i < block.rows(); ++i, ++read_rows) {
+            EXPECT_EQ(read_rows, int_column->get_int(i));
+            EXPECT_EQ("spill_" + std::to_string(read_rows), str_column->get_data_at(i).to_string());
+        }
+    }
+    EXPECT_EQ(num_blocks * rows_per_block, read_rows);
+}
+
+// more blocks than the writes in flight and the blocks read ahead
+TEST_F(BlockSpillStreamTest, async_io) {
+    ASSERT_NE(nullptr, _tmp_file_mgr.io_thread_pool());
+    int32_t max_inflight_writes = config::vec_spill_max_inflight_writes;
+    int32_t read_ahead_blocks = config::vec_spill_read_ahead_blocks;
+    config::vec_spill_max_inflight_writes = 2;
+    config::vec_spill_read_ahead_blocks = 3;
+
+    TUniqueId query_id;
+    RuntimeProfile profile("spill");
+    RuntimeProfile::Counter* io_timer = ADD_TIMER(&profile, "SpillIOTime");
+    BlockSpillStream stream(&_tmp_file_mgr, query_id);
+    stream.set_io_timer(io_timer);
+    write_and_read(stream, 50);
+    EXPECT_GT(io_timer->value(), 0);
+
+    config::vec_spill_max_inflight_writes = max_inflight_writes;
+    config::vec_spill_read_ahead_blocks = read_ahead_blocks;
+}
+
+TEST_F(BlockSpillStreamTest, sync_io) {
+    int32_t io_thread_num = config::vec_spill_io_thread_num;
+    config::vec_spill_io_thread_num = 0;
+    TmpFileMgr tmp_file_mgr;
+    EXPECT_TRUE(tmp_file_mgr.init_custom(_tmp_dirs, true).ok());
+    config::vec_spill_io_thread_num = io_thread_num;
+    ASSERT_EQ(nullptr, tmp_file_mgr.io_thread_pool());
+
+    TUniqueId query_id;
+    BlockSpillStream stream(&tmp_file_mgr, query_id);
+    write_and_read(stream, 10);
+}
+
+TEST_F(BlockSpillStreamTest, zstd) {
+    TUniqueId query_id;
+    BlockSpillStream stream(&_tmp_file_mgr, query_id, segment_v2::ZSTD);
+    write_and_read(stream, 10);
+}
+
+TEST_F(BlockSpillStreamTest, file_removed_on_destroy) {
+    TUniqueId query_id;
+    {
+        BlockSpillStream stream(&_tmp_file_mgr, query_id);
+        EXPECT_TRUE(stream.prepare().ok());
+        EXPECT_TRUE(stream.add_block(create_block(0, 10)).ok());
+        EXPECT_TRUE(stream.done_write().ok());
+        EXPECT_EQ(1, count_spill_files());
+    }
+    EXPECT_EQ(0, count_spill_files());
+}
+
+} // namespace doris::vectorized
@@ -0,0 +1,80 @@
+// Licensed to the Apache Software Foundation (ASF) under one
+// or more contributor license agreements.  See the NOTICE file
+// distributed with this work for additional information
+// regarding copyright ownership.  The ASF licenses this file
+// to you under the Apache License, Version 2.0 (the
+// "License"); you may not use this file except in compliance
+// with the License.  You may obtain a copy of the License at
+//
+//   http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing,
+// software distributed under the License is distributed on an
+// "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+// KIND, either express or implied.  See the License for the
+// specific language governing permissions and limitations
+// under the License.
+
+#include "vec/sink/mysql_result_writer.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "vec/columns/column_array.h"
+#include "vec/columns/column_nullable.h"
+#include "vec/columns/column_string.h"
+#include "vec/columns/column_vector.h"
+#include "vec/data_types/data_type_nullable.h"
+#include "vec/data_types/data_type_string.h"
+
+namespace doris::vectorized {
+
+// The cells of an array column are packed in the dynamic mode of the buffer, whose length is
+// written after the buffer is reallocated by the large cells.
+TEST(VMysqlResultWriterTest, add_array_column) {
+    auto strings = ColumnString::create();
+    auto null_map = ColumnUInt8::create();
+    auto offsets = ColumnArray::ColumnOffsets::create();
+    std::vector<std::string> expected;
+    for (int i = 0; i < 300; ++i) {
+        // a cell of more than the default buffer of 4096 bytes every 50 rows
+        int num_elements = i % 50 == 0 ? 200 : i % 7;
+        std::string cell = "[";
+        for (int j = 0; j < num_elements; ++j) {
+            std::string value = std::string(j % 30, 'a' + i % 26) + std::to_string(j);
+            bool is_null = (i + j) % 11 == 0;
+            strings->insert_data(value.data(), is_null ? 0 : value.size());
+            null_map->insert_value(is_null);
+            cell += (j == 0 ? "" : ", ") + (is_null ? "NULL" : value);
+        }
+        offsets->insert_value(strings->size());
+        expected.push_back(cell + "]");
+    }
+    ColumnPtr column = ColumnArray::create(
+            ColumnNullable::create(std::move(strings), std::move(null_map)), std::move(offsets));
+    DataTypePtr nested_type = make_nullable(std::make_shared<DataTypeString>());
+
+    std::vector<VExprContext*> output_vexpr_ctxs;
+    VMysqlResultWriter writer(nullptr, output_vexpr_ctxs, nullptr);
+    MysqlColumnBuffer buf;
+    Status st = writer._add_one_column<PrimitiveType::TYPE_ARRAY, false>(column, buf, nested_type);
+    ASSERT_TRUE(st.ok()) << st.to_string();
+    ASSERT_EQ(expected.size(), buf.cell_ends.size());
+
+    const char* data = buf.buffer.buf();
+    int64_t cell_begin = 0;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        // 254, the length in 8 bytes, and the cell
+        const char* cell = data + cell_begin;
+        ASSERT_EQ(cell_begin + 9 + expected[i].size(), buf.cell_ends[i]) << "row " << i;
+        EXPECT_EQ(254, *reinterpret_cast<const uint8_t*>(cell));
+        EXPECT_EQ(expected[i].size(), *reinterpret_cast<const int64_t*>(cell + 1));
+        EXPECT_EQ(expected[i], std::string(cell + 9, expected[i].size())) << "row " << i;
+        cell_begin = buf.cell_ends[i];
+    }
+    EXPECT_EQ(cell_begin, buf.buffer.length());
+}
+
+} // namespace doris::vectorized
@@ -203,6 +203,9 @@ fi
 if [[ -z ${WITH_LZO} ]]; then
     WITH_LZO=OFF
 fi
+if [[ -z ${WITH_HYPERSCAN} ]]; then
+    WITH_HYPERSCAN=OFF
+fi
 if [[ -z ${USE_LIBCPP} ]]; then
     USE_LIBCPP=OFF
 fi
@@ -225,6 +228,7 @@ echo "Get params:
     CLEAN               -- $CLEAN
     WITH_MYSQL          -- $WITH_MYSQL
     WITH_LZO            -- $WITH_LZO
+    WITH_HYPERSCAN      -- $WITH_HYPERSCAN
     GLIBC_COMPATIBILITY -- $GLIBC_COMPATIBILITY
     USE_AVX2            -- $USE_AVX2
     USE_LIBCPP          -- $USE_LIBCPP
@@ -284,6 +288,7 @@ if [ ${BUILD_BE} -eq 1 ] ; then
             ${CMAKE_USE_CCACHE} \
             -DWITH_MYSQL=${WITH_MYSQL} \
             -DWITH_LZO=${WITH_LZO} \
+            -DWITH_HYPERSCAN=${WITH_HYPERSCAN} \
             -DUSE_LIBCPP=${USE_LIBCPP} \
             -DBUILD_META_TOOL=${BUILD_META_TOOL} \
             -DUSE_LLD=${USE_LLD} \
@@ -139,6 +139,7 @@ public class ReportHandler extends Daemon {
         Map<String, TDisk> disks = null;
         Map<Long, TTablet> tablets = null;
         long reportVersion = -1;
+        boolean isIncremental = false;
 
         ReportType reportType = ReportType.UNKNOWN;
 
@@ -163,11 +164,15 @@ public class ReportHandler extends Daemon {
             reportType = ReportType.TABLET;
         }
 
+        if (tablets != null && request.isSetIsIncremental()) {
+            isIncremental = request.isIsIncremental();
+        }
+
         if (request.isSetTabletMaxCompactionScore()) {
             backend.setTabletMaxCompactionScore(request.getTabletMaxCompactionScore());
         }
 
-        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion);
+        ReportTask reportTask = new ReportTask(beId, tasks, disks, tablets, reportVersion, isIncremental);
         try {
             putToQueue(reportTask);
         } catch (Exception e) {
@@ -213,15 +218,17 @@ public class ReportHandler extends Daemon {
         private Map<String, TDisk> disks;
         private Map<Long, TTablet> tablets;
         private long reportVersion;
+        private boolean isIncremental;
 
         public ReportTask(long beId, Map<TTaskType, Set<Long>> tasks,
                           Map<String, TDisk> disks,
-                          Map<Long, TTablet> tablets, long reportVersion) {
+                          Map<Long, TTablet> tablets, long reportVersion, boolean isIncremental) {
             this.beId = beId;
             this.tasks = tasks;
             this.disks = disks;
             this.tablets = tablets;
             this.reportVersion = reportVersion;
+            this.isIncremental = isIncremental;
         }
 
         @Override
@@ -238,16 +245,19 @@ public class ReportHandler extends Daemon {
                     LOG.warn("out of date report version {} from backend[{}]. current report version[{}]",
                             reportVersion, beId, backendReportVersion);
                 } else {
-                    ReportHandler.tabletReport(beId, tablets, reportVersion);
+                    ReportHandler.tabletReport(beId, tablets, reportVersion, isIncremental);
                 }
             }
         }
     }
 
-    private static void tabletReport(long backendId, Map<Long, TTablet> backendTablets, long backendReportVersion) {
+    // In an incremental report, backendTablets only contains the tablets changed since the last report,
+    // so the tablets missing in it are not deleted from the meta or the backend.
+    private static void tabletReport(long backendId, Map<Long, TTablet> backendTablets, long backendReportVersion,
+                                     boolean isIncremental) {
         long start = System.currentTimeMillis();
-        LOG.info("backend[{}] reports {} tablet(s). report version: {}",
-                backendId, backendTablets.size(), backendReportVersion);
+        LOG.info("backend[{}] reports {} tablet(s). report version: {}, incremental: {}",
+                backendId, backendTablets.size(), backendReportVersion, isIncremental);
 
         // storage medium map
         HashMap<Long, TStorageMedium> storageMediumMap = Config.disable_storage_medium_check ?
@@ -289,7 +299,7 @@ public class ReportHandler extends Daemon {
 
         // 3. delete (meta - be)
         // BE will automatically drop defective tablets. these tablets should also be dropped in catalog
-        if (!tabletDeleteFromMeta.isEmpty()) {
+        if (!isIncremental && !tabletDeleteFromMeta.isEmpty()) {
             deleteFromMeta(tabletDeleteFromMeta, backendId, backendReportVersion);
         }
 
@@ -62,6 +62,7 @@ import org.apache.doris.thrift.TPaloScanRange;
 import org.apache.doris.thrift.TPlanNode;
 import org.apache.doris.thrift.TPlanNodeType;
 import org.apache.doris.thrift.TPrimitiveType;
+import org.apache.doris.thrift.TPushAggOp;
 import org.apache.doris.thrift.TScanRange;
 import org.apache.doris.thrift.TScanRangeLocation;
 import org.apache.doris.thrift.TScanRangeLocations;
@@ -128,6 +129,8 @@ public class OlapScanNode extends ScanNode {
     private String reasonOfPreAggregation = null;
     private boolean canTurnOnPreAggr = true;
     private boolean forceOpenPreAgg = false;
+    // the aggregate without grouping answered from the segment metadata by BE
+    private TPushAggOp pushDownAggNoGroupingOp = null;
     private OlapTable olapTable = null;
     private long selectedTabletsNum = 0;
     private long totalTabletsNum = 0;
@@ -168,6 +171,10 @@ public class OlapScanNode extends ScanNode {
         this.canTurnOnPreAggr = canChangePreAggr;
     }
 
+    public void setPushDownAggNoGrouping(TPushAggOp pushDownAggNoGroupingOp) {
+        this.pushDownAggNoGroupingOp = pushDownAggNoGroupingOp;
+    }
+
     public void closePreAggregation(String reason) {
         setIsPreAggregation(false, reason);
         setCanTurnOnPreAggr(false);
@@ -707,6 +714,9 @@ public class OlapScanNode extends ScanNode {
             output.append(prefix).append("runtime filters: ");
             output.append(getRuntimeFilterExplainString(false));
         }
+        if (isPushDownAggNoGrouping()) {
+            output.append(prefix).append("pushAggOp=").append(pushDownAggNoGroupingOp).append("\n");
+        }
 
         output.append(prefix).append(String.format(
                 "partitions=%s/%s",
@@ -772,6 +782,16 @@ public class OlapScanNode extends ScanNode {
             msg.olap_scan_node.setSortColumn(sortColumn);
         }
         msg.olap_scan_node.setKeyType(olapTable.getKeysType().toThrift());
+        if (isPushDownAggNoGrouping()) {
+            msg.olap_scan_node.setPushDownAggTypeOpt(pushDownAggNoGroupingOp);
+        }
+    }
+
+    // The rows of the selected index must not be merged, a materialized view may be
+    // selected after the aggregate is planned.
+    private boolean isPushDownAggNoGrouping() {
+        return pushDownAggNoGroupingOp != null && selectedIndexId != -1
+                && olapTable.getKeysTypeByIndexId(selectedIndexId) == KeysType.DUP_KEYS;
     }
 
     // export some tablets
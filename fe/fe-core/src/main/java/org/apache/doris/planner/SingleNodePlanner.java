@@ -55,14 +55,17 @@ import org.apache.doris.catalog.AggregateFunction;
 import org.apache.doris.catalog.AggregateType;
 import org.apache.doris.catalog.Column;
 import org.apache.doris.catalog.FunctionSet;
+import org.apache.doris.catalog.KeysType;
 import org.apache.doris.catalog.MysqlTable;
 import org.apache.doris.catalog.OdbcTable;
 import org.apache.doris.catalog.Table;
+import org.apache.doris.catalog.Type;
 import org.apache.doris.common.AnalysisException;
 import org.apache.doris.common.FeConstants;
 import org.apache.doris.common.Pair;
 import org.apache.doris.common.Reference;
 import org.apache.doris.common.UserException;
+import org.apache.doris.thrift.TPushAggOp;
 
 import com.google.common.base.Preconditions;
 import com.google.common.base.Predicate;
@@ -1162,9 +1165,53 @@ public class SingleNodePlanner {
         }
         // add Having clause
         newRoot.assignConjuncts(analyzer);
+        pushDownAggNoGrouping(aggInfo, root);
         return newRoot;
     }
 
+    /**
+     * Let the olap scan node answer count(*), or min and max of the columns, from the metadata
+     * of the segments if the aggregation has no grouping and the scanned rows are not filtered.
+     * BE falls back to read the rows if a segment can't answer it, e.g. there are delete
+     * predicates or runtime filters.
+     */
+    private void pushDownAggNoGrouping(AggregateInfo aggInfo, PlanNode root) {
+        if (!(root instanceof OlapScanNode) || aggInfo.isDistinctAgg()
+                || !aggInfo.getGroupingExprs().isEmpty() || !root.getConjuncts().isEmpty()) {
+            return;
+        }
+        OlapScanNode scanNode = (OlapScanNode) root;
+        if (scanNode.getOlapTable().getKeysType() != KeysType.DUP_KEYS) {
+            return;
+        }
+        TPushAggOp aggOp = null;
+        for (FunctionCallExpr aggExpr : aggInfo.getAggregateExprs()) {
+            String fnName = aggExpr.getFnName().getFunction();
+            TPushAggOp op;
+            if (fnName.equalsIgnoreCase(FunctionSet.COUNT) && aggExpr.getParams().isStar()) {
+                op = TPushAggOp.COUNT;
+            } else if ((fnName.equalsIgnoreCase("MIN") || fnName.equalsIgnoreCase("MAX"))
+                    && aggExpr.getChildren().size() == 1 && aggExpr.getChild(0) instanceof SlotRef) {
+                Type type = aggExpr.getChild(0).getType();
+                if (!type.isFixedPointType() && !type.isDateType() && !type.isDecimalV2()
+                        && !type.isBoolean() && !type.isStringType()) {
+                    return;
+                }
+                op = TPushAggOp.MINMAX;
+            } else {
+                return;
+            }
+            // count(*) needs all the rows, while min and max need only two rows of a segment
+            if (aggOp != null && aggOp != op) {
+                return;
+            }
+            aggOp = op;
+        }
+        if (aggOp != null) {
+            scanNode.setPushDownAggNoGrouping(aggOp);
+        }
+    }
+
     /**
      * Returns a MergeNode that materializes the exprs of the constant selectStmt. Replaces the resultExprs of the
      * selectStmt with SlotRefs into the materialized tuple.
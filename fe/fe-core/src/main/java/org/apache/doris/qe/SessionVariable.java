@@ -164,6 +164,11 @@ public class SessionVariable implements Serializable, Writable {
 
     public static final String ENABLE_VECTORIZED_ENGINE = "enable_vectorized_engine";
 
+    public static final String ENABLE_PIPELINE_ENGINE = "enable_pipeline_engine";
+
+    public static final String ENABLE_SHARE_HASH_TABLE_FOR_BROADCAST_JOIN
+            = "enable_share_hash_table_for_broadcast_join";
+
     public static final String CPU_RESOURCE_LIMIT = "cpu_resource_limit";
     
     public static final String ENABLE_PARALLEL_OUTFILE = "enable_parallel_outfile";
@@ -409,6 +414,10 @@ public class SessionVariable implements Serializable, Writable {
     private int runtimeFilterMaxInNum = 1024;
     @VariableMgr.VarAttr(name = ENABLE_VECTORIZED_ENGINE)
     public boolean enableVectorizedEngine = false;
+    @VariableMgr.VarAttr(name = ENABLE_PIPELINE_ENGINE)
+    public boolean enablePipelineEngine = false;
+    @VariableMgr.VarAttr(name = ENABLE_SHARE_HASH_TABLE_FOR_BROADCAST_JOIN)
+    public boolean enableShareHashTableForBroadcastJoin = false;
     @VariableMgr.VarAttr(name = ENABLE_PARALLEL_OUTFILE)
     public boolean enableParallelOutfile = false;
 
@@ -816,6 +825,22 @@ public class SessionVariable implements Serializable, Writable {
         this.enableVectorizedEngine = enableVectorizedEngine;
     }
 
+    public boolean enablePipelineEngine() {
+        return enablePipelineEngine;
+    }
+
+    public void setEnablePipelineEngine(boolean enablePipelineEngine) {
+        this.enablePipelineEngine = enablePipelineEngine;
+    }
+
+    public boolean enableShareHashTableForBroadcastJoin() {
+        return enableShareHashTableForBroadcastJoin;
+    }
+
+    public void setEnableShareHashTableForBroadcastJoin(boolean enableShareHashTableForBroadcastJoin) {
+        this.enableShareHashTableForBroadcastJoin = enableShareHashTableForBroadcastJoin;
+    }
+
     public long getInsertVisibleTimeoutMs() {
         if (insertVisibleTimeoutMs < MIN_INSERT_VISIBLE_TIMEOUT_MS) {
             return MIN_INSERT_VISIBLE_TIMEOUT_MS;
@@ -922,6 +947,8 @@ public class SessionVariable implements Serializable, Writable {
         tResult.setIsReportSuccess(enableProfile);
         tResult.setCodegenLevel(codegenLevel);
         tResult.setEnableVectorizedEngine(enableVectorizedEngine);
+        tResult.setEnablePipelineEngine(enablePipelineEngine);
+        tResult.setEnableShareHashTableForBroadcastJoin(enableShareHashTableForBroadcastJoin);
         tResult.setReturnObjectDataAsBinary(returnObjectDataAsBinary);
 
         tResult.setBatchSize(batchSize);
@@ -1167,6 +1167,13 @@ visible_functions = [
         '_ZN5doris13JsonFunctions15json_path_closeEPN9doris_udf15FunctionContextENS2_18FunctionStateScopeE',
         'vec', 'ALWAYS_NULLABLE'],
 
+    # Jsonb functions, only supported by the vec engine
+    [['jsonb_parse'], 'STRING', ['STRING'], '', '', '', 'vec', 'ALWAYS_NULLABLE'],
+    [['jsonb_to_json'], 'STRING', ['STRING'], '', '', '', 'vec', 'ALWAYS_NULLABLE'],
+    [['get_jsonb_int'], 'INT', ['STRING', 'STRING'], '', '', '', 'vec', 'ALWAYS_NULLABLE'],
+    [['get_jsonb_double'], 'DOUBLE', ['STRING', 'STRING'], '', '', '', 'vec', 'ALWAYS_NULLABLE'],
+    [['get_jsonb_string'], 'STRING', ['STRING', 'STRING'], '', '', '', 'vec', 'ALWAYS_NULLABLE'],
+
     [['json_array'], 'VARCHAR', ['VARCHAR', '...'],
             '_ZN5doris13JsonFunctions10json_arrayEPN9doris_udf15FunctionContextEiPKNS1_9StringValE',
             '', '', 'vec', ''],
@@ -51,6 +51,7 @@ struct TTabletSchema {
     10: optional i32 sequence_col_idx = -1
     11: optional Types.TSortType sort_type
     12: optional i32 sort_col_num
+    13: optional string compaction_policy
 }
 
 // this enum stands for different storage format in src_backends
@@ -105,6 +106,7 @@ struct TCreateTabletReq {
     13: optional TStorageFormat storage_format
     14: optional TTabletType tablet_type
     15: optional TStorageParam storage_param
+    16: optional bool enable_unique_key_merge_on_write = false
 }
 
 struct TDropTabletReq {
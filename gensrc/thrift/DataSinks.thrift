@@ -73,9 +73,22 @@ struct TDataStreamSink {
   3: optional bool ignore_not_found
 }
 
+// The second phase of a two-phase Top-N query: the rows sent to the result sink only have the
+// sort columns and the row locators, the other columns are fetched by the locators from the
+// backends holding the rows.
+struct TFetchOption {
+    // the slot of the row locators in the output of the plan
+    1: optional Types.TSlotId row_locator_slot_id
+    // the columns to fetch, appended to the output of the plan, the output exprs of the sink
+    // reference the slots of this tuple
+    2: optional Types.TTupleId fetch_tuple_id
+    3: optional Descriptors.TPaloNodesInfo nodes_info
+}
+
 struct TResultSink {
     1: optional TResultSinkType type;
     2: optional TResultFileSinkOptions file_options // deprecated
+    3: optional TFetchOption fetch_option
 }
 
 struct TResultFileSink {
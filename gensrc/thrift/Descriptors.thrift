@@ -100,7 +100,9 @@ enum THdfsCompression {
 }
 
 enum TIndexType {
-  BITMAP
+  BITMAP,
+  NGRAM_BF,
+  INVERTED
 }
 
 // Mapping from names defined by Avro to the enum.
@@ -176,6 +178,9 @@ struct TOlapTableIndex {
   2: optional list<string> columns
   3: optional TIndexType index_type
   4: optional string comment
+  // for NGRAM_BF: "gram_size" and "bf_size"
+  // for INVERTED: "parser"
+  5: optional map<string, string> properties
 }
 
 struct TTabletLocation {
@@ -51,6 +51,9 @@ enum TExprNodeType {
 
   // only used in runtime filter
   BLOOM_PRED,
+
+  // only used in runtime filter
+  BITMAP_PRED,
 }
 
 //enum TAggregationOp {
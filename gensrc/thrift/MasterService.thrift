@@ -89,6 +89,11 @@ struct TReportRequest {
     // the max compaction score of all tablets on a backend,
     // this field should be set along with tablet report
     8: optional i64 tablet_max_compaction_score
+    // if true, `tablets` only contains the tablets changed since the last report,
+    // the tablets not in it are neither deleted from the meta nor from the backend
+    9: optional bool is_incremental
+    // the checksum of the report info of all the tablets on the backend
+    10: optional i64 tablets_checksum
 }
 
 struct TMasterResult {
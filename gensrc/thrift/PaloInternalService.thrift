@@ -81,6 +81,13 @@ struct TResourceLimit {
     1: optional i32 cpu_limit
 }
 
+enum TExchangeColumnCodec {
+  // the columns are only compressed with the whole block by snappy
+  PLAIN,
+  // the values of the fixed-width columns are compressed by bitshuffle + lz4 first
+  BITSHUFFLE_LZ4
+}
+
 // Query options that correspond to PaloService.PaloQueryOptions,
 // with their respective defaults
 struct TQueryOptions {
@@ -160,6 +167,33 @@ struct TQueryOptions {
   // show bitmap data in result, if use this in mysql cli may make the terminal
   // output corrupted character
   43: optional bool return_object_data_as_binary = false
+
+  // whether execute the vectorized fragments by the pipeline engine of BE
+  44: optional bool enable_pipeline_engine = false
+
+  // whether the instances of a broadcast join on one BE share one hash table
+  45: optional bool enable_share_hash_table_for_broadcast_join = false
+
+  // the codec of the fixed-width columns of the blocks sent by the vectorized exchange,
+  // not set by the FE yet
+  46: optional TExchangeColumnCodec exchange_column_codec = TExchangeColumnCodec.PLAIN
+
+  // the preferred bytes of a vectorized block, 0 to size the blocks by batch_size, the config
+  // preferred_block_size_bytes of BE is used if it's not set, which is always the case until
+  // the FE sets it
+  47: optional i64 preferred_block_size_bytes
+
+  // the workload group of the query, one of the groups configured by workload_groups of BE,
+  // not set by the FE yet
+  48: optional string workload_group
+
+  // the priority of the query in the admission queue of BE, the higher run first. Not set by
+  // the FE yet, so the queued queries run in the order of their arrival.
+  49: optional i32 query_priority = 0
+
+  // whether to count the hardware events (cpu cycles, instructions and llc misses) of the
+  // exec nodes in the profile, not set by the FE yet
+  50: optional bool enable_hardware_counters = false
 }
     
 
@@ -341,6 +375,11 @@ struct TExecPlanFragmentParams {
   17: optional TTxnParams txn_conf
   18: optional i64 backend_id
   19: optional TGlobalDict global_dict  // scan node could use the global dict to encode the string value to an integer
+
+  // The id of the plan fragment in the query. With is_simplified_param, the fragment is only
+  // required for the first instance of the fragment on a BE, the later instances on the same
+  // BE may omit it and share the one of the first instance. Not set by the FE yet.
+  20: optional i32 fragment_id
 }
 
 struct TExecPlanFragmentResult {
@@ -340,6 +340,16 @@ struct TMetaScanNode {
   5: optional string user
 }
 
+// The aggregate without grouping answered by the olap scan node from the metadata of the
+// segments instead of the rows
+enum TPushAggOp {
+  NONE,
+  // min and max of the columns, answered by the segment zone maps
+  MINMAX,
+  // count(*), answered by the row numbers of the segments
+  COUNT
+}
+
 struct TOlapScanNode {
   1: required Types.TTupleId tuple_id
   2: required list<string> key_column_name
@@ -348,6 +358,8 @@ struct TOlapScanNode {
   5: optional string sort_column
   6: optional Types.TKeysType keyType
   7: optional string table_name
+  8: optional bool enable_unique_key_merge_on_write
+  9: optional TPushAggOp push_down_agg_type_opt
 }
 
 struct TEqJoinCondition {
@@ -399,6 +411,9 @@ struct THashJoinNode {
 
   // hash output column
   6: optional list<Types.TSlotId> hash_output_slot_ids
+
+  // true if the build side is broadcast to all the instances of the join
+  7: optional bool is_broadcast_join
 }
 
 struct TMergeJoinNode {
@@ -408,6 +423,9 @@ struct TMergeJoinNode {
   // anything from the ON or USING clauses (but *not* the WHERE clause) that's not an
   // equi-join predicate
   2: optional list<Exprs.TExpr> other_join_conjuncts
+
+  // only used by the vectorized merge join, INNER_JOIN if not set
+  3: optional TJoinOp join_op
 }
 
 enum TAggregationOp {
@@ -710,6 +728,8 @@ enum TRuntimeFilterType {
   BLOOM = 2
   MIN_MAX = 4
   IN_OR_BLOOM = 8
+  // a bitmap of the build keys, only for the joins on an integer key
+  BITMAP = 16
 }
 
 // Specification of a runtime filter.
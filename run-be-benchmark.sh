@@ -0,0 +1,152 @@
+#!/usr/bin/env bash
+# Licensed to the Apache Software Foundation (ASF) under one
+# or more contributor license agreements.  See the NOTICE file
+# distributed with this work for additional information
+# regarding copyright ownership.  The ASF licenses this file
+# to you under the Apache License, Version 2.0 (the
+# "License"); you may not use this file except in compliance
+# with the License.  You may obtain a copy of the License at
+#
+#   http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing,
+# software distributed under the License is distributed on an
+# "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+# KIND, either express or implied.  See the License for the
+# specific language governing permissions and limitations
+# under the License.
+
+#####################################################################
+# This script is used to build and run the microbenchmarks of Doris Backend
+# Usage: $0 <options>
+#  Optional options:
+#     --clean              clean and build benchmarks
+#     --run                build and run all benchmarks
+#     --run --filter=xx    build and run the benchmarks matching the regex
+#     --out=file           also save the result as JSON into the file
+#     -j                   build parallel
+#     -h                   print this help message
+#
+# The JSON results of two commits can be compared by
+#   be/benchmark/compare_benchmark.py base.json new.json
+#####################################################################
+
+ROOT=`dirname "$0"`
+ROOT=`cd "$ROOT"; pwd`
+
+export DORIS_HOME=${ROOT}
+
+# Check args
+usage() {
+  echo "
+Usage: $0 <options>
+  Optional options:
+     --clean              clean and build benchmarks
+     --run                build and run all benchmarks
+     --run --filter=xx    build and run the benchmarks matching the regex
+     --out=file           also save the result as JSON into the file
+     -j                   build parallel
+     -h                   print this help message
+
+  Eg.
+    $0                                                  build benchmarks
+    $0 --run                                            build and run all benchmarks
+    $0 --run --filter=BM_HashMap                        runs the benchmarks whose name contains BM_HashMap
+    $0 --run --out=result.json                          runs all benchmarks and saves the JSON result
+  "
+  exit 1
+}
+
+OPTS=$(getopt  -n $0 -o hj:f:o: -l run,clean,filter:,out: -- "$@")
+if [ "$?" != "0" ]; then
+  usage
+fi
+
+set -eo pipefail
+
+eval set -- "$OPTS"
+
+PARALLEL=$[$(nproc)/5+1]
+
+if [[ -z ${USE_LLD} ]]; then
+    USE_LLD=OFF
+fi
+
+CLEAN=0
+RUN=0
+FILTER=""
+OUT=""
+if [ $# != 1 ] ; then
+    while true; do
+        case "$1" in
+            --clean) CLEAN=1 ; shift ;;
+            --run) RUN=1 ; shift ;;
+            -f | --filter) FILTER="--benchmark_filter=$2"; shift 2;;
+            -o | --out) OUT="$2"; shift 2;;
+            -j) PARALLEL=$2; shift 2 ;;
+            -h) usage ; shift ;;
+            --) shift ;  break ;;
+            *) usage ; exit 0 ;;
+        esac
+    done
+fi
+
+# benchmarks are meaningless without optimization
+CMAKE_BUILD_TYPE=${BUILD_TYPE:-RELEASE}
+CMAKE_BUILD_TYPE="${CMAKE_BUILD_TYPE^^}"
+
+echo "Get params:
+    PARALLEL            -- $PARALLEL
+    CLEAN               -- $CLEAN
+    BUILD_TYPE          -- $CMAKE_BUILD_TYPE
+"
+echo "Build Backend Benchmark"
+
+. ${DORIS_HOME}/env.sh
+
+CMAKE_BUILD_DIR=${DORIS_HOME}/be/benchmark_build_${CMAKE_BUILD_TYPE}
+if [ ${CLEAN} -eq 1 ]; then
+    rm ${CMAKE_BUILD_DIR} -rf
+fi
+
+if [ ! -d ${CMAKE_BUILD_DIR} ]; then
+    mkdir -p ${CMAKE_BUILD_DIR}
+fi
+
+if [[ -z ${GLIBC_COMPATIBILITY} ]]; then
+    GLIBC_COMPATIBILITY=ON
+fi
+
+MAKE_PROGRAM="$(which "${BUILD_SYSTEM}")"
+echo "-- Make program: ${MAKE_PROGRAM}"
+
+cd ${CMAKE_BUILD_DIR}
+${CMAKE_CMD} -G "${GENERATOR}" \
+    -DCMAKE_MAKE_PROGRAM="${MAKE_PROGRAM}" \
+    -DCMAKE_BUILD_TYPE="${CMAKE_BUILD_TYPE}" \
+    -DMAKE_TEST=OFF \
+    -DBUILD_BENCHMARK=ON \
+    -DUSE_LLD=${USE_LLD} \
+    -DGLIBC_COMPATIBILITY="${GLIBC_COMPATIBILITY}" \
+    -DBUILD_META_TOOL=OFF \
+    -DWITH_MYSQL=OFF \
+    ${CMAKE_USE_CCACHE} ../
+${BUILD_SYSTEM} -j ${PARALLEL} doris_be_benchmark
+
+if [ ${RUN} -ne 1 ]; then
+    echo "Finished"
+    exit 0
+fi
+
+echo "******************************"
+echo "   Running Backend Benchmark  "
+echo "******************************"
+
+BENCHMARK_ARGS=()
+if [ -n "${FILTER}" ]; then
+    BENCHMARK_ARGS+=("${FILTER}")
+fi
+if [ -n "${OUT}" ]; then
+    BENCHMARK_ARGS+=("--benchmark_out=${OUT}" "--benchmark_out_format=json")
+fi
+${CMAKE_BUILD_DIR}/benchmark/doris_be_benchmark "${BENCHMARK_ARGS[@]}"
@@ -128,9 +128,10 @@ ${CMAKE_CMD} -G "${GENERATOR}" \
     -DCMAKE_MAKE_PROGRAM="${MAKE_PROGRAM}" \
     -DCMAKE_BUILD_TYPE="${CMAKE_BUILD_TYPE}" \
     -DMAKE_TEST=ON \
+    -DBUILD_BENCHMARK=ON \
     -DUSE_LLD=${USE_LLD} \
     -DGLIBC_COMPATIBILITY="${GLIBC_COMPATIBILITY}" \
-    -DBUILD_META_TOOL=OFF \
+    -DBUILD_META_TOOL=ON \
     -DWITH_MYSQL=OFF \
     ${CMAKE_USE_CCACHE} ../
 ${BUILD_SYSTEM} -j ${PARALLEL}